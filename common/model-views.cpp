@@ -248,6 +248,21 @@ namespace rs2
                 }
             }
 
+            // The 3D view deprojected the depth on the GPU, the points are only calculated for the export
+            if (!p)
+            {
+                for (auto&& f : frames)
+                {
+                    if (f.is<depth_frame>())
+                    {
+                        pointcloud pc;
+                        if (texture) pc.map_to(texture);
+                        p = pc.calculate(f);
+                        break;
+                    }
+                }
+            }
+
             if (p)
             {
                 p.export_to_ply(fname, texture);
@@ -1498,7 +1513,7 @@ namespace rs2
         for (auto i = 0; i < RS2_OPTION_COUNT; i++)
         {
             auto opt = static_cast<rs2_option>(i);
-            if (opt == RS2_OPTION_FRAMES_QUEUE_SIZE) continue;
+            if (opt == RS2_OPTION_FRAMES_QUEUE_SIZE || opt == RS2_OPTION_FRAMES_MEMORY_BUDGET) continue;
             if (std::find(drawing_order.begin(), drawing_order.end(), opt) == drawing_order.end())
             {
                 draw_option(opt, update_read_only_options, error_message, notifications);
@@ -1511,7 +1526,7 @@ namespace rs2
         return (uint64_t)std::count_if(
             std::begin(options_metadata),
             std::end(options_metadata),
-            [](const std::pair<int, option_model>& p) {return p.second.supported && p.second.opt != RS2_OPTION_FRAMES_QUEUE_SIZE; });
+            [](const std::pair<int, option_model>& p) {return p.second.supported && p.second.opt != RS2_OPTION_FRAMES_QUEUE_SIZE && p.second.opt != RS2_OPTION_FRAMES_MEMORY_BUDGET; });
     }
 
     bool option_model::draw_option(bool update_read_only_options,
@@ -2055,6 +2070,28 @@ namespace rs2
         }
         ImGui::SameLine();
 
+        if (gpu_renderer.supported())
+        {
+            if (gpu_points_enabled)
+            {
+                ImGui::PushStyleColor(ImGuiCol_Text, light_blue);
+                ImGui::PushStyleColor(ImGuiCol_TextSelectedBg, light_blue);
+            }
+            label = to_string() << textual_icons::braille << "##GPU Points";
+            if (ImGui::Button(label.c_str(), { 24, buttons_heights }))
+            {
+                gpu_points_enabled = !gpu_points_enabled;
+                last_points = rs2::points();
+                ppf.reset();
+            }
+            if (ImGui::IsItemHovered())
+            {
+                ImGui::SetTooltip(gpu_points_enabled ? "Points deprojected on the GPU, as points only" : "Deproject the points on the GPU");
+            }
+            if (gpu_points_enabled) ImGui::PopStyleColor(2);
+            ImGui::SameLine();
+        }
+
         if (support_non_syncronized_mode)
         {
             if (synchronization_enable)
@@ -3130,7 +3167,7 @@ namespace rs2
 
         if(viewer.is_3d_view)
         {
-            if(viewer.is_3d_depth_source(f))
+            if(viewer.is_3d_depth_source(f) && !viewer.gpu_points_enabled)
             {
                 res.push_back(pc->calculate(filtered));
             }
@@ -3385,7 +3422,10 @@ namespace rs2
                         }
 
                         if (frame.is<depth_frame>() && !paused)
+                        {
                             depth = frame;
+                            if (is_3d_depth_source(frame)) last_depth = frame;
+                        }
 
                         auto texture = upload_frame(std::move(frame));
 
@@ -3870,12 +3910,16 @@ namespace rs2
 
         glColor4f(1.f, 1.f, 1.f, 1.f);
 
-        if (draw_frustrum && last_points)
+        // The shader reads the 16 bit depth values, the disparity left to the points calculated on the CPU
+        auto gpu_depth = gpu_points_enabled ? last_depth.as<depth_frame>() : depth_frame(frame{});
+        if (gpu_depth && gpu_depth.get_profile().format() != RS2_FORMAT_Z16)
+            gpu_depth = depth_frame(frame{});
+        if (draw_frustrum && (last_points || gpu_depth))
         {
             glLineWidth(1.f);
             glBegin(GL_LINES);
 
-            auto intrin = last_points.get_profile().as<video_stream_profile>().get_intrinsics();
+            auto intrin = (last_points ? frame(last_points) : frame(gpu_depth)).get_profile().as<video_stream_profile>().get_intrinsics();
 
             glColor4f(sensor_bg.x, sensor_bg.y, sensor_bg.z, 0.5f);
 
@@ -3907,7 +3951,40 @@ namespace rs2
             glColor4f(1.f, 1.f, 1.f, 1.f);
         }
 
-        if (last_points && last_texture)
+        if (gpu_depth && last_texture)
+        {
+            auto depth_profile = gpu_depth.get_profile().as<video_stream_profile>();
+            auto depth_intrinsics = depth_profile.get_intrinsics();
+            auto texture_intrinsics = depth_intrinsics;
+            rs2_extrinsics depth_to_texture{ { 1, 0, 0, 0, 1, 0, 0, 0, 1 }, { 0, 0, 0 } };
+            if (auto tex = last_texture->get_last_frame(true).as<video_frame>())
+            {
+                try
+                {
+                    auto tex_profile = tex.get_profile().as<video_stream_profile>();
+                    depth_to_texture = depth_profile.get_extrinsics_to(tex_profile);
+                    texture_intrinsics = tex_profile.get_intrinsics();
+                }
+                catch (const error&)
+                {
+                    // No calibration between the streams, the texture is drawn as if it were aligned to the depth
+                }
+            }
+
+            glPointSize(std::sqrt(viewer_rect.w / depth_profile.width()));
+            glBindTexture(GL_TEXTURE_2D, last_texture->get_gl_handle());
+            glEnable(GL_TEXTURE_2D);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, texture_border_mode);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, texture_border_mode);
+
+            auto units = 0.001f;
+            auto stream = streams.find(streams_origin[depth_profile.unique_id()]);
+            if (stream != streams.end() && stream->second.dev && stream->second.dev->depth_units > 0)
+                units = stream->second.dev->depth_units;
+
+            gpu_renderer.draw(gpu_depth, units, depth_intrinsics, texture_intrinsics, depth_to_texture);
+        }
+        else if (last_points && last_texture)
         {
             auto vf_profile = last_points.get_profile().as<video_stream_profile>();
             // Non-linear correspondence customized for non-flat surface exploration
@@ -5881,7 +5958,7 @@ namespace rs2
                         for (auto i = 0; i < RS2_OPTION_COUNT; i++)
                         {
                             auto opt = static_cast<rs2_option>(i);
-                            if (opt == RS2_OPTION_FRAMES_QUEUE_SIZE) continue;
+                            if (opt == RS2_OPTION_FRAMES_QUEUE_SIZE || opt == RS2_OPTION_FRAMES_MEMORY_BUDGET) continue;
                             if (std::find(drawing_order.begin(), drawing_order.end(), opt) == drawing_order.end())
                             {
                                 if (dev.is<advanced_mode>() && opt == RS2_OPTION_VISUAL_PRESET)
@@ -5917,7 +5994,7 @@ namespace rs2
                         for (auto i = 0; i < RS2_OPTION_COUNT; i++)
                         {
                             auto opt = static_cast<rs2_option>(i);
-                            if (opt == RS2_OPTION_FRAMES_QUEUE_SIZE) continue;
+                            if (opt == RS2_OPTION_FRAMES_QUEUE_SIZE || opt == RS2_OPTION_FRAMES_MEMORY_BUDGET) continue;
                             pb->get_option(opt).draw_option(
                                 dev.is<playback>() || update_read_only_options,
                                 false, error_message, viewer.not_model);
@@ -6086,7 +6163,7 @@ namespace rs2
                                 for (auto i = 0; i < RS2_OPTION_COUNT; i++)
                                 {
                                     auto opt = static_cast<rs2_option>(i);
-                                    if (opt == RS2_OPTION_FRAMES_QUEUE_SIZE) continue;
+                                    if (opt == RS2_OPTION_FRAMES_QUEUE_SIZE || opt == RS2_OPTION_FRAMES_MEMORY_BUDGET) continue;
                                     pb->get_option(opt).draw_option(
                                         dev.is<playback>() || update_read_only_options,
                                         false, error_message, viewer.not_model);
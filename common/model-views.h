@@ -936,6 +936,7 @@ namespace rs2
         float3 up;
         bool fixed_up = true;
         bool render_quads = true;
+        bool gpu_points_enabled = false;    // Deprojects the depth for the 3D view on the GPU, no point cloud calculated for it
 
         float view[16];
         bool texture_wrapping_on = true;
@@ -944,6 +945,8 @@ namespace rs2
         rs2::points last_points;
         texture_buffer* last_texture;
         texture_buffer texture;
+        rs2::frame last_depth;
+        gpu_points gpu_renderer;
 
     };
 
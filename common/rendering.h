@@ -32,6 +32,40 @@
 #endif
 #endif
 
+#ifndef GL_PIXEL_UNPACK_BUFFER
+#define GL_PIXEL_UNPACK_BUFFER  0x88EC
+#endif
+#ifndef GL_STREAM_DRAW
+#define GL_STREAM_DRAW          0x88E0
+#endif
+#ifndef GL_WRITE_ONLY
+#define GL_WRITE_ONLY           0x88B9
+#endif
+#ifndef GL_ARRAY_BUFFER
+#define GL_ARRAY_BUFFER         0x8892
+#endif
+#ifndef GL_STATIC_DRAW
+#define GL_STATIC_DRAW          0x88E4
+#endif
+#ifndef GL_FRAGMENT_SHADER
+#define GL_FRAGMENT_SHADER      0x8B30
+#endif
+#ifndef GL_VERTEX_SHADER
+#define GL_VERTEX_SHADER        0x8B31
+#endif
+#ifndef GL_COMPILE_STATUS
+#define GL_COMPILE_STATUS       0x8B81
+#endif
+#ifndef GL_LINK_STATUS
+#define GL_LINK_STATUS          0x8B82
+#endif
+
+#ifdef _WIN32
+#define RS2_GL_APIENTRY __stdcall
+#else
+#define RS2_GL_APIENTRY
+#endif
+
 namespace rs2
 {
     class fps_calc
@@ -976,11 +1010,380 @@ namespace rs2
         timer _t;
     };
 
+    // The pixel buffer objects of OpenGL 2.1, loaded at run time, as the viewer links with the OpenGL 1.1 of every platform.
+    // Loaded on the first use, with the context of the window current
+    class pixel_buffers
+    {
+    public:
+        typedef void (RS2_GL_APIENTRY *gen_buffers_t)(GLsizei n, GLuint* buffers);
+        typedef void (RS2_GL_APIENTRY *bind_buffer_t)(GLenum target, GLuint buffer);
+        typedef void (RS2_GL_APIENTRY *buffer_data_t)(GLenum target, ptrdiff_t size, const void* data, GLenum usage);
+        typedef void* (RS2_GL_APIENTRY *map_buffer_t)(GLenum target, GLenum access);
+        typedef GLboolean (RS2_GL_APIENTRY *unmap_buffer_t)(GLenum target);
+
+        gen_buffers_t gen_buffers = nullptr;
+        bind_buffer_t bind_buffer = nullptr;
+        buffer_data_t buffer_data = nullptr;
+        map_buffer_t map_buffer = nullptr;
+        unmap_buffer_t unmap_buffer = nullptr;
+
+        static const pixel_buffers& get()
+        {
+            static const pixel_buffers functions;
+            return functions;
+        }
+
+        bool supported() const { return gen_buffers && bind_buffer && buffer_data && map_buffer && unmap_buffer; }
+
+    private:
+        pixel_buffers()
+        {
+            if (!glfwGetCurrentContext() || !glfwExtensionSupported("GL_ARB_pixel_buffer_object"))
+                return;
+            gen_buffers = (gen_buffers_t)glfwGetProcAddress("glGenBuffers");
+            bind_buffer = (bind_buffer_t)glfwGetProcAddress("glBindBuffer");
+            buffer_data = (buffer_data_t)glfwGetProcAddress("glBufferData");
+            map_buffer = (map_buffer_t)glfwGetProcAddress("glMapBuffer");
+            unmap_buffer = (unmap_buffer_t)glfwGetProcAddress("glUnmapBuffer");
+        }
+    };
+
+    // Draws a depth frame as points, deprojected and mapped to their texture in a vertex shader after rs2_deproject_pixel_to_point
+    // and rs2_project_point_to_pixel, for no point cloud to be calculated on the CPU just for display. Needs OpenGL 2.0, the
+    // functions of which are loaded at run time on the first use, with the context of the window current
+    class gpu_points
+    {
+        typedef GLuint (RS2_GL_APIENTRY *create_shader_t)(GLenum type);
+        typedef void (RS2_GL_APIENTRY *shader_source_t)(GLuint shader, GLsizei count, const char* const* string, const GLint* length);
+        typedef void (RS2_GL_APIENTRY *compile_shader_t)(GLuint shader);
+        typedef void (RS2_GL_APIENTRY *get_shaderiv_t)(GLuint shader, GLenum pname, GLint* params);
+        typedef GLuint (RS2_GL_APIENTRY *create_program_t)();
+        typedef void (RS2_GL_APIENTRY *attach_shader_t)(GLuint program, GLuint shader);
+        typedef void (RS2_GL_APIENTRY *link_program_t)(GLuint program);
+        typedef void (RS2_GL_APIENTRY *get_programiv_t)(GLuint program, GLenum pname, GLint* params);
+        typedef void (RS2_GL_APIENTRY *use_program_t)(GLuint program);
+        typedef GLint (RS2_GL_APIENTRY *get_location_t)(GLuint program, const char* name);
+        typedef void (RS2_GL_APIENTRY *uniform1i_t)(GLint location, GLint v0);
+        typedef void (RS2_GL_APIENTRY *uniform1f_t)(GLint location, GLfloat v0);
+        typedef void (RS2_GL_APIENTRY *uniform2f_t)(GLint location, GLfloat v0, GLfloat v1);
+        typedef void (RS2_GL_APIENTRY *uniform3f_t)(GLint location, GLfloat v0, GLfloat v1, GLfloat v2);
+        typedef void (RS2_GL_APIENTRY *uniform4f_t)(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3);
+        typedef void (RS2_GL_APIENTRY *uniform1fv_t)(GLint location, GLsizei count, const GLfloat* value);
+        typedef void (RS2_GL_APIENTRY *uniform_matrix3fv_t)(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+        typedef void (RS2_GL_APIENTRY *vertex_attrib_array_t)(GLuint index);
+        typedef void (RS2_GL_APIENTRY *vertex_attrib_pointer_t)(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer);
+        typedef void (RS2_GL_APIENTRY *gen_buffers_t)(GLsizei n, GLuint* buffers);
+        typedef void (RS2_GL_APIENTRY *bind_buffer_t)(GLenum target, GLuint buffer);
+        typedef void (RS2_GL_APIENTRY *buffer_data_t)(GLenum target, ptrdiff_t size, const void* data, GLenum usage);
+
+        create_shader_t create_shader = nullptr;
+        shader_source_t shader_source = nullptr;
+        compile_shader_t compile_shader = nullptr;
+        get_shaderiv_t get_shaderiv = nullptr;
+        create_program_t create_program = nullptr;
+        attach_shader_t attach_shader = nullptr;
+        link_program_t link_program = nullptr;
+        get_programiv_t get_programiv = nullptr;
+        use_program_t use_program = nullptr;
+        get_location_t get_uniform_location = nullptr;
+        get_location_t get_attrib_location = nullptr;
+        uniform1i_t uniform1i = nullptr;
+        uniform1f_t uniform1f = nullptr;
+        uniform2f_t uniform2f = nullptr;
+        uniform3f_t uniform3f = nullptr;
+        uniform4f_t uniform4f = nullptr;
+        uniform1fv_t uniform1fv = nullptr;
+        uniform_matrix3fv_t uniform_matrix3fv = nullptr;
+        vertex_attrib_array_t enable_vertex_attrib_array = nullptr;
+        vertex_attrib_array_t disable_vertex_attrib_array = nullptr;
+        vertex_attrib_pointer_t vertex_attrib_pointer = nullptr;
+        gen_buffers_t gen_buffers = nullptr;
+        bind_buffer_t bind_buffer = nullptr;
+        buffer_data_t buffer_data = nullptr;
+
+        bool _loaded = false;
+        GLuint _program = 0;
+        GLint _pixel = -1, _depth = -1;
+
+        // Pixel coordinates of the frame, uploaded once for its size, and its depth values, uploaded every frame
+        GLuint _buffers[2] = { 0, 0 };
+        int _width = 0, _height = 0;
+        std::vector<uint16_t> _packed;
+
+        template<class T> void load(T& function, const char* name)
+        {
+            function = (T)glfwGetProcAddress(name);
+        }
+
+        GLuint compile(GLenum type, const std::string& source)
+        {
+            auto shader = create_shader(type);
+            auto text = source.c_str();
+            shader_source(shader, 1, &text, nullptr);
+            compile_shader(shader);
+            GLint compiled = 0;
+            get_shaderiv(shader, GL_COMPILE_STATUS, &compiled);
+            return compiled ? shader : 0;
+        }
+
+        static std::string vertex_shader()
+        {
+            std::stringstream ss;
+            ss << "#version 110\n"
+               << "attribute vec2 pixel;\n"
+               << "attribute float depth;\n"
+               << "uniform float units;\n"
+               << "uniform vec4 depth_intrinsics;\n"      // ppx, ppy, fx, fy
+               << "uniform int depth_model;\n"
+               << "uniform float depth_coeffs[5];\n"
+               << "uniform mat3 rotation;\n"
+               << "uniform vec3 translation;\n"
+               << "uniform vec4 texture_intrinsics;\n"
+               << "uniform vec2 texture_size;\n"
+               << "uniform int texture_model;\n"
+               << "uniform float texture_coeffs[5];\n"
+               << "varying vec2 texcoord;\n"
+               << "void main()\n"
+               << "{\n"
+               << "    vec2 xy = (pixel - depth_intrinsics.xy) / depth_intrinsics.zw;\n"
+               << "    if (depth_model == " << int(RS2_DISTORTION_INVERSE_BROWN_CONRADY) << ")\n"
+               << "    {\n"
+               << "        float r2 = dot(xy, xy);\n"
+               << "        float f = 1.0 + depth_coeffs[0] * r2 + depth_coeffs[1] * r2 * r2 + depth_coeffs[4] * r2 * r2 * r2;\n"
+               << "        xy = vec2(xy.x * f + 2.0 * depth_coeffs[2] * xy.x * xy.y + depth_coeffs[3] * (r2 + 2.0 * xy.x * xy.x),\n"
+               << "                  xy.y * f + 2.0 * depth_coeffs[3] * xy.x * xy.y + depth_coeffs[2] * (r2 + 2.0 * xy.y * xy.y));\n"
+               << "    }\n"
+               << "    vec3 point = vec3(xy, 1.0) * (depth * units);\n"
+               << "    vec3 mapped = rotation * point + translation;\n"
+               << "    vec2 uv = mapped.xy / mapped.z;\n"
+               << "    if (texture_model == " << int(RS2_DISTORTION_MODIFIED_BROWN_CONRADY) << ")\n"
+               << "    {\n"
+               << "        float r2 = dot(uv, uv);\n"
+               << "        uv *= 1.0 + texture_coeffs[0] * r2 + texture_coeffs[1] * r2 * r2 + texture_coeffs[4] * r2 * r2 * r2;\n"
+               << "        uv = vec2(uv.x + 2.0 * texture_coeffs[2] * uv.x * uv.y + texture_coeffs[3] * (r2 + 2.0 * uv.x * uv.x),\n"
+               << "                  uv.y + 2.0 * texture_coeffs[3] * uv.x * uv.y + texture_coeffs[2] * (r2 + 2.0 * uv.y * uv.y));\n"
+               << "    }\n"
+               << "    if (texture_model == " << int(RS2_DISTORTION_FTHETA) << ")\n"
+               << "    {\n"
+               << "        float r = length(uv);\n"
+               << "        uv *= r > 0.0 ? atan(2.0 * r * tan(texture_coeffs[0] / 2.0)) / texture_coeffs[0] / r : 1.0;\n"
+               << "    }\n"
+               << "    texcoord = (uv * texture_intrinsics.zw + texture_intrinsics.xy) / texture_size;\n"
+               // The pixels without depth are left outside of the clip volume
+               << "    gl_Position = depth > 0.0 ? gl_ModelViewProjectionMatrix * vec4(point, 1.0) : vec4(2.0, 2.0, 2.0, 1.0);\n"
+               << "}\n";
+            return ss.str();
+        }
+
+        static std::string fragment_shader()
+        {
+            return "#version 110\n"
+                   "uniform sampler2D texture_image;\n"
+                   "varying vec2 texcoord;\n"
+                   "void main()\n"
+                   "{\n"
+                   "    gl_FragColor = texture2D(texture_image, texcoord);\n"
+                   "}\n";
+        }
+
+        void init()
+        {
+            _loaded = true;
+            if (!glfwGetCurrentContext())
+                return;
+
+            load(create_shader, "glCreateShader");
+            load(shader_source, "glShaderSource");
+            load(compile_shader, "glCompileShader");
+            load(get_shaderiv, "glGetShaderiv");
+            load(create_program, "glCreateProgram");
+            load(attach_shader, "glAttachShader");
+            load(link_program, "glLinkProgram");
+            load(get_programiv, "glGetProgramiv");
+            load(use_program, "glUseProgram");
+            load(get_uniform_location, "glGetUniformLocation");
+            load(get_attrib_location, "glGetAttribLocation");
+            load(uniform1i, "glUniform1i");
+            load(uniform1f, "glUniform1f");
+            load(uniform2f, "glUniform2f");
+            load(uniform3f, "glUniform3f");
+            load(uniform4f, "glUniform4f");
+            load(uniform1fv, "glUniform1fv");
+            load(uniform_matrix3fv, "glUniformMatrix3fv");
+            load(enable_vertex_attrib_array, "glEnableVertexAttribArray");
+            load(disable_vertex_attrib_array, "glDisableVertexAttribArray");
+            load(vertex_attrib_pointer, "glVertexAttribPointer");
+            load(gen_buffers, "glGenBuffers");
+            load(bind_buffer, "glBindBuffer");
+            load(buffer_data, "glBufferData");
+
+            if (!create_shader || !shader_source || !compile_shader || !get_shaderiv || !create_program || !attach_shader ||
+                !link_program || !get_programiv || !use_program || !get_uniform_location || !get_attrib_location || !uniform1i ||
+                !uniform1f || !uniform2f || !uniform3f || !uniform4f || !uniform1fv || !uniform_matrix3fv ||
+                !enable_vertex_attrib_array || !disable_vertex_attrib_array || !vertex_attrib_pointer || !gen_buffers ||
+                !bind_buffer || !buffer_data)
+                return;
+
+            auto vs = compile(GL_VERTEX_SHADER, vertex_shader());
+            auto fs = compile(GL_FRAGMENT_SHADER, fragment_shader());
+            if (!vs || !fs)
+                return;
+
+            auto program = create_program();
+            attach_shader(program, vs);
+            attach_shader(program, fs);
+            link_program(program);
+            GLint linked = 0;
+            get_programiv(program, GL_LINK_STATUS, &linked);
+            if (!linked)
+                return;
+
+            _program = program;
+            _pixel = get_attrib_location(_program, "pixel");
+            _depth = get_attrib_location(_program, "depth");
+            gen_buffers(2, _buffers);
+        }
+
+        void set_intrinsics(const char* prefix, const rs2_intrinsics& intrin)
+        {
+            auto name = [prefix](const char* suffix) { return std::string(prefix) + suffix; };
+            uniform4f(get_uniform_location(_program, name("_intrinsics").c_str()), intrin.ppx, intrin.ppy, intrin.fx, intrin.fy);
+            uniform1i(get_uniform_location(_program, name("_model").c_str()), intrin.model);
+            uniform1fv(get_uniform_location(_program, name("_coeffs").c_str()), 5, intrin.coeffs);
+        }
+
+    public:
+        bool supported()
+        {
+            if (!_loaded) init();
+            return _program != 0;
+        }
+
+        // Draws the points with the texture bound, its pixels those of the intrinsics, seen through the extrinsics from the depth
+        void draw(const depth_frame& depth, float units, const rs2_intrinsics& depth_intrinsics,
+                  const rs2_intrinsics& texture_intrinsics, const rs2_extrinsics& depth_to_texture)
+        {
+            if (!supported())
+                return;
+
+            const int width = depth.get_width(), height = depth.get_height();
+            if (width != _width || height != _height)
+            {
+                std::vector<float> pixels;
+                pixels.reserve(width * height * 2);
+                for (int y = 0; y < height; ++y)
+                    for (int x = 0; x < width; ++x)
+                    {
+                        pixels.push_back(float(x));
+                        pixels.push_back(float(y));
+                    }
+                bind_buffer(GL_ARRAY_BUFFER, _buffers[0]);
+                buffer_data(GL_ARRAY_BUFFER, pixels.size() * sizeof(float), pixels.data(), GL_STATIC_DRAW);
+                _width = width;
+                _height = height;
+            }
+
+            auto data = static_cast<const uint16_t*>(depth.get_data());
+            if (depth.get_stride_in_bytes() != width * int(sizeof(uint16_t)))
+            {
+                _packed.resize(width * height);
+                for (int y = 0; y < height; ++y)
+                    memcpy(_packed.data() + y * width, static_cast<const uint8_t*>(depth.get_data()) + y * depth.get_stride_in_bytes(), width * sizeof(uint16_t));
+                data = _packed.data();
+            }
+            bind_buffer(GL_ARRAY_BUFFER, _buffers[1]);
+            buffer_data(GL_ARRAY_BUFFER, width * height * sizeof(uint16_t), data, GL_STREAM_DRAW);
+
+            use_program(_program);
+            uniform1f(get_uniform_location(_program, "units"), units);
+            set_intrinsics("depth", depth_intrinsics);
+            set_intrinsics("texture", texture_intrinsics);
+            uniform2f(get_uniform_location(_program, "texture_size"), float(texture_intrinsics.width), float(texture_intrinsics.height));
+            uniform_matrix3fv(get_uniform_location(_program, "rotation"), 1, GL_FALSE, depth_to_texture.rotation);
+            uniform3f(get_uniform_location(_program, "translation"), depth_to_texture.translation[0], depth_to_texture.translation[1], depth_to_texture.translation[2]);
+            uniform1i(get_uniform_location(_program, "texture_image"), 0);
+
+            enable_vertex_attrib_array(_pixel);
+            bind_buffer(GL_ARRAY_BUFFER, _buffers[0]);
+            vertex_attrib_pointer(_pixel, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+            enable_vertex_attrib_array(_depth);
+            bind_buffer(GL_ARRAY_BUFFER, _buffers[1]);
+            vertex_attrib_pointer(_depth, 1, GL_UNSIGNED_SHORT, GL_FALSE, 0, nullptr);
+
+            glDrawArrays(GL_POINTS, 0, width * height);
+
+            disable_vertex_attrib_array(_pixel);
+            disable_vertex_attrib_array(_depth);
+            bind_buffer(GL_ARRAY_BUFFER, 0);
+            use_program(0);
+        }
+    };
+
     class texture_buffer
     {
         GLuint texture;
         rs2::frame_queue last_queue[2];
         mutable rs2::frame last[2];
+
+        // The storage of the texture, reallocated only when the frames change their size or format
+        GLint _internal_format = 0;
+        GLenum _format = 0;
+        GLenum _type = 0;
+        int _width = 0;
+        int _height = 0;
+
+        // Double buffered uploads, the frame copied to one buffer while the GPU reads the other
+        GLuint _pbo[2] = { 0, 0 };
+        int _pbo_index = 0;
+
+        static size_t bytes_per_pixel(GLenum format, GLenum type)
+        {
+            size_t components = format == GL_LUMINANCE_ALPHA ? 2 : format == GL_RGB ? 3 : format == GL_RGBA ? 4 : 1;
+            size_t size = type == GL_UNSIGNED_SHORT ? 2 : type == GL_FLOAT ? 4 : 1;
+            return components * size;
+        }
+
+        // Uploads a frame of tightly packed rows to the bound texture
+        void upload_texture(GLint internal_format, int width, int height, GLenum format, GLenum type, const void* data)
+        {
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            if (internal_format != _internal_format || format != _format || type != _type || width != _width || height != _height)
+            {
+                glTexImage2D(GL_TEXTURE_2D, 0, internal_format, width, height, 0, format, type, nullptr);
+                _internal_format = internal_format;
+                _format = format;
+                _type = type;
+                _width = width;
+                _height = height;
+            }
+
+            auto& pbo = pixel_buffers::get();
+            if (pbo.supported())
+            {
+                if (!_pbo[0])
+                    pbo.gen_buffers(2, _pbo);
+                _pbo_index = 1 - _pbo_index;
+
+                // The storage is orphaned before it is mapped, for the copy not to wait on the GPU reading a previous frame
+                auto size = width * height * bytes_per_pixel(format, type);
+                pbo.bind_buffer(GL_PIXEL_UNPACK_BUFFER, _pbo[_pbo_index]);
+                pbo.buffer_data(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+                if (auto ptr = pbo.map_buffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY))
+                {
+                    memcpy(ptr, data, size);
+                    if (pbo.unmap_buffer(GL_PIXEL_UNPACK_BUFFER))
+                    {
+                        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, format, type, nullptr);
+                        pbo.bind_buffer(GL_PIXEL_UNPACK_BUFFER, 0);
+                        return;
+                    }
+                }
+                pbo.bind_buffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            }
+
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, format, type, data);
+        }
+
     public:
         std::shared_ptr<colorizer> colorize;
         bool zoom_preview = false;
@@ -994,6 +1397,7 @@ namespace rs2
         texture_buffer& operator=(const texture_buffer& other)
         {
             texture = other.texture;
+            _width = _height = 0;
             return *this;
         }
 
@@ -1016,6 +1420,7 @@ namespace rs2
                 glGenTextures(1, &texture);
             glBindTexture(GL_TEXTURE_2D, texture);
             glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+            _width = _height = 0;
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
@@ -1062,37 +1467,37 @@ namespace rs2
                         data = colorized_frame.get_data();
                         // Override the first pixel in the colorized image for occlusion invalidation.
                         memset((void*)data,0, colorized_frame.get_bytes_per_pixel());
-                        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB,
-                                     colorized_frame.get_width(),
-                                     colorized_frame.get_height(),
-                                     0, GL_RGB, GL_UNSIGNED_BYTE,
-                                     colorized_frame.get_data());
+                        upload_texture(GL_RGB,
+                                       colorized_frame.get_width(),
+                                       colorized_frame.get_height(),
+                                       GL_RGB, GL_UNSIGNED_BYTE,
+                                       colorized_frame.get_data());
                         rendered_frame = colorized_frame;
                     }
                 }
-                else glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_LUMINANCE, GL_UNSIGNED_SHORT, data);
+                else upload_texture(GL_RGB, width, height, GL_LUMINANCE, GL_UNSIGNED_SHORT, data);
 
                 break;
             case RS2_FORMAT_DISPARITY32:
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, width, height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, data);
+                upload_texture(GL_DEPTH_COMPONENT, width, height, GL_DEPTH_COMPONENT, GL_FLOAT, data);
                 break;
             case RS2_FORMAT_XYZ32F:
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_FLOAT, data);
+                upload_texture(GL_RGB, width, height, GL_RGB, GL_FLOAT, data);
                 break;
             case RS2_FORMAT_YUYV: // Display YUYV by showing the luminance channel and packing chrominance into ignored alpha channel
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_LUMINANCE_ALPHA, GL_UNSIGNED_BYTE, data);
+                upload_texture(GL_RGB, width, height, GL_LUMINANCE_ALPHA, GL_UNSIGNED_BYTE, data);
                 break;
             case RS2_FORMAT_UYVY: // Use luminance component only to avoid costly UVUY->RGB conversion
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE, width, height, 0, GL_LUMINANCE, GL_UNSIGNED_SHORT, data);
+                upload_texture(GL_LUMINANCE, width, height, GL_LUMINANCE, GL_UNSIGNED_SHORT, data);
                 break;
             case RS2_FORMAT_RGB8: case RS2_FORMAT_BGR8: // Display both RGB and BGR by interpreting them RGB, to show the flipped byte ordering. Obviously, GL_BGR could be used on OpenGL 1.2+
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
+                upload_texture(GL_RGB, width, height, GL_RGB, GL_UNSIGNED_BYTE, data);
                 break;
             case RS2_FORMAT_RGBA8: case RS2_FORMAT_BGRA8: // Display both RGBA and BGRA by interpreting them RGBA, to show the flipped byte ordering. Obviously, GL_BGRA could be used on OpenGL 1.2+
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+                upload_texture(GL_RGBA, width, height, GL_RGBA, GL_UNSIGNED_BYTE, data);
                 break;
             case RS2_FORMAT_Y8:
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_LUMINANCE, GL_UNSIGNED_BYTE, data);
+                upload_texture(GL_RGB, width, height, GL_LUMINANCE, GL_UNSIGNED_BYTE, data);
                 break;
             case RS2_FORMAT_MOTION_XYZ32F:
             {
@@ -1108,12 +1513,12 @@ namespace rs2
                 break;
             }
             case RS2_FORMAT_Y16:
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_LUMINANCE, GL_UNSIGNED_SHORT, data);
+                upload_texture(GL_RGB, width, height, GL_LUMINANCE, GL_UNSIGNED_SHORT, data);
                 break;
             case RS2_FORMAT_RAW8:
             case RS2_FORMAT_MOTION_RAW:
             case RS2_FORMAT_GPIO_RAW:
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE, width, height, 0, GL_LUMINANCE, GL_UNSIGNED_BYTE, data);
+                upload_texture(GL_LUMINANCE, width, height, GL_LUMINANCE, GL_UNSIGNED_BYTE, data);
                 break;
             case RS2_FORMAT_6DOF:
             {
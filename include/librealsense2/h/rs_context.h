@@ -14,6 +14,39 @@ extern "C" {
 #endif
 #include "rs_types.h"
 
+/** \brief Compute devices the processing blocks can run their per-frame work on. */
+typedef enum rs2_compute_backend
+{
+    RS2_COMPUTE_BACKEND_CPU,    /**< Process frames on the CPU */
+    RS2_COMPUTE_BACKEND_OPENCL, /**< Offload the bandwidth-heavy blocks to the first OpenCL GPU, available when built with BUILD_WITH_OPENCL */
+    RS2_COMPUTE_BACKEND_COUNT   /**< Number of enumeration values. Not a valid input: intended to be used in for-loops. */
+} rs2_compute_backend;
+const char* rs2_compute_backend_to_string(rs2_compute_backend backend);
+
+/** \brief Kinds of threads librealsense runs, which can be given their own CPU set, priority and name. */
+typedef enum rs2_thread_role
+{
+    RS2_THREAD_ROLE_CAPTURE,        /**< Threads reading the frames of the UVC streams of the backend */
+    RS2_THREAD_ROLE_HID,            /**< Threads polling the HID devices of the backend for motion samples */
+    RS2_THREAD_ROLE_DISPATCH,       /**< Dispatchers, and the worker threads shared by them, that deliver frames to the user */
+    RS2_THREAD_ROLE_DEVICE_WATCHER, /**< Threads watching for devices being connected and disconnected */
+    RS2_THREAD_ROLE_PROCESSING,     /**< Worker threads of the processing graphs */
+    RS2_THREAD_ROLE_PARALLEL,       /**< Threads the data parallel kernels, as unpacking and align, split their work over */
+    RS2_THREAD_ROLE_COUNT           /**< Number of enumeration values. Not a valid input: intended to be used in for-loops. */
+} rs2_thread_role;
+const char* rs2_thread_role_to_string(rs2_thread_role role);
+
+/** \brief Scheduling classes of the threads of a role. */
+typedef enum rs2_thread_priority
+{
+    RS2_THREAD_PRIORITY_DEFAULT,  /**< Leave the scheduling to the operating system */
+    RS2_THREAD_PRIORITY_LOW,      /**< Below the normal priority */
+    RS2_THREAD_PRIORITY_HIGH,     /**< Above the normal priority */
+    RS2_THREAD_PRIORITY_REALTIME, /**< Real-time scheduling, SCHED_FIFO on Linux, which usually requires CAP_SYS_NICE */
+    RS2_THREAD_PRIORITY_COUNT     /**< Number of enumeration values. Not a valid input: intended to be used in for-loops. */
+} rs2_thread_priority;
+const char* rs2_thread_priority_to_string(rs2_thread_priority priority);
+
 /**
 * \brief Creates RealSense context that is required for the rest of the API.
 * \param[in] api_version Users are expected to pass their version of \c RS2_API_VERSION to make sure they are running the correct librealsense version.
@@ -55,6 +88,18 @@ void rs2_set_devices_changed_callback(const rs2_context* context, rs2_devices_ch
  */
 rs2_device* rs2_context_add_device(rs2_context* ctx, const char* file, rs2_error** error);
 
+/**
+ * Create a new device of the files of a multi-device recording and add it to the context
+ * The files play as one device synchronized on their timestamps, with the sensors of every file in order. The timelines
+ * of the files are aligned at their starts. Remove it with rs2_context_remove_device and the file names joined by '|'
+ * \param ctx   The context to which the new device will be added
+ * \param files The files from which the device should be created
+ * \param count The number of files, one or more
+ * \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * @return  A pointer to a device that plays data from the files, or null in case of failure
+ */
+rs2_device* rs2_context_add_merged_device(rs2_context* ctx, const char** files, int count, rs2_error** error);
+
 /**
  * Removes a playback device from the context, if exists
  * \param[in]  ctx       The context from which the device should be removed
@@ -63,6 +108,26 @@ rs2_device* rs2_context_add_device(rs2_context* ctx, const char* file, rs2_error
  */
 void rs2_context_remove_device(rs2_context* ctx, const char* file, rs2_error** error);
 
+/**
+ * Connect to a device another host publishes with rs2_create_net_server and add it to the context
+ * Its sensors stream remotely, with their depth compressed losslessly. Remove it with rs2_context_remove_device and its address
+ * \param ctx       The context to which the new device will be added
+ * \param address   host:port of the server, or the host alone for the default port 8554
+ * \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * @return  A pointer to a device that streams from the server, or null in case of failure
+ */
+rs2_device* rs2_context_add_network_device(rs2_context* ctx, const char* address, rs2_error** error);
+
+/**
+ * Attach to a device another process of the host publishes with rs2_create_shm_publisher and add it to the context
+ * Its frames are the shared memory the publisher wrote them to, and its streams those the publisher runs. Remove it with rs2_context_remove_device and its name
+ * \param ctx       The context to which the new device will be added
+ * \param name      The name the device is published as
+ * \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * @return  A pointer to a device that streams from the publisher, or null in case of failure
+ */
+rs2_device* rs2_context_add_shm_device(rs2_context* ctx, const char* name, rs2_error** error);
+
 /**
 * create a static snapshot of all connected devices at the time of the call
 * \param context     Object representing librealsense session
@@ -76,6 +141,8 @@ rs2_device_list* rs2_query_devices(const rs2_context* context, rs2_error** error
 #define RS2_PRODUCT_LINE_NON_INTEL  0x01
 #define RS2_PRODUCT_LINE_D400       0x02
 #define RS2_PRODUCT_LINE_SR300      0x04
+#define RS2_PRODUCT_LINE_FAST_ENUMERATE 0x100 /**< Combined with the product lines, enumerates the UVC interfaces only, without probing the USB and HID devices, when the context does not keep the devices up to date already. The devices then lack their motion modules and recovery devices are not found */
+#define RS2_PRODUCT_LINE_CREATE_DEVICES 0x200 /**< Combined with the product lines, also creates the devices of the list concurrently, on a thread each, before returning. The first rs2_create_device of every device of the list then returns it without initializing it again */
 
 /**
 * create a static snapshot of all connected devices at the time of the call
@@ -120,6 +187,103 @@ rs2_device* rs2_device_hub_wait_for_device(const rs2_device_hub* hub, rs2_error*
 int rs2_device_hub_is_device_connected(const rs2_device_hub* hub, const rs2_device* device, rs2_error** error);
 
 
+/**
+* Checks whether librealsense was built with a compute backend, and the machine has a device it can run on
+* \param[in] backend The compute backend
+* \param[out] error  If non-null, receives any error that occurs during this call, otherwise, errors are ignored.
+* \return            1 if the backend can be selected, 0 otherwise
+*/
+int rs2_is_compute_backend_available(rs2_compute_backend backend, rs2_error** error);
+
+/**
+* Selects the compute device the YUY2 unpacking, align, pointcloud, colorizer and decimation blocks run on.
+* The selection applies to every block of the process, and blocks fall back to the CPU for any input the backend does not handle
+* \param[in] context The context
+* \param[in] backend The compute backend, RS2_COMPUTE_BACKEND_CPU by default
+* \param[out] error  If non-null, receives any error that occurs during this call, otherwise, errors are ignored.
+*/
+void rs2_context_set_compute_backend(rs2_context* context, rs2_compute_backend backend, rs2_error** error);
+
+/**
+* Runs the dispatching of the pipelines, playback streams and recorders the context creates from now on on a pool of worker
+* threads they share, instead of a thread each. Each of them still delivers its frames one at a time and in order
+* \param[in] context The context
+* \param[in] threads The number of worker threads, -1 for one per hardware thread, or 0 for a thread per dispatcher (the default)
+* \param[out] error  If non-null, receives any error that occurs during this call, otherwise, errors are ignored.
+*/
+void rs2_context_set_worker_threads(rs2_context* context, int threads, rs2_error** error);
+
+/**
+* Sizes the frame pools of the sensors of the devices the context creates as they open, from their profiles and frames queue
+* size, and counts the frame allocations the pools do not cover once streaming, see rs2_frame_memory_stats. In the fatal mode
+* such allocations are refused and their frames dropped, so that streaming does not allocate the storage or objects of frames.
+* Takes effect the next time a sensor is opened
+* \param[in] context The context
+* \param[in] enabled 1 to size the pools and count the streaming allocations, 0 for the pools to grow as needed (the default)
+* \param[in] fatal   1 to refuse the streaming allocations, 0 to count them only
+* \param[out] error  If non-null, receives any error that occurs during this call, otherwise, errors are ignored.
+*/
+void rs2_context_set_streaming_preallocation(rs2_context* context, int enabled, int fatal, rs2_error** error);
+
+/** \brief Runs the task of index index, of the tasks handed to a parallel executor */
+typedef void(*rs2_parallel_task_ptr)(void* task, int index);
+
+/** \brief Runs task(task_data, i) for every i from 0 to count - 1, on threads of the application, and returns once every one of them returned */
+typedef void(*rs2_parallel_executor_ptr)(rs2_parallel_task_ptr task, void* task_data, int count, void* user);
+
+/**
+* Sets the number of threads the data parallel kernels of the library, as the unpacking of the frames and align, split
+* their work over, in the whole process. The calling thread of a kernel is one of them, and the threads of the library
+* are started on the first kernel that uses them, following the policy of RS2_THREAD_ROLE_PARALLEL
+* \param[in] context The context
+* \param[in] threads The number of threads, -1 for one per hardware thread, or 1 for the calling thread alone. The default is
+*                    the calling thread alone, or one thread per hardware thread for the builds with BUILD_WITH_OPENMP
+* \param[out] error  If non-null, receives any error that occurs during this call, otherwise, errors are ignored.
+*/
+void rs2_context_set_parallel_threads(rs2_context* context, int threads, rs2_error** error);
+
+/**
+* Runs the data parallel kernels of the library on the threads of the application, through its executor, instead of threads
+* of the library, in the whole process. Kernels split their work into up to four times concurrency tasks, and the executor
+* may run them on any thread, the calling one included, in any order
+* \param[in] context     The context
+* \param[in] executor    The executor, or null to run the kernels on the calling thread alone
+* \param[in] user        Passed to the executor
+* \param[in] concurrency The number of tasks the executor runs at once
+* \param[out] error      If non-null, receives any error that occurs during this call, otherwise, errors are ignored.
+*/
+void rs2_context_set_parallel_executor(rs2_context* context, rs2_parallel_executor_ptr executor, void* user, int concurrency, rs2_error** error);
+
+/**
+* Sets the CPUs, priority and name of the threads of a role that librealsense starts from now on, in the whole process.
+* Threads carry the name of their role by default. A policy the operating system refuses only logs a warning
+* \param[in] context   The context
+* \param[in] role      The role of the threads
+* \param[in] cpus      The indices of the CPUs the threads may run on, or null for any CPU
+* \param[in] cpu_count The number of CPUs in cpus
+* \param[in] priority  The scheduling class of the threads
+* \param[in] name      The name of the threads, truncated to 15 characters, or null for the name of the role
+* \param[out] error    If non-null, receives any error that occurs during this call, otherwise, errors are ignored.
+*/
+void rs2_context_set_thread_policy(rs2_context* context, rs2_thread_role role, const int* cpus, int cpu_count,
+    rs2_thread_priority priority, const char* name, rs2_error** error);
+
+/**
+* Starts tracing the delivery of frames in the whole process, from their dequeue from the backend through unpacking, syncing,
+* processing blocks and callbacks to their release. Events are kept in memory, per thread, until the trace is stopped
+* \param[in] context The context
+* \param[out] error  If non-null, receives any error that occurs during this call, otherwise, errors are ignored.
+*/
+void rs2_context_start_trace(rs2_context* context, rs2_error** error);
+
+/**
+* Stops tracing and writes the events to a file of the Chrome trace event format, opened by chrome://tracing and Perfetto
+* \param[in] context The context
+* \param[in] file    The path of the trace file
+* \param[out] error  If non-null, receives any error that occurs during this call, otherwise, errors are ignored.
+*/
+void rs2_context_stop_trace(rs2_context* context, const char* file, rs2_error** error);
+
 #ifdef __cplusplus
 }
 #endif
@@ -90,6 +90,20 @@ void rs2_hardware_reset(const rs2_device * device, rs2_error ** error);
 */
 const rs2_raw_data_buffer* rs2_send_and_receive_raw_data(rs2_device* device, void* raw_data_to_send, unsigned size_of_raw_data_to_send, rs2_error** error);
 
+/**
+* Send many raw commands to device back-to-back, without waiting for the response of each before sending the next one
+* The responses are collected in the order of the commands, and a command failing does not stop the others
+* \param[in]  device                    RealSense device to send data to
+* \param[in]  raw_data_to_send          Raw data of every command
+* \param[in]  sizes_of_raw_data_to_send Size of the raw data of every command in bytes
+* \param[in]  count                     Number of commands
+* \param[out] responses                 Receives the response of every command in a rs2_raw_data_buffer, which should be released by rs2_delete_raw_data, or null for the commands that failed
+* \param[out] error                     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return                               Number of commands the device responded to
+*/
+int rs2_send_and_receive_raw_data_batch(rs2_device* device, const void** raw_data_to_send, const unsigned* sizes_of_raw_data_to_send, int count,
+    const rs2_raw_data_buffer** responses, rs2_error** error);
+
 /**
 * Test if the given device can be extended to the requested extension.
 * \param[in]  device    Realsense device
@@ -146,6 +160,39 @@ void rs2_connect_tm2_controller(const rs2_device* device, const unsigned char* m
 */
 void rs2_disconnect_tm2_controller(const rs2_device* device, int id, rs2_error** error);
 
+/**
+* Publishes the video streams of a device over the network, to one client at a time, which connects with rs2_context_add_network_device
+* The sensors the client opens are closed when it disconnects, and the device should not be streamed locally meanwhile
+* \param[in]  device       Device to publish
+* \param[in]  port         TCP port to listen on, or 0 for the default port 8554
+* \param[in]  allow_remote Non-zero to accept the clients of other hosts, which can then control the device, rather than those of the loopback interface alone
+* \param[out] error        If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return                  The server, should be released by rs2_delete_net_server
+*/
+rs2_net_server* rs2_create_net_server(const rs2_device* device, int port, int allow_remote, rs2_error** error);
+
+/**
+* Stops publishing the device and disconnects its client
+* \param[in]  server     Server to delete
+*/
+void rs2_delete_net_server(rs2_net_server* server);
+
+/**
+* Publishes the video frames a device streams in this process into shared memory, for the other processes of the host to attach with rs2_context_add_shm_device
+* The frames are copied once, whoever starts the sensors, and the attached processes receive them without copying
+* \param[in]  device     Device to publish
+* \param[in]  name       Name to publish the device as, without slashes
+* \param[out] error      If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return                The publisher, should be released by rs2_delete_shm_publisher
+*/
+rs2_shm_publisher* rs2_create_shm_publisher(const rs2_device* device, const char* name, rs2_error** error);
+
+/**
+* Stops publishing the frames of the device. The attached processes keep the frames they hold
+* \param[in]  publisher  Publisher to delete
+*/
+void rs2_delete_shm_publisher(rs2_shm_publisher* publisher);
+
 #ifdef __cplusplus
 }
 #endif
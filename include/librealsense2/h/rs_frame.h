@@ -20,10 +20,21 @@ typedef enum rs2_timestamp_domain
 {
     RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, /**< Frame timestamp was measured in relation to the camera clock */
     RS2_TIMESTAMP_DOMAIN_SYSTEM_TIME,    /**< Frame timestamp was measured in relation to the OS system clock */
+    RS2_TIMESTAMP_DOMAIN_GLOBAL_TIME,    /**< Frame timestamp was measured on the camera clock, and mapped onto the monotonic clock of the host (std::chrono::steady_clock) by a fit of the
+                                              camera clock to the arrival times of the frames. Enabled by RS2_OPTION_GLOBAL_TIME_ENABLED */
     RS2_TIMESTAMP_DOMAIN_COUNT           /**< Number of enumeration values. Not a valid input: intended to be used in for-loops. */
 } rs2_timestamp_domain;
 const char* rs2_timestamp_domain_to_string(rs2_timestamp_domain info);
 
+/** \brief What rs2_depth_frame_sample computes of every pixel. */
+typedef enum rs2_depth_sample_mode
+{
+    RS2_DEPTH_SAMPLE_DISTANCE, /**< The depth of the pixel, in meters: one float per pixel */
+    RS2_DEPTH_SAMPLE_POINT,    /**< The point in 3D space of the pixel at its depth, deprojected by the intrinsics of the frame: three floats, x, y, z, per pixel */
+    RS2_DEPTH_SAMPLE_MODE_COUNT /**< Number of enumeration values. Not a valid input: intended to be used in for-loops. */
+} rs2_depth_sample_mode;
+const char* rs2_depth_sample_mode_to_string(rs2_depth_sample_mode mode);
+
 /** \brief Per-Frame-Metadata are set of read-only properties that might be exposed for each individual frame */
 typedef enum rs2_frame_metadata_value
 {
@@ -57,6 +68,15 @@ typedef enum rs2_frame_metadata_value
     RS2_FRAME_METADATA_MANUAL_WHITE_BALANCE                 , /**< Color image white balance. */
     RS2_FRAME_METADATA_POWER_LINE_FREQUENCY                 , /**< Power Line Frequency for anti-flickering Off/50Hz/60Hz/Auto. */
     RS2_FRAME_METADATA_LOW_LIGHT_COMPENSATION               , /**< Color lowlight compensation. Zero corresponds to switched off. */
+    RS2_FRAME_METADATA_DEQUEUE_TIME                         , /**< Host monotonic time the frame was taken from the driver. usec*/
+    RS2_FRAME_METADATA_UNPACK_TIME                          , /**< Host monotonic time the frame was unpacked into its format. usec*/
+    RS2_FRAME_METADATA_SYNC_TIME                            , /**< Host monotonic time the frame was matched into a frameset. usec*/
+    RS2_FRAME_METADATA_CALLBACK_TIME                        , /**< Host monotonic time the frame was last handed to a callback. usec*/
+    RS2_FRAME_METADATA_DEPTH_MIN                            , /**< Smallest valid depth of the frame, in depth units. */
+    RS2_FRAME_METADATA_DEPTH_MAX                            , /**< Largest depth of the frame, in depth units. */
+    RS2_FRAME_METADATA_DEPTH_MEAN                           , /**< Mean of the valid depth of the frame, in depth units. */
+    RS2_FRAME_METADATA_DEPTH_FILL_RATE                      , /**< Pixels of the frame with valid depth, in hundredths of a percent. */
+    RS2_FRAME_METADATA_DEPTH_HISTOGRAM                      , /**< 8 bins of the valid depth over the histogram range, the last one taking the depth beyond it. Bin k in bits 8k to 8k+7, as its fraction of the valid pixels times 255. */
     RS2_FRAME_METADATA_COUNT
 } rs2_frame_metadata_value;
 const char* rs2_frame_metadata_to_string(rs2_frame_metadata_value metadata);
@@ -87,6 +107,13 @@ typedef struct rs2_quaternion
     float x, y, z, w;
 }rs2_quaternion;
 
+/** \brief Motion sample of a batched motion frame */
+typedef struct rs2_motion_sample
+{
+    rs2_vector      motion;               /**< X, Y, Z values of the sample, as the data of a motion frame of the stream                                  */
+    double          timestamp;            /**< Timestamp of the sample, in milliseconds and in the timestamp domain of the frame                          */
+} rs2_motion_sample;
+
 typedef struct rs2_pose
 {
     rs2_vector      translation;          /**< X, Y, Z values of translation, in meters (relative to initial position)                                    */
@@ -99,6 +126,21 @@ typedef struct rs2_pose
     unsigned int    mapper_confidence;    /**< pose data confidence 0x0 - Failed, 0x1 - Low, 0x2 - Medium, 0x3 - High                                     */
 } rs2_pose;
 
+/** \brief The common fields of a frame, retrieved at once with rs2_get_frame_info */
+typedef struct rs2_frame_info
+{
+    const void*               data;             /**< Pointer to the start of the frame data                                            */
+    rs2_time_t                timestamp;        /**< Timestamp of the frame in milliseconds                                            */
+    rs2_timestamp_domain      timestamp_domain; /**< Clock in relation to which the timestamp was measured                             */
+    unsigned long long        frame_number;     /**< Frame number of the frame                                                         */
+    const rs2_stream_profile* profile;          /**< Stream profile of the frame, valid for as long as the frame is held               */
+    int                       is_video;         /**< Non-zero for video frames, the fields below are 0 for the others                  */
+    int                       width;            /**< Frame width in pixels                                                              */
+    int                       height;           /**< Frame height in pixels                                                             */
+    int                       stride_in_bytes;  /**< Number of bytes from start of line N to start of line N+1                          */
+    int                       bits_per_pixel;   /**< Bits per pixel of the frame image                                                  */
+} rs2_frame_info;
+
 
 /**
 * retrieve metadata from frame handle
@@ -118,6 +160,17 @@ rs2_metadata_type rs2_get_frame_metadata(const rs2_frame* frame, rs2_frame_metad
 */
 int rs2_supports_frame_metadata(const rs2_frame* frame, rs2_frame_metadata_value frame_metadata, rs2_error** error);
 
+/**
+* retrieve all the metadata of a frame handle at once, without the cost of an error for the attributes it does not support
+* \param[in] frame         handle returned from a callback
+* \param[out] values       array of count values, indexed by rs2_frame_metadata_value, receiving those of the supported metadata
+* \param[out] supported    array of count flags, indexed by rs2_frame_metadata_value, set to 1 for the supported metadata and 0 for the others
+* \param[in] count         number of metadata to retrieve, from the first one, up to RS2_FRAME_METADATA_COUNT
+* \param[out] error        if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return                  number of metadata the frame supports
+*/
+int rs2_get_frame_metadata_all(const rs2_frame* frame, rs2_metadata_type* values, int* supported, int count, rs2_error** error);
+
 /**
 * retrieve timestamp domain from frame handle. timestamps can only be comparable if they are in common domain
 * (for example, depth timestamp might come from system time while color timestamp might come from the device)
@@ -152,6 +205,56 @@ unsigned long long rs2_get_frame_number(const rs2_frame* frame, rs2_error** erro
 */
 const void* rs2_get_frame_data(const rs2_frame* frame, rs2_error** error);
 
+/**
+* retrieve the device memory holding the data of a GPU-resident frame, see RS2_EXTENSION_GPU_FRAME.
+* Frames are GPU-resident when librealsense is built with CUDA and the frame was produced on the GPU
+* \param[in] frame      handle returned from a callback
+* \param[out] error     if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return               the CUDA device pointer to the start of the frame data, valid for as long as the frame is held
+*/
+const void* rs2_get_frame_device_pointer(const rs2_frame* frame, rs2_error** error);
+
+/**
+* retrieve the DMABUF holding the data of a frame delivered in an exported backend buffer, see RS2_EXTENSION_DMABUF_FRAME.
+* Frames are exported on Linux with LRS_V4L_DMABUF=1 set, for the pass-through formats of sensors with RS2_OPTION_ZERO_COPY_ENABLED,
+* on kernels with a metadata node and drivers that support VIDIOC_EXPBUF
+* \param[in] frame      handle returned from a callback
+* \param[out] offset    if non-null, receives the offset of the frame data in bytes from the start of the DMABUF
+* \param[out] stride    if non-null, receives the distance in bytes between the starts of consecutive rows
+* \param[out] error     if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return               the DMABUF file descriptor, owned by librealsense and valid for as long as the frame is held
+*/
+int rs2_get_frame_dmabuf(const rs2_frame* frame, int* offset, int* stride, rs2_error** error);
+
+/**
+* retrieve the samples of a batched motion frame, see RS2_EXTENSION_MOTION_BATCH_FRAME.
+* Motion sensors deliver batched frames when RS2_OPTION_MOTION_BATCH_SIZE is above 1, for the streams of format RS2_FORMAT_MOTION_XYZ32F.
+* RS2_OPTION_MOTION_BATCH_LATENCY bounds the time the samples wait for their batch to be delivered.
+* The timestamp and frame number of the frame are those of its first sample, whose motion is the data of the frame as a motion frame
+* \param[in] frame      handle returned from a callback
+* \param[out] count     receives the number of samples of the frame
+* \param[out] error     if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return               the samples of the frame in the order they were captured, valid for as long as the frame is held
+*/
+const rs2_motion_sample* rs2_get_motion_samples(const rs2_frame* frame, int* count, rs2_error** error);
+
+/**
+* retrieve the samples of a motion stream of the sensor captured within a time range, see RS2_EXTENSION_MOTION_HISTORY.
+* The motion sensors keep the latest few seconds of the samples of their RS2_FORMAT_MOTION_XYZ32F streams as they capture them,
+* for the samples between the timestamps of two frames to be read without buffering the motion frames
+* \param[in] sensor     the motion sensor
+* \param[in] stream     RS2_STREAM_GYRO or RS2_STREAM_ACCEL
+* \param[in] index      the index of the stream
+* \param[in] begin      the earliest timestamp of the samples, in milliseconds and in the timestamp domain of the frames of the stream
+* \param[in] end        the latest timestamp of the samples, inclusive
+* \param[out] timestamps receives the timestamps of the samples, oldest first. May be null
+* \param[out] motion    receives the X, Y, Z values of the samples, in the same order. May be null
+* \param[in] capacity   the number of samples the arrays hold
+* \param[out] error     if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return               the number of samples written, the oldest of those in range when there are more than capacity
+*/
+int rs2_get_motion_history(const rs2_sensor* sensor, rs2_stream stream, int index, double begin, double end, double* timestamps, rs2_vector* motion, int capacity, rs2_error** error);
+
 /**
 * retrieve frame width in pixels
 * \param[in] frame      handle returned from a callback
@@ -185,6 +288,27 @@ int rs2_get_frame_stride_in_bytes(const rs2_frame* frame, rs2_error** error);
 */
 int rs2_get_frame_bits_per_pixel(const rs2_frame* frame, rs2_error** error);
 
+/**
+* retrieve the data, timestamp, frame number, stream profile and, of video frames, the dimensions of a frame handle at once.
+* Frames that are not video frames are not an error, their video fields are set to 0
+* \param[in] frame      handle returned from a callback
+* \param[out] info      receives the common fields of the frame
+* \param[out] error     if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_get_frame_info(const rs2_frame* frame, rs2_frame_info* info, rs2_error** error);
+
+/**
+* convert the image of a video frame into another format, straight into a buffer of the application, in a single pass.
+* Frames convert from YUYV to Y8, Y16, RGB8, RGBA8, BGR8 and BGRA8, from UYVY to RGB8, RGBA8, BGR8 and BGRA8, from Y8 to Y16,
+* between RGB8 and BGR8, and to their own format
+* \param[in] frame        handle returned from a callback
+* \param[out] dest        buffer of at least height rows of dest_stride bytes, receiving the converted image
+* \param[in] dest_stride  number of bytes from the start of a row of dest to the start of the next, 0 for rows right one after the other
+* \param[in] format       format to convert the image into
+* \param[out] error       if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_frame_copy_to(const rs2_frame* frame, void* dest, int dest_stride, rs2_format format, rs2_error** error);
+
 /**
 * create additional reference to a frame without duplicating frame data
 * \param[in] frame      handle returned from a callback
@@ -210,12 +334,24 @@ void rs2_keep_frame(rs2_frame* frame);
 /**
 * When called on Points frame type, this method returns a pointer to an array of 3D vertices of the model
 * The coordinate system is: X right, Y up, Z away from the camera. Units: Meters
+* For RS2_FORMAT_XYZ16 and RS2_FORMAT_XYZ16F points profiles the array holds 3 16-bit values per vertex instead, as described by the format
 * \param[in] frame       Points frame
 * \param[out] error      If non-null, receives any error that occurs during this call, otherwise, errors are ignored
 * \return                Pointer to an array of vertices, lifetime is managed by the frame
 */
 rs2_vertex* rs2_get_frame_vertices(const rs2_frame* frame, rs2_error** error);
 
+/**
+* When called on Points frame type, this method returns a pointer to the X, Y or Z of every vertex, of the planar points
+* computed with the RS2_OPTION_POINTS_LAYOUT of the pointcloud block set to planar. A null pointer is returned for interleaved
+* points, and rs2_get_frame_vertices fails for planar ones
+* \param[in] frame       Points frame
+* \param[in] axis        0 for X, 1 for Y and 2 for Z
+* \param[out] error      If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return                Pointer to an array of floats, one per vertex, lifetime is managed by the frame
+*/
+const float* rs2_get_frame_vertex_plane(const rs2_frame* frame, int axis, rs2_error** error);
+
 /**
 * When called on Points frame type, this method creates a ply file of the model with the given file name.
 * \param[in] frame       Points frame
@@ -225,9 +361,24 @@ rs2_vertex* rs2_get_frame_vertices(const rs2_frame* frame, rs2_error** error);
 */
 void rs2_export_to_ply(const rs2_frame* frame, const char* fname, rs2_frame* texture, rs2_error** error);
 
+/**
+* When called on Points frame type, this method creates a ply file of the model, optionally with the normals of its vertices and the triangles between them
+* Normals and faces are of the neighbouring pixels of the depth image, for points of all its pixels or with their pixel indices (RS2_OPTION_COMPACT_POINTS)
+* \param[in] frame       Points frame
+* \param[in] fname       The name for the ply file
+* \param[in] texture     Texture frame, or null
+* \param[in] normals     Non-zero to export the normal of every vertex
+* \param[in] faces       Non-zero to export the triangles between neighbouring vertices, not across depth edges
+* \param[out] error      If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_export_mesh_to_ply(const rs2_frame* frame, const char* fname, rs2_frame* texture, int normals, int faces, rs2_error** error);
+
 /**
 * When called on Points frame type, this method returns a pointer to an array of texture coordinates per vertex
 * Each coordinate represent a (u,v) pair within [0,1] range, to be mapped to texture image
+* For RS2_FORMAT_XYZ16 and RS2_FORMAT_XYZ16F points profiles the pairs are 16-bit floating point values
+* The point clouds of no mapped texture hold no texture coordinates, and read as zeros allocated on the first call. The
+* pointcloud block computes those of a mapped texture on the first call, or the first read of the frame data
 * \param[in] frame       Points frame
 * \param[out] error      If non-null, receives any error that occurs during this call, otherwise, errors are ignored
 * \return                Pointer to an array of texture coordinates, lifetime is managed by the frame
@@ -242,6 +393,33 @@ rs2_pixel* rs2_get_frame_texture_coordinates(const rs2_frame* frame, rs2_error**
 */
 int rs2_get_frame_points_count(const rs2_frame* frame, rs2_error** error);
 
+/**
+* When called on Points frame type, this method returns a pointer to an array of the depth pixel indices per vertex
+* Only compacted point clouds, holding the valid points alone, carry them. A null pointer is returned otherwise
+* \param[in] frame       Points frame
+* \param[out] error      If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return                Pointer to an array of pixel indices (y * width + x of the depth frame), lifetime is managed by the frame
+*/
+const int* rs2_get_frame_pixel_indices(const rs2_frame* frame, rs2_error** error);
+
+/**
+* When called on Points frame type, this method returns a pointer to an array of the unit normal of every vertex, facing the camera
+* Only point clouds computed with normals carry them, see RS2_OPTION_NORMALS_WINDOW. A null pointer is returned otherwise
+* \param[in] frame       Points frame
+* \param[out] error      If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return                Pointer to an array of normals, zero for the vertices without depth or neighbours, lifetime is managed by the frame
+*/
+const rs2_vertex* rs2_get_frame_normals(const rs2_frame* frame, rs2_error** error);
+
+/**
+* When called on Points frame type, this method returns a pointer to the red, green and blue bytes of every vertex
+* Only point clouds of blocks that sample the colors of their points carry them, see rs2_create_colored_pointcloud_block. A null pointer is returned otherwise
+* \param[in] frame       Points frame
+* \param[out] error      If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return                Pointer to 3 bytes per vertex, zero for the vertices without depth or out of the color image, lifetime is managed by the frame
+*/
+const unsigned char* rs2_get_frame_colors(const rs2_frame* frame, rs2_error** error);
+
 /**
 * Returns the stream profile that was used to start the stream of this frame
 * \param[in] frame       frame reference, owned by the user
@@ -287,6 +465,31 @@ rs2_frame* rs2_allocate_synthetic_video_frame(rs2_source* source, const rs2_stre
 */
 rs2_frame* rs2_allocate_points(rs2_source* source, const rs2_stream_profile* new_stream, rs2_frame* original, rs2_error** error);
 
+/**
+* Allocate new points frame holding a given number of vertices, using a frame-source provided from a processing block
+* \param[in] source         Frame pool to allocate the frame from
+* \param[in] new_stream     New stream profile to assign to newly created frame
+* \param[in] original       A reference frame that can be used to fill in auxilary information like format, width, height, bpp, stride (if applicable)
+* \param[in] count          Number of vertices of the frame
+* \param[in] pixel_indices  Non-zero to also store the depth pixel index of every vertex
+* \param[out] error         If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return                   reference to a newly allocated frame, must be released with release_frame
+*                           memory for the frame is likely to be re-used from previous frame, but in lack of available frames in the pool will be allocated from the free store
+*/
+rs2_frame* rs2_allocate_compact_points(rs2_source* source, const rs2_stream_profile* new_stream, rs2_frame* original, int count, int pixel_indices, rs2_error** error);
+
+/**
+* Allocate new points frame holding a given number of vertices and the normal of every vertex, using a frame-source provided from a processing block
+* \param[in] source         Frame pool to allocate the frame from
+* \param[in] new_stream     New stream profile to assign to newly created frame
+* \param[in] original       A reference frame that can be used to fill in auxilary information like format, width, height, bpp, stride (if applicable)
+* \param[in] count          Number of vertices of the frame
+* \param[in] pixel_indices  Non-zero to also store the depth pixel index of every vertex
+* \param[out] error         If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return                   reference to a newly allocated frame, must be released with release_frame
+*/
+rs2_frame* rs2_allocate_points_with_normals(rs2_source* source, const rs2_stream_profile* new_stream, rs2_frame* original, int count, int pixel_indices, rs2_error** error);
+
 /**
 * Allocate new composite frame, aggregating a set of existing frames
 * \param[in] source      Frame pool to allocate the frame from
@@ -334,6 +537,30 @@ void rs2_synthetic_frame_ready(rs2_source* source, rs2_frame* frame, rs2_error**
 */
 void rs2_pose_frame_get_pose_data(const rs2_frame* frame, rs2_pose* pose, rs2_error** error);
 
+/**
+* Retrieves the latest pose of a pose stream as soon as the sensor receives it, without waiting on the pose frames,
+* from sensors extendable to RS2_EXTENSION_POSE_PREDICTION. The call never blocks on the thread receiving the poses
+* \param[in] sensor      the sensor streaming the poses
+* \param[in] index       the index of the pose stream
+* \param[out] pose       receives the latest pose
+* \param[out] timestamp  receives the timestamp of the pose, in the timestamp domain of the pose frames. May be null
+* \param[out] error      If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return                1 if the pose was written, 0 while the stream sent no pose
+*/
+int rs2_get_latest_pose(const rs2_sensor* sensor, int index, rs2_pose* pose, double* timestamp, rs2_error** error);
+
+/**
+* Predicts the pose of a pose stream at a timestamp, usually ahead of the latest pose, by extrapolation of its velocity
+* and acceleration, for rendering with the pose of when the frame is to be shown. See rs2_get_latest_pose
+* \param[in] sensor      the sensor streaming the poses
+* \param[in] index       the index of the pose stream
+* \param[in] timestamp   the timestamp to predict the pose at, in milliseconds in the timestamp domain of the pose frames
+* \param[out] pose       receives the predicted pose
+* \param[out] error      If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return                1 if the pose was written, 0 while the stream sent no pose
+*/
+int rs2_predict_pose(const rs2_sensor* sensor, int index, double timestamp, rs2_pose* pose, rs2_error** error);
+
 #ifdef __cplusplus
 }
 #endif
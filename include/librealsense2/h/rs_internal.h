@@ -13,6 +13,7 @@
 #ifdef __cplusplus
 extern "C" {
 #endif
+#include <stddef.h>
 #include "rs_types.h"
 #include "rs_context.h"
 #include "rs_sensor.h"
@@ -25,8 +26,8 @@ extern "C" {
 typedef enum rs2_recording_mode
 {
     RS2_RECORDING_MODE_BLANK_FRAMES, /* frame metadata will be recorded, but pixel data will be replaced with zeros to save space */
-    RS2_RECORDING_MODE_COMPRESSED,   /* frames will be encoded using a proprietary lossy encoding, aiming at x5 compression at some CPU expense */
-    RS2_RECORDING_MODE_BEST_QUALITY, /* frames will not be compressed, but rather stored as-is. This gives best quality and low CPU overhead, but you might run out of memory */
+    RS2_RECORDING_MODE_COMPRESSED,   /* frames will be compressed losslessly with LZ4, at little CPU expense */
+    RS2_RECORDING_MODE_BEST_QUALITY, /* frames will not be compressed, but rather stored as-is. This gives best quality and low CPU overhead, at the most disk space */
     RS2_RECORDING_MODE_COUNT
 } rs2_recording_mode;
 
@@ -115,6 +116,16 @@ rs2_sensor* rs2_software_device_add_sensor(rs2_device* dev, const char* sensor_n
  */
 void rs2_software_sensor_on_video_frame(rs2_sensor* sensor, rs2_software_video_frame frame, rs2_error** error);
 
+/**
+ * Inject several frames to software sensor at once, of any of its streams, in order. Saves the cost of a call per
+ * frame when frames are injected faster than cameras would produce them
+ * \param[in] sensor the software sensor
+ * \param[in] frames the frames, each handed over to the sensor as by rs2_software_sensor_on_video_frame
+ * \param[in] count  the number of frames
+ * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_software_sensor_on_video_frames(rs2_sensor* sensor, const rs2_software_video_frame* frames, int count, rs2_error** error);
+
 /**
 * Set frame metadata for the upcoming frames
 * \param[in] sensor the software sensor
@@ -157,6 +168,49 @@ void rs2_software_sensor_add_read_only_option(rs2_sensor* sensor, rs2_option opt
  * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
  */
 void rs2_software_sensor_update_read_only_option(rs2_sensor* sensor, rs2_option option, float val, rs2_error** error);
+
+typedef void* (*rs2_frame_allocator_alloc_ptr)(size_t size, size_t alignment, void* user);
+typedef void  (*rs2_frame_allocator_free_ptr)(void* ptr, size_t size, void* user);
+
+/**
+ * Provide the storage for the frame data produced by a sensor. Both callbacks may be invoked concurrently from library threads,
+ * and the allocator must remain valid for as long as frames allocated with it are alive.
+ * Takes effect the next time the sensor is opened
+ * \param[in] sensor     the sensor
+ * \param[in] alloc      allocate a buffer of the given size and alignment, returns nullptr on failure. Pass nullptr to restore the default allocator
+ * \param[in] free       release a buffer previously returned by alloc
+ * \param[in] alignment  required alignment of the frame data, must be a power of two
+ * \param[in] user       auxiliary data passed to the callbacks
+ * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_set_frame_allocator(rs2_sensor* sensor, rs2_frame_allocator_alloc_ptr alloc, rs2_frame_allocator_free_ptr free, size_t alignment, void* user, rs2_error** error);
+
+/**
+ * Capture a stream into buffers of the application the next times the sensor is opened, for the driver to write the frames
+ * into them directly. Pass-through formats with RS2_OPTION_ZERO_COPY_ENABLED are then delivered in these buffers without any copy.
+ * The buffers must outlive the streaming, and hold the frame with 255 more bytes for its metadata. Frames held by the application
+ * keep their buffers away from the driver, so register enough of them to cover the frames queue. Only supported on Linux
+ * \param[in] sensor     the RealSense sensor, which must not be opened
+ * \param[in] stream     stream type of the profile that will be opened
+ * \param[in] index      stream index of the profile that will be opened
+ * \param[in] buffers    the start of each buffer, or null to go back to buffers of librealsense
+ * \param[in] count      number of buffers, between 1 and 32, or 0 to go back to buffers of librealsense
+ * \param[in] size       size in bytes of every buffer
+ * \param[out] error     if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_set_user_buffers(rs2_sensor* sensor, rs2_stream stream, int index, void** buffers, int count, size_t size, rs2_error** error);
+
+/**
+ * Provide the storage for the frame data of all the sensors of the devices created by the context,
+ * unless a sensor was given its own allocator via rs2_set_frame_allocator. Takes effect the next time a sensor is opened
+ * \param[in] context    the context
+ * \param[in] alloc      allocate a buffer of the given size and alignment, returns nullptr on failure. Pass nullptr to restore the default allocator
+ * \param[in] free       release a buffer previously returned by alloc
+ * \param[in] alignment  required alignment of the frame data, must be a power of two
+ * \param[in] user       auxiliary data passed to the callbacks
+ * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_context_set_frame_allocator(rs2_context* context, rs2_frame_allocator_alloc_ptr alloc, rs2_frame_allocator_free_ptr free, size_t alignment, void* user, rs2_error** error);
 #ifdef __cplusplus
 }
 #endif
@@ -67,6 +67,42 @@ extern "C" {
         RS2_OPTION_STREAM_FILTER, /**< Select a stream to process */
         RS2_OPTION_STREAM_FORMAT_FILTER, /**< Select a stream format to process */
         RS2_OPTION_STREAM_INDEX_FILTER, /**< Select a stream index to process */
+        RS2_OPTION_FRAMES_MEMORY_BUDGET, /**< Max memory in megabytes the frames the user keeps per stream may occupy, 0 for unlimited. Frames beyond the budget are dropped.*/
+        RS2_OPTION_ZERO_COPY_ENABLED, /**< Deliver pass-through formats in the backend buffers without copying them. Applied when the sensor is opened*/
+        RS2_OPTION_FRAMES_HUGE_PAGES, /**< Back large frame buffers with 2MB huge pages to reduce TLB misses (Linux only). Applied when the sensor is opened*/
+        RS2_OPTION_UNPACK_THREADS, /**< Number of threads converting each frame from its native format, in bands of rows. Applied when the sensor is opened*/
+        RS2_OPTION_DEFERRED_UNPACK, /**< Convert frames from their native format on the first access to their data, instead of on arrival. Applied when the sensor is opened*/
+        RS2_OPTION_PROCESSING_THREADS, /**< Number of threads a processing block splits the work on each frame across*/
+        RS2_OPTION_COMPACT_POINTS, /**< Output only the points with valid depth, optionally with the index of the depth pixel of every point*/
+        RS2_OPTION_POINTS_FORMAT, /**< Format of the vertices and texture coordinates of a point cloud: XYZ32F, XYZ16 or XYZ16F*/
+        RS2_OPTION_HISTOGRAM_SAMPLING, /**< Number of frames over which the depth histogram of the colorizer is recounted, one in that many rows every frame*/
+        RS2_OPTION_FUSED_DISPARITY_TO_DEPTH, /**< Output depth from disparity input, in place of a disparity to depth transform following the filter*/
+        RS2_OPTION_PROCESSING_STATISTICS, /**< Record the frames a processing block is invoked on and drops, and the time it takes to process them*/
+        RS2_OPTION_PROCESSED_FRAMES, /**< Number of frames the processing block was invoked on while recording statistics. Read-only*/
+        RS2_OPTION_DROPPED_FRAMES, /**< Number of frames the processing block failed to process while recording statistics. Read-only*/
+        RS2_OPTION_PROCESSING_TIME_P50, /**< Median processing time of the recent frames, in milliseconds. Read-only*/
+        RS2_OPTION_PROCESSING_TIME_P99, /**< 99th percentile of the processing time of the recent frames, in milliseconds. Read-only*/
+        RS2_OPTION_CROP_TO_ROI, /**< Output only the region of interest of a processing block, instead of the whole frame*/
+        RS2_OPTION_SYNC_LATENCY_BUDGET, /**< Longest time, in milliseconds, the syncer holds a frameset back waiting for its missing frames. 0 waits for as long as the frame rates suggest*/
+        RS2_OPTION_BACKEND_BUFFERS, /**< Number of kernel buffers each stream of the sensor captures into, or of USB transfers it keeps in flight with the libuvc backend, 0 to derive it from the frame rate and RS2_OPTION_BUFFERS_LATENCY_TOLERANCE. Applied when the sensor is opened*/
+        RS2_OPTION_BUFFERS_LATENCY_TOLERANCE, /**< Longest stall, in milliseconds, of the frame callbacks that the automatic number of kernel buffers absorbs without dropping frames. Applied when the sensor is opened*/
+        RS2_OPTION_MOTION_BATCH_SIZE, /**< Number of motion samples delivered together in a single frame, see RS2_EXTENSION_MOTION_BATCH_FRAME. 1 delivers every sample in its own frame. Applied when the sensor is opened*/
+        RS2_OPTION_CONTROLS_CACHE_TTL, /**< Time, in milliseconds, the values of the controls that the camera changes by itself, such as the exposure under auto exposure, are reused without querying the camera. The controls only the host changes are reused until written or reset. 0 queries the former every time. Only the controls the device opts in to caching are reused, the others are queried every time*/
+        RS2_OPTION_WARM_RESTART, /**< Keep the device streaming, with the frame callbacks stopped, when a UVC sensor is closed, so that opening it again with the same profiles resumes without restarting the streams*/
+        RS2_OPTION_GLOBAL_TIME_ENABLED, /**< Map the hardware timestamps of the frames onto the monotonic clock of the host, see RS2_TIMESTAMP_DOMAIN_GLOBAL_TIME*/
+        RS2_OPTION_MOTION_BATCH_LATENCY, /**< Longest time, in milliseconds, a motion sample waits in its batch, which caps RS2_OPTION_MOTION_BATCH_SIZE at the samples the stream captures meanwhile. 0 for no bound. Applied when the sensor is opened*/
+        RS2_OPTION_VOXEL_SIZE, /**< Edge length, in meters, of the cubes of the grid a voxel filter downsamples the points into*/
+        RS2_OPTION_VOXEL_POINT, /**< Point a voxel filter outputs for every occupied voxel: the centroid of its points, or the first of them*/
+        RS2_OPTION_NORMALS_WINDOW, /**< Half the side, in pixels, of the window of neighbours the normals of the points are averaged over. 0 computes no normals*/
+        RS2_OPTION_TSDF_TRUNCATION, /**< Distance, in meters, from the surfaces beyond which the signed distances of a fusion volume are truncated*/
+        RS2_OPTION_TSDF_MAX_WEIGHT, /**< Number of frames the signed distances of a fusion volume are averaged over at most, for the volume to follow the changes of the scene*/
+        RS2_OPTION_DEPTH_STATISTICS, /**< Attach the min, max, mean, fill rate and histogram of the output depth to its frames as metadata*/
+        RS2_OPTION_DEPTH_HISTOGRAM_RANGE, /**< Depth, in meters, the bins of the depth histogram metadata span*/
+        RS2_OPTION_DISTANCE_OUTPUT, /**< Output depth as RS2_FORMAT_DISTANCE, in float meters, instead of RS2_FORMAT_Z16*/
+        RS2_OPTION_TARGET_SCALE, /**< Scale of the resolution of the image the depth is aligned to, for the aligned depth to be computed at a reduced resolution*/
+        RS2_OPTION_CALLBACK_THREADS, /**< Number of threads the frame callback of the sensor may be invoked on at once. Above one, the callback must be thread-safe*/
+        RS2_OPTION_ORDERED_CALLBACKS, /**< With more callback threads than one, deliver the frames of every stream one at a time and in order*/
+        RS2_OPTION_POINTS_LAYOUT, /**< Layout of the XYZ32F vertices of a point cloud: interleaved, or in planes of X, Y and Z read by rs2_get_frame_vertex_plane*/
         RS2_OPTION_COUNT                                        /**< Number of enumeration values. Not a valid input: intended to be used in for-loops. */
     } rs2_option;
     const char* rs2_option_to_string(rs2_option option);
@@ -130,6 +166,31 @@ extern "C" {
     */
     void rs2_set_option(const rs2_options* options, rs2_option option, float value, rs2_error** error);
 
+    /**
+    * write new values to many options in a single call, the controls of a sensor being written within one power up of the device,
+    * and the values the sensor has cached for its controls not being written again. An item failing does not stop the others
+    * \param[in] options     the options container
+    * \param[in] option_ids  options to be written
+    * \param[in] values      new values of the options, one per option
+    * \param[in] count       number of options
+    * \param[out] statuses   if non-null, receives 1 for every option that was written, 0 for the others
+    * \param[out] error      if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+    * \return                number of options written
+    */
+    int rs2_set_options(const rs2_options* options, const rs2_option* option_ids, const float* values, int count, int* statuses, rs2_error** error);
+
+    /**
+    * read the values of many options in a single call, the controls of a sensor being read within one power up of the device
+    * \param[in] options     the options container
+    * \param[in] option_ids  options to be queried
+    * \param[out] values     receives the values of the options, 0 for those that failed
+    * \param[in] count       number of options
+    * \param[out] statuses   if non-null, receives 1 for every option that was read, 0 for the others
+    * \param[out] error      if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+    * \return                number of options read
+    */
+    int rs2_get_options(const rs2_options* options, const rs2_option* option_ids, float* values, int count, int* statuses, rs2_error** error);
+
     /**
     * check if particular option is supported by a subdevice
     * \param[in] sensor     the RealSense sensor
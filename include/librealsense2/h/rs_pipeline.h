@@ -16,6 +16,18 @@ extern "C" {
 
 #include "rs_types.h"
 #include "rs_sensor.h"
+#include "rs_record_playback.h"
+
+    /** \brief A step the load governor of a pipeline takes to lower its load, see rs2_config_enable_load_governor */
+    typedef enum rs2_load_action
+    {
+        RS2_LOAD_ACTION_RAISE_DECIMATION,   /**< Raise the magnitude of the decimation filters of the configuration by one, up to their maximum */
+        RS2_LOAD_ACTION_SKIP_TEMPORAL,      /**< Pass the framesets around the temporal filters of the configuration */
+        RS2_LOAD_ACTION_DROP_STREAMS,       /**< Leave the streams of low priority out of the framesets, see rs2_config_set_low_priority_stream */
+        RS2_LOAD_ACTION_HALVE_RATE,         /**< Deliver every other frameset of those the previous levels deliver */
+        RS2_LOAD_ACTION_COUNT
+    } rs2_load_action;
+    const char* rs2_load_action_to_string(rs2_load_action action);
 
     /**
     * Create a pipeline instance
@@ -90,6 +102,20 @@ extern "C" {
     */
     int rs2_pipeline_try_wait_for_frames(rs2_pipeline* pipe, rs2_frame** output_frame, unsigned int timeout_ms, rs2_error ** error);
 
+    /**
+    * Wait for the first of several frame queues and started pipelines to have frames, for a single thread to consume those of
+    * many devices with no polling. The frames are left where they are, for rs2_poll_for_frame or rs2_pipeline_poll_for_frames
+    * to fetch them from the one returned
+    * \param[in] queues          frame queues to wait on, null of a count of zero
+    * \param[in] queue_count     number of frame queues
+    * \param[in] pipes           started pipelines to wait on, null of a count of zero
+    * \param[in] pipe_count      number of pipelines
+    * \param[in] timeout_ms      max time in milliseconds to wait, 0 to only check which has frames
+    * \param[out] error          if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+    * \return the index of the first with frames, from 0 to queue_count - 1 of a queue and from queue_count of a pipeline, or -1 on timeout
+    */
+    int rs2_wait_for_any(rs2_frame_queue** queues, int queue_count, rs2_pipeline** pipes, int pipe_count, unsigned int timeout_ms, rs2_error ** error);
+
     /**
     * Delete a pipeline instance.
     * Upon destruction, the pipeline will implicitly stop itself
@@ -144,6 +170,31 @@ extern "C" {
     */
     rs2_pipeline_profile* rs2_pipeline_get_active_profile(rs2_pipeline* pipe, rs2_error ** error);
 
+    /** \brief Frames of an active pipeline at every stage from its sensors to the application, counted since it was started. Always kept */
+    typedef struct rs2_pipeline_health
+    {
+        rs2_sensor_health sensors;              /**< Sum of the counters of the sensors the pipeline streams from, playback sensors excepted */
+        unsigned long long sync_received;       /**< Frames that reached the syncers of the pipeline */
+        unsigned long long sync_drops;          /**< Frames the syncers dropped, for overflowing their queues or for the streams having stopped */
+        unsigned long long sync_queue_depth;    /**< Frames currently waiting in the syncers for their matches */
+        unsigned long long framesets_queued;    /**< Framesets queued for the application */
+        unsigned long long queue_drops;         /**< Framesets replaced in the queue by newer ones before the application read them */
+        unsigned long long queue_depth;         /**< Framesets currently waiting to be read */
+        unsigned long long framesets_delivered; /**< Framesets the application read */
+        unsigned long long load_level;          /**< Actions of the load governor in effect, 0 at full quality */
+        unsigned long long governor_skips;      /**< Framesets the load governor did not deliver, to lower the rate */
+    } rs2_pipeline_health;
+
+    /**
+    * Retrieve the counters of the frames received, dropped and queued at every stage of the pipeline.
+    * The method returns a valid result only when the pipeline is active, and does not wait for a call waiting for frames to return.
+    *
+    * \param[in] pipe    a pointer to an instance of the pipeline
+    * \param[out] health receives the counters
+    * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+    */
+    void rs2_pipeline_get_health(rs2_pipeline* pipe, rs2_pipeline_health* health, rs2_error ** error);
+
     /**
     * Retrieve the device used by the pipeline.
     * The device class provides the application access to control camera additional settings -
@@ -248,6 +299,19 @@ extern "C" {
     */
     void rs2_config_enable_device(rs2_config* config, const char* serial, rs2_error ** error);
 
+    /**
+    * Add a device by its serial number to the devices the pipeline streams from, resolving the same stream requests for
+    * every one of them. The first device added is the one selected by \c rs2_config_enable_device(), and the profile of
+    * the pipeline is that of this device. The framesets of the other devices are matched with its framesets on the host
+    * times of their frames, and the pipeline returns framesets of the frames of all the devices.
+    * Not supported together with playback from a file or recording to a file.
+    *
+    * \param[in] config    A pointer to an instance of a config
+    * \param[in] serial device serial number, as returned by RS2_CAMERA_INFO_SERIAL_NUMBER
+    * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+    */
+    void rs2_config_add_device(rs2_config* config, const char* serial, rs2_error ** error);
+
     /**
     * Select a recorded device from a file, to be used by the pipeline through playback.
     * The device available streams are as recorded to the file, and \c resolve() considers only this device and configuration
@@ -285,6 +349,64 @@ extern "C" {
     */
     void rs2_config_enable_record_to_file(rs2_config* config, const char* file, rs2_error ** error);
 
+    /**
+    * Sets the compression of the frames of a stream in the file enable_record_to_file() records to
+    *
+    * \param[in] config      A pointer to an instance of a config
+    * \param[in] stream      The stream type
+    * \param[in] compression The compression of the frames of the stream, RS2_RECORD_COMPRESSION_NONE by default
+    * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+    */
+    void rs2_config_enable_record_compression(rs2_config* config, rs2_stream stream, rs2_record_compression compression, rs2_error ** error);
+
+    /**
+    * Requires that the resolved streams fit the estimated bandwidth of the USB bus of the device, together with the streams
+    * the other devices on the same bus run in this process. Configurations that do not fit fail to resolve, with an error
+    * that suggests the nearest streams that fit, at lower frame rates or resolutions.
+    *
+    * \param[in] config    A pointer to an instance of a config
+    * \param[in] enable    Non-zero to check the bandwidth when resolving, zero to skip the check (default)
+    * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+    */
+    void rs2_config_enable_usb_bandwidth_check(rs2_config* config, int enable, rs2_error ** error);
+
+    /**
+    * Adds a processing block that the pipeline runs on the framesets it outputs, on a worker thread of its own, after the
+    * frames are synchronized and before they are returned by wait_for_frames and poll_for_frames. The blocks run in the
+    * order they were added, each on the output of the previous one, and take over the output of the block.
+    * A processing graph can be added for blocks that are not a chain.
+    *
+    * \param[in] config    A pointer to an instance of a config
+    * \param[in] block     The processing block to run on the framesets of the pipeline
+    * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+    */
+    void rs2_config_add_processing_block(rs2_config* config, rs2_processing_block* block, rs2_error ** error);
+
+    /**
+    * Enables a governor that bounds the latency of the framesets of the pipeline under load. The latency is taken from the
+    * driver to the application reading the frameset, together with the framesets the queue of the application drops.
+    * Under load, the governor takes the actions one at a time in order, each one a level of degradation, and undoes them in
+    * the reverse order once the load subsides for long enough, the time it waits growing when the load returns right after.
+    * An action may be repeated, to raise the decimation or to halve the rate several times
+    *
+    * \param[in] config          A pointer to an instance of a config
+    * \param[in] max_latency_ms  Latency the framesets are to be delivered within, zero to disable the governor
+    * \param[in] actions         The actions in the order they are taken
+    * \param[in] count           Number of actions
+    * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+    */
+    void rs2_config_enable_load_governor(rs2_config* config, float max_latency_ms, const rs2_load_action* actions, int count, rs2_error ** error);
+
+    /**
+    * Sets a stream as of low priority, for RS2_LOAD_ACTION_DROP_STREAMS to leave it out of the framesets
+    *
+    * \param[in] config    A pointer to an instance of a config
+    * \param[in] stream    Stream type
+    * \param[in] index     Stream index, -1 for every stream of the type
+    * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+    */
+    void rs2_config_set_low_priority_stream(rs2_config* config, rs2_stream stream, int index, rs2_error ** error);
+
 
     /**
     * Disable a device stream explicitly, to remove any requests on this stream type.
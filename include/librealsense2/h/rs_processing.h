@@ -17,6 +17,17 @@ extern "C" {
 #include "rs_types.h"
 #include "rs_sensor.h"
 
+/** \brief What a frame queue does with a new frame when it is full. */
+typedef enum rs2_frame_queue_policy
+{
+    RS2_FRAME_QUEUE_POLICY_DROP_OLDEST, /**< Drop the oldest frame of the queue to make room */
+    RS2_FRAME_QUEUE_POLICY_DROP_NEWEST, /**< Keep the queued frames and drop the new one */
+    RS2_FRAME_QUEUE_POLICY_BLOCK,       /**< Block the producer until there is room, and drop the new frame after the timeout */
+    RS2_FRAME_QUEUE_POLICY_KEEP_LATEST, /**< Only keep the latest frame, overwriting the previous one whatever the capacity */
+    RS2_FRAME_QUEUE_POLICY_COUNT        /**< Number of enumeration values. Not a valid input: intended to be used in for-loops. */
+} rs2_frame_queue_policy;
+const char* rs2_frame_queue_policy_to_string(rs2_frame_queue_policy policy);
+
 /**
 * Creates Depth-Colorizer processing block that can be used to quickly visualize the depth data
 * This block will accept depth frames as input and replace them by depth frames with format RGB8
@@ -34,6 +45,15 @@ rs2_processing_block* rs2_create_colorizer(rs2_error** error);
 */
 rs2_processing_block* rs2_create_sync_processing_block(rs2_error** error);
 
+/**
+* Creates a processing block matching the frames, or the framesets, of several devices into framesets of all of them.
+* The hardware timestamps of every device are mapped onto the host clock, with the offset and the drift of the device clock
+* estimated as its frames arrive, and the frames taken within half a frame period of each other are matched
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return            new processing block, to be released by rs2_delete_processing_block
+*/
+rs2_processing_block* rs2_create_multi_device_sync_processing_block(rs2_error** error);
+
 /**
 * Creates Point-Cloud processing block. This block accepts depth frames and outputs Points frames
 * In addition, given non-depth frame, the block will align texture coordinate to the non-depth stream
@@ -99,6 +119,48 @@ void rs2_process_frame(rs2_processing_block* block, rs2_frame* frame, rs2_error*
 */
 void rs2_delete_processing_block(rs2_processing_block* block);
 
+/** \brief Invocation statistics of a processing block, recorded while its RS2_OPTION_PROCESSING_STATISTICS option is set */
+typedef struct rs2_processing_block_stats
+{
+    unsigned long long invocations;    /**< Number of frames the block was invoked on */
+    unsigned long long dropped_frames; /**< Number of frames the block failed to process, as when it ran out of frame resources */
+    double             total_time;     /**< Cumulative processing time, in milliseconds */
+    double             p50_time;       /**< Median processing time of the recent frames, in milliseconds */
+    double             p99_time;       /**< 99th percentile of the processing time of the recent frames, in milliseconds */
+} rs2_processing_block_stats;
+
+/**
+* Retrieves the invocation statistics of a processing block. Enabling RS2_OPTION_PROCESSING_STATISTICS clears them
+* \param[in] block          Processing block
+* \param[out] stats         Statistics recorded since they were last enabled
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_get_processing_block_stats(const rs2_processing_block* block, rs2_processing_block_stats* stats, rs2_error** error);
+
+/**
+* Restricts the processing of a depth filter or of the pointcloud to a rectangle of its input frames.
+* Pixels outside it are passed through unprocessed, or left out when RS2_OPTION_CROP_TO_ROI is set.
+* An empty rectangle, the default, processes the whole frame
+* \param[in] block          Processing block
+* \param[in] min_x          Left column of the rectangle
+* \param[in] min_y          Top row of the rectangle
+* \param[in] max_x          Column past the right of the rectangle
+* \param[in] max_y          Row past the bottom of the rectangle
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_set_processing_block_roi(rs2_processing_block* block, int min_x, int min_y, int max_x, int max_y, rs2_error** error);
+
+/**
+* Retrieves the rectangle a processing block restricts its processing to
+* \param[in] block          Processing block
+* \param[out] min_x         Left column of the rectangle
+* \param[out] min_y         Top row of the rectangle
+* \param[out] max_x         Column past the right of the rectangle
+* \param[out] max_y         Row past the bottom of the rectangle
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_get_processing_block_roi(const rs2_processing_block* block, int* min_x, int* min_y, int* max_x, int* max_y, rs2_error** error);
+
 /**
 * create frame queue. frame queues are the simplest x-platform synchronization primitive provided by librealsense
 * to help developers who are not using async APIs
@@ -108,6 +170,46 @@ void rs2_delete_processing_block(rs2_processing_block* block);
 */
 rs2_frame_queue* rs2_create_frame_queue(int capacity, rs2_error** error);
 
+/**
+* create frame queue with a policy for the frames that arrive while it is full
+* \param[in] capacity   max number of frames to allow to be stored in the queue
+* \param[in] policy     what to do with a new frame when the queue is full
+* \param[in] timeout_ms how long RS2_FRAME_QUEUE_POLICY_BLOCK blocks the producer before dropping the new frame
+* \param[out] error     if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return handle to the frame queue, must be released using rs2_delete_frame_queue
+*/
+rs2_frame_queue* rs2_create_frame_queue_with_policy(int capacity, rs2_frame_queue_policy policy, unsigned int timeout_ms, rs2_error** error);
+
+/**
+* retrieve the number of frames the queue dropped since it was created, whichever its policy
+* \param[in] queue  the frame queue data structure
+* \param[out] error if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return the number of dropped frames
+*/
+unsigned long long rs2_get_frame_queue_dropped_frames(const rs2_frame_queue* queue, rs2_error** error);
+
+/**
+* create frame queue that spills the frames it has no room for to a file instead of dropping them, for a consumer that stalls
+* for a while to lose none of them. The spilled frames are delivered in order after those of the queue, and only the frames
+* that find the file full, of max_spill_bytes of frame data, are dropped. The file is created, or truncated, and is removed
+* with the queue
+* \param[in] capacity        max number of frames to allow to be stored in memory
+* \param[in] spill_file      path of the file to spill the frames to
+* \param[in] max_spill_bytes max size of the spill file
+* \param[out] error          if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return handle to the frame queue, must be released using rs2_delete_frame_queue
+*/
+rs2_frame_queue* rs2_create_frame_queue_with_spill(int capacity, const char* spill_file, unsigned long long max_spill_bytes, rs2_error** error);
+
+/**
+* retrieve the number of frames the queue holds in its spill file, zero for the queues with none
+* \param[in] queue          the frame queue data structure
+* \param[out] spilled_bytes if non-null, receives the bytes of the spill file that the spilled frames take
+* \param[out] error         if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return the number of spilled frames
+*/
+int rs2_get_frame_queue_spilled_frames(const rs2_frame_queue* queue, unsigned long long* spilled_bytes, rs2_error** error);
+
 /**
 * deletes frame queue and releases all frames inside it
 * \param[in] queue queue to delete
@@ -162,6 +264,14 @@ rs2_processing_block* rs2_create_align(rs2_stream align_to, rs2_error** error);
 */
 rs2_processing_block* rs2_create_decimation_filter_block(rs2_error** error);
 
+/**
+* Creates a block that attaches the minimum, maximum and mean of the valid depth of Z16 depth frames, their fill rate and a histogram
+* of their depth to them as metadata, see RS2_FRAME_METADATA_DEPTH_MIN to RS2_FRAME_METADATA_DEPTH_HISTOGRAM and RS2_OPTION_DEPTH_HISTOGRAM_RANGE.
+* The decimation filter computes the same statistics as it writes its output when RS2_OPTION_DEPTH_STATISTICS is on
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_depth_statistics_block(rs2_error** error);
+
 /**
 * Creates Depth post-processing filter block. This block accepts depth frames, applies temporal filter
 * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
@@ -187,6 +297,207 @@ rs2_processing_block* rs2_create_disparity_transform_block(unsigned char transfo
 */
 rs2_processing_block* rs2_create_hole_filling_filter_block(rs2_error** error);
 
+/**
+* Creates a block that losslessly compresses Z16 frames into RS2_FORMAT_Z16_RVL frames, of the same stream and dimensions
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_depth_compressor_block(rs2_error** error);
+
+/**
+* Creates a block that decompresses RS2_FORMAT_Z16_RVL frames back into Z16 frames
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_depth_decompressor_block(rs2_error** error);
+
+/**
+* Creates a block that downsamples point clouds to a single point per occupied voxel of a grid, the centroid of the points in the
+* voxel or the first of them, see RS2_OPTION_VOXEL_SIZE and RS2_OPTION_VOXEL_POINT. It accepts RS2_FORMAT_XYZ32F points, and Z16 depth
+* frames that it deprojects as it bins them, without computing the points of the whole frame first. It outputs RS2_FORMAT_XYZ32F points
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_voxel_filter_block(rs2_error** error);
+
+/**
+* Creates a block that computes the normal map of RS2_FORMAT_XYZ32F point clouds of whole depth images: a video frame of the unit normal
+* of every vertex, facing the camera, as RS2_FORMAT_XYZ32F. The normals are averaged over a window of neighbours, see RS2_OPTION_NORMALS_WINDOW.
+* The point cloud block computes the same normals into its points when its RS2_OPTION_NORMALS_WINDOW is set, see rs2_get_frame_normals
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_normals_filter_block(rs2_error** error);
+
+/**
+* Creates a block that computes the RS2_FORMAT_XYZ32F point cloud of the Z16 depth frame of a frameset in the coordinates of its RGB8, BGR8,
+* RGBA8 or BGRA8 color frame, in a single pass over the raw depth rather than aligning the depth to the color first. Every depth pixel, in order,
+* is transformed to the color camera and projected onto the color image, for its texture coordinates and its color, see rs2_get_frame_colors
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_colored_pointcloud_block(rs2_error** error);
+
+/**
+* Creates a block that merges the Z16 depth frames of a frameset, such as those of the devices the multi-device syncer takes together,
+* into a single RS2_FORMAT_XYZ32F point cloud in the coordinates of the world. Every pixel is deprojected and transformed at once into the
+* output frame. The extrinsics of every depth stream to the world are found in the extrinsics graph, see rs2_pointcloud_merger_set_world_extrinsics.
+* The cameras are output in the order of the frameset, their points with valid depth alone unless RS2_OPTION_COMPACT_POINTS is off.
+* The points of the cameras overlapping are merged into a point per voxel when RS2_OPTION_VOXEL_SIZE is set, see rs2_create_voxel_filter_block
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_pointcloud_merger_block(rs2_error** error);
+
+/**
+* Sets the extrinsics from a stream to the world of a pointcloud merger. The stream is that of the depth frames, or any stream the extrinsics
+* of the device link the depth to, such as the color stream a calibration against a target was done with
+* \param[in] merger    pointcloud merger block
+* \param[in] profile   profile of the stream
+* \param[in] to_world  extrinsics from the stream to the world
+* \param[out] error    if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_pointcloud_merger_set_world_extrinsics(rs2_processing_block* merger, const rs2_stream_profile* profile, const rs2_extrinsics* to_world, rs2_error** error);
+
+/**
+* Creates a block that integrates Z16 depth frames into a truncated signed distance volume for reconstruction, allocated in blocks of voxels
+* around the surfaces alone. The frames pass through the block, and the volume is raycast and extracted on demand.
+* The pose of the camera is that of the pose frame of the frameset, composed with the extrinsics from the depth to the pose stream when known,
+* or else that of rs2_tsdf_fusion_set_camera_pose. With CUDA the volume stays in device memory, as may the depth frames
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_tsdf_fusion_block(rs2_error** error);
+
+/**
+* Sets the pose of the camera of the depth frames without a pose frame, the identity until set
+* \param[in] fusion           TSDF fusion block
+* \param[in] camera_to_world  extrinsics from the depth stream to the world of the volume
+* \param[out] error           if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_tsdf_fusion_set_camera_pose(rs2_processing_block* fusion, const rs2_extrinsics* camera_to_world, rs2_error** error);
+
+/**
+* Clears the volume of a TSDF fusion block
+* \param[in] fusion  TSDF fusion block
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_tsdf_fusion_reset(rs2_processing_block* fusion, rs2_error** error);
+
+/**
+* Raycasts the volume of a TSDF fusion block from a camera, once a depth frame was integrated
+* \param[in] fusion           TSDF fusion block
+* \param[in] intrinsics       intrinsics of the camera
+* \param[in] camera_to_world  pose of the camera in the world of the volume
+* \param[out] error           if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return                     points frame of the surface seen by every pixel, with normals, in the coordinates of the camera. The points of the pixels seeing no surface are zero
+*/
+rs2_frame* rs2_tsdf_fusion_raycast(rs2_processing_block* fusion, const rs2_intrinsics* intrinsics, const rs2_extrinsics* camera_to_world, rs2_error** error);
+
+/**
+* Extracts the surfaces of the volume of a TSDF fusion block, once a depth frame was integrated
+* \param[in] fusion  TSDF fusion block
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return            points frame of the zero crossings of the distances between neighbouring voxels, with normals, in the coordinates of the world
+*/
+rs2_frame* rs2_tsdf_fusion_extract_points(rs2_processing_block* fusion, rs2_error** error);
+
+/**
+* Creates a depth post-processing block that runs the decimation -> depth to disparity -> spatial -> temporal -> disparity to depth -> hole filling
+* chain in strips of rows that stay in the cache, and allocates only the final depth frame. The results are those of the separate blocks.
+* Every filter keeps being configured through its own options. Stereoscopic depth is filtered in the disparity domain, other depth as is
+* \param[in] decimation    decimation filter block, or null to leave decimation out of the chain
+* \param[in] spatial       spatial filter block, or null to leave spatial filtering out of the chain
+* \param[in] temporal      temporal filter block, or null to leave temporal filtering out of the chain. It keeps its history in between the frames of the chain
+* \param[in] hole_filling  hole filling filter block, or null to leave hole filling out of the chain
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_depth_post_processing_block(rs2_processing_block* decimation, rs2_processing_block* spatial,
+    rs2_processing_block* temporal, rs2_processing_block* hole_filling, rs2_error** error);
+
+/** \brief Counters of the frames of a stream reaching a sync processing block */
+typedef struct rs2_sync_stream_stats
+{
+    unsigned long long enqueued;   /**< Number of frames of the stream that reached the syncer */
+    unsigned long long matched;    /**< Number of frames of the stream synced into a frameset */
+    unsigned long long skipped;    /**< Number of framesets synced without a frame of the stream, that was not waited for */
+    unsigned long long overflowed; /**< Number of frames dropped from a full queue, to make room for newer frames */
+    unsigned long long dropped;    /**< Number of frames dropped when the stream was found to have stopped */
+} rs2_sync_stream_stats;
+
+/** \brief Number of buckets of the latency histogram of a sync processing block. Bucket 0 counts the framesets dispatched within
+* a millisecond of the arrival of their first frame, bucket i those dispatched within 2^i milliseconds, and the last one all the others */
+#define RS2_SYNC_LATENCY_BUCKETS 12
+
+/**
+* Retrieves the counters of the frames of a stream reaching a sync processing block, kept since it first received one
+* \param[in] syncer            sync processing block
+* \param[in] stream_unique_id  unique id of the stream profile of the stream
+* \param[out] stats            counters of the stream
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_get_sync_stream_stats(rs2_processing_block* syncer, int stream_unique_id, rs2_sync_stream_stats* stats, rs2_error** error);
+
+/**
+* Retrieves the histogram of the time framesets took to be dispatched by a sync processing block, from the arrival of their first frame
+* \param[in] syncer   sync processing block
+* \param[out] buckets number of framesets in every bucket
+* \param[in] count    number of buckets to retrieve, at most RS2_SYNC_LATENCY_BUCKETS
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_get_sync_latency_histogram(rs2_processing_block* syncer, unsigned long long* buckets, int count, rs2_error** error);
+
+/**
+* Retrieves the number of framesets a sync processing block emitted without a frame of a stream,
+* because RS2_OPTION_SYNC_LATENCY_BUDGET ran out while waiting for it
+* \param[in] syncer            sync processing block
+* \param[in] stream_unique_id  unique id of the stream profile of the stream
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return                      number of incomplete framesets
+*/
+unsigned long long rs2_get_sync_incomplete_framesets(rs2_processing_block* syncer, int stream_unique_id, rs2_error** error);
+
+/**
+* Creates a processing graph, which runs a graph of processing blocks on a pool of worker threads. Every block of the graph processes
+* its frames one at a time and in the order they reach it, while different blocks run in parallel, so consecutive frames are pipelined
+* through the graph. Frames processed by the graph go to every block without inputs, and the frames of blocks without outputs are its output
+* \param[in] threads        number of worker threads running the blocks of the graph
+* \param[in] max_in_flight  number of frames the graph works on at a time. Processing a frame blocks while the graph works on this many frames
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return                   new processing block, to be released by rs2_delete_processing_block
+*/
+rs2_processing_block* rs2_create_processing_graph(int threads, int max_in_flight, rs2_error** error);
+
+/**
+* Adds a processing block to a processing graph, which takes over the output of the block for as long as the graph exists
+* \param[in] graph   processing graph
+* \param[in] block   processing block to add
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return            index of the block in the graph
+*/
+int rs2_processing_graph_add(rs2_processing_block* graph, rs2_processing_block* block, rs2_error** error);
+
+/**
+* Sends the output frames of one block of a processing graph to another. Connections that would make a cycle are rejected
+* \param[in] graph   processing graph
+* \param[in] from    index of the block whose frames are sent
+* \param[in] to      index of the block receiving them
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_processing_graph_connect(rs2_processing_block* graph, int from, int to, rs2_error** error);
+
+/**
+* Waits until the processing graph has finished working on all the frames it was given
+* \param[in] graph   processing graph
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_processing_graph_flush(rs2_processing_block* graph, rs2_error** error);
+
+/**
+* Runs a batch of frames through a processing graph and waits for it to finish with them. The frames are pipelined through the graph
+* as frames it processes one at a time, without going through its output callback
+* \param[in] graph   processing graph
+* \param[in] frames  frames to process, released by the call
+* \param[out] results        for every input frame, the frame that left the graph, a composite frame when several did, or null when none did.
+*                             Every frame returned is to be released by rs2_release_frame
+* \param[in] count   number of frames in the batch
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_processing_graph_process_batch(rs2_processing_block* graph, rs2_frame** frames, rs2_frame** results, int count, rs2_error** error);
+
 #ifdef __cplusplus
 }
 #endif
@@ -15,6 +15,7 @@ extern "C" {
 #endif
 
 #include "rs_types.h"
+#include "rs_sensor.h"
 
 typedef enum rs2_playback_status
 {
@@ -28,6 +29,50 @@ const char* rs2_playback_status_to_string(rs2_playback_status status);
 
 typedef void (*rs2_playback_status_changed_callback_ptr)(rs2_playback_status);
 
+/** \brief Policy of a recording device for the frames arriving when its write queue is full */
+typedef enum rs2_record_queue_policy
+{
+    RS2_RECORD_QUEUE_POLICY_DROP_NEWEST,       /**< The arriving frame is dropped and counted */
+    RS2_RECORD_QUEUE_POLICY_BLOCK,             /**< The sensor callback waits until the queue has room for the frame */
+    RS2_RECORD_QUEUE_POLICY_DROP_LOW_PRIORITY, /**< Once the queue is half full, frames of streams below the highest priority are dropped, so the rest keep the room left */
+    RS2_RECORD_QUEUE_POLICY_COUNT
+} rs2_record_queue_policy;
+const char* rs2_record_queue_policy_to_string(rs2_record_queue_policy policy);
+
+/** \brief Lateness of the frames a playback device published in real time mode, past the times their recording makes them due */
+typedef struct rs2_playback_jitter
+{
+    unsigned long long frames;      /**< Frames published in real time mode since the playback last started */
+    double mean_lateness_us;        /**< Mean lateness of the frames, in microseconds */
+    double stddev_lateness_us;      /**< Standard deviation of the lateness, in microseconds */
+    double max_lateness_us;         /**< Largest lateness, in microseconds */
+} rs2_playback_jitter;
+
+/** \brief Compression of the frames of a stream in a recorded file */
+typedef enum rs2_record_compression
+{
+    RS2_RECORD_COMPRESSION_NONE,  /**< Frames are written as they are, in the LZ4 compressed chunks of the file */
+    RS2_RECORD_COMPRESSION_LZ4,   /**< Every frame is LZ4 compressed on its own, by the worker threads of the context */
+    RS2_RECORD_COMPRESSION_LZ4HC, /**< Every frame is LZ4HC compressed on its own, for smaller files at a higher processing cost */
+    RS2_RECORD_COMPRESSION_RVL,   /**< Z16 frames are compressed with the lossless depth codec of RS2_FORMAT_Z16_RVL, the frames of other formats with LZ4 */
+    RS2_RECORD_COMPRESSION_COUNT
+} rs2_record_compression;
+const char* rs2_record_compression_to_string(rs2_record_compression compression);
+
+/** \brief Counters of the write queue of a recording device */
+typedef struct rs2_record_queue_stats
+{
+    unsigned long long queued_frames;          /**< Frames waiting to be written */
+    unsigned long long queued_bytes;           /**< Bytes of the frames waiting to be written */
+    unsigned long long peak_bytes;             /**< Highest value of queued_bytes */
+    unsigned long long written_frames;         /**< Frames written to the file */
+    unsigned long long dropped_frames;         /**< Frames dropped because the queue was full */
+    unsigned long long average_latency_us;     /**< Average time from the arrival to the write of a frame, in microseconds */
+    unsigned long long max_latency_us;         /**< Longest time from the arrival to the write of a frame, in microseconds */
+    unsigned long long pre_roll_frames;        /**< Frames held in memory for the pre-roll of a flight recording */
+    unsigned long long pre_roll_bytes;         /**< Bytes of the frames held for the pre-roll, compressed as their stream is */
+} rs2_record_queue_stats;
+
 /**
  * Creates a recording device to record the given device and save it to the given file
  * \param[in]  device    The device to record
@@ -37,6 +82,22 @@ typedef void (*rs2_playback_status_changed_callback_ptr)(rs2_playback_status);
  */
 rs2_device* rs2_create_record_device(const rs2_device* device, const char* file, rs2_error** error);
 
+/**
+ * Creates a recording device to record the given device to a sequence of files, for continuous recording.
+ * A new file starts before the first frame that would exceed the duration or size of the current one, with the
+ * description of the device and its streams repeated, so that each file plays on its own and no frame is lost in
+ * between. The files are named after the given file with the index of their segment, as in <name>_000000.bag.
+ * Segments but the first start at the time of their first frame
+ * \param[in]  device        The device to record
+ * \param[in]  file          The desired path to which the segments of the recording are named after
+ * \param[in]  max_duration  Longest duration of a segment in milliseconds, 0 for no bound on the duration
+ * \param[in]  max_bytes     Size of a segment after which the next one starts, 0 for no bound on the size
+ * \param[out] error         If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * \return A pointer to a device that records its data to files, or null in case of failure
+ */
+rs2_device* rs2_create_segmented_record_device(const rs2_device* device, const char* file, unsigned long long max_duration,
+                                               unsigned long long max_bytes, rs2_error** error);
+
 /**
 * Pause the recording device without stopping the actual device from streaming.
 * Pausing will cause the device to stop writing new data to the file, in particular, frames and changes to extensions
@@ -60,6 +121,104 @@ void rs2_record_device_resume(const rs2_device* device, rs2_error** error);
 */
 const char* rs2_record_device_filename(const rs2_device* device, rs2_error** error);
 
+/**
+* Bounds the queue of the frames the recording device has yet to write, for storage slower than the streams
+* \param[in]  device      A recording device
+* \param[in]  max_frames  Frames the queue holds at most, 0 for no bound on the count
+* \param[in]  max_bytes   Bytes of frame data the queue holds at most, 0 for no bound on the size
+* \param[in]  policy      What happens to the frames arriving when the queue is full
+* \param[out] error       If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_record_device_set_queue_limit(const rs2_device* device, unsigned long long max_frames, unsigned long long max_bytes,
+                                       rs2_record_queue_policy policy, rs2_error** error);
+
+/**
+* Sets the priority of a stream for RS2_RECORD_QUEUE_POLICY_DROP_LOW_PRIORITY, 0 by default
+* \param[in]  device      A recording device
+* \param[in]  stream      The stream type
+* \param[in]  priority    Higher values are kept longer as the queue fills
+* \param[out] error       If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_record_device_set_stream_priority(const rs2_device* device, rs2_stream stream, int priority, rs2_error** error);
+
+/**
+* Gets the counters of the write queue of the recording device
+* \param[in]  device      A recording device
+* \param[out] stats       Receives the counters
+* \param[out] error       If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_record_device_get_queue_stats(const rs2_device* device, rs2_record_queue_stats* stats, rs2_error** error);
+
+/**
+* Sets the compression of the video frames of a stream, RS2_RECORD_COMPRESSION_NONE by default.
+* The frames are compressed on worker threads, ahead of the thread writing them to the file
+* \param[in]  device      A recording device
+* \param[in]  stream      The stream type
+* \param[in]  compression The compression of the frames of the stream
+* \param[out] error       If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_record_device_set_stream_compression(const rs2_device* device, rs2_stream stream, rs2_record_compression compression, rs2_error** error);
+
+/**
+* Sets the codec encoding the video frames of a stream, such as a JPEG or an intra-only H.264 encoder of the application.
+* The encoded frames are tagged with the name of the codec, and take precedence over the compression of the stream.
+* Frames the codec does not encode are recorded under the compression of the stream
+* \param[in]  device      A recording device
+* \param[in]  stream      The stream type
+* \param[in]  codec       The codec of the frames of the stream, released by the device. Null to record the frames without a codec
+* \param[out] error       If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_record_device_set_stream_codec(const rs2_device* device, rs2_stream stream, rs2_frame_codec* codec, rs2_error** error);
+
+/**
+* Makes a flight recording of a recording device: the frames of the last pre-roll are held in memory and written to the file
+* only once the application triggers it, together with the frames of the post-roll that follows. Video frames are held
+* compressed as their stream is recorded. Frames are written as they come with a zero pre-roll, the default
+* \param[in]  device      A recording device
+* \param[in]  pre_roll    Time of the frames held before a trigger, in nanoseconds
+* \param[in]  post_roll   Time of the frames written after a trigger, in nanoseconds
+* \param[in]  max_bytes   Bound of the bytes of the frames held, 0 for the pre-roll alone to bound them
+* \param[out] error       If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_record_device_set_pre_roll(const rs2_device* device, long long int pre_roll, long long int post_roll, unsigned long long max_bytes, rs2_error** error);
+
+/**
+* Writes the frames held for the pre-roll of a flight recording to its file, and the frames of its post-roll as they come
+* \param[in]  device      A recording device with a pre-roll
+* \param[out] error       If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_record_device_trigger(const rs2_device* device, rs2_error** error);
+
+/**
+* Sets the processing block of the frames of a stream, such as a chain of decimation and spatial filters, whose output frames
+* are recorded in place of the frames of the stream, under the profiles and intrinsics of the output. The block delivers its
+* frames to the device alone, and is set before the stream starts recording. A recording holds a single profile of every
+* stream, the output frames of the profiles that follow the first are left out
+* \param[in]  device      A recording device
+* \param[in]  stream      The stream type
+* \param[in]  block       The processing block of the frames of the stream, shared with the device. Null to record them as they stream
+* \param[out] error       If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_record_device_set_stream_processing(const rs2_device* device, rs2_stream stream, rs2_processing_block* block, rs2_error** error);
+
+/**
+* Sets the callback of a segmented recording device, called with the file of each segment once it is closed and
+* complete, from the thread writing the recording
+* \param[in]  device      A segmented recording device
+* \param[in]  callback    The callback, released by the device
+* \param[out] error       If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_record_device_set_segment_closed_callback(const rs2_device* device, rs2_segment_closed_callback* callback, rs2_error** error);
+
+/**
+* Bounds the disk space the closed segments of a segmented recording device take. Whenever a segment is closed, the
+* oldest segments are deleted while the closed ones take more than the budget. Segments are kept by default
+* \param[in]  device      A segmented recording device
+* \param[in]  max_bytes   Bytes the closed segments take at most, 0 to keep all
+* \param[out] error       If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_record_device_set_disk_budget(const rs2_device* device, unsigned long long max_bytes, rs2_error** error);
+
 /**
 * Creates a playback device to play the content of the given file
 * \param[in]  file      Path to the file to play
@@ -139,6 +298,47 @@ void rs2_playback_device_set_real_time(const rs2_device* device, int real_time,
  */
 int rs2_playback_device_is_real_time(const rs2_device* device, rs2_error** error);
 
+/**
+ * Sets how many messages of the file playback reads ahead of their playing, on a thread of its own, for storage
+ * where reads are slow or seek-bound. The messages are read on demand by default
+ * \param[in] device    A playback device
+ * \param[in] count     Messages read ahead, 0 to read them on demand, at most 16
+ * \param[out] error    If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_playback_device_set_read_ahead(const rs2_device* device, int count, rs2_error** error);
+
+/**
+ * Sets whether playback reads the file through a memory mapping of it rather than through system calls.
+ * The file is read through system calls by default
+ * \param[in] device    A playback device
+ * \param[in] mapped    Indicates if a memory mapping is requested, 0 means false, otherwise true
+ * \param[out] error    If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * \return 0 when the file cannot be mapped, in which case it is read through system calls, otherwise 1
+ */
+int rs2_playback_device_set_mapped_read(const rs2_device* device, int mapped, rs2_error** error);
+
+/**
+ * Sets whether playback decodes the frames of each stream on the thread publishing them, before their callback, so that
+ * the frames of different streams decompress and decode in parallel. Together with non real time mode and read ahead,
+ * this plays a file as fast as its streams decode. By default, frames decode when their data is first accessed
+ * \param[in] device    A playback device
+ * \param[in] parallel  Indicates if parallel decoding is requested, 0 means false, otherwise true
+ * \param[out] error    If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_playback_device_set_parallel_decode(const rs2_device* device, int parallel, rs2_error** error);
+
+/**
+ * Retrieves the lateness of the frames of a stream the playback published in real time mode, counted since the playback last
+ * started. Frames are published by a clock shared by the streams, their waits ending in a spin for a jitter well under
+ * the granularity of the timers of the OS
+ * \param[in] device    A playback device
+ * \param[in] stream    Stream type of the frames, RS2_STREAM_ANY for all streams
+ * \param[in] index     Stream index of the frames, -1 for all indices
+ * \param[out] jitter   Receives the statistics of the lateness
+ * \param[out] error    If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_playback_device_get_jitter(const rs2_device* device, rs2_stream stream, int index, rs2_playback_jitter* jitter, rs2_error** error);
+
 /**
  * Register to receive callback from playback device upon its status changes
  *
@@ -150,6 +350,16 @@ int rs2_playback_device_is_real_time(const rs2_device* device, rs2_error** error
  */
 void rs2_playback_device_set_status_changed_callback(const rs2_device* device, rs2_playback_status_changed_callback* callback, rs2_error** error);
 
+/**
+ * Registers a codec to decode the frames recorded with a codec of the same name.
+ * The frames are decoded when their data is first accessed, so those dropped on the way are never decoded.
+ * Frames without a registered codec are not played
+ * \param[in] device     A playback device
+ * \param[in] codec      The codec, released by the device
+ * \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_playback_device_register_codec(const rs2_device* device, rs2_frame_codec* codec, rs2_error** error);
+
 /**
  * Returns the current state of the playback device
  * \param[in] device     A playback device
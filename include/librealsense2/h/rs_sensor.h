@@ -74,6 +74,12 @@ typedef enum rs2_format
     RS2_FORMAT_GPIO_RAW        , /**< Raw data from the external sensors hooked to one of the GPIO's */
     RS2_FORMAT_6DOF            , /**< Pose data packed as floats array, containing translation vector, rotation quaternion and prediction velocities and accelerations vectors */
     RS2_FORMAT_DISPARITY32     , /**< 32-bit float-point disparity values. Depth->Disparity conversion : Disparity = Baseline*FocalLength/Depth */
+    RS2_FORMAT_NV12            , /**< 4:2:0 planar: full resolution 8-bit Y plane followed by a half resolution plane of interleaved U and V. The stride spans the two planes, at 12 bits per pixel */
+    RS2_FORMAT_I420            , /**< 4:2:0 planar: full resolution 8-bit Y plane followed by half resolution U and V planes. The stride spans the three planes, at 12 bits per pixel */
+    RS2_FORMAT_XYZ16           , /**< 16-bit 3D coordinates in depth units: signed X and Y, and unsigned Z equal to the depth value. Texture coordinates are 16-bit floating point */
+    RS2_FORMAT_XYZ16F          , /**< 16-bit floating point 3D coordinates in meters, with 16-bit floating point texture coordinates */
+    RS2_FORMAT_Z16_RVL         , /**< Losslessly compressed 16-bit depth: the 32-bit size of the encoded data, followed by the data. The stride spreads it over the rows of the frame */
+    RS2_FORMAT_DISTANCE        , /**< 32-bit floating point depth in meters, 0 where there is no depth */
     RS2_FORMAT_COUNT             /**< Number of enumeration values. Not a valid input: intended to be used in for-loops. */
 } rs2_format;
 const char* rs2_format_to_string(rs2_format format);
@@ -85,6 +91,32 @@ typedef struct rs2_extrinsics
     float translation[3]; /**< Three-element translation vector, in meters */
 } rs2_extrinsics;
 
+/** \brief Frame memory held by a sensor and its frame drops, accumulated since the sensor was last opened. */
+typedef struct rs2_frame_memory_stats
+{
+    unsigned long long live_frames;         /**< Frames currently held by the user */
+    unsigned long long bytes_held;          /**< Bytes held by live frames and by recycled buffers waiting for reuse */
+    unsigned long long pooled_bytes;        /**< Bytes held by recycled buffers waiting for reuse */
+    unsigned long long peak_bytes;          /**< Highest value of bytes_held, summed over the frame types the sensor produces */
+    unsigned long long allocation_failures; /**< Frames dropped because their storage could not be allocated or would exceed RS2_OPTION_FRAMES_MEMORY_BUDGET */
+    unsigned long long queue_drops;         /**< Frames dropped because the user already held RS2_OPTION_FRAMES_QUEUE_SIZE frames */
+    unsigned long long transport_errors;    /**< USB transfers and payloads that failed, on the backends that count them */
+    unsigned long long transport_drops;     /**< Frames the backend dropped for lost data or for not being taken in time, on the backends that count them */
+    unsigned long long streaming_allocations; /**< Frame allocations the pools sized at open did not cover, counted in the streaming preallocation mode alone, see rs2_context_set_streaming_preallocation */
+} rs2_frame_memory_stats;
+
+/** \brief Frames of a sensor at every stage from the backend to its callback, counted since the sensor was last opened. Always kept */
+typedef struct rs2_sensor_health
+{
+    unsigned long long frames_received;     /**< Frames the sensor made of the data of the backend, dropped ones included */
+    unsigned long long frames_delivered;    /**< Frames passed to the callback of the sensor */
+    unsigned long long transport_drops;     /**< Frames the backend dropped, on the backends that count them */
+    unsigned long long allocation_drops;    /**< Frames dropped because their storage could not be allocated or would exceed RS2_OPTION_FRAMES_MEMORY_BUDGET */
+    unsigned long long queue_drops;         /**< Frames dropped because the user already held RS2_OPTION_FRAMES_QUEUE_SIZE frames */
+    unsigned long long frames_in_flight;    /**< Frames currently on their way to the callback or held by the user */
+    unsigned long long bytes_in_flight;     /**< Bytes of the frames in flight */
+} rs2_sensor_health;
+
 /**
 * Deletes sensors list, any sensors created from this list will remain unaffected
 * \param[in] info_list list to delete
@@ -183,6 +215,58 @@ void rs2_set_region_of_interest(const rs2_sensor* sensor, int min_x, int min_y,
  */
 void rs2_get_region_of_interest(const rs2_sensor* sensor, int* min_x, int* min_y, int* max_x, int* max_y, rs2_error** error);
 
+/**
+ * \brief retrieves a snapshot of the frame memory held by the sensor, and of the frames it dropped for lack of memory or queue space
+ * \param[in] sensor     the RealSense sensor
+ * \param[out] stats     receives the snapshot
+ * \param[out] error     if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_get_frame_memory_stats(const rs2_sensor* sensor, rs2_frame_memory_stats* stats, rs2_error** error);
+
+/**
+ * \brief sets the priority of the frames of a stream, 0 by default. Wherever frames compete for room, in the frame budgets of
+ * the sensor, in frame queues and in the syncer, the frames below the highest priority only get half of it and are dropped first
+ * \param[in] sensor     the RealSense sensor
+ * \param[in] stream     the stream type
+ * \param[in] index      the stream index, -1 for every stream of the type
+ * \param[in] priority   higher values are kept longer under load
+ * \param[out] error     if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_set_stream_priority(const rs2_sensor* sensor, rs2_stream stream, int index, int priority, rs2_error** error);
+
+/**
+ * \brief retrieves the priority of the frames of a stream
+ * \param[in] sensor     the RealSense sensor
+ * \param[in] stream     the stream type
+ * \param[in] index      the stream index
+ * \param[out] error     if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * \return               the priority set for the stream, or for every stream of the type, 0 otherwise
+ */
+int rs2_get_stream_priority(const rs2_sensor* sensor, rs2_stream stream, int index, rs2_error** error);
+
+/**
+ * \brief lists a profile of a region of the frames of a video profile, among the profiles of the sensor. Streaming it only converts
+ * that region of the frames, whose intrinsics are those of the full frames with the principal point moved to the origin of the region.
+ * The region must start at a column multiple of 16, and be of a width multiple of 16 unless it ends with the frames
+ * \param[in] sensor     the RealSense sensor, which must not be opened
+ * \param[in] base       a video profile of the sensor
+ * \param[in] x          first column of the region
+ * \param[in] y          first row of the region
+ * \param[in] width      width of the region
+ * \param[in] height     height of the region
+ * \param[out] error     if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * \return               the cropped profile, to be released with rs2_delete_stream_profile
+ */
+rs2_stream_profile* rs2_sensor_add_cropped_profile(rs2_sensor* sensor, const rs2_stream_profile* base, int x, int y, int width, int height, rs2_error** error);
+
+/**
+ * \brief retrieves the counters of the frames the sensor received, delivered and dropped at every stage, and of the frames in flight
+ * \param[in] sensor     the RealSense sensor
+ * \param[out] health    receives the counters
+ * \param[out] error     if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_get_sensor_health(const rs2_sensor* sensor, rs2_sensor_health* health, rs2_error** error);
+
 /**
 * open subdevice for exclusive access, by committing to a configuration
 * \param[in] device relevant RealSense device
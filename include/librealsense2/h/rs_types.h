@@ -118,6 +118,11 @@ typedef enum rs2_extension
     RS2_EXTENSION_TM2,
     RS2_EXTENSION_SOFTWARE_DEVICE,
     RS2_EXTENSION_SOFTWARE_SENSOR,
+    RS2_EXTENSION_GPU_FRAME,
+    RS2_EXTENSION_DMABUF_FRAME,
+    RS2_EXTENSION_MOTION_BATCH_FRAME,
+    RS2_EXTENSION_MOTION_HISTORY,
+    RS2_EXTENSION_POSE_PREDICTION,
     RS2_EXTENSION_COUNT
 } rs2_extension;
 const char* rs2_extension_type_to_string(rs2_extension type);
@@ -164,6 +169,8 @@ typedef struct rs2_source rs2_source;
 typedef struct rs2_processing_block rs2_processing_block;
 typedef struct rs2_frame_processor_callback rs2_frame_processor_callback;
 typedef struct rs2_playback_status_changed_callback rs2_playback_status_changed_callback;
+typedef struct rs2_frame_codec rs2_frame_codec;
+typedef struct rs2_segment_closed_callback rs2_segment_closed_callback;
 typedef struct rs2_context rs2_context;
 typedef struct rs2_device_hub rs2_device_hub;
 typedef struct rs2_sensor_list rs2_sensor_list;
@@ -172,6 +179,8 @@ typedef struct rs2_options rs2_options;
 typedef struct rs2_devices_changed_callback rs2_devices_changed_callback;
 typedef struct rs2_notification rs2_notification;
 typedef struct rs2_notifications_callback rs2_notifications_callback;
+typedef struct rs2_net_server rs2_net_server;
+typedef struct rs2_shm_publisher rs2_shm_publisher;
 typedef void (*rs2_notification_callback_ptr)(rs2_notification*, void*);
 typedef void (*rs2_devices_changed_callback_ptr)(rs2_device_list*, rs2_device_list*, void*);
 typedef void (*rs2_frame_callback_ptr)(rs2_frame*, void*);
@@ -200,6 +200,64 @@ namespace rs2
             return playback { device };
         }
 
+        /**
+         * Creates one device of the files of a multi-device recording, playing them synchronized on their timestamps
+         *
+         * The sensors of the device are those of every file in order. unload_device with the file names joined by '|' removes it
+         * @param files  Paths to RealSense Files, one or more
+         * @return A playback device of the merged files
+         */
+        playback load_merged_device(const std::vector<std::string>& files)
+        {
+            std::vector<const char*> names;
+            for (auto&& file : files)
+                names.push_back(file.c_str());
+
+            rs2_error* e = nullptr;
+            auto device = std::shared_ptr<rs2_device>(
+                rs2_context_add_merged_device(_context.get(), names.data(), static_cast<int>(names.size()), &e),
+                rs2_delete_device);
+            rs2::error::handle(e);
+
+            return playback { device };
+        }
+
+        /**
+         * Connects to a device another host publishes with rs2::net_server
+         *
+         * The device is appended to the context and a devices_changed event triggered. unload_device with the address removes it
+         * @param address  host:port of the server, or the host alone for the default port
+         * @return A device streaming from the server
+         */
+        device connect_device(const std::string& address)
+        {
+            rs2_error* e = nullptr;
+            auto dev = std::shared_ptr<rs2_device>(
+                rs2_context_add_network_device(_context.get(), address.c_str(), &e),
+                rs2_delete_device);
+            rs2::error::handle(e);
+
+            return device(dev);
+        }
+
+        /**
+         * Attaches to a device another process of the host publishes with rs2::shm_publisher
+         *
+         * The device is appended to the context and a devices_changed event triggered. unload_device with the name removes it
+         * @param name  The name the device is published as
+         * @return A device streaming the frames of the publisher
+         */
+        device attach_device(const std::string& name)
+        {
+            rs2_error* e = nullptr;
+            auto dev = std::shared_ptr<rs2_device>(
+                rs2_context_add_shm_device(_context.get(), name.c_str(), &e),
+                rs2_delete_device);
+            rs2::error::handle(e);
+
+            return device(dev);
+        }
+
         void unload_device(const std::string& file)
         {
             rs2_error* e = nullptr;
@@ -207,6 +265,113 @@ namespace rs2
             rs2::error::handle(e);
         }
 
+        /**
+        * Checks whether the processing blocks can be offloaded to a compute backend on this machine
+        * \param[in] backend   the compute backend
+        */
+        bool is_compute_backend_available(rs2_compute_backend backend) const
+        {
+            rs2_error* e = nullptr;
+            auto res = rs2_is_compute_backend_available(backend, &e);
+            error::handle(e);
+            return res != 0;
+        }
+
+        /**
+        * Selects the compute backend the processing blocks of the process run on
+        * \param[in] backend   the compute backend, RS2_COMPUTE_BACKEND_CPU by default
+        */
+        void set_compute_backend(rs2_compute_backend backend)
+        {
+            rs2_error* e = nullptr;
+            rs2_context_set_compute_backend(_context.get(), backend, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Shares a pool of worker threads between the pipelines, playback streams and recorders the context creates from now on
+        * \param[in] threads   the number of worker threads, -1 for one per hardware thread, or 0 for a thread per dispatcher
+        */
+        void set_worker_threads(int threads)
+        {
+            rs2_error* e = nullptr;
+            rs2_context_set_worker_threads(_context.get(), threads, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Sizes the frame pools of the sensors the context creates as they open, and counts the frame allocations left to streaming
+        * \param[in] enabled   whether the pools are sized and the streaming allocations counted
+        * \param[in] fatal     whether the streaming allocations are refused, dropping their frames
+        */
+        void set_streaming_preallocation(bool enabled, bool fatal = false)
+        {
+            rs2_error* e = nullptr;
+            rs2_context_set_streaming_preallocation(_context.get(), enabled ? 1 : 0, fatal ? 1 : 0, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Sets the number of threads the data parallel kernels of the library split their work over, in the whole process
+        * \param[in] threads   the number of threads, the calling one included, -1 for one per hardware thread, or 1 for the calling thread alone
+        */
+        void set_parallel_threads(int threads)
+        {
+            rs2_error* e = nullptr;
+            rs2_context_set_parallel_threads(_context.get(), threads, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Runs the data parallel kernels of the library on the threads of the application, through its executor
+        * \param[in] executor     runs task(task_data, i) for every i below count, returning once every one of them returned. Null for the calling thread alone
+        * \param[in] user         passed to the executor
+        * \param[in] concurrency  the number of tasks the executor runs at once
+        */
+        void set_parallel_executor(rs2_parallel_executor_ptr executor, void* user, int concurrency)
+        {
+            rs2_error* e = nullptr;
+            rs2_context_set_parallel_executor(_context.get(), executor, user, concurrency, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Sets the CPUs, priority and name of the threads of a role that librealsense starts from now on, in the whole process
+        * \param[in] role      the role of the threads
+        * \param[in] cpus      the indices of the CPUs the threads may run on, empty for any CPU
+        * \param[in] priority  the scheduling class of the threads
+        * \param[in] name      the name of the threads, empty for the name of the role
+        */
+        void set_thread_policy(rs2_thread_role role, const std::vector<int>& cpus,
+            rs2_thread_priority priority = RS2_THREAD_PRIORITY_DEFAULT, const std::string& name = "")
+        {
+            rs2_error* e = nullptr;
+            rs2_context_set_thread_policy(_context.get(), role, cpus.data(), int(cpus.size()), priority,
+                name.empty() ? nullptr : name.c_str(), &e);
+            error::handle(e);
+        }
+
+        /**
+        * Starts tracing the delivery of frames in the process, kept in memory until the trace is stopped
+        */
+        void start_trace()
+        {
+            rs2_error* e = nullptr;
+            rs2_context_start_trace(_context.get(), &e);
+            error::handle(e);
+        }
+
+        /**
+        * Stops tracing and writes the events as Chrome trace JSON, opened by chrome://tracing and Perfetto
+        * \param[in] file   the path of the trace file
+        */
+        void stop_trace(const std::string& file)
+        {
+            rs2_error* e = nullptr;
+            rs2_context_stop_trace(_context.get(), file.c_str(), &e);
+            error::handle(e);
+        }
+
         context(std::shared_ptr<rs2_context> ctx)
             : _context(ctx)
         {}
@@ -180,6 +180,50 @@ namespace rs2
 
             return results;
         }
+
+        /**
+        * Sends the commands back-to-back and collects their responses in order
+        * \param[in] inputs      raw data of every command
+        * \param[out] succeeded  if non-null, receives whether the device responded to every command
+        * \return                response of every command, empty for those that failed
+        */
+        std::vector<std::vector<uint8_t>> send_and_receive_raw_data_batch(const std::vector<std::vector<uint8_t>>& inputs,
+            std::vector<bool>* succeeded = nullptr) const
+        {
+            std::vector<const void*> data;
+            std::vector<unsigned> sizes;
+            for (auto&& input : inputs)
+            {
+                data.push_back(input.data());
+                sizes.push_back(static_cast<unsigned>(input.size()));
+            }
+            std::vector<const rs2_raw_data_buffer*> buffers(inputs.size(), nullptr);
+
+            rs2_error* e = nullptr;
+            rs2_send_and_receive_raw_data_batch(_dev.get(), data.data(), sizes.data(), static_cast<int>(inputs.size()), buffers.data(), &e);
+            error::handle(e);
+
+            std::vector<std::shared_ptr<const rs2_raw_data_buffer>> owned;
+            for (auto buffer : buffers)
+                owned.push_back(buffer ? std::shared_ptr<const rs2_raw_data_buffer>(buffer, rs2_delete_raw_data) : nullptr);
+
+            std::vector<std::vector<uint8_t>> results(inputs.size());
+            if (succeeded)
+                succeeded->assign(inputs.size(), false);
+            for (size_t i = 0; i < owned.size(); i++)
+            {
+                if (!owned[i])
+                    continue;
+                auto size = rs2_get_raw_data_size(owned[i].get(), &e);
+                error::handle(e);
+                auto start = rs2_get_raw_data(owned[i].get(), &e);
+                error::handle(e);
+                results[i].assign(start, start + size);
+                if (succeeded)
+                    (*succeeded)[i] = true;
+            }
+            return results;
+        }
     };
 
     class device_list
@@ -359,5 +403,41 @@ namespace rs2
             error::handle(e);
         }
     };
+
+    // Publishes the video streams of a device over the network for as long as it lives, see rs2::context::connect_device.
+    // Only the clients of this host may connect unless allow_remote is set, as a client controls the device
+    class net_server
+    {
+    public:
+        explicit net_server(device dev, int port = 0, bool allow_remote = false)
+        {
+            rs2_error* e = nullptr;
+            _server = std::shared_ptr<rs2_net_server>(
+                rs2_create_net_server(dev.get().get(), port, allow_remote ? 1 : 0, &e),
+                rs2_delete_net_server);
+            error::handle(e);
+        }
+
+    private:
+        std::shared_ptr<rs2_net_server> _server;
+    };
+
+    // Publishes the frames a device streams in this process to the other processes of the host for as long as it lives,
+    // see rs2::context::attach_device
+    class shm_publisher
+    {
+    public:
+        shm_publisher(device dev, const std::string& name)
+        {
+            rs2_error* e = nullptr;
+            _publisher = std::shared_ptr<rs2_shm_publisher>(
+                rs2_create_shm_publisher(dev.get().get(), name.c_str(), &e),
+                rs2_delete_shm_publisher);
+            error::handle(e);
+        }
+
+    private:
+        std::shared_ptr<rs2_shm_publisher> _publisher;
+    };
 }
 #endif // LIBREALSENSE_RS2_DEVICE_HPP
@@ -442,6 +442,19 @@ namespace rs2
             return r != 0;
         }
 
+        /** retrieve the values of all the frame_metadata the frame supports at once
+        * \param[out] values     the values of the supported frame_metadata, indexed by rs2_frame_metadata_value
+        * \param[out] supported  non-zero for the supported frame_metadata, indexed by rs2_frame_metadata_value
+        * \return            the number of frame_metadata the frame supports
+        */
+        int get_frame_metadata_all(rs2_metadata_type (&values)[RS2_FRAME_METADATA_COUNT], int (&supported)[RS2_FRAME_METADATA_COUNT]) const
+        {
+            rs2_error* e = nullptr;
+            auto r = rs2_get_frame_metadata_all(frame_ref, values, supported, RS2_FRAME_METADATA_COUNT, &e);
+            error::handle(e);
+            return r;
+        }
+
         /**
         * retrieve frame number (from frame handle)
         * \return               the frame number of the frame, in milliseconds since the device was started
@@ -454,6 +467,19 @@ namespace rs2
             return r;
         }
 
+        /**
+        * retrieve the data, timestamp, frame number, stream profile and, of video frames, the dimensions of the frame at once
+        * \return               the common fields of the frame, with the video fields set to 0 for frames that are not video frames
+        */
+        rs2_frame_info get_info() const
+        {
+            rs2_error* e = nullptr;
+            rs2_frame_info info;
+            rs2_get_frame_info(frame_ref, &info, &e);
+            error::handle(e);
+            return info;
+        }
+
         /**
         * retrieve data from frame handle
         * \return               the pointer to the start of the frame data
@@ -621,6 +647,19 @@ namespace rs2
         * \return            number of bytes per one pixel
         */
         int get_bytes_per_pixel() const { return get_bits_per_pixel() / 8; }
+
+        /**
+        * convert the image of the frame into another format, straight into a buffer of the application
+        * \param[out] dest     buffer of at least get_height() rows of dest_stride bytes, receiving the converted image
+        * \param[in] format    format to convert the image into
+        * \param[in] dest_stride  number of bytes from the start of a row of dest to the start of the next, 0 for rows right one after the other
+        */
+        void copy_to(void* dest, rs2_format format, int dest_stride = 0) const
+        {
+            rs2_error* e = nullptr;
+            rs2_frame_copy_to(get(), dest, dest_stride, format, &e);
+            error::handle(e);
+        }
     };
 
     struct vertex {
@@ -673,17 +712,37 @@ namespace rs2
             return (const vertex*)res;
         }
 
+        /**
+        * Retrieve the X, Y or Z of every vertex of planar points, see RS2_OPTION_POINTS_LAYOUT
+        * \param[in] axis - 0 for X, 1 for Y and 2 for Z
+        * \return const float* - pointer of one float per vertex, or null for interleaved points, whose get_vertices() is read instead
+        */
+        const float* get_vertex_plane(int axis) const
+        {
+            rs2_error* e = nullptr;
+            auto res = rs2_get_frame_vertex_plane(get(), axis, &e);
+            error::handle(e);
+            return res;
+        }
+
+        bool is_planar() const { return get_vertex_plane(0) != nullptr; }
+
         /**
         * Export current point cloud to PLY file
         * \param[in] string fname - file name of the PLY to be saved
         * \param[in] video_frame texture - the texture for the PLY.
+        * \param[in] bool normals - also export the normal of every vertex
+        * \param[in] bool faces - also export the triangles between neighbouring vertices
         */
-        void export_to_ply(const std::string& fname, video_frame texture)
+        void export_to_ply(const std::string& fname, video_frame texture, bool normals = false, bool faces = false)
         {
             rs2_frame* ptr = nullptr;
             std::swap(texture.frame_ref, ptr);
             rs2_error* e = nullptr;
-            rs2_export_to_ply(get(), fname.c_str(), ptr, &e);
+            if (normals || faces)
+                rs2_export_mesh_to_ply(get(), fname.c_str(), ptr, normals, faces, &e);
+            else
+                rs2_export_to_ply(get(), fname.c_str(), ptr, &e);
             error::handle(e);
         }
         /**
@@ -698,6 +757,42 @@ namespace rs2
             return (const texture_coordinate*)res;
         }
 
+        /**
+        * return the depth pixel index of every vertex, when the point cloud was compacted to its valid points
+        * \return const int* - pointer of pixel indices, or null if the vertices map the depth pixels in order.
+        */
+        const int* get_pixel_indices() const
+        {
+            rs2_error* e = nullptr;
+            auto res = rs2_get_frame_pixel_indices(get(), &e);
+            error::handle(e);
+            return res;
+        }
+
+        /**
+        * return the unit normal of every vertex, facing the camera, when the point cloud was computed with normals
+        * \return const vertex* - pointer of normals, or null without normals.
+        */
+        const vertex* get_normals() const
+        {
+            rs2_error* e = nullptr;
+            auto res = rs2_get_frame_normals(get(), &e);
+            error::handle(e);
+            return (const vertex*)res;
+        }
+
+        /**
+        * return the red, green and blue bytes of every vertex, when the point cloud was computed with its colors
+        * \return const uint8_t* - pointer of 3 bytes per vertex, or null without colors.
+        */
+        const uint8_t* get_colors() const
+        {
+            rs2_error* e = nullptr;
+            auto res = rs2_get_frame_colors(get(), &e);
+            error::handle(e);
+            return res;
+        }
+
         size_t size() const
         {
             return _size;
@@ -738,6 +833,34 @@ namespace rs2
             error::handle(e);
             return r;
         }
+
+        /**
+        * Retrieve the depth, or the 3D point, of many pixels at once, see rs2_depth_frame_sample
+        * \param[in] pixels  coordinates of count pixels, interleaved as x, y
+        * \param[in] count   number of pixels
+        * \param[out] output receives a float per pixel of RS2_DEPTH_SAMPLE_DISTANCE, or three of RS2_DEPTH_SAMPLE_POINT
+        * \param[in] mode    what is computed of every pixel
+        * \param[in] window  odd size of the window the depth is the median of, 1 for the pixel itself
+        */
+        void sample(const float* pixels, int count, float* output, rs2_depth_sample_mode mode = RS2_DEPTH_SAMPLE_DISTANCE, int window = 1) const
+        {
+            rs2_error * e = nullptr;
+            rs2_depth_frame_sample(get(), pixels, count, output, mode, window, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Retrieve the validity mask of the frame, of a bit per pixel set for the pixels with depth, see rs2_depth_frame_get_validity_mask
+        * \param[out] words  if non-null, receives the number of 64-bit words of the mask
+        * \return the words of the mask, valid for as long as the frame is
+        */
+        const unsigned long long* get_validity_mask(int* words = nullptr) const
+        {
+            rs2_error * e = nullptr;
+            auto r = rs2_depth_frame_get_validity_mask(get(), words, &e);
+            error::handle(e);
+            return r;
+        }
     };
 
     class disparity_frame : public depth_frame
@@ -798,6 +921,48 @@ namespace rs2
         }
     };
 
+    class motion_batch_frame : public motion_frame
+    {
+    public:
+        /**
+        * Inherit motion_frame class with access to the samples of batched motion frames
+        * \param[in] frame - existing frame instance
+        */
+        motion_batch_frame(const frame& f)
+            : motion_frame(f), _samples(nullptr), _count(0)
+        {
+            rs2_error* e = nullptr;
+            if (!f || (rs2_is_frame_extendable_to(f.get(), RS2_EXTENSION_MOTION_BATCH_FRAME, &e) == 0 && !e))
+            {
+                reset();
+            }
+            error::handle(e);
+
+            if (get())
+            {
+                _samples = rs2_get_motion_samples(get(), &_count, &e);
+                error::handle(e);
+            }
+        }
+        /**
+        * Retrieve the number of samples of the frame
+        * \return int - number of samples
+        */
+        int size() const { return _count; }
+        /**
+        * Retrieve a sample of the frame, in the order they were captured
+        * \param[in] index - index of the sample, below size()
+        * \return rs2_motion_sample - motion data and timestamp of the sample
+        */
+        const rs2_motion_sample& operator[](int index) const { return _samples[index]; }
+        const rs2_motion_sample* begin() const { return _samples; }
+        const rs2_motion_sample* end() const { return _samples + _count; }
+
+    private:
+        const rs2_motion_sample* _samples;
+        int _count;
+    };
+
     class pose_frame : public frame
     {
     public:
@@ -829,6 +994,75 @@ namespace rs2
         }
     };
 
+    class gpu_frame : public frame
+    {
+    public:
+        /**
+        * Inherit frame class with access to the device memory of frames produced on the GPU
+        * \param[in] frame - existing frame instance
+        */
+        gpu_frame(const frame& f)
+            : frame(f)
+        {
+            rs2_error* e = nullptr;
+            if (!f || (rs2_is_frame_extendable_to(f.get(), RS2_EXTENSION_GPU_FRAME, &e) == 0 && !e))
+            {
+                reset();
+            }
+            error::handle(e);
+        }
+        /**
+        * Retrieve the CUDA device pointer to the frame data, to hand it to GPU consumers without copying it to the host
+        * \return const void* - device pointer to the start of the frame data, valid for as long as the frame is held
+        */
+        const void* get_device_pointer() const
+        {
+            rs2_error* e = nullptr;
+            auto r = rs2_get_frame_device_pointer(get(), &e);
+            error::handle(e);
+            return r;
+        }
+    };
+
+    class dmabuf_frame : public video_frame
+    {
+    public:
+        /**
+        * Inherit video_frame class with access to the DMABUF of frames delivered in exported backend buffers
+        * \param[in] frame - existing frame instance
+        */
+        dmabuf_frame(const frame& f)
+            : video_frame(f), _fd(-1), _offset(0)
+        {
+            rs2_error* e = nullptr;
+            if (!f || (rs2_is_frame_extendable_to(f.get(), RS2_EXTENSION_DMABUF_FRAME, &e) == 0 && !e))
+            {
+                reset();
+            }
+            error::handle(e);
+
+            if (get())
+            {
+                _fd = rs2_get_frame_dmabuf(get(), &_offset, nullptr, &e);
+                error::handle(e);
+            }
+        }
+        /**
+        * Retrieve the DMABUF file descriptor, to import the frame into EGL, Vulkan or VA-API without copying it
+        * \return int - file descriptor owned by librealsense, valid for as long as the frame is held
+        */
+        int get_fd() const { return _fd; }
+        /**
+        * Retrieve the offset of the frame data from the start of the DMABUF
+        * \return int - offset in bytes, the rows are get_stride_in_bytes() apart
+        */
+        int get_offset() const { return _offset; }
+
+    private:
+        int _fd;
+        int _offset;
+    };
+
     class frameset : public frame
     {
     public:
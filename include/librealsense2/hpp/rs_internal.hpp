@@ -100,6 +100,18 @@ namespace rs2
             error::handle(e);
         }
 
+        /**
+        * Inject several frames, of any of the streams of the sensor, in a single call
+        *
+        * \param[in] frames  the frames, in the order they are to be delivered
+        */
+        void on_video_frames(const std::vector<rs2_software_video_frame>& frames)
+        {
+            rs2_error* e = nullptr;
+            rs2_software_sensor_on_video_frames(_sensor.get(), frames.data(), static_cast<int>(frames.size()), &e);
+            error::handle(e);
+        }
+
         /**
         * Set frame metadata for the upcoming frames
         * \param[in] value metadata key to set
@@ -7,6 +7,7 @@
 #include "rs_types.hpp"
 #include "rs_frame.hpp"
 #include "rs_context.hpp"
+#include "rs_processing.hpp"
 
 namespace rs2
 {
@@ -212,6 +213,20 @@ namespace rs2
             error::handle(e);
         }
 
+        /**
+        * Add a device to the devices the pipeline streams from, with the same stream requests. The first device added is the
+        * one selected by \c enable_device(), whose profile is that of the pipeline. The framesets the pipeline returns hold
+        * the frames of all the devices, matched on the host times of their frames.
+        *
+        * \param[in] serial device serial number, as returned by RS2_CAMERA_INFO_SERIAL_NUMBER
+        */
+        void add_device(const std::string& serial)
+        {
+            rs2_error* e = nullptr;
+            rs2_config_add_device(_config.get(), serial.c_str(), &e);
+            error::handle(e);
+        }
+
         /**
         * Select a recorded device from a file, to be used by the pipeline through playback.
         * The device available streams are as recorded to the file, and \c resolve() considers only this device and
@@ -241,6 +256,75 @@ namespace rs2
             error::handle(e);
         }
 
+        /**
+        * Sets the compression of the frames of a stream in the file enable_record_to_file() records to
+        *
+        * \param[in] stream       The stream type
+        * \param[in] compression  The compression of the frames of the stream
+        */
+        void enable_record_compression(rs2_stream stream, rs2_record_compression compression)
+        {
+            rs2_error* e = nullptr;
+            rs2_config_enable_record_compression(_config.get(), stream, compression, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Require that the resolved streams fit the estimated bandwidth of the USB bus of the device, together with the streams
+        * the other devices on the bus run in this process. \c resolve() fails otherwise, suggesting the nearest streams that fit.
+        *
+        * \param[in] enable  true to check the bandwidth when resolving
+        */
+        void enable_usb_bandwidth_check(bool enable = true)
+        {
+            rs2_error* e = nullptr;
+            rs2_config_enable_usb_bandwidth_check(_config.get(), enable ? 1 : 0, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Run a processing block on the framesets of the pipeline, on a worker thread of its own, before they are returned by
+        * \c wait_for_frames() and \c poll_for_frames(), so that the processing overlaps with that of the application.
+        * Blocks run in the order they were added, each on the output of the previous one, and take over the output of the block.
+        * A \c processing_graph can be added for blocks that are not a chain.
+        *
+        * \param[in] block  the processing block to run
+        */
+        void add_processing_block(const processing_block& block)
+        {
+            rs2_error* e = nullptr;
+            rs2_config_add_processing_block(_config.get(), block.get(), &e);
+            error::handle(e);
+        }
+
+        /**
+        * Bound the latency of the framesets under load, taking the actions in order one at a time while the framesets are
+        * late or dropped, and undoing them once the load subsides. An action may be repeated, to raise the decimation or to
+        * halve the rate several times
+        *
+        * \param[in] max_latency_ms  latency from the driver the framesets are to be read within, 0 to disable the governor
+        * \param[in] actions         the actions in the order they are taken
+        */
+        void enable_load_governor(float max_latency_ms, const std::vector<rs2_load_action>& actions)
+        {
+            rs2_error* e = nullptr;
+            rs2_config_enable_load_governor(_config.get(), max_latency_ms, actions.data(), int(actions.size()), &e);
+            error::handle(e);
+        }
+
+        /**
+        * Set a stream as of low priority, for RS2_LOAD_ACTION_DROP_STREAMS to leave it out of the framesets
+        *
+        * \param[in] stream  the stream type
+        * \param[in] index   the stream index, -1 for every stream of the type
+        */
+        void set_low_priority_stream(rs2_stream stream, int index = -1)
+        {
+            rs2_error* e = nullptr;
+            rs2_config_set_low_priority_stream(_config.get(), stream, index, &e);
+            error::handle(e);
+        }
+
         /**
         * Disable a device stream explicitly, to remove any requests on this stream profile.
         * The stream can still be enabled due to pipeline computer vision module request. This call removes any filter on the
@@ -505,6 +589,21 @@ namespace rs2
             return pipeline_profile(p);
         }
 
+        /**
+        * Return the counters of the frames received, dropped and queued at every stage of the pipeline, since it was started.
+        * The method is valid only when the pipeline is active, and may be called while another thread waits for frames.
+        *
+        * \return  The counters of the sensors, the syncer and the queue of the pipeline
+        */
+        rs2_pipeline_health get_health() const
+        {
+            rs2_pipeline_health health{};
+            rs2_error* e = nullptr;
+            rs2_pipeline_get_health(_pipeline.get(), &health, &e);
+            error::handle(e);
+            return health;
+        }
+
         operator std::shared_ptr<rs2_pipeline>() const
         {
             return _pipeline;
@@ -515,5 +614,27 @@ namespace rs2
         std::shared_ptr<rs2_pipeline> _pipeline;
         friend class config;
     };
+
+    /**
+    * Wait for the first of several frame queues and started pipelines to have frames, with no polling, see rs2_wait_for_any
+    * \param[in] queues     frame queues to wait on
+    * \param[in] pipelines  started pipelines to wait on
+    * \param[in] timeout_ms max time in milliseconds to wait
+    * \return the index of the first with frames, the queues first and the pipelines after them, or -1 on timeout
+    */
+    inline int wait_for_any(const std::vector<frame_queue>& queues, const std::vector<pipeline>& pipelines, unsigned int timeout_ms = 5000)
+    {
+        std::vector<rs2_frame_queue*> queue_refs;
+        for (auto&& q : queues) queue_refs.push_back(q.get());
+        std::vector<std::shared_ptr<rs2_pipeline>> pipes(pipelines.begin(), pipelines.end());
+        std::vector<rs2_pipeline*> pipe_refs;
+        for (auto&& p : pipes) pipe_refs.push_back(p.get());
+
+        rs2_error* e = nullptr;
+        auto res = rs2_wait_for_any(queue_refs.data(), static_cast<int>(queue_refs.size()),
+            pipe_refs.data(), static_cast<int>(pipe_refs.size()), timeout_ms, &e);
+        error::handle(e);
+        return res;
+    }
 }
 #endif // LIBREALSENSE_RS2_PROCESSING_HPP
@@ -53,6 +53,16 @@ namespace rs2
             return result;
         }
 
+        frame allocate_points(const stream_profile& profile,
+            const frame& original, int count, bool pixel_indices, bool normals = false) const
+        {
+            rs2_error* e = nullptr;
+            auto result = normals ? rs2_allocate_points_with_normals(_source, profile.get(), original.get(), count, pixel_indices ? 1 : 0, &e)
+                : rs2_allocate_compact_points(_source, profile.get(), original.get(), count, pixel_indices ? 1 : 0, &e);
+            error::handle(e);
+            return result;
+        }
+
         /**
         * Allocate composite frame with given params
         *
@@ -128,6 +138,38 @@ namespace rs2
             error::handle(e);
         }
 
+        /**
+        * create frame queue with a policy for the frames that arrive while it is full
+        * param[in] capacity   size of the frame queue, 1 for RS2_FRAME_QUEUE_POLICY_KEEP_LATEST
+        * param[in] policy     what to do with a new frame when the queue is full
+        * param[in] timeout_ms how long RS2_FRAME_QUEUE_POLICY_BLOCK blocks the producer before dropping the new frame
+        */
+        frame_queue(unsigned int capacity, rs2_frame_queue_policy policy, unsigned int timeout_ms = 5000)
+            : _capacity(policy == RS2_FRAME_QUEUE_POLICY_KEEP_LATEST ? 1 : capacity)
+        {
+            rs2_error* e = nullptr;
+            _queue = std::shared_ptr<rs2_frame_queue>(
+                rs2_create_frame_queue_with_policy(capacity, policy, timeout_ms, &e),
+                rs2_delete_frame_queue);
+            error::handle(e);
+        }
+
+        /**
+        * create frame queue that spills the frames it has no room for to a file, to be delivered in order after its own
+        * param[in] capacity        size of the frame queue in memory
+        * param[in] spill_file      path of the file to spill the frames to, removed with the queue
+        * param[in] max_spill_bytes max size of the spill file, the frames that find it full being dropped
+        */
+        frame_queue(unsigned int capacity, const std::string& spill_file, unsigned long long max_spill_bytes)
+            : _capacity(capacity)
+        {
+            rs2_error* e = nullptr;
+            _queue = std::shared_ptr<rs2_frame_queue>(
+                rs2_create_frame_queue_with_spill(capacity, spill_file.c_str(), max_spill_bytes, &e),
+                rs2_delete_frame_queue);
+            error::handle(e);
+        }
+
         frame_queue() : frame_queue(1) {}
 
         /**
@@ -193,6 +235,33 @@ namespace rs2
         */
         size_t capacity() const { return _capacity; }
 
+        /**
+        * return the number of frames the queue dropped since it was created
+        * \return dropped frames
+        */
+        unsigned long long dropped_frames() const
+        {
+            rs2_error* e = nullptr;
+            auto res = rs2_get_frame_queue_dropped_frames(_queue.get(), &e);
+            error::handle(e);
+            return res;
+        }
+
+        /**
+        * return the number of frames the queue holds in its spill file
+        * \param[out] spilled_bytes if non-null, receives the bytes of the spill file that they take
+        * \return spilled frames
+        */
+        int spilled_frames(unsigned long long* spilled_bytes = nullptr) const
+        {
+            rs2_error* e = nullptr;
+            auto res = rs2_get_frame_queue_spilled_frames(_queue.get(), spilled_bytes, &e);
+            error::handle(e);
+            return res;
+        }
+
+        rs2_frame_queue* get() const { return _queue.get(); }
+
     private:
         std::shared_ptr<rs2_frame_queue> _queue;
         size_t _capacity;
@@ -250,7 +319,8 @@ namespace rs2
         */
         rs2::frame process(rs2::frame frame) const override
         {
-            invoke(frame);
+            // Passing on the reference lets the block process a frame that nothing else references in place
+            invoke(std::move(frame));
             rs2::frame f;
             if (!_queue.poll_for_frame(&f))
                 throw std::runtime_error("Error occured during execution of the processing block! See the log for more info");
@@ -282,6 +352,41 @@ namespace rs2
             error::handle(e);
         }
 
+        /**
+        * Retrieve the invocation statistics of the processing block, recorded while RS2_OPTION_PROCESSING_STATISTICS is set
+        *
+        * \return the statistics recorded since they were last enabled
+        */
+        rs2_processing_block_stats get_stats() const
+        {
+            rs2_error* e = nullptr;
+            rs2_processing_block_stats stats;
+            rs2_get_processing_block_stats(get(), &stats, &e);
+            error::handle(e);
+            return stats;
+        }
+
+        /**
+        * Restrict the processing to a rectangle of the input frames, excluding max_x and max_y. Supported by the depth filters and the pointcloud
+        *
+        * \param[in] roi  the rectangle, or an empty one to process the whole frame
+        */
+        void set_region_of_interest(const region_of_interest& roi)
+        {
+            rs2_error* e = nullptr;
+            rs2_set_processing_block_roi(get(), roi.min_x, roi.min_y, roi.max_x, roi.max_y, &e);
+            error::handle(e);
+        }
+
+        region_of_interest get_region_of_interest() const
+        {
+            region_of_interest roi {};
+            rs2_error* e = nullptr;
+            rs2_get_processing_block_roi(get(), &roi.min_x, &roi.min_y, &roi.max_x, &roi.max_y, &e);
+            error::handle(e);
+            return roi;
+        }
+
         frame_queue get_queue() { return _queue; }
         operator rs2_options*() const { return (rs2_options*)get(); }
         rs2_processing_block* get() const override { return _block.get(); }
@@ -434,11 +539,143 @@ namespace rs2
         {
             _sync.invoke(std::move(f));
         }
+
+        /**
+        * Limit the time a frameset is held back waiting for its missing frames, after which it is emitted without them
+        * \param[in] ms   the budget in milliseconds, or 0 to wait for as long as the frame rates of the streams suggest
+        */
+        void set_latency_budget(float ms)
+        {
+            _sync.set_option(RS2_OPTION_SYNC_LATENCY_BUDGET, ms);
+        }
+
+        /**
+        * Number of framesets emitted without a frame of a stream because the latency budget ran out
+        * \param[in] profile   the profile of the stream
+        * \return the number of incomplete framesets
+        */
+        unsigned long long get_incomplete_framesets(const stream_profile& profile) const
+        {
+            rs2_error* e = nullptr;
+            auto count = rs2_get_sync_incomplete_framesets(_sync.get(), profile.unique_id(), &e);
+            error::handle(e);
+            return count;
+        }
+
+        /**
+        * Counters of the frames of a stream reaching the syncer
+        * \param[in] profile   the profile of the stream
+        * \return the counters, kept since the syncer first received a frame of the stream
+        */
+        rs2_sync_stream_stats get_stream_stats(const stream_profile& profile) const
+        {
+            rs2_error* e = nullptr;
+            rs2_sync_stream_stats stats;
+            rs2_get_sync_stream_stats(_sync.get(), profile.unique_id(), &stats, &e);
+            error::handle(e);
+            return stats;
+        }
+
+        /**
+        * Histogram of the time framesets took to be dispatched, from the arrival of their first frame
+        * \return RS2_SYNC_LATENCY_BUCKETS bucket counts. Bucket 0 counts the framesets dispatched within a millisecond, bucket i those
+        * dispatched within 2^i milliseconds
+        */
+        std::vector<unsigned long long> get_latency_histogram() const
+        {
+            rs2_error* e = nullptr;
+            std::vector<unsigned long long> buckets(RS2_SYNC_LATENCY_BUCKETS);
+            rs2_get_sync_latency_histogram(_sync.get(), buckets.data(), RS2_SYNC_LATENCY_BUCKETS, &e);
+            error::handle(e);
+            return buckets;
+        }
     private:
         asynchronous_syncer _sync;
         frame_queue _results;
     };
 
+    class asynchronous_multi_device_syncer : public processing_block
+    {
+    public:
+        /**
+        * Real asynchronous syncer within multi_device_syncer class
+        */
+        asynchronous_multi_device_syncer() : processing_block(init(), 1) {}
+
+    private:
+        std::shared_ptr<rs2_processing_block> init()
+        {
+            rs2_error* e = nullptr;
+            auto block = std::shared_ptr<rs2_processing_block>(
+                rs2_create_multi_device_sync_processing_block(&e),
+                rs2_delete_processing_block);
+
+            error::handle(e);
+            return block;
+        }
+    };
+
+    /**
+    * Syncer matching the frames, or the framesets, of several devices into framesets of all of them.
+    * The hardware timestamps of every device are mapped onto the host clock, with the offset and the drift of the device clock
+    * estimated as its frames arrive
+    */
+    class multi_device_syncer
+    {
+    public:
+        multi_device_syncer(int queue_size = 1)
+            :_results(queue_size)
+        {
+            _sync.start(_results);
+        }
+
+        /**
+        * Wait until a set of frames of all the devices becomes available
+        * \param[in] timeout_ms   Max time in milliseconds to wait until an exception will be thrown
+        * \return Set of frames taken together
+        */
+        frameset wait_for_frames(unsigned int timeout_ms = 5000) const
+        {
+            return frameset(_results.wait_for_frame(timeout_ms));
+        }
+
+        /**
+        * Check if a set of frames of all the devices is available
+        * \param[out] fs      New set of frames
+        * \return true if new frame-set was stored to result
+        */
+        bool poll_for_frames(frameset* fs) const
+        {
+            frame result;
+            if (_results.poll_for_frame(&result))
+            {
+                *fs = frameset(result);
+                return true;
+            }
+            return false;
+        }
+
+        /**
+        * Limit the time a frameset is held back waiting for the frames of the other devices, after which it is emitted without them
+        * \param[in] ms   the budget in milliseconds, or 0 to wait for as long as the devices keep streaming
+        */
+        void set_latency_budget(float ms)
+        {
+            _sync.set_option(RS2_OPTION_SYNC_LATENCY_BUDGET, ms);
+        }
+
+        /**
+        * Send a frame, or a frameset, of one of the devices to the syncer
+        */
+        void operator()(frame f) const
+        {
+            _sync.invoke(std::move(f));
+        }
+    private:
+        asynchronous_multi_device_syncer _sync;
+        frame_queue _results;
+    };
+
     /**
     Auxiliary processing block that performs image alignment using depth data and camera calibration
     */
@@ -456,6 +693,16 @@ namespace rs2
         */
         align(rs2_stream align_to) : processing_block(init(align_to), 1) {}
 
+        /**
+        Create align processing block aligning the depth to a reduced resolution of the other stream
+        * \param[in] align_to      The stream type to which the depth is aligned, other than RS2_STREAM_DEPTH
+        * \param[in] target_scale  Scale of the resolution of that stream the aligned depth is computed at, see RS2_OPTION_TARGET_SCALE
+        */
+        align(rs2_stream align_to, float target_scale) : processing_block(init(align_to), 1)
+        {
+            set_option(RS2_OPTION_TARGET_SCALE, target_scale);
+        }
+
         /**
         * Run the alignment process on the given frames to get an aligned set of frames
         *
@@ -569,6 +816,35 @@ namespace rs2
         }
     };
 
+    class depth_statistics : public processing_block
+    {
+    public:
+        /**
+        * Create a block that attaches the min, max, mean, fill rate and histogram of depth frames to them as metadata
+        */
+        depth_statistics() : processing_block(init(), 1) {}
+
+        /**
+        * Create a block that attaches the min, max, mean, fill rate and histogram of depth frames to them as metadata
+        * \param[in] histogram_range - depth, in meters, the bins of the histogram span
+        */
+        depth_statistics(float histogram_range) : processing_block(init(), 1)
+        {
+            set_option(RS2_OPTION_DEPTH_HISTOGRAM_RANGE, histogram_range);
+        }
+
+    private:
+        std::shared_ptr<rs2_processing_block> init()
+        {
+            rs2_error* e = nullptr;
+            auto block = std::shared_ptr<rs2_processing_block>(
+                rs2_create_depth_statistics_block(&e),
+                rs2_delete_processing_block);
+            error::handle(e);
+            return block;
+        }
+    };
+
     class temporal_filter : public processing_block
     {
     public:
@@ -694,6 +970,272 @@ namespace rs2
         }
     };
 
+    class depth_compressor : public processing_block
+    {
+    public:
+        /**
+        * Create a block that losslessly compresses Z16 frames into RS2_FORMAT_Z16_RVL frames
+        */
+        depth_compressor() : processing_block(init(), 1) { }
+
+    private:
+        std::shared_ptr<rs2_processing_block> init()
+        {
+            rs2_error* e = nullptr;
+            auto block = std::shared_ptr<rs2_processing_block>(
+                rs2_create_depth_compressor_block(&e),
+                rs2_delete_processing_block);
+            error::handle(e);
+            return block;
+        }
+    };
+
+    class depth_decompressor : public processing_block
+    {
+    public:
+        /**
+        * Create a block that decompresses RS2_FORMAT_Z16_RVL frames back into Z16 frames
+        */
+        depth_decompressor() : processing_block(init(), 1) { }
+
+    private:
+        std::shared_ptr<rs2_processing_block> init()
+        {
+            rs2_error* e = nullptr;
+            auto block = std::shared_ptr<rs2_processing_block>(
+                rs2_create_depth_decompressor_block(&e),
+                rs2_delete_processing_block);
+            error::handle(e);
+            return block;
+        }
+    };
+
+    class voxel_filter : public processing_block
+    {
+    public:
+        /**
+        * Create a block that downsamples point clouds, or depth frames it deprojects, to a single point per occupied voxel of a grid
+        */
+        voxel_filter() : processing_block(init(), 1) { }
+
+        /**
+        * Create a block that downsamples point clouds, or depth frames it deprojects, to a single point per occupied voxel of a grid
+        * \param[in] voxel_size - edge length of the voxels, in meters
+        * \param[in] first_hit - output the first point of every voxel, rather than the centroid of its points
+        */
+        voxel_filter(float voxel_size, bool first_hit = false) : processing_block(init(), 1)
+        {
+            set_option(RS2_OPTION_VOXEL_SIZE, voxel_size);
+            set_option(RS2_OPTION_VOXEL_POINT, first_hit ? 1.f : 0.f);
+        }
+
+        /**
+        * Downsample a point cloud or a depth frame
+        * \param[in] f - points or depth frame
+        * \return points - a point per occupied voxel
+        */
+        points calculate(frame f)
+        {
+            return process(f);
+        }
+
+    private:
+        std::shared_ptr<rs2_processing_block> init()
+        {
+            rs2_error* e = nullptr;
+            auto block = std::shared_ptr<rs2_processing_block>(
+                rs2_create_voxel_filter_block(&e),
+                rs2_delete_processing_block);
+            error::handle(e);
+            return block;
+        }
+    };
+
+    class normals_filter : public processing_block
+    {
+    public:
+        /**
+        * Create a block that computes the normal map of point clouds of whole depth images
+        */
+        normals_filter() : processing_block(init(), 1) { }
+
+        /**
+        * Create a block that computes the normal map of point clouds of whole depth images
+        * \param[in] window - half the side, in pixels, of the window of neighbours the normals are averaged over
+        */
+        normals_filter(int window) : processing_block(init(), 1)
+        {
+            set_option(RS2_OPTION_NORMALS_WINDOW, float(window));
+        }
+
+        /**
+        * Compute the normal map of a point cloud
+        * \param[in] cloud - points of a whole depth image, as computed by the pointcloud block without compaction
+        * \return video_frame - the normal of every vertex, as RS2_FORMAT_XYZ32F
+        */
+        video_frame calculate(points cloud)
+        {
+            return process(cloud);
+        }
+
+    private:
+        std::shared_ptr<rs2_processing_block> init()
+        {
+            rs2_error* e = nullptr;
+            auto block = std::shared_ptr<rs2_processing_block>(
+                rs2_create_normals_filter_block(&e),
+                rs2_delete_processing_block);
+            error::handle(e);
+            return block;
+        }
+    };
+
+    class colored_pointcloud : public processing_block
+    {
+    public:
+        /**
+        * Create a block that computes the point cloud of depth frames in the coordinates of the color frame, with the color of every point
+        */
+        colored_pointcloud() : processing_block(init(), 1) { }
+
+        /**
+        * Compute the colored point cloud of a frameset
+        * \param[in] frames - frameset of a Z16 depth frame and an RGB8, BGR8, RGBA8 or BGRA8 color frame
+        * \return points - the points of every depth pixel in the coordinates of the color camera, with their colors, see points::get_colors
+        */
+        points calculate(frameset frames)
+        {
+            auto res = process(frames);
+            if (auto set = res.as<frameset>())
+            {
+                for (auto f : set)
+                    if (auto p = f.as<points>())
+                        return p;
+            }
+            return res.as<points>();
+        }
+
+    private:
+        std::shared_ptr<rs2_processing_block> init()
+        {
+            rs2_error* e = nullptr;
+            auto block = std::shared_ptr<rs2_processing_block>(
+                rs2_create_colored_pointcloud_block(&e),
+                rs2_delete_processing_block);
+            error::handle(e);
+            return block;
+        }
+    };
+
+    class pointcloud_merger : public processing_block
+    {
+    public:
+        /**
+        * Create a block that merges the depth frames of a frameset of several cameras into a single point cloud in the coordinates of the world
+        */
+        pointcloud_merger() : processing_block(init(), 1) { }
+
+        /**
+        * Set the extrinsics from a stream to the world
+        * \param[in] profile - the depth stream of a camera, or any stream the extrinsics of the device link the depth to
+        * \param[in] to_world - extrinsics from the stream to the world
+        */
+        void set_world_extrinsics(const stream_profile& profile, const rs2_extrinsics& to_world)
+        {
+            rs2_error* e = nullptr;
+            rs2_pointcloud_merger_set_world_extrinsics(get(), profile.get(), &to_world, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Merge the depth frames of a frameset
+        * \param[in] frames - frameset of depth frames, or a single depth frame
+        * \return points - the points of every camera, in the coordinates of the world
+        */
+        points calculate(frame frames)
+        {
+            return process(frames);
+        }
+
+    private:
+        std::shared_ptr<rs2_processing_block> init()
+        {
+            rs2_error* e = nullptr;
+            auto block = std::shared_ptr<rs2_processing_block>(
+                rs2_create_pointcloud_merger_block(&e),
+                rs2_delete_processing_block);
+            error::handle(e);
+            return block;
+        }
+    };
+
+    class tsdf_fusion : public processing_block
+    {
+    public:
+        /**
+        * Create a block that integrates depth frames into a volume for reconstruction. The frames pass through the block
+        */
+        tsdf_fusion() : processing_block(init(), 1) { }
+
+        /**
+        * Set the pose of the camera of the depth frames without a pose frame
+        * \param[in] camera_to_world - extrinsics from the depth stream to the world of the volume
+        */
+        void set_camera_pose(const rs2_extrinsics& camera_to_world)
+        {
+            rs2_error* e = nullptr;
+            rs2_tsdf_fusion_set_camera_pose(get(), &camera_to_world, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Clear the volume
+        */
+        void reset()
+        {
+            rs2_error* e = nullptr;
+            rs2_tsdf_fusion_reset(get(), &e);
+            error::handle(e);
+        }
+
+        /**
+        * Raycast the volume from a camera
+        * \param[in] intrinsics - intrinsics of the camera
+        * \param[in] camera_to_world - pose of the camera in the world of the volume
+        * \return points - the surface seen by every pixel, with normals, in the coordinates of the camera
+        */
+        points raycast(const rs2_intrinsics& intrinsics, const rs2_extrinsics& camera_to_world)
+        {
+            rs2_error* e = nullptr;
+            auto result = rs2_tsdf_fusion_raycast(get(), &intrinsics, &camera_to_world, &e);
+            error::handle(e);
+            return points(frame(result));
+        }
+
+        /**
+        * Extract the surfaces of the volume
+        * \return points - the zero crossings of the distances, with normals, in the coordinates of the world
+        */
+        points extract_points()
+        {
+            rs2_error* e = nullptr;
+            auto result = rs2_tsdf_fusion_extract_points(get(), &e);
+            error::handle(e);
+            return points(frame(result));
+        }
+
+    private:
+        std::shared_ptr<rs2_processing_block> init()
+        {
+            rs2_error* e = nullptr;
+            auto block = std::shared_ptr<rs2_processing_block>(
+                rs2_create_tsdf_fusion_block(&e),
+                rs2_delete_processing_block);
+            error::handle(e);
+            return block;
+        }
+    };
+
     class hole_filling_filter : public processing_block
     {
     public:
@@ -733,5 +1275,127 @@ namespace rs2
             return block;
         }
     };
+
+    class depth_post_processing : public processing_block
+    {
+    public:
+        /**
+        * Create a block that runs the decimation -> depth to disparity -> spatial -> temporal -> disparity to depth -> hole filling chain
+        * in strips of rows that stay in the cache, and allocates only the final depth frame. The results are those of the separate blocks
+        * \param[in] decimation    the decimation filter, configured through its own options, or null to leave it out of the chain
+        * \param[in] spatial       the spatial filter, configured through its own options, or null to leave it out of the chain
+        * \param[in] temporal      the temporal filter, configured through its own options, or null to leave it out of the chain
+        * \param[in] hole_filling  the hole filling filter, configured through its own options, or null to leave it out of the chain
+        */
+        depth_post_processing(const decimation_filter* decimation, const spatial_filter* spatial,
+            const temporal_filter* temporal, const hole_filling_filter* hole_filling)
+            : processing_block(init(decimation, spatial, temporal, hole_filling), 1) {}
+
+    private:
+        friend class context;
+
+        static rs2_processing_block* get_block(const processing_block* block) { return block ? block->get() : nullptr; }
+
+        std::shared_ptr<rs2_processing_block> init(const decimation_filter* decimation, const spatial_filter* spatial,
+            const temporal_filter* temporal, const hole_filling_filter* hole_filling)
+        {
+            rs2_error* e = nullptr;
+            auto block = std::shared_ptr<rs2_processing_block>(
+                rs2_create_depth_post_processing_block(get_block(decimation), get_block(spatial), get_block(temporal), get_block(hole_filling), &e),
+                rs2_delete_processing_block);
+            error::handle(e);
+
+            return block;
+        }
+    };
+
+    class processing_graph : public processing_block
+    {
+    public:
+        /**
+        * Create a graph running processing blocks on a pool of worker threads. Every block processes its frames one at a time and in order,
+        * while different blocks run in parallel, so consecutive frames are pipelined through the graph. Its output is received through start()
+        * \param[in] threads        number of worker threads running the blocks of the graph
+        * \param[in] max_in_flight  number of frames the graph works on at a time. Invoking the graph blocks while it works on this many frames
+        */
+        processing_graph(int threads = 2, int max_in_flight = 4)
+            : processing_block(init(threads, max_in_flight)) {}
+
+        /**
+        * Add a processing block to the graph, which takes over the output of the block. Frames invoked on the graph go to every block without inputs,
+        * and the frames of blocks without outputs are the output of the graph
+        * \param[in] block  the block to add
+        * \return index of the block in the graph
+        */
+        int add(const processing_block& block)
+        {
+            rs2_error* e = nullptr;
+            auto index = rs2_processing_graph_add(get(), block.get(), &e);
+            error::handle(e);
+            return index;
+        }
+
+        /**
+        * Send the output frames of one block of the graph to another
+        * \param[in] from  index of the block whose frames are sent
+        * \param[in] to    index of the block receiving them
+        */
+        void connect(int from, int to)
+        {
+            rs2_error* e = nullptr;
+            rs2_processing_graph_connect(get(), from, to, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Wait until the graph has finished working on all the frames it was given
+        */
+        void flush()
+        {
+            rs2_error* e = nullptr;
+            rs2_processing_graph_flush(get(), &e);
+            error::handle(e);
+        }
+
+        /**
+        * Run a batch of frames through the graph, pipelined as the frames it is invoked on, and wait for the results.
+        * The results do not go through the output of the graph
+        * \param[in] frames  the frames to process
+        * \return for every input frame, the frame that left the graph, a frameset when several did, or an empty frame when none did
+        */
+        std::vector<frame> process(const std::vector<frame>& frames)
+        {
+            std::vector<rs2_frame*> inputs;
+            for (auto&& f : frames)
+            {
+                rs2_error* e = nullptr;
+                rs2_frame_add_ref(f.get(), &e);
+                error::handle(e);
+                inputs.push_back(f.get());
+            }
+
+            std::vector<rs2_frame*> outputs(frames.size(), nullptr);
+            rs2_error* e = nullptr;
+            rs2_processing_graph_process_batch(get(), inputs.data(), outputs.data(), int(inputs.size()), &e);
+            error::handle(e);
+
+            std::vector<frame> results;
+            for (auto ptr : outputs)
+                results.push_back(ptr ? frame(ptr) : frame());
+            return results;
+        }
+
+    private:
+        std::shared_ptr<rs2_processing_block> init(int threads, int max_in_flight)
+        {
+            rs2_error* e = nullptr;
+            auto block = std::shared_ptr<rs2_processing_block>(
+                rs2_create_processing_graph(threads, max_in_flight, &e),
+                rs2_delete_processing_block);
+            error::handle(e);
+
+            return block;
+        }
+    };
 }
 #endif // LIBREALSENSE_RS2_PROCESSING_HPP
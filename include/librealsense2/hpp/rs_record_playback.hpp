@@ -24,6 +24,71 @@ namespace rs2
         void release() override { delete this; }
     };
 
+    template<class T>
+    class segment_closed_callback : public rs2_segment_closed_callback
+    {
+        T on_segment_closed_function;
+    public:
+        explicit segment_closed_callback(T on_segment_closed) : on_segment_closed_function(on_segment_closed) {}
+
+        void on_segment_closed(const char* file) override
+        {
+            on_segment_closed_function(std::string(file));
+        }
+
+        void release() override { delete this; }
+    };
+
+    /**
+    * Codec of the video frames of a stream in recorded files, such as a JPEG encoder. Every frame is coded on its own,
+    * and the functions may be called from several threads at once
+    */
+    class frame_codec
+    {
+    public:
+        virtual ~frame_codec() = default;
+
+        /**
+        * The tag of the frames in the file, by which playback finds the codec to decode them
+        */
+        virtual std::string name() const = 0;
+
+        /**
+        * Encodes a frame into at most capacity bytes
+        * \return The bytes written to encoded, 0 for the frame to be recorded without the codec
+        */
+        virtual size_t encode(const video_frame& frame, uint8_t* encoded, size_t capacity) = 0;
+
+        /**
+        * Decodes a frame into pixels of the given layout, holding stride * height bytes
+        * \return False when the data does not decode
+        */
+        virtual bool decode(const uint8_t* encoded, size_t size, int width, int height, int stride, rs2_format format, uint8_t* pixels) = 0;
+    };
+
+    class frame_codec_adapter : public rs2_frame_codec
+    {
+        std::shared_ptr<frame_codec> _codec;
+        std::string _name;
+    public:
+        explicit frame_codec_adapter(std::shared_ptr<frame_codec> codec) : _codec(std::move(codec)), _name(_codec->name()) {}
+
+        const char* get_name() override { return _name.c_str(); }
+
+        int encode(rs2_frame* f, unsigned char* encoded, int capacity) override
+        {
+            video_frame vf{ frame{ f } };
+            return static_cast<int>(_codec->encode(vf, encoded, static_cast<size_t>(capacity)));
+        }
+
+        int decode(const unsigned char* encoded, int size, int width, int height, int stride, rs2_format format, unsigned char* pixels) override
+        {
+            return _codec->decode(encoded, static_cast<size_t>(size), width, height, stride, format, pixels) ? 1 : 0;
+        }
+
+        void release() override { delete this; }
+    };
+
     class playback : public device
     {
     public:
@@ -126,6 +191,56 @@ namespace rs2
             error::handle(e);
         }
 
+        /**
+        * Sets how many messages of the file are read ahead of their playing, on a thread of their own
+        * \param[in] count  Messages read ahead, 0 to read them on demand, at most 16
+        */
+        void set_read_ahead(int count) const
+        {
+            rs2_error* e = nullptr;
+            rs2_playback_device_set_read_ahead(_dev.get(), count, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Sets whether the file is read through a memory mapping of it rather than through system calls
+        * \param[in] mapped  Indicates if a memory mapping is requested
+        * \return False when the file cannot be mapped, in which case it is read through system calls
+        */
+        bool set_mapped_read(bool mapped) const
+        {
+            rs2_error* e = nullptr;
+            bool result = rs2_playback_device_set_mapped_read(_dev.get(), (mapped ? 1 : 0), &e) != 0;
+            error::handle(e);
+            return result;
+        }
+
+        /**
+        * Sets whether the frames of each stream are decoded before their callback, in parallel with those of other streams
+        * \param[in] parallel  Indicates if parallel decoding is requested
+        */
+        void set_parallel_decode(bool parallel) const
+        {
+            rs2_error* e = nullptr;
+            rs2_playback_device_set_parallel_decode(_dev.get(), (parallel ? 1 : 0), &e);
+            error::handle(e);
+        }
+
+        /**
+        * Retrieves the lateness of the frames the playback published in real time mode since it last started
+        * \param[in] stream    Stream type of the frames, RS2_STREAM_ANY for all streams
+        * \param[in] index     Stream index of the frames, -1 for all indices
+        * \return              The statistics of the lateness
+        */
+        rs2_playback_jitter get_jitter(rs2_stream stream = RS2_STREAM_ANY, int index = -1) const
+        {
+            rs2_playback_jitter jitter{};
+            rs2_error* e = nullptr;
+            rs2_playback_device_get_jitter(_dev.get(), stream, index, &jitter, &e);
+            error::handle(e);
+            return jitter;
+        }
+
         /**
         * Set the playing speed
         * \param[in] speed  Indicates a multiplication of the speed to play (e.g: 1 = normal, 0.5 twice as slow)
@@ -157,6 +272,17 @@ namespace rs2
             error::handle(e);
         }
 
+        /**
+        * Registers a codec to decode the frames recorded with a codec of the same name, when their data is first accessed
+        * \param[in] codec   The codec
+        */
+        void register_codec(std::shared_ptr<frame_codec> codec)
+        {
+            rs2_error* e = nullptr;
+            rs2_playback_device_register_codec(_dev.get(), new frame_codec_adapter(std::move(codec)), &e);
+            error::handle(e);
+        }
+
         /**
         * Returns the current state of the playback device
         * \return Current state of the playback
@@ -219,6 +345,23 @@ namespace rs2
             rs2::error::handle(e);
         }
 
+        /**
+        * Creates a recording device to record the given device to a sequence of files of bounded duration and size,
+        * named after the given file with the index of their segment
+        * \param[in]  file          The desired path to which the segments of the recording are named after
+        * \param[in]  device        The device to record
+        * \param[in]  max_duration  Longest duration of a segment, 0 for no bound on the duration
+        * \param[in]  max_bytes     Size of a segment after which the next one starts, 0 for no bound on the size
+        */
+        recorder(const std::string& file, rs2::device device, std::chrono::milliseconds max_duration, unsigned long long max_bytes)
+        {
+            rs2_error* e = nullptr;
+            _dev = std::shared_ptr<rs2_device>(
+                rs2_create_segmented_record_device(device.get().get(), file.c_str(), static_cast<unsigned long long>(max_duration.count()), max_bytes, &e),
+                rs2_delete_device);
+            rs2::error::handle(e);
+        }
+
         /**
         * Pause the recording device without stopping the actual device from streaming.
         */
@@ -250,6 +393,136 @@ namespace rs2
             error::handle(e);
             return filename;
         }
+
+        /**
+        * Bounds the queue of the frames the recorder has yet to write
+        * \param[in]  max_frames  Frames the queue holds at most, 0 for no bound on the count
+        * \param[in]  max_bytes   Bytes of frame data the queue holds at most, 0 for no bound on the size
+        * \param[in]  policy      What happens to the frames arriving when the queue is full
+        */
+        void set_queue_limit(unsigned long long max_frames, unsigned long long max_bytes,
+                             rs2_record_queue_policy policy = RS2_RECORD_QUEUE_POLICY_DROP_NEWEST)
+        {
+            rs2_error* e = nullptr;
+            rs2_record_device_set_queue_limit(_dev.get(), max_frames, max_bytes, policy, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Sets the priority of a stream for RS2_RECORD_QUEUE_POLICY_DROP_LOW_PRIORITY, 0 by default
+        */
+        void set_stream_priority(rs2_stream stream, int priority)
+        {
+            rs2_error* e = nullptr;
+            rs2_record_device_set_stream_priority(_dev.get(), stream, priority, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Sets the compression of the video frames of a stream, RS2_RECORD_COMPRESSION_NONE by default
+        * \param[in]  stream      The stream type
+        * \param[in]  compression The compression of the frames of the stream
+        */
+        void set_stream_compression(rs2_stream stream, rs2_record_compression compression)
+        {
+            rs2_error* e = nullptr;
+            rs2_record_device_set_stream_compression(_dev.get(), stream, compression, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Sets the codec encoding the video frames of a stream, taking precedence over its compression
+        * \param[in]  stream      The stream type
+        * \param[in]  codec       The codec of the frames of the stream, null to record them without a codec
+        */
+        void set_stream_codec(rs2_stream stream, std::shared_ptr<frame_codec> codec)
+        {
+            rs2_error* e = nullptr;
+            rs2_record_device_set_stream_codec(_dev.get(), stream, codec ? new frame_codec_adapter(std::move(codec)) : nullptr, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Makes a flight recording, holding the frames of the last pre-roll in memory until trigger writes them with those of the
+        * post-roll that follows
+        * \param[in]  pre_roll    Time of the frames held before a trigger, zero to write the frames as they come
+        * \param[in]  post_roll   Time of the frames written after a trigger
+        * \param[in]  max_bytes   Bound of the bytes of the frames held, 0 for the pre-roll alone to bound them
+        */
+        void set_pre_roll(std::chrono::nanoseconds pre_roll, std::chrono::nanoseconds post_roll, unsigned long long max_bytes = 0)
+        {
+            rs2_error* e = nullptr;
+            rs2_record_device_set_pre_roll(_dev.get(), pre_roll.count(), post_roll.count(), max_bytes, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Writes the frames of the pre-roll of a flight recording, and those of its post-roll as they come
+        */
+        void trigger()
+        {
+            rs2_error* e = nullptr;
+            rs2_record_device_trigger(_dev.get(), &e);
+            error::handle(e);
+        }
+
+        /**
+        * Sets the processing block whose output frames are recorded in place of the frames of a stream, under their own profiles
+        * \param[in]  stream      The stream type
+        * \param[in]  block       The processing block of the frames of the stream, delivering them to the recorder alone
+        */
+        void set_stream_processing(rs2_stream stream, const process_interface& block)
+        {
+            rs2_error* e = nullptr;
+            rs2_record_device_set_stream_processing(_dev.get(), stream, block.get(), &e);
+            error::handle(e);
+        }
+
+        /**
+        * Records the frames of a stream as they stream, with no processing block
+        * \param[in]  stream      The stream type
+        */
+        void reset_stream_processing(rs2_stream stream)
+        {
+            rs2_error* e = nullptr;
+            rs2_record_device_set_stream_processing(_dev.get(), stream, nullptr, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Sets the callback of a segmented recorder, called with the file of each segment once it is closed
+        * \param[in]  callback    Callable taking the name of the file of the closed segment
+        */
+        template <typename T>
+        void set_segment_closed_callback(T callback)
+        {
+            rs2_error* e = nullptr;
+            rs2_record_device_set_segment_closed_callback(_dev.get(), new segment_closed_callback<T>(std::move(callback)), &e);
+            error::handle(e);
+        }
+
+        /**
+        * Bounds the disk space the closed segments of a segmented recorder take, deleting the oldest ones first
+        * \param[in]  max_bytes   Bytes the closed segments take at most, 0 to keep all
+        */
+        void set_disk_budget(unsigned long long max_bytes)
+        {
+            rs2_error* e = nullptr;
+            rs2_record_device_set_disk_budget(_dev.get(), max_bytes, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Gets the counters of the write queue of the recorder
+        */
+        rs2_record_queue_stats get_queue_stats() const
+        {
+            rs2_error* e = nullptr;
+            rs2_record_queue_stats stats{};
+            rs2_record_device_get_queue_stats(_dev.get(), &stats, &e);
+            error::handle(e);
+            return stats;
+        }
     protected:
         explicit recorder(std::shared_ptr<rs2_device> dev) : device(dev)
         {
@@ -194,6 +194,44 @@ namespace rs2
             error::handle(e);
         }
 
+        /**
+        * write new values to many options at once, see rs2_set_options
+        * \param[in] values    the options and their new values
+        * \return              per option, whether it was written
+        */
+        std::vector<bool> set_options(const std::vector<std::pair<rs2_option, float>>& values) const
+        {
+            std::vector<rs2_option> ids;
+            std::vector<float> vals;
+            for (auto&& v : values)
+            {
+                ids.push_back(v.first);
+                vals.push_back(v.second);
+            }
+            std::vector<int> statuses(values.size());
+            rs2_error* e = nullptr;
+            rs2_set_options(_options, ids.data(), vals.data(), static_cast<int>(ids.size()), statuses.data(), &e);
+            error::handle(e);
+            return{ statuses.begin(), statuses.end() };
+        }
+
+        /**
+        * read the values of many options at once, see rs2_get_options
+        * \param[in] ids       the options to be queried
+        * \param[out] statuses if non-null, receives per option whether it was read
+        * \return              the values of the options, 0 for those that failed
+        */
+        std::vector<float> get_options(const std::vector<rs2_option>& ids, std::vector<bool>* statuses = nullptr) const
+        {
+            std::vector<float> values(ids.size());
+            std::vector<int> res(ids.size());
+            rs2_error* e = nullptr;
+            rs2_get_options(_options, ids.data(), values.data(), static_cast<int>(ids.size()), res.data(), &e);
+            error::handle(e);
+            if (statuses) statuses->assign(res.begin(), res.end());
+            return values;
+        }
+
         /**
         * check if particular option is read-only
         * \param[in] option     option id to be checked
@@ -373,6 +411,75 @@ namespace rs2
             return results;
         }
 
+        /**
+        * retrieve a snapshot of the frame memory held by the sensor and of its dropped frames
+        * \return   memory and drop counters accumulated since the sensor was last opened
+        */
+        rs2_frame_memory_stats get_frame_memory_stats() const
+        {
+            rs2_frame_memory_stats stats{};
+            rs2_error* e = nullptr;
+            rs2_get_frame_memory_stats(_sensor.get(), &stats, &e);
+            error::handle(e);
+            return stats;
+        }
+
+        /**
+        * set the priority of the frames of a stream, the frames below the highest priority being dropped first under load
+        * \param[in] stream    the stream type
+        * \param[in] index     the stream index, -1 for every stream of the type
+        * \param[in] priority  higher values are kept longer, 0 by default
+        */
+        void set_stream_priority(rs2_stream stream, int index, int priority) const
+        {
+            rs2_error* e = nullptr;
+            rs2_set_stream_priority(_sensor.get(), stream, index, priority, &e);
+            error::handle(e);
+        }
+
+        /**
+        * retrieve the priority of the frames of a stream
+        * \return   the priority set for the stream, or for every stream of the type, 0 otherwise
+        */
+        int get_stream_priority(rs2_stream stream, int index) const
+        {
+            rs2_error* e = nullptr;
+            auto priority = rs2_get_stream_priority(_sensor.get(), stream, index, &e);
+            error::handle(e);
+            return priority;
+        }
+
+        /**
+        * list a profile of a region of the frames of a video profile of the sensor, streaming it only converts that region
+        * \param[in] base    a video profile of the sensor, which must not be opened
+        * \param[in] x, y    origin of the region, x being a multiple of 16
+        * \param[in] width   width of the region, a multiple of 16 unless the region ends with the frames
+        * \param[in] height  height of the region
+        * \return            the cropped profile, also listed by get_stream_profiles from now on
+        */
+        stream_profile add_cropped_profile(const stream_profile& base, int x, int y, int width, int height) const
+        {
+            rs2_error* e = nullptr;
+            auto ref = rs2_sensor_add_cropped_profile(_sensor.get(), base.get(), x, y, width, height, &e);
+            error::handle(e);
+            stream_profile res(ref);
+            res._clone = std::shared_ptr<rs2_stream_profile>(ref, [](rs2_stream_profile* r) { rs2_delete_stream_profile(r); });
+            return res;
+        }
+
+        /**
+        * retrieve the counters of the frames of the sensor at every stage from the backend to its callback
+        * \return   counters accumulated since the sensor was last opened, and the frames currently in flight
+        */
+        rs2_sensor_health get_health() const
+        {
+            rs2_sensor_health health{};
+            rs2_error* e = nullptr;
+            rs2_get_sensor_health(_sensor.get(), &health, &e);
+            error::handle(e);
+            return health;
+        }
+
         sensor& operator=(const std::shared_ptr<rs2_sensor> other)
         {
             options::operator=(other);
@@ -475,6 +582,86 @@ namespace rs2
         operator bool() const { return _sensor.get() != nullptr; }
     };
 
+    class motion_history_sensor : public sensor
+    {
+    public:
+        motion_history_sensor(sensor s)
+            : sensor(s.get())
+        {
+            rs2_error* e = nullptr;
+            if (rs2_is_sensor_extendable_to(_sensor.get(), RS2_EXTENSION_MOTION_HISTORY, &e) == 0 && !e)
+            {
+                _sensor.reset();
+            }
+            error::handle(e);
+        }
+
+        /** Retrieves the samples of a motion stream captured within a time range, from the latest ones the sensor keeps
+        * \param[in] stream      RS2_STREAM_GYRO or RS2_STREAM_ACCEL
+        * \param[in] index       the index of the stream
+        * \param[in] begin       the earliest timestamp of the samples, in the timestamp domain of the frames of the stream
+        * \param[in] end         the latest timestamp of the samples, inclusive
+        * \param[out] timestamps receives the timestamps of the samples, oldest first. May be null
+        * \param[out] motion     receives the X, Y, Z values of the samples. May be null
+        * \param[in] capacity    the number of samples the arrays hold
+        * \return the number of samples written
+        */
+        int get_motion_history(rs2_stream stream, int index, double begin, double end, double* timestamps, rs2_vector* motion, int capacity) const
+        {
+            rs2_error* e = nullptr;
+            auto res = rs2_get_motion_history(_sensor.get(), stream, index, begin, end, timestamps, motion, capacity, &e);
+            error::handle(e);
+            return res;
+        }
+
+        operator bool() const { return _sensor.get() != nullptr; }
+    };
+
+    class pose_prediction_sensor : public sensor
+    {
+    public:
+        pose_prediction_sensor(sensor s)
+            : sensor(s.get())
+        {
+            rs2_error* e = nullptr;
+            if (rs2_is_sensor_extendable_to(_sensor.get(), RS2_EXTENSION_POSE_PREDICTION, &e) == 0 && !e)
+            {
+                _sensor.reset();
+            }
+            error::handle(e);
+        }
+
+        /** Retrieves the latest pose of a pose stream as soon as the sensor receives it, without waiting on the pose frames
+        * \param[out] pose       receives the latest pose
+        * \param[out] timestamp  receives the timestamp of the pose, in the timestamp domain of the pose frames
+        * \param[in] index       the index of the pose stream
+        * \return false while the stream sent no pose
+        */
+        bool get_latest_pose(rs2_pose& pose, double& timestamp, int index = 1) const
+        {
+            rs2_error* e = nullptr;
+            auto res = rs2_get_latest_pose(_sensor.get(), index, &pose, &timestamp, &e);
+            error::handle(e);
+            return res != 0;
+        }
+
+        /** Predicts the pose of a pose stream at a timestamp, from the velocity and acceleration of its latest pose
+        * \param[in] timestamp   in milliseconds, in the timestamp domain of the pose frames
+        * \param[out] pose       receives the predicted pose
+        * \param[in] index       the index of the pose stream
+        * \return false while the stream sent no pose
+        */
+        bool predict_pose(double timestamp, rs2_pose& pose, int index = 1) const
+        {
+            rs2_error* e = nullptr;
+            auto res = rs2_predict_pose(_sensor.get(), index, timestamp, &pose, &e);
+            error::handle(e);
+            return res != 0;
+        }
+
+        operator bool() const { return _sensor.get() != nullptr; }
+    };
+
     class depth_sensor : public sensor
     {
     public:
@@ -64,6 +64,25 @@ struct rs2_playback_status_changed_callback
     virtual                                 ~rs2_playback_status_changed_callback() {}
 };
 
+struct rs2_segment_closed_callback
+{
+    virtual void                            on_segment_closed(const char* file) = 0;
+    virtual void                            release() = 0;
+    virtual                                 ~rs2_segment_closed_callback() {}
+};
+
+// Codec of the video frames of a stream in recorded files, every frame coded on its own.
+// encode releases the frame it is given, and returns the bytes written to encoded, 0 for the frame to be recorded as it is.
+// decode fills the pixels of a frame of the given layout, returning 0 on failure. Both may be called from several threads at once
+struct rs2_frame_codec
+{
+    virtual const char*                     get_name() = 0;
+    virtual int                             encode(rs2_frame* frame, unsigned char* encoded, int capacity) = 0;
+    virtual int                             decode(const unsigned char* encoded, int size, int width, int height, int stride, rs2_format format, unsigned char* pixels) = 0;
+    virtual void                            release() = 0;
+    virtual                                 ~rs2_frame_codec() {}
+};
+
 namespace rs2
 {
     class error : public std::runtime_error
@@ -87,6 +87,32 @@ void rs2_log(rs2_log_severity severity, const char * message, rs2_error ** error
 */
 float rs2_depth_frame_get_distance(const rs2_frame* frame_ref, int x, int y, rs2_error** error);
 
+/**
+* The depth, or the point in 3D space, of many pixels of a depth frame at once, of the same results as calls of
+* rs2_depth_frame_get_distance and rs2_deproject_pixel_to_point on every pixel. A pixel samples the depth of its nearest
+* one, and those out of the frame or without depth get zero. Of a window over one pixel, the depth is the lower median of the
+* pixels of depth within window x window of the nearest one, and zero when there is none
+* \param[in] frame_ref  depth frame
+* \param[in] pixels     coordinates of count pixels, interleaved as x, y (Left-Upper corner origin)
+* \param[in] count      number of pixels
+* \param[out] output    receives count depths of RS2_DEPTH_SAMPLE_DISTANCE, or count points, interleaved as x, y, z, of RS2_DEPTH_SAMPLE_POINT
+* \param[in] mode       what is computed of every pixel
+* \param[in] window     odd size of the window the depth is the median of, from 1 for the pixel itself up to 15
+* \param[out] error     if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_depth_frame_sample(const rs2_frame* frame_ref, const float* pixels, int count, float* output, rs2_depth_sample_mode mode, int window, rs2_error** error);
+
+/**
+* The validity mask of a depth frame, of a bit per pixel set for the pixels with depth, for the pixels without any to be
+* skipped 64 at a time. Bit i % 64 of word i / 64 is of pixel i = y * width + x, and the bits past the last pixel are clear.
+* The mask is computed the first time it is retrieved, and shared by every reader of the frame for as long as it is held
+* \param[in] frame_ref  depth frame
+* \param[out] words     if non-null, receives the number of 64-bit words of the mask
+* \param[out] error     if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return               the words of the mask, valid for as long as the frame is
+*/
+const unsigned long long* rs2_depth_frame_get_validity_mask(const rs2_frame* frame_ref, int* words, rs2_error** error);
+
 /**
 * return the time at specific time point
 * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
@@ -94,6 +120,52 @@ float rs2_depth_frame_get_distance(const rs2_frame* frame_ref, int x, int y, rs2
 */
 rs2_time_t rs2_get_time( rs2_error** error);
 
+/**
+* Deprojects pixels and their depth into points in 3D space relative to the same camera, of the same results as calls of
+* rs2_deproject_pixel_to_point of rsutil.h on every pixel, with a loop specialised to the distortion model of the intrinsics
+* \param[in] intrin  intrinsics of the image of the pixels
+* \param[in] pixels  coordinates of count pixels, interleaved as x, y
+* \param[in] depth   depth of each pixel, in meters
+* \param[out] points receives count points, interleaved as x, y, z
+* \param[in] count   number of pixels
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_deproject_pixels(const rs2_intrinsics* intrin, const float* pixels, const float* depth, float* points, int count, rs2_error** error);
+
+/**
+* The same, of the coordinates of the pixels and the points in separate arrays. An output array may be one of the inputs
+* \param[in] intrin  intrinsics of the image of the pixels
+* \param[in] pixel_x,pixel_y  coordinates of count pixels
+* \param[in] depth   depth of each pixel, in meters
+* \param[out] point_x,point_y,point_z  receive the coordinates of count points
+* \param[in] count   number of pixels
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_deproject_pixels_soa(const rs2_intrinsics* intrin, const float* pixel_x, const float* pixel_y, const float* depth,
+    float* point_x, float* point_y, float* point_z, int count, rs2_error** error);
+
+/**
+* Projects points in 3D space onto the pixels of an image of the same camera, of the same results as calls of
+* rs2_project_point_to_pixel of rsutil.h on every point, with a loop specialised to the distortion model of the intrinsics
+* \param[in] intrin  intrinsics of the image
+* \param[in] points  count points, interleaved as x, y, z
+* \param[out] pixels receives the coordinates of count pixels, interleaved as x, y
+* \param[in] count   number of points
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_project_points(const rs2_intrinsics* intrin, const float* points, float* pixels, int count, rs2_error** error);
+
+/**
+* The same, of the coordinates of the points and the pixels in separate arrays. An output array may be one of the inputs
+* \param[in] intrin  intrinsics of the image
+* \param[in] point_x,point_y,point_z  coordinates of count points
+* \param[out] pixel_x,pixel_y  receive the coordinates of count pixels
+* \param[in] count   number of points
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_project_points_soa(const rs2_intrinsics* intrin, const float* point_x, const float* point_y, const float* point_z,
+    float* pixel_x, float* pixel_y, int count, rs2_error** error);
+
 #ifdef __cplusplus
 }
 #endif
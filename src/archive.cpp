@@ -2,11 +2,103 @@
 #include "archive.h"
 #include <fstream>
 #include "core/processing.h"
+#include "core/video.h"
+#include "trace.h"
+#include "image.h"
+#include "projection.h"
+#include <stdlib.h>
+#include <cmath>
+#ifdef __SSSE3__
+#include <tmmintrin.h> // For SSSE3 intrinsics
+#endif
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+#ifdef RS2_USE_CUDA
+#include "cuda/cuda-frame-archive.cuh"
+#endif
 
 #define MIN_DISTANCE 1e-6
 
 namespace librealsense
 {
+    namespace
+    {
+        // Of every pixel, the value of its nearest one, or the lower median of the nonzero values in the window around it
+        template<class T>
+        void sample_pixels(const uint8_t* data, int width, int height, int stride, float scale,
+            const float2* pixels, size_t count, int window, float* distances)
+        {
+            const int radius = window / 2;
+            std::vector<T> values(window * window);
+            for (size_t i = 0; i < count; ++i)
+            {
+                // Checked while still floats, as casting NaN or values out of the range of int is undefined. NaN fails every comparison
+                auto fx = std::floor(pixels[i].x + 0.5f);
+                auto fy = std::floor(pixels[i].y + 0.5f);
+                if (!(fx >= 0 && fy >= 0 && fx < width && fy < height))
+                {
+                    distances[i] = 0;
+                    continue;
+                }
+                auto x = static_cast<int>(fx);
+                auto y = static_cast<int>(fy);
+                if (!radius)
+                {
+                    distances[i] = reinterpret_cast<const T*>(data + y * stride)[x] * scale;
+                    continue;
+                }
+
+                size_t n = 0;
+                for (auto v = std::max(y - radius, 0); v <= std::min(y + radius, height - 1); ++v)
+                {
+                    auto row = reinterpret_cast<const T*>(data + v * stride);
+                    for (auto u = std::max(x - radius, 0); u <= std::min(x + radius, width - 1); ++u)
+                        if (row[u]) values[n++] = row[u];
+                }
+                if (!n)
+                {
+                    distances[i] = 0;
+                    continue;
+                }
+                auto median = values.begin() + (n - 1) / 2;
+                std::nth_element(values.begin(), median, values.begin() + n);
+                distances[i] = *median * scale;
+            }
+        }
+
+        // The bits of the pixels of a row, from bit first of the mask on, set for the nonzero values
+        template<class T>
+        void mask_row(const T* row, int width, size_t first, uint64_t* mask)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                auto i = first + x;
+                mask[i / 64] |= uint64_t(row[x] != 0) << (i % 64);
+            }
+        }
+
+        void mask_row(const uint16_t* row, int width, size_t first, uint64_t* mask)
+        {
+            int x = 0;
+#ifdef __SSSE3__
+            // Of 16 pixels at a time, the bits of which straddle two words unless they start in the first 48 bits of one
+            const __m128i zero = _mm_setzero_si128();
+            for (; x + 16 <= width; x += 16)
+            {
+                auto a = _mm_cmpeq_epi16(_mm_loadu_si128((const __m128i*)(row + x)), zero);
+                auto b = _mm_cmpeq_epi16(_mm_loadu_si128((const __m128i*)(row + x + 8)), zero);
+                auto bits = uint64_t(~_mm_movemask_epi8(_mm_packs_epi16(a, b)) & 0xffff);
+                auto i = first + x;
+                mask[i / 64] |= bits << (i % 64);
+                if (i % 64 > 48)
+                    mask[i / 64 + 1] |= bits >> (64 - i % 64);
+            }
+#endif
+            mask_row<uint16_t>(row + x, width - x, first + x, mask);
+        }
+    }
+
     std::shared_ptr<sensor_interface> frame::get_sensor() const
     {
         auto res = sensor.lock();
@@ -21,108 +113,369 @@ namespace librealsense
 
     float3* points::get_vertices()
     {
+        if (_planar)
+            throw wrong_api_call_sequence_exception("The vertices of planar points are read a plane at a time");
         auto xyz = (float3*)data.data();
         return xyz;
     }
 
-    std::tuple<uint8_t, uint8_t, uint8_t> get_texcolor(const frame_holder& texture, float u, float v)
+    float* points::get_vertex_plane(int axis)
     {
-        auto ptr = dynamic_cast<video_frame*>(texture.frame);
-        if (ptr == nullptr) {
-            throw librealsense::invalid_value_exception("frame must be video frame");
-        }
-        const int w = ptr->get_width(), h = ptr->get_height();
-        int x = std::min(std::max(int(u*w + .5f), 0), w - 1);
-        int y = std::min(std::max(int(v*h + .5f), 0), h - 1);
-        int idx = x * ptr->get_bpp() / 8 + y * ptr->get_stride();
-        const auto texture_data = reinterpret_cast<const uint8_t*>(ptr->get_frame_data());
-        return std::make_tuple(texture_data[idx], texture_data[idx + 1], texture_data[idx + 2]);
+        if (!_planar)
+            return nullptr;
+        if (axis < 0 || axis > 2)
+            throw invalid_value_exception(to_string() << "Vertex plane " << axis << " is out of range");
+        return reinterpret_cast<float*>(data.data()) + axis * get_vertex_count();
     }
 
-    void points::export_to_ply(const std::string& fname, const frame_holder& texture)
+    namespace
     {
-        const auto vertices = get_vertices();
-        const auto texcoords = get_texture_coordinates();
-        std::vector<float3> new_vertices;
-        std::vector<std::tuple<uint8_t, uint8_t, uint8_t>> new_tex;
-        new_vertices.reserve(get_vertex_count());
-        new_tex.reserve(get_vertex_count());
-        assert(get_vertex_count());
-        for (size_t i = 0; i < get_vertex_count(); ++i)
-            if (fabs(vertices[i].x) >= MIN_DISTANCE || fabs(vertices[i].y) >= MIN_DISTANCE ||
-                fabs(vertices[i].z) >= MIN_DISTANCE)
-            {
-                new_vertices.push_back(vertices[i]);
-                if (texture)
+        const float min_distance = static_cast<float>(MIN_DISTANCE);
+        // Neighbours on the depth image further apart in depth, in meters, are on either side of an edge of the scene
+        const float max_depth_step = 0.05f;
+
+        // The vertices of the depth pixels without depth are at the origin
+        bool is_valid_vertex(const float3& v)
+        {
+            return std::fabs(v.x) >= min_distance || std::fabs(v.y) >= min_distance || std::fabs(v.z) >= min_distance;
+        }
+
+        std::vector<int> find_valid_vertices(const float3* vertices, int count)
+        {
+            std::vector<int> valid;
+            valid.reserve(count);
+            int i = 0;
+#ifdef __SSSE3__
+            if (get_simd_level() != simd_level::generic)
+            {
+                const auto sign = _mm_set1_ps(-0.f);
+                const auto min = _mm_set1_ps(min_distance);
+                auto coordinates = reinterpret_cast<const float*>(vertices);
+                for (; i + 4 <= count; i += 4)
                 {
-                    auto color = get_texcolor(texture, texcoords[i].x, texcoords[i].y);
-                    new_tex.push_back(color);
+                    // The 12 coordinates of 4 vertices, bits 3k to 3k + 2 of the mask for vertex k
+                    int mask = 0;
+                    for (int j = 0; j < 3; ++j)
+                    {
+                        auto c = _mm_andnot_ps(sign, _mm_loadu_ps(coordinates + 3 * i + 4 * j));
+                        mask |= _mm_movemask_ps(_mm_cmpge_ps(c, min)) << (4 * j);
+                    }
+                    if (!mask) continue;
+                    for (int k = 0; k < 4; ++k)
+                        if (mask & (7 << (3 * k))) valid.push_back(i + k);
                 }
             }
+#endif
+            for (; i < count; ++i)
+                if (is_valid_vertex(vertices[i])) valid.push_back(i);
+            return valid;
+        }
+
+        // Samples a texture of 3 or 4 bytes per pixel, the RGB or BGR of which are exported as they are
+        class texture_sampler
+        {
+        public:
+            explicit texture_sampler(const frame_holder& texture)
+            {
+                auto ptr = dynamic_cast<video_frame*>(texture.frame);
+                if (ptr == nullptr)
+                    throw invalid_value_exception("frame must be video frame");
+                if (ptr->get_bpp() != 24 && ptr->get_bpp() != 32)
+                    throw invalid_value_exception(to_string() << "Texture of " << ptr->get_bpp() << " bits per pixel, rather than of 24 or 32, cannot color PLY vertices");
+                _width = ptr->get_width();
+                _height = ptr->get_height();
+                _bytes_per_pixel = ptr->get_bpp() / 8;
+                _stride = ptr->get_stride();
+                _data = ptr->get_frame_data();
+            }
+
+            const uint8_t* operator()(const float2& uv) const
+            {
+                int x = std::min(std::max(int(uv.x * _width + .5f), 0), _width - 1);
+                int y = std::min(std::max(int(uv.y * _height + .5f), 0), _height - 1);
+                return _data + x * _bytes_per_pixel + y * _stride;
+            }
 
-        std::ofstream out(fname);
-        out << "ply\n";
-        out << "format binary_little_endian 1.0\n" /*"format ascii 1.0\n"*/;
-        out << "comment pointcloud saved from Realsense Viewer\n";
-        out << "element vertex " << new_vertices.size() << "\n";
-        out << "property float" << sizeof(float) * 8 << " x\n";
-        out << "property float" << sizeof(float) * 8 << " y\n";
-        out << "property float" << sizeof(float) * 8 << " z\n";
-        if (texture)
+        private:
+            int _width, _height, _bytes_per_pixel, _stride;
+            const uint8_t* _data;
+        };
+
+        float3 operator - (const float3& a, const float3& b) { return{ a.x - b.x, a.y - b.y, a.z - b.z }; }
+
+        float3 cross(const float3& a, const float3& b)
         {
-            out << "property uchar red\n";
-            out << "property uchar green\n";
-            out << "property uchar blue\n";
+            return{ a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
         }
-        out << "end_header\n";
-        out.close();
 
-        out.open(fname, std::ios_base::app | std::ios_base::binary);
-        for (int i = 0; i < new_vertices.size(); ++i)
+        // The valid vertices of the depth image, by their pixels, where normals and faces find their neighbours
+        class vertex_grid
+        {
+        public:
+            vertex_grid(const float3* vertices, const std::vector<int>& valid, const int* pixel_indices, int width, int height)
+                : _vertices(vertices), _width(width), _height(height), _grid(width * height, -1)
+            {
+                for (auto i : valid)
+                {
+                    auto pixel = pixel_indices ? pixel_indices[i] : i;
+                    if (pixel >= 0 && pixel < width * height) _grid[pixel] = i;
+                }
+            }
+
+            int width() const { return _width; }
+            int height() const { return _height; }
+
+            // Index of the vertex of the pixel, or -1 outside the image or without depth
+            int at(int x, int y) const
+            {
+                return x < 0 || y < 0 || x >= _width || y >= _height ? -1 : _grid[y * _width + x];
+            }
+
+            bool connected(int a, int b) const
+            {
+                return a >= 0 && b >= 0 && std::fabs(_vertices[a].z - _vertices[b].z) <= max_depth_step;
+            }
+
+            // Of the neighbours on either side not across an edge, facing the camera. Zero when the vertex has none
+            float3 normal(int pixel) const
+            {
+                auto x = pixel % _width, y = pixel / _width;
+                auto center = at(x, y);
+                auto neighbour = [&](int dx, int dy) {
+                    auto n = at(x + dx, y + dy);
+                    return _vertices[connected(center, n) ? n : center];
+                };
+                auto n = cross(neighbour(0, 1) - neighbour(0, -1), neighbour(1, 0) - neighbour(-1, 0));
+                auto length = std::sqrt(n.x * n.x + n.y * n.y + n.z * n.z);
+                return length > 0 ? n * (1 / length) : float3{ 0, 0, 0 };
+            }
+
+        private:
+            const float3* _vertices;
+            int _width, _height;
+            std::vector<int> _grid;
+        };
+    }
+
+    void points::export_to_ply(const std::string& fname, const frame_holder& texture, bool normals, bool faces)
+    {
+        if (get_vertex_size(_format) != sizeof(float3))
+            throw invalid_value_exception(to_string() << "Exporting " << get_string(_format) << " points to PLY is not supported");
+
+        const auto vertices = get_vertices();
+        const auto texcoords = get_texture_coordinates();
+        const auto count = static_cast<int>(get_vertex_count());
+        assert(count);
+        const auto valid = find_valid_vertices(vertices, count);
+        std::unique_ptr<texture_sampler> sampler(texture ? new texture_sampler(texture) : nullptr);
+        // Without a texture, the points that carry their colors are exported with them
+        const auto colors = sampler ? nullptr : get_colors();
+
+        // Normals and faces need the neighbours of the vertices, of the whole depth image or of their pixel indices
+        std::unique_ptr<vertex_grid> grid;
+        std::vector<int> triangles;
+        if (normals || faces)
+        {
+            auto profile = As<video_stream_profile_interface>(get_stream());
+            auto indices = get_pixel_indices();
+            if (!profile || (!indices && count != int(profile->get_width() * profile->get_height())))
+                throw invalid_value_exception("Normals and faces are exported for the points of the whole depth image, or of their pixel indices");
+            grid.reset(new vertex_grid(vertices, valid, indices, profile->get_width(), profile->get_height()));
+        }
+        if (faces)
         {
-            // we assume little endian architecture on your device
-            out.write(reinterpret_cast<const char*>(&(new_vertices[i].x)), sizeof(float));
-            out.write(reinterpret_cast<const char*>(&(new_vertices[i].y)), sizeof(float));
-            out.write(reinterpret_cast<const char*>(&(new_vertices[i].z)), sizeof(float));
+            // Vertices are renumbered as the invalid ones are left out
+            std::vector<int> exported(count, -1);
+            for (size_t i = 0; i < valid.size(); ++i)
+                exported[valid[i]] = static_cast<int>(i);
+
+            // Two triangles a pixel, counterclockwise seen from the camera, of the neighbours not across an edge
+            for (int y = 0; y + 1 < grid->height(); ++y)
+                for (int x = 0; x + 1 < grid->width(); ++x)
+                {
+                    auto a = grid->at(x, y), b = grid->at(x + 1, y), c = grid->at(x, y + 1), d = grid->at(x + 1, y + 1);
+                    if (grid->connected(a, b) && grid->connected(a, c) && grid->connected(b, c))
+                        triangles.insert(triangles.end(), { exported[a], exported[c], exported[b] });
+                    if (grid->connected(b, c) && grid->connected(b, d) && grid->connected(c, d))
+                        triangles.insert(triangles.end(), { exported[b], exported[c], exported[d] });
+                }
+        }
 
-            if (texture)
+        std::stringstream header;
+        header << "ply\n";
+        header << "format binary_little_endian 1.0\n";
+        header << "comment pointcloud saved from Realsense Viewer\n";
+        header << "element vertex " << valid.size() << "\n";
+        header << "property float32 x\n";
+        header << "property float32 y\n";
+        header << "property float32 z\n";
+        if (normals)
+        {
+            header << "property float32 nx\n";
+            header << "property float32 ny\n";
+            header << "property float32 nz\n";
+        }
+        if (sampler || colors)
+        {
+            header << "property uchar red\n";
+            header << "property uchar green\n";
+            header << "property uchar blue\n";
+        }
+        if (faces)
+        {
+            header << "element face " << triangles.size() / 3 << "\n";
+            header << "property list uchar int vertex_indices\n";
+        }
+        header << "end_header\n";
+        const auto header_text = header.str();
+
+        // The file is assembled in memory, to be written at once. We assume little endian architecture on your device
+        const size_t vertex_size = sizeof(float3) * (normals ? 2 : 1) + (sampler || colors ? 3 : 0);
+        const size_t face_size = sizeof(uint8_t) + 3 * sizeof(int32_t);
+        std::vector<uint8_t> buffer(header_text.size() + valid.size() * vertex_size + triangles.size() / 3 * face_size);
+        auto out_ptr = buffer.data();
+        memcpy(out_ptr, header_text.data(), header_text.size());
+        out_ptr += header_text.size();
+        for (auto i : valid)
+        {
+            memcpy(out_ptr, &vertices[i], sizeof(float3));
+            out_ptr += sizeof(float3);
+            if (normals)
+            {
+                auto pixel = get_pixel_indices() ? get_pixel_indices()[i] : i;
+                auto n = grid->normal(pixel);
+                memcpy(out_ptr, &n, sizeof(float3));
+                out_ptr += sizeof(float3);
+            }
+            if (sampler)
             {
-                uint8_t x, y, z;
-                std::tie(x, y, z) = new_tex[i];
-                out.write(reinterpret_cast<const char*>(&x), sizeof(uint8_t));
-                out.write(reinterpret_cast<const char*>(&y), sizeof(uint8_t));
-                out.write(reinterpret_cast<const char*>(&z), sizeof(uint8_t));
+                auto texel = (*sampler)(texcoords[i]);
+                *out_ptr++ = texel[0];
+                *out_ptr++ = texel[1];
+                *out_ptr++ = texel[2];
             }
+            else if (colors)
+            {
+                memcpy(out_ptr, colors + i * 3, 3);
+                out_ptr += 3;
+            }
+        }
+        for (size_t i = 0; i < triangles.size(); i += 3)
+        {
+            *out_ptr++ = 3;
+            memcpy(out_ptr, &triangles[i], 3 * sizeof(int32_t));
+            out_ptr += 3 * sizeof(int32_t);
         }
+
+        std::ofstream out(fname, std::ios_base::binary | std::ios_base::trunc);
+        out.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+        if (!out)
+            throw io_exception(to_string() << "Could not write " << fname);
+    }
+
+    size_t points::get_vertex_size(rs2_format format)
+    {
+        return format == RS2_FORMAT_XYZ16 || format == RS2_FORMAT_XYZ16F ? 3 * sizeof(uint16_t) : sizeof(float3);
+    }
+
+    size_t points::get_texture_coordinate_size(rs2_format format)
+    {
+        return format == RS2_FORMAT_XYZ16 || format == RS2_FORMAT_XYZ16F ? 2 * sizeof(uint16_t) : sizeof(float2);
+    }
+
+    size_t points::get_point_size(rs2_format format, bool pixel_indices, bool normals, bool colors, bool texture_coordinates)
+    {
+        return get_vertex_size(format) + (texture_coordinates ? get_texture_coordinate_size(format) : 0) + (normals ? sizeof(float3) : 0) +
+            (pixel_indices ? sizeof(int) : 0) + (colors ? 3 : 0);
     }
 
     size_t points::get_vertex_count() const
     {
-        return data.size() / (sizeof(float3) + sizeof(int2));
+        return data.size() / get_point_size(_format, _pixel_indices, _normals, _colors, _texture_coordinates);
     }
 
     float2* points::get_texture_coordinates()
     {
-        auto xyz = (float3*)data.data();
-        auto ijs = (float2*)(xyz + get_vertex_count());
+        if (!_texture_coordinates)
+        {
+            std::lock_guard<std::mutex> lock(_texture_mutex);
+            _unmapped_texture_coordinates.resize(get_vertex_count(), float2{ 0.f, 0.f });
+            return _unmapped_texture_coordinates.data();
+        }
+
+        if (_texture_pending) map_deferred_texture();
+        auto ijs = (float2*)(data.data() + get_vertex_count() * get_vertex_size(_format));
         return ijs;
     }
 
+    void points::map_deferred_texture() const
+    {
+        std::lock_guard<std::mutex> lock(_texture_mutex);
+        if (!_texture_pending) return;
+
+        auto self = const_cast<points*>(this);
+        auto count = get_vertex_count();
+        _deferred_texture((const float3*)data.data(), (float2*)(self->data.data() + count * get_vertex_size(_format)), count);
+        self->_deferred_texture = nullptr;
+        _texture_pending = false;
+    }
+
+    const byte* points::get_frame_data() const
+    {
+        if (_texture_pending) map_deferred_texture();
+        return frame::get_frame_data();
+    }
+
+    float3* points::get_normals()
+    {
+        if (!_normals)
+            return nullptr;
+        return (float3*)(data.data() + get_vertex_count() * (get_vertex_size(_format) + get_texture_size()));
+    }
+
+    int* points::get_pixel_indices()
+    {
+        if (!_pixel_indices)
+            return nullptr;
+        return (int*)(data.data() + get_vertex_count() * (get_vertex_size(_format) + get_texture_size() + (_normals ? sizeof(float3) : 0)));
+    }
+
+    uint8_t* points::get_colors()
+    {
+        if (!_colors)
+            return nullptr;
+        return data.data() + get_vertex_count() * get_point_size(_format, _pixel_indices, _normals, false, _texture_coordinates);
+    }
+
     // Defines general frames storage model
     template<class T>
     class frame_archive : public std::enable_shared_from_this<frame_archive<T>>, public archive_interface
     {
         std::atomic<uint32_t>* max_frame_queue_size;
+        std::atomic<uint32_t>* max_frame_memory; // in megabytes, zero stands for unlimited
+        const std::atomic<int>* highest_priority; // of the frames of the source, those below it only get half the budgets
         std::atomic<uint32_t> published_frames_count;
+        std::atomic<size_t> published_bytes;
+        size_t peak_bytes = 0;
+        std::atomic<uint64_t> allocation_failures;
+        std::atomic<uint64_t> queue_drops;
         small_heap<T, RS2_USER_QUEUE_SIZE> published_frames;
         std::shared_ptr<metadata_parser_map> _metadata_parsers = nullptr;
         callbacks_heap callback_inflight;
 
-        std::vector<T> freelist; // return frames here
+        // Recycled frames, grouped by buffer size. Every stream profile produces buffers of a single
+        // size, so each entry effectively serves one profile and is reused without reallocation
+        std::map<size_t, std::vector<T>> freelist; // return frames here
+        size_t freelist_bytes = 0;
+        size_t freelist_budget;
         std::atomic<bool> recycle_frames;
+        std::vector<std::unique_ptr<T>> spare_frames;   // Frame objects of the archives with no bound on the frames queue
         int pending_frames = 0;
-        std::recursive_mutex mutex;
+        mutable std::recursive_mutex mutex;
         std::shared_ptr<platform::time_service> _time_service;
+        std::shared_ptr<const frame_allocator> _allocator;
+        preallocation_mode preallocation;
+        std::atomic<uint64_t> streaming_allocations;
 
         std::weak_ptr<sensor_interface> _sensor;
         std::shared_ptr<sensor_interface> get_sensor() const override { return _sensor.lock(); }
@@ -131,40 +484,87 @@ namespace librealsense
         T alloc_frame(const size_t size, const frame_additional_data& additional_data, bool requires_memory)
         {
             T backbuffer;
-            //const size_t size = modes[stream].get_image_size(stream);
+            if (requires_memory)
             {
-                std::lock_guard<std::recursive_mutex> guard(mutex);
-
-                if (requires_memory)
                 {
+                    std::lock_guard<std::recursive_mutex> guard(mutex);
+
                     // Attempt to obtain a buffer of the appropriate size from the freelist
-                    for (auto it = begin(freelist); it != end(freelist); ++it)
+                    auto it = freelist.find(size);
+                    if (it != freelist.end() && !it->second.empty())
                     {
-                        if (it->data.size() == size)
-                        {
-                            backbuffer = std::move(*it);
-                            freelist.erase(it);
-                            break;
-                        }
+                        backbuffer = std::move(it->second.back());
+                        it->second.pop_back();
+                        freelist_bytes -= size;
                     }
                 }
 
-                // Discard buffers that have been in the freelist for longer than 1s
-                for (auto it = begin(freelist); it != end(freelist);)
-                {
-                    if (additional_data.timestamp > it->additional_data.timestamp + 1000) it = freelist.erase(it);
-                    else ++it;
-                }
-            }
+                if (backbuffer.data.empty() && !allow_allocation("frame storage"))
+                    throw std::bad_alloc();
 
-            if (requires_memory)
-            {
-                backbuffer.data.resize(size, 0); // TODO: Allow users to provide a custom allocator for frame buffers
+                if (backbuffer.data.empty() && _allocator)
+                    backbuffer.data = frame_data(frame_data_allocator<byte>(_allocator));
+                backbuffer.data.resize(size, 0);
             }
             backbuffer.additional_data = additional_data;
             return backbuffer;
         }
 
+        // Of an allocation the pools did not cover, counted once the sensor preallocates, and refused in the fatal mode
+        bool allow_allocation(const char* what)
+        {
+            if (preallocation == preallocation_mode::off)
+                return true;
+
+            ++streaming_allocations;
+            if (preallocation == preallocation_mode::counted)
+            {
+                LOG_DEBUG("Streaming allocation of " << what);
+                return true;
+            }
+            LOG_ERROR("Streaming allocation of " << what << " refused, the frame is dropped");
+            return false;
+        }
+
+        size_t get_memory_budget() const
+        {
+            return static_cast<size_t>(max_frame_memory ? max_frame_memory->load() : 0) * 1024 * 1024;
+        }
+
+        size_t get_freelist_budget() const
+        {
+            auto budget = get_memory_budget();
+            return budget ? std::min(budget, freelist_budget) : freelist_budget;
+        }
+
+        // A frame object released earlier, for the archives with no bound on the frames queue not to allocate one per frame
+        T* take_spare_frame()
+        {
+            std::lock_guard<std::recursive_mutex> guard(mutex);
+            if (spare_frames.empty())
+                return nullptr;
+            auto f = spare_frames.back().release();
+            spare_frames.pop_back();
+            return f;
+        }
+
+        // Return frame to the freelist, unless it would grow the pool beyond its budget
+        void recycle_frame(T&& f)
+        {
+            auto size = f.data.size();
+            if (!size || freelist_bytes + size > get_freelist_budget())
+                return;
+
+            freelist[size].push_back(std::move(f));
+            freelist_bytes += size;
+            update_peak();
+        }
+
+        void update_peak()
+        {
+            peak_bytes = std::max(peak_bytes, published_bytes + freelist_bytes);
+        }
+
         frame_interface* track_frame(T& f)
         {
             std::unique_lock<std::recursive_mutex> lock(mutex);
@@ -189,16 +589,24 @@ namespace librealsense
                 std::unique_lock<std::recursive_mutex> lock(mutex);
 
                 frame->keep();
+                published_bytes -= f->data.size();
 
                 if (recycle_frames)
                 {
-                    freelist.push_back(std::move(*f));
+                    recycle_frame(std::move(*f));
+                }
+                auto spare = !f->is_fixed() && recycle_frames && spare_frames.size() < RS2_USER_QUEUE_SIZE;
+                if (spare)
+                {
+                    // Let go of the owner and of the buffer of the frame, for it not to keep the archive alive
+                    *f = T();
+                    spare_frames.emplace_back(f);
                 }
                 lock.unlock();
 
                 if (f->is_fixed())
                     published_frames.deallocate(f);
-                else
+                else if (!spare)
                     delete f;
             }
         }
@@ -214,13 +622,27 @@ namespace librealsense
 
             unsigned int max_frames = *max_frame_queue_size;
 
-            if (published_frames_count >= max_frames
+            // The streams below the highest priority leave the second half of the budgets to the others
+            auto low_priority = highest_priority && f->additional_data.priority < highest_priority->load();
+            auto frames_limit = low_priority ? (max_frames + 1) / 2 : max_frames;
+            if (published_frames_count >= frames_limit
                 && max_frames)
             {
                 LOG_DEBUG("User didn't release frame resource.");
+                ++queue_drops;
+                return nullptr;
+            }
+
+            auto frame_size = f->data.size();
+            auto max_memory = get_memory_budget();
+            if (low_priority) max_memory = (max_memory + 1) / 2;
+            if (max_memory && frame_size && published_bytes + frame_size > max_memory)
+            {
+                LOG_DEBUG("Frames memory budget of " << max_memory << " bytes exceeded.");
+                ++allocation_failures;
                 return nullptr;
             }
-            auto new_frame = (max_frames ? published_frames.allocate() : new T());
+            auto new_frame = (max_frames ? published_frames.allocate() : take_spare_frame());
 
             if (new_frame)
             {
@@ -228,10 +650,17 @@ namespace librealsense
             }
             else
             {
+                if (!allow_allocation("a frame"))
+                {
+                    ++allocation_failures;
+                    return nullptr;
+                }
                 new_frame = new T();
             }
 
             ++published_frames_count;
+            published_bytes += frame_size;
+            update_peak();
             *new_frame = std::move(*f);
 
             return new_frame;
@@ -258,19 +687,34 @@ namespace librealsense
             }
         }
 
-        std::shared_ptr<metadata_parser_map> get_md_parsers() const { return _metadata_parsers; };
+        const std::shared_ptr<metadata_parser_map>& get_md_parsers() const override { return _metadata_parsers; };
 
         friend class frame;
 
     public:
         explicit frame_archive(std::atomic<uint32_t>* in_max_frame_queue_size,
+            std::atomic<uint32_t>* in_max_frame_memory,
+            const std::atomic<int>* in_highest_priority,
             std::shared_ptr<platform::time_service> ts,
-            std::shared_ptr<metadata_parser_map> parsers)
+            std::shared_ptr<metadata_parser_map> parsers,
+            std::shared_ptr<const frame_allocator> allocator,
+            preallocation_mode in_preallocation)
             : max_frame_queue_size(in_max_frame_queue_size),
+            max_frame_memory(in_max_frame_memory),
+            highest_priority(in_highest_priority),
+            published_frames(std::max(static_cast<int>(in_max_frame_queue_size->load()), 1)),
+            callback_inflight(RS2_MAX_CALLBACK_THREADS),
+            freelist_budget(RS2_FRAME_POOL_BUDGET),
             mutex(), recycle_frames(true), _time_service(ts),
+            _allocator(std::move(allocator)),
+            preallocation(in_preallocation),
             _metadata_parsers(parsers)
         {
+            streaming_allocations = 0;
             published_frames_count = 0;
+            published_bytes = 0;
+            allocation_failures = 0;
+            queue_drops = 0;
         }
 
         callback_invocation_holder begin_callback()
@@ -285,8 +729,63 @@ namespace librealsense
 
         frame_interface* alloc_and_track(const size_t size, const frame_additional_data& additional_data, bool requires_memory)
         {
-            auto frame = alloc_frame(size, additional_data, requires_memory);
-            return track_frame(frame);
+            try
+            {
+                auto frame = alloc_frame(size, additional_data, requires_memory);
+                auto published = track_frame(frame);
+
+                // The storage of a dropped frame goes back to the pool, not to drain it
+                if (!published && frame.data.size())
+                {
+                    std::lock_guard<std::recursive_mutex> guard(mutex);
+                    if (recycle_frames)
+                        recycle_frame(std::move(frame));
+                }
+                return published;
+            }
+            catch (const std::bad_alloc&)
+            {
+                ++allocation_failures;
+                LOG_WARNING("Failed to allocate " << size << " bytes of frame storage");
+                return nullptr;
+            }
+        }
+
+        void reserve_frames(const size_t size, uint32_t count)
+        {
+            std::lock_guard<std::recursive_mutex> guard(mutex);
+            if (!recycle_frames) return;
+
+            // The frame objects too, when the frames queue is unbounded and the sensor preallocates
+            if (preallocation != preallocation_mode::off && !*max_frame_queue_size)
+            {
+                while (spare_frames.size() < std::min<size_t>(count, RS2_USER_QUEUE_SIZE))
+                    spare_frames.emplace_back(new T());
+            }
+            if (!size) return;
+
+            auto&& pool = freelist[size];
+            while (pool.size() < count && freelist_bytes + size <= get_freelist_budget())
+            {
+                T f;
+                f.data = frame_data(frame_data_allocator<byte>(_allocator));
+                f.data.resize(size, 0);
+                pool.push_back(std::move(f));
+                freelist_bytes += size;
+            }
+            update_peak();
+        }
+
+        void get_memory_stats(rs2_frame_memory_stats& stats) const
+        {
+            std::lock_guard<std::recursive_mutex> guard(mutex);
+            stats.live_frames += published_frames_count;
+            stats.bytes_held += published_bytes + freelist_bytes;
+            stats.pooled_bytes += freelist_bytes;
+            stats.peak_bytes += peak_bytes;
+            stats.allocation_failures += allocation_failures;
+            stats.queue_drops += queue_drops;
+            stats.streaming_allocations += streaming_allocations;
         }
 
         void flush()
@@ -306,6 +805,8 @@ namespace librealsense
             {
                 std::lock_guard<std::recursive_mutex> guard(mutex);
                 freelist.clear();
+                freelist_bytes = 0;
+                spare_frames.clear();
             }
 
             pending_frames = published_frames.get_size();
@@ -329,33 +830,102 @@ namespace librealsense
 
     };
 
+    static size_t align_up(size_t size, size_t alignment)
+    {
+        return (size + alignment - 1) / alignment * alignment;
+    }
+
+    void* allocate_frame_data(size_t size)
+    {
+        auto capacity = align_up(std::max(size, (size_t)1), FRAME_DATA_ALIGNMENT);
+#ifdef _WIN32
+        auto ptr = _aligned_malloc(capacity, FRAME_DATA_ALIGNMENT);
+#else
+        void* ptr = nullptr;
+        if (posix_memalign(&ptr, FRAME_DATA_ALIGNMENT, capacity)) ptr = nullptr;
+#endif
+        if (!ptr) throw std::bad_alloc();
+        return ptr;
+    }
+
+    void free_frame_data(void* ptr, size_t size)
+    {
+#ifdef _WIN32
+        _aligned_free(ptr);
+#else
+        free(ptr);
+#endif
+    }
+
+#ifdef __linux__
+    const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+    static void* huge_page_alloc(size_t size, size_t alignment, void* user)
+    {
+        if (size < HUGE_PAGE_SIZE)
+            return allocate_frame_data(size);
+
+        // Prefer reserved huge pages, and fall back to transparent huge pages when none are configured
+        auto capacity = align_up(size, HUGE_PAGE_SIZE);
+        auto ptr = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (ptr == MAP_FAILED)
+        {
+            ptr = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (ptr == MAP_FAILED) return nullptr;
+            madvise(ptr, capacity, MADV_HUGEPAGE);
+        }
+        return ptr;
+    }
+
+    static void huge_page_free(void* ptr, size_t size, void* user)
+    {
+        if (size < HUGE_PAGE_SIZE) free_frame_data(ptr, size);
+        else munmap(ptr, align_up(size, HUGE_PAGE_SIZE));
+    }
+
+    std::shared_ptr<const frame_allocator> get_huge_page_allocator()
+    {
+        static auto allocator = std::make_shared<const frame_allocator>(frame_allocator{ huge_page_alloc, huge_page_free, FRAME_DATA_ALIGNMENT, nullptr });
+        return allocator;
+    }
+#else
+    std::shared_ptr<const frame_allocator> get_huge_page_allocator()
+    {
+        return nullptr;
+    }
+#endif
+
     std::shared_ptr<archive_interface> make_archive(rs2_extension type,
         std::atomic<uint32_t>* in_max_frame_queue_size,
+        std::atomic<uint32_t>* in_max_frame_memory,
+        const std::atomic<int>* in_highest_priority,
         std::shared_ptr<platform::time_service> ts,
-		std::shared_ptr<metadata_parser_map> parsers)
+        std::shared_ptr<metadata_parser_map> parsers,
+        std::shared_ptr<const frame_allocator> allocator,
+        preallocation_mode preallocation)
     {
         switch (type)
         {
         case RS2_EXTENSION_VIDEO_FRAME:
-            return std::make_shared<frame_archive<video_frame>>(in_max_frame_queue_size, ts, parsers);
+            return std::make_shared<frame_archive<video_frame>>(in_max_frame_queue_size, in_max_frame_memory, in_highest_priority, ts, parsers, allocator, preallocation);
 
         case RS2_EXTENSION_COMPOSITE_FRAME:
-            return std::make_shared<frame_archive<composite_frame>>(in_max_frame_queue_size, ts, parsers);
+            return std::make_shared<frame_archive<composite_frame>>(in_max_frame_queue_size, in_max_frame_memory, in_highest_priority, ts, parsers, allocator, preallocation);
 
         case RS2_EXTENSION_MOTION_FRAME:
-            return std::make_shared<frame_archive<motion_frame>>(in_max_frame_queue_size, ts, parsers);
+            return std::make_shared<frame_archive<motion_frame>>(in_max_frame_queue_size, in_max_frame_memory, in_highest_priority, ts, parsers, allocator, preallocation);
 
         case RS2_EXTENSION_POINTS:
-            return std::make_shared<frame_archive<points>>(in_max_frame_queue_size, ts, parsers);
+            return std::make_shared<frame_archive<points>>(in_max_frame_queue_size, in_max_frame_memory, in_highest_priority, ts, parsers, allocator, preallocation);
 
         case RS2_EXTENSION_DEPTH_FRAME:
-            return std::make_shared<frame_archive<depth_frame>>(in_max_frame_queue_size, ts, parsers);
+            return std::make_shared<frame_archive<depth_frame>>(in_max_frame_queue_size, in_max_frame_memory, in_highest_priority, ts, parsers, allocator, preallocation);
 
         case RS2_EXTENSION_POSE_FRAME:
-            return std::make_shared<frame_archive<pose_frame>>(in_max_frame_queue_size, ts, parsers);
+            return std::make_shared<frame_archive<pose_frame>>(in_max_frame_queue_size, in_max_frame_memory, in_highest_priority, ts, parsers, allocator, preallocation);
 
         case RS2_EXTENSION_DISPARITY_FRAME:
-            return std::make_shared<frame_archive<disparity_frame>>(in_max_frame_queue_size, ts, parsers);
+            return std::make_shared<frame_archive<disparity_frame>>(in_max_frame_queue_size, in_max_frame_memory, in_highest_priority, ts, parsers, allocator, preallocation);
 
         default:
             throw std::runtime_error("Requested frame type is not supported!");
@@ -366,6 +936,12 @@ namespace librealsense
     {
         if (ref_count.fetch_sub(1) == 1)
         {
+            trace_scope scope("release", "frame", get_frame_number());
+            // Frames dropped before anyone read them skip the conversion altogether
+            _unpack_pending = false;
+            _deferred_unpack = nullptr;
+            _download_pending = false;
+            _device_data.reset();
             on_release();
             owner->unpublish_frame(this);
         }
@@ -373,6 +949,9 @@ namespace librealsense
 
     void frame::keep()
     {
+        // Kept frames may be held indefinitely, so return their backend buffer right away
+        if (_unpack_pending) run_deferred_unpack();
+
         if (!_kept.exchange(true))
         {
             owner->keep_frame(this);
@@ -381,7 +960,7 @@ namespace librealsense
 
     frame_interface* frame::publish(std::shared_ptr<archive_interface> new_owner)
     {
-        owner = new_owner;
+        owner = std::move(new_owner);
         _kept = false;
         return owner->publish_frame(this);
     }
@@ -392,14 +971,14 @@ namespace librealsense
             throw invalid_value_exception(to_string() << "metadata not available for "
                 << get_string(get_stream()->get_stream_type()) << " stream");
 
-        auto it = metadata_parsers.get()->find(frame_metadata);
-        if (it == metadata_parsers.get()->end())          // Possible user error - md attribute is not supported by this frame type
+        auto parser = metadata_parsers->get(frame_metadata);
+        if (!parser)          // Possible user error - md attribute is not supported by this frame type
             throw invalid_value_exception(to_string() << get_string(frame_metadata)
                 << " attribute is not applicable for "
                 << get_string(get_stream()->get_stream_type()) << " stream ");
 
         // Proceed to parse and extract the required data attribute
-        return it->second->get(*this);
+        return parser->get(*this);
     }
 
     bool frame::supports_frame_metadata(const rs2_frame_metadata_value& frame_metadata) const
@@ -408,15 +987,74 @@ namespace librealsense
         if (!metadata_parsers)
             return false;                         // No parsers are available or no metadata was attached
 
-        auto it = metadata_parsers.get()->find(frame_metadata);
-        if (it == metadata_parsers.get()->end())          // Possible user error - md attribute is not supported by this frame type
+        auto parser = metadata_parsers->get(frame_metadata);
+        if (!parser)          // Possible user error - md attribute is not supported by this frame type
             return false;
 
-        return it->second->supports(*this);
+        return parser->supports(*this);
+    }
+
+    int frame::get_all_frame_metadata(rs2_metadata_type* values, int* supported, int count) const
+    {
+        auto found = 0;
+        for (auto i = 0; i < count; i++)
+        {
+            auto parser = metadata_parsers ? metadata_parsers->get(static_cast<rs2_frame_metadata_value>(i)) : nullptr;
+            supported[i] = (parser && parser->try_get(*this, values[i])) ? 1 : 0;
+            found += supported[i];
+        }
+        return found;
+    }
+
+    void frame::run_deferred_unpack() const
+    {
+        std::lock_guard<std::mutex> lock(_unpack_mutex);
+        if (!_unpack_pending) return;
+
+        auto self = const_cast<frame*>(this);
+        trace_scope scope("unpack", "frame", additional_data.frame_number);
+        _deferred_unpack(self->data.data(), static_cast<const byte*>(on_release.get_data()));
+        self->set_stage_time(frame_stage::unpack, platform::monotonic_time());
+        self->_deferred_unpack = nullptr;
+        self->on_release();
+        _unpack_pending = false;
+    }
+
+#ifdef RS2_USE_CUDA
+    void* frame::alloc_device_data(size_t size)
+    {
+        try
+        {
+            _device_data = rscuda::memory_pool::device()->acquire(size);
+        }
+        catch (const std::bad_alloc&)
+        {
+            LOG_WARNING("Could not allocate " << size << " bytes of device memory, the frame stays in host memory");
+            return nullptr;
+        }
+        _device_size = size;
+        _download_pending = true;
+        return _device_data.get();
+    }
+#endif
+
+    void frame::run_device_download() const
+    {
+#ifdef RS2_USE_CUDA
+        std::lock_guard<std::mutex> lock(_unpack_mutex);
+        if (!_download_pending) return;
+
+        auto self = const_cast<frame*>(this);
+        rscuda::download(self->data.data(), _device_data.get(), std::min(_device_size, data.size()));
+        _download_pending = false;
+#endif
     }
 
     const byte* frame::get_frame_data() const
     {
+        if (_unpack_pending) run_deferred_unpack();
+        if (_download_pending) run_device_download();
+
         const byte* frame_data = data.data();
 
         if (on_release.get_data())
@@ -478,4 +1116,78 @@ namespace librealsense
                 << "ms, FPS: " << get_stream()->get_framerate() << ", Max Duration: " << callback_warning_duration << "ms)");
         }
     }
+
+    void depth_frame::sample(const float2* pixels, size_t count, float* output, rs2_depth_sample_mode mode, int window) const
+    {
+        // As get_distance, of the original of the frames that do not hold the depth themselves
+        auto format = get_stream()->get_format();
+        if (_original && format != RS2_FORMAT_Z16 && format != RS2_FORMAT_DISTANCE)
+            return ((depth_frame*)_original.frame)->sample(pixels, count, output, mode, window);
+
+        // The points are deprojected from the distances, of a buffer of their own
+        std::vector<float> buffer(mode == RS2_DEPTH_SAMPLE_POINT ? count : 0);
+        auto distances = mode == RS2_DEPTH_SAMPLE_POINT ? buffer.data() : output;
+
+        auto data = get_frame_data();
+        auto width = get_width(), height = get_height();
+        auto stride = get_stride() ? get_stride() : width * get_bpp() / 8;
+        if (format == RS2_FORMAT_DISTANCE)
+            sample_pixels<float>(data, width, height, stride, 1.f, pixels, count, window, distances);
+        else
+        {
+            auto units = get_units();
+            switch (get_bpp() / 8) // bits per pixel
+            {
+            case 1: sample_pixels<uint8_t>(data, width, height, stride, units, pixels, count, window, distances);  break;
+            case 2: sample_pixels<uint16_t>(data, width, height, stride, units, pixels, count, window, distances); break;
+            case 4: sample_pixels<uint32_t>(data, width, height, stride, units, pixels, count, window, distances); break;
+            case 8: sample_pixels<uint64_t>(data, width, height, stride, units, pixels, count, window, distances); break;
+            default: throw std::runtime_error(to_string() << "Unrecognized depth format " << int(get_bpp() / 8) << " bytes per pixel");
+            }
+        }
+
+        if (mode == RS2_DEPTH_SAMPLE_POINT)
+        {
+            auto profile = As<video_stream_profile_interface>(get_stream());
+            if (!profile)
+                throw invalid_value_exception("The points of a depth frame are deprojected by the intrinsics of a video stream");
+            deproject_pixels(profile->get_intrinsics(), pixels, distances, reinterpret_cast<float3*>(output), count);
+        }
+    }
+
+    const std::vector<uint64_t>& depth_frame::get_validity_mask() const
+    {
+        // As get_distance, of the original of the frames that do not hold the depth themselves
+        auto format = get_stream()->get_format();
+        if (_original && format != RS2_FORMAT_Z16 && format != RS2_FORMAT_DISTANCE)
+            return ((depth_frame*)_original.frame)->get_validity_mask();
+
+        auto mask = std::atomic_load(&_validity_mask);
+        if (mask)
+            return *mask;
+
+        // Readers that compute it at the same time keep the mask of the first of them
+        auto width = get_width(), height = get_height();
+        auto stride = get_stride() ? get_stride() : width * get_bpp() / 8;
+        auto bits = std::make_shared<std::vector<uint64_t>>((size_t(width) * height + 63) / 64, 0);
+        auto data = get_frame_data();
+        for (int y = 0; y < height; ++y)
+        {
+            auto row = data + y * stride;
+            auto first = size_t(y) * width;
+            switch (get_bpp() / 8) // bits per pixel
+            {
+            case 1: mask_row<uint8_t>(row, width, first, bits->data()); break;
+            case 2: mask_row(reinterpret_cast<const uint16_t*>(row), width, first, bits->data()); break;
+            case 4: mask_row(reinterpret_cast<const uint32_t*>(row), width, first, bits->data()); break;
+            case 8: mask_row(reinterpret_cast<const uint64_t*>(row), width, first, bits->data()); break;
+            default: throw std::runtime_error(to_string() << "Unrecognized depth format " << int(get_bpp() / 8) << " bytes per pixel");
+            }
+        }
+
+        std::shared_ptr<const std::vector<uint64_t>> computed = bits;
+        if (!std::atomic_compare_exchange_strong(&_validity_mask, &mask, computed))
+            return *mask;
+        return *computed;
+    }
 }
@@ -5,8 +5,11 @@
 
 #include "types.h"
 #include "core/streaming.h"
+#include "../include/librealsense2/h/rs_internal.h"
 #include <atomic>
 #include <array>
+#include <cstring>
+#include <memory>
 #include <math.h>
 
 namespace librealsense
@@ -19,7 +22,148 @@ namespace librealsense
 
 namespace librealsense
 {
-    typedef std::map<rs2_frame_metadata_value, std::shared_ptr<md_attribute_parser_base>> metadata_parser_map;
+    // The metadata attribute parsers of the frames of a sensor, in an array indexed by attribute, for the attributes of
+    // every frame to be looked up without a search
+    class metadata_parser_map
+    {
+    public:
+        // Null when the attribute has no parser
+        const md_attribute_parser_base* get(rs2_frame_metadata_value metadata) const
+        {
+            auto index = static_cast<size_t>(metadata);
+            return index < _parsers.size() ? _parsers[index].get() : nullptr;
+        }
+
+        // Replaces the parser of the attribute, if it has one
+        void set(rs2_frame_metadata_value metadata, std::shared_ptr<md_attribute_parser_base> parser)
+        {
+            auto index = static_cast<size_t>(metadata);
+            if (index >= _parsers.size())
+                _parsers.resize(index + 1);
+            _parsers[index] = std::move(parser);
+        }
+
+    private:
+        std::vector<std::shared_ptr<md_attribute_parser_base>> _parsers;
+    };
+
+    // The raw metadata of a frame, sized to its payload rather than to the largest metadata there is. Payloads as small as
+    // those of the motion and pose frames are held inline, larger ones in a buffer kept for as long as the frame object,
+    // which is reused across the frames of the archive. A blob made over the metadata buffer of the backend refers to it
+    // instead of copying it, every copy of the blob, as the one into the frame, holding its own copy of the payload
+    class frame_metadata_blob
+    {
+    public:
+        static const size_t inline_size = 32;
+
+        frame_metadata_blob() : _view(nullptr), _size(0), _capacity(inline_size) {}
+
+        // Refers to the payload, which is to outlive the blob
+        frame_metadata_blob(const uint8_t* data, size_t size)
+            : _view(size ? data : nullptr), _size(static_cast<uint16_t>(std::min(size, size_t(MAX_META_DATA_SIZE)))), _capacity(inline_size) {}
+
+        frame_metadata_blob(const frame_metadata_blob& other) : frame_metadata_blob() { assign(other.data(), other.size()); }
+        frame_metadata_blob(frame_metadata_blob&& other) : frame_metadata_blob() { *this = std::move(other); }
+
+        frame_metadata_blob& operator=(const frame_metadata_blob& other)
+        {
+            if (this != &other) assign(other.data(), other.size());
+            return *this;
+        }
+
+        // Takes the buffer of the other blob when it has one of its own, and copies the payload otherwise
+        frame_metadata_blob& operator=(frame_metadata_blob&& other)
+        {
+            if (this == &other) return *this;
+            if (other._heap && !other._view)
+            {
+                _heap = std::move(other._heap);
+                _capacity = other._capacity;
+                _size = other._size;
+                _view = nullptr;
+                other._capacity = inline_size;
+                other._size = 0;
+            }
+            else assign(other.data(), other.size());
+            return *this;
+        }
+
+        const uint8_t* data() const { return _view ? _view : (_heap ? _heap.get() : _inline); }
+        size_t size() const { return _size; }
+
+        void assign(const uint8_t* data, size_t size)
+        {
+            size = std::min(size, size_t(MAX_META_DATA_SIZE));
+            _view = nullptr;
+            auto dest = reserve(size);
+            if (size) std::memcpy(dest, data, size);
+            _size = static_cast<uint16_t>(size);
+        }
+
+        // Adds to the end of the payload, as long as it stays within MAX_META_DATA_SIZE. Returns false otherwise
+        bool append(const void* data, size_t size)
+        {
+            if (_size + size > MAX_META_DATA_SIZE) return false;
+            if (_view) assign(_view, _size);
+            auto dest = reserve(_size + size);
+            std::memcpy(dest + _size, data, size);
+            _size = static_cast<uint16_t>(_size + size);
+            return true;
+        }
+
+        void clear()
+        {
+            _view = nullptr;
+            _size = 0;
+        }
+
+    private:
+        // Owned storage of at least size bytes, keeping the payload held
+        uint8_t* reserve(size_t size)
+        {
+            if (size > _capacity)
+            {
+                std::unique_ptr<uint8_t[]> grown(new uint8_t[size]);
+                if (_size) std::memcpy(grown.get(), data(), _size);
+                _heap = std::move(grown);
+                _capacity = static_cast<uint16_t>(size);
+            }
+            return _heap ? _heap.get() : _inline;
+        }
+
+        const uint8_t* _view;
+        std::unique_ptr<uint8_t[]> _heap;
+        uint16_t _size;
+        uint16_t _capacity;
+        alignas(8) uint8_t _inline[inline_size];
+    };
+
+    // Statistics of the valid depth of a frame, the pixels of zero depth being invalid. Statistics of parts of a frame
+    // merge into those of the whole, for as long as their histograms are of the same range
+    struct depth_statistics
+    {
+        static const int histogram_bins = 8;
+
+        uint32_t        pixels = 0;             // Zero when the frame has no statistics
+        uint32_t        valid = 0;
+        uint16_t        min = 0xffff;
+        uint16_t        max = 0;
+        uint64_t        sum = 0;
+        uint16_t        histogram_range = 0;    // In depth units, over the bins but the last, which takes the depth beyond it
+        uint32_t        histogram[histogram_bins] = {};
+
+        void merge(const depth_statistics& other)
+        {
+            pixels += other.pixels;
+            valid += other.valid;
+            min = std::min(min, other.min);
+            max = std::max(max, other.max);
+            sum += other.sum;
+            histogram_range = other.histogram_range;
+            for (int i = 0; i < histogram_bins; ++i)
+                histogram[i] += other.histogram[i];
+        }
+    };
 
     struct frame_additional_data
     {
@@ -28,13 +172,15 @@ namespace librealsense
         rs2_timestamp_domain timestamp_domain = RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK;
         rs2_time_t      system_time = 0;
         rs2_time_t      frame_callback_started = 0;
-        uint32_t        metadata_size = 0;
         bool            fisheye_ae_mode = false;
-        std::array<uint8_t, MAX_META_DATA_SIZE> metadata_blob;
+        frame_metadata_blob metadata_blob;
         rs2_time_t      backend_timestamp = 0;
         rs2_time_t last_timestamp = 0;
         unsigned long long last_frame_number = 0;
         bool is_blocking = false;
+        int priority = 0;
+        std::array<rs2_time_t, static_cast<size_t>(frame_stage::count)> stage_times{};
+        depth_statistics depth_stats;
 
         frame_additional_data() {};
 
@@ -50,15 +196,12 @@ namespace librealsense
             : timestamp(in_timestamp),
             frame_number(in_frame_number),
             system_time(in_system_time),
-            metadata_size(md_size),
+            metadata_blob(md_buf, md_size),
             backend_timestamp(backend_time),
             last_timestamp(last_timestamp),
             last_frame_number(last_frame_number),
             is_blocking(in_is_blocking)
         {
-            // Copy up to 255 bytes to preserve metadata as raw data
-            if (metadata_size)
-                std::copy(md_buf, md_buf + std::min(md_size, MAX_META_DATA_SIZE), metadata_blob.begin());
         }
     };
 
@@ -69,7 +212,14 @@ namespace librealsense
 
         virtual frame_interface* alloc_and_track(const size_t size, const frame_additional_data& additional_data, bool requires_memory) = 0;
 
-        virtual std::shared_ptr<metadata_parser_map> get_md_parsers() const = 0;
+        // Pre-allocate frame buffers of the given size, so that streaming can start without hitting the heap
+        virtual void reserve_frames(const size_t size, uint32_t count) = 0;
+
+        // Accumulate the memory held by this archive and its drop counters into stats
+        virtual void get_memory_stats(rs2_frame_memory_stats& stats) const = 0;
+
+        // Borrowed, copied once into each frame the archive publishes
+        virtual const std::shared_ptr<metadata_parser_map>& get_md_parsers() const = 0;
 
         virtual void flush() = 0;
 
@@ -80,27 +230,91 @@ namespace librealsense
 
     };
 
+    // User-provided storage for frame data, see rs2_set_frame_allocator
+    struct frame_allocator
+    {
+        rs2_frame_allocator_alloc_ptr alloc;
+        rs2_frame_allocator_free_ptr free;
+        size_t alignment;
+        void* user;
+    };
+
+    // Frame buffers are cache-line aligned, with capacity rounded up to a whole number of cache lines,
+    // so vectorized kernels may process trailing partial blocks without running past the allocation
+    const size_t FRAME_DATA_ALIGNMENT = 64;
+
+    void* allocate_frame_data(size_t size);
+    void free_frame_data(void* ptr, size_t size);
+
+    // Built-in allocator backing buffers of 2MB and above with huge pages (Linux only, aligned heap memory elsewhere)
+    std::shared_ptr<const frame_allocator> get_huge_page_allocator();
+
+    // Standard allocator adapter, forwarding frame data requests to the attached frame_allocator (if any)
+    template<class T>
+    class frame_data_allocator
+    {
+    public:
+        typedef T value_type;
+        typedef std::true_type propagate_on_container_move_assignment;
+        typedef std::true_type propagate_on_container_swap;
+
+        frame_data_allocator() {}
+        explicit frame_data_allocator(std::shared_ptr<const frame_allocator> allocator) : _allocator(std::move(allocator)) {}
+        template<class U> frame_data_allocator(const frame_data_allocator<U>& other) : _allocator(other.get_frame_allocator()) {}
+
+        T* allocate(size_t n)
+        {
+            if (!_allocator)
+                return static_cast<T*>(allocate_frame_data(n * sizeof(T)));
+
+            auto ptr = _allocator->alloc(n * sizeof(T), _allocator->alignment, _allocator->user);
+            if (!ptr) throw std::bad_alloc();
+            return static_cast<T*>(ptr);
+        }
+
+        void deallocate(T* ptr, size_t n)
+        {
+            if (!_allocator) free_frame_data(ptr, n * sizeof(T));
+            else _allocator->free(ptr, n * sizeof(T), _allocator->user);
+        }
+
+        const std::shared_ptr<const frame_allocator>& get_frame_allocator() const { return _allocator; }
+
+    private:
+        std::shared_ptr<const frame_allocator> _allocator;
+    };
+
+    template<class T, class U>
+    bool operator==(const frame_data_allocator<T>& a, const frame_data_allocator<U>& b) { return a.get_frame_allocator() == b.get_frame_allocator(); }
+    template<class T, class U>
+    bool operator!=(const frame_data_allocator<T>& a, const frame_data_allocator<U>& b) { return !(a == b); }
+
+    typedef std::vector<byte, frame_data_allocator<byte>> frame_data;
+
     std::shared_ptr<archive_interface> make_archive(rs2_extension type,
         std::atomic<uint32_t>* in_max_frame_queue_size,
+        std::atomic<uint32_t>* in_max_frame_memory,
+        const std::atomic<int>* in_highest_priority,
         std::shared_ptr<platform::time_service> ts,
-        std::shared_ptr<metadata_parser_map> parsers);
+        std::shared_ptr<metadata_parser_map> parsers,
+        std::shared_ptr<const frame_allocator> allocator = nullptr,
+        preallocation_mode preallocation = preallocation_mode::off);
 
     // Define a movable but explicitly noncopyable buffer type to hold our frame data
     class frame : public frame_interface
     {
     public:
-        std::vector<byte> data;
+        frame_data data;
         frame_additional_data additional_data;
         std::shared_ptr<metadata_parser_map> metadata_parsers = nullptr;
-        explicit frame() : ref_count(0), _kept(false), owner(nullptr), on_release() {}
+        explicit frame() : ref_count(0), _kept(false), owner(nullptr), on_release(), _unpack_pending(false), _download_pending(false) {}
         frame(const frame& r) = delete;
         frame(frame&& r)
             : ref_count(r.ref_count.exchange(0)), _kept(r._kept.exchange(false)),
-            owner(r.owner), on_release()
+            owner(r.owner), on_release(), _unpack_pending(false), _download_pending(false)
         {
             *this = std::move(r);
             if (owner) metadata_parsers = owner->get_md_parsers();
-            if (r.metadata_parsers) metadata_parsers = std::move(r.metadata_parsers);
         }
 
         frame& operator=(const frame& r) = delete;
@@ -111,16 +325,22 @@ namespace librealsense
             ref_count = r.ref_count.exchange(0);
             _kept = r._kept.exchange(false);
             on_release = std::move(r.on_release);
+            _deferred_unpack = std::move(r._deferred_unpack);
+            _unpack_pending = r._unpack_pending.exchange(false);
+            _device_data = std::move(r._device_data);
+            _device_size = r._device_size;
+            _download_pending = r._download_pending.exchange(false);
             additional_data = std::move(r.additional_data);
             r.owner.reset();
-            if (owner) metadata_parsers = owner->get_md_parsers();
             if (r.metadata_parsers) metadata_parsers = std::move(r.metadata_parsers);
+            else if (owner) metadata_parsers = owner->get_md_parsers();
             return *this;
         }
 
         virtual ~frame() { on_release.reset(); }
         rs2_metadata_type get_frame_metadata(const rs2_frame_metadata_value& frame_metadata) const override;
         bool supports_frame_metadata(const rs2_frame_metadata_value& frame_metadata) const override;
+        int get_all_frame_metadata(rs2_metadata_type* values, int* supported, int count) const override;
         const byte* get_frame_data() const override;
         rs2_time_t get_frame_timestamp() const override;
         rs2_timestamp_domain get_frame_timestamp_domain() const override;
@@ -133,20 +353,47 @@ namespace librealsense
 
         rs2_time_t get_frame_system_time() const override;
 
-        std::shared_ptr<stream_profile_interface> get_stream() const override { return stream; }
+        const std::shared_ptr<stream_profile_interface>& get_stream() const override { return stream; }
         void set_stream(std::shared_ptr<stream_profile_interface> sp) override { stream = std::move(sp); }
 
         rs2_time_t get_frame_callback_start_time_point() const override;
         void update_frame_callback_start_ts(rs2_time_t ts) override;
+        rs2_time_t get_stage_time(frame_stage stage) const override { return additional_data.stage_times[static_cast<size_t>(stage)]; }
+        void set_stage_time(frame_stage stage, rs2_time_t time) override { additional_data.stage_times[static_cast<size_t>(stage)] = time; }
 
         void acquire() override { ref_count.fetch_add(1); }
         void release() override;
         void keep() override;
 
+        // Whether the holder of the one reference to the frame may modify it in place: the frame is not kept, and its data is its own
+        bool is_exclusive() const
+        {
+            if (_unpack_pending) run_deferred_unpack();
+            return ref_count == 1 && !_kept && !on_release.get_data() && !_device_data;
+        }
+
         frame_interface* publish(std::shared_ptr<archive_interface> new_owner) override;
         void attach_continuation(frame_continuation&& continuation) override { on_release = std::move(continuation); }
         void disable_continuation() override { on_release.reset(); }
 
+        // Postpone converting the native pixels held by the continuation into the frame data until get_frame_data() is first called.
+        // Runs once even with concurrent readers, after which the backend buffer is released
+        void defer_unpack(std::function<void(byte* dest, const byte* source)> unpack)
+        {
+            _deferred_unpack = std::move(unpack);
+            _unpack_pending = true;
+        }
+
+#ifdef RS2_USE_CUDA
+        // Back the frame with size bytes of pooled device memory for the GPU to write, making the frame GPU-resident.
+        // The host data is downloaded from the device when it is first read. Null when the device is out of memory, the frame
+        // then staying in host memory for the caller to write there instead
+        void* alloc_device_data(size_t size);
+#endif
+
+        // Device memory of GPU-resident frames, null for the others
+        const void* get_device_data() const { return _device_data.get(); }
+
         archive_interface* get_owner() const override { return owner.get(); }
 
         std::shared_ptr<sensor_interface> get_sensor() const override;
@@ -162,6 +409,9 @@ namespace librealsense
         void set_blocking(bool state) override { additional_data.is_blocking = state; }
         bool is_blocking() const override { return additional_data.is_blocking; }
 
+        void set_priority(int priority) override { additional_data.priority = priority; }
+        int get_priority() const override { return additional_data.priority; }
+
     private:
         // TODO: check boost::intrusive_ptr or an alternative
         std::atomic<int> ref_count; // the reference count is on how many times this placeholder has been observed (not lifetime, not content)
@@ -171,15 +421,113 @@ namespace librealsense
         bool _fixed = false;
         std::atomic_bool _kept;
         std::shared_ptr<stream_profile_interface> stream;
+
+        void run_deferred_unpack() const;
+        std::function<void(byte* dest, const byte* source)> _deferred_unpack;
+        mutable std::atomic_bool _unpack_pending;
+        mutable std::mutex _unpack_mutex;
+
+        void run_device_download() const;
+        std::shared_ptr<void> _device_data;
+        size_t _device_size = 0;
+        mutable std::atomic_bool _download_pending;
     };
 
+    // Device memory of a GPU-resident frame, null for the others
+    inline const void* get_device_data(const frame_interface* f)
+    {
+        auto fr = dynamic_cast<const frame*>(f);
+        return fr ? fr->get_device_data() : nullptr;
+    }
+
     class points : public frame
     {
     public:
+        points() : frame(), _format(RS2_FORMAT_XYZ32F), _pixel_indices(false), _normals(false), _colors(false),
+            _texture_coordinates(true), _planar(false), _texture_pending(false) {}
+        points(points&& r) : frame(), _texture_pending(false) { *this = std::move(r); }
+
+        points& operator=(points&& r)
+        {
+            frame::operator=(std::move(r));
+            _format = r._format;
+            _pixel_indices = r._pixel_indices;
+            _normals = r._normals;
+            _colors = r._colors;
+            _texture_coordinates = r._texture_coordinates;
+            _planar = r._planar;
+            _deferred_texture = std::move(r._deferred_texture);
+            _texture_pending = r._texture_pending.exchange(false);
+            _unmapped_texture_coordinates = std::move(r._unmapped_texture_coordinates);
+            return *this;
+        }
+
+        // The texture coordinates computed before the data is read, of the points whose computation was deferred
+        const byte* get_frame_data() const override;
+
+        // Vertices and texture coordinates are float3 and float2 for RS2_FORMAT_XYZ32F, and 3 and 2 16-bit values for the 16-bit formats.
+        // Throws for planar points, whose vertices are read a plane at a time
         float3* get_vertices();
-        void export_to_ply(const std::string& fname, const frame_holder& texture);
+
+        // Planar RS2_FORMAT_XYZ32F points hold the X, Y and Z of their vertices in three planes of floats, in place of the
+        // interleaved vertices. Null for interleaved points
+        float* get_vertex_plane(int axis);
+        bool is_planar() const { return _planar; }
+        void set_planar(bool planar) { _planar = planar; }
+
+        // Normals and faces are of the neighbours on the depth image, for the points of all its pixels or with their pixel indices
+        void export_to_ply(const std::string& fname, const frame_holder& texture, bool normals = false, bool faces = false);
         size_t get_vertex_count() const;
+        // Of the points laid out without texture coordinates, zeros allocated on the first read
         float2* get_texture_coordinates();
+
+        // Postpone mapping the vertices to the texture coordinates until they or the data are first read. Runs once even with
+        // concurrent readers, for the points that are never textured not to pay for the projection
+        void defer_texture_coordinates(std::function<void(const float3* vertices, float2* texture_coordinates, size_t count)> map)
+        {
+            _deferred_texture = std::move(map);
+            _texture_pending = true;
+        }
+
+        // Unit normal of every vertex as float3 of every format, stored after the texture coordinates of the point clouds
+        // computed with normals alone
+        float3* get_normals();
+
+        // Depth pixel index of every vertex, stored after the texture coordinates and normals of compacted point clouds alone
+        int* get_pixel_indices();
+
+        // Red, green and blue bytes of every vertex, stored last by the blocks that sample the color of the points
+        uint8_t* get_colors();
+
+        // Recycled frames keep the layout of their previous use, so every allocation sets it. Points without texture
+        // coordinates are the vertices of untextured point clouds
+        void set_layout(rs2_format format, bool pixel_indices, bool normals = false, bool colors = false, bool texture_coordinates = true)
+        {
+            _format = format; _pixel_indices = pixel_indices; _normals = normals; _colors = colors; _texture_coordinates = texture_coordinates;
+            _planar = false;
+            _deferred_texture = nullptr;
+            _texture_pending = false;
+            _unmapped_texture_coordinates.clear();
+        }
+        static size_t get_vertex_size(rs2_format format);
+        static size_t get_texture_coordinate_size(rs2_format format);
+        static size_t get_point_size(rs2_format format, bool pixel_indices, bool normals = false, bool colors = false, bool texture_coordinates = true);
+
+    private:
+        size_t get_texture_size() const { return _texture_coordinates ? get_texture_coordinate_size(_format) : 0; }
+        void map_deferred_texture() const;
+
+        rs2_format _format;
+        bool _pixel_indices;
+        bool _normals;
+        bool _colors;
+        bool _texture_coordinates;
+        bool _planar;
+
+        std::function<void(const float3* vertices, float2* texture_coordinates, size_t count)> _deferred_texture;
+        mutable std::atomic_bool _texture_pending;
+        mutable std::mutex _texture_mutex;
+        std::vector<float2> _unmapped_texture_coordinates;
     };
 
     MAP_EXTENSION(RS2_EXTENSION_POINTS, librealsense::points);
@@ -187,7 +535,11 @@ namespace librealsense
     class composite_frame : public frame
     {
     public:
-        composite_frame() : frame() {}
+        // The framesets of up to as many frames hold them within the composite frame, which the archive pools,
+        // rather than in a buffer of their own
+        static const size_t max_inline_frames = 8;
+
+        composite_frame() : frame(), _inline_count(0) {}
 
         frame_interface* get_frame(int i) const
         {
@@ -195,7 +547,17 @@ namespace librealsense
             return frames[i];
         }
 
-        frame_interface** get_frames() const { return (frame_interface**)data.data(); }
+        frame_interface** get_frames() const
+        {
+            return _inline_count ? const_cast<frame_interface**>(_inline_frames.data()) : (frame_interface**)data.data();
+        }
+
+        // For the frames to be held within the composite frame, which was allocated with no buffer
+        void hold_inline(size_t count)
+        {
+            _inline_frames.fill(nullptr);
+            _inline_count = count;
+        }
 
         const frame_interface* first() const
         {
@@ -214,7 +576,7 @@ namespace librealsense
             frame::keep();
         }
 
-        size_t get_embedded_frames_count() const { return data.size() / sizeof(rs2_frame*); }
+        size_t get_embedded_frames_count() const { return _inline_count ? _inline_count : data.size() / sizeof(rs2_frame*); }
 
         // In the next section we make the composite frame "look and feel" like the first of its children
         rs2_metadata_type get_frame_metadata(const rs2_frame_metadata_value& frame_metadata) const override
@@ -225,6 +587,21 @@ namespace librealsense
         {
             return first()->supports_frame_metadata(frame_metadata);
         }
+        rs2_time_t get_stage_time(frame_stage stage) const override
+        {
+            return first()->get_stage_time(stage);
+        }
+        void set_stage_time(frame_stage stage, rs2_time_t time) override
+        {
+            auto frames = get_frames();
+            for (int i = 0; i < get_embedded_frames_count(); i++)
+                if (frames[i]) frames[i]->set_stage_time(stage, time);
+            frame::set_stage_time(stage, time);
+        }
+        int get_all_frame_metadata(rs2_metadata_type* values, int* supported, int count) const override
+        {
+            return first()->get_all_frame_metadata(values, supported, count);
+        }
         const byte* get_frame_data() const override
         {
             return first()->get_frame_data();
@@ -252,6 +629,10 @@ namespace librealsense
         {
             return first()->get_sensor();
         }
+
+    private:
+        std::array<frame_interface*, max_inline_frames> _inline_frames;
+        size_t _inline_count;   // Zero when the frames are held in the buffer of the frame
     };
 
     MAP_EXTENSION(RS2_EXTENSION_COMPOSITE_FRAME, librealsense::composite_frame);
@@ -260,9 +641,16 @@ namespace librealsense
     {
     public:
         video_frame()
-            : frame(), _width(0), _height(0), _bpp(0), _stride(0)
+            : frame(), _width(0), _height(0), _bpp(0), _stride(0), _dmabuf_fd(-1), _dmabuf_offset(0)
         {}
 
+        frame_interface* publish(std::shared_ptr<archive_interface> new_owner) override
+        {
+            _dmabuf_fd = -1;
+            _dmabuf_offset = 0;
+            return frame::publish(std::move(new_owner));
+        }
+
         int get_width() const { return _width; }
         int get_height() const { return _height; }
         int get_stride() const { return _stride; }
@@ -276,8 +664,18 @@ namespace librealsense
             _bpp = bpp;
         }
 
+        // Frames that wrap an exported backend buffer, whose DMABUF stays valid for as long as the frame is held
+        void set_dmabuf(int fd, int offset)
+        {
+            _dmabuf_fd = fd;
+            _dmabuf_offset = offset;
+        }
+        int get_dmabuf_fd() const { return _dmabuf_fd; }
+        int get_dmabuf_offset() const { return _dmabuf_offset; }
+
     private:
         int _width, _height, _bpp, _stride;
+        int _dmabuf_fd, _dmabuf_offset;
     };
 
     MAP_EXTENSION(RS2_EXTENSION_VIDEO_FRAME, librealsense::video_frame);
@@ -292,7 +690,8 @@ namespace librealsense
         frame_interface* publish(std::shared_ptr<archive_interface> new_owner) override
         {
             _depth_units = optional_value<float>();
-            return video_frame::publish(new_owner);
+            _validity_mask.reset();
+            return video_frame::publish(std::move(new_owner));
         }
 
         void keep() override
@@ -303,6 +702,10 @@ namespace librealsense
 
         float get_distance(int x, int y) const
         {
+            // Metric depth holds the distance itself
+            if (get_stream()->get_format() == RS2_FORMAT_DISTANCE)
+                return reinterpret_cast<const float*>(get_frame_data())[y*get_width() + x];
+
             // If this frame does not itself contain Z16 depth data,
             // fall back to the original frame it was created from
             if (_original && get_stream()->get_format() != RS2_FORMAT_Z16)
@@ -321,6 +724,13 @@ namespace librealsense
             return pixel * get_units();
         }
 
+        // The distances, or the points of mode RS2_DEPTH_SAMPLE_POINT, of count pixels at once, see rs2_depth_frame_sample
+        void sample(const float2* pixels, size_t count, float* output, rs2_depth_sample_mode mode, int window) const;
+
+        // A bit per pixel, set for the pixels with depth, bit i % 64 of word i / 64 being of pixel i of the frame in row order.
+        // Computed once by the first of its readers, for the others to skip the pixels without depth by whole words
+        const std::vector<uint64_t>& get_validity_mask() const;
+
         float get_units() const
         {
             if (!_depth_units)
@@ -392,6 +802,7 @@ namespace librealsense
 
         frame_holder _original;
         mutable optional_value<float> _depth_units;
+        mutable std::shared_ptr<const std::vector<uint64_t>> _validity_mask; // Read and set atomically, by the readers of the frame
     };
 
     MAP_EXTENSION(RS2_EXTENSION_DEPTH_FRAME, librealsense::depth_frame);
@@ -454,8 +865,21 @@ namespace librealsense
     class motion_frame : public frame
     {
     public:
-        motion_frame() : frame()
+        motion_frame() : frame(), _batched(false)
         {}
+
+        frame_interface* publish(std::shared_ptr<archive_interface> new_owner) override
+        {
+            _batched = false;
+            return frame::publish(std::move(new_owner));
+        }
+
+        // Batched frames hold an array of rs2_motion_sample, instead of the data of a single sample
+        void set_batched(bool batched) { _batched = batched; }
+        bool is_batched() const { return _batched; }
+
+    private:
+        bool _batched;
     };
 
     MAP_EXTENSION(RS2_EXTENSION_MOTION_FRAME, librealsense::motion_frame);
@@ -14,6 +14,16 @@
 #endif
 
 #include "backend.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
 void librealsense::platform::control_range::populate_raw_data(std::vector<uint8_t>& vec, int32_t value)
 {
     vec.resize(sizeof(value));
@@ -26,4 +36,20 @@ double librealsense::monotonic_to_realtime(double monotonic)
     auto realtime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
     auto time_since_epoch = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
     return monotonic + (realtime - time_since_epoch);
-}
\ No newline at end of file
+}
+
+rs2_time_t librealsense::platform::monotonic_time()
+{
+#ifdef _WIN32
+    static const double ticks_per_ms = [] { LARGE_INTEGER frequency; QueryPerformanceFrequency(&frequency); return frequency.QuadPart / 1000.; }();
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return counter.QuadPart / ticks_per_ms;
+#elif defined(CLOCK_MONOTONIC_RAW)
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return ts.tv_sec * 1000. + ts.tv_nsec / 1000000.;
+#else
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
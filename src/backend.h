@@ -25,6 +25,7 @@
 const uint16_t MAX_RETRIES                = 100;
 const uint16_t VID_INTEL_CAMERA           = 0x8086;
 const uint8_t  DEFAULT_V4L2_FRAME_BUFFERS = 4;
+const uint8_t  MAX_V4L2_FRAME_BUFFERS     = 32; // VIDEO_MAX_FRAME
 const uint16_t DELAY_FOR_RETRIES          = 50;
 
 const uint8_t MAX_META_DATA_SIZE          = 0xff; // UVC Metadata total length
@@ -105,6 +106,16 @@ namespace librealsense
             }
         };
 
+        // Milliseconds of a clock neither stepped nor slewed, for comparing the times taken at different layers of the
+        // library: CLOCK_MONOTONIC_RAW on Linux, QueryPerformanceCounter on Windows and steady_clock elsewhere
+        rs2_time_t monotonic_time();
+
+        class monotonic_time_service : public time_service
+        {
+        public:
+            rs2_time_t get_time() const override { return monotonic_time(); }
+        };
+
         struct guid { uint32_t data1; uint16_t data2, data3; uint8_t data4[8]; };
         // subdevice and node fields are assigned by Host driver; unit and GUID are hard-coded in camera firmware
         struct extension_unit { int subdevice, unit, node; guid id; };
@@ -120,6 +131,22 @@ namespace librealsense
             virtual ~command_transfer() = default;
         };
 
+        // Claims the interface of a command transfer, by claim returning busy while another process holds it. That process
+        // releases the interface at the end of its own command, so the claim is retried until the timeout of the transfer
+        // rather than failing it
+        template<class Claim>
+        int claim_when_free(Claim claim, int busy, int timeout_ms)
+        {
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+            while (true)
+            {
+                auto status = claim();
+                if (status != busy || std::chrono::steady_clock::now() >= deadline)
+                    return status;
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+
         enum power_state
         {
             D0,
@@ -164,6 +191,27 @@ namespace librealsense
 
         constexpr uint8_t uvc_header_size = sizeof(uvc_header);
 
+        // DMABUF exported by the driver for a capture buffer, for other devices to import the pixels without copying them
+        struct dmabuf_plane
+        {
+            int             fd;
+            uint32_t        offset;     // Of the pixels, in bytes from the start of the DMABUF
+        };
+
+        // Health of the transport of a device, accumulated since it last started streaming
+        struct transport_stats
+        {
+            unsigned long long transfer_errors;     // Transfers and payloads that the bus or the device failed
+            unsigned long long dropped_frames;      // Frames dropped by the backend before reaching the callback
+        };
+
+        // Memory of the application for the driver to capture a frame into, which must outlive the streaming
+        struct user_buffer
+        {
+            void*           data;
+            size_t          size;
+        };
+
         struct frame_object
         {
             size_t          frame_size;
@@ -171,6 +219,8 @@ namespace librealsense
             const void *    pixels;
             const void *    metadata;
             rs2_time_t      backend_time;
+            const dmabuf_plane* dmabuf;     // Null unless the backend exports its buffers, owned by the backend
+            rs2_time_t      dequeue_time;   // monotonic_time() the frame was taken from the driver, zero when the backend does not stamp it
         };
 
         typedef std::function<void(stream_profile, frame_object, std::function<void()>)> frame_callback;
@@ -372,6 +422,7 @@ namespace librealsense
         {
             std::string sensor_name;
             uint32_t frequency;
+            uint32_t batch;     // Samples the backend waits for before waking up to read them, 0 for its default
         };
 
         enum custom_sensor_report_field{
@@ -418,6 +469,9 @@ namespace librealsense
         {
         public:
             virtual void probe_and_commit(stream_profile profile, frame_callback callback, int buffers = DEFAULT_V4L2_FRAME_BUFFERS) = 0;
+            // Capture the next commit of the profile into the buffers of the application in place of buffers of the backend,
+            // false when the backend cannot. The buffers are used until the profile is closed
+            virtual bool set_user_buffers(stream_profile profile, std::vector<user_buffer> buffers) { return false; }
             virtual void stream_on(std::function<void(const notification& n)> error_handler = [](const notification& n){}) = 0;
             virtual void start_callbacks() = 0;
             virtual void stop_callbacks() = 0;
@@ -443,6 +497,9 @@ namespace librealsense
             virtual std::string get_device_location() const = 0;
             virtual usb_spec  get_usb_specification() const = 0;
 
+            // Zero for the backends that do not count
+            virtual transport_stats get_transport_stats() const { return transport_stats{}; }
+
             virtual ~uvc_device() = default;
 
         protected:
@@ -460,6 +517,11 @@ namespace librealsense
                 _dev->probe_and_commit(profile, callback, buffers);
             }
 
+            bool set_user_buffers(stream_profile profile, std::vector<user_buffer> buffers) override
+            {
+                return _dev->set_user_buffers(profile, std::move(buffers));
+            }
+
             void stream_on(std::function<void(const notification& n)> error_handler = [](const notification& n){}) override
             {
                 _dev->stream_on(error_handler);
@@ -568,6 +630,11 @@ namespace librealsense
                 return _dev->get_usb_specification();
             }
 
+            transport_stats get_transport_stats() const override
+            {
+                return _dev->get_transport_stats();
+            }
+
             void lock() const override { _dev->lock(); }
             void unlock() const override { _dev->unlock(); }
 
@@ -730,6 +797,11 @@ namespace librealsense
                 _dev[dev_index]->probe_and_commit(profile, callback, buffers);
             }
 
+            bool set_user_buffers(stream_profile profile, std::vector<user_buffer> buffers) override
+            {
+                return _dev[get_dev_index_by_profiles(profile)]->set_user_buffers(profile, std::move(buffers));
+            }
+
 
             void stream_on(std::function<void(const notification& n)> error_handler = [](const notification& n){}) override
             {
@@ -831,6 +903,18 @@ namespace librealsense
                 return _dev.front()->get_usb_specification();
             }
 
+            transport_stats get_transport_stats() const override
+            {
+                transport_stats stats{};
+                for (auto&& dev : _dev)
+                {
+                    auto dev_stats = dev->get_transport_stats();
+                    stats.transfer_errors += dev_stats.transfer_errors;
+                    stats.dropped_frames += dev_stats.dropped_frames;
+                }
+                return stats;
+            }
+
             void lock() const override
             {
                 std::vector<uvc_device*> locked_dev;
@@ -889,6 +973,10 @@ namespace librealsense
         public:
             virtual void start(device_changed_callback callback) = 0;
             virtual void stop() = 0;
+
+            // Starts from devices the caller just queried, instead of querying them again. Watchers that report every change
+            // as it happens return true, for the caller to keep the devices up to date from the callback; the others do not start
+            virtual bool start_from(const backend_device_group& devices, device_changed_callback callback) { return false; }
             virtual ~device_watcher() {};
         };
     }
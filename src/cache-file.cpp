@@ -0,0 +1,81 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include "cache-file.h"
+#include "types.h"
+
+#include <fstream>
+#include <thread>
+#include <chrono>
+#include <cstdio>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+namespace librealsense
+{
+    bool cache_file::is_enabled(const char* variable)
+    {
+        auto value = getenv(variable);
+        return value && *value;
+    }
+
+    cache_file::cache_file(const char* variable, const std::string& name)
+    {
+        auto dir = getenv(variable);
+        _path = to_string() << (dir && *dir ? dir : ".") << "/" << name;
+    }
+
+    bool cache_file::read(std::vector<uint8_t>& content, size_t max_size) const
+    {
+        std::ifstream file(_path, std::ios::binary | std::ios::ate);
+        if (!file.good())
+            return false;
+
+        auto size = static_cast<uint64_t>(file.tellg());
+        if (size > max_size)
+        {
+            LOG_WARNING("Ignoring the cache " << _path << " of " << size << " bytes, above the maximum of " << max_size);
+            return false;
+        }
+
+        std::vector<uint8_t> data(static_cast<size_t>(size));
+        file.seekg(0);
+        if (!file.read(reinterpret_cast<char*>(data.data()), data.size()))
+            return false;
+
+        content = std::move(data);
+        return true;
+    }
+
+    bool cache_file::write(const std::vector<uint8_t>& content) const
+    {
+        std::string temp_path = to_string() << _path << "." << std::hash<std::thread::id>()(std::this_thread::get_id())
+            << "." << std::chrono::high_resolution_clock::now().time_since_epoch().count() << ".tmp";
+        {
+            std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(content.data()), content.size());
+            if (!file.good())
+            {
+                LOG_WARNING("Could not write the cache " << temp_path);
+                file.close();
+                std::remove(temp_path.c_str());
+                return false;
+            }
+        }
+
+        // Replacing the file at once, where removing it first would let another process find none meanwhile
+#ifdef _WIN32
+        auto replaced = MoveFileExA(temp_path.c_str(), _path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+        auto replaced = std::rename(temp_path.c_str(), _path.c_str()) == 0;
+#endif
+        if (!replaced)
+        {
+            LOG_WARNING("Could not write the cache " << _path);
+            std::remove(temp_path.c_str());
+        }
+        return replaced;
+    }
+}
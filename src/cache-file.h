@@ -0,0 +1,33 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace librealsense
+{
+    // File of an opt-in cache, in the existing directory an environment variable names. A file is written aside and renamed
+    // over the previous one, for the processes sharing the directory to never read a partial file
+    class cache_file
+    {
+    public:
+        // Whether the variable is set. Callers read it once, the variable being set for the whole run of the process
+        static bool is_enabled(const char* variable);
+
+        // The file of the name in the directory, the current one when the variable is not set
+        cache_file(const char* variable, const std::string& name);
+
+        const std::string& get_path() const { return _path; }
+
+        // False when there is no file, or when it is above max_size, which is checked before anything is allocated for it
+        bool read(std::vector<uint8_t>& content, size_t max_size) const;
+        // False, after logging the failure, when the file could not be replaced
+        bool write(const std::vector<uint8_t>& content) const;
+
+    private:
+        std::string _path;
+    };
+}
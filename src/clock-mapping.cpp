@@ -0,0 +1,90 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include <algorithm>
+#include "clock-mapping.h"
+
+namespace librealsense
+{
+    // Crystal clocks drift by far less, which keeps the slope from following the jitter of the arrival times
+    const double max_clock_drift = 0.001;
+    // Samples delayed by more than this many times the mean delay, and by at least the margin, are outliers
+    const double outlier_delays = 4.;
+    const double outlier_margin = 2.;
+    const int max_rejected = 30;
+
+    const size_t device_clock_mapping::window_size;
+    const size_t device_clock_mapping::min_samples;
+
+    device_clock_mapping::device_clock_mapping()
+        : _next(0), _count(0), _device_origin(0), _host_origin(0), _slope(1), _offset(0), _mean_delay(0), _rejected(0)
+    {
+    }
+
+    void device_clock_mapping::add(double device_time, double host_time)
+    {
+        // A clock that went back was reset, along with the device
+        if (_count && device_time - _device_origin < _samples[(_next + window_size - 1) % window_size].first - 1000)
+            reset();
+
+        if (is_ready())
+        {
+            auto delay = host_time - to_host(device_time);
+            if (delay > std::max(outlier_delays * _mean_delay, outlier_margin) && ++_rejected < max_rejected)
+                return;
+            // Waited long enough for the mapping to come back, the clocks jumped instead
+            if (_rejected >= max_rejected)
+                reset();
+        }
+        _rejected = 0;
+
+        if (!_count)
+        {
+            _next = 0;
+            _device_origin = device_time;
+            _host_origin = host_time;
+        }
+
+        _samples[_next] = { device_time - _device_origin, host_time - _host_origin };
+        _next = (_next + 1) % window_size;
+        _count = std::min(_count + 1, window_size);
+        fit();
+    }
+
+    void device_clock_mapping::fit()
+    {
+        double mean_device = 0, mean_host = 0;
+        for (size_t i = 0; i < _count; i++)
+        {
+            mean_device += _samples[i].first;
+            mean_host += _samples[i].second;
+        }
+        mean_device /= _count;
+        mean_host /= _count;
+
+        double variance = 0, covariance = 0;
+        for (size_t i = 0; i < _count; i++)
+        {
+            auto d = _samples[i].first - mean_device;
+            variance += d * d;
+            covariance += d * (_samples[i].second - mean_host);
+        }
+        _slope = variance > 0 ? covariance / variance : 1;
+        _slope = std::max(1 - max_clock_drift, std::min(1 + max_clock_drift, _slope));
+
+        // Frames only ever arrive late, the earliest of them tells the offset best
+        _offset = _samples[0].second - _slope * _samples[0].first;
+        for (size_t i = 1; i < _count; i++)
+            _offset = std::min(_offset, _samples[i].second - _slope * _samples[i].first);
+
+        _mean_delay = 0;
+        for (size_t i = 0; i < _count; i++)
+            _mean_delay += _samples[i].second - (_offset + _slope * _samples[i].first);
+        _mean_delay /= _count;
+    }
+
+    double device_clock_mapping::to_host(double device_time) const
+    {
+        return _host_origin + _offset + _slope * (device_time - _device_origin);
+    }
+}
@@ -0,0 +1,43 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <utility>
+
+namespace librealsense
+{
+    // Estimates the host time of the timestamps of a device clock from the times the frames reach the host.
+    // The drift is the least-squares slope of the recent samples, and the offset is that of the sample that took the least time to arrive.
+    // Samples that arrived far later than the others are left out, unless so many of them in a row that the clocks rather jumped
+    class device_clock_mapping
+    {
+    public:
+        device_clock_mapping();
+
+        void add(double device_time, double host_time);
+        double to_host(double device_time) const;
+
+        // Whether there were enough samples for the drift to mean anything
+        bool is_ready() const { return _count >= min_samples; }
+        void reset() { _count = 0; _rejected = 0; }
+
+    private:
+        static const size_t window_size = 128;
+        static const size_t min_samples = 8;
+
+        void fit();
+
+        std::array<std::pair<double, double>, window_size> _samples;    // Device and host times, relative to the first sample
+        size_t _next;
+        size_t _count;
+        double _device_origin;
+        double _host_origin;
+        double _slope;
+        double _offset;
+        double _mean_delay;     // Of the samples over the earliest one, once fit
+        int _rejected;          // In a row
+    };
+}
@@ -3,13 +3,65 @@
 
 #pragma once
 #include <queue>
+#include <deque>
 #include <mutex>
 #include <condition_variable>
 #include <thread>
 #include <atomic>
 #include <functional>
+#include <vector>
+#include <algorithm>
+#include <memory>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <exception>
+
+#include "thread-policy.h"
 
 const int QUEUE_MAX_SIZE = 10;
+
+// Raises value to v unless it is already higher, for the highest of what several threads see
+inline void raise_to(std::atomic<int>& value, int v)
+{
+    auto current = value.load(std::memory_order_relaxed);
+    while (current < v && !value.compare_exchange_weak(current, v, std::memory_order_relaxed)) {}
+}
+
+// A consumer waiting on several queues at once, which every one of them signals as it receives an item
+class queue_waiter
+{
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    bool _signaled = false;
+
+public:
+    void signal()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _signaled = true;
+        _cv.notify_all();
+    }
+
+    // Waits for ready to hold, checking it again on every signal, up to the deadline
+    template<class Pred>
+    bool wait_until(std::chrono::steady_clock::time_point deadline, Pred ready)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (!ready())
+        {
+            if (_signaled)
+            {
+                _signaled = false;
+                continue;
+            }
+            if (_cv.wait_until(lock, deadline) == std::cv_status::timeout)
+                return ready();
+        }
+        return true;
+    }
+};
+
 // Simplest implementation of a blocking concurrent queue for thread messaging
 template<class T>
 class single_consumer_queue
@@ -138,30 +190,297 @@ public:
     }
 };
 
+// Bounded queue with the semantics of single_consumer_queue, whose producers and consumers claim the cells of a ring
+// with atomic operations instead of a lock. Every cell carries a sequence number telling whether it is free for the
+// producer of its position or full for the consumer of it. Threads only take the mutex to sleep, when the queue is
+// empty, or full for a blocking enqueue, and to wake the sleepers. It has no peek, as a cell may be reused once popped
+template<class T>
+class ring_queue
+{
+    struct cell
+    {
+        std::atomic<size_t> sequence;
+        T item;
+    };
+
+    const size_t _cap;
+    std::unique_ptr<cell[]> _cells;
+    std::atomic<size_t> _enqueue_pos;
+    std::atomic<size_t> _dequeue_pos;
+
+    std::atomic<bool> _accepting;
+    std::atomic<bool> _need_to_flush;
+
+    std::mutex _mutex;
+    std::condition_variable _deq_cv; // not empty signal
+    std::condition_variable _enq_cv; // not full signal
+    std::atomic<int> _waiting_consumers;
+    std::atomic<int> _waiting_producers;
+    std::vector<queue_waiter*> _waiters; // Counted among the waiting consumers, guarded by _mutex
+
+    bool try_push(T& item)
+    {
+        auto pos = _enqueue_pos.load(std::memory_order_relaxed);
+        while (true)
+        {
+            auto& c = _cells[pos % _cap];
+            auto diff = intptr_t(c.sequence.load(std::memory_order_acquire)) - intptr_t(pos);
+            if (diff == 0)
+            {
+                if (_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    c.item = std::move(item);
+                    c.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+                return false; // The cell still holds the item of the previous round, so the ring is full
+            else
+                pos = _enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+
+    bool try_pop(T& item)
+    {
+        auto pos = _dequeue_pos.load(std::memory_order_relaxed);
+        while (true)
+        {
+            auto& c = _cells[pos % _cap];
+            auto diff = intptr_t(c.sequence.load(std::memory_order_acquire)) - intptr_t(pos + 1);
+            if (diff == 0)
+            {
+                if (_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    item = std::move(c.item);
+                    c.item = T(); // Release what the moved-from item may still own
+                    c.sequence.store(pos + _cap, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+                return false; // The cell was not written yet, so the ring is empty
+            else
+                pos = _dequeue_pos.load(std::memory_order_relaxed);
+        }
+    }
+
+    bool empty() const
+    {
+        auto pos = _dequeue_pos.load(std::memory_order_relaxed);
+        return _cells[pos % _cap].sequence.load(std::memory_order_acquire) != pos + 1;
+    }
+
+    bool full() const
+    {
+        auto pos = _enqueue_pos.load(std::memory_order_relaxed);
+        return _cells[pos % _cap].sequence.load(std::memory_order_acquire) != pos;
+    }
+
+    void drain()
+    {
+        T item;
+        while (try_pop(item)) item = T();
+    }
+
+    // The fence pairs with that of wait(), so that either the waiter sees the change or we see the waiter
+    void notify(std::atomic<int>& waiting, std::condition_variable& cv)
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiting.load(std::memory_order_relaxed))
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            cv.notify_all();
+            if (&cv == &_deq_cv)
+                for (auto w : _waiters)
+                    w->signal();
+        }
+    }
+
+    template<class Pred>
+    bool wait(std::atomic<int>& waiting, std::condition_variable& cv, std::chrono::milliseconds timeout, Pred pred)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        waiting.fetch_add(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto ready = cv.wait_for(lock, timeout, pred);
+        waiting.fetch_sub(1);
+        return ready;
+    }
+
+public:
+    explicit ring_queue<T>(unsigned int cap = QUEUE_MAX_SIZE)
+        : _cap(std::max(cap, 1u)), _cells(new cell[_cap]), _enqueue_pos(0), _dequeue_pos(0),
+          _accepting(true), _need_to_flush(false), _waiting_consumers(0), _waiting_producers(0)
+    {
+        for (size_t i = 0; i < _cap; i++)
+            _cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    // Drops the oldest items to make room. Returns the number of items dropped, the new one included when the queue was cleared
+    size_t enqueue(T&& item)
+    {
+        if (!_accepting) return 1;
+
+        size_t dropped = 0;
+        while (!try_push(item))
+        {
+            T oldest;
+            if (try_pop(oldest)) dropped++;
+        }
+
+        // A clear() that ran during the push would not have seen the item
+        if (!_accepting) drain();
+        notify(_waiting_consumers, _deq_cv);
+        return dropped;
+    }
+
+    // Keeps the queued items, and rejects the new one when the queue is full or was cleared
+    bool try_enqueue(T&& item)
+    {
+        if (!_accepting || !try_push(item))
+            return false;
+
+        if (!_accepting) drain();
+        notify(_waiting_consumers, _deq_cv);
+        return true;
+    }
+
+    // Waits for room, and rejects the item when the queue stays full for the timeout or is cleared
+    bool blocking_enqueue(T&& item, std::chrono::milliseconds timeout = std::chrono::hours(999999))
+    {
+        using namespace std::chrono;
+
+        auto deadline = steady_clock::now() + timeout;
+        auto pushed = false;
+        while (_accepting && !(pushed = try_push(item)))
+        {
+            auto now = steady_clock::now();
+            if (now >= deadline)
+                break;
+
+            wait(_waiting_producers, _enq_cv, duration_cast<milliseconds>(deadline - now) + milliseconds(1),
+                [this]() { return !full() || !_accepting; });
+        }
+
+        if (!_accepting) drain();
+        if (pushed) notify(_waiting_consumers, _deq_cv);
+        return pushed && _accepting;
+    }
+
+    bool dequeue(T* item, unsigned int timeout_ms = 5000)
+    {
+        _accepting = true;
+        if (!try_pop(*item))
+        {
+            wait(_waiting_consumers, _deq_cv, std::chrono::milliseconds(timeout_ms),
+                [this]() { return !empty() || _need_to_flush; });
+            if (!try_pop(*item))
+                return false;
+        }
+        notify(_waiting_producers, _enq_cv);
+        return true;
+    }
+
+    bool try_dequeue(T* item)
+    {
+        _accepting = true;
+        if (!try_pop(*item))
+            return false;
+        notify(_waiting_producers, _enq_cv);
+        return true;
+    }
+
+    void clear()
+    {
+        _accepting = false;
+        _need_to_flush = true;
+        drain();
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _deq_cv.notify_all();
+        _enq_cv.notify_all();
+    }
+
+    void start()
+    {
+        _need_to_flush = false;
+        _accepting = true;
+    }
+
+    size_t capacity() const { return _cap; }
+
+    // Whether an item can be dequeued, for the waiters on several queues to tell which are ready
+    bool ready() const { return !empty(); }
+
+    // The waiter is signaled by every item enqueued from then on, and is seen as a waiting consumer by the producers
+    void add_waiter(queue_waiter* waiter)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _waiters.push_back(waiter);
+        _waiting_consumers.fetch_add(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    void remove_waiter(queue_waiter* waiter)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _waiters.erase(std::remove(_waiters.begin(), _waiters.end(), waiter), _waiters.end());
+        _waiting_consumers.fetch_sub(1);
+    }
+
+    size_t size() const
+    {
+        auto dequeued = _dequeue_pos.load(std::memory_order_acquire);
+        auto enqueued = _enqueue_pos.load(std::memory_order_acquire);
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+};
+
 template<class T>
 class single_consumer_frame_queue
 {
-    single_consumer_queue<T> _queue;
+    ring_queue<T> _queue;
+    std::atomic<int> _highest_priority;
+
+    // Frames below the highest priority the queue received are rejected once it is half full, the rest of it being left to the others
+    bool admits(const T& item)
+    {
+        auto priority = item.get_priority();
+        raise_to(_highest_priority, priority);
+        return priority >= _highest_priority.load(std::memory_order_relaxed) || _queue.size() < (_queue.capacity() + 1) / 2;
+    }
 
 public:
-    single_consumer_frame_queue<T>(unsigned int cap = QUEUE_MAX_SIZE) : _queue(cap) {}
+    single_consumer_frame_queue<T>(unsigned int cap = QUEUE_MAX_SIZE)
+        : _queue(cap), _highest_priority(std::numeric_limits<int>::min()) {}
 
-    void enqueue(T&& item)
+    // Drops the oldest frames to make room, unless the new frame is blocking and waits for room, or is of a lower priority than
+    // others and finds the queue half full. Returns the number of frames dropped
+    size_t enqueue(T&& item)
     {
         if (item.is_blocking())
-            _queue.blocking_enqueue(std::move(item));
-        else
-            _queue.enqueue(std::move(item));
+            return _queue.blocking_enqueue(std::move(item)) ? 0 : 1;
+        if (!admits(item))
+            return 1;
+        return _queue.enqueue(std::move(item));
     }
 
-    bool dequeue(T* item, unsigned int timeout_ms = 5000)
+    // Rejects the new frame when the queue is full, or half full for a frame of a lower priority than others
+    bool try_enqueue(T&& item)
     {
-        return _queue.dequeue(item, timeout_ms);
+        return admits(item) && _queue.try_enqueue(std::move(item));
     }
 
-    bool peek(T** item)
+    // Rejects the new frame when the queue stays full for the timeout
+    bool blocking_enqueue(T&& item, std::chrono::milliseconds timeout)
     {
-        return _queue.peek(item);
+        return _queue.blocking_enqueue(std::move(item), timeout);
+    }
+
+    bool dequeue(T* item, unsigned int timeout_ms = 5000)
+    {
+        return _queue.dequeue(item, timeout_ms);
     }
 
     bool try_dequeue(T* item)
@@ -188,6 +507,196 @@ public:
     {
         return _queue.size();
     }
+
+    bool ready() const { return _queue.ready(); }
+    void add_waiter(queue_waiter* waiter) { _queue.add_waiter(waiter); }
+    void remove_waiter(queue_waiter* waiter) { _queue.remove_waiter(waiter); }
+};
+
+// Waits for the first of the queues to have an item, with no polling, and returns its index, or -1 when none has one
+// within the timeout. The item is left in the queue, for its consumer to dequeue
+template<class Q>
+int wait_for_any(const std::vector<Q*>& queues, unsigned int timeout_ms)
+{
+    auto first_ready = [&]()
+    {
+        for (size_t i = 0; i < queues.size(); i++)
+            if (queues[i]->ready()) return static_cast<int>(i);
+        return -1;
+    };
+    auto index = first_ready();
+    if (index >= 0 || !timeout_ms || queues.empty())
+        return index;
+
+    queue_waiter waiter;
+    for (auto q : queues) q->add_waiter(&waiter);
+    waiter.wait_until(std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms),
+        [&]() { return (index = first_ready()) >= 0; });
+    for (auto q : queues) q->remove_waiter(&waiter);
+    return index;
+}
+
+// Work-stealing pool of worker threads that a context shares between its dispatchers.
+// Every worker runs the tasks of its own deque oldest first, and steals the newest tasks of the others once it runs dry.
+// Tasks submitted from a worker go to its own deque, other threads spread theirs round-robin
+class executor
+{
+public:
+    // As many workers as hardware threads for a count of 0
+    explicit executor(unsigned int count = 0)
+        : _pool(std::make_shared<pool>())
+    {
+        if (!count) count = std::max(std::thread::hardware_concurrency(), 1u);
+        for (unsigned int i = 0; i < count; i++)
+            _pool->workers.emplace_back(new worker());
+
+        auto p = _pool;
+        for (size_t i = 0; i < _pool->workers.size(); i++)
+            _pool->workers[i]->thread = std::thread([p, i]()
+            {
+                librealsense::apply_thread_policy(RS2_THREAD_ROLE_DISPATCH);
+                p->work(i);
+            });
+    }
+
+    void submit(std::function<void()> task)
+    {
+        _pool->submit(std::move(task));
+    }
+
+    // Whether the calling thread is one of the workers
+    bool is_worker() const { return pool::current_worker().first == _pool.get(); }
+
+    // Run one pending task on the calling thread, for a worker waiting on other tasks not to hold up the pool
+    bool try_run_one()
+    {
+        auto& current = pool::current_worker();
+        std::function<void()> task;
+        if (!_pool->try_take(current.first == _pool.get() ? current.second : 0, task))
+            return false;
+        pool::run(task);
+        return true;
+    }
+
+    size_t size() const { return _pool->workers.size(); }
+
+    // Runs the tasks still pending before joining. A worker that drops the last reference to the executor from
+    // within a task cannot join itself, and is detached to exit on its own once the task returns
+    ~executor()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_pool->mutex);
+            _pool->is_alive = false;
+        }
+        _pool->cv.notify_all();
+        for (auto&& w : _pool->workers)
+        {
+            if (w->thread.get_id() == std::this_thread::get_id())
+                w->thread.detach();
+            else
+                w->thread.join();
+        }
+    }
+
+private:
+    executor(const executor&) = delete;
+    executor& operator=(const executor&) = delete;
+
+    struct worker
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+        std::thread thread;
+    };
+
+    // Shared with the workers, which may outlive the executor as described above
+    struct pool
+    {
+        std::vector<std::unique_ptr<worker>> workers;
+        std::atomic<size_t> next{ 0 };
+        int pending = 0; // May dip below zero while a task is taken before its submit counted it
+        bool is_alive = true;
+        std::mutex mutex;
+        std::condition_variable cv;
+
+        static std::pair<const pool*, size_t>& current_worker()
+        {
+            static thread_local std::pair<const pool*, size_t> current(nullptr, 0);
+            return current;
+        }
+
+        static void run(std::function<void()>& task)
+        {
+            try
+            {
+                task();
+            }
+            catch (...) {}
+        }
+
+        void submit(std::function<void()> task)
+        {
+            auto& current = current_worker();
+            auto index = current.first == this ? current.second : next++ % workers.size();
+            {
+                std::lock_guard<std::mutex> lock(workers[index]->mutex);
+                workers[index]->tasks.push_back(std::move(task));
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                ++pending;
+            }
+            cv.notify_one();
+        }
+
+        bool try_take(size_t index, std::function<void()>& task)
+        {
+            for (size_t i = 0; i < workers.size(); i++)
+            {
+                auto& w = *workers[(index + i) % workers.size()];
+                std::lock_guard<std::mutex> lock(w.mutex);
+                if (w.tasks.empty())
+                    continue;
+
+                if (i == 0)
+                {
+                    task = std::move(w.tasks.front());
+                    w.tasks.pop_front();
+                }
+                else
+                {
+                    task = std::move(w.tasks.back());
+                    w.tasks.pop_back();
+                }
+
+                std::lock_guard<std::mutex> pending_lock(mutex);
+                --pending;
+                return true;
+            }
+            return false;
+        }
+
+        void work(size_t index)
+        {
+            current_worker() = std::make_pair(this, index);
+            while (true)
+            {
+                std::function<void()> task;
+                if (try_take(index, task))
+                {
+                    run(task);
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [this]() { return pending > 0 || !is_alive; });
+                if (pending <= 0 && !is_alive)
+                    return;
+            }
+        }
+    };
+
+    std::shared_ptr<pool> _pool;
 };
 
 class dispatcher
@@ -209,32 +718,40 @@ public:
             return !(_owner->_was_stopped_cv.wait_for(lock, milliseconds(ms), good));
         }
 
+        template<class Clock, class Duration>
+        bool try_sleep_until(const std::chrono::time_point<Clock, Duration>& deadline)
+        {
+            std::unique_lock<std::mutex> lock(_owner->_was_stopped_mutex);
+            auto good = [&]() { return _owner->_was_stopped.load(); };
+            return !(_owner->_was_stopped_cv.wait_until(lock, deadline, good));
+        }
+
     private:
         dispatcher* _owner;
     };
 
-    dispatcher(unsigned int cap)
+    // With an executor, the dispatcher is a strand of it rather than a thread of its own: its items still run one at a time
+    // and in order, by a task that the first item of an empty queue submits to the executor
+    dispatcher(unsigned int cap, std::shared_ptr<executor> exec = nullptr, rs2_thread_role role = RS2_THREAD_ROLE_DISPATCH)
         : _queue(cap),
+          _executor(std::move(exec)),
           _was_stopped(true),
           _was_flushed(false),
+          _is_scheduled(false),
           _is_alive(true)
     {
-        _thread = std::thread([&]()
+        if (_executor)
+            return;
+
+        _thread = std::thread([this, role]()
         {
+            librealsense::apply_thread_policy(role);
             while (_is_alive)
             {
                 std::function<void(cancellable_timer)> item;
 
                 if (_queue.dequeue(&item))
-                {
-                    cancellable_timer time(this);
-
-                    try
-                    {
-                        item(time);
-                    }
-                    catch(...){}
-                }
+                    run(item);
 
 #ifndef ANDROID
                 std::unique_lock<std::mutex> lock(_was_flushed_mutex);
@@ -257,6 +774,9 @@ public:
                 _queue.blocking_enqueue(std::move(item));
             else
                 _queue.enqueue(std::move(item));
+
+            if (_executor)
+                schedule();
         }
     }
 
@@ -268,6 +788,7 @@ public:
         _queue.start();
     }
 
+    // Called from an item of the dispatcher, stop() does not wait for that item to return, which it could only do forever
     void stop()
     {
         {
@@ -283,18 +804,34 @@ public:
             _was_flushed = false;
         }
 
-        std::unique_lock<std::mutex> lock_was_flushed(_was_flushed_mutex);
-        _was_flushed_cv.wait_for(lock_was_flushed, std::chrono::hours(999999), [&]() { return _was_flushed.load(); });
+        if (!is_running_item())
+        {
+            if (_executor)
+                wait_for_strand();
+            else
+            {
+                std::unique_lock<std::mutex> lock_was_flushed(_was_flushed_mutex);
+                _was_flushed_cv.wait_for(lock_was_flushed, std::chrono::hours(999999), [&]() { return _was_flushed.load(); });
+            }
+        }
 
         _queue.start();
     }
 
+    // An item may not destroy its own dispatcher, which the item returning would then use, and doing so terminates at once
+    // rather than hang or corrupt the memory
     ~dispatcher()
     {
+        if (is_running_item())
+            std::terminate();
+
         stop();
         _queue.clear();
         _is_alive = false;
-        _thread.join();
+        if (_executor)
+            wait_for_strand();
+        else
+            _thread.join();
     }
 
     bool flush()
@@ -327,7 +864,79 @@ public:
 
 private:
     friend cancellable_timer;
-    single_consumer_queue<std::function<void(cancellable_timer)>> _queue;
+
+    // Items a strand runs before handing its worker to the other tasks of the executor
+    static const int strand_batch = 16;
+
+    // The dispatcher whose item the calling thread runs, if any
+    static const dispatcher*& current_dispatcher()
+    {
+        static thread_local const dispatcher* current = nullptr;
+        return current;
+    }
+
+    bool is_running_item() const { return current_dispatcher() == this; }
+
+    void run(std::function<void(cancellable_timer)>& item)
+    {
+        cancellable_timer time(this);
+        auto previous = current_dispatcher();
+        current_dispatcher() = this;
+
+        try
+        {
+            item(time);
+        }
+        catch(...){}
+        current_dispatcher() = previous;
+    }
+
+    void schedule()
+    {
+        if (!_is_scheduled.exchange(true))
+            _executor->submit([this]() { drain(); });
+    }
+
+    void drain()
+    {
+        std::function<void(cancellable_timer)> item;
+        for (int i = 0; i < strand_batch && _queue.try_dequeue(&item); i++)
+        {
+            run(item);
+            item = nullptr;
+        }
+
+        // The exchange pairs with that of schedule(), for an item enqueued meanwhile to be seen here or to schedule a new drain.
+        // Nothing of the dispatcher is touched once the lock is released, as stop() and the destructor may then return
+        std::lock_guard<std::mutex> lock(_was_flushed_mutex);
+        _is_scheduled.exchange(false);
+        if (_is_alive && _queue.size() > 0)
+            schedule();
+        _was_flushed = true;
+        _was_flushed_cv.notify_all();
+    }
+
+    // Wait for the running drain to return. A worker keeps running the other tasks meanwhile, as the drain may sit behind them
+    void wait_for_strand()
+    {
+        std::unique_lock<std::mutex> lock(_was_flushed_mutex);
+        if (!_executor->is_worker())
+        {
+            _was_flushed_cv.wait(lock, [&]() { return !_is_scheduled.load(); });
+            return;
+        }
+
+        while (_is_scheduled)
+        {
+            lock.unlock();
+            if (!_executor->try_run_one())
+                std::this_thread::yield();
+            lock.lock();
+        }
+    }
+
+    ring_queue<std::function<void(cancellable_timer)>> _queue;
+    std::shared_ptr<executor> _executor;
     std::thread _thread;
 
     std::atomic<bool> _was_stopped;
@@ -338,15 +947,119 @@ private:
     std::condition_variable _was_flushed_cv;
     std::mutex _was_flushed_mutex;
 
+    std::atomic<bool> _is_scheduled;
     std::atomic<bool> _is_alive;
 };
 
+// Fixed set of worker threads sharing a batch of indexed tasks with the calling thread.
+// run() returns only once every task has completed, so tasks may freely borrow the caller's buffers
+class parallel_workers
+{
+public:
+    explicit parallel_workers(unsigned int count)
+        : _task(nullptr), _next(0), _tasks(0), _pending(0), _is_alive(true)
+    {
+        for (unsigned int i = 0; i < count; i++)
+            _threads.emplace_back([this]()
+            {
+                librealsense::apply_thread_policy(RS2_THREAD_ROLE_PROCESSING);
+                work();
+            });
+    }
+
+    // Execute task(0) ... task(count - 1), blocking until all of them returned. Not reentrant
+    void run(int count, const std::function<void(int)>& task)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _task = &task;
+        _next = 0;
+        _tasks = count;
+        _pending = count;
+        _work_cv.notify_all();
+
+        while (_next < _tasks)
+        {
+            auto i = _next++;
+            lock.unlock();
+            invoke(task, i);
+            lock.lock();
+            --_pending;
+        }
+
+        _done_cv.wait(lock, [&]() { return _pending == 0; });
+        _task = nullptr;
+    }
+
+    // Split [0, count) into one band per thread, in multiples of alignment (a power of two), and run task(begin, end) on each
+    void run_bands(size_t count, size_t alignment, const std::function<void(size_t, size_t)>& task)
+    {
+        if (!count)
+            return;
+
+        auto bands = size() + 1;
+        auto band = ((count + bands - 1) / bands + alignment - 1) & ~(alignment - 1);
+        run(int((count + band - 1) / band), [&](int i)
+        {
+            task(i * band, std::min(count, (i + 1) * band));
+        });
+    }
+
+    size_t size() const { return _threads.size(); }
+
+    ~parallel_workers()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _is_alive = false;
+        }
+        _work_cv.notify_all();
+        for (auto&& t : _threads) t.join();
+    }
+
+private:
+    static void invoke(const std::function<void(int)>& task, int i)
+    {
+        try
+        {
+            task(i);
+        }
+        catch (...) {}
+    }
+
+    void work()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (true)
+        {
+            _work_cv.wait(lock, [&]() { return !_is_alive || (_task && _next < _tasks); });
+            if (!_is_alive) return;
+
+            auto i = _next++;
+            auto task = _task;
+            lock.unlock();
+            invoke(*task, i);
+            lock.lock();
+            if (--_pending == 0) _done_cv.notify_all();
+        }
+    }
+
+    std::vector<std::thread> _threads;
+    std::mutex _mutex;
+    std::condition_variable _work_cv;
+    std::condition_variable _done_cv;
+    const std::function<void(int)>* _task;
+    int _next;
+    int _tasks;
+    int _pending;
+    bool _is_alive;
+};
+
 template<class T = std::function<void(dispatcher::cancellable_timer)>>
 class active_object
 {
 public:
-    active_object(T operation)
-        : _operation(std::move(operation)), _dispatcher(1), _stopped(true)
+    active_object(T operation, rs2_thread_role role = RS2_THREAD_ROLE_DISPATCH)
+        : _operation(std::move(operation)), _dispatcher(1, nullptr, role), _stopped(true)
     {
     }
 
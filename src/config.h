@@ -236,6 +236,12 @@ namespace librealsense
                 {
                     return _dev_to_profiles;
                 }
+
+                // Of the profiles, by their index in the device
+                const std::map<int, sensor_interface*>& get_sensors() const
+                {
+                    return _results;
+                }
             private:
                 friend class config;
 
@@ -377,6 +383,36 @@ namespace librealsense
                 return multistream(std::move(sensors_map), std::move(stream_to_profile), std::move(dev_to_profiles));
             }
 
+            // Rebuilds the streams a previous resolve selected, from the profiles of the sensors that match them exactly
+            static multistream resolve(device_interface* dev, const std::vector<std::pair<int, stream_profile>>& selection)
+            {
+                std::map<int, stream_profiles> dev_to_profiles;
+                std::map<index_type, std::shared_ptr<stream_profile_interface>> stream_to_profile;
+                std::map<int, sensor_interface*> sensors_map;
+
+                for (auto&& s : selection)
+                {
+                    if (s.first < 0 || s.first >= static_cast<int>(dev->get_sensors_count()))
+                        throw std::runtime_error("Failed to resolve request. Invalid sensor index");
+
+                    auto&& sensor = dev->get_sensor(s.first);
+                    auto profiles = sensor.get_stream_profiles();
+                    auto it = std::find_if(begin(profiles), end(profiles), [&s](const std::shared_ptr<stream_profile_interface>& profile)
+                    {
+                        auto p = to_profile(profile.get());
+                        return p.stream == s.second.stream && p == s.second;
+                    });
+                    if (it == end(profiles))
+                        throw std::runtime_error("Failed to resolve request. The sensor has no such profile");
+
+                    sensors_map[s.first] = &sensor;
+                    dev_to_profiles[s.first].push_back(*it);
+                    stream_to_profile[{ (*it)->get_stream_type(), (*it)->get_stream_index() }] = *it;
+                }
+
+                return multistream(std::move(sensors_map), std::move(stream_to_profile), std::move(dev_to_profiles));
+            }
+
         private:
             static bool sort_highest_framerate(const std::shared_ptr<stream_profile_interface> lhs, const std::shared_ptr<stream_profile_interface> rhs) {
                 return lhs->get_framerate() < rhs->get_framerate();
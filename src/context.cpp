@@ -8,6 +8,7 @@
 
 #include <array>
 #include <chrono>
+#include <thread>
 #include "l500/l500.h"
 #include "ivcam/sr300.h"
 #include "ds5/ds5-factory.h"
@@ -15,6 +16,10 @@
 #include "backend.h"
 #include "mock/recorder.h"
 #include <media/ros/ros_reader.h>
+#include <media/capture/capture_reader.h>
+#include <media/playback/merged_reader.h>
+#include "net/net-device.h"
+#include "shm/shm-device.h"
 #include "types.h"
 #include "stream.h"
 #include "environment.h"
@@ -98,6 +103,7 @@ namespace librealsense
         : _devices_changed_callback(nullptr, [](rs2_devices_changed_callback*){})
     {
         LOG_DEBUG("Librealsense " << std::string(std::begin(rs2_api_version),std::end(rs2_api_version)));
+        LOG_INFO("Pixel unpackers use " << get_string(get_simd_level()) << " instructions");
 
         switch(type)
         {
@@ -304,15 +310,68 @@ namespace librealsense
 
     context::~context()
     {
-        _device_watcher->stop(); //ensure that the device watcher will stop before the _devices_changed_callback will be deleted
+        stop(); //ensure that the device watcher will stop before the _devices_changed_callback will be deleted
     }
 
     std::vector<std::shared_ptr<device_info>> context::query_devices(int mask) const
     {
+        return create_devices(query_device_data(mask), _playback_devices, mask);
+    }
+
+    platform::backend_device_group context::query_device_data(int mask) const
+    {
+        {
+            std::lock_guard<std::mutex> lock(_devices_data_mutex);
+            if (_is_devices_data_cached)
+                return _devices_data;
+        }
 
+        if (mask & RS2_PRODUCT_LINE_FAST_ENUMERATE)
+            return platform::backend_device_group(_backend->query_uvc_devices(), {}, {});
+
+        // The first full enumeration lets the watcher keep the devices up to date from then on
         platform::backend_device_group devices(_backend->query_uvc_devices(), _backend->query_usb_devices(), _backend->query_hid_devices());
+        start_device_watcher(devices, false);
+        return devices;
+    }
+
+    // Unless required, watchers that cannot keep the devices up to date are not started
+    bool context::start_device_watcher(const platform::backend_device_group& devices, bool required) const
+    {
+        std::lock_guard<std::mutex> lock(_watcher_mutex);
+        uint64_t generation = 0;
+        {
+            std::lock_guard<std::mutex> data_lock(_devices_data_mutex);
+            if (_is_devices_data_cached && !required)
+                return true;
+
+            // The callbacks of the previous watcher, still running until the new one starts, are not applied
+            generation = ++_devices_data_generation;
+            _devices_data = devices;
+            _is_devices_data_cached = true;
+        }
+
+        auto t = const_cast<context*>(this);
+        auto callback = [t, generation](platform::backend_device_group old, platform::backend_device_group curr)
+        {
+            {
+                std::lock_guard<std::mutex> lock(t->_devices_data_mutex);
+                if (t->_is_devices_data_cached && t->_devices_data_generation == generation)
+                    t->_devices_data = curr;
+            }
+            t->on_device_changed(old, curr, t->_playback_devices, t->_playback_devices);
+        };
 
-        return create_devices(devices, _playback_devices, mask);
+        if (_device_watcher->start_from(devices, callback))
+            return true;
+
+        {
+            std::lock_guard<std::mutex> data_lock(_devices_data_mutex);
+            _is_devices_data_cached = false;
+        }
+        if (required)
+            _device_watcher->start(callback);
+        return false;
     }
 
     std::vector<std::shared_ptr<device_info>> context::create_devices(platform::backend_device_group devices,
@@ -364,6 +423,35 @@ namespace librealsense
     }
 
 
+    std::vector<std::shared_ptr<device_interface>> context::create_devices_concurrently(const std::vector<std::shared_ptr<device_info>>& infos) const
+    {
+        std::vector<std::shared_ptr<device_interface>> devices(infos.size());
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < infos.size(); i++)
+        {
+            threads.emplace_back([&infos, &devices, i]()
+            {
+                try
+                {
+                    devices[i] = infos[i]->create_device();
+                }
+                catch (const std::exception& ex)
+                {
+                    LOG_WARNING("Could not create device " << i << ": " << ex.what());
+                }
+                catch (...)
+                {
+                    LOG_WARNING("Could not create device " << i);
+                }
+            });
+        }
+
+        for (auto& thread : threads)
+            thread.join();
+
+        return devices;
+    }
+
     void context::on_device_changed(platform::backend_device_group old,
                                     platform::backend_device_group curr,
                                     const std::map<std::string, std::weak_ptr<device_info>>& old_playback_devices,
@@ -440,13 +528,10 @@ namespace librealsense
 
     void context::set_devices_changed_callback(devices_changed_callback_ptr callback)
     {
-        _device_watcher->stop();
+        stop();
 
         _devices_changed_callback = std::move(callback);
-        _device_watcher->start([this](platform::backend_device_group old, platform::backend_device_group curr)
-        {
-            on_device_changed(old, curr, _playback_devices, _playback_devices);
-        });
+        start_device_watcher({ _backend->query_uvc_devices(), _backend->query_usb_devices(), _backend->query_hid_devices() }, true);
     }
 
     void context::unregister_internal_device_callback(uint64_t cb_id)
@@ -505,7 +590,7 @@ namespace librealsense
             //Already exists
             throw librealsense::invalid_value_exception(to_string() << "File \"" << file << "\" already loaded to context");
         }
-        auto playback_dev = std::make_shared<playback_device>(shared_from_this(), std::make_shared<ros_reader>(file, shared_from_this()));
+        auto playback_dev = std::make_shared<playback_device>(shared_from_this(), create_reader(file));
         auto dinfo = std::make_shared<playback_device_info>(playback_dev);
         auto prev_playback_devices = _playback_devices;
         _playback_devices[file] = dinfo;
@@ -513,6 +598,65 @@ namespace librealsense
         return playback_dev;
     }
 
+    std::shared_ptr<device_serializer::reader> context::create_reader(const std::string& file)
+    {
+        if (capture::is_capture_file(file))
+            return std::make_shared<capture_reader>(file);
+        return std::make_shared<ros_reader>(file, shared_from_this());
+    }
+
+    std::shared_ptr<device_interface> context::add_merged_device(const std::vector<std::string>& files)
+    {
+        auto name = merged_reader::merged_name(files);
+        auto it = _playback_devices.find(name);
+        if (it != _playback_devices.end() && it->second.lock())
+        {
+            //Already exists
+            throw librealsense::invalid_value_exception(to_string() << "Files \"" << name << "\" already loaded to context");
+        }
+        std::vector<std::shared_ptr<device_serializer::reader>> readers;
+        for (auto&& file : files)
+            readers.push_back(create_reader(file));
+        auto playback_dev = std::make_shared<playback_device>(shared_from_this(), std::make_shared<merged_reader>(readers));
+        auto dinfo = std::make_shared<playback_device_info>(playback_dev);
+        auto prev_playback_devices = _playback_devices;
+        _playback_devices[name] = dinfo;
+        on_device_changed({}, {}, prev_playback_devices, _playback_devices);
+        return playback_dev;
+    }
+
+    std::shared_ptr<device_interface> context::add_network_device(const std::string& address)
+    {
+        auto it = _playback_devices.find(address);
+        if (it != _playback_devices.end() && it->second.lock())
+        {
+            //Already exists
+            throw librealsense::invalid_value_exception(to_string() << "Network device \"" << address << "\" already added to context");
+        }
+        auto net_dev = std::make_shared<net_device>(shared_from_this(), address);
+        auto dinfo = std::make_shared<net_device_info>(net_dev);
+        auto prev_playback_devices = _playback_devices;
+        _playback_devices[address] = dinfo;
+        on_device_changed({}, {}, prev_playback_devices, _playback_devices);
+        return net_dev;
+    }
+
+    std::shared_ptr<device_interface> context::add_shm_device(const std::string& name)
+    {
+        auto it = _playback_devices.find(name);
+        if (it != _playback_devices.end() && it->second.lock())
+        {
+            //Already exists
+            throw librealsense::invalid_value_exception(to_string() << "Shared memory device \"" << name << "\" already added to context");
+        }
+        auto shm_dev = std::make_shared<shm_device>(shared_from_this(), name);
+        auto dinfo = std::make_shared<shm_device_info>(shm_dev);
+        auto prev_playback_devices = _playback_devices;
+        _playback_devices[name] = dinfo;
+        on_device_changed({}, {}, prev_playback_devices, _playback_devices);
+        return shm_dev;
+    }
+
     void context::remove_device(const std::string& file)
     {
         auto it = _playback_devices.find(file);
@@ -24,6 +24,7 @@ struct rs2_device_info
 {
     std::shared_ptr<librealsense::context> ctx;
     std::shared_ptr<librealsense::device_info> info;
+    mutable std::shared_ptr<librealsense::device_interface> device; // Created along with the list, for its first rs2_create_device
 };
 
 struct rs2_device_list
@@ -42,6 +43,7 @@ namespace librealsense
 {
     class device;
     class context;
+    struct frame_allocator;
 
     class device_info
     {
@@ -115,7 +117,13 @@ namespace librealsense
             rs2_recording_mode mode = RS2_RECORDING_MODE_COUNT,
             std::string min_api_version = "0.0.0");
 
-        void stop(){_device_watcher->stop();}
+        void stop()
+        {
+            std::lock_guard<std::mutex> lock(_watcher_mutex);
+            _device_watcher->stop();
+            std::lock_guard<std::mutex> data_lock(_devices_data_mutex);
+            _is_devices_data_cached = false;
+        }
         ~context();
         std::vector<std::shared_ptr<device_info>> query_devices(int mask) const;
         const platform::backend& get_backend() const { return *_backend; }
@@ -127,19 +135,45 @@ namespace librealsense
         std::vector<std::shared_ptr<device_info>> create_devices(platform::backend_device_group devices, 
             const std::map<std::string, std::weak_ptr<device_info>>& playback_devices, int mask) const;
 
+        // Creates the devices on a thread each, for their hardware monitor round-trips to overlap. nullptr for the devices that failed
+        std::vector<std::shared_ptr<device_interface>> create_devices_concurrently(const std::vector<std::shared_ptr<device_info>>& infos) const;
+
 
 
         std::shared_ptr<device_interface> add_device(const std::string& file);
+        // Device playing the files of the devices of a recording together, removed with remove_device and the name of its
+        // merged files, see merged_reader
+        std::shared_ptr<device_interface> add_merged_device(const std::vector<std::string>& files);
+        // Device streaming from a net_server, removed with remove_device and its address
+        std::shared_ptr<device_interface> add_network_device(const std::string& address);
+        // Device receiving the frames a shm_publisher of another process publishes, removed with remove_device and its name
+        std::shared_ptr<device_interface> add_shm_device(const std::string& name);
         void remove_device(const std::string& file);
 
+        // Default frame data storage for the sensors of the devices created by the context
+        void set_frame_allocator(std::shared_ptr<const frame_allocator> allocator) { std::atomic_store(&_frame_allocator, std::move(allocator)); }
+        std::shared_ptr<const frame_allocator> get_frame_allocator() const { return std::atomic_load(&_frame_allocator); }
+
+        // Worker threads shared by the dispatchers created afterwards, nullptr for a thread per dispatcher
+        void set_executor(std::shared_ptr<executor> exec) { std::atomic_store(&_executor, std::move(exec)); }
+        std::shared_ptr<executor> get_executor() const { return std::atomic_load(&_executor); }
+
+        // Whether the sensors of the devices created by the context size their frame pools as they open, and count or refuse
+        // the frame allocations the pools do not cover afterwards
+        void set_preallocation(preallocation_mode mode) { _preallocation = mode; }
+        preallocation_mode get_preallocation() const { return _preallocation; }
+
     private:
         void on_device_changed(platform::backend_device_group old,
                                platform::backend_device_group curr,
                                const std::map<std::string, std::weak_ptr<device_info>>& old_playback_devices,
                                const std::map<std::string, std::weak_ptr<device_info>>& new_playback_devices);
         void raise_devices_changed(const std::vector<rs2_device_info>& removed, const std::vector<rs2_device_info>& added);
+        platform::backend_device_group query_device_data(int mask) const;
+        bool start_device_watcher(const platform::backend_device_group& devices, bool required) const;
         int find_stream_profile(const stream_interface& p);
         std::shared_ptr<lazy<rs2_extrinsics>> fetch_edge(int from, int to);
+        std::shared_ptr<device_serializer::reader> create_reader(const std::string& file);
 
         std::shared_ptr<platform::backend> _backend;
 #if WITH_TRACKING
@@ -153,7 +187,16 @@ namespace librealsense
         devices_changed_callback_ptr _devices_changed_callback;
         std::map<int, std::weak_ptr<const stream_interface>> _streams;
         std::map<int, std::map<int, std::weak_ptr<lazy<rs2_extrinsics>>>> _extrinsics;
+        std::shared_ptr<const frame_allocator> _frame_allocator;
+        std::shared_ptr<executor> _executor;
+        std::atomic<preallocation_mode> _preallocation{ preallocation_mode::off };
         std::mutex _streams_mutex, _devices_changed_callbacks_mtx;
+
+        // Devices kept up to date by the watcher, once it started from them, for the queries not to enumerate them again
+        mutable std::mutex _watcher_mutex, _devices_data_mutex;
+        mutable platform::backend_device_group _devices_data;
+        mutable bool _is_devices_data_cached = false;
+        mutable uint64_t _devices_data_generation = 0;
     };
 
     class readonly_device_info : public device_info
@@ -206,17 +206,43 @@ namespace librealsense
         preset get_all() const;
         void set_all(const preset& p);
 
+        // The register tables of the device as last read, valid until another command reaches the device.
+        // Called within a batch of the monitor, which holds back the commands of the other threads
+        bool load_tables(preset& p) const;
+        void store_tables(const preset& p) const;
+
+        mutable preset _tables;
+        mutable bool _are_tables_known = false;
+        mutable uint64_t _tables_generation = 0;
+
         std::vector<uint8_t> send_receive(const std::vector<uint8_t>& input) const;
 
         template<class T>
         void set(const T& strct, EtAdvancedModeRegGroup cmd) const
+        {
+            write(strct, cmd);
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+
+        template<class T>
+        void write(const T& strct, EtAdvancedModeRegGroup cmd) const
         {
             auto ptr = (uint8_t*)(&strct);
             std::vector<uint8_t> data(ptr, ptr + sizeof(T));
 
             assert_no_error(ds::fw_cmd::SET_ADV,
                 send_receive(encode_command(ds::fw_cmd::SET_ADV, static_cast<uint32_t>(cmd), 0, 0, 0, data)));
-            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+
+        // Writes the table unless the device is known to have it already, without waiting for the firmware to apply it
+        template<class T>
+        bool write_if_changed(const T& strct, const T& current, bool is_current_known, EtAdvancedModeRegGroup cmd) const
+        {
+            if (is_current_known && !memcmp(&strct, &current, sizeof(T)))
+                return false;
+
+            write(strct, cmd);
+            return true;
         }
 
         template<class T>
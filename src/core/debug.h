@@ -5,6 +5,7 @@
 #include "streaming.h"
 #include "extension.h"
 #include <vector>
+#include <future>
 
 namespace librealsense
 {
@@ -12,6 +13,27 @@ namespace librealsense
     {
     public:
         virtual std::vector<uint8_t> send_receive_raw_data(const std::vector<uint8_t>& input) = 0;
+
+        // Of every input in order, the future of its response. The devices of a hardware monitor queue them all for its
+        // thread, to be sent back-to-back within one power up, while by default each is sent in turn before returning
+        virtual std::vector<std::future<std::vector<uint8_t>>> send_receive_raw_data_async(const std::vector<std::vector<uint8_t>>& inputs)
+        {
+            std::vector<std::future<std::vector<uint8_t>>> results;
+            for (auto&& input : inputs)
+            {
+                std::promise<std::vector<uint8_t>> result;
+                try
+                {
+                    result.set_value(send_receive_raw_data(input));
+                }
+                catch (...)
+                {
+                    result.set_exception(std::current_exception());
+                }
+                results.push_back(result.get_future());
+            }
+            return results;
+        }
     };
 
     MAP_EXTENSION(RS2_EXTENSION_DEBUG, librealsense::debug_interface);
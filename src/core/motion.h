@@ -23,6 +23,28 @@ namespace librealsense
 
     MAP_EXTENSION(RS2_EXTENSION_POSE_PROFILE, librealsense::pose_stream_profile_interface);
 
+    // Sensors keeping the latest samples of their motion streams, for the query of a time range of them
+    class motion_history_interface
+    {
+    public:
+        // Copies up to count samples of the stream captured between begin and end, inclusive, oldest first. Returns how many were copied
+        virtual int get_motion_history(rs2_stream stream, int index, double begin, double end, double* timestamps, rs2_vector* motion, int count) const = 0;
+        virtual ~motion_history_interface() = default;
+    };
+
+    MAP_EXTENSION(RS2_EXTENSION_MOTION_HISTORY, librealsense::motion_history_interface);
+
+    // Sensors keeping the latest pose of their pose streams, as soon as it is received and ahead of the frames
+    class pose_prediction_interface
+    {
+    public:
+        // False while the stream sent no pose
+        virtual bool get_latest_pose(int index, double& timestamp, rs2_pose& pose) const = 0;
+        virtual ~pose_prediction_interface() = default;
+    };
+
+    MAP_EXTENSION(RS2_EXTENSION_POSE_PREDICTION, librealsense::pose_prediction_interface);
+
     class tm2_extensions
     {
     public:
@@ -27,6 +27,8 @@ namespace librealsense
         virtual bool is_read_only() const { return false; }
         virtual const char* get_description() const = 0;
         virtual const char* get_value_description(float) const { return nullptr; }
+        // The value of the option when the sensor has it cached, known without a query of the camera
+        virtual bool try_get_cached(float& value) const { return false; }
         virtual void create_snapshot(std::shared_ptr<option>& snapshot) const override;
 
         virtual ~option() = default;
@@ -40,6 +42,55 @@ namespace librealsense
         virtual const option& get_option(rs2_option id) const = 0;
         virtual bool supports_option(rs2_option id) const = 0;
 
+        // Of many options in a single call, every item failing on its own. applied, when given, receives 1 for the items set or
+        // queried and 0 for the others, whose errors are logged. The values an option has cached are not written again.
+        // Returns the number of items applied
+        virtual int set_options(const rs2_option* ids, const float* values, int count, int* applied)
+        {
+            auto res = 0;
+            for (auto i = 0; i < count; i++)
+            {
+                auto ok = 0;
+                try
+                {
+                    auto& opt = get_option(ids[i]);
+                    float cached;
+                    if (!opt.try_get_cached(cached) || cached != values[i])
+                        opt.set(values[i]);
+                    ok = 1;
+                }
+                catch (const std::exception& e)
+                {
+                    LOG_WARNING("Option " << get_string(ids[i]) << " was not set to " << values[i] << ": " << e.what());
+                }
+                if (applied) applied[i] = ok;
+                res += ok;
+            }
+            return res;
+        }
+
+        virtual int get_options(const rs2_option* ids, float* values, int count, int* applied) const
+        {
+            auto res = 0;
+            for (auto i = 0; i < count; i++)
+            {
+                auto ok = 0;
+                try
+                {
+                    values[i] = get_option(ids[i]).query();
+                    ok = 1;
+                }
+                catch (const std::exception& e)
+                {
+                    values[i] = 0.f;
+                    LOG_WARNING("Option " << get_string(ids[i]) << " was not queried: " << e.what());
+                }
+                if (applied) applied[i] = ok;
+                res += ok;
+            }
+            return res;
+        }
+
         virtual ~options_interface() = default;
     };
 
@@ -32,6 +32,8 @@ namespace librealsense
         virtual frame_interface* allocate_composite_frame(std::vector<frame_holder> frames) = 0;
 
         virtual frame_interface* allocate_points(std::shared_ptr<stream_profile_interface> stream, frame_interface* original) = 0;
+        virtual frame_interface* allocate_points(std::shared_ptr<stream_profile_interface> stream, frame_interface* original, size_t count, bool pixel_indices, bool normals, bool colors,
+            bool texture_coordinates) = 0;
 
         virtual void frame_ready(frame_holder result) = 0;
         virtual rs2_source* get_c_wrapper() = 0;
@@ -321,15 +321,31 @@ namespace librealsense
             status_file_eof = -404,             /**< EOF */
         };
 
+        // Data of a frame compressed ahead of its write
+        struct compressed_payload
+        {
+            rs2_record_compression compression = RS2_RECORD_COMPRESSION_NONE;
+            std::string codec; // Name of the codec of the application that encoded the data, if any
+            std::vector<uint8_t> data;
+        };
+
         class writer
         {
         public:
             virtual void write_device_description(const device_snapshot& device_description) = 0;
             virtual void write_frame(const stream_identifier& stream_id, const nanoseconds& timestamp, frame_holder&& frame) = 0;
+            // Safe to call concurrently with the other functions, for the caller to compress frames on threads of its own.
+            // The payload is left with RS2_RECORD_COMPRESSION_NONE for the frames written as they are
+            virtual compressed_payload compress_frame(const frame_interface& frame, rs2_record_compression compression) const = 0;
+            // As compress_frame, with a codec of the application. The payload is left empty for the frames the codec does not encode
+            virtual compressed_payload encode_frame(const frame_interface& frame, rs2_frame_codec& codec) const = 0;
+            virtual void write_compressed_frame(const stream_identifier& stream_id, const nanoseconds& timestamp, frame_holder&& frame, compressed_payload&& payload) = 0;
             virtual void write_snapshot(uint32_t device_index, const nanoseconds& timestamp, rs2_extension type, const std::shared_ptr<extension_snapshot>& snapshot) = 0;
             virtual void write_snapshot(const sensor_identifier& sensor_id, const nanoseconds& timestamp, rs2_extension type, const std::shared_ptr<extension_snapshot>& snapshot) = 0;
             virtual void write_notification(const sensor_identifier& stream_id, const nanoseconds& timestamp, const notification& n) = 0;
             virtual const std::string& get_file_name() const = 0;
+            // Bytes written to the file so far, a lower bound of its size
+            virtual uint64_t get_written_size() const = 0;
             virtual ~writer() = default;
         };
 
@@ -346,6 +362,10 @@ namespace librealsense
             virtual void disable_stream(const std::vector<device_serializer::stream_identifier>& stream_ids) = 0;
             virtual const std::string& get_file_name() const = 0;
             virtual std::vector<std::shared_ptr<serialized_data>> fetch_last_frames(const nanoseconds& seek_time) = 0;
+            // Codecs of the application decoding the frames recorded with codecs of the same name
+            virtual void register_codec(frame_codec_ptr codec) = 0;
+            // Reads the file through a memory mapping rather than system calls, returning false when it cannot be mapped
+            virtual bool set_mapped_read(bool mapped) = 0;
         };
     }
 }
@@ -78,11 +78,23 @@ namespace librealsense
         virtual void set_c_wrapper(rs2_stream_profile* wrapper) = 0;
     };
 
+    // Points the frames go through on their way to the application, stamped with platform::monotonic_time()
+    enum class frame_stage
+    {
+        dequeue,    // Taken from the driver by the backend
+        unpack,     // Unpacked into the format of its profile
+        sync,       // Matched into a frameset by a syncer
+        callback,   // Handed to a callback, the last one for frames handed to several
+        count
+    };
+
     class frame_interface : public sensor_part
     {
     public:
         virtual rs2_metadata_type get_frame_metadata(const rs2_frame_metadata_value& frame_metadata) const = 0;
         virtual bool supports_frame_metadata(const rs2_frame_metadata_value& frame_metadata) const = 0;
+        // Of every attribute below count, indexed by attribute. Returns the number of attributes supported
+        virtual int get_all_frame_metadata(rs2_metadata_type* values, int* supported, int count) const = 0;
         virtual const byte* get_frame_data() const = 0;
         //TODO: add virtual uint64_t get_frame_data_size() const = 0;
         virtual rs2_time_t get_frame_timestamp() const = 0;
@@ -92,14 +104,20 @@ namespace librealsense
 
         virtual void set_timestamp_domain(rs2_timestamp_domain timestamp_domain) = 0;
         virtual rs2_time_t get_frame_system_time() const = 0;
-        virtual std::shared_ptr<stream_profile_interface> get_stream() const = 0;
+        // Borrowed for as long as the frame is held, copy it to keep the profile any longer
+        virtual const std::shared_ptr<stream_profile_interface>& get_stream() const = 0;
         virtual void set_stream(std::shared_ptr<stream_profile_interface> sp) = 0;
 
         virtual rs2_time_t get_frame_callback_start_time_point() const = 0;
         virtual void update_frame_callback_start_ts(rs2_time_t ts) = 0;
 
+        // Zero for the stages the frame did not go through
+        virtual rs2_time_t get_stage_time(frame_stage stage) const = 0;
+        virtual void set_stage_time(frame_stage stage, rs2_time_t time) = 0;
+
         virtual void acquire() = 0;
         virtual void release() = 0;
+        // Takes the owner over, moved down the overrides for a single reference count per published frame
         virtual frame_interface* publish(std::shared_ptr<archive_interface> new_owner) = 0;
         virtual void attach_continuation(frame_continuation&& continuation) = 0;
         virtual void disable_continuation() = 0;
@@ -113,6 +131,9 @@ namespace librealsense
         virtual bool is_fixed() const = 0;
         virtual void set_blocking(bool state) = 0;
         virtual bool is_blocking() const = 0;
+        // Of the stream of the frame, higher priorities are dropped last when frames compete for room
+        virtual void set_priority(int priority) = 0;
+        virtual int get_priority() const = 0;
 
         virtual void keep() = 0;
 
@@ -153,6 +174,7 @@ namespace librealsense
         frame_holder clone() const;
 
         bool is_blocking() const { return frame->is_blocking(); };
+        int get_priority() const { return frame->get_priority(); };
 
     private:
         frame_holder& operator=(const frame_holder& other) = delete;
@@ -0,0 +1,254 @@
+#ifdef RS2_USE_CUDA
+
+#include "cuda-align.cuh"
+#include <new>
+#include <stdexcept>
+#include <string>
+
+// Marks the pixels of the other image that no depth pixel was projected onto
+#define RS2_CUDA_NO_DEPTH 0xffffffffu
+
+static __device__
+void deproject_pixel_to_point_cuda(float point[3], const rs2_intrinsics& intrin, const float pixel[2], float depth)
+{
+    float x = (pixel[0] - intrin.ppx) / intrin.fx;
+    float y = (pixel[1] - intrin.ppy) / intrin.fy;
+    if (intrin.model == RS2_DISTORTION_INVERSE_BROWN_CONRADY)
+    {
+        float r2  = x*x + y*y;
+        float f = 1 + intrin.coeffs[0]*r2 + intrin.coeffs[1]*r2*r2 + intrin.coeffs[4]*r2*r2*r2;
+        float ux = x*f + 2*intrin.coeffs[2]*x*y + intrin.coeffs[3]*(r2 + 2*x*x);
+        float uy = y*f + 2*intrin.coeffs[3]*x*y + intrin.coeffs[2]*(r2 + 2*y*y);
+        x = ux;
+        y = uy;
+    }
+    point[0] = depth * x;
+    point[1] = depth * y;
+    point[2] = depth;
+}
+
+static __device__
+void transform_point_to_point_cuda(float to_point[3], const rs2_extrinsics& extrin, const float from_point[3])
+{
+    to_point[0] = extrin.rotation[0] * from_point[0] + extrin.rotation[3] * from_point[1] + extrin.rotation[6] * from_point[2] + extrin.translation[0];
+    to_point[1] = extrin.rotation[1] * from_point[0] + extrin.rotation[4] * from_point[1] + extrin.rotation[7] * from_point[2] + extrin.translation[1];
+    to_point[2] = extrin.rotation[2] * from_point[0] + extrin.rotation[5] * from_point[1] + extrin.rotation[8] * from_point[2] + extrin.translation[2];
+}
+
+static __device__
+void project_point_to_pixel_cuda(float pixel[2], const rs2_intrinsics& intrin, const float point[3])
+{
+    float x = point[0] / point[2], y = point[1] / point[2];
+
+    if (intrin.model == RS2_DISTORTION_MODIFIED_BROWN_CONRADY)
+    {
+        float r2  = x*x + y*y;
+        float f = 1 + intrin.coeffs[0]*r2 + intrin.coeffs[1]*r2*r2 + intrin.coeffs[4]*r2*r2*r2;
+        x *= f;
+        y *= f;
+        float dx = x + 2*intrin.coeffs[2]*x*y + intrin.coeffs[3]*(r2 + 2*x*x);
+        float dy = y + 2*intrin.coeffs[3]*x*y + intrin.coeffs[2]*(r2 + 2*y*y);
+        x = dx;
+        y = dy;
+    }
+    if (intrin.model == RS2_DISTORTION_FTHETA)
+    {
+        float r = sqrtf(x*x + y*y);
+        float rd = (float)(1.0f / intrin.coeffs[0] * atan(2 * r* tan(intrin.coeffs[0] / 2.0f)));
+        x *= rd / r;
+        y *= rd / r;
+    }
+
+    pixel[0] = x * intrin.fx + intrin.ppx;
+    pixel[1] = y * intrin.fy + intrin.ppy;
+}
+
+// Maps the corners of a depth pixel onto the other image, the same way the CPU align_images does.
+// Returns false when the resulting rectangle is not fully inside the other image.
+static __device__
+bool map_depth_pixel_cuda(int& other_x0, int& other_y0, int& other_x1, int& other_y1, int depth_x, int depth_y, float depth,
+    const rs2_intrinsics& depth_intrin, const rs2_extrinsics& depth_to_other, const rs2_intrinsics& other_intrin)
+{
+    // Map the top-left corner of the depth pixel onto the other image
+    float depth_pixel[2] = { depth_x - 0.5f, depth_y - 0.5f }, depth_point[3], other_point[3], other_pixel[2];
+    deproject_pixel_to_point_cuda(depth_point, depth_intrin, depth_pixel, depth);
+    transform_point_to_point_cuda(other_point, depth_to_other, depth_point);
+    project_point_to_pixel_cuda(other_pixel, other_intrin, other_point);
+    other_x0 = static_cast<int>(other_pixel[0] + 0.5f);
+    other_y0 = static_cast<int>(other_pixel[1] + 0.5f);
+
+    // Map the bottom-right corner of the depth pixel onto the other image
+    depth_pixel[0] = depth_x + 0.5f; depth_pixel[1] = depth_y + 0.5f;
+    deproject_pixel_to_point_cuda(depth_point, depth_intrin, depth_pixel, depth);
+    transform_point_to_point_cuda(other_point, depth_to_other, depth_point);
+    project_point_to_pixel_cuda(other_pixel, other_intrin, other_point);
+    other_x1 = static_cast<int>(other_pixel[0] + 0.5f);
+    other_y1 = static_cast<int>(other_pixel[1] + 0.5f);
+
+    return !(other_x0 < 0 || other_y0 < 0 || other_x1 >= other_intrin.width || other_y1 >= other_intrin.height);
+}
+
+__global__
+void kernel_depth_to_other_cuda(unsigned int * depth_scatter, const uint16_t * depth_in, float depth_scale,
+    const rs2_intrinsics depth_intrin, const rs2_extrinsics depth_to_other, const rs2_intrinsics other_intrin)
+{
+    int count = depth_intrin.height * depth_intrin.width;
+    int stride = blockDim.x * gridDim.x;
+
+    for (int i = blockDim.x * blockIdx.x + threadIdx.x; i < count; i += stride)
+    {
+        // Skip over depth pixels with the value of zero, we have no depth data so we will not write anything into the aligned image
+        uint16_t z = depth_in[i];
+        if (!z)
+            continue;
+
+        int depth_y = i / depth_intrin.width;
+        int depth_x = i - depth_y * depth_intrin.width;
+        int other_x0, other_y0, other_x1, other_y1;
+        if (!map_depth_pixel_cuda(other_x0, other_y0, other_x1, other_y1, depth_x, depth_y, depth_scale * z, depth_intrin, depth_to_other, other_intrin))
+            continue;
+
+        // Several depth pixels may cover the same pixel of the other image, the closest one is kept
+        for (int y = other_y0; y <= other_y1; ++y)
+        {
+            for (int x = other_x0; x <= other_x1; ++x)
+            {
+                atomicMin(&depth_scatter[y * other_intrin.width + x], (unsigned int)z);
+            }
+        }
+    }
+}
+
+__global__
+void kernel_scatter_to_depth_cuda(uint16_t * aligned_out, const unsigned int * depth_scatter, int count)
+{
+    int stride = blockDim.x * gridDim.x;
+
+    for (int i = blockDim.x * blockIdx.x + threadIdx.x; i < count; i += stride)
+    {
+        unsigned int z = depth_scatter[i];
+        aligned_out[i] = z == RS2_CUDA_NO_DEPTH ? 0 : (uint16_t)z;
+    }
+}
+
+__global__
+void kernel_other_to_depth_cuda(uint8_t * aligned_out, const uint8_t * other_in, int other_bytes_per_pixel, const uint16_t * depth_in, float depth_scale,
+    const rs2_intrinsics depth_intrin, const rs2_extrinsics depth_to_other, const rs2_intrinsics other_intrin)
+{
+    int count = depth_intrin.height * depth_intrin.width;
+    int stride = blockDim.x * gridDim.x;
+
+    for (int i = blockDim.x * blockIdx.x + threadIdx.x; i < count; i += stride)
+    {
+        uint8_t * out = aligned_out + i * other_bytes_per_pixel;
+        for (int b = 0; b < other_bytes_per_pixel; ++b)
+            out[b] = 0;
+
+        uint16_t z = depth_in[i];
+        if (!z)
+            continue;
+
+        int depth_y = i / depth_intrin.width;
+        int depth_x = i - depth_y * depth_intrin.width;
+        int other_x0, other_y0, other_x1, other_y1;
+        if (!map_depth_pixel_cuda(other_x0, other_y0, other_x1, other_y1, depth_x, depth_y, depth_scale * z, depth_intrin, depth_to_other, other_intrin))
+            continue;
+
+        // Every depth pixel owns its output pixel, so the last pixel of the rectangle wins like on the CPU
+        const uint8_t * in = other_in + (other_y1 * other_intrin.width + other_x1) * other_bytes_per_pixel;
+        for (int b = 0; b < other_bytes_per_pixel; ++b)
+            out[b] = in[b];
+    }
+}
+
+void rscuda::check(cudaError_t result, const char* call)
+{
+    if (result != cudaSuccess)
+        throw std::runtime_error(std::string(call) + " failed: " + cudaGetErrorString(result));
+}
+
+void* rscuda::device_buffer::reserve(size_t size)
+{
+    if (size > _size)
+    {
+        if (_data)
+            cudaFree(_data);
+        _data = nullptr;
+        _size = 0;
+
+        if (cudaMalloc(&_data, size) != cudaSuccess)
+        {
+            _data = nullptr;
+            throw std::bad_alloc();
+        }
+        _size = size;
+    }
+    return _data;
+}
+
+rscuda::align_cuda::align_cuda()
+{
+    check(cudaStreamCreate(&_stream), "cudaStreamCreate");
+}
+
+rscuda::align_cuda::~align_cuda()
+{
+    cudaStreamDestroy(_stream);
+}
+
+void rscuda::align_cuda::align_depth_to_other(uint16_t* h_aligned_out, const uint16_t* h_depth_in, float depth_scale,
+    const rs2_intrinsics& h_depth_intrin, const rs2_extrinsics& h_depth_to_other, const rs2_intrinsics& h_other_intrin,
+    const uint16_t* d_depth_in, uint16_t* d_aligned_out)
+{
+    int depth_count = h_depth_intrin.height * h_depth_intrin.width;
+    int other_count = h_other_intrin.height * h_other_intrin.width;
+    int depth_blocks = (depth_count + RS2_CUDA_THREADS_PER_BLOCK - 1) / RS2_CUDA_THREADS_PER_BLOCK;
+    int other_blocks = (other_count + RS2_CUDA_THREADS_PER_BLOCK - 1) / RS2_CUDA_THREADS_PER_BLOCK;
+
+    auto dev_depth = d_depth_in ? d_depth_in : static_cast<uint16_t*>(_d_depth_in.reserve(depth_count * sizeof(uint16_t)));
+    auto dev_scatter = static_cast<unsigned int*>(_d_depth_scatter.reserve(other_count * sizeof(unsigned int)));
+    auto dev_aligned = d_aligned_out ? d_aligned_out : static_cast<uint16_t*>(_d_aligned_out.reserve(other_count * sizeof(uint16_t)));
+
+    if (!d_depth_in)
+        check(cudaMemcpyAsync(const_cast<uint16_t*>(dev_depth), h_depth_in, depth_count * sizeof(uint16_t), cudaMemcpyHostToDevice, _stream), "cudaMemcpyAsync");
+    check(cudaMemsetAsync(dev_scatter, 0xff, other_count * sizeof(unsigned int), _stream), "cudaMemsetAsync");
+
+    kernel_depth_to_other_cuda<<<depth_blocks, RS2_CUDA_THREADS_PER_BLOCK, 0, _stream>>>(dev_scatter, dev_depth, depth_scale,
+        h_depth_intrin, h_depth_to_other, h_other_intrin);
+    check(cudaGetLastError(), "kernel_depth_to_other_cuda");
+    kernel_scatter_to_depth_cuda<<<other_blocks, RS2_CUDA_THREADS_PER_BLOCK, 0, _stream>>>(dev_aligned, dev_scatter, other_count);
+    check(cudaGetLastError(), "kernel_scatter_to_depth_cuda");
+
+    if (!d_aligned_out)
+        check(cudaMemcpyAsync(h_aligned_out, dev_aligned, other_count * sizeof(uint16_t), cudaMemcpyDeviceToHost, _stream), "cudaMemcpyAsync");
+    check(cudaStreamSynchronize(_stream), "cudaStreamSynchronize");
+}
+
+void rscuda::align_cuda::align_other_to_depth(uint8_t* h_aligned_out, const uint16_t* h_depth_in, float depth_scale,
+    const rs2_intrinsics& h_depth_intrin, const rs2_extrinsics& h_depth_to_other, const rs2_intrinsics& h_other_intrin,
+    const uint8_t* h_other_in, int other_bytes_per_pixel,
+    const uint16_t* d_depth_in, const uint8_t* d_other_in, uint8_t* d_aligned_out)
+{
+    int depth_count = h_depth_intrin.height * h_depth_intrin.width;
+    int other_size = h_other_intrin.height * h_other_intrin.width * other_bytes_per_pixel;
+    int depth_blocks = (depth_count + RS2_CUDA_THREADS_PER_BLOCK - 1) / RS2_CUDA_THREADS_PER_BLOCK;
+
+    auto dev_depth = d_depth_in ? d_depth_in : static_cast<uint16_t*>(_d_depth_in.reserve(depth_count * sizeof(uint16_t)));
+    auto dev_other = d_other_in ? d_other_in : static_cast<uint8_t*>(_d_other_in.reserve(other_size));
+    auto dev_aligned = d_aligned_out ? d_aligned_out : static_cast<uint8_t*>(_d_aligned_out.reserve(depth_count * other_bytes_per_pixel));
+
+    if (!d_depth_in)
+        check(cudaMemcpyAsync(const_cast<uint16_t*>(dev_depth), h_depth_in, depth_count * sizeof(uint16_t), cudaMemcpyHostToDevice, _stream), "cudaMemcpyAsync");
+    if (!d_other_in)
+        check(cudaMemcpyAsync(const_cast<uint8_t*>(dev_other), h_other_in, other_size, cudaMemcpyHostToDevice, _stream), "cudaMemcpyAsync");
+
+    kernel_other_to_depth_cuda<<<depth_blocks, RS2_CUDA_THREADS_PER_BLOCK, 0, _stream>>>(dev_aligned, dev_other, other_bytes_per_pixel,
+        dev_depth, depth_scale, h_depth_intrin, h_depth_to_other, h_other_intrin);
+    check(cudaGetLastError(), "kernel_other_to_depth_cuda");
+
+    if (!d_aligned_out)
+        check(cudaMemcpyAsync(h_aligned_out, dev_aligned, depth_count * other_bytes_per_pixel, cudaMemcpyDeviceToHost, _stream), "cudaMemcpyAsync");
+    check(cudaStreamSynchronize(_stream), "cudaStreamSynchronize");
+}
+
+#endif
@@ -0,0 +1,80 @@
+#pragma once
+#ifndef LIBREALSENSE_CUDA_ALIGN_H
+#define LIBREALSENSE_CUDA_ALIGN_H
+
+#ifdef RS2_USE_CUDA
+
+// Types
+#include <stdint.h>
+#include <utility>
+#include "../../include/librealsense2/rs.h"
+#include "assert.h"
+#include "../../include/librealsense2/rsutil.h"
+
+// CUDA headers
+#include <cuda_runtime.h>
+
+#ifdef _MSC_VER
+// Add library dependencies if using VS
+#pragma comment(lib, "cudart_static")
+#endif
+
+#define RS2_CUDA_THREADS_PER_BLOCK 256
+
+namespace rscuda
+{
+    // Throws the error of a call to the runtime, or of the kernels launched last when given cudaGetLastError()
+    void check(cudaError_t result, const char* call);
+
+    // Device memory that is kept between frames, and only reallocated when a larger size is requested
+    class device_buffer
+    {
+    public:
+        device_buffer() : _data(nullptr), _size(0) {}
+        ~device_buffer() { if (_data) cudaFree(_data); }
+
+        void* reserve(size_t size);
+        void swap(device_buffer& other) { std::swap(_data, other._data); std::swap(_size, other._size); }
+
+    private:
+        device_buffer(const device_buffer&) = delete;
+        device_buffer& operator=(const device_buffer&) = delete;
+
+        void* _data;
+        size_t _size;
+    };
+
+    // Aligns frames on the GPU, one instance per align block so that every block owns its stream and buffers
+    class align_cuda
+    {
+    public:
+        align_cuda();
+        ~align_cuda();
+
+        // Inputs of GPU-resident frames are read from their device pointers, the others are uploaded from the host.
+        // When d_aligned_out is given the aligned frame stays in device memory, otherwise it is downloaded into h_aligned_out
+        void align_depth_to_other(uint16_t* h_aligned_out, const uint16_t* h_depth_in, float depth_scale,
+            const rs2_intrinsics& h_depth_intrin, const rs2_extrinsics& h_depth_to_other, const rs2_intrinsics& h_other_intrin,
+            const uint16_t* d_depth_in = nullptr, uint16_t* d_aligned_out = nullptr);
+
+        void align_other_to_depth(uint8_t* h_aligned_out, const uint16_t* h_depth_in, float depth_scale,
+            const rs2_intrinsics& h_depth_intrin, const rs2_extrinsics& h_depth_to_other, const rs2_intrinsics& h_other_intrin,
+            const uint8_t* h_other_in, int other_bytes_per_pixel,
+            const uint16_t* d_depth_in = nullptr, const uint8_t* d_other_in = nullptr, uint8_t* d_aligned_out = nullptr);
+
+    private:
+        align_cuda(const align_cuda&) = delete;
+        align_cuda& operator=(const align_cuda&) = delete;
+
+        cudaStream_t _stream;
+
+        device_buffer _d_depth_in;
+        device_buffer _d_other_in;
+        device_buffer _d_aligned_out;
+        device_buffer _d_depth_scatter;
+    };
+}
+
+#endif // RS2_USE_CUDA
+
+#endif // LIBREALSENSE_CUDA_ALIGN_H
@@ -3,6 +3,7 @@
 #ifdef RS2_USE_CUDA
 
 #include "cuda-conversion.cuh"
+#include "cuda-frame-archive.cuh"
 #include <iostream>
 #include <iomanip>
 
@@ -224,86 +225,78 @@ __global__ void kernel_unpack_yuy2_bgra8_cuda(const uint8_t * src, uint8_t *dst,
 }
 
 
-void rscuda::unpack_yuy2_cuda_helper(const uint8_t* src, uint8_t* dst, int n, rs2_format format) 
+static int yuy2_unpacked_bytes_per_pixel(rs2_format format)
 {
-/*    cudaEvent_t start, stop;
-    cudaEventCreate(&start);
-    cudaEventCreate(&stop);
-    cudaEventRecord(start); */
-    
-	// How many super pixels do we have?
-	int superPix = n / 2;
-	uint8_t *devSrc = 0;
-	uint8_t *devDst = 0;
-	
-	cudaError_t result = cudaMalloc(&devSrc, superPix * sizeof(uint8_t) * 4);
-	assert(result == cudaSuccess);
-	
-	result = cudaMemcpy(devSrc, src, superPix * sizeof(uint8_t) * 4, cudaMemcpyHostToDevice);
-	assert(result == cudaSuccess);
-	
-	int numBlocks = superPix / RS2_CUDA_THREADS_PER_BLOCK;
-	int size;
-	
-	switch (format)
-	{
-	// conversion to Y8 is currently not available in the API
-	/*	case RS2_FORMAT_Y8:
-	    size = 1;
-		result = cudaMalloc(&devDst, n * sizeof(uint8_t) * size);
-	    assert(result == cudaSuccess);
-		kernel_unpack_yuy2_y8_cuda<<<numBlocks, RS2_CUDA_THREADS_PER_BLOCK>>>(devSrc, devDst, superPix);
-		break;
-	*/
-	case RS2_FORMAT_Y16:
-		size = 2;
-		result = cudaMalloc(&devDst, n * sizeof(uint8_t) * size);
-	    assert(result == cudaSuccess);
-		kernel_unpack_yuy2_y16_cuda<<<numBlocks, RS2_CUDA_THREADS_PER_BLOCK>>>(devSrc, devDst, superPix);
-		break;
-	case RS2_FORMAT_RGB8:
-	    size = 3;
-		result = cudaMalloc(&devDst, n * sizeof(uint8_t) * size);
-	    assert(result == cudaSuccess);
-		kernel_unpack_yuy2_rgb8_cuda<<<numBlocks, RS2_CUDA_THREADS_PER_BLOCK>>>(devSrc, devDst, superPix);
-		break;
-	case RS2_FORMAT_BGR8:
-	    size = 3;
-        result = cudaMalloc(&devDst, n * sizeof(uint8_t) * size);
-	    assert(result == cudaSuccess);
-		kernel_unpack_yuy2_bgr8_cuda<<<numBlocks, RS2_CUDA_THREADS_PER_BLOCK>>>(devSrc, devDst, superPix);
-    	break;
-	case RS2_FORMAT_RGBA8:
-		size = 4;
-		result = cudaMalloc(&devDst, n * sizeof(uint8_t) * size);
-	    assert(result == cudaSuccess);
-		kernel_unpack_yuy2_rgba8_cuda<<<numBlocks, RS2_CUDA_THREADS_PER_BLOCK>>>(devSrc, devDst, superPix);
-		break;
-	case RS2_FORMAT_BGRA8:
-        size = 4;
-		result = cudaMalloc(&devDst, n * sizeof(uint8_t) * size);
-	    assert(result == cudaSuccess);
-		kernel_unpack_yuy2_bgra8_cuda<<<numBlocks, RS2_CUDA_THREADS_PER_BLOCK>>>(devSrc, devDst, superPix);
-		break;
-	default:
-		assert(false);
-	}
-
-
-	result = cudaGetLastError();
-	assert(result == cudaSuccess);
-
-	result = cudaMemcpy(dst, devDst, n * sizeof(uint8_t) * size, cudaMemcpyDeviceToHost);
-	assert(result == cudaSuccess);
-	
-	cudaFree(devSrc);
-	cudaFree(devDst);
+    switch (format)
+    {
+    case RS2_FORMAT_Y16: return 2;
+    case RS2_FORMAT_RGB8:
+    case RS2_FORMAT_BGR8: return 3;
+    case RS2_FORMAT_RGBA8:
+    case RS2_FORMAT_BGRA8: return 4;
+    default: assert(false); return 0;
+    }
+}
 
-/*	cudaEventRecord(stop);	
-	cudaEventSynchronize(stop);
-    float milliseconds = 0;
-    cudaEventElapsedTime(&milliseconds, start, stop);
-    std::cout << milliseconds << "\n"; */
+void rscuda::unpack_yuy2_cuda_device(const uint8_t* dev_src, uint8_t* dev_dst, int n, rs2_format format, cudaStream_t stream)
+{
+    // How many super pixels do we have?
+    int superPix = n / 2;
+    int numBlocks = (superPix + RS2_CUDA_THREADS_PER_BLOCK - 1) / RS2_CUDA_THREADS_PER_BLOCK;
+
+    switch (format)
+    {
+    // conversion to Y8 is currently not available in the API
+    /*  case RS2_FORMAT_Y8:
+        kernel_unpack_yuy2_y8_cuda<<<numBlocks, RS2_CUDA_THREADS_PER_BLOCK>>>(dev_src, dev_dst, superPix);
+        break;
+    */
+    case RS2_FORMAT_Y16:
+        kernel_unpack_yuy2_y16_cuda<<<numBlocks, RS2_CUDA_THREADS_PER_BLOCK, 0, stream>>>(dev_src, dev_dst, superPix);
+        break;
+    case RS2_FORMAT_RGB8:
+        kernel_unpack_yuy2_rgb8_cuda<<<numBlocks, RS2_CUDA_THREADS_PER_BLOCK, 0, stream>>>(dev_src, dev_dst, superPix);
+        break;
+    case RS2_FORMAT_BGR8:
+        kernel_unpack_yuy2_bgr8_cuda<<<numBlocks, RS2_CUDA_THREADS_PER_BLOCK, 0, stream>>>(dev_src, dev_dst, superPix);
+        break;
+    case RS2_FORMAT_RGBA8:
+        kernel_unpack_yuy2_rgba8_cuda<<<numBlocks, RS2_CUDA_THREADS_PER_BLOCK, 0, stream>>>(dev_src, dev_dst, superPix);
+        break;
+    case RS2_FORMAT_BGRA8:
+        kernel_unpack_yuy2_bgra8_cuda<<<numBlocks, RS2_CUDA_THREADS_PER_BLOCK, 0, stream>>>(dev_src, dev_dst, superPix);
+        break;
+    default:
+        assert(false);
+    }
+
+    cudaError_t result = cudaGetLastError();
+    assert(result == cudaSuccess);
+}
+
+void rscuda::unpack_yuy2_cuda_to_device(const uint8_t* src, uint8_t* dev_dst, int n, rs2_format format)
+{
+    // The native frame goes through a pinned staging buffer, and the unpacked one stays on the device
+    auto stream = thread_stream();
+    auto devSrc = memory_pool::device()->acquire(n * sizeof(uint8_t) * 2);
+    upload(devSrc.get(), src, n * sizeof(uint8_t) * 2, stream);
+
+    unpack_yuy2_cuda_device(static_cast<const uint8_t*>(devSrc.get()), dev_dst, n, format, stream);
+
+    // The source buffer returns to the pool, so the kernel has to be done with it
+    cudaError_t result = cudaStreamSynchronize(stream);
+    assert(result == cudaSuccess);
+}
+
+void rscuda::unpack_yuy2_cuda_helper(const uint8_t* src, uint8_t* dst, int n, rs2_format format)
+{
+    // Of the super pixels, two pixels each
+    int size = yuy2_unpacked_bytes_per_pixel(format);
+    transform(src, sizeof(uint8_t) * 4, dst, sizeof(uint8_t) * size * 2, n / 2,
+        [format](const void* d_src, void* d_dst, size_t first, size_t count, cudaStream_t stream)
+    {
+        unpack_yuy2_cuda_device(static_cast<const uint8_t*>(d_src), static_cast<uint8_t*>(d_dst), static_cast<int>(count * 2), format, stream);
+    });
 }
 
 
@@ -333,17 +326,18 @@ void rscuda::y8_y8_from_y8i_cuda_helper(uint8_t* const dest[], int count, const
     uint8_t *devDst1 = 0; // for dest[0]
     uint8_t *devDst2 = 0; // for dest[1]
     
-    cudaError_t result = cudaMalloc(&devSrc, count * sizeof(rscuda::y8i_pixel));
-    assert(result == cudaSuccess);
+    auto devSrcBuffer = rscuda::memory_pool::device()->acquire(count * sizeof(rscuda::y8i_pixel));
+    devSrc = static_cast<decltype(devSrc)>(devSrcBuffer.get());
+    cudaError_t result;
 
     result = cudaMemcpy(devSrc, source, count * sizeof(rscuda::y8i_pixel), cudaMemcpyHostToDevice);
     assert(result == cudaSuccess);
 
-    result = cudaMalloc(&devDst1, count * sizeof(uint8_t));
-    assert(result == cudaSuccess);
+    auto devDst1Buffer = rscuda::memory_pool::device()->acquire(count * sizeof(uint8_t));
+    devDst1 = static_cast<decltype(devDst1)>(devDst1Buffer.get());
 
-    result = cudaMalloc(&devDst2, count * sizeof(uint8_t));
-    assert(result == cudaSuccess);
+    auto devDst2Buffer = rscuda::memory_pool::device()->acquire(count * sizeof(uint8_t));
+    devDst2 = static_cast<decltype(devDst2)>(devDst2Buffer.get());
     
     kernel_split_frame_y8_y8_from_y8i_cuda<<<numBlocks, RS2_CUDA_THREADS_PER_BLOCK>>>(devDst1, devDst2, count, devSrc);
 
@@ -354,10 +348,6 @@ void rscuda::y8_y8_from_y8i_cuda_helper(uint8_t* const dest[], int count, const
     assert(result == cudaSuccess);
     result = cudaMemcpy(b, devDst2, count * sizeof(uint8_t), cudaMemcpyDeviceToHost);
     assert(result == cudaSuccess);
-
-    cudaFree(devSrc);
-    cudaFree(devDst1);
-    cudaFree(devDst2);
     
 /*    cudaEventRecord(stop);
 	cudaEventSynchronize(stop);
@@ -396,17 +386,18 @@ void rscuda::y16_y16_from_y12i_10_cuda_helper(uint8_t* const dest[], int count,
     uint16_t *devDst1 = 0; // for dest[0]
     uint16_t *devDst2 = 0; // for dest[1]
     
-    cudaError_t result = cudaMalloc(&devSrc, count * sizeof(rscuda::y12i_pixel));
-    assert(result == cudaSuccess);
+    auto devSrcBuffer = rscuda::memory_pool::device()->acquire(count * sizeof(rscuda::y12i_pixel));
+    devSrc = static_cast<decltype(devSrc)>(devSrcBuffer.get());
+    cudaError_t result;
 
     result = cudaMemcpy(devSrc, source, count * sizeof(rscuda::y12i_pixel), cudaMemcpyHostToDevice);
     assert(result == cudaSuccess);
 
-    result = cudaMalloc(&devDst1, count * sizeof(uint16_t));
-    assert(result == cudaSuccess);
+    auto devDst1Buffer = rscuda::memory_pool::device()->acquire(count * sizeof(uint16_t));
+    devDst1 = static_cast<decltype(devDst1)>(devDst1Buffer.get());
 
-    result = cudaMalloc(&devDst2, count * sizeof(uint16_t));
-    assert(result == cudaSuccess);
+    auto devDst2Buffer = rscuda::memory_pool::device()->acquire(count * sizeof(uint16_t));
+    devDst2 = static_cast<decltype(devDst2)>(devDst2Buffer.get());
     
     kernel_split_frame_y16_y16_from_y12i_cuda<<<numBlocks, RS2_CUDA_THREADS_PER_BLOCK>>>(devDst1, devDst2, count, devSrc);
 
@@ -417,10 +408,6 @@ void rscuda::y16_y16_from_y12i_10_cuda_helper(uint8_t* const dest[], int count,
     assert(result == cudaSuccess);
     result = cudaMemcpy(b, devDst2, count * sizeof(uint16_t), cudaMemcpyDeviceToHost);
     assert(result == cudaSuccess);
-
-    cudaFree(devSrc);
-    cudaFree(devDst1);
-    cudaFree(devDst2);
     
     /*
 	cudaEventRecord(stop);
@@ -454,23 +441,21 @@ void rscuda::unpack_z16_y8_from_sr300_inzi_cuda (uint8_t * const dest, const uin
      
     int numBlocks = count / RS2_CUDA_THREADS_PER_BLOCK;
     
-    cudaError_t result = cudaMalloc(&devSrc, count * sizeof(uint16_t));
-    assert(result == cudaSuccess);
+    auto devSrcBuffer = rscuda::memory_pool::device()->acquire(count * sizeof(uint16_t));
+    devSrc = static_cast<decltype(devSrc)>(devSrcBuffer.get());
+    cudaError_t result;
 
     result = cudaMemcpy(devSrc, source, count * sizeof(uint16_t), cudaMemcpyHostToDevice);
     assert(result == cudaSuccess);
     
-    result = cudaMalloc(&devDst, count * sizeof(uint8_t));
-    assert(result == cudaSuccess);
+    auto devDstBuffer = rscuda::memory_pool::device()->acquire(count * sizeof(uint8_t));
+    devDst = static_cast<decltype(devDst)>(devDstBuffer.get());
 
     kernel_z16_y8_from_sr300_inzi_cuda<<<numBlocks, RS2_CUDA_THREADS_PER_BLOCK>>>(devSrc, devDst, count);
     
     result = cudaMemcpy(dest, devDst, count * sizeof(uint8_t), cudaMemcpyDeviceToHost);
     assert(result == cudaSuccess);
     
-    cudaFree(devSrc);
-    cudaFree(devDst);
-    
 /*  cudaEventRecord(stop);
    	cudaEventSynchronize(stop);
     float milliseconds = 0;
@@ -500,23 +485,21 @@ void rscuda::unpack_z16_y16_from_sr300_inzi_cuda(uint16_t * const dest, const ui
      
     int numBlocks = count / RS2_CUDA_THREADS_PER_BLOCK;
     
-    cudaError_t result = cudaMalloc(&devSrc, count * sizeof(uint16_t));
-    assert(result == cudaSuccess);
+    auto devSrcBuffer = rscuda::memory_pool::device()->acquire(count * sizeof(uint16_t));
+    devSrc = static_cast<decltype(devSrc)>(devSrcBuffer.get());
+    cudaError_t result;
 
     result = cudaMemcpy(devSrc, source, count * sizeof(uint16_t), cudaMemcpyHostToDevice);
     assert(result == cudaSuccess);
     
-    result = cudaMalloc(&devDst, count * sizeof(uint16_t));
-    assert(result == cudaSuccess);
+    auto devDstBuffer = rscuda::memory_pool::device()->acquire(count * sizeof(uint16_t));
+    devDst = static_cast<decltype(devDst)>(devDstBuffer.get());
 
     kernel_z16_y16_from_sr300_inzi_cuda<<<numBlocks, RS2_CUDA_THREADS_PER_BLOCK>>>(devSrc, devDst, count);
     
     result = cudaMemcpy(dest, devDst, count * sizeof(uint16_t), cudaMemcpyDeviceToHost);
     assert(result == cudaSuccess);
     
-    cudaFree(devSrc);
-    cudaFree(devDst);
-    
         	
 /*	cudaEventRecord(stop);
 	cudaEventSynchronize(stop);
@@ -29,6 +29,12 @@ namespace rscuda
     void y8_y8_from_y8i_cuda_helper(uint8_t* const dest[], int count, const y8i_pixel * source);
     void y16_y16_from_y12i_10_cuda_helper(uint8_t* const dest[], int count, const rscuda::y12i_pixel * source);
     void unpack_yuy2_cuda_helper(const uint8_t* src, uint8_t* dst, int n, rs2_format format);
+
+    // Unpack n pixels of YUY2 from and into device memory, queued on the stream
+    void unpack_yuy2_cuda_device(const uint8_t* dev_src, uint8_t* dev_dst, int n, rs2_format format, cudaStream_t stream = 0);
+
+    // Unpack n pixels of YUY2 from host memory into device memory, for the frame to stay on the GPU
+    void unpack_yuy2_cuda_to_device(const uint8_t* src, uint8_t* dev_dst, int n, rs2_format format);
     
 	template<rs2_format FORMAT> void unpack_yuy2_cuda(uint8_t * const d[], const uint8_t * s, int n)
 	{
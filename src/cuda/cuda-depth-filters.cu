@@ -0,0 +1,529 @@
+#ifdef RS2_USE_CUDA
+
+#include "cuda-depth-filters.cuh"
+#include <float.h>
+#include <limits.h>
+
+// The filters blend values with explicitly rounded operations, so that nvcc does not contract them into FMAs and the results
+// stay identical to the CPU filters
+
+static __device__ __forceinline__
+float blend(float a, float weight_a, float b, float weight_b)
+{
+    return __fadd_rn(__fmul_rn(a, weight_a), __fmul_rn(b, weight_b));
+}
+
+// The conversions of the CPU filters, which truncate to int32 like cvttps, with INT_MIN for what is out of its range
+static __device__ __forceinline__
+int truncate_to_int(float value)
+{
+    return (value >= -2147483648.f && value < 2147483648.f) ? __float2int_rz(value) : INT_MIN;
+}
+
+// and then saturate to [0, 65535] when they pack the results of a blend
+static __device__ __forceinline__
+uint16_t saturate_to_uint16(float value)
+{
+    int v = truncate_to_int(value);
+    return static_cast<uint16_t>(v < 0 ? 0 : (v > 65535 ? 65535 : v));
+}
+
+static __device__ __forceinline__
+uint16_t blend_result(float value, uint16_t) { return saturate_to_uint16(value); }
+
+static __device__ __forceinline__
+float blend_result(float value, float) { return value; }
+
+static __device__ __forceinline__
+bool valid_fp(float value)
+{
+    return __float_as_int(value) > 0;
+}
+
+static __device__ __forceinline__
+bool empty(uint16_t value) { return !value; }
+
+static __device__ __forceinline__
+bool empty(float value) { return !__float_as_int(value); }
+
+static int blocks_for(int count)
+{
+    return (count + RS2_CUDA_THREADS_PER_BLOCK - 1) / RS2_CUDA_THREADS_PER_BLOCK;
+}
+
+// Every call of the runtime is checked, and the kernels after their launch, so that a failure fails the processing block
+// instead of handing on a frame that was not filtered
+static void check_launch(const char* kernel)
+{
+    rscuda::check(cudaGetLastError(), kernel);
+}
+
+// Disparity transform
+
+__global__
+void kernel_depth_to_disparity(float* disparity, const uint16_t* depth, int count, float factor)
+{
+    int i = blockDim.x * blockIdx.x + threadIdx.x;
+    if (i >= count)
+        return;
+
+    float input = depth[i];
+    disparity[i] = input ? __fdiv_rn(factor, input) : 0.f;
+}
+
+__global__
+void kernel_disparity_to_depth(uint16_t* depth, const float* disparity, int count, float factor)
+{
+    int i = blockDim.x * blockIdx.x + threadIdx.x;
+    if (i >= count)
+        return;
+
+    // Normal numbers only, like std::isnormal
+    float input = disparity[i];
+    float a = fabsf(input);
+    if (a >= FLT_MIN && a <= FLT_MAX)
+        depth[i] = static_cast<uint16_t>(truncate_to_int(__fadd_rn(__fdiv_rn(factor, input), 0.5f)));
+    else
+        depth[i] = 0;
+}
+
+// Spatial filter, depth domain. One thread per row, then one per column
+
+__global__
+void kernel_spatial_horizontal(uint16_t* image, int width, int height, float alpha, float one_minus_alpha, uint16_t delta_z, uint8_t radius)
+{
+    int v = blockDim.x * blockIdx.x + threadIdx.x;
+    if (v >= height)
+        return;
+
+    uint16_t* im = image + v * width;
+
+    // left to right
+    uint16_t val0 = im[0];
+    int cur_fill = 0;
+    for (int u = 1; u < width - 1; u++)
+    {
+        uint16_t val1 = im[u];
+        if (val0 >= 1)
+        {
+            if (val1 >= 1)
+            {
+                cur_fill = 0;
+                uint16_t diff = static_cast<uint16_t>(abs(val1 - val0));
+                if (diff >= 1 && diff <= delta_z)
+                {
+                    val1 = saturate_to_uint16(__fadd_rn(blend(val1, alpha, val0, one_minus_alpha), 0.5f));
+                    im[u] = val1;
+                }
+            }
+            else if (radius)
+            {
+                if (++cur_fill < radius)
+                    im[u] = val1 = val0;
+            }
+        }
+        val0 = val1;
+    }
+
+    // right to left
+    uint16_t val1 = im[width - 1];
+    cur_fill = 0;
+    for (int u = width - 2; u >= 0; u--)
+    {
+        uint16_t val0 = im[u];
+        if (val1 >= 1)
+        {
+            if (val0 > 1)
+            {
+                cur_fill = 0;
+                uint16_t diff = static_cast<uint16_t>(abs(val1 - val0));
+                if (diff <= delta_z)
+                {
+                    val0 = saturate_to_uint16(__fadd_rn(blend(val0, alpha, val1, one_minus_alpha), 0.5f));
+                    im[u] = val0;
+                }
+            }
+            else if (radius)
+            {
+                if (++cur_fill < radius)
+                    im[u] = val0 = val1;
+            }
+        }
+        val1 = val0;
+    }
+}
+
+__global__
+void kernel_spatial_vertical(uint16_t* image, int width, int height, float alpha, float one_minus_alpha, uint16_t delta_z)
+{
+    int u = blockDim.x * blockIdx.x + threadIdx.x;
+    if (u >= width)
+        return;
+
+    uint16_t* im = image + u;
+
+    // top to bottom, blending every pixel with the filtered one above it
+    for (int v = 1; v < height; v++)
+    {
+        uint16_t imw = im[v * width], im0 = im[(v - 1) * width];
+        uint16_t diff = static_cast<uint16_t>(abs(im0 - imw));
+        if (diff < delta_z)
+            im[v * width] = saturate_to_uint16(__fadd_rn(blend(imw, alpha, im0, one_minus_alpha), 0.5f));
+    }
+
+    // bottom to top, between valid pixels only
+    for (int v = height - 1; v > 0; v--)
+    {
+        uint16_t imw = im[(v - 1) * width], im0 = im[v * width];
+        if (im0 >= 1 && imw >= 1)
+        {
+            uint16_t diff = static_cast<uint16_t>(abs(im0 - imw));
+            if (diff < delta_z)
+                im[(v - 1) * width] = saturate_to_uint16(__fadd_rn(blend(imw, alpha, im0, one_minus_alpha), 0.5f));
+        }
+    }
+}
+
+// Spatial filter, disparity domain. The state machine of the CPU passes, with the branches turned into selects
+
+struct recursive_state
+{
+    float state, previous_innovation;
+    bool valid;
+
+    __device__ void start(float value)
+    {
+        previous_innovation = state = value;
+        valid = valid_fp(value);
+    }
+
+    __device__ float filter(float innovation, float alpha, float one_minus_alpha, float delta_z)
+    {
+        bool valid_innovation = valid_fp(innovation);
+        float delta = __fsub_rn(previous_innovation, innovation);
+        bool small_difference = valid && valid_innovation && delta < delta_z && delta > -delta_z;
+
+        float out = small_difference ? blend(innovation, alpha, state, one_minus_alpha) : innovation;
+        if (valid_innovation)
+        {
+            state = out;
+            previous_innovation = innovation;
+        }
+        valid = valid_innovation;
+        return out;
+    }
+};
+
+__global__
+void kernel_spatial_horizontal_fp(float* image, int width, int height, float alpha, float one_minus_alpha, float delta_z)
+{
+    int v = blockDim.x * blockIdx.x + threadIdx.x;
+    if (v >= height)
+        return;
+
+    float* im = image + v * width;
+    recursive_state s;
+
+    s.start(im[0]);
+    for (int u = 1; u < width; u++)
+        im[u] = s.filter(im[u], alpha, one_minus_alpha, delta_z);
+
+    s.start(im[width - 1]);
+    for (int u = width - 2; u >= 0; u--)
+        im[u] = s.filter(im[u], alpha, one_minus_alpha, delta_z);
+}
+
+__global__
+void kernel_spatial_vertical_fp(float* image, int width, int height, float alpha, float one_minus_alpha, float delta_z)
+{
+    int u = blockDim.x * blockIdx.x + threadIdx.x;
+    if (u >= width)
+        return;
+
+    float* im = image + u;
+    recursive_state s;
+
+    s.start(im[0]);
+    for (int v = 1; v < height; v++)
+        im[v * width] = s.filter(im[v * width], alpha, one_minus_alpha, delta_z);
+
+    s.start(im[(height - 1) * width]);
+    for (int v = height - 1; v > 0; v--)
+        im[(v - 1) * width] = s.filter(im[(v - 1) * width], alpha, one_minus_alpha, delta_z);
+}
+
+__global__
+void kernel_inertial_holes_fill(float* image, int width, int height, uint8_t radius)
+{
+    int v = blockDim.x * blockIdx.x + threadIdx.x;
+    if (v >= height)
+        return;
+
+    float* p = image + v * width;
+
+    int cur_fill = 0;
+    for (int i = 1; i < width; i++)
+    {
+        if (empty(p[i]))
+        {
+            if (++cur_fill < radius)
+                p[i] = p[i - 1];
+        }
+        else
+            cur_fill = 0;
+    }
+
+    // The CPU filter starts from the first pixel of the next row, which no row modifies
+    cur_fill = 0;
+    for (int i = width - 1; i > 0; i--)
+    {
+        if (empty(p[i]))
+        {
+            if (++cur_fill < radius)
+                p[i] = (i + 1 < width) ? p[i + 1] : (v + 1 < height ? p[width] : 0.f);
+        }
+        else
+            cur_fill = 0;
+    }
+}
+
+// Temporal filter, one thread per pixel
+
+template<typename T>
+__global__
+void kernel_temporal(T* frame, T* last_frame, uint8_t* history, const uint8_t* persistence_map, int count,
+    float alpha, float one_minus_alpha, T delta_z, uint8_t mask)
+{
+    int i = blockDim.x * blockIdx.x + threadIdx.x;
+    if (i >= count)
+        return;
+
+    T cur_val = frame[i];
+    T prev_val = last_frame[i];
+
+    if (cur_val)
+    {
+        if (!prev_val)
+        {
+            last_frame[i] = cur_val;
+            history[i] = mask;
+        }
+        else
+        {
+            T diff = static_cast<T>(fabsf(float(cur_val) - float(prev_val)));
+            if (diff < delta_z)
+            {
+                history[i] |= mask;
+                T result = blend_result(blend(alpha, cur_val, one_minus_alpha, prev_val), cur_val);
+                frame[i] = result;
+                last_frame[i] = result;
+            }
+            else
+            {
+                last_frame[i] = cur_val;
+                history[i] = mask;
+            }
+        }
+    }
+    else
+    {
+        if (prev_val && (persistence_map[history[i]] & mask))
+            frame[i] = prev_val;
+        history[i] &= ~mask;
+    }
+}
+
+// Hole filling filter
+
+template<typename T>
+__global__
+void kernel_holes_fill_left(T* image, int width, int height)
+{
+    int v = blockDim.x * blockIdx.x + threadIdx.x;
+    if (v >= height)
+        return;
+
+    T* p = image + v * width;
+    for (int i = 1; i < width; i++)
+        if (empty(p[i]))
+            p[i] = p[i - 1];
+}
+
+// A pixel reads the filled pixels to its left and above it, and the unfilled ones below, so the pixel (x, y) is filled at step x + 2y by a
+// single block, every thread of which fills rows
+template<typename T, bool FAREST>
+__global__
+void kernel_holes_fill_around(T* image, int width, int height)
+{
+    for (int step = 0; step < width + 2 * height; step++)
+    {
+        for (int y = threadIdx.x; y < height - 1; y += blockDim.x)
+        {
+            int x = step - 2 * y;
+            if (y < 1 || x < 1 || x >= width)
+                continue;
+
+            T* p = image + y * width + x;
+            if (!empty(*p))
+                continue;
+
+            const T* around[] = { p - width - 1, p - 1, p + width - 1, p + width };
+            T tmp = *(p - width);
+            for (auto q : around)
+            {
+                if (FAREST)
+                {
+                    if (*q > tmp)
+                        tmp = *q;
+                }
+                else if (!empty(*q) && *q < tmp)
+                    tmp = *q;
+            }
+            *p = tmp;
+        }
+        __syncthreads();
+    }
+}
+
+rscuda::depth_filters_cuda::depth_filters_cuda()
+    : _width(0), _height(0), _fp(false), _history_size(0)
+{
+    check(cudaStreamCreate(&_stream), "cudaStreamCreate");
+}
+
+rscuda::depth_filters_cuda::~depth_filters_cuda()
+{
+    cudaStreamDestroy(_stream);
+}
+
+void rscuda::depth_filters_cuda::upload(const void* h_frame, int width, int height, bool fp)
+{
+    _width = width;
+    _height = height;
+    _fp = fp;
+
+    // Copies from pageable memory return once the host data is staged, so the caller may reuse its frame right away
+    auto dev_frame = _d_frame.reserve(bytes());
+    check(cudaMemcpyAsync(dev_frame, h_frame, bytes(), cudaMemcpyHostToDevice, _stream), "cudaMemcpyAsync");
+}
+
+void rscuda::depth_filters_cuda::download(void* h_frame)
+{
+    check(cudaMemcpyAsync(h_frame, _d_frame.reserve(bytes()), bytes(), cudaMemcpyDeviceToHost, _stream), "cudaMemcpyAsync");
+    check(cudaStreamSynchronize(_stream), "cudaStreamSynchronize");
+}
+
+void rscuda::depth_filters_cuda::depth_to_disparity(float factor)
+{
+    assert(!_fp);
+    int count = _width * _height;
+    auto dev_depth = static_cast<const uint16_t*>(_d_frame.reserve(count * sizeof(uint16_t)));
+    auto dev_disparity = static_cast<float*>(_d_converted.reserve(count * sizeof(float)));
+
+    kernel_depth_to_disparity<<<blocks_for(count), RS2_CUDA_THREADS_PER_BLOCK, 0, _stream>>>(dev_disparity, dev_depth, count, factor);
+    check_launch("kernel_depth_to_disparity");
+    _d_frame.swap(_d_converted);
+    _fp = true;
+}
+
+void rscuda::depth_filters_cuda::disparity_to_depth(float factor)
+{
+    assert(_fp);
+    int count = _width * _height;
+    auto dev_disparity = static_cast<const float*>(_d_frame.reserve(count * sizeof(float)));
+    auto dev_depth = static_cast<uint16_t*>(_d_converted.reserve(count * sizeof(uint16_t)));
+
+    kernel_disparity_to_depth<<<blocks_for(count), RS2_CUDA_THREADS_PER_BLOCK, 0, _stream>>>(dev_depth, dev_disparity, count, factor);
+    check_launch("kernel_disparity_to_depth");
+    _d_frame.swap(_d_converted);
+    _fp = false;
+}
+
+void rscuda::depth_filters_cuda::spatial(float alpha, float delta, int iterations, uint8_t holes_filling_radius, bool inertial_holes_fill)
+{
+    float one_minus_alpha = 1.f - alpha;
+    auto dev_frame = _d_frame.reserve(bytes());
+
+    for (int i = 0; i < iterations; i++)
+    {
+        if (_fp)
+        {
+            auto image = static_cast<float*>(dev_frame);
+            kernel_spatial_horizontal_fp<<<blocks_for(_height), RS2_CUDA_THREADS_PER_BLOCK, 0, _stream>>>(image, _width, _height, alpha, one_minus_alpha, delta);
+            check_launch("kernel_spatial_horizontal_fp");
+            kernel_spatial_vertical_fp<<<blocks_for(_width), RS2_CUDA_THREADS_PER_BLOCK, 0, _stream>>>(image, _width, _height, alpha, one_minus_alpha, delta);
+            check_launch("kernel_spatial_vertical_fp");
+        }
+        else
+        {
+            auto image = static_cast<uint16_t*>(dev_frame);
+            auto delta_z = static_cast<uint16_t>(delta);
+            kernel_spatial_horizontal<<<blocks_for(_height), RS2_CUDA_THREADS_PER_BLOCK, 0, _stream>>>(image, _width, _height, alpha, one_minus_alpha, delta_z, holes_filling_radius);
+            check_launch("kernel_spatial_horizontal");
+            kernel_spatial_vertical<<<blocks_for(_width), RS2_CUDA_THREADS_PER_BLOCK, 0, _stream>>>(image, _width, _height, alpha, one_minus_alpha, delta_z);
+            check_launch("kernel_spatial_vertical");
+        }
+    }
+
+    if (inertial_holes_fill && _fp)
+    {
+        kernel_inertial_holes_fill<<<blocks_for(_height), RS2_CUDA_THREADS_PER_BLOCK, 0, _stream>>>(static_cast<float*>(dev_frame), _width, _height, holes_filling_radius);
+        check_launch("kernel_inertial_holes_fill");
+    }
+}
+
+void rscuda::depth_filters_cuda::temporal(float alpha, float one_minus_alpha, uint8_t delta, const uint8_t persistence_map[256], uint8_t frame_index, bool reset)
+{
+    int count = _width * _height;
+    auto dev_frame = _d_frame.reserve(bytes());
+    auto dev_last_frame = _d_last_frame.reserve(bytes());
+    auto dev_history = static_cast<uint8_t*>(_d_history.reserve(count));
+    auto dev_persistence_map = static_cast<uint8_t*>(_d_persistence_map.reserve(256));
+
+    if (reset || _history_size != bytes())
+    {
+        check(cudaMemsetAsync(dev_last_frame, 0, bytes(), _stream), "cudaMemsetAsync");
+        check(cudaMemsetAsync(dev_history, 0, count, _stream), "cudaMemsetAsync");
+        _history_size = bytes();
+    }
+    check(cudaMemcpyAsync(dev_persistence_map, persistence_map, 256, cudaMemcpyHostToDevice, _stream), "cudaMemcpyAsync");
+
+    uint8_t mask = 1 << frame_index;
+    if (_fp)
+        kernel_temporal<float><<<blocks_for(count), RS2_CUDA_THREADS_PER_BLOCK, 0, _stream>>>(static_cast<float*>(dev_frame),
+            static_cast<float*>(dev_last_frame), dev_history, dev_persistence_map, count, alpha, one_minus_alpha, static_cast<float>(delta), mask);
+    else
+        kernel_temporal<uint16_t><<<blocks_for(count), RS2_CUDA_THREADS_PER_BLOCK, 0, _stream>>>(static_cast<uint16_t*>(dev_frame),
+            static_cast<uint16_t*>(dev_last_frame), dev_history, dev_persistence_map, count, alpha, one_minus_alpha, static_cast<uint16_t>(delta), mask);
+    check_launch("kernel_temporal");
+}
+
+void rscuda::depth_filters_cuda::hole_filling(int mode)
+{
+    auto dev_frame = _d_frame.reserve(bytes());
+    int threads = _height < 1024 ? _height : 1024;
+
+    if (_fp)
+    {
+        auto image = static_cast<float*>(dev_frame);
+        if (mode == 0)
+            kernel_holes_fill_left<float><<<blocks_for(_height), RS2_CUDA_THREADS_PER_BLOCK, 0, _stream>>>(image, _width, _height);
+        else if (mode == 1)
+            kernel_holes_fill_around<float, true><<<1, threads, 0, _stream>>>(image, _width, _height);
+        else
+            kernel_holes_fill_around<float, false><<<1, threads, 0, _stream>>>(image, _width, _height);
+    }
+    else
+    {
+        auto image = static_cast<uint16_t*>(dev_frame);
+        if (mode == 0)
+            kernel_holes_fill_left<uint16_t><<<blocks_for(_height), RS2_CUDA_THREADS_PER_BLOCK, 0, _stream>>>(image, _width, _height);
+        else if (mode == 1)
+            kernel_holes_fill_around<uint16_t, true><<<1, threads, 0, _stream>>>(image, _width, _height);
+        else
+            kernel_holes_fill_around<uint16_t, false><<<1, threads, 0, _stream>>>(image, _width, _height);
+    }
+    check_launch("hole filling kernel");
+}
+
+#endif // RS2_USE_CUDA
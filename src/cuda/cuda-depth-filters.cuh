@@ -0,0 +1,71 @@
+#pragma once
+#ifndef LIBREALSENSE_CUDA_DEPTH_FILTERS_H
+#define LIBREALSENSE_CUDA_DEPTH_FILTERS_H
+
+#ifdef RS2_USE_CUDA
+
+// Types
+#include <stdint.h>
+#include "../../include/librealsense2/rs.h"
+#include "assert.h"
+
+// CUDA headers
+#include <cuda_runtime.h>
+
+// Device buffers
+#include "cuda-align.cuh"
+
+#ifdef _MSC_VER
+// Add library dependencies if using VS
+#pragma comment(lib, "cudart_static")
+#endif
+
+namespace rscuda
+{
+    // Runs the spatial, temporal and hole filling filters on the GPU, with the same results as the CPU filters.
+    // The frame stays on the device from upload() to download(), so that any number of filters may run on it in between.
+    // Frames are uint16_t depth, or float disparity when fp is set
+    class depth_filters_cuda
+    {
+    public:
+        depth_filters_cuda();
+        ~depth_filters_cuda();
+
+        void upload(const void* h_frame, int width, int height, bool fp);
+        void download(void* h_frame);
+
+        // Convert the resident frame between depth and disparity, like the disparity transform
+        void depth_to_disparity(float factor);
+        void disparity_to_depth(float factor);
+
+        // Rows are filtered in parallel in the horizontal passes, and columns in the vertical ones
+        void spatial(float alpha, float delta, int iterations, uint8_t holes_filling_radius, bool inertial_holes_fill);
+
+        // The history of the temporal filter stays on the device between frames, and is cleared when reset is set
+        void temporal(float alpha, float one_minus_alpha, uint8_t delta, const uint8_t persistence_map[256], uint8_t frame_index, bool reset);
+
+        // mode is one of the hole filling filter modes: 0 fills from the left, 1 with the farest around, 2 with the nearest around
+        void hole_filling(int mode);
+
+    private:
+        depth_filters_cuda(const depth_filters_cuda&) = delete;
+        depth_filters_cuda& operator=(const depth_filters_cuda&) = delete;
+
+        size_t bytes() const { return size_t(_width) * _height * (_fp ? sizeof(float) : sizeof(uint16_t)); }
+
+        cudaStream_t _stream;
+        int _width, _height;
+        bool _fp;
+
+        device_buffer _d_frame;
+        device_buffer _d_converted;
+        device_buffer _d_last_frame;
+        device_buffer _d_history;
+        device_buffer _d_persistence_map;
+        size_t _history_size;
+    };
+}
+
+#endif // RS2_USE_CUDA
+
+#endif // LIBREALSENSE_CUDA_DEPTH_FILTERS_H
@@ -0,0 +1,179 @@
+#ifdef RS2_USE_CUDA
+
+#include "cuda-frame-archive.cuh"
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+// Idle memory the process-wide pools hold on to, so that a few frames of every stream stay allocated
+#define RS2_CUDA_DEVICE_POOL_BUDGET (256u * 1024 * 1024)
+#define RS2_CUDA_PINNED_POOL_BUDGET (64u * 1024 * 1024)
+
+// Chunks a frame is split into by transform, unless the caller sizes them
+#define RS2_CUDA_TRANSFORM_CHUNKS 4
+
+rscuda::memory_pool::memory_pool(memory_type type, size_t budget)
+    : _type(type), _budget(budget), _idle_bytes(0)
+{
+}
+
+rscuda::memory_pool::~memory_pool()
+{
+    for (auto&& kvp : _idle)
+        for (auto ptr : kvp.second)
+            free(ptr);
+}
+
+std::shared_ptr<void> rscuda::memory_pool::acquire(size_t size)
+{
+    void* ptr = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _idle.find(size);
+        if (it != _idle.end() && !it->second.empty())
+        {
+            ptr = it->second.back();
+            it->second.pop_back();
+            _idle_bytes -= size;
+        }
+    }
+
+    if (!ptr)
+    {
+        cudaError_t result = _type == device_memory ? cudaMalloc(&ptr, size) : cudaMallocHost(&ptr, size);
+        if (result != cudaSuccess)
+            throw std::bad_alloc();
+    }
+
+    auto self = shared_from_this();
+    return std::shared_ptr<void>(ptr, [self, size](void* p) { self->recycle(p, size); });
+}
+
+void rscuda::memory_pool::recycle(void* ptr, size_t size)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_idle_bytes + size <= _budget)
+        {
+            _idle[size].push_back(ptr);
+            _idle_bytes += size;
+            return;
+        }
+    }
+    free(ptr);
+}
+
+void rscuda::memory_pool::free(void* ptr)
+{
+    if (_type == device_memory)
+        cudaFree(ptr);
+    else
+        cudaFreeHost(ptr);
+}
+
+std::shared_ptr<rscuda::memory_pool> rscuda::memory_pool::device()
+{
+    static auto pool = std::make_shared<memory_pool>(device_memory, RS2_CUDA_DEVICE_POOL_BUDGET);
+    return pool;
+}
+
+std::shared_ptr<rscuda::memory_pool> rscuda::memory_pool::pinned()
+{
+    static auto pool = std::make_shared<memory_pool>(pinned_memory, RS2_CUDA_PINNED_POOL_BUDGET);
+    return pool;
+}
+
+void rscuda::upload(void* d_dst, const void* h_src, size_t size, cudaStream_t stream)
+{
+    auto staging = memory_pool::pinned()->acquire(size);
+    memcpy(staging.get(), h_src, size);
+
+    cudaError_t result = cudaMemcpyAsync(d_dst, staging.get(), size, cudaMemcpyHostToDevice, stream);
+    assert(result == cudaSuccess);
+    result = cudaStreamSynchronize(stream);
+    assert(result == cudaSuccess);
+}
+
+void rscuda::download(void* h_dst, const void* d_src, size_t size, cudaStream_t stream)
+{
+    auto staging = memory_pool::pinned()->acquire(size);
+
+    cudaError_t result = cudaMemcpyAsync(staging.get(), d_src, size, cudaMemcpyDeviceToHost, stream);
+    assert(result == cudaSuccess);
+    result = cudaStreamSynchronize(stream);
+    assert(result == cudaSuccess);
+
+    memcpy(h_dst, staging.get(), size);
+}
+
+namespace
+{
+    struct thread_streams
+    {
+        cudaStream_t streams[2];
+
+        thread_streams()
+        {
+            for (auto&& s : streams)
+            {
+                cudaError_t result = cudaStreamCreateWithFlags(&s, cudaStreamNonBlocking);
+                assert(result == cudaSuccess);
+            }
+        }
+        ~thread_streams()
+        {
+            for (auto s : streams)
+                cudaStreamDestroy(s);
+        }
+    };
+}
+
+cudaStream_t rscuda::thread_stream(int index)
+{
+    static thread_local thread_streams streams;
+    return streams.streams[index & 1];
+}
+
+void rscuda::transform(const void* h_src, size_t src_element, void* h_dst, size_t dst_element, size_t count,
+    const chunk_kernel& launch, size_t chunk)
+{
+    if (!count) return;
+    if (!chunk) chunk = (count + RS2_CUDA_TRANSFORM_CHUNKS - 1) / RS2_CUDA_TRANSFORM_CHUNKS;
+
+    // Of the sizes of the frame, which the pools keep for the next frames of the profile
+    auto staging_src = memory_pool::pinned()->acquire(count * src_element);
+    auto staging_dst = memory_pool::pinned()->acquire(count * dst_element);
+    auto d_src = memory_pool::device()->acquire(count * src_element);
+    auto d_dst = memory_pool::device()->acquire(count * dst_element);
+
+    auto src = static_cast<const uint8_t*>(h_src);
+    auto in = static_cast<uint8_t*>(staging_src.get());
+    auto out = static_cast<uint8_t*>(staging_dst.get());
+    auto dev_in = static_cast<uint8_t*>(d_src.get());
+    auto dev_out = static_cast<uint8_t*>(d_dst.get());
+
+    cudaError_t result;
+    for (size_t first = 0, k = 0; first < count; first += chunk, ++k)
+    {
+        auto n = std::min(chunk, count - first);
+        auto stream = thread_stream(static_cast<int>(k));
+
+        // The host copies a chunk into the staging buffer while the device works on those before
+        memcpy(in + first * src_element, src + first * src_element, n * src_element);
+        result = cudaMemcpyAsync(dev_in + first * src_element, in + first * src_element, n * src_element, cudaMemcpyHostToDevice, stream);
+        assert(result == cudaSuccess);
+        launch(dev_in + first * src_element, dev_out + first * dst_element, first, n, stream);
+        result = cudaMemcpyAsync(out + first * dst_element, dev_out + first * dst_element, n * dst_element, cudaMemcpyDeviceToHost, stream);
+        assert(result == cudaSuccess);
+    }
+
+    // The buffers return to the pools, so both streams have to be done with them
+    for (int i = 0; i < 2; i++)
+    {
+        result = cudaStreamSynchronize(thread_stream(i));
+        assert(result == cudaSuccess);
+    }
+    memcpy(h_dst, out, count * dst_element);
+}
+
+#endif
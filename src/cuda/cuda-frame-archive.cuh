@@ -0,0 +1,78 @@
+#pragma once
+#ifndef LIBREALSENSE_CUDA_FRAME_ARCHIVE_H
+#define LIBREALSENSE_CUDA_FRAME_ARCHIVE_H
+
+#ifdef RS2_USE_CUDA
+
+// Types
+#include <stdint.h>
+#include <map>
+#include <vector>
+#include <mutex>
+#include <memory>
+#include <functional>
+#include "assert.h"
+
+// CUDA headers
+#include <cuda_runtime.h>
+
+#ifdef _MSC_VER
+// Add library dependencies if using VS
+#pragma comment(lib, "cudart_static")
+#endif
+
+namespace rscuda
+{
+    // Device or pinned host buffers, recycled by size so that streaming does not allocate on every frame.
+    // Every stream profile asks for buffers of a single size, so each size effectively serves one profile
+    class memory_pool : public std::enable_shared_from_this<memory_pool>
+    {
+    public:
+        enum memory_type { device_memory, pinned_memory };
+
+        // Idle buffers are kept up to budget bytes, and freed beyond it
+        memory_pool(memory_type type, size_t budget);
+        ~memory_pool();
+
+        // The buffer returns to the pool when its last reference is released
+        std::shared_ptr<void> acquire(size_t size);
+
+        // Pools shared by all the frames of the process
+        static std::shared_ptr<memory_pool> device();
+        static std::shared_ptr<memory_pool> pinned();
+
+    private:
+        memory_pool(const memory_pool&) = delete;
+        memory_pool& operator=(const memory_pool&) = delete;
+
+        void recycle(void* ptr, size_t size);
+        void free(void* ptr);
+
+        const memory_type _type;
+        const size_t _budget;
+        std::mutex _mutex;
+        std::map<size_t, std::vector<void*>> _idle;
+        size_t _idle_bytes;
+    };
+
+    // Copy between pageable host memory and the device through a pinned staging buffer of the pool,
+    // so that the transfers run at the full bandwidth of the bus. Both return once the copy is complete
+    void upload(void* d_dst, const void* h_src, size_t size, cudaStream_t stream = 0);
+    void download(void* h_dst, const void* d_src, size_t size, cudaStream_t stream = 0);
+
+    // The frames of a sensor are unpacked and processed on its own thread, so the streams of the calling thread keep the
+    // work of every sensor apart instead of serializing it with that of the others on the default stream
+    cudaStream_t thread_stream(int index = 0);
+
+    // Runs a kernel over count elements from pageable host memory into pageable host memory, in chunks queued over two
+    // streams of the thread through pinned staging buffers, for the upload of a chunk to overlap the kernel of the one
+    // before and the download of the one before that. launch queues the kernel of the n elements from first on the
+    // stream, of device pointers to them. Returns once the output is complete
+    typedef std::function<void(const void* d_src, void* d_dst, size_t first, size_t n, cudaStream_t stream)> chunk_kernel;
+    void transform(const void* h_src, size_t src_element, void* h_dst, size_t dst_element, size_t count,
+        const chunk_kernel& launch, size_t chunk = 0);
+}
+
+#endif // RS2_USE_CUDA
+
+#endif // LIBREALSENSE_CUDA_FRAME_ARCHIVE_H
@@ -34,57 +34,46 @@ void deproject_pixel_to_point_cuda(float points[3], const struct rs2_intrinsics
 
 
 __global__
-//void kernel_deproject_depth_cuda(float * points, const rs2_intrinsics & intrin, const uint16_t * depth, std::function<uint16_t(float)> map_depth)
-
-void kernel_deproject_depth_cuda(float * points, const rs2_intrinsics* intrin, const uint16_t * depth, float depth_scale)
+void kernel_deproject_depth_cuda(float * points, const rs2_intrinsics intrin, const uint16_t * depth, float depth_scale, int first, int count)
 {
     int i = blockDim.x * blockIdx.x + threadIdx.x;
-    
-    if (i >= (*intrin).height * (*intrin).width) {
-        return;
-    }
     int stride = blockDim.x * gridDim.x;
-    int a, b;
-    
-    for (int j = i; j < (*intrin).height * (*intrin).width; j += stride) {
-        b = j / (*intrin).width;
-        a = j - b * (*intrin).width;
+
+    // Of the count pixels from first, in the order of the image
+    for (int j = i; j < count; j += stride) {
+        int b = (first + j) / intrin.width;
+        int a = first + j - b * intrin.width;
         const float pixel[] = { (float)a, (float)b };
-        deproject_pixel_to_point_cuda(points + j * 3, intrin, pixel, depth_scale * depth[j]);               
+        deproject_pixel_to_point_cuda(points + j * 3, &intrin, pixel, depth_scale * depth[j]);
    }
 }
 
 
-void rscuda::deproject_depth_cuda(float * points, const rs2_intrinsics & intrin, const uint16_t * depth, float depth_scale)
+void rscuda::deproject_depth_cuda(float * points, const rs2_intrinsics & intrin, const uint16_t * depth, float depth_scale, const uint16_t * dev_depth_in)
 {
     int count = intrin.height * intrin.width;
-    int numBlocks = count / RS2_CUDA_THREADS_PER_BLOCK;
-    
-    float *dev_points = 0;	
-    uint16_t *dev_depth = 0;
-    rs2_intrinsics* dev_intrin = 0;
-    cudaError_t result;
 
-    result = cudaMalloc(&dev_points, count * sizeof(float) * 3);
-    assert(result == cudaSuccess);
-    result = cudaMalloc(&dev_depth, count * sizeof(uint16_t));
-    assert(result == cudaSuccess);
-    result = cudaMalloc(&dev_intrin, sizeof(rs2_intrinsics));
-    assert(result == cudaSuccess);
-       
-    result = cudaMemcpy(dev_depth, depth, count * sizeof(uint16_t), cudaMemcpyHostToDevice);
-    assert(result == cudaSuccess); 
-    result = cudaMemcpy(dev_intrin, &intrin, sizeof(rs2_intrinsics), cudaMemcpyHostToDevice);
-    assert(result == cudaSuccess); 
-     
-    kernel_deproject_depth_cuda<<<numBlocks, RS2_CUDA_THREADS_PER_BLOCK>>>(dev_points, dev_intrin, dev_depth, depth_scale); 
+    // The intrinsics are passed to the kernel by value, with no copy of their own
+    auto launch = [&intrin, depth_scale](const void* d_src, void* d_dst, size_t first, size_t n, cudaStream_t stream)
+    {
+        int numBlocks = (static_cast<int>(n) + RS2_CUDA_THREADS_PER_BLOCK - 1) / RS2_CUDA_THREADS_PER_BLOCK;
+        kernel_deproject_depth_cuda<<<numBlocks, RS2_CUDA_THREADS_PER_BLOCK, 0, stream>>>(static_cast<float*>(d_dst), intrin,
+            static_cast<const uint16_t*>(d_src), depth_scale, static_cast<int>(first), static_cast<int>(n));
+        cudaError_t result = cudaGetLastError();
+        assert(result == cudaSuccess);
+    };
 
-     result = cudaMemcpy(points, dev_points, count * sizeof(float) * 3, cudaMemcpyDeviceToHost);
-     assert(result == cudaSuccess);
+    // GPU-resident depth frames are read where they are, and the others uploaded in chunks overlapping the kernel
+    if (!dev_depth_in)
+    {
+        transform(depth, sizeof(uint16_t), points, sizeof(float) * 3, count, launch);
+        return;
+    }
 
-    cudaFree(dev_points);
-    cudaFree(dev_depth);
-    cudaFree(dev_intrin);
+    auto stream = thread_stream();
+    auto dev_points = memory_pool::device()->acquire(count * sizeof(float) * 3);
+    launch(dev_depth_in, dev_points.get(), 0, count, stream);
+    download(points, dev_points.get(), count * sizeof(float) * 3, stream);
 }
 
 #endif
@@ -10,6 +10,7 @@
 #include "assert.h"
 #include "../../include/librealsense2/rsutil.h"
 #include <functional>
+#include "cuda-frame-archive.cuh"
 
 // CUDA headers
 #include <cuda_runtime.h>
@@ -23,7 +24,8 @@
 
 namespace rscuda
 {
-    void deproject_depth_cuda(float * points, const rs2_intrinsics & intrin, const uint16_t * depth, float depth_scale);
+    // Depth already in device memory is passed as dev_depth_in, otherwise depth is uploaded from the host
+    void deproject_depth_cuda(float * points, const rs2_intrinsics & intrin, const uint16_t * depth, float depth_scale, const uint16_t * dev_depth_in = nullptr);
 
 }
 
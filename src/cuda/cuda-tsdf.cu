@@ -0,0 +1,561 @@
+#ifdef RS2_USE_CUDA
+
+#include "cuda-tsdf.cuh"
+#include <limits.h>
+#include <float.h>
+
+#define RS2_CUDA_TSDF_BLOCK_SIDE 8
+#define RS2_CUDA_TSDF_BLOCK_VOXELS (RS2_CUDA_TSDF_BLOCK_SIDE * RS2_CUDA_TSDF_BLOCK_SIDE * RS2_CUDA_TSDF_BLOCK_SIDE)
+
+// 128MB of voxels, in a hash at most a quarter full
+#define RS2_CUDA_TSDF_MAX_BLOCKS (1 << 15)
+#define RS2_CUDA_TSDF_HASH_SLOTS (RS2_CUDA_TSDF_MAX_BLOCKS * 4)
+#define RS2_CUDA_TSDF_EMPTY_KEY 0xffffffffffffffffull
+
+struct tsdf_counters
+{
+    unsigned int blocks, visible, points;
+    int low[3], high[3];    // Bounds of the coordinates of the blocks
+};
+
+static int blocks_for(int count)
+{
+    return (count + RS2_CUDA_THREADS_PER_BLOCK - 1) / RS2_CUDA_THREADS_PER_BLOCK;
+}
+
+static __device__
+void deproject_pixel_to_point_cuda(float point[3], const rs2_intrinsics& intrin, const float pixel[2], float depth)
+{
+    float x = (pixel[0] - intrin.ppx) / intrin.fx;
+    float y = (pixel[1] - intrin.ppy) / intrin.fy;
+    if (intrin.model == RS2_DISTORTION_INVERSE_BROWN_CONRADY)
+    {
+        float r2  = x*x + y*y;
+        float f = 1 + intrin.coeffs[0]*r2 + intrin.coeffs[1]*r2*r2 + intrin.coeffs[4]*r2*r2*r2;
+        float ux = x*f + 2*intrin.coeffs[2]*x*y + intrin.coeffs[3]*(r2 + 2*x*x);
+        float uy = y*f + 2*intrin.coeffs[3]*x*y + intrin.coeffs[2]*(r2 + 2*y*y);
+        x = ux;
+        y = uy;
+    }
+    point[0] = depth * x;
+    point[1] = depth * y;
+    point[2] = depth;
+}
+
+static __device__
+void project_point_to_pixel_cuda(float pixel[2], const rs2_intrinsics& intrin, const float point[3])
+{
+    float x = point[0] / point[2], y = point[1] / point[2];
+
+    if (intrin.model == RS2_DISTORTION_MODIFIED_BROWN_CONRADY)
+    {
+        float r2  = x*x + y*y;
+        float f = 1 + intrin.coeffs[0]*r2 + intrin.coeffs[1]*r2*r2 + intrin.coeffs[4]*r2*r2*r2;
+        x *= f;
+        y *= f;
+        float dx = x + 2*intrin.coeffs[2]*x*y + intrin.coeffs[3]*(r2 + 2*x*x);
+        float dy = y + 2*intrin.coeffs[3]*x*y + intrin.coeffs[2]*(r2 + 2*y*y);
+        x = dx;
+        y = dy;
+    }
+
+    pixel[0] = x * intrin.fx + intrin.ppx;
+    pixel[1] = y * intrin.fy + intrin.ppy;
+}
+
+static __device__
+float3 transform(const rs2_extrinsics& e, float3 p)
+{
+    return make_float3(e.rotation[0] * p.x + e.rotation[3] * p.y + e.rotation[6] * p.z + e.translation[0],
+        e.rotation[1] * p.x + e.rotation[4] * p.y + e.rotation[7] * p.z + e.translation[1],
+        e.rotation[2] * p.x + e.rotation[5] * p.y + e.rotation[8] * p.z + e.translation[2]);
+}
+
+static __device__
+float3 rotate_inverse(const rs2_extrinsics& e, float3 p)
+{
+    return make_float3(e.rotation[0] * p.x + e.rotation[1] * p.y + e.rotation[2] * p.z,
+        e.rotation[3] * p.x + e.rotation[4] * p.y + e.rotation[5] * p.z,
+        e.rotation[6] * p.x + e.rotation[7] * p.y + e.rotation[8] * p.z);
+}
+
+static __device__ __forceinline__
+float get(const float3& v, int axis) { return axis == 0 ? v.x : axis == 1 ? v.y : v.z; }
+
+static __device__ __forceinline__
+int floor_div(int a, int b) { return a >= 0 ? a / b : -((-a + b - 1) / b); }
+
+static __device__ __forceinline__
+unsigned long long block_key(int x, int y, int z)
+{
+    const unsigned long long mask = (1ull << 21) - 1;
+    return ((static_cast<unsigned long long>(x) & mask) << 42) | ((static_cast<unsigned long long>(y) & mask) << 21) |
+        (static_cast<unsigned long long>(z) & mask);
+}
+
+static __device__ __forceinline__
+unsigned int first_slot(unsigned long long key)
+{
+    return static_cast<unsigned int>((key * 0x9E3779B97F4A7C15ull) >> 32) & (RS2_CUDA_TSDF_HASH_SLOTS - 1);
+}
+
+// Read once the kernel allocating the blocks is done, for the block of every key to be set
+static __device__
+int find_block(const unsigned long long* keys, const int* slots, int x, int y, int z)
+{
+    auto key = block_key(x, y, z);
+    for (unsigned int s = first_slot(key), probes = 0; probes < RS2_CUDA_TSDF_HASH_SLOTS; s = (s + 1) & (RS2_CUDA_TSDF_HASH_SLOTS - 1), ++probes)
+    {
+        auto k = keys[s];
+        if (k == key)
+            return slots[s];
+        if (k == RS2_CUDA_TSDF_EMPTY_KEY)
+            return -1;
+    }
+    return -1;
+}
+
+struct tsdf_view
+{
+    const unsigned long long* keys;
+    const int* slots;
+    const float2* voxels;   // Distance and weight
+    float voxel_size;
+
+    __device__ const float2* find_voxel(int x, int y, int z) const
+    {
+        int bx = floor_div(x, RS2_CUDA_TSDF_BLOCK_SIDE), by = floor_div(y, RS2_CUDA_TSDF_BLOCK_SIDE), bz = floor_div(z, RS2_CUDA_TSDF_BLOCK_SIDE);
+        int index = find_block(keys, slots, bx, by, bz);
+        if (index < 0)
+            return nullptr;
+        const float2* v = voxels + index * RS2_CUDA_TSDF_BLOCK_VOXELS + ((z - bz * RS2_CUDA_TSDF_BLOCK_SIDE) * RS2_CUDA_TSDF_BLOCK_SIDE +
+            (y - by * RS2_CUDA_TSDF_BLOCK_SIDE)) * RS2_CUDA_TSDF_BLOCK_SIDE + (x - bx * RS2_CUDA_TSDF_BLOCK_SIDE);
+        return v->y > 0 ? v : nullptr;
+    }
+
+    __device__ bool sample(float3 p, float& tsdf) const
+    {
+        float u[] = { p.x / voxel_size - 0.5f, p.y / voxel_size - 0.5f, p.z / voxel_size - 0.5f };
+        int base[] = { (int)floorf(u[0]), (int)floorf(u[1]), (int)floorf(u[2]) };
+        float f[] = { u[0] - base[0], u[1] - base[1], u[2] - base[2] };
+
+        tsdf = 0.f;
+        for (int corner = 0; corner < 8; ++corner)
+        {
+            int dx = corner & 1, dy = (corner >> 1) & 1, dz = corner >> 2;
+            auto v = find_voxel(base[0] + dx, base[1] + dy, base[2] + dz);
+            if (!v)
+                return false;
+            tsdf += v->x * (dx ? f[0] : 1 - f[0]) * (dy ? f[1] : 1 - f[1]) * (dz ? f[2] : 1 - f[2]);
+        }
+        return true;
+    }
+
+    // As on the CPU, one-sided at the edges of the observed voxels
+    __device__ float3 get_normal(float3 p) const
+    {
+        float g[3];
+        float center;
+        bool has_center = sample(p, center);
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            float3 a = p, b = p;
+            if (axis == 0) { a.x -= voxel_size; b.x += voxel_size; }
+            else if (axis == 1) { a.y -= voxel_size; b.y += voxel_size; }
+            else { a.z -= voxel_size; b.z += voxel_size; }
+
+            float fa, fb;
+            bool has_a = sample(a, fa), has_b = sample(b, fb);
+            if (has_a && has_b)
+                g[axis] = fb - fa;
+            else if (has_center && has_b)
+                g[axis] = 2 * (fb - center);
+            else if (has_center && has_a)
+                g[axis] = 2 * (center - fa);
+            else
+                return make_float3(0.f, 0.f, 0.f);
+        }
+        float l = sqrtf(g[0] * g[0] + g[1] * g[1] + g[2] * g[2]);
+        return l > 0 ? make_float3(g[0] / l, g[1] / l, g[2] / l) : make_float3(0.f, 0.f, 0.f);
+    }
+};
+
+// The blocks along the ray of every pixel within the truncation of its depth, at half the size of a block apart.
+// MARK_VISIBLE is false for the pass inserting the blocks, and true for the one collecting the blocks of the frame
+template<bool MARK_VISIBLE>
+__global__
+void kernel_tsdf_blocks(const uint16_t* depth, const rs2_intrinsics intrin, float depth_units, const rs2_extrinsics to_world,
+    float truncation, float block_size, unsigned long long* keys, int* slots, int3* coordinates, tsdf_counters* counters,
+    unsigned int* stamps, unsigned int* visible, unsigned int frame)
+{
+    int i = blockDim.x * blockIdx.x + threadIdx.x;
+    if (i >= intrin.width * intrin.height)
+        return;
+
+    float z = depth[i] * depth_units;
+    if (!z)
+        return;
+
+    int y = i / intrin.width;
+    const float pixel[] = { float(i - y * intrin.width), float(y) };
+    float ray[3];
+    deproject_pixel_to_point_cuda(ray, intrin, pixel, 1.f);
+
+    float near_z = fmaxf(z - truncation, 0.f), far_z = z + truncation;
+    float ray_length = sqrtf(ray[0] * ray[0] + ray[1] * ray[1] + ray[2] * ray[2]);
+    int steps = max(1, (int)ceilf((far_z - near_z) * ray_length / (block_size * 0.5f)));
+    for (int s = 0; s <= steps; ++s)
+    {
+        float d = near_z + (far_z - near_z) * s / steps;
+        float3 p = transform(to_world, make_float3(ray[0] * d, ray[1] * d, ray[2] * d));
+        int bx = (int)floorf(p.x / block_size), by = (int)floorf(p.y / block_size), bz = (int)floorf(p.z / block_size);
+
+        if (MARK_VISIBLE)
+        {
+            int index = find_block(keys, slots, bx, by, bz);
+            if (index >= 0 && atomicExch(&stamps[index], frame) != frame)
+                visible[atomicAdd(&counters->visible, 1u)] = index;
+            continue;
+        }
+
+        auto key = block_key(bx, by, bz);
+        for (unsigned int slot = first_slot(key), probes = 0; probes < RS2_CUDA_TSDF_HASH_SLOTS; slot = (slot + 1) & (RS2_CUDA_TSDF_HASH_SLOTS - 1), ++probes)
+        {
+            auto previous = atomicCAS(&keys[slot], RS2_CUDA_TSDF_EMPTY_KEY, key);
+            if (previous == RS2_CUDA_TSDF_EMPTY_KEY)
+            {
+                // The slots of the blocks beyond the capacity stay at -1, as unallocated
+                unsigned int index = atomicAdd(&counters->blocks, 1u);
+                if (index < RS2_CUDA_TSDF_MAX_BLOCKS)
+                {
+                    slots[slot] = index;
+                    coordinates[index] = make_int3(bx, by, bz);
+                    atomicMin(&counters->low[0], bx); atomicMin(&counters->low[1], by); atomicMin(&counters->low[2], bz);
+                    atomicMax(&counters->high[0], bx); atomicMax(&counters->high[1], by); atomicMax(&counters->high[2], bz);
+                }
+                break;
+            }
+            if (previous == key)
+                break;
+        }
+    }
+}
+
+// One CUDA block per visible block of voxels, one thread per voxel
+__global__
+void kernel_tsdf_integrate(const unsigned int* visible, const int3* coordinates, float2* voxels, const uint16_t* depth,
+    const rs2_intrinsics intrin, float depth_units, const rs2_extrinsics to_world, float voxel_size, float truncation, float max_weight)
+{
+    unsigned int index = visible[blockIdx.x];
+    int3 c = coordinates[index];
+    int i = threadIdx.x & 7, j = (threadIdx.x >> 3) & 7, k = threadIdx.x >> 6;
+
+    float3 center = make_float3((c.x * RS2_CUDA_TSDF_BLOCK_SIDE + i + 0.5f) * voxel_size, (c.y * RS2_CUDA_TSDF_BLOCK_SIDE + j + 0.5f) * voxel_size,
+        (c.z * RS2_CUDA_TSDF_BLOCK_SIDE + k + 0.5f) * voxel_size);
+    float3 point = rotate_inverse(to_world, make_float3(center.x - to_world.translation[0], center.y - to_world.translation[1], center.z - to_world.translation[2]));
+    if (point.z <= 0)
+        return;
+
+    float pixel[2];
+    const float p[] = { point.x, point.y, point.z };
+    project_point_to_pixel_cuda(pixel, intrin, p);
+    int px = (int)floorf(pixel[0] + 0.5f), py = (int)floorf(pixel[1] + 0.5f);
+    if (px < 0 || py < 0 || px >= intrin.width || py >= intrin.height)
+        return;
+
+    float z = depth[py * intrin.width + px] * depth_units;
+    float sdf = z - point.z;
+    if (!z || sdf < -truncation)
+        return;
+
+    float2& v = voxels[index * RS2_CUDA_TSDF_BLOCK_VOXELS + threadIdx.x];
+    float tsdf = fminf(1.f, sdf / truncation);
+    v.x = (v.x * v.y + tsdf) / (v.y + 1);
+    v.y = fminf(v.y + 1, max_weight);
+}
+
+__global__
+void kernel_tsdf_raycast(const tsdf_view volume, const tsdf_counters* counters, const rs2_intrinsics intrin, const rs2_extrinsics to_world,
+    float truncation, float3* vertices, float3* normals)
+{
+    int i = blockDim.x * blockIdx.x + threadIdx.x;
+    if (i >= intrin.width * intrin.height)
+        return;
+
+    vertices[i] = make_float3(0.f, 0.f, 0.f);
+    normals[i] = make_float3(0.f, 0.f, 0.f);
+    if (!counters->blocks)
+        return;
+
+    int y = i / intrin.width;
+    const float pixel[] = { float(i - y * intrin.width), float(y) };
+    float r[3];
+    deproject_pixel_to_point_cuda(r, intrin, pixel, 1.f);
+    float l = sqrtf(r[0] * r[0] + r[1] * r[1] + r[2] * r[2]);
+    float3 ray = make_float3(r[0] / l, r[1] / l, r[2] / l);
+    float3 direction = transform(to_world, ray);
+    float3 origin = make_float3(to_world.translation[0], to_world.translation[1], to_world.translation[2]);
+    direction = make_float3(direction.x - origin.x, direction.y - origin.y, direction.z - origin.z);
+
+    // Marched within the bounds of the blocks
+    const float block_size = volume.voxel_size * RS2_CUDA_TSDF_BLOCK_SIDE;
+    float t0 = 0.f, t1 = FLT_MAX;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        float o = get(origin, axis), d = get(direction, axis);
+        float low = counters->low[axis] * block_size, high = (counters->high[axis] + 1) * block_size;
+        if (fabsf(d) < 1e-9f)
+        {
+            if (o < low || o > high)
+                return;
+            continue;
+        }
+        float ta = (low - o) / d, tb = (high - o) / d;
+        t0 = fmaxf(t0, fminf(ta, tb));
+        t1 = fminf(t1, fmaxf(ta, tb));
+    }
+
+    bool previous = false;
+    float previous_tsdf = 0.f, previous_t = 0.f;
+    for (float t = t0; t <= t1;)
+    {
+        float3 p = make_float3(origin.x + direction.x * t, origin.y + direction.y * t, origin.z + direction.z * t);
+        int vx = (int)floorf(p.x / volume.voxel_size), vy = (int)floorf(p.y / volume.voxel_size), vz = (int)floorf(p.z / volume.voxel_size);
+        if (find_block(volume.keys, volume.slots, floor_div(vx, RS2_CUDA_TSDF_BLOCK_SIDE), floor_div(vy, RS2_CUDA_TSDF_BLOCK_SIDE), floor_div(vz, RS2_CUDA_TSDF_BLOCK_SIDE)) < 0)
+        {
+            previous = false;
+            t += block_size * 0.5f;
+            continue;
+        }
+        auto v = volume.find_voxel(vx, vy, vz);
+        if (!v)
+        {
+            previous = false;
+            t += volume.voxel_size;
+            continue;
+        }
+
+        if (previous && previous_tsdf > 0 && v->x <= 0)
+        {
+            float fa = previous_tsdf, fb = v->x;
+            float sa, sb;
+            float3 pa = make_float3(origin.x + direction.x * previous_t, origin.y + direction.y * previous_t, origin.z + direction.z * previous_t);
+            if (volume.sample(pa, sa) && volume.sample(p, sb) && sa > sb)
+            {
+                fa = sa;
+                fb = sb;
+            }
+            float hit_t = previous_t + (t - previous_t) * fa / (fa - fb);
+            float3 vertex = make_float3(ray.x * hit_t, ray.y * hit_t, ray.z * hit_t);
+            float3 normal = rotate_inverse(to_world, volume.get_normal(make_float3(origin.x + direction.x * hit_t,
+                origin.y + direction.y * hit_t, origin.z + direction.z * hit_t)));
+            if (normal.x * vertex.x + normal.y * vertex.y + normal.z * vertex.z > 0)
+                normal = make_float3(-normal.x, -normal.y, -normal.z);
+            vertices[i] = vertex;
+            normals[i] = normal;
+            return;
+        }
+
+        previous = true;
+        previous_tsdf = v->x;
+        previous_t = t;
+        t += fmaxf(volume.voxel_size, v->x * truncation * 0.8f);
+    }
+}
+
+// One CUDA block per block of voxels, one thread per voxel. Counts the points alone when vertices is null
+__global__
+void kernel_tsdf_extract(const tsdf_view volume, const int3* coordinates, tsdf_counters* counters, float3* vertices)
+{
+    int3 c = coordinates[blockIdx.x];
+    int local[] = { (int)threadIdx.x & 7, ((int)threadIdx.x >> 3) & 7, (int)threadIdx.x >> 6 };
+    const float2& v = volume.voxels[blockIdx.x * RS2_CUDA_TSDF_BLOCK_VOXELS + threadIdx.x];
+    if (!(v.y > 0))
+        return;
+
+    int g[] = { c.x * RS2_CUDA_TSDF_BLOCK_SIDE + local[0], c.y * RS2_CUDA_TSDF_BLOCK_SIDE + local[1], c.z * RS2_CUDA_TSDF_BLOCK_SIDE + local[2] };
+    const int steps[] = { 1, RS2_CUDA_TSDF_BLOCK_SIDE, RS2_CUDA_TSDF_BLOCK_SIDE * RS2_CUDA_TSDF_BLOCK_SIDE };
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        const float2* n = local[axis] + 1 < RS2_CUDA_TSDF_BLOCK_SIDE ? &v + steps[axis] : nullptr;
+        if (n && !(n->y > 0))
+            continue;
+        if (!n)
+            n = volume.find_voxel(g[0] + (axis == 0), g[1] + (axis == 1), g[2] + (axis == 2));
+        if (!n || (v.x > 0) == (n->x > 0) || fabsf(v.x - n->x) >= 1.f)
+            continue;
+
+        unsigned int index = atomicAdd(&counters->points, 1u);
+        if (!vertices)
+            continue;
+
+        float p[] = { (g[0] + 0.5f) * volume.voxel_size, (g[1] + 0.5f) * volume.voxel_size, (g[2] + 0.5f) * volume.voxel_size };
+        p[axis] += volume.voxel_size * v.x / (v.x - n->x);
+        vertices[index] = make_float3(p[0], p[1], p[2]);
+    }
+}
+
+__global__
+void kernel_tsdf_normals(const tsdf_view volume, const float3* vertices, float3* normals, int count)
+{
+    int i = blockDim.x * blockIdx.x + threadIdx.x;
+    if (i >= count)
+        return;
+    normals[i] = volume.get_normal(vertices[i]);
+}
+
+rscuda::tsdf_volume_cuda::tsdf_volume_cuda()
+    : _voxel_size(0.f), _frame(0)
+{
+    cudaError_t result = cudaStreamCreate(&_stream);
+    assert(result == cudaSuccess);
+}
+
+rscuda::tsdf_volume_cuda::~tsdf_volume_cuda()
+{
+    cudaStreamDestroy(_stream);
+}
+
+void rscuda::tsdf_volume_cuda::reset(float voxel_size)
+{
+    _voxel_size = voxel_size;
+    _frame = 0;
+
+    tsdf_counters counters = { 0, 0, 0, { INT_MAX, INT_MAX, INT_MAX }, { INT_MIN, INT_MIN, INT_MIN } };
+    cudaError_t result;
+    result = cudaMemsetAsync(_d_keys.reserve(RS2_CUDA_TSDF_HASH_SLOTS * sizeof(unsigned long long)), 0xff, RS2_CUDA_TSDF_HASH_SLOTS * sizeof(unsigned long long), _stream);
+    assert(result == cudaSuccess);
+    result = cudaMemsetAsync(_d_slots.reserve(RS2_CUDA_TSDF_HASH_SLOTS * sizeof(int)), 0xff, RS2_CUDA_TSDF_HASH_SLOTS * sizeof(int), _stream);
+    assert(result == cudaSuccess);
+    result = cudaMemsetAsync(_d_voxels.reserve(size_t(RS2_CUDA_TSDF_MAX_BLOCKS) * RS2_CUDA_TSDF_BLOCK_VOXELS * sizeof(float2)), 0,
+        size_t(RS2_CUDA_TSDF_MAX_BLOCKS) * RS2_CUDA_TSDF_BLOCK_VOXELS * sizeof(float2), _stream);
+    assert(result == cudaSuccess);
+    result = cudaMemsetAsync(_d_stamps.reserve(RS2_CUDA_TSDF_MAX_BLOCKS * sizeof(unsigned int)), 0, RS2_CUDA_TSDF_MAX_BLOCKS * sizeof(unsigned int), _stream);
+    assert(result == cudaSuccess);
+    _d_coordinates.reserve(RS2_CUDA_TSDF_MAX_BLOCKS * sizeof(int3));
+    _d_visible.reserve(RS2_CUDA_TSDF_MAX_BLOCKS * sizeof(unsigned int));
+    result = cudaMemcpyAsync(_d_counters.reserve(sizeof(tsdf_counters)), &counters, sizeof(counters), cudaMemcpyHostToDevice, _stream);
+    assert(result == cudaSuccess);
+    result = cudaStreamSynchronize(_stream);
+    assert(result == cudaSuccess);
+}
+
+void rscuda::tsdf_volume_cuda::integrate(const uint16_t* h_depth, const uint16_t* d_depth, const rs2_intrinsics& intrinsics, float depth_units,
+    const rs2_extrinsics& camera_to_world, float truncation, float max_weight)
+{
+    int count = intrinsics.width * intrinsics.height;
+    auto dev_depth = d_depth ? d_depth : static_cast<const uint16_t*>(_d_depth.reserve(count * sizeof(uint16_t)));
+    auto keys = static_cast<unsigned long long*>(_d_keys.reserve(RS2_CUDA_TSDF_HASH_SLOTS * sizeof(unsigned long long)));
+    auto slots = static_cast<int*>(_d_slots.reserve(RS2_CUDA_TSDF_HASH_SLOTS * sizeof(int)));
+    auto coordinates = static_cast<int3*>(_d_coordinates.reserve(RS2_CUDA_TSDF_MAX_BLOCKS * sizeof(int3)));
+    auto stamps = static_cast<unsigned int*>(_d_stamps.reserve(RS2_CUDA_TSDF_MAX_BLOCKS * sizeof(unsigned int)));
+    auto visible = static_cast<unsigned int*>(_d_visible.reserve(RS2_CUDA_TSDF_MAX_BLOCKS * sizeof(unsigned int)));
+    auto counters = static_cast<tsdf_counters*>(_d_counters.reserve(sizeof(tsdf_counters)));
+    const float block_size = _voxel_size * RS2_CUDA_TSDF_BLOCK_SIDE;
+    cudaError_t result;
+
+    if (!d_depth)
+    {
+        result = cudaMemcpyAsync(const_cast<uint16_t*>(dev_depth), h_depth, count * sizeof(uint16_t), cudaMemcpyHostToDevice, _stream);
+        assert(result == cudaSuccess);
+    }
+    result = cudaMemsetAsync(&counters->visible, 0, sizeof(unsigned int), _stream);
+    assert(result == cudaSuccess);
+
+    ++_frame;
+    kernel_tsdf_blocks<false><<<blocks_for(count), RS2_CUDA_THREADS_PER_BLOCK, 0, _stream>>>(dev_depth, intrinsics, depth_units, camera_to_world,
+        truncation, block_size, keys, slots, coordinates, counters, stamps, visible, _frame);
+    kernel_tsdf_blocks<true><<<blocks_for(count), RS2_CUDA_THREADS_PER_BLOCK, 0, _stream>>>(dev_depth, intrinsics, depth_units, camera_to_world,
+        truncation, block_size, keys, slots, coordinates, counters, stamps, visible, _frame);
+
+    tsdf_counters h_counters;
+    result = cudaMemcpyAsync(&h_counters, counters, sizeof(h_counters), cudaMemcpyDeviceToHost, _stream);
+    assert(result == cudaSuccess);
+    result = cudaStreamSynchronize(_stream);
+    assert(result == cudaSuccess);
+
+    if (h_counters.visible)
+    {
+        kernel_tsdf_integrate<<<h_counters.visible, RS2_CUDA_TSDF_BLOCK_VOXELS, 0, _stream>>>(visible, coordinates,
+            static_cast<float2*>(_d_voxels.reserve(size_t(RS2_CUDA_TSDF_MAX_BLOCKS) * RS2_CUDA_TSDF_BLOCK_VOXELS * sizeof(float2))),
+            dev_depth, intrinsics, depth_units, camera_to_world, _voxel_size, truncation, max_weight);
+    }
+
+    // The depth is released by the caller once the frame is integrated
+    result = cudaStreamSynchronize(_stream);
+    assert(result == cudaSuccess);
+}
+
+void rscuda::tsdf_volume_cuda::raycast(const rs2_intrinsics& intrinsics, const rs2_extrinsics& camera_to_world, float truncation,
+    float* h_vertices, float* h_normals)
+{
+    int count = intrinsics.width * intrinsics.height;
+    tsdf_view volume = { static_cast<const unsigned long long*>(_d_keys.reserve(RS2_CUDA_TSDF_HASH_SLOTS * sizeof(unsigned long long))),
+        static_cast<const int*>(_d_slots.reserve(RS2_CUDA_TSDF_HASH_SLOTS * sizeof(int))),
+        static_cast<const float2*>(_d_voxels.reserve(size_t(RS2_CUDA_TSDF_MAX_BLOCKS) * RS2_CUDA_TSDF_BLOCK_VOXELS * sizeof(float2))), _voxel_size };
+    auto vertices = static_cast<float3*>(_d_vertices.reserve(count * sizeof(float3)));
+    auto normals = static_cast<float3*>(_d_normals.reserve(count * sizeof(float3)));
+
+    kernel_tsdf_raycast<<<blocks_for(count), RS2_CUDA_THREADS_PER_BLOCK, 0, _stream>>>(volume,
+        static_cast<const tsdf_counters*>(_d_counters.reserve(sizeof(tsdf_counters))), intrinsics, camera_to_world, truncation, vertices, normals);
+
+    cudaError_t result;
+    result = cudaMemcpyAsync(h_vertices, vertices, count * sizeof(float3), cudaMemcpyDeviceToHost, _stream);
+    assert(result == cudaSuccess);
+    result = cudaMemcpyAsync(h_normals, normals, count * sizeof(float3), cudaMemcpyDeviceToHost, _stream);
+    assert(result == cudaSuccess);
+    result = cudaStreamSynchronize(_stream);
+    assert(result == cudaSuccess);
+}
+
+void rscuda::tsdf_volume_cuda::extract_points(std::vector<float>& h_vertices, std::vector<float>& h_normals)
+{
+    tsdf_view volume = { static_cast<const unsigned long long*>(_d_keys.reserve(RS2_CUDA_TSDF_HASH_SLOTS * sizeof(unsigned long long))),
+        static_cast<const int*>(_d_slots.reserve(RS2_CUDA_TSDF_HASH_SLOTS * sizeof(int))),
+        static_cast<const float2*>(_d_voxels.reserve(size_t(RS2_CUDA_TSDF_MAX_BLOCKS) * RS2_CUDA_TSDF_BLOCK_VOXELS * sizeof(float2))), _voxel_size };
+    auto coordinates = static_cast<const int3*>(_d_coordinates.reserve(RS2_CUDA_TSDF_MAX_BLOCKS * sizeof(int3)));
+    auto counters = static_cast<tsdf_counters*>(_d_counters.reserve(sizeof(tsdf_counters)));
+    cudaError_t result;
+
+    tsdf_counters h_counters;
+    result = cudaMemsetAsync(&counters->points, 0, sizeof(unsigned int), _stream);
+    assert(result == cudaSuccess);
+    result = cudaMemcpyAsync(&h_counters, counters, sizeof(h_counters), cudaMemcpyDeviceToHost, _stream);
+    assert(result == cudaSuccess);
+    result = cudaStreamSynchronize(_stream);
+    assert(result == cudaSuccess);
+
+    h_vertices.clear();
+    h_normals.clear();
+    unsigned int blocks = h_counters.blocks < RS2_CUDA_TSDF_MAX_BLOCKS ? h_counters.blocks : RS2_CUDA_TSDF_MAX_BLOCKS;
+    if (!blocks)
+        return;
+
+    // Counted first, for the points to be written into a buffer of their size
+    kernel_tsdf_extract<<<blocks, RS2_CUDA_TSDF_BLOCK_VOXELS, 0, _stream>>>(volume, coordinates, counters, nullptr);
+    unsigned int count;
+    result = cudaMemcpyAsync(&count, &counters->points, sizeof(count), cudaMemcpyDeviceToHost, _stream);
+    assert(result == cudaSuccess);
+    result = cudaMemsetAsync(&counters->points, 0, sizeof(unsigned int), _stream);
+    assert(result == cudaSuccess);
+    result = cudaStreamSynchronize(_stream);
+    assert(result == cudaSuccess);
+    if (!count)
+        return;
+
+    auto vertices = static_cast<float3*>(_d_vertices.reserve(count * sizeof(float3)));
+    auto normals = static_cast<float3*>(_d_normals.reserve(count * sizeof(float3)));
+    kernel_tsdf_extract<<<blocks, RS2_CUDA_TSDF_BLOCK_VOXELS, 0, _stream>>>(volume, coordinates, counters, vertices);
+    kernel_tsdf_normals<<<blocks_for(count), RS2_CUDA_THREADS_PER_BLOCK, 0, _stream>>>(volume, vertices, normals, count);
+
+    h_vertices.resize(count * 3);
+    h_normals.resize(count * 3);
+    result = cudaMemcpyAsync(h_vertices.data(), vertices, count * sizeof(float3), cudaMemcpyDeviceToHost, _stream);
+    assert(result == cudaSuccess);
+    result = cudaMemcpyAsync(h_normals.data(), normals, count * sizeof(float3), cudaMemcpyDeviceToHost, _stream);
+    assert(result == cudaSuccess);
+    result = cudaStreamSynchronize(_stream);
+    assert(result == cudaSuccess);
+}
+
+#endif // RS2_USE_CUDA
@@ -0,0 +1,71 @@
+#pragma once
+#ifndef LIBREALSENSE_CUDA_TSDF_H
+#define LIBREALSENSE_CUDA_TSDF_H
+
+#ifdef RS2_USE_CUDA
+
+// Types
+#include <stdint.h>
+#include <vector>
+#include "../../include/librealsense2/rs.h"
+#include "assert.h"
+
+// CUDA headers
+#include <cuda_runtime.h>
+
+// Device buffers
+#include "cuda-align.cuh"
+
+#ifdef _MSC_VER
+// Add library dependencies if using VS
+#pragma comment(lib, "cudart_static")
+#endif
+
+namespace rscuda
+{
+    // The truncated signed distance volume of the TSDF fusion block, with the same blocks of 8x8x8 voxels as on the CPU,
+    // in device memory. The blocks are found through a hash table of open addressing, allocated with atomics by the pixels
+    // of the depth. The capacity of blocks is fixed, and the blocks beyond it are not allocated
+    class tsdf_volume_cuda
+    {
+    public:
+        tsdf_volume_cuda();
+        ~tsdf_volume_cuda();
+
+        void reset(float voxel_size);
+
+        // Depth already in device memory is passed as d_depth, otherwise h_depth is uploaded
+        void integrate(const uint16_t* h_depth, const uint16_t* d_depth, const rs2_intrinsics& intrinsics, float depth_units,
+            const rs2_extrinsics& camera_to_world, float truncation, float max_weight);
+
+        // Into width * height host vertices and normals, of 3 floats each
+        void raycast(const rs2_intrinsics& intrinsics, const rs2_extrinsics& camera_to_world, float truncation,
+            float* h_vertices, float* h_normals);
+
+        // Zero crossings between neighbouring voxels, 3 floats each
+        void extract_points(std::vector<float>& h_vertices, std::vector<float>& h_normals);
+
+    private:
+        tsdf_volume_cuda(const tsdf_volume_cuda&) = delete;
+        tsdf_volume_cuda& operator=(const tsdf_volume_cuda&) = delete;
+
+        cudaStream_t _stream;
+        float _voxel_size;
+        uint32_t _frame;
+
+        device_buffer _d_keys;          // Block coordinates of every slot of the hash
+        device_buffer _d_slots;         // Block of every slot
+        device_buffer _d_coordinates;   // Coordinates of every block
+        device_buffer _d_voxels;
+        device_buffer _d_stamps;        // Frame every block was last seen by
+        device_buffer _d_visible;
+        device_buffer _d_counters;      // Blocks, visible blocks and extracted points, then the bounds of the blocks
+        device_buffer _d_depth;
+        device_buffer _d_vertices;
+        device_buffer _d_normals;
+    };
+}
+
+#endif // RS2_USE_CUDA
+
+#endif // LIBREALSENSE_CUDA_TSDF_H
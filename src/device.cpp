@@ -227,6 +227,13 @@ void device::hardware_reset()
     throw not_implemented_exception(to_string() << __FUNCTION__ << " is not implemented for this device!");
 }
 
+void device::invalidate_controls()
+{
+    for (auto&& s : _sensors)
+        if (auto uvc = dynamic_cast<uvc_sensor*>(s.get()))
+            uvc->invalidate_controls();
+}
+
 std::shared_ptr<matcher> librealsense::device::create_matcher(const frame_holder& frame) const
 {
 
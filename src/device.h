@@ -51,6 +51,9 @@ namespace librealsense
 
         void hardware_reset() override;
 
+        // The controls of the sensors changed behind the values their options cached
+        void invalidate_controls();
+
         virtual std::shared_ptr<matcher> create_matcher(const frame_holder& frame) const override;
 
         size_t find_sensor_idx(const sensor_interface& s) const;
@@ -662,90 +662,144 @@ namespace librealsense
 
     preset ds5_advanced_mode_base::get_all() const
     {
-        preset p;
-        get_depth_control_group(&p.depth_controls);
-        get_rsm(&p.rsm);
-        get_rau_support_vector_control(&p.rsvc);
-        get_color_control(&p.color_control);
-        get_rau_color_thresholds_control(&p.rctc);
-        get_slo_color_thresholds_control(&p.sctc);
-        get_slo_penalty_control(&p.spc);
-        get_hdad(&p.hdad);
-        get_color_correction(&p.cc);
-        get_depth_table_control(&p.depth_table);
-        get_ae_control(&p.ae);
-        get_census_radius(&p.census);
-        get_laser_power(&p.laser_power);
-        get_laser_state(&p.laser_state);
-        get_depth_exposure(&p.depth_exposure);
-        get_depth_auto_exposure(&p.depth_auto_exposure);
-        get_depth_gain(&p.depth_gain);
-        get_depth_auto_white_balance(&p.depth_auto_white_balance);
-        get_color_exposure(&p.color_exposure);
-        get_color_auto_exposure(&p.color_auto_exposure);
-        get_color_backlight_compensation(&p.color_backlight_compensation);
-        get_color_brightness(&p.color_brightness);
-        get_color_contrast(&p.color_contrast);
-        get_color_gain(&p.color_gain);
-        get_color_gamma(&p.color_gamma);
-        get_color_hue(&p.color_hue);
-        get_color_saturation(&p.color_saturation);
-        get_color_sharpness(&p.color_sharpness);
-        get_color_white_balance(&p.color_white_balance);
-        get_color_auto_white_balance(&p.color_auto_white_balance);
-        get_color_power_line_frequency(&p.color_power_line_frequency);
-        return p;
+        // Keep the device powered and the monitor held for all the commands of the preset, instead of once per command
+        return _hw_monitor->batch([&]()
+        {
+            preset p;
+            if (!load_tables(p))
+            {
+                get_depth_control_group(&p.depth_controls);
+                get_rsm(&p.rsm);
+                get_rau_support_vector_control(&p.rsvc);
+                get_color_control(&p.color_control);
+                get_rau_color_thresholds_control(&p.rctc);
+                get_slo_color_thresholds_control(&p.sctc);
+                get_slo_penalty_control(&p.spc);
+                get_hdad(&p.hdad);
+                get_color_correction(&p.cc);
+                get_depth_table_control(&p.depth_table);
+                get_ae_control(&p.ae);
+                get_census_radius(&p.census);
+            }
+            get_laser_power(&p.laser_power);
+            get_laser_state(&p.laser_state);
+            get_depth_exposure(&p.depth_exposure);
+            get_depth_auto_exposure(&p.depth_auto_exposure);
+            get_depth_gain(&p.depth_gain);
+            get_depth_auto_white_balance(&p.depth_auto_white_balance);
+            get_color_exposure(&p.color_exposure);
+            get_color_auto_exposure(&p.color_auto_exposure);
+            get_color_backlight_compensation(&p.color_backlight_compensation);
+            get_color_brightness(&p.color_brightness);
+            get_color_contrast(&p.color_contrast);
+            get_color_gain(&p.color_gain);
+            get_color_gamma(&p.color_gamma);
+            get_color_hue(&p.color_hue);
+            get_color_saturation(&p.color_saturation);
+            get_color_sharpness(&p.color_sharpness);
+            get_color_white_balance(&p.color_white_balance);
+            get_color_auto_white_balance(&p.color_auto_white_balance);
+            get_color_power_line_frequency(&p.color_power_line_frequency);
+            store_tables(p);
+            return p;
+        });
     }
 
     void ds5_advanced_mode_base::set_all(const preset& p)
     {
-        set(p.depth_controls, advanced_mode_traits<STDepthControlGroup>::group);
-        set(p.rsm           , advanced_mode_traits<STRsm>::group);
-        set(p.rsvc          , advanced_mode_traits<STRauSupportVectorControl>::group);
-        set(p.color_control , advanced_mode_traits<STColorControl>::group);
-        set(p.rctc          , advanced_mode_traits<STRauColorThresholdsControl>::group);
-        set(p.sctc          , advanced_mode_traits<STSloColorThresholdsControl>::group);
-        set(p.spc           , advanced_mode_traits<STSloPenaltyControl>::group);
-        set(p.hdad          , advanced_mode_traits<STHdad>::group);
-
-        // Setting auto-white-balance control before colorCorrection parameters
-        set_depth_auto_white_balance(p.depth_auto_white_balance);
-        set(p.cc            , advanced_mode_traits<STColorCorrection>::group);
-
-        set(p.depth_table   , advanced_mode_traits<STDepthTableControl>::group);
-        set(p.ae            , advanced_mode_traits<STAEControl>::group);
-        set(p.census        , advanced_mode_traits<STCensusRadius>::group);
-
-        set_laser_state(p.laser_state);
-        if (p.laser_state.was_set && p.laser_state.laser_state == 1) // 1 - on
-            set_laser_power(p.laser_power);
-
-        set_depth_auto_exposure(p.depth_auto_exposure);
-        if (p.depth_auto_exposure.was_set && p.depth_auto_exposure.auto_exposure == 0)
+        // Keep the device powered and the monitor held for all the commands of the preset, instead of once per command
+        _hw_monitor->batch([&]()
         {
-            set_depth_gain(p.depth_gain);
-            set_depth_exposure(p.depth_exposure);
-        }
+            // Only the tables that differ from those the device is known to have are written. They are sent back-to-back,
+            // and the firmware is given time to apply them once per run instead of once per table
+            preset current;
+            auto known = load_tables(current);
+
+            auto written = false;
+            written |= write_if_changed(p.depth_controls, current.depth_controls, known, advanced_mode_traits<STDepthControlGroup>::group);
+            written |= write_if_changed(p.rsm           , current.rsm           , known, advanced_mode_traits<STRsm>::group);
+            written |= write_if_changed(p.rsvc          , current.rsvc          , known, advanced_mode_traits<STRauSupportVectorControl>::group);
+            written |= write_if_changed(p.color_control , current.color_control , known, advanced_mode_traits<STColorControl>::group);
+            written |= write_if_changed(p.rctc          , current.rctc          , known, advanced_mode_traits<STRauColorThresholdsControl>::group);
+            written |= write_if_changed(p.sctc          , current.sctc          , known, advanced_mode_traits<STSloColorThresholdsControl>::group);
+            written |= write_if_changed(p.spc           , current.spc           , known, advanced_mode_traits<STSloPenaltyControl>::group);
+            written |= write_if_changed(p.hdad          , current.hdad          , known, advanced_mode_traits<STHdad>::group);
+            if (written)
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+            // Setting auto-white-balance control before colorCorrection parameters
+            set_depth_auto_white_balance(p.depth_auto_white_balance);
+
+            written = false;
+            written |= write_if_changed(p.cc            , current.cc            , known, advanced_mode_traits<STColorCorrection>::group);
+            written |= write_if_changed(p.depth_table   , current.depth_table   , known, advanced_mode_traits<STDepthTableControl>::group);
+            written |= write_if_changed(p.ae            , current.ae            , known, advanced_mode_traits<STAEControl>::group);
+            written |= write_if_changed(p.census        , current.census        , known, advanced_mode_traits<STCensusRadius>::group);
+            if (written)
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+            set_laser_state(p.laser_state);
+            if (p.laser_state.was_set && p.laser_state.laser_state == 1) // 1 - on
+                set_laser_power(p.laser_power);
+
+            set_depth_auto_exposure(p.depth_auto_exposure);
+            if (p.depth_auto_exposure.was_set && p.depth_auto_exposure.auto_exposure == 0)
+            {
+                set_depth_gain(p.depth_gain);
+                set_depth_exposure(p.depth_exposure);
+            }
+
+            set_color_auto_exposure(p.color_auto_exposure);
+            if (p.color_auto_exposure.was_set && p.color_auto_exposure.auto_exposure == 0)
+                set_color_exposure(p.color_exposure);
+
+            set_color_backlight_compensation(p.color_backlight_compensation);
+            set_color_brightness(p.color_brightness);
+            set_color_contrast(p.color_contrast);
+            set_color_gain(p.color_gain);
+            set_color_gamma(p.color_gamma);
+            set_color_hue(p.color_hue);
+            set_color_saturation(p.color_saturation);
+            set_color_sharpness(p.color_sharpness);
 
-        set_color_auto_exposure(p.color_auto_exposure);
-        if (p.color_auto_exposure.was_set && p.color_auto_exposure.auto_exposure == 0)
-            set_color_exposure(p.color_exposure);
-
-        set_color_backlight_compensation(p.color_backlight_compensation);
-        set_color_brightness(p.color_brightness);
-        set_color_contrast(p.color_contrast);
-        set_color_gain(p.color_gain);
-        set_color_gamma(p.color_gamma);
-        set_color_hue(p.color_hue);
-        set_color_saturation(p.color_saturation);
-        set_color_sharpness(p.color_sharpness);
-
-        set_color_auto_white_balance(p.color_auto_white_balance);
-        if (p.color_auto_white_balance.was_set && p.color_auto_white_balance.auto_white_balance == 0)
-            set_color_white_balance(p.color_white_balance);
-
-        // TODO: W/O due to a FW bug of power_line_frequency control on Windows OS
-        //set_color_power_line_frequency(p.color_power_line_frequency);
+            set_color_auto_white_balance(p.color_auto_white_balance);
+            if (p.color_auto_white_balance.was_set && p.color_auto_white_balance.auto_white_balance == 0)
+                set_color_white_balance(p.color_white_balance);
+
+            // TODO: W/O due to a FW bug of power_line_frequency control on Windows OS
+            //set_color_power_line_frequency(p.color_power_line_frequency);
+
+            // The firmware may clamp or reject what was written, so the tables are only known again once read back
+            _are_tables_known = false;
+        });
+    }
+
+    bool ds5_advanced_mode_base::load_tables(preset& p) const
+    {
+        // Every command and every write of a control of the depth sensor changes its generation, those of this batch included
+        if (!_are_tables_known || _tables_generation != _depth_sensor.get_controls_generation())
+            return false;
+
+        p.depth_controls = _tables.depth_controls;
+        p.rsm            = _tables.rsm;
+        p.rsvc           = _tables.rsvc;
+        p.color_control  = _tables.color_control;
+        p.rctc           = _tables.rctc;
+        p.sctc           = _tables.sctc;
+        p.spc            = _tables.spc;
+        p.hdad           = _tables.hdad;
+        p.cc             = _tables.cc;
+        p.depth_table    = _tables.depth_table;
+        p.ae             = _tables.ae;
+        p.census         = _tables.census;
+        return true;
+    }
+
+    void ds5_advanced_mode_base::store_tables(const preset& p) const
+    {
+        _tables = p;
+        _tables_generation = _depth_sensor.get_controls_generation();
+        _are_tables_known = true;
     }
 
     std::vector<uint8_t> ds5_advanced_mode_base::send_receive(const std::vector<uint8_t>& input) const
@@ -51,21 +51,26 @@ namespace librealsense
 
         _color_device_idx = add_sensor(color_ep);
 
-        color_ep->register_pixel_format(pf_yuyv);
-        color_ep->register_pixel_format(pf_yuy2);
+        if (ds::downscaled_color_pid.count(color_devices_info.front().pid))
+        {
+            color_ep->register_pixel_format(pf_yuyv_downscaled);
+            color_ep->register_pixel_format(pf_yuy2_downscaled);
+        }
+        else
+        {
+            color_ep->register_pixel_format(pf_yuyv);
+            color_ep->register_pixel_format(pf_yuy2);
+        }
         color_ep->register_pixel_format(pf_bayer16);
 
-        color_ep->register_pu(RS2_OPTION_BACKLIGHT_COMPENSATION);
-        color_ep->register_pu(RS2_OPTION_BRIGHTNESS);
-        color_ep->register_pu(RS2_OPTION_CONTRAST);
-        color_ep->register_pu(RS2_OPTION_GAIN);
-        color_ep->register_pu(RS2_OPTION_GAMMA);
-        color_ep->register_pu(RS2_OPTION_HUE);
-        color_ep->register_pu(RS2_OPTION_SATURATION);
-        color_ep->register_pu(RS2_OPTION_SHARPNESS);
-
-        auto white_balance_option = std::make_shared<uvc_pu_option>(*color_ep, RS2_OPTION_WHITE_BALANCE);
-        auto auto_white_balance_option = std::make_shared<uvc_pu_option>(*color_ep, RS2_OPTION_ENABLE_AUTO_WHITE_BALANCE);
+        // The processing units are cached, only the host changing them but for the gain, which the auto exposure picks
+        for (auto id : { RS2_OPTION_BACKLIGHT_COMPENSATION, RS2_OPTION_BRIGHTNESS, RS2_OPTION_CONTRAST, RS2_OPTION_GAMMA,
+                         RS2_OPTION_HUE, RS2_OPTION_SATURATION, RS2_OPTION_SHARPNESS, RS2_OPTION_AUTO_EXPOSURE_PRIORITY })
+            color_ep->register_option(id, std::make_shared<uvc_pu_option>(*color_ep, id, option_cache::policy::persistent));
+        color_ep->register_option(RS2_OPTION_GAIN, std::make_shared<uvc_pu_option>(*color_ep, RS2_OPTION_GAIN, option_cache::policy::transient));
+
+        auto white_balance_option = std::make_shared<uvc_pu_option>(*color_ep, RS2_OPTION_WHITE_BALANCE, option_cache::policy::transient);
+        auto auto_white_balance_option = std::make_shared<uvc_pu_option>(*color_ep, RS2_OPTION_ENABLE_AUTO_WHITE_BALANCE, option_cache::policy::persistent);
         color_ep->register_option(RS2_OPTION_WHITE_BALANCE, white_balance_option);
         color_ep->register_option(RS2_OPTION_ENABLE_AUTO_WHITE_BALANCE, auto_white_balance_option);
         color_ep->register_option(RS2_OPTION_WHITE_BALANCE,
@@ -73,8 +78,8 @@ namespace librealsense
                 white_balance_option,
                 auto_white_balance_option));
 
-        auto exposure_option = std::make_shared<uvc_pu_option>(*color_ep, RS2_OPTION_EXPOSURE);
-        auto auto_exposure_option = std::make_shared<uvc_pu_option>(*color_ep, RS2_OPTION_ENABLE_AUTO_EXPOSURE);
+        auto exposure_option = std::make_shared<uvc_pu_option>(*color_ep, RS2_OPTION_EXPOSURE, option_cache::policy::transient);
+        auto auto_exposure_option = std::make_shared<uvc_pu_option>(*color_ep, RS2_OPTION_ENABLE_AUTO_EXPOSURE, option_cache::policy::persistent);
         color_ep->register_option(RS2_OPTION_EXPOSURE, exposure_option);
         color_ep->register_option(RS2_OPTION_ENABLE_AUTO_EXPOSURE, auto_exposure_option);
         color_ep->register_option(RS2_OPTION_EXPOSURE,
@@ -87,9 +92,7 @@ namespace librealsense
                 std::map<float, std::string>{ { 0.f, "Disabled"},
                 { 1.f, "50Hz" },
                 { 2.f, "60Hz" },
-                { 3.f, "Auto" }, }));
-
-        color_ep->register_pu(RS2_OPTION_AUTO_EXPOSURE_PRIORITY);
+                { 3.f, "Auto" }, }, option_cache::policy::persistent));
 
         color_ep->register_metadata(RS2_FRAME_METADATA_FRAME_TIMESTAMP, make_uvc_header_parser(&platform::uvc_header::timestamp));
         color_ep->register_metadata(RS2_FRAME_METADATA_ACTUAL_FPS,  std::make_shared<ds5_md_attribute_actual_fps> (false, [](const rs2_metadata_type& param)
@@ -69,10 +69,19 @@ namespace librealsense
         return _hw_monitor->send(input);
     }
 
+    std::vector<std::future<std::vector<uint8_t>>> ds5_device::send_receive_raw_data_async(const std::vector<std::vector<uint8_t>>& inputs)
+    {
+        std::vector<std::future<std::vector<uint8_t>>> results;
+        for (auto&& input : inputs)
+            results.push_back(_hw_monitor->send_async(input));
+        return results;
+    }
+
     void ds5_device::hardware_reset()
     {
         command cmd(ds::HWRST);
         _hw_monitor->send(cmd);
+        invalidate_controls();
     }
 
     class ds5_depth_sensor : public uvc_sensor, public video_sensor_interface, public depth_stereo_sensor, public roi_sensor_base
@@ -274,8 +283,15 @@ namespace librealsense
 
     std::vector<uint8_t> ds5_device::get_raw_calibration_table(ds::calibration_table_id table_id) const
     {
+        std::vector<uint8_t> table;
+        if (_calibration_cache && _calibration_cache->load(table_id, table))
+            return table;
+
         command cmd(ds::GETINTCAL, table_id);
-        return _hw_monitor->send(cmd);
+        table = _hw_monitor->send(cmd);
+        if (_calibration_cache)
+            _calibration_cache->store(table_id, table);
+        return table;
     }
 
     std::shared_ptr<uvc_sensor> ds5_device::create_depth_device(std::shared_ptr<context> ctx,
@@ -354,9 +370,13 @@ namespace librealsense
         _coefficients_table_raw = [this]() { return get_raw_calibration_table(coefficients_table_id); };
 
         std::string device_name = (rs400_sku_names.end() != rs400_sku_names.find(group.uvc_devices.front().pid)) ? rs400_sku_names.at(group.uvc_devices.front().pid) : "RS4xx";
-        _fw_version = firmware_version(_hw_monitor->get_firmware_version_string(GVD, camera_fw_version_offset));
+        std::vector<uint8_t> gvd_buff(HW_MONITOR_BUFFER_SIZE);
+        _hw_monitor->get_gvd(gvd_buff.size(), gvd_buff.data(), GVD);
+        _fw_version = firmware_version(hw_monitor::get_firmware_version_string(gvd_buff, camera_fw_version_offset));
         recommended_fw_version = firmware_version("5.10.3.0");
-        auto serial = _hw_monitor->get_module_serial_string(GVD, module_serial_offset);
+        auto serial = hw_monitor::get_module_serial_string(gvd_buff, module_serial_offset);
+        if (calibration_cache::is_enabled())
+            _calibration_cache = std::make_shared<calibration_cache>(serial, _fw_version);
 
         auto& depth_ep = get_depth_sensor();
         auto advanced_mode = is_camera_in_advanced_mode();
@@ -386,7 +406,7 @@ namespace librealsense
         std::string is_camera_locked{ "" };
         if (_fw_version >= firmware_version("5.6.3.0"))
         {
-            auto is_locked = _hw_monitor->is_camera_locked(GVD, is_camera_locked_offset);
+            auto is_locked = hw_monitor::is_camera_locked(gvd_buff, is_camera_locked_offset);
             is_camera_locked = (is_locked) ? "YES" : "NO";
 
 #ifdef HWM_OVER_XU
@@ -400,17 +420,19 @@ namespace librealsense
                         get_depth_sensor()));
             }
 #endif
-            depth_ep.register_pu(RS2_OPTION_GAIN);
+            depth_ep.register_option(RS2_OPTION_GAIN, std::make_shared<uvc_pu_option>(depth_ep, RS2_OPTION_GAIN, option_cache::policy::transient));
             auto exposure_option = std::make_shared<uvc_xu_option<uint32_t>>(depth_ep,
                 depth_xu,
                 DS5_EXPOSURE,
                 "Depth Exposure (usec)");
+            exposure_option->set_cache_policy(option_cache::policy::transient);
             depth_ep.register_option(RS2_OPTION_EXPOSURE, exposure_option);
 
             auto enable_auto_exposure = std::make_shared<uvc_xu_option<uint8_t>>(depth_ep,
                 depth_xu,
                 DS5_ENABLE_AUTO_EXPOSURE,
                 "Enable Auto Exposure");
+            enable_auto_exposure->set_cache_policy(option_cache::policy::persistent);
             depth_ep.register_option(RS2_OPTION_ENABLE_AUTO_EXPOSURE, enable_auto_exposure);
 
 
@@ -422,9 +444,10 @@ namespace librealsense
 
         if (_fw_version >= firmware_version("5.5.8.0"))
         {
-            depth_ep.register_option(RS2_OPTION_OUTPUT_TRIGGER_ENABLED,
-                std::make_shared<uvc_xu_option<uint8_t>>(depth_ep, depth_xu, DS5_EXT_TRIGGER,
-                    "Generate trigger from the camera to external device once per frame"));
+            auto output_trigger = std::make_shared<uvc_xu_option<uint8_t>>(depth_ep, depth_xu, DS5_EXT_TRIGGER,
+                "Generate trigger from the camera to external device once per frame");
+            output_trigger->set_cache_policy(option_cache::policy::persistent);
+            depth_ep.register_option(RS2_OPTION_OUTPUT_TRIGGER_ENABLED, output_trigger);
 
             auto error_control = std::unique_ptr<uvc_xu_option<uint8_t>>(new uvc_xu_option<uint8_t>(depth_ep, depth_xu, DS5_ERROR_REPORTING, "Error reporting"));
 
@@ -639,6 +662,7 @@ namespace librealsense
                 depth_xu,
                 DS5_LASER_POWER,
                 "Manual laser power in mw. applicable only when laser power mode is set to Manual");
+            laser_power->set_cache_policy(option_cache::policy::persistent);
             depth_ep.register_option(RS2_OPTION_LASER_POWER,
                 std::make_shared<auto_disabling_control>(
                     laser_power,
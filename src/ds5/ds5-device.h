@@ -28,6 +28,7 @@ namespace librealsense
                    const platform::backend_device_group& group);
 
         std::vector<uint8_t> send_receive_raw_data(const std::vector<uint8_t>& input) override;
+        std::vector<std::future<std::vector<uint8_t>>> send_receive_raw_data_async(const std::vector<std::vector<uint8_t>>& inputs) override;
 
         void hardware_reset() override;
         void create_snapshot(std::shared_ptr<debug_interface>& snapshot) const override;
@@ -58,6 +59,7 @@ namespace librealsense
         uint8_t _depth_device_idx;
 
         lazy<std::vector<uint8_t>> _coefficients_table_raw;
+        std::shared_ptr<calibration_cache> _calibration_cache;   // Set when LRS_CALIBRATION_CACHE names a directory
 
         std::unique_ptr<polling_error_handler> _polling_error_handler;
         std::shared_ptr<lazy<rs2_extrinsics>> _left_right_extrinsics;
@@ -67,6 +67,13 @@ namespace librealsense
             ds::RS435_RGB_PID
         };
 
+        // The color sensors whose intrinsics are computed from a normalized calibration, holding at the downscaled resolutions too
+        static const std::set<std::uint16_t> downscaled_color_pid = {
+            ds::RS415_PID,
+            ds::RS430_MM_RGB_PID,
+            ds::RS435_RGB_PID
+        };
+
         static const std::map<std::uint16_t, std::string> rs400_sku_names = {
             { RS400_PID,        "Intel RealSense D400"},
             { RS400_MM_PID,     "Intel RealSense D400 with Tracking Module"},
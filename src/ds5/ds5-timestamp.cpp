@@ -15,16 +15,23 @@
 
 namespace librealsense
 {
+    namespace
+    {
+        // The depth and the other streams of a UVC interface are of pins of their own
+        int pin_of(const request_mapping& mode)
+        {
+            return mode.pf->fourcc == 0x5a313620 ? 1 : 0; // Z16
+        }
+    }
+
     ds5_timestamp_reader_from_metadata::ds5_timestamp_reader_from_metadata(std::unique_ptr<frame_timestamp_reader> backup_timestamp_reader)
-        :_backup_timestamp_reader(std::move(backup_timestamp_reader)), _has_metadata(pins), one_time_note(false)
+        :_backup_timestamp_reader(std::move(backup_timestamp_reader)), one_time_note(false)
     {
         reset();
     }
 
-    bool ds5_timestamp_reader_from_metadata::has_metadata(const request_mapping& mode, const void * metadata, size_t metadata_size)
+    bool ds5_timestamp_reader_from_metadata::has_metadata(const request_mapping& mode, const void * metadata, size_t metadata_size) const
     {
-        std::lock_guard<std::recursive_mutex> lock(_mtx);
-
         if(metadata == nullptr || metadata_size == 0)
         {
             return false;
@@ -40,29 +47,29 @@ namespace librealsense
         return false;
     }
 
-    rs2_time_t ds5_timestamp_reader_from_metadata::get_frame_timestamp(const request_mapping& mode, const platform::frame_object& fo)
+    bool ds5_timestamp_reader_from_metadata::pin_has_metadata(const request_mapping& mode, const platform::frame_object& fo)
     {
-        std::lock_guard<std::recursive_mutex> lock(_mtx);
-        auto pin_index = 0;
-        if (mode.pf->fourcc == 0x5a313620) // Z16
-            pin_index = 1;
-
-        if(!_has_metadata[pin_index])
-        {
-           _has_metadata[pin_index] = has_metadata(mode, fo.metadata, fo.metadata_size);
-        }
+        auto pin_index = pin_of(mode);
+        if (_has_metadata[pin_index].load(std::memory_order_relaxed))
+            return true;
+        if (!has_metadata(mode, fo.metadata, fo.metadata_size))
+            return false;
+        _has_metadata[pin_index] = true;
+        return true;
+    }
 
+    rs2_time_t ds5_timestamp_reader_from_metadata::get_frame_timestamp(const request_mapping& mode, const platform::frame_object& fo)
+    {
         auto md = (librealsense::metadata_intel_basic*)(fo.metadata);
-        if(_has_metadata[pin_index] && md)
+        if(pin_has_metadata(mode, fo) && md)
         {
             return (double)(md->header.timestamp)*TIMESTAMP_USEC_TO_MSEC;
         }
         else
         {
-            if (!one_time_note)
+            if (!one_time_note.exchange(true))
             {
                 LOG_WARNING("UVC metadata payloads not available. Please refer to installation chapter for details.");
-                one_time_note = true;
             }
             return _backup_timestamp_reader->get_frame_timestamp(mode, fo);
         }
@@ -70,12 +77,7 @@ namespace librealsense
 
     unsigned long long ds5_timestamp_reader_from_metadata::get_frame_counter(const request_mapping & mode, const platform::frame_object& fo) const
     {
-        std::lock_guard<std::recursive_mutex> lock(_mtx);
-        auto pin_index = 0;
-        if (mode.pf->fourcc == 0x5a313620) // Z16
-            pin_index = 1;
-
-        if(_has_metadata[pin_index] && fo.metadata_size > platform::uvc_header_size)
+        if(_has_metadata[pin_of(mode)] && fo.metadata_size > platform::uvc_header_size)
         {
             auto md = (librealsense::metadata_intel_basic*)(fo.metadata);
             if (md->capture_valid())
@@ -87,7 +89,6 @@ namespace librealsense
 
     void ds5_timestamp_reader_from_metadata::reset()
     {
-        std::lock_guard<std::recursive_mutex> lock(_mtx);
         one_time_note = false;
         for (auto i = 0; i < pins; ++i)
         {
@@ -97,24 +98,38 @@ namespace librealsense
 
     rs2_timestamp_domain ds5_timestamp_reader_from_metadata::get_frame_timestamp_domain(const request_mapping & mode, const platform::frame_object& fo) const
     {
-        std::lock_guard<std::recursive_mutex> lock(_mtx);
-        auto pin_index = 0;
-        if (mode.pf->fourcc == 0x5a313620) // Z16
-            pin_index = 1;
+        return _has_metadata[pin_of(mode)] ? RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK :
+                                             _backup_timestamp_reader->get_frame_timestamp_domain(mode,fo);
+    }
 
-        return _has_metadata[pin_index] ? RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK :
-                                          _backup_timestamp_reader->get_frame_timestamp_domain(mode,fo);
+    frame_timestamps ds5_timestamp_reader_from_metadata::get_frame_timestamps(const request_mapping& mode, const platform::frame_object& fo)
+    {
+        auto md = (librealsense::metadata_intel_basic*)(fo.metadata);
+        if (!pin_has_metadata(mode, fo) || !md)
+        {
+            if (!one_time_note.exchange(true))
+            {
+                LOG_WARNING("UVC metadata payloads not available. Please refer to installation chapter for details.");
+            }
+            return _backup_timestamp_reader->get_frame_timestamps(mode, fo);
+        }
+
+        frame_timestamps res;
+        res.timestamp = (double)(md->header.timestamp)*TIMESTAMP_USEC_TO_MSEC;
+        res.domain = RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK;
+        res.frame_counter = fo.metadata_size > platform::uvc_header_size && md->capture_valid() ? md->payload.frame_counter :
+                                                                                                  _backup_timestamp_reader->get_frame_counter(mode, fo);
+        return res;
     }
 
     ds5_timestamp_reader::ds5_timestamp_reader(std::shared_ptr<platform::time_service> ts)
-        : counter(pins), _ts(ts)
+        : _ts(ts)
     {
         reset();
     }
 
     void ds5_timestamp_reader::reset()
     {
-        std::lock_guard<std::recursive_mutex> lock(_mtx);
         for (auto i = 0; i < pins; ++i)
         {
             counter[i] = 0;
@@ -123,18 +138,12 @@ namespace librealsense
 
     rs2_time_t ds5_timestamp_reader::get_frame_timestamp(const request_mapping& mode, const platform::frame_object& fo)
     {
-        std::lock_guard<std::recursive_mutex> lock(_mtx);
         return _ts->get_time();
     }
 
     unsigned long long ds5_timestamp_reader::get_frame_counter(const request_mapping & mode, const platform::frame_object& fo) const
     {
-        std::lock_guard<std::recursive_mutex> lock(_mtx);
-        auto pin_index = 0;
-        if (mode.pf->fourcc == 0x5a313620) // Z16
-            pin_index = 1;
-
-        return ++counter[pin_index];
+        return ++counter[pin_of(mode)];
     }
 
     rs2_timestamp_domain ds5_timestamp_reader::get_frame_timestamp_domain(const request_mapping & mode, const platform::frame_object& fo) const
@@ -142,15 +151,22 @@ namespace librealsense
         return RS2_TIMESTAMP_DOMAIN_SYSTEM_TIME;
     }
 
+    frame_timestamps ds5_timestamp_reader::get_frame_timestamps(const request_mapping& mode, const platform::frame_object& fo)
+    {
+        frame_timestamps res;
+        res.timestamp = _ts->get_time();
+        res.domain = RS2_TIMESTAMP_DOMAIN_SYSTEM_TIME;
+        res.frame_counter = ++counter[pin_of(mode)];
+        return res;
+    }
+
     ds5_iio_hid_timestamp_reader::ds5_iio_hid_timestamp_reader()
     {
-        counter.resize(sensors);
         reset();
     }
 
     void ds5_iio_hid_timestamp_reader::reset()
     {
-        std::lock_guard<std::recursive_mutex> lock(_mtx);
         started = false;
         for (auto i = 0; i < sensors; ++i)
         {
@@ -160,18 +176,15 @@ namespace librealsense
 
     rs2_time_t ds5_iio_hid_timestamp_reader::get_frame_timestamp(const request_mapping& mode, const platform::frame_object& fo)
     {
-        std::lock_guard<std::recursive_mutex> lock(_mtx);
-
         if(has_metadata(mode, fo.metadata, fo.metadata_size))
         {
             auto timestamp = *((uint64_t*)((const uint8_t*)fo.metadata));
             return static_cast<rs2_time_t>(timestamp) * TIMESTAMP_USEC_TO_MSEC;
         }
 
-        if (!started)
+        if (!started.exchange(true))
         {
             LOG_WARNING("HID timestamp not found! please apply HID patch.");
-            started = true;
         }
 
         return std::chrono::duration<rs2_time_t, std::milli>(std::chrono::system_clock::now().time_since_epoch()).count();
@@ -188,7 +201,6 @@ namespace librealsense
 
     unsigned long long ds5_iio_hid_timestamp_reader::get_frame_counter(const request_mapping & mode, const platform::frame_object& fo) const
     {
-        std::lock_guard<std::recursive_mutex> lock(_mtx);
         if (nullptr == mode.pf) return 0;                   // Windows support is limited
         int index = 0;
         if (mode.pf->fourcc == 'GYRO')
@@ -208,13 +220,11 @@ namespace librealsense
 
     ds5_custom_hid_timestamp_reader::ds5_custom_hid_timestamp_reader()
     {
-        counter.resize(sensors);
         reset();
     }
 
     void ds5_custom_hid_timestamp_reader::reset()
     {
-        std::lock_guard<std::recursive_mutex> lock(_mtx);
         for (auto i = 0; i < sensors; ++i)
         {
             counter[i] = 0;
@@ -223,7 +233,6 @@ namespace librealsense
 
     rs2_time_t ds5_custom_hid_timestamp_reader::get_frame_timestamp(const request_mapping& /*mode*/, const platform::frame_object& fo)
     {
-        std::lock_guard<std::recursive_mutex> lock(_mtx);
         static const uint8_t timestamp_offset = 17;
 
         auto timestamp = *((uint64_t*)((const uint8_t*)fo.pixels + timestamp_offset));
@@ -237,8 +246,7 @@ namespace librealsense
 
     unsigned long long ds5_custom_hid_timestamp_reader::get_frame_counter(const request_mapping & mode, const platform::frame_object& fo) const
     {
-        std::lock_guard<std::recursive_mutex> lock(_mtx);
-        return ++counter.front();
+        return ++counter[0];
     }
 
     rs2_timestamp_domain ds5_custom_hid_timestamp_reader::get_frame_timestamp_domain(const request_mapping & /*mode*/, const platform::frame_object& /*fo*/) const
@@ -10,18 +10,22 @@
 
 namespace librealsense
 {
+    // The readers are called from the capture threads of every stream with no lock: the state of every pin, or HID sensor, is
+    // its own and atomic
     class ds5_timestamp_reader_from_metadata : public frame_timestamp_reader
     {
        std::unique_ptr<frame_timestamp_reader> _backup_timestamp_reader;
        static const int pins = 2;
-       std::vector<std::atomic<bool>> _has_metadata;
-       bool one_time_note;
-       mutable std::recursive_mutex _mtx;
+       std::atomic<bool> _has_metadata[pins];
+       std::atomic<bool> one_time_note;
+
+       // Whether the pin of the stream was ever seen with metadata, checked on the frames until it is
+       bool pin_has_metadata(const request_mapping& mode, const platform::frame_object& fo);
 
     public:
         ds5_timestamp_reader_from_metadata(std::unique_ptr<frame_timestamp_reader> backup_timestamp_reader);
 
-        bool has_metadata(const request_mapping& mode, const void * metadata, size_t metadata_size);
+        bool has_metadata(const request_mapping& mode, const void * metadata, size_t metadata_size) const;
 
         rs2_time_t get_frame_timestamp(const request_mapping& mode, const platform::frame_object& fo) override;
 
@@ -30,14 +34,15 @@ namespace librealsense
         void reset() override;
 
         rs2_timestamp_domain get_frame_timestamp_domain(const request_mapping & mode, const platform::frame_object& fo) const override;
+
+        frame_timestamps get_frame_timestamps(const request_mapping& mode, const platform::frame_object& fo) override;
     };
 
     class ds5_timestamp_reader : public frame_timestamp_reader
     {
         static const int pins = 2;
-        mutable std::vector<int64_t> counter;
+        mutable std::atomic<int64_t> counter[pins];
         std::shared_ptr<platform::time_service> _ts;
-        mutable std::recursive_mutex _mtx;
     public:
         ds5_timestamp_reader(std::shared_ptr<platform::time_service> ts);
 
@@ -48,14 +53,15 @@ namespace librealsense
         unsigned long long get_frame_counter(const request_mapping & mode, const platform::frame_object& fo) const override;
 
         rs2_timestamp_domain get_frame_timestamp_domain(const request_mapping & mode, const platform::frame_object& fo) const override;
+
+        frame_timestamps get_frame_timestamps(const request_mapping& mode, const platform::frame_object& fo) override;
     };
 
     class ds5_iio_hid_timestamp_reader : public frame_timestamp_reader
     {
         static const int sensors = 2;
-        bool started;
-        mutable std::vector<int64_t> counter;
-        mutable std::recursive_mutex _mtx;
+        std::atomic<bool> started;
+        mutable std::atomic<int64_t> counter[sensors];
     public:
         ds5_iio_hid_timestamp_reader();
 
@@ -74,8 +80,7 @@ namespace librealsense
     {
         static const int sensors = 4; // TODO: implement frame-counter for each GPIO or
                                       //       reading counter field report
-        mutable std::vector<int64_t> counter;
-        mutable std::recursive_mutex _mtx;
+        mutable std::atomic<int64_t> counter[sensors];
     public:
         ds5_custom_hid_timestamp_reader();
 
@@ -6,7 +6,7 @@
 namespace librealsense
 {
     extrinsics_graph::extrinsics_graph()
-        : _locks_count(0)
+        : _locks_count(0), _cache(std::make_shared<extrinsics_cache>())
     {
         _id = std::make_shared<lazy<rs2_extrinsics>>([]()
         {
@@ -43,6 +43,7 @@ namespace librealsense
 
         _extrinsics[from_idx][to_idx] = extr;
         _extrinsics[to_idx][from_idx] = std::shared_ptr<lazy<rs2_extrinsics>>(nullptr);
+        invalidate_cache();
     }
 
     void extrinsics_graph::register_extrinsics(const stream_interface & from, const stream_interface & to, rs2_extrinsics extr)
@@ -82,7 +83,16 @@ namespace librealsense
         }
 
         if (!invalid_ids.empty())
+        {
+            invalidate_cache();
             LOG_INFO("Found " << invalid_ids.size() << " unreachable streams, " << counter << " extrinsics deleted");
+        }
+    }
+
+    void extrinsics_graph::invalidate_cache()
+    {
+        if (!std::atomic_load(&_cache)->empty())
+            std::atomic_store(&_cache, std::shared_ptr<const extrinsics_cache>(std::make_shared<extrinsics_cache>()));
     }
 
     int extrinsics_graph::find_stream_profile(const stream_interface& p)
@@ -102,22 +112,42 @@ namespace librealsense
 
     bool extrinsics_graph::try_fetch_extrinsics(const stream_interface& from, const stream_interface& to, rs2_extrinsics* extr)
     {
-        std::lock_guard<std::mutex> lock(_mutex);
-        cleanup_extrinsics();
-        auto from_idx = find_stream_profile(from);
-        auto to_idx = find_stream_profile(to);
-
-        if (from_idx == to_idx)
+        if (&from == &to)
         {
             *extr = identity_matrix();
             return true;
         }
 
+        // Streams whose address was reused by others are expired in the cache
+        auto key = std::make_pair(&from, &to);
+        auto cache = std::atomic_load(&_cache);
+        auto cached = cache->find(key);
+        if (cached != cache->end() && !cached->second.from.expired() && !cached->second.to.expired() &&
+            std::none_of(cached->second.edges.begin(), cached->second.edges.end(),
+                [](const std::weak_ptr<lazy<rs2_extrinsics>>& edge) { return edge.expired(); }))
+        {
+            *extr = cached->second.extrinsics;
+            return true;
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        cleanup_extrinsics();
+        auto from_idx = find_stream_profile(from);
+        auto to_idx = find_stream_profile(to);
+
         std::set<int> visited;
-        return try_fetch_extrinsics(from_idx, to_idx, visited, extr);
+        std::vector<std::weak_ptr<lazy<rs2_extrinsics>>> edges;
+        if (!try_fetch_extrinsics(from_idx, to_idx, visited, extr, edges))
+            return false;
+
+        auto updated = std::make_shared<extrinsics_cache>(*std::atomic_load(&_cache));
+        (*updated)[key] = { _streams[from_idx], _streams[to_idx], std::move(edges), *extr };
+        std::atomic_store(&_cache, std::shared_ptr<const extrinsics_cache>(updated));
+        return true;
     }
 
-    bool extrinsics_graph::try_fetch_extrinsics(int from, int to, std::set<int>& visited, rs2_extrinsics* extr)
+    bool extrinsics_graph::try_fetch_extrinsics(int from, int to, std::set<int>& visited, rs2_extrinsics* extr,
+                                                std::vector<std::weak_ptr<lazy<rs2_extrinsics>>>& edges)
     {
         if (visited.count(from)) return false;
 
@@ -135,6 +165,7 @@ namespace librealsense
                 else
                     *extr = inverse(back_edge->operator*());
 
+                edges.push_back(fwd_edge.get() ? fwd_edge : back_edge);
                 return true;
             }
             else
@@ -150,7 +181,7 @@ namespace librealsense
                     fwd_edge = fetch_edge(from, new_from);
 
                     if ((back_edge.get() || fwd_edge.get()) &&
-                        try_fetch_extrinsics(new_from, to, visited, extr))
+                        try_fetch_extrinsics(new_from, to, visited, extr, edges))
                     {
                         const auto local = [&]() {
                             if (fwd_edge.get())
@@ -161,6 +192,7 @@ namespace librealsense
 
                         auto pose = to_pose(local) * to_pose(*extr);
                         *extr = from_pose(pose);
+                        edges.push_back(fwd_edge.get() ? fwd_edge : back_edge);
                         return true;
                     }
                 }
@@ -205,4 +237,25 @@ namespace librealsense
     {
         return _ts;
     }
+
+    void environment::set_compute_backend(std::shared_ptr<compute_backend> backend)
+    {
+        // Blocks read the backend from their processing threads, for every frame
+        std::atomic_store(&_compute_backend, backend);
+    }
+
+    std::shared_ptr<compute_backend> environment::get_compute_backend() const
+    {
+        return std::atomic_load(&_compute_backend);
+    }
+
+    void environment::set_parallel_runtime(std::shared_ptr<parallel_runtime> runtime)
+    {
+        std::atomic_store(&_parallel_runtime, runtime);
+    }
+
+    std::shared_ptr<parallel_runtime> environment::get_parallel_runtime() const
+    {
+        return std::atomic_load(&_parallel_runtime);
+    }
 }
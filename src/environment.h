@@ -4,6 +4,8 @@
 #pragma once
 #include "core/streaming.h"
 #include "types.h"
+#include "proc/compute-backend.h"
+#include "parallel.h"
 #include <memory>
 #include <mutex>
 
@@ -24,6 +26,7 @@ namespace librealsense
             extrinsics_lock(extrinsics_graph& owner)
                 : _owner(owner)
             {
+                std::lock_guard<std::mutex> lock(_owner._mutex);
                 _owner.cleanup_extrinsics();
                 _owner._locks_count.fetch_add(1);
             }
@@ -45,8 +48,20 @@ namespace librealsense
         extrinsics_lock lock();
 
     private:
+        // Resolved extrinsics between two streams, standing for as long as both streams and every edge of the path between
+        // them are alive, and the graph unchanged
+        struct cached_extrinsics
+        {
+            std::weak_ptr<const stream_interface> from, to;
+            std::vector<std::weak_ptr<lazy<rs2_extrinsics>>> edges;
+            rs2_extrinsics extrinsics;
+        };
+        typedef std::map<std::pair<const stream_interface*, const stream_interface*>, cached_extrinsics> extrinsics_cache;
+
+        void invalidate_cache();
         std::shared_ptr<lazy<rs2_extrinsics>> fetch_edge(int from, int to);
-        bool try_fetch_extrinsics(int from, int to, std::set<int>& visited, rs2_extrinsics* extr);
+        bool try_fetch_extrinsics(int from, int to, std::set<int>& visited, rs2_extrinsics* extr,
+                                  std::vector<std::weak_ptr<lazy<rs2_extrinsics>>>& edges);
         void cleanup_extrinsics();
         int find_stream_profile(const stream_interface& p);
 
@@ -59,6 +74,9 @@ namespace librealsense
         std::shared_ptr<lazy<rs2_extrinsics>> _id;
         std::map<int, std::weak_ptr<const stream_interface>> _streams;
 
+        // Replaced, never modified in place, for lookups to read it without taking the mutex
+        std::shared_ptr<const extrinsics_cache> _cache;
+
     };
 
 
@@ -74,6 +92,14 @@ namespace librealsense
         void set_time_service(std::shared_ptr<platform::time_service> ts);
         std::shared_ptr<platform::time_service> get_time_service();
 
+        // The device the processing blocks offload their kernels to, nullptr for the CPU
+        void set_compute_backend(std::shared_ptr<compute_backend> backend);
+        std::shared_ptr<compute_backend> get_compute_backend() const;
+
+        // Where the parallel kernels split their work, nullptr for the calling thread alone
+        void set_parallel_runtime(std::shared_ptr<parallel_runtime> runtime);
+        std::shared_ptr<parallel_runtime> get_parallel_runtime() const;
+
         environment(const environment&) = delete;
         environment(const environment&&) = delete;
         environment operator=(const environment&) = delete;
@@ -83,8 +109,16 @@ namespace librealsense
         extrinsics_graph _extrinsics;
         std::atomic<int> _stream_id;
         std::shared_ptr<platform::time_service> _ts;
+        std::shared_ptr<compute_backend> _compute_backend;
+        std::shared_ptr<parallel_runtime> _parallel_runtime;
 
-        environment(){_stream_id = 0;}
+        environment()
+        {
+            _stream_id = 0;
+#ifdef RS2_PARALLEL_BY_DEFAULT
+            _parallel_runtime = make_parallel_threads(-1);
+#endif
+        }
 
     };
 }
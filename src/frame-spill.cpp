@@ -0,0 +1,197 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include "frame-spill.h"
+
+#include <cstdio>
+
+namespace librealsense
+{
+    frame_spill::frame_spill(const std::string& filename, unsigned long long max_bytes)
+        : _filename(filename), _max_bytes(max_bytes), _spilled_bytes(0), _source(0), _framesets(_source)
+    {
+        _file.open(filename, std::ios::in | std::ios::out | std::ios::trunc | std::ios::binary);
+        if (!_file)
+            throw io_exception(to_string() << "Could not open the spill file " << filename);
+        _source.init(std::shared_ptr<metadata_parser_map>());
+    }
+
+    frame_spill::~frame_spill()
+    {
+        clear();
+        _file.close();
+        std::remove(_filename.c_str());
+    }
+
+    // The regions are taken and given back in order, the oldest at the front, and a region that does not fit before the end
+    // of the file starts it over once the oldest regions are gone from there
+    bool frame_spill::reserve(size_t size)
+    {
+        if (size > _max_bytes)
+            return false;
+
+        unsigned long long offset = 0;
+        if (!_regions.empty())
+        {
+            auto head = _regions.front().first;
+            auto tail = _regions.back().first + _regions.back().second;
+            if (tail > head)
+            {
+                if (tail + size <= _max_bytes) offset = tail;
+                else if (size <= head) offset = 0;
+                else return false;
+            }
+            else if (tail + size <= head) offset = tail;
+            else return false;
+        }
+        _regions.emplace_back(offset, size);
+        return true;
+    }
+
+    bool frame_spill::spill_frame(frame_holder frame, entry& e)
+    {
+        auto vf = dynamic_cast<video_frame*>(frame.frame);
+        if (!vf)
+        {
+            frame->keep();
+            e.frames.push_back({ std::move(frame), RS2_EXTENSION_UNKNOWN, 0 });
+            return true;
+        }
+
+        auto type = Is<disparity_frame>(frame.frame) ? RS2_EXTENSION_DISPARITY_FRAME :
+                    Is<depth_frame>(frame.frame) ? RS2_EXTENSION_DEPTH_FRAME : RS2_EXTENSION_VIDEO_FRAME;
+        auto size = static_cast<size_t>(vf->get_stride()) * vf->get_height();
+        if (!reserve(size))
+            return false;
+
+        auto header = _source.alloc_frame(type, 0, vf->additional_data, false);
+        if (!header)
+        {
+            _regions.pop_back();
+            return false;
+        }
+        auto copy = static_cast<video_frame*>(header);
+        copy->metadata_parsers = vf->metadata_parsers;
+        copy->assign(vf->get_width(), vf->get_height(), vf->get_stride(), vf->get_bpp());
+        copy->set_sensor(vf->get_sensor());
+        copy->set_stream(vf->get_stream());
+
+        _file.seekp(_regions.back().first);
+        _file.write(reinterpret_cast<const char*>(vf->get_frame_data()), size);
+        if (!_file)
+        {
+            _file.clear();
+            _regions.pop_back();
+            frame_holder release(header);
+            throw io_exception(to_string() << "Could not write " << size << " bytes to the spill file " << _filename);
+        }
+        _spilled_bytes += size;
+        e.frames.push_back({ frame_holder(header), type, size });
+        return true;
+    }
+
+    bool frame_spill::push(frame_holder frame)
+    {
+        entry e;
+        e.composite = false;
+        auto regions = _regions.size();
+        auto bytes = _spilled_bytes;
+
+        // A frameset is spilled whole or not at all
+        auto rollback = [&]()
+        {
+            _regions.resize(regions);
+            _spilled_bytes = bytes;
+        };
+
+        bool spilled = true;
+        try
+        {
+            if (auto composite = dynamic_cast<composite_frame*>(frame.frame))
+            {
+                e.composite = true;
+                auto frames = composite->get_frames();
+                for (size_t i = 0; spilled && i < composite->get_embedded_frames_count(); i++)
+                {
+                    if (!frames[i]) continue;
+                    frames[i]->acquire();
+                    spilled = spill_frame(frame_holder(frames[i]), e);
+                }
+            }
+            else spilled = spill_frame(std::move(frame), e);
+        }
+        catch (...)
+        {
+            rollback();
+            throw;
+        }
+
+        if (!spilled || e.frames.empty())
+        {
+            rollback();
+            return false;
+        }
+        _entries.push_back(std::move(e));
+        return true;
+    }
+
+    frame_holder frame_spill::rebuild_frame(spilled_frame& f)
+    {
+        if (!f.size)
+            return std::move(f.header);
+
+        auto offset = _regions.front().first;
+        _regions.pop_front();
+        _spilled_bytes -= f.size;
+
+        auto header = static_cast<video_frame*>(f.header.frame);
+        auto res = _source.alloc_frame(f.type, f.size, header->additional_data, true);
+        if (!res)
+            return frame_holder();
+
+        auto vf = static_cast<video_frame*>(res);
+        vf->metadata_parsers = header->metadata_parsers;
+        vf->assign(header->get_width(), header->get_height(), header->get_stride(), header->get_bpp());
+        vf->set_sensor(header->get_sensor());
+        vf->set_stream(header->get_stream());
+        frame_holder frame(res);
+
+        _file.seekg(offset);
+        _file.read(reinterpret_cast<char*>(vf->data.data()), f.size);
+        if (!_file)
+        {
+            _file.clear();
+            throw io_exception(to_string() << "Could not read " << f.size << " bytes of the spill file " << _filename);
+        }
+        return frame;
+    }
+
+    frame_holder frame_spill::pop()
+    {
+        if (_entries.empty())
+            return frame_holder();
+
+        auto e = std::move(_entries.front());
+        _entries.pop_front();
+
+        if (!e.composite)
+            return rebuild_frame(e.frames.front());
+
+        std::vector<frame_holder> frames;
+        for (auto&& f : e.frames)
+        {
+            auto frame = rebuild_frame(f);
+            if (frame) frames.push_back(std::move(frame));
+        }
+        if (frames.empty())
+            return frame_holder();
+        return frame_holder(_framesets.allocate_composite_frame(std::move(frames)));
+    }
+
+    void frame_spill::clear()
+    {
+        _entries.clear();
+        _regions.clear();
+        _spilled_bytes = 0;
+    }
+}
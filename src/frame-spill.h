@@ -0,0 +1,67 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "archive.h"
+#include "source.h"
+#include "proc/synthetic-stream.h"
+
+#include <deque>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace librealsense
+{
+    // The overflow of a frame queue, where the frames the queue has no room for wait on disk instead of being dropped, to be
+    // rebuilt in their order once the consumer catches up. The data of the video frames is written to a file used as a ring of
+    // at most max_bytes, while their headers are held in memory with no buffer. The other frames, of motion, pose and points,
+    // are held as they are, and a frameset is spilled as its frames and rebuilt as a frameset of them
+    class frame_spill
+    {
+    public:
+        frame_spill(const std::string& filename, unsigned long long max_bytes);
+        ~frame_spill();
+
+        // False when the data of the frame does not fit in what is left of the file, the frame being rejected
+        bool push(frame_holder frame);
+
+        // The oldest frame, rebuilt with its data, or an empty holder when the spill is empty or the frame can not be rebuilt
+        frame_holder pop();
+
+        void clear();
+        bool empty() const { return _entries.empty(); }
+        size_t size() const { return _entries.size(); }
+
+        // The bytes of the file that the spilled frames take
+        unsigned long long get_spilled_bytes() const { return _spilled_bytes; }
+
+    private:
+        struct spilled_frame
+        {
+            frame_holder    header;     // The video frames without their data, the others as they are
+            rs2_extension   type;
+            size_t          size;       // Of the data in the file, zero for the frames held as they are
+        };
+
+        struct entry
+        {
+            std::vector<spilled_frame>  frames;
+            bool                        composite;
+        };
+
+        bool spill_frame(frame_holder frame, entry& e);
+        frame_holder rebuild_frame(spilled_frame& f);
+        bool reserve(size_t size);
+
+        std::string                                             _filename;
+        std::fstream                                            _file;
+        unsigned long long                                      _max_bytes;
+        unsigned long long                                      _spilled_bytes;
+        std::deque<entry>                                       _entries;
+        std::deque<std::pair<unsigned long long, size_t>>       _regions;   // Offset and size of the data of every spilled video frame, in order
+        frame_source                                            _source;
+        synthetic_source                                        _framesets;
+    };
+}
@@ -0,0 +1,61 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include <chrono>
+#include "global-timestamp-reader.h"
+
+namespace librealsense
+{
+    global_timestamp_reader::global_timestamp_reader(std::unique_ptr<frame_timestamp_reader> device_reader)
+        : _device_reader(std::move(device_reader)), _enabled(false)
+    {
+    }
+
+    double global_timestamp_reader::get_frame_timestamp(const request_mapping& mode, const platform::frame_object& fo)
+    {
+        // The system time of the frames follows the wall clock, which steps along with NTP
+        auto arrival = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        auto timestamp = _device_reader->get_frame_timestamp(mode, fo);
+        if (!_enabled || _device_reader->get_frame_timestamp_domain(mode, fo) != RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK)
+            return timestamp;
+        return map_timestamp(mode, timestamp, arrival);
+    }
+
+    frame_timestamps global_timestamp_reader::get_frame_timestamps(const request_mapping& mode, const platform::frame_object& fo)
+    {
+        auto arrival = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        auto res = _device_reader->get_frame_timestamps(mode, fo);
+        if (_enabled && res.domain == RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK)
+        {
+            res.timestamp = map_timestamp(mode, res.timestamp, arrival);
+            res.domain = RS2_TIMESTAMP_DOMAIN_GLOBAL_TIME;
+        }
+        return res;
+    }
+
+    double global_timestamp_reader::map_timestamp(const request_mapping& mode, double timestamp, double arrival)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto&& clock = _clocks[mode.pf];
+        clock.add(timestamp, arrival);
+        return clock.is_ready() ? clock.to_host(timestamp) : arrival;
+    }
+
+    unsigned long long global_timestamp_reader::get_frame_counter(const request_mapping& mode, const platform::frame_object& fo) const
+    {
+        return _device_reader->get_frame_counter(mode, fo);
+    }
+
+    rs2_timestamp_domain global_timestamp_reader::get_frame_timestamp_domain(const request_mapping& mode, const platform::frame_object& fo) const
+    {
+        auto domain = _device_reader->get_frame_timestamp_domain(mode, fo);
+        return _enabled && domain == RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK ? RS2_TIMESTAMP_DOMAIN_GLOBAL_TIME : domain;
+    }
+
+    void global_timestamp_reader::reset()
+    {
+        _device_reader->reset();
+        std::lock_guard<std::mutex> lock(_mutex);
+        _clocks.clear();
+    }
+}
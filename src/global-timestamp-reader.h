@@ -0,0 +1,41 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "sensor.h"
+#include "clock-mapping.h"
+
+#include <atomic>
+#include <map>
+#include <mutex>
+
+namespace librealsense
+{
+    // Maps the hardware timestamps of another reader onto the monotonic clock of the host, in RS2_TIMESTAMP_DOMAIN_GLOBAL_TIME,
+    // while enabled. Every stream is mapped on its own, its transport delaying it by its own latency. Until the mapping of a
+    // stream is ready its frames are stamped with their arrival times, and the timestamps of the other domains pass through
+    class global_timestamp_reader : public frame_timestamp_reader
+    {
+    public:
+        explicit global_timestamp_reader(std::unique_ptr<frame_timestamp_reader> device_reader);
+
+        void enable(bool enabled) { _enabled = enabled; }
+
+        double get_frame_timestamp(const request_mapping& mode, const platform::frame_object& fo) override;
+        unsigned long long get_frame_counter(const request_mapping& mode, const platform::frame_object& fo) const override;
+        rs2_timestamp_domain get_frame_timestamp_domain(const request_mapping& mode, const platform::frame_object& fo) const override;
+        void reset() override;
+
+        frame_timestamps get_frame_timestamps(const request_mapping& mode, const platform::frame_object& fo) override;
+
+    private:
+        // The host time of a hardware timestamp, once the mapping of its stream is ready
+        double map_timestamp(const request_mapping& mode, double timestamp, double arrival);
+
+        std::unique_ptr<frame_timestamp_reader> _device_reader;
+        std::atomic<bool> _enabled;
+        std::mutex _mutex;
+        std::map<const native_pixel_format*, device_clock_mapping> _clocks;
+    };
+}
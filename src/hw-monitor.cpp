@@ -138,6 +138,84 @@ namespace librealsense
             newCommand.receivedCommandData + newCommand.receivedCommandDataLength);
     }
 
+    std::vector<std::vector<uint8_t>> hw_monitor::send(const std::vector<command>& commands) const
+    {
+        return _locked_transfer->batch([&]()
+        {
+            std::vector<std::vector<uint8_t>> results;
+            for (auto&& cmd : commands)
+                results.push_back(send(cmd));
+            return results;
+        });
+    }
+
+    std::future<std::vector<uint8_t>> hw_monitor::send_async(command cmd) const
+    {
+        return queue([this, cmd]() { return send(cmd); });
+    }
+
+    std::future<std::vector<uint8_t>> hw_monitor::send_async(std::vector<uint8_t> data) const
+    {
+        return queue([this, data]() { return send(data); });
+    }
+
+    std::future<std::vector<uint8_t>> hw_monitor::queue(std::function<std::vector<uint8_t>()> send) const
+    {
+        std::future<std::vector<uint8_t>> result;
+        bool was_idle = false;
+        {
+            std::lock_guard<std::mutex> lock(_pending_mutex);
+            if (!_dispatcher)
+            {
+                _dispatcher.reset(new dispatcher(4));
+                _dispatcher->start();
+            }
+
+            _pending.push_back({ std::move(send), std::promise<std::vector<uint8_t>>() });
+            result = _pending.back().result.get_future();
+            was_idle = (_pending.size() == 1);
+        }
+
+        // The commands queued before the monitor thread takes them all join the batch already scheduled
+        if (was_idle)
+            _dispatcher->invoke([this](dispatcher::cancellable_timer) { send_pending(); }, true);
+        return result;
+    }
+
+    void hw_monitor::send_pending() const
+    {
+        std::deque<pending_command> pending;
+        {
+            std::lock_guard<std::mutex> lock(_pending_mutex);
+            pending.swap(_pending);
+        }
+
+        size_t sent = 0;
+        try
+        {
+            _locked_transfer->batch([&]()
+            {
+                for (; sent < pending.size(); sent++)
+                {
+                    try
+                    {
+                        pending[sent].result.set_value(pending[sent].send());
+                    }
+                    catch (...)
+                    {
+                        pending[sent].result.set_exception(std::current_exception());
+                    }
+                }
+            });
+        }
+        catch (...)
+        {
+            // The device could not be powered up
+            for (; sent < pending.size(); sent++)
+                pending[sent].result.set_exception(std::current_exception());
+        }
+    }
+
     void hw_monitor::get_gvd(size_t sz, unsigned char* gvd, uint8_t gvd_cmd) const
     {
         command command(gvd_cmd);
@@ -150,6 +228,11 @@ namespace librealsense
     {
         std::vector<unsigned char> gvd(HW_MONITOR_BUFFER_SIZE);
         get_gvd(gvd.size(), gvd.data(), gvd_cmd);
+        return get_firmware_version_string(gvd, offset);
+    }
+
+    std::string hw_monitor::get_firmware_version_string(const std::vector<uint8_t>& gvd, uint32_t offset)
+    {
         uint8_t fws[8];
         librealsense::copy(fws, gvd.data() + offset, 8);
         return to_string() << static_cast<int>(fws[3]) << "." << static_cast<int>(fws[2])
@@ -160,6 +243,11 @@ namespace librealsense
     {
         std::vector<unsigned char> gvd(HW_MONITOR_BUFFER_SIZE);
         get_gvd(gvd.size(), gvd.data(), gvd_cmd);
+        return get_module_serial_string(gvd, offset);
+    }
+
+    std::string hw_monitor::get_module_serial_string(const std::vector<uint8_t>& gvd, uint32_t offset)
+    {
         unsigned char ss[8];
         librealsense::copy(ss, gvd.data() + offset, 8);
         std::stringstream formattedBuffer;
@@ -177,8 +265,63 @@ namespace librealsense
     {
         std::vector<unsigned char> gvd(HW_MONITOR_BUFFER_SIZE);
         get_gvd(gvd.size(), gvd.data(), gvd_cmd);
+        return is_camera_locked(gvd, offset);
+    }
+
+    bool hw_monitor::is_camera_locked(const std::vector<uint8_t>& gvd, uint32_t offset)
+    {
         bool value;
         librealsense::copy(&value, gvd.data() + offset, 1);
         return value;
     }
+
+    // Every file holds a magic number, the size and the CRC32 of the table, followed by the table
+    static const uint32_t calibration_cache_magic = 0x43545352; // "RSTC"
+    static const size_t max_calibration_cache_size = 1024 * 1024;
+
+    bool calibration_cache::is_enabled()
+    {
+        static const bool enabled = cache_file::is_enabled("LRS_CALIBRATION_CACHE");
+        return enabled;
+    }
+
+    calibration_cache::calibration_cache(const std::string& serial, const std::string& firmware_version)
+        : _prefix(to_string() << serial << "-" << firmware_version << "-")
+    {
+    }
+
+    cache_file calibration_cache::get_file(uint32_t table_id) const
+    {
+        return cache_file("LRS_CALIBRATION_CACHE", to_string() << _prefix << std::hex << table_id << ".bin");
+    }
+
+    bool calibration_cache::load(uint32_t table_id, std::vector<uint8_t>& table) const
+    {
+        auto file = get_file(table_id);
+        std::vector<uint8_t> content;
+        uint32_t header[3] = {};
+        if (!file.read(content, max_calibration_cache_size) || content.size() < sizeof(header))
+            return false;
+
+        librealsense::copy(header, content.data(), sizeof(header));
+        if (header[0] != calibration_cache_magic)
+            return false;
+        if (header[1] != content.size() - sizeof(header) || calc_crc32(content.data() + sizeof(header), header[1]) != header[2])
+        {
+            LOG_WARNING("Ignoring the corrupted calibration cache " << file.get_path());
+            return false;
+        }
+
+        table.assign(content.begin() + sizeof(header), content.end());
+        return true;
+    }
+
+    void calibration_cache::store(uint32_t table_id, const std::vector<uint8_t>& table) const
+    {
+        uint32_t header[3] = { calibration_cache_magic, static_cast<uint32_t>(table.size()), calc_crc32(table.data(), table.size()) };
+        std::vector<uint8_t> content(sizeof(header) + table.size());
+        librealsense::copy(content.data(), header, sizeof(header));
+        std::copy(table.begin(), table.end(), content.begin() + sizeof(header));
+        get_file(table_id).write(content);
+    }
 }
@@ -4,7 +4,12 @@
 #pragma once
 
 #include "sensor.h"
+#include "concurrency.h"
+#include "cache-file.h"
 #include <mutex>
+#include <deque>
+#include <future>
+#include <type_traits>
 
 const uint8_t   IV_COMMAND_FIRMWARE_UPDATE_MODE = 0x01;
 const uint8_t   IV_COMMAND_GET_CALIBRATION_DATA = 0x02;
@@ -45,31 +50,71 @@ namespace librealsense
 {
     class uvc_sensor;
 
+    // The transfers of the hardware monitor of a device, one command and its response at a time. The locks are taken in
+    // the order of the power of the sensor, briefly, the transfer mutex, then whatever the transport locks of the interface
+    // it sends through: the device lock around the XU control for commands over XU, and the claim of the interface of the
+    // bulk endpoints otherwise, waited for while another process holds it. The device lock is not held around the transport,
+    // for the commands over the bulk endpoints not to hold back the other users of the UVC device for as long as they take
     class locked_transfer
     {
     public:
         locked_transfer(std::shared_ptr<platform::command_transfer> command_transfer, uvc_sensor& uvc_ep)
             :_command_transfer(command_transfer),
-             _uvc_sensor_base(uvc_ep)
+             _uvc_sensor_base(&uvc_ep)
         {}
+        virtual ~locked_transfer() = default;
 
         std::vector<uint8_t> send_receive(
             const std::vector<uint8_t>& data,
             int timeout_ms = 5000,
             bool require_response = true)
         {
-            std::lock_guard<std::recursive_mutex> lock(_local_mtx);
-            return _uvc_sensor_base.invoke_powered([&]
-                (platform::uvc_device& dev)
+            // Powered before the transfer is held, for a power up not to keep the other threads waiting on the monitor
+            std::vector<uint8_t> response;
+            hold([&]() { response = transfer(data, timeout_ms, require_response); });
+            return response;
+        }
+
+        // Runs f with the device powered and the transfers of the other threads held back, for the transfers f sends
+        // to follow each other instead of powering the device up and down around each of them
+        template<class T>
+        auto batch(T f) -> typename std::enable_if<!std::is_void<decltype(f())>::value, decltype(f())>::type
+        {
+            decltype(f()) result;
+            hold([&]() { result = f(); });
+            return result;
+        }
+
+        template<class T>
+        auto batch(T f) -> typename std::enable_if<std::is_void<decltype(f())>::value>::type
+        {
+            hold(f);
+        }
+
+    protected:
+        // For the test doubles, which override both the holding and the transfers
+        locked_transfer() : _uvc_sensor_base(nullptr) {}
+
+        virtual void hold(const std::function<void()>& f)
+        {
+            _uvc_sensor_base->invoke_powered([&]
+                (platform::uvc_device&)
                 {
-                    std::lock_guard<platform::uvc_device> lock(dev);
-                    return _command_transfer->send_receive(data, timeout_ms, require_response);
+                    std::lock_guard<std::recursive_mutex> lock(_local_mtx);
+                    f();
                 });
         }
 
+        virtual std::vector<uint8_t> transfer(const std::vector<uint8_t>& data, int timeout_ms, bool require_response)
+        {
+            // Commands may write the controls behind the values the options cached
+            _uvc_sensor_base->invalidate_controls();
+            return _command_transfer->send_receive(data, timeout_ms, require_response);
+        }
+
     private:
         std::shared_ptr<platform::command_transfer> _command_transfer;
-        uvc_sensor& _uvc_sensor_base;
+        uvc_sensor* _uvc_sensor_base;
         std::recursive_mutex _local_mtx;
     };
 
@@ -156,7 +201,18 @@ namespace librealsense
         static void update_cmd_details(hwmon_cmd_details& details, size_t receivedCmdLen, unsigned char* outputBuffer);
         void send_hw_monitor_command(hwmon_cmd_details& details) const;
 
+        struct pending_command
+        {
+            std::function<std::vector<uint8_t>()> send;
+            std::promise<std::vector<uint8_t>> result;
+        };
+        std::future<std::vector<uint8_t>> queue(std::function<std::vector<uint8_t>()> send) const;
+        void send_pending() const;
+
         std::shared_ptr<locked_transfer> _locked_transfer;
+        mutable std::mutex _pending_mutex;
+        mutable std::deque<pending_command> _pending;
+        mutable std::unique_ptr<dispatcher> _dispatcher; // Created by the first send_async, and destroyed first
     public:
         explicit hw_monitor(std::shared_ptr<locked_transfer> locked_transfer)
             : _locked_transfer(std::move(locked_transfer))
@@ -164,9 +220,50 @@ namespace librealsense
 
         std::vector<uint8_t> send(std::vector<uint8_t> data) const;
         std::vector<uint8_t> send(command cmd) const;
+
+        // Sends the commands back-to-back, with the device powered once for all of them. Throws at the first that fails
+        std::vector<std::vector<uint8_t>> send(const std::vector<command>& commands) const;
+
+        // Queues the command for the thread of the monitor, which sends the commands queued meanwhile back-to-back.
+        // The hardware monitor answers one command at a time, the caller only stops waiting for each round-trip
+        std::future<std::vector<uint8_t>> send_async(command cmd) const;
+        // Of a raw command, its bytes sent as they are
+        std::future<std::vector<uint8_t>> send_async(std::vector<uint8_t> data) const;
+
+        template<class T>
+        auto batch(T f) const -> decltype(f())
+        {
+            return _locked_transfer->batch(f);
+        }
+
         void get_gvd(size_t sz, unsigned char* gvd, uint8_t gvd_cmd) const;
         std::string get_firmware_version_string(int gvd_cmd, uint32_t offset) const;
         std::string get_module_serial_string(uint8_t gvd_cmd, uint32_t offset) const;
         bool is_camera_locked(uint8_t gvd_cmd, uint32_t offset) const;
+
+        // Parse a GVD read once, for its fields not to cost a round-trip each
+        static std::string get_firmware_version_string(const std::vector<uint8_t>& gvd, uint32_t offset);
+        static std::string get_module_serial_string(const std::vector<uint8_t>& gvd, uint32_t offset);
+        static bool is_camera_locked(const std::vector<uint8_t>& gvd, uint32_t offset);
+    };
+
+    // Calibration tables read over the hardware monitor, stored per serial number and firmware version in the existing directory
+    // named by LRS_CALIBRATION_CACHE. The tables are assumed to change only with the firmware, the directory is to be cleared
+    // after recalibrating a camera with an external tool
+    class calibration_cache
+    {
+    public:
+        static bool is_enabled();
+
+        calibration_cache(const std::string& serial, const std::string& firmware_version);
+
+        // False when the table was not cached, or its file is corrupted
+        bool load(uint32_t table_id, std::vector<uint8_t>& table) const;
+        void store(uint32_t table_id, const std::vector<uint8_t>& table) const;
+
+    private:
+        cache_file get_file(uint32_t table_id) const;
+
+        std::string _prefix;
     };
 }
@@ -3,8 +3,13 @@
 
 #define _USE_MATH_DEFINES
 #include <cmath>
+#include <cstdlib> // For getenv
+#include <atomic>
+#include <array>
 #include "image.h"
 #include "image_avx.h"
+#include "image_neon.h"
+#include "environment.h"
 
 #ifdef RS2_USE_CUDA
 #include "cuda/cuda-conversion.cuh"
@@ -15,33 +20,157 @@
 
 #if defined (ANDROID) || (defined (__linux__) && !defined (__x86_64__))
 
-bool has_avx() { return false; }
+bool has_ssse3() { return false; }
+bool has_avx2() { return false; }
 
 #else
 
 #ifdef _WIN32
 #include <intrin.h>
 #define cpuid(info, x)    __cpuidex(info, x, 0)
+unsigned long long xgetbv0() { return _xgetbv(0); }
 #else
 #include <cpuid.h>
 void cpuid(int info[4], int info_type){
     __cpuid_count(info_type, 0, info[0], info[1], info[2], info[3]);
 }
+// Inline assembly, as the _xgetbv intrinsic of GCC requires building the file with -mxsave
+unsigned long long xgetbv0()
+{
+    unsigned int eax, edx;
+    __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<unsigned long long>(edx) << 32) | eax;
+}
 #endif
 
-bool has_avx()
+bool has_ssse3()
+{
+    int info[4];
+    cpuid(info, 1);
+    return (info[2] & ((int)1 << 9)) != 0;
+}
+
+bool has_avx2()
 {
     int info[4];
     cpuid(info, 0);
-    cpuid(info, 0x80000000);
-    return (info[2] & ((int)1 << 28)) != 0;
+    if (info[0] < 7) return false;
+    cpuid(info, 1);
+    if ((info[2] & ((int)1 << 28)) == 0) return false; // AVX itself
+    // The OS must also save the YMM registers across context switches (OSXSAVE, then the SSE and AVX state in XCR0), which
+    // some VMs and kernels leave disabled on CPUs that report AVX2
+    if ((info[2] & ((int)1 << 27)) == 0) return false;
+    if ((xgetbv0() & 6) != 6) return false;
+    cpuid(info, 7);
+    return (info[1] & ((int)1 << 5)) != 0;
 }
 
 #endif
 
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+#if defined(__arm__) && defined(__linux__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+
+// 32-bit ARM builds may run on cores without Advanced SIMD
+bool has_neon() { return (getauxval(AT_HWCAP) & HWCAP_NEON) != 0; }
+#else
+// Advanced SIMD is mandatory on AArch64, and assumed by other NEON-enabled targets
+bool has_neon() { return true; }
+#endif
+
+#else
+
+bool has_neon() { return false; }
+
+#endif
+
+// Variants compiled into this build. Unavailable ones are left null in the unpack_variants tables
+#ifdef __SSSE3__
+#define SSSE3_VARIANT(f) f
+#else
+#define SSSE3_VARIANT(f) nullptr
+#endif
+#if defined(__SSSE3__) && !defined(ANDROID) && (defined(__AVX2__) || defined(RS2_USE_AVX2_UNPACKERS))
+#define AVX2_VARIANT(f) f
+#else
+#define AVX2_VARIANT(f) nullptr
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define NEON_VARIANT(f) f
+#else
+#define NEON_VARIANT(f) nullptr
+#endif
+
 #pragma pack(push, 1) // All structs in this file are assumed to be byte-packed
 namespace librealsense
 {
+    ////////////////////////////
+    // Run-time SIMD dispatch //
+    ////////////////////////////
+
+    static const char* simd_level_names[] = { "generic", "ssse3", "avx2", "neon" };
+
+    const char* get_string(simd_level level)
+    {
+        auto i = static_cast<int>(level);
+        return i >= 0 && i < static_cast<int>(simd_level::count) ? simd_level_names[i] : "unknown";
+    }
+
+    simd_level detect_simd_level()
+    {
+        if (has_neon()) return simd_level::neon;
+        if (has_avx2()) return simd_level::avx2;
+        if (has_ssse3()) return simd_level::ssse3;
+        return simd_level::generic;
+    }
+
+    static simd_level select_simd_level()
+    {
+        auto level = detect_simd_level();
+
+        // Allow lowering the level for benchmarking, but never beyond what the CPU supports
+        if (auto requested = getenv("LRS_SIMD_LEVEL"))
+        {
+            auto it = std::find_if(std::begin(simd_level_names), std::end(simd_level_names),
+                [requested](const char* name) { return strcmp(name, requested) == 0; });
+            if (it == std::end(simd_level_names))
+                LOG_WARNING("Unknown LRS_SIMD_LEVEL " << requested << ", using " << get_string(level));
+            else
+                level = std::min(level, static_cast<simd_level>(it - std::begin(simd_level_names)));
+        }
+        return level;
+    }
+
+    static std::atomic<int> simd_level_limit(static_cast<int>(simd_level::count));
+
+    simd_level get_simd_level()
+    {
+        static const simd_level level = select_simd_level();
+        return std::min(level, static_cast<simd_level>(simd_level_limit.load(std::memory_order_relaxed)));
+    }
+
+    void set_simd_level(simd_level level)
+    {
+        simd_level_limit = static_cast<int>(level);
+    }
+
+    // All implementations of a single unpacker, indexed by simd_level. The best one the level allows is used
+    struct unpack_variants
+    {
+        void(*variants[static_cast<int>(simd_level::count)])(byte * const dest[], const byte * source, int width, int height);
+
+        void operator()(byte * const dest[], const byte * source, int width, int height) const
+        {
+            for (auto level = static_cast<int>(get_simd_level()); level >= 0; --level)
+            {
+                if (variants[level])
+                    return variants[level](dest, source, width, height);
+            }
+        }
+    };
+
 
     ////////////////////////////
     // Image size computation //
@@ -50,6 +179,7 @@ namespace librealsense
     size_t get_image_size(int width, int height, rs2_format format)
     {
         if (format == RS2_FORMAT_YUYV || (format == RS2_FORMAT_UYVY)) assert(width % 2 == 0);
+        if (format == RS2_FORMAT_NV12 || (format == RS2_FORMAT_I420)) assert(width % 2 == 0 && height % 2 == 0);
         if (format == RS2_FORMAT_RAW10) assert(width % 4 == 0);
         return width * height * get_image_bpp(format) / 8;
     }
@@ -61,7 +191,11 @@ namespace librealsense
         case RS2_FORMAT_Z16: return  16;
         case RS2_FORMAT_DISPARITY16: return 16;
         case RS2_FORMAT_DISPARITY32: return 32;
+        case RS2_FORMAT_DISTANCE: return 32;
         case RS2_FORMAT_XYZ32F: return 12 * 8;
+        case RS2_FORMAT_XYZ16: return 6 * 8;
+        case RS2_FORMAT_XYZ16F: return 6 * 8;
+        case RS2_FORMAT_Z16_RVL: return 16;
         case RS2_FORMAT_YUYV:  return 16;
         case RS2_FORMAT_RGB8: return 24;
         case RS2_FORMAT_BGR8: return 24;
@@ -73,6 +207,8 @@ namespace librealsense
         case RS2_FORMAT_RAW16: return 16;
         case RS2_FORMAT_RAW8: return 8;
         case RS2_FORMAT_UYVY: return 16;
+        case RS2_FORMAT_NV12: return 12;
+        case RS2_FORMAT_I420: return 12;
         case RS2_FORMAT_GPIO_RAW: return 1;
         case RS2_FORMAT_MOTION_RAW: return 1;
         case RS2_FORMAT_MOTION_XYZ32F: return 1;
@@ -144,14 +280,94 @@ namespace librealsense
         librealsense::copy(dest[0], source + input_reports_offset, input_reports_size);
     }
 
+    // Transposes a tile of 8x8 pixels, the column k of the source tile being written as the row k of the destination
     template<size_t SIZE>
-    void rotate_270_degrees_clockwise(byte * const dest[], const byte * source, int width, int height)
+    void transpose_tile_generic(byte * dst, ptrdiff_t dst_stride, const byte * src, ptrdiff_t src_stride)
+    {
+        for (int r = 0; r < 8; ++r)
+            for (int c = 0; c < 8; ++c)
+                librealsense::copy(dst + c * dst_stride + r * SIZE, src + r * src_stride + c * SIZE, SIZE);
+    }
+
+#ifdef __SSSE3__
+    template<size_t SIZE>
+    void transpose_tile_ssse3(byte * dst, ptrdiff_t dst_stride, const byte * src, ptrdiff_t src_stride);
+
+    template<>
+    void transpose_tile_ssse3<1>(byte * dst, ptrdiff_t dst_stride, const byte * src, ptrdiff_t src_stride)
+    {
+        __m128i r[8];
+        for (int k = 0; k < 8; ++k)
+            r[k] = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(src + k * src_stride));
+
+        // Pairs of rows interleaved, then pairs of pairs, for each 32 bits to hold 4 rows of a column
+        auto a0 = _mm_unpacklo_epi8(r[0], r[1]), a1 = _mm_unpacklo_epi8(r[2], r[3]);
+        auto a2 = _mm_unpacklo_epi8(r[4], r[5]), a3 = _mm_unpacklo_epi8(r[6], r[7]);
+        auto b0 = _mm_unpacklo_epi16(a0, a1), b1 = _mm_unpackhi_epi16(a0, a1);
+        auto b2 = _mm_unpacklo_epi16(a2, a3), b3 = _mm_unpackhi_epi16(a2, a3);
+        // Two columns each
+        __m128i c[4] = { _mm_unpacklo_epi32(b0, b2), _mm_unpackhi_epi32(b0, b2), _mm_unpacklo_epi32(b1, b3), _mm_unpackhi_epi32(b1, b3) };
+
+        for (int k = 0; k < 4; ++k)
+        {
+            _mm_storel_epi64(reinterpret_cast<__m128i *>(dst + (k * 2) * dst_stride), c[k]);
+            _mm_storel_epi64(reinterpret_cast<__m128i *>(dst + (k * 2 + 1) * dst_stride), _mm_unpackhi_epi64(c[k], c[k]));
+        }
+    }
+
+    template<>
+    void transpose_tile_ssse3<2>(byte * dst, ptrdiff_t dst_stride, const byte * src, ptrdiff_t src_stride)
     {
+        __m128i r[8];
+        for (int k = 0; k < 8; ++k)
+            r[k] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + k * src_stride));
+
+        __m128i a[8], b[8];
+        for (int k = 0; k < 4; ++k)
+        {
+            a[k * 2] = _mm_unpacklo_epi16(r[k * 2], r[k * 2 + 1]);
+            a[k * 2 + 1] = _mm_unpackhi_epi16(r[k * 2], r[k * 2 + 1]);
+        }
+        for (int k = 0; k < 2; ++k)
+        {
+            b[k * 4] = _mm_unpacklo_epi32(a[k * 4], a[k * 4 + 2]);
+            b[k * 4 + 1] = _mm_unpackhi_epi32(a[k * 4], a[k * 4 + 2]);
+            b[k * 4 + 2] = _mm_unpacklo_epi32(a[k * 4 + 1], a[k * 4 + 3]);
+            b[k * 4 + 3] = _mm_unpackhi_epi32(a[k * 4 + 1], a[k * 4 + 3]);
+        }
+        // The rows 0-3 of two columns are in b[k], their rows 4-7 in b[k + 4]
+        for (int k = 0; k < 4; ++k)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + (k * 2) * dst_stride), _mm_unpacklo_epi64(b[k], b[k + 4]));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + (k * 2 + 1) * dst_stride), _mm_unpackhi_epi64(b[k], b[k + 4]));
+        }
+    }
+#endif
+
+    // The source column j is the destination row width - 1 - j. Rather than a pixel at a time, which writes a new row for
+    // each, the frame is transposed a tile at a time, over bands of columns narrow enough for the rows they are written to
+    // to stay in the cache
+    template<size_t SIZE, void(*TRANSPOSE)(byte *, ptrdiff_t, const byte *, ptrdiff_t)>
+    void rotate_270_degrees_clockwise_tiled(byte * const dest[], const byte * source, int width, int height)
+    {
+        const int tile = 8, band = 64;
         auto out = dest[0];
+        const auto out_stride = -static_cast<ptrdiff_t>(height) * SIZE;
+        const int tiled_width = width - width % tile, tiled_height = height - height % tile;
+
+        for (int b = 0; b < tiled_width; b += band)
+        {
+            auto band_end = std::min(b + band, tiled_width);
+            for (int i = 0; i < tiled_height; i += tile)
+                for (int j = b; j < band_end; j += tile)
+                    TRANSPOSE(&out[((((width - 1) - j) * height) + i) * SIZE], out_stride, &source[(i * width + j) * SIZE], width * SIZE);
+        }
+
+        // The pixels of the right and bottom edges, off the tiles
         for (int i = 0; i < height; ++i)
         {
             auto row_offset = i * width;
-            for (int j = 0; j < width; ++j)
+            for (int j = i < tiled_height ? tiled_width : 0; j < width; ++j)
             {
                 auto out_index = ((((width - 1) - j) * height) + i) * SIZE;
                 librealsense::copy((void*)(&out[out_index]), &(source[(row_offset + j) * SIZE]), SIZE);
@@ -159,27 +375,44 @@ namespace librealsense
         }
     }
 
-    void unpack_confidence(byte * const dest[], const byte * source, int width, int height)
+    template<size_t SIZE>
+    void rotate_270_degrees_clockwise(byte * const dest[], const byte * source, int width, int height)
     {
-#pragma pack (push, 1)
-        struct lsb_msb
-        {
-            unsigned lsb : 4;
-            unsigned msb : 4;
-        };
-#pragma pack(pop)
+        static const unpack_variants variants = { { &rotate_270_degrees_clockwise_tiled<SIZE, transpose_tile_generic<SIZE>>,
+            SSSE3_VARIANT((&rotate_270_degrees_clockwise_tiled<SIZE, transpose_tile_ssse3<SIZE>>)) } };
+        variants(dest, source, width, height);
+    }
 
+    void unpack_confidence(byte * const dest[], const byte * source, int width, int height)
+    {
         rotate_270_degrees_clockwise<1>(dest, source, width, height);
+
+        // Each rotated row is spread in place over two, of the low nibbles and of the high ones, scaled to 8 bits. From the
+        // last row, for the rows to be read before they are written over
         auto out = dest[0];
-        for (int i = (width - 1), out_i = ((width - 1) * 2); i >= 0; --i, out_i-=2)
+        for (int i = width - 1; i >= 0; --i)
         {
-            auto row_offset = i * height;
-            for (int j = 0; j < height; ++j)
+            auto in = out + i * height;
+            auto lsb = out + i * 2 * height;
+            auto msb = lsb + height;
+            int j = 0;
+#ifdef __SSSE3__
+            if (get_simd_level() >= simd_level::ssse3)
+            {
+                const __m128i high_nibbles = _mm_set1_epi8(static_cast<char>(0xf0));
+                for (; j + 16 <= height; j += 16)
+                {
+                    auto v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + j));
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(lsb + j), _mm_and_si128(_mm_slli_epi16(v, 4), high_nibbles));
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(msb + j), _mm_and_si128(v, high_nibbles));
+                }
+            }
+#endif
+            for (; j < height; ++j)
             {
-                auto val = *(reinterpret_cast<const lsb_msb*>(&out[(row_offset + j)]));
-                auto out_index = out_i * height + j;
-                out[out_index] = val.lsb << 4;
-                out[out_index + height] = val.msb << 4;
+                auto val = in[j];
+                lsb[j] = static_cast<byte>(val << 4);
+                msb[j] = val & 0xf0;
             }
         }
     }
@@ -190,6 +423,32 @@ namespace librealsense
         librealsense::copy(dest[0], source, SIZE * count);
     }
 
+    void depth_to_distance(const uint16_t * depth, float * distance, size_t count, float depth_units)
+    {
+        size_t i = 0;
+#ifdef __SSSE3__
+        if (get_simd_level() >= simd_level::ssse3)
+        {
+            const __m128 units = _mm_set_ps1(depth_units);
+            const __m128i zero = _mm_setzero_si128();
+            for (; i + 8 <= count; i += 8)
+            {
+                auto d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(depth + i));
+                _mm_storeu_ps(distance + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(d, zero)), units));
+                _mm_storeu_ps(distance + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(d, zero)), units));
+            }
+        }
+#endif
+        for (; i < count; ++i)
+            distance[i] = depth[i] * depth_units;
+    }
+
+    // In the default units of a millimeter, the sensors converting their depth with their own units instead
+    void unpack_distance_from_z16(byte * const dest[], const byte * source, int width, int height)
+    {
+        depth_to_distance(reinterpret_cast<const uint16_t *>(source), reinterpret_cast<float *>(dest[0]), size_t(width) * height, 0.001f);
+    }
+
     void copy_raw10(byte * const dest[], const byte * source, int width, int height)
     {
         auto count = width * height;
@@ -203,26 +462,92 @@ namespace librealsense
     }
 
     void unpack_y16_from_y8(byte * const d[], const byte * s, int width, int height) { unpack_pixels(d, width * height, reinterpret_cast<const uint8_t *>(s), [](uint8_t  pixel) -> uint16_t { return pixel | pixel << 8; }); }
-    void unpack_y16_from_y16_10(byte * const d[], const byte * s, int width, int height) { unpack_pixels(d, width * height, reinterpret_cast<const uint16_t*>(s), [](uint16_t pixel) -> uint16_t { return pixel << 6; }); }
-    void unpack_y8_from_y16_10(byte * const d[], const byte * s, int width, int height) { unpack_pixels(d, width * height, reinterpret_cast<const uint16_t*>(s), [](uint16_t pixel) -> uint8_t  { return pixel >> 2; }); }
-    void unpack_rw10_from_rw8(byte *  const d[], const byte * s, int width, int height)
+    void unpack_y16_from_y16_10_generic(byte * const d[], const byte * s, int width, int height) { unpack_pixels(d, width * height, reinterpret_cast<const uint16_t*>(s), [](uint16_t pixel) -> uint16_t { return pixel << 6; }); }
+    void unpack_y8_from_y16_10_generic(byte * const d[], const byte * s, int width, int height) { unpack_pixels(d, width * height, reinterpret_cast<const uint16_t*>(s), [](uint16_t pixel) -> uint8_t  { return pixel >> 2; }); }
+    // Runs a SIMD kernel over whole vectors of pixels, and leaves the remainder to the generic code.
+    // LAST_DEST_BPP is that of the last output, for the kernels whose outputs differ in their size
+    template<int(*KERNEL)(byte * const[], const byte *, int), void(*GENERIC)(byte * const[], const byte *, int, int), int OUTPUTS, int SOURCE_BPP, int DEST_BPP, int LAST_DEST_BPP = DEST_BPP>
+    void unpack_simd(byte * const dest[], const byte * source, int width, int height)
     {
+        auto count = width * height;
+        auto done = KERNEL(dest, source, count);
+        if (done == count) return;
+
+        byte * rest[OUTPUTS];
+        for (int i = 0; i < OUTPUTS; i++) rest[i] = dest[i] + done * (i == OUTPUTS - 1 ? LAST_DEST_BPP : DEST_BPP);
+        GENERIC(rest, source + done * SOURCE_BPP, count - done, 1);
+    }
+
 #ifdef __SSSE3__
+    int unpack_y16_from_y16_10_ssse3(byte * const d[], const byte * s, int n)
+    {
+        auto src = reinterpret_cast<const __m128i *>(s);
+        auto dst = reinterpret_cast<__m128i *>(d[0]);
+
+        int i = 0;
+        for (; i + 8 <= n; i += 8)
+            _mm_storeu_si128(dst++, _mm_slli_epi16(_mm_loadu_si128(src++), 6));
+        return i;
+    }
+
+    int unpack_y8_from_y16_10_ssse3(byte * const d[], const byte * s, int n)
+    {
         auto src = reinterpret_cast<const __m128i *>(s);
         auto dst = reinterpret_cast<__m128i *>(d[0]);
+        // The pixels are truncated to 8 bits like the generic code, rather than saturated by the pack
+        const __m128i low_byte = _mm_set1_epi16(0x00ff);
+
+        int i = 0;
+        for (; i + 16 <= n; i += 16, src += 2)
+        {
+            __m128i lo = _mm_and_si128(_mm_srli_epi16(_mm_loadu_si128(src), 2), low_byte);
+            __m128i hi = _mm_and_si128(_mm_srli_epi16(_mm_loadu_si128(src + 1), 2), low_byte);
+            _mm_storeu_si128(dst++, _mm_packus_epi16(lo, hi));
+        }
+        return i;
+    }
+#endif
+
+    void unpack_y16_from_y16_10(byte * const d[], const byte * s, int width, int height)
+    {
+        static const unpack_variants variants = { { &unpack_y16_from_y16_10_generic,
+            SSSE3_VARIANT((&unpack_simd<unpack_y16_from_y16_10_ssse3, unpack_y16_from_y16_10_generic, 1, 2, 2>)),
+            AVX2_VARIANT((&unpack_simd<unpack_y16_from_y16_10_avx, unpack_y16_from_y16_10_generic, 1, 2, 2>)),
+            NEON_VARIANT((&unpack_simd<unpack_y16_from_y16_10_neon, unpack_y16_from_y16_10_generic, 1, 2, 2>)) } };
+        variants(d, s, width, height);
+    }
+
+    void unpack_y8_from_y16_10(byte * const d[], const byte * s, int width, int height)
+    {
+        static const unpack_variants variants = { { &unpack_y8_from_y16_10_generic,
+            SSSE3_VARIANT((&unpack_simd<unpack_y8_from_y16_10_ssse3, unpack_y8_from_y16_10_generic, 1, 2, 1>)),
+            AVX2_VARIANT((&unpack_simd<unpack_y8_from_y16_10_avx, unpack_y8_from_y16_10_generic, 1, 2, 1>)),
+            NEON_VARIANT((&unpack_simd<unpack_y8_from_y16_10_neon, unpack_y8_from_y16_10_generic, 1, 2, 1>)) } };
+        variants(d, s, width, height);
+    }
+
+#ifdef __SSSE3__
+    int unpack_rw10_from_rw8_ssse3(byte *  const d[], const byte * s, int n)
+    {
+        auto xin = reinterpret_cast<const __m128i *>(s);
+        auto xout = reinterpret_cast<__m128i *>(d[0]);
 
-        __m128i * xin = (__m128i *)src;
-        __m128i * xout = (__m128i *) dst;
-        for (int i = 0; i < width * height; i += 16, ++xout, xin += 2)
+        int i = 0;
+        for (; i + 16 <= n; i += 16, ++xout, xin += 2)
         {
-            __m128i  in1_16 = _mm_load_si128((__m128i *)(xin));
-            __m128i  in2_16 = _mm_load_si128((__m128i *)(xin + 1));
+            __m128i  in1_16 = _mm_loadu_si128(xin);
+            __m128i  in2_16 = _mm_loadu_si128(xin + 1);
             __m128i  out1_16 = _mm_srli_epi16(in1_16, 2);
             __m128i  out2_16 = _mm_srli_epi16(in2_16, 2);
             __m128i  out8 = _mm_packus_epi16(out1_16, out2_16);
-            _mm_store_si128(xout, out8);
+            _mm_storeu_si128(xout, out8);
         }
-#else  // Generic code for when SSSE3 is not available.
+        return i;
+    }
+#endif
+
+    void unpack_rw10_from_rw8_generic(byte *  const d[], const byte * s, int width, int height)
+    {
         unsigned short* from = (unsigned short*)s;
         byte * to = d[0];
 
@@ -233,57 +558,49 @@ namespace librealsense
             ++from;
             ++to;
         }
-#endif
+    }
+
+    void unpack_rw10_from_rw8(byte *  const d[], const byte * s, int width, int height)
+    {
+        static const unpack_variants variants = { { &unpack_rw10_from_rw8_generic,
+            SSSE3_VARIANT((&unpack_simd<unpack_rw10_from_rw8_ssse3, unpack_rw10_from_rw8_generic, 1, 2, 1>)), nullptr,
+            NEON_VARIANT((&unpack_simd<unpack_rw10_from_rw8_neon, unpack_rw10_from_rw8_generic, 1, 2, 1>)) } };
+        variants(d, s, width, height);
     }
 
     // Unpack luminocity 8 bit from 10-bit packed macro-pixels (4 pixels in 5 bytes):
     // The first four bytes store the 8 MSB of each pixel, and the last byte holds the 2 LSB for each pixel :8888[2222]
-    void unpack_y8_from_rw10(byte *  const d[], const byte * s, int width, int height)
-    {
 #ifdef __SSSE3__
-        auto n = width * height;
-        assert(!(n % 48));  //We process 12 macro-pixels simultaneously to achieve performance boost
+    int unpack_y8_from_rw10_ssse3(byte *  const d[], const byte * s, int n)
+    {
         auto src = reinterpret_cast<const uint8_t *>(s);
         auto dst = reinterpret_cast<uint8_t *>(d[0]);
 
-        const __m128i * blk_0_in = reinterpret_cast<const __m128i *>(src);
-        const __m128i * blk_1_in = reinterpret_cast<const __m128i *>(src + 15);
-        const __m128i * blk_2_in = reinterpret_cast<const __m128i *>(src + 30);
-        const __m128i * blk_3_in = reinterpret_cast<const __m128i *>(src + 45);
-
-        auto blk_0_out = reinterpret_cast<__m128i *>(dst);
-        auto blk_1_out = reinterpret_cast<__m128i *>(dst + 12);
-        auto blk_2_out = reinterpret_cast<__m128i *>(dst + 24);
-        auto blk_3_out = reinterpret_cast<__m128i *>(dst + 36);
-
-        __m128i res[4];
         // The mask will reorder the input so the 12 bytes with pixels' MSB values will come first
-        static const __m128i mask = _mm_setr_epi8(0x0, 0x1, 0x2, 0x3, 0x5, 0x6, 0x7, 0x8, 0xa, 0xb, 0xc, 0xd, -1, -1, -1, -1);
-
+        const __m128i mask = _mm_setr_epi8(0x0, 0x1, 0x2, 0x3, 0x5, 0x6, 0x7, 0x8, 0xa, 0xb, 0xc, 0xd, -1, -1, -1, -1);
 
-        for (int i = 0; (i + 48) < n; i += 48, src += 60, dst += 48)
+        // We process 12 macro-pixels simultaneously to achieve performance boost. The last load and store
+        // of every block run past it, so the final block is always left to the generic code
+        int i = 0;
+        for (; (i + 48) < n; i += 48, src += 60, dst += 48)
         {
-            blk_0_in = reinterpret_cast<const __m128i *>(src);
-            blk_1_in = reinterpret_cast<const __m128i *>(src + 15);
-            blk_2_in = reinterpret_cast<const __m128i *>(src + 30);
-            blk_3_in = reinterpret_cast<const __m128i *>(src + 45);
-
-            blk_0_out = reinterpret_cast<__m128i *>(dst);
-            blk_1_out = reinterpret_cast<__m128i *>(dst + 12);
-            blk_2_out = reinterpret_cast<__m128i *>(dst + 24);
-            blk_3_out = reinterpret_cast<__m128i *>(dst + 36);
-
-            res[0] = _mm_shuffle_epi8(_mm_loadu_si128(blk_0_in), mask);
-            res[1] = _mm_shuffle_epi8(_mm_loadu_si128(blk_1_in), mask);
-            res[2] = _mm_shuffle_epi8(_mm_loadu_si128(blk_2_in), mask);
-            res[3] = _mm_shuffle_epi8(_mm_loadu_si128(blk_3_in), mask);
-
-            _mm_storeu_si128(blk_0_out, res[0]);
-            _mm_storeu_si128(blk_1_out, res[1]);
-            _mm_storeu_si128(blk_2_out, res[2]);
-            _mm_storeu_si128(blk_3_out, res[3]);
+            __m128i res[4];
+            res[0] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src)), mask);
+            res[1] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 15)), mask);
+            res[2] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 30)), mask);
+            res[3] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 45)), mask);
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), res[0]);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 12), res[1]);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 24), res[2]);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 36), res[3]);
         }
-#else  // Generic code for when SSSE3 is not available.
+        return i;
+    }
+#endif
+
+    void unpack_y8_from_rw10_generic(byte *  const d[], const byte * s, int width, int height)
+    {
         auto from = reinterpret_cast<const uint8_t *>(s);
         uint8_t * tgt = d[0];
 
@@ -294,7 +611,26 @@ namespace librealsense
             *tgt++ = from[2];
             *tgt++ = from[3];
         }
-#endif
+    }
+
+    // Runs a SIMD kernel over whole blocks of macro-pixels, and leaves the remainder to the generic code
+    template<int(*KERNEL)(byte * const[], const byte *, int)>
+    void unpack_y8_from_rw10_simd(byte *  const d[], const byte * s, int width, int height)
+    {
+        auto count = width * height;
+        auto done = KERNEL(d, s, count);
+        if (done == count) return;
+
+        byte * const rest[] = { d[0] + done };
+        unpack_y8_from_rw10_generic(rest, s + done / 4 * 5, count - done, 1);
+    }
+
+    void unpack_y8_from_rw10(byte *  const d[], const byte * s, int width, int height)
+    {
+        static const unpack_variants variants = { { &unpack_y8_from_rw10_generic,
+            SSSE3_VARIANT(&unpack_y8_from_rw10_simd<unpack_y8_from_rw10_ssse3>), nullptr,
+            NEON_VARIANT(&unpack_y8_from_rw10_simd<unpack_y8_from_rw10_neon>) } };
+        variants(d, s, width, height);
     }
 
     /////////////////////////////
@@ -302,34 +638,16 @@ namespace librealsense
     /////////////////////////////
     // This templated function unpacks YUY2 into Y8/Y16/RGB8/RGBA8/BGR8/BGRA8, depending on the compile-time parameter FORMAT.
     // It is expected that all branching outside of the loop control variable will be removed due to constant-folding.
-    template<rs2_format FORMAT> void unpack_yuy2(byte * const d[], const byte * s, int width, int height)
+#ifdef __SSSE3__
+    template<rs2_format FORMAT> void unpack_yuy2_ssse3(byte * const d[], const byte * s, int width, int height)
     {
         auto n = width * height;
-        assert(n % 16 == 0); // All currently supported color resolutions are multiples of 16 pixels. Could easily extend support to other resolutions by copying final n<16 pixels into a zero-padded buffer and recursively calling self for final iteration.
-#ifdef RS2_USE_CUDA
-        rscuda::unpack_yuy2_cuda<FORMAT>(d, s, n);
-#endif
-#if defined __SSSE3__ && ! defined ANDROID
-        static bool do_avx = has_avx();
-        #ifdef __AVX2__
+        auto src = reinterpret_cast<const __m128i *>(s);
+        auto dst = reinterpret_cast<__m128i *>(d[0]);
 
-                if (do_avx)
-                {
-                    if (FORMAT == RS2_FORMAT_Y8) unpack_yuy2_avx_y8(d, s, n);
-                    if (FORMAT == RS2_FORMAT_Y16) unpack_yuy2_avx_y16(d, s, n);
-                    if (FORMAT == RS2_FORMAT_RGB8) unpack_yuy2_avx_rgb8(d, s, n);
-                    if (FORMAT == RS2_FORMAT_RGBA8) unpack_yuy2_avx_rgba8(d, s, n);
-                    if (FORMAT == RS2_FORMAT_BGR8) unpack_yuy2_avx_bgr8(d, s, n);
-                    if (FORMAT == RS2_FORMAT_BGRA8) unpack_yuy2_avx_bgra8(d, s, n);
-                }
-                else
-        #endif
+        parallel_for(0, n / 16, 1024, [&](int first, int last)
         {
-            auto src = reinterpret_cast<const __m128i *>(s);
-            auto dst = reinterpret_cast<__m128i *>(d[0]);
-
-#pragma omp parallel for
-            for (int i = 0; i < n / 16; i++)
+            for (int i = first; i < last; i++)
             {
                 const __m128i zero = _mm_set1_epi8(0);
                 const __m128i n100 = _mm_set1_epi16(100 << 4);
@@ -348,7 +666,7 @@ namespace librealsense
                     // Align all Y components and output 16 pixels (16 bytes) at once
                     __m128i y0 = _mm_shuffle_epi8(s0, _mm_setr_epi8(1, 3, 5, 7, 9, 11, 13, 15, 0, 2, 4, 6, 8, 10, 12, 14));
                     __m128i y1 = _mm_shuffle_epi8(s1, _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15));
-                    _mm_storeu_si128(&dst[i], _mm_alignr_epi8(y0, y1, 8));
+                    _mm_storeu_si128(&dst[i], _mm_alignr_epi8(y1, y0, 8));
                     continue;
                 }
 
@@ -468,8 +786,54 @@ namespace librealsense
                     }
                 }
             }
+        });
+    }
+#endif
+
+#if defined(__SSSE3__) && !defined(ANDROID) && (defined(__AVX2__) || defined(RS2_USE_AVX2_UNPACKERS))
+    template<rs2_format FORMAT> void unpack_yuy2_avx2(byte * const d[], const byte * s, int width, int height)
+    {
+        // The AVX2 kernels consume 32 pixels at a time, the SSSE3 code completes the last 16 if needed
+        auto n = width * height / 32 * 32;
+        auto bpp = get_image_bpp(FORMAT) / 8;
+        // Split here rather than in the AVX2 file, which is kept clear of the shared C++ code
+        parallel_for(0, n / 32, 512, [&](int first, int last)
+        {
+            byte * const dest[] = { d[0] + first * 32 * bpp };
+            auto src = s + first * 64;
+            auto count = (last - first) * 32;
+            if (FORMAT == RS2_FORMAT_Y8) unpack_yuy2_avx_y8(dest, src, count);
+            if (FORMAT == RS2_FORMAT_Y16) unpack_yuy2_avx_y16(dest, src, count);
+            if (FORMAT == RS2_FORMAT_RGB8) unpack_yuy2_avx_rgb8(dest, src, count);
+            if (FORMAT == RS2_FORMAT_RGBA8) unpack_yuy2_avx_rgba8(dest, src, count);
+            if (FORMAT == RS2_FORMAT_BGR8) unpack_yuy2_avx_bgr8(dest, src, count);
+            if (FORMAT == RS2_FORMAT_BGRA8) unpack_yuy2_avx_bgra8(dest, src, count);
+        });
+
+        if (n < width * height)
+        {
+            byte * const rest[] = { d[0] + n * get_image_bpp(FORMAT) / 8 };
+            unpack_yuy2_ssse3<FORMAT>(rest, s + n * 2, width * height - n, 1);
         }
-#else  // Generic code for when SSSE3 is not available.
+    }
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    template<rs2_format FORMAT> void unpack_yuy2_neon(byte * const d[], const byte * s, int width, int height)
+    {
+        auto n = width * height;
+        if (FORMAT == RS2_FORMAT_Y8) unpack_yuy2_neon_y8(d, s, n);
+        if (FORMAT == RS2_FORMAT_Y16) unpack_yuy2_neon_y16(d, s, n);
+        if (FORMAT == RS2_FORMAT_RGB8) unpack_yuy2_neon_rgb8(d, s, n);
+        if (FORMAT == RS2_FORMAT_RGBA8) unpack_yuy2_neon_rgba8(d, s, n);
+        if (FORMAT == RS2_FORMAT_BGR8) unpack_yuy2_neon_bgr8(d, s, n);
+        if (FORMAT == RS2_FORMAT_BGRA8) unpack_yuy2_neon_bgra8(d, s, n);
+    }
+#endif
+
+    template<rs2_format FORMAT> void unpack_yuy2_generic(byte * const d[], const byte * s, int width, int height)
+    {
+        auto n = width * height;
         auto src = reinterpret_cast<const uint8_t *>(s);
         auto dst = reinterpret_cast<uint8_t *>(d[0]);
         for (; n; n -= 16, src += 32)
@@ -601,16 +965,182 @@ namespace librealsense
                 continue;
             }
         }
-    #endif
+    }
+
+    template<rs2_format FORMAT> void unpack_yuy2(byte * const d[], const byte * s, int width, int height)
+    {
+        assert(width * height % 16 == 0); // All currently supported color resolutions are multiples of 16 pixels. Could easily extend support to other resolutions by copying final n<16 pixels into a zero-padded buffer and recursively calling self for final iteration.
+#ifdef RS2_USE_CUDA
+        rscuda::unpack_yuy2_cuda<FORMAT>(d, s, width * height);
+#else
+        auto backend = environment::get_instance().get_compute_backend();
+        if (backend && backend->unpack_yuy2(FORMAT, d[0], s, width * height))
+            return;
+
+        static const unpack_variants variants = { { &unpack_yuy2_generic<FORMAT>, SSSE3_VARIANT(&unpack_yuy2_ssse3<FORMAT>),
+                                                    AVX2_VARIANT(&unpack_yuy2_avx2<FORMAT>), NEON_VARIANT(&unpack_yuy2_neon<FORMAT>) } };
+        variants(d, s, width, height);
+#endif
+    }
+
+    // These templated functions convert YUY2 (or UYVY, if UYVY is set) into the planar 4:2:0 NV12/I420 formats, two rows at a time.
+    // Every chroma sample is the rounded average of the two vertically adjacent source samples.
+    // NV12 interleaves U and V in a single plane, I420 stores the U plane followed by the V plane
+    template<rs2_format FORMAT, bool UYVY> void planar_rows_generic(const byte * row0, const byte * row1, byte * y0, byte * y1, byte * u, byte * v, int from, int width)
+    {
+        const int y_offset = UYVY ? 1 : 0, u_offset = UYVY ? 0 : 1, v_offset = UYVY ? 2 : 3;
+        const int step = FORMAT == RS2_FORMAT_NV12 ? 2 : 1;
+        for (int x = from; x < width; x += 2)
+        {
+            auto src0 = row0 + x * 2;
+            auto src1 = row1 + x * 2;
+            y0[x] = src0[y_offset];
+            y0[x + 1] = src0[y_offset + 2];
+            y1[x] = src1[y_offset];
+            y1[x + 1] = src1[y_offset + 2];
+            u[x / 2 * step] = static_cast<byte>((src0[u_offset] + src1[u_offset] + 1) >> 1);
+            v[x / 2 * step] = static_cast<byte>((src0[v_offset] + src1[v_offset] + 1) >> 1);
+        }
+    }
+
+    template<rs2_format FORMAT, bool UYVY> int planar_rows_none(const byte *, const byte *, byte *, byte *, byte *, byte *, int) { return 0; }
+
+#ifdef __SSSE3__
+    template<rs2_format FORMAT, bool UYVY> int planar_rows_ssse3(const byte * row0, const byte * row1, byte * y0, byte * y1, byte * u, byte * v, int width)
+    {
+        // Luma sits in the even bytes of YUY2 and the odd bytes of UYVY, chroma in the others, already ordered U0 V0 U1 V1 ...
+        const __m128i evens = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, -1, -1, -1, -1, -1, -1, -1, -1);
+        const __m128i odds = _mm_setr_epi8(1, 3, 5, 7, 9, 11, 13, 15, -1, -1, -1, -1, -1, -1, -1, -1);
+        const __m128i luma = UYVY ? odds : evens;
+        const __m128i chroma = UYVY ? evens : odds;
+        // Splits interleaved U/V samples into 8 U followed by 8 V
+        const __m128i split = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+
+        int x = 0;
+        for (; x + 16 <= width; x += 16)
+        {
+            __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row0 + x * 2));
+            __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row0 + x * 2 + 16));
+            __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row1 + x * 2));
+            __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row1 + x * 2 + 16));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(y0 + x), _mm_unpacklo_epi64(_mm_shuffle_epi8(a0, luma), _mm_shuffle_epi8(a1, luma)));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(y1 + x), _mm_unpacklo_epi64(_mm_shuffle_epi8(b0, luma), _mm_shuffle_epi8(b1, luma)));
+
+            __m128i uv = _mm_avg_epu8(_mm_unpacklo_epi64(_mm_shuffle_epi8(a0, chroma), _mm_shuffle_epi8(a1, chroma)),
+                                      _mm_unpacklo_epi64(_mm_shuffle_epi8(b0, chroma), _mm_shuffle_epi8(b1, chroma)));
+            if (FORMAT == RS2_FORMAT_NV12)
+            {
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(u + x), uv);
+            }
+            else
+            {
+                uv = _mm_shuffle_epi8(uv, split);
+                _mm_storel_epi64(reinterpret_cast<__m128i *>(u + x / 2), uv);
+                _mm_storel_epi64(reinterpret_cast<__m128i *>(v + x / 2), _mm_srli_si128(uv, 8));
+            }
+        }
+        return x;
+    }
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    template<rs2_format FORMAT, bool UYVY> int planar_rows_neon(const byte * row0, const byte * row1, byte * y0, byte * y1, byte * u, byte * v, int width)
+    {
+        return unpack_planar_rows_neon(row0, row1, y0, y1, u, v, width, UYVY, FORMAT == RS2_FORMAT_NV12);
+    }
+#endif
+
+    template<rs2_format FORMAT, bool UYVY, int(*KERNEL)(const byte *, const byte *, byte *, byte *, byte *, byte *, int)>
+    void unpack_planar_by_rows(byte * const d[], const byte * s, int width, int height)
+    {
+        auto luma = d[0];
+        auto chroma = d[0] + width * height;
+        auto u_plane = chroma;
+        auto v_plane = FORMAT == RS2_FORMAT_NV12 ? chroma + 1 : chroma + width * height / 4;
+        auto chroma_stride = FORMAT == RS2_FORMAT_NV12 ? width : width / 2;
+
+        for (int row = 0; row < height; row += 2)
+        {
+            auto row0 = s + row * width * 2;
+            auto row1 = row + 1 < height ? row0 + width * 2 : row0;
+            auto y0 = luma + row * width;
+            auto y1 = row + 1 < height ? y0 + width : y0;
+            auto u = u_plane + row / 2 * chroma_stride;
+            auto v = v_plane + row / 2 * chroma_stride;
+
+            auto done = KERNEL(row0, row1, y0, y1, u, v, width);
+            planar_rows_generic<FORMAT, UYVY>(row0, row1, y0, y1, u, v, done, width);
+        }
+    }
+
+    template<rs2_format FORMAT, bool UYVY> void unpack_planar(byte * const d[], const byte * s, int width, int height)
+    {
+        static const unpack_variants variants = { { &unpack_planar_by_rows<FORMAT, UYVY, planar_rows_none<FORMAT, UYVY>>,
+            SSSE3_VARIANT((&unpack_planar_by_rows<FORMAT, UYVY, planar_rows_ssse3<FORMAT, UYVY>>)), nullptr,
+            NEON_VARIANT((&unpack_planar_by_rows<FORMAT, UYVY, planar_rows_neon<FORMAT, UYVY>>)) } };
+        variants(d, s, width, height);
+    }
+
+    // This templated function unpacks YUY2 into RGB8/RGBA8/BGR8/BGRA8 scaled down by SCALE in both dimensions, in a single pass.
+    // Every SCALExSCALE block of source pixels is averaged (box filter) before the color conversion. width and height are the source's
+    template<rs2_format FORMAT, int SCALE> void unpack_yuy2_downscale(byte * const d[], const byte * s, int width, int height)
+    {
+        static_assert(SCALE % 2 == 0, "Blocks must cover whole YUY2 macro-pixels");
+        const int area = SCALE * SCALE;
+        auto out_width = width / SCALE;
+        auto out_height = height / SCALE;
+        auto dst = reinterpret_cast<uint8_t *>(d[0]);
+
+        for (int y = 0; y < out_height; ++y)
+        {
+            auto block = reinterpret_cast<const uint8_t *>(s) + y * SCALE * width * 2;
+            for (int x = 0; x < out_width; ++x, block += SCALE * 2)
+            {
+                int32_t sum_y = 0, sum_u = 0, sum_v = 0;
+                for (int j = 0; j < SCALE; ++j)
+                {
+                    auto src = block + j * width * 2;
+                    for (int i = 0; i < SCALE; i += 2, src += 4)
+                    {
+                        sum_y += src[0] + src[2];
+                        sum_u += src[1];
+                        sum_v += src[3];
+                    }
+                }
+
+                // Rounded block averages, with one chroma sample per two pixels
+                int32_t c = (sum_y + area / 2) / area - 16;
+                int32_t e_d = (sum_u + area / 4) / (area / 2) - 128;
+                int32_t e_v = (sum_v + area / 4) / (area / 2) - 128;
+
+                int32_t t;
+                #define clamp(x)  ((t=(x)) > 255 ? 255 : t < 0 ? 0 : t)
+                uint8_t r = clamp((298 * c + 409 * e_v + 128) >> 8);
+                uint8_t g = clamp((298 * c - 100 * e_d - 208 * e_v + 128) >> 8);
+                uint8_t b = clamp((298 * c + 516 * e_d + 128) >> 8);
+                #undef clamp
+
+                if (FORMAT == RS2_FORMAT_RGB8 || FORMAT == RS2_FORMAT_RGBA8)
+                {
+                    *dst++ = r; *dst++ = g; *dst++ = b;
+                }
+                else
+                {
+                    *dst++ = b; *dst++ = g; *dst++ = r;
+                }
+                if (FORMAT == RS2_FORMAT_RGBA8 || FORMAT == RS2_FORMAT_BGRA8)
+                    *dst++ = 255;
+            }
+        }
     }
 
     // This templated function unpacks UYVY into RGB8/RGBA8/BGR8/BGRA8, depending on the compile-time parameter FORMAT.
     // It is expected that all branching outside of the loop control variable will be removed due to constant-folding.
-    template<rs2_format FORMAT> void unpack_uyvy(byte * const d[], const byte * s, int width, int height)
+#ifdef __SSSE3__
+    template<rs2_format FORMAT> void unpack_uyvy_ssse3(byte * const d[], const byte * s, int width, int height)
     {
         auto n = width * height;
-        assert(n % 16 == 0); // All currently supported color resolutions are multiples of 16 pixels. Could easily extend support to other resolutions by copying final n<16 pixels into a zero-padded buffer and recursively calling self for final iteration.
-#ifdef __SSSE3__
         auto src = reinterpret_cast<const __m128i *>(s);
         auto dst = reinterpret_cast<__m128i *>(d[0]);
         for (; n; n -= 16)
@@ -737,7 +1267,12 @@ namespace librealsense
                 }
             }
         }
-#else  // Generic code for when SSSE3 is not available.
+    }
+#endif
+
+    template<rs2_format FORMAT> void unpack_uyvy_generic(byte * const d[], const byte * s, int width, int height)
+    {
+        auto n = width * height;
         auto src = reinterpret_cast<const uint8_t *>(s);
         auto dst = reinterpret_cast<uint8_t *>(d[0]);
         for (; n; n -= 16, src += 32)
@@ -842,7 +1377,13 @@ namespace librealsense
                 continue;
             }
         }
-#endif
+    }
+
+    template<rs2_format FORMAT> void unpack_uyvy(byte * const d[], const byte * s, int width, int height)
+    {
+        assert(width * height % 16 == 0); // All currently supported color resolutions are multiples of 16 pixels. Could easily extend support to other resolutions by copying final n<16 pixels into a zero-padded buffer and recursively calling self for final iteration.
+        static const unpack_variants variants = { { &unpack_uyvy_generic<FORMAT>, SSSE3_VARIANT(&unpack_uyvy_ssse3<FORMAT>) } };
+        variants(d, s, width, height);
     }
 
     //////////////////////////////////////
@@ -861,33 +1402,81 @@ namespace librealsense
     }
 
     struct y8i_pixel { uint8_t l, r; };
+    void unpack_y8_y8_from_y8i_generic(byte * const dest[], const byte * source, int width, int height)
+    {
+        split_frame(dest, width * height, reinterpret_cast<const y8i_pixel*>(source),
+            [](const y8i_pixel & p) -> uint8_t { return p.l; },
+            [](const y8i_pixel & p) -> uint8_t { return p.r; });
+    }
+
     void unpack_y8_y8_from_y8i(byte * const dest[], const byte * source, int width, int height)
     {
         auto count = width * height;
 #ifdef RS2_USE_CUDA
         rscuda::split_frame_y8_y8_from_y8i_cuda(dest, count, reinterpret_cast<const y8i_pixel *>(source));
 #else
-        split_frame(dest, count, reinterpret_cast<const y8i_pixel*>(source),
-            [](const y8i_pixel & p) -> uint8_t { return p.l; },
-            [](const y8i_pixel & p) -> uint8_t { return p.r; });
+        static const unpack_variants variants = { { &unpack_y8_y8_from_y8i_generic, nullptr, nullptr,
+            NEON_VARIANT((&unpack_simd<unpack_y8_y8_from_y8i_neon, unpack_y8_y8_from_y8i_generic, 2, 2, 1>)) } };
+        variants(dest, source, width, height);
 #endif
     }
 
     struct y12i_pixel { uint8_t rl : 8, rh : 4, ll : 4, lh : 8; int l() const { return lh << 4 | ll; } int r() const { return rh << 8 | rl; } };
+    void unpack_y16_y16_from_y12i_10_generic(byte * const dest[], const byte * source, int width, int height)
+    {
+        split_frame(dest, width * height, reinterpret_cast<const y12i_pixel*>(source),
+        [](const y12i_pixel & p) -> uint16_t { return p.l() << 6 | p.l() >> 4; },  // We want to convert 10-bit data to 16-bit data
+        [](const y12i_pixel & p) -> uint16_t { return p.r() << 6 | p.r() >> 4; }); // Multiply by 64 1/16 to efficiently approximate 65535/1023
+    }
+
+#ifdef __SSSE3__
+    int unpack_y16_y16_from_y12i_10_ssse3(byte * const dest[], const byte * source, int count)
+    {
+        auto left = reinterpret_cast<__m128i *>(dest[0]);
+        auto right = reinterpret_cast<__m128i *>(dest[1]);
+
+        // Gather the two bytes holding each 12-bit value of 8 pixels into 16-bit lanes. Pixels 0-4 are picked
+        // from the first 16 bytes of the block, pixels 5-7 from the 16 bytes starting at the block's 8th byte
+        const __m128i left_lo = _mm_setr_epi8(1, 2, 4, 5, 7, 8, 10, 11, 13, 14, -1, -1, -1, -1, -1, -1);
+        const __m128i left_hi = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 8, 9, 11, 12, 14, 15);
+        const __m128i right_lo = _mm_setr_epi8(0, 1, 3, 4, 6, 7, 9, 10, 12, 13, -1, -1, -1, -1, -1, -1);
+        const __m128i right_hi = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 7, 8, 10, 11, 13, 14);
+        const __m128i mask = _mm_set1_epi16(0x0fff);
+
+        int i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i * 3));
+            __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i * 3 + 8));
+
+            // Every pixel is packed as [rl:8][rh:4 ll:4][lh:8]
+            __m128i l = _mm_srli_epi16(_mm_or_si128(_mm_shuffle_epi8(lo, left_lo), _mm_shuffle_epi8(hi, left_hi)), 4);
+            __m128i r = _mm_and_si128(_mm_or_si128(_mm_shuffle_epi8(lo, right_lo), _mm_shuffle_epi8(hi, right_hi)), mask);
+
+            // Expand the 10 bits of data to the full 16-bit range, like the generic code
+            _mm_storeu_si128(left++, _mm_or_si128(_mm_slli_epi16(l, 6), _mm_srli_epi16(l, 4)));
+            _mm_storeu_si128(right++, _mm_or_si128(_mm_slli_epi16(r, 6), _mm_srli_epi16(r, 4)));
+        }
+        return i;
+    }
+#endif
+
     void unpack_y16_y16_from_y12i_10(byte * const dest[], const byte * source, int width, int height)
     {
         auto count = width * height;
 #ifdef RS2_USE_CUDA
     rscuda::split_frame_y16_y16_from_y12i_cuda(dest, count, reinterpret_cast<const y12i_pixel *>(source));
 #else
-        split_frame(dest, count, reinterpret_cast<const y12i_pixel*>(source),
-        [](const y12i_pixel & p) -> uint16_t { return p.l() << 6 | p.l() >> 4; },  // We want to convert 10-bit data to 16-bit data
-        [](const y12i_pixel & p) -> uint16_t { return p.r() << 6 | p.r() >> 4; }); // Multiply by 64 1/16 to efficiently approximate 65535/1023
+        static const unpack_variants variants = { { &unpack_y16_y16_from_y12i_10_generic,
+            SSSE3_VARIANT((&unpack_simd<unpack_y16_y16_from_y12i_10_ssse3, unpack_y16_y16_from_y12i_10_generic, 2, 3, 2>)),
+            AVX2_VARIANT((&unpack_simd<unpack_y16_y16_from_y12i_10_avx, unpack_y16_y16_from_y12i_10_generic, 2, 3, 2>)),
+            NEON_VARIANT((&unpack_simd<unpack_y16_y16_from_y12i_10_neon, unpack_y16_y16_from_y12i_10_generic, 2, 3, 2>)) } };
+        variants(dest, source, width, height);
 #endif
     }
 
     struct f200_inzi_pixel { uint16_t z16; uint8_t y8; };
-    void unpack_z16_y8_from_f200_inzi(byte * const dest[], const byte * source, int width, int height)
+    void unpack_z16_y8_from_f200_inzi_generic(byte * const dest[], const byte * source, int width, int height)
     {
         auto count = width * height;
         split_frame(dest, count, reinterpret_cast<const f200_inzi_pixel*>(source),
@@ -895,7 +1484,7 @@ namespace librealsense
             [](const f200_inzi_pixel & p) -> uint8_t { return p.y8; });
     }
 
-    void unpack_z16_y16_from_f200_inzi(byte * const dest[], const byte * source, int width, int height)
+    void unpack_z16_y16_from_f200_inzi_generic(byte * const dest[], const byte * source, int width, int height)
     {
         auto count = width * height;
         split_frame(dest, count, reinterpret_cast<const f200_inzi_pixel*>(source),
@@ -903,15 +1492,65 @@ namespace librealsense
             [](const f200_inzi_pixel & p) -> uint16_t { return p.y8 | p.y8 << 8; });
     }
 
+#ifdef __SSSE3__
+    // Splits 8 pixels at a time, from the 16 bytes of pixels 0-4 and the 16 bytes starting at the 8th byte, for pixels 5-7
+    template<bool Y16>
+    int unpack_z16_y_from_f200_inzi_ssse3(byte * const dest[], const byte * source, int count)
+    {
+        auto depth = reinterpret_cast<__m128i *>(dest[0]);
+        auto ir = dest[1];
+
+        // Every pixel is packed as [z:16][y:8]
+        const __m128i z_lo = _mm_setr_epi8(0, 1, 3, 4, 6, 7, 9, 10, 12, 13, -1, -1, -1, -1, -1, -1);
+        const __m128i z_hi = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 7, 8, 10, 11, 13, 14);
+        const __m128i y_lo = Y16 ? _mm_setr_epi8(2, 2, 5, 5, 8, 8, 11, 11, 14, 14, -1, -1, -1, -1, -1, -1)
+                                 : _mm_setr_epi8(2, 5, 8, 11, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+        const __m128i y_hi = Y16 ? _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 9, 9, 12, 12, 15, 15)
+                                 : _mm_setr_epi8(-1, -1, -1, -1, -1, 9, 12, 15, -1, -1, -1, -1, -1, -1, -1, -1);
+
+        int i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i * 3));
+            __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i * 3 + 8));
+
+            _mm_storeu_si128(depth++, _mm_or_si128(_mm_shuffle_epi8(lo, z_lo), _mm_shuffle_epi8(hi, z_hi)));
+            __m128i y = _mm_or_si128(_mm_shuffle_epi8(lo, y_lo), _mm_shuffle_epi8(hi, y_hi));
+            if (Y16) _mm_storeu_si128(reinterpret_cast<__m128i *>(ir + i * 2), y);
+            else _mm_storel_epi64(reinterpret_cast<__m128i *>(ir + i), y);
+        }
+        return i;
+    }
+#endif
+
+    void unpack_z16_y8_from_f200_inzi(byte * const dest[], const byte * source, int width, int height)
+    {
+        static const unpack_variants variants = { { &unpack_z16_y8_from_f200_inzi_generic,
+            SSSE3_VARIANT((&unpack_simd<unpack_z16_y_from_f200_inzi_ssse3<false>, unpack_z16_y8_from_f200_inzi_generic, 2, 3, 2, 1>)),
+            AVX2_VARIANT((&unpack_simd<unpack_z16_y8_from_f200_inzi_avx, unpack_z16_y8_from_f200_inzi_generic, 2, 3, 2, 1>)),
+            NEON_VARIANT((&unpack_simd<unpack_z16_y8_from_f200_inzi_neon, unpack_z16_y8_from_f200_inzi_generic, 2, 3, 2, 1>)) } };
+        variants(dest, source, width, height);
+    }
+
+    void unpack_z16_y16_from_f200_inzi(byte * const dest[], const byte * source, int width, int height)
+    {
+        static const unpack_variants variants = { { &unpack_z16_y16_from_f200_inzi_generic,
+            SSSE3_VARIANT((&unpack_simd<unpack_z16_y_from_f200_inzi_ssse3<true>, unpack_z16_y16_from_f200_inzi_generic, 2, 3, 2>)),
+            AVX2_VARIANT((&unpack_simd<unpack_z16_y16_from_f200_inzi_avx, unpack_z16_y16_from_f200_inzi_generic, 2, 3, 2>)),
+            NEON_VARIANT((&unpack_simd<unpack_z16_y16_from_f200_inzi_neon, unpack_z16_y16_from_f200_inzi_generic, 2, 3, 2>)) } };
+        variants(dest, source, width, height);
+    }
+
+    // The SR300 sends the infrared plane first, then the depth plane, which is copied as is
     void unpack_z16_y8_from_sr300_inzi(byte * const dest[], const byte * source, int width, int height)
     {
         auto count = width * height;
         auto in = reinterpret_cast<const uint16_t*>(source);
-        auto out_ir = reinterpret_cast<uint8_t *>(dest[1]);
 #ifdef RS2_USE_CUDA
-        rscuda::unpack_z16_y8_from_sr300_inzi_cuda(out_ir, in, count);
+        rscuda::unpack_z16_y8_from_sr300_inzi_cuda(reinterpret_cast<uint8_t *>(dest[1]), in, count);
 #else
-        for (int i = 0; i < count; ++i) *out_ir++ = *in++ >> 2;
+        unpack_y8_from_y16_10(&dest[1], source, width, height);
+        in += count;
 #endif
         librealsense::copy(dest[0], in, count * 2);
     }
@@ -920,16 +1559,16 @@ namespace librealsense
     {
         auto count = width * height;
         auto in = reinterpret_cast<const uint16_t*>(source);
-        auto out_ir = reinterpret_cast<uint16_t*>(dest[1]);
 #ifdef RS2_USE_CUDA
-        rscuda::unpack_z16_y16_from_sr300_inzi_cuda(out_ir, in, count);
+        rscuda::unpack_z16_y16_from_sr300_inzi_cuda(reinterpret_cast<uint16_t *>(dest[1]), in, count);
 #else
-        for (int i = 0; i < count; ++i) *out_ir++ = *in++ << 6;
+        unpack_y16_from_y16_10(&dest[1], source, width, height);
+        in += count;
 #endif
         librealsense::copy(dest[0], in, count * 2);
     }
 
-    void unpack_rgb_from_bgr(byte * const dest[], const byte * source, int width, int height)
+    void unpack_rgb_from_bgr_generic(byte * const dest[], const byte * source, int width, int height)
     {
         auto count = width * height;
         auto in = reinterpret_cast<const uint8_t *>(source);
@@ -942,12 +1581,195 @@ namespace librealsense
         }
     }
 
-#ifdef ZERO_COPY
-    constexpr bool requires_processing = false;
+    void unpack_rgb_from_bgr(byte * const dest[], const byte * source, int width, int height)
+    {
+        static const unpack_variants variants = { { &unpack_rgb_from_bgr_generic, nullptr, nullptr,
+            NEON_VARIANT((&unpack_simd<unpack_rgb_from_bgr_neon, unpack_rgb_from_bgr_generic, 1, 3, 3>)) } };
+        variants(dest, source, width, height);
+    }
+
+    bool is_pass_through(const pixel_format_unpacker& unpacker)
+    {
+        // Plain copies of a single output can be served directly from the backend buffer
+        return unpacker.outputs.size() == 1 &&
+               (unpacker.unpack == &copy_pixels<1> || unpacker.unpack == &copy_pixels<2>) &&
+               get_image_bpp(unpacker.outputs.front().format) == (unpacker.unpack == &copy_pixels<1> ? 8 : 16);
+    }
+
+    bool is_row_separable(const pixel_format_unpacker& unpacker)
+    {
+        static const std::vector<void(*)(byte * const[], const byte *, int, int)> separable = {
+            &copy_pixels<1>, &copy_pixels<2>,
+            &unpack_yuy2<RS2_FORMAT_Y8>, &unpack_yuy2<RS2_FORMAT_Y16>, &unpack_yuy2<RS2_FORMAT_RGB8>,
+            &unpack_yuy2<RS2_FORMAT_RGBA8>, &unpack_yuy2<RS2_FORMAT_BGR8>, &unpack_yuy2<RS2_FORMAT_BGRA8>,
+            &unpack_uyvy<RS2_FORMAT_RGB8>, &unpack_uyvy<RS2_FORMAT_RGBA8>, &unpack_uyvy<RS2_FORMAT_BGR8>, &unpack_uyvy<RS2_FORMAT_BGRA8>,
+            &unpack_y16_from_y8, &unpack_y16_from_y16_10, &unpack_y8_from_y16_10,
+            &unpack_y8_y8_from_y8i, &unpack_y16_y16_from_y12i_10,
+            &unpack_z16_y8_from_f200_inzi, &unpack_z16_y16_from_f200_inzi,
+            &unpack_rgb_from_bgr };
+
+        return std::find(separable.begin(), separable.end(), unpacker.unpack) != separable.end();
+    }
+
+    void unpack_cropped_rows(const pixel_format_unpacker& unpacker, byte * const dest[], const byte * source,
+                             int source_stride, int bytes_per_pixel, int width, int rows)
+    {
+        // The kernels of the chroma subsampled formats convert 16 pixels at a time
+        static const std::vector<void(*)(byte * const[], const byte *, int, int)> subsampled = {
+            &unpack_yuy2<RS2_FORMAT_Y8>, &unpack_yuy2<RS2_FORMAT_Y16>, &unpack_yuy2<RS2_FORMAT_RGB8>,
+            &unpack_yuy2<RS2_FORMAT_RGBA8>, &unpack_yuy2<RS2_FORMAT_BGR8>, &unpack_yuy2<RS2_FORMAT_BGRA8>,
+            &unpack_uyvy<RS2_FORMAT_RGB8>, &unpack_uyvy<RS2_FORMAT_RGBA8>, &unpack_uyvy<RS2_FORMAT_BGR8>, &unpack_uyvy<RS2_FORMAT_BGRA8> };
+        auto granularity = std::find(subsampled.begin(), subsampled.end(), unpacker.unpack) != subsampled.end() ? 16 : 1;
+
+        auto source_row = width * bytes_per_pixel;
+        if (source_stride == source_row && (width * rows) % granularity == 0)
+        {
+            unpacker.unpack(dest, source, width, rows);
+            return;
+        }
+
+        std::array<byte *, 2> row_dest{};
+        std::array<int, 2> dest_row{};
+        for (size_t i = 0; i < unpacker.outputs.size(); i++)
+        {
+            row_dest[i] = dest[i];
+            dest_row[i] = width * get_image_bpp(unpacker.outputs[i].format) / 8;
+        }
+
+        auto padded_width = (width + granularity - 1) / granularity * granularity;
+        std::vector<byte> scratch_source;
+        std::array<std::vector<byte>, 2> scratch_dest;
+        std::array<byte *, 2> scratch{};
+        if (padded_width != width)
+        {
+            scratch_source.resize(padded_width * bytes_per_pixel);
+            for (size_t i = 0; i < unpacker.outputs.size(); i++)
+            {
+                scratch_dest[i].resize(padded_width * get_image_bpp(unpacker.outputs[i].format) / 8);
+                scratch[i] = scratch_dest[i].data();
+            }
+        }
+        for (int y = 0; y < rows; ++y)
+        {
+            auto src = source + y * source_stride;
+            if (padded_width == width)
+                unpacker.unpack(row_dest.data(), src, width, 1);
+            else
+            {
+                librealsense::copy(scratch_source.data(), src, source_row);
+                unpacker.unpack(scratch.data(), scratch_source.data(), padded_width, 1);
+                for (size_t i = 0; i < unpacker.outputs.size(); i++)
+                    librealsense::copy(row_dest[i], scratch[i], dest_row[i]);
+            }
+            for (size_t i = 0; i < unpacker.outputs.size(); i++)
+                row_dest[i] += dest_row[i];
+        }
+    }
+
+    bool unpacks_on_device(const pixel_format_unpacker& unpacker)
+    {
+#ifdef RS2_USE_CUDA
+        static const std::vector<void(*)(byte * const[], const byte *, int, int)> on_device = {
+            &unpack_yuy2<RS2_FORMAT_Y16>, &unpack_yuy2<RS2_FORMAT_RGB8>, &unpack_yuy2<RS2_FORMAT_RGBA8>,
+            &unpack_yuy2<RS2_FORMAT_BGR8>, &unpack_yuy2<RS2_FORMAT_BGRA8> };
+
+        return unpacker.outputs.size() == 1 &&
+               std::find(on_device.begin(), on_device.end(), unpacker.unpack) != on_device.end();
 #else
-    constexpr bool requires_processing = true;
+        return false;
+#endif
+    }
+
+#ifdef RS2_USE_CUDA
+    void unpack_to_device(const pixel_format_unpacker& unpacker, byte * device_dest, const byte * source, int width, int height)
+    {
+        assert(unpacks_on_device(unpacker));
+        rscuda::unpack_yuy2_cuda_to_device(source, device_dest, width * height, unpacker.outputs.front().format);
+    }
 #endif
 
+    bool copy_image(byte * dest, int dest_stride, rs2_format dest_format, const byte * source, int source_stride, rs2_format source_format, int width, int height)
+    {
+        typedef void(*unpack_func)(byte * const[], const byte *, int, int);
+        struct conversion { rs2_format source, dest; unpack_func unpack; };
+        // Row separable unpackers only, for the rows to be converted straight into the strides of the destination
+        static const conversion conversions[] = {
+            { RS2_FORMAT_YUYV, RS2_FORMAT_Y8, &unpack_yuy2<RS2_FORMAT_Y8> },
+            { RS2_FORMAT_YUYV, RS2_FORMAT_Y16, &unpack_yuy2<RS2_FORMAT_Y16> },
+            { RS2_FORMAT_YUYV, RS2_FORMAT_RGB8, &unpack_yuy2<RS2_FORMAT_RGB8> },
+            { RS2_FORMAT_YUYV, RS2_FORMAT_RGBA8, &unpack_yuy2<RS2_FORMAT_RGBA8> },
+            { RS2_FORMAT_YUYV, RS2_FORMAT_BGR8, &unpack_yuy2<RS2_FORMAT_BGR8> },
+            { RS2_FORMAT_YUYV, RS2_FORMAT_BGRA8, &unpack_yuy2<RS2_FORMAT_BGRA8> },
+            { RS2_FORMAT_UYVY, RS2_FORMAT_RGB8, &unpack_uyvy<RS2_FORMAT_RGB8> },
+            { RS2_FORMAT_UYVY, RS2_FORMAT_RGBA8, &unpack_uyvy<RS2_FORMAT_RGBA8> },
+            { RS2_FORMAT_UYVY, RS2_FORMAT_BGR8, &unpack_uyvy<RS2_FORMAT_BGR8> },
+            { RS2_FORMAT_UYVY, RS2_FORMAT_BGRA8, &unpack_uyvy<RS2_FORMAT_BGRA8> },
+            { RS2_FORMAT_Y8, RS2_FORMAT_Y16, &unpack_y16_from_y8 },
+            // Swapping the first and third channels converts both ways
+            { RS2_FORMAT_BGR8, RS2_FORMAT_RGB8, &unpack_rgb_from_bgr },
+            { RS2_FORMAT_RGB8, RS2_FORMAT_BGR8, &unpack_rgb_from_bgr } };
+
+        unpack_func unpack = nullptr;
+        // The kernels of the chroma subsampled formats convert 16 pixels at a time
+        int granularity = 1;
+        if (source_format == dest_format)
+        {
+            if (get_image_bpp(source_format) % 8 != 0 || source_format == RS2_FORMAT_Z16_RVL)
+                return false;
+        }
+        else
+        {
+            for (auto&& c : conversions)
+                if (c.source == source_format && c.dest == dest_format) unpack = c.unpack;
+            if (!unpack)
+                return false;
+            if (source_format == RS2_FORMAT_YUYV || source_format == RS2_FORMAT_UYVY)
+                granularity = 16;
+        }
+
+        auto source_row = width * get_image_bpp(source_format) / 8;
+        auto dest_row = width * get_image_bpp(dest_format) / 8;
+        if (!unpack)
+        {
+            if (source_stride == source_row && dest_stride == dest_row)
+                librealsense::copy(dest, source, dest_row * height);
+            else
+                for (int y = 0; y < height; ++y)
+                    librealsense::copy(dest + y * dest_stride, source + y * source_stride, dest_row);
+            return true;
+        }
+
+        // Contiguous images are converted at once; otherwise row by row, through scratch rows when a row is not a whole number of kernel steps
+        if (source_stride == source_row && dest_stride == dest_row && (width * height) % granularity == 0)
+        {
+            unpack(&dest, source, width, height);
+            return true;
+        }
+
+        auto padded_width = (width + granularity - 1) / granularity * granularity;
+        std::vector<byte> scratch_source, scratch_dest;
+        if (padded_width != width)
+        {
+            scratch_source.resize(padded_width * get_image_bpp(source_format) / 8);
+            scratch_dest.resize(padded_width * get_image_bpp(dest_format) / 8);
+        }
+        for (int y = 0; y < height; ++y)
+        {
+            auto src = source + y * source_stride;
+            byte * dst = dest + y * dest_stride;
+            if (padded_width == width)
+            {
+                unpack(&dst, src, width, 1);
+                continue;
+            }
+            librealsense::copy(scratch_source.data(), src, source_row);
+            auto scratch = scratch_dest.data();
+            unpack(&scratch, scratch_source.data(), padded_width, 1);
+            librealsense::copy(dst, scratch, dest_row);
+        }
+        return true;
+    }
+
     resolution rotate_resolution(resolution res)
     {
         return resolution{ res.height , res.width};
@@ -958,6 +1780,11 @@ namespace librealsense
         return resolution{ res.height , res.width * 2 };
     }
 
+    template<int SCALE> resolution downscale_resolution(resolution res)
+    {
+        return resolution{ res.width / SCALE, res.height / SCALE };
+    }
+
     //////////////////////////
     // Native pixel formats //
     //////////////////////////
@@ -974,21 +1801,41 @@ namespace librealsense
                                                                                { false,               &copy_pixels<2>,                               { { RS2_STREAM_COLOR,          RS2_FORMAT_YUYV } } },
                                                                                { true,                &unpack_yuy2<RS2_FORMAT_RGBA8>,                { { RS2_STREAM_COLOR,          RS2_FORMAT_RGBA8 } } },
                                                                                { true,                &unpack_yuy2<RS2_FORMAT_BGR8 >,                { { RS2_STREAM_COLOR,          RS2_FORMAT_BGR8 } } },
-                                                                               { true,                &unpack_yuy2<RS2_FORMAT_BGRA8>,                { { RS2_STREAM_COLOR,          RS2_FORMAT_BGRA8 } } } } };
+                                                                               { true,                &unpack_yuy2<RS2_FORMAT_BGRA8>,                { { RS2_STREAM_COLOR,          RS2_FORMAT_BGRA8 } } },
+                                                                               { true,                &unpack_planar<RS2_FORMAT_NV12, false>,        { { RS2_STREAM_COLOR,          RS2_FORMAT_NV12 } } },
+                                                                               { true,                &unpack_planar<RS2_FORMAT_I420, false>,        { { RS2_STREAM_COLOR,          RS2_FORMAT_I420 } } } } };
+    const native_pixel_format pf_yuy2_downscaled          = { 'YUY2', 1, 2, {  { true,                &unpack_yuy2<RS2_FORMAT_RGB8 >,                { { RS2_STREAM_COLOR,          RS2_FORMAT_RGB8 } } },
+                                                                               { true,                &unpack_yuy2<RS2_FORMAT_Y16>,                  { { RS2_STREAM_COLOR,          RS2_FORMAT_Y16 } } },
+                                                                               { false,               &copy_pixels<2>,                               { { RS2_STREAM_COLOR,          RS2_FORMAT_YUYV } } },
+                                                                               { true,                &unpack_yuy2<RS2_FORMAT_RGBA8>,                { { RS2_STREAM_COLOR,          RS2_FORMAT_RGBA8 } } },
+                                                                               { true,                &unpack_yuy2<RS2_FORMAT_BGR8 >,                { { RS2_STREAM_COLOR,          RS2_FORMAT_BGR8 } } },
+                                                                               { true,                &unpack_yuy2<RS2_FORMAT_BGRA8>,                { { RS2_STREAM_COLOR,          RS2_FORMAT_BGRA8 } } },
+                                                                               { true,                &unpack_planar<RS2_FORMAT_NV12, false>,        { { RS2_STREAM_COLOR,          RS2_FORMAT_NV12 } } },
+                                                                               { true,                &unpack_planar<RS2_FORMAT_I420, false>,        { { RS2_STREAM_COLOR,          RS2_FORMAT_I420 } } },
+                                                                               // Converted and scaled down in a single pass
+                                                                               { true,                &unpack_yuy2_downscale<RS2_FORMAT_RGB8, 2>,    { { RS2_STREAM_COLOR,          RS2_FORMAT_RGB8,  downscale_resolution<2> } } },
+                                                                               { true,                &unpack_yuy2_downscale<RS2_FORMAT_RGBA8, 2>,   { { RS2_STREAM_COLOR,          RS2_FORMAT_RGBA8, downscale_resolution<2> } } },
+                                                                               { true,                &unpack_yuy2_downscale<RS2_FORMAT_BGR8, 2>,    { { RS2_STREAM_COLOR,          RS2_FORMAT_BGR8,  downscale_resolution<2> } } },
+                                                                               { true,                &unpack_yuy2_downscale<RS2_FORMAT_BGRA8, 2>,   { { RS2_STREAM_COLOR,          RS2_FORMAT_BGRA8, downscale_resolution<2> } } },
+                                                                               { true,                &unpack_yuy2_downscale<RS2_FORMAT_RGB8, 4>,    { { RS2_STREAM_COLOR,          RS2_FORMAT_RGB8,  downscale_resolution<4> } } },
+                                                                               { true,                &unpack_yuy2_downscale<RS2_FORMAT_RGBA8, 4>,   { { RS2_STREAM_COLOR,          RS2_FORMAT_RGBA8, downscale_resolution<4> } } },
+                                                                               { true,                &unpack_yuy2_downscale<RS2_FORMAT_BGR8, 4>,    { { RS2_STREAM_COLOR,          RS2_FORMAT_BGR8,  downscale_resolution<4> } } },
+                                                                               { true,                &unpack_yuy2_downscale<RS2_FORMAT_BGRA8, 4>,   { { RS2_STREAM_COLOR,          RS2_FORMAT_BGRA8, downscale_resolution<4> } } } } };
 
     const native_pixel_format pf_confidence_l500          = { 'C   ', 1, 1, {  { true,                &unpack_confidence,                            { { RS2_STREAM_CONFIDENCE,     RS2_FORMAT_RAW8, l500_confidence_resolution } } },
-                                                                               { requires_processing, &copy_pixels<1>,                               { { RS2_STREAM_CONFIDENCE,     RS2_FORMAT_RAW8 } } } } };
+                                                                               { true,                &copy_pixels<1>,                               { { RS2_STREAM_CONFIDENCE,     RS2_FORMAT_RAW8 } } } } };
     const native_pixel_format pf_z16_l500                 = { 'Z16 ', 1, 2, {  { true,                &rotate_270_degrees_clockwise<2>,              { { RS2_STREAM_DEPTH,          RS2_FORMAT_Z16,  rotate_resolution } } },
-                                                                               { requires_processing, &copy_pixels<2>,                               { { RS2_STREAM_DEPTH,          RS2_FORMAT_Z16                    } } } } };
+                                                                               { true,                &copy_pixels<2>,                               { { RS2_STREAM_DEPTH,          RS2_FORMAT_Z16                    } } } } };
     const native_pixel_format pf_y8_l500                  = { 'GREY', 1, 1, {  { true,                &rotate_270_degrees_clockwise<1>,              { { RS2_STREAM_INFRARED,       RS2_FORMAT_Y8,   rotate_resolution } } },
-                                                                               { requires_processing, &copy_pixels<1>,                               { { RS2_STREAM_INFRARED,       RS2_FORMAT_Y8 } } } } };
-    const native_pixel_format pf_y8                       = { 'GREY', 1, 1, {  { requires_processing, &copy_pixels<1>,                             { { { RS2_STREAM_INFRARED, 1 },  RS2_FORMAT_Y8  } } } } };
+                                                                               { true,                &copy_pixels<1>,                               { { RS2_STREAM_INFRARED,       RS2_FORMAT_Y8 } } } } };
+    const native_pixel_format pf_y8                       = { 'GREY', 1, 1, {  { true,                &copy_pixels<1>,                             { { { RS2_STREAM_INFRARED, 1 },  RS2_FORMAT_Y8  } } } } };
     const native_pixel_format pf_y16                      = { 'Y16 ', 1, 2, {  { true,                &unpack_y16_from_y16_10,                     { { { RS2_STREAM_INFRARED, 1 },  RS2_FORMAT_Y16 } } } } };
     const native_pixel_format pf_y8i                      = { 'Y8I ', 1, 2, {  { true,                &unpack_y8_y8_from_y8i,                      { { { RS2_STREAM_INFRARED, 1 },  RS2_FORMAT_Y8  },
                                                                                                                                                      { { RS2_STREAM_INFRARED, 2 },  RS2_FORMAT_Y8 } } } } };
     const native_pixel_format pf_y12i                     = { 'Y12I', 1, 3, {  { true,                &unpack_y16_y16_from_y12i_10,                { { { RS2_STREAM_INFRARED, 1 },  RS2_FORMAT_Y16 },
                                                                                                                                                      { { RS2_STREAM_INFRARED, 2 },  RS2_FORMAT_Y16 } } } } };
-    const native_pixel_format pf_z16                      = { 'Z16 ', 1, 2, {  { requires_processing, &copy_pixels<2>,                               { { RS2_STREAM_DEPTH,          RS2_FORMAT_Z16 } } },
+    const native_pixel_format pf_z16                      = { 'Z16 ', 1, 2, {  { true,                &copy_pixels<2>,                               { { RS2_STREAM_DEPTH,          RS2_FORMAT_Z16 } } },
+                                                                               { true,                &unpack_distance_from_z16,                     { { RS2_STREAM_DEPTH,          RS2_FORMAT_DISTANCE } } },
         // The Disparity_Z is not applicable for D4XX. TODO - merge with INVZ when confirmed
         /*{ false, &copy_pixels<2>,                                { { RS2_STREAM_DEPTH,    RS2_FORMAT_DISPARITY16 } } }*/ } };
     const native_pixel_format pf_invz                     = { 'Z16 ', 1, 2, {  { true,               &copy_pixels<2>,                               { { RS2_STREAM_DEPTH,          RS2_FORMAT_Z16 } } } } };
@@ -1009,7 +1856,9 @@ namespace librealsense
                                                                                { false,               &copy_pixels<2>,                               { { RS2_STREAM_INFRARED,       RS2_FORMAT_UYVY } } },
                                                                                { true,                &unpack_uyvy<RS2_FORMAT_RGBA8>,                { { RS2_STREAM_INFRARED,       RS2_FORMAT_RGBA8} } },
                                                                                { true,                &unpack_uyvy<RS2_FORMAT_BGR8 >,                { { RS2_STREAM_INFRARED,       RS2_FORMAT_BGR8 } } },
-                                                                               { true,                &unpack_uyvy<RS2_FORMAT_BGRA8>,                { { RS2_STREAM_INFRARED,       RS2_FORMAT_BGRA8} } } } };
+                                                                               { true,                &unpack_uyvy<RS2_FORMAT_BGRA8>,                { { RS2_STREAM_INFRARED,       RS2_FORMAT_BGRA8} } },
+                                                                               { true,                &unpack_planar<RS2_FORMAT_NV12, true>,         { { RS2_STREAM_INFRARED,       RS2_FORMAT_NV12 } } },
+                                                                               { true,                &unpack_planar<RS2_FORMAT_I420, true>,         { { RS2_STREAM_INFRARED,       RS2_FORMAT_I420 } } } } };
 
     const native_pixel_format pf_rgb888                   = { 'RGB2', 1, 2, {  { true,                &unpack_rgb_from_bgr,                          { { RS2_STREAM_INFRARED,       RS2_FORMAT_RGB8 } } } } };
 
@@ -1019,7 +1868,26 @@ namespace librealsense
                                                                                { false,               &copy_pixels<2>,                               { { RS2_STREAM_COLOR,          RS2_FORMAT_YUYV } } },
                                                                                { true,                &unpack_yuy2<RS2_FORMAT_RGBA8>,                { { RS2_STREAM_COLOR,          RS2_FORMAT_RGBA8 } } },
                                                                                { true,                &unpack_yuy2<RS2_FORMAT_BGR8 >,                { { RS2_STREAM_COLOR,          RS2_FORMAT_BGR8 } } },
-                                                                               { true,                &unpack_yuy2<RS2_FORMAT_BGRA8>,                { { RS2_STREAM_COLOR,          RS2_FORMAT_BGRA8 } } } } };
+                                                                               { true,                &unpack_yuy2<RS2_FORMAT_BGRA8>,                { { RS2_STREAM_COLOR,          RS2_FORMAT_BGRA8 } } },
+                                                                               { true,                &unpack_planar<RS2_FORMAT_NV12, false>,        { { RS2_STREAM_COLOR,          RS2_FORMAT_NV12 } } },
+                                                                               { true,                &unpack_planar<RS2_FORMAT_I420, false>,        { { RS2_STREAM_COLOR,          RS2_FORMAT_I420 } } } } };
+    const native_pixel_format pf_yuyv_downscaled          = { 'YUYV', 1, 2, {  { true,                &unpack_yuy2<RS2_FORMAT_RGB8 >,                { { RS2_STREAM_COLOR,          RS2_FORMAT_RGB8 } } },
+                                                                               { true,                &unpack_yuy2<RS2_FORMAT_Y16>,                  { { RS2_STREAM_COLOR,          RS2_FORMAT_Y16 } } },
+                                                                               { false,               &copy_pixels<2>,                               { { RS2_STREAM_COLOR,          RS2_FORMAT_YUYV } } },
+                                                                               { true,                &unpack_yuy2<RS2_FORMAT_RGBA8>,                { { RS2_STREAM_COLOR,          RS2_FORMAT_RGBA8 } } },
+                                                                               { true,                &unpack_yuy2<RS2_FORMAT_BGR8 >,                { { RS2_STREAM_COLOR,          RS2_FORMAT_BGR8 } } },
+                                                                               { true,                &unpack_yuy2<RS2_FORMAT_BGRA8>,                { { RS2_STREAM_COLOR,          RS2_FORMAT_BGRA8 } } },
+                                                                               { true,                &unpack_planar<RS2_FORMAT_NV12, false>,        { { RS2_STREAM_COLOR,          RS2_FORMAT_NV12 } } },
+                                                                               { true,                &unpack_planar<RS2_FORMAT_I420, false>,        { { RS2_STREAM_COLOR,          RS2_FORMAT_I420 } } },
+                                                                               // Converted and scaled down in a single pass
+                                                                               { true,                &unpack_yuy2_downscale<RS2_FORMAT_RGB8, 2>,    { { RS2_STREAM_COLOR,          RS2_FORMAT_RGB8,  downscale_resolution<2> } } },
+                                                                               { true,                &unpack_yuy2_downscale<RS2_FORMAT_RGBA8, 2>,   { { RS2_STREAM_COLOR,          RS2_FORMAT_RGBA8, downscale_resolution<2> } } },
+                                                                               { true,                &unpack_yuy2_downscale<RS2_FORMAT_BGR8, 2>,    { { RS2_STREAM_COLOR,          RS2_FORMAT_BGR8,  downscale_resolution<2> } } },
+                                                                               { true,                &unpack_yuy2_downscale<RS2_FORMAT_BGRA8, 2>,   { { RS2_STREAM_COLOR,          RS2_FORMAT_BGRA8, downscale_resolution<2> } } },
+                                                                               { true,                &unpack_yuy2_downscale<RS2_FORMAT_RGB8, 4>,    { { RS2_STREAM_COLOR,          RS2_FORMAT_RGB8,  downscale_resolution<4> } } },
+                                                                               { true,                &unpack_yuy2_downscale<RS2_FORMAT_RGBA8, 4>,   { { RS2_STREAM_COLOR,          RS2_FORMAT_RGBA8, downscale_resolution<4> } } },
+                                                                               { true,                &unpack_yuy2_downscale<RS2_FORMAT_BGR8, 4>,    { { RS2_STREAM_COLOR,          RS2_FORMAT_BGR8,  downscale_resolution<4> } } },
+                                                                               { true,                &unpack_yuy2_downscale<RS2_FORMAT_BGRA8, 4>,   { { RS2_STREAM_COLOR,          RS2_FORMAT_BGRA8, downscale_resolution<4> } } } } };
 
     const native_pixel_format pf_accel_axes               = { 'ACCL', 1, 1, {  { true,                &unpack_accel_axes<RS2_FORMAT_MOTION_XYZ32F>,  { { RS2_STREAM_ACCEL,          RS2_FORMAT_MOTION_XYZ32F } } },
                                                                                { false,               &unpack_hid_raw_data,                          { { RS2_STREAM_ACCEL,          RS2_FORMAT_MOTION_RAW  } } }} };
@@ -27,6 +27,41 @@ namespace librealsense
     std::vector<int> compute_rectification_table    (const rs2_intrinsics & rect_intrin, const rs2_extrinsics & rect_to_unrect, const rs2_intrinsics & unrect_intrin);
     void             rectify_image                  (uint8_t * rect_pixels, const std::vector<int> & rectification_table, const uint8_t * unrect_pixels, rs2_format format);
 
+    // Z16 into float meters of the given depth units, the pixels without depth staying 0. Vectorized with SSE
+    void             depth_to_distance              (const uint16_t * depth, float * distance, size_t count, float depth_units);
+
+    // Converts an image into another format, with the rows of either at any stride, in a single pass through the unpackers.
+    // False when there is no conversion between the formats
+    bool             copy_image                     (byte * dest, int dest_stride, rs2_format dest_format, const byte * source, int source_stride,
+                                                     rs2_format source_format, int width, int height);
+
+    // Unpacks rows of width pixels lying source_stride bytes apart, such as those of a cropped region, into contiguous rows of the
+    // outputs. Rows the vectorized kernels cannot consume whole are converted one at a time through zero-padded scratch rows
+    void             unpack_cropped_rows            (const pixel_format_unpacker& unpacker, byte * const dest[], const byte * source,
+                                                     int source_stride, int bytes_per_pixel, int width, int rows);
+
+    // True for unpackers that merely copy the native pixels, so that the frame may wrap the backend buffer instead
+    bool             is_pass_through                (const pixel_format_unpacker& unpacker);
+    // True for unpackers converting every row independently, so that bands of rows may be unpacked in parallel
+    bool             is_row_separable               (const pixel_format_unpacker& unpacker);
+    // True for unpackers running on the GPU, whose frames may stay in device memory. Always false without CUDA
+    bool             unpacks_on_device              (const pixel_format_unpacker& unpacker);
+#ifdef RS2_USE_CUDA
+    // Unpack the native pixels of a single output unpacker running on the GPU straight into device memory
+    void             unpack_to_device               (const pixel_format_unpacker& unpacker, byte * device_dest, const byte * source, int width, int height);
+#endif
+
+    // Instruction sets the unpackers have implementations for, in increasing order of preference
+    enum class simd_level { generic, ssse3, avx2, neon, count };
+    // Best level supported by the running CPU
+    simd_level       detect_simd_level              ();
+    // Level the unpackers dispatch on: detect_simd_level(), optionally lowered through the LRS_SIMD_LEVEL environment variable
+    simd_level       get_simd_level                 ();
+    // Lowers the level of get_simd_level() at run time, for the tests to compare the variants against the generic code.
+    // Never raises it beyond the selected level, and simd_level::count lifts the limit
+    void             set_simd_level                 (simd_level level);
+    const char *     get_string                     (simd_level level);
+
     extern const native_pixel_format pf_fe_raw8_unpatched_kernel; // W/O for unpatched kernel
     extern const native_pixel_format pf_raw8;       // 8 bit luminance
     extern const native_pixel_format pf_rw10;       // Four 10 bit luminance values in one 40 bit macropixel
@@ -35,6 +70,8 @@ namespace librealsense
     extern const native_pixel_format pf_bayer16;    // 16-bit Bayer raw
     extern const native_pixel_format pf_yuy2;       // Y0 U Y1 V ordered chroma subsampled macropixel
     extern const native_pixel_format pf_yuyv;       // Y0 U Y1 V ordered chroma subsampled macropixel
+    extern const native_pixel_format pf_yuy2_downscaled; // pf_yuy2 with RGB outputs at a half and a quarter of its resolution
+    extern const native_pixel_format pf_yuyv_downscaled; // pf_yuyv with RGB outputs at a half and a quarter of its resolution
     extern const native_pixel_format pf_y8;         // 8 bit IR/Luminosity (left) imager
     extern const native_pixel_format pf_y8i;        // 8 bits left IR + 8 bits right IR per pixel
     extern const native_pixel_format pf_y16;        // 16 bit (left) IR image
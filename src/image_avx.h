@@ -5,18 +5,29 @@
 #ifndef LIBREALSENSE_IMAGE_AVX_H
 #define LIBREALSENSE_IMAGE_AVX_H
 
-#include "types.h"
+// Compiled with -mavx2, this header and its file only include the C headers of the API and the intrinsics. Any inline
+// function of a shared C++ header would be compiled with AVX instructions too, and may be the copy the linker keeps for
+// the whole library, which would then fault on the CPUs without AVX whatever the dispatch chooses
+#include <stdint.h>
 
 namespace librealsense
 {
 #ifndef ANDROID
-    #if defined(__SSSE3__) && defined(__AVX2__)
-    void unpack_yuy2_avx_y8(byte * const d[], const byte * s, int n);
-    void unpack_yuy2_avx_y16(byte * const d[], const byte * s, int n);
-    void unpack_yuy2_avx_rgb8(byte * const d[], const byte * s, int n);
-    void unpack_yuy2_avx_rgba8(byte * const d[], const byte * s, int n);
-    void unpack_yuy2_avx_bgr8(byte * const d[], const byte * s, int n);
-    void unpack_yuy2_avx_bgra8(byte * const d[], const byte * s, int n);
+    #if defined(__SSSE3__) && (defined(__AVX2__) || defined(RS2_USE_AVX2_UNPACKERS))
+    // Unpack n pixels, a multiple of 32, on the calling thread. The caller splits the image across threads
+    void unpack_yuy2_avx_y8(uint8_t * const d[], const uint8_t * s, int n);
+    void unpack_yuy2_avx_y16(uint8_t * const d[], const uint8_t * s, int n);
+    void unpack_yuy2_avx_rgb8(uint8_t * const d[], const uint8_t * s, int n);
+    void unpack_yuy2_avx_rgba8(uint8_t * const d[], const uint8_t * s, int n);
+    void unpack_yuy2_avx_bgr8(uint8_t * const d[], const uint8_t * s, int n);
+    void unpack_yuy2_avx_bgra8(uint8_t * const d[], const uint8_t * s, int n);
+
+    // Returns the number of pixels unpacked, a multiple of 16. The remaining ones are left to the caller
+    int unpack_y16_y16_from_y12i_10_avx(uint8_t * const d[], const uint8_t * s, int n);
+    int unpack_z16_y8_from_f200_inzi_avx(uint8_t * const d[], const uint8_t * s, int n);
+    int unpack_z16_y16_from_f200_inzi_avx(uint8_t * const d[], const uint8_t * s, int n);
+    int unpack_y8_from_y16_10_avx(uint8_t * const d[], const uint8_t * s, int n);     // Returns a multiple of 32
+    int unpack_y16_from_y16_10_avx(uint8_t * const d[], const uint8_t * s, int n);
     #endif
 #endif
 }
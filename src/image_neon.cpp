@@ -0,0 +1,312 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2015 Intel Corporation. All Rights Reserved.
+
+#include "image_neon.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+
+namespace librealsense
+{
+    // Saturating narrow of (x + 128) >> 8 to [0, 255], matching the rounding of the generic code
+    static inline uint8x8_t narrow_to_u8(int32x4_t lo, int32x4_t hi)
+    {
+        return vqmovun_s16(vcombine_s16(vqrshrn_n_s32(lo, 8), vqrshrn_n_s32(hi, 8)));
+    }
+
+    // Converts 8 pixels using the same fixed-point BT.601 coefficients as the generic code, with 32-bit accumulation
+    static inline void yuv_to_rgb(uint8x8_t y, uint8x8_t u, uint8x8_t v, uint8x8_t& r, uint8x8_t& g, uint8x8_t& b)
+    {
+        int16x8_t c = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(y)), vdupq_n_s16(16));
+        int16x8_t d = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(u)), vdupq_n_s16(128));
+        int16x8_t e = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(v)), vdupq_n_s16(128));
+
+        int32x4_t c_lo = vmull_n_s16(vget_low_s16(c), 298);
+        int32x4_t c_hi = vmull_n_s16(vget_high_s16(c), 298);
+
+        r = narrow_to_u8(vmlal_n_s16(c_lo, vget_low_s16(e), 409), vmlal_n_s16(c_hi, vget_high_s16(e), 409));
+        g = narrow_to_u8(vmlsl_n_s16(vmlsl_n_s16(c_lo, vget_low_s16(d), 100), vget_low_s16(e), 208),
+                         vmlsl_n_s16(vmlsl_n_s16(c_hi, vget_high_s16(d), 100), vget_high_s16(e), 208));
+        b = narrow_to_u8(vmlal_n_s16(c_lo, vget_low_s16(d), 516), vmlal_n_s16(c_hi, vget_high_s16(d), 516));
+    }
+
+    template<rs2_format FORMAT> void unpack_yuy2(byte * const d[], const byte * s, int n)
+    {
+        auto src = reinterpret_cast<const uint8_t *>(s);
+        auto dst = reinterpret_cast<uint8_t *>(d[0]);
+
+        for (; n; n -= 16, src += 32)
+        {
+            // De-interleave 16 YUY2 pixels, into 16 Y components and 8 U/V pairs
+            uint8x16x2_t yuyv = vld2q_u8(src);
+
+            if (FORMAT == RS2_FORMAT_Y8)
+            {
+                vst1q_u8(dst, yuyv.val[0]);
+                dst += 16;
+                continue;
+            }
+
+            if (FORMAT == RS2_FORMAT_Y16)
+            {
+                // Y16 is little-endian.  We output Y << 8.
+                uint8x16x2_t y16 = { { vdupq_n_u8(0), yuyv.val[0] } };
+                vst2q_u8(dst, y16);
+                dst += 32;
+                continue;
+            }
+
+            // Separate the U and V components, and duplicate each for the two pixels sharing it
+            uint8x8x2_t uv = vuzp_u8(vget_low_u8(yuyv.val[1]), vget_high_u8(yuyv.val[1]));
+            uint8x8x2_t u = vzip_u8(uv.val[0], uv.val[0]);
+            uint8x8x2_t v = vzip_u8(uv.val[1], uv.val[1]);
+
+            uint8x8_t r0, g0, b0, r1, g1, b1;
+            yuv_to_rgb(vget_low_u8(yuyv.val[0]), u.val[0], v.val[0], r0, g0, b0);
+            yuv_to_rgb(vget_high_u8(yuyv.val[0]), u.val[1], v.val[1], r1, g1, b1);
+
+            uint8x16_t r = vcombine_u8(r0, r1);
+            uint8x16_t g = vcombine_u8(g0, g1);
+            uint8x16_t b = vcombine_u8(b0, b1);
+
+            if (FORMAT == RS2_FORMAT_RGB8)
+            {
+                uint8x16x3_t out = { { r, g, b } };
+                vst3q_u8(dst, out);
+                dst += 16 * 3;
+            }
+
+            if (FORMAT == RS2_FORMAT_BGR8)
+            {
+                uint8x16x3_t out = { { b, g, r } };
+                vst3q_u8(dst, out);
+                dst += 16 * 3;
+            }
+
+            if (FORMAT == RS2_FORMAT_RGBA8)
+            {
+                uint8x16x4_t out = { { r, g, b, vdupq_n_u8(255) } };
+                vst4q_u8(dst, out);
+                dst += 16 * 4;
+            }
+
+            if (FORMAT == RS2_FORMAT_BGRA8)
+            {
+                uint8x16x4_t out = { { b, g, r, vdupq_n_u8(255) } };
+                vst4q_u8(dst, out);
+                dst += 16 * 4;
+            }
+        }
+    }
+
+    void unpack_yuy2_neon_y8(byte * const d[], const byte * s, int n)
+    {
+        unpack_yuy2<RS2_FORMAT_Y8>(d, s, n);
+    }
+    void unpack_yuy2_neon_y16(byte * const d[], const byte * s, int n)
+    {
+        unpack_yuy2<RS2_FORMAT_Y16>(d, s, n);
+    }
+    void unpack_yuy2_neon_rgb8(byte * const d[], const byte * s, int n)
+    {
+        unpack_yuy2<RS2_FORMAT_RGB8>(d, s, n);
+    }
+    void unpack_yuy2_neon_rgba8(byte * const d[], const byte * s, int n)
+    {
+        unpack_yuy2<RS2_FORMAT_RGBA8>(d, s, n);
+    }
+    void unpack_yuy2_neon_bgr8(byte * const d[], const byte * s, int n)
+    {
+        unpack_yuy2<RS2_FORMAT_BGR8>(d, s, n);
+    }
+    void unpack_yuy2_neon_bgra8(byte * const d[], const byte * s, int n)
+    {
+        unpack_yuy2<RS2_FORMAT_BGRA8>(d, s, n);
+    }
+
+    int unpack_y8_y8_from_y8i_neon(byte * const d[], const byte * s, int n)
+    {
+        auto src = reinterpret_cast<const uint8_t *>(s);
+        auto left = reinterpret_cast<uint8_t *>(d[0]);
+        auto right = reinterpret_cast<uint8_t *>(d[1]);
+
+        int i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            uint8x16x2_t lr = vld2q_u8(src + i * 2);
+            vst1q_u8(left + i, lr.val[0]);
+            vst1q_u8(right + i, lr.val[1]);
+        }
+        return i;
+    }
+
+    int unpack_y16_y16_from_y12i_10_neon(byte * const d[], const byte * s, int n)
+    {
+        auto src = reinterpret_cast<const uint8_t *>(s);
+        auto left = reinterpret_cast<uint16_t *>(d[0]);
+        auto right = reinterpret_cast<uint16_t *>(d[1]);
+
+        int i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            // Every pixel is packed as [rl:8][rh:4 ll:4][lh:8]
+            uint8x8x3_t px = vld3_u8(src + i * 3);
+            uint16x8_t l = vorrq_u16(vshll_n_u8(px.val[2], 4), vmovl_u8(vshr_n_u8(px.val[1], 4)));
+            uint16x8_t r = vorrq_u16(vshll_n_u8(vand_u8(px.val[1], vdup_n_u8(0x0f)), 8), vmovl_u8(px.val[0]));
+
+            // Expand the 10 bits of data to the full 16-bit range
+            vst1q_u16(left + i, vorrq_u16(vshlq_n_u16(l, 6), vshrq_n_u16(l, 4)));
+            vst1q_u16(right + i, vorrq_u16(vshlq_n_u16(r, 6), vshrq_n_u16(r, 4)));
+        }
+        return i;
+    }
+
+    int unpack_z16_y8_from_f200_inzi_neon(byte * const d[], const byte * s, int n)
+    {
+        auto src = reinterpret_cast<const uint8_t *>(s);
+        auto depth = reinterpret_cast<uint8_t *>(d[0]);
+        auto ir = reinterpret_cast<uint8_t *>(d[1]);
+
+        int i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            // Every pixel is packed as [z:16][y:8]
+            uint8x16x3_t px = vld3q_u8(src + i * 3);
+            uint8x16x2_t z = { { px.val[0], px.val[1] } };
+            vst2q_u8(depth + i * 2, z);
+            vst1q_u8(ir + i, px.val[2]);
+        }
+        return i;
+    }
+
+    int unpack_z16_y16_from_f200_inzi_neon(byte * const d[], const byte * s, int n)
+    {
+        auto src = reinterpret_cast<const uint8_t *>(s);
+        auto depth = reinterpret_cast<uint8_t *>(d[0]);
+        auto ir = reinterpret_cast<uint8_t *>(d[1]);
+
+        int i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            uint8x16x3_t px = vld3q_u8(src + i * 3);
+            uint8x16x2_t z = { { px.val[0], px.val[1] } };
+            uint8x16x2_t y = { { px.val[2], px.val[2] } };
+            vst2q_u8(depth + i * 2, z);
+            vst2q_u8(ir + i * 2, y);
+        }
+        return i;
+    }
+
+    int unpack_y8_from_y16_10_neon(byte * const d[], const byte * s, int n)
+    {
+        auto src = reinterpret_cast<const uint16_t *>(s);
+        auto dst = reinterpret_cast<uint8_t *>(d[0]);
+
+        int i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            // Truncating like the generic code
+            uint8x8_t lo = vshrn_n_u16(vld1q_u16(src + i), 2);
+            uint8x8_t hi = vshrn_n_u16(vld1q_u16(src + i + 8), 2);
+            vst1q_u8(dst + i, vcombine_u8(lo, hi));
+        }
+        return i;
+    }
+
+    int unpack_y16_from_y16_10_neon(byte * const d[], const byte * s, int n)
+    {
+        auto src = reinterpret_cast<const uint16_t *>(s);
+        auto dst = reinterpret_cast<uint16_t *>(d[0]);
+
+        int i = 0;
+        for (; i + 8 <= n; i += 8)
+            vst1q_u16(dst + i, vshlq_n_u16(vld1q_u16(src + i), 6));
+        return i;
+    }
+
+    int unpack_rgb_from_bgr_neon(byte * const d[], const byte * s, int n)
+    {
+        auto src = reinterpret_cast<const uint8_t *>(s);
+        auto dst = reinterpret_cast<uint8_t *>(d[0]);
+
+        int i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            uint8x16x3_t bgr = vld3q_u8(src + i * 3);
+            uint8x16x3_t rgb = { { bgr.val[2], bgr.val[1], bgr.val[0] } };
+            vst3q_u8(dst + i * 3, rgb);
+        }
+        return i;
+    }
+
+    int unpack_rw10_from_rw8_neon(byte * const d[], const byte * s, int n)
+    {
+        auto src = reinterpret_cast<const uint16_t *>(s);
+        auto dst = reinterpret_cast<uint8_t *>(d[0]);
+
+        int i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            // Saturating like the SSSE3 code
+            uint8x8_t lo = vqshrn_n_u16(vld1q_u16(src + i), 2);
+            uint8x8_t hi = vqshrn_n_u16(vld1q_u16(src + i + 8), 2);
+            vst1q_u8(dst + i, vcombine_u8(lo, hi));
+        }
+        return i;
+    }
+
+    int unpack_planar_rows_neon(const byte * row0, const byte * row1, byte * y0, byte * y1, byte * u, byte * v, int width, bool uyvy, bool nv12)
+    {
+        // De-interleaving 16 macro-pixels yields Y0 U Y1 V for YUY2, and U Y0 V Y1 for UYVY
+        const int y_index = uyvy ? 1 : 0, u_index = uyvy ? 0 : 1, v_index = uyvy ? 2 : 3;
+
+        int x = 0;
+        for (; x + 32 <= width; x += 32)
+        {
+            uint8x16x4_t a = vld4q_u8(row0 + x * 2);
+            uint8x16x4_t b = vld4q_u8(row1 + x * 2);
+
+            uint8x16x2_t luma0 = { { a.val[y_index], a.val[y_index + 2] } };
+            uint8x16x2_t luma1 = { { b.val[y_index], b.val[y_index + 2] } };
+            vst2q_u8(y0 + x, luma0);
+            vst2q_u8(y1 + x, luma1);
+
+            // Rounding halving add, like the generic (a + b + 1) >> 1
+            uint8x16_t cu = vrhaddq_u8(a.val[u_index], b.val[u_index]);
+            uint8x16_t cv = vrhaddq_u8(a.val[v_index], b.val[v_index]);
+            if (nv12)
+            {
+                uint8x16x2_t uv = { { cu, cv } };
+                vst2q_u8(u + x, uv);
+            }
+            else
+            {
+                vst1q_u8(u + x / 2, cu);
+                vst1q_u8(v + x / 2, cv);
+            }
+        }
+        return x;
+    }
+
+    int unpack_y8_from_rw10_neon(byte * const d[], const byte * s, int n)
+    {
+        auto src = reinterpret_cast<const uint8_t *>(s);
+        auto dst = reinterpret_cast<uint8_t *>(d[0]);
+
+        // Picks the 8 MSB bytes of two macro-pixels :8888[2222]8888[2222] out of 16 loaded bytes
+        const uint8x8_t msb = { 0, 1, 2, 3, 5, 6, 7, 8 };
+
+        // Every iteration converts 4 macro-pixels (20 bytes), but the last load reaches 6 bytes further
+        int i = 0;
+        for (; i + 24 <= n; i += 16, src += 20)
+        {
+            uint8x16_t a = vld1q_u8(src);
+            uint8x16_t b = vld1q_u8(src + 10);
+            uint8x8x2_t ta = { { vget_low_u8(a), vget_high_u8(a) } };
+            uint8x8x2_t tb = { { vget_low_u8(b), vget_high_u8(b) } };
+            vst1q_u8(dst + i, vcombine_u8(vtbl2_u8(ta, msb), vtbl2_u8(tb, msb)));
+        }
+        return i;
+    }
+}
+#endif
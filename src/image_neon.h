@@ -0,0 +1,38 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2015 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#ifndef LIBREALSENSE_IMAGE_NEON_H
+#define LIBREALSENSE_IMAGE_NEON_H
+
+#include "types.h"
+
+namespace librealsense
+{
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    // YUY2 conversions of n pixels, n being a multiple of 16
+    void unpack_yuy2_neon_y8(byte * const d[], const byte * s, int n);
+    void unpack_yuy2_neon_y16(byte * const d[], const byte * s, int n);
+    void unpack_yuy2_neon_rgb8(byte * const d[], const byte * s, int n);
+    void unpack_yuy2_neon_rgba8(byte * const d[], const byte * s, int n);
+    void unpack_yuy2_neon_bgr8(byte * const d[], const byte * s, int n);
+    void unpack_yuy2_neon_bgra8(byte * const d[], const byte * s, int n);
+
+    // Conversions of up to n pixels, returning how many were converted. The remainder is left for the generic code
+    int unpack_y8_y8_from_y8i_neon(byte * const d[], const byte * s, int n);
+    int unpack_y16_y16_from_y12i_10_neon(byte * const d[], const byte * s, int n);
+    int unpack_rgb_from_bgr_neon(byte * const d[], const byte * s, int n);
+    int unpack_rw10_from_rw8_neon(byte * const d[], const byte * s, int n);
+    int unpack_y8_from_rw10_neon(byte * const d[], const byte * s, int n); // Returns a multiple of 4, the macro-pixel size
+    int unpack_z16_y8_from_f200_inzi_neon(byte * const d[], const byte * s, int n);
+    int unpack_z16_y16_from_f200_inzi_neon(byte * const d[], const byte * s, int n);
+    int unpack_y8_from_y16_10_neon(byte * const d[], const byte * s, int n);
+    int unpack_y16_from_y16_10_neon(byte * const d[], const byte * s, int n);
+
+    // Converts up to width pixels of two rows of YUY2 (or UYVY) into two luma rows and one row of averaged NV12 or I420 chroma,
+    // returning how many pixels were converted
+    int unpack_planar_rows_neon(const byte * row0, const byte * row1, byte * y0, byte * y1, byte * u, byte * v, int width, bool uyvy, bool nv12);
+#endif
+}
+
+#endif
@@ -333,17 +333,14 @@ namespace librealsense
             color_ep->register_pixel_format(pf_yuy2);
             color_ep->register_pixel_format(pf_yuyv);
 
-            color_ep->register_pu(RS2_OPTION_BACKLIGHT_COMPENSATION);
-            color_ep->register_pu(RS2_OPTION_BRIGHTNESS);
-            color_ep->register_pu(RS2_OPTION_CONTRAST);
-            color_ep->register_pu(RS2_OPTION_GAIN);
-            color_ep->register_pu(RS2_OPTION_GAMMA);
-            color_ep->register_pu(RS2_OPTION_HUE);
-            color_ep->register_pu(RS2_OPTION_SATURATION);
-            color_ep->register_pu(RS2_OPTION_SHARPNESS);
-
-            auto white_balance_option = std::make_shared<uvc_pu_option>(*color_ep, RS2_OPTION_WHITE_BALANCE);
-            auto auto_white_balance_option = std::make_shared<uvc_pu_option>(*color_ep, RS2_OPTION_ENABLE_AUTO_WHITE_BALANCE);
+            // The processing units are cached, only the host changing them but for the gain, which the auto exposure picks
+            for (auto id : { RS2_OPTION_BACKLIGHT_COMPENSATION, RS2_OPTION_BRIGHTNESS, RS2_OPTION_CONTRAST, RS2_OPTION_GAMMA,
+                             RS2_OPTION_HUE, RS2_OPTION_SATURATION, RS2_OPTION_SHARPNESS })
+                color_ep->register_option(id, std::make_shared<uvc_pu_option>(*color_ep, id, option_cache::policy::persistent));
+            color_ep->register_option(RS2_OPTION_GAIN, std::make_shared<uvc_pu_option>(*color_ep, RS2_OPTION_GAIN, option_cache::policy::transient));
+
+            auto white_balance_option = std::make_shared<uvc_pu_option>(*color_ep, RS2_OPTION_WHITE_BALANCE, option_cache::policy::transient);
+            auto auto_white_balance_option = std::make_shared<uvc_pu_option>(*color_ep, RS2_OPTION_ENABLE_AUTO_WHITE_BALANCE, option_cache::policy::persistent);
             color_ep->register_option(RS2_OPTION_WHITE_BALANCE, white_balance_option);
             color_ep->register_option(RS2_OPTION_ENABLE_AUTO_WHITE_BALANCE, auto_white_balance_option);
             color_ep->register_option(RS2_OPTION_WHITE_BALANCE,
@@ -351,8 +348,8 @@ namespace librealsense
                     white_balance_option,
                     auto_white_balance_option));
 
-            auto exposure_option = std::make_shared<uvc_pu_option>(*color_ep, RS2_OPTION_EXPOSURE);
-            auto auto_exposure_option = std::make_shared<uvc_pu_option>(*color_ep, RS2_OPTION_ENABLE_AUTO_EXPOSURE);
+            auto exposure_option = std::make_shared<uvc_pu_option>(*color_ep, RS2_OPTION_EXPOSURE, option_cache::policy::transient);
+            auto auto_exposure_option = std::make_shared<uvc_pu_option>(*color_ep, RS2_OPTION_ENABLE_AUTO_EXPOSURE, option_cache::policy::persistent);
             color_ep->register_option(RS2_OPTION_EXPOSURE, exposure_option);
             color_ep->register_option(RS2_OPTION_ENABLE_AUTO_EXPOSURE, auto_exposure_option);
             color_ep->register_option(RS2_OPTION_EXPOSURE,
@@ -422,9 +419,18 @@ namespace librealsense
             return _hw_monitor->send(input);
         }
 
+        std::vector<std::future<std::vector<uint8_t>>> send_receive_raw_data_async(const std::vector<std::vector<uint8_t>>& inputs) override
+        {
+            std::vector<std::future<std::vector<uint8_t>>> results;
+            for (auto&& input : inputs)
+                results.push_back(_hw_monitor->send_async(input));
+            return results;
+        }
+
         void hardware_reset() override
         {
             force_hardware_reset();
+            invalidate_controls();
         }
 
         uvc_sensor& get_depth_sensor() { return dynamic_cast<uvc_sensor&>(get_sensor(_depth_device_idx)); }
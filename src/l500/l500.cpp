@@ -144,32 +144,29 @@ namespace librealsense
 
         return std::make_shared<timestamp_composite_matcher>(matchers);
     }
-    rs2_time_t l500_timestamp_reader_from_metadata::get_frame_timestamp(const request_mapping& mode, const platform::frame_object& fo)
+    rs2_time_t l500_timestamp_reader_from_metadata::get_backup_timestamp(const request_mapping& mode, const platform::frame_object& fo)
     {
-        std::lock_guard<std::recursive_mutex> lock(_mtx);
+        if (!one_time_note.exchange(true))
+        {
+            LOG_WARNING("UVC metadata payloads are not available for stream "
+                << std::hex << mode.pf->fourcc << std::dec << (mode.profile.format)
+                << ". Please refer to installation chapter for details.");
+        }
+        return _backup_timestamp_reader->get_frame_timestamp(mode, fo);
+    }
 
+    rs2_time_t l500_timestamp_reader_from_metadata::get_frame_timestamp(const request_mapping& mode, const platform::frame_object& fo)
+    {
         if (has_metadata_ts(fo))
         {
             auto md = (librealsense::metadata_raw*)(fo.metadata);
-            return (double)(ts_wrap.calc(md->header.timestamp))*0.0001;
-        }
-        else
-        {
-            if (!one_time_note)
-            {
-                LOG_WARNING("UVC metadata payloads are not available for stream "
-                    << std::hex << mode.pf->fourcc << std::dec << (mode.profile.format)
-                    << ". Please refer to installation chapter for details.");
-                one_time_note = true;
-            }
-            return _backup_timestamp_reader->get_frame_timestamp(mode, fo);
+            return (double)(ts_wrap[l500_timestamp_reader::pin_of(mode)].calc(md->header.timestamp))*0.0001;
         }
+        return get_backup_timestamp(mode, fo);
     }
 
     unsigned long long l500_timestamp_reader_from_metadata::get_frame_counter(const request_mapping & mode, const platform::frame_object& fo) const
     {
-        std::lock_guard<std::recursive_mutex> lock(_mtx);
-
         if (has_metadata_fc(fo))
         {
             auto md = (librealsense::metadata_raw*)(fo.metadata);
@@ -181,16 +178,33 @@ namespace librealsense
 
     void l500_timestamp_reader_from_metadata::reset()
     {
-        std::lock_guard<std::recursive_mutex> lock(_mtx);
         one_time_note = false;
         _backup_timestamp_reader->reset();
-        ts_wrap.reset();
+        for (auto&& wrap : ts_wrap)
+            wrap.reset();
     }
 
     rs2_timestamp_domain l500_timestamp_reader_from_metadata::get_frame_timestamp_domain(const request_mapping & mode, const platform::frame_object& fo) const
     {
-        std::lock_guard<std::recursive_mutex> lock(_mtx);
-
         return (has_metadata_ts(fo)) ? RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK : _backup_timestamp_reader->get_frame_timestamp_domain(mode, fo);
     }
+
+    frame_timestamps l500_timestamp_reader_from_metadata::get_frame_timestamps(const request_mapping& mode, const platform::frame_object& fo)
+    {
+        // The header of the metadata holds the timestamp, and what follows it the counter
+        auto md = (librealsense::metadata_raw*)(fo.metadata);
+        frame_timestamps res;
+        if (has_metadata_ts(fo))
+        {
+            res.timestamp = (double)(ts_wrap[l500_timestamp_reader::pin_of(mode)].calc(md->header.timestamp))*0.0001;
+            res.domain = RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK;
+        }
+        else
+        {
+            res.timestamp = get_backup_timestamp(mode, fo);
+            res.domain = _backup_timestamp_reader->get_frame_timestamp_domain(mode, fo);
+        }
+        res.frame_counter = has_metadata_fc(fo) ? md->mode.sr300_rgb_mode.frame_counter : _backup_timestamp_reader->get_frame_counter(mode, fo);
+        return res;
+    }
 }
@@ -23,22 +23,30 @@ namespace librealsense
 
     class l500_device;
 
+    // The streams of the depth interface are of pins of their own, whose state the capture threads read and advance with no lock
     class l500_timestamp_reader : public frame_timestamp_reader
     {
         static const int pins = 3;
-        mutable std::vector<int64_t> counter;
+        mutable std::atomic<int64_t> counter[pins];
         std::shared_ptr<platform::time_service> _ts;
-        mutable std::recursive_mutex _mtx;
     public:
         l500_timestamp_reader(std::shared_ptr<platform::time_service> ts)
-            : counter(pins), _ts(ts)
+            : _ts(ts)
         {
             reset();
         }
 
+        static int pin_of(const request_mapping& mode)
+        {
+            if (mode.pf->fourcc == 0x5a313620) // Z16
+                return 1;
+            if (mode.pf->fourcc == 0x43202020) // Confidence
+                return 2;
+            return 0;
+        }
+
         void reset() override
         {
-            std::lock_guard<std::recursive_mutex> lock(_mtx);
             for (auto i = 0; i < pins; ++i)
             {
                 counter[i] = 0;
@@ -47,20 +55,12 @@ namespace librealsense
 
         rs2_time_t get_frame_timestamp(const request_mapping& mode, const platform::frame_object& fo) override
         {
-            std::lock_guard<std::recursive_mutex> lock(_mtx);
             return _ts->get_time();
         }
 
         unsigned long long get_frame_counter(const request_mapping & mode, const platform::frame_object& fo) const override
         {
-            std::lock_guard<std::recursive_mutex> lock(_mtx);
-            auto pin_index = 0;
-            if (mode.pf->fourcc == 0x5a313620) // Z16
-                pin_index = 1;
-            else if (mode.pf->fourcc == 0x43202020) // Confidence
-                pin_index = 2;
-
-            return ++counter[pin_index];
+            return ++counter[pin_of(mode)];
         }
 
         rs2_timestamp_domain get_frame_timestamp_domain(const request_mapping & mode, const platform::frame_object& fo) const override
@@ -71,31 +71,25 @@ namespace librealsense
 
     class l500_timestamp_reader_from_metadata : public frame_timestamp_reader
     {
+        static const int pins = 3;
         std::unique_ptr<l500_timestamp_reader> _backup_timestamp_reader;
-        bool one_time_note;
-        mutable std::recursive_mutex _mtx;
-        arithmetic_wraparound<uint32_t, uint64_t > ts_wrap;
+        std::atomic<bool> one_time_note;
+        atomic_wraparound ts_wrap[pins];  // Of every pin, whose timestamps its frames alone keep in order
+
+        // The host time of the frames without a timestamp in their metadata, noted the first time
+        rs2_time_t get_backup_timestamp(const request_mapping& mode, const platform::frame_object& fo);
 
     protected:
 
+        // Metadata support for a specific stream is immutable
         bool has_metadata_ts(const platform::frame_object& fo) const
         {
-            // Metadata support for a specific stream is immutable
-            const bool has_md_ts = [&] { std::lock_guard<std::recursive_mutex> lock(_mtx);
             return ((fo.metadata != nullptr) && (fo.metadata_size >= platform::uvc_header_size) && ((byte*)fo.metadata)[0] >= platform::uvc_header_size);
-            }();
-
-            return has_md_ts;
         }
 
         bool has_metadata_fc(const platform::frame_object& fo) const
         {
-            // Metadata support for a specific stream is immutable
-            const bool has_md_frame_counter = [&] { std::lock_guard<std::recursive_mutex> lock(_mtx);
             return ((fo.metadata != nullptr) && (fo.metadata_size > platform::uvc_header_size) && ((byte*)fo.metadata)[0] > platform::uvc_header_size);
-            }();
-
-            return has_md_frame_counter;
         }
 
     public:
@@ -112,6 +106,8 @@ namespace librealsense
         void reset() override;
 
         rs2_timestamp_domain get_frame_timestamp_domain(const request_mapping & mode, const platform::frame_object& fo) const override;
+
+        frame_timestamps get_frame_timestamps(const request_mapping& mode, const platform::frame_object& fo) override;
     };
 
     class l500_info : public device_info
@@ -275,6 +271,14 @@ namespace librealsense
             return _hw_monitor->send(input);
         }
 
+        std::vector<std::future<std::vector<uint8_t>>> send_receive_raw_data_async(const std::vector<std::vector<uint8_t>>& inputs) override
+        {
+            std::vector<std::future<std::vector<uint8_t>>> results;
+            for (auto&& input : inputs)
+                results.push_back(_hw_monitor->send_async(input));
+            return results;
+        }
+
         void hardware_reset() override
         {
             force_hardware_reset();
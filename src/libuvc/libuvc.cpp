@@ -152,16 +152,32 @@ namespace librealsense
                     int timeout_ms = 5000,
                     bool require_response = true) override
             {
-                libusb_device_handle* usb_handle = nullptr;
-                int status = libusb_open(_usb_device, &usb_handle);
+                // The interface is released and the handle closed on every way out, for the other processes to claim it
+                struct claimed_handle
+                {
+                    libusb_device_handle* handle = nullptr;
+                    int mi;
+                    bool claimed = false;
+                    ~claimed_handle()
+                    {
+                        if (claimed) libusb_release_interface(handle, mi);
+                        if (handle) libusb_close(handle);
+                    }
+                } usb{ nullptr, _mi };
+
+                int status = libusb_open(_usb_device, &usb.handle);
                 if(status < 0)
+                {
+                    usb.handle = nullptr;
                     throw linux_backend_exception(to_string() << "libusb_open(...) returned " << libusb_error_name(status));
-                status = libusb_claim_interface(usb_handle, _mi);
+                }
+                status = claim_when_free([&]() { return libusb_claim_interface(usb.handle, _mi); }, LIBUSB_ERROR_BUSY, timeout_ms);
                 if(status < 0)
                     throw linux_backend_exception(to_string() << "libusb_claim_interface(...) returned " << libusb_error_name(status));
+                usb.claimed = true;
 
                 int actual_length;
-                status = libusb_bulk_transfer(usb_handle, 1, const_cast<uint8_t*>(data.data()), data.size(), &actual_length, timeout_ms);
+                status = libusb_bulk_transfer(usb.handle, 1, const_cast<uint8_t*>(data.data()), data.size(), &actual_length, timeout_ms);
                 if(status < 0)
                     throw linux_backend_exception(to_string() << "libusb_bulk_transfer(...) returned " << libusb_error_name(status));
 
@@ -171,15 +187,13 @@ namespace librealsense
                 if (require_response)
                 {
                     result.resize(1024);
-                    status = libusb_bulk_transfer(usb_handle, 0x81, const_cast<uint8_t*>(result.data()), result.size(), &actual_length, timeout_ms);
+                    status = libusb_bulk_transfer(usb.handle, 0x81, const_cast<uint8_t*>(result.data()), result.size(), &actual_length, timeout_ms);
                     if(status < 0)
                         throw linux_backend_exception(to_string() << "libusb_bulk_transfer(...) returned " << libusb_error_name(status));
 
                     result.resize(actual_length);
                 }
 
-                libusb_close(usb_handle);
-
                 return result;
             }
 
@@ -320,6 +334,7 @@ namespace librealsense
                 }
 
                 // add to the vector of profiles.
+                _num_transfers.push_back(buffers);
                 _profiles.push_back(profile);
                 _callbacks.push_back(callback);
                 _stream_ctrls.push_back(ctrl);
@@ -329,6 +344,9 @@ namespace librealsense
             void stream_on(std::function<void(const notification& n)> error_handler) override
             {
                 uvc_error_t res;
+                std::lock_guard<std::mutex> lock(_stats_mutex);
+                _closed_stats = {};
+
                 // loop over each prfile and start streaming.
                 for (auto i=0; i < _profiles.size(); ++i) {
                     callback_context *context = new callback_context();
@@ -340,7 +358,9 @@ namespace librealsense
                                               &_stream_ctrls[i],
                                               internal_uvc_callback,
                                               context,
-                                              0);
+                                              0,
+                                              _num_transfers[i],
+                                              transfer_size());
 
                     if (res < 0) throw linux_backend_exception("fail to start streaming.");
                 }
@@ -364,11 +384,19 @@ namespace librealsense
                     _is_capturing = false;
                     _is_started = false;
                 }
-                uvc_stop_streaming(_device_handle);
+                {
+                    // The counters of the streams go with them
+                    std::lock_guard<std::mutex> lock(_stats_mutex);
+                    auto stats = streams_stats();
+                    _closed_stats.transfer_errors += stats.transfer_errors;
+                    _closed_stats.dropped_frames += stats.dropped_frames;
+                    uvc_stop_streaming(_device_handle);
+                }
                 _stream_ctrls.clear();
                 _profiles.clear();
                 _callbacks.clear();
-                
+                _num_transfers.clear();
+
             }
 
             void power_D0() {
@@ -673,6 +701,17 @@ namespace librealsense
 
             usb_spec get_usb_specification() const override { return _device_usb_spec; }
 
+            transport_stats get_transport_stats() const override
+            {
+                // The power thread closes the device handle under the power lock
+                std::lock_guard<std::mutex> power_lock(_power_mutex);
+                std::lock_guard<std::mutex> lock(_stats_mutex);
+                auto stats = streams_stats();
+                stats.transfer_errors += _closed_stats.transfer_errors;
+                stats.dropped_frames += _closed_stats.dropped_frames;
+                return stats;
+            }
+
             /* received a frame and call the callback. */
             void uvc_callback(uvc_frame_t *frame, frame_callback callback, stream_profile profile) {
                 frame_object fo{ frame->data_bytes,
@@ -709,8 +748,27 @@ namespace librealsense
           }
 
         private:
+            // Size of the USB transfers of every stream, set by LRS_LIBUVC_TRANSFER_SIZE in bytes and rounded down to whole
+            // maximal payloads of the stream. Zero makes each transfer one maximal payload
+            static size_t transfer_size()
+            {
+                static const size_t size = []()
+                {
+                    auto value = getenv("LRS_LIBUVC_TRANSFER_SIZE");
+                    return value ? static_cast<size_t>(strtoul(value, nullptr, 0)) : size_t(0);
+                }();
+                return size;
+            }
+
+            transport_stats streams_stats() const
+            {
+                transport_stats stats{};
+                if (_device_handle)
+                    uvc_get_streams_stats(_device_handle, &stats.transfer_errors, &stats.dropped_frames);
+                return stats;
+            }
 
-            std::mutex _power_mutex;
+            mutable std::mutex _power_mutex;
             std::thread _thread_handle;
             std::atomic<bool> _is_power_thread_alive;
             power_state _real_state = D3;
@@ -725,6 +783,9 @@ namespace librealsense
             std::vector<stream_profile> _profiles;
             std::vector<frame_callback> _callbacks;
             std::vector<uvc_stream_ctrl_t> _stream_ctrls;
+            std::vector<int> _num_transfers;
+            mutable std::mutex _stats_mutex;
+            transport_stats _closed_stats{};
             mutable std::unordered_map<uint32_t, uint32_t> _substitute_4cc;
             std::atomic<bool> _is_capturing;
             std::atomic<bool> _is_alive;
@@ -612,7 +612,9 @@ uvc_error_t uvc_start_streaming(
         uvc_stream_ctrl_t *ctrl,
         uvc_frame_callback_t *cb,
         void *user_ptr,
-        uint8_t flags);
+        uint8_t flags,
+        int num_transfers = 0,
+        size_t transfer_size = 0);
 
 uvc_error_t uvc_start_iso_streaming(
         uvc_device_handle_t *devh,
@@ -627,7 +629,9 @@ uvc_error_t uvc_stream_ctrl(uvc_stream_handle_t *strmh, uvc_stream_ctrl_t *ctrl)
 uvc_error_t uvc_stream_start(uvc_stream_handle_t *strmh,
                              uvc_frame_callback_t *cb,
                              void *user_ptr,
-                             uint8_t flags);
+                             uint8_t flags,
+                             int num_transfers = 0,
+                             size_t transfer_size = 0);
 uvc_error_t uvc_stream_start_iso(uvc_stream_handle_t *strmh,
                                  uvc_frame_callback_t *cb,
                                  void *user_ptr);
@@ -638,6 +642,9 @@ uvc_error_t uvc_stream_get_frame(
 );
 uvc_error_t uvc_stream_stop(uvc_stream_handle_t *strmh);
 void uvc_stream_close(uvc_stream_handle_t *strmh);
+void uvc_get_streams_stats(uvc_device_handle_t *devh,
+                           unsigned long long *transfer_errors,
+                           unsigned long long *dropped_frames);
 
 int uvc_get_ctrl_len(uvc_device_handle_t *devh, uint8_t unit, uint8_t ctrl);
 int uvc_get_ctrl(uvc_device_handle_t *devh, uint8_t unit, uint8_t ctrl, void *data, int len, enum uvc_req_code req_code);
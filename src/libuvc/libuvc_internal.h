@@ -236,14 +236,12 @@ typedef struct uvc_device_info {
 } uvc_device_info_t;
 
 /*
-  set a high number of transfer buffers. This uses a lot of ram, but
-  avoids problems with scheduling delays on slow boards causing missed
-  transfers. A better approach may be to make the transfer thread FIFO
-  scheduled (if we have root).
-  We could/should change this to allow reduce it to, say, 5 by default
-  and then allow the user to change the number of buffers as required.
+  Upper bound of the transfers a stream keeps in flight. Every stream chooses
+  its own number when it starts: more transfers use more ram, but avoid
+  missing payloads when the handler thread is delayed on slow boards.
  */
-#define LIBUVC_NUM_TRANSFER_BUFS 1
+#define LIBUVC_NUM_TRANSFER_BUFS 32
+#define LIBUVC_DEFAULT_TRANSFER_BUFS 4
 
 #define LIBUVC_XFER_BUF_SIZE	( 16 * 1024 * 1024 )
 
@@ -266,13 +264,21 @@ struct uvc_stream_handle {
     uint8_t *metadata_buf;
     size_t metadata_bytes,metadata_size;
     size_t got_bytes, hold_bytes;
+    /* the frame being assembled and the last complete one. With the data of the frame
+     * handed to the user they rotate, so that no buffer is copied into another */
     uint8_t *outbuf, *holdbuf;
+    /* set when the frame being assembled lost data, for it to be dropped at its end */
+    uint8_t outbuf_corrupt;
+    /* health of the stream, accumulated since it started */
+    std::atomic<unsigned long long> transfer_errors;
+    std::atomic<unsigned long long> dropped_frames;
     std::mutex cb_mutex;
     std::condition_variable cb_cond;
     std::thread cb_thread;
     uint32_t last_polled_seq;
     uvc_frame_callback_t *user_cb;
     void *user_ptr;
+    int num_transfers;
     struct libusb_transfer *transfers[LIBUVC_NUM_TRANSFER_BUFS];
     uint8_t *transfer_bufs[LIBUVC_NUM_TRANSFER_BUFS];
     std::condition_variable transfer_cancel[LIBUVC_NUM_TRANSFER_BUFS];
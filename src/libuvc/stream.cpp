@@ -38,7 +38,9 @@
 
 #include "libuvc.h"
 #include "libuvc_internal.h"
+#include "../thread-policy.h"
 #include "errno.h"
+#include <algorithm>
 #include <chrono>
 
 #ifdef _MSC_VER
@@ -699,19 +701,27 @@ uvc_error_t uvc_probe_stream_ctrl(
  */
 void _uvc_swap_buffers(uvc_stream_handle_t *strmh) {
   uint8_t *tmp_buf;
-  {
-      /* swap the buffers */
-      tmp_buf = strmh->holdbuf;
-      strmh->hold_bytes = strmh->got_bytes;
-      strmh->holdbuf = strmh->outbuf;
-      strmh->outbuf = tmp_buf;
-      strmh->hold_last_scr = strmh->last_scr;
-      strmh->hold_pts = strmh->pts;
-      strmh->hold_seq = strmh->seq;
+
+  if (strmh->outbuf_corrupt) {
+    /* drop the frame that lost data rather than present it incomplete */
+    strmh->dropped_frames++;
+    strmh->outbuf_corrupt = 0;
+  } else {
+    {
+        /* swap the buffers */
+        tmp_buf = strmh->holdbuf;
+        strmh->hold_bytes = strmh->got_bytes;
+        strmh->holdbuf = strmh->outbuf;
+        strmh->outbuf = tmp_buf;
+        strmh->hold_last_scr = strmh->last_scr;
+        strmh->hold_pts = strmh->pts;
+        strmh->hold_seq = strmh->seq;
+    }
+    strmh->cb_cond.notify_all();
+
+    strmh->seq++;
   }
-  strmh->cb_cond.notify_all();
 
-  strmh->seq++;
   strmh->got_bytes = 0;
   strmh->last_scr = 0;
   strmh->pts = 0;
@@ -786,6 +796,7 @@ void _uvc_process_payload(uvc_stream_handle_t *strmh, uint8_t *payload, size_t p
 
     if (header_info & 0x40) {
       UVC_DEBUG("bad packet: error bit set");
+      strmh->transfer_errors++;
       return;
     }
 
@@ -811,8 +822,13 @@ void _uvc_process_payload(uvc_stream_handle_t *strmh, uint8_t *payload, size_t p
   }
 
   if (data_len > 0) {
-    memcpy(strmh->outbuf + strmh->got_bytes, payload + header_len, data_len);
-    strmh->got_bytes += data_len;
+    if (strmh->got_bytes + data_len > LIBUVC_XFER_BUF_SIZE) {
+      UVC_DEBUG("frame overflow: %zd bytes", strmh->got_bytes + data_len);
+      strmh->outbuf_corrupt = 1;
+    } else {
+      memcpy(strmh->outbuf + strmh->got_bytes, payload + header_len, data_len);
+      strmh->got_bytes += data_len;
+    }
 
     if (header_info & (1 << 1)) {
       /* The EOF bit is set, so publish the complete frame */
@@ -841,8 +857,15 @@ void LIBUSB_CALL _uvc_stream_callback(struct libusb_transfer *transfer) {
           if (strmh && !strmh->running)
               break;
           if (transfer->num_iso_packets == 0) {
-              /* This is a bulk mode transfer, so it just has one payload transfer */
-              _uvc_process_payload(strmh, transfer->buffer, transfer->actual_length);
+              /* This is a bulk mode transfer, of one payload or more. A payload shorter than the maximal one ends
+               * with a short packet, which completes the transfer, so all the payloads of a transfer but the last
+               * are of the maximal size */
+              size_t max_payload = strmh->cur_ctrl.dwMaxPayloadTransferSize;
+              size_t length = transfer->actual_length;
+              if (!max_payload)
+                  max_payload = length;
+              for (size_t offset = 0; offset < length; offset += max_payload)
+                  _uvc_process_payload(strmh, transfer->buffer + offset, std::min(max_payload, length - offset));
           }
           else
           {
@@ -858,6 +881,7 @@ void LIBUSB_CALL _uvc_stream_callback(struct libusb_transfer *transfer) {
                   if (pkt->status != 0) {
 
                       UVC_DEBUG("bad packet (isochronous transfer); status: %d", pkt->status);
+                      strmh->transfer_errors++;
                       continue;
                   }
                   
@@ -899,6 +923,10 @@ void LIBUSB_CALL _uvc_stream_callback(struct libusb_transfer *transfer) {
   case LIBUSB_TRANSFER_OVERFLOW:
   case LIBUSB_TRANSFER_ERROR:
     UVC_DEBUG("retrying transfer, status = %d", transfer->status);
+    strmh->transfer_errors++;
+    /* the payload of the transfer is lost, and with it the frame being assembled */
+    if (strmh->got_bytes != 0)
+      strmh->outbuf_corrupt = 1;
     break;
   }
   
@@ -938,13 +966,18 @@ void LIBUSB_CALL _uvc_stream_callback(struct libusb_transfer *transfer) {
  * @param cb   User callback function. See {uvc_frame_callback_t} for restrictions.
  * @param flags Stream setup flags, currently undefined. Set this to zero. The lower bit
  * is reserved for backward compatibility.
+ * @param num_transfers Transfers kept in flight, up to LIBUVC_NUM_TRANSFER_BUFS. Zero for the default
+ * @param transfer_size Size of every transfer, rounded down to a multiple of the maximal payload of the stream and at least one.
+ * Zero for the maximal payload
  */
 uvc_error_t uvc_start_streaming(
     uvc_device_handle_t *devh,
     uvc_stream_ctrl_t *ctrl,
     uvc_frame_callback_t *cb,
     void *user_ptr,
-    uint8_t flags
+    uint8_t flags,
+    int num_transfers,
+    size_t transfer_size
 ) {
   uvc_error_t ret;
   uvc_stream_handle_t *strmh;
@@ -953,7 +986,7 @@ uvc_error_t uvc_start_streaming(
   if (ret != UVC_SUCCESS)
     return ret;
 
-  ret = uvc_stream_start(strmh, cb, user_ptr, flags);
+  ret = uvc_stream_start(strmh, cb, user_ptr, flags, num_transfers, transfer_size);
   if (ret != UVC_SUCCESS) {
     uvc_stream_close(strmh);
     return ret;
@@ -1055,6 +1088,7 @@ uvc_error_t uvc_stream_open_ctrl(uvc_device_handle_t *devh, uvc_stream_handle_t
     /** @todo take only what we need */
     strmh->outbuf = (uint8_t *)malloc( LIBUVC_XFER_BUF_SIZE );
     strmh->holdbuf = (uint8_t *)malloc( LIBUVC_XFER_BUF_SIZE );
+    strmh->frame.data = malloc( LIBUVC_XFER_BUF_SIZE );
 
     strmh->metadata_buf = (uint8_t *)malloc( 2048 );
     strmh->metadata_size = 2048;
@@ -1080,12 +1114,17 @@ fail:
  * @param cb   User callback function. See {uvc_frame_callback_t} for restrictions.
  * @param flags Stream setup flags, currently undefined. Set this to zero. The lower bit
  * is reserved for backward compatibility.
+ * @param num_transfers Transfers kept in flight, up to LIBUVC_NUM_TRANSFER_BUFS. Zero for the default
+ * @param transfer_size Size of every transfer, rounded down to a multiple of the maximal payload of the stream and at least one.
+ * Zero for the maximal payload
  */
 uvc_error_t uvc_stream_start(
     uvc_stream_handle_t *strmh,
     uvc_frame_callback_t *cb,
     void *user_ptr,
-    uint8_t flags
+    uint8_t flags,
+    int num_transfers,
+    size_t transfer_size
 ) {
   /* USB interface we'll be using */
   const struct libusb_interface *interface;
@@ -1114,6 +1153,19 @@ uvc_error_t uvc_stream_start(
   strmh->fid = 0;
   strmh->pts = 0;
   strmh->last_scr = 0;
+  strmh->outbuf_corrupt = 0;
+  strmh->transfer_errors = 0;
+  strmh->dropped_frames = 0;
+
+  if (num_transfers <= 0)
+    num_transfers = LIBUVC_DEFAULT_TRANSFER_BUFS;
+  strmh->num_transfers = num_transfers < LIBUVC_NUM_TRANSFER_BUFS ? num_transfers : LIBUVC_NUM_TRANSFER_BUFS;
+
+  /* a bulk transfer holds whole payloads, so it is a multiple of the largest of them, and no shorter */
+  if (strmh->cur_ctrl.dwMaxPayloadTransferSize) {
+    size_t max_payload = strmh->cur_ctrl.dwMaxPayloadTransferSize;
+    transfer_size = transfer_size < max_payload ? max_payload : transfer_size - transfer_size % max_payload;
+  }
 
   frame_desc = uvc_find_frame_desc_stream(strmh, ctrl->bFormatIndex, ctrl->bFrameIndex);
   if (!frame_desc) {
@@ -1132,16 +1184,15 @@ uvc_error_t uvc_stream_start(
    * (UVC 1.5: 2.4.3. VideoStreaming Interface) */
   isochronous = interface->num_altsetting > 1;
 
-  for (transfer_id = 0; transfer_id < LIBUVC_NUM_TRANSFER_BUFS;
+  for (transfer_id = 0; transfer_id < strmh->num_transfers;
       ++transfer_id) {
     transfer = libusb_alloc_transfer(0);
     strmh->transfers[transfer_id] = transfer;
-    strmh->transfer_bufs[transfer_id] = (uint8_t *)malloc (
-        strmh->cur_ctrl.dwMaxPayloadTransferSize );
+    strmh->transfer_bufs[transfer_id] = (uint8_t *)malloc ( transfer_size );
     libusb_fill_bulk_transfer ( transfer, strmh->devh->usb_devh,
         format_desc->parent->bEndpointAddress,
         strmh->transfer_bufs[transfer_id],
-        strmh->cur_ctrl.dwMaxPayloadTransferSize, _uvc_stream_callback,
+        (int)transfer_size, _uvc_stream_callback,
         ( void* ) strmh, 5000 );
   }
 
@@ -1152,10 +1203,14 @@ uvc_error_t uvc_stream_start(
    * with the contents of each frame.
    */
   if (cb) {
-      strmh->cb_thread = std::thread([&]() {_uvc_user_caller((void*)strmh); });
+      strmh->cb_thread = std::thread([strmh]()
+      {
+          librealsense::apply_thread_policy(RS2_THREAD_ROLE_CAPTURE);
+          _uvc_user_caller((void*)strmh);
+      });
   }
 
-  for (transfer_id = 0; transfer_id < LIBUVC_NUM_TRANSFER_BUFS;
+  for (transfer_id = 0; transfer_id < strmh->num_transfers;
       transfer_id++) {
     ret = libusb_submit_transfer(strmh->transfers[transfer_id]);
     if (ret != UVC_SUCCESS) {
@@ -1214,6 +1269,10 @@ void *_uvc_user_caller(void *arg) {
               break;
           }
 
+          /* frames replaced in the hold buffer before this thread could take them */
+          if (last_seq && strmh->hold_seq > last_seq + 1)
+              strmh->dropped_frames += strmh->hold_seq - last_seq - 1;
+
           last_seq = strmh->hold_seq;
           _uvc_populate_frame(strmh);
       }
@@ -1262,12 +1321,12 @@ void _uvc_populate_frame(uvc_stream_handle_t *strmh) {
   /** @todo set the frame time */
   // frame->capture_time
 
-  /* copy the image data from the hold buffer to the frame (unnecessary extra buf?) */
-  if (frame->data_bytes < strmh->hold_bytes) {
-    frame->data = realloc(frame->data, strmh->hold_bytes);
-  }
+  /* hand the hold buffer over to the frame, whose previous buffer takes its place. The transfers
+   * only ever assemble into the out buffer, so the frame is not touched until it is populated again */
+  uint8_t *tmp_buf = (uint8_t *)frame->data;
+  frame->data = strmh->holdbuf;
+  strmh->holdbuf = tmp_buf;
   frame->data_bytes = strmh->hold_bytes;
-  memcpy(frame->data, strmh->holdbuf, frame->data_bytes);
 
     /* copy the header data from the buffer to the frame */
 
@@ -1444,6 +1503,28 @@ uvc_error_t uvc_stream_stop(uvc_stream_handle_t *strmh) {
   return UVC_SUCCESS;
 }
 
+/** @brief Health of the streams of a device
+ * @ingroup streaming
+ *
+ * Sums the counters of the streams of the device, accumulated since each of them started
+ *
+ * @param devh UVC device
+ * @param[out] transfer_errors Transfers and payloads that failed
+ * @param[out] dropped_frames Frames dropped for lost data, or replaced before the user took them
+ */
+void uvc_get_streams_stats(uvc_device_handle_t *devh,
+                           unsigned long long *transfer_errors,
+                           unsigned long long *dropped_frames) {
+  uvc_stream_handle_t *strmh;
+
+  *transfer_errors = 0;
+  *dropped_frames = 0;
+  DL_FOREACH(devh->streams, strmh) {
+    *transfer_errors += strmh->transfer_errors;
+    *dropped_frames += strmh->dropped_frames;
+  }
+}
+
 /** @brief Close stream.
  * @ingroup streaming
  *
@@ -260,6 +260,7 @@ namespace librealsense
             _callback = sensor_callback;
             _is_capturing = true;
             _hid_thread = std::unique_ptr<std::thread>(new std::thread([this, read_device_path_str](){
+                apply_thread_policy(RS2_THREAD_ROLE_HID);
                 static const uint32_t buf_len = 128;
                 const uint32_t channel_size = 24; // TODO: why 24?
                 std::vector<uint8_t> raw_data(channel_size * buf_len);
@@ -439,8 +440,9 @@ namespace librealsense
             }
         }
 
-        iio_hid_sensor::iio_hid_sensor(const std::string& device_path, uint32_t frequency)
-            : _iio_device_path(device_path),
+        iio_hid_sensor::iio_hid_sensor(const std::string& device_path, uint32_t frequency, uint32_t batch)
+            : _buffer_length(buf_len),
+              _iio_device_path(device_path),
               _sensor_name(""),
               _callback(nullptr),
               _is_capturing(false),
@@ -448,7 +450,7 @@ namespace librealsense
               _fd(0),
               _stop_pipe_fd{}
         {
-            init(frequency);
+            init(frequency, batch);
         }
 
         iio_hid_sensor::~iio_hid_sensor()
@@ -512,8 +514,9 @@ namespace librealsense
             _callback = sensor_callback;
             _is_capturing = true;
             _hid_thread = std::unique_ptr<std::thread>(new std::thread([this](){
+                apply_thread_policy(RS2_THREAD_ROLE_HID);
                 const uint32_t channel_size = get_channel_size();
-                auto raw_data_size = channel_size*buf_len;
+                auto raw_data_size = channel_size*_buffer_length;
 
                 std::vector<uint8_t> raw_data(raw_data_size);
                 auto metadata = has_metadata();
@@ -626,7 +629,7 @@ namespace librealsense
             create_channel_array();
 
             const uint32_t channel_size = get_channel_size();
-            auto raw_data_size = channel_size*buf_len;
+            auto raw_data_size = channel_size*_buffer_length;
 
             std::vector<uint8_t> raw_data(raw_data_size);
 
@@ -690,7 +693,7 @@ namespace librealsense
         }
 
         // initialize the device sensor. reading its name and all of its inputs.
-        void iio_hid_sensor::init(uint32_t frequency)
+        void iio_hid_sensor::init(uint32_t frequency, uint32_t batch)
         {
             std::ifstream iio_device_file(_iio_device_path + "/name");
 
@@ -732,7 +735,15 @@ namespace librealsense
                 input->enable(true);
 
             set_frequency(frequency);
-            write_integer_to_param("buffer/length", buf_len);
+
+            // The kernel buffer holds a few batches, for the samples to keep arriving while one is read.
+            // The watermark lets select() sleep until a whole batch is ready, instead of waking up for every sample
+            _buffer_length = std::max(buf_len, 4 * batch);
+            write_integer_to_param("buffer/length", _buffer_length);
+            if (std::ifstream(_iio_device_path + "/buffer/watermark").good())
+                write_integer_to_param("buffer/watermark", std::max<uint32_t>(batch, 1));
+            else if (batch > 1)
+                LOG_WARNING("The kernel does not support IIO buffer watermarks, " << _sensor_name << " samples are read as they arrive");
             write_integer_to_param("buffer/enable", 1);
         }
 
@@ -911,11 +922,13 @@ namespace librealsense
                     else
                     {
                         uint32_t frequency = 0;
+                        uint32_t batch = 0;
                         for (auto& profile : hid_profiles)
                         {
                             if (profile.sensor_name == device_info.id)
                             {
                                 frequency = profile.frequency;
+                                batch = profile.batch;
                                 break;
                             }
                         }
@@ -923,7 +936,7 @@ namespace librealsense
                         if (frequency == 0)
                             continue;
 
-                        auto device = std::unique_ptr<iio_hid_sensor>(new iio_hid_sensor(device_info.device_path, frequency));
+                        auto device = std::unique_ptr<iio_hid_sensor>(new iio_hid_sensor(device_info.device_path, frequency, batch));
                         _iio_hid_sensors.push_back(std::move(device));
                     }
                 }
@@ -115,7 +115,7 @@ namespace librealsense
         // declare device sensor with all of its inputs.
         class iio_hid_sensor {
         public:
-            iio_hid_sensor(const std::string& device_path, uint32_t frequency);
+            iio_hid_sensor(const std::string& device_path, uint32_t frequency, uint32_t batch = 0);
 
             ~iio_hid_sensor();
 
@@ -140,7 +140,7 @@ namespace librealsense
             void create_channel_array();
 
             // initialize the device sensor. reading its name and all of its inputs.
-            void init(uint32_t frequency);
+            void init(uint32_t frequency, uint32_t batch);
 
             // calculate the storage size of a scan
             uint32_t get_channel_size() const;
@@ -156,7 +156,8 @@ namespace librealsense
             // configure hid device via fd
             void write_integer_to_param(const std::string& param,int value);
 
-            static const uint32_t buf_len = 128; // TODO
+            static const uint32_t buf_len = 128; // Minimal length of the kernel buffer, in samples
+            uint32_t _buffer_length;
             int _stop_pipe_fd[2]; // write to _stop_pipe_fd[1] and read from _stop_pipe_fd[0]
             int _fd;
             int _iio_device_number;
@@ -34,6 +34,7 @@
 #include <sys/stat.h>
 #include <sys/mman.h>
 #include <sys/ioctl.h>
+#include <sys/epoll.h>
 #include <sys/sysmacros.h> // minor(...), major(...)
 #include <linux/usb/video.h>
 #include <linux/uvcvideo.h>
@@ -43,6 +44,8 @@
 #include <list>
 
 #include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
 #include <signal.h>
 #pragma GCC diagnostic ignored "-Woverflow"
 
@@ -107,25 +110,36 @@ namespace librealsense
         named_mutex::named_mutex(const std::string& device_path, unsigned timeout)
             : _device_path(device_path),
               _timeout(timeout), // TODO: try to lock with timeout
-              _fildes(-1)
+              _fildes(-1),
+              _count(0)
         {
         }
 
         void named_mutex::lock()
         {
             std::lock_guard<std::mutex> lock(_mutex);
-            acquire();
+            if (_count == 0)
+                acquire();
+            _count++;
         }
 
         void named_mutex::unlock()
         {
             std::lock_guard<std::mutex> lock(_mutex);
-            release();
+            if (_count == 0)
+                return;
+            if (--_count == 0)
+                release();
         }
 
         bool named_mutex::try_lock()
         {
             std::lock_guard<std::mutex> lock(_mutex);
+            if (_count > 0)
+            {
+                _count++;
+                return true;
+            }
             if (-1 == _fildes)
             {
                 _fildes = open(_device_path.c_str(), O_RDWR, 0); //TODO: check
@@ -137,6 +151,7 @@ namespace librealsense
             if (ret != 0)
                 return false;
 
+            _count++;
             return true;
         }
 
@@ -180,7 +195,7 @@ namespace librealsense
         }
 
         buffer::buffer(int fd, v4l2_buf_type type, bool use_memory_map, int index)
-            : _type(type), _use_memory_map(use_memory_map), _index(index)
+            : _type(type), _use_memory_map(use_memory_map), _index(index), _dmabuf{ -1, 0 }
         {
             v4l2_buffer buf = {};
             buf.type = _type;
@@ -201,6 +216,19 @@ namespace librealsense
                                                     fd, buf.m.offset));
                 if(_start == MAP_FAILED)
                     throw linux_backend_exception("mmap failed");
+
+                // The exported DMABUF shares the mapped memory, so the frames that hold this buffer keep both valid
+                if (V4L2_BUF_TYPE_VIDEO_CAPTURE == type)
+                {
+                    v4l2_exportbuffer expbuf = {};
+                    expbuf.type = _type;
+                    expbuf.index = index;
+                    expbuf.flags = O_CLOEXEC | O_RDONLY;
+                    if (xioctl(fd, VIDIOC_EXPBUF, &expbuf) < 0)
+                        LOG_DEBUG("xioctl(VIDIOC_EXPBUF) failed, buffer " << index << " is not exported, error: " << strerror(errno));
+                    else
+                        _dmabuf.fd = expbuf.fd;
+                }
             }
             else
             {
@@ -211,6 +239,28 @@ namespace librealsense
             }
         }
 
+        buffer::buffer(int fd, v4l2_buf_type type, const user_buffer& memory, int index)
+            : _type(type), _use_memory_map(false), _index(index), _owns_memory(false), _dmabuf{ -1, 0 }
+        {
+            v4l2_buffer buf = {};
+            buf.type = _type;
+            buf.memory = V4L2_MEMORY_USERPTR;
+            buf.index = index;
+            if(xioctl(fd, VIDIOC_QUERYBUF, &buf) < 0)
+                throw linux_backend_exception("xioctl(VIDIOC_QUERYBUF) failed");
+
+            auto md_extra = (V4L2_BUF_TYPE_VIDEO_CAPTURE==type) ? MAX_META_DATA_SIZE : 0;
+            _original_length = buf.length;
+            _length = _original_length + md_extra;
+
+            if (!memory.data || memory.size < _length)
+                throw invalid_value_exception(to_string() << "User buffer " << index << " of " << memory.size
+                    << " bytes is too small, the stream requires " << _length << " bytes");
+
+            _start = static_cast<uint8_t*>(memory.data);
+            memset(_start, 0, _length);
+        }
+
         void buffer::prepare_for_streaming(int fd)
         {
             v4l2_buffer buf = {};
@@ -229,12 +279,15 @@ namespace librealsense
 
         buffer::~buffer()
         {
+            if (_dmabuf.fd >= 0)
+                ::close(_dmabuf.fd);
+
             if (_use_memory_map)
             {
                if(munmap(_start, _length) < 0)
                    linux_backend_exception("munmap");
             }
-            else
+            else if (_owns_memory)
             {
                free(_start);
             }
@@ -476,16 +529,34 @@ namespace librealsense
             int timeout_ms,
             bool require_response)
         {
-            libusb_device_handle* usb_handle = nullptr;
-            int status = libusb_open(_usb_device, &usb_handle);
+            // The interface is released and the handle closed on every way out, for the other processes to claim it
+            struct claimed_handle
+            {
+                claimed_handle(libusb_device_handle* h, int m) : handle(h), mi(m), claimed(false) {}
+                ~claimed_handle()
+                {
+                    if (claimed) libusb_release_interface(handle, mi);
+                    if (handle) libusb_close(handle);
+                }
+
+                libusb_device_handle* handle;
+                int mi;
+                bool claimed;
+            } usb(nullptr, _mi);
+
+            int status = libusb_open(_usb_device, &usb.handle);
             if(status < 0)
+            {
+                usb.handle = nullptr;
                 throw linux_backend_exception(to_string() << "libusb_open(...) returned " << libusb_error_name(status));
-            status = libusb_claim_interface(usb_handle, _mi);
+            }
+            status = claim_when_free([&]() { return libusb_claim_interface(usb.handle, _mi); }, LIBUSB_ERROR_BUSY, timeout_ms);
             if(status < 0)
                 throw linux_backend_exception(to_string() << "libusb_claim_interface(...) returned " << libusb_error_name(status));
+            usb.claimed = true;
 
             int actual_length;
-            status = libusb_bulk_transfer(usb_handle, 1, const_cast<uint8_t*>(data.data()), data.size(), &actual_length, timeout_ms);
+            status = libusb_bulk_transfer(usb.handle, 1, const_cast<uint8_t*>(data.data()), data.size(), &actual_length, timeout_ms);
             if(status < 0)
                 throw linux_backend_exception(to_string() << "libusb_bulk_transfer(...) returned " << libusb_error_name(status));
 
@@ -495,15 +566,13 @@ namespace librealsense
             if (require_response)
             {
                 result.resize(1024);
-                status = libusb_bulk_transfer(usb_handle, 0x81, const_cast<uint8_t*>(result.data()), result.size(), &actual_length, timeout_ms);
+                status = libusb_bulk_transfer(usb.handle, 0x81, const_cast<uint8_t*>(result.data()), result.size(), &actual_length, timeout_ms);
                 if(status < 0)
                     throw linux_backend_exception(to_string() << "libusb_bulk_transfer(...) returned " << libusb_error_name(status));
 
                 result.resize(actual_length);
             }
 
-            libusb_close(usb_handle);
-
             return result;
         }
 
@@ -682,6 +751,176 @@ namespace librealsense
             }
         }
 
+        bool v4l_reactor::is_enabled()
+        {
+            static const bool enabled = []()
+            {
+                auto value = getenv("LRS_V4L_REACTOR");
+                return value && strcmp(value, "0") != 0;
+            }();
+            return enabled;
+        }
+
+        std::shared_ptr<v4l_reactor> v4l_reactor::get()
+        {
+            static std::mutex mutex;
+            static std::weak_ptr<v4l_reactor> instance;
+
+            std::lock_guard<std::mutex> lock(mutex);
+            auto reactor = instance.lock();
+            if (!reactor)
+            {
+                reactor = std::shared_ptr<v4l_reactor>(new v4l_reactor());
+                instance = reactor;
+            }
+            return reactor;
+        }
+
+        v4l_reactor::v4l_reactor()
+            : _epoll_fd(epoll_create1(EPOLL_CLOEXEC)), _wake_pipe_fd{ -1, -1 }, _is_alive(true)
+        {
+            if (_epoll_fd < 0)
+                throw linux_backend_exception("v4l_reactor: epoll_create1 failed");
+
+            if (pipe(_wake_pipe_fd) < 0)
+            {
+                ::close(_epoll_fd);
+                throw linux_backend_exception("v4l_reactor: cannot create pipe");
+            }
+
+            epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.fd = _wake_pipe_fd[0];
+            epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, _wake_pipe_fd[0], &event);
+
+            _thread = std::thread([this]()
+            {
+                apply_thread_policy(RS2_THREAD_ROLE_CAPTURE);
+                loop();
+            });
+        }
+
+        v4l_reactor::~v4l_reactor()
+        {
+            _is_alive = false;
+            char buff[1] = {};
+            if (write(_wake_pipe_fd[1], buff, 1) < 0)
+                LOG_ERROR("v4l_reactor: could not wake the reactor thread");
+            _thread.join();
+
+            ::close(_wake_pipe_fd[0]);
+            ::close(_wake_pipe_fd[1]);
+            ::close(_epoll_fd);
+        }
+
+        void v4l_reactor::add(v4l_uvc_device* dev, const std::vector<int>& fds)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            for (auto fd : fds)
+            {
+                epoll_event event{};
+                event.events = EPOLLIN;
+                event.data.fd = fd;
+                if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0)
+                    throw linux_backend_exception(to_string() << "v4l_reactor: epoll_ctl failed for fd " << fd);
+                _owners[fd] = dev;
+            }
+            _devices[dev] = { fds, std::chrono::steady_clock::now() };
+        }
+
+        void v4l_reactor::remove(v4l_uvc_device* dev)
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            auto it = _devices.find(dev);
+            if (it == _devices.end())
+                return;
+
+            for (auto fd : it->second.fds)
+            {
+                epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+                _owners.erase(fd);
+            }
+            _devices.erase(it);
+
+            if (std::this_thread::get_id() != _thread.get_id())
+                _dispatched_cv.wait(lock, [&]() { return _dispatching != dev; });
+        }
+
+        void v4l_reactor::loop()
+        {
+            // A device that signalled no frame for this long is notified, as the select() loop does
+            const auto frames_timeout = std::chrono::seconds(5);
+            const int max_events = 64;
+            epoll_event events[max_events];
+
+            while (_is_alive)
+            {
+                auto count = epoll_wait(_epoll_fd, events, max_events, 100);
+                if (count < 0)
+                {
+                    if (errno == EINTR) continue;
+                    LOG_ERROR("v4l_reactor: epoll_wait failed, errno " << errno);
+                    return;
+                }
+
+                // Gather the ready nodes of each device, for its video and metadata to be dequeued together
+                std::map<v4l_uvc_device*, std::pair<fd_set, int>> ready;
+                auto now = std::chrono::steady_clock::now();
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    for (int i = 0; i < count; i++)
+                    {
+                        auto fd = events[i].data.fd;
+                        if (fd == _wake_pipe_fd[0])
+                        {
+                            char buff[16];
+                            if (read(fd, buff, sizeof(buff)) < 0)
+                                LOG_DEBUG("v4l_reactor: could not drain the wake pipe");
+                            continue;
+                        }
+
+                        auto owner = _owners.find(fd);
+                        if (owner == _owners.end())
+                            continue;
+
+                        auto& entry = ready[owner->second];
+                        if (!entry.second) FD_ZERO(&entry.first);
+                        FD_SET(fd, &entry.first);
+                        entry.second++;
+                    }
+
+                    for (auto&& dev : _devices)
+                    {
+                        if (ready.count(dev.first))
+                            dev.second.last_ready = now;
+                        else if (now - dev.second.last_ready > frames_timeout)
+                        {
+                            dev.second.last_ready = now;
+                            FD_ZERO(&ready[dev.first].first);
+                        }
+                    }
+                }
+
+                for (auto&& entry : ready)
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(_mutex);
+                        if (!_devices.count(entry.first))
+                            continue;
+                        _dispatching = entry.first;
+                    }
+
+                    entry.first->on_ready(entry.second.first, entry.second.second);
+
+                    {
+                        std::lock_guard<std::mutex> lock(_mutex);
+                        _dispatching = nullptr;
+                    }
+                    _dispatched_cv.notify_all();
+                }
+            }
+        }
+
         v4l_uvc_device::v4l_uvc_device(const uvc_device_info& info, bool use_memory_map)
             : _name(""), _info(),
               _is_capturing(false),
@@ -712,6 +951,7 @@ namespace librealsense
         v4l_uvc_device::~v4l_uvc_device()
         {
             _is_capturing = false;
+            if (_reactor) _reactor->remove(this);
             if (_thread) _thread->join();
             _fds.clear();
         }
@@ -781,9 +1021,20 @@ namespace librealsense
                 if(xioctl(_fd, VIDIOC_S_PARM, &parm) < 0)
                     throw linux_backend_exception("xioctl(VIDIOC_S_PARM) failed");
 
+                if (!_user_buffers.empty())
+                    buffers = static_cast<int>(_user_buffers.size());
+
                 // Init memory mapped IO
-                negotiate_kernel_buffers(buffers);
-                allocate_io_buffers(buffers);
+                try
+                {
+                    negotiate_kernel_buffers(buffers);
+                    allocate_io_buffers(buffers);
+                }
+                catch (...)
+                {
+                    _user_buffers.clear();
+                    throw;
+                }
 
                 _profile =  profile;
                 _callback = callback;
@@ -794,6 +1045,19 @@ namespace librealsense
             }
         }
 
+        bool v4l_uvc_device::set_user_buffers(stream_profile, std::vector<user_buffer> buffers)
+        {
+            // The memory mapped buffers of DMABUF export are allocated by the driver
+            if (_use_memory_map || buffers.size() > MAX_V4L2_FRAME_BUFFERS)
+                return false;
+
+            if (_callback)
+                throw wrong_api_call_sequence_exception("Device already streaming!");
+
+            _user_buffers = std::move(buffers);
+            return true;
+        }
+
         void v4l_uvc_device::stream_on(std::function<void(const notification& n)> error_handler)
         {
             if(!_is_capturing)
@@ -807,7 +1071,24 @@ namespace librealsense
                 streamon();
 
                 _is_capturing = true;
-                _thread = std::unique_ptr<std::thread>(new std::thread([this](){ capture_loop(); }));
+                if (v4l_reactor::is_enabled())
+                {
+                    // The reactor has no use for the stop pipe, as removing the device is enough to stop its callbacks
+                    std::vector<int> fds;
+                    for (auto fd : _fds)
+                        if (fd != _stop_pipe_fd[0] && fd != _stop_pipe_fd[1]) fds.push_back(fd);
+
+                    _reactor = v4l_reactor::get();
+                    _reactor->add(this, fds);
+                }
+                else
+                {
+                    _thread = std::unique_ptr<std::thread>(new std::thread([this]()
+                    {
+                        apply_thread_policy(RS2_THREAD_ROLE_CAPTURE);
+                        capture_loop();
+                    }));
+                }
             }
         }
 
@@ -821,11 +1102,19 @@ namespace librealsense
             _is_capturing = false;
             _is_started = false;
 
-            // Stop nn-demand frames polling
-            signal_stop();
+            if (_reactor)
+            {
+                _reactor->remove(this);
+                _reactor.reset();
+            }
+            else
+            {
+                // Stop nn-demand frames polling
+                signal_stop();
 
-            _thread->join();
-            _thread.reset();
+                _thread->join();
+                _thread.reset();
+            }
 
             // Notify kernel
             streamoff();
@@ -856,6 +1145,7 @@ namespace librealsense
                 // Release IO
                 negotiate_kernel_buffers(0);
 
+                _user_buffers.clear();
                 _callback = nullptr;
             }
         }
@@ -914,107 +1204,127 @@ namespace librealsense
             }
             else
             {
-                if(val > 0)
+                handle_ready(fds, val);
+            }
+        }
+
+        void v4l_uvc_device::on_ready(fd_set& fds, int count)
+        {
+            try
+            {
+                handle_ready(fds, count);
+            }
+            catch (const std::exception& ex)
+            {
+                // As the capture thread would, stop polling the device
+                report_error(ex);
+                _reactor->remove(this);
+            }
+        }
+
+        void v4l_uvc_device::handle_ready(fd_set& fds, int val)
+        {
+            if(val > 0)
+            {
+                if(FD_ISSET(_stop_pipe_fd[0], &fds) || FD_ISSET(_stop_pipe_fd[1], &fds))
                 {
-                    if(FD_ISSET(_stop_pipe_fd[0], &fds) || FD_ISSET(_stop_pipe_fd[1], &fds))
+                    if(!_is_capturing)
                     {
-                        if(!_is_capturing)
-                        {
-                            LOG_INFO("Stream finished");
-                            return;
-                        }
-                        else
-                        {
-                            LOG_ERROR("Stop pipe was signalled during streaming");
-                            return;
-                        }
+                        LOG_INFO("Stream finished");
+                        return;
                     }
-                    else // Check and acquire data buffers from kernel
+                    else
                     {
-                        buffers_mgr buf_mgr(_use_memory_map);
-                        // Read metadata from a node
-                        acquire_metadata(buf_mgr,fds);
+                        LOG_ERROR("Stop pipe was signalled during streaming");
+                        return;
+                    }
+                }
+                else // Check and acquire data buffers from kernel
+                {
+                    buffers_mgr buf_mgr(_use_memory_map);
+                    // Read metadata from a node
+                    acquire_metadata(buf_mgr,fds);
 
-                        if(FD_ISSET(_fd, &fds))
+                    if(FD_ISSET(_fd, &fds))
+                    {
+                        FD_CLR(_fd,&fds);
+                        v4l2_buffer buf = {};
+                        buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+                        buf.memory = _use_memory_map ? V4L2_MEMORY_MMAP : V4L2_MEMORY_USERPTR;
+                        if(xioctl(_fd, VIDIOC_DQBUF, &buf) < 0)
                         {
-                            FD_CLR(_fd,&fds);
-                            v4l2_buffer buf = {};
-                            buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-                            buf.memory = _use_memory_map ? V4L2_MEMORY_MMAP : V4L2_MEMORY_USERPTR;
-                            if(xioctl(_fd, VIDIOC_DQBUF, &buf) < 0)
-                            {
-                                LOG_DEBUG("Dequeued empty buf for fd " << _fd);
-                                if(errno == EAGAIN)
-                                    return;
+                            LOG_DEBUG("Dequeued empty buf for fd " << _fd);
+                            if(errno == EAGAIN)
+                                return;
 
-                                throw linux_backend_exception(to_string() << "xioctl(VIDIOC_DQBUF) failed for fd: " << _fd);
-                            }
-                            LOG_DEBUG("Dequeued buf " << buf.index << " for fd " << _fd);
+                            throw linux_backend_exception(to_string() << "xioctl(VIDIOC_DQBUF) failed for fd: " << _fd);
+                        }
+                        LOG_DEBUG("Dequeued buf " << buf.index << " for fd " << _fd);
+                        auto dequeue_time = monotonic_time();
 
-                            auto buffer = _buffers[buf.index];
-                            buf_mgr.handle_buffer(e_video_buf,_fd, buf,buffer);
+                        auto buffer = _buffers[buf.index];
+                        buf_mgr.handle_buffer(e_video_buf,_fd, buf,buffer);
 
-                            if (_is_started)
+                        if (_is_started)
+                        {
+                            if((buf.bytesused < buffer->get_full_length() - MAX_META_DATA_SIZE) &&
+                                    buf.bytesused > 0)
                             {
-                                if((buf.bytesused < buffer->get_full_length() - MAX_META_DATA_SIZE) &&
-                                        buf.bytesused > 0)
+                                auto percentage = (100 * buf.bytesused) / buffer->get_full_length();
+                                std::stringstream s;
+                                s << "Incomplete video frame detected!\nSize " << buf.bytesused
+                                  << " out of " << buffer->get_full_length() << " bytes (" << percentage << "%)";
+                                librealsense::notification n = { RS2_NOTIFICATION_CATEGORY_FRAME_CORRUPTED, 0, RS2_LOG_SEVERITY_WARN, s.str()};
+
+                                _error_handler(n);
+                            }
+                            else
+                            {
+                                if (buf.bytesused > 0)
                                 {
-                                    auto percentage = (100 * buf.bytesused) / buffer->get_full_length();
-                                    std::stringstream s;
-                                    s << "Incomplete video frame detected!\nSize " << buf.bytesused
-                                      << " out of " << buffer->get_full_length() << " bytes (" << percentage << "%)";
-                                    librealsense::notification n = { RS2_NOTIFICATION_CATEGORY_FRAME_CORRUPTED, 0, RS2_LOG_SEVERITY_WARN, s.str()};
+                                    auto timestamp = (double)buf.timestamp.tv_sec*1000.f + (double)buf.timestamp.tv_usec/1000.f;
+                                    timestamp = monotonic_to_realtime(timestamp);
+
+                                    // read metadata from the frame appendix
+                                    acquire_metadata(buf_mgr,fds);
+
+                                    if (val > 1)
+                                        LOG_INFO("Frame buf ready, md size: " << std::dec << (int)buf_mgr.metadata_size() << " seq. id: " << buf.sequence);
+                                    frame_object fo{ buffer->get_length_frame_only(), buf_mgr.metadata_size(),
+                                        buffer->get_frame_start(), buf_mgr.metadata_start(), timestamp, buffer->get_dmabuf(), dequeue_time };
 
-                                    _error_handler(n);
+                                     buffer->attach_buffer(buf);
+                                     buf_mgr.handle_buffer(e_video_buf,-1); // transfer new buffer request to the frame callback
+
+                                     //Invoke user callback and enqueue next frame
+                                     _callback(_profile, fo,
+                                               [buf_mgr]() mutable {
+                                         buf_mgr.request_next_frame();
+                                     });
                                 }
                                 else
                                 {
-                                    if (buf.bytesused > 0)
-                                    {
-                                        auto timestamp = (double)buf.timestamp.tv_sec*1000.f + (double)buf.timestamp.tv_usec/1000.f;
-                                        timestamp = monotonic_to_realtime(timestamp);
-
-                                        // read metadata from the frame appendix
-                                        acquire_metadata(buf_mgr,fds);
-
-                                        if (val > 1)
-                                            LOG_INFO("Frame buf ready, md size: " << std::dec << (int)buf_mgr.metadata_size() << " seq. id: " << buf.sequence);
-                                        frame_object fo{ buffer->get_length_frame_only(), buf_mgr.metadata_size(),
-                                            buffer->get_frame_start(), buf_mgr.metadata_start(), timestamp };
-
-                                         buffer->attach_buffer(buf);
-                                         buf_mgr.handle_buffer(e_video_buf,-1); // transfer new buffer request to the frame callback
-
-                                         //Invoke user callback and enqueue next frame
-                                         _callback(_profile, fo,
-                                                   [buf_mgr]() mutable {
-                                             buf_mgr.request_next_frame();
-                                         });
-                                    }
-                                    else
-                                    {
-                                        LOG_INFO("Empty video frame arrived");
-                                    }
+                                    LOG_INFO("Empty video frame arrived");
                                 }
                             }
-                            else
-                            {
-                                LOG_ERROR("Video frame arrived in idle mode."); // TODO - verification
-                            }
                         }
                         else
                         {
-                            LOG_WARNING("FD_ISSET returned false - video node is not signalled (md only)");
+                            LOG_ERROR("Video frame arrived in idle mode."); // TODO - verification
                         }
                     }
+                    else
+                    {
+                        LOG_WARNING("FD_ISSET returned false - video node is not signalled (md only)");
+                    }
                 }
-                else // (val==0)
-                {
-                    LOG_WARNING("Frames didn't arrived within 5 seconds");
-                        librealsense::notification n = {RS2_NOTIFICATION_CATEGORY_FRAMES_TIMEOUT, 0, RS2_LOG_SEVERITY_WARN,  "Frames didn't arrived within 5 seconds"};
+            }
+            else // (val==0)
+            {
+                LOG_WARNING("Frames didn't arrived within 5 seconds");
+                    librealsense::notification n = {RS2_NOTIFICATION_CATEGORY_FRAMES_TIMEOUT, 0, RS2_LOG_SEVERITY_WARN,  "Frames didn't arrived within 5 seconds"};
 
-                        _error_handler(n);
-                }
+                    _error_handler(n);
             }
         }
 
@@ -1332,12 +1642,27 @@ namespace librealsense
             }
             catch (const std::exception& ex)
             {
-                LOG_ERROR(ex.what());
+                report_error(ex);
+            }
+        }
 
-                librealsense::notification n = {RS2_NOTIFICATION_CATEGORY_UNKNOWN_ERROR, 0, RS2_LOG_SEVERITY_ERROR, ex.what()};
+        void v4l_uvc_device::report_error(const std::exception& ex)
+        {
+            LOG_ERROR(ex.what());
 
-                _error_handler(n);
-            }
+            librealsense::notification n = {RS2_NOTIFICATION_CATEGORY_UNKNOWN_ERROR, 0, RS2_LOG_SEVERITY_ERROR, ex.what()};
+
+            _error_handler(n);
+        }
+
+        bool v4l_uvc_device::is_dmabuf_export_enabled()
+        {
+            static const bool enabled = []()
+            {
+                auto value = getenv("LRS_V4L_DMABUF");
+                return value && strcmp(value, "0") != 0;
+            }();
+            return enabled;
         }
 
         bool v4l_uvc_device::has_metadata() const
@@ -1368,7 +1693,10 @@ namespace librealsense
             {
                 for(size_t i = 0; i < buffers; ++i)
                 {
-                    _buffers.push_back(std::make_shared<buffer>(_fd, V4L2_BUF_TYPE_VIDEO_CAPTURE, _use_memory_map, i));
+                    if (i < _user_buffers.size())
+                        _buffers.push_back(std::make_shared<buffer>(_fd, V4L2_BUF_TYPE_VIDEO_CAPTURE, _user_buffers[i], i));
+                    else
+                        _buffers.push_back(std::make_shared<buffer>(_fd, V4L2_BUF_TYPE_VIDEO_CAPTURE, _use_memory_map, i));
                 }
             }
             else
@@ -1671,7 +1999,7 @@ namespace librealsense
         std::shared_ptr<uvc_device> v4l_backend::create_uvc_device(uvc_device_info info) const
         {
             auto v4l_uvc_dev = (!info.has_metadata_node) ? std::make_shared<v4l_uvc_device>(info) :
-                                                           std::make_shared<v4l_uvc_meta_device>(info);
+                                                           std::make_shared<v4l_uvc_meta_device>(info, v4l_uvc_device::is_dmabuf_export_enabled());
 
             return std::make_shared<platform::retry_controls_work_around>(v4l_uvc_dev);
         }
@@ -1729,9 +2057,230 @@ namespace librealsense
             return std::make_shared<os_time_service>();
         }
 
+        v4l_device_watcher::v4l_device_watcher(const backend* backend_ref)
+            : _backend(backend_ref), _socket(-1), _stop_pipe_fd{ -1, -1 }, _is_watching(false)
+        {
+            _socket = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_KOBJECT_UEVENT);
+            if (_socket < 0)
+                throw linux_backend_exception("v4l_device_watcher: cannot open the uevent socket");
+
+            // Keep the events of a hub full of devices plugged at once
+            int rcvbuf = 1 << 20;
+            setsockopt(_socket, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+            sockaddr_nl addr{};
+            addr.nl_family = AF_NETLINK;
+            addr.nl_groups = 1; // Kernel events
+            if (bind(_socket, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || pipe(_stop_pipe_fd) < 0)
+            {
+                ::close(_socket);
+                throw linux_backend_exception("v4l_device_watcher: cannot listen to uevents");
+            }
+        }
+
+        v4l_device_watcher::~v4l_device_watcher()
+        {
+            stop();
+            ::close(_socket);
+            ::close(_stop_pipe_fd[0]);
+            ::close(_stop_pipe_fd[1]);
+        }
+
+        void v4l_device_watcher::start(device_changed_callback callback)
+        {
+            start_from({ _backend->query_uvc_devices(),
+                         _backend->query_usb_devices(),
+                         _backend->query_hid_devices() }, std::move(callback));
+        }
+
+        bool v4l_device_watcher::start_from(const backend_device_group& devices, device_changed_callback callback)
+        {
+            stop();
+            _callback = std::move(callback);
+            _devices_data = devices;
+
+            _is_watching = true;
+            _thread = std::unique_ptr<std::thread>(new std::thread([this]()
+            {
+                apply_thread_policy(RS2_THREAD_ROLE_DEVICE_WATCHER);
+                watch();
+            }));
+            return true;
+        }
+
+        void v4l_device_watcher::stop()
+        {
+            if (!_thread)
+                return;
+
+            _is_watching = false;
+            char buff[1] = {};
+            if (write(_stop_pipe_fd[1], buff, 1) < 0)
+                LOG_ERROR("v4l_device_watcher: could not signal the watcher thread to stop");
+            _thread->join();
+            _thread.reset();
+
+            _callback_inflight.wait_until_empty();
+        }
+
+        void v4l_device_watcher::watch()
+        {
+            // A device adds or removes several nodes, whose events arrive within a few milliseconds of each other. A stream of
+            // events that never settles, of a device reconnecting over and over, still gets its rescan after the longest deferral
+            static const int settle_time_ms = 100;
+            static const int max_deferral_ms = 1000;
+            uint32_t pending = 0;
+            auto first_pending = std::chrono::steady_clock::now();
+
+            while (_is_watching)
+            {
+                auto settle_ms = settle_time_ms;
+                if (pending)
+                {
+                    auto deferred_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - first_pending).count();
+                    if (deferred_ms >= max_deferral_ms)
+                    {
+                        rescan(pending);
+                        pending = 0;
+                        continue;
+                    }
+                    settle_ms = static_cast<int>(std::min<long long>(settle_time_ms, max_deferral_ms - deferred_ms));
+                }
+
+                fd_set fds;
+                FD_ZERO(&fds);
+                FD_SET(_socket, &fds);
+                FD_SET(_stop_pipe_fd[0], &fds);
+
+                struct timeval tv = { 0, settle_ms * 1000 };
+                auto val = select(std::max(_socket, _stop_pipe_fd[0]) + 1, &fds, NULL, NULL, pending ? &tv : nullptr);
+                if (val < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+                    LOG_ERROR("v4l_device_watcher: select failed, errno " << errno << ". Devices are not watched anymore");
+                    return;
+                }
+
+                if (val == 0)
+                {
+                    rescan(pending);
+                    pending = 0;
+                    continue;
+                }
+
+                if (FD_ISSET(_stop_pipe_fd[0], &fds))
+                {
+                    char buff[1];
+                    if (read(_stop_pipe_fd[0], buff, 1) < 0)
+                        LOG_WARNING("v4l_device_watcher: could not read the stop signal");
+                    return;
+                }
+
+                if (FD_ISSET(_socket, &fds))
+                {
+                    auto kinds = read_events();
+                    if (kinds && !pending)
+                        first_pending = std::chrono::steady_clock::now();
+                    pending |= kinds;
+                }
+            }
+        }
+
+        // The kinds of devices the queued events are about. Every event is "action@devpath" followed by KEY=value strings
+        uint32_t v4l_device_watcher::read_events()
+        {
+            uint32_t kinds = 0;
+            char buffer[8192];
+            while (true)
+            {
+                sockaddr_nl sender{};
+                iovec iov{ buffer, sizeof(buffer) - 1 };
+                msghdr msg{};
+                msg.msg_name = &sender;
+                msg.msg_namelen = sizeof(sender);
+                msg.msg_iov = &iov;
+                msg.msg_iovlen = 1;
+
+                auto size = recvmsg(_socket, &msg, MSG_DONTWAIT);
+                if (size < 0)
+                {
+                    // Events were lost when the socket overflowed, anything may have changed
+                    if (errno == ENOBUFS)
+                        kinds |= all_devices;
+                    else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                        LOG_WARNING("v4l_device_watcher: recvmsg failed, errno " << errno);
+                    if (errno != EINTR)
+                        return kinds;
+                    continue;
+                }
+
+                // Only the kernel is trusted, not the user space processes multicasting on the same socket
+                if (sender.nl_pid != 0)
+                    continue;
+
+                buffer[size] = 0;
+                std::string subsystem, devpath;
+                for (auto field = buffer + strlen(buffer) + 1; field < buffer + size; field += strlen(field) + 1)
+                {
+                    if (!strncmp(field, "SUBSYSTEM=", 10))
+                        subsystem = field + 10;
+                    else if (!strncmp(field, "DEVPATH=", 8))
+                        devpath = field + 8;
+                }
+
+                if (subsystem == "video4linux")
+                    kinds |= uvc_devices;
+                else if (subsystem == "usb")
+                    kinds |= usb_devices;
+                else if (subsystem == "iio" || subsystem == "hid" ||
+                         (subsystem == "platform" && devpath.find("HID-SENSOR") != std::string::npos))
+                    kinds |= hid_devices;
+            }
+        }
+
+        void v4l_device_watcher::rescan(uint32_t kinds)
+        {
+            platform::backend_device_group curr = _devices_data;
+            try
+            {
+                if (kinds & uvc_devices)
+                    curr.uvc_devices = _backend->query_uvc_devices();
+                if (kinds & usb_devices)
+                    curr.usb_devices = _backend->query_usb_devices();
+                if (kinds & hid_devices)
+                    curr.hid_devices = _backend->query_hid_devices();
+            }
+            catch (const std::exception& ex)
+            {
+                LOG_WARNING("v4l_device_watcher: could not query the devices, " << ex.what());
+                return;
+            }
+
+            if (list_changed(_devices_data.uvc_devices, curr.uvc_devices) ||
+                list_changed(_devices_data.usb_devices, curr.usb_devices) ||
+                list_changed(_devices_data.hid_devices, curr.hid_devices))
+            {
+                callback_invocation_holder callback = { _callback_inflight.allocate(), &_callback_inflight };
+                if (callback)
+                {
+                    _callback(_devices_data, curr);
+                    _devices_data = curr;
+                }
+            }
+        }
+
         std::shared_ptr<device_watcher> v4l_backend::create_device_watcher() const
         {
-            return std::make_shared<polling_device_watcher>(this);
+            try
+            {
+                return std::make_shared<v4l_device_watcher>(this);
+            }
+            catch (const linux_backend_exception& ex)
+            {
+                LOG_WARNING(ex.what() << ", polling for devices instead");
+                return std::make_shared<polling_device_watcher>(this);
+            }
         }
 
         std::shared_ptr<backend> create_backend()
@@ -38,6 +38,11 @@
 #include <fts.h>
 #include <regex>
 #include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
 
 #pragma GCC diagnostic ignored "-Wpedantic"
 #ifdef USE_SYSTEM_LIBUSB
@@ -88,6 +93,8 @@ namespace librealsense
 {
     namespace platform
     {
+        // Exclusion of the processes that share the device, by a lock on its node. The threads of the process share it,
+        // nested locks counted, for the file lock, owned by the process, to be released by the last unlock alone
         class named_mutex
         {
         public:
@@ -108,6 +115,7 @@ namespace librealsense
             std::string _device_path;
             uint32_t _timeout;
             int _fildes;
+            int _count;
             std::mutex _mutex;
         };
 
@@ -118,6 +126,9 @@ namespace librealsense
         public:
             buffer(int fd, v4l2_buf_type type, bool use_memory_map, int index);
 
+            // User pointer buffer over memory of the application, which must hold the frame and the metadata appendix
+            buffer(int fd, v4l2_buf_type type, const user_buffer& memory, int index);
+
             void prepare_for_streaming(int fd);
 
             ~buffer();
@@ -135,6 +146,9 @@ namespace librealsense
 
             bool use_memory_map() const { return _use_memory_map; }
 
+            // DMABUF of memory mapped video buffers, when the driver supports VIDIOC_EXPBUF
+            const dmabuf_plane* get_dmabuf() const { return _dmabuf.fd >= 0 ? &_dmabuf : nullptr; }
+
         private:
             v4l2_buf_type _type;
             uint8_t* _start;
@@ -145,6 +159,8 @@ namespace librealsense
             v4l2_buffer _buf;
             std::mutex _mutex;
             bool _must_enqueue = false;
+            bool _owns_memory = true;
+            dmabuf_plane _dmabuf;
         };
 
         enum supported_kernel_buf_types : uint8_t
@@ -262,6 +278,46 @@ namespace librealsense
             virtual void acquire_metadata(buffers_mgr & buf_mgr,fd_set &fds) = 0;
         };
 
+        class v4l_uvc_device;
+
+        // Single epoll thread waiting on the video and metadata nodes of all the streaming devices, in place of a select()
+        // thread per device, enabled by setting LRS_V4L_REACTOR=1. The ready nodes of a device are handed to it in one call
+        class v4l_reactor
+        {
+        public:
+            static bool is_enabled();
+
+            // The reactor of the process, which exists while a device is registered
+            static std::shared_ptr<v4l_reactor> get();
+
+            ~v4l_reactor();
+
+            void add(v4l_uvc_device* dev, const std::vector<int>& fds);
+
+            // Once this returns, the device is not called anymore, unless called from within its own callback
+            void remove(v4l_uvc_device* dev);
+
+        private:
+            v4l_reactor();
+            void loop();
+
+            struct watched_device
+            {
+                std::vector<int> fds;
+                std::chrono::steady_clock::time_point last_ready;
+            };
+
+            int _epoll_fd;
+            int _wake_pipe_fd[2];
+            std::mutex _mutex;
+            std::condition_variable _dispatched_cv;
+            std::map<int, v4l_uvc_device*> _owners;
+            std::map<v4l_uvc_device*, watched_device> _devices;
+            v4l_uvc_device* _dispatching = nullptr;
+            std::atomic<bool> _is_alive;
+            std::thread _thread;
+        };
+
         class v4l_uvc_device : public uvc_device, public v4l_uvc_interface
         {
         public:
@@ -271,10 +327,16 @@ namespace librealsense
 
             v4l_uvc_device(const uvc_device_info& info, bool use_memory_map = false);
 
+            // Whether the capture buffers are memory mapped and exported as DMABUF, enabled by setting LRS_V4L_DMABUF=1.
+            // Only devices with a metadata node qualify, as the metadata of the others is appended to buffers that librealsense allocates
+            static bool is_dmabuf_export_enabled();
+
             ~v4l_uvc_device();
 
             void probe_and_commit(stream_profile profile, frame_callback callback, int buffers) override;
 
+            bool set_user_buffers(stream_profile profile, std::vector<user_buffer> buffers) override;
+
             void stream_on(std::function<void(const notification& n)> error_handler) override;
 
             void start_callbacks() override;
@@ -289,6 +351,9 @@ namespace librealsense
 
             void poll();
 
+            // Handle the nodes of the ready set, as found by poll() or the reactor. A count of 0 means they timed out
+            void on_ready(fd_set& fds, int count);
+
             void set_power_state(power_state state) override;
             power_state get_power_state() const override { return _state; }
 
@@ -330,6 +395,9 @@ namespace librealsense
             virtual void stop_data_capture();
             virtual void acquire_metadata(buffers_mgr & buf_mgr,fd_set &fds);
 
+            void handle_ready(fd_set& fds, int val);
+            void report_error(const std::exception& ex);
+
             power_state _state = D3;
             std::string _name = "";
             std::string _device_path = "";
@@ -337,12 +405,14 @@ namespace librealsense
             uvc_device_info _info;
 
             std::vector<std::shared_ptr<buffer>> _buffers;
+            std::vector<user_buffer> _user_buffers;     // Memory of the application for the next commit, in place of allocated buffers
             stream_profile _profile;
             frame_callback _callback;
             std::atomic<bool> _is_capturing;
             std::atomic<bool> _is_alive;
             std::atomic<bool> _is_started;
             std::unique_ptr<std::thread> _thread;
+            std::shared_ptr<v4l_reactor> _reactor;
             std::unique_ptr<named_mutex> _named_mtx;
             bool _use_memory_map;
             int _max_fd = 0;                    // specifies the maximal pipe number the polling process will monitor
@@ -381,6 +451,42 @@ namespace librealsense
             stream_profile _md_profile;
         };
 
+        // Rescans the devices as soon as the kernel reports a change over its uevent netlink socket, instead of every 5 seconds.
+        // Only the kinds of devices whose subsystems changed are queried again, once their burst of events settled
+        class v4l_device_watcher : public device_watcher
+        {
+        public:
+            v4l_device_watcher(const backend* backend_ref);
+            ~v4l_device_watcher();
+
+            void start(device_changed_callback callback) override;
+            bool start_from(const backend_device_group& devices, device_changed_callback callback) override;
+            void stop() override;
+
+        private:
+            enum device_kinds : uint32_t
+            {
+                uvc_devices = 1,
+                usb_devices = 2,
+                hid_devices = 4,
+                all_devices = uvc_devices | usb_devices | hid_devices
+            };
+
+            void watch();
+            uint32_t read_events();
+            void rescan(uint32_t kinds);
+
+            const backend* _backend;
+            int _socket;
+            int _stop_pipe_fd[2]; // write to _stop_pipe_fd[1] and read from _stop_pipe_fd[0]
+            std::atomic<bool> _is_watching;
+            std::unique_ptr<std::thread> _thread;
+
+            callbacks_heap _callback_inflight;
+            backend_device_group _devices_data;
+            device_changed_callback _callback;
+        };
+
         class v4l_backend : public backend
         {
         public:
@@ -0,0 +1,126 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include "load-governor.h"
+
+#include <algorithm>
+
+namespace librealsense
+{
+    namespace
+    {
+        // Fraction of the maximum latency the load is low under, for a level to be restored
+        const double calm_latency = 0.5;
+        const int max_rate_divider = 1 << 10;
+    }
+
+    const double load_governor::window_ms = 250.;
+    const double load_governor::min_hold_ms = 1000.;
+    const double load_governor::max_hold_ms = 32000.;
+
+    load_level load_level::of(const std::vector<rs2_load_action>& actions, int level)
+    {
+        load_level l;
+        for (int i = 0; i < level && i < int(actions.size()); ++i)
+        {
+            switch (actions[i])
+            {
+            case RS2_LOAD_ACTION_RAISE_DECIMATION: ++l.decimation_raise; break;
+            case RS2_LOAD_ACTION_SKIP_TEMPORAL: l.skip_temporal = true; break;
+            case RS2_LOAD_ACTION_DROP_STREAMS: l.drop_streams = true; break;
+            case RS2_LOAD_ACTION_HALVE_RATE: l.rate_divider = std::min(l.rate_divider * 2, max_rate_divider); break;
+            default: break;
+            }
+        }
+        return l;
+    }
+
+    load_governor::load_governor(float max_latency_ms, int levels)
+        : _max_latency_ms(max_latency_ms), _levels(levels), _level(0), _window_start(-1.), _settling(false),
+          _latency_sum(0.), _delivered(0), _queued(0), _dropped(0),
+          _calm_since(-1.), _hold_ms(min_hold_ms), _last_restore(-1.), _last_overload(-1.)
+    {
+        if (max_latency_ms <= 0.f)
+            throw invalid_value_exception(to_string() << "Unsupported load governor latency " << max_latency_ms << " ms, it must be positive");
+    }
+
+    bool load_governor::on_delivered(double now, double latency_ms)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _latency_sum += latency_ms;
+        ++_delivered;
+        return evaluate(now);
+    }
+
+    bool load_governor::on_queued(double now, bool dropped)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        ++_queued;
+        if (dropped)
+            ++_dropped;
+        return evaluate(now);
+    }
+
+    int load_governor::get_level() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _level;
+    }
+
+    bool load_governor::evaluate(double now)
+    {
+        if (_window_start < 0)
+            _window_start = now;
+        if (now - _window_start < window_ms)
+            return false;
+
+        auto latency = _delivered ? _latency_sum / _delivered : 0.;
+        auto overloaded = (_delivered && latency > _max_latency_ms) || (_dropped && _dropped * 4 >= _queued);
+        auto calm = latency < _max_latency_ms * calm_latency && !_dropped;
+        auto settling = _settling;
+
+        _window_start = now;
+        _settling = false;
+        _latency_sum = 0.;
+        _delivered = _queued = _dropped = 0;
+        if (settling)
+            return false;
+
+        if (overloaded)
+        {
+            _calm_since = -1.;
+            _last_overload = now;
+            if (_level == _levels)
+                return false;
+
+            // The load came back right after a level was restored, which waits longer the next time
+            if (_last_restore >= 0 && now - _last_restore < 2 * _hold_ms)
+                _hold_ms = std::min(_hold_ms * 2, max_hold_ms);
+
+            ++_level;
+            _settling = true;
+            return true;
+        }
+
+        if (!calm)
+        {
+            _calm_since = -1.;
+            return false;
+        }
+
+        // Without overload for as long as the longest hold, the hold is back to the shortest
+        if (_last_overload < 0 || now - _last_overload >= max_hold_ms)
+            _hold_ms = min_hold_ms;
+
+        if (_calm_since < 0)
+            _calm_since = now - window_ms;
+        if (!_level || now - _calm_since < _hold_ms)
+            return false;
+
+        --_level;
+        _last_restore = now;
+        _calm_since = -1.;
+        _settling = true;
+        return true;
+    }
+}
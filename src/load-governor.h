@@ -0,0 +1,75 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "types.h"
+
+#include <mutex>
+#include <set>
+#include <vector>
+
+namespace librealsense
+{
+    // What a pipeline configuration asks of its load governor
+    struct load_governor_settings
+    {
+        float                               max_latency_ms = 0.f;   // Zero when the pipeline has no governor
+        std::vector<rs2_load_action>        actions;                // Taken in order as the load grows
+        std::set<std::pair<rs2_stream, int>> low_priority;          // Streams RS2_LOAD_ACTION_DROP_STREAMS leaves out, index -1 for all
+    };
+
+    // The actions in effect at a level of a governor, the first level ones of the order
+    struct load_level
+    {
+        int     decimation_raise = 0;   // Added to the magnitude of the decimation filters
+        bool    skip_temporal = false;
+        bool    drop_streams = false;
+        int     rate_divider = 1;       // One frameset of every rate_divider is delivered
+
+        static load_level of(const std::vector<rs2_load_action>& actions, int level);
+    };
+
+    // Decides the level of degradation of a pipeline from the latency its framesets reach the application with, and from the
+    // framesets the queue of the application drops. The load is judged over windows of time: a window over the maximum latency,
+    // or where the queue dropped a quarter of the framesets, raises the level by one. A level is only restored after windows
+    // well under the maximum for as long as its hold, which doubles every time the load returns right after a restore, for the
+    // level to settle instead of oscillating, and is back to its shortest once the load stays low. The window after a change is
+    // left out, its framesets being of the previous level. Times are in milliseconds of the monotonic clock
+    class load_governor
+    {
+    public:
+        static const double window_ms;
+        static const double min_hold_ms;
+        static const double max_hold_ms;
+
+        load_governor(float max_latency_ms, int levels);
+
+        // Of a frameset the application read, latency from the driver. Returns true when the level changed
+        bool on_delivered(double now, double latency_ms);
+        // Of a frameset queued for the application, whether it replaced one the application did not read
+        bool on_queued(double now, bool dropped);
+
+        int get_level() const;
+
+    private:
+        bool evaluate(double now);
+
+        const double _max_latency_ms;
+        const int _levels;
+
+        mutable std::mutex _mutex;
+        int _level;
+        double _window_start;
+        bool _settling;             // The window follows a change of level
+        double _latency_sum;
+        int _delivered;
+        int _queued;
+        int _dropped;
+
+        double _calm_since;         // Start of the windows of low load, negative while the load is not low
+        double _hold_ms;
+        double _last_restore;       // Negative until a level is restored
+        double _last_overload;      // Negative until the load is high
+    };
+}
@@ -1,12 +1,472 @@
 #include "types.h"
 
 #include <fstream>
+#include <ctime>
 
 #if BUILD_EASYLOGGINGPP
 INITIALIZE_EASYLOGGINGPP
 
 namespace librealsense
 {
+    std::atomic<int> minimum_logged_severity(RS2_LOG_SEVERITY_NONE);
+
+    namespace
+    {
+        enum class log_entry : uint8_t
+        {
+            text,                   // Length, then the characters
+            value,                  // Print function, size, then the bytes of the value
+            ios_manipulator,
+            ostream_manipulator
+        };
+
+        // Leads every message, followed by its entries
+        struct log_header
+        {
+            uint32_t size;          // Of the whole message, the header included
+            int32_t severity;
+            const char* file;
+            int32_t line;
+            int64_t time;           // Microseconds of the system clock
+        };
+
+        template<class T>
+        void append(std::vector<uint8_t>& record, const T& value)
+        {
+            auto at = record.size();
+            record.resize(at + sizeof(T));
+            memcpy(record.data() + at, &value, sizeof(T));
+        }
+
+        void append_text(std::vector<uint8_t>& record, const char* text, size_t length)
+        {
+            append(record, log_entry::text);
+            append(record, static_cast<uint32_t>(length));
+            record.insert(record.end(), text, text + length);
+        }
+
+        void reset_format(std::ostringstream& out)
+        {
+            out.str(std::string());
+            out.clear();
+            out.flags(std::ios_base::dec | std::ios_base::skipws);
+            out.precision(6);
+            out.width(0);
+            out.fill(' ');
+        }
+
+        // Formats the entries of a message, or only replays its manipulators
+        void format_entries(const uint8_t* message, size_t size, std::ostream& out, bool manipulators_only)
+        {
+            size_t at = sizeof(log_header);
+            while (at < size)
+            {
+                auto entry = static_cast<log_entry>(message[at++]);
+                switch (entry)
+                {
+                case log_entry::text:
+                {
+                    uint32_t length;
+                    memcpy(&length, message + at, sizeof(length));
+                    at += sizeof(length);
+                    if (!manipulators_only) out.write(reinterpret_cast<const char*>(message + at), length);
+                    at += length;
+                    break;
+                }
+                case log_entry::value:
+                {
+                    log_message::print_function print;
+                    memcpy(&print, message + at, sizeof(print));
+                    at += sizeof(print);
+                    auto length = message[at++];
+                    if (!manipulators_only) print(out, message + at);
+                    at += length;
+                    break;
+                }
+                case log_entry::ios_manipulator:
+                {
+                    std::ios_base& (*manipulator)(std::ios_base&);
+                    memcpy(&manipulator, message + at, sizeof(manipulator));
+                    at += sizeof(manipulator);
+                    manipulator(out);
+                    break;
+                }
+                case log_entry::ostream_manipulator:
+                {
+                    std::ostream& (*manipulator)(std::ostream&);
+                    memcpy(&manipulator, message + at, sizeof(manipulator));
+                    at += sizeof(manipulator);
+                    if (!manipulators_only) manipulator(out);
+                    break;
+                }
+                }
+            }
+        }
+
+        // Messages of a single thread, written by it and read by the flushing thread without locking
+        class log_ring
+        {
+        public:
+            explicit log_ring(std::string thread)
+                : _data(new uint8_t[capacity]), _head(0), _tail(0), _dropped(0), _retired(false), _thread(std::move(thread)) {}
+
+            // Drops the message when the ring is full, rather than waiting on the flushing thread
+            void push(const std::vector<uint8_t>& message)
+            {
+                auto head = _head.load(std::memory_order_relaxed);
+                auto tail = _tail.load(std::memory_order_acquire);
+                if (message.size() > capacity - (head - tail))
+                {
+                    _dropped.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                copy_in(head, message.data(), message.size());
+                _head.store(head + message.size(), std::memory_order_release);
+            }
+
+            template<class F>
+            void drain(F on_message)
+            {
+                auto head = _head.load(std::memory_order_acquire);
+                auto tail = _tail.load(std::memory_order_relaxed);
+                while (tail < head)
+                {
+                    log_header header;
+                    copy_out(tail, &header, sizeof(header));
+                    std::vector<uint8_t> message(header.size);
+                    copy_out(tail, message.data(), message.size());
+                    tail += header.size;
+                    on_message(std::move(message));
+                }
+                _tail.store(tail, std::memory_order_release);
+            }
+
+            uint64_t take_dropped() { return _dropped.exchange(0, std::memory_order_relaxed); }
+            void retire() { _retired = true; }
+            bool is_retired() const { return _retired; }
+            const std::string& get_thread() const { return _thread; }
+
+        private:
+            static const size_t capacity = 1024 * 1024;
+
+            void copy_in(uint64_t at, const uint8_t* data, size_t size)
+            {
+                auto offset = static_cast<size_t>(at % capacity);
+                auto first = std::min(size, capacity - offset);
+                memcpy(_data.get() + offset, data, first);
+                memcpy(_data.get(), data + first, size - first);
+            }
+
+            void copy_out(uint64_t at, void* data, size_t size) const
+            {
+                auto offset = static_cast<size_t>(at % capacity);
+                auto first = std::min(size, capacity - offset);
+                memcpy(data, _data.get() + offset, first);
+                memcpy(static_cast<uint8_t*>(data) + first, _data.get(), size - first);
+            }
+
+            std::unique_ptr<uint8_t[]> _data;
+            std::atomic<uint64_t> _head;    // Bytes written, by the logging thread
+            std::atomic<uint64_t> _tail;    // Bytes read, by the flushing thread
+            std::atomic<uint64_t> _dropped;
+            std::atomic<bool> _retired;
+            const std::string _thread;
+        };
+
+        // Writes the messages of all the rings to EasyLogging++, in the order they were logged, every few milliseconds
+        class log_flusher
+        {
+        public:
+            static log_flusher& instance()
+            {
+                static log_flusher flusher;
+                return flusher;
+            }
+
+            std::shared_ptr<log_ring> add_ring()
+            {
+                std::ostringstream thread;
+                thread << std::this_thread::get_id();
+                auto ring = std::make_shared<log_ring>(thread.str());
+
+                std::lock_guard<std::mutex> lock(_rings_mutex);
+                _rings.push_back(ring);
+                if (!_thread.joinable())
+                    _thread = std::thread([this]() { run(); });
+                return ring;
+            }
+
+            void flush()
+            {
+                std::lock_guard<std::mutex> lock(_flush_mutex);
+
+                std::vector<std::shared_ptr<log_ring>> rings;
+                {
+                    std::lock_guard<std::mutex> lock(_rings_mutex);
+                    rings = _rings;
+                }
+
+                std::vector<std::pair<std::vector<uint8_t>, const log_ring*>> messages;
+                std::vector<std::pair<const log_ring*, uint64_t>> dropped;
+                for (auto&& ring : rings)
+                {
+                    // A ring retired before draining it receives no more messages
+                    auto retired = ring->is_retired();
+                    ring->drain([&](std::vector<uint8_t>&& message) { messages.emplace_back(std::move(message), ring.get()); });
+                    if (auto count = ring->take_dropped())
+                        dropped.emplace_back(ring.get(), count);
+                    if (retired)
+                    {
+                        std::lock_guard<std::mutex> lock(_rings_mutex);
+                        _rings.erase(std::remove(_rings.begin(), _rings.end(), ring), _rings.end());
+                    }
+                }
+
+                std::stable_sort(messages.begin(), messages.end(), [](const std::pair<std::vector<uint8_t>, const log_ring*>& a, const std::pair<std::vector<uint8_t>, const log_ring*>& b)
+                {
+                    return time_of(a.first) < time_of(b.first);
+                });
+                for (auto&& message : messages)
+                    write(message.first, *message.second);
+
+                auto now = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+                for (auto&& ring : dropped)
+                {
+                    begin_line(now, RS2_LOG_SEVERITY_WARN, *ring.first);
+                    _out << ring.second << " messages were dropped, the log ring of the thread was full";
+                    write(RS2_LOG_SEVERITY_WARN, _out.str());
+                }
+            }
+
+            ~log_flusher()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(_wake_mutex);
+                    _stopping = true;
+                }
+                _wake.notify_one();
+                if (_thread.joinable())
+                    _thread.join();
+                flush();
+            }
+
+        private:
+            log_flusher() = default;
+
+            void run()
+            {
+                std::unique_lock<std::mutex> lock(_wake_mutex);
+                while (!_stopping)
+                {
+                    _wake.wait_for(lock, std::chrono::milliseconds(10));
+                    lock.unlock();
+                    flush();
+                    lock.lock();
+                }
+            }
+
+            static int64_t time_of(const std::vector<uint8_t>& message)
+            {
+                log_header header;
+                memcpy(&header, message.data(), sizeof(header));
+                return header.time;
+            }
+
+            // In the format the messages had when EasyLogging++ formatted them on the logging thread
+            void write(const std::vector<uint8_t>& message, const log_ring& ring)
+            {
+                log_header header;
+                memcpy(&header, message.data(), sizeof(header));
+
+                std::string file = header.file;
+                auto slash = file.find_last_of("/\\");
+                if (slash != std::string::npos)
+                    file = file.substr(slash + 1);
+
+                begin_line(header.time, header.severity, ring);
+                _out << "(" << file << ":" << header.line << ") ";
+                format_entries(message.data(), message.size(), _out, false);
+                write(static_cast<rs2_log_severity>(header.severity), _out.str());
+            }
+
+            void begin_line(int64_t time_us, int severity, const log_ring& ring)
+            {
+                auto seconds = static_cast<time_t>(time_us / 1000000);
+                tm local{};
+#ifdef _WIN32
+                localtime_s(&local, &seconds);
+#else
+                localtime_r(&seconds, &local);
+#endif
+                char time[32];
+                auto length = strftime(time, sizeof(time), "%d/%m %H:%M:%S", &local);
+                snprintf(time + length, sizeof(time) - length, ",%03d", static_cast<int>(time_us / 1000 % 1000));
+
+                reset_format(_out);
+                _out << " " << time << " " << level_name(severity) << " [" << ring.get_thread() << "] ";
+            }
+
+            static const char* level_name(int severity)
+            {
+                switch (severity)
+                {
+                case RS2_LOG_SEVERITY_DEBUG: return "DEBUG";
+                case RS2_LOG_SEVERITY_INFO: return "INFO";
+                case RS2_LOG_SEVERITY_WARN: return "WARNING";
+                case RS2_LOG_SEVERITY_ERROR: return "ERROR";
+                default: return "FATAL";
+                }
+            }
+
+            static void write(rs2_log_severity severity, const std::string& line)
+            {
+                switch (severity)
+                {
+                case RS2_LOG_SEVERITY_DEBUG: CLOG(DEBUG, "librealsense") << line; break;
+                case RS2_LOG_SEVERITY_INFO: CLOG(INFO, "librealsense") << line; break;
+                case RS2_LOG_SEVERITY_WARN: CLOG(WARNING, "librealsense") << line; break;
+                case RS2_LOG_SEVERITY_ERROR: CLOG(ERROR, "librealsense") << line; break;
+                default: CLOG(FATAL, "librealsense") << line; break;
+                }
+            }
+
+            std::mutex _rings_mutex;
+            std::vector<std::shared_ptr<log_ring>> _rings;
+            std::mutex _flush_mutex;
+            std::ostringstream _out;
+            std::mutex _wake_mutex;
+            std::condition_variable _wake;
+            bool _stopping = false;
+            std::thread _thread;
+        };
+
+        // Retires the ring of a thread as it exits, for the flusher to drop it once drained
+        struct ring_holder
+        {
+            std::shared_ptr<log_ring> ring;
+            ~ring_holder() { if (ring) ring->retire(); }
+        };
+
+        log_ring& current_ring()
+        {
+            static thread_local ring_holder holder;
+            if (!holder.ring)
+                holder.ring = log_flusher::instance().add_ring();
+            return *holder.ring;
+        }
+    }
+
+    // Reused by the messages of a thread, for logging not to allocate once warmed up
+    struct log_message::scratch
+    {
+        std::vector<uint8_t> record;
+        std::ostringstream stream;
+        bool busy = false;
+        bool nested = false;
+    };
+
+    log_message::log_message(rs2_log_severity severity, const char* file, int line)
+        : _formatted(false)
+    {
+        static thread_local scratch current;
+        // A message logged while formatting another has its own
+        if (current.busy)
+        {
+            _scratch = new scratch();
+            _scratch->nested = true;
+        }
+        else _scratch = &current;
+        _scratch->busy = true;
+        _stream = &_scratch->stream;
+
+        log_header header{};
+        header.severity = severity;
+        header.file = file;
+        header.line = line;
+        header.time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        _scratch->record.clear();
+        append(_scratch->record, header);
+    }
+
+    log_message::~log_message()
+    {
+        try
+        {
+            auto& record = _scratch->record;
+            if (_formatted)
+            {
+                auto text = _scratch->stream.str();
+                append_text(record, text.data(), text.size());
+            }
+            auto size = static_cast<uint32_t>(record.size());
+            memcpy(record.data(), &size, sizeof(size));
+            current_ring().push(record);
+        }
+        catch (...) {}
+
+        if (_scratch->nested) delete _scratch;
+        else _scratch->busy = false;
+    }
+
+    log_message& log_message::operator<<(const char* value)
+    {
+        if (_formatted) *_stream << value;
+        else if (value) append_text(_scratch->record, value, strlen(value));
+        return *this;
+    }
+
+    log_message& log_message::operator<<(const std::string& value)
+    {
+        if (_formatted) *_stream << value;
+        else append_text(_scratch->record, value.data(), value.size());
+        return *this;
+    }
+
+    log_message& log_message::operator<<(std::ios_base& (*manipulator)(std::ios_base&))
+    {
+        if (_formatted) manipulator(*_stream);
+        else
+        {
+            append(_scratch->record, log_entry::ios_manipulator);
+            append(_scratch->record, manipulator);
+        }
+        return *this;
+    }
+
+    log_message& log_message::operator<<(std::ostream& (*manipulator)(std::ostream&))
+    {
+        if (_formatted) manipulator(*_stream);
+        else
+        {
+            append(_scratch->record, log_entry::ostream_manipulator);
+            append(_scratch->record, manipulator);
+        }
+        return *this;
+    }
+
+    void log_message::capture_value(print_function print, const void* value, size_t size)
+    {
+        auto& record = _scratch->record;
+        append(record, log_entry::value);
+        append(record, print);
+        append(record, static_cast<uint8_t>(size));
+        auto bytes = static_cast<const uint8_t*>(value);
+        record.insert(record.end(), bytes, bytes + size);
+    }
+
+    std::ostream& log_message::begin_formatting()
+    {
+        // The values formatted from now on follow the manipulators captured so far
+        reset_format(_scratch->stream);
+        format_entries(_scratch->record.data(), _scratch->record.size(), _scratch->stream, true);
+        _formatted = true;
+        return *_stream;
+    }
+
+    void flush_log()
+    {
+        log_flusher::instance().flush();
+    }
     class logger_type
     {
         rs2_log_severity minimum_log_severity = RS2_LOG_SEVERITY_NONE;
@@ -45,7 +505,8 @@ namespace librealsense
             defaultConf.setGlobally(el::ConfigurationType::ToStandardOutput, "false");
             defaultConf.setGlobally(el::ConfigurationType::MaxLogFileSize, "2097152");
             defaultConf.setGlobally(el::ConfigurationType::LogFlushThreshold, "10");
-            defaultConf.setGlobally(el::ConfigurationType::Format, " %datetime{%d/%M %H:%m:%s,%g} %level [%thread] (%fbase:%line) %msg");
+            // The messages come formatted from the flushing thread, with the time, thread and location they were logged at
+            defaultConf.setGlobally(el::ConfigurationType::Format, "%msg");
 
             for (int i = minimum_console_severity; i < RS2_LOG_SEVERITY_NONE; i++)
             {
@@ -61,6 +522,7 @@ namespace librealsense
             }
 
             el::Loggers::reconfigureLogger(log_id, defaultConf);
+            minimum_logged_severity = std::min(minimum_console_severity, minimum_file_severity);
         }
 
         void open_def() const
@@ -73,6 +535,7 @@ namespace librealsense
             defaultConf.setGlobally(el::ConfigurationType::ToStandardOutput, "false");
 
             el::Loggers::reconfigureLogger(log_id, defaultConf);
+            minimum_logged_severity = RS2_LOG_SEVERITY_NONE;
         }
 
 
@@ -0,0 +1,161 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include "capture_format.h"
+
+namespace librealsense
+{
+    namespace capture
+    {
+        static void write_infos(net::writer& w, const std::vector<std::pair<rs2_camera_info, std::string>>& infos)
+        {
+            w << static_cast<uint32_t>(infos.size());
+            for (auto&& info : infos)
+                w << static_cast<uint32_t>(info.first) << info.second;
+        }
+
+        static std::vector<std::pair<rs2_camera_info, std::string>> read_infos(net::reader& r)
+        {
+            std::vector<std::pair<rs2_camera_info, std::string>> infos;
+            auto count = r.read<uint32_t>();
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                auto info = static_cast<rs2_camera_info>(r.read<uint32_t>());
+                infos.emplace_back(info, r.read<std::string>());
+            }
+            return infos;
+        }
+
+        static void write_option(net::writer& w, const option_value& o)
+        {
+            w << static_cast<uint32_t>(o.id) << o.value << o.description;
+        }
+
+        static option_value read_option(net::reader& r)
+        {
+            option_value o;
+            o.id = static_cast<rs2_option>(r.read<uint32_t>());
+            r >> o.value >> o.description;
+            return o;
+        }
+
+        void write_footer(net::writer& w, const footer& f)
+        {
+            w << file_version;
+            write_infos(w, f.infos);
+
+            w << static_cast<uint32_t>(f.sensors.size());
+            for (auto&& s : f.sensors)
+            {
+                w << s.index;
+                write_infos(w, s.infos);
+
+                w << static_cast<uint32_t>(s.options.size());
+                for (auto&& o : s.options)
+                    write_option(w, o);
+
+                w << static_cast<uint32_t>(s.profiles.size());
+                for (auto&& p : s.profiles)
+                    w << static_cast<uint32_t>(p.type) << static_cast<uint32_t>(p.stream) << p.index << static_cast<uint32_t>(p.format)
+                      << p.fps << p.tag << p.width << p.height << p.intrinsics << p.motion_intrinsics;
+            }
+
+            w << static_cast<uint32_t>(f.streams.size());
+            for (auto&& s : f.streams)
+                w << s.id.device_index << s.id.sensor_index << static_cast<uint32_t>(s.id.stream_type) << s.id.stream_index
+                  << static_cast<uint8_t>(s.has_extrinsics ? 1 : 0) << s.extrinsics_group << s.extrinsics;
+
+            w << static_cast<uint32_t>(f.option_changes.size());
+            for (auto&& c : f.option_changes)
+            {
+                w << c.time << c.sensor;
+                write_option(w, c.option);
+            }
+
+            w << static_cast<uint32_t>(f.notifications.size());
+            for (auto&& n : f.notifications)
+                w << n.time << n.sensor << static_cast<uint32_t>(n.category) << static_cast<uint32_t>(n.severity)
+                  << n.description << n.serialized_data << n.timestamp;
+
+            w << static_cast<uint32_t>(f.chunks.size());
+            for (auto&& c : f.chunks)
+                w << c;
+
+            w << f.duration;
+        }
+
+        footer read_footer(net::reader& r)
+        {
+            auto version = r.read<uint32_t>();
+            if (version != file_version)
+                throw io_exception(to_string() << "Capture file version " << version << " is not supported");
+
+            footer f;
+            f.infos = read_infos(r);
+
+            auto sensors_count = r.read<uint32_t>();
+            for (uint32_t i = 0; i < sensors_count; ++i)
+            {
+                sensor_description s;
+                r >> s.index;
+                s.infos = read_infos(r);
+
+                auto options_count = r.read<uint32_t>();
+                for (uint32_t o = 0; o < options_count; ++o)
+                    s.options.push_back(read_option(r));
+
+                auto profiles_count = r.read<uint32_t>();
+                for (uint32_t p = 0; p < profiles_count; ++p)
+                {
+                    profile_description d;
+                    d.type = static_cast<rs2_extension>(r.read<uint32_t>());
+                    d.stream = static_cast<rs2_stream>(r.read<uint32_t>());
+                    r >> d.index;
+                    d.format = static_cast<rs2_format>(r.read<uint32_t>());
+                    r >> d.fps >> d.tag >> d.width >> d.height >> d.intrinsics >> d.motion_intrinsics;
+                    s.profiles.push_back(d);
+                }
+                f.sensors.push_back(s);
+            }
+
+            auto streams_count = r.read<uint32_t>();
+            for (uint32_t i = 0; i < streams_count; ++i)
+            {
+                stream_description s;
+                r >> s.id.device_index >> s.id.sensor_index;
+                s.id.stream_type = static_cast<rs2_stream>(r.read<uint32_t>());
+                r >> s.id.stream_index;
+                s.has_extrinsics = r.read<uint8_t>() != 0;
+                r >> s.extrinsics_group >> s.extrinsics;
+                f.streams.push_back(s);
+            }
+
+            auto changes_count = r.read<uint32_t>();
+            for (uint32_t i = 0; i < changes_count; ++i)
+            {
+                option_change c;
+                r >> c.time >> c.sensor;
+                c.option = read_option(r);
+                f.option_changes.push_back(c);
+            }
+
+            auto notifications_count = r.read<uint32_t>();
+            for (uint32_t i = 0; i < notifications_count; ++i)
+            {
+                recorded_notification n;
+                r >> n.time >> n.sensor;
+                n.category = static_cast<rs2_notification_category>(r.read<uint32_t>());
+                n.severity = static_cast<rs2_log_severity>(r.read<uint32_t>());
+                r >> n.description >> n.serialized_data >> n.timestamp;
+                f.notifications.push_back(n);
+            }
+
+            auto chunks_count = r.read<uint32_t>();
+            for (uint32_t i = 0; i < chunks_count; ++i)
+                f.chunks.push_back(r.read<chunk_entry>());
+
+            r >> f.duration;
+            return f;
+        }
+    }
+}
@@ -0,0 +1,152 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "net/net-protocol.h"
+#include "core/serialization.h"
+
+#include <string>
+#include <vector>
+
+namespace librealsense
+{
+    // Native capture files, recorded and played through the device_serializer writer and reader as rosbag files are.
+    // A file is a header, followed by chunks of the frames of one stream each, and ends with a footer describing the device
+    // and indexing the chunks, followed by a trailer locating the footer. A chunk starts on a page boundary with a column of
+    // fixed-layout frame records, followed by the raw data of its frames, each aligned on its own, so that a reader mapping
+    // the file hands out the frame data in place. Everything is in the byte order of the host that recorded the file
+    namespace capture
+    {
+        const uint32_t file_magic = 0x50435352;     // "RSCP"
+        const uint32_t file_version = 1;
+        const char* const file_extension = ".rscap";
+
+        const uint64_t chunk_alignment = 4096;
+        const uint64_t data_alignment = 64;
+        const uint32_t max_chunk_frames = 32;
+        const uint64_t max_chunk_data = 64 * 1024 * 1024;
+        const uint32_t max_metadata = 32;
+
+#pragma pack(push, 1)
+        struct file_header
+        {
+            uint32_t magic;
+            uint32_t version;
+        };
+
+        struct chunk_header
+        {
+            uint32_t stream;        // In the streams of the footer
+            uint32_t frame_count;   // Of the records that follow
+        };
+
+        struct frame_record
+        {
+            uint64_t capture_time;  // In nanoseconds from the start of the recording
+            uint64_t data_offset;   // In the file
+            uint32_t extension;     // Of the frame
+            net::frame_header frame;
+            net::metadata_pair metadata[max_metadata];
+        };
+
+        struct chunk_entry
+        {
+            uint64_t offset;
+            uint32_t stream;
+            uint32_t frame_count;
+            uint64_t first_time;
+            uint64_t last_time;
+        };
+
+        struct file_trailer
+        {
+            uint64_t footer_offset;
+            uint64_t footer_size;
+            uint32_t magic;
+        };
+#pragma pack(pop)
+
+        struct option_value
+        {
+            rs2_option id;
+            float value;
+            std::string description;
+        };
+
+        struct profile_description
+        {
+            rs2_extension type;     // Video, motion or pose profile
+            rs2_stream stream;
+            uint32_t index;
+            rs2_format format;
+            uint32_t fps;
+            int32_t tag;
+            uint32_t width;
+            uint32_t height;
+            rs2_intrinsics intrinsics;
+            rs2_motion_device_intrinsic motion_intrinsics;
+        };
+
+        struct sensor_description
+        {
+            uint32_t index;
+            std::vector<std::pair<rs2_camera_info, std::string>> infos;
+            std::vector<option_value> options;
+            std::vector<profile_description> profiles;
+        };
+
+        struct stream_description
+        {
+            device_serializer::stream_identifier id;
+            bool has_extrinsics;
+            uint32_t extrinsics_group;
+            rs2_extrinsics extrinsics;
+        };
+
+        struct option_change
+        {
+            uint64_t time;
+            uint32_t sensor;
+            option_value option;
+        };
+
+        struct recorded_notification
+        {
+            uint64_t time;
+            uint32_t sensor;
+            rs2_notification_category category;
+            rs2_log_severity severity;
+            std::string description;
+            std::string serialized_data;
+            double timestamp;
+        };
+
+        // The device as it was when the recording started, and what changed during it, in the order it did
+        struct footer
+        {
+            std::vector<std::pair<rs2_camera_info, std::string>> infos;
+            std::vector<sensor_description> sensors;
+            std::vector<stream_description> streams;
+            std::vector<option_change> option_changes;
+            std::vector<recorded_notification> notifications;
+            std::vector<chunk_entry> chunks;
+            uint64_t duration = 0;
+        };
+
+        void write_footer(net::writer& w, const footer& f);
+        // Throws when the footer is of another file version
+        footer read_footer(net::reader& r);
+
+        inline uint64_t align(uint64_t offset, uint64_t alignment)
+        {
+            return (offset + alignment - 1) / alignment * alignment;
+        }
+
+        inline bool is_capture_file(const std::string& file)
+        {
+            auto extension = std::string(file_extension);
+            return file.size() > extension.size() && file.compare(file.size() - extension.size(), extension.size(), extension) == 0;
+        }
+    }
+}
@@ -0,0 +1,485 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include "capture_reader.h"
+#include "source.h"
+#include "stream.h"
+#include "option.h"
+#include "metadata-parser.h"
+#include "net/net-description.h"
+
+#include <algorithm>
+#include <limits>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+using namespace librealsense;
+using namespace device_serializer;
+
+namespace librealsense
+{
+    namespace capture
+    {
+        mapped_file::mapped_file(const std::string& file)
+        {
+#ifdef _WIN32
+            auto handle = CreateFileA(file.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (handle == INVALID_HANDLE_VALUE)
+                throw io_exception(to_string() << "Cannot open \"" << file << "\", error " << GetLastError());
+            _file = handle;
+            LARGE_INTEGER size;
+            if (!GetFileSizeEx(handle, &size) || size.QuadPart == 0)
+                throw io_exception(to_string() << "Cannot map \"" << file << "\", it is empty or its size is unknown");
+            _size = static_cast<uint64_t>(size.QuadPart);
+            _mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (!_mapping)
+                throw io_exception(to_string() << "Cannot map \"" << file << "\", error " << GetLastError());
+            _data = static_cast<const uint8_t*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+            if (!_data)
+                throw io_exception(to_string() << "Cannot map \"" << file << "\", error " << GetLastError());
+#else
+            auto fd = ::open(file.c_str(), O_RDONLY);
+            if (fd < 0)
+                throw io_exception(to_string() << "Cannot open \"" << file << "\", " << strerror(errno));
+            struct stat st;
+            if (fstat(fd, &st) != 0 || st.st_size == 0)
+            {
+                ::close(fd);
+                throw io_exception(to_string() << "Cannot map \"" << file << "\", it is empty or its size is unknown");
+            }
+            _size = static_cast<uint64_t>(st.st_size);
+            auto data = mmap(nullptr, static_cast<size_t>(_size), PROT_READ, MAP_SHARED, fd, 0);
+            ::close(fd);
+            if (data == MAP_FAILED)
+                throw io_exception(to_string() << "Cannot map \"" << file << "\", " << strerror(errno));
+            _data = static_cast<const uint8_t*>(data);
+#endif
+        }
+
+        mapped_file::~mapped_file()
+        {
+#ifdef _WIN32
+            if (_data)
+                UnmapViewOfFile(_data);
+            if (_mapping)
+                CloseHandle(_mapping);
+            if (_file)
+                CloseHandle(_file);
+#else
+            if (_data)
+                munmap(const_cast<uint8_t*>(_data), static_cast<size_t>(_size));
+#endif
+        }
+    }
+}
+
+static std::shared_ptr<info_container> create_infos(const std::vector<std::pair<rs2_camera_info, std::string>>& infos)
+{
+    auto container = std::make_shared<info_container>();
+    for (auto&& info : infos)
+        container->register_info(info.first, info.second);
+    return container;
+}
+
+static std::shared_ptr<stream_profile_interface> create_profile(const capture::profile_description& d)
+{
+    std::shared_ptr<stream_profile_interface> result;
+    if (d.type == RS2_EXTENSION_VIDEO_PROFILE)
+    {
+        auto profile = std::make_shared<video_stream_profile>(platform::stream_profile{ d.width, d.height, d.fps, static_cast<uint32_t>(d.format) });
+        auto intrinsics = d.intrinsics;
+        profile->set_intrinsics([intrinsics]() { return intrinsics; });
+        profile->set_dims(d.width, d.height);
+        result = profile;
+    }
+    else if (d.type == RS2_EXTENSION_MOTION_PROFILE)
+    {
+        auto profile = std::make_shared<motion_stream_profile>(platform::stream_profile{ 0, 0, d.fps, static_cast<uint32_t>(d.format) });
+        auto intrinsics = d.motion_intrinsics;
+        profile->set_intrinsics([intrinsics]() { return intrinsics; });
+        result = profile;
+    }
+    else
+    {
+        result = std::make_shared<stream_profile_base>(platform::stream_profile{ 0, 0, d.fps, static_cast<uint32_t>(d.format) });
+    }
+    result->set_stream_index(d.index);
+    result->set_stream_type(d.stream);
+    result->set_format(d.format);
+    result->set_framerate(d.fps);
+    if (d.tag)
+        result->tag_profile(d.tag);
+    return result;
+}
+
+capture_reader::capture_reader(const std::string& file) :
+    _file(file),
+    _next_option_change(0),
+    _next_notification(0),
+    _streaming(false),
+    _time(0),
+    _metadata_parsers(md_constant_parser::create_metadata_parser_map())
+{
+    // Played back frames are stamped through their delivery as the frames of devices are
+    _metadata_parsers->set(RS2_FRAME_METADATA_DEQUEUE_TIME, std::make_shared<md_stage_time_parser>(frame_stage::dequeue));
+    _metadata_parsers->set(RS2_FRAME_METADATA_UNPACK_TIME, std::make_shared<md_stage_time_parser>(frame_stage::unpack));
+    _metadata_parsers->set(RS2_FRAME_METADATA_SYNC_TIME, std::make_shared<md_stage_time_parser>(frame_stage::sync));
+    _metadata_parsers->set(RS2_FRAME_METADATA_CALLBACK_TIME, std::make_shared<md_stage_time_parser>(frame_stage::callback));
+    _metadata_parsers->set(RS2_FRAME_METADATA_DEPTH_MIN, std::make_shared<md_depth_statistics_parser>(RS2_FRAME_METADATA_DEPTH_MIN));
+    _metadata_parsers->set(RS2_FRAME_METADATA_DEPTH_MAX, std::make_shared<md_depth_statistics_parser>(RS2_FRAME_METADATA_DEPTH_MAX));
+    _metadata_parsers->set(RS2_FRAME_METADATA_DEPTH_MEAN, std::make_shared<md_depth_statistics_parser>(RS2_FRAME_METADATA_DEPTH_MEAN));
+    _metadata_parsers->set(RS2_FRAME_METADATA_DEPTH_FILL_RATE, std::make_shared<md_depth_statistics_parser>(RS2_FRAME_METADATA_DEPTH_FILL_RATE));
+    _metadata_parsers->set(RS2_FRAME_METADATA_DEPTH_HISTOGRAM, std::make_shared<md_depth_statistics_parser>(RS2_FRAME_METADATA_DEPTH_HISTOGRAM));
+    try
+    {
+        _mapping = std::make_shared<capture::mapped_file>(file);
+        auto data = _mapping->data();
+        auto size = _mapping->size();
+        if (size < sizeof(capture::file_header) + sizeof(capture::file_trailer))
+            throw io_exception("The file is truncated");
+
+        auto header = reinterpret_cast<const capture::file_header*>(data);
+        if (header->magic != capture::file_magic)
+            throw io_exception("The file is not a capture file");
+        if (header->version != capture::file_version)
+            throw io_exception(to_string() << "The file is of version " << header->version << ", version " << capture::file_version << " is supported");
+
+        // The trailer is written last, a file without it was not closed
+        capture::file_trailer trailer;
+        memcpy(&trailer, data + size - sizeof(trailer), sizeof(trailer));
+        auto footer_end = size - sizeof(trailer);
+        if (trailer.magic != capture::file_magic || trailer.footer_size > footer_end || trailer.footer_offset > footer_end - trailer.footer_size)
+            throw io_exception("The file was not completed");
+
+        net::reader r(data + trailer.footer_offset, static_cast<size_t>(trailer.footer_size));
+        _footer = capture::read_footer(r);
+        index_chunks();
+        _initial_description = create_device_description();
+        reset();
+    }
+    catch (const std::exception& e)
+    {
+        //Rethrowing with better clearer message
+        throw io_exception(to_string() << "Failed to create capture reader for \"" << file << "\": " << e.what());
+    }
+}
+
+void capture_reader::index_chunks()
+{
+    // Records and data are checked against the trailer, for no frame to reach out of the mapping
+    auto end = _mapping->size() - sizeof(capture::file_trailer);
+    _streams.resize(_footer.streams.size());
+    for (auto&& chunk : _footer.chunks)
+    {
+        auto records_size = static_cast<uint64_t>(chunk.frame_count) * sizeof(capture::frame_record);
+        // Subtracting from the end rather than adding to the offsets, which a corrupt file may set to overflow
+        auto chunk_size = sizeof(capture::chunk_header) + records_size;
+        if (chunk.stream >= _streams.size() || chunk_size > end || chunk.offset > end - chunk_size)
+            throw io_exception(to_string() << "The chunk at " << chunk.offset << " is out of the file");
+
+        auto records = reinterpret_cast<const capture::frame_record*>(_mapping->data() + chunk.offset + sizeof(capture::chunk_header));
+        for (uint32_t i = 0; i < chunk.frame_count; ++i)
+        {
+            auto&& record = records[i];
+            if (record.frame.data_size > end || record.data_offset > end - record.frame.data_size)
+                throw io_exception(to_string() << "The data of frame " << record.frame.frame_number << " is out of the file");
+
+            // Video frames are read in place, their rows must lie within their data as shm::is_valid_frame checks the slots
+            auto extension = static_cast<rs2_extension>(record.extension);
+            if (extension == RS2_EXTENSION_VIDEO_FRAME || extension == RS2_EXTENSION_DEPTH_FRAME)
+            {
+                auto row = (static_cast<uint64_t>(record.frame.width) * record.frame.bpp + 7) / 8;
+                auto frame_size = static_cast<uint64_t>(record.frame.stride) * record.frame.height;
+                if (!record.frame.bpp || record.frame.stride < row || frame_size > record.frame.data_size)
+                {
+                    LOG_WARNING("Skipped frame " << record.frame.frame_number << " of the capture, its pixels do not fit its data");
+                    continue;
+                }
+            }
+            _streams[chunk.stream].records.push_back(&record);
+        }
+    }
+
+    for (auto&& s : _streams)
+        std::stable_sort(s.records.begin(), s.records.end(),
+            [](const capture::frame_record* a, const capture::frame_record* b) { return a->capture_time < b->capture_time; });
+    std::stable_sort(_footer.option_changes.begin(), _footer.option_changes.end(),
+        [](const capture::option_change& a, const capture::option_change& b) { return a.time < b.time; });
+    std::stable_sort(_footer.notifications.begin(), _footer.notifications.end(),
+        [](const capture::recorded_notification& a, const capture::recorded_notification& b) { return a.time < b.time; });
+}
+
+snapshot_collection capture_reader::create_sensor_options(const capture::sensor_description& sensor, uint64_t time) const
+{
+    snapshot_collection sensor_extensions;
+    std::map<rs2_option, capture::option_value> values;
+    for (auto&& o : sensor.options)
+        values[o.id] = o;
+    for (auto&& c : _footer.option_changes)
+        if (c.sensor == sensor.index && c.time <= time)
+            values[c.option.id] = c.option;
+
+    auto options = std::make_shared<options_container>();
+    for (auto&& v : values)
+        options->register_option(v.first, std::make_shared<const_value_option>(v.second.description, v.second.value));
+    sensor_extensions[RS2_EXTENSION_OPTIONS] = options;
+
+    if (options->supports_option(RS2_OPTION_DEPTH_UNITS))
+    {
+        auto&& dpt_opt = options->get_option(RS2_OPTION_DEPTH_UNITS);
+        sensor_extensions[RS2_EXTENSION_DEPTH_SENSOR] = std::make_shared<depth_sensor_snapshot>(dpt_opt.query());
+
+        if (options->supports_option(RS2_OPTION_STEREO_BASELINE))
+        {
+            auto&& bl_opt = options->get_option(RS2_OPTION_STEREO_BASELINE);
+            sensor_extensions[RS2_EXTENSION_DEPTH_STEREO_SENSOR] = std::make_shared<depth_stereo_sensor_snapshot>(dpt_opt.query(), bl_opt.query());
+        }
+    }
+    return sensor_extensions;
+}
+
+device_snapshot capture_reader::create_device_description() const
+{
+    snapshot_collection device_extensions;
+    device_extensions[RS2_EXTENSION_INFO] = create_infos(_footer.infos);
+
+    std::vector<sensor_snapshot> sensors;
+    for (auto&& s : _footer.sensors)
+    {
+        auto sensor_extensions = create_sensor_options(s, 0);
+        sensor_extensions[RS2_EXTENSION_INFO] = create_infos(s.infos);
+        stream_profiles profiles;
+        for (auto&& p : s.profiles)
+            profiles.push_back(create_profile(p));
+        sensors.emplace_back(s.index, sensor_extensions, profiles);
+    }
+
+    std::map<stream_identifier, std::pair<uint32_t, rs2_extrinsics>> extrinsics;
+    for (auto&& s : _footer.streams)
+        if (s.has_extrinsics)
+            extrinsics[s.id] = std::make_pair(s.extrinsics_group, s.extrinsics);
+    return device_snapshot(device_extensions, sensors, extrinsics);
+}
+
+device_snapshot capture_reader::query_device_description(const nanoseconds& time)
+{
+    // The profiles are those of the initial description, with the options as they were at the time
+    auto description = _initial_description;
+    for (auto& sensor : description.get_sensors_snapshots())
+    {
+        auto it = std::find_if(_footer.sensors.begin(), _footer.sensors.end(),
+            [&sensor](const capture::sensor_description& s) { return s.index == sensor.get_sensor_index(); });
+        auto options = create_sensor_options(*it, time.count());
+        auto& sensor_extensions = sensor.get_sensor_extensions_snapshots();
+        for (auto&& snapshot : options.get_snapshots())
+            sensor_extensions[snapshot.first] = snapshot.second;
+    }
+    return description;
+}
+
+std::shared_ptr<serialized_data> capture_reader::create_frame(size_t stream, const capture::frame_record& record) const
+{
+    auto&& stream_id = _footer.streams[stream].id;
+    auto timestamp = nanoseconds(record.capture_time);
+    auto additional_data = net::get_additional_data(record.frame, record.metadata, std::min(record.frame.metadata_count, capture::max_metadata));
+    auto extension = static_cast<rs2_extension>(record.extension);
+    auto data = _mapping->data() + record.data_offset;
+
+    frame_interface* frame = nullptr;
+    std::shared_ptr<stream_profile_interface> temp_profile;
+    if (extension == RS2_EXTENSION_VIDEO_FRAME || extension == RS2_EXTENSION_DEPTH_FRAME)
+    {
+        frame = _source->alloc_frame(extension, 0, additional_data, false);
+        if (frame)
+        {
+            // The frame is the mapped data itself, which stays mapped until the frame is released
+            auto mapping = _mapping;
+            static_cast<video_frame*>(frame)->assign(record.frame.width, record.frame.height, record.frame.stride, record.frame.bpp);
+            frame->attach_continuation(frame_continuation{ [mapping]() {}, data });
+            temp_profile = std::make_shared<video_stream_profile>(platform::stream_profile{});
+        }
+    }
+    else if (extension == RS2_EXTENSION_MOTION_FRAME || extension == RS2_EXTENSION_POSE_FRAME)
+    {
+        // Motion and pose frames are read in place of their data, which they are copied from
+        frame = _source->alloc_frame(extension, record.frame.data_size, additional_data, true);
+        if (frame)
+        {
+            auto&& frame_data = static_cast<librealsense::frame*>(frame)->data;
+            std::copy(data, data + std::min<size_t>(record.frame.data_size, frame_data.size()), frame_data.begin());
+            if (extension == RS2_EXTENSION_MOTION_FRAME)
+                temp_profile = std::make_shared<motion_stream_profile>(platform::stream_profile{});
+            else
+                temp_profile = std::make_shared<stream_profile_base>(platform::stream_profile{});
+        }
+    }
+    else
+    {
+        throw io_exception(to_string() << "Frame " << record.frame.frame_number << " of " << stream_id << " is of unsupported type " << extension);
+    }
+
+    if (frame == nullptr)
+    {
+        LOG_WARNING("Failed to allocate new frame");
+        return std::make_shared<serialized_invalid_frame>(timestamp, stream_id);
+    }
+
+    //attaching a temp stream to the frame. Playback sensor should assign the real stream
+    frame->set_stream(temp_profile);
+    frame->get_stream()->set_stream_index(stream_id.stream_index);
+    frame->get_stream()->set_stream_type(stream_id.stream_type);
+    return std::make_shared<serialized_frame>(timestamp, stream_id, frame_holder{ frame });
+}
+
+std::shared_ptr<serialized_data> capture_reader::read_next_data()
+{
+    // The earliest of the next frames of the enabled streams, option change and notification
+    auto earliest = std::numeric_limits<uint64_t>::max();
+    size_t stream = _streams.size();
+    for (size_t i = 0; i < _streams.size(); ++i)
+    {
+        auto&& s = _streams[i];
+        if (s.enabled && s.next < s.records.size() && s.records[s.next]->capture_time < earliest)
+        {
+            earliest = s.records[s.next]->capture_time;
+            stream = i;
+        }
+    }
+
+    auto device_index = _footer.streams.empty() ? 0 : _footer.streams.front().id.device_index;
+    if (_streaming && _next_option_change < _footer.option_changes.size() && _footer.option_changes[_next_option_change].time < earliest)
+    {
+        auto&& c = _footer.option_changes[_next_option_change++];
+        _time = c.time;
+        LOG_DEBUG("Next data is an option");
+        return std::make_shared<serialized_option>(nanoseconds(c.time), sensor_identifier{ device_index, c.sensor }, c.option.id,
+                                                   std::make_shared<const_value_option>(c.option.description, c.option.value));
+    }
+
+    if (_streaming && _next_notification < _footer.notifications.size() && _footer.notifications[_next_notification].time < earliest)
+    {
+        auto&& n = _footer.notifications[_next_notification++];
+        _time = n.time;
+        LOG_DEBUG("Next data is a notification");
+        notification result(n.category, 0, n.severity, n.description);
+        result.timestamp = n.timestamp;
+        result.serialized_data = n.serialized_data;
+        return std::make_shared<serialized_notification>(nanoseconds(n.time), sensor_identifier{ device_index, n.sensor }, result);
+    }
+
+    if (stream == _streams.size())
+    {
+        LOG_DEBUG("End of file reached");
+        return std::make_shared<serialized_end_of_file>();
+    }
+
+    auto&& record = *_streams[stream].records[_streams[stream].next++];
+    _time = record.capture_time;
+    return create_frame(stream, record);
+}
+
+void capture_reader::move_to(uint64_t time)
+{
+    for (auto&& s : _streams)
+        s.next = std::lower_bound(s.records.begin(), s.records.end(), time,
+            [](const capture::frame_record* r, uint64_t t) { return r->capture_time < t; }) - s.records.begin();
+    _next_option_change = std::lower_bound(_footer.option_changes.begin(), _footer.option_changes.end(), time,
+        [](const capture::option_change& c, uint64_t t) { return c.time < t; }) - _footer.option_changes.begin();
+    _next_notification = std::lower_bound(_footer.notifications.begin(), _footer.notifications.end(), time,
+        [](const capture::recorded_notification& n, uint64_t t) { return n.time < t; }) - _footer.notifications.begin();
+    _time = time;
+}
+
+void capture_reader::seek_to_time(const nanoseconds& seek_time)
+{
+    if (seek_time.count() > _footer.duration)
+    {
+        throw invalid_value_exception(to_string() << "Requested time is out of playback length. (Requested = " << seek_time.count() << ", Duration = " << _footer.duration << ")");
+    }
+    move_to(seek_time.count());
+}
+
+nanoseconds capture_reader::query_duration() const
+{
+    return nanoseconds(_footer.duration);
+}
+
+void capture_reader::reset()
+{
+    _source = std::make_shared<frame_source>(32);
+    _source->init(_metadata_parsers);
+    for (auto&& s : _streams)
+        s.enabled = false;
+    _streaming = false;
+    move_to(0);
+}
+
+void capture_reader::enable_stream(const std::vector<stream_identifier>& stream_ids)
+{
+    for (auto&& id : stream_ids)
+    {
+        auto it = std::find_if(_footer.streams.begin(), _footer.streams.end(), [&id](const capture::stream_description& s) { return s.id == id; });
+        if (it == _footer.streams.end())
+            continue;
+
+        // A stream enabled while streaming starts from the time of the last data read
+        auto&& s = _streams[it - _footer.streams.begin()];
+        if (!s.enabled)
+        {
+            s.enabled = true;
+            s.next = std::lower_bound(s.records.begin(), s.records.end(), _time,
+                [](const capture::frame_record* r, uint64_t t) { return r->capture_time < t; }) - s.records.begin();
+        }
+    }
+    _streaming = true;
+}
+
+void capture_reader::disable_stream(const std::vector<stream_identifier>& stream_ids)
+{
+    for (auto&& id : stream_ids)
+    {
+        auto it = std::find_if(_footer.streams.begin(), _footer.streams.end(), [&id](const capture::stream_description& s) { return s.id == id; });
+        if (it != _footer.streams.end())
+            _streams[it - _footer.streams.begin()].enabled = false;
+    }
+}
+
+const std::string& capture_reader::get_file_name() const
+{
+    return _file;
+}
+
+std::vector<std::shared_ptr<serialized_data>> capture_reader::fetch_last_frames(const nanoseconds& seek_time)
+{
+    std::vector<std::shared_ptr<serialized_data>> result;
+    for (size_t i = 0; i < _streams.size(); ++i)
+    {
+        auto&& s = _streams[i];
+        if (!s.enabled)
+            continue;
+        auto last = std::upper_bound(s.records.begin(), s.records.end(), static_cast<uint64_t>(seek_time.count()),
+            [](uint64_t t, const capture::frame_record* r) { return t < r->capture_time; });
+        if (last != s.records.begin())
+            result.push_back(create_frame(i, **(last - 1)));
+    }
+    return result;
+}
+
+void capture_reader::register_codec(frame_codec_ptr codec)
+{
+    // Capture files hold raw frames only
+}
+
+bool capture_reader::set_mapped_read(bool mapped)
+{
+    // Capture files are always read through their mapping
+    return mapped;
+}
@@ -0,0 +1,87 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include "capture_format.h"
+#include "archive.h"
+
+namespace librealsense
+{
+    class frame_source;
+
+    namespace capture
+    {
+        // Read only mapping of a whole file, unmapped on destruction
+        class mapped_file
+        {
+        public:
+            explicit mapped_file(const std::string& file);
+            ~mapped_file();
+
+            const uint8_t* data() const { return _data; }
+            uint64_t size() const { return _size; }
+
+        private:
+            mapped_file(const mapped_file&) = delete;
+            mapped_file& operator=(const mapped_file&) = delete;
+
+            const uint8_t* _data = nullptr;
+            uint64_t _size = 0;
+#ifdef _WIN32
+            void* _file = nullptr;
+            void* _mapping = nullptr;
+#endif
+        };
+    }
+
+    // Plays a capture file through a mapping of it. Video frames are the mapped data itself, kept mapped while any of them
+    // is held, and the frames of the enabled streams, the option changes and the notifications are read in the order of
+    // their capture times, found from the index of the footer rather than by reading through the file
+    class capture_reader : public device_serializer::reader
+    {
+    public:
+        explicit capture_reader(const std::string& file);
+
+        device_serializer::device_snapshot query_device_description(const device_serializer::nanoseconds& time) override;
+        std::shared_ptr<device_serializer::serialized_data> read_next_data() override;
+        void seek_to_time(const device_serializer::nanoseconds& time) override;
+        device_serializer::nanoseconds query_duration() const override;
+        void reset() override;
+        void enable_stream(const std::vector<device_serializer::stream_identifier>& stream_ids) override;
+        void disable_stream(const std::vector<device_serializer::stream_identifier>& stream_ids) override;
+        const std::string& get_file_name() const override;
+        std::vector<std::shared_ptr<device_serializer::serialized_data>> fetch_last_frames(const device_serializer::nanoseconds& seek_time) override;
+        void register_codec(frame_codec_ptr codec) override;
+        bool set_mapped_read(bool mapped) override;
+
+    private:
+        struct stream_frames
+        {
+            // In the mapped file, in the order of their capture times
+            std::vector<const capture::frame_record*> records;
+            size_t next = 0;
+            bool enabled = false;
+        };
+
+        void index_chunks();
+        device_serializer::snapshot_collection create_sensor_options(const capture::sensor_description& sensor, uint64_t time) const;
+        device_serializer::device_snapshot create_device_description() const;
+        std::shared_ptr<device_serializer::serialized_data> create_frame(size_t stream, const capture::frame_record& record) const;
+        // Moves the next data of every stream, and the next option change and notification, to the first at the time or after
+        void move_to(uint64_t time);
+
+        const std::string _file;
+        std::shared_ptr<capture::mapped_file> _mapping;
+        capture::footer _footer;
+        std::vector<stream_frames> _streams;
+        size_t _next_option_change;
+        size_t _next_notification;
+        // Option changes and notifications are read once streaming starts
+        bool _streaming;
+        // Of the last data read
+        uint64_t _time;
+        std::shared_ptr<metadata_parser_map> _metadata_parsers;
+        std::shared_ptr<frame_source> _source;
+        device_serializer::device_snapshot _initial_description;
+    };
+}
@@ -0,0 +1,357 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include "capture_writer.h"
+#include "archive.h"
+#include "stream.h"
+
+#include <algorithm>
+
+using namespace librealsense;
+using namespace device_serializer;
+
+static std::vector<std::pair<rs2_camera_info, std::string>> describe_infos(const std::shared_ptr<extension_snapshot>& snapshot)
+{
+    std::vector<std::pair<rs2_camera_info, std::string>> infos;
+    auto info = As<info_interface>(snapshot);
+    if (!info)
+        return infos;
+    for (int i = 0; i < RS2_CAMERA_INFO_COUNT; ++i)
+        if (info->supports_info(static_cast<rs2_camera_info>(i)))
+            infos.emplace_back(static_cast<rs2_camera_info>(i), info->get_info(static_cast<rs2_camera_info>(i)));
+    return infos;
+}
+
+static std::vector<capture::option_value> describe_options(const std::shared_ptr<extension_snapshot>& snapshot, uint32_t sensor_index)
+{
+    std::vector<capture::option_value> values;
+    auto options = As<options_interface>(snapshot);
+    if (!options)
+        return values;
+    for (int i = 0; i < static_cast<int>(RS2_OPTION_COUNT); i++)
+    {
+        auto id = static_cast<rs2_option>(i);
+        try
+        {
+            if (!options->supports_option(id))
+                continue;
+            auto&& option = options->get_option(id);
+            auto description = option.get_description();
+            values.push_back({ id, option.query(), description ? std::string(description) : (to_string() << "Read only option of " << id) });
+        }
+        catch (const std::exception& e)
+        {
+            LOG_WARNING("Failed to get option " << id << " of sensor " << sensor_index << ". Exception: " << e.what());
+        }
+    }
+    return values;
+}
+
+capture_writer::capture_writer(const std::string& file) :
+    _file(file),
+    _out(file, std::ios::binary | std::ios::trunc),
+    _offset(0),
+    _pending_size(0)
+{
+    if (!_out)
+    {
+        throw io_exception(to_string() << "Failed to create capture file \"" << file << "\"");
+    }
+    capture::file_header header{ capture::file_magic, capture::file_version };
+    write(&header, sizeof(header));
+    pad_to(capture::chunk_alignment);
+}
+
+capture_writer::~capture_writer()
+{
+    try
+    {
+        for (size_t i = 0; i < _pending.size(); ++i)
+            write_chunk(i);
+        write_footer();
+    }
+    catch (const std::exception& e)
+    {
+        LOG_ERROR("Failed to complete capture file " << _file << ": " << e.what());
+    }
+}
+
+void capture_writer::write(const void* data, size_t size)
+{
+    _out.write(reinterpret_cast<const char*>(data), size);
+    if (!_out)
+    {
+        throw io_exception(to_string() << "Failed to write to capture file \"" << _file << "\"");
+    }
+    _offset += size;
+}
+
+void capture_writer::pad_to(uint64_t offset)
+{
+    static const uint8_t zeros[capture::chunk_alignment] = {};
+    while (_offset < offset)
+        write(zeros, static_cast<size_t>(std::min<uint64_t>(offset - _offset, sizeof(zeros))));
+}
+
+void capture_writer::update_duration(const nanoseconds& timestamp)
+{
+    _footer.duration = std::max<uint64_t>(_footer.duration, timestamp.count());
+}
+
+capture::sensor_description& capture_writer::get_sensor(uint32_t index)
+{
+    auto it = std::find_if(_footer.sensors.begin(), _footer.sensors.end(), [index](const capture::sensor_description& s) { return s.index == index; });
+    if (it != _footer.sensors.end())
+        return *it;
+    _footer.sensors.push_back({ index, {}, {}, {} });
+    return _footer.sensors.back();
+}
+
+void capture_writer::record_profile(capture::sensor_description& sensor, const std::shared_ptr<stream_profile_interface>& profile)
+{
+    if (!profile)
+        return;
+
+    capture::profile_description d{};
+    d.stream = profile->get_stream_type();
+    d.index = static_cast<uint32_t>(profile->get_stream_index());
+    d.format = profile->get_format();
+    d.fps = profile->get_framerate();
+    d.tag = profile->get_tag();
+    if (auto video = As<video_stream_profile_interface>(profile))
+    {
+        d.type = RS2_EXTENSION_VIDEO_PROFILE;
+        d.width = video->get_width();
+        d.height = video->get_height();
+        try
+        {
+            d.intrinsics = video->get_intrinsics();
+        }
+        catch (...)
+        {
+            LOG_ERROR("Error trying to get intrinsc data for stream " << d.stream << ", " << d.index);
+        }
+    }
+    else if (auto motion = As<motion_stream_profile_interface>(profile))
+    {
+        d.type = RS2_EXTENSION_MOTION_PROFILE;
+        try
+        {
+            d.motion_intrinsics = motion->get_intrinsics();
+        }
+        catch (...)
+        {
+            LOG_ERROR("Error trying to get intrinsc data for stream " << d.stream << ", " << d.index);
+        }
+    }
+    else
+    {
+        d.type = RS2_EXTENSION_POSE_PROFILE;
+    }
+
+    // A stream is described by the last profile it was recorded with
+    auto it = std::find_if(sensor.profiles.begin(), sensor.profiles.end(),
+        [&d](const capture::profile_description& p) { return p.stream == d.stream && p.index == d.index; });
+    if (it != sensor.profiles.end())
+        *it = d;
+    else
+        sensor.profiles.push_back(d);
+}
+
+size_t capture_writer::get_stream(const stream_identifier& stream_id, frame_interface* frame)
+{
+    auto it = std::find_if(_footer.streams.begin(), _footer.streams.end(), [&stream_id](const capture::stream_description& s) { return s.id == stream_id; });
+    if (it != _footer.streams.end())
+        return it - _footer.streams.begin();
+
+    capture::stream_description s{};
+    s.id = stream_id;
+    try
+    {
+        auto& dev = frame->get_sensor()->get_device();
+        std::tie(s.extrinsics_group, s.extrinsics) = dev.get_extrinsics(*frame->get_stream());
+        s.has_extrinsics = true;
+    }
+    catch (const std::exception& e)
+    {
+        LOG_WARNING("Failed to get stream extrinsics for " << stream_id << ". Exception: " << e.what());
+    }
+    _footer.streams.push_back(s);
+    _pending.emplace_back();
+    return _footer.streams.size() - 1;
+}
+
+void capture_writer::write_device_description(const device_snapshot& device_description)
+{
+    _footer.infos = describe_infos(device_description.get_device_extensions_snapshots().find(RS2_EXTENSION_INFO));
+    for (auto&& sensor_snapshot : device_description.get_sensors_snapshots())
+    {
+        auto&& extensions = sensor_snapshot.get_sensor_extensions_snapshots();
+        auto& sensor = get_sensor(sensor_snapshot.get_sensor_index());
+        sensor.infos = describe_infos(extensions.find(RS2_EXTENSION_INFO));
+        sensor.options = describe_options(extensions.find(RS2_EXTENSION_OPTIONS), sensor.index);
+        for (auto&& profile : sensor_snapshot.get_stream_profiles())
+            record_profile(sensor, profile);
+    }
+}
+
+void capture_writer::write_frame(const stream_identifier& stream_id, const nanoseconds& timestamp, frame_holder&& frame)
+{
+    write_compressed_frame(stream_id, timestamp, std::move(frame), {});
+}
+
+compressed_payload capture_writer::compress_frame(const frame_interface& frame, rs2_record_compression compression) const
+{
+    return {};
+}
+
+compressed_payload capture_writer::encode_frame(const frame_interface& frame, rs2_frame_codec& codec) const
+{
+    return {};
+}
+
+void capture_writer::write_compressed_frame(const stream_identifier& stream_id, const nanoseconds& timestamp, frame_holder&& frame, compressed_payload&& payload)
+{
+    if (!frame)
+        return;
+
+    capture::frame_record record{};
+    const byte* data = nullptr;
+    auto f = frame.frame;
+    if (auto vid_frame = dynamic_cast<video_frame*>(f))
+    {
+        record.extension = Is<depth_frame>(f) ? RS2_EXTENSION_DEPTH_FRAME : RS2_EXTENSION_VIDEO_FRAME;
+        record.frame.width = vid_frame->get_width();
+        record.frame.height = vid_frame->get_height();
+        record.frame.stride = vid_frame->get_stride();
+        record.frame.bpp = vid_frame->get_bpp();
+        record.frame.data_size = static_cast<uint32_t>(static_cast<size_t>(vid_frame->get_stride()) * vid_frame->get_height());
+        data = vid_frame->get_frame_data();
+    }
+    else if (Is<motion_frame>(f) || Is<pose_frame>(f))
+    {
+        auto raw = static_cast<librealsense::frame*>(f);
+        record.extension = Is<motion_frame>(f) ? RS2_EXTENSION_MOTION_FRAME : RS2_EXTENSION_POSE_FRAME;
+        record.frame.data_size = static_cast<uint32_t>(raw->data.size());
+        data = raw->get_frame_data();
+    }
+    else
+    {
+        LOG_WARNING("Frame of " << stream_id << " is not of a type capture files hold");
+        return;
+    }
+
+    record.capture_time = timestamp.count();
+    record.frame.sensor = stream_id.sensor_index;
+    record.frame.codec = static_cast<uint32_t>(net::codec::raw);
+    record.frame.timestamp = f->get_frame_timestamp();
+    record.frame.domain = static_cast<uint32_t>(f->get_frame_timestamp_domain());
+    record.frame.frame_number = f->get_frame_number();
+    for (int i = 0; i < RS2_FRAME_METADATA_COUNT && record.frame.metadata_count < capture::max_metadata; ++i)
+    {
+        auto key = static_cast<rs2_frame_metadata_value>(i);
+        if (f->supports_frame_metadata(key))
+            record.metadata[record.frame.metadata_count++] = { static_cast<uint32_t>(i), f->get_frame_metadata(key) };
+    }
+
+    auto stream = get_stream(stream_id, f);
+    auto& chunk = _pending[stream];
+    auto offset = capture::align(chunk.data.size(), capture::data_alignment);
+    record.data_offset = offset;
+    _pending_size += offset + record.frame.data_size - chunk.data.size() + sizeof(record);
+    chunk.data.resize(static_cast<size_t>(offset) + record.frame.data_size);
+    std::copy(data, data + record.frame.data_size, chunk.data.begin() + static_cast<size_t>(offset));
+    chunk.records.push_back(record);
+    update_duration(timestamp);
+
+    if (chunk.records.size() >= capture::max_chunk_frames || chunk.data.size() >= capture::max_chunk_data)
+        write_chunk(stream);
+}
+
+void capture_writer::write_chunk(size_t stream)
+{
+    auto& chunk = _pending[stream];
+    if (chunk.records.empty())
+        return;
+
+    auto chunk_offset = _offset;
+    capture::chunk_header header{ static_cast<uint32_t>(stream), static_cast<uint32_t>(chunk.records.size()) };
+    auto records_size = chunk.records.size() * sizeof(capture::frame_record);
+    auto data_offset = capture::align(chunk_offset + sizeof(header) + records_size, capture::data_alignment);
+    for (auto&& record : chunk.records)
+        record.data_offset += data_offset;
+
+    write(&header, sizeof(header));
+    write(chunk.records.data(), records_size);
+    pad_to(data_offset);
+    write(chunk.data.data(), chunk.data.size());
+    pad_to(capture::align(_offset, capture::chunk_alignment));
+
+    _footer.chunks.push_back({ chunk_offset, header.stream, header.frame_count, chunk.records.front().capture_time, chunk.records.back().capture_time });
+    chunk.records.clear();
+    chunk.data.clear();
+    _pending_size = 0;
+    for (auto&& pending : _pending)
+        _pending_size += pending.data.size() + pending.records.size() * sizeof(capture::frame_record);
+}
+
+void capture_writer::write_footer()
+{
+    net::writer w;
+    capture::write_footer(w, _footer);
+    capture::file_trailer trailer{ _offset, static_cast<uint64_t>(w.data().size()), capture::file_magic };
+    write(w.data().data(), w.data().size());
+    write(&trailer, sizeof(trailer));
+    _out.close();
+}
+
+void capture_writer::write_snapshot(uint32_t device_index, const nanoseconds& timestamp, rs2_extension type, const std::shared_ptr<extension_snapshot>& snapshot)
+{
+    if (type == RS2_EXTENSION_INFO)
+        _footer.infos = describe_infos(snapshot);
+}
+
+void capture_writer::write_snapshot(const sensor_identifier& sensor_id, const nanoseconds& timestamp, rs2_extension type, const std::shared_ptr<extension_snapshot>& snapshot)
+{
+    auto& sensor = get_sensor(sensor_id.sensor_index);
+    switch (type)
+    {
+    case RS2_EXTENSION_INFO:
+        sensor.infos = describe_infos(snapshot);
+        break;
+    case RS2_EXTENSION_OPTIONS:
+        for (auto&& option : describe_options(snapshot, sensor.index))
+            _footer.option_changes.push_back({ static_cast<uint64_t>(timestamp.count()), sensor.index, option });
+        update_duration(timestamp);
+        break;
+    case RS2_EXTENSION_VIDEO_PROFILE:
+    case RS2_EXTENSION_MOTION_PROFILE:
+    case RS2_EXTENSION_POSE_PROFILE:
+        record_profile(sensor, As<stream_profile_interface>(snapshot));
+        break;
+    case RS2_EXTENSION_DEBUG:
+    case RS2_EXTENSION_VIDEO:
+    case RS2_EXTENSION_ROI:
+    case RS2_EXTENSION_DEPTH_SENSOR:
+    case RS2_EXTENSION_DEPTH_STEREO_SENSOR:
+        break;
+    default:
+        throw invalid_value_exception(to_string() << "Failed to Write Extension Snapshot: Unsupported extension \"" << librealsense::get_string(type) << "\"");
+    }
+}
+
+void capture_writer::write_notification(const sensor_identifier& sensor_id, const nanoseconds& timestamp, const notification& n)
+{
+    _footer.notifications.push_back({ static_cast<uint64_t>(timestamp.count()), sensor_id.sensor_index, n.category, n.severity, n.description, n.serialized_data, n.timestamp });
+    update_duration(timestamp);
+}
+
+const std::string& capture_writer::get_file_name() const
+{
+    return _file;
+}
+
+uint64_t capture_writer::get_written_size() const
+{
+    return _offset + _pending_size;
+}
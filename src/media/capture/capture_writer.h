@@ -0,0 +1,57 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include "capture_format.h"
+
+#include <fstream>
+
+namespace librealsense
+{
+    // Records to a capture file. Frames are written raw, neither compressed nor encoded, for them to play back in place
+    // from the mapped file, and are held per stream until they fill a chunk. The footer is written when the writer is
+    // destroyed, and the file does not play before
+    class capture_writer : public device_serializer::writer
+    {
+    public:
+        explicit capture_writer(const std::string& file);
+        ~capture_writer();
+
+        void write_device_description(const device_serializer::device_snapshot& device_description) override;
+        void write_frame(const device_serializer::stream_identifier& stream_id, const device_serializer::nanoseconds& timestamp, frame_holder&& frame) override;
+        device_serializer::compressed_payload compress_frame(const frame_interface& frame, rs2_record_compression compression) const override;
+        device_serializer::compressed_payload encode_frame(const frame_interface& frame, rs2_frame_codec& codec) const override;
+        void write_compressed_frame(const device_serializer::stream_identifier& stream_id, const device_serializer::nanoseconds& timestamp, frame_holder&& frame, device_serializer::compressed_payload&& payload) override;
+        void write_snapshot(uint32_t device_index, const device_serializer::nanoseconds& timestamp, rs2_extension type, const std::shared_ptr<extension_snapshot>& snapshot) override;
+        void write_snapshot(const device_serializer::sensor_identifier& sensor_id, const device_serializer::nanoseconds& timestamp, rs2_extension type, const std::shared_ptr<extension_snapshot>& snapshot) override;
+        void write_notification(const device_serializer::sensor_identifier& sensor_id, const device_serializer::nanoseconds& timestamp, const notification& n) override;
+        const std::string& get_file_name() const override;
+        uint64_t get_written_size() const override;
+
+    private:
+        // Frames of a stream not written yet, their data at offsets from the end of their records
+        struct pending_chunk
+        {
+            std::vector<capture::frame_record> records;
+            std::vector<uint8_t> data;
+        };
+
+        size_t get_stream(const device_serializer::stream_identifier& stream_id, frame_interface* frame);
+        capture::sensor_description& get_sensor(uint32_t index);
+        void record_profile(capture::sensor_description& sensor, const std::shared_ptr<stream_profile_interface>& profile);
+        void update_duration(const device_serializer::nanoseconds& timestamp);
+
+        void write_chunk(size_t stream);
+        void write_footer();
+        void write(const void* data, size_t size);
+        void pad_to(uint64_t offset);
+
+        const std::string _file;
+        std::ofstream _out;
+        uint64_t _offset;
+        uint64_t _pending_size;
+        capture::footer _footer;
+        // Of the streams of the footer
+        std::vector<pending_chunk> _pending;
+    };
+}
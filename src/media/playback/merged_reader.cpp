@@ -0,0 +1,218 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include "merged_reader.h"
+
+using namespace librealsense;
+using namespace device_serializer;
+
+// The extrinsics groups of a file are numbered apart from those of the files before it
+static const uint32_t extrinsics_groups_per_file = 1 << 16;
+
+merged_reader::merged_reader(std::vector<std::shared_ptr<reader>> readers)
+{
+    if (readers.empty())
+    {
+        throw invalid_value_exception("No files to merge");
+    }
+
+    std::vector<std::string> files;
+    uint32_t sensors = 0;
+    for (auto&& r : readers)
+    {
+        if (r == nullptr)
+        {
+            throw invalid_value_exception("null reader");
+        }
+        _sources.push_back({ r, sensors, nullptr, false });
+        sensors += static_cast<uint32_t>(r->query_device_description(nanoseconds(0)).get_sensors_snapshots().size());
+        files.push_back(r->get_file_name());
+    }
+    _name = merged_name(files);
+}
+
+std::string merged_reader::merged_name(const std::vector<std::string>& files)
+{
+    std::string name;
+    for (auto&& f : files)
+        name += (name.empty() ? "" : "|") + f;
+    return name;
+}
+
+device_snapshot merged_reader::query_device_description(const nanoseconds& time)
+{
+    snapshot_collection device_extensions;
+    std::vector<sensor_snapshot> sensors;
+    std::map<stream_identifier, std::pair<uint32_t, rs2_extrinsics>> extrinsics;
+    for (size_t i = 0; i < _sources.size(); i++)
+    {
+        auto& s = _sources[i];
+        auto description = s.reader->query_device_description(std::min(time, s.reader->query_duration()));
+        if (i == 0)
+            device_extensions = description.get_device_extensions_snapshots();
+
+        for (auto&& sensor : description.get_sensors_snapshots())
+            sensors.emplace_back(sensor.get_sensor_index() + s.first_sensor, sensor.get_sensor_extensions_snapshots(), sensor.get_stream_profiles());
+
+        for (auto&& e : description.get_extrinsics_map())
+        {
+            auto id = e.first;
+            id.sensor_index += s.first_sensor;
+            extrinsics[id] = { e.second.first + static_cast<uint32_t>(i) * extrinsics_groups_per_file, e.second.second };
+        }
+    }
+    return device_snapshot(device_extensions, sensors, extrinsics);
+}
+
+void merged_reader::to_merged(const source& s, serialized_data& data) const
+{
+    if (auto frame = data.as<serialized_frame>())
+        frame->stream_id.sensor_index += s.first_sensor;
+    else if (data.is<serialized_invalid_frame>())
+        static_cast<serialized_invalid_frame&>(data).stream_id.sensor_index += s.first_sensor;
+    else if (auto option = data.as<serialized_option>())
+        option->sensor_id.sensor_index += s.first_sensor;
+    else if (auto notification = data.as<serialized_notification>())
+        notification->sensor_id.sensor_index += s.first_sensor;
+}
+
+std::shared_ptr<serialized_data> merged_reader::read_next_data()
+{
+    // The earliest of the data the files have next, one read ahead per file, so every file is read in its own order
+    source* earliest = nullptr;
+    for (auto&& s : _sources)
+    {
+        if (!s.next && !s.end_of_file)
+        {
+            s.next = s.reader->read_next_data();
+            if (s.next->is<serialized_end_of_file>())
+            {
+                s.next = nullptr;
+                s.end_of_file = true;
+                continue;
+            }
+            to_merged(s, *s.next);
+        }
+        if (s.next && (!earliest || s.next->get_timestamp() < earliest->next->get_timestamp()))
+            earliest = &s;
+    }
+
+    if (!earliest)
+        return std::make_shared<serialized_end_of_file>();
+
+    auto res = earliest->next;
+    earliest->next = nullptr;
+    return res;
+}
+
+void merged_reader::drop_pending()
+{
+    for (auto&& s : _sources)
+    {
+        s.next = nullptr;
+        s.end_of_file = false;
+    }
+}
+
+void merged_reader::seek_to_time(const nanoseconds& time)
+{
+    // Files shorter than the time are left at their end
+    for (auto&& s : _sources)
+        s.reader->seek_to_time(std::min(time, s.reader->query_duration()));
+    drop_pending();
+}
+
+nanoseconds merged_reader::query_duration() const
+{
+    nanoseconds duration(0);
+    for (auto&& s : _sources)
+        duration = std::max(duration, s.reader->query_duration());
+    return duration;
+}
+
+void merged_reader::reset()
+{
+    for (auto&& s : _sources)
+        s.reader->reset();
+    drop_pending();
+}
+
+std::vector<std::vector<stream_identifier>> merged_reader::to_sources(const std::vector<stream_identifier>& stream_ids) const
+{
+    std::vector<std::vector<stream_identifier>> res(_sources.size());
+    for (auto id : stream_ids)
+    {
+        auto i = _sources.size() - 1;
+        while (i > 0 && id.sensor_index < _sources[i].first_sensor)
+            i--;
+        id.sensor_index -= _sources[i].first_sensor;
+        res[i].push_back(id);
+    }
+    return res;
+}
+
+void merged_reader::enable_stream(const std::vector<stream_identifier>& stream_ids)
+{
+    // The data a file has next is still of an enabled stream, while the file may have more past its end
+    auto ids = to_sources(stream_ids);
+    for (size_t i = 0; i < _sources.size(); i++)
+    {
+        if (ids[i].empty())
+            continue;
+        _sources[i].reader->enable_stream(ids[i]);
+        _sources[i].end_of_file = false;
+    }
+}
+
+void merged_reader::disable_stream(const std::vector<stream_identifier>& stream_ids)
+{
+    auto ids = to_sources(stream_ids);
+    for (size_t i = 0; i < _sources.size(); i++)
+    {
+        auto& s = _sources[i];
+        if (ids[i].empty())
+            continue;
+        s.reader->disable_stream(ids[i]);
+
+        if (auto frame = s.next ? s.next->as<serialized_frame>() : nullptr)
+        {
+            auto id = frame->stream_id;
+            id.sensor_index -= s.first_sensor;
+            if (std::find(ids[i].begin(), ids[i].end(), id) != ids[i].end())
+                s.next = nullptr;
+        }
+    }
+}
+
+const std::string& merged_reader::get_file_name() const
+{
+    return _name;
+}
+
+std::vector<std::shared_ptr<serialized_data>> merged_reader::fetch_last_frames(const nanoseconds& seek_time)
+{
+    std::vector<std::shared_ptr<serialized_data>> res;
+    for (auto&& s : _sources)
+    {
+        for (auto&& data : s.reader->fetch_last_frames(std::min(seek_time, s.reader->query_duration())))
+        {
+            to_merged(s, *data);
+            res.push_back(data);
+        }
+    }
+    return res;
+}
+
+void merged_reader::register_codec(frame_codec_ptr codec)
+{
+    for (auto&& s : _sources)
+        s.reader->register_codec(codec);
+}
+
+bool merged_reader::set_mapped_read(bool mapped)
+{
+    auto res = true;
+    for (auto&& s : _sources)
+        res = s.reader->set_mapped_read(mapped) && res;
+    return res;
+}
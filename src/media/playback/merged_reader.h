@@ -0,0 +1,51 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <core/serialization.h>
+
+namespace librealsense
+{
+    // Reads the files of the devices of a recording as a single device, the data of all of them in the order of a common
+    // timeline, for one playback to read them, seek, pause and play them together. The timelines of the files are aligned at
+    // their starts, the starts of their recordings. The sensors of a file follow those of the files before it, and its
+    // extrinsics groups are kept apart from theirs. The device info is that of the first file
+    class merged_reader : public device_serializer::reader
+    {
+    public:
+        explicit merged_reader(std::vector<std::shared_ptr<device_serializer::reader>> readers);
+
+        device_serializer::device_snapshot query_device_description(const device_serializer::nanoseconds& time) override;
+        std::shared_ptr<device_serializer::serialized_data> read_next_data() override;
+        void seek_to_time(const device_serializer::nanoseconds& time) override;
+        device_serializer::nanoseconds query_duration() const override;
+        void reset() override;
+        void enable_stream(const std::vector<device_serializer::stream_identifier>& stream_ids) override;
+        void disable_stream(const std::vector<device_serializer::stream_identifier>& stream_ids) override;
+        const std::string& get_file_name() const override;
+        std::vector<std::shared_ptr<device_serializer::serialized_data>> fetch_last_frames(const device_serializer::nanoseconds& seek_time) override;
+        void register_codec(frame_codec_ptr codec) override;
+        bool set_mapped_read(bool mapped) override;
+
+        // The name of the files of a merged reader, as get_file_name returns it
+        static std::string merged_name(const std::vector<std::string>& files);
+
+    private:
+        struct source
+        {
+            std::shared_ptr<device_serializer::reader> reader;
+            uint32_t first_sensor;
+            std::shared_ptr<device_serializer::serialized_data> next;  // Read from the file, not yet returned
+            bool end_of_file;
+        };
+
+        // The data of a file with the sensor indices of the merged device
+        void to_merged(const source& s, device_serializer::serialized_data& data) const;
+        // The stream ids of the merged device, of the file they belong to, with the sensor indices of that file
+        std::vector<std::vector<device_serializer::stream_identifier>> to_sources(const std::vector<device_serializer::stream_identifier>& stream_ids) const;
+        void drop_pending();
+
+        std::vector<source> _sources;
+        std::string _name;
+    };
+}
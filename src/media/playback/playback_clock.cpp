@@ -0,0 +1,67 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include "playback_clock.h"
+
+#include <cmath>
+#include <thread>
+
+namespace librealsense
+{
+    const std::chrono::microseconds playback_clock::spin_window(1000);
+
+    bool playback_clock::wait_until(dispatcher::cancellable_timer& timer, clock::time_point deadline)
+    {
+        if (!timer.try_sleep_until(deadline - spin_window))
+            return false;
+
+        while (clock::now() < deadline)
+            std::this_thread::yield();
+        return true;
+    }
+
+    void playback_clock::record(rs2_stream stream, int index, clock::duration lateness)
+    {
+        auto us = std::chrono::duration<double, std::micro>(lateness).count();
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto& s = _statistics[std::make_pair(stream, index)];
+        s.max = s.frames ? std::max(s.max, us) : us;
+        s.frames++;
+        s.sum += us;
+        s.sum_of_squares += us * us;
+    }
+
+    rs2_playback_jitter playback_clock::get_jitter(rs2_stream stream, int index) const
+    {
+        statistics total;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            for (auto&& s : _statistics)
+            {
+                if ((stream != RS2_STREAM_ANY && s.first.first != stream) || (index != -1 && s.first.second != index))
+                    continue;
+                total.max = total.frames ? std::max(total.max, s.second.max) : s.second.max;
+                total.frames += s.second.frames;
+                total.sum += s.second.sum;
+                total.sum_of_squares += s.second.sum_of_squares;
+            }
+        }
+
+        rs2_playback_jitter res{};
+        res.frames = total.frames;
+        if (total.frames)
+        {
+            res.mean_lateness_us = total.sum / total.frames;
+            res.stddev_lateness_us = std::sqrt(std::max(0., total.sum_of_squares / total.frames - res.mean_lateness_us * res.mean_lateness_us));
+            res.max_lateness_us = total.max;
+        }
+        return res;
+    }
+
+    void playback_clock::reset()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _statistics.clear();
+    }
+}
@@ -0,0 +1,45 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include "concurrency.h"
+#include "../include/librealsense2/h/rs_record_playback.h"
+
+#include <chrono>
+#include <map>
+#include <mutex>
+
+namespace librealsense
+{
+    // The clock the streams of a playback are published by in real time mode, shared by their dispatchers, and the lateness of the
+    // frames against it. The timed waits of the OS wake up late by up to their granularity, so a wait ends spinning over its last
+    // spin_window, and the reading thread wakes up that much before the frame is due for its dispatcher to make the final wait.
+    // The waits block the thread they are made on, so the dispatchers of a playback are threads of their own
+    class playback_clock
+    {
+    public:
+        typedef std::chrono::steady_clock clock;
+        static const std::chrono::microseconds spin_window;
+
+        // Waits for the deadline, returning false when the dispatcher of the timer was stopped meanwhile
+        static bool wait_until(dispatcher::cancellable_timer& timer, clock::time_point deadline);
+
+        // Of a frame published in real time mode, the lateness past the time it was due
+        void record(rs2_stream stream, int index, clock::duration lateness);
+        // Of the frames of a stream since the last reset, RS2_STREAM_ANY and -1 for all streams and all indices
+        rs2_playback_jitter get_jitter(rs2_stream stream, int index) const;
+        void reset();
+
+    private:
+        struct statistics
+        {
+            unsigned long long frames = 0;
+            double sum = 0;
+            double sum_of_squares = 0;
+            double max = 0;
+        };
+
+        mutable std::mutex _mutex;
+        std::map<std::pair<rs2_stream, int>, statistics> _statistics;
+    };
+}
@@ -26,7 +26,8 @@ playback_device::playback_device(std::shared_ptr<context> ctx, std::shared_ptr<d
         throw invalid_value_exception("null serializer");
     }
 
-    m_reader = serializer;
+    m_prefetching_reader = std::make_shared<prefetching_reader>(serializer);
+    m_reader = m_prefetching_reader;
     (*m_read_thread)->start();
 
     //Read header and build device from recorded device snapshot
@@ -241,9 +242,9 @@ void playback_device::seek_to_time(std::chrono::nanoseconds time)
                     }
                     //push frame to the sensor (see handle_frame definition for more details)
                     m_sensors.at(frame->stream_id.sensor_index)->handle_frame(std::move(frame->frame), m_real_time,
-                        []() { return device_serializer::nanoseconds(0); },
+                        []() { return playback_clock::clock::now(); },
                         []() { return false; },
-                        [this, time]()
+                        [this, time](playback_clock::clock::duration)
                         {
                             std::lock_guard<std::mutex> locker(m_last_published_timestamp_mutex);
                             m_last_published_timestamp = time;
@@ -339,7 +340,7 @@ void playback_device::resume()
 
 void playback_device::set_real_time(bool real_time)
 {
-    LOG_INFO("Set real time to " << (real_time) ? "True" : "False");
+    LOG_INFO("Set real time to " << (real_time ? "True" : "False"));
     m_real_time = real_time;
 }
 
@@ -348,6 +349,38 @@ bool playback_device::is_real_time() const
     return m_real_time;
 }
 
+void playback_device::register_codec(frame_codec_ptr codec)
+{
+    LOG_INFO("Register codec \"" << codec->get_name() << "\"");
+    m_reader->register_codec(codec);
+}
+
+void playback_device::set_read_ahead(size_t count)
+{
+    LOG_INFO("Set read ahead to " << count);
+    m_prefetching_reader->set_read_ahead(count);
+}
+
+bool playback_device::set_mapped_read(bool mapped)
+{
+    auto result = m_reader->set_mapped_read(mapped);
+    if (!result)
+        LOG_WARNING("Failed to map " << get_file_name() << ", reading it through system calls");
+    return result;
+}
+
+rs2_playback_jitter playback_device::get_jitter(rs2_stream stream, int index) const
+{
+    return m_clock.get_jitter(stream, index);
+}
+
+void playback_device::set_parallel_decode(bool parallel)
+{
+    LOG_INFO("Set parallel decode to " << parallel);
+    for (auto&& s : m_sensors)
+        s.second->set_parallel_decode(parallel);
+}
+
 platform::backend_device_group playback_device::get_device_data() const
 {
     return platform::backend_device_group({ platform::playback_device_info{ m_reader->get_file_name() } });
@@ -365,7 +398,7 @@ bool playback_device::is_valid() const
 
 void playback_device::update_time_base(device_serializer::nanoseconds base_timestamp)
 {
-    m_base_sys_time = std::chrono::high_resolution_clock::now();
+    m_base_sys_time = playback_clock::clock::now();
     m_base_timestamp = base_timestamp;
     LOG_DEBUG("Updating Time Base... m_base_sys_time " << m_base_sys_time.time_since_epoch().count() << " m_base_timestamp " << m_base_timestamp.count());
 }
@@ -376,7 +409,7 @@ device_serializer::nanoseconds playback_device::calc_sleep_time(device_serialize
         return device_serializer::nanoseconds(0);
     //The time to sleep returned here equals to the difference between the file recording time
     // and the playback time.
-    auto now = std::chrono::high_resolution_clock::now();
+    auto now = playback_clock::clock::now();
     auto play_time = now - m_base_sys_time;
     if(timestamp < m_base_timestamp)
     {
@@ -399,6 +432,16 @@ device_serializer::nanoseconds playback_device::calc_sleep_time(device_serialize
     return sleep_time;
 }
 
+playback_clock::clock::time_point playback_device::calc_deadline(device_serializer::nanoseconds timestamp) const
+{
+    auto rate = m_sample_rate.load();
+    if (!m_real_time || rate <= 0 || timestamp < m_base_timestamp)
+        return playback_clock::clock::now();
+
+    auto recorded_time = std::chrono::duration_cast<device_serializer::nanoseconds>((timestamp - m_base_timestamp) / rate);
+    return m_base_sys_time + std::chrono::duration_cast<playback_clock::clock::duration>(recorded_time);
+}
+
 void playback_device::start()
 {
     //Start reading from the file
@@ -414,6 +457,7 @@ void playback_device::start()
         return; //nothing to do
 
     m_is_started = true;
+    m_clock.reset();
     catch_up();
     try_looping();
     LOG_INFO("Playback started");
@@ -558,10 +602,11 @@ void playback_device::try_looping()
             auto sleep_time = calc_sleep_time(timestamp);
             if (sleep_time.count() > 0)
             {
-                if (m_sample_rate > 0)
+                // The dispatcher of the frame makes the final, precise wait
+                if (m_sample_rate > 0 && sleep_time > playback_clock::spin_window)
                 {
                     LOG_DEBUG("Sleeping for: " << (sleep_time.count() * 1e-6));
-                    std::this_thread::sleep_for(sleep_time);
+                    std::this_thread::sleep_for(sleep_time - playback_clock::spin_window);
                 }
             }
         }
@@ -583,11 +628,15 @@ void playback_device::try_looping()
                 return true;
             }
             //Dispatch frame to the relevant sensor (see handle_frame definition for more details)
+            auto stream = frame->stream_id.stream_type;
+            auto index = static_cast<int>(frame->stream_id.stream_index);
             m_active_sensors.at(frame->stream_id.sensor_index)->handle_frame(std::move(frame->frame), m_real_time,
-                [this, timestamp]() { return calc_sleep_time(timestamp); },
+                [this, timestamp]() { return calc_deadline(timestamp); },
                 [this]() { return m_is_paused == true; },
-                [this, timestamp]()
+                [this, timestamp, stream, index](playback_clock::clock::duration lateness)
                 {
+                    if (m_real_time)
+                        m_clock.record(stream, index, lateness);
                     std::lock_guard<std::mutex> locker(m_last_published_timestamp_mutex);
                     m_last_published_timestamp = timestamp;
                 });
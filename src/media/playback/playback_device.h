@@ -11,6 +11,7 @@
 #include "concurrency.h"
 #include "sensor.h"
 #include "playback_sensor.h"
+#include "prefetching_reader.h"
 
 namespace librealsense
 {
@@ -40,6 +41,11 @@ namespace librealsense
         void stop();
         void set_real_time(bool real_time);
         bool is_real_time() const;
+        void register_codec(frame_codec_ptr codec);
+        void set_read_ahead(size_t count);
+        bool set_mapped_read(bool mapped);
+        void set_parallel_decode(bool parallel);
+        rs2_playback_jitter get_jitter(rs2_stream stream, int index) const;
         const std::string& get_file_name() const;
         uint64_t get_position() const;
         signal<playback_device, rs2_playback_status> playback_status_changed;
@@ -58,6 +64,7 @@ namespace librealsense
     private:
         void update_time_base(device_serializer::nanoseconds base_timestamp);
         device_serializer::nanoseconds calc_sleep_time(device_serializer::nanoseconds  timestamp) const;
+        playback_clock::clock::time_point calc_deadline(device_serializer::nanoseconds timestamp) const;
         void start();
         void stop_internal();
         void try_looping();
@@ -73,11 +80,12 @@ namespace librealsense
 
     private:
         lazy<std::shared_ptr<dispatcher>> m_read_thread;
+        std::shared_ptr<prefetching_reader> m_prefetching_reader;
         std::shared_ptr<device_serializer::reader> m_reader;
         device_serializer::device_snapshot m_device_description;
         std::atomic_bool m_is_started;
         std::atomic_bool m_is_paused;
-        std::chrono::high_resolution_clock::time_point m_base_sys_time; // !< System time when reading began (first frame was read)
+        playback_clock::clock::time_point m_base_sys_time; // !< Time of the playback clock when reading began (first frame was read)
         device_serializer::nanoseconds m_base_timestamp; // !< Timestamp of the first frame that has a real timestamp (different than 0)
         std::map<uint32_t, std::shared_ptr<playback_sensor>> m_sensors;
         std::map<uint32_t, std::shared_ptr<playback_sensor>> m_active_sensors;
@@ -89,6 +97,7 @@ namespace librealsense
         std::map<int, std::pair<uint32_t, rs2_extrinsics>> m_extrinsics_map;
         device_serializer::nanoseconds m_last_published_timestamp;
         std::mutex m_last_published_timestamp_mutex;
+        playback_clock m_clock;
     };
 
     MAP_EXTENSION(RS2_EXTENSION_PLAYBACK, playback_device);
@@ -27,6 +27,7 @@ std::string profile_to_string(std::shared_ptr<stream_profile_interface> s)
 
 playback_sensor::playback_sensor(const device_interface& parent_device, const device_serializer::sensor_snapshot& sensor_description):
     m_is_started(false),
+    m_parallel_decode(false),
     m_sensor_description(sensor_description),
     m_sensor_id(sensor_description.get_sensor_index()),
     m_parent_device(parent_device),
@@ -82,7 +83,9 @@ void playback_sensor::open(const stream_profiles& requests)
         }
     }
     std::vector<device_serializer::stream_identifier> opened_streams;
-    //For each stream, create a dedicated dispatching thread
+    //For each stream, create a dedicated dispatching thread. In real time mode the dispatcher of a stream waits there for each
+    //frame to be due, which a strand of the worker threads of the context would do by holding up a worker shared with other
+    //sensors; the mode can change at any time, so the streams of a playback never run on the workers
     for (auto&& profile : requests)
     {
         m_dispatchers.emplace(std::make_pair(profile->get_unique_id(), std::make_shared<dispatcher>(_default_queue_size)));
@@ -175,6 +178,11 @@ void playback_sensor::update_option(rs2_option id, std::shared_ptr<option> optio
     register_option(id, option);
 }
 
+void playback_sensor::set_parallel_decode(bool parallel)
+{
+    m_parallel_decode = parallel;
+}
+
 void playback_sensor::flush_pending_frames()
 {
     for (auto&& dispatcher : m_dispatchers)
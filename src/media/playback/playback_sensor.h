@@ -9,6 +9,7 @@
 #include "archive.h"
 #include "concurrency.h"
 #include "sensor.h"
+#include "playback_clock.h"
 #include "types.h"
 
 namespace librealsense
@@ -50,6 +51,9 @@ namespace librealsense
         void unregister_before_start_callback(int token) override;
         void raise_notification(const notification& n);
         bool streams_contains_one_frame_or_more();
+        // Whether frames are decoded on the dispatcher of their stream, before they are published, rather than when
+        // their data is first accessed
+        void set_parallel_decode(bool parallel);
     private:
         void register_sensor_streams(const stream_profiles& vector);
         void register_sensor_infos(const device_serializer::sensor_snapshot& sensor_snapshot);
@@ -60,6 +64,7 @@ namespace librealsense
         using stream_unique_id = int;
         std::map<stream_unique_id, std::shared_ptr<dispatcher>> m_dispatchers;
         std::atomic<bool> m_is_started;
+        std::atomic<bool> m_parallel_decode;
         device_serializer::sensor_snapshot m_sensor_description;
         uint32_t m_sensor_id;
         std::mutex m_mutex;
@@ -71,13 +76,14 @@ namespace librealsense
 
     public:
         //handle frame use 3 lambda functions that determines if and when a frame should be published.
-        //calc_sleep - calculates the duration that the sensor should wait before publishing the frame,
+        //calc_deadline - calculates the time of the playback clock the sensor should publish the frame at in real time mode,
         // the start point for this calculation is the last playback resume.
         //is_paused - check if the playback was paused while waiting for the frame publish time.
         //update_last_pushed_frame - lets the playback device know that a specific frame was published,
         // the playback device will use this info to determine which frames should be played next in a pause/resume scenario.
+        // It is passed the lateness of the frame past its deadline.
         template <class T, class K, class P>
-        void handle_frame(frame_holder frame, bool is_real_time, T calc_sleep, K is_paused, P update_last_pushed_frame)
+        void handle_frame(frame_holder frame, bool is_real_time, T calc_deadline, K is_paused, P update_last_pushed_frame)
         {
             if (frame == nullptr)
             {
@@ -91,21 +97,32 @@ namespace librealsense
                 frame->set_stream(m_streams[std::make_pair(type, index)]);
                 frame->set_sensor(shared_from_this());
                 auto stream_id = frame.frame->get_stream()->get_unique_id();
+                // Read from the file, the frame is dequeued as one from a driver would be
+                frame->set_stage_time(frame_stage::dequeue, platform::monotonic_time());
                 //TODO: Ziv, remove usage of shared_ptr when frame_holder is cpoyable
                 auto pf = std::make_shared<frame_holder>(std::move(frame));
 
-                auto callback = [this, is_real_time, stream_id, pf, calc_sleep, is_paused, update_last_pushed_frame](dispatcher::cancellable_timer t)
+                auto callback = [this, is_real_time, stream_id, pf, calc_deadline, is_paused, update_last_pushed_frame](dispatcher::cancellable_timer t)
                 {
-                    device_serializer::nanoseconds sleep_for = calc_sleep();
-                    if (sleep_for.count() > 0)
-                        t.try_sleep(sleep_for.count() * 1e-6);
+                    playback_clock::clock::time_point deadline = calc_deadline();
+                    if (is_real_time)
+                        playback_clock::wait_until(t, deadline);
                     if(is_paused())
                         return;
 
+                    //Decompressing or decoding the frame here overlaps it with that of the frames of other streams
+                    if (m_parallel_decode)
+                    {
+                        (*pf)->get_frame_data();
+                        (*pf)->set_stage_time(frame_stage::unpack, platform::monotonic_time());
+                    }
+
                     frame_interface* pframe = nullptr;
                     std::swap((*pf).frame, pframe);
+                    auto lateness = playback_clock::clock::now() - deadline;
+                    pframe->set_stage_time(frame_stage::callback, platform::monotonic_time());
                     m_user_callback->on_frame((rs2_frame*)pframe);
-                    update_last_pushed_frame();
+                    update_last_pushed_frame(lateness);
                 };
                 m_dispatchers.at(stream_id)->invoke(callback, !is_real_time);
             }
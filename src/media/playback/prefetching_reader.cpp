@@ -0,0 +1,193 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include "prefetching_reader.h"
+
+using namespace librealsense;
+using namespace device_serializer;
+
+prefetching_reader::prefetching_reader(std::shared_ptr<reader> reader) :
+    _reader(reader),
+    _read_ahead(0),
+    _end_of_data(false),
+    _stopping(false)
+{
+    if (_reader == nullptr)
+    {
+        throw invalid_value_exception("null reader");
+    }
+    _thread = std::thread([this]() { prefetch_loop(); });
+}
+
+prefetching_reader::~prefetching_reader()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _cv.notify_all();
+    _thread.join();
+}
+
+void prefetching_reader::set_read_ahead(size_t count)
+{
+    if (count > max_read_ahead)
+    {
+        throw invalid_value_exception(to_string() << "Read ahead of " << count << " is above " << max_read_ahead);
+    }
+    {
+        // What was read ahead already is still handed out first
+        std::lock_guard<std::mutex> lock(_mutex);
+        _read_ahead = count;
+    }
+    _cv.notify_all();
+}
+
+size_t prefetching_reader::get_read_ahead() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _read_ahead;
+}
+
+bool prefetching_reader::should_prefetch() const
+{
+    return _buffer.size() < _read_ahead && !_end_of_data;
+}
+
+void prefetching_reader::prefetch_loop()
+{
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _cv.wait(lock, [this]() { return _stopping || should_prefetch(); });
+            if (_stopping)
+                return;
+        }
+
+        std::lock_guard<std::mutex> reader_lock(_reader_mutex);
+        {
+            //Operations on the reader may have run in between
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_stopping || !should_prefetch())
+                continue;
+        }
+
+        prefetched next;
+        try
+        {
+            next.data = _reader->read_next_data();
+        }
+        catch (...)
+        {
+            next.error = std::current_exception();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (next.error || next.data->is<serialized_end_of_file>())
+                _end_of_data = true;
+            _buffer.push_back(std::move(next));
+        }
+        _cv.notify_all();
+    }
+}
+
+std::shared_ptr<serialized_data> prefetching_reader::pop_front()
+{
+    auto next = std::move(_buffer.front());
+    _buffer.pop_front();
+    if (next.error)
+        std::rethrow_exception(next.error);
+    return next.data;
+}
+
+std::shared_ptr<serialized_data> prefetching_reader::read_next_data()
+{
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _cv.wait(lock, [this]() { return !_buffer.empty() || !should_prefetch() || _stopping; });
+        if (!_buffer.empty())
+        {
+            auto data = pop_front();
+            lock.unlock();
+            _cv.notify_all();
+            return data;
+        }
+    }
+
+    //Read on demand, unless the prefetching thread was reading the next data meanwhile
+    std::lock_guard<std::mutex> reader_lock(_reader_mutex);
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_buffer.empty())
+            return pop_front();
+    }
+    return _reader->read_next_data();
+}
+
+void prefetching_reader::restart(std::function<void()> operation)
+{
+    std::lock_guard<std::mutex> reader_lock(_reader_mutex);
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _buffer.clear();
+        _end_of_data = false;
+    }
+    operation();
+    _cv.notify_all();
+}
+
+void prefetching_reader::seek_to_time(const nanoseconds& time)
+{
+    restart([&]() { _reader->seek_to_time(time); });
+}
+
+void prefetching_reader::reset()
+{
+    restart([&]() { _reader->reset(); });
+}
+
+void prefetching_reader::enable_stream(const std::vector<stream_identifier>& stream_ids)
+{
+    restart([&]() { _reader->enable_stream(stream_ids); });
+}
+
+void prefetching_reader::disable_stream(const std::vector<stream_identifier>& stream_ids)
+{
+    restart([&]() { _reader->disable_stream(stream_ids); });
+}
+
+device_snapshot prefetching_reader::query_device_description(const nanoseconds& time)
+{
+    std::lock_guard<std::mutex> reader_lock(_reader_mutex);
+    return _reader->query_device_description(time);
+}
+
+nanoseconds prefetching_reader::query_duration() const
+{
+    std::lock_guard<std::mutex> reader_lock(_reader_mutex);
+    return _reader->query_duration();
+}
+
+const std::string& prefetching_reader::get_file_name() const
+{
+    return _reader->get_file_name();
+}
+
+std::vector<std::shared_ptr<serialized_data>> prefetching_reader::fetch_last_frames(const nanoseconds& seek_time)
+{
+    std::lock_guard<std::mutex> reader_lock(_reader_mutex);
+    return _reader->fetch_last_frames(seek_time);
+}
+
+void prefetching_reader::register_codec(frame_codec_ptr codec)
+{
+    _reader->register_codec(codec);
+}
+
+bool prefetching_reader::set_mapped_read(bool mapped)
+{
+    std::lock_guard<std::mutex> reader_lock(_reader_mutex);
+    return _reader->set_mapped_read(mapped);
+}
@@ -0,0 +1,65 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <core/serialization.h>
+
+#include <condition_variable>
+#include <deque>
+#include <thread>
+
+namespace librealsense
+{
+    // Reads the data of a file ahead of its playback on a thread of its own, so that reading and decompressing the file
+    // overlaps with the handling of the data read before. Without read ahead, reads go straight to the underlying reader
+    class prefetching_reader : public device_serializer::reader
+    {
+    public:
+        // The data read ahead holds frames of the pool of the underlying reader, so it is kept well below the pool size
+        static const size_t max_read_ahead = 16;
+
+        explicit prefetching_reader(std::shared_ptr<device_serializer::reader> reader);
+        ~prefetching_reader();
+
+        // The count of data read ahead, 0 to read on demand
+        void set_read_ahead(size_t count);
+        size_t get_read_ahead() const;
+
+        device_serializer::device_snapshot query_device_description(const device_serializer::nanoseconds& time) override;
+        std::shared_ptr<device_serializer::serialized_data> read_next_data() override;
+        void seek_to_time(const device_serializer::nanoseconds& time) override;
+        device_serializer::nanoseconds query_duration() const override;
+        void reset() override;
+        void enable_stream(const std::vector<device_serializer::stream_identifier>& stream_ids) override;
+        void disable_stream(const std::vector<device_serializer::stream_identifier>& stream_ids) override;
+        const std::string& get_file_name() const override;
+        std::vector<std::shared_ptr<device_serializer::serialized_data>> fetch_last_frames(const device_serializer::nanoseconds& seek_time) override;
+        void register_codec(frame_codec_ptr codec) override;
+        bool set_mapped_read(bool mapped) override;
+
+    private:
+        struct prefetched
+        {
+            std::shared_ptr<device_serializer::serialized_data> data;
+            std::exception_ptr error;
+        };
+
+        void prefetch_loop();
+        bool should_prefetch() const;
+        std::shared_ptr<device_serializer::serialized_data> pop_front();
+        // Runs an operation moving the position of the underlying reader, dropping what was read ahead of the former one
+        void restart(std::function<void()> operation);
+
+        std::shared_ptr<device_serializer::reader> _reader;
+        // Held over every call to the underlying reader, before _mutex when both are
+        mutable std::mutex _reader_mutex;
+
+        mutable std::mutex _mutex;
+        std::condition_variable _cv;
+        std::deque<prefetched> _buffer;
+        size_t _read_ahead;
+        bool _end_of_data;
+        bool _stopping;
+        std::thread _thread;
+    };
+}
@@ -5,14 +5,37 @@
 #include <core/motion.h>
 #include <core/advanced_mode.h>
 #include "record_device.h"
+#include "segmenting_writer.h"
+#include "media/capture/capture_writer.h"
+#include "media/ros/ros_writer.h"
+#include "context.h"
+
+#include <algorithm>
+#include <future>
 
 using namespace librealsense;
 
 librealsense::record_device::record_device(std::shared_ptr<librealsense::device_interface> device,
                                       std::shared_ptr<librealsense::device_serializer::writer> serializer):
-    m_write_thread([](){return std::make_shared<dispatcher>(std::numeric_limits<unsigned int>::max());}),
+    m_write_thread([this]()
+    {
+        auto ctx = m_device->get_context();
+        return std::make_shared<dispatcher>(std::numeric_limits<unsigned int>::max(), ctx ? ctx->get_executor() : nullptr);
+    }),
     m_is_recording(true),
-    m_record_pause_time(0)
+    m_record_pause_time(0),
+    m_max_queued_frames(0),
+    m_max_queued_bytes(MAX_CACHED_DATA_SIZE),
+    m_queue_policy(RS2_RECORD_QUEUE_POLICY_DROP_NEWEST),
+    m_queue_stats(),
+    m_total_latency_us(0),
+    m_queue_closed(false),
+    m_pre_roll(0),
+    m_post_roll(0),
+    m_pre_roll_max_bytes(0),
+    m_held_frames_source(0),
+    m_held_bytes(0),
+    m_post_roll_end(std::chrono::nanoseconds::min())
 {
     if (device == nullptr)
     {
@@ -26,6 +49,7 @@ librealsense::record_device::record_device(std::shared_ptr<librealsense::device_
 
     m_device = device;
     m_ros_writer = serializer;
+    m_held_frames_source.init(std::shared_ptr<metadata_parser_map>());
     (*m_write_thread)->start(); //Start thread before creating the sensors (since they might write right away)
     m_sensors = create_record_sensors(m_device);
     LOG_DEBUG("Created record_device");
@@ -57,16 +81,31 @@ librealsense::record_device::~record_device()
         s->on_extension_change -= m_on_extension_change_token;
         s->disable_recording();
     }
+    {
+        // Sensor callbacks waiting for room give up their frames
+        std::lock_guard<std::mutex> lock(m_queue_mutex);
+        m_queue_closed = true;
+    }
+    m_queue_cv.notify_all();
     if ((*m_write_thread)->flush() == false)
     {
         LOG_ERROR("Error - timeout waiting for flush, possible deadlock detected");
     }
     (*m_write_thread)->stop();
+    //The frames of the pre-roll that no trigger wrote are let go of
+    m_held_frames.clear();
     //Just in case someone still holds a reference to the sensors,
     // we make sure that they will not try to record anything
     m_sensors.clear();
 }
 
+std::shared_ptr<device_serializer::writer> librealsense::record_device::create_file_writer(const std::string& file)
+{
+    if (capture::is_capture_file(file))
+        return std::make_shared<capture_writer>(file);
+    return std::make_shared<ros_writer>(file);
+}
+
 std::shared_ptr<context> librealsense::record_device::get_context() const
 {
     return m_device->get_context();
@@ -121,23 +160,66 @@ void librealsense::record_device::write_data(size_t sensor_index, librealsense::
         initialize_recording();
     });
 
-    //TODO: restore: uint64_t data_size = frame.frame->get_frame_data_size();
-    uint64_t cached_data_size = m_cached_data_size; //TODO: restore: (+ data_size)
-    if (cached_data_size > MAX_CACHED_DATA_SIZE)
+    auto stream_type = frame.frame->get_stream()->get_stream_type();
+    uint64_t data_size = 0;
+    auto video = dynamic_cast<video_frame*>(frame.frame);
+    if (video)
+        data_size = static_cast<uint64_t>(video->get_stride()) * video->get_height();
+    else if (auto f = dynamic_cast<librealsense::frame*>(frame.frame))
+        data_size = f->data.size();
+
+    if (!enqueue_frame(stream_type, data_size))
     {
-        LOG_WARNING("Recorder reached maximum cache size, frame dropped");
-        on_error("Recorder reached maximum cache size, frame dropped");
+        LOG_DEBUG("Recorder queue is full, frame " << frame.frame->get_frame_number() << " of " << stream_type << " dropped");
         return;
     }
 
-    m_cached_data_size = cached_data_size;
+    auto enqueue_time = std::chrono::steady_clock::now();
     auto capture_time = get_capture_time();
     //TODO: remove usage of shared pointer when frame_holder is copyable
     auto frame_holder_ptr = std::make_shared<frame_holder>();
     *frame_holder_ptr = std::move(frame);
-    (*m_write_thread)->invoke([this, frame_holder_ptr, sensor_index, capture_time/*, data_size*/, on_error](dispatcher::cancellable_timer t) {
+
+    auto compression = RS2_RECORD_COMPRESSION_NONE;
+    frame_codec_ptr codec;
+    {
+        std::lock_guard<std::mutex> lock(m_queue_mutex);
+        auto it = m_stream_compression.find(stream_type);
+        if (video && it != m_stream_compression.end())
+            compression = it->second;
+        auto codec_it = m_stream_codecs.find(stream_type);
+        if (video && codec_it != m_stream_codecs.end())
+            codec = codec_it->second;
+    }
+
+    //Frames the codec does not encode fall back to the compression of their stream
+    auto writer = m_ros_writer;
+    auto compress = [writer, frame_holder_ptr, compression, codec]()
+    {
+        device_serializer::compressed_payload compressed;
+        if (codec)
+            compressed = writer->encode_frame(*frame_holder_ptr->frame, *codec);
+        if (compressed.data.empty() && compression != RS2_RECORD_COMPRESSION_NONE)
+            compressed = writer->compress_frame(*frame_holder_ptr->frame, compression);
+        return compressed;
+    };
+    auto compressed_write = codec || compression != RS2_RECORD_COMPRESSION_NONE;
+
+    //Frames are compressed on the workers of the context, while the write thread writes the frames before them
+    auto ctx = m_device->get_context();
+    auto exec = ctx ? ctx->get_executor() : nullptr;
+    std::shared_ptr<std::future<device_serializer::compressed_payload>> payload;
+    if (compressed_write && exec)
+    {
+        auto task = std::make_shared<std::packaged_task<device_serializer::compressed_payload()>>(compress);
+        payload = std::make_shared<std::future<device_serializer::compressed_payload>>(task->get_future());
+        exec->submit([task]() { (*task)(); });
+    }
+
+    (*m_write_thread)->invoke([this, frame_holder_ptr, sensor_index, capture_time, data_size, enqueue_time, compressed_write, compress, payload, exec, on_error](dispatcher::cancellable_timer t) {
         if (m_is_recording == false)
         {
+            dequeue_frame(data_size, enqueue_time, false);
             return; //Recording is paused
         }
         std::call_once(m_first_frame_flag, [&]()
@@ -158,16 +240,320 @@ void librealsense::record_device::write_data(size_t sensor_index, librealsense::
             const uint32_t device_index = 0;
             auto stream_type = frame_holder_ptr->frame->get_stream()->get_stream_type();
             auto stream_index = static_cast<uint32_t>(frame_holder_ptr->frame->get_stream()->get_stream_index());
-            m_ros_writer->write_frame({ device_index, static_cast<uint32_t>(sensor_index), stream_type, stream_index }, capture_time, std::move(*frame_holder_ptr));
-            //TODO: restore: std::lock_guard<std::mutex> locker(m_mutex);  m_cached_data_size -= data_size;
+            device_serializer::stream_identifier stream_id{ device_index, static_cast<uint32_t>(sensor_index), stream_type, stream_index };
+            device_serializer::compressed_payload compressed;
+            if (payload)
+            {
+                //A write thread running on the workers keeps them busy while it waits
+                while (payload->wait_for(std::chrono::milliseconds(0)) != std::future_status::ready)
+                {
+                    if (!exec->is_worker())
+                        payload->wait();
+                    else if (!exec->try_run_one())
+                        payload->wait_for(std::chrono::milliseconds(1));
+                }
+                compressed = payload->get();
+            }
+            else if (compressed_write)
+            {
+                compressed = compress();
+            }
+            bool pre_roll;
+            {
+                std::lock_guard<std::mutex> lock(m_queue_mutex);
+                pre_roll = m_pre_roll.count() != 0;
+            }
+            if (pre_roll && capture_time > m_post_roll_end)
+            {
+                hold_frame(stream_id, capture_time, std::move(*frame_holder_ptr), std::move(compressed), data_size);
+                dequeue_frame(data_size, enqueue_time, false);
+                return;
+            }
+            m_ros_writer->write_compressed_frame(stream_id, capture_time, std::move(*frame_holder_ptr), std::move(compressed));
+            dequeue_frame(data_size, enqueue_time, true);
         }
         catch(std::exception& e)
         {
+            dequeue_frame(data_size, enqueue_time, false);
             on_error(to_string() << "Failed to write frame. " << e.what());
         }
     });
 }
 
+bool librealsense::record_device::queue_has_room(uint64_t size, uint64_t max_frames, uint64_t max_bytes) const
+{
+    //A frame larger than the bound is still written, alone
+    if (m_queue_stats.queued_frames == 0)
+        return true;
+    if (max_frames && m_queue_stats.queued_frames + 1 > max_frames)
+        return false;
+    if (max_bytes && m_queue_stats.queued_bytes + size > max_bytes)
+        return false;
+    return true;
+}
+
+bool librealsense::record_device::enqueue_frame(rs2_stream stream, uint64_t size)
+{
+    std::unique_lock<std::mutex> lock(m_queue_mutex);
+    bool admitted = false;
+    switch (m_queue_policy)
+    {
+    case RS2_RECORD_QUEUE_POLICY_BLOCK:
+        m_queue_cv.wait(lock, [&]() { return m_queue_closed || queue_has_room(size, m_max_queued_frames, m_max_queued_bytes); });
+        admitted = !m_queue_closed;
+        break;
+    case RS2_RECORD_QUEUE_POLICY_DROP_LOW_PRIORITY:
+    {
+        int highest = 0, priority = 0;
+        for (auto&& p : m_stream_priorities)
+        {
+            highest = std::max(highest, p.second);
+            if (p.first == stream)
+                priority = p.second;
+        }
+        //Streams below the highest priority leave the second half of the queue to the others
+        admitted = priority < highest ?
+            queue_has_room(size, (m_max_queued_frames + 1) / 2, (m_max_queued_bytes + 1) / 2) :
+            queue_has_room(size, m_max_queued_frames, m_max_queued_bytes);
+        break;
+    }
+    default:
+        admitted = queue_has_room(size, m_max_queued_frames, m_max_queued_bytes);
+    }
+
+    if (!admitted)
+    {
+        if (m_queue_stats.dropped_frames++ == 0)
+            LOG_WARNING("Recorder reached the bound of its write queue, frames are dropped");
+        return false;
+    }
+
+    m_queue_stats.queued_frames++;
+    m_queue_stats.queued_bytes += size;
+    m_queue_stats.peak_bytes = std::max(m_queue_stats.peak_bytes, m_queue_stats.queued_bytes);
+    return true;
+}
+
+void librealsense::record_device::dequeue_frame(uint64_t size, std::chrono::steady_clock::time_point enqueue_time, bool written)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_queue_mutex);
+        m_queue_stats.queued_frames--;
+        m_queue_stats.queued_bytes -= size;
+        if (written)
+        {
+            auto latency = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - enqueue_time).count());
+            m_queue_stats.written_frames++;
+            m_queue_stats.max_latency_us = std::max<unsigned long long>(m_queue_stats.max_latency_us, latency);
+            m_total_latency_us += latency;
+        }
+    }
+    m_queue_cv.notify_all();
+}
+
+void librealsense::record_device::set_queue_limit(uint64_t max_frames, uint64_t max_bytes, rs2_record_queue_policy policy)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_queue_mutex);
+        m_max_queued_frames = max_frames;
+        m_max_queued_bytes = max_bytes;
+        m_queue_policy = policy;
+    }
+    m_queue_cv.notify_all();
+}
+
+void librealsense::record_device::set_stream_priority(rs2_stream stream, int priority)
+{
+    std::lock_guard<std::mutex> lock(m_queue_mutex);
+    m_stream_priorities[stream] = priority;
+}
+
+void librealsense::record_device::set_stream_compression(rs2_stream stream, rs2_record_compression compression)
+{
+    std::lock_guard<std::mutex> lock(m_queue_mutex);
+    m_stream_compression[stream] = compression;
+}
+
+void librealsense::record_device::set_stream_codec(rs2_stream stream, frame_codec_ptr codec)
+{
+    std::lock_guard<std::mutex> lock(m_queue_mutex);
+    if (codec)
+        m_stream_codecs[stream] = codec;
+    else
+        m_stream_codecs.erase(stream);
+}
+
+void librealsense::record_device::set_stream_processing(rs2_stream stream, std::shared_ptr<processing_block_interface> block)
+{
+    //The stream is processed by the sensor streaming it
+    for (auto&& s : m_sensors)
+    {
+        auto profiles = s->get_stream_profiles();
+        if (std::any_of(profiles.begin(), profiles.end(), [stream](const std::shared_ptr<stream_profile_interface>& p) { return p->get_stream_type() == stream; }))
+        {
+            s->set_stream_processing(stream, block);
+            return;
+        }
+    }
+    throw invalid_value_exception(to_string() << "The recorded device has no sensor of " << stream);
+}
+
+void librealsense::record_device::set_pre_roll(std::chrono::nanoseconds pre_roll, std::chrono::nanoseconds post_roll, uint64_t max_bytes)
+{
+    if (pre_roll.count() < 0 || post_roll.count() < 0)
+        throw invalid_value_exception("The pre-roll and the post-roll of a flight recording are not negative");
+    {
+        std::lock_guard<std::mutex> lock(m_queue_mutex);
+        m_pre_roll = pre_roll;
+        m_post_roll = post_roll;
+        m_pre_roll_max_bytes = max_bytes;
+    }
+    //The frames held past the new bounds are let go of
+    (*m_write_thread)->invoke([this](dispatcher::cancellable_timer t)
+    {
+        trim_held_frames();
+    });
+}
+
+void librealsense::record_device::trigger()
+{
+    std::chrono::nanoseconds post_roll;
+    {
+        std::lock_guard<std::mutex> lock(m_queue_mutex);
+        if (m_pre_roll.count() == 0)
+            throw wrong_api_call_sequence_exception("Triggers are of flight recordings, which have a pre-roll");
+        post_roll = m_post_roll;
+    }
+
+    //The frames queued before the trigger are held before the write thread writes them
+    auto end = get_capture_time() + post_roll;
+    (*m_write_thread)->invoke([this, end](dispatcher::cancellable_timer t)
+    {
+        write_held_frames();
+        m_post_roll_end = std::max(m_post_roll_end, end);
+    });
+}
+
+frame_holder librealsense::record_device::copy_held_frame(frame_holder frame, bool with_data)
+{
+    //The motion and pose frames are small enough to be kept as they are
+    auto vf = dynamic_cast<video_frame*>(frame.frame);
+    if (!vf)
+    {
+        frame->keep();
+        return frame;
+    }
+
+    auto type = Is<disparity_frame>(frame.frame) ? RS2_EXTENSION_DISPARITY_FRAME :
+                Is<depth_frame>(frame.frame) ? RS2_EXTENSION_DEPTH_FRAME : RS2_EXTENSION_VIDEO_FRAME;
+    auto size = with_data ? static_cast<size_t>(vf->get_stride()) * vf->get_height() : 0;
+    auto res = m_held_frames_source.alloc_frame(type, size, vf->additional_data, with_data);
+    if (!res)
+        return frame_holder();
+
+    auto copy = static_cast<video_frame*>(res);
+    copy->metadata_parsers = vf->metadata_parsers;
+    copy->assign(vf->get_width(), vf->get_height(), vf->get_stride(), vf->get_bpp());
+    copy->set_sensor(vf->get_sensor());
+    copy->set_stream(vf->get_stream());
+    if (size)
+        memcpy(copy->data.data(), vf->get_frame_data(), size);
+    return frame_holder(res);
+}
+
+void librealsense::record_device::hold_frame(const device_serializer::stream_identifier& stream_id, std::chrono::nanoseconds capture_time,
+    frame_holder frame, device_serializer::compressed_payload&& payload, uint64_t size)
+{
+    //A compressed video frame is held as its payload, with none of its data
+    auto compressed = !payload.data.empty();
+    auto held = std::make_shared<held_frame>();
+    held->stream_id = stream_id;
+    held->capture_time = capture_time;
+    held->frame = copy_held_frame(std::move(frame), !compressed);
+    if (!held->frame)
+    {
+        LOG_WARNING("Failed to hold frame of " << stream_id.stream_type << " for the pre-roll");
+        return;
+    }
+    held->size = compressed ? payload.data.size() : size;
+    held->payload = std::move(payload);
+
+    m_held_bytes += held->size;
+    m_held_frames.push_back(held);
+    trim_held_frames();
+}
+
+void librealsense::record_device::trim_held_frames()
+{
+    std::lock_guard<std::mutex> lock(m_queue_mutex);
+    if (m_pre_roll.count() == 0)
+    {
+        m_held_frames.clear();
+        m_held_bytes = 0;
+    }
+
+    //The newest frame is held alone when it is larger than the bound
+    while (m_held_frames.size() > 1 &&
+        (m_held_frames.front()->capture_time < m_held_frames.back()->capture_time - m_pre_roll ||
+        (m_pre_roll_max_bytes && m_held_bytes > m_pre_roll_max_bytes)))
+    {
+        m_held_bytes -= m_held_frames.front()->size;
+        m_held_frames.pop_front();
+    }
+    m_queue_stats.pre_roll_frames = m_held_frames.size();
+    m_queue_stats.pre_roll_bytes = m_held_bytes;
+}
+
+void librealsense::record_device::write_held_frames()
+{
+    while (!m_held_frames.empty())
+    {
+        auto held = m_held_frames.front();
+        m_held_frames.pop_front();
+        try
+        {
+            m_ros_writer->write_compressed_frame(held->stream_id, held->capture_time, std::move(held->frame), std::move(held->payload));
+        }
+        catch (const std::exception& e)
+        {
+            LOG_ERROR("Failed to write frame of the pre-roll. " << e.what());
+        }
+    }
+    m_held_bytes = 0;
+
+    std::lock_guard<std::mutex> lock(m_queue_mutex);
+    m_queue_stats.pre_roll_frames = 0;
+    m_queue_stats.pre_roll_bytes = 0;
+}
+
+std::shared_ptr<librealsense::segmenting_writer> librealsense::record_device::get_segmenting_writer() const
+{
+    auto segmenting = std::dynamic_pointer_cast<segmenting_writer>(m_ros_writer);
+    if (!segmenting)
+    {
+        throw invalid_value_exception(to_string() << "Recording to " << get_filename() << " is not segmented");
+    }
+    return segmenting;
+}
+
+void librealsense::record_device::set_segment_closed_callback(segment_closed_callback_ptr callback)
+{
+    get_segmenting_writer()->set_segment_closed_callback(callback);
+}
+
+void librealsense::record_device::set_disk_budget(uint64_t max_bytes)
+{
+    get_segmenting_writer()->set_disk_budget(max_bytes);
+}
+
+rs2_record_queue_stats librealsense::record_device::get_queue_stats() const
+{
+    std::lock_guard<std::mutex> lock(m_queue_mutex);
+    auto stats = m_queue_stats;
+    stats.average_latency_us = stats.written_frames ? m_total_latency_us / stats.written_frames : 0;
+    return stats;
+}
+
 const std::string& librealsense::record_device::get_info(rs2_camera_info info) const
 {
     return m_device->get_info(info);
@@ -416,7 +802,6 @@ void record_device::initialize_recording()
 {
     //Expected to be called once when recording to file actually starts
     m_capture_time_base = std::chrono::high_resolution_clock::now();
-    m_cached_data_size = 0;
 }
 void record_device::stop_gracefully(to_string error_msg)
 {
@@ -10,9 +10,16 @@
 #include "concurrency.h"
 #include "sensor.h"
 #include "record_sensor.h"
+#include "source.h"
+
+#include <condition_variable>
+#include <deque>
+#include <map>
 
 namespace librealsense
 {
+    class segmenting_writer;
+
     class record_device : public device_interface,
                           public extendable_interface,
                           public info_container
@@ -23,6 +30,9 @@ namespace librealsense
         record_device(std::shared_ptr<device_interface> device, std::shared_ptr<device_serializer::writer> serializer);
         virtual ~record_device();
 
+        // Writer of capture files for the files of their extension, and of rosbag files for the others
+        static std::shared_ptr<device_serializer::writer> create_file_writer(const std::string& file);
+
         std::shared_ptr<context> get_context() const override;
 
         sensor_interface& get_sensor(size_t i) override;
@@ -39,6 +49,19 @@ namespace librealsense
         void pause_recording();
         void resume_recording();
         const std::string& get_filename() const;
+        void set_queue_limit(uint64_t max_frames, uint64_t max_bytes, rs2_record_queue_policy policy);
+        void set_stream_priority(rs2_stream stream, int priority);
+        void set_stream_compression(rs2_stream stream, rs2_record_compression compression);
+        void set_stream_codec(rs2_stream stream, frame_codec_ptr codec);
+        void set_stream_processing(rs2_stream stream, std::shared_ptr<processing_block_interface> block);
+        // Of recordings to a segmenting_writer only
+        void set_segment_closed_callback(segment_closed_callback_ptr callback);
+        void set_disk_budget(uint64_t max_bytes);
+        // Flight recording: the frames of the last pre_roll are held in memory, bounded by max_bytes unless it is zero, and
+        // written with the frames of the post_roll that follows every trigger. Frames are written as they come at a zero pre_roll
+        void set_pre_roll(std::chrono::nanoseconds pre_roll, std::chrono::nanoseconds post_roll, uint64_t max_bytes);
+        void trigger();
+        rs2_record_queue_stats get_queue_stats() const;
         platform::backend_device_group get_device_data() const override;
         std::pair<uint32_t, rs2_extrinsics> get_extrinsics(const stream_interface& stream) const override;
         bool is_valid() const override;
@@ -47,14 +70,32 @@ namespace librealsense
         void tag_profiles(stream_profiles profiles) const override { m_device->tag_profiles(profiles); }
 
     private:
+        struct held_frame
+        {
+            device_serializer::stream_identifier stream_id;
+            std::chrono::nanoseconds capture_time;
+            frame_holder frame;
+            device_serializer::compressed_payload payload;
+            uint64_t size;
+        };
+
         template <typename T> void write_device_extension_changes(const T& ext);
         template <rs2_extension E, typename P> bool extend_to_aux(std::shared_ptr<P> p, void** ext);
 
         void write_header();
+        std::shared_ptr<segmenting_writer> get_segmenting_writer() const;
         std::chrono::nanoseconds get_capture_time() const;
         void write_data(size_t sensor_index, frame_holder f, std::function<void(std::string const&)> on_error);
+        bool enqueue_frame(rs2_stream stream, uint64_t size);
+        void dequeue_frame(uint64_t size, std::chrono::steady_clock::time_point enqueue_time, bool written);
+        bool queue_has_room(uint64_t size, uint64_t max_frames, uint64_t max_bytes) const;
         void write_sensor_extension_snapshot(size_t sensor_index, rs2_extension ext, std::shared_ptr<extension_snapshot> snapshot, std::function<void(std::string const&)> on_error);
         void write_notification(size_t sensor_index, const notification& n);
+        frame_holder copy_held_frame(frame_holder frame, bool with_data);
+        void hold_frame(const device_serializer::stream_identifier& stream_id, std::chrono::nanoseconds capture_time, frame_holder frame,
+            device_serializer::compressed_payload&& payload, uint64_t size);
+        void trim_held_frames();
+        void write_held_frames();
         std::vector<std::shared_ptr<record_sensor>> create_record_sensors(std::shared_ptr<device_interface> m_device);
         template <typename T> device_serializer::snapshot_collection get_extensions_snapshots(T* extendable);
         template <typename T, typename Ext> void try_add_snapshot(T* extendable, device_serializer::snapshot_collection& snapshots);
@@ -74,7 +115,28 @@ namespace librealsense
         int m_on_notification_token;
         int m_on_frame_token;
         int m_on_extension_change_token;
-        uint64_t m_cached_data_size;
+
+        // Frames handed to m_write_thread and not written yet, bounded by m_max_queued_frames and m_max_queued_bytes
+        mutable std::mutex m_queue_mutex;
+        std::condition_variable m_queue_cv;
+        uint64_t m_max_queued_frames;
+        uint64_t m_max_queued_bytes;
+        rs2_record_queue_policy m_queue_policy;
+        std::map<rs2_stream, int> m_stream_priorities;
+        rs2_record_queue_stats m_queue_stats;
+        uint64_t m_total_latency_us;
+        bool m_queue_closed;
+        std::map<rs2_stream, rs2_record_compression> m_stream_compression;
+        std::map<rs2_stream, frame_codec_ptr> m_stream_codecs;
+        std::chrono::nanoseconds m_pre_roll;
+        std::chrono::nanoseconds m_post_roll;
+        uint64_t m_pre_roll_max_bytes;
+
+        // Of the write thread. The held video frames are copies of the frames of the sensors, for them not to run out of frames
+        frame_source m_held_frames_source;
+        std::deque<std::shared_ptr<held_frame>> m_held_frames;
+        uint64_t m_held_bytes;
+        std::chrono::nanoseconds m_post_roll_end;
         std::once_flag m_first_call_flag;
         void initialize_recording();
         void stop_gracefully(to_string error_msg);
@@ -5,6 +5,8 @@
 #include "api.h"
 #include "stream.h"
 
+#include <algorithm>
+
 using namespace librealsense;
 
 librealsense::record_sensor::record_sensor(const device_interface& device,
@@ -24,6 +26,8 @@ librealsense::record_sensor::~record_sensor()
     disable_sensor_options_recording();
     disable_sensor_hooks();
     m_is_recording = false;
+    for (auto&& p : m_stream_processing)
+        p.second->set_output_callback(nullptr);
     LOG_DEBUG("Destructed record_sensor");
 }
 
@@ -232,11 +236,90 @@ void record_sensor::record_frame(frame_holder frame)
 {
     if(m_is_recording)
     {
+        std::shared_ptr<processing_block_interface> block;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_stream_processing.find(frame->get_stream()->get_stream_type());
+            if (it != m_stream_processing.end())
+                block = it->second;
+        }
+        if (block)
+        {
+            //The block raises the frames to record, in this thread
+            block->invoke(std::move(frame));
+            return;
+        }
+
         //Send to recording thread
         on_frame(std::move(frame));
     }
 }
 
+void record_sensor::record_processed_frame(frame_holder frame)
+{
+    if (!frame || !m_is_recording)
+        return;
+
+    if (auto composite = dynamic_cast<composite_frame*>(frame.frame))
+    {
+        auto frames = composite->get_frames();
+        for (size_t i = 0; i < composite->get_embedded_frames_count(); i++)
+        {
+            if (!frames[i])
+                continue;
+            frames[i]->acquire();
+            record_processed_frame(frame_holder(frames[i]));
+        }
+        return;
+    }
+
+    auto stream = frame->get_stream();
+    auto key = std::make_pair(stream->get_stream_type(), stream->get_stream_index());
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_processed_streams_ids.find(key);
+        if (it == m_processed_streams_ids.end())
+        {
+            record_stream_profile(stream);
+            m_processed_streams_ids[key] = stream->get_unique_id();
+        }
+        else if (it->second != stream->get_unique_id())
+        {
+            //A recording holds a single profile of every stream, the frames of the profiles after it are left out
+            LOG_DEBUG("Processed frame " << frame->get_frame_number() << " of " << key.first << " has another profile than its stream, dropped");
+            return;
+        }
+    }
+
+    //Send to recording thread
+    on_frame(std::move(frame));
+}
+
+void record_sensor::set_stream_processing(rs2_stream stream, std::shared_ptr<processing_block_interface> block)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    //The profile of the stream, the one of the recording, is written once it starts streaming
+    auto processed = std::any_of(m_processed_streams_ids.begin(), m_processed_streams_ids.end(),
+        [stream](const std::pair<const std::pair<rs2_stream, int>, int>& p) { return p.first.first == stream; });
+    if (m_is_sensor_hooked || processed || m_recorded_stream_types.count(stream))
+        throw wrong_api_call_sequence_exception(to_string() << "The processing of " << stream << " is set before it starts recording");
+
+    auto it = m_stream_processing.find(stream);
+    if (it != m_stream_processing.end())
+    {
+        it->second->set_output_callback(nullptr);
+        m_stream_processing.erase(it);
+    }
+    if (!block)
+        return;
+
+    block->set_output_callback(std::make_shared<frame_holder_callback>([this](frame_holder f)
+    {
+        record_processed_frame(std::move(f));
+    }));
+    m_stream_processing[stream] = block;
+}
+
 void record_sensor::enable_sensor_hooks()
 {
     std::lock_guard<std::mutex> lock(m_mutex);
@@ -334,29 +417,37 @@ void record_sensor::disable_sensor_options_recording()
         option.enable_recording([](const librealsense::option& snapshot) {});
     }
 }
+void record_sensor::record_stream_profile(const std::shared_ptr<stream_profile_interface>& stream)
+{
+    std::shared_ptr<stream_profile_interface> snapshot;
+    stream->create_snapshot(snapshot);
+    rs2_extension extension_type;
+    if (Is<librealsense::video_stream_profile_interface>(stream))
+        extension_type = RS2_EXTENSION_VIDEO_PROFILE;
+    else if (Is<librealsense::motion_stream_profile_interface>(stream))
+        extension_type = RS2_EXTENSION_MOTION_PROFILE;
+    else if (Is<librealsense::pose_stream_profile_interface>(stream))
+        extension_type = RS2_EXTENSION_POSE_PROFILE;
+    else
+        throw std::runtime_error("Unsupported stream");
+
+    on_extension_change(extension_type, std::dynamic_pointer_cast<extension_snapshot>(snapshot));
+}
 void record_sensor::wrap_streams()
 {
     auto streams = m_sensor.get_active_streams();
     for (auto stream : streams)
     {
+        //The profiles of the processed streams are those of the output of their block
+        if (m_stream_processing.count(stream->get_stream_type()))
+            continue;
+
         auto id = stream->get_unique_id();
         if (m_recorded_streams_ids.count(id) == 0)
         {
-            std::shared_ptr<stream_profile_interface> snapshot;
-            stream->create_snapshot(snapshot);
-            rs2_extension extension_type;
-            if (Is<librealsense::video_stream_profile_interface>(stream))
-                extension_type = RS2_EXTENSION_VIDEO_PROFILE;
-            else if (Is<librealsense::motion_stream_profile_interface>(stream))
-                extension_type = RS2_EXTENSION_MOTION_PROFILE;
-            else if (Is<librealsense::pose_stream_profile_interface>(stream))
-                extension_type = RS2_EXTENSION_POSE_PROFILE;
-            else
-                throw std::runtime_error("Unsupported stream");
-
-            on_extension_change(extension_type, std::dynamic_pointer_cast<extension_snapshot>(snapshot));
-
-           m_recorded_streams_ids.insert(id);
+            record_stream_profile(stream);
+            m_recorded_streams_ids.insert(id);
+            m_recorded_stream_types.insert(stream->get_stream_type());
         }
     }
 }
@@ -6,6 +6,7 @@
 #include "core/extension.h"
 #include "core/serialization.h"
 #include "core/streaming.h"
+#include "core/processing.h"
 #include "archive.h"
 #include "concurrency.h"
 #include "sensor.h"
@@ -47,10 +48,14 @@ namespace librealsense
         signal<record_sensor, rs2_extension, std::shared_ptr<extension_snapshot>> on_extension_change;
         void stop_with_error(const std::string& message);
         void disable_recording();
+        // Records the output frames of the block in place of the frames of the stream, under the profiles of the output
+        void set_stream_processing(rs2_stream stream, std::shared_ptr<processing_block_interface> block);
     private /*methods*/:
         template <typename T> void record_snapshot(rs2_extension extension_type, const  recordable<T>& snapshot);
         template <rs2_extension E, typename P> bool extend_to_aux(P* p, void** ext);
         void record_frame(frame_holder holder);
+        void record_processed_frame(frame_holder holder);
+        void record_stream_profile(const std::shared_ptr<stream_profile_interface>& stream);
         void enable_sensor_hooks();
         void disable_sensor_hooks();
         void hook_sensor_callbacks();
@@ -63,6 +68,10 @@ namespace librealsense
     private /*members*/:
         sensor_interface& m_sensor;
         std::set<int> m_recorded_streams_ids;
+        std::set<rs2_stream> m_recorded_stream_types;
+        std::map<rs2_stream, std::shared_ptr<processing_block_interface>> m_stream_processing;
+        // Of every processed stream, the unique id of its recorded profile, the one of the recording
+        std::map<std::pair<rs2_stream, int>, int> m_processed_streams_ids;
         std::set<rs2_option> m_recording_options;
         librealsense::notifications_callback_ptr m_user_notification_callback;
         std::atomic_bool m_is_recording;
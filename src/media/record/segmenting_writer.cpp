@@ -0,0 +1,261 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include "segmenting_writer.h"
+#include "stream.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+
+using namespace librealsense;
+using namespace device_serializer;
+
+segmenting_writer::segmenting_writer(const std::string& file, writer_factory create_writer, nanoseconds max_duration, uint64_t max_size) :
+    _file(file),
+    _create_writer(create_writer),
+    _max_duration(max_duration),
+    _max_size(max_size),
+    _disk_budget(0),
+    _segment_index(0),
+    _segment_start(0),
+    _segment_has_frames(false)
+{
+    if (!_create_writer)
+    {
+        throw invalid_value_exception("null writer factory");
+    }
+    if (_max_duration.count() < 0)
+    {
+        throw invalid_value_exception(to_string() << "Negative segment duration " << _max_duration.count());
+    }
+    _writer = _create_writer(segment_file_name(_segment_index));
+}
+
+segmenting_writer::~segmenting_writer()
+{
+    try
+    {
+        close_segment();
+    }
+    catch (const std::exception& e)
+    {
+        LOG_ERROR("Failed to close the last segment of " << _file << ": " << e.what());
+    }
+}
+
+std::string segmenting_writer::segment_file_name(uint64_t index) const
+{
+    auto separator = _file.find_last_of("/\\");
+    auto extension = _file.find_last_of('.');
+    if (extension == std::string::npos || (separator != std::string::npos && extension < separator))
+        extension = _file.size();
+    return to_string() << _file.substr(0, extension) << "_" << std::setw(6) << std::setfill('0') << index << _file.substr(extension);
+}
+
+void segmenting_writer::set_segment_closed_callback(segment_closed_callback_ptr callback)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _on_segment_closed = callback;
+}
+
+void segmenting_writer::set_disk_budget(uint64_t max_size)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _disk_budget = max_size;
+}
+
+std::vector<std::string> segmenting_writer::get_closed_segments() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::vector<std::string> files;
+    for (auto&& segment : _closed_segments)
+        files.push_back(segment.file);
+    return files;
+}
+
+std::shared_ptr<writer> segmenting_writer::current_writer() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _writer;
+}
+
+void segmenting_writer::close_segment()
+{
+    std::shared_ptr<writer> closed;
+    segment_closed_callback_ptr callback;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::swap(closed, _writer);
+        callback = _on_segment_closed;
+    }
+    if (!closed)
+        return;
+
+    // Frames still being compressed with the writer keep it alive, it closes its file once they are done
+    auto file = closed->get_file_name();
+    uint64_t size = closed->get_written_size();
+    closed.reset();
+    std::ifstream closed_file(file, std::ios::binary | std::ios::ate);
+    if (closed_file)
+        size = static_cast<uint64_t>(closed_file.tellg());
+    LOG_INFO("Closed segment " << file << " of " << size << " bytes");
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _closed_segments.push_back({ file, size });
+    }
+    if (callback)
+        callback->on_segment_closed(file.c_str());
+    enforce_disk_budget();
+}
+
+void segmenting_writer::enforce_disk_budget()
+{
+    std::vector<std::string> deleted;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_disk_budget == 0)
+            return;
+
+        uint64_t total = 0;
+        for (auto&& segment : _closed_segments)
+            total += segment.size;
+        while (total > _disk_budget && !_closed_segments.empty())
+        {
+            total -= _closed_segments.front().size;
+            deleted.push_back(_closed_segments.front().file);
+            _closed_segments.pop_front();
+        }
+    }
+
+    for (auto&& file : deleted)
+    {
+        LOG_INFO("Deleting segment " << file << " to keep the recording within its disk budget");
+        if (std::remove(file.c_str()) != 0)
+            LOG_WARNING("Failed to delete segment " << file);
+        std::remove((file + ".idx").c_str());
+    }
+}
+
+void segmenting_writer::start_segment(const nanoseconds& timestamp)
+{
+    close_segment();
+
+    ++_segment_index;
+    _segment_start = timestamp;
+    _segment_has_frames = false;
+    auto next = _create_writer(segment_file_name(_segment_index));
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _writer = next;
+    }
+    LOG_INFO("Started segment " << next->get_file_name());
+
+    // Every segment describes the device and its streams as the first did, with the options as they are now
+    if (_device_description)
+        next->write_device_description(*_device_description);
+    for (auto&& s : _snapshots)
+    {
+        if (s.is_device)
+            next->write_snapshot(s.sensor_id.device_index, to_segment_time(timestamp), s.type, s.snapshot);
+        else
+            next->write_snapshot(s.sensor_id, to_segment_time(timestamp), s.type, s.snapshot);
+    }
+}
+
+void segmenting_writer::rotate_if_needed(const nanoseconds& timestamp)
+{
+    if (!_segment_has_frames)
+        return;
+
+    bool too_long = _max_duration.count() > 0 && timestamp - _segment_start >= _max_duration;
+    bool too_large = _max_size > 0 && current_writer()->get_written_size() >= _max_size;
+    if (too_long || too_large)
+        start_segment(timestamp);
+}
+
+nanoseconds segmenting_writer::to_segment_time(const nanoseconds& timestamp) const
+{
+    // The first segment keeps the times of the recording. The others start at the time of their first frame, and
+    // what was captured before it is written at their start, which files cannot precede
+    if (_segment_index == 0)
+        return timestamp;
+    return std::max(timestamp - _segment_start, nanoseconds(1));
+}
+
+void segmenting_writer::keep_snapshot(recorded_snapshot&& snapshot)
+{
+    // A stream profile snapshot is kept per stream, the others per extension
+    auto profile = As<stream_profile_interface>(snapshot.snapshot);
+    for (auto&& s : _snapshots)
+    {
+        if (s.is_device != snapshot.is_device || s.type != snapshot.type ||
+            s.sensor_id.device_index != snapshot.sensor_id.device_index || s.sensor_id.sensor_index != snapshot.sensor_id.sensor_index)
+            continue;
+
+        auto kept_profile = As<stream_profile_interface>(s.snapshot);
+        if (profile && kept_profile && (profile->get_stream_type() != kept_profile->get_stream_type() || profile->get_stream_index() != kept_profile->get_stream_index()))
+            continue;
+
+        s.snapshot = snapshot.snapshot;
+        return;
+    }
+    _snapshots.push_back(std::move(snapshot));
+}
+
+void segmenting_writer::write_device_description(const device_snapshot& device_description)
+{
+    _device_description = std::make_shared<device_snapshot>(device_description);
+    current_writer()->write_device_description(device_description);
+}
+
+void segmenting_writer::write_frame(const stream_identifier& stream_id, const nanoseconds& timestamp, frame_holder&& frame)
+{
+    write_compressed_frame(stream_id, timestamp, std::move(frame), {});
+}
+
+compressed_payload segmenting_writer::compress_frame(const frame_interface& frame, rs2_record_compression compression) const
+{
+    return current_writer()->compress_frame(frame, compression);
+}
+
+compressed_payload segmenting_writer::encode_frame(const frame_interface& frame, rs2_frame_codec& codec) const
+{
+    return current_writer()->encode_frame(frame, codec);
+}
+
+void segmenting_writer::write_compressed_frame(const stream_identifier& stream_id, const nanoseconds& timestamp, frame_holder&& frame, compressed_payload&& payload)
+{
+    rotate_if_needed(timestamp);
+    current_writer()->write_compressed_frame(stream_id, to_segment_time(timestamp), std::move(frame), std::move(payload));
+    _segment_has_frames = true;
+}
+
+void segmenting_writer::write_snapshot(uint32_t device_index, const nanoseconds& timestamp, rs2_extension type, const std::shared_ptr<extension_snapshot>& snapshot)
+{
+    current_writer()->write_snapshot(device_index, to_segment_time(timestamp), type, snapshot);
+    keep_snapshot({ true, { device_index, 0 }, type, snapshot });
+}
+
+void segmenting_writer::write_snapshot(const sensor_identifier& sensor_id, const nanoseconds& timestamp, rs2_extension type, const std::shared_ptr<extension_snapshot>& snapshot)
+{
+    current_writer()->write_snapshot(sensor_id, to_segment_time(timestamp), type, snapshot);
+    keep_snapshot({ false, sensor_id, type, snapshot });
+}
+
+void segmenting_writer::write_notification(const sensor_identifier& sensor_id, const nanoseconds& timestamp, const notification& n)
+{
+    current_writer()->write_notification(sensor_id, to_segment_time(timestamp), n);
+}
+
+const std::string& segmenting_writer::get_file_name() const
+{
+    return _file;
+}
+
+uint64_t segmenting_writer::get_written_size() const
+{
+    return current_writer()->get_written_size();
+}
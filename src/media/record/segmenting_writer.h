@@ -0,0 +1,89 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <core/serialization.h>
+
+#include <deque>
+#include <mutex>
+
+namespace librealsense
+{
+    // Splits a recording into segments of bounded duration and size, each a file of its own that plays on its own.
+    // A new segment starts right before the frame that would exceed the bounds of the current one, so no frame is
+    // lost at the boundaries, and starts with the device description and the latest snapshots written before.
+    // Segments are named after the file of the recording with their index, as in <name>_000000.bag
+    class segmenting_writer : public device_serializer::writer
+    {
+    public:
+        using writer_factory = std::function<std::shared_ptr<device_serializer::writer>(const std::string& file)>;
+
+        // 0 for a segment duration or size without bound
+        segmenting_writer(const std::string& file, writer_factory create_writer, device_serializer::nanoseconds max_duration, uint64_t max_size);
+        ~segmenting_writer();
+
+        // Called with the file of each segment once it is closed, from the thread writing the recording
+        void set_segment_closed_callback(segment_closed_callback_ptr callback);
+        // Deletes the oldest segments closed while they take more than the budget in all, 0 to keep them all
+        void set_disk_budget(uint64_t max_size);
+        // Files of the segments which were closed and not deleted, oldest first
+        std::vector<std::string> get_closed_segments() const;
+
+        void write_device_description(const device_serializer::device_snapshot& device_description) override;
+        void write_frame(const device_serializer::stream_identifier& stream_id, const device_serializer::nanoseconds& timestamp, frame_holder&& frame) override;
+        device_serializer::compressed_payload compress_frame(const frame_interface& frame, rs2_record_compression compression) const override;
+        device_serializer::compressed_payload encode_frame(const frame_interface& frame, rs2_frame_codec& codec) const override;
+        void write_compressed_frame(const device_serializer::stream_identifier& stream_id, const device_serializer::nanoseconds& timestamp, frame_holder&& frame, device_serializer::compressed_payload&& payload) override;
+        void write_snapshot(uint32_t device_index, const device_serializer::nanoseconds& timestamp, rs2_extension type, const std::shared_ptr<extension_snapshot>& snapshot) override;
+        void write_snapshot(const device_serializer::sensor_identifier& sensor_id, const device_serializer::nanoseconds& timestamp, rs2_extension type, const std::shared_ptr<extension_snapshot>& snapshot) override;
+        void write_notification(const device_serializer::sensor_identifier& sensor_id, const device_serializer::nanoseconds& timestamp, const notification& n) override;
+        const std::string& get_file_name() const override;
+        uint64_t get_written_size() const override;
+
+    private:
+        struct recorded_snapshot
+        {
+            bool is_device;
+            device_serializer::sensor_identifier sensor_id;
+            rs2_extension type;
+            std::shared_ptr<extension_snapshot> snapshot;
+        };
+
+        struct closed_segment
+        {
+            std::string file;
+            uint64_t size;
+        };
+
+        std::string segment_file_name(uint64_t index) const;
+        std::shared_ptr<device_serializer::writer> current_writer() const;
+        void start_segment(const device_serializer::nanoseconds& timestamp);
+        void close_segment();
+        void enforce_disk_budget();
+        // Starts a new segment when a frame at the given time would exceed the bounds of the current one
+        void rotate_if_needed(const device_serializer::nanoseconds& timestamp);
+        // The time of a message in the segment it is written to
+        device_serializer::nanoseconds to_segment_time(const device_serializer::nanoseconds& timestamp) const;
+        void keep_snapshot(recorded_snapshot&& snapshot);
+
+        const std::string _file;
+        const writer_factory _create_writer;
+        const device_serializer::nanoseconds _max_duration;
+        const uint64_t _max_size;
+
+        // Guards the writer of the current segment, which frames are compressed with from other threads, and what the
+        // application sets
+        mutable std::mutex _mutex;
+        std::shared_ptr<device_serializer::writer> _writer;
+        segment_closed_callback_ptr _on_segment_closed;
+        uint64_t _disk_budget;
+        std::deque<closed_segment> _closed_segments;
+
+        // Accessed from the thread writing the recording only
+        uint64_t _segment_index;
+        device_serializer::nanoseconds _segment_start;
+        bool _segment_has_frames;
+        std::shared_ptr<device_serializer::device_snapshot> _device_description;
+        std::vector<recorded_snapshot> _snapshots;
+    };
+}
@@ -12,6 +12,7 @@
 #include "std_msgs/UInt32.h"
 #include "std_msgs/Float32.h"
 #include "std_msgs/String.h"
+#include "std_msgs/UInt64MultiArray.h"
 #include "realsense_msgs/StreamInfo.h"
 #include "realsense_msgs/ImuIntrinsic.h"
 #include "realsense_msgs/Notification.h"
@@ -47,6 +48,69 @@ namespace librealsense
         }
     }
 
+    // Sidecar of a recorded file, holding the indexes of its messages for large files to open and seek quickly.
+    // Written along with the file, and ignored when it does not match the file
+    inline std::string get_index_file_name(const std::string& file)
+    {
+        return file + ".idx";
+    }
+
+    // Images compressed on their own are marked by the suffix of their encoding, both LZ4 and LZ4HC decompressing as LZ4
+    const std::string lz4_image_encoding_suffix = "; lz4";
+    const std::string rvl_image_encoding_suffix = "; rvl";
+
+    inline std::string compressed_image_encoding(const std::string& encoding, rs2_record_compression compression)
+    {
+        switch (compression)
+        {
+        case RS2_RECORD_COMPRESSION_LZ4:
+        case RS2_RECORD_COMPRESSION_LZ4HC: return encoding + lz4_image_encoding_suffix;
+        case RS2_RECORD_COMPRESSION_RVL: return encoding + rvl_image_encoding_suffix;
+        default: return encoding;
+        }
+    }
+
+    // Strips the suffix of compressed images, returning the compression they are decompressed with
+    inline rs2_record_compression strip_compressed_image_encoding(std::string& encoding)
+    {
+        auto ends_with = [&encoding](const std::string& suffix)
+        {
+            return encoding.size() > suffix.size() && encoding.compare(encoding.size() - suffix.size(), suffix.size(), suffix) == 0;
+        };
+
+        if (ends_with(lz4_image_encoding_suffix))
+        {
+            encoding.resize(encoding.size() - lz4_image_encoding_suffix.size());
+            return RS2_RECORD_COMPRESSION_LZ4;
+        }
+        if (ends_with(rvl_image_encoding_suffix))
+        {
+            encoding.resize(encoding.size() - rvl_image_encoding_suffix.size());
+            return RS2_RECORD_COMPRESSION_RVL;
+        }
+        return RS2_RECORD_COMPRESSION_NONE;
+    }
+
+    // Images encoded by a codec of the application are marked by a suffix naming the codec
+    const std::string codec_image_encoding_prefix = "; codec ";
+
+    inline std::string codec_image_encoding(const std::string& encoding, const std::string& codec)
+    {
+        return encoding + codec_image_encoding_prefix + codec;
+    }
+
+    // Strips the suffix of images encoded by a codec, returning the name of the codec, or an empty string for the other images
+    inline std::string strip_codec_image_encoding(std::string& encoding)
+    {
+        auto pos = encoding.rfind(codec_image_encoding_prefix);
+        if (pos == std::string::npos)
+            return "";
+
+        auto codec = encoding.substr(pos + codec_image_encoding_prefix.size());
+        encoding.resize(pos);
+        return codec;
+    }
+
     inline void convert(const std::string& source, rs2_format& target)
     {
         if (source == sensor_msgs::image_encodings::MONO16) { target = RS2_FORMAT_Z16; return; }
@@ -192,6 +256,13 @@ namespace librealsense
     constexpr const char* FRAME_TIMESTAMP_MD_STR = "frame_timestamp";
     constexpr const char* TRACKER_CONFIDENCE_MD_STR = "Tracker Confidence";
 
+    /**
+    * Starting version 4, the metadata of a frame is written as a single record of 64-bit words:
+    * the bits of the frame's system time, its timestamp domain, and then a pair of words for each
+    * metadata value the frame supports - the rs2_frame_metadata_value and the value itself
+    */
+    constexpr size_t METADATA_RECORD_HEADER_SIZE = 2;
+
     class ros_topic
     {
     public:
@@ -313,6 +384,12 @@ namespace librealsense
             return create_from({ stream_full_prefix(stream_id), stream_to_ros_type(stream_id.stream_type), "metadata" });
         }
 
+        /*version 4 and up*/
+        static std::string frame_metadata_record_topic(const device_serializer::stream_identifier& stream_id)
+        {
+            return create_from({ stream_full_prefix(stream_id), stream_to_ros_type(stream_id.stream_type), "metadata_record" });
+        }
+
         static std::string stream_extrinsic_topic(const device_serializer::stream_identifier& stream_id, uint32_t ref_id)
         {
             return create_from({ stream_full_prefix(stream_id), "tf", std::to_string(ref_id) });
@@ -515,7 +592,7 @@ namespace librealsense
     */
     constexpr uint32_t get_file_version()
     {
-        return 3u;
+        return 4u;
     }
 
     constexpr uint32_t get_minimum_supported_file_version()
@@ -9,6 +9,8 @@
 #include <core/serialization.h>
 #include "rosbag/view.h"
 #include "ros_file_format.h"
+#include "../../../third-party/realsense-file/lz4/lz4.h"
+#include "proc/depth-codec.h"
 
 namespace librealsense
 {
@@ -24,6 +26,16 @@ namespace librealsense
             m_version(0),
             m_metadata_parser_map(md_constant_parser::create_metadata_parser_map())
         {
+            // Played back frames are stamped through their delivery as the frames of devices are
+            m_metadata_parser_map->set(RS2_FRAME_METADATA_DEQUEUE_TIME, std::make_shared<md_stage_time_parser>(frame_stage::dequeue));
+            m_metadata_parser_map->set(RS2_FRAME_METADATA_UNPACK_TIME, std::make_shared<md_stage_time_parser>(frame_stage::unpack));
+            m_metadata_parser_map->set(RS2_FRAME_METADATA_SYNC_TIME, std::make_shared<md_stage_time_parser>(frame_stage::sync));
+            m_metadata_parser_map->set(RS2_FRAME_METADATA_CALLBACK_TIME, std::make_shared<md_stage_time_parser>(frame_stage::callback));
+            m_metadata_parser_map->set(RS2_FRAME_METADATA_DEPTH_MIN, std::make_shared<md_depth_statistics_parser>(RS2_FRAME_METADATA_DEPTH_MIN));
+            m_metadata_parser_map->set(RS2_FRAME_METADATA_DEPTH_MAX, std::make_shared<md_depth_statistics_parser>(RS2_FRAME_METADATA_DEPTH_MAX));
+            m_metadata_parser_map->set(RS2_FRAME_METADATA_DEPTH_MEAN, std::make_shared<md_depth_statistics_parser>(RS2_FRAME_METADATA_DEPTH_MEAN));
+            m_metadata_parser_map->set(RS2_FRAME_METADATA_DEPTH_FILL_RATE, std::make_shared<md_depth_statistics_parser>(RS2_FRAME_METADATA_DEPTH_FILL_RATE));
+            m_metadata_parser_map->set(RS2_FRAME_METADATA_DEPTH_HISTOGRAM, std::make_shared<md_depth_statistics_parser>(RS2_FRAME_METADATA_DEPTH_HISTOGRAM));
             try
             {
                 reset(); //Note: calling a virtual function inside c'tor, safe while base function is pure virtual
@@ -111,21 +123,26 @@ namespace librealsense
         std::vector<std::shared_ptr<serialized_data>> fetch_last_frames(const nanoseconds& seek_time) override
         {
             std::vector<std::shared_ptr<serialized_data>> result;
-            rosbag::View view(m_file, FalseQuery());
             auto as_rostime = to_rostime(seek_time);
             auto start_time = to_rostime(get_static_file_info_timestamp());
-            
-            for (auto topic : m_enabled_streams_topics)
-            {
-                view.addQuery(m_file, rosbag::TopicQuery(topic), start_time, as_rostime);
-            }
+
+            //The last message of every topic is found in its index, rather than by scanning the file up to the seek time
             std::map<device_serializer::stream_identifier, ros::Time> last_frames;
-            for (auto&& m : view)
+            for (auto topic : m_enabled_streams_topics)
             {
-                if (m.isType<sensor_msgs::Image>() || m.isType<sensor_msgs::Imu>())
+                ros::Time last_time;
+                if (!m_file.findLastMessageTime(topic, as_rostime, last_time) || last_time < start_time)
+                    continue;
+
+                rosbag::View view(m_file, rosbag::TopicQuery(topic), last_time, last_time);
+                for (auto&& m : view)
                 {
-                    auto id = ros_topic::get_stream_identifier(m.getTopic());
-                    last_frames[id] = m.getTime();
+                    if (m.isType<sensor_msgs::Image>() || m.isType<sensor_msgs::Imu>())
+                    {
+                        auto id = ros_topic::get_stream_identifier(m.getTopic());
+                        if (last_frames.find(id) == last_frames.end() || last_frames[id] < last_time)
+                            last_frames[id] = last_time;
+                    }
                 }
             }
             for (auto&& kvp : last_frames)
@@ -138,6 +155,19 @@ namespace librealsense
             }
             return result;
         }
+
+        void register_codec(frame_codec_ptr codec) override
+        {
+            std::lock_guard<std::mutex> lock(m_codecs_mutex);
+            m_codecs[codec->get_name()] = codec;
+        }
+
+        bool set_mapped_read(bool mapped) override
+        {
+            m_mapped_read = m_file.setMappedRead(mapped) && mapped;
+            return m_mapped_read == mapped;
+        }
+
         nanoseconds query_duration() const override
         {
             return m_total_duration;
@@ -146,7 +176,10 @@ namespace librealsense
         void reset() override
         {
             m_file.close();
+            m_file.setIndexFile(get_index_file_name(m_file_path));
             m_file.open(m_file_path, rosbag::BagMode::Read);
+            if (m_mapped_read && !m_file.setMappedRead(true))
+                m_mapped_read = false;
             m_version = read_file_version(m_file);
             m_samples_view = nullptr;
             m_frame_source = std::make_shared<frame_source>(m_version == 1 ? 128 : 32);
@@ -314,7 +347,7 @@ namespace librealsense
             const rosbag::MessageInstance &msg, 
             frame_additional_data& additional_data)
         {
-            uint32_t total_md_size = 0;
+            additional_data.metadata_blob.clear();
             rosbag::View frame_metadata_view(bag, legacy_file_format::FrameInfoExt(stream_id), msg.getTime(), msg.getTime());
             assert(frame_metadata_view.size() <= 1);
             for (auto message_instance : frame_metadata_view)
@@ -336,14 +369,12 @@ namespace librealsense
                         rs2_metadata_type value = *reinterpret_cast<const rs2_metadata_type*>(fmd.data.data());
                         auto size_of_enum = sizeof(rs2_frame_metadata_value);
                         auto size_of_data = sizeof(rs2_metadata_type);
-                        if (total_md_size + size_of_enum + size_of_data > 255)
+                        if (additional_data.metadata_blob.size() + size_of_enum + size_of_data > 255)
                         {
                             continue; //stop adding metadata to frame
                         }
-                        memcpy(additional_data.metadata_blob.data() + total_md_size, &type, size_of_enum);
-                        total_md_size += static_cast<uint32_t>(size_of_enum);
-                        memcpy(additional_data.metadata_blob.data() + total_md_size, &value, size_of_data);
-                        total_md_size += static_cast<uint32_t>(size_of_data);
+                        additional_data.metadata_blob.append(&type, size_of_enum);
+                        additional_data.metadata_blob.append(&value, size_of_data);
                     }
                 }
                 
@@ -379,7 +410,6 @@ namespace librealsense
             const rosbag::MessageInstance &msg, 
             frame_additional_data& additional_data)
         {
-            uint32_t total_md_size = 0;
             std::map<std::string, std::string> remaining;
             rosbag::View frame_metadata_view(bag, rosbag::TopicQuery(topic), msg.getTime(), msg.getTime());
 
@@ -416,20 +446,58 @@ namespace librealsense
                     }
                     auto size_of_enum = sizeof(rs2_frame_metadata_value);
                     auto size_of_data = sizeof(rs2_metadata_type);
-                    if (total_md_size + size_of_enum + size_of_data > 255)
+                    if (additional_data.metadata_blob.size() + size_of_enum + size_of_data > 255)
                     {
                         continue; //stop adding metadata to frame
                     }
-                    memcpy(additional_data.metadata_blob.data() + total_md_size, &type, size_of_enum);
-                    total_md_size += static_cast<uint32_t>(size_of_enum);
-                    memcpy(additional_data.metadata_blob.data() + total_md_size, &md, size_of_data);
-                    total_md_size += static_cast<uint32_t>(size_of_data);
+                    additional_data.metadata_blob.append(&type, size_of_enum);
+                    additional_data.metadata_blob.append(&md, size_of_data);
                 }
             }
-            additional_data.metadata_size = total_md_size;
             return remaining;
         }
 
+        /*Starting version 4*/
+        static void get_frame_metadata_record(const rosbag::Bag& bag,
+            const device_serializer::stream_identifier& stream_id,
+            const rosbag::MessageInstance &msg,
+            frame_additional_data& additional_data)
+        {
+            rosbag::View frame_metadata_view(bag, rosbag::TopicQuery(ros_topic::frame_metadata_record_topic(stream_id)), msg.getTime(), msg.getTime());
+            for (auto message_instance : frame_metadata_view)
+            {
+                auto record = instantiate_msg<std_msgs::UInt64MultiArray>(message_instance);
+                auto& words = record->data;
+                if (words.size() < METADATA_RECORD_HEADER_SIZE || (words.size() - METADATA_RECORD_HEADER_SIZE) % 2 != 0)
+                {
+                    LOG_WARNING("Invalid metadata record of " << words.size() << " words for " << stream_id);
+                    continue;
+                }
+
+                memcpy(&additional_data.system_time, &words[0], sizeof(additional_data.system_time));
+                if (words[1] < RS2_TIMESTAMP_DOMAIN_COUNT)
+                    additional_data.timestamp_domain = static_cast<rs2_timestamp_domain>(words[1]);
+
+                for (size_t i = METADATA_RECORD_HEADER_SIZE; i < words.size(); i += 2)
+                {
+                    if (words[i] >= RS2_FRAME_METADATA_COUNT)
+                    {
+                        continue; //metadata of a later version of the library
+                    }
+                    auto type = static_cast<rs2_frame_metadata_value>(words[i]);
+                    auto md = static_cast<rs2_metadata_type>(words[i + 1]);
+                    auto size_of_enum = sizeof(rs2_frame_metadata_value);
+                    auto size_of_data = sizeof(rs2_metadata_type);
+                    if (additional_data.metadata_blob.size() + size_of_enum + size_of_data > 255)
+                    {
+                        break; //stop adding metadata to frame
+                    }
+                    additional_data.metadata_blob.append(&type, size_of_enum);
+                    additional_data.metadata_blob.append(&md, size_of_data);
+                }
+            }
+        }
+
         frame_holder create_image_from_message(const rosbag::MessageInstance &image_data) const
         {
             LOG_DEBUG("Trying to create an image frame from message");
@@ -451,12 +519,37 @@ namespace librealsense
             {
                 //Version 2 and above
                 stream_id = ros_topic::get_stream_identifier(image_data.getTopic());
-                auto info_topic = ros_topic::frame_metadata_topic(stream_id);
-                get_frame_metadata(m_file, info_topic, stream_id, image_data, additional_data);
+                if (m_version >= 4)
+                {
+                    get_frame_metadata_record(m_file, stream_id, image_data, additional_data);
+                }
+                else
+                {
+                    auto info_topic = ros_topic::frame_metadata_topic(stream_id);
+                    get_frame_metadata(m_file, info_topic, stream_id, image_data, additional_data);
+                }
             }
 
+            auto encoding = msg->encoding;
+            auto codec_name = strip_codec_image_encoding(encoding);
+            auto compression = strip_compressed_image_encoding(encoding);
+            frame_codec_ptr codec;
+            if (!codec_name.empty())
+            {
+                std::lock_guard<std::mutex> lock(m_codecs_mutex);
+                auto it = m_codecs.find(codec_name);
+                if (it == m_codecs.end())
+                {
+                    LOG_WARNING("No codec \"" << codec_name << "\" is registered to decode frame " << msg->header.seq << " of " << stream_id);
+                    return nullptr;
+                }
+                codec = it->second;
+            }
+            // Raw images are the data of the message itself, held by the frame, and the others are decoded into the frame
+            auto size = codec || compression != RS2_RECORD_COMPRESSION_NONE ? static_cast<size_t>(msg->step) * msg->height : 0;
+
             frame_interface* frame = m_frame_source->alloc_frame((stream_id.stream_type == RS2_STREAM_DEPTH) ? RS2_EXTENSION_DEPTH_FRAME : RS2_EXTENSION_VIDEO_FRAME,
-                msg->data.size(), additional_data, true);
+                size, additional_data, true);
             if (frame == nullptr)
             {
                 LOG_WARNING("Failed to allocate new frame");
@@ -465,14 +558,45 @@ namespace librealsense
             librealsense::video_frame* video_frame = static_cast<librealsense::video_frame*>(frame);
             video_frame->assign(msg->width, msg->height, msg->step, msg->step / msg->width * 8);
             rs2_format stream_format;
-            convert(msg->encoding, stream_format);
+            convert(encoding, stream_format);
             //attaching a temp stream to the frame. Playback sensor should assign the real stream
             frame->set_stream(std::make_shared<video_stream_profile>(platform::stream_profile{}));
             frame->get_stream()->set_format(stream_format);
             frame->get_stream()->set_stream_index(stream_id.stream_index);
             frame->get_stream()->set_stream_type(stream_id.stream_type);
-            video_frame->data = std::move(msg->data);
             librealsense::frame_holder fh{ video_frame };
+            if (codec)
+            {
+                // Decoded from the message, held until then, when the data of the frame is first accessed
+                int width = msg->width, height = msg->height, stride = msg->step;
+                auto encoded_size = static_cast<int>(msg->data.size());
+                auto frame_number = msg->header.seq;
+                video_frame->attach_continuation(frame_continuation{ [msg]() {}, msg->data.data() });
+                video_frame->defer_unpack([codec, encoded_size, width, height, stride, stream_format, frame_number, stream_id](byte* dest, const byte* source)
+                {
+                    if (!codec->decode(source, encoded_size, width, height, stride, stream_format, dest))
+                    {
+                        LOG_WARNING("Failed to decode frame " << frame_number << " of " << stream_id << " with codec \"" << codec->get_name() << "\"");
+                        std::fill(dest, dest + static_cast<size_t>(stride) * height, byte(0));
+                    }
+                });
+            }
+            else if (compression != RS2_RECORD_COMPRESSION_NONE)
+            {
+                auto decompressed = compression == RS2_RECORD_COMPRESSION_RVL ?
+                    rvl_decode(msg->data.data(), msg->data.size(), reinterpret_cast<uint16_t*>(video_frame->data.data()), size / 2) :
+                    LZ4_decompress_safe(reinterpret_cast<const char*>(msg->data.data()), reinterpret_cast<char*>(video_frame->data.data()),
+                                        static_cast<int>(msg->data.size()), static_cast<int>(size)) == static_cast<int>(size);
+                if (!decompressed)
+                {
+                    LOG_WARNING("Failed to decompress frame " << msg->header.seq << " of " << stream_id);
+                    return nullptr;
+                }
+            }
+            else
+            {
+                video_frame->attach_continuation(frame_continuation{ [msg]() {}, msg->data.data() });
+            }
             LOG_DEBUG("Created image frame: " << stream_id << " " << video_frame->get_width() << "x" << video_frame->get_height() << " " << stream_format);
 
             return std::move(fh);
@@ -501,8 +625,15 @@ namespace librealsense
             {
                 //Version 2 and above
                 stream_id = ros_topic::get_stream_identifier(motion_data.getTopic());
-                auto info_topic = ros_topic::frame_metadata_topic(stream_id);
-                get_frame_metadata(m_file, info_topic, stream_id, motion_data, additional_data);
+                if (m_version >= 4)
+                {
+                    get_frame_metadata_record(m_file, stream_id, motion_data, additional_data);
+                }
+                else
+                {
+                    auto info_topic = ros_topic::frame_metadata_topic(stream_id);
+                    get_frame_metadata(m_file, info_topic, stream_id, motion_data, additional_data);
+                }
             }
 
             frame_interface* frame = m_frame_source->alloc_frame(RS2_EXTENSION_MOTION_FRAME, 3 * sizeof(float), additional_data, true);
@@ -622,6 +753,11 @@ namespace librealsense
                 stream_id = ros_topic::get_stream_identifier(msg.getTopic());
                 auto info_topic = ros_topic::frame_metadata_topic(stream_id);
                 auto remaining = get_frame_metadata(m_file, info_topic, stream_id, msg, additional_data);
+                if (m_version >= 4)
+                {
+                    //Only what is particular to pose frames is written as key-value messages
+                    get_frame_metadata_record(m_file, stream_id, msg, additional_data);
+                }
                 for (auto&& kvp : remaining)
                 {
                     if (kvp.first == MAPPER_CONFIDENCE_MD_STR)
@@ -1244,5 +1380,8 @@ namespace librealsense
         std::shared_ptr<metadata_parser_map>    m_metadata_parser_map;
         std::shared_ptr<context>                m_context;
         uint32_t                                m_version;
+        std::map<std::string, frame_codec_ptr>  m_codecs;
+        mutable std::mutex                      m_codecs_mutex;
+        bool                                    m_mapped_read = false;
     };
 }
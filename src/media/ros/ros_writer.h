@@ -14,6 +14,80 @@
 #include "stream.h"
 #include "rosbag/bag.h"
 #include "ros_file_format.h"
+#include "../../../third-party/realsense-file/lz4/lz4.h"
+#include "../../../third-party/realsense-file/lz4/lz4hc.h"
+#include "proc/depth-codec.h"
+
+namespace librealsense
+{
+    // A sensor_msgs::Image of data it does not own, serialized into the bag straight from the buffer of the frame instead of
+    // through a copy into the message. Written as a sensor_msgs::Image, of the same type, checksum and serialized layout
+    struct image_view
+    {
+        std_msgs::Header header;
+        uint32_t height = 0;
+        uint32_t width = 0;
+        std::string encoding;
+        uint8_t is_bigendian = 0;
+        uint32_t step = 0;
+        const uint8_t* data = nullptr;
+        uint32_t size = 0;
+    };
+}
+
+namespace ros
+{
+    namespace message_traits
+    {
+        template<> struct IsFixedSize<librealsense::image_view> : FalseType {};
+        template<> struct IsMessage<librealsense::image_view> : TrueType {};
+        template<> struct HasHeader<librealsense::image_view> : TrueType {};
+
+        template<> struct MD5Sum<librealsense::image_view>
+        {
+            static const char* value() { return MD5Sum<sensor_msgs::Image>::value(); }
+            static const char* value(const librealsense::image_view&) { return value(); }
+        };
+
+        template<> struct DataType<librealsense::image_view>
+        {
+            static const char* value() { return DataType<sensor_msgs::Image>::value(); }
+            static const char* value(const librealsense::image_view&) { return value(); }
+        };
+
+        template<> struct Definition<librealsense::image_view>
+        {
+            static const char* value() { return Definition<sensor_msgs::Image>::value(); }
+            static const char* value(const librealsense::image_view&) { return value(); }
+        };
+    }
+
+    namespace serialization
+    {
+        // The fields of sensor_msgs::Image in order, the data as a uint8[] of its length and bytes
+        template<> struct Serializer<librealsense::image_view>
+        {
+            template<typename Stream> inline static void write(Stream& stream, const librealsense::image_view& m)
+            {
+                stream.next(m.header);
+                stream.next(m.height);
+                stream.next(m.width);
+                stream.next(m.encoding);
+                stream.next(m.is_bigendian);
+                stream.next(m.step);
+                stream.next(m.size);
+                if (m.size)
+                    memcpy(stream.advance(m.size), m.data, m.size);
+            }
+
+            inline static uint32_t serializedLength(const librealsense::image_view& m)
+            {
+                return serializationLength(m.header) + serializationLength(m.encoding) +
+                    sizeof(m.height) + sizeof(m.width) + sizeof(m.is_bigendian) + sizeof(m.step) + sizeof(m.size) + m.size;
+            }
+        };
+    }
+}
 
 namespace librealsense
 {
@@ -24,6 +98,7 @@ namespace librealsense
     public:
         explicit ros_writer(const std::string& file) : m_file_path(file)
         {
+            m_bag.setIndexFile(get_index_file_name(file));
             m_bag.open(file, rosbag::BagMode::Write);
             m_bag.setCompression(rosbag::CompressionType::LZ4);
             write_file_version();
@@ -46,10 +121,88 @@ namespace librealsense
         }
 
         void write_frame(const stream_identifier& stream_id, const nanoseconds& timestamp, frame_holder&& frame) 
+        {
+            write_compressed_frame(stream_id, timestamp, std::move(frame), {});
+        }
+
+        compressed_payload compress_frame(const frame_interface& frame, rs2_record_compression compression) const override
+        {
+            compressed_payload payload;
+            auto vid_frame = dynamic_cast<const librealsense::video_frame*>(&frame);
+            if (compression == RS2_RECORD_COMPRESSION_NONE || !vid_frame)
+                return payload;
+
+            auto size = vid_frame->get_stride() * vid_frame->get_height();
+            if (size <= 0 || size > LZ4_MAX_INPUT_SIZE)
+                return payload;
+
+            if (compression == RS2_RECORD_COMPRESSION_RVL)
+            {
+                if (vid_frame->get_stream()->get_format() == RS2_FORMAT_Z16 && vid_frame->get_stride() == vid_frame->get_width() * 2)
+                {
+                    auto count = static_cast<size_t>(size) / 2;
+                    payload.data.resize(rvl_max_encoded_size(count));
+                    payload.data.resize(rvl_encode(reinterpret_cast<const uint16_t*>(vid_frame->get_frame_data()), count, payload.data.data()));
+                    if (payload.data.size() >= static_cast<size_t>(size))
+                        payload.data.clear();
+                    else
+                        payload.compression = compression;
+                    return payload;
+                }
+                compression = RS2_RECORD_COMPRESSION_LZ4;
+            }
+
+            auto src = reinterpret_cast<const char*>(vid_frame->get_frame_data());
+            payload.data.resize(LZ4_compressBound(size));
+            auto dst = reinterpret_cast<char*>(payload.data.data());
+            auto dst_size = static_cast<int>(payload.data.size());
+            auto compressed = compression == RS2_RECORD_COMPRESSION_LZ4HC ?
+                LZ4_compress_HC(src, dst, size, dst_size, LZ4HC_CLEVEL_DEFAULT) :
+                LZ4_compress_default(src, dst, size, dst_size);
+
+            // Frames that do not compress are written as they are
+            if (compressed <= 0 || compressed >= size)
+            {
+                payload.data.clear();
+                return payload;
+            }
+            payload.data.resize(compressed);
+            payload.compression = compression;
+            return payload;
+        }
+
+        compressed_payload encode_frame(const frame_interface& frame, rs2_frame_codec& codec) const override
+        {
+            compressed_payload payload;
+            auto vid_frame = dynamic_cast<const librealsense::video_frame*>(&frame);
+            if (!vid_frame)
+                return payload;
+
+            // Encoded data larger than the frame is of no use
+            auto size = vid_frame->get_stride() * vid_frame->get_height();
+            if (size <= 0)
+                return payload;
+            payload.data.resize(size);
+
+            // The codec releases the frame, as callbacks do
+            auto f = const_cast<frame_interface*>(&frame);
+            f->acquire();
+            auto encoded = codec.encode(reinterpret_cast<rs2_frame*>(f), payload.data.data(), size);
+            if (encoded <= 0 || encoded > size)
+            {
+                payload.data.clear();
+                return payload;
+            }
+            payload.data.resize(encoded);
+            payload.codec = codec.get_name();
+            return payload;
+        }
+
+        void write_compressed_frame(const stream_identifier& stream_id, const nanoseconds& timestamp, frame_holder&& frame, compressed_payload&& payload) override
         {
             if (Is<video_frame>(frame.frame))
             {
-                write_video_frame(stream_id, timestamp, std::move(frame));
+                write_video_frame(stream_id, timestamp, std::move(frame), std::move(payload));
                 return;
             }
 
@@ -81,6 +234,11 @@ namespace librealsense
             return m_file_path;
         }
 
+        uint64_t get_written_size() const override
+        {
+            return m_bag.getSize();
+        }
+
     private:
         void write_file_version()
         {
@@ -92,29 +250,26 @@ namespace librealsense
 
         void write_frame_metadata(const stream_identifier& stream_id, const nanoseconds& timestamp, frame_interface* frame)
         {
-            auto metadata_topic = ros_topic::frame_metadata_topic(stream_id);
-            diagnostic_msgs::KeyValue system_time;
-            system_time.key = SYSTEM_TIME_MD_STR;
-            system_time.value = std::to_string(frame->get_frame_system_time());
-            write_message(metadata_topic, timestamp, system_time);
+            std_msgs::UInt64MultiArray record;
+            record.data.reserve(METADATA_RECORD_HEADER_SIZE + 2 * RS2_FRAME_METADATA_COUNT);
 
-            diagnostic_msgs::KeyValue timestamp_domain;
-            timestamp_domain.key = TIMESTAMP_DOMAIN_MD_STR;
-            timestamp_domain.value = librealsense::get_string(frame->get_frame_timestamp_domain());
-            write_message(metadata_topic, timestamp, timestamp_domain);
+            uint64_t system_time = 0;
+            auto frame_system_time = frame->get_frame_system_time();
+            static_assert(sizeof(system_time) == sizeof(frame_system_time), "System time does not fit a metadata record word");
+            memcpy(&system_time, &frame_system_time, sizeof(system_time));
+            record.data.push_back(system_time);
+            record.data.push_back(static_cast<uint64_t>(frame->get_frame_timestamp_domain()));
 
             for (int i = 0; i < static_cast<rs2_frame_metadata_value>(rs2_frame_metadata_value::RS2_FRAME_METADATA_COUNT); i++)
             {
                 rs2_frame_metadata_value type = static_cast<rs2_frame_metadata_value>(i);
                 if (frame->supports_frame_metadata(type))
                 {
-                    auto md = frame->get_frame_metadata(type);
-                    diagnostic_msgs::KeyValue md_msg;
-                    md_msg.key = librealsense::get_string(type);
-                    md_msg.value = std::to_string(md);
-                    write_message(metadata_topic, timestamp, md_msg);
+                    record.data.push_back(static_cast<uint64_t>(type));
+                    record.data.push_back(static_cast<uint64_t>(frame->get_frame_metadata(type)));
                 }
             }
+            write_message(ros_topic::frame_metadata_record_topic(stream_id), timestamp, record);
         }
 
         void write_extrinsics(const stream_identifier& stream_id, frame_interface* frame)
@@ -172,9 +327,9 @@ namespace librealsense
             }
         }
 
-        void write_video_frame(const stream_identifier& stream_id, const nanoseconds& timestamp, frame_holder&& frame)
+        void write_video_frame(const stream_identifier& stream_id, const nanoseconds& timestamp, frame_holder&& frame, compressed_payload&& payload)
         {
-            sensor_msgs::Image image;
+            image_view image;
             auto vid_frame = dynamic_cast<librealsense::video_frame*>(frame.frame);
             assert(vid_frame != nullptr);
 
@@ -183,9 +338,23 @@ namespace librealsense
             image.step = static_cast<uint32_t>(vid_frame->get_stride());
             convert(vid_frame->get_stream()->get_format(), image.encoding);
             image.is_bigendian = is_big_endian();
-            auto size = vid_frame->get_stride() * vid_frame->get_height();
-            auto p_data = vid_frame->get_frame_data();
-            image.data.assign(p_data, p_data + size);
+            if (!payload.codec.empty())
+            {
+                image.encoding = codec_image_encoding(image.encoding, payload.codec);
+                image.data = payload.data.data();
+                image.size = static_cast<uint32_t>(payload.data.size());
+            }
+            else if (payload.compression != RS2_RECORD_COMPRESSION_NONE)
+            {
+                image.encoding = compressed_image_encoding(image.encoding, payload.compression);
+                image.data = payload.data.data();
+                image.size = static_cast<uint32_t>(payload.data.size());
+            }
+            else
+            {
+                image.data = vid_frame->get_frame_data();
+                image.size = static_cast<uint32_t>(vid_frame->get_stride() * vid_frame->get_height());
+            }
             image.header.seq = static_cast<uint32_t>(vid_frame->get_frame_number());
             std::chrono::duration<double, std::milli> timestamp_ms(vid_frame->get_frame_timestamp());
             image.header.stamp = ros::Time(std::chrono::duration<double>(timestamp_ms).count());
@@ -198,39 +367,59 @@ namespace librealsense
 
         void write_motion_frame(const stream_identifier& stream_id, const nanoseconds& timestamp, frame_holder&& frame)
         {
-            sensor_msgs::Imu imu_msg;
             if (!frame)
             {
                 throw io_exception("Null frame passed to write_motion_frame");
             }
-            
-            imu_msg.header.seq = static_cast<uint32_t>(frame.frame->get_frame_number());
-            std::chrono::duration<double, std::milli> timestamp_ms(frame.frame->get_frame_timestamp());
+
+            if (stream_id.stream_type != RS2_STREAM_ACCEL && stream_id.stream_type != RS2_STREAM_GYRO)
+            {
+                throw io_exception("Unsupported stream type for a motion frame");
+            }
+
+            // The samples of a batched frame are written as a message each, with their own timestamp, and sharing the
+            // metadata of the frame. They are played back as a frame each
+            auto topic = ros_topic::frame_data_topic(stream_id);
+            auto mf = static_cast<motion_frame*>(frame.frame);
+            if (mf->is_batched())
+            {
+                auto samples = reinterpret_cast<const rs2_motion_sample*>(frame.frame->get_frame_data());
+                auto count = mf->data.size() / sizeof(rs2_motion_sample);
+                for (size_t i = 0; i < count; i++)
+                {
+                    write_message(topic, timestamp, to_imu_msg(stream_id, frame.frame->get_frame_number() + i, samples[i].timestamp,
+                        &samples[i].motion.x));
+                }
+            }
+            else
+            {
+                write_message(topic, timestamp, to_imu_msg(stream_id, frame.frame->get_frame_number(), frame.frame->get_frame_timestamp(),
+                    reinterpret_cast<const float*>(frame.frame->get_frame_data())));
+            }
+            write_additional_frame_messages(stream_id, timestamp, frame);
+        }
+
+        sensor_msgs::Imu to_imu_msg(const stream_identifier& stream_id, unsigned long long frame_number, double timestamp, const float* data_ptr)
+        {
+            sensor_msgs::Imu imu_msg;
+            imu_msg.header.seq = static_cast<uint32_t>(frame_number);
+            std::chrono::duration<double, std::milli> timestamp_ms(timestamp);
             imu_msg.header.stamp = ros::Time(std::chrono::duration<double>(timestamp_ms).count());
             std::string TODO_CORRECT_ME = "0";
             imu_msg.header.frame_id = TODO_CORRECT_ME;
-            auto data_ptr = reinterpret_cast<const float*>(frame.frame->get_frame_data());
             if (stream_id.stream_type == RS2_STREAM_ACCEL)
             {
                 imu_msg.linear_acceleration.x = data_ptr[0];
                 imu_msg.linear_acceleration.y = data_ptr[1];
                 imu_msg.linear_acceleration.z = data_ptr[2];
             }
-           
-            else if (stream_id.stream_type == RS2_STREAM_GYRO)
+            else
             {
                 imu_msg.angular_velocity.x = data_ptr[0];
                 imu_msg.angular_velocity.y = data_ptr[1];
-                imu_msg.angular_velocity.z = data_ptr[2]; 
-            }
-            else
-            {
-                throw io_exception("Unsupported stream type for a motion frame");
+                imu_msg.angular_velocity.z = data_ptr[2];
             }
-
-            auto topic = ros_topic::frame_data_topic(stream_id);
-            write_message(topic, timestamp, imu_msg);
-            write_additional_frame_messages(stream_id, timestamp, frame);
+            return imu_msg;
         }
 
         inline geometry_msgs::Vector3 to_vector3(const float3& f)
@@ -30,6 +30,15 @@ namespace librealsense
         virtual rs2_metadata_type get(const frame& frm) const = 0;
         virtual bool supports(const frame& frm) const = 0;
 
+        // Both in one call, without throwing for the attributes the frame does not support
+        virtual bool try_get(const frame& frm, rs2_metadata_type& result) const
+        {
+            if (!supports(frm))
+                return false;
+            result = get(frm);
+            return true;
+        }
+
         virtual ~md_attribute_parser_base() = default;
     };
 
@@ -59,16 +68,16 @@ namespace librealsense
             for (int i = 0; i < static_cast<int>(rs2_frame_metadata_value::RS2_FRAME_METADATA_COUNT); ++i)
             {
                 auto frame_md_type = static_cast<rs2_frame_metadata_value>(i);
-                md_parser_map->insert(std::make_pair(frame_md_type, std::make_shared<md_constant_parser>(frame_md_type)));
+                md_parser_map->set(frame_md_type, std::make_shared<md_constant_parser>(frame_md_type));
             }
             return md_parser_map;
         }
-    private:
-        bool try_get(const frame& frm, rs2_metadata_type& result) const
+
+        bool try_get(const frame& frm, rs2_metadata_type& result) const override
         {
             auto pair_size = (sizeof(rs2_frame_metadata_value) + sizeof(rs2_metadata_type));
             const uint8_t* pos = frm.additional_data.metadata_blob.data();
-            while (pos <= frm.additional_data.metadata_blob.data() + frm.additional_data.metadata_blob.size())
+            while (pos + pair_size <= frm.additional_data.metadata_blob.data() + frm.additional_data.metadata_blob.size())
             {
                 const rs2_frame_metadata_value* type = reinterpret_cast<const rs2_frame_metadata_value*>(pos);
                 pos += sizeof(rs2_frame_metadata_value);
@@ -104,6 +113,70 @@ namespace librealsense
         }
     };
 
+    /**\brief Monotonic time, in microseconds, the frame went through a stage of its delivery */
+    class md_stage_time_parser : public md_attribute_parser_base
+    {
+    public:
+        explicit md_stage_time_parser(frame_stage stage) : _stage(stage) {}
+
+        rs2_metadata_type get(const frame& frm) const override
+        {
+            return (rs2_metadata_type)(frm.get_stage_time(_stage) * 1000);
+        }
+
+        bool supports(const frame& frm) const override
+        {
+            return frm.get_stage_time(_stage) != 0;
+        }
+
+    private:
+        frame_stage _stage;
+    };
+
+    /**\brief Statistics of the depth of the frame, attached by the depth statistics block or the filters computing them */
+    class md_depth_statistics_parser : public md_attribute_parser_base
+    {
+    public:
+        explicit md_depth_statistics_parser(rs2_frame_metadata_value type) : _type(type) {}
+
+        rs2_metadata_type get(const frame& frm) const override
+        {
+            auto&& stats = frm.additional_data.depth_stats;
+            if (!stats.pixels)
+                throw invalid_value_exception("Frame has no depth statistics");
+
+            switch (_type)
+            {
+            case RS2_FRAME_METADATA_DEPTH_MIN: return stats.valid ? stats.min : 0;
+            case RS2_FRAME_METADATA_DEPTH_MAX: return stats.max;
+            case RS2_FRAME_METADATA_DEPTH_MEAN: return stats.valid ? (rs2_metadata_type)((stats.sum + stats.valid / 2) / stats.valid) : 0;
+            case RS2_FRAME_METADATA_DEPTH_FILL_RATE: return (rs2_metadata_type)((uint64_t(stats.valid) * 10000 + stats.pixels / 2) / stats.pixels);
+            case RS2_FRAME_METADATA_DEPTH_HISTOGRAM:
+            {
+                uint64_t packed = 0;
+                if (stats.valid)
+                {
+                    for (int i = 0; i < depth_statistics::histogram_bins; ++i)
+                    {
+                        uint64_t bin = (uint64_t(stats.histogram[i]) * 255 + stats.valid / 2) / stats.valid;
+                        packed |= bin << (8 * i);
+                    }
+                }
+                return (rs2_metadata_type)packed;
+            }
+            default: throw invalid_value_exception(to_string() << rs2_frame_metadata_to_string(_type) << " is not a depth statistic");
+            }
+        }
+
+        bool supports(const frame& frm) const override
+        {
+            return frm.additional_data.depth_stats.pixels != 0;
+        }
+
+    private:
+        rs2_frame_metadata_value _type;
+    };
+
     /**\brief The metadata parser class directly access the metadata attribute in the blob received from HW.
     *   Given the metadata-nested construct, and the c++ lack of pointers
     *   to the inner struct, we pre-calculate and store the attribute offset internally
@@ -117,7 +190,7 @@ namespace librealsense
 
         rs2_metadata_type get(const librealsense::frame & frm) const override
         {
-            auto s = reinterpret_cast<const S*>(((const uint8_t*)frm.additional_data.metadata_blob.data()) + _offset);
+            auto s = find(frm);
 
             if (!is_attribute_valid(s))
                 throw invalid_value_exception("metadata not available");
@@ -130,15 +203,38 @@ namespace librealsense
         // Verifies that the parameter is both supported and available
         bool supports(const librealsense::frame & frm) const override
         {
-            auto s = reinterpret_cast<const S*>(((const uint8_t*)frm.additional_data.metadata_blob.data()) + _offset);
+            auto s = find(frm);
 
             return is_attribute_valid(s);
         }
 
+        bool try_get(const librealsense::frame & frm, rs2_metadata_type& result) const override
+        {
+            auto s = find(frm);
+
+            if (!is_attribute_valid(s))
+                return false;
+
+            result = static_cast<rs2_metadata_type>((*s).*_md_attribute);
+            if (_modifyer) result = _modifyer(result);
+            return true;
+        }
+
     protected:
 
+            // The struct within the metadata, null when the metadata is too short to hold it
+            const S* find(const librealsense::frame & frm) const
+            {
+                if (frm.additional_data.metadata_blob.size() < _offset + sizeof(S))
+                    return nullptr;
+                return reinterpret_cast<const S*>(frm.additional_data.metadata_blob.data() + _offset);
+            }
+
             bool is_attribute_valid(const S* s) const
             {
+                if (!s)
+                    return false;
+
                 // verify that the struct is of the correct type
                 // Check that the header id and the struct size corresponds.
                 // Note that this heurisic is not deterministic and may validate false frames! TODO - requires review
@@ -200,7 +296,7 @@ namespace librealsense
         }
 
         bool supports(const librealsense::frame & frm) const override
-        { return (frm.additional_data.metadata_size >= platform::uvc_header_size); }
+        { return (frm.additional_data.metadata_blob.size() >= platform::uvc_header_size); }
 
     private:
         md_uvc_header_parser() = delete;
@@ -394,7 +490,7 @@ namespace librealsense
 
         bool supports(const librealsense::frame & frm) const override
         {
-            return (frm.additional_data.metadata_size >= (sizeof(S) + platform::uvc_header_size));
+            return (frm.additional_data.metadata_blob.size() >= (sizeof(S) + platform::uvc_header_size));
         }
 
     private:
@@ -7,6 +7,8 @@
 #include <algorithm>
 #include "types.h"
 #include <iostream>
+#include <condition_variable>
+#include "../../third-party/realsense-file/lz4/lz4.h"
 
 using namespace std;
 using namespace sql;
@@ -70,31 +72,20 @@ namespace librealsense
             hid_input
         };
 
-        int compression_algorithm::dist(uint32_t x, uint32_t y) const
-        {
-            union {
-                uint32_t block;
-                uint8_t bytes[4];
-            } xu;
-            union {
-                uint32_t block;
-                uint8_t bytes[4];
-            } yu;
-            xu.block = x;
-            yu.block = y;
-            auto diff_sum = 0;
-            for (auto i = 0; i < 4; i++)
-            {
-                auto dist = abs(xu.bytes[i] - yu.bytes[i]);
-                diff_sum += dist * dist;
-            }
-            return diff_sum;
+        vector<uint8_t> compression_algorithm::decode(const vector<uint8_t>& input, size_t size) const
+        {
+            vector<uint8_t> results(size);
+            auto decoded = LZ4_decompress_safe(reinterpret_cast<const char*>(input.data()), reinterpret_cast<char*>(results.data()),
+                static_cast<int>(input.size()), static_cast<int>(size));
+            if (decoded != static_cast<int>(size))
+                throw runtime_error(to_string() << "Recorded frame could not be decompressed, " << decoded << " of " << size << " bytes");
+            return results;
         }
 
-        vector<uint8_t> compression_algorithm::decode(const vector<uint8_t>& input) const
+        vector<uint8_t> compression_algorithm::decode_runs(const vector<uint8_t>& input) const
         {
             vector<uint8_t> results;
-            for (size_t i = 0; i < input.size() - 5; i += 5)
+            for (size_t i = 0; i + 5 < input.size(); i += 5)
             {
                 union {
                     uint32_t block;
@@ -111,68 +102,48 @@ namespace librealsense
             return results;
         }
 
-        vector<uint8_t> compression_algorithm::encode(uint8_t* data, size_t size) const
+        vector<uint8_t> compression_algorithm::encode(const uint8_t* data, size_t size) const
         {
-            vector<uint8_t> results;
-            union {
-                uint32_t block;
-                uint8_t bytes[4];
-            } curr_block;
-            curr_block.block = *reinterpret_cast<const uint32_t*>(data);
-            uint8_t length = 0;
-            for (size_t i = 0; i < size; i += 4)
-            {
-                auto block = *reinterpret_cast<const uint32_t*>(data + i);
-                if (dist(block, curr_block.block) < min_dist && length < max_length)
-                {
-                    length++;
-                }
-                else
-                {
-                    for (auto j = 0; j < 4; j++)
-                        results.push_back(curr_block.bytes[j]);
-                    results.push_back(length);
-                    curr_block.block = block;
-                    length = 1;
-                }
-            }
-            if (length)
-            {
-                for (auto j = 0; j < 4; j++)
-                    results.push_back(curr_block.bytes[j]);
-                results.push_back(length);
-            }
+            vector<uint8_t> results(LZ4_compressBound(static_cast<int>(size)));
+            auto compressed = LZ4_compress_default(reinterpret_cast<const char*>(data), reinterpret_cast<char*>(results.data()),
+                static_cast<int>(size), static_cast<int>(results.size()));
+            if (compressed <= 0)
+                throw runtime_error(to_string() << "Frame of " << size << " bytes could not be compressed");
+            results.resize(compressed);
             return results;
         }
 
-        recording::recording(std::shared_ptr<time_service> ts, std::shared_ptr<playback_device_watcher> watcher)
-            :_ts(ts), _watcher(watcher)
+        // Writes the blobs of a recording from a thread of its own, batching them in a transaction every
+        // write_interval so that the frame callbacks saving them only queue them
+        class recording_writer
         {
-        }
+        public:
+            recording_writer(const char* filename, const char* section, bool append);
+            ~recording_writer();
 
-        void recording::invoke_device_changed_event()
-        {
-            call* next;
-            do
-            {
-                backend_device_group old, curr;
-                lookup_key k{ 0, call_type::device_watcher_event };
-                load_device_changed_data(old, curr, k);
-                _watcher->raise_callback(old, curr);
-                next = pick_next_call();
-            } while (next && next->type == call_type::device_watcher_event);
-        }
+            void write_blob(vector<uint8_t> blob);
+            // Writes the blobs queued and stops the thread, after which the connection is for the caller to use
+            void stop();
 
-        rs2_time_t recording::get_time()
-        {
-            return _curr_time;
-        }
+            const connection& get_connection() const { return _connection; }
+            int get_section() const { return _section; }
 
-        void recording::save(const char* filename, const char* section, bool append) const
-        {
-            connection c(filename);
-            LOG_WARNING("Saving recording to file, don't close the application");
+        private:
+            void write_blobs();
+
+            const std::chrono::milliseconds write_interval{ 200 };
 
+            connection _connection;
+            int _section;
+            std::mutex _mutex;
+            std::condition_variable _cv;
+            vector<vector<uint8_t>> _queue;
+            bool _stopping;
+            std::thread _thread;
+        };
+
+        static int open_section(const connection& c, const char* filename, const char* section, bool append)
+        {
             if (!c.table_exists(CONFIG_TABLE))
             {
                 c.execute(SECTIONS_CREATE);
@@ -249,67 +220,183 @@ namespace librealsense
                 }
             }
 
+            return section_id;
+        }
+
+        recording_writer::recording_writer(const char* filename, const char* section, bool append)
+            : _connection(filename), _section(open_section(_connection, filename, section, append)), _stopping(false),
+            _thread([this]() { write_blobs(); })
+        {
+        }
+
+        recording_writer::~recording_writer()
+        {
+            stop();
+        }
+
+        void recording_writer::write_blob(vector<uint8_t> blob)
+        {
+            lock_guard<std::mutex> lock(_mutex);
+            _queue.push_back(move(blob));
+        }
+
+        void recording_writer::stop()
+        {
+            {
+                lock_guard<std::mutex> lock(_mutex);
+                _stopping = true;
+            }
+            _cv.notify_one();
+            if (_thread.joinable())
+                _thread.join();
+        }
+
+        void recording_writer::write_blobs()
+        {
+            statement insert(_connection, BLOBS_INSERT);
+            vector<vector<uint8_t>> batch;
+            bool stopping = false;
+            while (!stopping)
+            {
+                {
+                    unique_lock<std::mutex> lock(_mutex);
+                    _cv.wait_for(lock, write_interval, [this]() { return _stopping; });
+                    stopping = _stopping;
+                    batch.swap(_queue);
+                }
+                if (batch.empty())
+                    continue;
+
+                try
+                {
+                    _connection.transaction([&]()
+                    {
+                        for (auto&& blob : batch)
+                        {
+                            insert.bind(1, _section);
+                            insert.bind(2, blob);
+                            insert();
+                            insert.reset();
+                        }
+                    });
+                }
+                catch (const std::exception& e)
+                {
+                    LOG_ERROR("Recording blobs could not be written: " << e.what());
+                }
+                batch.clear();
+            }
+        }
+
+        recording::recording(std::shared_ptr<time_service> ts, std::shared_ptr<playback_device_watcher> watcher)
+            :_ts(ts), _watcher(watcher)
+        {
+        }
+
+        void recording::invoke_device_changed_event()
+        {
+            call* next;
+            do
+            {
+                backend_device_group old, curr;
+                lookup_key k{ 0, call_type::device_watcher_event };
+                load_device_changed_data(old, curr, k);
+                _watcher->raise_callback(old, curr);
+                next = pick_next_call();
+            } while (next && next->type == call_type::device_watcher_event);
+        }
+
+        rs2_time_t recording::get_time()
+        {
+            return _curr_time;
+        }
+
+        void recording::start_saving(const char* filename, const char* section)
+        {
+            lock_guard<recursive_mutex> lock(_mutex);
+            _writer = make_shared<recording_writer>(filename, section, false);
+            for (auto&& blob : blobs)
+                _writer->write_blob(move(blob));
+            _written_blobs += static_cast<int>(blobs.size());
+            blobs.clear();
+        }
+
+        void recording::save(const char* filename, const char* section, bool append) const
+        {
+            LOG_WARNING("Saving recording to file, don't close the application");
+
+            auto writer = _writer ? _writer : make_shared<recording_writer>(filename, section, append);
+            for (auto&& blob : blobs)
+                writer->write_blob(blob);
+            writer->stop();
+
+            auto&& c = writer->get_connection();
+            auto section_id = writer->get_section();
+
             c.transaction([&]()
             {
+                statement insert_call(c, CALLS_INSERT);
+                statement insert_device(c, DEVICE_INFO_INSERT);
+                statement insert_profile(c, PROFILES_INSERT);
+
                 for (auto&& cl : calls)
                 {
-                    statement insert(c, CALLS_INSERT);
-                    insert.bind(1, section_id);
-                    insert.bind(2, static_cast<int>(cl.type));
-                    insert.bind(3, cl.timestamp);
-                    insert.bind(4, cl.entity_id);
-                    insert.bind(5, cl.inline_string.c_str());
-                    insert.bind(6, cl.param1);
-                    insert.bind(7, cl.param2);
-                    insert.bind(8, cl.param3);
-                    insert.bind(9, cl.param4);
-                    insert.bind(10, cl.param5);
-                    insert.bind(11, cl.param6);
-                    insert.bind(12, cl.had_error ? 1 : 0);
-                    insert.bind(13, cl.param7);
-                    insert.bind(14, cl.param8);
-                    insert.bind(15, cl.param9);
-                    insert.bind(16, cl.param10);
-                    insert.bind(17, cl.param11);
-                    insert.bind(18, cl.param12);
-
-                    insert();
+                    insert_call.bind(1, section_id);
+                    insert_call.bind(2, static_cast<int>(cl.type));
+                    insert_call.bind(3, cl.timestamp);
+                    insert_call.bind(4, cl.entity_id);
+                    insert_call.bind(5, cl.inline_string.c_str());
+                    insert_call.bind(6, cl.param1);
+                    insert_call.bind(7, cl.param2);
+                    insert_call.bind(8, cl.param3);
+                    insert_call.bind(9, cl.param4);
+                    insert_call.bind(10, cl.param5);
+                    insert_call.bind(11, cl.param6);
+                    insert_call.bind(12, cl.had_error ? 1 : 0);
+                    insert_call.bind(13, cl.param7);
+                    insert_call.bind(14, cl.param8);
+                    insert_call.bind(15, cl.param9);
+                    insert_call.bind(16, cl.param10);
+                    insert_call.bind(17, cl.param11);
+                    insert_call.bind(18, cl.param12);
+
+                    insert_call();
+                    insert_call.reset();
                 }
 
                 for (auto&& uvc_info : uvc_device_infos)
                 {
-                    statement insert(c, DEVICE_INFO_INSERT);
-                    insert.bind(1, section_id);
-                    insert.bind(2, (int)device_type::uvc);
-                    insert.bind(3, "");
-                    insert.bind(4, uvc_info.unique_id.c_str());
-                    insert.bind(5, (int)uvc_info.pid);
-                    insert.bind(6, (int)uvc_info.vid);
-                    insert.bind(7, (int)uvc_info.mi);
-                    insert();
+                    insert_device.bind(1, section_id);
+                    insert_device.bind(2, (int)device_type::uvc);
+                    insert_device.bind(3, "");
+                    insert_device.bind(4, uvc_info.unique_id.c_str());
+                    insert_device.bind(5, (int)uvc_info.pid);
+                    insert_device.bind(6, (int)uvc_info.vid);
+                    insert_device.bind(7, (int)uvc_info.mi);
+                    insert_device();
+                    insert_device.reset();
                 }
 
                 for (auto&& usb_info : usb_device_infos)
                 {
-                    statement insert(c, DEVICE_INFO_INSERT);
-                    insert.bind(1, section_id);
-                    insert.bind(2, (int)device_type::usb);
+                    insert_device.bind(1, section_id);
+                    insert_device.bind(2, (int)device_type::usb);
                     string id(usb_info.id.begin(), usb_info.id.end());
-                    insert.bind(3, id.c_str());
-                    insert.bind(4, usb_info.unique_id.c_str());
-                    insert.bind(5, (int)usb_info.pid);
-                    insert.bind(6, (int)usb_info.vid);
-                    insert.bind(7, (int)usb_info.mi);
-                    insert();
+                    insert_device.bind(3, id.c_str());
+                    insert_device.bind(4, usb_info.unique_id.c_str());
+                    insert_device.bind(5, (int)usb_info.pid);
+                    insert_device.bind(6, (int)usb_info.vid);
+                    insert_device.bind(7, (int)usb_info.mi);
+                    insert_device();
+                    insert_device.reset();
                 }
 
                 for (auto&& hid_info : hid_device_infos)
                 {
-                    statement insert(c, DEVICE_INFO_INSERT);
-                    insert.bind(1, section_id);
-                    insert.bind(2, (int)device_type::hid);
-                    insert.bind(3, hid_info.id.c_str());
-                    insert.bind(4, hid_info.unique_id.c_str());
+                    insert_device.bind(1, section_id);
+                    insert_device.bind(2, (int)device_type::hid);
+                    insert_device.bind(3, hid_info.id.c_str());
+                    insert_device.bind(4, hid_info.unique_id.c_str());
 
                     stringstream ss_vid(hid_info.vid);
                     stringstream ss_pid(hid_info.pid);
@@ -317,49 +404,42 @@ namespace librealsense
                     ss_vid >> hex >> vid;
                     ss_pid >> hex >> pid;
 
-                    insert.bind(5, (int)pid);
-                    insert.bind(6, (int)vid);
-                    insert.bind(7, hid_info.device_path.c_str());
-                    insert();
+                    insert_device.bind(5, (int)pid);
+                    insert_device.bind(6, (int)vid);
+                    insert_device.bind(7, hid_info.device_path.c_str());
+                    insert_device();
+                    insert_device.reset();
                 }
 
                 for (auto&& hid_info : hid_sensors)
                 {
-                    statement insert(c, DEVICE_INFO_INSERT);
-                    insert.bind(1, section_id);
-                    insert.bind(2, (int)device_type::hid_sensor);
-                    insert.bind(3, hid_info.name.c_str());
-                    insert.bind(4, "");
-                    insert();
+                    insert_device.bind(1, section_id);
+                    insert_device.bind(2, (int)device_type::hid_sensor);
+                    insert_device.bind(3, hid_info.name.c_str());
+                    insert_device.bind(4, "");
+                    insert_device();
+                    insert_device.reset();
                 }
 
                 for (auto&& hid_info : hid_sensor_inputs)
                 {
-                    statement insert(c, DEVICE_INFO_INSERT);
-                    insert.bind(1, section_id);
-                    insert.bind(2, (int)device_type::hid_input);
-                    insert.bind(3, hid_info.name.c_str());
-                    insert.bind(4, "");
-                    insert();
+                    insert_device.bind(1, section_id);
+                    insert_device.bind(2, (int)device_type::hid_input);
+                    insert_device.bind(3, hid_info.name.c_str());
+                    insert_device.bind(4, "");
+                    insert_device();
+                    insert_device.reset();
                 }
 
                 for (auto&& profile : this->stream_profiles)
                 {
-                    statement insert(c, PROFILES_INSERT);
-                    insert.bind(1, section_id);
-                    insert.bind(2, (int)profile.width);
-                    insert.bind(3, (int)profile.height);
-                    insert.bind(4, (int)profile.fps);
-                    insert.bind(5, (int)profile.format);
-                    insert();
-                }
-
-                for (auto&& blob : blobs)
-                {
-                    statement insert(c, BLOBS_INSERT);
-                    insert.bind(1, section_id);
-                    insert.bind(2, blob);
-                    insert();
+                    insert_profile.bind(1, section_id);
+                    insert_profile.bind(2, (int)profile.width);
+                    insert_profile.bind(3, (int)profile.height);
+                    insert_profile.bind(4, (int)profile.fps);
+                    insert_profile.bind(5, (int)profile.format);
+                    insert_profile();
+                    insert_profile.reset();
                 }
             });
         }
@@ -391,7 +471,8 @@ namespace librealsense
 
             auto result = make_shared<recording>(nullptr, watcher);
 
-            connection c(filename);
+            // Nothing is written back to the recording, for several test processes to play it back at once
+            connection c(filename, true);
 
             if (!c.table_exists(CONFIG_TABLE))
             {
@@ -538,8 +619,16 @@ namespace librealsense
             vector<uint8_t> holder;
             holder.resize(size);
             librealsense::copy(holder.data(), ptr, size);
-            auto id = static_cast<int>(blobs.size());
-            blobs.push_back(holder);
+            auto id = _written_blobs + static_cast<int>(blobs.size());
+            if (_writer)
+            {
+                _writer->write_blob(move(holder));
+                ++_written_blobs;
+            }
+            else
+            {
+                blobs.push_back(holder);
+            }
             return id;
         }
 
@@ -582,6 +671,18 @@ namespace librealsense
             throw runtime_error("The recording is missing the part you are trying to playback!");
         }
 
+        vector<call*> recording::find_calls(call_type t, int entity_id)
+        {
+            lock_guard<recursive_mutex> lock(_mutex);
+            vector<call*> results;
+            for (auto&& c : calls)
+            {
+                if (c.type == t && c.entity_id == entity_id)
+                    results.push_back(&c);
+            }
+            return results;
+        }
+
         call* recording::pick_next_call(int id)
         {
             lock_guard<recursive_mutex> lock(_mutex);
@@ -675,10 +776,10 @@ namespace librealsense
                         }
                         else
                         {
-                            auto compressed = _compression->encode((uint8_t*)f.pixels, f.frame_size);
+                            auto compressed = _compression->encode((const uint8_t*)f.pixels, f.frame_size);
                             c.param2 = rec1->save_blob(compressed.data(), static_cast<int>(compressed.size()));
-                            c.param4 = static_cast<int>(compressed.size());
-                            c.param3 = 2;
+                            c.param4 = static_cast<int>(f.frame_size);
+                            c.param3 = 3;
                         }
 
                         c.param5 = rec1->save_blob(f.metadata, static_cast<int>(f.metadata_size));
@@ -1094,7 +1195,9 @@ namespace librealsense
             : _source(source), _rec(std::make_shared<platform::recording>(create_time_service())), _entity_count(1),
             _filename(filename),
             _section(section), _compression(make_shared<compression_algorithm>()), _mode(mode)
-        {}
+        {
+            _rec->start_saving(filename, section);
+        }
 
         record_backend::~record_backend()
         {
@@ -1170,6 +1273,8 @@ namespace librealsense
             assert(_alive);
             _alive = false;
             _callback_thread.join();
+            if (_decoder_thread.joinable())
+                _decoder_thread.join();
         }
 
         void record_backend::write_to_file() const
@@ -1241,6 +1346,9 @@ namespace librealsense
             for (auto&& pair : _commitments)
                 _callbacks.push_back(pair);
             _commitments.clear();
+
+            if (!_decoder_thread.joinable())
+                _decoder_thread = std::thread([this]() { decoder_thread(); });
         }
 
         void playback_uvc_device::start_callbacks()
@@ -1392,7 +1500,7 @@ namespace librealsense
         }
 
         playback_uvc_device::playback_uvc_device(shared_ptr<recording> rec, int id)
-            : _rec(rec), _entity_id(id), _alive(true)
+            : _rec(rec), _entity_id(id), _alive(true), _decoded_bytes(0)
         {
             _callback_thread = std::thread([this]() { callback_thread(); });
         }
@@ -1461,14 +1569,14 @@ namespace librealsense
                 auto c_ptr = _rec->cycle_calls(call_type::hid_frame, _entity_id);
                 if (c_ptr)
                 {
-                    auto sd_data = _rec->load_blob(c_ptr->param1);
+                    auto&& sd_data = _rec->get_blob(c_ptr->param1);
                     auto sensor_name = c_ptr->inline_string;
 
                     sensor_data sd;
                     sd.fo.pixels = (void*)sd_data.data();
                     sd.fo.frame_size = sd_data.size();
 
-                    auto metadata = _rec->load_blob(c_ptr->param2);
+                    auto&& metadata = _rec->get_blob(c_ptr->param2);
                     sd.fo.metadata = (void*)metadata.data();
                     sd.fo.metadata_size = static_cast<uint8_t>(metadata.size());
 
@@ -1476,7 +1584,11 @@ namespace librealsense
 
                     _callback(sd);
                 }
-                this_thread::sleep_for(chrono::milliseconds(1));
+                else
+                {
+                    // No frame at this point of the recording, the callbacks are delivered as fast as they are cycled
+                    this_thread::sleep_for(chrono::milliseconds(1));
+                }
             }
         }
 
@@ -1506,7 +1618,7 @@ namespace librealsense
 
         stream_profile playback_uvc_device::get_profile(call* frame) const
         {
-            auto profile_blob = _rec->load_blob(frame->param1);
+            auto&& profile_blob = _rec->get_blob(frame->param1);
 
             stream_profile p;
             librealsense::copy(&p, profile_blob.data(), sizeof(p));
@@ -1514,14 +1626,79 @@ namespace librealsense
             return p;
         }
 
+        shared_ptr<const playback_uvc_device::decoded_frame> playback_uvc_device::decode_frame(call* frame) const
+        {
+            auto result = make_shared<decoded_frame>();
+            if (frame->param3 == 0) // frame was not saved
+            {
+                result->data = vector<uint8_t>(frame->param4, 0);
+            }
+            else if (frame->param3 == 1)// frame was saved
+            {
+                result->data = _rec->get_blob(frame->param2);
+            }
+            else if (frame->param3 == 2) // frame was run length encoded, by older recordings
+            {
+                result->data = _compression.decode_runs(_rec->get_blob(frame->param2));
+            }
+            else
+            {
+                result->data = _compression.decode(_rec->get_blob(frame->param2), frame->param4);
+            }
+            result->metadata = _rec->get_blob(frame->param5);
+            return result;
+        }
+
+        shared_ptr<const playback_uvc_device::decoded_frame> playback_uvc_device::get_frame(call* frame)
+        {
+            {
+                lock_guard<mutex> lock(_decoded_mutex);
+                auto it = _decoded_frames.find(frame);
+                if (it != _decoded_frames.end())
+                    return it->second;
+            }
 
-        void playback_uvc_device::callback_thread()
+            // Ahead of the decoder, or past the frames it keeps
+            auto result = decode_frame(frame);
+            lock_guard<mutex> lock(_decoded_mutex);
+            auto size = result->data.size() + result->metadata.size();
+            if (_decoded_bytes + size <= max_decoded_bytes && _decoded_frames.emplace(frame, result).second)
+                _decoded_bytes += size;
+            return result;
+        }
+
+        void playback_uvc_device::decoder_thread()
         {
-            int next_timeout_ms = 0;
-            double prev_frame_ts = 0;
+            for (auto&& frame : _rec->find_calls(call_type::uvc_frame, _entity_id))
+            {
+                if (!_alive)
+                    return;
+
+                {
+                    lock_guard<mutex> lock(_decoded_mutex);
+                    if (_decoded_bytes >= max_decoded_bytes)
+                        return;
+                    if (_decoded_frames.count(frame))
+                        continue;
+                }
+                try
+                {
+                    get_frame(frame);
+                }
+                catch (const std::exception& e)
+                {
+                    // Left for the callbacks to decode, and fail, in turn
+                    LOG_WARNING("Recorded frame could not be decoded ahead: " << e.what());
+                    return;
+                }
+            }
+        }
 
+        void playback_uvc_device::callback_thread()
+        {
             while (_alive)
             {
+                auto delivered = false;
                 auto c_ptr = _rec->pick_next_call(_entity_id);
 
                 if (c_ptr && c_ptr->type == call_type::uvc_frame)
@@ -1538,38 +1715,14 @@ namespace librealsense
                                 auto p = get_profile(c_ptr);
                                 if(p == pair.first)
                                 {
-                                    vector<uint8_t> frame_blob;
-                                    vector<uint8_t> metadata_blob;
-
-                                    if (prev_frame_ts > 0 &&
-                                        c_ptr->timestamp > prev_frame_ts &&
-                                        c_ptr->timestamp - prev_frame_ts <= 300)
-                                    {
-                                        prev_frame_ts = c_ptr->timestamp - prev_frame_ts;
-                                    }
-
-                                    prev_frame_ts = c_ptr->timestamp;
-
-                                    if (c_ptr->param3 == 0) // frame was not saved
-                                    {
-                                        frame_blob = vector<uint8_t>(c_ptr->param4, 0);
-                                    }
-                                    else if (c_ptr->param3 == 1)// frame was saved
-                                    {
-                                        frame_blob = _rec->load_blob(c_ptr->param2);
-                                    }
-                                    else
-                                    {
-                                        frame_blob = _compression.decode(_rec->load_blob(c_ptr->param2));
-                                    }
-
-                                    metadata_blob = _rec->load_blob(c_ptr->param5);
-                                    frame_object fo{ frame_blob.size(),
-                                                static_cast<uint8_t>(metadata_blob.size()), // Metadata is limited to 0xff bytes by design
-                                                frame_blob.data(),metadata_blob.data() };
-
+                                    // The frame is handed to the callback as is, the callbacks copying what they keep
+                                    auto frame = get_frame(c_ptr);
+                                    frame_object fo{ frame->data.size(),
+                                                static_cast<uint8_t>(frame->metadata.size()), // Metadata is limited to 0xff bytes by design
+                                                frame->data.data(), frame->metadata.data() };
 
                                     pair.second(p, fo, []() {});
+                                    delivered = true;
 
                                     break;
                                 }
@@ -1587,8 +1740,9 @@ namespace librealsense
                 {
                     _rec->cycle_calls(call_type::uvc_frame, _entity_id);
                 }
-                // work around - Let the other threads of playback uvc devices pull their frames
-                this_thread::sleep_for(std::chrono::milliseconds(next_timeout_ms));
+                // work around - Let the other threads of playback uvc devices pull their frames, when this one has none
+                if (!delivered)
+                    this_thread::yield();
             }
         }
 
@@ -58,17 +58,16 @@ namespace librealsense
             uvc_get_usb_specification
         };
 
+        // Frames of low quality recordings are stored as LZ4 blocks, and those of older recordings in the lossy run length
+        // encoding this replaced, which is still decoded
         class compression_algorithm
         {
         public:
-            int dist(uint32_t x, uint32_t y) const;
+            std::vector<uint8_t> decode(const std::vector<uint8_t>& input, size_t size) const;
 
-            std::vector<uint8_t> decode(const std::vector<uint8_t>& input) const;
+            std::vector<uint8_t> decode_runs(const std::vector<uint8_t>& input) const;
 
-            std::vector<uint8_t> encode(uint8_t* data, size_t size) const;
-
-            int min_dist = 110;
-            int max_length = 32;
+            std::vector<uint8_t> encode(const uint8_t* data, size_t size) const;
         };
 
         struct call
@@ -103,6 +102,7 @@ namespace librealsense
             call_type type;
         };
         class playback_device_watcher;
+        class recording_writer;
 
         class recording
         {
@@ -110,6 +110,9 @@ namespace librealsense
             recording(std::shared_ptr<time_service> ts = nullptr, std::shared_ptr<playback_device_watcher> watcher = nullptr);
 
             double get_time();
+            // Writes the blobs saved from now on to the file as they come, rather than holding them until save
+            void start_saving(const char* filename, const char* section);
+            // To the file of start_saving when it was called
             void save(const char* filename, const char* section, bool append = false) const;
             static std::shared_ptr<recording> load(const char* filename, const char* section, std::shared_ptr<playback_device_watcher> watcher = nullptr, std::string min_api_version = "");
 
@@ -291,6 +294,15 @@ namespace librealsense
                 return blobs[id];
             }
 
+            // The blobs of a loaded recording are left unchanged, and are read in place by its playback
+            const std::vector<uint8_t>& get_blob(int id) const
+            {
+                return blobs[id];
+            }
+
+            // The calls of a type of an entity, in the order they were recorded
+            std::vector<call*> find_calls(call_type t, int entity_id);
+
             call& find_call(call_type t, int entity_id, std::function<bool(const call& c)> history_match_validation = [](const call& c) {return true; });
             call* cycle_calls(call_type call_type, int id);
             call* pick_next_call(int id = 0);
@@ -299,6 +311,9 @@ namespace librealsense
         private:
             std::vector<call> calls;
             std::vector<std::vector<uint8_t>> blobs;
+            // Blobs handed to the writer, ahead of those held
+            int _written_blobs = 0;
+            std::shared_ptr<recording_writer> _writer;
             std::vector<uvc_device_info> uvc_device_infos;
             std::vector<usb_device_info> usb_device_infos;
             std::vector<stream_profile> stream_profiles;
@@ -530,16 +545,33 @@ namespace librealsense
             ~playback_uvc_device();
 
         private:
-             stream_profile get_profile(call* frame) const;
+            // The frames of the recording decoded once and kept, for the cycles of the playback to deliver them again
+            // with no decoding, up to max_decoded_bytes per device
+            struct decoded_frame
+            {
+                std::vector<uint8_t> data;
+                std::vector<uint8_t> metadata;
+            };
+            static const size_t max_decoded_bytes = 256 * 1024 * 1024;
+
+            stream_profile get_profile(call* frame) const;
+            std::shared_ptr<const decoded_frame> decode_frame(call* frame) const;
+            std::shared_ptr<const decoded_frame> get_frame(call* frame);
+            // Decodes the frames of the entity ahead of the callbacks, from when it streams
+            void decoder_thread();
 
             std::shared_ptr<recording> _rec;
             int _entity_id;
             std::atomic<bool> _alive;
             std::thread _callback_thread;
+            std::thread _decoder_thread;
             configurations _callbacks;
             configurations _commitments;
             std::mutex _callback_mutex;
             compression_algorithm _compression;
+            std::map<const call*, std::shared_ptr<const decoded_frame>> _decoded_frames;
+            size_t _decoded_bytes;
+            std::mutex _decoded_mutex;
         };
 
 
@@ -44,10 +44,11 @@ namespace sql
         }
     }
 
-    connection::connection(const char* filename)
+    connection::connection(const char* filename, bool read_only)
     {
         connection_handle handle;
-        auto const code = do_with_retries([&]() { return sqlite3_open(filename, handle.get_address()); });
+        auto const flags = read_only ? SQLITE_OPEN_READONLY : SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE;
+        auto const code = do_with_retries([&]() { return sqlite3_open_v2(filename, handle.get_address(), flags, nullptr); });
         if (SQLITE_OK != code)
         {
             throw runtime_error(sqlite3_errmsg(handle.get()));
@@ -105,6 +106,12 @@ namespace sql
         throw runtime_error(sqlite3_errmsg(sqlite3_db_handle(m_handle.get())));
     }
 
+    void statement::reset() const
+    {
+        sqlite3_reset(m_handle.get());
+        sqlite3_clear_bindings(m_handle.get());
+    }
+
     int statement::get_int(int const column) const
     {
         return sqlite3_column_int(m_handle.get(), column);
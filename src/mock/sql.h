@@ -74,6 +74,8 @@ namespace sql
         statement(const connection& conn, const char * sql);
 
         bool step() const;
+        // For the statement to run again, with new bindings
+        void reset() const;
 
         int get_int(int column = 0) const;
         double get_double(int column = 0) const;
@@ -151,7 +153,8 @@ namespace sql
 
         friend class statement;
     public:
-        explicit connection(const char* filename);
+        // Read only connections open databases other processes may read at the same time, and never create them
+        explicit connection(const char* filename, bool read_only = false);
 
         void execute(const char * command) const;
 
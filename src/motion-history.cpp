@@ -0,0 +1,112 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include "motion-history.h"
+
+#include <algorithm>
+
+namespace librealsense
+{
+    motion_history::motion_history()
+        : _timestamps(new std::atomic<double>[capacity]),
+          _x(new std::atomic<float>[capacity]), _y(new std::atomic<float>[capacity]), _z(new std::atomic<float>[capacity]),
+          _written(0)
+    {
+    }
+
+    void motion_history::record(double timestamp, const rs2_vector& motion)
+    {
+        auto n = _written.load(std::memory_order_relaxed);
+        auto slot = n & (capacity - 1);
+        _timestamps[slot].store(timestamp, std::memory_order_relaxed);
+        _x[slot].store(motion.x, std::memory_order_relaxed);
+        _y[slot].store(motion.y, std::memory_order_relaxed);
+        _z[slot].store(motion.z, std::memory_order_relaxed);
+        _written.store(n + 1, std::memory_order_release);
+    }
+
+    int motion_history::query(double begin, double end, double* timestamps, rs2_vector* motion, int count) const
+    {
+        auto written = _written.load(std::memory_order_acquire);
+        auto oldest = written > capacity ? written - capacity : 0;
+        auto at = [this](uint64_t i) { return _timestamps[i & (capacity - 1)].load(std::memory_order_relaxed); };
+
+        // The timestamps of a stream only grow, the first sample in range is searched for
+        auto first = oldest, last = written;
+        while (first < last)
+        {
+            auto mid = first + (last - first) / 2;
+            if (at(mid) < begin) first = mid + 1;
+            else last = mid;
+        }
+
+        int copied = 0;
+        for (auto i = first; i < written && copied < count; ++i, ++copied)
+        {
+            auto t = at(i);
+            if (t > end) break;
+            auto slot = i & (capacity - 1);
+            if (timestamps) timestamps[copied] = t;
+            if (motion) motion[copied] = { _x[slot].load(std::memory_order_relaxed), _y[slot].load(std::memory_order_relaxed),
+                                           _z[slot].load(std::memory_order_relaxed) };
+        }
+
+        // The samples the writer went over while they were read are dropped
+        std::atomic_thread_fence(std::memory_order_acquire);
+        auto now_written = _written.load(std::memory_order_relaxed);
+        auto now_oldest = now_written > capacity ? now_written - capacity : 0;
+        if (first >= now_oldest)
+            return copied;
+
+        auto overwritten = static_cast<int>(std::min<uint64_t>(now_oldest - first, copied));
+        if (timestamps) std::copy(timestamps + overwritten, timestamps + copied, timestamps);
+        if (motion) std::copy(motion + overwritten, motion + copied, motion);
+        return copied - overwritten;
+    }
+
+    motion_histories::motion_histories()
+    {
+        for (auto&& h : _histories)
+            h.store(nullptr);
+    }
+
+    motion_histories::~motion_histories()
+    {
+        for (auto&& h : _histories)
+            delete h.load();
+    }
+
+    std::atomic<motion_history*>* motion_histories::find(rs2_stream stream, int index)
+    {
+        if ((stream != RS2_STREAM_GYRO && stream != RS2_STREAM_ACCEL) || index < 0 || index >= max_index)
+            return nullptr;
+        return &_histories[(stream == RS2_STREAM_GYRO ? 0 : max_index) + index];
+    }
+
+    const std::atomic<motion_history*>* motion_histories::find(rs2_stream stream, int index) const
+    {
+        return const_cast<motion_histories*>(this)->find(stream, index);
+    }
+
+    void motion_histories::record(rs2_stream stream, int index, double timestamp, const rs2_vector& motion)
+    {
+        auto h = find(stream, index);
+        if (!h)
+            return;
+
+        auto history = h->load(std::memory_order_acquire);
+        if (!history)
+        {
+            history = new motion_history();
+            h->store(history, std::memory_order_release);
+        }
+        history->record(timestamp, motion);
+    }
+
+    int motion_histories::query(rs2_stream stream, int index, double begin, double end, double* timestamps, rs2_vector* motion, int count) const
+    {
+        auto h = find(stream, index);
+        auto history = h ? h->load(std::memory_order_acquire) : nullptr;
+        return history ? history->query(begin, end, timestamps, motion, count) : 0;
+    }
+}
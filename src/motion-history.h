@@ -0,0 +1,60 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "types.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace librealsense
+{
+    // The latest samples of a motion stream, kept in a ring as they are captured. A single thread writes the samples,
+    // and any number of threads query them without locking: a query drops the oldest samples it read if they were
+    // overwritten meanwhile. The timestamps and the axes are kept in separate arrays, for the time range to be searched
+    // over the timestamps alone
+    class motion_history
+    {
+    public:
+        static const size_t capacity = 4096;    // A few seconds at the rates of the IMUs. A power of two
+
+        motion_history();
+
+        void record(double timestamp, const rs2_vector& motion);
+
+        // Copies, oldest first, up to count samples captured between begin and end, inclusive, and returns how many were copied.
+        // Either of timestamps or motion may be null for the samples to be counted without being copied
+        int query(double begin, double end, double* timestamps, rs2_vector* motion, int count) const;
+
+    private:
+        std::unique_ptr<std::atomic<double>[]> _timestamps;
+        std::unique_ptr<std::atomic<float>[]> _x, _y, _z;
+        std::atomic<uint64_t> _written;     // Since the history was created, the latest sample being at _written - 1
+    };
+
+    // The histories of the gyro and accel streams of a sensor, created by the thread capturing the samples of a stream
+    // the first time it records one, and kept for as long as the sensor
+    class motion_histories
+    {
+    public:
+        motion_histories();
+        ~motion_histories();
+
+        void record(rs2_stream stream, int index, double timestamp, const rs2_vector& motion);
+
+        // Of the samples of the stream, none while it did not stream
+        int query(rs2_stream stream, int index, double begin, double end, double* timestamps, rs2_vector* motion, int count) const;
+
+    private:
+        static const int max_index = 4;
+
+        std::atomic<motion_history*>* find(rs2_stream stream, int index);
+        const std::atomic<motion_history*>* find(rs2_stream stream, int index) const;
+
+        std::array<std::atomic<motion_history*>, 2 * max_index> _histories;  // Gyro then accel, by index
+    };
+}
@@ -0,0 +1,256 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include "net-description.h"
+#include "archive.h"
+#include "stream.h"
+#include "environment.h"
+
+namespace librealsense
+{
+    namespace net
+    {
+        static std::vector<std::pair<rs2_camera_info, std::string>> describe_infos(const info_interface& infos)
+        {
+            std::vector<std::pair<rs2_camera_info, std::string>> result;
+            for (int i = 0; i < RS2_CAMERA_INFO_COUNT; ++i)
+                if (infos.supports_info(static_cast<rs2_camera_info>(i)))
+                    result.emplace_back(static_cast<rs2_camera_info>(i), infos.get_info(static_cast<rs2_camera_info>(i)));
+            return result;
+        }
+
+        device_description describe(const device_interface& dev)
+        {
+            device_description result;
+            result.infos = describe_infos(dev);
+
+            std::vector<std::shared_ptr<stream_profile_interface>> video_profiles;
+            for (size_t i = 0; i < dev.get_sensors_count(); ++i)
+            {
+                auto&& sensor = dev.get_sensor(i);
+                sensor_description s;
+                s.name = sensor.supports_info(RS2_CAMERA_INFO_NAME) ? sensor.get_info(RS2_CAMERA_INFO_NAME) : "";
+                s.infos = describe_infos(sensor);
+
+                auto depth = dynamic_cast<const depth_sensor*>(&sensor);
+                s.is_depth = depth != nullptr;
+                s.depth_units = depth ? depth->get_depth_scale() : 0.f;
+
+                for (int o = 0; o < RS2_OPTION_COUNT; ++o)
+                {
+                    auto id = static_cast<rs2_option>(o);
+                    if (!sensor.supports_option(id))
+                        continue;
+                    auto&& option = sensor.get_option(id);
+                    s.options.push_back({ id, option.get_range(), option.is_read_only(), option.get_description() });
+                }
+
+                for (auto&& p : sensor.get_stream_profiles())
+                {
+                    auto vid = dynamic_cast<video_stream_profile_interface*>(p.get());
+                    if (!vid)
+                        continue;
+
+                    profile_description d{};
+                    d.uid = static_cast<uint32_t>(p->get_unique_id());
+                    d.stream = p->get_stream_type();
+                    d.index = p->get_stream_index();
+                    d.format = p->get_format();
+                    d.fps = p->get_framerate();
+                    d.width = vid->get_width();
+                    d.height = vid->get_height();
+                    d.tag = p->get_tag();
+                    try
+                    {
+                        d.intrinsics = vid->get_intrinsics();
+                        d.has_intrinsics = true;
+                    }
+                    catch (...)
+                    {
+                        d.has_intrinsics = false;
+                    }
+                    s.profiles.push_back(d);
+                    video_profiles.push_back(p);
+                }
+                result.sensors.push_back(s);
+            }
+
+            for (size_t i = 1; i < video_profiles.size(); ++i)
+            {
+                rs2_extrinsics extr;
+                if (environment::get_instance().get_extrinsics_graph().try_fetch_extrinsics(*video_profiles.front(), *video_profiles[i], &extr))
+                    result.extrinsics.emplace_back(static_cast<uint32_t>(video_profiles[i]->get_unique_id()), extr);
+            }
+            return result;
+        }
+
+        static void write_infos(writer& w, const std::vector<std::pair<rs2_camera_info, std::string>>& infos)
+        {
+            w << static_cast<uint32_t>(infos.size());
+            for (auto&& info : infos)
+                w << static_cast<uint32_t>(info.first) << info.second;
+        }
+
+        static std::vector<std::pair<rs2_camera_info, std::string>> read_infos(reader& r)
+        {
+            std::vector<std::pair<rs2_camera_info, std::string>> infos;
+            auto count = r.read<uint32_t>();
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                auto info = static_cast<rs2_camera_info>(r.read<uint32_t>());
+                infos.emplace_back(info, r.read<std::string>());
+            }
+            return infos;
+        }
+
+        void write_description(writer& w, const device_description& description)
+        {
+            w << protocol_version;
+            write_infos(w, description.infos);
+
+            w << static_cast<uint32_t>(description.sensors.size());
+            for (auto&& s : description.sensors)
+            {
+                w << s.name;
+                write_infos(w, s.infos);
+                w << static_cast<uint8_t>(s.is_depth ? 1 : 0) << s.depth_units;
+
+                w << static_cast<uint32_t>(s.options.size());
+                for (auto&& o : s.options)
+                    w << static_cast<uint32_t>(o.id) << o.range << static_cast<uint8_t>(o.read_only ? 1 : 0) << o.description;
+
+                w << static_cast<uint32_t>(s.profiles.size());
+                for (auto&& p : s.profiles)
+                    w << p.uid << static_cast<uint32_t>(p.stream) << p.index << static_cast<uint32_t>(p.format)
+                      << p.fps << p.width << p.height << p.tag << static_cast<uint8_t>(p.has_intrinsics ? 1 : 0) << p.intrinsics;
+            }
+
+            w << static_cast<uint32_t>(description.extrinsics.size());
+            for (auto&& e : description.extrinsics)
+                w << e.first << e.second;
+        }
+
+        device_description read_description(reader& r)
+        {
+            auto version = r.read<uint32_t>();
+            if (version != protocol_version)
+                throw io_exception(to_string() << "Device description version " << version << " is not supported");
+
+            device_description result;
+            result.infos = read_infos(r);
+
+            auto sensors_count = r.read<uint32_t>();
+            for (uint32_t i = 0; i < sensors_count; ++i)
+            {
+                sensor_description s;
+                r >> s.name;
+                s.infos = read_infos(r);
+                s.is_depth = r.read<uint8_t>() != 0;
+                r >> s.depth_units;
+
+                auto options_count = r.read<uint32_t>();
+                for (uint32_t o = 0; o < options_count; ++o)
+                {
+                    option_description d;
+                    d.id = static_cast<rs2_option>(r.read<uint32_t>());
+                    r >> d.range;
+                    d.read_only = r.read<uint8_t>() != 0;
+                    r >> d.description;
+                    s.options.push_back(d);
+                }
+
+                auto profiles_count = r.read<uint32_t>();
+                for (uint32_t p = 0; p < profiles_count; ++p)
+                {
+                    profile_description d;
+                    r >> d.uid;
+                    d.stream = static_cast<rs2_stream>(r.read<uint32_t>());
+                    r >> d.index;
+                    d.format = static_cast<rs2_format>(r.read<uint32_t>());
+                    r >> d.fps >> d.width >> d.height >> d.tag;
+                    d.has_intrinsics = r.read<uint8_t>() != 0;
+                    r >> d.intrinsics;
+                    s.profiles.push_back(d);
+                }
+                result.sensors.push_back(s);
+            }
+
+            auto extrinsics_count = r.read<uint32_t>();
+            for (uint32_t e = 0; e < extrinsics_count; ++e)
+            {
+                auto to = r.read<uint32_t>();
+                result.extrinsics.emplace_back(to, r.read<rs2_extrinsics>());
+            }
+            return result;
+        }
+
+        std::shared_ptr<video_stream_profile> create_profile(const profile_description& d)
+        {
+            auto profile = std::make_shared<video_stream_profile>(platform::stream_profile{ d.width, d.height, d.fps, 0 });
+            profile->set_dims(d.width, d.height);
+            profile->set_format(d.format);
+            profile->set_framerate(d.fps);
+            profile->set_stream_index(d.index);
+            profile->set_stream_type(d.stream);
+            profile->set_unique_id(environment::get_instance().generate_stream_id());
+            if (d.has_intrinsics)
+            {
+                auto intrinsics = d.intrinsics;
+                profile->set_intrinsics([intrinsics]() { return intrinsics; });
+            }
+            if (d.tag)
+                profile->tag_profile(d.tag);
+            return profile;
+        }
+
+        bool describe_frame(frame_interface& f, uint32_t sensor, frame_header& header, std::vector<metadata_pair>& metadata)
+        {
+            auto vf = dynamic_cast<video_frame*>(&f);
+            if (!vf)
+                return false;
+
+            header = {};
+            header.sensor = sensor;
+            header.profile = static_cast<uint32_t>(f.get_stream()->get_unique_id());
+            header.codec = static_cast<uint32_t>(codec::raw);
+            header.timestamp = f.get_frame_timestamp();
+            header.domain = static_cast<uint32_t>(f.get_frame_timestamp_domain());
+            header.frame_number = f.get_frame_number();
+            header.width = vf->get_width();
+            header.height = vf->get_height();
+            header.stride = vf->get_stride();
+            header.bpp = vf->get_bpp();
+            header.data_size = static_cast<uint32_t>(static_cast<size_t>(vf->get_stride()) * vf->get_height());
+
+            metadata.clear();
+            for (int i = 0; i < RS2_FRAME_METADATA_COUNT; ++i)
+            {
+                auto key = static_cast<rs2_frame_metadata_value>(i);
+                if (f.supports_frame_metadata(key))
+                    metadata.push_back({ static_cast<uint32_t>(i), f.get_frame_metadata(key) });
+            }
+            header.metadata_count = static_cast<uint32_t>(metadata.size());
+            return true;
+        }
+
+        frame_additional_data get_additional_data(const frame_header& header, const metadata_pair* metadata, size_t count)
+        {
+            frame_additional_data data;
+            data.timestamp = header.timestamp;
+            data.timestamp_domain = static_cast<rs2_timestamp_domain>(header.domain);
+            data.frame_number = header.frame_number;
+
+            // Encoded the way md_constant_parser reads them back
+            for (size_t i = 0; i < count; ++i)
+            {
+                auto key = static_cast<rs2_frame_metadata_value>(metadata[i].key);
+                rs2_metadata_type value = metadata[i].value;
+                if (data.metadata_blob.size() + sizeof(key) + sizeof(value) > 255)
+                    break;
+                data.metadata_blob.append(&key, sizeof(key));
+                data.metadata_blob.append(&value, sizeof(value));
+            }
+            return data;
+        }
+    }
+}
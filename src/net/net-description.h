@@ -0,0 +1,71 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "net-protocol.h"
+#include "core/streaming.h"
+#include "core/options.h"
+
+namespace librealsense
+{
+    class video_stream_profile;
+    struct frame_additional_data;
+
+    namespace net
+    {
+        struct option_description
+        {
+            rs2_option id;
+            option_range range;
+            bool read_only;
+            std::string description;
+        };
+
+        struct profile_description
+        {
+            uint32_t uid;       // On the described device
+            rs2_stream stream;
+            int32_t index;
+            rs2_format format;
+            uint32_t fps;
+            uint32_t width;
+            uint32_t height;
+            int32_t tag;
+            bool has_intrinsics;
+            rs2_intrinsics intrinsics;
+        };
+
+        struct sensor_description
+        {
+            std::string name;
+            std::vector<std::pair<rs2_camera_info, std::string>> infos;
+            bool is_depth;
+            float depth_units;
+            std::vector<option_description> options;
+            std::vector<profile_description> profiles;
+        };
+
+        // What a device publishes of itself to the processes streaming from it: its video profiles alone, and the extrinsics
+        // from the first of them to every other
+        struct device_description
+        {
+            std::vector<std::pair<rs2_camera_info, std::string>> infos;
+            std::vector<sensor_description> sensors;
+            std::vector<std::pair<uint32_t, rs2_extrinsics>> extrinsics;
+        };
+
+        device_description describe(const device_interface& dev);
+
+        void write_description(writer& w, const device_description& description);
+        // Throws when the description is of another protocol version
+        device_description read_description(reader& r);
+
+        // Profile with a unique id of this process
+        std::shared_ptr<video_stream_profile> create_profile(const profile_description& description);
+
+        // Header of a video frame, with its data raw, and its metadata appended to the pairs. Fails for other frames
+        bool describe_frame(frame_interface& f, uint32_t sensor, frame_header& header, std::vector<metadata_pair>& metadata);
+        frame_additional_data get_additional_data(const frame_header& header, const metadata_pair* metadata, size_t count);
+    }
+}
@@ -0,0 +1,335 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include "net-device.h"
+#include "net-description.h"
+#include "stream.h"
+#include "environment.h"
+#include "metadata-parser.h"
+
+namespace librealsense
+{
+    const std::chrono::seconds net_request_timeout(5);
+
+    net_device::net_device(std::shared_ptr<context> ctx, const std::string& address)
+        : device(ctx, platform::backend_device_group({ platform::playback_device_info{ address } })),
+          _address(address),
+          _socket(net::socket::connect(address))
+    {
+        net::message_header header;
+        if (!net::receive_header(_socket, header) || header.type != static_cast<uint32_t>(net::message_type::description))
+            throw io_exception(to_string() << "No device description from " << address);
+
+        std::vector<uint8_t> payload(header.size);
+        if (!_socket.receive(payload.data(), payload.size()))
+            throw io_exception(to_string() << "No device description from " << address);
+
+        net::reader r(payload);
+        add_sensors(net::read_description(r));
+
+        _receive_thread = std::thread([this]() { receive_loop(); });
+    }
+
+    net_device::~net_device()
+    {
+        _socket.shutdown();
+        if (_receive_thread.joinable())
+            _receive_thread.join();
+    }
+
+    void net_device::add_sensors(const net::device_description& description)
+    {
+        for (auto&& info : description.infos)
+            register_info(info.first, info.second);
+
+        std::vector<std::shared_ptr<stream_profile_interface>> profiles;
+        for (uint32_t s = 0; s < description.sensors.size(); ++s)
+        {
+            auto&& d = description.sensors[s];
+            std::shared_ptr<net_sensor> sensor = d.is_depth ?
+                std::make_shared<net_depth_sensor>(d.name, this, s, d.depth_units) :
+                std::make_shared<net_sensor>(d.name, this, s);
+            for (auto&& info : d.infos)
+                if (info.first != RS2_CAMERA_INFO_NAME)
+                    sensor->register_info(info.first, info.second);
+
+            // The frame queue and memory options of the server are left to the local ones of the sensor
+            for (auto&& o : d.options)
+                if (!sensor->supports_option(o.id))
+                    sensor->register_option(o.id, std::make_shared<net_option>(this, s, o.id, o.range, o.read_only, o.description));
+
+            for (auto&& p : d.profiles)
+            {
+                auto profile = net::create_profile(p);
+                sensor->_profiles.push_back(profile);
+                sensor->_remote_ids[profile->get_unique_id()] = p.uid;
+                _profiles[p.uid] = profile;
+                profiles.push_back(profile);
+            }
+
+            add_sensor(sensor);
+            _net_sensors.push_back(sensor);
+        }
+
+        // Relative to the first profile the server described
+        for (auto&& e : description.extrinsics)
+        {
+            auto it = _profiles.find(e.first);
+            if (!profiles.empty() && it != _profiles.end())
+                environment::get_instance().get_extrinsics_graph().register_extrinsics(*profiles.front(), *it->second, e.second);
+        }
+    }
+
+    std::shared_ptr<matcher> net_device::create_matcher(const frame_holder& frame) const
+    {
+        std::vector<stream_interface*> profiles;
+
+        for (auto&& s : _net_sensors)
+            for (auto&& p : s->get_stream_profiles())
+                profiles.push_back(p.get());
+
+        return matcher_factory::create(RS2_MATCHER_DEFAULT, profiles);
+    }
+
+    float net_device::request(net::request_type type, uint32_t sensor, const net::writer& args)
+    {
+        std::lock_guard<std::mutex> request_lock(_request_mutex);
+
+        uint32_t id;
+        {
+            std::lock_guard<std::mutex> lock(_response_mutex);
+            if (!_connected)
+                throw io_exception(to_string() << "The network device " << _address << " is disconnected");
+            id = ++_request_id;
+            _has_response = false;
+        }
+
+        net::writer w;
+        w << id << static_cast<uint32_t>(type) << sensor;
+        auto payload = w.data();
+        payload.insert(payload.end(), args.data().begin(), args.data().end());
+        net::send_message(_socket, net::message_type::request, payload);
+
+        std::unique_lock<std::mutex> lock(_response_mutex);
+        if (!_response_cv.wait_for(lock, net_request_timeout, [this]() { return _has_response || !_connected; }))
+            throw io_exception(to_string() << "The network device " << _address << " did not respond in time");
+        if (!_has_response)
+            throw io_exception(to_string() << "The network device " << _address << " is disconnected");
+        if (!_response_ok)
+            throw invalid_value_exception(_response_error);
+        return _response_value;
+    }
+
+    void net_device::fail_requests(const std::string& error)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_response_mutex);
+            _connected = false;
+        }
+        _response_cv.notify_all();
+        LOG_WARNING("Network device " << _address << " disconnected, " << error);
+    }
+
+    void net_device::receive_loop()
+    {
+        try
+        {
+            net::message_header header;
+            std::vector<uint8_t> payload;
+            while (net::receive_header(_socket, header))
+            {
+                if (header.type == static_cast<uint32_t>(net::message_type::frame))
+                {
+                    receive_frame(header);
+                    continue;
+                }
+
+                payload.resize(header.size);
+                if (!_socket.receive(payload.data(), payload.size()))
+                    break;
+                if (header.type != static_cast<uint32_t>(net::message_type::response))
+                    continue;
+
+                net::reader r(payload);
+                auto id = r.read<uint32_t>();
+                auto ok = r.read<uint32_t>();
+                auto value = r.read<float>();
+                auto error = r.read<std::string>();
+
+                std::lock_guard<std::mutex> lock(_response_mutex);
+                if (id != _request_id)
+                    continue; // Of a request that timed out
+                _response_ok = ok != 0;
+                _response_value = value;
+                _response_error = error;
+                _has_response = true;
+                _response_cv.notify_all();
+            }
+            fail_requests("connection closed");
+        }
+        catch (const std::exception& e)
+        {
+            fail_requests(e.what());
+        }
+    }
+
+    void net_device::receive_frame(const net::message_header& header)
+    {
+        net::frame_header fh;
+        if (header.size < sizeof(fh) || !_socket.receive(&fh, sizeof(fh)))
+            throw io_exception("Truncated frame");
+
+        std::vector<net::metadata_pair> metadata(fh.metadata_count);
+        auto metadata_size = metadata.size() * sizeof(net::metadata_pair);
+        if (header.size < sizeof(fh) + metadata_size || !_socket.receive(metadata.data(), metadata_size))
+            throw io_exception("Truncated frame");
+        auto encoded_size = header.size - sizeof(fh) - metadata_size;
+
+        frame_interface* frame = nullptr;
+        auto it = _profiles.find(fh.profile);
+        if (fh.sensor < _net_sensors.size() && it != _profiles.end())
+            frame = _net_sensors[fh.sensor]->alloc_frame(fh, metadata, it->second);
+        frame_holder holder(frame);
+
+        // Raw data lands in the frame itself, encoded data is decoded into it
+        auto c = static_cast<net::codec>(fh.codec);
+        if (frame && c == net::codec::raw && encoded_size == fh.data_size)
+        {
+            if (!_socket.receive(const_cast<byte*>(frame->get_frame_data()), encoded_size))
+                throw io_exception("Truncated frame");
+        }
+        else
+        {
+            _scratch.resize(encoded_size);
+            if (!_socket.receive(_scratch.data(), encoded_size))
+                throw io_exception("Truncated frame");
+            if (frame && !net::decode(c, _scratch.data(), encoded_size, const_cast<byte*>(frame->get_frame_data()), fh.data_size))
+            {
+                LOG_WARNING("Dropped a frame of " << _address << " that did not decode");
+                return;
+            }
+        }
+
+        if (frame)
+            _net_sensors[fh.sensor]->on_frame(std::move(holder));
+    }
+
+    net_sensor::net_sensor(std::string name, net_device* owner, uint32_t index)
+        : sensor_base(name, owner), _device(owner), _index(index)
+    {
+        _metadata_parsers = md_constant_parser::create_metadata_parser_map();
+    }
+
+    stream_profiles net_sensor::init_stream_profiles()
+    {
+        return _profiles;
+    }
+
+    void net_sensor::open(const stream_profiles& requests)
+    {
+        if (_is_streaming)
+            throw wrong_api_call_sequence_exception("open(...) failed. Network device is streaming!");
+        else if (_is_opened)
+            throw wrong_api_call_sequence_exception("open(...) failed. Network device is already opened!");
+
+        net::writer args;
+        args << static_cast<uint32_t>(requests.size());
+        for (auto&& r : requests)
+        {
+            auto it = _remote_ids.find(r->get_unique_id());
+            if (it == _remote_ids.end())
+                throw invalid_value_exception("open(...) failed. The stream profile is not of this network sensor!");
+            args << it->second;
+        }
+        _device->request(net::request_type::open, _index, args);
+
+        _is_opened = true;
+        set_active_streams(requests);
+    }
+
+    void net_sensor::close()
+    {
+        if (_is_streaming)
+            throw wrong_api_call_sequence_exception("close() failed. Network device is streaming!");
+        else if (!_is_opened)
+            throw wrong_api_call_sequence_exception("close() failed. Network device was not opened!");
+
+        _is_opened = false;
+        set_active_streams({});
+        _device->request(net::request_type::close, _index);
+    }
+
+    void net_sensor::start(frame_callback_ptr callback)
+    {
+        if (_is_streaming)
+            throw wrong_api_call_sequence_exception("start_streaming(...) failed. Network device is already streaming!");
+        else if (!_is_opened)
+            throw wrong_api_call_sequence_exception("start_streaming(...) failed. Network device was not opened!");
+
+        _source.init(_metadata_parsers, get_frame_allocator(), get_preallocation());
+        _source.set_sensor(this->shared_from_this());
+        _source.set_callback(callback);
+        _device->request(net::request_type::start, _index);
+        _is_streaming = true;
+        raise_on_before_streaming_changes(true);
+    }
+
+    void net_sensor::stop()
+    {
+        if (!_is_streaming)
+            throw wrong_api_call_sequence_exception("stop_streaming() failed. Network device is not streaming!");
+
+        _is_streaming = false;
+        raise_on_before_streaming_changes(false);
+        _source.flush();
+        _source.reset();
+
+        // Stopped locally even when the server is gone
+        _device->request(net::request_type::stop, _index);
+    }
+
+    frame_interface* net_sensor::alloc_frame(const net::frame_header& header, const std::vector<net::metadata_pair>& metadata,
+                                             std::shared_ptr<stream_profile_interface> profile)
+    {
+        if (!_is_streaming)
+            return nullptr;
+
+        auto data = net::get_additional_data(header, metadata.data(), metadata.size());
+
+        auto extension = profile->get_stream_type() == RS2_STREAM_DEPTH ? RS2_EXTENSION_DEPTH_FRAME : RS2_EXTENSION_VIDEO_FRAME;
+        auto frame = _source.alloc_frame(extension, header.data_size, data, true);
+        if (!frame)
+        {
+            LOG_INFO("Dropped frame. alloc_frame(...) returned nullptr");
+            return nullptr;
+        }
+
+        auto vid_frame = dynamic_cast<video_frame*>(frame);
+        vid_frame->assign(header.width, header.height, header.stride, header.bpp);
+        frame->set_stream(profile);
+        return frame;
+    }
+
+    void net_sensor::on_frame(frame_holder frame)
+    {
+        _source.invoke_callback(std::move(frame));
+    }
+
+    void net_option::set(float value)
+    {
+        if (_read_only)
+            throw invalid_value_exception(to_string() << "Option " << rs2_option_to_string(_id) << " is read only!");
+
+        net::writer args;
+        args << static_cast<uint32_t>(_id) << value;
+        _owner->request(net::request_type::set_option, _sensor, args);
+        _recording_function(*this);
+    }
+
+    float net_option::query() const
+    {
+        net::writer args;
+        args << static_cast<uint32_t>(_id);
+        return _owner->request(net::request_type::get_option, _sensor, args);
+    }
+}
@@ -0,0 +1,158 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "net-protocol.h"
+#include "core/streaming.h"
+#include "core/video.h"
+#include "device.h"
+#include "context.h"
+
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace librealsense
+{
+    class net_sensor;
+    namespace net { struct device_description; }
+
+    // Device streaming from a net_server. The sensors, options and profiles are those the server described on connection,
+    // opening and starting them and setting their options are requests to the server, and frames arrive on a receiving thread
+    class net_device : public device
+    {
+    public:
+        net_device(std::shared_ptr<context> ctx, const std::string& address);
+        ~net_device();
+
+        const std::string& get_address() const { return _address; }
+
+        std::shared_ptr<matcher> create_matcher(const frame_holder& frame) const override;
+
+        std::vector<tagged_profile> get_profiles_tags() const override
+        {
+            std::vector<tagged_profile> markers;
+            return markers;
+        };
+
+        // Sends the request and waits for its response, throwing the error the server reported
+        float request(net::request_type type, uint32_t sensor, const net::writer& args = {});
+
+    private:
+        void add_sensors(const net::device_description& description);
+        void receive_loop();
+        void receive_frame(const net::message_header& header);
+        void fail_requests(const std::string& error);
+
+        std::string _address;
+        net::socket _socket;
+        std::vector<std::shared_ptr<net_sensor>> _net_sensors;
+        std::map<uint32_t, std::shared_ptr<stream_profile_interface>> _profiles;  // By the unique id on the server
+
+        std::mutex _request_mutex;              // Requests go out one at a time
+        std::mutex _response_mutex;
+        std::condition_variable _response_cv;
+        uint32_t _request_id = 0;
+        bool _has_response = false;
+        bool _response_ok = false;
+        float _response_value = 0;
+        std::string _response_error;
+        bool _connected = true;
+
+        std::vector<uint8_t> _scratch;          // Encoded data of a frame, or data nothing takes
+        std::thread _receive_thread;
+    };
+
+    class net_sensor : public sensor_base
+    {
+    public:
+        net_sensor(std::string name, net_device* owner, uint32_t index);
+
+        stream_profiles init_stream_profiles() override;
+
+        void open(const stream_profiles& requests) override;
+        void close() override;
+
+        void start(frame_callback_ptr callback) override;
+        void stop() override;
+
+        // Frame for the data of the message, or nullptr when the sensor does not stream, or its frames are all in use
+        frame_interface* alloc_frame(const net::frame_header& header, const std::vector<net::metadata_pair>& metadata,
+                                     std::shared_ptr<stream_profile_interface> profile);
+        void on_frame(frame_holder frame);
+
+    private:
+        friend class net_device;
+        net_device* _device;
+        uint32_t _index;
+        stream_profiles _profiles;
+        std::map<int, uint32_t> _remote_ids;   // Unique id on the server of every local profile
+    };
+
+    class net_depth_sensor : public net_sensor, public virtual depth_sensor
+    {
+    public:
+        net_depth_sensor(std::string name, net_device* owner, uint32_t index, float depth_units)
+            : net_sensor(name, owner, index), _depth_units(depth_units) {}
+
+        float get_depth_scale() const override { return _depth_units; }
+
+        void create_snapshot(std::shared_ptr<depth_sensor>& snapshot) const override
+        {
+            snapshot = std::make_shared<depth_sensor_snapshot>(get_depth_scale());
+        }
+
+        void enable_recording(std::function<void(const depth_sensor&)> recording_function) override {}
+
+    private:
+        float _depth_units;
+    };
+
+    // Option of a sensor of the server, queried and set remotely
+    class net_option : public option_base
+    {
+    public:
+        net_option(net_device* owner, uint32_t sensor, rs2_option id, const option_range& range, bool read_only, std::string desc)
+            : option_base(range), _owner(owner), _sensor(sensor), _id(id), _read_only(read_only), _desc(std::move(desc)) {}
+
+        void set(float value) override;
+        float query() const override;
+        bool is_enabled() const override { return true; }
+        bool is_read_only() const override { return _read_only; }
+        const char* get_description() const override { return _desc.c_str(); }
+
+    private:
+        net_device* _owner;
+        uint32_t _sensor;
+        rs2_option _id;
+        bool _read_only;
+        std::string _desc;
+    };
+
+    class net_device_info : public device_info
+    {
+    public:
+        explicit net_device_info(std::shared_ptr<net_device> dev)
+            : device_info(dev->get_context()), _dev(dev) {}
+
+        std::shared_ptr<device_interface> create_device(bool) const override
+        {
+            return _dev;
+        }
+
+        platform::backend_device_group get_device_data() const override
+        {
+            return platform::backend_device_group({ platform::playback_device_info{ _dev->get_address() } });
+        }
+
+        std::shared_ptr<device_interface> create(std::shared_ptr<context>, bool) const override
+        {
+            return _dev;
+        }
+
+    private:
+        std::shared_ptr<net_device> _dev;
+    };
+}
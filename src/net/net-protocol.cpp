@@ -0,0 +1,349 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include "net-protocol.h"
+#include "../../third-party/realsense-file/lz4/lz4.h"
+#include "proc/depth-codec.h"
+
+#ifdef _WIN32
+#include <ws2tcpip.h>
+#pragma comment(lib, "Ws2_32.lib")
+#else
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+#include <mutex>
+
+namespace librealsense
+{
+    namespace net
+    {
+#ifdef _WIN32
+        static const socket::handle invalid_handle = INVALID_SOCKET;
+
+        static void init_sockets()
+        {
+            static std::once_flag once;
+            std::call_once(once, []()
+            {
+                WSADATA data;
+                if (WSAStartup(MAKEWORD(2, 2), &data) != 0)
+                    throw io_exception("WSAStartup failed");
+            });
+        }
+
+        static std::string last_error() { return std::to_string(WSAGetLastError()); }
+        static void close_handle(socket::handle h) { closesocket(h); }
+        static const int send_flags = 0;
+#else
+        static const socket::handle invalid_handle = -1;
+
+        static void init_sockets() {}
+        static std::string last_error() { return strerror(errno); }
+        static void close_handle(socket::handle h) { ::close(h); }
+#ifdef MSG_NOSIGNAL
+        static const int send_flags = MSG_NOSIGNAL;
+#else
+        static const int send_flags = 0;
+#endif
+#endif
+
+        socket::socket() : _handle(invalid_handle) {}
+
+        socket::socket(handle h) : _handle(h)
+        {
+            // Frames and responses go out at once instead of waiting to fill a segment
+            int one = 1;
+            setsockopt(_handle, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&one), sizeof(one));
+#ifdef SO_NOSIGPIPE
+            setsockopt(_handle, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+        }
+
+        socket::~socket()
+        {
+            close();
+        }
+
+        socket::socket(socket&& other) : _handle(other._handle)
+        {
+            other._handle = invalid_handle;
+        }
+
+        socket& socket::operator=(socket&& other)
+        {
+            if (this != &other)
+            {
+                close();
+                _handle = other._handle;
+                other._handle = invalid_handle;
+            }
+            return *this;
+        }
+
+        void socket::close()
+        {
+            if (_handle != invalid_handle)
+                close_handle(_handle);
+            _handle = invalid_handle;
+        }
+
+        socket socket::connect(const std::string& address)
+        {
+            init_sockets();
+
+            auto host = address;
+            auto port = std::to_string(default_port);
+            auto colon = address.rfind(':');
+            if (colon != std::string::npos)
+            {
+                host = address.substr(0, colon);
+                port = address.substr(colon + 1);
+            }
+
+            addrinfo hints{};
+            hints.ai_family = AF_UNSPEC;
+            hints.ai_socktype = SOCK_STREAM;
+            addrinfo* result = nullptr;
+            if (getaddrinfo(host.c_str(), port.c_str(), &hints, &result) != 0 || !result)
+                throw io_exception(to_string() << "Cannot resolve the address " << address);
+
+            for (auto ai = result; ai; ai = ai->ai_next)
+            {
+                auto h = ::socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+                if (h == invalid_handle)
+                    continue;
+                if (::connect(h, ai->ai_addr, static_cast<int>(ai->ai_addrlen)) == 0)
+                {
+                    freeaddrinfo(result);
+                    return socket(h);
+                }
+                close_handle(h);
+            }
+            freeaddrinfo(result);
+            throw io_exception(to_string() << "Cannot connect to " << address << ", " << last_error());
+        }
+
+        socket socket::listen(uint16_t port, bool allow_remote)
+        {
+            init_sockets();
+
+            auto h = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+            if (h == invalid_handle)
+                throw io_exception(to_string() << "Cannot create a socket, " << last_error());
+
+            int one = 1;
+            setsockopt(h, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&one), sizeof(one));
+
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_addr.s_addr = htonl(allow_remote ? INADDR_ANY : INADDR_LOOPBACK);
+            addr.sin_port = htons(port);
+            if (::bind(h, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(h, 1) != 0)
+            {
+                auto error = last_error();
+                close_handle(h);
+                throw io_exception(to_string() << "Cannot listen on port " << port << ", " << error);
+            }
+
+            socket s;
+            s._handle = h;
+            return s;
+        }
+
+        socket socket::accept() const
+        {
+            auto h = ::accept(_handle, nullptr, nullptr);
+            if (h == invalid_handle)
+                return socket();
+            return socket(h);
+        }
+
+        void socket::send(const void* data, size_t size) const
+        {
+            auto p = static_cast<const char*>(data);
+            while (size > 0)
+            {
+                auto sent = ::send(_handle, p, static_cast<int>(std::min<size_t>(size, 1 << 30)), send_flags);
+                if (sent <= 0)
+                {
+#ifndef _WIN32
+                    if (sent < 0 && errno == EINTR)
+                        continue;
+#endif
+                    throw io_exception(to_string() << "Network send failed, " << last_error());
+                }
+                p += sent;
+                size -= sent;
+            }
+        }
+
+        bool socket::receive(void* data, size_t size) const
+        {
+            auto p = static_cast<char*>(data);
+            while (size > 0)
+            {
+                auto received = ::recv(_handle, p, static_cast<int>(std::min<size_t>(size, 1 << 30)), 0);
+                if (received <= 0)
+                {
+#ifndef _WIN32
+                    if (received < 0 && errno == EINTR)
+                        continue;
+#endif
+                    return false;
+                }
+                p += received;
+                size -= received;
+            }
+            return true;
+        }
+
+        void socket::shutdown() const
+        {
+            if (_handle == invalid_handle)
+                return;
+#ifdef _WIN32
+            ::shutdown(_handle, SD_BOTH);
+#else
+            ::shutdown(_handle, SHUT_RDWR);
+#endif
+        }
+
+        bool socket::is_valid() const
+        {
+            return _handle != invalid_handle;
+        }
+
+        std::string socket::get_peer() const
+        {
+            sockaddr_storage addr{};
+            socklen_t size = sizeof(addr);
+            if (getpeername(_handle, reinterpret_cast<sockaddr*>(&addr), &size) != 0)
+                return "";
+
+            char host[NI_MAXHOST] = {};
+            char port[NI_MAXSERV] = {};
+            if (getnameinfo(reinterpret_cast<sockaddr*>(&addr), size, host, sizeof(host), port, sizeof(port), NI_NUMERICHOST | NI_NUMERICSERV) != 0)
+                return "";
+            return to_string() << host << ":" << port;
+        }
+
+        void send_message(const socket& s, message_type type, const std::vector<uint8_t>& payload)
+        {
+            std::vector<uint8_t> data(sizeof(message_header) + payload.size());
+            message_header header{ protocol_magic, static_cast<uint32_t>(type), static_cast<uint32_t>(payload.size()) };
+            memcpy(data.data(), &header, sizeof(header));
+            if (!payload.empty())
+                memcpy(data.data() + sizeof(header), payload.data(), payload.size());
+            s.send(data.data(), data.size());
+        }
+
+        bool receive_header(const socket& s, message_header& header)
+        {
+            if (!s.receive(&header, sizeof(header)))
+                return false;
+            validate_header(header);
+            return true;
+        }
+
+        void validate_header(const message_header& header)
+        {
+            if (header.magic != protocol_magic)
+                throw invalid_value_exception("Invalid network message");
+            if (header.size > max_payload_size)
+                throw invalid_value_exception(to_string() << "Network message of " << header.size << " bytes, above the maximum of "
+                                                          << max_payload_size);
+        }
+
+        codec encode(rs2_format format, const uint8_t* src, size_t size, std::vector<uint8_t>& dst)
+        {
+            dst.clear();
+            if (size == 0 || size > static_cast<size_t>(LZ4_MAX_INPUT_SIZE))
+                return codec::raw;
+
+            if (format == RS2_FORMAT_Z16 && size % 2 == 0)
+            {
+                dst.resize(rvl_max_encoded_size(size / 2));
+                dst.resize(rvl_encode(reinterpret_cast<const uint16_t*>(src), size / 2, dst.data()));
+                if (dst.size() >= size)
+                {
+                    dst.clear();
+                    return codec::raw;
+                }
+                return codec::rvl;
+            }
+
+            auto c = codec::lz4;
+            std::vector<uint8_t> delta;
+            if (format == RS2_FORMAT_DISPARITY16 && size % 2 == 0)
+            {
+                // Neighbouring depth values are close, and their differences mostly zero or small
+                c = codec::delta_lz4;
+                delta.resize(size);
+                auto in = reinterpret_cast<const uint16_t*>(src);
+                auto out = reinterpret_cast<uint16_t*>(delta.data());
+                uint16_t prev = 0;
+                for (size_t i = 0; i < size / 2; ++i)
+                {
+                    out[i] = static_cast<uint16_t>(in[i] - prev);
+                    prev = in[i];
+                }
+                src = delta.data();
+            }
+
+            dst.resize(LZ4_compressBound(static_cast<int>(size)));
+            auto compressed = LZ4_compress_default(reinterpret_cast<const char*>(src), reinterpret_cast<char*>(dst.data()),
+                                                   static_cast<int>(size), static_cast<int>(dst.size()));
+            if (compressed <= 0 || static_cast<size_t>(compressed) >= size)
+            {
+                dst.clear();
+                return codec::raw;
+            }
+            dst.resize(compressed);
+            return c;
+        }
+
+        bool decode(codec c, const uint8_t* src, size_t size, uint8_t* dst, size_t dst_size)
+        {
+            switch (c)
+            {
+            case codec::raw:
+                if (size != dst_size)
+                    return false;
+                memcpy(dst, src, size);
+                return true;
+            case codec::lz4:
+            case codec::delta_lz4:
+            {
+                auto decoded = LZ4_decompress_safe(reinterpret_cast<const char*>(src), reinterpret_cast<char*>(dst),
+                                                   static_cast<int>(size), static_cast<int>(dst_size));
+                if (decoded < 0 || static_cast<size_t>(decoded) != dst_size)
+                    return false;
+
+                if (c == codec::delta_lz4)
+                {
+                    auto p = reinterpret_cast<uint16_t*>(dst);
+                    uint16_t prev = 0;
+                    for (size_t i = 0; i < dst_size / 2; ++i)
+                    {
+                        p[i] = static_cast<uint16_t>(p[i] + prev);
+                        prev = p[i];
+                    }
+                }
+                return true;
+            }
+            case codec::rvl:
+                return dst_size % 2 == 0 && rvl_decode(src, size, reinterpret_cast<uint16_t*>(dst), dst_size / 2);
+            default:
+                return false;
+            }
+        }
+    }
+}
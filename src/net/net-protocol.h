@@ -0,0 +1,218 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "../include/librealsense2/h/rs_types.h"
+#include "../include/librealsense2/h/rs_sensor.h"
+#include "types.h"
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include <type_traits>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#endif
+
+namespace librealsense
+{
+    // Streaming of a device over TCP. A connection starts with the server describing the device, after which the client sends
+    // requests, each answered by a response, while the server sends the frames of the streams the client started.
+    // Every message is a header followed by its payload, in the byte order of the hosts, which are assumed to agree
+    namespace net
+    {
+        const uint32_t protocol_magic = 0x4E535352;  // "RSSN"
+        const uint32_t protocol_version = 1;
+        const uint16_t default_port = 8554;
+        // Of a message payload, above any frame the devices stream, for a corrupt or hostile header not to allocate the memory out
+        const uint32_t max_payload_size = 64 * 1024 * 1024;
+
+        enum class message_type : uint32_t
+        {
+            description = 1,
+            request     = 2,
+            response    = 3,
+            frame       = 4,
+        };
+
+        enum class request_type : uint32_t
+        {
+            open       = 1,
+            start      = 2,
+            stop       = 3,
+            close      = 4,
+            set_option = 5,
+            get_option = 6,
+        };
+
+        // Encoding of the data of a frame. Z16 depth goes through the lossless depth codec, disparity is delta-coded along the
+        // rows before compression, and every frame falls back to its raw data when compression does not shrink it
+        enum class codec : uint32_t
+        {
+            raw       = 0,
+            lz4       = 1,
+            delta_lz4 = 2,
+            rvl       = 3,
+        };
+
+#pragma pack(push, 1)
+        struct message_header
+        {
+            uint32_t magic;
+            uint32_t type;
+            uint32_t size;      // Of the payload that follows
+        };
+
+        // Fixed part of a frame message, followed by its metadata pairs and then by its encoded data
+        struct frame_header
+        {
+            uint32_t sensor;
+            uint32_t profile;
+            uint32_t codec;
+            double timestamp;
+            uint32_t domain;
+            uint64_t frame_number;
+            uint32_t width;
+            uint32_t height;
+            uint32_t stride;
+            uint32_t bpp;           // Bits per pixel
+            uint32_t data_size;     // Decoded
+            uint32_t metadata_count;
+        };
+
+        struct metadata_pair
+        {
+            uint32_t key;
+            int64_t value;
+        };
+#pragma pack(pop)
+
+        // Connected or listening TCP socket, closed on destruction
+        class socket
+        {
+        public:
+#ifdef _WIN32
+            typedef SOCKET handle;
+#else
+            typedef int handle;
+#endif
+            socket();
+            ~socket();
+            socket(socket&& other);
+            socket& operator=(socket&& other);
+
+            // host:port, or host alone for the default port
+            static socket connect(const std::string& address);
+            // On the loopback interface alone, unless the other hosts of the network are to be let in
+            static socket listen(uint16_t port, bool allow_remote);
+
+            // Invalid once the socket is shut down
+            socket accept() const;
+
+            void send(const void* data, size_t size) const;
+            // False when the connection is closed before size bytes arrive
+            bool receive(void* data, size_t size) const;
+
+            // Fails the pending and the following calls, from any thread
+            void shutdown() const;
+
+            bool is_valid() const;
+            std::string get_peer() const;
+
+        private:
+            explicit socket(handle h);
+            socket(const socket&) = delete;
+            socket& operator=(const socket&) = delete;
+
+            void close();
+
+            handle _handle;
+        };
+
+        // Builds a payload of trivially copyable values and of strings
+        class writer
+        {
+        public:
+            template<class T>
+            writer& operator<<(const T& value)
+            {
+                static_assert(std::is_trivially_copyable<T>::value, "writer supports trivially copyable types and strings only");
+                auto p = reinterpret_cast<const uint8_t*>(&value);
+                _data.insert(_data.end(), p, p + sizeof(T));
+                return *this;
+            }
+
+            writer& operator<<(const std::string& value)
+            {
+                *this << static_cast<uint32_t>(value.size());
+                _data.insert(_data.end(), value.begin(), value.end());
+                return *this;
+            }
+
+            const std::vector<uint8_t>& data() const { return _data; }
+
+        private:
+            std::vector<uint8_t> _data;
+        };
+
+        // Reads back a payload a writer built, throwing when it ends early
+        class reader
+        {
+        public:
+            reader(const uint8_t* data, size_t size) : _data(data), _left(size) {}
+            explicit reader(const std::vector<uint8_t>& data) : reader(data.data(), data.size()) {}
+
+            template<class T>
+            reader& operator>>(T& value)
+            {
+                static_assert(std::is_trivially_copyable<T>::value, "reader supports trivially copyable types and strings only");
+                take(&value, sizeof(T));
+                return *this;
+            }
+
+            reader& operator>>(std::string& value)
+            {
+                uint32_t size;
+                *this >> size;
+                if (size > _left)
+                    throw invalid_value_exception("Truncated network message");
+                value.assign(reinterpret_cast<const char*>(_data), size);
+                _data += size;
+                _left -= size;
+                return *this;
+            }
+
+            template<class T>
+            T read()
+            {
+                T value;
+                *this >> value;
+                return value;
+            }
+
+        private:
+            void take(void* dst, size_t size)
+            {
+                if (size > _left)
+                    throw invalid_value_exception("Truncated network message");
+                memcpy(dst, _data, size);
+                _data += size;
+                _left -= size;
+            }
+
+            const uint8_t* _data;
+            size_t _left;
+        };
+
+        void send_message(const socket& s, message_type type, const std::vector<uint8_t>& payload);
+        // False when the connection is closed. Throws for a header of another protocol or of a payload above max_payload_size
+        bool receive_header(const socket& s, message_header& header);
+        void validate_header(const message_header& header);
+
+        // Encodes the data into dst, and returns raw with dst left empty when the encoding would not be smaller
+        codec encode(rs2_format format, const uint8_t* src, size_t size, std::vector<uint8_t>& dst);
+        bool decode(codec c, const uint8_t* src, size_t size, uint8_t* dst, size_t dst_size);
+    }
+}
@@ -0,0 +1,262 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include "net-server.h"
+#include "net-description.h"
+#include "archive.h"
+#include "core/video.h"
+
+namespace librealsense
+{
+    net_server::net_server(std::shared_ptr<device_interface> dev, uint16_t port, bool allow_remote)
+        : _dev(std::move(dev)),
+          _listener(net::socket::listen(port ? port : net::default_port, allow_remote)),
+          _stopping(false),
+          _frames(4)
+    {
+        _sensor_states.resize(_dev->get_sensors_count());
+        for (uint32_t i = 0; i < _dev->get_sensors_count(); ++i)
+        {
+            auto&& sensor = _dev->get_sensor(i);
+            _sensor_indices[&sensor] = i;
+            for (auto&& p : sensor.get_stream_profiles())
+                if (dynamic_cast<video_stream_profile_interface*>(p.get()))
+                    _profiles[static_cast<uint32_t>(p->get_unique_id())] = p;
+        }
+
+        _accept_thread = std::thread([this]() { accept_loop(); });
+        _send_thread = std::thread([this]() { send_loop(); });
+    }
+
+    net_server::~net_server()
+    {
+        _stopping = true;
+        _listener.shutdown();
+        {
+            std::lock_guard<std::mutex> lock(_client_mutex);
+            if (_client)
+                _client->shutdown();
+        }
+        _frames.clear();
+
+        if (_accept_thread.joinable())
+            _accept_thread.join();
+        if (_send_thread.joinable())
+            _send_thread.join();
+    }
+
+    void net_server::accept_loop()
+    {
+        while (!_stopping)
+        {
+            auto client = _listener.accept();
+            if (!client.is_valid())
+            {
+                if (!_stopping)
+                    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                continue;
+            }
+
+            LOG_INFO("Network client connected from " << client.get_peer());
+            try
+            {
+                serve(client);
+            }
+            catch (const std::exception& e)
+            {
+                LOG_WARNING("Network client disconnected, " << e.what());
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(_client_mutex);
+                _client = nullptr;
+            }
+            release_sensors();
+
+            // The queue drops what is left of the client, and takes frames again for the next one
+            _frames.clear();
+            _frames.start();
+        }
+    }
+
+    void net_server::serve(net::socket& client)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_client_mutex);
+            net::send_message(client, net::message_type::description, describe());
+            _client = &client;
+        }
+
+        std::vector<uint8_t> payload;
+        net::message_header header;
+        while (!_stopping && net::receive_header(client, header))
+        {
+            payload.resize(header.size);
+            if (!client.receive(payload.data(), payload.size()))
+                break;
+            if (header.type != static_cast<uint32_t>(net::message_type::request))
+                continue;
+
+            net::reader args(payload);
+            auto id = args.read<uint32_t>();
+            auto type = static_cast<net::request_type>(args.read<uint32_t>());
+            auto sensor = args.read<uint32_t>();
+
+            // Failures are reported to the client, which raises them from the call it made
+            net::writer response;
+            try
+            {
+                auto value = handle_request(type, sensor, args);
+                response << id << static_cast<uint32_t>(1) << value << std::string();
+            }
+            catch (const std::exception& e)
+            {
+                response << id << static_cast<uint32_t>(0) << 0.f << std::string(e.what());
+            }
+
+            std::lock_guard<std::mutex> lock(_client_mutex);
+            net::send_message(client, net::message_type::response, response.data());
+        }
+    }
+
+    void net_server::release_sensors()
+    {
+        for (uint32_t i = 0; i < _sensor_states.size(); ++i)
+        {
+            auto&& sensor = _dev->get_sensor(i);
+            try
+            {
+                if (_sensor_states[i].second)
+                    sensor.stop();
+                if (_sensor_states[i].first)
+                    sensor.close();
+            }
+            catch (const std::exception& e)
+            {
+                LOG_WARNING("Could not release the sensor " << i << " of the network client, " << e.what());
+            }
+            _sensor_states[i] = { false, false };
+        }
+    }
+
+    float net_server::handle_request(net::request_type type, uint32_t index, net::reader& args)
+    {
+        if (index >= _sensor_states.size())
+            throw invalid_value_exception(to_string() << "Invalid sensor index " << index);
+        auto&& sensor = _dev->get_sensor(index);
+
+        switch (type)
+        {
+        case net::request_type::open:
+        {
+            stream_profiles requests;
+            auto count = args.read<uint32_t>();
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                auto it = _profiles.find(args.read<uint32_t>());
+                if (it == _profiles.end())
+                    throw invalid_value_exception("Invalid stream profile");
+                requests.push_back(it->second);
+            }
+            sensor.open(requests);
+            _sensor_states[index].first = true;
+            return 0;
+        }
+        case net::request_type::start:
+        {
+            auto on_frame = [this](frame_holder f)
+            {
+                _frames.enqueue(std::move(f));
+            };
+            sensor.start({ new internal_frame_callback<decltype(on_frame)>(on_frame),
+                           [](rs2_frame_callback* p) { p->release(); } });
+            _sensor_states[index].second = true;
+            return 0;
+        }
+        case net::request_type::stop:
+            sensor.stop();
+            _sensor_states[index].second = false;
+            return 0;
+        case net::request_type::close:
+            sensor.close();
+            _sensor_states[index].first = false;
+            return 0;
+        case net::request_type::set_option:
+        {
+            auto option = static_cast<rs2_option>(args.read<uint32_t>());
+            auto value = args.read<float>();
+            sensor.get_option(option).set(value);
+            return 0;
+        }
+        case net::request_type::get_option:
+            return sensor.get_option(static_cast<rs2_option>(args.read<uint32_t>())).query();
+        default:
+            throw invalid_value_exception("Invalid network request");
+        }
+    }
+
+    std::vector<uint8_t> net_server::describe() const
+    {
+        // Options are described with their range alone, and queried remotely
+        net::writer w;
+        net::write_description(w, net::describe(*_dev));
+        return w.data();
+    }
+
+    void net_server::send_loop()
+    {
+        while (!_stopping)
+        {
+            frame_holder f;
+            if (!_frames.dequeue(&f, 100))
+                continue;
+
+            try
+            {
+                send_frame(f);
+            }
+            catch (const std::exception& e)
+            {
+                // The client is gone, its connection ends the serving loop
+                LOG_DEBUG("Could not send a frame to the network client, " << e.what());
+            }
+        }
+    }
+
+    void net_server::send_frame(frame_holder& f)
+    {
+        auto sensor = f->get_sensor();
+        if (!sensor)
+            return;
+
+        auto it = _sensor_indices.find(sensor.get());
+        if (it == _sensor_indices.end())
+            return;
+
+        net::frame_header header;
+        std::vector<net::metadata_pair> metadata;
+        if (!net::describe_frame(*f.frame, it->second, header, metadata))
+            return;
+
+        auto size = static_cast<size_t>(header.data_size);
+        auto data = f->get_frame_data();
+        auto c = net::encode(f->get_stream()->get_format(), data, size, _encoded);
+        header.codec = static_cast<uint32_t>(c);
+
+        auto encoded_size = c == net::codec::raw ? size : _encoded.size();
+        auto payload_size = sizeof(header) + metadata.size() * sizeof(net::metadata_pair) + encoded_size;
+
+        std::vector<uint8_t> prefix(sizeof(net::message_header) + sizeof(header) + metadata.size() * sizeof(net::metadata_pair));
+        net::message_header message{ net::protocol_magic, static_cast<uint32_t>(net::message_type::frame), static_cast<uint32_t>(payload_size) };
+        memcpy(prefix.data(), &message, sizeof(message));
+        memcpy(prefix.data() + sizeof(message), &header, sizeof(header));
+        if (!metadata.empty())
+            memcpy(prefix.data() + sizeof(message) + sizeof(header), metadata.data(), metadata.size() * sizeof(net::metadata_pair));
+
+        std::lock_guard<std::mutex> lock(_client_mutex);
+        if (!_client)
+            return;
+        _client->send(prefix.data(), prefix.size());
+        _client->send(c == net::codec::raw ? data : _encoded.data(), encoded_size);
+    }
+}
@@ -0,0 +1,53 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "net-protocol.h"
+#include "core/streaming.h"
+#include "concurrency.h"
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace librealsense
+{
+    // Publishes the video streams of a local device to one client at a time, which opens and starts its sensors remotely.
+    // Frames are queued for a sending thread, which drops the oldest when the network falls behind the camera, and the
+    // sensors the client left open are stopped and closed when it disconnects. Only clients of the same host may connect,
+    // unless those of the network are allowed in
+    class net_server
+    {
+    public:
+        net_server(std::shared_ptr<device_interface> dev, uint16_t port, bool allow_remote);
+        ~net_server();
+
+    private:
+        void accept_loop();
+        void serve(net::socket& client);
+        void send_loop();
+        void release_sensors();
+
+        std::vector<uint8_t> describe() const;
+        float handle_request(net::request_type type, uint32_t sensor, net::reader& args);
+        void send_frame(frame_holder& f);
+
+        std::shared_ptr<device_interface> _dev;
+        net::socket _listener;
+        std::atomic<bool> _stopping;
+
+        std::mutex _client_mutex;           // Guards the client and serializes the messages sent to it
+        net::socket* _client = nullptr;
+
+        std::vector<std::pair<bool, bool>> _sensor_states;  // Opened and streaming by the client, per sensor
+        std::map<const sensor_interface*, uint32_t> _sensor_indices;
+        std::map<uint32_t, std::shared_ptr<stream_profile_interface>> _profiles;
+
+        single_consumer_queue<frame_holder> _frames;
+        std::vector<uint8_t> _encoded;
+        std::thread _accept_thread;
+        std::thread _send_thread;
+    };
+}
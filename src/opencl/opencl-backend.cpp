@@ -0,0 +1,449 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#ifdef RS2_USE_OPENCL
+
+#include "opencl-backend.h"
+#include "../types.h"
+
+#include <vector>
+
+#ifdef _MSC_VER
+// Add library dependencies if using VS
+#pragma comment(lib, "OpenCL")
+#endif
+
+namespace librealsense
+{
+    // The kernels follow the CPU code of the blocks step by step, and contraction into fused multiply-adds is disabled
+    // so that the floating point math rounds like the CPU does
+    static const char* kernels_source = R"CL(
+#pragma OPENCL FP_CONTRACT OFF
+
+typedef struct { int width, height; float ppx, ppy, fx, fy; int model; float coeffs[5]; } intrinsics;
+typedef struct { float rotation[9]; float translation[3]; } extrinsics;
+
+float3 deproject(const intrinsics* intrin, float px, float py, float depth)
+{
+    float x = (px - intrin->ppx) / intrin->fx;
+    float y = (py - intrin->ppy) / intrin->fy;
+    if (intrin->model == DISTORTION_INVERSE_BROWN_CONRADY)
+    {
+        float r2 = x*x + y*y;
+        float f = 1 + intrin->coeffs[0]*r2 + intrin->coeffs[1]*r2*r2 + intrin->coeffs[4]*r2*r2*r2;
+        float ux = x*f + 2*intrin->coeffs[2]*x*y + intrin->coeffs[3]*(r2 + 2*x*x);
+        float uy = y*f + 2*intrin->coeffs[3]*x*y + intrin->coeffs[2]*(r2 + 2*y*y);
+        x = ux;
+        y = uy;
+    }
+    return (float3)(depth * x, depth * y, depth);
+}
+
+float3 transform(const extrinsics* extrin, float3 p)
+{
+    return (float3)(extrin->rotation[0] * p.x + extrin->rotation[3] * p.y + extrin->rotation[6] * p.z + extrin->translation[0],
+                    extrin->rotation[1] * p.x + extrin->rotation[4] * p.y + extrin->rotation[7] * p.z + extrin->translation[1],
+                    extrin->rotation[2] * p.x + extrin->rotation[5] * p.y + extrin->rotation[8] * p.z + extrin->translation[2]);
+}
+
+float2 project(const intrinsics* intrin, float3 p)
+{
+    float x = p.x / p.z, y = p.y / p.z;
+    if (intrin->model == DISTORTION_MODIFIED_BROWN_CONRADY)
+    {
+        float r2 = x*x + y*y;
+        float f = 1 + intrin->coeffs[0]*r2 + intrin->coeffs[1]*r2*r2 + intrin->coeffs[4]*r2*r2*r2;
+        x *= f;
+        y *= f;
+        float dx = x + 2*intrin->coeffs[2]*x*y + intrin->coeffs[3]*(r2 + 2*x*x);
+        float dy = y + 2*intrin->coeffs[3]*x*y + intrin->coeffs[2]*(r2 + 2*y*y);
+        x = dx;
+        y = dy;
+    }
+    if (intrin->model == DISTORTION_FTHETA)
+    {
+        float r = sqrt(x*x + y*y);
+        float rd = 1.0f / intrin->coeffs[0] * atan(2 * r * tan(intrin->coeffs[0] / 2.0f));
+        x *= rd / r;
+        y *= rd / r;
+    }
+    return (float2)(x * intrin->fx + intrin->ppx, y * intrin->fy + intrin->ppy);
+}
+
+// The rectangle of other pixels covered by a depth pixel, as in align_images. False when it leaves the other image
+bool other_rect(const intrinsics* depth_intrin, const extrinsics* depth_to_other, const intrinsics* other_intrin,
+                int x, int y, float depth, int4* rect)
+{
+    float2 p0 = project(other_intrin, transform(depth_to_other, deproject(depth_intrin, x - 0.5f, y - 0.5f, depth)));
+    float2 p1 = project(other_intrin, transform(depth_to_other, deproject(depth_intrin, x + 0.5f, y + 0.5f, depth)));
+    int4 r = (int4)((int)(p0.x + 0.5f), (int)(p0.y + 0.5f), (int)(p1.x + 0.5f), (int)(p1.y + 0.5f));
+    *rect = r;
+    return !(r.x < 0 || r.y < 0 || r.z >= other_intrin->width || r.w >= other_intrin->height);
+}
+
+__kernel void unpack_yuy2(__global const uchar* src, __global uchar* dst, int format, int pairs)
+{
+    int i = get_global_id(0);
+    if (i >= pairs) return;
+
+    __global const uchar* s = src + i * 4;
+    int d = s[1] - 128, e = s[3] - 128;
+    for (int k = 0; k < 2; ++k)
+    {
+        int p = i * 2 + k;
+        uchar y = s[k * 2];
+        if (format == FORMAT_Y8) { dst[p] = y; continue; }
+        if (format == FORMAT_Y16) { dst[p * 2] = 0; dst[p * 2 + 1] = y; continue; }
+
+        int c = y - 16;
+        uchar r = clamp((298 * c + 409 * e + 128) >> 8, 0, 255);
+        uchar g = clamp((298 * c - 100 * d - 208 * e + 128) >> 8, 0, 255);
+        uchar b = clamp((298 * c + 516 * d + 128) >> 8, 0, 255);
+        if (format == FORMAT_RGB8) { dst[p * 3] = r; dst[p * 3 + 1] = g; dst[p * 3 + 2] = b; }
+        if (format == FORMAT_BGR8) { dst[p * 3] = b; dst[p * 3 + 1] = g; dst[p * 3 + 2] = r; }
+        if (format == FORMAT_RGBA8) { dst[p * 4] = r; dst[p * 4 + 1] = g; dst[p * 4 + 2] = b; dst[p * 4 + 3] = 255; }
+        if (format == FORMAT_BGRA8) { dst[p * 4] = b; dst[p * 4 + 1] = g; dst[p * 4 + 2] = r; dst[p * 4 + 3] = 255; }
+    }
+}
+
+__kernel void decimate_depth(__global const ushort* src, __global ushort* dst, int width_in, int scale,
+                             int real_width, int real_height, int padded_width, int padded_height)
+{
+    int x = get_global_id(0), y = get_global_id(1);
+    if (x >= padded_width || y >= padded_height) return;
+
+    ushort result = 0;
+    if (x < real_width && y < real_height)
+    {
+        __global const ushort* block = src + y * scale * width_in + x * scale;
+        if (scale == 2 || scale == 3)
+        {
+            // Sort the non-zero values, and for even counts pick the one below the middle
+            ushort values[9];
+            int n = 0;
+            for (int j = 0; j < scale; ++j)
+                for (int i = 0; i < scale; ++i)
+                {
+                    ushort z = block[j * width_in + i];
+                    if (!z) continue;
+                    int k = n++;
+                    for (; k > 0 && values[k - 1] > z; --k)
+                        values[k] = values[k - 1];
+                    values[k] = z;
+                }
+            if (n) result = values[(n - 1) / 2];
+        }
+        else
+        {
+            int sum = 0, counter = 0;
+            for (int j = 0; j < scale; ++j)
+                for (int i = 0; i < scale; ++i)
+                {
+                    ushort z = block[j * width_in + i];
+                    if (z) { sum += z; ++counter; }
+                }
+            if (counter) result = sum / counter;
+        }
+    }
+    dst[y * padded_width + x] = result;
+}
+
+__kernel void colorize(__global const ushort* depth, __global const uint* lut, __global uchar* rgb, int count)
+{
+    int i = get_global_id(0);
+    if (i >= count) return;
+
+    uint c = lut[depth[i]];
+    rgb[i * 3] = (uchar)c;
+    rgb[i * 3 + 1] = (uchar)(c >> 8);
+    rgb[i * 3 + 2] = (uchar)(c >> 16);
+}
+
+__kernel void deproject_depth(__global float* points, intrinsics intrin, __global const ushort* depth, float depth_scale)
+{
+    int x = get_global_id(0), y = get_global_id(1);
+    if (x >= intrin.width || y >= intrin.height) return;
+
+    int i = y * intrin.width + x;
+    float3 p = deproject(&intrin, x, y, depth_scale * depth[i]);
+    points[i * 3] = p.x;
+    points[i * 3 + 1] = p.y;
+    points[i * 3 + 2] = p.z;
+}
+
+// Depth is scattered into a buffer cleared to UINT_MAX, keeping the nearest of the depth pixels that land on an other pixel
+__kernel void align_depth_to_other(__global uint* aligned, __global const ushort* depth, float depth_scale,
+                                   intrinsics depth_intrin, extrinsics depth_to_other, intrinsics other_intrin)
+{
+    int x = get_global_id(0), y = get_global_id(1);
+    if (x >= depth_intrin.width || y >= depth_intrin.height) return;
+
+    ushort z = depth[y * depth_intrin.width + x];
+    int4 rect;
+    if (!z || !other_rect(&depth_intrin, &depth_to_other, &other_intrin, x, y, depth_scale * z, &rect)) return;
+
+    for (int oy = rect.y; oy <= rect.w; ++oy)
+        for (int ox = rect.x; ox <= rect.z; ++ox)
+            atomic_min(&aligned[oy * other_intrin.width + ox], (uint)z);
+}
+
+__kernel void finish_depth_to_other(__global const uint* aligned, __global ushort* dst, int count)
+{
+    int i = get_global_id(0);
+    if (i >= count) return;
+
+    uint z = aligned[i];
+    dst[i] = z == UINT_MAX ? 0 : (ushort)z;
+}
+
+// The CPU code transfers every other pixel of the rectangle in turn, so the last one, at its bottom-right corner, is kept
+__kernel void align_other_to_depth(__global uchar* aligned, __global const ushort* depth, float depth_scale,
+                                   intrinsics depth_intrin, extrinsics depth_to_other, intrinsics other_intrin,
+                                   __global const uchar* other, int bpp)
+{
+    int x = get_global_id(0), y = get_global_id(1);
+    if (x >= depth_intrin.width || y >= depth_intrin.height) return;
+
+    int i = y * depth_intrin.width + x;
+    ushort z = depth[i];
+    int4 rect;
+    bool mapped = z && other_rect(&depth_intrin, &depth_to_other, &other_intrin, x, y, depth_scale * z, &rect)
+                    && rect.x <= rect.z && rect.y <= rect.w;
+
+    __global const uchar* src = mapped ? other + (rect.w * other_intrin.width + rect.z) * bpp : 0;
+    for (int b = 0; b < bpp; ++b)
+        aligned[i * bpp + b] = mapped ? src[b] : 0;
+}
+)CL";
+
+    static bool has_gpu(cl_platform_id platform, cl_device_id* device)
+    {
+        cl_uint count = 0;
+        return clGetDeviceIDs(platform, CL_DEVICE_TYPE_GPU, 1, device, &count) == CL_SUCCESS && count > 0;
+    }
+
+    static bool find_gpu(cl_device_id* device)
+    {
+        cl_uint count = 0;
+        if (clGetPlatformIDs(0, nullptr, &count) != CL_SUCCESS || count == 0)
+            return false;
+
+        std::vector<cl_platform_id> platforms(count);
+        if (clGetPlatformIDs(count, platforms.data(), nullptr) != CL_SUCCESS)
+            return false;
+
+        for (auto platform : platforms)
+            if (has_gpu(platform, device))
+                return true;
+        return false;
+    }
+
+    bool opencl_backend::is_available()
+    {
+        cl_device_id device;
+        return find_gpu(&device);
+    }
+
+    opencl_backend::opencl_backend()
+        : _context(nullptr), _queue(nullptr), _program(nullptr),
+          _unpack_yuy2(nullptr), _decimate_depth(nullptr), _colorize(nullptr), _deproject_depth(nullptr),
+          _align_depth_to_other(nullptr), _finish_depth_to_other(nullptr), _align_other_to_depth(nullptr)
+    {
+        cl_device_id device;
+        if (!find_gpu(&device))
+            throw backend_exception("No OpenCL GPU found", RS2_EXCEPTION_TYPE_BACKEND);
+
+        cl_int result;
+        _context = clCreateContext(nullptr, 1, &device, nullptr, nullptr, &result);
+        if (result == CL_SUCCESS)
+            _queue = clCreateCommandQueue(_context, device, 0, &result);
+        if (result == CL_SUCCESS)
+            _program = clCreateProgramWithSource(_context, 1, &kernels_source, nullptr, &result);
+        if (result != CL_SUCCESS)
+        {
+            release();
+            throw backend_exception(to_string() << "Failed to initialize OpenCL, error " << result, RS2_EXCEPTION_TYPE_BACKEND);
+        }
+
+        // The kernels share the enumerations of the API
+        std::string options = to_string()
+            << "-DFORMAT_Y8=" << RS2_FORMAT_Y8 << " -DFORMAT_Y16=" << RS2_FORMAT_Y16
+            << " -DFORMAT_RGB8=" << RS2_FORMAT_RGB8 << " -DFORMAT_BGR8=" << RS2_FORMAT_BGR8
+            << " -DFORMAT_RGBA8=" << RS2_FORMAT_RGBA8 << " -DFORMAT_BGRA8=" << RS2_FORMAT_BGRA8
+            << " -DDISTORTION_MODIFIED_BROWN_CONRADY=" << int(RS2_DISTORTION_MODIFIED_BROWN_CONRADY)
+            << " -DDISTORTION_INVERSE_BROWN_CONRADY=" << int(RS2_DISTORTION_INVERSE_BROWN_CONRADY)
+            << " -DDISTORTION_FTHETA=" << int(RS2_DISTORTION_FTHETA);
+        result = clBuildProgram(_program, 1, &device, options.c_str(), nullptr, nullptr);
+        if (result != CL_SUCCESS)
+        {
+            size_t size = 0;
+            clGetProgramBuildInfo(_program, device, CL_PROGRAM_BUILD_LOG, 0, nullptr, &size);
+            std::string log(size, '\0');
+            clGetProgramBuildInfo(_program, device, CL_PROGRAM_BUILD_LOG, size, &log[0], nullptr);
+            release();
+            throw backend_exception(to_string() << "Failed to build the OpenCL kernels, error " << result << ":\n" << log, RS2_EXCEPTION_TYPE_BACKEND);
+        }
+
+        struct { cl_kernel* kernel; const char* name; } kernels[] = {
+            { &_unpack_yuy2, "unpack_yuy2" }, { &_decimate_depth, "decimate_depth" }, { &_colorize, "colorize" },
+            { &_deproject_depth, "deproject_depth" }, { &_align_depth_to_other, "align_depth_to_other" },
+            { &_finish_depth_to_other, "finish_depth_to_other" }, { &_align_other_to_depth, "align_other_to_depth" } };
+        for (auto&& k : kernels)
+        {
+            *k.kernel = clCreateKernel(_program, k.name, &result);
+            if (result != CL_SUCCESS)
+            {
+                release();
+                throw backend_exception(to_string() << "Failed to create the OpenCL kernel " << k.name << ", error " << result, RS2_EXCEPTION_TYPE_BACKEND);
+            }
+        }
+    }
+
+    opencl_backend::~opencl_backend()
+    {
+        release();
+    }
+
+    void opencl_backend::release()
+    {
+        for (auto b : { &_input, &_other, &_output, &_scratch, &_lut })
+        {
+            if (b->mem) clReleaseMemObject(b->mem);
+            b->mem = nullptr;
+            b->size = 0;
+        }
+        for (auto k : { &_unpack_yuy2, &_decimate_depth, &_colorize, &_deproject_depth,
+                        &_align_depth_to_other, &_finish_depth_to_other, &_align_other_to_depth })
+        {
+            if (*k) clReleaseKernel(*k);
+            *k = nullptr;
+        }
+        if (_program) clReleaseProgram(_program);
+        if (_queue) clReleaseCommandQueue(_queue);
+        if (_context) clReleaseContext(_context);
+        _program = nullptr;
+        _queue = nullptr;
+        _context = nullptr;
+    }
+
+    bool opencl_backend::check(cl_int result, const char* call)
+    {
+        if (result == CL_SUCCESS)
+            return true;
+        LOG_WARNING(call << " failed with OpenCL error " << result << ", processing on the CPU");
+        return false;
+    }
+
+    cl_mem opencl_backend::reserve(buffer& b, size_t size)
+    {
+        if (b.size >= size)
+            return b.mem;
+
+        if (b.mem) clReleaseMemObject(b.mem);
+        b.size = 0;
+
+        cl_int result;
+        b.mem = clCreateBuffer(_context, CL_MEM_READ_WRITE, size, nullptr, &result);
+        if (!check(result, "clCreateBuffer"))
+            return b.mem = nullptr;
+        b.size = size;
+        return b.mem;
+    }
+
+    bool opencl_backend::write(buffer& b, const void* src, size_t size)
+    {
+        return reserve(b, size) && check(clEnqueueWriteBuffer(_queue, b.mem, CL_FALSE, 0, size, src, 0, nullptr, nullptr), "clEnqueueWriteBuffer");
+    }
+
+    bool opencl_backend::read(buffer& b, void* dst, size_t size)
+    {
+        return check(clEnqueueReadBuffer(_queue, b.mem, CL_TRUE, 0, size, dst, 0, nullptr, nullptr), "clEnqueueReadBuffer");
+    }
+
+    bool opencl_backend::run(cl_kernel kernel, size_t width, size_t height)
+    {
+        size_t global[] = { width, height };
+        return check(clEnqueueNDRangeKernel(_queue, kernel, height > 1 ? 2 : 1, nullptr, global, nullptr, 0, nullptr, nullptr), "clEnqueueNDRangeKernel");
+    }
+
+    bool opencl_backend::unpack_yuy2(rs2_format format, void* dst, const void* src, size_t count)
+    {
+        int bpp;
+        switch (format)
+        {
+        case RS2_FORMAT_Y8: bpp = 1; break;
+        case RS2_FORMAT_Y16: bpp = 2; break;
+        case RS2_FORMAT_RGB8: case RS2_FORMAT_BGR8: bpp = 3; break;
+        case RS2_FORMAT_RGBA8: case RS2_FORMAT_BGRA8: bpp = 4; break;
+        default: return false;
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        int pairs = static_cast<int>(count / 2);
+        int format_value = format;
+        return write(_input, src, count * 2) && reserve(_output, count * bpp)
+            && set_args(_unpack_yuy2, _input.mem, _output.mem, format_value, pairs)
+            && run(_unpack_yuy2, pairs) && read(_output, dst, count * bpp);
+    }
+
+    bool opencl_backend::decimate_depth(const uint16_t* src, uint16_t* dst, int width_in, int scale,
+        int real_width, int real_height, int padded_width, int padded_height)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto out_size = size_t(padded_width) * padded_height * sizeof(uint16_t);
+        return write(_input, src, size_t(width_in) * real_height * scale * sizeof(uint16_t)) && reserve(_output, out_size)
+            && set_args(_decimate_depth, _input.mem, _output.mem, width_in, scale, real_width, real_height, padded_width, padded_height)
+            && run(_decimate_depth, padded_width, padded_height) && read(_output, dst, out_size);
+    }
+
+    bool opencl_backend::colorize(const uint16_t* depth, const uint32_t* lut, size_t lut_size, uint8_t* rgb, size_t count)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        int n = static_cast<int>(count);
+        return write(_input, depth, count * sizeof(uint16_t)) && write(_lut, lut, lut_size * sizeof(uint32_t)) && reserve(_output, count * 3)
+            && set_args(_colorize, _input.mem, _lut.mem, _output.mem, n)
+            && run(_colorize, count) && read(_output, rgb, count * 3);
+    }
+
+    bool opencl_backend::deproject_depth(float* points, const rs2_intrinsics& depth_intrin, const uint16_t* depth, float depth_scale)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto count = size_t(depth_intrin.width) * depth_intrin.height;
+        return write(_input, depth, count * sizeof(uint16_t)) && reserve(_output, count * 3 * sizeof(float))
+            && set_args(_deproject_depth, _output.mem, depth_intrin, _input.mem, depth_scale)
+            && run(_deproject_depth, depth_intrin.width, depth_intrin.height) && read(_output, points, count * 3 * sizeof(float));
+    }
+
+    bool opencl_backend::align_depth_to_other(uint16_t* aligned_out, const uint16_t* depth, float depth_scale,
+        const rs2_intrinsics& depth_intrin, const rs2_extrinsics& depth_to_other, const rs2_intrinsics& other_intrin)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto depth_count = size_t(depth_intrin.width) * depth_intrin.height;
+        auto other_count = size_t(other_intrin.width) * other_intrin.height;
+        const cl_uint farthest = 0xffffffff;
+        int n = static_cast<int>(other_count);
+        return write(_input, depth, depth_count * sizeof(uint16_t)) && reserve(_scratch, other_count * sizeof(cl_uint))
+            && reserve(_output, other_count * sizeof(uint16_t))
+            && check(clEnqueueFillBuffer(_queue, _scratch.mem, &farthest, sizeof(farthest), 0, other_count * sizeof(cl_uint), 0, nullptr, nullptr), "clEnqueueFillBuffer")
+            && set_args(_align_depth_to_other, _scratch.mem, _input.mem, depth_scale, depth_intrin, depth_to_other, other_intrin)
+            && run(_align_depth_to_other, depth_intrin.width, depth_intrin.height)
+            && set_args(_finish_depth_to_other, _scratch.mem, _output.mem, n)
+            && run(_finish_depth_to_other, other_count) && read(_output, aligned_out, other_count * sizeof(uint16_t));
+    }
+
+    bool opencl_backend::align_other_to_depth(uint8_t* aligned_out, const uint16_t* depth, float depth_scale,
+        const rs2_intrinsics& depth_intrin, const rs2_extrinsics& depth_to_other, const rs2_intrinsics& other_intrin,
+        const uint8_t* other, int other_bytes_per_pixel)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto depth_count = size_t(depth_intrin.width) * depth_intrin.height;
+        auto other_size = size_t(other_intrin.width) * other_intrin.height * other_bytes_per_pixel;
+        return write(_input, depth, depth_count * sizeof(uint16_t)) && write(_other, other, other_size)
+            && reserve(_output, depth_count * other_bytes_per_pixel)
+            && set_args(_align_other_to_depth, _output.mem, _input.mem, depth_scale, depth_intrin, depth_to_other, other_intrin, _other.mem, other_bytes_per_pixel)
+            && run(_align_other_to_depth, depth_intrin.width, depth_intrin.height)
+            && read(_output, aligned_out, depth_count * other_bytes_per_pixel);
+    }
+}
+
+#endif // RS2_USE_OPENCL
@@ -0,0 +1,89 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#ifdef RS2_USE_OPENCL
+
+#include "../proc/compute-backend.h"
+
+#include <mutex>
+
+#define CL_TARGET_OPENCL_VERSION 120
+#ifdef __APPLE__
+#include <OpenCL/cl.h>
+#else
+#include <CL/cl.h>
+#endif
+
+namespace librealsense
+{
+    // Runs the kernels on the first OpenCL GPU, which may just as well be integrated as discrete.
+    // Kernels are serialized on a single in-order queue, and their buffers are kept between frames
+    class opencl_backend : public compute_backend
+    {
+    public:
+        opencl_backend();
+        ~opencl_backend();
+
+        static bool is_available();
+
+        rs2_compute_backend get_type() const override { return RS2_COMPUTE_BACKEND_OPENCL; }
+
+        bool unpack_yuy2(rs2_format format, void* dst, const void* src, size_t count) override;
+        bool decimate_depth(const uint16_t* src, uint16_t* dst, int width_in, int scale,
+            int real_width, int real_height, int padded_width, int padded_height) override;
+        bool colorize(const uint16_t* depth, const uint32_t* lut, size_t lut_size, uint8_t* rgb, size_t count) override;
+        bool deproject_depth(float* points, const rs2_intrinsics& depth_intrin, const uint16_t* depth, float depth_scale) override;
+        bool align_depth_to_other(uint16_t* aligned_out, const uint16_t* depth, float depth_scale,
+            const rs2_intrinsics& depth_intrin, const rs2_extrinsics& depth_to_other, const rs2_intrinsics& other_intrin) override;
+        bool align_other_to_depth(uint8_t* aligned_out, const uint16_t* depth, float depth_scale,
+            const rs2_intrinsics& depth_intrin, const rs2_extrinsics& depth_to_other, const rs2_intrinsics& other_intrin,
+            const uint8_t* other, int other_bytes_per_pixel) override;
+
+    private:
+        opencl_backend(const opencl_backend&) = delete;
+        opencl_backend& operator=(const opencl_backend&) = delete;
+
+        // Device buffer that only grows, so that a stream of frames of the same size allocates once
+        struct buffer
+        {
+            cl_mem mem = nullptr;
+            size_t size = 0;
+        };
+
+        void release();
+        cl_mem reserve(buffer& b, size_t size);
+        bool write(buffer& b, const void* src, size_t size);
+        bool read(buffer& b, void* dst, size_t size);
+        bool run(cl_kernel kernel, size_t width, size_t height = 1);
+        bool check(cl_int result, const char* call);
+
+        template<class... T>
+        bool set_args(cl_kernel kernel, const T&... args)
+        {
+            cl_uint index = 0;
+            cl_int results[] = { clSetKernelArg(kernel, index++, sizeof(T), &args)... };
+            for (auto result : results)
+                if (!check(result, "clSetKernelArg")) return false;
+            return true;
+        }
+
+        std::mutex _mutex;
+        cl_context _context;
+        cl_command_queue _queue;
+        cl_program _program;
+
+        cl_kernel _unpack_yuy2;
+        cl_kernel _decimate_depth;
+        cl_kernel _colorize;
+        cl_kernel _deproject_depth;
+        cl_kernel _align_depth_to_other;
+        cl_kernel _finish_depth_to_other;
+        cl_kernel _align_other_to_depth;
+
+        buffer _input, _other, _output, _scratch, _lut;
+    };
+}
+
+#endif // RS2_USE_OPENCL
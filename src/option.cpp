@@ -31,8 +31,47 @@ void librealsense::option::create_snapshot(std::shared_ptr<option>& snapshot) co
     snapshot = std::make_shared<const_value_option>(get_description(), query());
 }
 
+bool librealsense::option_cache::get(const uvc_sensor& ep, float& value) const
+{
+    if (_policy == policy::none)
+        return false;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_is_valid || _generation != ep.get_controls_generation())
+        return false;
+
+    if (_policy == policy::transient)
+    {
+        auto age = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - _time).count();
+        if (age >= ep.get_controls_cache_ttl())
+            return false;
+    }
+
+    value = _value;
+    return true;
+}
+
+void librealsense::option_cache::put(const uvc_sensor& ep, float value, uint64_t generation) const
+{
+    if (_policy == policy::none)
+        return;
+
+    // A value read before the controls changed is already stale
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (generation != ep.get_controls_generation())
+        return;
+
+    _value = value;
+    _generation = generation;
+    _time = std::chrono::steady_clock::now();
+    _is_valid = true;
+}
+
 void librealsense::uvc_pu_option::set(float value)
 {
+    // Writing a control may change others, such as the auto exposure a manual exposure disables
+    _ep.invalidate_controls();
+    auto generation = _ep.get_controls_generation();
     _ep.invoke_powered(
         [this, value](platform::uvc_device& dev)
         {
@@ -40,11 +79,17 @@ void librealsense::uvc_pu_option::set(float value)
                 throw invalid_value_exception(to_string() << "set_pu(id=" << std::to_string(_id) << ") failed!" << " Last Error: " << strerror(errno));
             _record(*this);
         });
+    _cache.put(_ep, static_cast<float>(static_cast<int32_t>(value)), generation);
 }
 
 float librealsense::uvc_pu_option::query() const
 {
-    return static_cast<float>(_ep.invoke_powered(
+    float cached;
+    if (_cache.get(_ep, cached))
+        return cached;
+
+    auto generation = _ep.get_controls_generation();
+    auto result = static_cast<float>(_ep.invoke_powered(
         [this](platform::uvc_device& dev)
         {
             int32_t value = 0;
@@ -53,26 +98,31 @@ float librealsense::uvc_pu_option::query() const
 
             return static_cast<float>(value);
         }));
+    _cache.put(_ep, result, generation);
+    return result;
 }
 
 librealsense::option_range librealsense::uvc_pu_option::get_range() const
 {
-    auto uvc_range = _ep.invoke_powered(
-        [this](platform::uvc_device& dev)
-        {
-            return dev.get_pu_range(_id);
-        });
-
-    if (uvc_range.min.size() < sizeof(int32_t)) return option_range{0,0,1,0};
-
-    auto min = *(reinterpret_cast<int32_t*>(uvc_range.min.data()));
-    auto max = *(reinterpret_cast<int32_t*>(uvc_range.max.data()));
-    auto step = *(reinterpret_cast<int32_t*>(uvc_range.step.data()));
-    auto def = *(reinterpret_cast<int32_t*>(uvc_range.def.data()));
-    return option_range{static_cast<float>(min),
-                        static_cast<float>(max),
-                        static_cast<float>(step),
-                        static_cast<float>(def)};
+    return _range.get([this]()
+    {
+        auto uvc_range = _ep.invoke_powered(
+            [this](platform::uvc_device& dev)
+            {
+                return dev.get_pu_range(_id);
+            });
+
+        if (uvc_range.min.size() < sizeof(int32_t)) return option_range{0,0,1,0};
+
+        auto min = *(reinterpret_cast<int32_t*>(uvc_range.min.data()));
+        auto max = *(reinterpret_cast<int32_t*>(uvc_range.max.data()));
+        auto step = *(reinterpret_cast<int32_t*>(uvc_range.step.data()));
+        auto def = *(reinterpret_cast<int32_t*>(uvc_range.def.data()));
+        return option_range{static_cast<float>(min),
+                            static_cast<float>(max),
+                            static_cast<float>(step),
+                            static_cast<float>(def)};
+    });
 }
 
 const char* librealsense::uvc_pu_option::get_description() const
@@ -10,6 +10,7 @@
 #include "core/streaming.h"
 
 #include <chrono>
+#include <mutex>
 #include <memory>
 #include <vector>
 #include <cmath>
@@ -61,6 +62,23 @@ namespace librealsense
         std::string _desc;
     };
 
+    // Read-only option reporting a value the owner keeps up to date, queried on every read
+    class query_option : public readonly_option
+    {
+    public:
+        query_option(std::string desc, std::function<float()> query)
+            : _query(std::move(query)), _desc(std::move(desc)) {}
+
+        float query() const override { return _query(); }
+        option_range get_range() const override { return { 0, std::numeric_limits<float>::max(), 0, 0 }; }
+        bool is_enabled() const override { return true; }
+
+        const char* get_description() const override { return _desc.c_str(); }
+    private:
+        std::function<float()> _query;
+        std::string _desc;
+    };
+
     class option_base : public option
     {
     public:
@@ -144,6 +162,58 @@ namespace librealsense
         std::function<void(float)> _on_set;
     };
 
+    // Last value of a control, reused instead of querying the camera again. Persistent controls, which only the host changes, keep
+    // it until their sensor invalidates its controls, transient ones, which the camera changes by itself, for the TTL of the sensor
+    class option_cache
+    {
+    public:
+        enum class policy
+        {
+            none,
+            persistent,
+            transient
+        };
+
+        explicit option_cache(policy p = policy::none) : _policy(p) {}
+
+        void set_policy(policy p) { _policy = p; }
+
+        bool get(const uvc_sensor& ep, float& value) const;
+        // generation is that of the sensor controls before the value was read or written
+        void put(const uvc_sensor& ep, float value, uint64_t generation) const;
+
+    private:
+        policy _policy;
+        mutable std::mutex _mutex;
+        mutable bool _is_valid = false;
+        mutable float _value = 0.f;
+        mutable uint64_t _generation = 0;
+        mutable std::chrono::steady_clock::time_point _time;
+    };
+
+    // Range of a control, read from the camera on its first query only: the firmware sets it, and it does not change
+    // while the device is connected
+    class option_range_cache
+    {
+    public:
+        template<class T>
+        option_range get(T read) const
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (!_is_valid)
+            {
+                _range = read();
+                _is_valid = true;
+            }
+            return _range;
+        }
+
+    private:
+        mutable std::mutex _mutex;
+        mutable bool _is_valid = false;
+        mutable option_range _range{};
+    };
+
     class uvc_pu_option : public option
     {
     public:
@@ -158,16 +228,22 @@ namespace librealsense
             return true;
         }
 
-        uvc_pu_option(uvc_sensor& ep, rs2_option id)
-            : _ep(ep), _id(id)
+        // The controls are read from the camera every time unless their device opts in to a cache policy, knowing which of
+        // them its firmware changes by itself
+        uvc_pu_option(uvc_sensor& ep, rs2_option id, option_cache::policy policy = option_cache::policy::none)
+            : _ep(ep), _id(id), _cache(policy)
         {
         }
 
-        uvc_pu_option(uvc_sensor& ep, rs2_option id, const std::map<float, std::string>& description_per_value)
-            : _ep(ep), _id(id), _description_per_value(description_per_value)
+        uvc_pu_option(uvc_sensor& ep, rs2_option id, const std::map<float, std::string>& description_per_value,
+                      option_cache::policy policy = option_cache::policy::none)
+            : _ep(ep), _id(id), _description_per_value(description_per_value), _cache(policy)
         {
         }
 
+        void set_cache_policy(option_cache::policy policy) { _cache.set_policy(policy); }
+        bool try_get_cached(float& value) const override { return _cache.get(_ep, value); }
+
         const char* get_description() const override;
 
         const char* get_value_description(float val) const override
@@ -185,6 +261,8 @@ namespace librealsense
         rs2_option _id;
         const std::map<float, std::string> _description_per_value;
         std::function<void(const option &)> _record = [](const option &) {};
+        option_cache _cache;
+        option_range_cache _range;
     };
 
     template<typename T>
@@ -193,6 +271,9 @@ namespace librealsense
     public:
         void set(float value) override
         {
+            // Writing a control may change others, such as the auto exposure a manual exposure disables
+            _ep.invalidate_controls();
+            auto generation = _ep.get_controls_generation();
             _ep.invoke_powered(
                 [this, value](platform::uvc_device& dev)
                 {
@@ -201,11 +282,17 @@ namespace librealsense
                         throw invalid_value_exception(to_string() << "set_xu(id=" << std::to_string(_id) << ") failed!" << " Last Error: " << strerror(errno));
                     _recording_function(*this);
                 });
+            _cache.put(_ep, static_cast<float>(static_cast<T>(value)), generation);
         }
 
         float query() const override
         {
-            return static_cast<float>(_ep.invoke_powered(
+            float value;
+            if (_cache.get(_ep, value))
+                return value;
+
+            auto generation = _ep.get_controls_generation();
+            value = static_cast<float>(_ep.invoke_powered(
                 [this](platform::uvc_device& dev)
                 {
                     T t;
@@ -214,34 +301,43 @@ namespace librealsense
 
                     return static_cast<float>(t);
                 }));
+            _cache.put(_ep, value, generation);
+            return value;
         }
 
         option_range get_range() const override
         {
-            auto uvc_range = _ep.invoke_powered(
-                [this](platform::uvc_device& dev)
-                {
-                    return dev.get_xu_range(_xu, _id, sizeof(T));
-                });
-
-            if (uvc_range.min.size() < sizeof(int32_t)) return option_range{0,0,1,0};
-
-            auto min = *(reinterpret_cast<int32_t*>(uvc_range.min.data()));
-            auto max = *(reinterpret_cast<int32_t*>(uvc_range.max.data()));
-            auto step = *(reinterpret_cast<int32_t*>(uvc_range.step.data()));
-            auto def = *(reinterpret_cast<int32_t*>(uvc_range.def.data()));
-            return option_range{static_cast<float>(min),
-                                static_cast<float>(max),
-                                static_cast<float>(step),
-                                static_cast<float>(def)};
+            return _range.get([this]()
+            {
+                auto uvc_range = _ep.invoke_powered(
+                    [this](platform::uvc_device& dev)
+                    {
+                        return dev.get_xu_range(_xu, _id, sizeof(T));
+                    });
+
+                if (uvc_range.min.size() < sizeof(int32_t)) return option_range{0,0,1,0};
+
+                auto min = *(reinterpret_cast<int32_t*>(uvc_range.min.data()));
+                auto max = *(reinterpret_cast<int32_t*>(uvc_range.max.data()));
+                auto step = *(reinterpret_cast<int32_t*>(uvc_range.step.data()));
+                auto def = *(reinterpret_cast<int32_t*>(uvc_range.def.data()));
+                return option_range{static_cast<float>(min),
+                                    static_cast<float>(max),
+                                    static_cast<float>(step),
+                                    static_cast<float>(def)};
+            });
         }
 
         bool is_enabled() const override { return true; }
 
+        // Extension controls are not cached unless their policy is set, for the status and error reports to be read every time
         uvc_xu_option(uvc_sensor& ep, platform::extension_unit xu, uint8_t id, std::string description)
             : _ep(ep), _xu(xu), _id(id), _desciption(std::move(description))
         {}
 
+        void set_cache_policy(option_cache::policy policy) { _cache.set_policy(policy); }
+        bool try_get_cached(float& value) const override { return _cache.get(_ep, value); }
+
         const char* get_description() const override
         {
             return _desciption.c_str();
@@ -256,6 +352,8 @@ namespace librealsense
         uint8_t             _id;
         std::string         _desciption;
         std::function<void(const option&)> _recording_function = [](const option&) {};
+        option_cache        _cache;
+        option_range_cache  _range;
     };
 
     inline std::string hexify(unsigned char n)
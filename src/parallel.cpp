@@ -0,0 +1,188 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include "parallel.h"
+#include "environment.h"
+#include "thread-policy.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace librealsense
+{
+    namespace
+    {
+        thread_local bool in_parallel_for = false;
+
+        // The tasks of a run, taken by index by the caller and the workers alike
+        struct parallel_job
+        {
+            parallel_job(int count, const std::function<void(int)>& task) : count(count), task(task), next(0), done(0) {}
+
+            const int count;
+            const std::function<void(int)>& task;
+            std::atomic<int> next;
+            std::atomic<int> done;
+        };
+
+        class parallel_threads : public parallel_runtime
+        {
+        public:
+            explicit parallel_threads(int threads) : _threads(threads) {}
+
+            ~parallel_threads()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    _stopping = true;
+                }
+                _work.notify_all();
+                for (auto&& t : _workers)
+                    t.join();
+            }
+
+            int get_concurrency() const override { return _threads; }
+
+            void run(int count, const std::function<void(int)>& task) override
+            {
+                parallel_job job(count, task);
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    // Started on the first run, for the threads to follow the policy set before the streaming
+                    while (static_cast<int>(_workers.size()) < _threads - 1)
+                        _workers.emplace_back([this]() { work(); });
+                    _jobs.push_back(&job);
+                }
+                _work.notify_all();
+
+                for (int i; (i = job.next.fetch_add(1)) < count; job.done++)
+                    task(i);
+
+                // No worker takes a task of the job once it is out of the queue, those running one are waited for
+                std::unique_lock<std::mutex> lock(_mutex);
+                auto it = std::find(_jobs.begin(), _jobs.end(), &job);
+                if (it != _jobs.end()) _jobs.erase(it);
+                _finished.wait(lock, [&]() { return job.done == count; });
+            }
+
+        private:
+            void work()
+            {
+                apply_thread_policy(RS2_THREAD_ROLE_PARALLEL);
+                in_parallel_for = true;
+
+                std::unique_lock<std::mutex> lock(_mutex);
+                while (true)
+                {
+                    _work.wait(lock, [this]() { return _stopping || !_jobs.empty(); });
+                    if (_stopping)
+                        return;
+
+                    auto job = _jobs.front();
+                    auto i = job->next.fetch_add(1);
+                    if (i >= job->count)
+                    {
+                        _jobs.pop_front();
+                        continue;
+                    }
+
+                    lock.unlock();
+                    job->task(i);
+                    lock.lock();
+                    // Counted under the lock, for the caller not to let go of the job before it is notified
+                    if (++job->done == job->count)
+                        _finished.notify_all();
+                }
+            }
+
+            const int _threads;
+            std::mutex _mutex;
+            std::condition_variable _work;
+            std::condition_variable _finished;
+            std::deque<parallel_job*> _jobs;
+            std::vector<std::thread> _workers;
+            bool _stopping = false;
+        };
+
+        class parallel_executor : public parallel_runtime
+        {
+        public:
+            parallel_executor(rs2_parallel_executor_ptr executor, void* user, int concurrency)
+                : _executor(executor), _user(user), _concurrency(concurrency) {}
+
+            int get_concurrency() const override { return _concurrency; }
+
+            void run(int count, const std::function<void(int)>& task) override
+            {
+                _executor([](void* data, int index) {
+                    // The threads of the application run no other parallel_for within the task
+                    auto nested = in_parallel_for;
+                    in_parallel_for = true;
+                    (*static_cast<const std::function<void(int)>*>(data))(index);
+                    in_parallel_for = nested;
+                }, const_cast<std::function<void(int)>*>(&task), count, _user);
+            }
+
+        private:
+            rs2_parallel_executor_ptr _executor;
+            void* _user;
+            int _concurrency;
+        };
+    }
+
+    std::shared_ptr<parallel_runtime> make_parallel_threads(int threads)
+    {
+        if (threads < 0) threads = static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+        if (threads <= 1) return nullptr;
+        return std::make_shared<parallel_threads>(threads);
+    }
+
+    std::shared_ptr<parallel_runtime> make_parallel_executor(rs2_parallel_executor_ptr executor, void* user, int concurrency)
+    {
+        if (!executor) return nullptr;
+        return std::make_shared<parallel_executor>(executor, user, std::max(concurrency, 1));
+    }
+
+    void parallel_for(int begin, int end, int grain, const std::function<void(int, int)>& body)
+    {
+        if (begin >= end)
+            return;
+
+        auto runtime = in_parallel_for ? nullptr : environment::get_instance().get_parallel_runtime();
+        auto size = end - begin;
+        grain = std::max(grain, 1);
+        // A few chunks per thread, for the threads that start late or run slower to be caught up with
+        auto chunks = runtime ? std::min((size + grain - 1) / grain, runtime->get_concurrency() * 4) : 1;
+        if (chunks <= 1)
+        {
+            body(begin, end);
+            return;
+        }
+
+        std::mutex error_mutex;
+        std::exception_ptr error;
+        auto chunk = (size + chunks - 1) / chunks;
+        in_parallel_for = true;
+        runtime->run((size + chunk - 1) / chunk, [&](int i) {
+            try
+            {
+                auto first = begin + i * chunk;
+                body(first, std::min(first + chunk, end));
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!error) error = std::current_exception();
+            }
+        });
+        in_parallel_for = false;
+        if (error)
+            std::rethrow_exception(error);
+    }
+}
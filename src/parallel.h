@@ -0,0 +1,36 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "../include/librealsense2/h/rs_context.h"
+
+#include <functional>
+#include <memory>
+
+namespace librealsense
+{
+    // Where the data parallel kernels of the library split their work: threads of the library, or the executor of the
+    // application for the kernels to share its threads rather than compete with them
+    class parallel_runtime
+    {
+    public:
+        // The number of tasks worth running at once
+        virtual int get_concurrency() const = 0;
+
+        // Runs task(i) for every i in [0, count), returning once every task returned
+        virtual void run(int count, const std::function<void(int)>& task) = 0;
+
+        virtual ~parallel_runtime() = default;
+    };
+
+    // A pool of threads - 1 threads, working along the calling thread. -1 for one thread per hardware thread
+    std::shared_ptr<parallel_runtime> make_parallel_threads(int threads);
+
+    std::shared_ptr<parallel_runtime> make_parallel_executor(rs2_parallel_executor_ptr executor, void* user, int concurrency);
+
+    // Runs body(first, last) over chunks of [begin, end) of at least grain iterations, on the parallel runtime of the
+    // environment, returning once the whole range is done. Runs on the calling thread alone when there is no runtime,
+    // when the range is a single chunk, and from within another parallel_for. Rethrows the first exception of the body
+    void parallel_for(int begin, int end, int grain, const std::function<void(int, int)>& body);
+}
@@ -2,19 +2,59 @@
 // Copyright(c) 2015 Intel Corporation. All Rights Reserved.
 
 #include <algorithm>
+#include <sstream>
 #include "proc/synthetic-stream.h"
 #include "proc/syncer-processing-block.h"
+#include "proc/decimation-filter.h"
+#include "proc/temporal-filter.h"
 #include "pipeline.h"
+#include "usb-bandwidth.h"
 #include "stream.h"
 #include "media/record/record_device.h"
 #include "media/ros/ros_writer.h"
 
 namespace librealsense
 {
-    pipeline_processing_block::pipeline_processing_block(const std::vector<int>& streams_to_aggregate) :
+    pipeline_processing_block::pipeline_processing_block(const std::vector<int>& streams_to_aggregate,
+                                                         const std::vector<std::shared_ptr<processing_block_interface>>& post_processing,
+                                                         const load_governor_settings& governor) :
         _queue(new single_consumer_frame_queue<frame_holder>(1)),
-        _streams_ids(streams_to_aggregate)
+        _streams_ids(streams_to_aggregate),
+        _queued(0), _queue_drops(0), _delivered(0),
+        _governor_settings(governor),
+        _pending_level(0), _applied_level(0), _drop_streams(false), _rate_divider(1), _framesets(0), _governor_skips(0)
     {
+        if (governor.max_latency_ms > 0)
+        {
+            _governor.reset(new load_governor(governor.max_latency_ms, int(governor.actions.size())));
+            for (auto&& block : post_processing)
+                if (auto decimation = std::dynamic_pointer_cast<decimation_filter>(block))
+                    _decimation.push_back({ &decimation->get_option(RS2_OPTION_FILTER_MAGNITUDE), 0.f });
+        }
+
+        if (!post_processing.empty())
+        {
+            // A worker per block, for the blocks to work on consecutive framesets at the same time
+            auto blocks = int(post_processing.size());
+            _post_processing.reset(new processing_graph(blocks, blocks + 1));
+            for (int i = 0; i < blocks; i++)
+            {
+                _post_processing->add(post_processing[i]);
+                if (i > 0)
+                    _post_processing->connect(i - 1, i);
+                if (_governor && std::dynamic_pointer_cast<temporal_filter>(post_processing[i]))
+                    _temporal.push_back(i);
+            }
+
+            auto on_processed = [this](frame_interface* f)
+            {
+                enqueue(frame_holder(f));
+            };
+            _post_processing->set_output_callback({
+                new internal_frame_callback<decltype(on_processed)>(on_processed),
+                [](rs2_frame_callback* p) { p->release(); } });
+        }
+
         auto processing_callback = [&](frame_holder frame, synthetic_source_interface* source)
         {
             handle_frame(std::move(frame), source);
@@ -26,7 +66,11 @@ namespace librealsense
 
     void pipeline_processing_block::handle_frame(frame_holder frame, synthetic_source_interface* source)
     {
-        std::lock_guard<std::mutex> lock(_mutex);
+        // Applied on the frames on their way in, where no block holds the lock of its options
+        if (_governor)
+            apply_load_level(_pending_level);
+
+        std::unique_lock<std::mutex> lock(_mutex);
         auto comp = dynamic_cast<composite_frame*>(frame.frame);
         if (comp)
         {
@@ -43,18 +87,37 @@ namespace librealsense
                     return;
             }
 
+            // Lowering the rate, the framesets are left out before they are processed
+            auto divider = _rate_divider.load(std::memory_order_relaxed);
+            if (divider > 1 && _framesets++ % divider)
+            {
+                _governor_skips.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            auto drop_streams = _drop_streams.load(std::memory_order_relaxed);
             std::vector<frame_holder> set;
             for (auto&& s : _last_set)
             {
+                if (drop_streams && is_low_priority(s.second.frame))
+                    continue;
                 set.push_back(s.second.clone());
             }
+            if (set.empty())
+                return;
             auto fref = source->allocate_composite_frame(std::move(set));
             if (!fref)
             {
                 LOG_ERROR("Failed to allocate composite frame");
                 return;
             }
-            _queue->enqueue(fref);
+            lock.unlock();
+
+            // Holds the syncer back while the blocks work on as many framesets as they may
+            if (_post_processing)
+                _post_processing->invoke(frame_holder(fref));
+            else
+                enqueue(fref);
         }
         else
         {
@@ -63,14 +126,115 @@ namespace librealsense
         }
     }
 
+    void pipeline_processing_block::enqueue(frame_holder frame)
+    {
+        _queued.fetch_add(1, std::memory_order_relaxed);
+        auto dropped = _queue->enqueue(std::move(frame));
+        if (dropped)
+            _queue_drops.fetch_add(dropped, std::memory_order_relaxed);
+        if (_governor && _governor->on_queued(platform::monotonic_time(), dropped != 0))
+            _pending_level = _governor->get_level();
+    }
+
     bool pipeline_processing_block::dequeue(frame_holder* item, unsigned int timeout_ms)
     {
-        return _queue->dequeue(item, timeout_ms);
+        if (!_queue->dequeue(item, timeout_ms))
+            return false;
+        _delivered.fetch_add(1, std::memory_order_relaxed);
+        on_delivered(*item);
+        return true;
     }
 
     bool pipeline_processing_block::try_dequeue(frame_holder* item)
     {
-        return _queue->try_dequeue(item);
+        if (!_queue->try_dequeue(item))
+            return false;
+        _delivered.fetch_add(1, std::memory_order_relaxed);
+        on_delivered(*item);
+        return true;
+    }
+
+    void pipeline_processing_block::on_delivered(const frame_holder& frame)
+    {
+        if (!_governor)
+            return;
+
+        // From the earliest stage the frames of the set were stamped at, the driver for the frames of devices
+        rs2_time_t first = 0;
+        auto add = [&first](const frame_interface* f)
+        {
+            for (auto stage : { frame_stage::dequeue, frame_stage::unpack, frame_stage::sync })
+            {
+                auto t = f->get_stage_time(stage);
+                if (t)
+                {
+                    if (!first || t < first)
+                        first = t;
+                    break;
+                }
+            }
+        };
+        if (auto comp = dynamic_cast<composite_frame*>(frame.frame))
+        {
+            for (size_t i = 0; i < comp->get_embedded_frames_count(); i++)
+                add(comp->get_frame(int(i)));
+        }
+        else if (frame.frame)
+        {
+            add(frame.frame);
+        }
+        if (!first)
+            return;
+
+        auto now = platform::monotonic_time();
+        if (_governor->on_delivered(now, now - first))
+            _pending_level = _governor->get_level();
+    }
+
+    void pipeline_processing_block::apply_load_level(int level)
+    {
+        std::lock_guard<std::mutex> lock(_level_mutex);
+        if (level == _applied_level)
+            return;
+        auto next = load_level::of(_governor_settings.actions, level);
+
+        // The magnitudes are raised from those they had, which they go back to
+        if (next.decimation_raise != _level.decimation_raise)
+        {
+            for (auto&& d : _decimation)
+            {
+                if (!_level.decimation_raise)
+                    d.second = d.first->query();
+                auto range = d.first->get_range();
+                d.first->set(std::min(d.second + next.decimation_raise * range.step, range.max));
+            }
+        }
+        if (next.skip_temporal != _level.skip_temporal)
+            for (auto index : _temporal)
+                _post_processing->set_bypass(index, next.skip_temporal);
+
+        _drop_streams = next.drop_streams;
+        _rate_divider = next.rate_divider;
+        _level = next;
+        _applied_level = level;
+        LOG_INFO("Pipeline load level " << level << " of " << _governor_settings.actions.size());
+    }
+
+    bool pipeline_processing_block::is_low_priority(const frame_interface* frame) const
+    {
+        auto stream = frame->get_stream();
+        auto&& low = _governor_settings.low_priority;
+        return low.count({ stream->get_stream_type(), stream->get_stream_index() }) || low.count({ stream->get_stream_type(), -1 });
+    }
+
+    void pipeline_processing_block::get_health(rs2_pipeline_health& health) const
+    {
+        health.framesets_queued = _queued.load(std::memory_order_relaxed);
+        health.queue_drops = _queue_drops.load(std::memory_order_relaxed);
+        health.queue_depth = _queue->size();
+        health.framesets_delivered = _delivered.load(std::memory_order_relaxed);
+        health.load_level = _governor ? _governor->get_level() : 0;
+        health.governor_skips = _governor_skips.load(std::memory_order_relaxed);
     }
 
     /*
@@ -107,6 +271,22 @@ namespace librealsense
         std::lock_guard<std::mutex> lock(_mtx);
         _resolved_profile.reset();
         _device_request.serial = serial;
+        _additional_devices.erase(std::remove(_additional_devices.begin(), _additional_devices.end(), serial), _additional_devices.end());
+    }
+
+    void pipeline_config::add_device(const std::string& serial)
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        if (!_device_request.filename.empty() || !_device_request.record_output.empty())
+        {
+            throw std::runtime_error("Configuring several devices, and a device from file or record to file is unsupported");
+        }
+        _resolved_profile.reset();
+        if (_device_request.serial.empty())
+            _device_request.serial = serial;
+        else if (_device_request.serial != serial &&
+                 std::find(_additional_devices.begin(), _additional_devices.end(), serial) == _additional_devices.end())
+            _additional_devices.push_back(serial);
     }
 
     void pipeline_config::enable_device_from_file(const std::string& file, bool repeat_playback = true)
@@ -116,11 +296,50 @@ namespace librealsense
         {
             throw std::runtime_error("Configuring both device from file, and record to file is unsupported");
         }
+        if (!_additional_devices.empty())
+        {
+            throw std::runtime_error("Configuring several devices, and a device from file or record to file is unsupported");
+        }
         _resolved_profile.reset();
         _device_request.filename = file;
         _playback_loop = repeat_playback;
     }
 
+    void pipeline_config::enable_usb_bandwidth_check(bool enable)
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        _resolved_profile.reset();
+        _check_usb_bandwidth = enable;
+    }
+
+    void pipeline_config::add_processing_block(std::shared_ptr<processing_block_interface> block)
+    {
+        if (!block)
+            throw invalid_value_exception("Null processing block can not be added to a pipeline configuration");
+
+        std::lock_guard<std::mutex> lock(_mtx);
+        _processing_blocks.push_back(block);
+    }
+
+    void pipeline_config::enable_load_governor(float max_latency_ms, const std::vector<rs2_load_action>& actions)
+    {
+        if (max_latency_ms < 0.f)
+            throw invalid_value_exception(to_string() << "Unsupported load governor latency " << max_latency_ms << " ms, it must be positive");
+        for (auto action : actions)
+            if (!is_valid(action))
+                throw invalid_value_exception(to_string() << "Unsupported load action " << int(action));
+
+        std::lock_guard<std::mutex> lock(_mtx);
+        _load_governor.max_latency_ms = max_latency_ms;
+        _load_governor.actions = actions;
+    }
+
+    void pipeline_config::set_low_priority_stream(rs2_stream stream, int index)
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        _load_governor.low_priority.insert({ stream, index });
+    }
+
     void pipeline_config::enable_record_to_file(const std::string& file)
     {
         std::lock_guard<std::mutex> lock(_mtx);
@@ -128,10 +347,21 @@ namespace librealsense
         {
             throw std::runtime_error("Configuring both device from file, and record to file is unsupported");
         }
+        if (!_additional_devices.empty())
+        {
+            throw std::runtime_error("Configuring several devices, and a device from file or record to file is unsupported");
+        }
         _resolved_profile.reset();
         _device_request.record_output = file;
     }
 
+    void pipeline_config::enable_record_compression(rs2_stream stream, rs2_record_compression compression)
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        _resolved_profile.reset();
+        _device_request.record_compression[stream] = compression;
+    }
+
     std::shared_ptr<pipeline_profile> pipeline_config::get_cached_resolved_profile()
     {
         std::lock_guard<std::mutex> lock(_mtx);
@@ -166,6 +396,94 @@ namespace librealsense
     }
 
     std::shared_ptr<pipeline_profile> pipeline_config::resolve(std::shared_ptr<device_interface> dev)
+    {
+        // Cameras are resolved from the cache, recordings and the devices recording to a file are resolved every time
+        std::unique_ptr<pipeline_profile_cache> cache;
+        if (pipeline_profile_cache::is_enabled() && _device_request.filename.empty() && _device_request.record_output.empty() &&
+            dev->supports_info(RS2_CAMERA_INFO_SERIAL_NUMBER) && dev->supports_info(RS2_CAMERA_INFO_FIRMWARE_VERSION))
+        {
+            cache.reset(new pipeline_profile_cache(dev->get_info(RS2_CAMERA_INFO_SERIAL_NUMBER),
+                dev->get_info(RS2_CAMERA_INFO_FIRMWARE_VERSION), get_requests_key()));
+
+            std::vector<std::pair<int, stream_profile>> selection;
+            if (cache->load(selection))
+            {
+                try
+                {
+                    auto profile = std::make_shared<pipeline_profile>(dev, selection);
+                    if (_check_usb_bandwidth)
+                        check_usb_bandwidth(*profile);
+                    return profile;
+                }
+                catch (const invalid_value_exception&)
+                {
+                    throw;
+                }
+                catch (const std::exception& e)
+                {
+                    LOG_WARNING("Ignoring the pipeline cache, the device does not match it. " << e.what());
+                }
+            }
+        }
+
+        auto profile = resolve_requests(dev);
+        if (cache)
+            cache->store(profile->get_selection());
+        if (_check_usb_bandwidth)
+            check_usb_bandwidth(*profile);
+        return profile;
+    }
+
+    void pipeline_config::check_usb_bandwidth(pipeline_profile& profile)
+    {
+        usb_bandwidth_planner planner;
+        auto dev = profile.get_device();
+        planner.add(*dev, profile._multistream.get_profiles_per_sensor());
+        if (planner.fits())
+            return;
+
+        std::stringstream msg;
+        msg << "Failed to resolve request. The streams exceed the bandwidth of the USB bus:";
+        for (auto&& load : planner.get_loads())
+            if (load.demand > load.capacity)
+                msg << " " << load.bus << " would carry " << load.demand / 1e6 << " of " << load.capacity / 1e6 << " MB/s.";
+
+        try
+        {
+            auto suggestion = planner.suggest();
+            msg << " The nearest streams that fit are";
+            for (auto&& kvp : suggestion.front())
+                for (auto&& p : kvp.second)
+                {
+                    auto s = to_profile(p.get());
+                    msg << " " << rs2_stream_to_string(s.stream) << " " << s.index << " " << rs2_format_to_string(s.format)
+                        << " " << s.width << "x" << s.height << " " << s.fps << "fps";
+                }
+        }
+        catch (const std::exception& e)
+        {
+            msg << " " << e.what();
+        }
+        throw invalid_value_exception(msg.str());
+    }
+
+    std::string pipeline_config::get_requests_key() const
+    {
+        if (_enable_all_streams)
+            return "all";
+        if (_stream_requests.empty())
+            return "default";
+
+        std::stringstream key;
+        for (auto&& req : _stream_requests)
+        {
+            auto r = req.second;
+            key << r.stream << "," << r.stream_index << "," << r.width << "," << r.height << "," << r.format << "," << r.fps << ";";
+        }
+        return key.str();
+    }
+
+    std::shared_ptr<pipeline_profile> pipeline_config::resolve_requests(std::shared_ptr<device_interface> dev)
     {
         util::config config;
 
@@ -178,7 +496,7 @@ namespace librealsense
                 auto profiles = sub.get_stream_profiles(PROFILE_TAG_SUPERSET);
                 config.enable_streams(profiles);
             }
-            return std::make_shared<pipeline_profile>(dev, config, _device_request.record_output);
+            return std::make_shared<pipeline_profile>(dev, config, _device_request.record_output, _device_request.record_compression);
         }
 
         //If the user did not request anything, give it the default, on playback all recorded streams are marked as default.
@@ -186,7 +504,7 @@ namespace librealsense
         {
             auto default_profiles = get_default_configuration(dev);
             config.enable_streams(default_profiles);
-            return std::make_shared<pipeline_profile>(dev, config, _device_request.record_output);
+            return std::make_shared<pipeline_profile>(dev, config, _device_request.record_output, _device_request.record_compression);
         }
 
         //Enabled requested streams
@@ -195,7 +513,7 @@ namespace librealsense
             auto r = req.second;
             config.enable_stream(r.stream, r.stream_index, r.width, r.height, r.format, r.fps);
         }
-        return std::make_shared<pipeline_profile>(dev, config, _device_request.record_output);
+        return std::make_shared<pipeline_profile>(dev, config, _device_request.record_output, _device_request.record_compression);
     }
 
     std::shared_ptr<pipeline_profile> pipeline_config::resolve(std::shared_ptr<pipeline> pipe, const std::chrono::milliseconds& timeout)
@@ -342,6 +660,33 @@ namespace librealsense
         return _playback_loop;
     }
 
+    std::vector<std::shared_ptr<processing_block_interface>> pipeline_config::get_processing_blocks()
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        return _processing_blocks;
+    }
+
+    load_governor_settings pipeline_config::get_load_governor_settings()
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        return _load_governor;
+    }
+
+    std::vector<std::shared_ptr<pipeline_config>> pipeline_config::get_additional_device_configs()
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        std::vector<std::shared_ptr<pipeline_config>> configs;
+        for (auto&& serial : _additional_devices)
+        {
+            auto conf = std::make_shared<pipeline_config>(*this);
+            conf->_device_request.serial = serial;
+            conf->_additional_devices.clear();
+            conf->_processing_blocks.clear();
+            configs.push_back(conf);
+        }
+        return configs;
+    }
+
     /*
         .______    __  .______    _______  __       __  .__   __.  _______ 
         |   _  \  |  | |   _  \  |   ____||  |     |  | |  \ |  | |   ____|
@@ -352,7 +697,7 @@ namespace librealsense
     */
 
     pipeline::pipeline(std::shared_ptr<librealsense::context> ctx)
-        :_ctx(ctx), _hub(ctx), _dispatcher(10)
+        :_ctx(ctx), _hub(ctx), _dispatcher(10, ctx->get_executor())
     {}
 
     pipeline::~pipeline()
@@ -401,44 +746,53 @@ namespace librealsense
         return _active_profile;
     }
 
-    void pipeline::unsafe_start(std::shared_ptr<pipeline_config> conf)
+    std::shared_ptr<pipeline_profile> pipeline::resolve_with_retries(std::shared_ptr<pipeline_config> conf)
     {
-        std::shared_ptr<pipeline_profile> profile = nullptr;
         //first try to get the previously resolved profile (if exists)
         auto cached_profile = conf->get_cached_resolved_profile();
         if (cached_profile)
         {
-            profile = cached_profile;
+            return cached_profile;
         }
-        else
+
+        const int NUM_TIMES_TO_RETRY = 3;
+        for (int i = 1; i <= NUM_TIMES_TO_RETRY; i++)
         {
-            const int NUM_TIMES_TO_RETRY = 3;
-            for (int i = 1; i <= NUM_TIMES_TO_RETRY; i++)
+            try
             {
-                try
-                {
-                    profile = conf->resolve(shared_from_this(), std::chrono::seconds(5));
-                    break;
-                }
-                catch (...)
-                {
-                    if (i == NUM_TIMES_TO_RETRY)
-                        throw;
-                }
+                return conf->resolve(shared_from_this(), std::chrono::seconds(5));
+            }
+            catch (...)
+            {
+                if (i == NUM_TIMES_TO_RETRY)
+                    throw;
             }
         }
+        return nullptr;
+    }
+
+    void pipeline::unsafe_start(std::shared_ptr<pipeline_config> conf)
+    {
+        auto profile = resolve_with_retries(conf);
 
         assert(profile);
         assert(profile->_multistream.get_profiles().size() > 0);
 
+        std::vector<std::shared_ptr<pipeline_profile>> additional_profiles;
+        for (auto&& device_conf : conf->get_additional_device_configs())
+            additional_profiles.push_back(resolve_with_retries(device_conf));
+
         std::vector<int> unique_ids;
         for (auto&& s : profile->get_active_streams())
         {
             unique_ids.push_back(s->get_unique_id());
         }
+        for (auto&& p : additional_profiles)
+            for (auto&& s : p->get_active_streams())
+                unique_ids.push_back(s->get_unique_id());
 
         _syncer = std::unique_ptr<syncer_process_unit>(new syncer_process_unit());
-        _pipeline_process = std::unique_ptr<pipeline_processing_block>(new pipeline_processing_block(unique_ids));
+        _pipeline_process = std::shared_ptr<pipeline_processing_block>(new pipeline_processing_block(unique_ids, conf->get_processing_blocks(), conf->get_load_governor_settings()));
 
         auto pipeline_process_callback = [&](frame_holder fref)
         {
@@ -450,7 +804,45 @@ namespace librealsense
             [](rs2_frame_callback* p) { p->release(); }
         };
 
-        _syncer->set_output_callback(to_pipeline_process);
+        if (additional_profiles.empty())
+        {
+            _syncer->set_output_callback(to_pipeline_process);
+        }
+        else
+        {
+            // The framesets of every device are matched into framesets of all of them, on the host times of their frames
+            _device_syncer = std::unique_ptr<multi_device_syncer>(new multi_device_syncer());
+            _device_syncer->set_output_callback(to_pipeline_process);
+
+            auto device_syncer_callback = [&](frame_holder fref)
+            {
+                _device_syncer->invoke(std::move(fref));
+            };
+
+            frame_callback_ptr to_device_syncer = {
+                new internal_frame_callback<decltype(device_syncer_callback)>(device_syncer_callback),
+                [](rs2_frame_callback* p) { p->release(); }
+            };
+
+            _syncer->set_output_callback(to_device_syncer);
+            for (auto&& p : additional_profiles)
+            {
+                auto syncer = std::unique_ptr<syncer_process_unit>(new syncer_process_unit());
+                syncer->set_output_callback(to_device_syncer);
+                auto s = syncer.get();
+                auto to_syncer = [s](frame_holder fref)
+                {
+                    s->invoke(std::move(fref));
+                };
+
+                p->_multistream.open();
+                p->_multistream.start(frame_callback_ptr(
+                    new internal_frame_callback<decltype(to_syncer)>(to_syncer),
+                    [](rs2_frame_callback* p) { p->release(); }));
+                _additional_syncers.push_back(std::move(syncer));
+                _additional_profiles.push_back(p);
+            }
+        }
 
         auto to_syncer = [&](frame_holder fref)
         {
@@ -486,7 +878,10 @@ namespace librealsense
         _dispatcher.start();
         profile->_multistream.open();
         profile->_multistream.start(syncer_callback);
-        _active_profile = profile;
+        {
+            std::lock_guard<std::mutex> lock(_health_mtx);
+            _active_profile = profile;
+        }
         _prev_conf = std::make_shared<pipeline_config>(*conf);
     }
 
@@ -519,8 +914,23 @@ namespace librealsense
             {
             } // Stop will throw if device was disconnected. TODO - refactoring anticipated
         }
+        for (auto&& p : _additional_profiles)
+        {
+            try
+            {
+                p->_multistream.stop();
+                p->_multistream.close();
+            }
+            catch (...)
+            {
+            }
+        }
+        std::lock_guard<std::mutex> lock(_health_mtx);
         _active_profile.reset();
+        _additional_profiles.clear();
+        _additional_syncers.clear();
         _syncer.reset();
+        _device_syncer.reset();
         _pipeline_process.reset();
         _prev_conf.reset();
     }
@@ -539,7 +949,7 @@ namespace librealsense
         }
 
         //hub returns true even if device already reconnected
-        if (!_hub.is_connected(*_active_profile->get_device()))
+        if (!unsafe_is_connected())
         {
             try
             {
@@ -577,6 +987,16 @@ namespace librealsense
         return false;
     }
 
+    std::shared_ptr<single_consumer_frame_queue<frame_holder>> pipeline::get_frames_queue() const
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        if (!_active_profile)
+        {
+            throw librealsense::wrong_api_call_sequence_exception("get_frames_queue cannot be called before start()");
+        }
+        return std::shared_ptr<single_consumer_frame_queue<frame_holder>>(_pipeline_process, &_pipeline_process->get_queue());
+    }
+
     bool pipeline::try_wait_for_frames(frame_holder* frame, unsigned int timeout_ms)
     {
         std::lock_guard<std::mutex> lock(_mtx);
@@ -591,7 +1011,7 @@ namespace librealsense
         }
 
         //hub returns true even if device already reconnected
-        if (!_hub.is_connected(*_active_profile->get_device()))
+        if (!unsafe_is_connected())
         {
             try
             {
@@ -609,6 +1029,16 @@ namespace librealsense
         return false;
     }
 
+    bool pipeline::unsafe_is_connected()
+    {
+        if (!_hub.is_connected(*_active_profile->get_device()))
+            return false;
+        for (auto&& p : _additional_profiles)
+            if (!_hub.is_connected(*p->get_device()))
+                return false;
+        return true;
+    }
+
     std::shared_ptr<device_interface> pipeline::wait_for_device(const std::chrono::milliseconds& timeout, const std::string& serial)
     {
         // Pipeline's device selection shall be deterministic
@@ -620,6 +1050,51 @@ namespace librealsense
         return _ctx;
     }
 
+    rs2_pipeline_health pipeline::get_health() const
+    {
+        std::lock_guard<std::mutex> lock(_health_mtx);
+        if (!_active_profile)
+            throw wrong_api_call_sequence_exception("get_health() can only be called between a start() and a following stop()");
+
+        rs2_pipeline_health health{};
+        auto add_sensors = [&health](const pipeline_profile& profile)
+        {
+            for (auto&& kvp : profile._multistream.get_sensors())
+            {
+                // Playback sensors keep no counters
+                auto s = dynamic_cast<sensor_base*>(kvp.second);
+                if (!s) continue;
+
+                auto sensor = s->get_health();
+                health.sensors.frames_received += sensor.frames_received;
+                health.sensors.frames_delivered += sensor.frames_delivered;
+                health.sensors.transport_drops += sensor.transport_drops;
+                health.sensors.allocation_drops += sensor.allocation_drops;
+                health.sensors.queue_drops += sensor.queue_drops;
+                health.sensors.frames_in_flight += sensor.frames_in_flight;
+                health.sensors.bytes_in_flight += sensor.bytes_in_flight;
+            }
+        };
+        add_sensors(*_active_profile);
+        for (auto&& p : _additional_profiles)
+            add_sensors(*p);
+
+        auto add_syncer = [&health](syncer_process_unit& syncer)
+        {
+            unsigned long long queued = 0;
+            auto totals = syncer.get_totals(&queued);
+            health.sync_received += totals.enqueued;
+            health.sync_drops += totals.overflowed + totals.dropped;
+            health.sync_queue_depth += queued;
+        };
+        add_syncer(*_syncer);
+        for (auto&& s : _additional_syncers)
+            add_syncer(*s);
+
+        _pipeline_process->get_health(health);
+        return health;
+    }
+
 
     /*
         .______   .______        ______    _______  __   __       _______
@@ -632,7 +1107,8 @@ namespace librealsense
 
     pipeline_profile::pipeline_profile(std::shared_ptr<device_interface> dev,
                                        util::config config,
-                                       const std::string& to_file) :
+                                       const std::string& to_file,
+                                       const std::map<rs2_stream, rs2_record_compression>& compression) :
         _dev(dev), _to_file(to_file)
     {
         if (!to_file.empty())
@@ -640,11 +1116,89 @@ namespace librealsense
             if (!dev)
                 throw librealsense::invalid_value_exception("Failed to create a pipeline_profile, device is null");
 
-            _dev = std::make_shared<record_device>(dev, std::make_shared<ros_writer>(to_file));
+            auto recorder = std::make_shared<record_device>(dev, record_device::create_file_writer(to_file));
+            for (auto&& c : compression)
+                recorder->set_stream_compression(c.first, c.second);
+            _dev = recorder;
         }
         _multistream = config.resolve(_dev.get());
     }
 
+    pipeline_profile::pipeline_profile(std::shared_ptr<device_interface> dev,
+                                       const std::vector<std::pair<int, stream_profile>>& selection) :
+        _dev(dev)
+    {
+        _multistream = util::config::resolve(_dev.get(), selection);
+    }
+
+    std::vector<std::pair<int, stream_profile>> pipeline_profile::get_selection() const
+    {
+        std::vector<std::pair<int, stream_profile>> selection;
+        for (auto&& kvp : _multistream.get_profiles_per_sensor())
+            for (auto&& p : kvp.second)
+                selection.emplace_back(kvp.first, to_profile(p.get()));
+        return selection;
+    }
+
+    // Of the biggest selections the devices resolve to
+    static const size_t max_pipeline_cache_size = 64 * 1024;
+
+    bool pipeline_profile_cache::is_enabled()
+    {
+        static const bool enabled = cache_file::is_enabled("LRS_PIPELINE_CACHE");
+        return enabled;
+    }
+
+    pipeline_profile_cache::pipeline_profile_cache(const std::string& serial, const std::string& firmware_version, const std::string& requests)
+        : _file("LRS_PIPELINE_CACHE", to_string() << serial << "-" << firmware_version << "-" << std::hex
+                << calc_crc32(reinterpret_cast<const uint8_t*>(requests.data()), requests.size()) << ".txt"),
+          _requests(requests)
+    {
+    }
+
+    // Every file holds the requests on its first line, then a line per stream of the sensor index and the profile
+    bool pipeline_profile_cache::load(std::vector<std::pair<int, stream_profile>>& selection) const
+    {
+        std::vector<uint8_t> content;
+        if (!_file.read(content, max_pipeline_cache_size))
+            return false;
+        std::istringstream file(std::string(content.begin(), content.end()));
+
+        std::string requests;
+        if (!std::getline(file, requests) || requests != _requests)
+            return false;
+
+        std::vector<std::pair<int, stream_profile>> result;
+        int sensor, stream, index, format;
+        uint32_t width, height, fps;
+        while (file >> sensor >> stream >> index >> width >> height >> format >> fps)
+        {
+            result.emplace_back(sensor, stream_profile{ static_cast<rs2_stream>(stream), index, width, height, fps, static_cast<rs2_format>(format) });
+        }
+        if (!file.eof() || result.empty())
+        {
+            LOG_WARNING("Ignoring the corrupted pipeline cache " << _file.get_path());
+            return false;
+        }
+
+        selection = std::move(result);
+        return true;
+    }
+
+    void pipeline_profile_cache::store(const std::vector<std::pair<int, stream_profile>>& selection) const
+    {
+        std::ostringstream file;
+        file << _requests << "\n";
+        for (auto&& s : selection)
+        {
+            auto&& p = s.second;
+            file << s.first << " " << static_cast<int>(p.stream) << " " << p.index << " " << p.width << " " << p.height
+                 << " " << static_cast<int>(p.format) << " " << p.fps << "\n";
+        }
+        auto text = file.str();
+        _file.write(std::vector<uint8_t>(text.begin(), text.end()));
+    }
+
     std::shared_ptr<device_interface> pipeline_profile::get_device()
     {
         //pipeline_profile can be retrieved from a pipeline_config and pipeline::start()
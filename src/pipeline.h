@@ -9,6 +9,10 @@
 #include "device_hub.h"
 #include "sync.h"
 #include "config.h"
+#include "proc/processing-graph.h"
+#include "proc/multi-device-syncer.h"
+#include "load-governor.h"
+#include "cache-file.h"
 
 namespace librealsense
 {
@@ -19,26 +23,79 @@ namespace librealsense
         std::map<stream_id, frame_holder> _last_set;
         std::unique_ptr<single_consumer_frame_queue<frame_holder>> _queue;
         std::vector<int> _streams_ids;
+        // Runs the processing blocks of the configuration on the framesets before they are queued, destroyed before the queue
+        std::unique_ptr<processing_graph> _post_processing;
+        std::atomic<unsigned long long> _queued;
+        std::atomic<unsigned long long> _queue_drops;
+        std::atomic<unsigned long long> _delivered;
+
+        // Degrades the framesets under load, when the configuration asks for it
+        std::unique_ptr<load_governor> _governor;
+        load_governor_settings _governor_settings;
+        std::atomic<int> _pending_level;                        // Decided by the governor, applied with the next frameset
+        std::mutex _level_mutex;
+        int _applied_level;
+        load_level _level;
+        std::vector<std::pair<option*, float>> _decimation;    // Magnitude options, with their value before they were raised
+        std::vector<int> _temporal;                             // Of the temporal filters in the processing graph
+        std::atomic<bool> _drop_streams;
+        std::atomic<int> _rate_divider;
+        unsigned long long _framesets;
+        std::atomic<unsigned long long> _governor_skips;
+
         void handle_frame(frame_holder frame, synthetic_source_interface* source);
+        void enqueue(frame_holder frame);
+        void on_delivered(const frame_holder& frame);
+        void apply_load_level(int level);
+        bool is_low_priority(const frame_interface* frame) const;
     public:
-        pipeline_processing_block(const std::vector<int>& streams_to_aggregate);
+        pipeline_processing_block(const std::vector<int>& streams_to_aggregate,
+                                  const std::vector<std::shared_ptr<processing_block_interface>>& post_processing = {},
+                                  const load_governor_settings& governor = {});
         bool dequeue(frame_holder* item, unsigned int timeout_ms = 5000);
         bool try_dequeue(frame_holder* item);
+        single_consumer_frame_queue<frame_holder>& get_queue() { return *_queue; }
+        // Fills the counters of the framesets queued for the application
+        void get_health(rs2_pipeline_health& health) const;
     };
 
     class pipeline;
     class pipeline_profile
     {
     public:
-        pipeline_profile(std::shared_ptr<device_interface> dev, util::config config, const std::string& file = "");
+        pipeline_profile(std::shared_ptr<device_interface> dev, util::config config, const std::string& file = "",
+                         const std::map<rs2_stream, rs2_record_compression>& compression = {});
+        pipeline_profile(std::shared_ptr<device_interface> dev, const std::vector<std::pair<int, stream_profile>>& selection);
         std::shared_ptr<device_interface> get_device();
         stream_profiles get_active_streams() const;
+        // The profiles of the streams, with the index of their sensor
+        std::vector<std::pair<int, stream_profile>> get_selection() const;
         util::config::multistream _multistream;
     private:
         std::shared_ptr<device_interface> _dev;
         std::string _to_file;
     };
 
+    // Profiles a configuration resolved to, stored per serial number, firmware version and requests in the existing directory
+    // named by LRS_PIPELINE_CACHE, for the next runs to open the same streams without matching the requests again
+    class pipeline_profile_cache
+    {
+    public:
+        static bool is_enabled();
+
+        pipeline_profile_cache(const std::string& serial, const std::string& firmware_version, const std::string& requests);
+
+        // False when the requests were not resolved yet, or their file is corrupted
+        bool load(std::vector<std::pair<int, stream_profile>>& selection) const;
+        void store(const std::vector<std::pair<int, stream_profile>>& selection) const;
+
+        const std::string& get_path() const { return _file.get_path(); }
+
+    private:
+        cache_file _file;
+        std::string _requests;
+    };
+
     class pipeline_config;
     class pipeline : public std::enable_shared_from_this<pipeline>
     {
@@ -53,24 +110,37 @@ namespace librealsense
         frame_holder wait_for_frames(unsigned int timeout_ms = 5000);
         bool poll_for_frames(frame_holder* frame);
         bool try_wait_for_frames(frame_holder* frame, unsigned int timeout_ms);
+        // The queue of the framesets of the started pipeline, which stays valid for as long as it is held, for a wait on
+        // several pipelines at once
+        std::shared_ptr<single_consumer_frame_queue<frame_holder>> get_frames_queue() const;
         //Non top level API
         std::shared_ptr<device_interface> wait_for_device(const std::chrono::milliseconds& timeout = std::chrono::hours::max(),
                                                             const std::string& serial = "");
         std::shared_ptr<librealsense::context> get_context() const;
+        // Counters of the frames at every stage of the pipeline, kept since it was started. Not held back by waiting for frames
+        rs2_pipeline_health get_health() const;
 
 
      private:
         void unsafe_start(std::shared_ptr<pipeline_config> conf);
         void unsafe_stop();
         std::shared_ptr<pipeline_profile> unsafe_get_active_profile() const;
+        std::shared_ptr<pipeline_profile> resolve_with_retries(std::shared_ptr<pipeline_config> conf);
+        bool unsafe_is_connected();
 
         std::shared_ptr<librealsense::context> _ctx;
         mutable std::mutex _mtx;
+        // Guards the stages of an active pipeline against being torn down while their counters are read
+        mutable std::mutex _health_mtx;
         device_hub _hub;
         std::shared_ptr<pipeline_profile> _active_profile;
         frame_callback_ptr _callback;
         std::unique_ptr<syncer_process_unit> _syncer;
-        std::unique_ptr<pipeline_processing_block> _pipeline_process;
+        std::shared_ptr<pipeline_processing_block> _pipeline_process;
+        // Of the devices added to the configuration, whose framesets are matched with those of the active profile
+        std::vector<std::shared_ptr<pipeline_profile>> _additional_profiles;
+        std::vector<std::unique_ptr<syncer_process_unit>> _additional_syncers;
+        std::unique_ptr<multi_device_syncer> _device_syncer;
         std::shared_ptr<pipeline_config> _prev_conf;
         int _playback_stopped_token = -1;
         dispatcher _dispatcher;
@@ -83,16 +153,28 @@ namespace librealsense
         void enable_stream(rs2_stream stream, int index, uint32_t width, uint32_t height, rs2_format format, uint32_t framerate);
         void enable_all_stream();
         void enable_device(const std::string& serial);
+        void add_device(const std::string& serial);
         void enable_device_from_file(const std::string& file, bool repeat_playback);
         void enable_record_to_file(const std::string& file);
+        void enable_record_compression(rs2_stream stream, rs2_record_compression compression);
+        void enable_usb_bandwidth_check(bool enable);
+        void add_processing_block(std::shared_ptr<processing_block_interface> block);
+        void enable_load_governor(float max_latency_ms, const std::vector<rs2_load_action>& actions);
+        void set_low_priority_stream(rs2_stream stream, int index);
         void disable_stream(rs2_stream stream, int index = -1);
         void disable_all_streams();
         std::shared_ptr<pipeline_profile> resolve(std::shared_ptr<pipeline> pipe, const std::chrono::milliseconds& timeout = std::chrono::milliseconds(0));
         bool can_resolve(std::shared_ptr<pipeline> pipe);
         bool get_repeat_playback();
+        std::vector<std::shared_ptr<processing_block_interface>> get_processing_blocks();
+        load_governor_settings get_load_governor_settings();
+        // The configurations of the devices the pipeline spans besides the one it resolves to, with the same stream requests
+        std::vector<std::shared_ptr<pipeline_config>> get_additional_device_configs();
 
         //Non top level API
         std::shared_ptr<pipeline_profile> get_cached_resolved_profile();
+        // The requests as one line, equal for the equal requests, which their cached profiles are keyed by
+        std::string get_requests_key() const;
 
         pipeline_config(const pipeline_config& other)
         {
@@ -102,6 +184,10 @@ namespace librealsense
             _stream_requests = other._stream_requests;
             _resolved_profile = nullptr;
             _playback_loop = other._playback_loop;
+            _check_usb_bandwidth = other._check_usb_bandwidth;
+            _processing_blocks = other._processing_blocks;
+            _additional_devices = other._additional_devices;
+            _load_governor = other._load_governor;
         }
     private:
         struct device_request
@@ -109,11 +195,14 @@ namespace librealsense
             std::string serial;
             std::string filename;
             std::string record_output;
+            std::map<rs2_stream, rs2_record_compression> record_compression;
         };
         std::shared_ptr<device_interface> get_or_add_playback_device(std::shared_ptr<pipeline> pipe, const std::string& file);
         std::shared_ptr<device_interface> resolve_device_requests(std::shared_ptr<pipeline> pipe, const std::chrono::milliseconds& timeout);
         stream_profiles get_default_configuration(std::shared_ptr<device_interface> dev);
         std::shared_ptr<pipeline_profile> resolve(std::shared_ptr<device_interface> dev);
+        std::shared_ptr<pipeline_profile> resolve_requests(std::shared_ptr<device_interface> dev);
+        void check_usb_bandwidth(pipeline_profile& profile);
 
         device_request _device_request;
         std::map<std::pair<rs2_stream, int>, util::config::request_type> _stream_requests;
@@ -121,6 +210,10 @@ namespace librealsense
         bool _enable_all_streams = false;
         std::shared_ptr<pipeline_profile> _resolved_profile;
         bool _playback_loop;
+        bool _check_usb_bandwidth = false;
+        std::vector<std::shared_ptr<processing_block_interface>> _processing_blocks;
+        std::vector<std::string> _additional_devices;
+        load_governor_settings _load_governor;
     };
 
 }
@@ -0,0 +1,105 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include "pose-prediction.h"
+
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+namespace librealsense
+{
+    static_assert(sizeof(rs2_pose) % sizeof(uint32_t) == 0, "rs2_pose is copied as 32-bit words");
+
+    latest_pose::latest_pose()
+        : _written(0)
+    {
+        for (auto&& s : _slots)
+        {
+            s.timestamp.store(0, std::memory_order_relaxed);
+            for (auto&& w : s.pose) w.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void latest_pose::record(double timestamp, const rs2_pose& pose)
+    {
+        uint32_t data[words];
+        std::memcpy(data, &pose, sizeof(data));
+
+        auto n = _written.load(std::memory_order_relaxed);
+        auto&& s = _slots[n % slots];
+        s.timestamp.store(timestamp, std::memory_order_relaxed);
+        for (size_t i = 0; i < words; i++)
+            s.pose[i].store(data[i], std::memory_order_relaxed);
+        _written.store(n + 1, std::memory_order_release);
+    }
+
+    bool latest_pose::get(double& timestamp, rs2_pose& pose) const
+    {
+        uint32_t data[words];
+        while (true)
+        {
+            auto n = _written.load(std::memory_order_acquire);
+            if (n == 0)
+                return false;
+
+            auto&& s = _slots[(n - 1) % slots];
+            timestamp = s.timestamp.load(std::memory_order_relaxed);
+            for (size_t i = 0; i < words; i++)
+                data[i] = s.pose[i].load(std::memory_order_relaxed);
+
+            // The slot is only written again once the writer started on the slots - 1 others
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (_written.load(std::memory_order_relaxed) - n < slots - 1)
+                break;
+        }
+        std::memcpy(&pose, data, sizeof(data));
+        return true;
+    }
+
+    void latest_poses::record(int index, double timestamp, const rs2_pose& pose)
+    {
+        if (index >= 0 && index < max_index)
+            _poses[index].record(timestamp, pose);
+    }
+
+    bool latest_poses::get(int index, double& timestamp, rs2_pose& pose) const
+    {
+        if (index < 0 || index >= max_index)
+            return false;
+        return _poses[index].get(timestamp, pose);
+    }
+
+    // The rotation of the rotation vector v, as a quaternion
+    static rs2_quaternion quaternion_exp(const rs2_vector& v)
+    {
+        float x = v.x / 2, y = v.y / 2, z = v.z / 2;
+        float th2 = x * x + y * y + z * z, th = std::sqrt(th2);
+        float c = std::cos(th), s = th2 < std::sqrt(120 * FLT_EPSILON) ? 1 - th2 / 6 : std::sin(th) / th;
+        return { s * x, s * y, s * z, c };
+    }
+
+    static rs2_quaternion quaternion_multiply(const rs2_quaternion& a, const rs2_quaternion& b)
+    {
+        return { a.x * b.w + a.w * b.x - a.z * b.y + a.y * b.z,
+                 a.y * b.w + a.z * b.x + a.w * b.y - a.x * b.z,
+                 a.z * b.w - a.y * b.x + a.x * b.y + a.w * b.z,
+                 a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z };
+    }
+
+    rs2_pose predict_pose(const rs2_pose& pose, double dt_ms)
+    {
+        auto dt = static_cast<float>(dt_ms / 1000);
+        auto dt2 = dt * dt / 2;
+        auto extrapolate = [dt, dt2](const rs2_vector& p, const rs2_vector& v, const rs2_vector& a) {
+            return rs2_vector{ p.x + dt * v.x + dt2 * a.x, p.y + dt * v.y + dt2 * a.y, p.z + dt * v.z + dt2 * a.z };
+        };
+
+        auto predicted = pose;
+        predicted.translation = extrapolate(pose.translation, pose.velocity, pose.acceleration);
+        predicted.velocity = extrapolate(pose.velocity, pose.acceleration, { 0, 0, 0 });
+        predicted.rotation = quaternion_multiply(quaternion_exp(extrapolate({ 0, 0, 0 }, pose.angular_velocity, pose.angular_acceleration)), pose.rotation);
+        predicted.angular_velocity = extrapolate(pose.angular_velocity, pose.angular_acceleration, { 0, 0, 0 });
+        return predicted;
+    }
+}
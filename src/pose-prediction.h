@@ -0,0 +1,56 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "types.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace librealsense
+{
+    // The latest pose of a pose stream, kept as it is received, ahead of the frame carrying it. A single thread writes
+    // the poses into a ring of a few slots, read by any number of threads without locking and without waiting on the
+    // writer: a read only starts over if the writer went around the whole ring meanwhile
+    class latest_pose
+    {
+    public:
+        latest_pose();
+
+        void record(double timestamp, const rs2_pose& pose);
+
+        // False while no pose was received
+        bool get(double& timestamp, rs2_pose& pose) const;
+
+    private:
+        static const size_t slots = 4;
+        static const size_t words = sizeof(rs2_pose) / sizeof(uint32_t);
+
+        struct slot
+        {
+            std::atomic<double> timestamp;
+            std::array<std::atomic<uint32_t>, words> pose;
+        };
+
+        std::array<slot, slots> _slots;
+        std::atomic<uint64_t> _written;     // The latest pose being in the slot of _written - 1
+    };
+
+    // The latest poses of the pose streams of a sensor, by stream index
+    class latest_poses
+    {
+    public:
+        void record(int index, double timestamp, const rs2_pose& pose);
+        bool get(int index, double& timestamp, rs2_pose& pose) const;
+
+    private:
+        static const int max_index = 4;
+        std::array<latest_pose, max_index> _poses;
+    };
+
+    // Extrapolates a pose by dt milliseconds, from its velocity and acceleration. The angular velocity and acceleration,
+    // as those of the translation, are those of the world frame
+    rs2_pose predict_pose(const rs2_pose& pose, double dt_ms);
+}
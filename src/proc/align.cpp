@@ -8,9 +8,15 @@
 #include "core/video.h"
 #include "proc/synthetic-stream.h"
 #include "environment.h"
+#include "option.h"
 #include "align.h"
+#include "align_avx.h"
 #include "stream.h"
 
+#ifdef RS2_USE_CUDA_ALIGN
+#include "../cuda/cuda-align.cuh"
+#endif
+
 #ifdef __SSSE3__
 #include <tmmintrin.h> // For SSE3 intrinsic used in unpack_yuy2_sse
 #endif
@@ -192,18 +198,69 @@ namespace librealsense
     }
 
 
-    image_transform::image_transform(const rs2_intrinsics& from, float depth_scale)
+    image_transform::image_transform(const rs2_intrinsics& from, float depth_scale, std::shared_ptr<parallel_workers> workers)
         :_depth(from),
         _depth_scale(depth_scale),
         _pixel_top_left_int(from.width*from.height),
-        _pixel_bottom_right_int(from.width*from.height)
+        _pixel_bottom_right_int(from.width*from.height),
+        _workers(workers)
+    {
+    }
+
+    template<rs2_distortion dist>
+    inline void image_transform::get_texture_map(const uint16_t* z_pixels,
+        const std::vector<float>& pre_compute_map_x,
+        const std::vector<float>& pre_compute_map_y,
+        std::vector<int2>& pixels,
+        const rs2_intrinsics& to,
+        const rs2_extrinsics& from_to_other)
     {
+        // Bands keep the 8-pixel steps of the SIMD code, and its alignment
+        auto project = [&](size_t begin, size_t end)
+        {
+#if defined(__AVX2__) || defined(RS2_USE_AVX2_UNPACKERS)
+            if (get_simd_level() == simd_level::avx2)
+            {
+                get_texture_map_avx(z_pixels + begin, _depth_scale, static_cast<unsigned int>(end - begin), pre_compute_map_x.data() + begin,
+                    pre_compute_map_y.data() + begin, (byte*)(pixels.data() + begin), to, from_to_other);
+                return;
+            }
+#endif
+            get_texture_map_sse<dist>(z_pixels + begin, _depth_scale, static_cast<unsigned int>(end - begin), pre_compute_map_x.data() + begin,
+                pre_compute_map_y.data() + begin, (byte*)(pixels.data() + begin), to, from_to_other);
+
+            // The streaming stores must be visible before any other thread reads the pixels
+            _mm_sfence();
+        };
+
+        auto size = static_cast<size_t>(_depth.height*_depth.width);
+        if (_workers)
+            _workers->run_bands(size, 8, project);
+        else
+            project(0, size);
     }
 
     void image_transform::pre_compute_x_y_map_corners()
     {
-        pre_compute_x_y_map(_pre_compute_map_x_top_left, _pre_compute_map_y_top_left, -0.5f);
-        pre_compute_x_y_map(_pre_compute_map_x_bottom_right, _pre_compute_map_y_bottom_right, 0.5f);
+        // The cache only holds the maps while some transform uses them
+        static std::mutex cache_mutex;
+        static std::vector<std::pair<rs2_intrinsics, std::weak_ptr<const pre_compute_maps>>> cache;
+
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        cache.erase(std::remove_if(cache.begin(), cache.end(),
+            [](const std::pair<rs2_intrinsics, std::weak_ptr<const pre_compute_maps>>& entry) { return entry.second.expired(); }), cache.end());
+
+        for (auto&& entry : cache)
+        {
+            if (entry.first == _depth && (_maps = entry.second.lock()))
+                return;
+        }
+
+        auto maps = std::make_shared<pre_compute_maps>();
+        pre_compute_x_y_map(maps->x_top_left, maps->y_top_left, -0.5f);
+        pre_compute_x_y_map(maps->x_bottom_right, maps->y_bottom_right, 0.5f);
+        cache.emplace_back(_depth, maps);
+        _maps = maps;
     }
 
     void image_transform::pre_compute_x_y_map(std::vector<float>& pre_compute_map_x,
@@ -256,7 +313,46 @@ namespace librealsense
         const std::vector<int2>& pixel_top_left_int,
         const std::vector<int2>& pixel_bottom_right_int)
     {
-        for (int y = 0; y < _depth.height; ++y)
+        if (!_workers)
+            return move_depth_to_other(z_pixels, dest, to, pixel_top_left_int, pixel_bottom_right_int, 0, _depth.height);
+
+        // Bands of depth rows may land on the same pixels. The first band writes to dest and the others to their own buffers,
+        // which are then merged keeping the closest valid depth, so the result does not depend on the order of the writes
+        auto bands = static_cast<int>(_workers->size()) + 1;
+        auto rows = (_depth.height + bands - 1) / bands;
+        auto size = static_cast<size_t>(to.width*to.height);
+        _band_depth.resize(bands - 1);
+
+        _workers->run(bands, [&](int i)
+        {
+            auto begin = std::min(i * rows, _depth.height);
+            auto end = std::min(begin + rows, _depth.height);
+            uint16_t* band_dest = dest;
+            if (i)
+            {
+                _band_depth[i - 1].assign(size, 0);
+                band_dest = _band_depth[i - 1].data();
+            }
+            move_depth_to_other(z_pixels, band_dest, to, pixel_top_left_int, pixel_bottom_right_int, begin, end);
+        });
+
+        _workers->run_bands(size, 32, [&](size_t begin, size_t end)
+        {
+            for (auto&& band : _band_depth)
+            {
+                // Zero wraps to the largest value, so the minimum ignores it unless both are zero
+                for (auto i = begin; i < end; ++i)
+                    dest[i] = static_cast<uint16_t>(std::min<uint16_t>(dest[i] - 1, band[i] - 1) + 1);
+            }
+        });
+    }
+
+    inline void image_transform::move_depth_to_other(const uint16_t* z_pixels, uint16_t* dest, const rs2_intrinsics& to,
+        const std::vector<int2>& pixel_top_left_int,
+        const std::vector<int2>& pixel_bottom_right_int,
+        int begin, int end)
+    {
+        for (int y = begin; y < end; ++y)
         {
             for (int x = 0; x < _depth.width; ++x)
             {
@@ -306,8 +402,7 @@ namespace librealsense
     inline void image_transform::align_depth_to_other_sse(const uint16_t * z_pixels, uint16_t * dest, const rs2_intrinsics& depth, const rs2_intrinsics& to,
         const rs2_extrinsics& from_to_other)
     {
-        get_texture_map_sse<dist>(z_pixels, _depth_scale, _depth.height*_depth.width, _pre_compute_map_x_top_left.data(),
-            _pre_compute_map_y_top_left.data(), (byte*)_pixel_top_left_int.data(), to, from_to_other);
+        get_texture_map<dist>(z_pixels, _maps->x_top_left, _maps->y_top_left, _pixel_top_left_int, to, from_to_other);
 
         float fov[2];
         rs2_fov(&depth, fov);
@@ -318,8 +413,7 @@ namespace librealsense
 
         if (pixels_per_angle_depth.x < pixels_per_angle_target.x || pixels_per_angle_depth.y < pixels_per_angle_target.y || is_special_resolution(depth, to))
         {
-            get_texture_map_sse<dist>(z_pixels, _depth_scale, _depth.height*_depth.width, _pre_compute_map_x_bottom_right.data(),
-                _pre_compute_map_y_bottom_right.data(), (byte*)_pixel_bottom_right_int.data(), to, from_to_other);
+            get_texture_map<dist>(z_pixels, _maps->x_bottom_right, _maps->y_bottom_right, _pixel_bottom_right_int, to, from_to_other);
 
             move_depth_to_other(z_pixels, dest, to, _pixel_top_left_int, _pixel_bottom_right_int);
         }
@@ -334,14 +428,12 @@ namespace librealsense
     inline void image_transform::align_other_to_depth_sse(const uint16_t * z_pixels, const byte * source, byte * dest, int bpp, const rs2_intrinsics& to,
         const rs2_extrinsics& from_to_other)
     {
-        get_texture_map_sse<dist>(z_pixels, _depth_scale, _depth.height*_depth.width, _pre_compute_map_x_top_left.data(),
-            _pre_compute_map_y_top_left.data(), (byte*)_pixel_top_left_int.data(), to, from_to_other);
+        get_texture_map<dist>(z_pixels, _maps->x_top_left, _maps->y_top_left, _pixel_top_left_int, to, from_to_other);
 
         std::vector<int2>& bottom_right = _pixel_top_left_int;
         if (to.height < _depth.height && to.width < _depth.width)
         {
-            get_texture_map_sse<dist>(z_pixels, _depth_scale, _depth.height*_depth.width, _pre_compute_map_x_bottom_right.data(),
-                _pre_compute_map_y_bottom_right.data(), (byte*)_pixel_bottom_right_int.data(), to, from_to_other);
+            get_texture_map<dist>(z_pixels, _maps->x_bottom_right, _maps->y_bottom_right, _pixel_bottom_right_int, to, from_to_other);
 
             bottom_right = _pixel_bottom_right_int;
         }
@@ -374,9 +466,29 @@ namespace librealsense
         T* dest, const rs2_intrinsics& to,
         const std::vector<int2>& pixel_top_left_int,
         const std::vector<int2>& pixel_bottom_right_int)
+    {
+        // Every depth pixel only writes to itself, so bands of rows are independent
+        auto rows = [&](size_t begin, size_t end)
+        {
+            move_other_to_depth(z_pixels, source, dest, to, pixel_top_left_int, pixel_bottom_right_int, int(begin), int(end));
+        };
+
+        if (_workers)
+            _workers->run_bands(_depth.height, 1, rows);
+        else
+            rows(0, _depth.height);
+    }
+
+    template<class T >
+    void image_transform::move_other_to_depth(const uint16_t* z_pixels,
+        const T* source,
+        T* dest, const rs2_intrinsics& to,
+        const std::vector<int2>& pixel_top_left_int,
+        const std::vector<int2>& pixel_bottom_right_int,
+        int begin, int end)
     {
         // Iterate over the pixels of the depth image
-        for (int y = 0; y < _depth.height; ++y)
+        for (int y = begin; y < end; ++y)
         {
             for (int x = 0; x < _depth.width; ++x)
             {
@@ -407,45 +519,47 @@ namespace librealsense
         const rs2_intrinsics& other_intrin, GET_DEPTH get_depth, TRANSFER_PIXEL transfer_pixel)
     {
         // Iterate over the pixels of the depth image
-#pragma omp parallel for schedule(dynamic)
-        for (int depth_y = 0; depth_y < depth_intrin.height; ++depth_y)
+        parallel_for(0, depth_intrin.height, 16, [&](int first, int last)
         {
-            int depth_pixel_index = depth_y * depth_intrin.width;
-            for (int depth_x = 0; depth_x < depth_intrin.width; ++depth_x, ++depth_pixel_index)
+            for (int depth_y = first; depth_y < last; ++depth_y)
             {
-                // Skip over depth pixels with the value of zero, we have no depth data so we will not write anything into our aligned images
-                if (float depth = get_depth(depth_pixel_index))
+                int depth_pixel_index = depth_y * depth_intrin.width;
+                for (int depth_x = 0; depth_x < depth_intrin.width; ++depth_x, ++depth_pixel_index)
                 {
-                    // Map the top-left corner of the depth pixel onto the other image
-                    float depth_pixel[2] = { depth_x - 0.5f, depth_y - 0.5f }, depth_point[3], other_point[3], other_pixel[2];
-                    rs2_deproject_pixel_to_point(depth_point, &depth_intrin, depth_pixel, depth);
-                    rs2_transform_point_to_point(other_point, &depth_to_other, depth_point);
-                    rs2_project_point_to_pixel(other_pixel, &other_intrin, other_point);
-                    const int other_x0 = static_cast<int>(other_pixel[0] + 0.5f);
-                    const int other_y0 = static_cast<int>(other_pixel[1] + 0.5f);
-
-                    // Map the bottom-right corner of the depth pixel onto the other image
-                    depth_pixel[0] = depth_x + 0.5f; depth_pixel[1] = depth_y + 0.5f;
-                    rs2_deproject_pixel_to_point(depth_point, &depth_intrin, depth_pixel, depth);
-                    rs2_transform_point_to_point(other_point, &depth_to_other, depth_point);
-                    rs2_project_point_to_pixel(other_pixel, &other_intrin, other_point);
-                    const int other_x1 = static_cast<int>(other_pixel[0] + 0.5f);
-                    const int other_y1 = static_cast<int>(other_pixel[1] + 0.5f);
-
-                    if (other_x0 < 0 || other_y0 < 0 || other_x1 >= other_intrin.width || other_y1 >= other_intrin.height)
-                        continue;
-
-                    // Transfer between the depth pixels and the pixels inside the rectangle on the other image
-                    for (int y = other_y0; y <= other_y1; ++y)
+                    // Skip over depth pixels with the value of zero, we have no depth data so we will not write anything into our aligned images
+                    if (float depth = get_depth(depth_pixel_index))
                     {
-                        for (int x = other_x0; x <= other_x1; ++x)
+                        // Map the top-left corner of the depth pixel onto the other image
+                        float depth_pixel[2] = { depth_x - 0.5f, depth_y - 0.5f }, depth_point[3], other_point[3], other_pixel[2];
+                        rs2_deproject_pixel_to_point(depth_point, &depth_intrin, depth_pixel, depth);
+                        rs2_transform_point_to_point(other_point, &depth_to_other, depth_point);
+                        rs2_project_point_to_pixel(other_pixel, &other_intrin, other_point);
+                        const int other_x0 = static_cast<int>(other_pixel[0] + 0.5f);
+                        const int other_y0 = static_cast<int>(other_pixel[1] + 0.5f);
+
+                        // Map the bottom-right corner of the depth pixel onto the other image
+                        depth_pixel[0] = depth_x + 0.5f; depth_pixel[1] = depth_y + 0.5f;
+                        rs2_deproject_pixel_to_point(depth_point, &depth_intrin, depth_pixel, depth);
+                        rs2_transform_point_to_point(other_point, &depth_to_other, depth_point);
+                        rs2_project_point_to_pixel(other_pixel, &other_intrin, other_point);
+                        const int other_x1 = static_cast<int>(other_pixel[0] + 0.5f);
+                        const int other_y1 = static_cast<int>(other_pixel[1] + 0.5f);
+
+                        if (other_x0 < 0 || other_y0 < 0 || other_x1 >= other_intrin.width || other_y1 >= other_intrin.height)
+                            continue;
+
+                        // Transfer between the depth pixels and the pixels inside the rectangle on the other image
+                        for (int y = other_y0; y <= other_y1; ++y)
                         {
-                            transfer_pixel(depth_pixel_index, y * other_intrin.width + x);
+                            for (int x = other_x0; x <= other_x1; ++x)
+                            {
+                                transfer_pixel(depth_pixel_index, y * other_intrin.width + x);
+                            }
                         }
                     }
                 }
             }
-        }
+        });
     }
 
     void align_z_to_other(byte* z_aligned_to_other, const uint16_t* z_pixels, float z_scale, const rs2_intrinsics& z_intrin, const rs2_extrinsics& z_to_other, const rs2_intrinsics& other_intrin)
@@ -505,6 +619,35 @@ namespace librealsense
         align_other_to_depth(other_aligned_to_z, [z_pixels, z_scale](int z_pixel_index) { return z_scale * z_pixels[z_pixel_index]; }, z_intrin, z_to_other, other_intrin, other_pixels, other_format);
     }
 
+    rs2_intrinsics scale_intrinsics(const rs2_intrinsics& intrin, float scale)
+    {
+        auto scaled = intrin;
+        scaled.width = std::max(1, static_cast<int>(std::lround(intrin.width * scale)));
+        scaled.height = std::max(1, static_cast<int>(std::lround(intrin.height * scale)));
+
+        auto scale_x = float(scaled.width) / intrin.width, scale_y = float(scaled.height) / intrin.height;
+        scaled.fx = intrin.fx * scale_x;
+        scaled.fy = intrin.fy * scale_y;
+        scaled.ppx = (intrin.ppx + 0.5f) * scale_x - 0.5f;
+        scaled.ppy = (intrin.ppy + 0.5f) * scale_y - 0.5f;
+        return scaled;
+    }
+
+    align::align(rs2_stream to_stream) : _to_stream_type(to_stream), _target_scale(1.f), _threads(1)
+    {
+        auto max_threads = std::max<int>(std::thread::hardware_concurrency(), 1);
+        auto processing_threads = std::make_shared<ptr_option<int>>(1, max_threads, 1, 1, &_threads,
+            "Number of threads, including the calling one, that align each frame in bands of depth rows");
+        register_option(RS2_OPTION_PROCESSING_THREADS, processing_threads);
+
+        if (to_stream != RS2_STREAM_DEPTH)
+        {
+            auto target_scale = std::make_shared<ptr_option<float>>(0.1f, 1.f, 0.01f, 1.f, &_target_scale,
+                "Scale of the resolution of the image the depth is aligned to, the aligned depth being computed at the reduced resolution");
+            register_option(RS2_OPTION_TARGET_SCALE, target_scale);
+        }
+    }
+
     int align::get_unique_id(rs2::video_stream_profile&  original_profile,
         rs2::video_stream_profile&  to_profile,
         rs2::video_stream_profile&  aligned_profile)
@@ -531,26 +674,19 @@ namespace librealsense
 
     std::shared_ptr<rs2::video_stream_profile> align::create_aligned_profile(
         rs2::video_stream_profile& original_profile,
-        rs2::video_stream_profile& to_profile)
+        rs2::video_stream_profile& to_profile,
+        const rs2_intrinsics& to_intrinsics)
     {
         auto aligned_profile = std::make_shared<rs2::video_stream_profile>(original_profile.clone(original_profile.stream_type(), original_profile.stream_index(), original_profile.format()));
         int aligned_unique_id = get_unique_id(original_profile, to_profile, *aligned_profile);
         aligned_profile->get()->profile->set_unique_id(aligned_unique_id);
         environment::get_instance().get_extrinsics_graph().register_same_extrinsics(*aligned_profile.get()->get()->profile, *original_profile.get()->profile);
         aligned_profile->get()->profile->set_framerate(original_profile.fps());
-        if (auto original_video_profile = As<video_stream_profile_interface>(original_profile.get()->profile))
+        if (auto aligned_video_profile = As<video_stream_profile_interface>(aligned_profile->get()->profile))
         {
-            if (auto to_video_profile = As<video_stream_profile_interface>(to_profile.get()->profile))
-            {
-                if (auto aligned_video_profile = As<video_stream_profile_interface>(aligned_profile->get()->profile))
-                {
-                    aligned_video_profile->set_dims(to_video_profile->get_width(), to_video_profile->get_height());
-                    auto aligned_intrinsics = to_video_profile->get_intrinsics();
-                    aligned_intrinsics.width = to_video_profile->get_width();
-                    aligned_intrinsics.height = to_video_profile->get_height();
-                    aligned_video_profile->set_intrinsics([aligned_intrinsics]() { return aligned_intrinsics; });
-                }
-            }
+            aligned_video_profile->set_dims(to_intrinsics.width, to_intrinsics.height);
+            auto aligned_intrinsics = to_intrinsics;
+            aligned_video_profile->set_intrinsics([aligned_intrinsics]() { return aligned_intrinsics; });
         }
         return aligned_profile;
     }
@@ -588,6 +724,15 @@ namespace librealsense
 
         auto curr_depth = depth_frame.get_profile().as<rs2::video_stream_profile>();
         // TODO: use sensor/profile id, to enable handle a case that two different depth streams with similar resolution being proceesed by the same "align" object
+        // The transform keeps the workers it was created with
+        if ((_workers ? int(_workers->size()) + 1 : 1) != _threads)
+        {
+            _workers = _threads > 1 ? std::make_shared<parallel_workers>(_threads - 1) : nullptr;
+#ifdef __SSSE3__
+            _stream_transform = nullptr;
+#endif
+        }
+
         if (_prev_depth_res.first != curr_depth.width() || _prev_depth_res.second != curr_depth.height())
         {
 #ifdef __SSSE3__
@@ -633,6 +778,9 @@ namespace librealsense
             }
 
             rs2_intrinsics other_intrinsics = other_profile.get_intrinsics();
+            // The depth aligned to the other image is scattered at the reduced resolution from the start
+            if (_target_scale < 1.f)
+                other_intrinsics = scale_intrinsics(other_intrinsics, _target_scale);
             rs2_extrinsics depth_to_other_extrinsics{};
             if (!environment::get_instance().get_extrinsics_graph().try_fetch_extrinsics(*depth_profile.get()->profile, *other_profile.get()->profile, &depth_to_other_extrinsics))
             {
@@ -660,7 +808,10 @@ namespace librealsense
             {
                 //Align a stream to depth
                 auto aligned_bytes_per_pixel = other_frame.get_bytes_per_pixel();
-                auto aligned_profile = create_aligned_profile(other_profile, depth_profile);
+                auto aligned_intrinsics = depth_intrinsics;
+                aligned_intrinsics.width = depth_profile.width();
+                aligned_intrinsics.height = depth_profile.height();
+                auto aligned_profile = create_aligned_profile(other_profile, depth_profile, aligned_intrinsics);
                 aligned_frame = source.allocate_video_frame(
                     *aligned_profile,
                     other_frame,
@@ -676,38 +827,69 @@ namespace librealsense
                     return rv;
                 }
 
-                byte* other_aligned_to_depth = reinterpret_cast<byte*>(const_cast<void*>(aligned_frame.get_data()));
-                memset(other_aligned_to_depth, 0, depth_intrinsics.height * depth_intrinsics.width * aligned_bytes_per_pixel);
-#ifdef __SSSE3__
-                if (_stream_transform == nullptr)
-                {
-                    _stream_transform = std::make_shared<image_transform>(depth_intrinsics,
-                        depth_scale);
-
-                    _stream_transform->pre_compute_x_y_map_corners();
-                }
-
-                _stream_transform->align_other_to_depth(reinterpret_cast<const uint16_t*>(depth_frame.get_data()),
-                    reinterpret_cast<const byte*>(other_frame.get_data()),
-                    other_aligned_to_depth, other_frame.get_bytes_per_pixel(),
+#if defined(RS2_USE_CUDA_ALIGN)
+                if (_aligner_cuda == nullptr)
+                    _aligner_cuda = std::make_shared<rscuda::align_cuda>();
+
+                // GPU-resident inputs are read on the device, and the aligned frame stays there as well unless the device is out of memory
+                auto d_depth = static_cast<const uint16_t*>(get_device_data((frame_interface*)depth_frame.get()));
+                auto d_other = static_cast<const uint8_t*>(get_device_data((frame_interface*)other_frame.get()));
+                auto aligned = dynamic_cast<librealsense::frame*>((frame_interface*)aligned_frame.get());
+                auto d_aligned = static_cast<uint8_t*>(aligned->alloc_device_data(depth_intrinsics.height * depth_intrinsics.width * aligned_bytes_per_pixel));
+                _aligner_cuda->align_other_to_depth(d_aligned ? nullptr : reinterpret_cast<uint8_t*>(const_cast<void*>(aligned_frame.get_data())),
+                    d_depth ? nullptr : reinterpret_cast<const uint16_t*>(depth_frame.get_data()),
+                    depth_scale,
+                    depth_intrinsics,
+                    depth_to_other_extrinsics,
                     other_intrinsics,
-                    depth_to_other_extrinsics);
+                    d_other ? nullptr : reinterpret_cast<const byte*>(other_frame.get_data()),
+                    other_frame.get_bytes_per_pixel(),
+                    d_depth, d_other, d_aligned);
 #else
-                align_other_to_z(other_aligned_to_depth,
+                byte* other_aligned_to_depth = reinterpret_cast<byte*>(const_cast<void*>(aligned_frame.get_data()));
+                auto backend = environment::get_instance().get_compute_backend();
+                if (!backend || !backend->align_other_to_depth(other_aligned_to_depth,
                     reinterpret_cast<const uint16_t*>(depth_frame.get_data()),
                     depth_scale,
                     depth_intrinsics,
                     depth_to_other_extrinsics,
                     other_intrinsics,
                     reinterpret_cast<const byte*>(other_frame.get_data()),
-                    other_profile.format());
+                    other_frame.get_bytes_per_pixel()))
+                {
+                    memset(other_aligned_to_depth, 0, depth_intrinsics.height * depth_intrinsics.width * aligned_bytes_per_pixel);
+#if defined(__SSSE3__)
+                    if (_stream_transform == nullptr)
+                    {
+                        _stream_transform = std::make_shared<image_transform>(depth_intrinsics,
+                            depth_scale, _workers);
+
+                        _stream_transform->pre_compute_x_y_map_corners();
+                    }
+
+                    _stream_transform->align_other_to_depth(reinterpret_cast<const uint16_t*>(depth_frame.get_data()),
+                        reinterpret_cast<const byte*>(other_frame.get_data()),
+                        other_aligned_to_depth, other_frame.get_bytes_per_pixel(),
+                        other_intrinsics,
+                        depth_to_other_extrinsics);
+#else
+                    align_other_to_z(other_aligned_to_depth,
+                        reinterpret_cast<const uint16_t*>(depth_frame.get_data()),
+                        depth_scale,
+                        depth_intrinsics,
+                        depth_to_other_extrinsics,
+                        other_intrinsics,
+                        reinterpret_cast<const byte*>(other_frame.get_data()),
+                        other_profile.format());
+#endif
+                }
 #endif
             }
             else
             {
                 //Align depth to some stream
                 auto aligned_bytes_per_pixel = depth_frame.get_bytes_per_pixel();
-                auto aligned_profile = create_aligned_profile(depth_profile, other_profile);
+                auto aligned_profile = create_aligned_profile(depth_profile, other_profile, other_intrinsics);
                 aligned_frame = source.allocate_video_frame(
                     *aligned_profile,
                     depth_frame,
@@ -722,21 +904,44 @@ namespace librealsense
                     LOG_ERROR("Failed to allocate frame for aligned output");
                     return rv;
                 }
-                byte* z_aligned_to_other = reinterpret_cast<byte*>(const_cast<void*>(aligned_frame.get_data()));
-                memset(z_aligned_to_other, 0, other_intrinsics.height * other_intrinsics.width * aligned_bytes_per_pixel);
-                auto data = (int16_t*)depth_frame.get_data();
 
-#ifdef __SSSE3__
-                if (_stream_transform == nullptr)
+#if defined(RS2_USE_CUDA_ALIGN)
+                if (_aligner_cuda == nullptr)
+                    _aligner_cuda = std::make_shared<rscuda::align_cuda>();
+
+                // GPU-resident depth is read on the device, and the aligned frame stays there as well unless the device is out of memory
+                auto d_depth = static_cast<const uint16_t*>(get_device_data((frame_interface*)depth_frame.get()));
+                auto aligned = dynamic_cast<librealsense::frame*>((frame_interface*)aligned_frame.get());
+                auto d_aligned = static_cast<uint16_t*>(aligned->alloc_device_data(other_intrinsics.height * other_intrinsics.width * aligned_bytes_per_pixel));
+                _aligner_cuda->align_depth_to_other(d_aligned ? nullptr : reinterpret_cast<uint16_t*>(const_cast<void*>(aligned_frame.get_data())),
+                    d_depth ? nullptr : reinterpret_cast<const uint16_t*>(depth_frame.get_data()),
+                    depth_scale,
+                    depth_intrinsics,
+                    depth_to_other_extrinsics,
+                    other_intrinsics,
+                    d_depth, d_aligned);
+#else
+                byte* z_aligned_to_other = reinterpret_cast<byte*>(const_cast<void*>(aligned_frame.get_data()));
+                auto backend = environment::get_instance().get_compute_backend();
+                if (!backend || !backend->align_depth_to_other(reinterpret_cast<uint16_t*>(z_aligned_to_other),
+                    reinterpret_cast<const uint16_t*>(depth_frame.get_data()),
+                    depth_scale,
+                    depth_intrinsics,
+                    depth_to_other_extrinsics,
+                    other_intrinsics))
                 {
-                    _stream_transform = std::make_shared<image_transform>(depth_intrinsics,
-                        depth_scale);
+                    memset(z_aligned_to_other, 0, other_intrinsics.height * other_intrinsics.width * aligned_bytes_per_pixel);
+#if defined(__SSSE3__)
+                    if (_stream_transform == nullptr)
+                    {
+                        _stream_transform = std::make_shared<image_transform>(depth_intrinsics,
+                            depth_scale, _workers);
 
-                    _stream_transform->pre_compute_x_y_map_corners();
-                }
-                _stream_transform->align_depth_to_other(reinterpret_cast<const uint16_t*>(depth_frame.get_data()),
-                    reinterpret_cast<uint16_t*>(z_aligned_to_other), depth_frame.get_bytes_per_pixel(),
-                    depth_intrinsics, other_intrinsics, depth_to_other_extrinsics);
+                        _stream_transform->pre_compute_x_y_map_corners();
+                    }
+                    _stream_transform->align_depth_to_other(reinterpret_cast<const uint16_t*>(depth_frame.get_data()),
+                        reinterpret_cast<uint16_t*>(z_aligned_to_other), depth_frame.get_bytes_per_pixel(),
+                        depth_intrinsics, other_intrinsics, depth_to_other_extrinsics);
 #else
                     align_z_to_other(z_aligned_to_other,
                         reinterpret_cast<const uint16_t*>(depth_frame.get_data()),
@@ -744,6 +949,8 @@ namespace librealsense
                         depth_intrinsics,
                         depth_to_other_extrinsics,
                         other_intrinsics);
+#endif
+                }
 #endif
                 assert(output_frames.size() == 0); //When aligning depth to other, only 2 frames are expected in the output.
                 other_frame.keep();
@@ -9,16 +9,35 @@
 #include "proc/synthetic-stream.h"
 #include "image.h"
 #include "source.h"
+#include "concurrency.h"
+
+#ifdef RS2_USE_CUDA_ALIGN
+namespace rscuda
+{
+    class align_cuda;
+}
+#endif
 
 namespace librealsense
 {
 #ifdef __SSSE3__
+    // Normalized coordinates of the corners of every depth pixel. They only depend on the depth intrinsics,
+    // so all the transforms of the process with the same intrinsics share them
+    struct pre_compute_maps
+    {
+        std::vector<float> x_top_left;
+        std::vector<float> y_top_left;
+        std::vector<float> x_bottom_right;
+        std::vector<float> y_bottom_right;
+    };
+
     class image_transform
     {
     public:
 
         image_transform(const rs2_intrinsics& from,
-            float depth_scale);
+            float depth_scale,
+            std::shared_ptr<parallel_workers> workers = nullptr);
 
         inline void align_depth_to_other(const uint16_t* z_pixels,
             uint16_t* dest, int bpp, 
@@ -31,6 +50,7 @@ namespace librealsense
             byte* dest, int bpp, const rs2_intrinsics& to,
             const rs2_extrinsics& from_to_other);
 
+        // Takes the maps of the depth intrinsics from the process-wide cache, computing them on first use
         void pre_compute_x_y_map_corners();
 
     private:
@@ -38,18 +58,29 @@ namespace librealsense
         const rs2_intrinsics _depth;
         float _depth_scale;
 
-        std::vector<float> _pre_compute_map_x_top_left;
-        std::vector<float> _pre_compute_map_y_top_left;
-        std::vector<float> _pre_compute_map_x_bottom_right;
-        std::vector<float> _pre_compute_map_y_bottom_right;
+        std::shared_ptr<const pre_compute_maps> _maps;
 
         std::vector<int2> _pixel_top_left_int;
         std::vector<int2> _pixel_bottom_right_int;
 
+        // Splits the work on each frame in bands of depth rows, when set
+        std::shared_ptr<parallel_workers> _workers;
+        // Depth written by each band but the first one, before keeping the closest value of every pixel
+        std::vector<std::vector<uint16_t>> _band_depth;
+
         void pre_compute_x_y_map(std::vector<float>& pre_compute_map_x,
             std::vector<float>& pre_compute_map_y,
             float offset = 0);
 
+        // Projects every depth pixel to the other image, from one of its corners
+        template<rs2_distortion dist>
+        inline void get_texture_map(const uint16_t* z_pixels,
+            const std::vector<float>& pre_compute_map_x,
+            const std::vector<float>& pre_compute_map_y,
+            std::vector<int2>& pixels,
+            const rs2_intrinsics& to,
+            const rs2_extrinsics& from_to_other);
+
         template<rs2_distortion dist = RS2_DISTORTION_NONE>
         inline void align_depth_to_other_sse(const uint16_t* z_pixels,
             uint16_t* dest, const rs2_intrinsics& depth,
@@ -67,6 +98,13 @@ namespace librealsense
             const std::vector<int2>& pixel_top_left_int,
             const std::vector<int2>& pixel_bottom_right_int);
 
+        // Scatters the depth rows in [begin, end)
+        inline void move_depth_to_other(const uint16_t* z_pixels,
+            uint16_t* dest, const rs2_intrinsics& to,
+            const std::vector<int2>& pixel_top_left_int,
+            const std::vector<int2>& pixel_bottom_right_int,
+            int begin, int end);
+
         template<class T >
         inline void move_other_to_depth(const uint16_t* z_pixels,
             const T* source,
@@ -74,13 +112,26 @@ namespace librealsense
             const std::vector<int2>& pixel_top_left_int,
             const std::vector<int2>& pixel_bottom_right_int);
 
+        // Gathers the depth rows in [begin, end)
+        template<class T >
+        inline void move_other_to_depth(const uint16_t* z_pixels,
+            const T* source,
+            T* dest, const rs2_intrinsics& to,
+            const std::vector<int2>& pixel_top_left_int,
+            const std::vector<int2>& pixel_bottom_right_int,
+            int begin, int end);
+
     };
 #endif
 
+    // The intrinsics of the image at a scale of its resolution, of the same field of view: the edges of the image, rather than
+    // the centers of its corner pixels, stay where they are
+    rs2_intrinsics scale_intrinsics(const rs2_intrinsics& intrin, float scale);
+
     class align : public generic_processing_block
     {
     public:
-        align(rs2_stream to_stream) : _to_stream_type(to_stream){}
+        align(rs2_stream to_stream);
 
     protected:
         bool should_process(const rs2::frame& frame) override;
@@ -89,14 +140,21 @@ namespace librealsense
     private:
         std::shared_ptr<rs2::video_stream_profile> create_aligned_profile(
             rs2::video_stream_profile& original_profile,
-            rs2::video_stream_profile& to_profile);
+            rs2::video_stream_profile& to_profile,
+            const rs2_intrinsics& to_intrinsics);
         int get_unique_id(rs2::video_stream_profile& original_profile,
             rs2::video_stream_profile& to_profile,
             rs2::video_stream_profile& aligned_profile);
         rs2_stream _to_stream_type;
         std::map<std::pair<int, int>, int> _align_stream_unique_ids;
         std::pair<int, int> _prev_depth_res;
+        float _target_scale;    // Of the resolution of the other image, when the depth is aligned to it
+        int _threads;
+        std::shared_ptr<parallel_workers> _workers;
 
+#ifdef RS2_USE_CUDA_ALIGN
+        std::shared_ptr<rscuda::align_cuda> _aligner_cuda;
+#endif
 #ifdef __SSSE3__
         std::shared_ptr<image_transform> _stream_transform;
 #endif
@@ -0,0 +1,135 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include "align_avx.h"
+
+#if defined(__SSSE3__) && (defined(__AVX2__) || defined(RS2_USE_AVX2_UNPACKERS))
+#include <immintrin.h>
+
+namespace librealsense
+{
+    template<rs2_distortion dist>
+    inline void distorte_x_y(const __m256 & x, const __m256 & y, __m256 * distorted_x, __m256 * distorted_y, const rs2_intrinsics& to)
+    {
+        *distorted_x = x;
+        *distorted_y = y;
+    }
+    template<>
+    inline void distorte_x_y<RS2_DISTORTION_MODIFIED_BROWN_CONRADY>(const __m256& x, const __m256& y, __m256* distorted_x, __m256* distorted_y, const rs2_intrinsics& to)
+    {
+        __m256 c[5];
+        auto one = _mm256_set1_ps(1);
+        auto two = _mm256_set1_ps(2);
+
+        for (int i = 0; i < 5; ++i)
+        {
+            c[i] = _mm256_set1_ps(to.coeffs[i]);
+        }
+        auto r2_0 = _mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y));
+        auto r3_0 = _mm256_add_ps(_mm256_mul_ps(c[1], _mm256_mul_ps(r2_0, r2_0)), _mm256_mul_ps(c[4], _mm256_mul_ps(r2_0, _mm256_mul_ps(r2_0, r2_0))));
+        auto f_0 = _mm256_add_ps(one, _mm256_add_ps(_mm256_mul_ps(c[0], r2_0), r3_0));
+
+        auto x_f0 = _mm256_mul_ps(x, f_0);
+        auto y_f0 = _mm256_mul_ps(y, f_0);
+
+        auto r4_0 = _mm256_mul_ps(c[3], _mm256_add_ps(r2_0, _mm256_mul_ps(two, _mm256_mul_ps(x_f0, x_f0))));
+        auto d_x0 = _mm256_add_ps(x_f0, _mm256_add_ps(_mm256_mul_ps(two, _mm256_mul_ps(c[2], _mm256_mul_ps(x_f0, y_f0))), r4_0));
+
+        auto r5_0 = _mm256_mul_ps(c[2], _mm256_add_ps(r2_0, _mm256_mul_ps(two, _mm256_mul_ps(y_f0, y_f0))));
+        auto d_y0 = _mm256_add_ps(y_f0, _mm256_add_ps(_mm256_mul_ps(two, _mm256_mul_ps(c[3], _mm256_mul_ps(x_f0, y_f0))), r4_0));
+
+        *distorted_x = d_x0;
+        *distorted_y = d_y0;
+    }
+
+    template<rs2_distortion dist>
+    inline void get_texture_map(const uint16_t * depth,
+        float depth_scale,
+        const unsigned int size,
+        const float * pre_compute_x, const float * pre_compute_y,
+        uint8_t * pixels_ptr_int,
+        const rs2_intrinsics& to,
+        const rs2_extrinsics& from_to_other)
+    {
+        auto scale = _mm256_set1_ps(depth_scale);
+
+        auto mapx = pre_compute_x;
+        auto mapy = pre_compute_y;
+
+        // The maps are only guaranteed to be 16-byte aligned, so all accesses are unaligned
+        auto res = reinterpret_cast<__m256i*>(pixels_ptr_int);
+
+        __m256 r[9];
+        __m256 t[3];
+
+        for (int i = 0; i < 9; ++i)
+        {
+            r[i] = _mm256_set1_ps(from_to_other.rotation[i]);
+        }
+        for (int i = 0; i < 3; ++i)
+        {
+            t[i] = _mm256_set1_ps(from_to_other.translation[i]);
+        }
+        auto zero = _mm256_set1_ps(0);
+        auto half = _mm256_set1_ps(0.5);
+        auto fx = _mm256_set1_ps(to.fx);
+        auto fy = _mm256_set1_ps(to.fy);
+        auto ppx = _mm256_set1_ps(to.ppx);
+        auto ppy = _mm256_set1_ps(to.ppy);
+
+        for (unsigned int i = 0; i < size; i += 8)
+        {
+            auto x = _mm256_loadu_ps(mapx + i);
+            auto y = _mm256_loadu_ps(mapy + i);
+
+            // Widen 8 depth pixels to 32 bits, and convert them to float
+            __m256i d = _mm256_cvtepu16_epi32(_mm_loadu_si128((__m128i const*)(depth + i)));
+            __m256 depth_f = _mm256_mul_ps(_mm256_cvtepi32_ps(d), scale);
+
+            auto px = _mm256_mul_ps(depth_f, x);
+            auto py = _mm256_mul_ps(depth_f, y);
+
+            auto p_x = _mm256_add_ps(_mm256_mul_ps(r[0], px), _mm256_add_ps(_mm256_mul_ps(r[3], py), _mm256_add_ps(_mm256_mul_ps(r[6], depth_f), t[0])));
+            auto p_y = _mm256_add_ps(_mm256_mul_ps(r[1], px), _mm256_add_ps(_mm256_mul_ps(r[4], py), _mm256_add_ps(_mm256_mul_ps(r[7], depth_f), t[1])));
+            auto p_z = _mm256_add_ps(_mm256_mul_ps(r[2], px), _mm256_add_ps(_mm256_mul_ps(r[5], py), _mm256_add_ps(_mm256_mul_ps(r[8], depth_f), t[2])));
+
+            p_x = _mm256_div_ps(p_x, p_z);
+            p_y = _mm256_div_ps(p_y, p_z);
+
+            distorte_x_y<dist>(p_x, p_y, &p_x, &p_y, to);
+
+            //zero the x and y if z is zero
+            auto cmp = _mm256_cmp_ps(depth_f, zero, _CMP_NEQ_UQ);
+            auto u_round = _mm256_and_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(p_x, fx), ppx), half), cmp);
+            auto v_round = _mm256_and_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(p_y, fy), ppy), half), cmp);
+
+            // Interleave to u0 v0 u1 v1 ... u7 v7. Unpacking works within 128-bit lanes, so the halves are regrouped after
+            auto uv_lo = _mm256_unpacklo_ps(u_round, v_round);  // u0 v0 u1 v1 | u4 v4 u5 v5
+            auto uv_hi = _mm256_unpackhi_ps(u_round, v_round);  // u2 v2 u3 v3 | u6 v6 u7 v7
+
+            _mm256_storeu_si256(&res[0], _mm256_cvtps_epi32(_mm256_permute2f128_ps(uv_lo, uv_hi, 0x20)));
+            _mm256_storeu_si256(&res[1], _mm256_cvtps_epi32(_mm256_permute2f128_ps(uv_lo, uv_hi, 0x31)));
+            res += 2;
+        }
+    }
+
+    void get_texture_map_avx(const uint16_t * depth,
+        float depth_scale,
+        const unsigned int size,
+        const float * pre_compute_x, const float * pre_compute_y,
+        uint8_t * pixels_ptr_int,
+        const rs2_intrinsics& to,
+        const rs2_extrinsics& from_to_other)
+    {
+        switch (to.model)
+        {
+        case RS2_DISTORTION_MODIFIED_BROWN_CONRADY:
+            get_texture_map<RS2_DISTORTION_MODIFIED_BROWN_CONRADY>(depth, depth_scale, size, pre_compute_x, pre_compute_y, pixels_ptr_int, to, from_to_other);
+            break;
+        default:
+            get_texture_map<RS2_DISTORTION_NONE>(depth, depth_scale, size, pre_compute_x, pre_compute_y, pixels_ptr_int, to, from_to_other);
+            break;
+        }
+    }
+}
+#endif
@@ -0,0 +1,22 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+// Compiled with -mavx2, like image_avx.h it only includes the C headers of the API, for no inline C++ code to be built for AVX
+#include <stdint.h>
+#include "../include/librealsense2/h/rs_sensor.h"
+
+namespace librealsense
+{
+#if defined(__SSSE3__) && (defined(__AVX2__) || defined(RS2_USE_AVX2_UNPACKERS))
+    // AVX2 version of get_texture_map_sse, with the same results. Projects 8 depth pixels per iteration
+    void get_texture_map_avx(const uint16_t * depth,
+        float depth_scale,
+        const unsigned int size,
+        const float * pre_compute_x, const float * pre_compute_y,
+        uint8_t * pixels_ptr_int,
+        const rs2_intrinsics& to,
+        const rs2_extrinsics& from_to_other);
+#endif
+}
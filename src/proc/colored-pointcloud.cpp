@@ -0,0 +1,179 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include "../include/librealsense2/rs.hpp"
+#include "../include/librealsense2/rsutil.h"
+
+#include "proc/synthetic-stream.h"
+#include "proc/colored-pointcloud.h"
+#include "option.h"
+#include "environment.h"
+#include "context.h"
+#include "projection.h"
+
+namespace librealsense
+{
+    namespace
+    {
+        bool is_depth(const rs2::frame& f)
+        {
+            return f.is<rs2::depth_frame>() && f.get_profile().format() == RS2_FORMAT_Z16;
+        }
+
+        bool is_color(const rs2::frame& f)
+        {
+            auto format = f.get_profile().format();
+            return f.get_profile().stream_type() == RS2_STREAM_COLOR && f.is<rs2::video_frame>() &&
+                (format == RS2_FORMAT_RGB8 || format == RS2_FORMAT_BGR8 || format == RS2_FORMAT_RGBA8 || format == RS2_FORMAT_BGRA8);
+        }
+    }
+
+    colored_pointcloud::colored_pointcloud()
+        : _depth_intrinsics{}, _color_intrinsics{}, _depth_to_color{}, _depth_units(0.f), _threads(1)
+    {
+        auto max_threads = std::max<int>(std::thread::hardware_concurrency(), 1);
+        auto processing_threads = std::make_shared<ptr_option<int>>(1, max_threads, 1, 1, &_threads,
+            "Number of threads, including the calling one, that compute the points in bands of depth rows");
+        register_option(RS2_OPTION_PROCESSING_THREADS, processing_threads);
+    }
+
+    bool colored_pointcloud::should_process(const rs2::frame& frame)
+    {
+        // Of the framesets of a depth and a color frame alone
+        auto set = frame.as<rs2::frameset>();
+        if (!set)
+            return false;
+
+        bool depth = false, color = false;
+        for (auto&& f : set)
+        {
+            depth = depth || is_depth(f);
+            color = color || is_color(f);
+        }
+        return depth && color;
+    }
+
+    void colored_pointcloud::inspect_frames(const rs2::depth_frame& depth, const rs2::video_frame& color)
+    {
+        if (depth.get_profile().get() != _depth_profile.get())
+        {
+            _depth_profile = depth.get_profile();
+            _depth_intrinsics = _depth_profile.as<rs2::video_stream_profile>().get_intrinsics();
+            if (_depth_intrinsics.width != depth.get_width() || _depth_intrinsics.height != depth.get_height())
+                throw invalid_value_exception("Colored point clouds are computed at the size of the depth intrinsics");
+            deprojection_maps(_depth_intrinsics, _map_x, _map_y);
+
+            auto sensor = ((frame_interface*)depth.get())->get_sensor().get();
+            _depth_units = sensor->get_option(RS2_OPTION_DEPTH_UNITS).query();
+            _color_profile = rs2::stream_profile();
+        }
+
+        if (color.get_profile().get() != _color_profile.get())
+        {
+            _color_profile = color.get_profile();
+            _color_intrinsics = _color_profile.as<rs2::video_stream_profile>().get_intrinsics();
+            if (!environment::get_instance().get_extrinsics_graph().try_fetch_extrinsics(
+                *(stream_interface*)(_depth_profile.get()->profile), *(stream_interface*)(_color_profile.get()->profile), &_depth_to_color))
+                throw wrong_api_call_sequence_exception("No extrinsics from the depth to the color stream");
+
+            // Of every depth pixel, in the coordinates of the color camera
+            _target_stream_profile = _depth_profile.clone(RS2_STREAM_DEPTH, _depth_profile.stream_index(), RS2_FORMAT_XYZ32F);
+            environment::get_instance().get_extrinsics_graph().register_same_extrinsics(
+                *(stream_interface*)(_color_profile.get()->profile), *(stream_interface*)(_target_stream_profile.get()->profile));
+        }
+    }
+
+    void colored_pointcloud::map_rows(const rs2::depth_frame& depth, const rs2::video_frame& color, size_t first, size_t last,
+        librealsense::points& output)
+    {
+        const auto width = _depth_intrinsics.width;
+        const auto depth_data = static_cast<const uint8_t*>(depth.get_data());
+        const auto depth_stride = depth.get_stride_in_bytes();
+        const auto color_data = static_cast<const uint8_t*>(color.get_data());
+        const auto color_stride = color.get_stride_in_bytes();
+        const auto color_bpp = color.get_bytes_per_pixel();
+        const auto bgr = color.get_profile().format() == RS2_FORMAT_BGR8 || color.get_profile().format() == RS2_FORMAT_BGRA8;
+        const auto& r = _depth_to_color.rotation;
+        const auto& t = _depth_to_color.translation;
+
+        std::vector<float2> pixels(width);
+        for (auto y = first; y < last; ++y)
+        {
+            auto row = reinterpret_cast<const uint16_t*>(depth_data + y * depth_stride);
+            auto map_x = _map_x.data() + y * width;
+            auto map_y = _map_y.data() + y * width;
+            auto vertices = output.get_vertices() + y * width;
+            auto tex = output.get_texture_coordinates() + y * width;
+            auto colors = output.get_colors() + y * width * 3;
+
+            // The pixels without depth stay at the origin, with no branch for the loop to be vectorized
+            for (int x = 0; x < width; ++x)
+            {
+                float z = row[x] * _depth_units;
+                float valid = row[x] ? 1.f : 0.f;
+                float px = map_x[x] * z, py = map_y[x] * z;
+                vertices[x] = { r[0] * px + r[3] * py + r[6] * z + t[0] * valid,
+                                r[1] * px + r[4] * py + r[7] * z + t[1] * valid,
+                                r[2] * px + r[5] * py + r[8] * z + t[2] * valid };
+            }
+            project_points(_color_intrinsics, vertices, pixels.data(), width);
+
+            for (int x = 0; x < width; ++x, colors += 3)
+            {
+                if (!row[x])
+                {
+                    tex[x] = { 0.f, 0.f };
+                    colors[0] = colors[1] = colors[2] = 0;
+                    continue;
+                }
+                tex[x] = { pixels[x].x / _color_intrinsics.width, pixels[x].y / _color_intrinsics.height };
+
+                // Of the nearest color pixel, the points behind the color camera having none
+                auto u = pixels[x].x + 0.5f, v = pixels[x].y + 0.5f;
+                if (!(vertices[x].z > 0 && u >= 0 && v >= 0 && u < _color_intrinsics.width && v < _color_intrinsics.height))
+                {
+                    colors[0] = colors[1] = colors[2] = 0;
+                    continue;
+                }
+                auto cx = static_cast<int>(u), cy = static_cast<int>(v);
+                auto texel = color_data + cy * color_stride + cx * color_bpp;
+                colors[0] = texel[bgr ? 2 : 0];
+                colors[1] = texel[1];
+                colors[2] = texel[bgr ? 0 : 2];
+            }
+        }
+    }
+
+    rs2::frame colored_pointcloud::process_frame(const rs2::frame_source& source, const rs2::frame& f)
+    {
+        auto set = f.as<rs2::frameset>();
+        rs2::depth_frame depth = rs2::frame();
+        rs2::video_frame color = rs2::frame();
+        for (auto&& frame : set)
+        {
+            if (!depth && is_depth(frame))
+                depth = frame;
+            if (!color && is_color(frame))
+                color = frame;
+        }
+        inspect_frames(depth, color);
+
+        auto count = size_t(_depth_intrinsics.width) * _depth_intrinsics.height;
+        auto profile = std::dynamic_pointer_cast<stream_profile_interface>(_target_stream_profile.get()->profile->shared_from_this());
+        auto res = _source_wrapper.allocate_points(profile, (frame_interface*)depth.get(), count, false, false, true, true);
+        if (!res)
+            return rs2::frame();
+        rs2::frame output((rs2_frame*)res);
+        auto points = (librealsense::points*)res;
+
+        if ((_workers ? int(_workers->size()) + 1 : 1) != _threads)
+            _workers = _threads > 1 ? std::make_shared<parallel_workers>(_threads - 1) : nullptr;
+
+        auto rows = [&](size_t first, size_t last) { map_rows(depth, color, first, last, *points); };
+        if (_workers)
+            _workers->run_bands(_depth_intrinsics.height, 1, rows);
+        else
+            rows(0, _depth_intrinsics.height);
+        return output;
+    }
+}
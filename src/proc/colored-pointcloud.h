@@ -0,0 +1,44 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "synthetic-stream.h"
+#include "concurrency.h"
+
+namespace librealsense
+{
+    // The point cloud of the depth frame of a frameset in the coordinates of its color camera, with the color of every point,
+    // taken from the raw depth in a single pass instead of aligning the depth to the color and computing the point cloud of
+    // the aligned depth. Every depth pixel is scaled from the deprojection maps of the depth intrinsics, transformed once and
+    // projected onto the color image, where its texture coordinates point and its nearest color is sampled. The output is a
+    // RS2_FORMAT_XYZ32F points frame of every depth pixel in order, with its colors, see rs2_get_frame_colors. The points
+    // without depth are zero, and so are the colors of the points that project out of the color image
+    class colored_pointcloud : public generic_processing_block
+    {
+    public:
+        colored_pointcloud();
+
+    protected:
+        bool should_process(const rs2::frame& frame) override;
+        rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
+
+    private:
+        // The intrinsics, extrinsics and maps of the frameset, kept for as long as its profiles are unchanged
+        void inspect_frames(const rs2::depth_frame& depth, const rs2::video_frame& color);
+        void map_rows(const rs2::depth_frame& depth, const rs2::video_frame& color, size_t first, size_t last, librealsense::points& output);
+
+        rs2::stream_profile                 _depth_profile;
+        rs2::stream_profile                 _color_profile;
+        rs2::stream_profile                 _target_stream_profile;
+        rs2_intrinsics                      _depth_intrinsics;
+        rs2_intrinsics                      _color_intrinsics;
+        rs2_extrinsics                      _depth_to_color;
+        float                               _depth_units;
+        std::vector<float>                  _map_x;
+        std::vector<float>                  _map_y;
+
+        int                                 _threads;
+        std::shared_ptr<parallel_workers>   _workers;
+    };
+}
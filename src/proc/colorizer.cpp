@@ -9,6 +9,8 @@
 #include "environment.h"
 #include "option.h"
 #include "colorizer.h"
+#include "image.h"
+#include "colorizer_avx.h"
 
 namespace librealsense
 {
@@ -124,7 +126,7 @@ namespace librealsense
         } };
 
     colorizer::colorizer()
-        : _min(0.f), _max(6.f), _equalize(true), _stream()
+        : _min(0.f), _max(6.f), _equalize(true), _stream(), _histogram(0x10000), _lut(0x10000)
     {
         _stream_filter.stream = RS2_STREAM_DEPTH;
         _stream_filter.format = RS2_FORMAT_Z16;
@@ -192,92 +194,149 @@ namespace librealsense
 
         auto hist_opt = std::make_shared<ptr_option<bool>>(false, true, true, true, &_equalize, "Perform histogram equalization");
         register_option(RS2_OPTION_HISTOGRAM_EQUALIZATION_ENABLED, hist_opt);
+
+        auto sampling_opt = std::make_shared<ptr_option<int>>(1, 16, 1, 1, &_histogram_sampling,
+            "Number of frames over which the histogram is recounted, one in that many depth rows every frame");
+        register_option(RS2_OPTION_HISTOGRAM_SAMPLING, sampling_opt);
     }
 
-    rs2::frame colorizer::process_frame(const rs2::frame_source& source, const rs2::frame& f)
+    void colorizer::update_histogram(const uint16_t* depth, int width, int height)
     {
-        if (!_stream || (f.get_profile().get() != _stream->get()))
-        {
-            _stream = std::make_shared<rs2::stream_profile>(f.get_profile().clone(RS2_STREAM_DEPTH, 0, RS2_FORMAT_RGB8));
-            environment::get_instance().get_extrinsics_graph().register_same_extrinsics(*_stream->get()->profile, *f.get_profile().get()->profile);
-        }
-        auto make_equalized_histogram = [this](const rs2::video_frame& depth, rs2::video_frame rgb)
+        const auto w = size_t(width);
+        const auto size = w * height;
+        if (_histogram_sampling > 1 && _counted_depth.size() == size)
         {
-            const auto max_depth = 0x10000;
-            static uint32_t histogram[max_depth];
-            memset(histogram, 0, sizeof(histogram));
-
-            const auto w = depth.get_width(), h = depth.get_height();
-            const auto depth_data = reinterpret_cast<const uint16_t*>(depth.get_data());
-            auto rgb_data = reinterpret_cast<uint8_t*>(const_cast<void *>(rgb.get_data()));
-
-            for (auto i = 0; i < w*h; ++i) ++histogram[depth_data[i]];
-            for (auto i = 2; i < max_depth; ++i) histogram[i] += histogram[i - 1]; // Build a cumulative histogram for the indices in [1,0xFFFF]
-            auto cm = _maps[_map_index];
-            for (auto i = 0; i < w*h; ++i)
+            // Only the pixels that changed since they were last counted move between bins
+            for (auto y = _sampled_row; y < height; y += _histogram_sampling)
             {
-                auto d = depth_data[i];
-
-                if (d)
-                {
-                    auto f = histogram[d] / (float)histogram[0xFFFF]; // 0-255 based on histogram location
-
-                    auto c = cm->get(f);
-                    rgb_data[i * 3 + 0] = (uint8_t)c.x;
-                    rgb_data[i * 3 + 1] = (uint8_t)c.y;
-                    rgb_data[i * 3 + 2] = (uint8_t)c.z;
-                }
-                else
+                auto row = depth + y * w;
+                auto counted = _counted_depth.data() + y * w;
+                for (size_t x = 0; x < w; ++x)
                 {
-                    rgb_data[i * 3 + 0] = 0;
-                    rgb_data[i * 3 + 1] = 0;
-                    rgb_data[i * 3 + 2] = 0;
+                    if (row[x] != counted[x])
+                    {
+                        --_histogram[counted[x]];
+                        ++_histogram[row[x]];
+                        counted[x] = row[x];
+                    }
                 }
             }
-        };
+            _sampled_row = (_sampled_row + 1) % _histogram_sampling;
+            return;
+        }
+
+        memset(_histogram.data(), 0, _histogram.size() * sizeof(uint32_t));
+        for (size_t i = 0; i < size; ++i) ++_histogram[depth[i]];
 
-        auto make_value_cropped_frame = [this](const rs2::video_frame& depth, rs2::video_frame rgb)
+        if (_histogram_sampling > 1)
         {
-            const auto max_depth = 0x10000;
-            const auto w = depth.get_width(), h = depth.get_height();
-            const auto depth_data = reinterpret_cast<const uint16_t*>(depth.get_data());
-            auto rgb_data = reinterpret_cast<uint8_t*>(const_cast<void *>(rgb.get_data()));
+            _counted_depth.assign(depth, depth + size);
+            _sampled_row = 0;
+        }
+        else
+            _counted_depth.clear();
+    }
 
-            auto fi = (frame_interface*)depth.get();
-            auto df = dynamic_cast<librealsense::depth_frame*>(fi);
-            auto depth_units = df->get_units();
+    void colorizer::make_equalized_lut()
+    {
+        const auto max_depth = 0x10000;
+        auto cm = _maps[_map_index];
+
+        // Cumulative histogram for the indices in [1,0xFFFF]
+        uint32_t total = 0;
+        for (auto i = 1; i < max_depth; ++i) total += _histogram[i];
 
-            for (auto i = 0; i < w*h; ++i)
+        _lut[0] = 0;
+        uint32_t cumulative = 0;
+        for (auto i = 1; i < max_depth; ++i)
+        {
+            cumulative += _histogram[i];
+            if (!total)
             {
-                auto d = depth_data[i];
+                _lut[i] = 0;
+                continue;
+            }
 
-                if (d)
-                {
-                    auto f = (d * depth_units - _min) / (_max - _min);
+            auto f = cumulative / (float)total; // 0-255 based on histogram location
+            auto c = cm->get(f);
+            _lut[i] = uint32_t((uint8_t)c.x) | uint32_t((uint8_t)c.y) << 8 | uint32_t((uint8_t)c.z) << 16;
+        }
+        _lut_map_index = -1;
+    }
 
-                    auto c = _maps[_map_index]->get(f);
-                    rgb_data[i * 3 + 0] = (uint8_t)c.x;
-                    rgb_data[i * 3 + 1] = (uint8_t)c.y;
-                    rgb_data[i * 3 + 2] = (uint8_t)c.z;
-                }
-                else
-                {
-                    rgb_data[i * 3 + 0] = 0;
-                    rgb_data[i * 3 + 1] = 0;
-                    rgb_data[i * 3 + 2] = 0;
-                }
-            }
-        };
+    void colorizer::make_value_cropped_lut(float depth_units)
+    {
+        if (_lut_map_index == _map_index && _lut_min == _min && _lut_max == _max && _lut_depth_units == depth_units)
+            return;
+
+        const auto max_depth = 0x10000;
+        auto cm = _maps[_map_index];
+
+        _lut[0] = 0;
+        for (auto i = 1; i < max_depth; ++i)
+        {
+            auto f = (i * depth_units - _min) / (_max - _min);
+            auto c = cm->get(f);
+            _lut[i] = uint32_t((uint8_t)c.x) | uint32_t((uint8_t)c.y) << 8 | uint32_t((uint8_t)c.z) << 16;
+        }
+
+        _lut_map_index = _map_index;
+        _lut_min = _min;
+        _lut_max = _max;
+        _lut_depth_units = depth_units;
+    }
+
+    void colorizer::colorize(const uint16_t* depth, uint8_t* rgb, size_t size) const
+    {
+        auto lut = _lut.data();
+        size_t i = 0;
+#if defined(__SSSE3__) && (defined(__AVX2__) || defined(RS2_USE_AVX2_UNPACKERS))
+        if (get_simd_level() == simd_level::avx2)
+            i = colorize_avx(depth, lut, rgb, size);
+#endif
+        for (; i < size; ++i)
+        {
+            auto c = lut[depth[i]];
+            rgb[i * 3 + 0] = (uint8_t)c;
+            rgb[i * 3 + 1] = (uint8_t)(c >> 8);
+            rgb[i * 3 + 2] = (uint8_t)(c >> 16);
+        }
+    }
+
+    rs2::frame colorizer::process_frame(const rs2::frame_source& source, const rs2::frame& f)
+    {
+        if (!_stream || (f.get_profile().get() != _stream->get()))
+        {
+            _stream = std::make_shared<rs2::stream_profile>(f.get_profile().clone(RS2_STREAM_DEPTH, 0, RS2_FORMAT_RGB8));
+            environment::get_instance().get_extrinsics_graph().register_same_extrinsics(*_stream->get()->profile, *f.get_profile().get()->profile);
+        }
         rs2::frame ret;
 
         auto vf = f.as<rs2::video_frame>();
         //rs2_extension ext = f.is<rs2::disparity_frame>() ? RS2_EXTENSION_DISPARITY_FRAME : RS2_EXTENSION_DEPTH_FRAME;
         ret = source.allocate_video_frame(*_stream, f, 3, vf.get_width(), vf.get_height(), vf.get_width() * 3, RS2_EXTENSION_VIDEO_FRAME);
 
+        const auto size = size_t(vf.get_width()) * vf.get_height();
+        const auto depth_data = reinterpret_cast<const uint16_t*>(vf.get_data());
+        auto rgb_data = reinterpret_cast<uint8_t*>(const_cast<void *>(ret.get_data()));
+
         if (_equalize)
-            make_equalized_histogram(f, ret);
-        else 
-            make_value_cropped_frame(f, ret);
+        {
+            update_histogram(depth_data, vf.get_width(), vf.get_height());
+            make_equalized_lut();
+        }
+        else
+        {
+            // The histogram no longer follows the depth
+            _counted_depth.clear();
+
+            auto fi = (frame_interface*)f.get();
+            auto df = dynamic_cast<librealsense::depth_frame*>(fi);
+            make_value_cropped_lut(df->get_units());
+        }
+        auto backend = environment::get_instance().get_compute_backend();
+        if (!backend || !backend->colorize(depth_data, _lut.data(), _lut.size(), rgb_data, size))
+            colorize(depth_data, rgb_data, size);
 
         return ret;
     }
@@ -102,11 +102,27 @@ namespace librealsense {
         rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
 
     private:
+        void update_histogram(const uint16_t* depth, int width, int height);
+        void make_equalized_lut();
+        void make_value_cropped_lut(float depth_units);
+        void colorize(const uint16_t* depth, uint8_t* rgb, size_t size) const;
+
         float _min, _max;
         bool _equalize;
         std::vector<color_map*> _maps;
         int _map_index = 0;
         int _preset = 0;
         std::shared_ptr<rs2::stream_profile> _stream;
+
+        // Every frame recounts one in _histogram_sampling depth rows, so the histogram follows the depth over that many frames
+        int _histogram_sampling = 1;
+        int _sampled_row = 0;
+        std::vector<uint32_t> _histogram;       // Count of every depth value in _counted_depth
+        std::vector<uint16_t> _counted_depth;   // Depth the histogram was counted on, kept only while sampling
+
+        // RGB of every depth value, packed as R | G << 8 | B << 16
+        std::vector<uint32_t> _lut;
+        int _lut_map_index = -1;                // Map of the value cropped table, -1 when the table is not value cropped
+        float _lut_min = 0.f, _lut_max = 0.f, _lut_depth_units = 0.f;
     };
 }
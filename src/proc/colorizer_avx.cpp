@@ -0,0 +1,30 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include "colorizer_avx.h"
+
+#if defined(__SSSE3__) && (defined(__AVX2__) || defined(RS2_USE_AVX2_UNPACKERS))
+#include <immintrin.h>
+
+namespace librealsense
+{
+    size_t colorize_avx(const uint16_t* depth, const uint32_t* lut, uint8_t* rgb, size_t count)
+    {
+        // Drops the fourth byte of every entry, leaving 12 bytes of RGB at the bottom of each lane
+        const __m256i pack = _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+                                              0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+
+        // The stores of every iteration reach 4 bytes past its 24, which the last 2 pixels are left to cover
+        size_t i = 0;
+        for (; i + 10 <= count; i += 8)
+        {
+            auto d = _mm256_cvtepu16_epi32(_mm_loadu_si128((__m128i const*)(depth + i)));
+            auto c = _mm256_shuffle_epi8(_mm256_i32gather_epi32(reinterpret_cast<const int*>(lut), d, 4), pack);
+
+            _mm_storeu_si128((__m128i*)(rgb + i * 3), _mm256_castsi256_si128(c));
+            _mm_storeu_si128((__m128i*)(rgb + i * 3 + 12), _mm256_extracti128_si256(c, 1));
+        }
+        return i;
+    }
+}
+#endif
@@ -0,0 +1,17 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+// Compiled with -mavx2, like image_avx.h it only includes the C headers of the API, for no inline C++ code to be built for AVX
+#include <stddef.h>
+#include <stdint.h>
+
+namespace librealsense
+{
+#if defined(__SSSE3__) && (defined(__AVX2__) || defined(RS2_USE_AVX2_UNPACKERS))
+    // Colors 8 depth pixels per iteration by gathering them from the table of every depth value, packed as R | G << 8 | B << 16
+    // Returns how many of the count pixels were colored, leaving the remainder to the generic code
+    size_t colorize_avx(const uint16_t* depth, const uint32_t* lut, uint8_t* rgb, size_t count);
+#endif
+}
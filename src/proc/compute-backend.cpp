@@ -0,0 +1,38 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include "proc/compute-backend.h"
+#include "types.h"
+
+#ifdef RS2_USE_OPENCL
+#include "../opencl/opencl-backend.h"
+#endif
+
+namespace librealsense
+{
+    bool is_compute_backend_available(rs2_compute_backend type)
+    {
+        switch (type)
+        {
+        case RS2_COMPUTE_BACKEND_CPU: return true;
+#ifdef RS2_USE_OPENCL
+        case RS2_COMPUTE_BACKEND_OPENCL: return opencl_backend::is_available();
+#endif
+        default: return false;
+        }
+    }
+
+    std::shared_ptr<compute_backend> make_compute_backend(rs2_compute_backend type)
+    {
+        if (!is_compute_backend_available(type))
+            throw not_implemented_exception(to_string() << "Compute backend " << type << " is not available on this system");
+
+        switch (type)
+        {
+#ifdef RS2_USE_OPENCL
+        case RS2_COMPUTE_BACKEND_OPENCL: return std::make_shared<opencl_backend>();
+#endif
+        default: return nullptr;
+        }
+    }
+}
@@ -0,0 +1,51 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "../include/librealsense2/h/rs_types.h"
+#include "../include/librealsense2/h/rs_context.h"
+#include "../include/librealsense2/h/rs_sensor.h"
+
+#include <memory>
+
+namespace librealsense
+{
+    // Runs the bandwidth-heavy kernels of the processing blocks on another compute device.
+    // Every kernel produces the same result as the CPU code of its block, and returns false when it cannot run,
+    // for the block to fall back to the CPU. Host buffers are passed in and out, and kernels may be called from any thread
+    class compute_backend
+    {
+    public:
+        virtual rs2_compute_backend get_type() const = 0;
+
+        // YUY2 into Y8, Y16, RGB8, RGBA8, BGR8 or BGRA8, for count pixels
+        virtual bool unpack_yuy2(rs2_format format, void* dst, const void* src, size_t count) = 0;
+
+        // Median of the non-zero depth of every scale x scale block for scales 2 and 3, and their mean beyond,
+        // into an output of padded_width x padded_height with the padding set to zero
+        virtual bool decimate_depth(const uint16_t* src, uint16_t* dst, int width_in, int scale,
+            int real_width, int real_height, int padded_width, int padded_height) = 0;
+
+        // Maps every depth value through the lut of the colorizer, whose members pack R | G << 8 | B << 16
+        virtual bool colorize(const uint16_t* depth, const uint32_t* lut, size_t lut_size, uint8_t* rgb, size_t count) = 0;
+
+        // XYZ of every depth pixel, as rs2_deproject_pixel_to_point
+        virtual bool deproject_depth(float* points, const rs2_intrinsics& depth_intrin, const uint16_t* depth, float depth_scale) = 0;
+
+        // As align_z_to_other and align_other_to_z, into zero-initialized outputs
+        virtual bool align_depth_to_other(uint16_t* aligned_out, const uint16_t* depth, float depth_scale,
+            const rs2_intrinsics& depth_intrin, const rs2_extrinsics& depth_to_other, const rs2_intrinsics& other_intrin) = 0;
+        virtual bool align_other_to_depth(uint8_t* aligned_out, const uint16_t* depth, float depth_scale,
+            const rs2_intrinsics& depth_intrin, const rs2_extrinsics& depth_to_other, const rs2_intrinsics& other_intrin,
+            const uint8_t* other, int other_bytes_per_pixel) = 0;
+
+        virtual ~compute_backend() = default;
+    };
+
+    // Whether the backend was built in and found a device to run on
+    bool is_compute_backend_available(rs2_compute_backend type);
+
+    // nullptr for the CPU, throws when the backend is not available
+    std::shared_ptr<compute_backend> make_compute_backend(rs2_compute_backend type);
+}
@@ -10,8 +10,13 @@
 #include "context.h"
 #include "proc/synthetic-stream.h"
 #include "proc/decimation-filter.h"
+#include "proc/depth-stats.h"
 #include "environment.h"
 
+#ifdef __SSSE3__
+#include <tmmintrin.h> // For SSSE3 intrinsics
+#endif
+
 #define PIX_SORT(a,b) { if ((a)>(b)) PIX_SWAP((a),(b)); }
 #define PIX_SWAP(a,b) { pixelvalue temp=(a);(a)=(b);(b)=temp; }
 #define PIX_MIN(a,b) ((a)>(b)) ? (b) : (a)
@@ -192,6 +197,135 @@ namespace librealsense
         return PIX_MIN(p[4], p[2]);
     }
 
+#ifdef __SSSE3__
+    // Sorts 8 blocks side by side with signed 16-bit min/max. Every value is mapped to (value - 1) ^ 0x8000,
+    // which keeps the order of valid values and moves the invalid zeros past all of them
+    static inline __m128i to_key(__m128i v)
+    {
+        return _mm_xor_si128(_mm_sub_epi16(v, _mm_set1_epi16(1)), _mm_set1_epi16(static_cast<short>(0x8000)));
+    }
+
+    static inline __m128i from_key(__m128i k)
+    {
+        return _mm_add_epi16(_mm_xor_si128(k, _mm_set1_epi16(static_cast<short>(0x8000))), _mm_set1_epi16(1));
+    }
+
+    static inline void sort_keys(__m128i& a, __m128i& b)
+    {
+        __m128i t = _mm_min_epi16(a, b);
+        b = _mm_max_epi16(a, b);
+        a = t;
+    }
+
+    static inline __m128i select(__m128i condition, __m128i a, __m128i b)
+    {
+        return _mm_or_si128(_mm_and_si128(condition, a), _mm_andnot_si128(condition, b));
+    }
+
+    // Like the scalar code, the result is the valid value one below the middle, and zero when there are none.
+    // Both return the number of output pixels processed, the remainder is left to the scalar code
+    static size_t median_2x2_simd(const uint16_t * row0, const uint16_t * row1, uint16_t * out, size_t count)
+    {
+        const __m128i even = _mm_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1);
+        const __m128i odd = _mm_setr_epi8(2, 3, 6, 7, 10, 11, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1);
+        const __m128i zero = _mm_setzero_si128();
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i p[4];
+            const uint16_t * rows[2] = { row0 + i * 2, row1 + i * 2 };
+            for (int n = 0; n < 2; n++)
+            {
+                __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(rows[n]));
+                __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(rows[n] + 8));
+                p[n * 2] = _mm_unpacklo_epi64(_mm_shuffle_epi8(a, even), _mm_shuffle_epi8(b, even));
+                p[n * 2 + 1] = _mm_unpacklo_epi64(_mm_shuffle_epi8(a, odd), _mm_shuffle_epi8(b, odd));
+            }
+
+            // Every zero adds -1
+            __m128i zeros = zero;
+            for (int n = 0; n < 4; n++)
+            {
+                zeros = _mm_add_epi16(zeros, _mm_cmpeq_epi16(p[n], zero));
+                p[n] = to_key(p[n]);
+            }
+
+            // The two smallest keys
+            sort_keys(p[0], p[1]);
+            sort_keys(p[2], p[3]);
+            sort_keys(p[0], p[2]);
+            sort_keys(p[1], p[3]);
+            __m128i second = _mm_min_epi16(p[1], p[2]);
+
+            // With 3 or 4 valid values, pick the second smallest
+            __m128i result = select(_mm_cmpgt_epi16(zeros, _mm_set1_epi16(-2)), second, p[0]);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), from_key(result));
+        }
+        return i;
+    }
+
+    static size_t median_3x3_simd(const uint16_t * row0, const uint16_t * row1, const uint16_t * row2, uint16_t * out, size_t count)
+    {
+        // Gathers the pixels 3k + j of 24 consecutive ones into lane k, out of their three registers
+        __m128i gather[3][3];
+        for (int j = 0; j < 3; j++)
+        {
+            for (int s = 0; s < 3; s++)
+            {
+                alignas(16) int8_t mask[16];
+                for (int k = 0; k < 8; k++)
+                {
+                    int p = 3 * k + j;
+                    mask[k * 2] = (p / 8 == s) ? static_cast<int8_t>((p % 8) * 2) : -1;
+                    mask[k * 2 + 1] = (p / 8 == s) ? static_cast<int8_t>((p % 8) * 2 + 1) : -1;
+                }
+                gather[j][s] = _mm_load_si128(reinterpret_cast<const __m128i *>(mask));
+            }
+        }
+        const __m128i zero = _mm_setzero_si128();
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i p[9];
+            const uint16_t * rows[3] = { row0 + i * 3, row1 + i * 3, row2 + i * 3 };
+            for (int n = 0; n < 3; n++)
+            {
+                __m128i src[3];
+                for (int s = 0; s < 3; s++)
+                    src[s] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(rows[n] + s * 8));
+
+                for (int j = 0; j < 3; j++)
+                    p[n * 3 + j] = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(src[0], gather[j][0]), _mm_shuffle_epi8(src[1], gather[j][1])),
+                                                _mm_shuffle_epi8(src[2], gather[j][2]));
+            }
+
+            // Every zero adds -1
+            __m128i zeros = zero;
+            for (int n = 0; n < 9; n++)
+            {
+                zeros = _mm_add_epi16(zeros, _mm_cmpeq_epi16(p[n], zero));
+                p[n] = to_key(p[n]);
+            }
+
+            // Odd-even transposition sort
+            for (int round = 0; round < 9; round++)
+                for (int n = round & 1; n + 1 < 9; n += 2)
+                    sort_keys(p[n], p[n + 1]);
+
+            // With v valid values, pick the sorted key (v - 1) / 2
+            __m128i result = p[0];
+            result = select(_mm_cmpgt_epi16(zeros, _mm_set1_epi16(-7)), p[1], result);
+            result = select(_mm_cmpgt_epi16(zeros, _mm_set1_epi16(-5)), p[2], result);
+            result = select(_mm_cmpgt_epi16(zeros, _mm_set1_epi16(-3)), p[3], result);
+            result = select(_mm_cmpgt_epi16(zeros, _mm_set1_epi16(-1)), p[4], result);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), from_key(result));
+        }
+        return i;
+    }
+#endif
+
     const uint8_t decimation_min_val = 1;
     const uint8_t decimation_max_val = 8;    // Decimation levels according to the reference design
     const uint8_t decimation_default_val = 2;
@@ -207,7 +341,10 @@ namespace librealsense
         _padded_width(0),
         _padded_height(0),
         _recalc_profile(false),
-        _options_changed(false)
+        _options_changed(false),
+        _threads(1),
+        _depth_statistics(0),
+        _histogram_range(depth_histogram_range_default)
     {
         _stream_filter.stream = RS2_STREAM_DEPTH;
         _stream_filter.format = RS2_FORMAT_Z16;
@@ -236,6 +373,25 @@ namespace librealsense
         });
 
         register_option(RS2_OPTION_FILTER_MAGNITUDE, decimation_control);
+
+        auto max_threads = std::max<int>(std::thread::hardware_concurrency(), 1);
+        auto processing_threads = std::make_shared<ptr_option<int>>(1, max_threads, 1, 1, &_threads,
+            "Number of threads, including the calling one, that decimate each depth frame in bands of rows");
+        register_option(RS2_OPTION_PROCESSING_THREADS, processing_threads);
+
+        auto depth_statistics = std::make_shared<ptr_option<uint8_t>>(0, 1, 1, 0, &_depth_statistics,
+            "Attach the statistics of the decimated depth to its frames as metadata, computed as the frames are decimated");
+        depth_statistics->set_description(0.f, "Off");
+        depth_statistics->set_description(1.f, "On");
+        register_option(RS2_OPTION_DEPTH_STATISTICS, depth_statistics);
+
+        auto histogram_range = std::make_shared<ptr_option<float>>(
+            depth_histogram_range_min,
+            depth_histogram_range_max,
+            depth_histogram_range_step,
+            depth_histogram_range_default,
+            &_histogram_range, "Depth, in meters, the bins of the histogram of the depth statistics span");
+        register_option(RS2_OPTION_DEPTH_HISTOGRAM_RANGE, histogram_range);
     }
 
     rs2::frame decimation_filter::process_frame(const rs2::frame_source& source, const rs2::frame& f)
@@ -257,9 +413,31 @@ namespace librealsense
         {
             if (format == RS2_FORMAT_Z16)
             {
-                decimate_depth(static_cast<const uint16_t*>(src.get_data()),
-                    static_cast<uint16_t*>(const_cast<void*>(tgt.get_data())),
-                    src.get_width(), src.get_height(), this->_patch_size);
+                auto depth_in = static_cast<const uint16_t*>(src.get_data());
+                auto depth_out = static_cast<uint16_t*>(const_cast<void*>(tgt.get_data()));
+                uint16_t range = _depth_statistics ? get_histogram_range(f, _histogram_range) : 0;
+                depth_statistics stats;
+
+                auto backend = environment::get_instance().get_compute_backend();
+                if (backend && backend->decimate_depth(depth_in, depth_out, src.get_width(), _patch_size,
+                    int(_real_width), int(_real_height), int(_padded_width), int(_padded_height)))
+                {
+                    // Of the frame the backend decimated, in a pass of their own
+                    if (range)
+                        accumulate_depth_statistics(depth_out, _real_width, _real_height, _padded_width, range, stats);
+                }
+                else
+                {
+                    if (_threads <= 1)
+                        _workers.reset();
+                    else if (!_workers || int(_workers->size()) != _threads - 1)
+                        _workers = std::make_shared<parallel_workers>(_threads - 1);
+
+                    decimate_depth(depth_in, depth_out, src.get_width(), src.get_height(), this->_patch_size, range, &stats);
+                }
+
+                if (range)
+                    dynamic_cast<frame*>((frame_interface*)tgt.get())->additional_data.depth_stats = stats;
             }
             else
             {
@@ -352,25 +530,66 @@ namespace librealsense
     }
 
     void decimation_filter::decimate_depth(const uint16_t * frame_data_in, uint16_t * frame_data_out,
-        size_t width_in, size_t height_in, size_t scale)
+        size_t width_in, size_t height_in, size_t scale, uint16_t histogram_range, depth_statistics* stats)
+    {
+        // Output rows only depend on their own block of input rows, their statistics being taken while they are in the cache
+        std::mutex stats_mutex;
+        auto rows = [&](size_t begin, size_t end)
+        {
+            decimate_depth_rows(frame_data_in, frame_data_out, width_in, scale, begin, end);
+            if (histogram_range && stats)
+            {
+                depth_statistics band;
+                accumulate_depth_statistics(frame_data_out + begin * _padded_width, _real_width, end - begin, _padded_width, histogram_range, band);
+                std::lock_guard<std::mutex> lock(stats_mutex);
+                stats->merge(band);
+            }
+        };
+
+        if (_workers)
+            _workers->run_bands(_real_height, 1, rows);
+        else
+            rows(0, _real_height);
+
+        // Fill-in the padded rows with zeros
+        frame_data_out += _real_height * _padded_width;
+        for (auto v = _real_height; v < _padded_height; ++v)
+        {
+            for (auto u = 0; u < _padded_width; ++u)
+                *frame_data_out++ = 0;
+        }
+    }
+
+    void decimation_filter::decimate_depth_rows(const uint16_t * frame_data_in, uint16_t * frame_data_out,
+        size_t width_in, size_t scale, size_t begin, size_t end)
     {
         // Use median filtering
         std::vector<uint16_t> working_kernel(_kernel_size);
         auto wk_begin = working_kernel.data();
         auto wk_itr = wk_begin;
         std::vector<uint16_t*> pixel_raws(scale);
-        uint16_t* block_start = const_cast<uint16_t*>(frame_data_in);
+        uint16_t* block_start = const_cast<uint16_t*>(frame_data_in) + begin * width_in * scale;
+        frame_data_out += begin * _padded_width;
 
         if (scale == 2 || scale == 3)
         {
-            for (int j = 0; j < _real_height; j++)
+            for (size_t j = begin; j < end; j++)
             {
                 uint16_t *p{};
                 // Mark the beginning of each of the N lines that the filter will run upon
                 for (size_t i = 0; i < pixel_raws.size(); i++)
                     pixel_raws[i] = block_start + (width_in*i);
 
-                for (size_t i = 0, chunk_offset = 0; i < _real_width; i++)
+                size_t i = 0;
+#ifdef __SSSE3__
+                if (scale == 2)
+                    i = median_2x2_simd(pixel_raws[0], pixel_raws[1], frame_data_out, _real_width);
+                else
+                    i = median_3x3_simd(pixel_raws[0], pixel_raws[1], pixel_raws[2], frame_data_out, _real_width);
+                frame_data_out += i;
+#endif
+
+                for (size_t chunk_offset = i * scale; i < _real_width; i++)
                 {
                     wk_itr = wk_begin;
                     // extract data the kernel to process
@@ -435,7 +654,7 @@ namespace librealsense
         }
         else
         {
-            for (int j = 0; j < _real_height; j++)
+            for (size_t j = begin; j < end; j++)
             {
                 uint16_t *p{};
                 // Mark the beginning of each of the N lines that the filter will run upon
@@ -473,13 +692,6 @@ namespace librealsense
                 block_start += width_in * scale;
             }
         }
-
-        // Fill-in the padded rows with zeros
-        for (auto v = _real_height; v < _padded_height; ++v)
-        {
-            for (auto u = 0; u < _padded_width; ++u)
-                *frame_data_out++ = 0;
-        }
     }
 
     void decimation_filter::decimate_others(rs2_format format, const void * frame_data_in, void * frame_data_out,
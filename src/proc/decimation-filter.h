@@ -5,9 +5,11 @@
 
 #include "../include/librealsense2/hpp/rs_frame.hpp"
 #include "../include/librealsense2/hpp/rs_processing.hpp"
+#include "concurrency.h"
 
 namespace librealsense
 {
+    struct depth_statistics;
 
     class decimation_filter : public stream_filter_processing_block
     {
@@ -17,14 +19,21 @@ namespace librealsense
     protected:
         rs2::frame prepare_target_frame(const rs2::frame& f, const rs2::frame_source& source, rs2_extension tgt_type);
 
+        // With a histogram range, the statistics of the output are accumulated into stats as it is written
         void decimate_depth(const uint16_t * frame_data_in, uint16_t * frame_data_out,
-            size_t width_in, size_t height_in, size_t scale);
+            size_t width_in, size_t height_in, size_t scale, uint16_t histogram_range = 0, depth_statistics* stats = nullptr);
+
+        // Decimate the output rows in [begin, end)
+        void decimate_depth_rows(const uint16_t * frame_data_in, uint16_t * frame_data_out,
+            size_t width_in, size_t scale, size_t begin, size_t end);
 
         void decimate_others(rs2_format format, const void * frame_data_in, void * frame_data_out,
             size_t width_in, size_t height_in, size_t scale);
         rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
 
     private:
+        friend class depth_post_processing;
+
         void    update_output_profile(const rs2::frame& f);
 
         uint8_t                 _decimation_factor;
@@ -40,5 +49,9 @@ namespace librealsense
         uint16_t                _padded_height;
         bool                    _recalc_profile;
         bool                    _options_changed;   // Tracking changes imposed by user
+        int                     _threads;
+        uint8_t                 _depth_statistics;  // Whether the statistics of the output depth are attached to it
+        float                   _histogram_range;
+        std::shared_ptr<parallel_workers> _workers;
     };
 }
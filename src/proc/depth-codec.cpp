@@ -0,0 +1,303 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include "../include/librealsense2/hpp/rs_sensor.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+
+#include "context.h"
+#include "proc/synthetic-stream.h"
+#include "proc/depth-codec.h"
+#include "environment.h"
+
+#ifdef __SSSE3__
+#include <tmmintrin.h> // For SSSE3 intrinsics
+#endif
+
+namespace librealsense
+{
+    namespace
+    {
+        class nibble_writer
+        {
+        public:
+            explicit nibble_writer(uint8_t* out) : _begin(out), _out(out) {}
+
+            // 3 bits per nibble, the high bit telling whether more follow
+            void write(uint32_t value)
+            {
+                if (value < 8)
+                {
+                    push(value, 1);
+                    return;
+                }
+
+                uint64_t code = 0;
+                int nibbles = 0;
+                do
+                {
+                    uint64_t nibble = value & 7;
+                    value >>= 3;
+                    if (value)
+                        nibble |= 8;
+                    code = (code << 4) | nibble;
+                    ++nibbles;
+                } while (value);
+
+                if (nibbles > 8)
+                {
+                    push(static_cast<uint32_t>(code >> 32), nibbles - 8);
+                    nibbles = 8;
+                }
+                push(static_cast<uint32_t>(code), nibbles);
+            }
+
+            size_t finish()
+            {
+                if (_nibbles)
+                {
+                    auto word = static_cast<uint32_t>(_pending << (4 * (8 - _nibbles)));
+                    memcpy(_out, &word, sizeof(word));
+                    _out += sizeof(word);
+                    _nibbles = 0;
+                }
+                return _out - _begin;
+            }
+
+        private:
+            // Appends the up to 8 nibbles of code, and writes out the words they complete
+            void push(uint32_t code, int nibbles)
+            {
+                _pending = (_pending << (4 * nibbles)) | code;
+                _nibbles += nibbles;
+                if (_nibbles >= 8)
+                {
+                    _nibbles -= 8;
+                    auto word = static_cast<uint32_t>(_pending >> (4 * _nibbles));
+                    memcpy(_out, &word, sizeof(word));
+                    _out += sizeof(word);
+                }
+            }
+
+            uint8_t* _begin;
+            uint8_t* _out;
+            uint64_t _pending = 0;
+            int _nibbles = 0;
+        };
+
+        class nibble_reader
+        {
+        public:
+            nibble_reader(const uint8_t* in, size_t size) : _in(in), _end(in + size / sizeof(uint32_t) * sizeof(uint32_t)) {}
+
+            bool read(uint32_t& value)
+            {
+                value = 0;
+                for (int shift = 0; shift <= 30; shift += 3)
+                {
+                    if (!_nibbles)
+                    {
+                        if (_in == _end)
+                            return false;
+                        memcpy(&_word, _in, sizeof(_word));
+                        _in += sizeof(_word);
+                        _nibbles = 8;
+                    }
+                    auto nibble = _word >> 28;
+                    _word <<= 4;
+                    --_nibbles;
+
+                    value |= (nibble & 7) << shift;
+                    if (!(nibble & 8))
+                        return true;
+                }
+                return false;
+            }
+
+        private:
+            const uint8_t* _in;
+            const uint8_t* _end;
+            uint32_t _word = 0;
+            int _nibbles = 0;
+        };
+
+        template<bool Zeros>
+        size_t count_run(const uint16_t* p, const uint16_t* end)
+        {
+            auto start = p;
+#ifdef __SSSE3__
+            const __m128i zero = _mm_setzero_si128();
+            while (p + 8 <= end)
+            {
+                auto mask = _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_loadu_si128((__m128i const*)p), zero));
+                if (mask != (Zeros ? 0xFFFF : 0))
+                    break;
+                p += 8;
+            }
+#endif
+            while (p < end && (*p == 0) == Zeros)
+                ++p;
+            return p - start;
+        }
+    }
+
+    size_t rvl_max_encoded_size(size_t count)
+    {
+        // 6 nibbles for the 17 bits of a difference, and less than 2.5 for the runs, per pixel
+        return ((9 * count + 16) / 8 + 1) * sizeof(uint32_t);
+    }
+
+    size_t rvl_encode(const uint16_t* depth, size_t count, uint8_t* encoded)
+    {
+        nibble_writer w(encoded);
+        auto end = depth + count;
+        int previous = 0;
+        while (depth < end)
+        {
+            auto zeros = count_run<true>(depth, end);
+            depth += zeros;
+            w.write(static_cast<uint32_t>(zeros));
+
+            auto nonzeros = count_run<false>(depth, end);
+            w.write(static_cast<uint32_t>(nonzeros));
+            for (auto run_end = depth + nonzeros; depth < run_end; ++depth)
+            {
+                int delta = *depth - previous;
+                w.write(static_cast<uint32_t>((delta << 1) ^ (delta >> 31)));
+                previous = *depth;
+            }
+        }
+        return w.finish();
+    }
+
+    bool rvl_decode(const uint8_t* encoded, size_t size, uint16_t* depth, size_t count)
+    {
+        nibble_reader r(encoded, size);
+        int previous = 0;
+        size_t i = 0;
+        while (i < count)
+        {
+            uint32_t zeros, nonzeros;
+            if (!r.read(zeros) || zeros > count - i)
+                return false;
+            std::fill(depth + i, depth + i + zeros, 0);
+            i += zeros;
+
+            if (!r.read(nonzeros) || nonzeros > count - i)
+                return false;
+            for (uint32_t j = 0; j < nonzeros; ++j)
+            {
+                uint32_t value;
+                if (!r.read(value))
+                    return false;
+                previous += static_cast<int>(value >> 1) ^ -static_cast<int>(value & 1);
+                depth[i++] = static_cast<uint16_t>(previous);
+            }
+        }
+        return true;
+    }
+
+    size_t rvl_frame_stride(size_t encoded_size, int height)
+    {
+        return height > 0 ? (sizeof(uint32_t) + encoded_size + height - 1) / height : 0;
+    }
+
+    static rs2::stream_profile create_target_profile(const rs2::stream_profile& source, rs2_format format)
+    {
+        auto target = source.clone(source.stream_type(), source.stream_index(), format);
+        environment::get_instance().get_extrinsics_graph().register_same_extrinsics(*(stream_interface*)(source.get()->profile), *(stream_interface*)(target.get()->profile));
+        auto src_vspi = dynamic_cast<video_stream_profile_interface*>(source.get()->profile);
+        auto tgt_vspi = dynamic_cast<video_stream_profile_interface*>(target.get()->profile);
+        rs2_intrinsics src_intrin = src_vspi->get_intrinsics();
+        tgt_vspi->set_intrinsics([src_intrin]() { return src_intrin; });
+        tgt_vspi->set_dims(src_intrin.width, src_intrin.height);
+        return target;
+    }
+
+    depth_compressor::depth_compressor()
+    {
+        unregister_option(RS2_OPTION_FRAMES_QUEUE_SIZE);
+    }
+
+    bool depth_compressor::should_process(const rs2::frame& frame)
+    {
+        if (!frame || frame.is<rs2::frameset>())
+            return false;
+        return frame.get_profile().format() == RS2_FORMAT_Z16;
+    }
+
+    rs2::frame depth_compressor::process_frame(const rs2::frame_source& source, const rs2::frame& f)
+    {
+        if (f.get_profile().get() != _source_stream_profile.get())
+        {
+            _source_stream_profile = f.get_profile();
+            _target_stream_profile = create_target_profile(_source_stream_profile, RS2_FORMAT_Z16_RVL);
+        }
+
+        auto vf = f.as<rs2::video_frame>();
+        auto width = vf.get_width();
+        auto height = vf.get_height();
+        auto count = static_cast<size_t>(width) * height;
+        _encoded.resize(rvl_max_encoded_size(count));
+        auto encoded_size = rvl_encode(reinterpret_cast<const uint16_t*>(vf.get_data()), count, _encoded.data());
+
+        auto stride = rvl_frame_stride(encoded_size, height);
+        auto tgt = source.allocate_video_frame(_target_stream_profile, f, 2, width, height, int(stride), RS2_EXTENSION_VIDEO_FRAME);
+        if (!tgt)
+            return tgt;
+
+        auto out = reinterpret_cast<uint8_t*>(const_cast<void*>(tgt.get_data()));
+        auto size = static_cast<uint32_t>(encoded_size);
+        memcpy(out, &size, sizeof(size));
+        memcpy(out + sizeof(size), _encoded.data(), encoded_size);
+        memset(out + sizeof(size) + encoded_size, 0, stride * height - sizeof(size) - encoded_size);
+        return tgt;
+    }
+
+    depth_decompressor::depth_decompressor()
+    {
+        unregister_option(RS2_OPTION_FRAMES_QUEUE_SIZE);
+    }
+
+    bool depth_decompressor::should_process(const rs2::frame& frame)
+    {
+        if (!frame || frame.is<rs2::frameset>())
+            return false;
+        return frame.get_profile().format() == RS2_FORMAT_Z16_RVL;
+    }
+
+    rs2::frame depth_decompressor::process_frame(const rs2::frame_source& source, const rs2::frame& f)
+    {
+        if (f.get_profile().get() != _source_stream_profile.get())
+        {
+            _source_stream_profile = f.get_profile();
+            _target_stream_profile = create_target_profile(_source_stream_profile, RS2_FORMAT_Z16);
+        }
+
+        auto vf = f.as<rs2::video_frame>();
+        auto width = vf.get_width();
+        auto height = vf.get_height();
+        auto available = static_cast<size_t>(vf.get_stride_in_bytes()) * height;
+        auto in = reinterpret_cast<const uint8_t*>(vf.get_data());
+        uint32_t encoded_size = 0;
+        if (available >= sizeof(encoded_size))
+            memcpy(&encoded_size, in, sizeof(encoded_size));
+        if (available < sizeof(encoded_size) + encoded_size)
+        {
+            LOG_WARNING("Compressed depth frame " << f.get_frame_number() << " is truncated");
+            return rs2::frame{};
+        }
+
+        auto extension = _target_stream_profile.stream_type() == RS2_STREAM_DEPTH ? RS2_EXTENSION_DEPTH_FRAME : RS2_EXTENSION_VIDEO_FRAME;
+        auto tgt = source.allocate_video_frame(_target_stream_profile, f, 2, width, height, width * 2, extension);
+        if (!tgt)
+            return tgt;
+
+        auto out = reinterpret_cast<uint16_t*>(const_cast<void*>(tgt.get_data()));
+        if (!rvl_decode(in + sizeof(encoded_size), encoded_size, out, static_cast<size_t>(width) * height))
+        {
+            LOG_WARNING("Compressed depth frame " << f.get_frame_number() << " did not decode");
+            return rs2::frame{};
+        }
+        return tgt;
+    }
+}
@@ -0,0 +1,52 @@
+// Lossless compression of 16-bit depth, and the blocks converting depth frames to and from compressed ones
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "synthetic-stream.h"
+
+namespace librealsense
+{
+    // Coding of 16-bit depth in the spirit of RVL (A. Wilson, "Fast Lossless Depth Image Compression", 2017):
+    // alternating runs of zero and non-zero pixels, the latter as zigzag differences to the previous non-zero pixel,
+    // all as variable length nibbles packed into 32-bit words of the host. Runs are scanned 8 pixels at a time with SSSE3
+    size_t rvl_max_encoded_size(size_t count);
+    // Returns the bytes written to encoded, which holds rvl_max_encoded_size(count) bytes at least
+    size_t rvl_encode(const uint16_t* depth, size_t count, uint8_t* encoded);
+    // False when the data does not decode to exactly count pixels
+    bool rvl_decode(const uint8_t* encoded, size_t size, uint16_t* depth, size_t count);
+
+    // RS2_FORMAT_Z16_RVL frames have the dimensions of their depth, and hold the size of the encoded data as their first
+    // 32 bits, followed by the data. Their stride is that of the data spread over their rows
+    size_t rvl_frame_stride(size_t encoded_size, int height);
+
+    class depth_compressor : public generic_processing_block
+    {
+    public:
+        depth_compressor();
+
+    protected:
+        bool should_process(const rs2::frame& frame) override;
+        rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
+
+    private:
+        rs2::stream_profile     _source_stream_profile;
+        rs2::stream_profile     _target_stream_profile;
+        std::vector<uint8_t>    _encoded;
+    };
+
+    class depth_decompressor : public generic_processing_block
+    {
+    public:
+        depth_decompressor();
+
+    protected:
+        bool should_process(const rs2::frame& frame) override;
+        rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
+
+    private:
+        rs2::stream_profile     _source_stream_profile;
+        rs2::stream_profile     _target_stream_profile;
+    };
+}
@@ -0,0 +1,304 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include "../include/librealsense2/hpp/rs_sensor.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+#include "option.h"
+#include "environment.h"
+#include "context.h"
+#include "proc/synthetic-stream.h"
+#include "proc/decimation-filter.h"
+#include "proc/disparity-transform.h"
+#include "proc/spatial-filter.h"
+#include "proc/temporal-filter.h"
+#include "proc/hole-filling-filter.h"
+#include "proc/depth-post-processing.h"
+
+#ifdef RS2_USE_CUDA_DEPTH_FILTERS
+#include "../cuda/cuda-depth-filters.cuh"
+#endif
+
+namespace librealsense
+{
+    // Pixels per strip of rows, so that a strip of the frame, its disparity and the temporal history fit in the cache together
+    const size_t strip_pixels = 16384;
+
+    depth_post_processing::depth_post_processing(std::shared_ptr<decimation_filter> decimation,
+        std::shared_ptr<spatial_filter> spatial,
+        std::shared_ptr<temporal_filter> temporal,
+        std::shared_ptr<hole_filling_filter> hole_filling) :
+        _decimation(decimation),
+        _spatial(spatial),
+        _temporal(temporal),
+        _hole_filling(hole_filling),
+        _width(0), _height(0), _strip_rows(1),
+        _disparity(false),
+        _d2d_convert_factor(0.f),
+        _threads(1)
+    {
+        _stream_filter.stream = RS2_STREAM_DEPTH;
+        _stream_filter.format = RS2_FORMAT_Z16;
+
+        auto max_threads = std::max<int>(std::thread::hardware_concurrency(), 1);
+        auto processing_threads = std::make_shared<ptr_option<int>>(1, max_threads, 1, 1, &_threads,
+            "Number of threads, including the calling one, that run the chain on each frame in bands of rows and columns");
+        register_option(RS2_OPTION_PROCESSING_THREADS, processing_threads);
+    }
+
+    rs2::frame depth_post_processing::process_frame(const rs2::frame_source& source, const rs2::frame& f)
+    {
+        update_configuration(f);
+
+        if (_threads <= 1)
+            _workers.reset();
+        else if (!_workers || int(_workers->size()) != _threads - 1)
+            _workers = std::make_shared<parallel_workers>(_threads - 1);
+
+        auto src = f.as<rs2::video_frame>();
+        auto tgt = source.allocate_video_frame(_target_stream_profile, f, int(sizeof(uint16_t)), int(_width), int(_height),
+            int(_width * sizeof(uint16_t)), RS2_EXTENSION_DEPTH_FRAME);
+
+        auto depth_in = static_cast<const uint16_t*>(src.get_data());
+        auto depth_out = static_cast<uint16_t*>(const_cast<void*>(tgt.get_data()));
+#ifdef RS2_USE_CUDA_DEPTH_FILTERS
+        process_chain_cuda(depth_in, src.get_width(), depth_out);
+#else
+        if (_disparity)
+            process_chain<float>(depth_in, src.get_width(), depth_out);
+        else
+            process_chain<uint16_t>(depth_in, src.get_width(), depth_out);
+#endif
+
+        return tgt;
+    }
+
+    void depth_post_processing::update_configuration(const rs2::frame& f)
+    {
+        // The decimated profile, as the rest of the chain would receive it
+        rs2::stream_profile profile = f.get_profile();
+        if (_decimation)
+        {
+            _decimation->update_output_profile(f);
+            profile = _decimation->_target_stream_profile;
+        }
+
+        if (profile.get() != _source_stream_profile.get())
+        {
+            _source_stream_profile = profile;
+            _target_stream_profile = _source_stream_profile.clone(RS2_STREAM_DEPTH, 0, RS2_FORMAT_Z16);
+
+            environment::get_instance().get_extrinsics_graph().register_same_extrinsics(
+                *(stream_interface*)(_source_stream_profile.get()->profile),
+                *(stream_interface*)(_target_stream_profile.get()->profile));
+
+            auto vp = _source_stream_profile.as<rs2::video_stream_profile>();
+            _width = vp.width();
+            _height = vp.height();
+            _strip_rows = std::max<size_t>(strip_pixels / _width, 1);
+
+            // Stereoscopic depth is filtered as disparity, like the depth to disparity transform would let it through
+            float depth_units = 0.f, stereo_baseline = 0.f;
+            _disparity = disparity_transform::query_stereo_parameters(f, depth_units, stereo_baseline);
+            if (_disparity)
+                _d2d_convert_factor = disparity_transform::conversion_factor(stereo_baseline, vp.get_intrinsics().fx, depth_units);
+
+            _disparity_frame.clear();
+            if (_disparity)
+                _disparity_frame.resize(_width * _height * sizeof(float));
+
+            // Start the temporal history over, as the temporal filter does for a new profile
+            if (_temporal)
+            {
+                _temporal->_last_frame.clear();
+                _temporal->_history_reset = true;
+            }
+        }
+
+        // The filters run on the frame dimensions of the chain, and configure themselves anew for the next frame they process alone
+        auto bpp = _disparity ? sizeof(float) : sizeof(uint16_t);
+        if (_spatial)
+        {
+            _spatial->_source_stream_profile = rs2::stream_profile();
+            _spatial->_width = _width;
+            _spatial->_height = _height;
+        }
+        if (_temporal)
+        {
+            _temporal->_source_stream_profile = rs2::stream_profile();
+            if (_temporal->_last_frame.size() != _width * _height * bpp)
+            {
+                _temporal->_last_frame.clear();
+                _temporal->_last_frame.resize(_width * _height * bpp);
+                _temporal->_history.clear();
+                _temporal->_history.resize(_width * _height * bpp);
+                _temporal->_history_reset = true;
+            }
+        }
+    }
+
+    template<typename T>
+    void depth_post_processing::process_chain(const uint16_t* depth_in, size_t width_in, uint16_t* depth_out)
+    {
+        // In the depth domain every filter runs in place on the output frame
+        auto frame = _disparity ? reinterpret_cast<T*>(_disparity_frame.data()) : reinterpret_cast<T*>(depth_out);
+        bool fp = std::is_floating_point<T>::value;
+        auto w = _width;
+        auto h = _height;
+
+        auto alpha = _spatial ? _spatial->_spatial_alpha_param : 0.f;
+        auto delta = _spatial ? _spatial->_spatial_edge_threshold : 0.f;
+        auto iterations = _spatial ? int(_spatial->_spatial_iterations) : 0;
+
+        auto horizontal = [&](size_t begin, size_t end)
+        {
+            if (fp)
+                _spatial->recursive_filter_horizontal_fp(frame, alpha, delta, begin, end);
+            else
+                _spatial->template recursive_filter_horizontal<T>(frame, alpha, delta, begin, end);
+        };
+        auto vertical = [&](size_t begin, size_t end)
+        {
+            if (fp)
+                _spatial->recursive_filter_vertical_fp(frame, alpha, delta, begin, end);
+            else
+                _spatial->template recursive_filter_vertical<T>(frame, alpha, delta, begin, end);
+        };
+
+        // Decimation, depth to disparity and the first horizontal pass only depend on their own rows
+        for_each_band(h, 1, [&](size_t begin, size_t end)
+        {
+            for_each_strip(begin, end, [&](size_t first, size_t last)
+            {
+                auto depth = depth_in + first * w;
+                if (_decimation)
+                {
+                    auto real_height = size_t(_decimation->_real_height);
+                    if (first < std::min(last, real_height))
+                        _decimation->decimate_depth_rows(depth_in, depth_out, width_in, _decimation->_patch_size, first, std::min(last, real_height));
+                    for (auto v = std::max(first, real_height); v < last; ++v)
+                        memset(depth_out + v * w, 0, w * sizeof(uint16_t));
+                    depth = depth_out + first * w;
+                }
+
+                if (_disparity)
+                    depth_to_disparity(depth, reinterpret_cast<float*>(frame + first * w), (last - first) * w, _d2d_convert_factor);
+                else if (!_decimation)
+                    memcpy(depth_out + first * w, depth, (last - first) * w * sizeof(uint16_t));
+
+                if (iterations)
+                    horizontal(first, last);
+            });
+        });
+
+        // The vertical passes run through whole columns, so every one of them takes its own pass over the frame
+        for (int i = 0; i < iterations; i++)
+        {
+            for_each_band(w, 16, vertical);
+            if (i + 1 < iterations)
+                for_each_band(h, 1, horizontal);
+        }
+
+        // The spatial holes filling, temporal filter and disparity to depth only depend on their own rows again
+        auto filter_rows = [&](size_t first, size_t last)
+        {
+            if (_spatial && _spatial->_holes_filling_mode && fp)
+                _spatial->template intertial_holes_fill<T>(frame, first, last);
+
+            if (_temporal)
+                _temporal->template temp_jw_smooth<T>(frame, _temporal->_last_frame.data(), _temporal->_history.data(), first * w, last * w);
+
+            if (_disparity)
+                disparity_to_depth(reinterpret_cast<const float*>(frame + first * w), depth_out + first * w, (last - first) * w, _d2d_convert_factor);
+
+            if (_hole_filling && _hole_filling->_hole_filling_mode == hf_fill_from_left)
+                _hole_filling->holes_fill_left(depth_out + first * w, w, last - first, w * sizeof(uint16_t));
+        };
+
+        if (!_hole_filling || _hole_filling->_hole_filling_mode == hf_fill_from_left)
+        {
+            for_each_band(h, 1, [&](size_t begin, size_t end) { for_each_strip(begin, end, filter_rows); });
+        }
+        else
+        {
+            // Filling a row from around reads the filled row above and the row below, which therefore trails the strips by one row
+            size_t filled = 1;
+            for_each_strip(0, h, [&](size_t first, size_t last)
+            {
+                filter_rows(first, last);
+
+                auto end = last - 1;
+                if (end <= filled)
+                    return;
+                auto rows = depth_out + (filled - 1) * w;
+                if (_hole_filling->_hole_filling_mode == hf_farest_from_around)
+                    _hole_filling->holes_fill_farest(rows, w, end - filled + 2, w * sizeof(uint16_t));
+                else
+                    _hole_filling->holes_fill_nearest(rows, w, end - filled + 2, w * sizeof(uint16_t));
+                filled = end;
+            });
+        }
+
+        if (_temporal)
+            _temporal->_cur_frame_index = (_temporal->_cur_frame_index + 1) % 8;
+    }
+
+#ifdef RS2_USE_CUDA_DEPTH_FILTERS
+    void depth_post_processing::process_chain_cuda(const uint16_t* depth_in, size_t width_in, uint16_t* depth_out)
+    {
+        auto depth = depth_in;
+        if (_decimation)
+        {
+            auto real_height = std::min(size_t(_decimation->_real_height), _height);
+            for_each_band(real_height, 1, [&](size_t begin, size_t end)
+            {
+                _decimation->decimate_depth_rows(depth_in, depth_out, width_in, _decimation->_patch_size, begin, end);
+            });
+            if (real_height < _height)
+                memset(depth_out + real_height * _width, 0, (_height - real_height) * _width * sizeof(uint16_t));
+            depth = depth_out;
+        }
+
+        // The temporal history lives on the device of the temporal filter, so that it carries over to the frames the filter processes alone
+        auto& cuda = _temporal ? _temporal->_cuda : _cuda;
+        if (!cuda)
+            cuda = std::make_shared<rscuda::depth_filters_cuda>();
+
+        cuda->upload(depth, int(_width), int(_height), false);
+        if (_disparity)
+            cuda->depth_to_disparity(_d2d_convert_factor);
+
+        if (_spatial)
+            cuda->spatial(_spatial->_spatial_alpha_param, _spatial->_spatial_edge_threshold, _spatial->_spatial_iterations,
+                _spatial->_holes_filling_radius, _spatial->_holes_filling_mode != 0);
+
+        if (_temporal)
+        {
+            cuda->temporal(_temporal->_alpha_param, _temporal->_one_minus_alpha, _temporal->_delta_param,
+                _temporal->_persistence_map.data(), _temporal->_cur_frame_index, _temporal->_history_reset);
+            _temporal->_history_reset = false;
+            _temporal->_cur_frame_index = (_temporal->_cur_frame_index + 1) % 8;
+        }
+
+        if (_disparity)
+            cuda->disparity_to_depth(_d2d_convert_factor);
+
+        if (_hole_filling)
+            cuda->hole_filling(_hole_filling->_hole_filling_mode);
+
+        cuda->download(depth_out);
+    }
+#endif
+
+    void depth_post_processing::for_each_band(size_t count, size_t alignment, const std::function<void(size_t begin, size_t end)>& task)
+    {
+        if (!_workers)
+            return task(0, count);
+        _workers->run_bands(count, alignment, task);
+    }
+
+    void depth_post_processing::for_each_strip(size_t begin, size_t end, const std::function<void(size_t begin, size_t end)>& task) const
+    {
+        for (auto first = begin; first < end; first += _strip_rows)
+            task(first, std::min(end, first + _strip_rows));
+    }
+}
@@ -0,0 +1,76 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+// Runs the decimation -> depth to disparity -> spatial -> temporal -> disparity to depth -> hole filling chain
+// in strips of rows that stay in the cache, and writes only the final depth frame
+
+#pragma once
+
+#include "../include/librealsense2/hpp/rs_frame.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+#include "concurrency.h"
+
+#ifdef RS2_USE_CUDA_DEPTH_FILTERS
+namespace rscuda
+{
+    class depth_filters_cuda;
+}
+#endif
+
+namespace librealsense
+{
+    class decimation_filter;
+    class spatial_filter;
+    class temporal_filter;
+    class hole_filling_filter;
+
+    class depth_post_processing : public depth_processing_block
+    {
+    public:
+        // Any of the filters may be null, to leave it out of the chain. The filters are configured through their own options,
+        // and the temporal filter keeps its history in between the frames of the chain
+        depth_post_processing(std::shared_ptr<decimation_filter> decimation,
+            std::shared_ptr<spatial_filter> spatial,
+            std::shared_ptr<temporal_filter> temporal,
+            std::shared_ptr<hole_filling_filter> hole_filling);
+
+    protected:
+        rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
+
+    private:
+        void    update_configuration(const rs2::frame& f);
+
+        // T is the type of the domain the spatial and temporal filters run in: float for disparity, uint16_t for depth
+        template<typename T>
+        void    process_chain(const uint16_t* depth_in, size_t width_in, uint16_t* depth_out);
+
+#ifdef RS2_USE_CUDA_DEPTH_FILTERS
+        // Decimates on the CPU, and runs the rest of the chain on the GPU without the frame leaving the device
+        void    process_chain_cuda(const uint16_t* depth_in, size_t width_in, uint16_t* depth_out);
+#endif
+
+        // Split [0, count) into one band per available thread, and run them in parallel
+        void    for_each_band(size_t count, size_t alignment, const std::function<void(size_t begin, size_t end)>& task);
+
+        // Run the rows in [begin, end) in strips of _strip_rows
+        void    for_each_strip(size_t begin, size_t end, const std::function<void(size_t begin, size_t end)>& task) const;
+
+        std::shared_ptr<decimation_filter>      _decimation;
+        std::shared_ptr<spatial_filter>         _spatial;
+        std::shared_ptr<temporal_filter>        _temporal;
+        std::shared_ptr<hole_filling_filter>    _hole_filling;
+
+        rs2::stream_profile     _source_stream_profile;     // The decimated profile, when decimating
+        rs2::stream_profile     _target_stream_profile;
+        size_t                  _width, _height;
+        size_t                  _strip_rows;
+        bool                    _disparity;                 // Whether the frames are stereoscopic depth, to be filtered as disparity
+        float                   _d2d_convert_factor;
+        std::vector<uint8_t>    _disparity_frame;           // The frame in the disparity domain, as the filters see it
+        int                     _threads;
+        std::shared_ptr<parallel_workers> _workers;
+
+#ifdef RS2_USE_CUDA_DEPTH_FILTERS
+        std::shared_ptr<rscuda::depth_filters_cuda> _cuda;  // Used when the chain has no temporal filter to share the history of
+#endif
+    };
+}
@@ -0,0 +1,206 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include "../include/librealsense2/rs.hpp"
+
+#include "proc/synthetic-stream.h"
+#include "proc/depth-stats.h"
+#include "option.h"
+#include "environment.h"
+#include "context.h"
+#include "parallel.h"
+
+#ifdef __SSSE3__
+#include <tmmintrin.h> // For SSSE3 intrinsics
+#endif
+
+namespace librealsense
+{
+    namespace
+    {
+        // Rows of a band, the statistics of the bands being merged once they are all counted
+        const int band_rows = 32;
+
+        // Iterations of 8 pixels the 16-bit counters of the SIMD loop take before they overflow, with margin
+        const size_t simd_run = 8192;
+    }
+
+    void accumulate_depth_statistics(const uint16_t* depth, size_t count, uint16_t histogram_range, depth_statistics& stats)
+    {
+        // The bin of a depth is (depth * scale) >> 16, the scale rounded up for the depth on the edge of a bin to fall in it
+        const uint32_t range = std::max<uint16_t>(histogram_range, 9);
+        const uint32_t scale = ((uint32_t(depth_statistics::histogram_bins) << 16) + range - 1) / range;
+        const uint16_t last_bin = depth_statistics::histogram_bins - 1;
+
+        uint32_t zeros = 0;
+        uint16_t min = stats.min, max = stats.max;
+        uint64_t sum = 0;
+        uint32_t histogram[depth_statistics::histogram_bins] = {};
+        size_t i = 0;
+
+#ifdef __SSSE3__
+        // The minimum and maximum are taken signed, of the depth biased by 0x8000, the empty pixels being out of the minimum
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i bias = _mm_set1_epi16(short(0x8000));
+        const __m128i no_min = _mm_set1_epi16(0x7fff);
+        const __m128i vscale = _mm_set1_epi16(short(scale));
+        const __m128i vlast = _mm_set1_epi16(last_bin);
+        __m128i vmin = no_min;
+        __m128i vmax = bias;
+
+        while (i + 8 <= count)
+        {
+            // Counts of every lane, subtracting the all-ones masks of cmpeq
+            __m128i vzeros = zero;
+            __m128i vsum = zero;
+            __m128i bins[depth_statistics::histogram_bins];
+            for (auto&& b : bins) b = zero;
+
+            auto run_end = std::min(count - (count - i) % 8, i + simd_run * 8);
+            for (; i < run_end; i += 8)
+            {
+                __m128i z = _mm_loadu_si128(reinterpret_cast<const __m128i*>(depth + i));
+                __m128i empty = _mm_cmpeq_epi16(z, zero);
+                __m128i biased = _mm_xor_si128(z, bias);
+
+                vmax = _mm_max_epi16(vmax, biased);
+                vmin = _mm_min_epi16(vmin, _mm_or_si128(_mm_andnot_si128(empty, biased), _mm_and_si128(empty, no_min)));
+                vzeros = _mm_sub_epi16(vzeros, empty);
+                vsum = _mm_add_epi32(vsum, _mm_add_epi32(_mm_unpacklo_epi16(z, zero), _mm_unpackhi_epi16(z, zero)));
+
+                // Unsigned minimum with the last bin, as a - max(a - last, 0)
+                __m128i bin = _mm_mulhi_epu16(z, vscale);
+                bin = _mm_sub_epi16(bin, _mm_subs_epu16(bin, vlast));
+                for (int b = 0; b < depth_statistics::histogram_bins; ++b)
+                    bins[b] = _mm_sub_epi16(bins[b], _mm_cmpeq_epi16(bin, _mm_set1_epi16(short(b))));
+            }
+
+            alignas(16) uint16_t lanes[8];
+            alignas(16) uint32_t sums[4];
+            _mm_store_si128(reinterpret_cast<__m128i*>(lanes), vzeros);
+            for (auto l : lanes) zeros += l;
+            _mm_store_si128(reinterpret_cast<__m128i*>(sums), vsum);
+            for (auto s : sums) sum += s;
+            for (int b = 0; b < depth_statistics::histogram_bins; ++b)
+            {
+                _mm_store_si128(reinterpret_cast<__m128i*>(lanes), bins[b]);
+                for (auto l : lanes) histogram[b] += l;
+            }
+        }
+
+        alignas(16) uint16_t lanes[8];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), vmin);
+        for (auto l : lanes) min = std::min<uint16_t>(min, l ^ 0x8000);
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), vmax);
+        for (auto l : lanes) max = std::max<uint16_t>(max, l ^ 0x8000);
+#endif
+
+        for (; i < count; ++i)
+        {
+            auto z = depth[i];
+            if (!z)
+            {
+                ++zeros;
+                ++histogram[0];
+                continue;
+            }
+            min = std::min(min, z);
+            max = std::max(max, z);
+            sum += z;
+            ++histogram[std::min<uint16_t>(uint16_t((z * scale) >> 16), last_bin)];
+        }
+
+        // The empty pixels were counted in the first bin
+        histogram[0] -= zeros;
+
+        stats.pixels += uint32_t(count);
+        stats.valid += uint32_t(count) - zeros;
+        stats.min = min;
+        stats.max = max;
+        stats.sum += sum;
+        stats.histogram_range = histogram_range;
+        for (int b = 0; b < depth_statistics::histogram_bins; ++b)
+            stats.histogram[b] += histogram[b];
+    }
+
+    void accumulate_depth_statistics(const uint16_t* depth, size_t width, size_t height, size_t stride,
+        uint16_t histogram_range, depth_statistics& stats)
+    {
+        for (size_t y = 0; y < height; ++y)
+            accumulate_depth_statistics(depth + y * stride, width, histogram_range, stats);
+    }
+
+    uint16_t get_histogram_range(const rs2::frame& depth, float range_meters)
+    {
+        float depth_units = 0.001f;
+        if (auto sensor = ((frame_interface*)depth.get())->get_sensor())
+            if (sensor->supports_option(RS2_OPTION_DEPTH_UNITS))
+                depth_units = sensor->get_option(RS2_OPTION_DEPTH_UNITS).query();
+
+        auto range = range_meters / depth_units;
+        return uint16_t(std::min(std::max(range, 9.f), 65535.f));
+    }
+
+    depth_statistics_filter::depth_statistics_filter()
+        : _histogram_range(depth_histogram_range_default)
+    {
+        _stream_filter.stream = RS2_STREAM_DEPTH;
+        _stream_filter.format = RS2_FORMAT_Z16;
+
+        auto histogram_range = std::make_shared<ptr_option<float>>(
+            depth_histogram_range_min,
+            depth_histogram_range_max,
+            depth_histogram_range_step,
+            depth_histogram_range_default,
+            &_histogram_range, "Depth, in meters, the bins of the histogram span");
+        register_option(RS2_OPTION_DEPTH_HISTOGRAM_RANGE, histogram_range);
+    }
+
+    rs2::frame depth_statistics_filter::process_frame(const rs2::frame_source& source, const rs2::frame& f)
+    {
+        auto vf = f.as<rs2::video_frame>();
+        auto width = vf.get_width();
+        auto height = vf.get_height();
+        auto stride = vf.get_stride_in_bytes();
+        auto bpp = vf.get_bytes_per_pixel();
+        auto data = static_cast<const uint8_t*>(f.get_data());
+
+        if (f.get_profile().get() != _source_stream_profile.get())
+        {
+            _source_stream_profile = f.get_profile();
+            _target_stream_profile = _source_stream_profile.clone(_source_stream_profile.stream_type(), _source_stream_profile.stream_index(), _source_stream_profile.format());
+            environment::get_instance().get_extrinsics_graph().register_same_extrinsics(
+                *(stream_interface*)(_source_stream_profile.get()->profile),
+                *(stream_interface*)(_target_stream_profile.get()->profile));
+        }
+
+        auto range = get_histogram_range(f, _histogram_range);
+        std::vector<depth_statistics> bands((height + band_rows - 1) / band_rows);
+        parallel_for(0, int(bands.size()), 1, [&](int first, int last)
+        {
+            for (int b = first; b < last; ++b)
+            {
+                auto y = b * band_rows;
+                auto rows = std::min(band_rows, height - y);
+                accumulate_depth_statistics(reinterpret_cast<const uint16_t*>(data + y * stride),
+                    width, rows, stride / sizeof(uint16_t), range, bands[b]);
+            }
+        });
+
+        depth_statistics stats;
+        for (auto&& band : bands)
+            stats.merge(band);
+        stats.histogram_range = range;
+
+        auto tgt = reuse_input_frame(f, _target_stream_profile, bpp, width, height, stride, RS2_EXTENSION_DEPTH_FRAME);
+        if (!tgt)
+        {
+            tgt = source.allocate_video_frame(_target_stream_profile, f, bpp, width, height, stride, RS2_EXTENSION_DEPTH_FRAME);
+            if (!tgt)
+                return tgt;
+            memcpy(const_cast<void*>(tgt.get_data()), data, size_t(stride) * height);
+        }
+        dynamic_cast<frame*>((frame_interface*)tgt.get())->additional_data.depth_stats = stats;
+        return tgt;
+    }
+}
@@ -0,0 +1,42 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "synthetic-stream.h"
+
+namespace librealsense
+{
+    // Of the histogram range option, in meters
+    const float depth_histogram_range_min = 0.1f;
+    const float depth_histogram_range_max = 65.f;
+    const float depth_histogram_range_step = 0.1f;
+    const float depth_histogram_range_default = 10.f;
+
+    // Adds the statistics of count pixels of depth to stats, with a histogram over [0, histogram_range) depth units that must
+    // be of at least 9 units. Processed 8 pixels at a time with SSE, for filters to compute it as they write their output
+    void accumulate_depth_statistics(const uint16_t* depth, size_t count, uint16_t histogram_range, depth_statistics& stats);
+
+    // The same, over the rows of a frame of stride pixels
+    void accumulate_depth_statistics(const uint16_t* depth, size_t width, size_t height, size_t stride,
+        uint16_t histogram_range, depth_statistics& stats);
+
+    // The histogram range option in meters, into the depth units of the frame
+    uint16_t get_histogram_range(const rs2::frame& depth, float range_meters);
+
+    // Attaches the min, max, mean, fill rate and histogram of depth frames to them as metadata. A frame nothing else
+    // references gets them in place, the others are copied for their metadata not to change under their other holders
+    class depth_statistics_filter : public stream_filter_processing_block
+    {
+    public:
+        depth_statistics_filter();
+
+    protected:
+        rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
+
+    private:
+        float                   _histogram_range;
+        rs2::stream_profile     _source_stream_profile;
+        rs2::stream_profile     _target_stream_profile;
+    };
+}
@@ -11,11 +11,135 @@
 #include "proc/disparity-transform.h"
 #include "software-device.h"
 #include "environment.h"
+#include "image.h"
+
+#ifdef __SSSE3__
+#include <tmmintrin.h> // For SSSE3 intrinsics
+#endif
 
 namespace librealsense
 {
+#ifdef __SSSE3__
+    // Both handle 8 pixels per iteration, and return how many of the count pixels were converted
+    static size_t depth_to_disparity_sse(const uint16_t* depth, float* disparity, size_t count, float factor)
+    {
+        const __m128 f = _mm_set_ps1(factor);
+        const __m128i zero = _mm_setzero_si128();
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            auto d = _mm_loadu_si128((__m128i const*)(depth + i));
+            auto lo = _mm_cvtepi32_ps(_mm_unpacklo_epi16(d, zero));
+            auto hi = _mm_cvtepi32_ps(_mm_unpackhi_epi16(d, zero));
+
+            // Every non-zero 16-bit depth is a normal number
+            auto valid_lo = _mm_cmpneq_ps(lo, _mm_setzero_ps());
+            auto valid_hi = _mm_cmpneq_ps(hi, _mm_setzero_ps());
+
+            _mm_storeu_ps(disparity + i, _mm_and_ps(_mm_div_ps(f, lo), valid_lo));
+            _mm_storeu_ps(disparity + i + 4, _mm_and_ps(_mm_div_ps(f, hi), valid_hi));
+        }
+        return i;
+    }
+
+    static size_t disparity_to_distance_sse(const float* disparity, float* distance, size_t count, float factor)
+    {
+        const __m128 f = _mm_set_ps1(factor);
+        const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+        const __m128 min_normal = _mm_set_ps1(std::numeric_limits<float>::min());
+        const __m128 max_normal = _mm_set_ps1(std::numeric_limits<float>::max());
+
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            auto d = _mm_loadu_ps(disparity + i);
+            auto a = _mm_and_ps(d, abs_mask);
+            auto normal = _mm_and_ps(_mm_cmpge_ps(a, min_normal), _mm_cmple_ps(a, max_normal));
+            _mm_storeu_ps(distance + i, _mm_and_ps(_mm_div_ps(f, d), normal));
+        }
+        return i;
+    }
+
+    static size_t disparity_to_depth_sse(const float* disparity, uint16_t* depth, size_t count, float factor)
+    {
+        const __m128 f = _mm_set_ps1(factor);
+        const __m128 round = _mm_set_ps1(0.5f);
+        const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+        const __m128 min_normal = _mm_set_ps1(std::numeric_limits<float>::min());
+        const __m128 max_normal = _mm_set_ps1(std::numeric_limits<float>::max());
+        // Keeps the low 16 bits of every 32-bit lane, like the narrowing of the scalar conversion
+        const __m128i low_words = _mm_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1);
+
+        auto convert = [&](const float* in)
+        {
+            auto d = _mm_loadu_ps(in);
+            auto a = _mm_and_ps(d, abs_mask);
+            auto normal = _mm_castps_si128(_mm_and_ps(_mm_cmpge_ps(a, min_normal), _mm_cmple_ps(a, max_normal)));
+            auto z = _mm_cvttps_epi32(_mm_add_ps(_mm_div_ps(f, d), round));
+            return _mm_shuffle_epi8(_mm_and_si128(z, normal), low_words);
+        };
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            _mm_storeu_si128((__m128i*)(depth + i), _mm_unpacklo_epi64(convert(disparity + i), convert(disparity + i + 4)));
+        }
+        return i;
+    }
+#endif
+
+    void depth_to_disparity(const uint16_t* depth, float* disparity, size_t count, float factor)
+    {
+        size_t i = 0;
+#ifdef __SSSE3__
+        i = depth_to_disparity_sse(depth, disparity, count, factor);
+#endif
+        for (; i < count; i++)
+        {
+            float input = depth[i];
+            if (std::isnormal(input))
+                disparity[i] = factor / input;
+            else
+                disparity[i] = 0;
+        }
+    }
+
+    void disparity_to_depth(const float* disparity, uint16_t* depth, size_t count, float factor)
+    {
+        size_t i = 0;
+#ifdef __SSSE3__
+        i = disparity_to_depth_sse(disparity, depth, count, factor);
+#endif
+        for (; i < count; i++)
+        {
+            float input = disparity[i];
+            if (std::isnormal(input))
+                depth[i] = static_cast<uint16_t>((factor / input) + 0.5f);
+            else
+                depth[i] = 0;
+        }
+    }
+
+    void disparity_to_distance(const float* disparity, float* distance, size_t count, float factor)
+    {
+        size_t i = 0;
+#ifdef __SSSE3__
+        i = disparity_to_distance_sse(disparity, distance, count, factor);
+#endif
+        for (; i < count; i++)
+        {
+            float input = disparity[i];
+            if (std::isnormal(input))
+                distance[i] = factor / input;
+            else
+                distance[i] = 0;
+        }
+    }
+
     disparity_transform::disparity_transform(bool transform_to_disparity):
         _transform_to_disparity(transform_to_disparity),
+        _distance_output(false),
         _update_target(false),
         _stereoscopic_depth(false),
         _focal_lenght_mm(0.f),
@@ -39,6 +163,21 @@ namespace librealsense
             on_set_mode(static_cast<bool>(!!int(val)));
         });
 
+        auto distance_opt = std::make_shared<ptr_option<bool>>(
+            false, true, true, false,
+            &_distance_output,
+            "Output the depth in float meters when transforming to depth");
+        distance_opt->on_set([this, distance_opt](float val)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (!distance_opt->is_valid(val))
+                throw invalid_value_exception(to_string() << "Unsupported distance output " << (int)val << " is out of range.");
+
+            _distance_output = !!int(val);
+            on_set_mode(_transform_to_disparity);
+        });
+        register_option(RS2_OPTION_DISTANCE_OUTPUT, distance_opt);
+
         unregister_option(RS2_OPTION_FRAMES_QUEUE_SIZE);
 
         on_set_mode(_transform_to_disparity);
@@ -55,6 +194,11 @@ namespace librealsense
         if (_transform_to_disparity && (frame.get_profile().stream_type() != RS2_STREAM_DEPTH || frame.get_profile().format() != RS2_FORMAT_Z16))
             return false;
 
+        // Z16 into meters
+        if (!_transform_to_disparity && _distance_output && frame.get_profile().stream_type() == RS2_STREAM_DEPTH &&
+            frame.get_profile().format() == RS2_FORMAT_Z16)
+            return true;
+
         if (!_transform_to_disparity && (frame.get_profile().stream_type() != RS2_STREAM_DEPTH ||
             (frame.get_profile().format() != RS2_FORMAT_DISPARITY16 && frame.get_profile().format() != RS2_FORMAT_DISPARITY32)))
             return false;
@@ -71,14 +215,22 @@ namespace librealsense
 
         update_transformation_profile(f);
 
-        if (_stereoscopic_depth && (tgt = prepare_target_frame(f, source)))
+        // Depth only needs its units to be converted into meters, of any depth sensor
+        auto from_depth = !_transform_to_disparity && f.get_profile().format() == RS2_FORMAT_Z16;
+        if ((_stereoscopic_depth || from_depth) && (tgt = prepare_target_frame(f, source)))
         {
             auto src = f.as<rs2::video_frame>();
+            auto dest = const_cast<void*>(tgt.get_data());
 
             if (_transform_to_disparity)
-                convert<uint16_t, float>(src.get_data(), const_cast<void*>(tgt.get_data()));
+                depth_to_disparity(reinterpret_cast<const uint16_t*>(src.get_data()), reinterpret_cast<float*>(dest), _width * _height, _d2d_convert_factor);
+            else if (from_depth)
+                depth_to_distance(reinterpret_cast<const uint16_t*>(src.get_data()), reinterpret_cast<float*>(dest), _width * _height,
+                    dynamic_cast<librealsense::depth_frame*>((frame_interface*)f.get())->get_units());
+            else if (_distance_output)
+                disparity_to_distance(reinterpret_cast<const float*>(src.get_data()), reinterpret_cast<float*>(dest), _width * _height, _d2d_convert_factor * _depth_units);
             else
-                convert<float, uint16_t>(src.get_data(), const_cast<void*>(tgt.get_data()));
+                disparity_to_depth(reinterpret_cast<const float*>(src.get_data()), reinterpret_cast<uint16_t*>(dest), _width * _height, _d2d_convert_factor);
         }
 
         return tgt;
@@ -87,10 +239,56 @@ namespace librealsense
     void disparity_transform::on_set_mode(bool to_disparity)
     {
         _transform_to_disparity = to_disparity;
-        _bpp = _transform_to_disparity ? sizeof(float) : sizeof(uint16_t);
+        _bpp = (_transform_to_disparity || _distance_output) ? sizeof(float) : sizeof(uint16_t);
         _update_target = true;
     }
 
+    bool disparity_transform::query_stereo_parameters(const rs2::frame& f, float& depth_units, float& stereo_baseline)
+    {
+        auto snr = ((frame_interface*)f.get())->get_sensor().get();
+        librealsense::depth_stereo_sensor* dss;
+        bool stereoscopic_depth = false;
+
+        // Playback sensor
+        if (auto a = As<librealsense::extendable_interface>(snr))
+        {
+            librealsense::depth_stereo_sensor* ptr;
+            if (stereoscopic_depth = a->extend_to(TypeToExtension<librealsense::depth_stereo_sensor>::value, (void**)&ptr))
+            {
+                dss = ptr;
+                depth_units = dss->get_depth_scale();
+                stereo_baseline = dss->get_stereo_baseline_mm()*0.001f;
+            }
+        }
+        else if (auto depth_emul = As<librealsense::software_sensor>(snr))
+        {
+            // Software device can obtain these options via Options interface
+            if (depth_emul->supports_option(RS2_OPTION_DEPTH_UNITS))
+                depth_units = depth_emul->get_option(RS2_OPTION_DEPTH_UNITS).query();
+            if (depth_emul->supports_option(RS2_OPTION_STEREO_BASELINE))
+                stereo_baseline = depth_emul->get_option(RS2_OPTION_STEREO_BASELINE).query();
+            stereoscopic_depth = true;
+        }
+        else // Live sensor
+        {
+            stereoscopic_depth = Is<librealsense::depth_stereo_sensor>(snr);
+            if (stereoscopic_depth)
+            {
+                dss = As<librealsense::depth_stereo_sensor>(snr);
+                depth_units = dss->get_depth_scale();
+                stereo_baseline = dss->get_stereo_baseline_mm()* 0.001f;
+            }
+        }
+        return stereoscopic_depth;
+    }
+
+    float disparity_transform::conversion_factor(float stereo_baseline, float focal_length, float depth_units)
+    {
+        const uint8_t fractional_bits = 5;
+        const uint8_t fractions = 1 << fractional_bits;
+        return (stereo_baseline * focal_length * fractions) / depth_units;
+    }
+
     void  disparity_transform::update_transformation_profile(const rs2::frame& f)
     {
         if (f.get_profile().get() != _source_stream_profile.get())
@@ -99,57 +297,23 @@ namespace librealsense
 
             // Check if the new frame originated from stereo-based depth sensor
             // and retrieve the stereo baseline parameter that will be used in transformations
-            auto snr = ((frame_interface*)f.get())->get_sensor().get();
-            librealsense::depth_stereo_sensor* dss;
-
-            // Playback sensor
-            if (auto a = As<librealsense::extendable_interface>(snr))
-            {
-                librealsense::depth_stereo_sensor* ptr;
-                if (_stereoscopic_depth = a->extend_to(TypeToExtension<librealsense::depth_stereo_sensor>::value, (void**)&ptr))
-                {
-                    dss = ptr;
-                    _depth_units = dss->get_depth_scale();
-                    _stereo_baseline = dss->get_stereo_baseline_mm()*0.001f;
-                }
-            }
-            else if (auto depth_emul = As<librealsense::software_sensor>(snr))
-            {
-                // Software device can obtain these options via Options interface
-                if (depth_emul->supports_option(RS2_OPTION_DEPTH_UNITS))
-                    _depth_units = depth_emul->get_option(RS2_OPTION_DEPTH_UNITS).query();
-                if (depth_emul->supports_option(RS2_OPTION_STEREO_BASELINE))
-                    _stereo_baseline = depth_emul->get_option(RS2_OPTION_STEREO_BASELINE).query();
-                _stereoscopic_depth = true;
-            }
-            else // Live sensor
-            {
-                _stereoscopic_depth = Is<librealsense::depth_stereo_sensor>(snr);
-                if (_stereoscopic_depth)
-                {
-                    dss = As<librealsense::depth_stereo_sensor>(snr);
-                    _depth_units = dss->get_depth_scale();
-                    _stereo_baseline = dss->get_stereo_baseline_mm()* 0.001f;
-                }
-            }
+            _stereoscopic_depth = query_stereo_parameters(f, _depth_units, _stereo_baseline);
 
+            auto vp = _source_stream_profile.as<rs2::video_stream_profile>();
             if (_stereoscopic_depth)
             {
-                auto vp = _source_stream_profile.as<rs2::video_stream_profile>();
                 _focal_lenght_mm    = vp.get_intrinsics().fx;
-                const uint8_t fractional_bits = 5;
-                const uint8_t fractions = 1 << fractional_bits;
-                _d2d_convert_factor = (_stereo_baseline * _focal_lenght_mm * fractions) / _depth_units;
-                _width = vp.width();
-                _height = vp.height();
-                _update_target = true;
+                _d2d_convert_factor = conversion_factor(_stereo_baseline, _focal_lenght_mm, _depth_units);
             }
+            _width = vp.width();
+            _height = vp.height();
+            _update_target = true;
         }
 
         // Adjust the target profile
         if (_update_target)
         {
-            auto tgt_format = _transform_to_disparity ? RS2_FORMAT_DISPARITY32 : RS2_FORMAT_Z16;
+            auto tgt_format = _transform_to_disparity ? RS2_FORMAT_DISPARITY32 : (_distance_output ? RS2_FORMAT_DISTANCE : RS2_FORMAT_Z16);
             _target_stream_profile = _source_stream_profile.clone(RS2_STREAM_DEPTH, 0, tgt_format);
             environment::get_instance().get_extrinsics_graph().register_same_extrinsics(*(stream_interface*)(_source_stream_profile.get()->profile), *(stream_interface*)(_target_stream_profile.get()->profile));
             auto src_vspi = dynamic_cast<video_stream_profile_interface*>(_source_stream_profile.get()->profile);
@@ -10,6 +10,15 @@
 
 namespace librealsense
 {
+    // Conversions between depth and disparity = factor / depth. Pixels with no depth, or whose disparity is not a normal number, give 0.
+    // The vectorized pixels are divided exactly like the remaining ones, so that every path gives the same results
+    void depth_to_disparity(const uint16_t* depth, float* disparity, size_t count, float factor);
+    void disparity_to_depth(const float* disparity, uint16_t* depth, size_t count, float factor);
+    // The same reciprocal into float depth, with the factor of the depth in meters
+    void disparity_to_distance(const float* disparity, float* distance, size_t count, float factor);
+
+    // Converting back to depth, RS2_OPTION_DISTANCE_OUTPUT writes it in float meters, which the disparity filters ending with the
+    // block then output without another pass. Z16 depth is converted too in that mode
 
     class disparity_transform : public generic_processing_block
     {
@@ -18,34 +27,14 @@ namespace librealsense
         bool should_process(const rs2::frame& frame) override;
         rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
 
-    protected:
-        rs2::frame prepare_target_frame(const rs2::frame& f, const rs2::frame_source& source);
-
-        template<typename Tin, typename Tout>
-        void convert(const void* in_data, void* out_data)
-        {
-            static_assert((std::is_arithmetic<Tin>::value), "disparity transform requires numeric type for input data");
-            static_assert((std::is_arithmetic<Tout>::value), "disparity transform requires numeric type for output data");
+        // Units, stereo baseline in meters, and whether f originated from a stereo-based depth sensor
+        static bool query_stereo_parameters(const rs2::frame& f, float& depth_units, float& stereo_baseline);
 
-            auto in = reinterpret_cast<const Tin*>(in_data);
-            auto out = reinterpret_cast<Tout*>(out_data);
+        // The disparity = factor / depth conversion factor, in disparity units of 1/32 pixel
+        static float conversion_factor(float stereo_baseline, float focal_length, float depth_units);
 
-            bool fp = (std::is_floating_point<Tin>::value);
-            const float round = fp ? 0.5f : 0.f;
-
-            float input{};
-            //TODO SSE optimize
-            for (auto i = 0; i < _height; i++)
-                for (auto j = 0; j < _width; j++)
-                {
-                    input = *in;
-                    if (std::isnormal(input))
-                        *out++ = static_cast<Tout>((_d2d_convert_factor / input)+round);
-                    else
-                        *out++ = 0;
-                    in++;
-                }
-        }
+    protected:
+        rs2::frame prepare_target_frame(const rs2::frame& f, const rs2::frame_source& source);
 
     private:
         void    update_transformation_profile(const rs2::frame& f);
@@ -53,6 +42,7 @@ namespace librealsense
         void    on_set_mode(bool to_disparity);
 
         bool                    _transform_to_disparity;
+        bool                    _distance_output;
         rs2::stream_profile     _source_stream_profile;
         rs2::stream_profile     _target_stream_profile;
         bool                    _update_target;
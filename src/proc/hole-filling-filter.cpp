@@ -11,8 +11,81 @@
 #include "proc/synthetic-stream.h"
 #include "proc/hole-filling-filter.h"
 
+#ifdef RS2_USE_CUDA_DEPTH_FILTERS
+#include "../cuda/cuda-depth-filters.cuh"
+#endif
+
+#ifdef __SSSE3__
+#include <tmmintrin.h> // For SSSE3 intrinsics
+#endif
+
 namespace librealsense
 {
+    void holes_fill_around(uint16_t* row, size_t width, size_t begin, size_t end, bool farest)
+    {
+        // Of every pixel, the selection among the pixels above and below it, which the scan does not change. The nearest keeps a
+        // pixel of no depth above it empty, and otherwise takes the smallest depth around, of the pixels minus one for 0 to be the
+        // largest. Only the pixel on the left then depends on the scan
+        const size_t chunk = 64;
+        uint16_t around[chunk];
+        const uint16_t* up = row - width;
+        const uint16_t* down = row + width;
+
+        for (auto first = begin; first < end; first += chunk)
+        {
+            auto last = std::min(first + chunk, end);
+            auto x = first;
+#ifdef __SSSE3__
+            const __m128i one = _mm_set1_epi16(1);
+            for (; x + 8 <= last; x += 8)
+            {
+                auto u = _mm_loadu_si128(reinterpret_cast<const __m128i*>(up + x));
+                auto ul = _mm_loadu_si128(reinterpret_cast<const __m128i*>(up + x - 1));
+                auto dl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(down + x - 1));
+                auto d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(down + x));
+                __m128i m;
+                if (farest)
+                {
+                    // Unsigned maximum as b + max(a - b, 0), and minimum as a - max(a - b, 0)
+                    m = _mm_add_epi16(_mm_subs_epu16(u, ul), ul);
+                    m = _mm_add_epi16(_mm_subs_epu16(m, dl), dl);
+                    m = _mm_add_epi16(_mm_subs_epu16(m, d), d);
+                }
+                else
+                {
+                    auto a = _mm_sub_epi16(u, one);
+                    auto b = _mm_sub_epi16(ul, one);
+                    m = _mm_sub_epi16(a, _mm_subs_epu16(a, b));
+                    b = _mm_sub_epi16(dl, one);
+                    m = _mm_sub_epi16(m, _mm_subs_epu16(m, b));
+                    b = _mm_sub_epi16(d, one);
+                    m = _mm_sub_epi16(m, _mm_subs_epu16(m, b));
+                }
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(around + x - first), m);
+            }
+#endif
+            for (; x < last; ++x)
+            {
+                if (farest)
+                    around[x - first] = std::max(std::max(up[x], up[x - 1]), std::max(down[x - 1], down[x]));
+                else
+                    around[x - first] = std::min(std::min(uint16_t(up[x] - 1), uint16_t(up[x - 1] - 1)),
+                                                 std::min(uint16_t(down[x - 1] - 1), uint16_t(down[x] - 1)));
+            }
+
+            // Selects rather than branches on the pixels being empty
+            for (x = first; x < last; ++x)
+            {
+                uint16_t filled;
+                if (farest)
+                    filled = std::max(around[x - first], row[x - 1]);
+                else
+                    filled = up[x] ? uint16_t(std::min(around[x - first], uint16_t(row[x - 1] - 1)) + 1) : 0;
+                row[x] = row[x] ? row[x] : filled;
+            }
+        }
+    }
+
     // The holes filling mode
     const uint8_t hole_fill_min = hf_fill_from_left;
     const uint8_t hole_fill_max = hf_max_value - 1;
@@ -23,7 +96,8 @@ namespace librealsense
         _width(0), _height(0), _stride(0), _bpp(0),
         _extension_type(RS2_EXTENSION_DEPTH_FRAME),
         _current_frm_size_pixels(0),
-        _hole_filling_mode(hole_fill_def)
+        _hole_filling_mode(hole_fill_def),
+        _threads(1)
     {
         _stream_filter.stream = RS2_STREAM_DEPTH;
         _stream_filter.format = RS2_FORMAT_Z16;
@@ -52,6 +126,11 @@ namespace librealsense
 
         register_option(RS2_OPTION_HOLES_FILL, hole_filling_mode);
 
+        auto max_threads = std::max<int>(std::thread::hardware_concurrency(), 1);
+        auto processing_threads = std::make_shared<ptr_option<int>>(1, max_threads, 1, 1, &_threads,
+            "Number of threads, including the calling one, that fill the holes of each frame row by row");
+        register_option(RS2_OPTION_PROCESSING_THREADS, processing_threads);
+
     }
 
     rs2::frame hole_filling_filter::process_frame(const rs2::frame_source& source, const rs2::frame& f)
@@ -59,11 +138,28 @@ namespace librealsense
         update_configuration(f);
         auto tgt = prepare_target_frame(f, source);
 
+        if (_threads <= 1)
+            _workers.reset();
+        else if (!_workers || int(_workers->size()) != _threads - 1)
+            _workers = std::make_shared<parallel_workers>(_threads - 1);
+
         // Hole filling pass
+#ifdef RS2_USE_CUDA_DEPTH_FILTERS
+        if (_hole_filling_mode >= hf_max_value)
+            throw invalid_value_exception(to_string()
+                << "Unsupported hole filling mode: " << _hole_filling_mode << " is out of range.");
+        if (!_cuda)
+            _cuda = std::make_shared<rscuda::depth_filters_cuda>();
+
+        _cuda->upload(tgt.get_data(), int(_width), int(_height), _extension_type == RS2_EXTENSION_DISPARITY_FRAME);
+        _cuda->hole_filling(_hole_filling_mode);
+        _cuda->download(const_cast<void*>(tgt.get_data()));
+#else
         if (_extension_type == RS2_EXTENSION_DISPARITY_FRAME)
             apply_hole_filling<float>(const_cast<void*>(tgt.get_data()));
         else
             apply_hole_filling<uint16_t>(const_cast<void*>(tgt.get_data()));
+#endif
 
         return tgt;
     }
@@ -92,6 +188,10 @@ namespace librealsense
 
     rs2::frame hole_filling_filter::prepare_target_frame(const rs2::frame& f, const rs2::frame_source& source)
     {
+        // A frame that nothing else references is filtered in place
+        if (auto tgt = reuse_input_frame(f, _target_stream_profile, int(_bpp), int(_width), int(_height), int(_stride), _extension_type))
+            return tgt;
+
         // Allocate and copy the content of the input data to the target
         rs2::frame tgt = source.allocate_video_frame(_target_stream_profile, f, int(_bpp), int(_width), int(_height), int(_stride), _extension_type);
 
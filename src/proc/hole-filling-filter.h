@@ -3,8 +3,51 @@
 // Enhancing the input video frame by filling missing data.
 #pragma once
 
+#include <atomic>
+#include <thread>
+
+#include "concurrency.h"
+
+#ifdef RS2_USE_CUDA_DEPTH_FILTERS
+namespace rscuda
+{
+    class depth_filters_cuda;
+}
+#endif
+
 namespace librealsense
 {
+    // Fill the holes of the columns [begin, end) of a row, 0 < begin, with the farest or the nearest of the pixels around them.
+    // The row above is read filled and the row below before it is filled, as the scan of the frame from its top left goes
+    template<typename T>
+    void holes_fill_around(T* row, size_t width, size_t begin, size_t end, bool farest)
+    {
+        auto empty = [](const T* ptr) { return std::is_floating_point<T>::value ? !*((const int *)ptr) : !*ptr; };
+
+        for (auto p = row + begin; p < row + end; ++p)
+        {
+            if (!empty(p))
+                continue;
+
+            T tmp = *(p - width);
+            const T* around[] = { p - width - 1, p - 1, p + width - 1, p + width };
+            for (auto q : around)
+            {
+                if (farest)
+                {
+                    if (*q > tmp)
+                        tmp = *q;
+                }
+                else if (!empty(q) && (*q < tmp))
+                    tmp = *q;
+            }
+            *p = tmp;
+        }
+    }
+
+    // The same for depth, its neighbourhoods selected with SSE ahead of the scan along the row
+    void holes_fill_around(uint16_t* row, size_t width, size_t begin, size_t end, bool farest);
+
     enum holes_filling_types : uint8_t
     {
         hf_fill_from_left,
@@ -34,13 +77,23 @@ namespace librealsense
             switch (_hole_filling_mode)
             {
             case hf_fill_from_left:
-                holes_fill_left(data, _width, _height, _stride);
+                // Every row is filled on its own
+                if (_workers)
+                    _workers->run_bands(_height, 1, [&](size_t begin, size_t end) { holes_fill_left(data + begin * _width, _width, end - begin, _stride); });
+                else
+                    holes_fill_left(data, _width, _height, _stride);
                 break;
             case hf_farest_from_around:
-                holes_fill_farest(data, _width, _height, _stride);
+                if (_workers)
+                    holes_fill_around_rows(data, true);
+                else
+                    holes_fill_farest(data, _width, _height, _stride);
                 break;
             case hf_nearest_from_around:
-                holes_fill_nearest(data, _width, _height, _stride);
+                if (_workers)
+                    holes_fill_around_rows(data, false);
+                else
+                    holes_fill_nearest(data, _width, _height, _stride);
                 break;
             default:
                 throw invalid_value_exception(to_string()
@@ -73,90 +126,52 @@ namespace librealsense
         template<typename T>
         inline void holes_fill_farest(T* image_data, size_t width, size_t height, size_t stride)
         {
-            std::function<bool(T*)> fp_oper = [](T* ptr) { return !*((int *)ptr); };
-            std::function<bool(T*)> uint_oper = [](T* ptr) { return !(*ptr); };
-            auto empty = (std::is_floating_point<T>::value) ? fp_oper : uint_oper;
-
-            T tmp = 0;
-            T * p = image_data + width;
-            T * q = nullptr;
-            for (int j = 1; j < height - 1; ++j)
-            {
-                ++p;
-                for (int i = 1; i < width; ++i)
-                {
-                    if (empty(p))
-                    {
-                        tmp = *(p - width);
-
-                        q = p - width - 1;
-                        if (*q > tmp)
-                            tmp = *q;
-
-                        q = p - 1;
-                        if (*q > tmp)
-                            tmp = *q;
-
-                        q = p + width - 1;
-                        if (*q > tmp)
-                            tmp = *q;
-
-                        q = p + width;
-                        if (*q > tmp)
-                            tmp = *q;
-
-                        *p = tmp;
-                    }
-
-                    p++;
-                }
-            }
+            for (size_t j = 1; j + 1 < height; ++j)
+                holes_fill_around(image_data + j * width, width, 1, width, true);
         }
 
         template<typename T>
         inline void holes_fill_nearest(T* image_data, size_t width, size_t height, size_t stride)
         {
-            std::function<bool(T*)> fp_oper = [](T* ptr) { return !*((int *)ptr); };
-            std::function<bool(T*)> uint_oper = [](T* ptr) { return !(*ptr); };
-            auto empty = (std::is_floating_point<T>::value) ? fp_oper : uint_oper;
+            for (size_t j = 1; j + 1 < height; ++j)
+                holes_fill_around(image_data + j * width, width, 1, width, false);
+        }
 
-            T tmp = 0;
-            T * p = image_data + width;
-            T * q = nullptr;
-            for (int j = 1; j < height - 1; ++j)
+        // The rows of the frame filled concurrently, each trailing the row above by a block of columns for its pixels to read
+        // the filled pixels above them, and the row below before that row is filled. The same results as the scan of a single thread
+        template<typename T>
+        void holes_fill_around_rows(T* image_data, bool farest)
+        {
+            const size_t block = 256;
+            if (_height < 3 || _width < 2)
+                return;
+
+            auto width = _width;
+            auto blocks = (width - 1 + block - 1) / block;
+            std::unique_ptr<std::atomic<size_t>[]> filled(new std::atomic<size_t>[_height]);
+            for (size_t j = 0; j < _height; ++j)
+                filled[j].store(0);
+            filled[0].store(blocks);
+
+            _workers->run(int(_height - 2), [&](int task)
             {
-                ++p;
-                for (int i = 1; i < width; ++i)
+                auto j = size_t(task) + 1;
+                auto row = image_data + j * width;
+                for (size_t b = 0; b < blocks; ++b)
                 {
-                    if (empty(p))
-                    {
-                        tmp = *(p - width);
-
-                        q = p - width - 1;
-                        if (!empty(q) && (*q < tmp))
-                            tmp = *q;
+                    auto above = std::min(b + 2, blocks);
+                    while (filled[j - 1].load(std::memory_order_acquire) < above)
+                        std::this_thread::yield();
 
-                        q = p - 1;
-                        if (!empty(q) && (*q < tmp))
-                            tmp = *q;
-
-                        q = p + width - 1;
-                        if (!empty(q) && (*q < tmp))
-                            tmp = *q;
-
-                        q = p + width;
-                        if (!empty(q) && (*q < tmp))
-                            tmp = *q;
-
-                        *p = tmp;
-                    }
-
-                    p++;
+                    auto begin = 1 + b * block;
+                    holes_fill_around(row, width, begin, std::min(begin + block, width), farest);
+                    filled[j].store(b + 1, std::memory_order_release);
                 }
-            }
+            });
         }
 
     private:
+        friend class depth_post_processing;
 
         size_t                  _width, _height, _stride;
         size_t                  _bpp;
@@ -165,5 +180,11 @@ namespace librealsense
         rs2::stream_profile     _source_stream_profile;
         rs2::stream_profile     _target_stream_profile;
         uint8_t                 _hole_filling_mode;
+        int                     _threads;
+        std::shared_ptr<parallel_workers> _workers;
+
+#ifdef RS2_USE_CUDA_DEPTH_FILTERS
+        std::shared_ptr<rscuda::depth_filters_cuda> _cuda;
+#endif
     };
 }
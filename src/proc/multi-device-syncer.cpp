@@ -0,0 +1,144 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include <algorithm>
+#include "source.h"
+#include "environment.h"
+#include "option.h"
+#include "proc/synthetic-stream.h"
+#include "proc/multi-device-syncer.h"
+
+namespace librealsense
+{
+    multi_device_syncer::multi_device_syncer()
+        : _latency_budget(0.f)
+    {
+        register_option(RS2_OPTION_SYNC_LATENCY_BUDGET, std::make_shared<ptr_option<float>>(0.f, 1000.f, 1.f, 0.f, &_latency_budget,
+            "Longest time, in milliseconds, a frameset is held back waiting for the frames of the other devices before it is emitted without them. "
+            "0 waits for as long as the devices keep streaming"));
+
+        auto f = [this](frame_holder frame, synthetic_source_interface* source)
+        {
+            dispatch(std::move(frame), source);
+        };
+        set_processing_callback(std::shared_ptr<rs2_frame_processor_callback>(
+            new internal_frame_processor_callback<decltype(f)>(f)));
+    }
+
+    multi_device_syncer::device_frames& multi_device_syncer::find_device(const frame_holder& frame)
+    {
+        const device_interface* dev = nullptr;
+        auto sensor = frame.frame->get_sensor();
+        if (sensor)
+            dev = &sensor->get_device();
+
+        for (auto&& d : _devices)
+            if (d->device == dev)
+                return *d;
+
+        _devices.push_back(std::unique_ptr<device_frames>(new device_frames{ dev, device_clock_mapping(), {}, 0., 1000. / 30, 0. }));
+        return *_devices.back();
+    }
+
+    double multi_device_syncer::frame_time(device_frames& device, frame_interface* f, double now)
+    {
+        auto ts = f->get_frame_timestamp();
+        if (f->get_frame_timestamp_domain() != RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK)
+            return ts;
+
+        // Frames of devices that do not report their arrival arrive now
+        auto host = f->get_frame_system_time();
+        device.clock.add(ts, host ? host : now);
+        return device.clock.to_host(ts);
+    }
+
+    bool multi_device_syncer::waits_for(const device_frames& device, double earliest, double tolerance, double oldest_arrival, double now) const
+    {
+        // The device stopped streaming
+        if (now - device.last_arrival > 5 * device.period)
+            return false;
+
+        // Its next frame is too late to match
+        if (device.next_expected > earliest + tolerance)
+            return false;
+
+        return _latency_budget <= 0 || now - oldest_arrival < _latency_budget;
+    }
+
+    void multi_device_syncer::dispatch(frame_holder frame, synthetic_source_interface* source)
+    {
+        std::vector<frame_holder> matches;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            auto now = environment::get_instance().get_time_service()->get_time();
+            auto& device = find_device(frame);
+
+            // The frames of a frameset were taken together, and the first of them stands for all
+            frame_interface* f = frame.frame;
+            auto composite = dynamic_cast<composite_frame*>(f);
+            if (composite && composite->get_embedded_frames_count())
+                f = composite->first();
+
+            auto time = frame_time(device, f, now);
+            auto fps = f->get_stream()->get_framerate();
+            if (fps)
+                device.period = 1000. / fps;
+            device.next_expected = time + device.period;
+            device.last_arrival = now;
+            device.frames.push_back({ std::move(frame), time, now });
+            if (device.frames.size() > QUEUE_MAX_SIZE)
+                device.frames.pop_front();
+
+            while (true)
+            {
+                device_frames* first = nullptr;
+                for (auto&& d : _devices)
+                    if (!d->frames.empty() && (!first || d->frames.front().time < first->frames.front().time))
+                        first = d.get();
+                if (!first)
+                    break;
+
+                // The frames of the other devices taken within half a frame of the earliest one
+                auto earliest = first->frames.front().time;
+                auto tolerance = first->period / 2;
+                auto oldest_arrival = now;
+                std::vector<device_frames*> matched;
+                for (auto&& d : _devices)
+                {
+                    if (!d->frames.empty() && d->frames.front().time - earliest < tolerance)
+                    {
+                        matched.push_back(d.get());
+                        oldest_arrival = std::min(oldest_arrival, d->frames.front().arrival);
+                    }
+                }
+
+                auto wait = false;
+                for (auto&& d : _devices)
+                {
+                    if (std::find(matched.begin(), matched.end(), d.get()) == matched.end() && waits_for(*d, earliest, tolerance, oldest_arrival, now))
+                    {
+                        wait = true;
+                        break;
+                    }
+                }
+                if (wait)
+                    break;
+
+                std::vector<frame_holder> match;
+                for (auto d : matched)
+                {
+                    match.push_back(std::move(d->frames.front().frame));
+                    d->frames.pop_front();
+                }
+
+                frame_holder composite = source->allocate_composite_frame(std::move(match));
+                if (composite.frame)
+                    matches.push_back(std::move(composite));
+            }
+        }
+
+        for (auto&& match : matches)
+            source->frame_ready(std::move(match));
+    }
+}
@@ -0,0 +1,50 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include "types.h"
+#include "proc/synthetic-stream.h"
+#include "clock-mapping.h"
+
+#include <array>
+#include <deque>
+#include <vector>
+#include <mutex>
+
+namespace librealsense
+{
+    // Matches the frames, or the framesets, of several devices into framesets of all of them.
+    // The hardware timestamps of every device are mapped onto the host clock, and the frames whose host times are within half
+    // a frame period are matched. A device is waited for while it keeps streaming, unless RS2_OPTION_SYNC_LATENCY_BUDGET runs out
+    class multi_device_syncer : public processing_block
+    {
+    public:
+        multi_device_syncer();
+
+    private:
+        struct pending_frame
+        {
+            frame_holder frame;
+            double time;        // Host time of the frame
+            double arrival;     // Time the frame reached the syncer
+        };
+
+        struct device_frames
+        {
+            const device_interface* device;
+            device_clock_mapping clock;
+            std::deque<pending_frame> frames;
+            double next_expected;
+            double period;
+            double last_arrival;
+        };
+
+        void dispatch(frame_holder frame, synthetic_source_interface* source);
+        device_frames& find_device(const frame_holder& frame);
+        double frame_time(device_frames& device, frame_interface* f, double now);
+        bool waits_for(const device_frames& device, double earliest, double tolerance, double oldest_arrival, double now) const;
+
+        std::vector<std::unique_ptr<device_frames>> _devices;
+        float _latency_budget;
+    };
+}
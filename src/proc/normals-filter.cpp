@@ -0,0 +1,180 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include "../include/librealsense2/rs.hpp"
+
+#include "proc/synthetic-stream.h"
+#include "proc/normals-filter.h"
+#include "option.h"
+#include "environment.h"
+#include "context.h"
+#include "parallel.h"
+
+#include <cmath>
+
+#ifdef __SSSE3__
+#include <tmmintrin.h> // For SSSE3 intrinsics
+#endif
+
+namespace librealsense
+{
+    namespace
+    {
+        // Neighbours further apart in depth, in meters, are on either side of an edge of the scene
+        const float max_depth_step = 0.05f;
+
+        // The sums of every pixel: the horizontal difference and the number of pixels it was taken at, and the same vertically
+        const int channels = 8;
+
+        // Difference of the neighbours on either side, when both have depth and are not across an edge
+        void difference(const float3* a, const float3* b, float* out)
+        {
+            if (a && b && a->z && b->z && std::fabs(a->z - b->z) <= 2 * max_depth_step)
+            {
+                out[0] = b->x - a->x;
+                out[1] = b->y - a->y;
+                out[2] = b->z - a->z;
+                out[3] = 1.f;
+            }
+            else
+            {
+                out[0] = out[1] = out[2] = out[3] = 0.f;
+            }
+        }
+
+        void get_differences(const float3* vertices, int width, int height, int y, float* out)
+        {
+            auto row = vertices + y * width;
+            auto above = y > 0 ? row - width : nullptr;
+            auto below = y + 1 < height ? row + width : nullptr;
+            for (int x = 0; x < width; ++x, out += channels)
+            {
+                difference(x > 0 ? row + x - 1 : nullptr, x + 1 < width ? row + x + 1 : nullptr, out);
+                difference(above ? above + x : nullptr, below ? below + x : nullptr, out + 4);
+            }
+        }
+
+        // sums[i] += add[i] - sub[i], for the count floats
+        void slide(float* sums, const float* add, const float* sub, int count)
+        {
+            int i = 0;
+#ifdef __SSSE3__
+            for (; i + 4 <= count; i += 4)
+                _mm_storeu_ps(sums + i, _mm_add_ps(_mm_loadu_ps(sums + i), _mm_sub_ps(_mm_loadu_ps(add + i), _mm_loadu_ps(sub + i))));
+#endif
+            for (; i < count; ++i)
+                sums[i] += add[i] - sub[i];
+        }
+
+        // Of the sums of the differences, facing the camera from the vertex
+        float3 get_normal(const float* sums, const float3& vertex)
+        {
+            if (!vertex.z || !sums[3] || !sums[7])
+                return{ 0.f, 0.f, 0.f };
+
+            // Of the vertical and horizontal differences, their number only scaling it
+            float3 n = { sums[5] * sums[2] - sums[6] * sums[1], sums[6] * sums[0] - sums[4] * sums[2], sums[4] * sums[1] - sums[5] * sums[0] };
+            auto length = std::sqrt(n.x * n.x + n.y * n.y + n.z * n.z);
+            if (!(length > 0))
+                return{ 0.f, 0.f, 0.f };
+            if (n.x * vertex.x + n.y * vertex.y + n.z * vertex.z > 0)
+                length = -length;
+            return{ n.x / length, n.y / length, n.z / length };
+        }
+
+        void estimate_rows(const float3* vertices, int width, int height, int radius, int first, int last, float3* normals)
+        {
+            // The differences of the rows of the window and of the row entering it
+            const int slots = 2 * radius + 2;
+            const int row_size = width * channels;
+            std::vector<float> rows(slots * row_size);
+            std::vector<float> zeros(row_size, 0.f);
+            std::vector<float> columns(row_size, 0.f);
+            auto row = [&](int y) { return rows.data() + (y % slots) * row_size; };
+
+            for (int y = std::max(first - radius, 0); y <= std::min(first + radius, height - 1); ++y)
+            {
+                get_differences(vertices, width, height, y, row(y));
+                slide(columns.data(), row(y), zeros.data(), row_size);
+            }
+
+            for (int y = first; y < last; ++y)
+            {
+                // The window of the first pixel of the row, slid across it
+                alignas(16) float sums[channels] = {};
+                for (int x = 0; x <= std::min(radius, width - 1); ++x)
+                    slide(sums, columns.data() + x * channels, zeros.data(), channels);
+
+                auto out = normals + y * width;
+                auto in = vertices + y * width;
+                for (int x = 0; x < width; ++x)
+                {
+                    out[x] = get_normal(sums, in[x]);
+                    auto enter = x + radius + 1 < width ? columns.data() + (x + radius + 1) * channels : zeros.data();
+                    auto leave = x - radius >= 0 ? columns.data() + (x - radius) * channels : zeros.data();
+                    slide(sums, enter, leave, channels);
+                }
+
+                // The window slid down to the next row
+                auto enter = y + radius + 1;
+                auto leave = y - radius;
+                if (enter < height)
+                    get_differences(vertices, width, height, enter, row(enter));
+                slide(columns.data(), enter < height ? row(enter) : zeros.data(), leave >= 0 ? row(leave) : zeros.data(), row_size);
+            }
+        }
+    }
+
+    void estimate_normals(const float3* vertices, int width, int height, int radius, float3* normals)
+    {
+        // Every band starts its window over, which bands of many rows make up for
+        parallel_for(0, height, std::max(32, 4 * radius), [&](int first, int last)
+        {
+            estimate_rows(vertices, width, height, radius, first, last, normals);
+        });
+    }
+
+    normals_filter::normals_filter()
+        : _window(2)
+    {
+        auto window = std::make_shared<ptr_option<int>>(1, 16, 1, 2, &_window,
+            "Half the side, in pixels, of the window of neighbours the normals are averaged over");
+        register_option(RS2_OPTION_NORMALS_WINDOW, window);
+    }
+
+    bool normals_filter::should_process(const rs2::frame& frame)
+    {
+        if (!frame || !frame.is<rs2::points>())
+            return false;
+
+        // Of the points of the whole depth image, in its order
+        auto points = frame.as<rs2::points>();
+        auto profile = frame.get_profile().as<rs2::video_stream_profile>();
+        return profile && frame.get_profile().format() == RS2_FORMAT_XYZ32F && !points.get_pixel_indices() &&
+            points.size() == size_t(profile.width()) * profile.height();
+    }
+
+    rs2::frame normals_filter::process_frame(const rs2::frame_source& source, const rs2::frame& f)
+    {
+        if (f.get_profile().get() != _source_stream_profile.get())
+        {
+            _source_stream_profile = f.get_profile();
+            _target_stream_profile = _source_stream_profile.clone(_source_stream_profile.stream_type(), _source_stream_profile.stream_index(), RS2_FORMAT_XYZ32F);
+            environment::get_instance().get_extrinsics_graph().register_same_extrinsics(
+                *(stream_interface*)(_source_stream_profile.get()->profile), *(stream_interface*)(_target_stream_profile.get()->profile));
+        }
+
+        auto profile = _source_stream_profile.as<rs2::video_stream_profile>();
+        auto width = profile.width();
+        auto height = profile.height();
+        auto bpp = int(sizeof(float3));
+        auto res = source.allocate_video_frame(_target_stream_profile, f, bpp, width, height, width * bpp, RS2_EXTENSION_VIDEO_FRAME);
+        if (!res)
+            return res;
+
+        auto points = f.as<rs2::points>();
+        estimate_normals(reinterpret_cast<const float3*>(points.get_vertices()), width, height, _window,
+            reinterpret_cast<float3*>(const_cast<void*>(res.get_data())));
+        return res;
+    }
+}
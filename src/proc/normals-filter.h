@@ -0,0 +1,32 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "synthetic-stream.h"
+
+namespace librealsense
+{
+    // Normals of the points of a whole depth image, in its order, of the differences between the neighbours on either side
+    // of every point averaged over a window of 2 * radius + 1 pixels, as with integral images. The sums of the window are
+    // slid down the columns and across the rows with SSE, in bands of rows run on the parallel runtime. Normals face the
+    // camera, and are zero for the points without depth or without neighbours on either side not across an edge
+    void estimate_normals(const float3* vertices, int width, int height, int radius, float3* normals);
+
+    // Computes the normal map of point clouds of whole depth images: a video frame of the normal of every vertex, as
+    // RS2_FORMAT_XYZ32F. The point cloud block computes the same normals into its points, see RS2_OPTION_NORMALS_WINDOW
+    class normals_filter : public generic_processing_block
+    {
+    public:
+        normals_filter();
+
+    protected:
+        bool should_process(const rs2::frame& frame) override;
+        rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
+
+    private:
+        int                     _window;
+        rs2::stream_profile     _source_stream_profile;
+        rs2::stream_profile     _target_stream_profile;
+    };
+}
@@ -6,6 +6,11 @@
 
 #include "proc/synthetic-stream.h"
 #include "proc/occlusion-filter.h"
+#include "image.h"
+
+#ifdef __SSSE3__
+#include <tmmintrin.h> // For SSSE3 intrinsics
+#endif
 
 namespace librealsense
 {
@@ -26,7 +31,11 @@ namespace librealsense
         case occlusion_none:
             break;
         case occlusion_monotonic_scan:
-            monotonic_heuristic_invalidation(points, uv_map, pix_coord);
+            // Every line is scanned on its own
+            for_each_band(_depth_intrinsics->height, [&](size_t begin, size_t end)
+            {
+                monotonic_heuristic_invalidation(points, uv_map, pix_coord, begin, end);
+            });
             break;
         case occlusion_exhaustic_search:
             comprehensive_invalidation(points, uv_map, pix_coord);
@@ -37,6 +46,13 @@ namespace librealsense
         }
     }
 
+    void occlusion_filter::for_each_band(size_t count, const std::function<void(size_t begin, size_t end)>& task) const
+    {
+        if (!_workers)
+            return task(0, count);
+        _workers->run_bands(count, 1, task);
+    }
+
     // IMPORTANT! This implementation is based on the assumption that the RGB sensor is positioned strictly to the left of the depth sensor.
     // namely D415/D435 and SR300. The implementation WILL NOT work properly for different setups
     // Heuristic occlusion invalidation algorithm:
@@ -45,15 +61,16 @@ namespace librealsense
     // -  The occlusion is designated as U coordinate for a given pixel is less than the U coordinate of the predecessing pixel.
     // -  The UV mapping for the occluded pixel is reset to (0,0). Later on the (0,0) coordinate in the texture map is overwritten
     //    with a invalidation color such as black/magenta according to the purpose (production/debugging)
-    void occlusion_filter::monotonic_heuristic_invalidation(float3* points, float2* uv_map, const std::vector<float2> & pix_coord) const
+    void occlusion_filter::monotonic_heuristic_invalidation(float3* points, float2* uv_map, const std::vector<float2> & pix_coord, size_t begin, size_t end) const
     {
         float occZTh = 0.1f; //meters
         int occDilationSz = 1;
-        auto pixels_ptr = pix_coord.data();
         auto points_width = _depth_intrinsics->width;
-        auto points_height = _depth_intrinsics->height;
+        auto pixels_ptr = pix_coord.data() + begin * points_width;
+        points += begin * points_width;
+        uv_map += begin * points_width;
 
-        for (size_t y = 0; y < points_height; ++y)
+        for (size_t y = begin; y < end; ++y)
         {
             float maxInLine = -1;
             float maxZ = 0;
@@ -90,6 +107,68 @@ namespace librealsense
         }
     }
 
+#ifdef __SSSE3__
+    // Handles 4 points per iteration, and returns how many of the count points were handled
+    static size_t get_texel_indices_sse(const float3* points, const float2* pix_coord, int* texel_indices, size_t count, int tex_width, int tex_height)
+    {
+        const __m128 min_z = _mm_set_ps1(0.0001f);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 width = _mm_set_ps1(float(tex_width));
+        const __m128 height = _mm_set_ps1(float(tex_height));
+        // The texel index y * width + x is a single multiply-add of 16-bit pairs, the texture being narrower than 32768 texels
+        const __m128i width_one = _mm_set1_epi32(tex_width | (1 << 16));
+        const __m128i invalid = _mm_set1_epi32(-1);
+
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            auto xy01 = _mm_loadu_ps(&pix_coord[i].x);
+            auto xy23 = _mm_loadu_ps(&pix_coord[i + 2].x);
+            auto x = _mm_shuffle_ps(xy01, xy23, _MM_SHUFFLE(2, 0, 2, 0));
+            auto y = _mm_shuffle_ps(xy01, xy23, _MM_SHUFFLE(3, 1, 3, 1));
+            auto z = _mm_set_ps(points[i + 3].z, points[i + 2].z, points[i + 1].z, points[i].z);
+
+            auto valid = _mm_and_ps(_mm_and_ps(_mm_cmpgt_ps(z, min_z), _mm_and_ps(_mm_cmpgt_ps(x, zero), _mm_cmplt_ps(x, width))),
+                _mm_and_ps(_mm_cmpgt_ps(y, zero), _mm_cmplt_ps(y, height)));
+
+            auto yx = _mm_or_si128(_mm_cvttps_epi32(y), _mm_slli_epi32(_mm_cvttps_epi32(x), 16));
+            auto index = _mm_madd_epi16(yx, width_one);
+
+            auto mask = _mm_castps_si128(valid);
+            _mm_storeu_si128((__m128i*)(texel_indices + i), _mm_or_si128(_mm_and_si128(mask, index), _mm_andnot_si128(mask, invalid)));
+        }
+        return i;
+    }
+#endif
+
+    void occlusion_filter::get_texel_indices(const float3* points, const float2* pix_coord, size_t begin, size_t end) const
+    {
+        int mapped_tex_width = _texels_intrinsics->width;
+        int mapped_tex_height = _texels_intrinsics->height;
+        auto texel_indices = _texel_indices.data();
+
+        size_t i = begin;
+#ifdef __SSSE3__
+        if (get_simd_level() >= simd_level::ssse3 && mapped_tex_width < 32768 && mapped_tex_height < 32768)
+            i += get_texel_indices_sse(points + begin, pix_coord + begin, texel_indices + begin, end - begin, mapped_tex_width, mapped_tex_height);
+#endif
+        for (; i < end; ++i)
+        {
+            auto depth_point = points + i;
+            auto mapped_pix = pix_coord + i;
+            if ((depth_point->z > 0.0001f) &&
+                (mapped_pix->x > 0.f) && (mapped_pix->x < mapped_tex_width) &&
+                (mapped_pix->y > 0.f) && (mapped_pix->y < mapped_tex_height))
+            {
+                texel_indices[i] = int((size_t)(mapped_pix->y)*mapped_tex_width + (size_t)(mapped_pix->x));
+            }
+            else
+            {
+                texel_indices[i] = -1;
+            }
+        }
+    }
+
     // Prepare texture map without occlusion that for every texture coordinate there no more than one depth point that is mapped to it
     // i.e. for every (u,v) map coordinate we select the depth point with minimum Z. all other points that are mapped to this texel will be invalidated
     // Algo input data:
@@ -100,10 +179,6 @@ namespace librealsense
     // each (i,j) cell holds the minimal Z among all the depth pixels that are mapped to the specific texel
     void occlusion_filter::comprehensive_invalidation(float3* points, float2* uv_map, const std::vector<float2> & pix_coord) const
     {
-        auto depth_points = points;
-        auto mapped_pix = pix_coord.data();
-        size_t mapped_tex_width = _texels_intrinsics->width;
-        size_t mapped_tex_height = _texels_intrinsics->height;
         size_t points_width = _depth_intrinsics->width;
         size_t points_height = _depth_intrinsics->height;
 
@@ -112,53 +187,41 @@ namespace librealsense
         // Clear previous data
         memset((void*)(_texels_depth.data()), 0, _texels_depth.size() * sizeof(float));
 
-        // Pass1 -generate texels mapping with minimal depth for each texel involved
-        for (size_t i = 0; i < points_height; i++)
+        // The texels of the depth points are independent of each other, and reused by both passes
+        _texel_indices.resize(points_width * points_height);
+        for_each_band(points_height, [&](size_t begin, size_t end)
         {
-            for (size_t j = 0; j < points_width; j++)
-            {
-                if ((depth_points->z > 0.0001f) &&
-                    (mapped_pix->x > 0.f) && (mapped_pix->x < mapped_tex_width) &&
-                    (mapped_pix->y > 0.f) && (mapped_pix->y < mapped_tex_height))
-                {
-                    size_t texel_index = (size_t)(mapped_pix->y)*mapped_tex_width + (size_t)(mapped_pix->x);
+            get_texel_indices(points, pix_coord.data(), begin * points_width, end * points_width);
+        });
 
-                    if ((_texels_depth[texel_index] < 0.0001f) || ((_texels_depth[texel_index] + z_threshold) > depth_points->z))
-                    {
-                        _texels_depth[texel_index] = depth_points->z;
-                    }
-                }
+        // Pass1 -generate texels mapping with minimal depth for each texel involved
+        // The result depends on the order in which the points reach a texel, so this pass stays sequential
+        for (size_t i = 0; i < points_height * points_width; i++)
+        {
+            auto texel_index = _texel_indices[i];
+            if (texel_index < 0)
+                continue;
 
-                ++depth_points;
-                ++mapped_pix;
+            if ((_texels_depth[texel_index] < 0.0001f) || ((_texels_depth[texel_index] + z_threshold) > points[i].z))
+            {
+                _texels_depth[texel_index] = points[i].z;
             }
         }
 
-        mapped_pix = pix_coord.data();
-        depth_points = points;
-        auto uv_ptr = uv_map;
-
         // Pass2 -invalidate depth texels with occlusion traits
-        for (size_t i = 0; i < points_height; i++)
+        for_each_band(points_height, [&](size_t begin, size_t end)
         {
-            for (size_t j = 0; j < points_width; j++)
+            for (size_t i = begin * points_width; i < end * points_width; i++)
             {
-                if ((depth_points->z > 0.0001f) &&
-                    (mapped_pix->x > 0.f) && (mapped_pix->x < mapped_tex_width) &&
-                    (mapped_pix->y > 0.f) && (mapped_pix->y < mapped_tex_height))
-                {
-                    size_t texel_index = (size_t)(mapped_pix->y)*mapped_tex_width + (size_t)(mapped_pix->x);
+                auto texel_index = _texel_indices[i];
+                if (texel_index < 0)
+                    continue;
 
-                    if ((_texels_depth[texel_index] > 0.0001f) && ((_texels_depth[texel_index] + z_threshold) < depth_points->z))
-                    {
-                        *uv_ptr = { 0.f, 0.f };
-                    }
+                if ((_texels_depth[texel_index] > 0.0001f) && ((_texels_depth[texel_index] + z_threshold) < points[i].z))
+                {
+                    uv_map[i] = { 0.f, 0.f };
                 }
-
-                ++depth_points;
-                ++mapped_pix;
-                ++uv_ptr;
             }
-        }
+        });
     }
 }
@@ -3,6 +3,7 @@
 
 #pragma once
 #include "../include/librealsense2/hpp/rs_frame.hpp"
+#include "concurrency.h"
 namespace librealsense
 {
     enum occlusion_rect_type : uint8_t {
@@ -26,17 +27,27 @@ namespace librealsense
 
         void set_texel_intrinsics(const rs2_intrinsics& in);
         void set_depth_intrinsics(const rs2_intrinsics& in) { _depth_intrinsics = in; }
+
+        // Null for running on the calling thread alone
+        void set_workers(std::shared_ptr<parallel_workers> workers) { _workers = workers; }
     private:
 
         friend class pointcloud;
 
-        void monotonic_heuristic_invalidation(float3* points, float2* uv_map, const std::vector<float2> & pix_coord) const;
+        void monotonic_heuristic_invalidation(float3* points, float2* uv_map, const std::vector<float2> & pix_coord, size_t begin, size_t end) const;
 
         void comprehensive_invalidation(float3* points, float2* uv_map, const std::vector<float2> & pix_coord) const;
 
+        // Texel of every depth point in [begin, end) that is mapped inside the texture with a valid Z, -1 otherwise
+        void get_texel_indices(const float3* points, const float2* pix_coord, size_t begin, size_t end) const;
+
+        void for_each_band(size_t count, const std::function<void(size_t begin, size_t end)>& task) const;
+
         optional_value<rs2_intrinsics>              _depth_intrinsics;
         optional_value<rs2_intrinsics>              _texels_intrinsics;
         mutable std::vector<float>                  _texels_depth; // Temporal translation table of (mapped_x*mapped_y) holds the minimal depth value among all depth pixels mapped to that texel
         occlusion_rect_type                         _occlusion_filter;
+        mutable std::vector<int>                    _texel_indices; // Texel of every depth pixel, shared by the passes of the exhaustive search
+        std::shared_ptr<parallel_workers>           _workers;
     };
 }
@@ -0,0 +1,271 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include "../include/librealsense2/rs.hpp"
+#include "../include/librealsense2/rsutil.h"
+
+#include "proc/synthetic-stream.h"
+#include "proc/pointcloud-merger.h"
+#include "option.h"
+#include "environment.h"
+#include "context.h"
+#include "parallel.h"
+#include "projection.h"
+
+namespace librealsense
+{
+    namespace
+    {
+        // Rows of a band, for the valid points of the bands to be counted in parallel before they are written
+        const int band_rows = 16;
+
+        bool is_depth(const rs2::frame& f)
+        {
+            return f.is<rs2::depth_frame>() && f.get_profile().format() == RS2_FORMAT_Z16;
+        }
+    }
+
+    pointcloud_merger::pointcloud_merger()
+        : _world(std::make_shared<stream>(RS2_STREAM_ANY)), _compact_points(1), _voxel_size(0.f), _voxel_point(voxel_centroid), _set_frames(0)
+    {
+        auto compact = std::make_shared<ptr_option<uint8_t>>(0, 1, 1, 1, &_compact_points,
+            "Output only the points with valid depth");
+        compact->set_description(0.f, "Off");
+        compact->set_description(1.f, "Valid points");
+        register_option(RS2_OPTION_COMPACT_POINTS, compact);
+
+        auto voxel_size = std::make_shared<ptr_option<float>>(0.f, 1.f, 0.001f, 0.f, &_voxel_size,
+            "Edge length, in meters, of the voxels the overlapping points of the cameras are merged in, 0 for no merge");
+        register_option(RS2_OPTION_VOXEL_SIZE, voxel_size);
+
+        auto voxel_point = std::make_shared<ptr_option<uint8_t>>(
+            voxel_centroid,
+            voxel_point_max - 1, 1,
+            voxel_centroid,
+            &_voxel_point,
+            "Point output for every occupied voxel");
+        voxel_point->set_description(0.f, "Centroid");
+        voxel_point->set_description(1.f, "First hit");
+        register_option(RS2_OPTION_VOXEL_POINT, voxel_point);
+    }
+
+    void pointcloud_merger::set_world_extrinsics(const stream_interface& stream, const rs2_extrinsics& to_world)
+    {
+        environment::get_instance().get_extrinsics_graph().register_extrinsics(stream, *_world, to_world);
+    }
+
+    bool pointcloud_merger::should_process(const rs2::frame& frame)
+    {
+        if (!frame)
+            return false;
+
+        // The frames of a frameset follow it, and are merged with it
+        if (auto set = frame.as<rs2::frameset>())
+        {
+            _set_frames = set.size();
+            for (auto&& f : set)
+                if (is_depth(f))
+                    return true;
+            return false;
+        }
+        if (_set_frames)
+        {
+            --_set_frames;
+            return false;
+        }
+        return is_depth(frame);
+    }
+
+    void pointcloud_merger::add_camera(const rs2::depth_frame& depth, std::vector<camera>& previous)
+    {
+        auto profile = depth.get_profile();
+        auto it = std::find_if(previous.begin(), previous.end(), [&](const camera& c) { return c.profile.get() == profile.get(); });
+        if (it != previous.end())
+        {
+            _cameras.push_back(std::move(*it));
+            previous.erase(it);
+        }
+        else
+        {
+            camera c;
+            c.profile = profile;
+            c.intrinsics = profile.as<rs2::video_stream_profile>().get_intrinsics();
+            if (c.intrinsics.width != depth.get_width() || c.intrinsics.height != depth.get_height())
+                throw invalid_value_exception("Depth frames are merged at the size of their intrinsics");
+            auto sensor = ((frame_interface*)depth.get())->get_sensor().get();
+            c.depth_units = sensor->get_option(RS2_OPTION_DEPTH_UNITS).query();
+            c.to_world = {};
+            _cameras.push_back(std::move(c));
+        }
+
+        // Fetched on every frame, the cache of the graph standing for as long as it is unchanged
+        auto&& c = _cameras.back();
+        rs2_extrinsics to_world;
+        if (!environment::get_instance().get_extrinsics_graph().try_fetch_extrinsics(*(stream_interface*)(profile.get()->profile), *_world, &to_world))
+            throw invalid_value_exception(to_string() << "No extrinsics to the world of the " << rs2_stream_to_string(profile.stream_type())
+                << " stream " << profile.unique_id() << ", see set_world_extrinsics");
+
+        if (c.rays.empty() || memcmp(&to_world, &c.to_world, sizeof(to_world)))
+        {
+            c.to_world = to_world;
+            auto rotation = to_world;
+            rotation.translation[0] = rotation.translation[1] = rotation.translation[2] = 0.f;
+
+            c.rays.resize(c.intrinsics.width * c.intrinsics.height);
+            std::vector<float2> pixels(c.intrinsics.width);
+            std::vector<float> depth(c.intrinsics.width, c.depth_units);
+            std::vector<float3> points(c.intrinsics.width);
+            auto ray = c.rays.data();
+            for (int y = 0; y < c.intrinsics.height; ++y)
+            {
+                for (int x = 0; x < c.intrinsics.width; ++x)
+                    pixels[x] = { float(x), float(y) };
+                deproject_pixels(c.intrinsics, pixels.data(), depth.data(), points.data(), points.size());
+                for (auto&& point : points)
+                    rs2_transform_point_to_point(&(ray++)->x, &rotation, &point.x);
+            }
+        }
+    }
+
+    void pointcloud_merger::merge(const std::vector<rs2::depth_frame>& frames, bool compact, float3* vertices)
+    {
+        parallel_for(0, int(_bands.size()), 1, [&](int first, int last)
+        {
+            for (int b = first; b < last; ++b)
+            {
+                auto&& band = _bands[b];
+                auto&& c = _cameras[band.camera];
+                auto&& depth = frames[band.camera];
+                auto data = static_cast<const uint8_t*>(depth.get_data());
+                auto stride = depth.get_stride_in_bytes();
+                auto width = c.intrinsics.width;
+                auto t = c.to_world.translation;
+                auto out = vertices + band.offset;
+
+                for (int y = band.first; y < band.last; ++y)
+                {
+                    auto row = reinterpret_cast<const uint16_t*>(data + y * stride);
+                    auto rays = c.rays.data() + y * width;
+                    if (compact)
+                    {
+                        for (int x = 0; x < width; ++x)
+                        {
+                            if (!row[x])
+                                continue;
+                            float z = row[x];
+                            *out++ = { rays[x].x * z + t[0], rays[x].y * z + t[1], rays[x].z * z + t[2] };
+                        }
+                    }
+                    else
+                    {
+                        // The pixels without depth stay at the origin, with no branch for the loop to be vectorized
+                        for (int x = 0; x < width; ++x)
+                        {
+                            float z = row[x];
+                            float valid = row[x] ? 1.f : 0.f;
+                            out[x] = { rays[x].x * z + t[0] * valid, rays[x].y * z + t[1] * valid, rays[x].z * z + t[2] * valid };
+                        }
+                        out += width;
+                    }
+                }
+            }
+        });
+    }
+
+    rs2::frame pointcloud_merger::process_frame(const rs2::frame_source& source, const rs2::frame& f)
+    {
+        std::vector<rs2::depth_frame> frames;
+        if (auto set = f.as<rs2::frameset>())
+        {
+            for (auto&& frame : set)
+                if (is_depth(frame))
+                    frames.push_back(frame);
+        }
+        else
+        {
+            frames.push_back(f);
+        }
+
+        std::vector<camera> previous;
+        previous.swap(_cameras);
+        for (auto&& depth : frames)
+            add_camera(depth, previous);
+
+        // The output is of the profile of the first camera, in the coordinates of the world
+        if (frames[0].get_profile().get() != _source_stream_profile.get())
+        {
+            _source_stream_profile = frames[0].get_profile();
+            _target_stream_profile = _source_stream_profile.clone(_source_stream_profile.stream_type(), _source_stream_profile.stream_index(), RS2_FORMAT_XYZ32F);
+            environment::get_instance().get_extrinsics_graph().register_same_extrinsics(*_world, *(stream_interface*)(_target_stream_profile.get()->profile));
+        }
+
+        _bands.clear();
+        size_t size = 0;
+        for (size_t i = 0; i < _cameras.size(); ++i)
+        {
+            auto&& intrinsics = _cameras[i].intrinsics;
+            for (int first = 0; first < intrinsics.height; first += band_rows)
+            {
+                _bands.push_back({ i, first, std::min(first + band_rows, intrinsics.height), size });
+                size += size_t(intrinsics.width) * (_bands.back().last - first);
+            }
+        }
+
+        // Compacted, every band starts after the valid points of the previous ones
+        bool compact = _compact_points != 0;
+        if (compact)
+        {
+            std::vector<size_t> counts(_bands.size());
+            parallel_for(0, int(_bands.size()), 4, [&](int first, int last)
+            {
+                for (int b = first; b < last; ++b)
+                {
+                    auto&& band = _bands[b];
+                    auto&& depth = frames[band.camera];
+                    auto data = static_cast<const uint8_t*>(depth.get_data());
+                    auto width = _cameras[band.camera].intrinsics.width;
+                    size_t count = 0;
+                    for (int y = band.first; y < band.last; ++y)
+                    {
+                        auto row = reinterpret_cast<const uint16_t*>(data + y * depth.get_stride_in_bytes());
+                        for (int x = 0; x < width; ++x)
+                            count += row[x] != 0;
+                    }
+                    counts[b] = count;
+                }
+            });
+
+            size = 0;
+            for (size_t b = 0; b < _bands.size(); ++b)
+            {
+                _bands[b].offset = size;
+                size += counts[b];
+            }
+        }
+
+        rs2::frame res;
+        if (_voxel_size > 0)
+        {
+            _merged.resize(size);
+            merge(frames, compact, _merged.data());
+            _grid.reset(_voxel_size, _voxel_point == voxel_centroid, size);
+            _grid.add(_merged.data(), nullptr, size);
+
+            res = source.allocate_points(_target_stream_profile, frames[0], static_cast<int>(_grid.size()), false);
+            if (!res)
+                return res;
+            auto pframe = (librealsense::points*)(res.get());
+            _grid.get_points(pframe->get_vertices(), pframe->get_texture_coordinates());
+        }
+        else
+        {
+            res = source.allocate_points(_target_stream_profile, frames[0], static_cast<int>(size), false);
+            if (!res)
+                return res;
+            auto pframe = (librealsense::points*)(res.get());
+            merge(frames, compact, pframe->get_vertices());
+            memset(pframe->get_texture_coordinates(), 0, size * sizeof(float2));
+        }
+        return res;
+    }
+}
@@ -0,0 +1,66 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "synthetic-stream.h"
+#include "voxel-filter.h"
+#include "stream.h"
+
+namespace librealsense
+{
+    // Merges the depth frames of several cameras, such as the framesets of the multi-device syncer, into a single point
+    // cloud in the coordinates of the world. The extrinsics of the cameras to the world are those of the extrinsics graph,
+    // between the streams of the depth frames and the world stream of the block, which set_world_extrinsics registers.
+    // Every pixel is deprojected and transformed at once, in bands of rows run on the parallel runtime, into the output frame
+    class pointcloud_merger : public generic_processing_block
+    {
+    public:
+        pointcloud_merger();
+
+        // The extrinsics from the stream, or from any stream the extrinsics graph links it to, to the world
+        void set_world_extrinsics(const stream_interface& stream, const rs2_extrinsics& to_world);
+
+    protected:
+        bool should_process(const rs2::frame& frame) override;
+        rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
+
+    private:
+        struct camera
+        {
+            rs2::stream_profile     profile;
+            rs2_intrinsics          intrinsics;
+            float                   depth_units;
+            rs2_extrinsics          to_world;
+            // The rotated deprojection of every pixel at a depth of one depth unit, which the points scale with before
+            // the translation to the world
+            std::vector<float3>     rays;
+        };
+
+        // A band of rows of a camera, and the index of its first point in the output
+        struct band
+        {
+            size_t                  camera;
+            int                     first, last;
+            size_t                  offset;
+        };
+
+        // Appends the camera of the frame to those of the frameset, reusing its state of the previous frameset
+        void add_camera(const rs2::depth_frame& depth, std::vector<camera>& previous);
+        void merge(const std::vector<rs2::depth_frame>& frames, bool compact, float3* vertices);
+
+        std::shared_ptr<stream_interface>   _world;
+        uint8_t                 _compact_points;
+        float                   _voxel_size;        // 0 for no deduplication
+        uint8_t                 _voxel_point;
+        voxel_grid              _grid;
+        size_t                  _set_frames;        // Frames of the last frameset still to be offered to should_process
+
+        std::vector<camera>     _cameras;           // Of the frames of the last frameset, in its order
+        std::vector<band>       _bands;
+        std::vector<float3>     _merged;            // Points to deduplicate
+
+        rs2::stream_profile     _source_stream_profile;
+        rs2::stream_profile     _target_stream_profile;
+    };
+}
@@ -11,6 +11,10 @@
 #include "option.h"
 #include "environment.h"
 #include "context.h"
+#include "image.h"
+#include "projection.h"
+#include "pointcloud_avx.h"
+#include "normals-filter.h"
 
 #include <iostream>
 
@@ -20,20 +24,27 @@
 #ifdef __SSSE3__
 #include <tmmintrin.h> // For SSSE3 intrinsics
 #endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
 
 
 namespace librealsense
 {
     template<class MAP_DEPTH> void deproject_depth(float * points, const rs2_intrinsics & intrin, const uint16_t * depth, MAP_DEPTH map_depth)
     {
+        // A row at a time, through the batch deprojection
+        std::vector<float2> pixels(intrin.width);
+        std::vector<float> row(intrin.width);
         for (int y = 0; y < intrin.height; ++y)
         {
             for (int x = 0; x < intrin.width; ++x)
             {
-                const float pixel[] = { (float)x, (float)y };
-                rs2_deproject_pixel_to_point(points, &intrin, pixel, map_depth(*depth++));
-                points += 3;
+                pixels[x] = { (float)x, (float)y };
+                row[x] = map_depth(*depth++);
             }
+            deproject_pixels(intrin, pixels.data(), row.data(), reinterpret_cast<float3*>(points), intrin.width);
+            points += 3 * intrin.width;
         }
     }
 
@@ -63,10 +74,10 @@ namespace librealsense
     void pointcloud::inspect_depth_frame(const rs2::frame& depth)
     {
         if (!_output_stream.get() || _depth_stream->unique_id() != depth.get_profile().unique_id() ||
-            stream_changed(*_depth_stream, depth.get_profile()))
+            stream_changed(*_depth_stream, depth.get_profile()) || _output_stream->format() != get_points_format())
         {
             _output_stream = std::make_shared<rs2::video_stream_profile>(depth.get_profile().as<rs2::video_stream_profile>().clone(
-                RS2_STREAM_DEPTH, depth.get_profile().stream_index(), RS2_FORMAT_XYZ32F));
+                RS2_STREAM_DEPTH, depth.get_profile().stream_index(), get_points_format()));
             _depth_stream = std::make_shared<rs2::video_stream_profile>(depth.get_profile().as<rs2::video_stream_profile>());
             environment::get_instance().get_extrinsics_graph().register_same_extrinsics(*_output_stream->get()->profile, *depth.get_profile().get()->profile);
             _depth_intrinsics = optional_value<rs2_intrinsics>();
@@ -85,7 +96,7 @@ namespace librealsense
                 _depth_intrinsics = video.get_intrinsics();
                 _pixels_map.resize(_depth_intrinsics->height*_depth_intrinsics->width);
                 _occlusion_filter->set_depth_intrinsics(_depth_intrinsics.value());
-#ifdef __SSSE3__
+#if defined(__SSSE3__) || defined(__ARM_NEON) || defined(__ARM_NEON__)
                 pre_compute_x_y_map(); //compute the x and y map once for optimization
 #endif
                 found_depth_intrinsics = true;
@@ -153,33 +164,7 @@ namespace librealsense
 
     void pointcloud::pre_compute_x_y_map()
     {
-        _pre_compute_map_x.resize(_depth_intrinsics->width*_depth_intrinsics->height);
-        _pre_compute_map_y.resize(_depth_intrinsics->width*_depth_intrinsics->height);
-
-        for (int h = 0; h < _depth_intrinsics->height; ++h)
-        {
-            for (int w = 0; w < _depth_intrinsics->width; ++w)
-            {
-                const float pixel[] = { (float)w, (float)h };
-
-                float x = (pixel[0] - _depth_intrinsics->ppx) / _depth_intrinsics->fx;
-                float y = (pixel[1] - _depth_intrinsics->ppy) / _depth_intrinsics->fy;
-
-
-                if (_depth_intrinsics->model == RS2_DISTORTION_INVERSE_BROWN_CONRADY)
-                {
-                    float r2 = x * x + y * y;
-                    float f = 1 + _depth_intrinsics->coeffs[0] * r2 + _depth_intrinsics->coeffs[1] * r2*r2 + _depth_intrinsics->coeffs[4] * r2*r2*r2;
-                    float ux = x * f + 2 * _depth_intrinsics->coeffs[2] * x*y + _depth_intrinsics->coeffs[3] * (r2 + 2 * x*x);
-                    float uy = y * f + 2 * _depth_intrinsics->coeffs[3] * x*y + _depth_intrinsics->coeffs[2] * (r2 + 2 * y*y);
-                    x = ux;
-                    y = uy;
-                }
-
-                _pre_compute_map_x[h*_depth_intrinsics->width + w] = x;
-                _pre_compute_map_y[h*_depth_intrinsics->width + w] = y;
-            }
-        }
+        deprojection_maps(*_depth_intrinsics, _pre_compute_map_x, _pre_compute_map_y);
     }
 
 #ifdef __SSSE3__
@@ -380,6 +365,105 @@ namespace librealsense
 
 #endif
 
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    void get_points_neon(const uint16_t* depth,
+        const unsigned int size,
+        const float* pre_compute_x,
+        const float* pre_compute_y,
+        float depth_scale,
+        float3* points)
+    {
+        auto point = reinterpret_cast<float*>(points);
+
+        unsigned int i = 0;
+        for (; i + 4 <= size; i += 4, point += 12)
+        {
+            auto z = vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vld1_u16(depth + i))), depth_scale);
+            float32x4x3_t xyz = { { vmulq_f32(z, vld1q_f32(pre_compute_x + i)), vmulq_f32(z, vld1q_f32(pre_compute_y + i)), z } };
+            vst3q_f32(point, xyz);
+        }
+        for (; i < size; ++i, point += 3)
+        {
+            auto z = depth_scale * depth[i];
+            point[0] = z * pre_compute_x[i];
+            point[1] = z * pre_compute_y[i];
+            point[2] = z;
+        }
+    }
+
+    static inline float32x4_t div_neon(float32x4_t a, float32x4_t b)
+    {
+#ifdef __aarch64__
+        return vdivq_f32(a, b);
+#else
+        // ARMv7 has no vector division, two Newton-Raphson steps refine the reciprocal estimate to about 1 ulp
+        auto inv = vrecpeq_f32(b);
+        inv = vmulq_f32(vrecpsq_f32(b, inv), inv);
+        inv = vmulq_f32(vrecpsq_f32(b, inv), inv);
+        return vmulq_f32(a, inv);
+#endif
+    }
+
+    // Projects 4 points per iteration, like get_texture_map. Returns how many of the size points were mapped,
+    // which is none for F-Theta lenses, whose distortion is left to the generic code
+    unsigned int get_texture_map_neon(const float3* points,
+        const unsigned int size,
+        const rs2_intrinsics &other_intrinsics,
+        const rs2_extrinsics& extr,
+        float2* tex_ptr,
+        float2* pixels_ptr)
+    {
+        if (other_intrinsics.model == RS2_DISTORTION_FTHETA)
+            return 0;
+
+        auto point = reinterpret_cast<const float*>(points);
+        auto res = reinterpret_cast<float*>(tex_ptr);
+        auto res1 = reinterpret_cast<float*>(pixels_ptr);
+        const bool brown_conrady = other_intrinsics.model == RS2_DISTORTION_MODIFIED_BROWN_CONRADY;
+        const float* c = other_intrinsics.coeffs;
+        auto w = vdupq_n_f32(float(other_intrinsics.width));
+        auto h = vdupq_n_f32(float(other_intrinsics.height));
+        auto zero = vdupq_n_f32(0);
+
+        unsigned int i = 0;
+        for (; i + 4 <= size; i += 4, point += 12, res += 8, res1 += 8)
+        {
+            auto xyz = vld3q_f32(point);
+
+            // Same order of operations as rs2_transform_point_to_point
+            auto p_x = vaddq_f32(vmlaq_n_f32(vmlaq_n_f32(vmulq_n_f32(xyz.val[0], extr.rotation[0]), xyz.val[1], extr.rotation[3]), xyz.val[2], extr.rotation[6]), vdupq_n_f32(extr.translation[0]));
+            auto p_y = vaddq_f32(vmlaq_n_f32(vmlaq_n_f32(vmulq_n_f32(xyz.val[0], extr.rotation[1]), xyz.val[1], extr.rotation[4]), xyz.val[2], extr.rotation[7]), vdupq_n_f32(extr.translation[1]));
+            auto p_z = vaddq_f32(vmlaq_n_f32(vmlaq_n_f32(vmulq_n_f32(xyz.val[0], extr.rotation[2]), xyz.val[1], extr.rotation[5]), xyz.val[2], extr.rotation[8]), vdupq_n_f32(extr.translation[2]));
+
+            p_x = div_neon(p_x, p_z);
+            p_y = div_neon(p_y, p_z);
+
+            if (brown_conrady)
+            {
+                auto r2 = vmlaq_f32(vmulq_f32(p_x, p_x), p_y, p_y);
+                auto f = vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(1), r2, c[0]), vmulq_f32(r2, r2), c[1]), vmulq_f32(r2, vmulq_f32(r2, r2)), c[4]);
+                auto x_f = vmulq_f32(p_x, f);
+                auto y_f = vmulq_f32(p_y, f);
+                auto xy = vmulq_f32(x_f, y_f);
+                p_x = vmlaq_n_f32(vmlaq_n_f32(x_f, xy, 2 * c[2]), vmlaq_n_f32(r2, vmulq_f32(x_f, x_f), 2), c[3]);
+                p_y = vmlaq_n_f32(vmlaq_n_f32(y_f, xy, 2 * c[3]), vmlaq_n_f32(r2, vmulq_f32(y_f, y_f), 2), c[2]);
+            }
+
+            //zero the x and y if z is zero
+            auto valid = vmvnq_u32(vceqq_f32(xyz.val[2], zero));
+            p_x = vbslq_f32(valid, vmlaq_n_f32(vdupq_n_f32(other_intrinsics.ppx), p_x, other_intrinsics.fx), zero);
+            p_y = vbslq_f32(valid, vmlaq_n_f32(vdupq_n_f32(other_intrinsics.ppy), p_y, other_intrinsics.fy), zero);
+
+            float32x4x2_t pixel = { { p_x, p_y } };
+            vst2q_f32(res1, pixel);
+
+            float32x4x2_t tex = { { div_neon(p_x, w), div_neon(p_y, h) } };
+            vst2q_f32(res, tex);
+        }
+        return i;
+    }
+#endif
+
     void get_texture_map(const float3* points,
         const unsigned int width,
         const unsigned int height,
@@ -388,83 +472,507 @@ namespace librealsense
         float2* tex_ptr,
         float2* pixels_ptr)
     {
-        for (unsigned int y = 0; y < height; ++y)
+        // The points are transformed, then projected together through the batch projection
+        const size_t count = size_t(width) * height;
+        std::vector<float3> transformed(count);
+        for (size_t i = 0; i < count; ++i)
+            transformed[i] = transform(&extr, points[i]);
+        project_points(other_intrinsics, transformed.data(), pixels_ptr, count);
+
+        for (size_t i = 0; i < count; ++i)
         {
-            for (unsigned int x = 0; x < width; ++x)
+            // Store intermediate results for poincloud filters
+            if (points[i].z)
             {
-                if (points->z)
-                {
-                    auto trans = transform(&extr, *points);
-                    //auto tex_xy = project_to_texcoord(&mapped_intr, trans);
-                    // Store intermediate results for poincloud filters
-                    *pixels_ptr = project(&other_intrinsics, trans);
-                    auto tex_xy = pixel_to_texcoord(&other_intrinsics, *pixels_ptr);
+                tex_ptr[i] = pixel_to_texcoord(&other_intrinsics, pixels_ptr[i]);
+            }
+            else
+            {
+                tex_ptr[i] = { 0.f, 0.f };
+                pixels_ptr[i] = { 0.f, 0.f };
+            }
+        }
+    }
 
-                    *tex_ptr = tex_xy;
-                }
-                else
-                {
-                    *tex_ptr = { 0.f, 0.f };
-                    *pixels_ptr = { 0.f, 0.f };
-                }
-                ++points;
-                ++tex_ptr;
-                ++pixels_ptr;
+    // The texture coordinates of points computed without them, when they are first read. The same as get_texture_map, in chunks
+    // that stay in the cache instead of buffers of the whole frame
+    void map_texture_coordinates(const float3* points, float2* tex_ptr, size_t count, const rs2_intrinsics& other_intrinsics, const rs2_extrinsics& extr)
+    {
+        const size_t chunk = 256;
+        float3 transformed[chunk];
+        for (size_t begin = 0; begin < count; begin += chunk)
+        {
+            auto n = std::min(chunk, count - begin);
+            for (size_t i = 0; i < n; ++i)
+                transformed[i] = transform(&extr, points[begin + i]);
+            project_points(other_intrinsics, transformed, tex_ptr + begin, n);
+
+            for (size_t i = begin; i < begin + n; ++i)
+                tex_ptr[i] = points[i].z ? pixel_to_texcoord(&other_intrinsics, tex_ptr[i]) : float2{ 0.f, 0.f };
+        }
+    }
+
+    // The same for planar vertices, through the batch projection of the structure of arrays layout
+    void map_planar_texture_coordinates(const float* x, const float* y, const float* z, float2* tex_ptr, size_t count,
+        const rs2_intrinsics& other_intrinsics, const rs2_extrinsics& extr)
+    {
+        const size_t chunk = 256;
+        float tx[chunk], ty[chunk], tz[chunk], px[chunk], py[chunk];
+        const auto& r = extr.rotation;
+        const auto& t = extr.translation;
+        for (size_t begin = 0; begin < count; begin += chunk)
+        {
+            auto n = std::min(chunk, count - begin);
+            // Same order of operations as rs2_transform_point_to_point
+            for (size_t i = 0; i < n; ++i)
+            {
+                auto j = begin + i;
+                tx[i] = r[0] * x[j] + r[3] * y[j] + r[6] * z[j] + t[0];
+                ty[i] = r[1] * x[j] + r[4] * y[j] + r[7] * z[j] + t[1];
+                tz[i] = r[2] * x[j] + r[5] * y[j] + r[8] * z[j] + t[2];
             }
+            project_points(other_intrinsics, tx, ty, tz, px, py, n);
+
+            for (size_t i = 0; i < n; ++i)
+                tex_ptr[begin + i] = z[begin + i] ? pixel_to_texcoord(&other_intrinsics, { px[i], py[i] }) : float2{ 0.f, 0.f };
         }
     }
 
-    rs2::frame pointcloud::process_depth_frame(const rs2::frame_source& source, const rs2::depth_frame& depth)
+    uint16_t float_to_half(float value)
     {
-        auto res = source.allocate_points(*_output_stream, depth);
-        auto pframe = (librealsense::points*)(res.get());
+        uint32_t x;
+        memcpy(&x, &value, sizeof(x));
+        uint32_t sign = (x >> 16) & 0x8000;
+        uint32_t abs = x & 0x7fffffff;
+
+        if (abs > 0x7f800000) // NaN
+            return static_cast<uint16_t>(sign | 0x7e00 | ((abs >> 13) & 0x3ff));
+        if (abs == 0x7f800000)
+            return static_cast<uint16_t>(sign | 0x7c00);
+        if (abs >= 0x477ff000) // Rounds to 65520 and above
+            return static_cast<uint16_t>(sign | 0x7c00);
+        if (abs < 0x38800000) // Below the smallest normal half, 2^-14
+        {
+            if (abs < 0x33000000)
+                return static_cast<uint16_t>(sign);
+            uint32_t mantissa = (abs & 0x7fffff) | 0x800000;
+            uint32_t shift = 126 - (abs >> 23);
+            uint32_t h = mantissa >> shift;
+            uint32_t rest = mantissa & ((1u << shift) - 1), halfway = 1u << (shift - 1);
+            if (rest > halfway || (rest == halfway && (h & 1)))
+                ++h;
+            return static_cast<uint16_t>(sign | h);
+        }
 
-        auto depth_data = (const uint16_t*)depth.get_data();
+        uint32_t h = (abs - 0x38000000) >> 13;
+        uint32_t rest = abs & 0x1fff;
+        if (rest > 0x1000 || (rest == 0x1000 && (h & 1)))
+            ++h;
+        return static_cast<uint16_t>(sign | h);
+    }
 
+    static inline uint16_t to_depth_units(float value)
+    {
+        return static_cast<uint16_t>(static_cast<int16_t>(std::lround(std::max(-32768.f, std::min(32767.f, value)))));
+    }
+
+    // Converts count points to the 16-bit layouts of RS2_FORMAT_XYZ16 and RS2_FORMAT_XYZ16F. Without texture coordinates zeros are written,
+    // and nothing without packed ones
+    static void pack_points(rs2_format format, float depth_units, const float3* vertices, const float2* tex_ptr, size_t count,
+        uint16_t* packed_vertices, uint16_t* packed_tex)
+    {
+        if (format == RS2_FORMAT_XYZ16)
+        {
+            const float units = 1.f / depth_units;
+            for (size_t i = 0; i < count; ++i, packed_vertices += 3)
+            {
+                packed_vertices[0] = to_depth_units(vertices[i].x * units);
+                packed_vertices[1] = to_depth_units(vertices[i].y * units);
+                packed_vertices[2] = static_cast<uint16_t>(vertices[i].z * units + 0.5f); // The depth value itself
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < count; ++i, packed_vertices += 3)
+            {
+                packed_vertices[0] = float_to_half(vertices[i].x);
+                packed_vertices[1] = float_to_half(vertices[i].y);
+                packed_vertices[2] = float_to_half(vertices[i].z);
+            }
+        }
+
+        for (size_t i = 0; packed_tex && i < count; ++i, packed_tex += 2)
+        {
+            packed_tex[0] = tex_ptr ? float_to_half(tex_ptr[i].x) : 0;
+            packed_tex[1] = tex_ptr ? float_to_half(tex_ptr[i].y) : 0;
+        }
+    }
+
+    rs2_format pointcloud::get_points_format() const
+    {
+        switch (_points_format)
+        {
+        case points_xyz16: return RS2_FORMAT_XYZ16;
+        case points_xyz16f: return RS2_FORMAT_XYZ16F;
+        default: return RS2_FORMAT_XYZ32F;
+        }
+    }
+
+    void pointcloud::get_points(const uint16_t* depth, unsigned int begin, unsigned int count, float3* vertices, float2* tex_ptr, bool map_texture)
+    {
         const float3* points;
-#ifdef __SSSE3__
-        points = get_points_sse(depth_data, _depth_intrinsics->height*_depth_intrinsics->width, _pre_compute_map_x.data(), _pre_compute_map_y.data(), *_depth_units, pframe->get_vertices());
-#else
-        points = depth_to_points((uint8_t*)pframe->get_vertices(), *_depth_intrinsics, depth_data, *_depth_units);
+        auto depth_data = depth + begin;
+        auto full_frame = begin == 0 && count == static_cast<unsigned int>(_depth_intrinsics->height*_depth_intrinsics->width);
+        auto backend = full_frame ? environment::get_instance().get_compute_backend() : nullptr;
+#ifdef RS2_USE_CUDA
+        // GPU-resident depth is deprojected on the device, without downloading it first
+        if (_device_depth && full_frame)
+        {
+            rscuda::deproject_depth_cuda(reinterpret_cast<float *>(vertices), *_depth_intrinsics, nullptr, *_depth_units, _device_depth);
+            points = vertices;
+        }
+        else
 #endif
-
-        auto vid_frame = depth.as<rs2::video_frame>();
-        float2* tex_ptr = pframe->get_texture_coordinates();
-        // Pixels calculated in the mapped texture. Used in post-processing filters
-        float2* pixels_ptr = _pixels_map.data();
-        rs2_intrinsics mapped_intr;
-        rs2_extrinsics extr;
-        bool map_texture = false;
+        if (backend && backend->deproject_depth(reinterpret_cast<float *>(vertices), *_depth_intrinsics, depth_data, *_depth_units))
+        {
+            points = vertices;
+        }
+        else
         {
-            if (_extrinsics && _other_intrinsics)
+#ifdef __SSSE3__
+            unsigned int converted = 0;
+#if defined(__AVX2__) || defined(RS2_USE_AVX2_UNPACKERS)
+            if (get_simd_level() == simd_level::avx2)
+                converted = get_points_avx(depth_data, count, _pre_compute_map_x.data() + begin, _pre_compute_map_y.data() + begin, *_depth_units, reinterpret_cast<float*>(vertices));
+#endif
+            get_points_sse(depth_data + converted, count - converted, _pre_compute_map_x.data() + begin + converted, _pre_compute_map_y.data() + begin + converted,
+                *_depth_units, vertices + converted);
+            points = vertices;
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+            get_points_neon(depth_data, count, _pre_compute_map_x.data() + begin, _pre_compute_map_y.data() + begin, *_depth_units, vertices);
+            points = vertices;
+#else
+            if (full_frame)
             {
-                mapped_intr = *_other_intrinsics;
-                extr = *_extrinsics;
-                map_texture = true;
+                points = depth_to_points((uint8_t*)vertices, *_depth_intrinsics, depth_data, *_depth_units);
             }
+            else
+            {
+                std::vector<float2> pixels(count);
+                std::vector<float> z(count);
+                for (unsigned int i = 0; i < count; ++i)
+                {
+                    pixels[i] = { float((begin + i) % _depth_intrinsics->width), float((begin + i) / _depth_intrinsics->width) };
+                    z[i] = *_depth_units * depth_data[i];
+                }
+                deproject_pixels(*_depth_intrinsics, pixels.data(), z.data(), vertices, count);
+                points = vertices;
+            }
+#endif
         }
 
         if (map_texture)
         {
-            auto height = vid_frame.get_height();
-            auto width = vid_frame.get_width();
+            auto& mapped_intr = *_other_intrinsics;
+            auto& extr = *_extrinsics;
+            // Pixels calculated in the mapped texture. Used in post-processing filters
+            float2* pixels_ptr = _pixels_map.data() + begin;
 
 #ifdef __SSSE3__
-            get_texture_map_sse(points, width, height, mapped_intr, extr, tex_ptr, pixels_ptr);
+            unsigned int mapped = 0;
+#if defined(__AVX2__) || defined(RS2_USE_AVX2_UNPACKERS)
+            if (get_simd_level() == simd_level::avx2)
+                mapped = get_texture_map_avx(reinterpret_cast<const float*>(points), count, mapped_intr, extr,
+                    reinterpret_cast<float*>(tex_ptr), reinterpret_cast<float*>(pixels_ptr));
+#endif
+            get_texture_map_sse(points + mapped, count - mapped, 1, mapped_intr, extr, tex_ptr + mapped, pixels_ptr + mapped);
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+            auto mapped = get_texture_map_neon(points, count, mapped_intr, extr, tex_ptr, pixels_ptr);
+            get_texture_map(points + mapped, count - mapped, 1, mapped_intr, extr, tex_ptr + mapped, pixels_ptr + mapped);
 #else
-            get_texture_map(points, width, height, mapped_intr, extr, tex_ptr, pixels_ptr);
+            get_texture_map(points, count, 1, mapped_intr, extr, tex_ptr, pixels_ptr);
 #endif
+        }
+    }
 
-            if (_occlusion_filter->active())
+    void pointcloud::get_planar_points(const uint16_t* depth, unsigned int count, float* x, float* y, float* z)
+    {
+        // The maps are only kept for the vectorized builds otherwise
+        if (_pre_compute_map_x.size() != count)
+            pre_compute_x_y_map();
+
+        const auto map_x = _pre_compute_map_x.data();
+        const auto map_y = _pre_compute_map_y.data();
+        const auto depth_scale = *_depth_units;
+        unsigned int i = 0;
+#ifdef __SSSE3__
+        // Every plane is written straight from the registers, without the shuffles of the interleaved layout
+        const auto scale = _mm_set_ps1(depth_scale);
+        const auto zero = _mm_setzero_si128();
+        for (; i + 8 <= count; i += 8)
+        {
+            auto d = _mm_loadu_si128((const __m128i*)(depth + i));
+            auto z0 = _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(d, zero)), scale);
+            auto z1 = _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(d, zero)), scale);
+            _mm_storeu_ps(x + i, _mm_mul_ps(z0, _mm_loadu_ps(map_x + i)));
+            _mm_storeu_ps(x + i + 4, _mm_mul_ps(z1, _mm_loadu_ps(map_x + i + 4)));
+            _mm_storeu_ps(y + i, _mm_mul_ps(z0, _mm_loadu_ps(map_y + i)));
+            _mm_storeu_ps(y + i + 4, _mm_mul_ps(z1, _mm_loadu_ps(map_y + i + 4)));
+            _mm_storeu_ps(z + i, z0);
+            _mm_storeu_ps(z + i + 4, z1);
+        }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+        for (; i + 4 <= count; i += 4)
+        {
+            auto d = vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vld1_u16(depth + i))), depth_scale);
+            vst1q_f32(x + i, vmulq_f32(d, vld1q_f32(map_x + i)));
+            vst1q_f32(y + i, vmulq_f32(d, vld1q_f32(map_y + i)));
+            vst1q_f32(z + i, d);
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            auto d = depth_scale * depth[i];
+            x[i] = d * map_x[i];
+            y[i] = d * map_y[i];
+            z[i] = d;
+        }
+    }
+
+    rs2::frame pointcloud::process_depth_frame(const rs2::frame_source& source, const rs2::depth_frame& depth)
+    {
+        const unsigned int size = _depth_intrinsics->height*_depth_intrinsics->width;
+        auto format = _output_stream->format();
+        region_of_interest roi;
+        auto in_roi = roi_in_frame(_depth_intrinsics->width, _depth_intrinsics->height, roi);
+#ifdef RS2_USE_CUDA
+        // Points computed in chunks, or for a region of the frame, read the depth on the host
+        _device_depth = format == RS2_FORMAT_XYZ32F && !in_roi ? static_cast<const uint16_t*>(get_device_data((frame_interface*)depth.get())) : nullptr;
+        auto depth_data = _device_depth ? nullptr : (const uint16_t*)depth.get_data();
+#else
+        auto depth_data = (const uint16_t*)depth.get_data();
+#endif
+        bool map_texture = _extrinsics && _other_intrinsics;
+        bool occlusion = map_texture && _occlusion_filter->active();
+        bool planar = format == RS2_FORMAT_XYZ32F && _points_layout == points_planar;
+
+        if ((_workers ? int(_workers->size()) + 1 : 1) != _threads)
+        {
+            _workers = _threads > 1 ? std::make_shared<parallel_workers>(_threads - 1) : nullptr;
+            _occlusion_filter->set_workers(_workers);
+        }
+
+        // Compacted point clouds, 16-bit ones the occlusion filter works on, the ones of a region of interest and those with normals,
+        // are computed for every pixel first and then copied to the frame
+        if (_compact_points != compact_none || ((format != RS2_FORMAT_XYZ32F || planar) && occlusion) || in_roi || _normals_window)
+        {
+            _full_vertices.resize(size);
+            _full_texture_coordinates.resize(size);
+            if (in_roi)
+                get_roi_points(depth_data, roi, map_texture);
+            else
+                get_points(depth_data, 0, size, _full_vertices.data(), _full_texture_coordinates.data(), map_texture);
+            if (occlusion)
+                _occlusion_filter->process(_full_vertices.data(), _full_texture_coordinates.data(), _pixels_map);
+            if (_normals_window)
             {
+                _full_normals.resize(size);
+                estimate_normals(_full_vertices.data(), _depth_intrinsics->width, _depth_intrinsics->height, _normals_window, _full_normals.data());
+            }
+            return copy_points(source, depth, map_texture, in_roi ? &roi : nullptr);
+        }
+
+        auto res = allocate_points(depth, size, false, false, map_texture);
+        auto pframe = (librealsense::points*)(res.get());
+
+        if (planar)
+        {
+#ifdef RS2_USE_CUDA
+            // The planar kernel deprojects on the host
+            if (_device_depth) depth_data = (const uint16_t*)depth.get_data();
+#endif
+            auto x = pframe->get_vertex_plane(0), y = pframe->get_vertex_plane(1), z = pframe->get_vertex_plane(2);
+            get_planar_points(depth_data, size, x, y, z);
+            if (map_texture)
+            {
+                auto other_intrinsics = *_other_intrinsics;
+                auto extrinsics = *_extrinsics;
+                pframe->defer_texture_coordinates([other_intrinsics, extrinsics](const float3* vertices, float2* tex_ptr, size_t count) {
+                    auto planes = reinterpret_cast<const float*>(vertices);
+                    map_planar_texture_coordinates(planes, planes + count, planes + 2 * count, tex_ptr, count, other_intrinsics, extrinsics); });
+            }
+            return res;
+        }
+
+        if (format == RS2_FORMAT_XYZ32F)
+        {
+            // Without occlusion removal, the texture coordinates are only computed if they are read
+            if (map_texture && !occlusion)
+            {
+                get_points(depth_data, 0, size, pframe->get_vertices(), nullptr, false);
+                auto other_intrinsics = *_other_intrinsics;
+                auto extrinsics = *_extrinsics;
+                pframe->defer_texture_coordinates([other_intrinsics, extrinsics](const float3* vertices, float2* tex_ptr, size_t count) {
+                    map_texture_coordinates(vertices, tex_ptr, count, other_intrinsics, extrinsics); });
+                return res;
+            }
+
+            get_points(depth_data, 0, size, pframe->get_vertices(), map_texture ? pframe->get_texture_coordinates() : nullptr, map_texture);
+            if (occlusion)
                 _occlusion_filter->process(pframe->get_vertices(), pframe->get_texture_coordinates(), _pixels_map);
+            return res;
+        }
+
+        // 16-bit points are computed in chunks that stay in the cache, and converted as they are written to the frame
+        const unsigned int chunk = 256;
+        alignas(16) float3 vertices[chunk];
+        alignas(16) float2 tex_ptr[chunk];
+        auto packed_vertices = reinterpret_cast<uint16_t*>(pframe->get_vertices());
+        auto packed_tex = map_texture ? reinterpret_cast<uint16_t*>(pframe->get_texture_coordinates()) : nullptr;
+        for (unsigned int begin = 0; begin < size; begin += chunk)
+        {
+            auto count = std::min(chunk, size - begin);
+            get_points(depth_data, begin, count, vertices, tex_ptr, map_texture);
+            pack_points(format, *_depth_units, vertices, map_texture ? tex_ptr : nullptr, count, packed_vertices + begin * 3,
+                packed_tex ? packed_tex + begin * 2 : nullptr);
+        }
+        return res;
+    }
+
+    rs2::frame pointcloud::allocate_points(const rs2::depth_frame& depth, size_t count, bool pixel_indices, bool normals, bool texture_coordinates)
+    {
+        auto profile = std::dynamic_pointer_cast<stream_profile_interface>(_output_stream->get()->profile->shared_from_this());
+        auto res = _source_wrapper.allocate_points(profile, (frame_interface*)depth.get(), count, pixel_indices, normals, false, texture_coordinates);
+        if (_output_stream->format() == RS2_FORMAT_XYZ32F && _points_layout == points_planar)
+            static_cast<librealsense::points*>(res)->set_planar(true);
+        return rs2::frame((rs2_frame*)res);
+    }
+
+    void pointcloud::get_roi_points(const uint16_t* depth, const region_of_interest& roi, bool map_texture)
+    {
+        // Points outside the region have no depth
+        std::fill(_full_vertices.begin(), _full_vertices.end(), float3{ 0.f, 0.f, 0.f });
+        std::fill(_full_texture_coordinates.begin(), _full_texture_coordinates.end(), float2{ 0.f, 0.f });
+
+        const auto width = _depth_intrinsics->width;
+        auto rows = [&](size_t begin, size_t end)
+        {
+            for (auto y = roi.min_y + int(begin); y < roi.min_y + int(end); ++y)
+            {
+                auto offset = y * width + roi.min_x;
+                get_points(depth, offset, roi.max_x - roi.min_x, _full_vertices.data() + offset, _full_texture_coordinates.data() + offset, map_texture);
+            }
+        };
+
+        if (_workers)
+            _workers->run_bands(roi.max_y - roi.min_y, 1, rows);
+        else
+            rows(0, roi.max_y - roi.min_y);
+    }
+
+    rs2::frame pointcloud::copy_points(const rs2::frame_source& source, const rs2::depth_frame& depth, bool map_texture, const region_of_interest* roi)
+    {
+        const int size = static_cast<int>(_full_vertices.size());
+        const int width = _depth_intrinsics->width;
+        auto compact = _compact_points != compact_none;
+        auto crop = roi && _crop_to_roi;
+        auto skip = [&](int i)
+        {
+            if (crop)
+            {
+                auto x = i % width, y = i / width;
+                if (x < roi->min_x || x >= roi->max_x || y < roi->min_y || y >= roi->max_y)
+                    return true;
             }
+            return compact && !_full_vertices[i].z;
+        };
+
+        // The compacted points leave out the pixels without depth, which the validity mask of the frame skips 64 at a time
+        const std::vector<uint64_t>* mask = nullptr;
+#ifdef RS2_USE_CUDA
+        // Not of the depth the device holds, for the mask not to download it
+        if (compact && !_device_depth)
+#else
+        if (compact)
+#endif
+        {
+            auto df = dynamic_cast<librealsense::depth_frame*>((frame_interface*)depth.get());
+            if (df && df->get_validity_mask().size() == size_t(size + 63) / 64)
+                mask = &df->get_validity_mask();
+        }
+        auto empty_word = [&](int i) { return mask && !(i % 64) && !(*mask)[i / 64]; };
+
+        int count = size;
+        if (compact || crop)
+        {
+            count = 0;
+            for (int i = 0; i < size; ++i)
+            {
+                if (empty_word(i))
+                    i += 63;
+                else if (!skip(i))
+                    ++count;
+            }
+        }
+
+        auto pixel_indices = _compact_points == compact_with_pixel_indices;
+        auto with_normals = _normals_window > 0;
+        auto res = allocate_points(depth, count, pixel_indices, with_normals, map_texture);
+        auto pframe = (librealsense::points*)(res.get());
+        auto format = _output_stream->format();
+        auto planar = pframe->is_planar();
+        auto vertices = planar ? nullptr : pframe->get_vertices();
+        float* planes[] = { pframe->get_vertex_plane(0), pframe->get_vertex_plane(1), pframe->get_vertex_plane(2) };
+        auto tex_ptr = map_texture ? pframe->get_texture_coordinates() : nullptr;
+        auto packed_vertices = reinterpret_cast<uint16_t*>(planar ? nullptr : pframe->get_vertices());
+        auto packed_tex = reinterpret_cast<uint16_t*>(tex_ptr);
+        auto normals = pframe->get_normals();
+        auto indices = pframe->get_pixel_indices();
+
+        for (int i = 0; i < size; ++i)
+        {
+            if (empty_word(i))
+            {
+                i += 63;
+                continue;
+            }
+            if (skip(i))
+                continue;
+
+            if (planar)
+            {
+                *planes[0]++ = _full_vertices[i].x;
+                *planes[1]++ = _full_vertices[i].y;
+                *planes[2]++ = _full_vertices[i].z;
+                if (tex_ptr)
+                    *tex_ptr++ = _full_texture_coordinates[i];
+            }
+            else if (format == RS2_FORMAT_XYZ32F)
+            {
+                *vertices++ = _full_vertices[i];
+                if (tex_ptr)
+                    *tex_ptr++ = _full_texture_coordinates[i];
+            }
+            else
+            {
+                pack_points(format, *_depth_units, &_full_vertices[i], map_texture ? &_full_texture_coordinates[i] : nullptr, 1, packed_vertices, packed_tex);
+                packed_vertices += 3;
+                if (packed_tex)
+                    packed_tex += 2;
+            }
+            if (with_normals)
+                *normals++ = _full_normals[i];
+            if (pixel_indices)
+                *indices++ = i;
         }
         return res;
     }
 
     pointcloud::pointcloud() :
-        _other_stream(nullptr)
+        _other_stream(nullptr), _compact_points(compact_none), _points_format(points_xyz32f), _points_layout(points_interleaved), _normals_window(0), _threads(1)
+#ifdef RS2_USE_CUDA
+        , _device_depth(nullptr)
+#endif
     {
         _occlusion_filter = std::make_shared<occlusion_filter>();
 
@@ -488,6 +996,49 @@ namespace librealsense
         occlusion_invalidation->set_description(1.f, "Heuristic");
         occlusion_invalidation->set_description(2.f, "Exhaustive");
         register_option(RS2_OPTION_FILTER_MAGNITUDE, occlusion_invalidation);
+
+        auto compact = std::make_shared<ptr_option<uint8_t>>(
+            compact_none,
+            compact_max - 1, 1,
+            compact_none,
+            &_compact_points,
+            "Output only the points with valid depth");
+        compact->set_description(0.f, "Off");
+        compact->set_description(1.f, "Valid points");
+        compact->set_description(2.f, "Valid points and pixel indices");
+        register_option(RS2_OPTION_COMPACT_POINTS, compact);
+
+        auto points_format = std::make_shared<ptr_option<uint8_t>>(
+            points_xyz32f,
+            points_format_max - 1, 1,
+            points_xyz32f,
+            &_points_format,
+            "Format of the vertices and texture coordinates");
+        points_format->set_description(0.f, "XYZ32F");
+        points_format->set_description(1.f, "XYZ16");
+        points_format->set_description(2.f, "XYZ16F");
+        register_option(RS2_OPTION_POINTS_FORMAT, points_format);
+
+        auto points_layout = std::make_shared<ptr_option<uint8_t>>(
+            points_interleaved,
+            points_layout_max - 1, 1,
+            points_interleaved,
+            &_points_layout,
+            "Layout of the XYZ32F vertices, interleaved or in planes of X, Y and Z");
+        points_layout->set_description(0.f, "Interleaved");
+        points_layout->set_description(1.f, "Planar");
+        register_option(RS2_OPTION_POINTS_LAYOUT, points_layout);
+
+        auto normals_window = std::make_shared<ptr_option<int>>(0, 16, 1, 0, &_normals_window,
+            "Half the side, in pixels, of the window of neighbours the normals of the points are averaged over, 0 for no normals");
+        register_option(RS2_OPTION_NORMALS_WINDOW, normals_window);
+
+        register_roi_options(*this);
+
+        auto max_threads = std::max<int>(std::thread::hardware_concurrency(), 1);
+        auto processing_threads = std::make_shared<ptr_option<int>>(1, max_threads, 1, 1, &_threads,
+            "Number of threads, including the calling one, that remove the occlusions in bands of depth rows");
+        register_option(RS2_OPTION_PROCESSING_THREADS, processing_threads);
     }
 
     bool pointcloud::should_process(const rs2::frame& frame)
@@ -3,11 +3,33 @@
 
 #pragma once
 #include "../include/librealsense2/hpp/rs_frame.hpp"
+#include "concurrency.h"
 namespace librealsense
 {
     class occlusion_filter;
 
-    class pointcloud : public stream_filter_processing_block
+    enum compact_points_type : uint8_t {
+        compact_none,
+        compact_valid_points,
+        compact_with_pixel_indices,
+        compact_max };
+
+    enum points_format_type : uint8_t {
+        points_xyz32f,
+        points_xyz16,
+        points_xyz16f,
+        points_format_max };
+
+    enum points_layout_type : uint8_t {
+        points_interleaved,
+        points_planar,
+        points_layout_max };
+
+    // Round to nearest even conversion to IEEE 754 half precision, saturating to infinity. Bit for bit what F16C converts,
+    // NaNs included, which keep the sign and the upper bits of their payload and are quieted
+    uint16_t float_to_half(float value);
+
+    class pointcloud : public stream_filter_processing_block, public processing_roi
     {
     public:
         pointcloud();
@@ -31,6 +53,13 @@ namespace librealsense
         void inspect_depth_frame(const rs2::frame& depth);
         void inspect_other_frame(const rs2::frame& other);
         rs2::frame process_depth_frame(const rs2::frame_source& source, const rs2::depth_frame& depth);
+        // Without texture coordinates when no texture is mapped
+        rs2::frame allocate_points(const rs2::depth_frame& depth, size_t count, bool pixel_indices, bool normals, bool texture_coordinates);
+        rs2::frame copy_points(const rs2::frame_source& source, const rs2::depth_frame& depth, bool map_texture, const region_of_interest* roi);
+        void get_roi_points(const uint16_t* depth, const region_of_interest& roi, bool map_texture);
+        void get_points(const uint16_t* depth, unsigned int begin, unsigned int count, float3* vertices, float2* tex_ptr, bool map_texture);
+        void get_planar_points(const uint16_t* depth, unsigned int count, float* x, float* y, float* z);
+        rs2_format get_points_format() const;
 
         bool stream_changed(const rs2::stream_profile& old, const rs2::stream_profile& curr);
 
@@ -39,5 +68,23 @@ namespace librealsense
 
         void pre_compute_x_y_map();
         stream_filter _prev_stream_filter;
+
+        uint8_t                                _compact_points;
+        uint8_t                                _points_format;
+        uint8_t                                _points_layout;      // Of the RS2_FORMAT_XYZ32F points alone
+
+        // Full frame of points and texture coordinates, from which compacted or 16-bit frames are copied
+        std::vector<float3>                    _full_vertices;
+        std::vector<float2>                    _full_texture_coordinates;
+
+        int                                    _normals_window;     // 0 for no normals
+        std::vector<float3>                    _full_normals;
+
+        int                                    _threads;
+        std::shared_ptr<parallel_workers>      _workers;
+
+#ifdef RS2_USE_CUDA
+        const uint16_t*                        _device_depth;  // Of the frame being processed, when it is GPU-resident
+#endif
     };
 }
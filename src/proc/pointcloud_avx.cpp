@@ -0,0 +1,161 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include "pointcloud_avx.h"
+
+#if defined(__SSSE3__) && (defined(__AVX2__) || defined(RS2_USE_AVX2_UNPACKERS))
+#include <immintrin.h>
+
+namespace librealsense
+{
+    // Loads two groups of 4 floats into the low and high lanes, so the 128-bit shuffles of the SSE code apply per lane
+    static inline __m256 load_lanes(const float* lo, const float* hi)
+    {
+        return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(lo)), _mm_loadu_ps(hi), 1);
+    }
+
+    unsigned int get_points_avx(const uint16_t* depth,
+        const unsigned int size,
+        const float* pre_compute_x,
+        const float* pre_compute_y,
+        float depth_scale,
+        float* points)
+    {
+        auto point = points;
+        auto scale = _mm256_set1_ps(depth_scale);
+
+        unsigned int i = 0;
+        for (; i + 8 <= size; i += 8)
+        {
+            auto x = _mm256_loadu_ps(pre_compute_x + i);
+            auto y = _mm256_loadu_ps(pre_compute_y + i);
+
+            // d0..d3 in the low lane, d4..d7 in the high one
+            auto d = _mm256_cvtepu16_epi32(_mm_loadu_si128((__m128i const*)(depth + i)));
+            auto z = _mm256_mul_ps(_mm256_cvtepi32_ps(d), scale);
+
+            auto px = _mm256_mul_ps(z, x);
+            auto py = _mm256_mul_ps(z, y);
+
+            //scattering of the x y z, every lane holds 4 points
+            auto x_y = _mm256_shuffle_ps(px, py, _MM_SHUFFLE(2, 0, 2, 0));
+            auto z_x = _mm256_shuffle_ps(z, px, _MM_SHUFFLE(3, 1, 2, 0));
+            auto y_z = _mm256_shuffle_ps(py, z, _MM_SHUFFLE(3, 1, 3, 1));
+
+            auto xyz1 = _mm256_shuffle_ps(x_y, z_x, _MM_SHUFFLE(2, 0, 2, 0));
+            auto xyz2 = _mm256_shuffle_ps(y_z, x_y, _MM_SHUFFLE(3, 1, 2, 0));
+            auto xyz3 = _mm256_shuffle_ps(z_x, y_z, _MM_SHUFFLE(3, 1, 3, 1));
+
+            //store 8 points of x y z
+            _mm256_storeu_ps(&point[0], _mm256_permute2f128_ps(xyz1, xyz2, 0x20));
+            _mm256_storeu_ps(&point[8], _mm256_permute2f128_ps(xyz3, xyz1, 0x30));
+            _mm256_storeu_ps(&point[16], _mm256_permute2f128_ps(xyz2, xyz3, 0x31));
+            point += 24;
+        }
+        return i;
+    }
+
+    unsigned int get_texture_map_avx(const float* points,
+        const unsigned int size,
+        const rs2_intrinsics &other_intrinsics,
+        const rs2_extrinsics& extr,
+        float* tex_ptr,
+        float* pixels_ptr)
+    {
+        auto point = points;
+        auto res = tex_ptr;
+        auto res1 = pixels_ptr;
+
+        __m256 r[9];
+        __m256 t[3];
+        __m256 c[5];
+
+        for (int i = 0; i < 9; ++i)
+        {
+            r[i] = _mm256_set1_ps(extr.rotation[i]);
+        }
+        for (int i = 0; i < 3; ++i)
+        {
+            t[i] = _mm256_set1_ps(extr.translation[i]);
+        }
+        for (int i = 0; i < 5; ++i)
+        {
+            c[i] = _mm256_set1_ps(other_intrinsics.coeffs[i]);
+        }
+
+        auto fx = _mm256_set1_ps(other_intrinsics.fx);
+        auto fy = _mm256_set1_ps(other_intrinsics.fy);
+        auto ppx = _mm256_set1_ps(other_intrinsics.ppx);
+        auto ppy = _mm256_set1_ps(other_intrinsics.ppy);
+        auto w = _mm256_set1_ps(float(other_intrinsics.width));
+        auto h = _mm256_set1_ps(float(other_intrinsics.height));
+        auto zero = _mm256_set1_ps(0);
+        auto one = _mm256_set1_ps(1);
+        auto two = _mm256_set1_ps(2);
+        const bool brown_conrady = other_intrinsics.model == RS2_DISTORTION_MODIFIED_BROWN_CONRADY;
+
+        unsigned int i = 0;
+        for (; i + 8 <= size; i += 8, point += 24)
+        {
+            //load 8 points (x,y,z), the first 4 in the low lanes and the last 4 in the high ones
+            auto xyz1 = load_lanes(point, point + 12);
+            auto xyz2 = load_lanes(point + 4, point + 16);
+            auto xyz3 = load_lanes(point + 8, point + 20);
+
+            //gather x,y,z
+            auto yz = _mm256_shuffle_ps(xyz1, xyz2, _MM_SHUFFLE(1, 0, 2, 1));
+            auto xy = _mm256_shuffle_ps(xyz2, xyz3, _MM_SHUFFLE(2, 1, 3, 2));
+
+            auto x = _mm256_shuffle_ps(xyz1, xy, _MM_SHUFFLE(2, 0, 3, 0));
+            auto y = _mm256_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+            auto z = _mm256_shuffle_ps(yz, xyz3, _MM_SHUFFLE(3, 0, 3, 1));
+
+            auto p_x = _mm256_add_ps(_mm256_mul_ps(r[0], x), _mm256_add_ps(_mm256_mul_ps(r[3], y), _mm256_add_ps(_mm256_mul_ps(r[6], z), t[0])));
+            auto p_y = _mm256_add_ps(_mm256_mul_ps(r[1], x), _mm256_add_ps(_mm256_mul_ps(r[4], y), _mm256_add_ps(_mm256_mul_ps(r[7], z), t[1])));
+            auto p_z = _mm256_add_ps(_mm256_mul_ps(r[2], x), _mm256_add_ps(_mm256_mul_ps(r[5], y), _mm256_add_ps(_mm256_mul_ps(r[8], z), t[2])));
+
+            p_x = _mm256_div_ps(p_x, p_z);
+            p_y = _mm256_div_ps(p_y, p_z);
+
+            if (brown_conrady)
+            {
+                // Same terms as the SSE code, so both paths give the same texture coordinates
+                auto r2 = _mm256_add_ps(_mm256_mul_ps(p_x, p_x), _mm256_mul_ps(p_y, p_y));
+                auto r3 = _mm256_add_ps(_mm256_mul_ps(c[1], _mm256_mul_ps(r2, r2)), _mm256_mul_ps(c[4], _mm256_mul_ps(r2, _mm256_mul_ps(r2, r2))));
+                auto f = _mm256_add_ps(one, _mm256_add_ps(_mm256_mul_ps(c[0], r2), r3));
+
+                auto x_f = _mm256_mul_ps(p_x, f);
+                auto y_f = _mm256_mul_ps(p_y, f);
+
+                auto r4 = _mm256_mul_ps(c[3], _mm256_add_ps(r2, _mm256_mul_ps(two, _mm256_mul_ps(x_f, x_f))));
+                p_x = _mm256_add_ps(x_f, _mm256_add_ps(_mm256_mul_ps(two, _mm256_mul_ps(c[2], _mm256_mul_ps(x_f, y_f))), r4));
+                p_y = _mm256_add_ps(y_f, _mm256_add_ps(_mm256_mul_ps(two, _mm256_mul_ps(c[3], _mm256_mul_ps(x_f, y_f))), r4));
+            }
+
+            //zero the x and y if z is zero
+            auto cmp = _mm256_cmp_ps(z, zero, _CMP_NEQ_UQ);
+            p_x = _mm256_and_ps(_mm256_add_ps(_mm256_mul_ps(p_x, fx), ppx), cmp);
+            p_y = _mm256_and_ps(_mm256_add_ps(_mm256_mul_ps(p_y, fy), ppy), cmp);
+
+            //interleave x y before normalize and store in pixels_ptr
+            auto xy_lo = _mm256_unpacklo_ps(p_x, p_y);
+            auto xy_hi = _mm256_unpackhi_ps(p_x, p_y);
+            _mm256_storeu_ps(res1, _mm256_permute2f128_ps(xy_lo, xy_hi, 0x20));
+            _mm256_storeu_ps(res1 + 8, _mm256_permute2f128_ps(xy_lo, xy_hi, 0x31));
+            res1 += 16;
+
+            //normalize x and y
+            p_x = _mm256_div_ps(p_x, w);
+            p_y = _mm256_div_ps(p_y, h);
+
+            //interleave x y after normalize and store in tex_ptr
+            xy_lo = _mm256_unpacklo_ps(p_x, p_y);
+            xy_hi = _mm256_unpackhi_ps(p_x, p_y);
+            _mm256_storeu_ps(res, _mm256_permute2f128_ps(xy_lo, xy_hi, 0x20));
+            _mm256_storeu_ps(res + 8, _mm256_permute2f128_ps(xy_lo, xy_hi, 0x31));
+            res += 16;
+        }
+        return i;
+    }
+}
+#endif
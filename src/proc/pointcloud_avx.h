@@ -0,0 +1,29 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+// Compiled with -mavx2, like image_avx.h it only includes the C headers of the API, for no inline C++ code to be built for AVX
+#include <stdint.h>
+#include "../include/librealsense2/h/rs_sensor.h"
+
+namespace librealsense
+{
+#if defined(__SSSE3__) && (defined(__AVX2__) || defined(RS2_USE_AVX2_UNPACKERS))
+    // AVX2 versions of get_points_sse and get_texture_map_sse, with the same results. Both handle 8 pixels per iteration
+    // and return how many of the size pixels were processed, leaving the remainder to the SSE code
+    unsigned int get_points_avx(const uint16_t* depth,
+        const unsigned int size,
+        const float* pre_compute_x,
+        const float* pre_compute_y,
+        float depth_scale,
+        float* points);
+
+    unsigned int get_texture_map_avx(const float* points,
+        const unsigned int size,
+        const rs2_intrinsics &other_intrinsics,
+        const rs2_extrinsics& extr,
+        float* tex_ptr,
+        float* pixels_ptr);
+#endif
+}
@@ -0,0 +1,252 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include <functional>
+#include <algorithm>
+#include "source.h"
+#include "proc/synthetic-stream.h"
+#include "proc/processing-graph.h"
+
+namespace librealsense
+{
+    processing_graph::processing_graph(int threads, int max_in_flight)
+        : _max_in_flight(max_in_flight), _stopping(false), _in_flight(0)
+    {
+        if (threads < 1)
+            throw invalid_value_exception(to_string() << "Unsupported number of threads " << threads << " is out of range.");
+        if (max_in_flight < 1)
+            throw invalid_value_exception(to_string() << "Unsupported number of frames in flight " << max_in_flight << " is out of range.");
+
+        auto f = [this](frame_holder frame, synthetic_source_interface* source)
+        {
+            submit(std::move(frame), nullptr, 0);
+        };
+        set_processing_callback(std::shared_ptr<rs2_frame_processor_callback>(
+            new internal_frame_processor_callback<decltype(f)>(f)));
+
+        for (int i = 0; i < threads; i++)
+            _threads.push_back(std::thread([this]()
+            {
+                apply_thread_policy(RS2_THREAD_ROLE_PROCESSING);
+                work();
+            }));
+    }
+
+    processing_graph::~processing_graph()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_graph_mutex);
+            _stopping = true;
+        }
+        _work_cv.notify_all();
+        for (auto&& thread : _threads)
+            thread.join();
+
+        // The blocks may outlive the graph
+        for (auto&& n : _nodes)
+            n->block->set_output_callback(frame_callback_ptr());
+        _nodes.clear();
+    }
+
+    int processing_graph::add(std::shared_ptr<processing_block_interface> block)
+    {
+        if (!block)
+            throw invalid_value_exception("Null processing block can not be added to a processing graph");
+
+        std::lock_guard<std::mutex> lock(_graph_mutex);
+        for (auto&& n : _nodes)
+            if (n->block == block)
+                throw invalid_value_exception("Processing block is already in the processing graph");
+
+        auto index = int(_nodes.size());
+        auto on_output = [this, index](frame_interface* f)
+        {
+            route(index, frame_holder(f));
+        };
+        block->set_output_callback({
+            new internal_frame_callback<decltype(on_output)>(on_output),
+            [](rs2_frame_callback* p) { p->release(); } });
+
+        _nodes.push_back(std::unique_ptr<node>(new node{ block, {}, 0, {}, false, nullptr, false }));
+        return index;
+    }
+
+    void processing_graph::connect(int from, int to)
+    {
+        std::lock_guard<std::mutex> lock(_graph_mutex);
+        auto count = int(_nodes.size());
+        if (from < 0 || from >= count || to < 0 || to >= count)
+            throw invalid_value_exception(to_string() << "Processing graph has no block " << (from < 0 || from >= count ? from : to));
+
+        auto& outputs = _nodes[from]->outputs;
+        if (std::find(outputs.begin(), outputs.end(), to) != outputs.end())
+            throw invalid_value_exception(to_string() << "Processing graph blocks " << from << " and " << to << " are already connected");
+        if (reaches(to, from))
+            throw invalid_value_exception(to_string() << "Connecting processing graph block " << from << " to " << to << " would make a cycle");
+
+        outputs.push_back(to);
+        _nodes[to]->inputs++;
+    }
+
+    void processing_graph::set_bypass(int index, bool bypass)
+    {
+        std::lock_guard<std::mutex> lock(_graph_mutex);
+        if (index < 0 || index >= int(_nodes.size()))
+            throw invalid_value_exception(to_string() << "Processing graph has no block " << index);
+        _nodes[index]->bypassed = bypass;
+    }
+
+    void processing_graph::flush()
+    {
+        std::unique_lock<std::mutex> lock(_in_flight_mutex);
+        _in_flight_cv.wait(lock, [this]() { return _in_flight == 0; });
+    }
+
+    std::vector<frame_holder> processing_graph::process_batch(std::vector<frame_holder> frames)
+    {
+        batch b{ std::vector<std::vector<frame_holder>>(frames.size()), 0 };
+        for (size_t i = 0; i < frames.size(); i++)
+            submit(std::move(frames[i]), &b, int(i));
+
+        {
+            std::unique_lock<std::mutex> lock(_in_flight_mutex);
+            _in_flight_cv.wait(lock, [&b]() { return b.in_flight == 0; });
+        }
+
+        std::vector<frame_holder> results;
+        for (auto&& out : b.outputs)
+        {
+            if (out.size() > 1)
+                results.push_back(get_source().allocate_composite_frame(std::move(out)));
+            else if (out.size() == 1)
+                results.push_back(std::move(out.front()));
+            else
+                results.push_back(frame_holder());
+        }
+        return results;
+    }
+
+    void processing_graph::submit(frame_holder frame, batch* owner, int index)
+    {
+        // Hold the caller back while the graph works on as many input frames as it may
+        {
+            std::unique_lock<std::mutex> lock(_in_flight_mutex);
+            _in_flight_cv.wait(lock, [this]() { return _in_flight < _max_in_flight; });
+            ++_in_flight;
+            if (owner)
+                ++owner->in_flight;
+        }
+
+        token_ptr token(new flight{ owner, index }, [this](flight* p)
+        {
+            {
+                std::lock_guard<std::mutex> lock(_in_flight_mutex);
+                --_in_flight;
+                if (p->owner)
+                    --p->owner->in_flight;
+            }
+            _in_flight_cv.notify_all();
+            delete p;
+        });
+
+        std::unique_lock<std::mutex> lock(_graph_mutex);
+        std::vector<int> roots;
+        for (int i = 0; i < int(_nodes.size()); i++)
+            if (!_nodes[i]->inputs)
+                roots.push_back(i);
+
+        if (roots.empty())
+        {
+            lock.unlock();
+            output(std::move(frame), token);
+            return;
+        }
+
+        for (size_t i = 0; i < roots.size(); i++)
+            enqueue(roots[i], i + 1 < roots.size() ? frame.clone() : std::move(frame), token);
+    }
+
+    void processing_graph::output(frame_holder frame, const token_ptr& token)
+    {
+        std::lock_guard<std::mutex> output_lock(_output_mutex);
+        if (token && token->owner)
+            token->owner->outputs[token->index].push_back(std::move(frame));
+        else
+            get_source().frame_ready(std::move(frame));
+    }
+
+    void processing_graph::enqueue(int index, frame_holder frame, token_ptr token)
+    {
+        auto& n = *_nodes[index];
+        n.pending.push_back({ std::move(frame), std::move(token) });
+        if (!n.scheduled)
+        {
+            n.scheduled = true;
+            _ready.push_back(index);
+            _work_cv.notify_one();
+        }
+    }
+
+    void processing_graph::route(int index, frame_holder frame)
+    {
+        std::unique_lock<std::mutex> lock(_graph_mutex);
+        auto& n = *_nodes[index];
+        if (n.outputs.empty())
+        {
+            auto token = n.token;
+            lock.unlock();
+            output(std::move(frame), token);
+            return;
+        }
+
+        // The outputs of a block carry the token of the frame it is processing
+        for (size_t i = 0; i < n.outputs.size(); i++)
+            enqueue(n.outputs[i], i + 1 < n.outputs.size() ? frame.clone() : std::move(frame), n.token);
+    }
+
+    bool processing_graph::reaches(int from, int to) const
+    {
+        if (from == to)
+            return true;
+        for (auto next : _nodes[from]->outputs)
+            if (reaches(next, to))
+                return true;
+        return false;
+    }
+
+    void processing_graph::work()
+    {
+        std::unique_lock<std::mutex> lock(_graph_mutex);
+        while (true)
+        {
+            _work_cv.wait(lock, [this]() { return _stopping || !_ready.empty(); });
+            if (_stopping)
+                return;
+
+            // A node is run by one worker at a time, one frame at a time, so its frames stay in order
+            auto index = _ready.front();
+            _ready.pop_front();
+            auto& n = *_nodes[index];
+            {
+                auto next = std::move(n.pending.front());
+                n.pending.pop_front();
+                n.token = std::move(next.token);
+                auto bypassed = n.bypassed;
+
+                lock.unlock();
+                if (bypassed)
+                    route(index, std::move(next.frame));
+                else
+                    n.block->invoke(std::move(next.frame));
+                lock.lock();
+
+                n.token.reset();
+            }
+
+            if (n.pending.empty())
+                n.scheduled = false;
+            else
+                _ready.push_back(index);
+        }
+    }
+}
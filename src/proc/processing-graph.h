@@ -0,0 +1,97 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include "types.h"
+#include "proc/synthetic-stream.h"
+
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <memory>
+#include <thread>
+#include <condition_variable>
+
+namespace librealsense
+{
+    // Runs a graph of processing blocks on a pool of worker threads.
+    // Every block processes its frames one at a time and in the order they reach it, while different blocks run in parallel,
+    // so the frames are pipelined through the graph. Frames entering the graph go to every block without inputs,
+    // and the frames of blocks without outputs leave it
+    class processing_graph : public processing_block
+    {
+    public:
+        processing_graph(int threads, int max_in_flight);
+        ~processing_graph();
+
+        // Add a block to the graph, which takes over its output callback. Returns the index of the block in the graph
+        int add(std::shared_ptr<processing_block_interface> block);
+
+        // Send the frames of one block to another
+        void connect(int from, int to);
+
+        // Wait until all the frames in flight leave the graph
+        void flush();
+
+        // A bypassed block passes the frames it is sent to the blocks it is connected to as they are
+        void set_bypass(int index, bool bypass);
+
+        // Run a batch of frames through the graph, pipelined as the frames it is invoked on, without going through its output callback.
+        // Returns the frame that left the graph for every input in the batch, a composite frame when several did, or an empty frame
+        std::vector<frame_holder> process_batch(std::vector<frame_holder> frames);
+
+    private:
+        struct batch
+        {
+            std::vector<std::vector<frame_holder>> outputs;
+            int in_flight;
+        };
+
+        // Held for as long as the graph is working on an input frame
+        struct flight
+        {
+            batch* owner;       // The batch of the frame, which collects the frames leaving the graph instead of the output callback
+            int index;
+        };
+        typedef std::shared_ptr<flight> token_ptr;
+
+        struct item
+        {
+            frame_holder frame;
+            token_ptr token;
+        };
+
+        struct node
+        {
+            std::shared_ptr<processing_block_interface> block;
+            std::vector<int> outputs;
+            int inputs;
+            std::deque<item> pending;
+            bool scheduled;                 // Whether the node is waiting for, or being run by, a worker
+            token_ptr token;                // Of the frame being processed
+            bool bypassed;
+        };
+
+        void submit(frame_holder frame, batch* owner, int index);
+        void output(frame_holder frame, const token_ptr& token);
+        void enqueue(int index, frame_holder frame, token_ptr token);
+        void route(int index, frame_holder frame);
+        bool reaches(int from, int to) const;
+        void work();
+
+        const int _max_in_flight;
+
+        std::mutex _graph_mutex;
+        std::condition_variable _work_cv;
+        std::vector<std::unique_ptr<node>> _nodes;
+        std::deque<int> _ready;
+        bool _stopping;
+
+        std::mutex _in_flight_mutex;
+        std::condition_variable _in_flight_cv;
+        int _in_flight;
+
+        std::mutex _output_mutex;
+        std::vector<std::thread> _threads;
+    };
+}
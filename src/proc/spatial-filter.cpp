@@ -11,6 +11,14 @@
 #include "proc/hole-filling-filter.h"
 #include "proc/spatial-filter.h"
 
+#ifdef RS2_USE_CUDA_DEPTH_FILTERS
+#include "../cuda/cuda-depth-filters.cuh"
+#endif
+
+#ifdef __SSSE3__
+#include <tmmintrin.h> // For SSSE3 intrinsics
+#endif
+
 namespace librealsense
 {
     enum spatial_holes_filling_types : uint8_t
@@ -59,7 +67,8 @@ namespace librealsense
         _focal_lenght_mm(0.f),
         _stereo_baseline_mm(0.f),
         _holes_filling_mode(holes_fill_def),
-        _holes_filling_radius(0)
+        _holes_filling_radius(0),
+        _threads(1)
     {
         _stream_filter.stream = RS2_STREAM_DEPTH;
         _stream_filter.format = RS2_FORMAT_Z16;
@@ -144,6 +153,11 @@ namespace librealsense
         register_option(RS2_OPTION_FILTER_SMOOTH_DELTA, spatial_filter_delta);
         register_option(RS2_OPTION_FILTER_MAGNITUDE, spatial_filter_iterations);
         register_option(RS2_OPTION_HOLES_FILL, holes_filling_mode);
+
+        auto max_threads = std::max<int>(std::thread::hardware_concurrency(), 1);
+        auto processing_threads = std::make_shared<ptr_option<int>>(1, max_threads, 1, 1, &_threads,
+            "Number of threads, including the calling one, that filter each frame in bands of rows and columns");
+        register_option(RS2_OPTION_PROCESSING_THREADS, processing_threads);
     }
 
     rs2::frame spatial_filter::process_frame(const rs2::frame_source& source, const rs2::frame& f)
@@ -153,11 +167,25 @@ namespace librealsense
         update_configuration(f);
         tgt = prepare_target_frame(f, source);
 
+        if (_threads <= 1)
+            _workers.reset();
+        else if (!_workers || int(_workers->size()) != _threads - 1)
+            _workers = std::make_shared<parallel_workers>(_threads - 1);
+
         // Spatial domain transform edge-preserving filter
+#ifdef RS2_USE_CUDA_DEPTH_FILTERS
+        if (!_cuda)
+            _cuda = std::make_shared<rscuda::depth_filters_cuda>();
+
+        _cuda->upload(tgt.get_data(), int(_width), int(_height), _extension_type == RS2_EXTENSION_DISPARITY_FRAME);
+        _cuda->spatial(_spatial_alpha_param, _spatial_edge_threshold, _spatial_iterations, _holes_filling_radius, _holes_filling_mode != 0);
+        _cuda->download(const_cast<void*>(tgt.get_data()));
+#else
         if (_extension_type == RS2_EXTENSION_DISPARITY_FRAME)
             dxf_smooth<float>(const_cast<void*>(tgt.get_data()), _spatial_alpha_param, _spatial_edge_threshold, _spatial_iterations);
         else
             dxf_smooth<uint16_t>(const_cast<void*>(tgt.get_data()), _spatial_alpha_param, _spatial_edge_threshold, _spatial_iterations);
+#endif
 
         return tgt;
     }
@@ -222,6 +250,10 @@ namespace librealsense
 
     rs2::frame spatial_filter::prepare_target_frame(const rs2::frame& f, const rs2::frame_source& source)
     {
+        // A frame that nothing else references is filtered in place
+        if (auto tgt = reuse_input_frame(f, _target_stream_profile, int(_bpp), int(_width), int(_height), int(_stride), _extension_type))
+            return tgt;
+
         // Allocate and copy the content of the original Depth data to the target
         rs2::frame tgt = source.allocate_video_frame(_target_stream_profile, f, int(_bpp), int(_width), int(_height), int(_stride), _extension_type);
 
@@ -229,13 +261,57 @@ namespace librealsense
         return tgt;
     }
 
-    void spatial_filter::recursive_filter_horizontal_fp(void * image_data, float alpha, float deltaZ)
+    void spatial_filter::for_each_band(size_t count, const std::function<void(size_t begin, size_t end)>& filter)
+    {
+        if (!_workers)
+            return filter(0, count);
+
+        // Keep the bands in multiples of 16, so that no two threads write to the same cache line of a row
+        _workers->run_bands(count, 16, filter);
+    }
+
+    size_t spatial_filter::filter_row_simd(uint16_t * target, const uint16_t * other, size_t count, float alpha, uint16_t delta_z, bool check_valid)
+    {
+        size_t u = 0;
+#ifdef __SSSE3__
+        // Same single-precision operations as the scalar code, in the same order, so the results are identical
+        const __m128 a = _mm_set1_ps(alpha), b = _mm_set1_ps(1.f - alpha), round = _mm_set1_ps(0.5f);
+        const __m128i zero = _mm_setzero_si128(), dz = _mm_set1_epi16(static_cast<short>(delta_z));
+        const __m128i bias32 = _mm_set1_epi32(0x8000), bias16 = _mm_set1_epi16(static_cast<short>(0x8000));
+
+        for (; u + 8 <= count; u += 8)
+        {
+            __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i *>(target + u));
+            __m128i o = _mm_loadu_si128(reinterpret_cast<const __m128i *>(other + u));
+
+            // |t - o| < delta_z wherever delta_z - |t - o| does not saturate to zero
+            __m128i diff = _mm_or_si128(_mm_subs_epu16(t, o), _mm_subs_epu16(o, t));
+            __m128i keep = _mm_cmpeq_epi16(_mm_subs_epu16(dz, diff), zero);
+            if (check_valid)
+                keep = _mm_or_si128(keep, _mm_or_si128(_mm_cmpeq_epi16(t, zero), _mm_cmpeq_epi16(o, zero)));
+
+            __m128 lo = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(t, zero)), a),
+                                              _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(o, zero)), b)), round);
+            __m128 hi = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(t, zero)), a),
+                                              _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(o, zero)), b)), round);
+
+            // Truncate to [0, 65535], and pack without SSE4.1 by packing signed around the mid-range
+            __m128i filtered = _mm_xor_si128(_mm_packs_epi32(_mm_sub_epi32(_mm_cvttps_epi32(lo), bias32),
+                                                             _mm_sub_epi32(_mm_cvttps_epi32(hi), bias32)), bias16);
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(target + u), _mm_or_si128(_mm_and_si128(keep, t), _mm_andnot_si128(keep, filtered)));
+        }
+#endif
+        return u;
+    }
+
+    void spatial_filter::recursive_filter_horizontal_fp(void * image_data, float alpha, float deltaZ, size_t begin, size_t end)
     {
         float *image = reinterpret_cast<float*>(image_data);
 
         int v, u;
 
-        for (v = 0; v < _height;) {
+        for (v = int(begin); v < int(end);) {
             // left to right
             float *im = image + v * _width;
             float state = *im;
@@ -357,134 +433,77 @@ namespace librealsense
         }
     }
 
-    void spatial_filter::recursive_filter_vertical_fp(void * image_data, float alpha, float deltaZ)
+    void spatial_filter::recursive_filter_vertical_fp(void * image_data, float alpha, float deltaZ, size_t begin, size_t end)
     {
-        float *image = reinterpret_cast<float*>(image_data);
-
-        int v, u;
-
-        // we'll do one column at a time, top to bottom, bottom to top, left to right,
-
-        for (u = 0; u < _width;) {
+        float *image = reinterpret_cast<float*>(image_data) + begin;
+        auto count = end - begin;
 
-            float *im = image + u;
-            float state = im[0];
-            float previousInnovation = state;
+        // Walk the rows in memory order, keeping the state of the per-column filters of [begin, end) side by side
+        std::vector<float> state(count), previous_innovation(count);
+        std::vector<int> valid(count);
 
-            v = int(_height) - 1;
-            im += _width;
-            float innovation = *im;
+        // The same state machine as the horizontal pass, with the branches turned into selects so that columns can be filtered in SIMD lanes
+        auto filter = [&](float * im)
+        {
+            size_t u = 0;
+#ifdef __SSSE3__
+            const __m128 a = _mm_set1_ps(alpha), b = _mm_set1_ps(1.0f - alpha);
+            const __m128 dz = _mm_set1_ps(deltaZ), minus_dz = _mm_set1_ps(-deltaZ);
+            const __m128i zero = _mm_setzero_si128();
 
-            if (!(*(int*)&previousInnovation > 0))
-                goto CurrentlyInvalidTB;
-            // else fall through
+            for (; u + 4 <= count; u += 4)
+            {
+                __m128 innovation = _mm_loadu_ps(im + u);
+                __m128 st = _mm_loadu_ps(&state[u]);
+                __m128 prev = _mm_loadu_ps(&previous_innovation[u]);
+                __m128 valid_innovation = _mm_castsi128_ps(_mm_cmpgt_epi32(_mm_castps_si128(innovation), zero));
+                __m128 valid_column = _mm_castsi128_ps(_mm_cmpgt_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(&valid[u])), zero));
+
+                __m128 delta = _mm_sub_ps(prev, innovation);
+                __m128 smallDifference = _mm_and_ps(_mm_and_ps(valid_column, valid_innovation),
+                                                    _mm_and_ps(_mm_cmplt_ps(delta, dz), _mm_cmpgt_ps(delta, minus_dz)));
+                __m128 filtered = _mm_add_ps(_mm_mul_ps(innovation, a), _mm_mul_ps(st, b));
+
+                __m128 out = _mm_or_ps(_mm_and_ps(smallDifference, filtered), _mm_andnot_ps(smallDifference, innovation));
+                _mm_storeu_ps(im + u, out);
+                _mm_storeu_ps(&state[u], _mm_or_ps(_mm_and_ps(valid_innovation, out), _mm_andnot_ps(valid_innovation, st)));
+                _mm_storeu_ps(&previous_innovation[u], _mm_or_ps(_mm_and_ps(valid_innovation, innovation), _mm_andnot_ps(valid_innovation, prev)));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(&valid[u]), _mm_srli_epi32(_mm_castps_si128(valid_innovation), 31));
+            }
+#endif
+            for (; u < count; u++)
+            {
+                float innovation = im[u];
+                bool valid_innovation = *(int*)&innovation > 0;
 
-        CurrentlyValidTB:
-            for (;;) {
-                if (*(int*)&innovation > 0) {
-                    float delta = previousInnovation - innovation;
-                    bool smallDifference = delta < deltaZ && delta > -deltaZ;
+                float delta = previous_innovation[u] - innovation;
+                bool smallDifference = valid[u] && valid_innovation && delta < deltaZ && delta > -deltaZ;
+                float filtered = innovation * alpha + state[u] * (1.0f - alpha);
 
-                    if (smallDifference) {
-                        float filtered = innovation * alpha + state * (1.0f - alpha);
-                        *im = state = filtered;
-                    }
-                    else {
-                        state = innovation;
-                    }
-                    v--;
-                    if (v <= 0)
-                        goto DoneTB;
-                    previousInnovation = innovation;
-                    im += _width;
-                    innovation = *im;
-                }
-                else {  // switch to CurrentlyInvalid state
-                    v--;
-                    if (v <= 0)
-                        goto DoneTB;
-                    previousInnovation = innovation;
-                    im += _width;
-                    innovation = *im;
-                    goto CurrentlyInvalidTB;
-                }
+                im[u] = smallDifference ? filtered : innovation;
+                state[u] = valid_innovation ? im[u] : state[u];
+                previous_innovation[u] = valid_innovation ? innovation : previous_innovation[u];
+                valid[u] = valid_innovation;
             }
+        };
 
-        CurrentlyInvalidTB:
-            for (;;) {
-                v--;
-                if (v <= 0)
-                    goto DoneTB;
-                if (*(int*)&innovation > 0) { // switch to CurrentlyValid state
-                    previousInnovation = state = innovation;
-                    im += _width;
-                    innovation = *im;
-                    goto CurrentlyValidTB;
-                }
-                else {
-                    im += _width;
-                    innovation = *im;
-                }
+        auto start = [&](const float * im)
+        {
+            for (size_t u = 0; u < count; u++)
+            {
+                previous_innovation[u] = state[u] = im[u];
+                valid[u] = *(const int*)&im[u] > 0;
             }
-        DoneTB:
+        };
 
-            im = image + u + (_height - 2) * _width;
-            state = im[_width];
-            previousInnovation = state;
-            innovation = *im;
-            v = int(_height) - 1;
-            if (!(*(int*)&previousInnovation > 0))
-                goto CurrentlyInvalidBT;
-            // else fall through
-        CurrentlyValidBT:
-            for (;;) {
-                if (*(int*)&innovation > 0) {
-                    float delta = previousInnovation - innovation;
-                    bool smallDifference = delta < deltaZ && delta > -deltaZ;
-
-                    if (smallDifference) {
-                        float filtered = innovation * alpha + state * (1.0f - alpha);
-                        *im = state = filtered;
-                    }
-                    else {
-                        state = innovation;
-                    }
-                    v--;
-                    if (v <= 0)
-                        goto DoneBT;
-                    previousInnovation = innovation;
-                    im -= _width;
-                    innovation = *im;
-                }
-                else {  // switch to CurrentlyInvalid state
-                    v--;
-                    if (v <= 0)
-                        goto DoneBT;
-                    previousInnovation = innovation;
-                    im -= _width;
-                    innovation = *im;
-                    goto CurrentlyInvalidBT;
-                }
-            }
+        // top to bottom
+        start(image);
+        for (size_t v = 1; v < _height; v++)
+            filter(image + v * _width);
 
-        CurrentlyInvalidBT:
-            for (;;) {
-                v--;
-                if (v <= 0)
-                    goto DoneBT;
-                if (*(int*)&innovation > 0) { // switch to CurrentlyValid state
-                    previousInnovation = state = innovation;
-                    im -= _width;
-                    innovation = *im;
-                    goto CurrentlyValidBT;
-                }
-                else {
-                    im -= _width;
-                    innovation = *im;
-                }
-            }
-        DoneBT:
-            u++;
-        }
+        // bottom to top
+        start(image + (_height - 1) * _width);
+        for (size_t v = _height - 1; v > 0; v--)
+            filter(image + (v - 1) * _width);
     }
 }
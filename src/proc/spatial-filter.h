@@ -12,6 +12,14 @@
 
 #include "../include/librealsense2/hpp/rs_frame.hpp"
 #include "../include/librealsense2/hpp/rs_processing.hpp"
+#include "concurrency.h"
+
+#ifdef RS2_USE_CUDA_DEPTH_FILTERS
+namespace rscuda
+{
+    class depth_filters_cuda;
+}
+#endif
 
 namespace librealsense
 {
@@ -32,31 +40,36 @@ namespace librealsense
             static_assert((std::is_arithmetic<T>::value), "Spatial filter assumes numeric types");
             bool fp = (std::is_floating_point<T>::value);
 
+            // Rows are independent in the horizontal pass and columns in the vertical one, so both are split into bands
             for (int i = 0; i < iterations; i++)
             {
                 if (fp)
                 {
-                    recursive_filter_horizontal_fp(frame_data, alpha, delta);
-                    recursive_filter_vertical_fp(frame_data, alpha, delta);
+                    for_each_band(_height, [&](size_t begin, size_t end) { recursive_filter_horizontal_fp(frame_data, alpha, delta, begin, end); });
+                    for_each_band(_width, [&](size_t begin, size_t end) { recursive_filter_vertical_fp(frame_data, alpha, delta, begin, end); });
                 }
                 else
                 {
-                    recursive_filter_horizontal<T>(frame_data, alpha, delta);
-                    recursive_filter_vertical<T>(frame_data, alpha, delta);
+                    for_each_band(_height, [&](size_t begin, size_t end) { recursive_filter_horizontal<T>(frame_data, alpha, delta, begin, end); });
+                    for_each_band(_width, [&](size_t begin, size_t end) { recursive_filter_vertical<T>(frame_data, alpha, delta, begin, end); });
                 }
             }
 
             // Disparity domain hole filling requires a second pass over the frame data
             // For depth domain a more efficient in-place hole filling is performed
             if (_holes_filling_mode && fp)
-                intertial_holes_fill<T>(static_cast<T*>(frame_data));
+                intertial_holes_fill<T>(static_cast<T*>(frame_data), 0, _height);
         }
 
-        void recursive_filter_horizontal_fp(void * image_data, float alpha, float deltaZ);
-        void recursive_filter_vertical_fp(void * image_data, float alpha, float deltaZ);
+        // Split [0, count) into one band per available thread, and run them in parallel
+        void for_each_band(size_t count, const std::function<void(size_t begin, size_t end)>& filter);
+
+        // Filter the rows/columns in [begin, end)
+        void recursive_filter_horizontal_fp(void * image_data, float alpha, float deltaZ, size_t begin, size_t end);
+        void recursive_filter_vertical_fp(void * image_data, float alpha, float deltaZ, size_t begin, size_t end);
 
         template <typename T>
-        void  recursive_filter_horizontal(void * image_data, float alpha, float deltaZ)
+        void  recursive_filter_horizontal(void * image_data, float alpha, float deltaZ, size_t begin, size_t end)
         {
             size_t v{}, u{};
 
@@ -72,7 +85,7 @@ namespace librealsense
             auto image = reinterpret_cast<T*>(image_data);
             size_t cur_fill = 0;
 
-            for (v = 0; v < _height; v++)
+            for (v = begin; v < end; v++)
             {
                 // left to right
                 T *im = image + v * _width;
@@ -151,10 +164,8 @@ namespace librealsense
         }
 
         template <typename T>
-        void recursive_filter_vertical(void * image_data, float alpha, float deltaZ)
+        void recursive_filter_vertical(void * image_data, float alpha, float deltaZ, size_t begin, size_t end)
         {
-            size_t v{}, u{};
-
             // Handle conversions for invalid input data
             bool fp = (std::is_floating_point<T>::value);
 
@@ -164,60 +175,59 @@ namespace librealsense
             const T valid_threshold = fp ? static_cast<T>(std::numeric_limits<T>::epsilon()) : static_cast<T>(1);
             const T delta_z = static_cast<T>(deltaZ);
 
-            auto image = reinterpret_cast<T*>(image_data);
+            auto image = reinterpret_cast<T*>(image_data) + begin;
+            auto count = end - begin;
 
-            // we'll do one row at a time, top to bottom, then bottom to top
+            // we'll do one row at a time, top to bottom, then bottom to top.
+            // Every row is blended with its already filtered neighbor, independently for each column
 
             // top to bottom
-
-            T *im = image;
-            T im0{};
-            T imw{};
-            for (v = 1; v < _height; v++)
+            for (size_t v = 1; v < _height; v++)
             {
-                for (u = 0; u < _width; u++)
-                {
-                    im0 = im[0];
-                    imw = im[_width];
-
-                    //if ((fabs(im0) >= valid_threshold) && (fabs(imw) >= valid_threshold))
-                    {
-                        T diff = static_cast<T>(fabs(im0 - imw));
-                        if (diff < delta_z)
-                        {
-                            float filtered = imw * alpha + im0 * (1.f - alpha);
-                            im[_width] = static_cast<T>(filtered + round);
-                        }
-                    }
-                    im += 1;
-                }
+                T *im = image + (v - 1) * _width;
+                filter_row<T>(im + _width, im, count, alpha, delta_z, valid_threshold, round, false);
             }
 
             // bottom to top
-            im = image + (_height - 2) * _width;
-            for (v = 1; v < _height; v++, im -= (_width * 2))
+            for (size_t v = _height - 1; v > 0; v--)
             {
-                for (u = 0; u < _width; u++)
-                {
-                    im0 = im[0];
-                    imw = im[_width];
+                T *im = image + (v - 1) * _width;
+                filter_row<T>(im, im + _width, count, alpha, delta_z, valid_threshold, round, true);
+            }
+        }
+
+        // target = target * alpha + other * (1 - alpha) wherever the two differ by less than delta_z (and are both valid, if requested)
+        template <typename T>
+        void filter_row(T * target, const T * other, size_t count, float alpha, T delta_z, T valid_threshold, float round, bool check_valid)
+        {
+            size_t u = filter_row_simd(target, other, count, alpha, delta_z, check_valid);
+
+            for (; u < count; u++)
+            {
+                T imw = target[u];
+                T im0 = other[u];
 
-                    if ((fabs(im0) >= valid_threshold) && (fabs(imw) >= valid_threshold))
+                if (!check_valid || ((fabs(im0) >= valid_threshold) && (fabs(imw) >= valid_threshold)))
+                {
+                    T diff = static_cast<T>(fabs(im0 - imw));
+                    if (diff < delta_z)
                     {
-                        T diff = static_cast<T>(fabs(im0 - imw));
-                        if (diff < delta_z)
-                        {
-                            float filtered = im0 * alpha + imw * (1.f - alpha);
-                            im[0] = static_cast<T>(filtered + round);
-                        }
+                        float filtered = imw * alpha + im0 * (1.f - alpha);
+                        target[u] = static_cast<T>(filtered + round);
                     }
-                    im += 1;
                 }
             }
         }
 
+        // Vectorized filter_row, returning the number of pixels processed. The remainder is left to the scalar code
+        static size_t filter_row_simd(uint16_t * target, const uint16_t * other, size_t count, float alpha, uint16_t delta_z, bool check_valid);
+
+        template <typename T>
+        static size_t filter_row_simd(T * target, const T * other, size_t count, float alpha, T delta_z, bool check_valid) { return 0; }
+
+        // Fill the rows in [begin, end)
         template<typename T>
-        inline void intertial_holes_fill(T* image_data)
+        inline void intertial_holes_fill(T* image_data, size_t begin, size_t end)
         {
             std::function<bool(T*)> fp_oper = [](T* ptr) { return !*((int *)ptr); };
             std::function<bool(T*)> uint_oper = [](T* ptr) { return !(*ptr); };
@@ -225,8 +235,8 @@ namespace librealsense
 
             size_t cur_fill = 0;
 
-            T* p = image_data;
-            for (int j = 0; j < _height; ++j)
+            T* p = image_data + begin * _width;
+            for (size_t j = begin; j < end; ++j)
             {
                 ++p;
                 cur_fill = 0;
@@ -264,6 +274,8 @@ namespace librealsense
         }
 
     private:
+        friend class depth_post_processing;
+
 
         float                   _spatial_alpha_param;
         uint8_t                 _spatial_delta_param;
@@ -280,5 +292,11 @@ namespace librealsense
         float                   _stereo_baseline_mm;
         uint8_t                 _holes_filling_mode;
         uint8_t                 _holes_filling_radius;
+        int                     _threads;
+        std::shared_ptr<parallel_workers> _workers;
+
+#ifdef RS2_USE_CUDA_DEPTH_FILTERS
+        std::shared_ptr<rscuda::depth_filters_cuda> _cuda;
+#endif
     };
 }
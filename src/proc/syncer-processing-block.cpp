@@ -6,15 +6,31 @@
 #include "sync.h"
 #include "proc/synthetic-stream.h"
 #include "proc/syncer-processing-block.h"
+#include "option.h"
+#include "environment.h"
+#include "trace.h"
 
 
 namespace librealsense
 {
     syncer_process_unit::syncer_process_unit()
-        : _matcher((new timestamp_composite_matcher({})))
+        : _matcher((new timestamp_composite_matcher({}))), _latency_budget(0.f)
     {
+        _latency_histogram.fill(0);
+
+        auto latency_budget = std::make_shared<ptr_option<float>>(0.f, 1000.f, 1.f, 0.f, &_latency_budget,
+            "Longest time, in milliseconds, a frameset is held back waiting for its missing frames before it is emitted without them. "
+            "0 waits for as long as the frame rates of the streams suggest");
+        latency_budget->on_set([this](float val)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _matcher->set_latency_budget(val);
+        });
+        register_option(RS2_OPTION_SYNC_LATENCY_BUDGET, latency_budget);
+
         _matcher->set_callback([this](frame_holder f, syncronization_environment env)
         {
+            f->set_stage_time(frame_stage::sync, platform::monotonic_time());
 
             std::stringstream ss;
             ss << "SYNCED: ";
@@ -26,16 +42,26 @@ namespace librealsense
             }
 
             LOG_DEBUG(ss.str());
+
+            // Bucket 0 holds the framesets dispatched within a millisecond, and bucket i those dispatched within 2^i
+            auto latency = platform::monotonic_time() - env.arrival;
+            size_t bucket = 0;
+            while (bucket + 1 < _latency_histogram.size() && latency >= double(1ull << bucket))
+                bucket++;
+            _latency_histogram[bucket]++;
+
             env.matches.enqueue(std::move(f));
         });
 
         auto f = [&](frame_holder frame, synthetic_source_interface* source)
         {
+            trace_scope scope("sync", "frame", frame->get_frame_number());
             single_consumer_frame_queue<frame_holder> matches;
+            auto arrival = platform::monotonic_time();
 
             {
                 std::lock_guard<std::mutex> lock(_mutex);
-                _matcher->dispatch(std::move(frame), { source, matches });
+                _matcher->dispatch(std::move(frame), { source, matches, arrival });
             }
 
             frame_holder f;
@@ -45,4 +71,34 @@ namespace librealsense
         set_processing_callback(std::shared_ptr<rs2_frame_processor_callback>(
             new internal_frame_processor_callback<decltype(f)>(f)));
     }
+
+    unsigned long long syncer_process_unit::get_incomplete_framesets(int stream)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _matcher->get_incomplete_framesets(stream);
+    }
+
+    rs2_sync_stream_stats syncer_process_unit::get_stream_stats(int stream)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        rs2_sync_stream_stats stats{};
+        if (!_matcher->get_stream_stats(stream, &stats))
+            throw invalid_value_exception(to_string() << "The syncer has not received frames of stream " << stream);
+        return stats;
+    }
+
+    rs2_sync_stream_stats syncer_process_unit::get_totals(unsigned long long* queued)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        rs2_sync_stream_stats totals{};
+        *queued = 0;
+        _matcher->get_totals(&totals, queued);
+        return totals;
+    }
+
+    std::vector<unsigned long long> syncer_process_unit::get_latency_histogram()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return std::vector<unsigned long long>(_latency_histogram.begin(), _latency_histogram.end());
+    }
 }
@@ -4,11 +4,13 @@
 #pragma once
 #include "types.h"
 #include "archive.h"
+#include "../include/librealsense2/h/rs_processing.h"
 
 #include <stdint.h>
 #include <vector>
 #include <mutex>
 #include <memory>
+#include <array>
 
 namespace librealsense
 {
@@ -19,11 +21,25 @@ namespace librealsense
     public:
         syncer_process_unit();
 
+        // Number of framesets emitted without a frame of the stream because RS2_OPTION_SYNC_LATENCY_BUDGET ran out
+        unsigned long long get_incomplete_framesets(int stream);
+
+        // Counters of the frames of the stream, kept since the syncer first received one
+        rs2_sync_stream_stats get_stream_stats(int stream);
+
+        // Counters of all the streams, and the number of frames waiting for their matches
+        rs2_sync_stream_stats get_totals(unsigned long long* queued);
+
+        // Number of framesets dispatched within every bucket of RS2_SYNC_LATENCY_BUCKETS, from the arrival of their first frame
+        std::vector<unsigned long long> get_latency_histogram();
+
         ~syncer_process_unit()
         {
             _matcher.reset();
         }
     private:
         std::unique_ptr<timestamp_composite_matcher> _matcher;
+        float _latency_budget;
+        std::array<unsigned long long, RS2_SYNC_LATENCY_BUCKETS> _latency_histogram;
     };
 }
@@ -2,8 +2,15 @@
 // Copyright(c) 2017 Intel Corporation. All Rights Reserved.
 
 #include "core/video.h"
+#include "context.h"
 #include "proc/synthetic-stream.h"
 #include "option.h"
+#include "environment.h"
+#include "trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 
 namespace librealsense
 {
@@ -18,16 +25,104 @@ namespace librealsense
         _source.set_callback(callback);
     }
 
+    const size_t processing_statistics::window_size;
+
+    // The clock of the block being timed on this thread. It is paused while the outputs of the block are delivered, the
+    // consumers of the outputs running within frame_ready, for the time they take not to be counted as that of the block
+    struct processing_clock
+    {
+        const synthetic_source* source;
+        std::chrono::high_resolution_clock::duration paused;
+        processing_clock* outer;    // Of the block whose output invoked this one
+    };
+    static thread_local processing_clock* current_clock = nullptr;
+
+    void processing_statistics::record(double ms, bool dropped)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        ++_invocations;
+        if (dropped)
+            ++_dropped;
+        _total_time += ms;
+        _recent[_next++ % window_size] = static_cast<float>(ms);
+    }
+
+    void processing_statistics::reset()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _invocations = 0;
+        _dropped = 0;
+        _total_time = 0;
+        _next = 0;
+    }
+
+    double processing_statistics::percentile(std::vector<float>& samples, double p) const
+    {
+        if (samples.empty())
+            return 0;
+
+        // Nearest-rank percentile
+        auto rank = static_cast<size_t>(std::ceil(p * samples.size()));
+        auto nth = samples.begin() + (rank ? rank - 1 : 0);
+        std::nth_element(samples.begin(), nth, samples.end());
+        return *nth;
+    }
+
+    rs2_processing_block_stats processing_statistics::get() const
+    {
+        std::vector<float> samples;
+        rs2_processing_block_stats stats;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            stats.invocations = _invocations;
+            stats.dropped_frames = _dropped;
+            stats.total_time = _total_time;
+            samples.assign(_recent.begin(), _recent.begin() + std::min(_next, window_size));
+        }
+        stats.p50_time = percentile(samples, 0.5);
+        stats.p99_time = percentile(samples, 0.99);
+        return stats;
+    }
+
     processing_block::processing_block() :
-        _source_wrapper(_source)
+        _source_wrapper(_source), _collect_stats(false), _stats_enabled(false), _trace_name(nullptr)
     {
         register_option(RS2_OPTION_FRAMES_QUEUE_SIZE, _source.get_published_size_option());
+
+        auto collect_stats = std::make_shared<ptr_option<bool>>(false, true, true, false, &_collect_stats,
+            "Record the frames the block is invoked on and drops, and the time it takes to process them");
+        collect_stats->on_set([this](float val)
+        {
+            // Every recording starts afresh
+            if (val && !_stats_enabled)
+                _stats.reset();
+            _stats_enabled = val != 0;
+        });
+        register_option(RS2_OPTION_PROCESSING_STATISTICS, collect_stats);
+
+        auto stats = [this]() { return _stats.get(); };
+        register_option(RS2_OPTION_PROCESSED_FRAMES, std::make_shared<query_option>(
+            "Number of frames the block was invoked on while recording statistics", [stats]() { return float(stats().invocations); }));
+        register_option(RS2_OPTION_DROPPED_FRAMES, std::make_shared<query_option>(
+            "Number of frames the block failed to process while recording statistics", [stats]() { return float(stats().dropped_frames); }));
+        register_option(RS2_OPTION_PROCESSING_TIME_P50, std::make_shared<query_option>(
+            "Median processing time of the recent frames, in milliseconds", [stats]() { return float(stats().p50_time); }));
+        register_option(RS2_OPTION_PROCESSING_TIME_P99, std::make_shared<query_option>(
+            "99th percentile of the processing time of the recent frames, in milliseconds", [stats]() { return float(stats().p99_time); }));
+
         _source.init(std::shared_ptr<metadata_parser_map>());
     }
 
     void processing_block::invoke(frame_holder f)
     {
         auto callback = _source.begin_callback();
+        trace_scope scope(trace_name(), "processing", f ? f->get_frame_number() : 0);
+        auto collect_stats = _stats_enabled.load(std::memory_order_relaxed);
+        auto start = collect_stats ? std::chrono::high_resolution_clock::now() : std::chrono::high_resolution_clock::time_point();
+        processing_clock clock{ &_source_wrapper, std::chrono::high_resolution_clock::duration::zero(), current_clock };
+        if (collect_stats)
+            current_clock = &clock;
+        bool dropped = false;
         try
         {
             if (_callback)
@@ -40,16 +135,40 @@ namespace librealsense
         }
         catch (...)
         {
+            dropped = true;
             LOG_ERROR("Exception was thrown during user processing callback!");
         }
+
+        if (collect_stats)
+        {
+            current_clock = clock.outer;
+            auto elapsed = std::chrono::high_resolution_clock::now() - start - clock.paused;
+            _stats.record(std::chrono::duration<double, std::milli>(elapsed).count(), dropped);
+        }
+    }
+
+    const char* processing_block::trace_name()
+    {
+        auto name = _trace_name.load(std::memory_order_relaxed);
+        if (!name && tracer::instance().is_enabled())
+        {
+            name = tracer::instance().intern(get_type_name(typeid(*this)));
+            _trace_name = name;
+        }
+        return name;
     }
 
     generic_processing_block::generic_processing_block()
+        : _exclusive_input(nullptr)
     {
         auto on_frame = [this](rs2::frame f, const rs2::frame_source& source)
         {
             std::lock_guard<std::mutex> lock(_mutex);
 
+            // Checked before the block takes references of its own
+            auto input = dynamic_cast<frame*>((frame_interface*)f.get());
+            _exclusive_input = (input && input->is_exclusive()) ? input : nullptr;
+
             std::vector<rs2::frame> frames_to_process;
 
             frames_to_process.push_back(f);
@@ -62,7 +181,7 @@ namespace librealsense
             {
                 if (should_process(f))
                 {
-                    auto res = process_frame(source, f);
+                    auto res = process(source, f);
                     if (!res) continue;
                     if (auto composite = res.as<rs2::frameset>())
                     {
@@ -77,6 +196,8 @@ namespace librealsense
                 }
             }
 
+            _exclusive_input = nullptr;
+
             auto out = prepare_output(source, f, results);
             if(out)
                 source.frame_ready(out);
@@ -86,6 +207,30 @@ namespace librealsense
         processing_block::set_processing_callback(std::shared_ptr<rs2_frame_processor_callback>(callback));
     }
 
+    rs2::frame generic_processing_block::reuse_input_frame(const rs2::frame& f, const rs2::stream_profile& profile,
+        int bpp, int width, int height, int stride, rs2_extension frame_type)
+    {
+        auto ptr = (frame_interface*)f.get();
+        if (!ptr || ptr != _exclusive_input)
+            return rs2::frame();
+
+        auto vf = dynamic_cast<video_frame*>(ptr);
+        if (!vf || vf->get_bpp() != bpp * 8 || vf->get_width() != width || vf->get_height() != height || vf->get_stride() != stride)
+            return rs2::frame();
+
+        auto disparity = dynamic_cast<disparity_frame*>(ptr) != nullptr;
+        auto depth = dynamic_cast<depth_frame*>(ptr) != nullptr;
+        auto same_type = (frame_type == RS2_EXTENSION_DISPARITY_FRAME) ? disparity :
+            (frame_type == RS2_EXTENSION_DEPTH_FRAME) ? depth && !disparity :
+            (frame_type == RS2_EXTENSION_VIDEO_FRAME) && !depth;
+        if (!same_type)
+            return rs2::frame();
+
+        vf->additional_data.depth_stats = {};
+        ptr->set_stream(std::dynamic_pointer_cast<stream_profile_interface>(profile.get()->profile->shared_from_this()));
+        return f;
+    }
+
     rs2::frame generic_processing_block::prepare_output(const rs2::frame_source& source, rs2::frame input, std::vector<rs2::frame> results)
     {
         if (results.empty())
@@ -206,6 +351,122 @@ namespace librealsense
         return true;
     }
 
+    void processing_roi::set_roi(const region_of_interest& roi)
+    {
+        std::lock_guard<std::mutex> lock(_roi_mutex);
+        _roi = roi;
+    }
+
+    region_of_interest processing_roi::get_roi() const
+    {
+        std::lock_guard<std::mutex> lock(_roi_mutex);
+        return _roi;
+    }
+
+    bool processing_roi::roi_in_frame(int width, int height, region_of_interest& roi) const
+    {
+        roi = get_roi();
+        roi.max_x = std::min(roi.max_x, width);
+        roi.max_y = std::min(roi.max_y, height);
+        if (roi.min_x >= roi.max_x || roi.min_y >= roi.max_y)
+            return false;
+        return roi.min_x > 0 || roi.min_y > 0 || roi.max_x < width || roi.max_y < height;
+    }
+
+    void processing_roi::register_roi_options(options_container& options)
+    {
+        auto crop = std::make_shared<ptr_option<bool>>(false, true, true, false, &_crop_to_roi,
+            "Output only the region of interest, instead of the whole frame with the pixels outside the region unprocessed");
+        options.register_option(RS2_OPTION_CROP_TO_ROI, crop);
+    }
+
+    rs2::stream_profile depth_processing_block::roi_profile(const rs2::stream_profile& profile, rs2_format format,
+        const region_of_interest& roi, bool cropped)
+    {
+        if (!cropped && format == profile.format())
+            return profile;
+
+        if (roi.min_x != _profiles_roi.min_x || roi.min_y != _profiles_roi.min_y || roi.max_x != _profiles_roi.max_x || roi.max_y != _profiles_roi.max_y)
+        {
+            _roi_profiles.clear();
+            _profiles_roi = roi;
+        }
+
+        auto key = std::make_tuple(profile.get(), format, cropped);
+        auto it = _roi_profiles.find(key);
+        if (it != _roi_profiles.end())
+            return it->second;
+
+        auto target = profile.clone(profile.stream_type(), profile.stream_index(), format);
+        environment::get_instance().get_extrinsics_graph().register_same_extrinsics(*(stream_interface*)(profile.get()->profile), *(stream_interface*)(target.get()->profile));
+        auto src_vspi = dynamic_cast<video_stream_profile_interface*>(profile.get()->profile);
+        auto tgt_vspi = dynamic_cast<video_stream_profile_interface*>(target.get()->profile);
+        rs2_intrinsics intrin = src_vspi->get_intrinsics();
+        if (cropped)
+        {
+            intrin.width = roi.max_x - roi.min_x;
+            intrin.height = roi.max_y - roi.min_y;
+            intrin.ppx -= roi.min_x;
+            intrin.ppy -= roi.min_y;
+        }
+        tgt_vspi->set_intrinsics([intrin]() { return intrin; });
+        tgt_vspi->set_dims(intrin.width, intrin.height);
+
+        return _roi_profiles[key] = target;
+    }
+
+    rs2::frame depth_processing_block::process(const rs2::frame_source& source, const rs2::frame& f)
+    {
+        auto vf = f.as<rs2::video_frame>();
+        region_of_interest roi;
+        if (!vf || !roi_in_frame(vf.get_width(), vf.get_height(), roi))
+            return process_frame(source, f);
+
+        const auto bpp = vf.get_bytes_per_pixel();
+        const auto width = roi.max_x - roi.min_x;
+        const auto height = roi.max_y - roi.min_y;
+        auto frame_type = f.is<rs2::disparity_frame>() ? RS2_EXTENSION_DISPARITY_FRAME : RS2_EXTENSION_DEPTH_FRAME;
+
+        auto cropped = source.allocate_video_frame(roi_profile(f.get_profile(), f.get_profile().format(), roi, true), f,
+            bpp, width, height, width * bpp, frame_type);
+        auto src = static_cast<const uint8_t*>(vf.get_data()) + roi.min_y * vf.get_stride_in_bytes() + roi.min_x * bpp;
+        auto dst = static_cast<uint8_t*>(const_cast<void*>(cropped.get_data()));
+        for (int y = 0; y < height; ++y)
+            memcpy(dst + y * width * bpp, src + y * vf.get_stride_in_bytes(), width * bpp);
+
+        auto res = process_frame(source, cropped).as<rs2::video_frame>();
+        if (!res || _crop_to_roi || res.get_width() != width || res.get_height() != height)
+            return res;
+
+        // Pixels outside the region keep the input when the block did not change the format, and are invalidated otherwise
+        const auto res_bpp = res.get_bytes_per_pixel();
+        const auto format = res.get_profile().format();
+        const bool same_format = format == f.get_profile().format();
+        frame_type = res.is<rs2::disparity_frame>() ? RS2_EXTENSION_DISPARITY_FRAME : RS2_EXTENSION_DEPTH_FRAME;
+        auto out = source.allocate_video_frame(roi_profile(f.get_profile(), format, roi, false), f,
+            res_bpp, vf.get_width(), vf.get_height(), vf.get_width() * res_bpp, frame_type);
+
+        auto out_data = static_cast<uint8_t*>(const_cast<void*>(out.get_data()));
+        const auto out_stride = vf.get_width() * res_bpp;
+        for (int y = 0; y < vf.get_height(); ++y)
+        {
+            auto row = out_data + y * out_stride;
+            if (same_format)
+                memcpy(row, static_cast<const uint8_t*>(vf.get_data()) + y * vf.get_stride_in_bytes(), out_stride);
+            else if (y < roi.min_y || y >= roi.max_y)
+                memset(row, 0, out_stride);
+            else
+            {
+                memset(row, 0, roi.min_x * res_bpp);
+                memset(row + roi.max_x * res_bpp, 0, (vf.get_width() - roi.max_x) * res_bpp);
+            }
+
+            if (y >= roi.min_y && y < roi.max_y)
+                memcpy(row + roi.min_x * res_bpp, static_cast<const uint8_t*>(res.get_data()) + (y - roi.min_y) * res.get_stride_in_bytes(), width * res_bpp);
+        }
+        return out;
+    }
+
     bool stream_filter_processing_block::should_process(const rs2::frame& frame)
     {
         if (!frame || frame.is<rs2::frameset>())
@@ -216,10 +477,28 @@ namespace librealsense
 
     void synthetic_source::frame_ready(frame_holder result)
     {
+        auto clock = current_clock;
+        if (!clock || clock->source != this)
+        {
+            _actual_source.invoke_callback(std::move(result));
+            return;
+        }
+
+        auto paused = std::chrono::high_resolution_clock::now();
         _actual_source.invoke_callback(std::move(result));
+        clock->paused += std::chrono::high_resolution_clock::now() - paused;
     }
 
     frame_interface* synthetic_source::allocate_points(std::shared_ptr<stream_profile_interface> stream, frame_interface* original)
+    {
+        auto vid_stream = dynamic_cast<video_stream_profile_interface*>(stream.get());
+        if (vid_stream)
+            return allocate_points(stream, original, vid_stream->get_width() * vid_stream->get_height(), false, false, false, true);
+        return nullptr;
+    }
+
+    frame_interface* synthetic_source::allocate_points(std::shared_ptr<stream_profile_interface> stream, frame_interface* original, size_t count, bool pixel_indices, bool normals, bool colors,
+        bool texture_coordinates)
     {
         auto vid_stream = dynamic_cast<video_stream_profile_interface*>(stream.get());
         if (vid_stream)
@@ -228,12 +507,14 @@ namespace librealsense
             data.frame_number = original->get_frame_number();
             data.timestamp = original->get_frame_timestamp();
             data.timestamp_domain = original->get_frame_timestamp_domain();
-            data.metadata_size = 0;
             data.system_time = _actual_source.get_time();
             data.is_blocking = original->is_blocking();
+            data.priority = original->get_priority();
 
-            auto res = _actual_source.alloc_frame(RS2_EXTENSION_POINTS, vid_stream->get_width() * vid_stream->get_height() * sizeof(float) * 5, data, true);
+            auto format = stream->get_format();
+            auto res = _actual_source.alloc_frame(RS2_EXTENSION_POINTS, count * points::get_point_size(format, pixel_indices, normals, colors, texture_coordinates), data, true);
             if (!res) throw wrong_api_call_sequence_exception("Out of frame resources!");
+            static_cast<points*>(res)->set_layout(format, pixel_indices, normals, colors, texture_coordinates);
             res->set_sensor(original->get_sensor());
             res->set_stream(stream);
             return res;
@@ -293,6 +574,7 @@ namespace librealsense
 
         auto of = dynamic_cast<frame*>(original);
         frame_additional_data data = of->additional_data;
+        data.depth_stats = {};     // Of the depth before it is processed
         auto res = _actual_source.alloc_frame(frame_type, stride * height, data, true);
         if (!res) throw wrong_api_call_sequence_exception("Out of frame resources!");
         vf = static_cast<video_frame*>(res);
@@ -346,16 +628,24 @@ namespace librealsense
         for (auto&& f : holders)
             req_size += get_embeded_frames_size(f.frame);
 
-        auto res = _actual_source.alloc_frame(RS2_EXTENSION_COMPOSITE_FRAME, req_size * sizeof(rs2_frame*), d, true);
+        // Most framesets fit within the composite frame, which comes from the pool of the archive with no buffer to allocate
+        auto fits_inline = req_size <= static_cast<int>(composite_frame::max_inline_frames);
+        auto res = _actual_source.alloc_frame(RS2_EXTENSION_COMPOSITE_FRAME, fits_inline ? 0 : req_size * sizeof(rs2_frame*), d, !fits_inline);
         if (!res) return nullptr;
 
         auto cf = static_cast<composite_frame*>(res);
+        if (fits_inline) cf->hold_inline(req_size);
 
+        // A frameset is as blocking, and of as high a priority, as the most of its frames
+        auto priority = std::numeric_limits<int>::min();
         for (auto&& f : holders)
         {
             if (f.is_blocking())
                 res->set_blocking(true);
+            if (f) priority = std::max(priority, f.get_priority());
         }
+        if (priority != std::numeric_limits<int>::min())
+            res->set_priority(priority);
 
         auto frames = cf->get_frames();
         for (auto&& f : holders)
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "core/processing.h"
+#include "core/roi.h"
 #include "image.h"
 #include "source.h"
 #include "../include/librealsense2/hpp/rs_frame.hpp"
@@ -30,6 +31,8 @@ namespace librealsense
         frame_interface* allocate_composite_frame(std::vector<frame_holder> frames) override;
 
         frame_interface* allocate_points(std::shared_ptr<stream_profile_interface> stream, frame_interface* original) override;
+        frame_interface* allocate_points(std::shared_ptr<stream_profile_interface> stream, frame_interface* original, size_t count, bool pixel_indices, bool normals, bool colors,
+            bool texture_coordinates) override;
 
         void frame_ready(frame_holder result) override;
 
@@ -40,6 +43,28 @@ namespace librealsense
         std::shared_ptr<rs2_source> _c_wrapper;
     };
 
+    // Invocation count, drops and processing times of a block. Percentiles are taken over a window of the recent invocations
+    class processing_statistics
+    {
+    public:
+        processing_statistics() : _recent(window_size, 0.f) { reset(); }
+
+        void record(double ms, bool dropped);
+        void reset();
+        rs2_processing_block_stats get() const;
+
+    private:
+        static const size_t window_size = 1024;
+        double percentile(std::vector<float>& samples, double p) const;
+
+        mutable std::mutex _mutex;
+        unsigned long long _invocations;
+        unsigned long long _dropped;
+        double _total_time;
+        std::vector<float> _recent;
+        size_t _next;
+    };
+
     class processing_block : public processing_block_interface, public options_container
     {
     public:
@@ -50,12 +75,23 @@ namespace librealsense
         void invoke(frame_holder frames) override;
         synthetic_source_interface& get_source() override { return _source_wrapper; }
 
+        rs2_processing_block_stats get_stats() const { return _stats.get(); }
+
         virtual ~processing_block() { _source.flush(); }
     protected:
         frame_source _source;
         std::mutex _mutex;
         frame_processor_callback_ptr _callback;
         synthetic_source _source_wrapper;
+
+    private:
+        bool _collect_stats;
+        std::atomic<bool> _stats_enabled;   // Read on every invocation, so that disabled statistics cost a single load
+        processing_statistics _stats;
+
+        // The type of the block, named once traced
+        const char* trace_name();
+        std::atomic<const char*> _trace_name;
     };
 
     class generic_processing_block : public processing_block
@@ -67,8 +103,19 @@ namespace librealsense
     protected:
         rs2::frame prepare_output(const rs2::frame_source& source, rs2::frame input, std::vector<rs2::frame> results);
 
+        // The input frame, as a frame of the target profile to be processed in place, when nothing else references it and it has the
+        // layout of the target. An empty frame otherwise, for the caller to allocate the target and copy the input into it
+        rs2::frame reuse_input_frame(const rs2::frame& f, const rs2::stream_profile& profile,
+            int bpp, int width, int height, int stride, rs2_extension frame_type);
+
         virtual bool should_process(const rs2::frame& frame) = 0;
         virtual rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) = 0;
+
+        // Runs process_frame on a frame the block should process, for blocks to wrap it in steps of their own
+        virtual rs2::frame process(const rs2::frame_source& source, const rs2::frame& f) { return process_frame(source, f); }
+
+    private:
+        frame_interface* _exclusive_input;  // The frame being processed, when the block holds the one reference to it
     };
 
     struct stream_filter
@@ -133,13 +180,50 @@ namespace librealsense
         bool should_process(const rs2::frame& frame) override;
     };
 
-    class depth_processing_block : public stream_filter_processing_block
+    // Rectangle of the frame a block restricts its processing to, including min_x and min_y and excluding max_x and max_y.
+    // The default empty rectangle, like one that does not intersect the frame, processes the whole frame
+    class processing_roi
     {
     public:
-        depth_processing_block() {}
+        processing_roi() : _crop_to_roi(false), _roi{ 0, 0, 0, 0 } {}
+
+        void set_roi(const region_of_interest& roi);
+        region_of_interest get_roi() const;
+
+        virtual ~processing_roi() = default;
+
+    protected:
+        // The part of the rectangle inside a frame of the given size, false when the whole frame is processed
+        bool roi_in_frame(int width, int height, region_of_interest& roi) const;
+
+        // Registers RS2_OPTION_CROP_TO_ROI
+        void register_roi_options(options_container& options);
+
+        bool _crop_to_roi;  // Output only the rectangle, instead of the whole frame with the pixels outside it unprocessed
+
+    private:
+        mutable std::mutex _roi_mutex;
+        region_of_interest _roi;
+    };
+
+    class depth_processing_block : public stream_filter_processing_block, public processing_roi
+    {
+    public:
+        depth_processing_block() { register_roi_options(*this); }
         virtual ~depth_processing_block() { _source.flush(); }
 
     protected:
         bool should_process(const rs2::frame& frame) override;
+
+        // The region of interest is cropped into a frame of its own, with the intrinsics of the crop, for process_frame to filter.
+        // Unless the output is cropped as well, the result goes back into a frame the size of the input.
+        // Blocks that output frames of another size than their input always output the crop
+        rs2::frame process(const rs2::frame_source& source, const rs2::frame& f) override;
+
+    private:
+        rs2::stream_profile roi_profile(const rs2::stream_profile& profile, rs2_format format, const region_of_interest& roi, bool cropped);
+
+        region_of_interest _profiles_roi = { 0, 0, 0, 0 };
+        std::map<std::tuple<const rs2_stream_profile*, rs2_format, bool>, rs2::stream_profile> _roi_profiles;
     };
 }
@@ -9,6 +9,15 @@
 #include "context.h"
 #include "proc/synthetic-stream.h"
 #include "proc/temporal-filter.h"
+#include "proc/disparity-transform.h"
+
+#ifdef RS2_USE_CUDA_DEPTH_FILTERS
+#include "../cuda/cuda-depth-filters.cuh"
+#endif
+
+#ifdef __SSSE3__
+#include <tmmintrin.h> // For SSSE3 intrinsics
+#endif
 
 namespace librealsense
 {
@@ -38,7 +47,14 @@ namespace librealsense
         _delta_param(temp_delta_default),
         _width(0), _height(0), _stride(0), _bpp(0),
         _extension_type(RS2_EXTENSION_DEPTH_FRAME),
-        _current_frm_size_pixels(0)
+        _fuse_to_depth(false),
+        _fuse_requested(false),
+        _fused_factor(0.f),
+        _distance_output(false),
+        _fused_distance(false),
+        _current_frm_size_pixels(0),
+        _history_reset(true),
+        _threads(1)
     {
         _stream_filter.stream = RS2_STREAM_DEPTH;
         _stream_filter.format = RS2_FORMAT_Z16;
@@ -101,6 +117,19 @@ namespace librealsense
         register_option(RS2_OPTION_FILTER_SMOOTH_ALPHA, temporal_filter_alpha);
         register_option(RS2_OPTION_FILTER_SMOOTH_DELTA, temporal_filter_delta);
 
+        auto max_threads = std::max<int>(std::thread::hardware_concurrency(), 1);
+        auto processing_threads = std::make_shared<ptr_option<int>>(1, max_threads, 1, 1, &_threads,
+            "Number of threads, including the calling one, that filter each frame in bands of pixels");
+        register_option(RS2_OPTION_PROCESSING_THREADS, processing_threads);
+
+        auto fused_to_depth = std::make_shared<ptr_option<bool>>(false, true, true, false, &_fuse_to_depth,
+            "Output disparity frames as depth, in place of a disparity to depth transform following the filter");
+        register_option(RS2_OPTION_FUSED_DISPARITY_TO_DEPTH, fused_to_depth);
+
+        auto distance_output = std::make_shared<ptr_option<bool>>(false, true, true, false, &_distance_output,
+            "Output the fused depth in float meters");
+        register_option(RS2_OPTION_DISTANCE_OUTPUT, distance_output);
+
         on_set_persistence_control(_persistence_param);
         on_set_delta(_delta_param);
         on_set_alpha(_alpha_param);
@@ -111,16 +140,224 @@ namespace librealsense
         update_configuration(f);
         auto tgt = prepare_target_frame(f, source);
 
+        if (_threads <= 1)
+            _workers.reset();
+        else if (!_workers || int(_workers->size()) != _threads - 1)
+            _workers = std::make_shared<parallel_workers>(_threads - 1);
+
         // Temporal filter execution
-        if (_extension_type == RS2_EXTENSION_DISPARITY_FRAME)
+#ifdef RS2_USE_CUDA_DEPTH_FILTERS
+        // The history stays on the device, and only the frame is uploaded
+        if (!_cuda)
+            _cuda = std::make_shared<rscuda::depth_filters_cuda>();
+
+        _cuda->upload(_fused_factor > 0.f ? _fused_disparity.data() : tgt.get_data(), int(_width), int(_height), _extension_type == RS2_EXTENSION_DISPARITY_FRAME);
+        _cuda->temporal(_alpha_param, _one_minus_alpha, _delta_param, _persistence_map.data(), _cur_frame_index, _history_reset);
+        _history_reset = false;
+        if (_fused_distance)
+        {
+            _cuda->download(_fused_disparity.data());
+            disparity_to_distance(reinterpret_cast<const float*>(_fused_disparity.data()), reinterpret_cast<float*>(const_cast<void*>(tgt.get_data())),
+                _current_frm_size_pixels, _fused_factor);
+        }
+        else
+        {
+            if (_fused_factor > 0.f)
+                _cuda->disparity_to_depth(_fused_factor);
+            _cuda->download(const_cast<void*>(tgt.get_data()));
+        }
+        _cur_frame_index = (_cur_frame_index + 1) % 8;
+#else
+        if (_fused_distance)
+        {
+            auto disparity = reinterpret_cast<float*>(_fused_disparity.data());
+            auto distance = reinterpret_cast<float*>(const_cast<void*>(tgt.get_data()));
+            temp_jw_smooth<float>(disparity, _last_frame.data(), _history.data(), [&](size_t begin, size_t end)
+            {
+                disparity_to_distance(disparity + begin, distance + begin, end - begin, _fused_factor);
+            });
+        }
+        else if (_fused_factor > 0.f)
+        {
+            auto disparity = reinterpret_cast<float*>(_fused_disparity.data());
+            auto depth = reinterpret_cast<uint16_t*>(const_cast<void*>(tgt.get_data()));
+            temp_jw_smooth<float>(disparity, _last_frame.data(), _history.data(), [&](size_t begin, size_t end)
+            {
+                disparity_to_depth(disparity + begin, depth + begin, end - begin, _fused_factor);
+            });
+        }
+        else if (_extension_type == RS2_EXTENSION_DISPARITY_FRAME)
             temp_jw_smooth<float>(const_cast<void*>(tgt.get_data()), _last_frame.data(), _history.data());
         else
             temp_jw_smooth<uint16_t>(const_cast<void*>(tgt.get_data()), _last_frame.data(), _history.data());
+#endif
 
         return tgt;
     }
 
 
+#ifdef __SSSE3__
+    // Whether the history of each of 16 pixels is credible in the current phase, as a 0x00/0xff mask.
+    // The test is a 256-entry table of bits, looked up by the low nibble of the history, then by the high one
+    static inline __m128i credible(__m128i history, __m128i low_table, __m128i high_table)
+    {
+        const __m128i nibble = _mm_set1_epi8(0x0f);
+        const __m128i bits = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+
+        __m128i low = _mm_and_si128(history, nibble);
+        __m128i high = _mm_and_si128(_mm_srli_epi16(history, 4), nibble);
+
+        // Histories of 0x80 and above are negative as signed bytes
+        __m128i upper = _mm_cmplt_epi8(history, _mm_setzero_si128());
+        __m128i row = _mm_or_si128(_mm_and_si128(upper, _mm_shuffle_epi8(high_table, low)),
+                                   _mm_andnot_si128(upper, _mm_shuffle_epi8(low_table, low)));
+        __m128i bit = _mm_shuffle_epi8(bits, high);
+        return _mm_cmpeq_epi8(_mm_and_si128(row, bit), bit);
+    }
+
+    // history | mask where the new value agrees with the last one, mask where it doesn't and history & ~mask where it is missing
+    static inline __m128i update_history(__m128i history, __m128i agree, __m128i missing, __m128i mask)
+    {
+        return _mm_or_si128(_mm_and_si128(missing, _mm_andnot_si128(mask, history)),
+                            _mm_andnot_si128(missing, _mm_or_si128(mask, _mm_and_si128(agree, history))));
+    }
+
+    static inline __m128i select(__m128i condition, __m128i a, __m128i b)
+    {
+        return _mm_or_si128(_mm_and_si128(condition, a), _mm_andnot_si128(condition, b));
+    }
+
+    static inline __m128 select(__m128 condition, __m128 a, __m128 b)
+    {
+        return _mm_or_ps(_mm_and_ps(condition, a), _mm_andnot_ps(condition, b));
+    }
+#endif
+
+    void temporal_filter::credible_tables(uint8_t low_table[16], uint8_t high_table[16]) const
+    {
+        unsigned char mask = 1 << _cur_frame_index;
+
+        for (int low = 0; low < 16; low++)
+        {
+            low_table[low] = high_table[low] = 0;
+            for (int high = 0; high < 8; high++)
+            {
+                if (_persistence_map[(high << 4) | low] & mask)
+                    low_table[low] |= 1 << high;
+                if (_persistence_map[((high + 8) << 4) | low] & mask)
+                    high_table[low] |= 1 << high;
+            }
+        }
+    }
+
+    size_t temporal_filter::temp_jw_smooth_simd(uint16_t * frame, uint16_t * last_frame, uint8_t * history, size_t count) const
+    {
+        size_t i = 0;
+#ifdef __SSSE3__
+        uint8_t low_bits[16], high_bits[16];
+        credible_tables(low_bits, high_bits);
+        const __m128i low_table = _mm_loadu_si128(reinterpret_cast<const __m128i *>(low_bits));
+        const __m128i high_table = _mm_loadu_si128(reinterpret_cast<const __m128i *>(high_bits));
+
+        // Same single-precision operations as the scalar code, in the same order, so the results are identical
+        const __m128 alpha = _mm_set1_ps(_alpha_param), one_minus_alpha = _mm_set1_ps(_one_minus_alpha);
+        const __m128i zero = _mm_setzero_si128(), delta_z = _mm_set1_epi16(_delta_param);
+        const __m128i mask = _mm_set1_epi8(static_cast<char>(1 << _cur_frame_index));
+        const __m128i bias32 = _mm_set1_epi32(0x8000), bias16 = _mm_set1_epi16(static_cast<short>(0x8000));
+
+        for (; i + 16 <= count; i += 16)
+        {
+            __m128i hist = _mm_loadu_si128(reinterpret_cast<const __m128i *>(history + i));
+            __m128i fill = credible(hist, low_table, high_table);
+            __m128i agree[2], missing[2];
+
+            for (int k = 0; k < 2; k++)
+            {
+                auto cur_ptr = reinterpret_cast<__m128i *>(frame + i + k * 8);
+                auto prev_ptr = reinterpret_cast<__m128i *>(last_frame + i + k * 8);
+                __m128i cur_val = _mm_loadu_si128(cur_ptr);
+                __m128i prev_val = _mm_loadu_si128(prev_ptr);
+
+                // |cur - prev| < delta_z wherever delta_z - |cur - prev| does not saturate to zero
+                __m128i diff = _mm_or_si128(_mm_subs_epu16(cur_val, prev_val), _mm_subs_epu16(prev_val, cur_val));
+                missing[k] = _mm_cmpeq_epi16(cur_val, zero);
+                __m128i no_prev = _mm_cmpeq_epi16(prev_val, zero);
+                __m128i disagree = _mm_or_si128(_mm_or_si128(missing[k], no_prev), _mm_cmpeq_epi16(_mm_subs_epu16(delta_z, diff), zero));
+                agree[k] = _mm_andnot_si128(disagree, _mm_cmpeq_epi16(zero, zero));
+
+                __m128 lo = _mm_add_ps(_mm_mul_ps(alpha, _mm_cvtepi32_ps(_mm_unpacklo_epi16(cur_val, zero))),
+                                       _mm_mul_ps(one_minus_alpha, _mm_cvtepi32_ps(_mm_unpacklo_epi16(prev_val, zero))));
+                __m128 hi = _mm_add_ps(_mm_mul_ps(alpha, _mm_cvtepi32_ps(_mm_unpackhi_epi16(cur_val, zero))),
+                                       _mm_mul_ps(one_minus_alpha, _mm_cvtepi32_ps(_mm_unpackhi_epi16(prev_val, zero))));
+
+                // Truncate to [0, 65535], and pack without SSE4.1 by packing signed around the mid-range
+                __m128i result = _mm_xor_si128(_mm_packs_epi32(_mm_sub_epi32(_mm_cvttps_epi32(lo), bias32),
+                                                               _mm_sub_epi32(_mm_cvttps_epi32(hi), bias32)), bias16);
+
+                // Missing values are taken from the last frame if it can be trusted
+                __m128i fill_val = _mm_andnot_si128(no_prev, _mm_and_si128(missing[k], k ? _mm_unpackhi_epi8(fill, fill) : _mm_unpacklo_epi8(fill, fill)));
+                _mm_storeu_si128(cur_ptr, select(agree[k], result, select(fill_val, prev_val, cur_val)));
+                _mm_storeu_si128(prev_ptr, select(agree[k], result, select(missing[k], prev_val, cur_val)));
+            }
+
+            hist = update_history(hist, _mm_packs_epi16(agree[0], agree[1]), _mm_packs_epi16(missing[0], missing[1]), mask);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(history + i), hist);
+        }
+#endif
+        return i;
+    }
+
+    size_t temporal_filter::temp_jw_smooth_simd(float * frame, float * last_frame, uint8_t * history, size_t count) const
+    {
+        size_t i = 0;
+#ifdef __SSSE3__
+        uint8_t low_bits[16], high_bits[16];
+        credible_tables(low_bits, high_bits);
+        const __m128i low_table = _mm_loadu_si128(reinterpret_cast<const __m128i *>(low_bits));
+        const __m128i high_table = _mm_loadu_si128(reinterpret_cast<const __m128i *>(high_bits));
+
+        const __m128 alpha = _mm_set1_ps(_alpha_param), one_minus_alpha = _mm_set1_ps(_one_minus_alpha);
+        const __m128 zero = _mm_setzero_ps(), delta_z = _mm_set1_ps(static_cast<float>(_delta_param));
+        const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+        const __m128i mask = _mm_set1_epi8(static_cast<char>(1 << _cur_frame_index));
+
+        for (; i + 16 <= count; i += 16)
+        {
+            __m128i hist = _mm_loadu_si128(reinterpret_cast<const __m128i *>(history + i));
+            __m128i fill = credible(hist, low_table, high_table);
+            __m128i fill16[2] = { _mm_unpacklo_epi8(fill, fill), _mm_unpackhi_epi8(fill, fill) };
+            __m128i agree[4], missing[4];
+
+            for (int k = 0; k < 4; k++)
+            {
+                __m128 cur_val = _mm_loadu_ps(frame + i + k * 4);
+                __m128 prev_val = _mm_loadu_ps(last_frame + i + k * 4);
+
+                __m128 diff = _mm_and_ps(_mm_sub_ps(cur_val, prev_val), abs_mask);
+                __m128 miss = _mm_cmpeq_ps(cur_val, zero);
+                __m128 no_prev = _mm_cmpeq_ps(prev_val, zero);
+                __m128 agrees = _mm_andnot_ps(_mm_or_ps(miss, no_prev), _mm_cmplt_ps(diff, delta_z));
+
+                __m128 result = _mm_add_ps(_mm_mul_ps(alpha, cur_val), _mm_mul_ps(one_minus_alpha, prev_val));
+
+                // Missing values are taken from the last frame if it can be trusted
+                __m128i fill32 = (k & 1) ? _mm_unpackhi_epi16(fill16[k / 2], fill16[k / 2]) : _mm_unpacklo_epi16(fill16[k / 2], fill16[k / 2]);
+                __m128 fill_val = _mm_andnot_ps(no_prev, _mm_and_ps(miss, _mm_castsi128_ps(fill32)));
+                _mm_storeu_ps(frame + i + k * 4, select(agrees, result, select(fill_val, prev_val, cur_val)));
+                _mm_storeu_ps(last_frame + i + k * 4, select(agrees, result, select(miss, prev_val, cur_val)));
+
+                agree[k] = _mm_castps_si128(agrees);
+                missing[k] = _mm_castps_si128(miss);
+            }
+
+            __m128i agree8 = _mm_packs_epi16(_mm_packs_epi32(agree[0], agree[1]), _mm_packs_epi32(agree[2], agree[3]));
+            __m128i missing8 = _mm_packs_epi16(_mm_packs_epi32(missing[0], missing[1]), _mm_packs_epi32(missing[2], missing[3]));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(history + i), update_history(hist, agree8, missing8, mask));
+        }
+#endif
+        return i;
+    }
+
     void temporal_filter::on_set_persistence_control(uint8_t val)
     {
         std::lock_guard<std::mutex> lock(_mutex);
@@ -128,6 +365,7 @@ namespace librealsense
         recalc_persistence_map();
         _last_frame.clear();
         _history.clear();
+        _history_reset = true;
     }
 
     void temporal_filter::on_set_alpha(float val)
@@ -138,6 +376,7 @@ namespace librealsense
         _cur_frame_index = 0;
         _last_frame.clear();
         _history.clear();
+        _history_reset = true;
     }
 
     void temporal_filter::on_set_delta(float val)
@@ -147,14 +386,32 @@ namespace librealsense
         _cur_frame_index = 0;
         _last_frame.clear();
         _history.clear();
+        _history_reset = true;
     }
 
     void  temporal_filter::update_configuration(const rs2::frame& f)
     {
-        if (f.get_profile().get() != _source_stream_profile.get())
+        bool fuse = _fuse_to_depth && f.is<rs2::disparity_frame>();
+        if (f.get_profile().get() != _source_stream_profile.get() || fuse != _fuse_requested || (fuse && _distance_output != _fused_distance))
         {
             _source_stream_profile = f.get_profile();
-            _target_stream_profile = _source_stream_profile.clone(RS2_STREAM_DEPTH, 0, _source_stream_profile.format());
+            _fuse_requested = fuse;
+
+            // The fused output converts back like a disparity to depth transform would, into meters with the units folded in the factor
+            _fused_factor = 0.f;
+            _fused_distance = false;
+            float depth_units = 0.f, stereo_baseline = 0.f;
+            if (fuse && disparity_transform::query_stereo_parameters(f, depth_units, stereo_baseline))
+            {
+                auto fx = _source_stream_profile.as<rs2::video_stream_profile>().get_intrinsics().fx;
+                _fused_factor = disparity_transform::conversion_factor(stereo_baseline, fx, depth_units);
+                _fused_distance = _distance_output;
+                if (_fused_distance)
+                    _fused_factor *= depth_units;
+            }
+
+            auto fused_format = _fused_distance ? RS2_FORMAT_DISTANCE : RS2_FORMAT_Z16;
+            _target_stream_profile = _source_stream_profile.clone(RS2_STREAM_DEPTH, 0, _fused_factor > 0.f ? fused_format : _source_stream_profile.format());
 
             environment::get_instance().get_extrinsics_graph().register_same_extrinsics(
                 *(stream_interface*)(f.get_profile().get()->profile),
@@ -174,12 +431,28 @@ namespace librealsense
 
             _history.clear();
             _history.resize(_current_frm_size_pixels*_bpp);
+            _history_reset = true;
 
+            _fused_disparity.clear();
+            if (_fused_factor > 0.f)
+                _fused_disparity.resize(_current_frm_size_pixels*_bpp);
         }
     }
 
     rs2::frame temporal_filter::prepare_target_frame(const rs2::frame& f, const rs2::frame_source& source)
     {
+        if (_fused_factor > 0.f)
+        {
+            // The disparity is filtered aside, and only its conversion is written to the target
+            memmove(_fused_disparity.data(), f.get_data(), _current_frm_size_pixels * _bpp);
+            auto bpp = _fused_distance ? sizeof(float) : sizeof(uint16_t);
+            return source.allocate_video_frame(_target_stream_profile, f, (int)bpp, (int)_width, (int)_height, (int)(_width * bpp), RS2_EXTENSION_DEPTH_FRAME);
+        }
+
+        // A frame that nothing else references is filtered in place
+        if (auto tgt = reuse_input_frame(f, _target_stream_profile, (int)_bpp, (int)_width, (int)_height, (int)_stride, _extension_type))
+            return tgt;
+
         // Allocate and copy the content of the original Depth data to the target
         rs2::frame tgt = source.allocate_video_frame(_target_stream_profile, f, (int)_bpp, (int)_width, (int)_height, (int)_stride, _extension_type);
 
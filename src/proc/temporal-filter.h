@@ -3,6 +3,14 @@
 
 #pragma once
 #include "types.h"
+#include "concurrency.h"
+
+#ifdef RS2_USE_CUDA_DEPTH_FILTERS
+namespace rscuda
+{
+    class depth_filters_cuda;
+}
+#endif
 
 namespace librealsense
 {
@@ -19,13 +27,33 @@ namespace librealsense
 
         rs2::frame prepare_target_frame(const rs2::frame& f, const rs2::frame_source& source);
 
+        // on_band, when set, follows the filtering of every band of pixels while they are still in the cache
         template<typename T>
-        void temp_jw_smooth(void* frame_data, void * _last_frame_data, uint8_t *history)
+        void temp_jw_smooth(void* frame_data, void * _last_frame_data, uint8_t *history, const std::function<void(size_t, size_t)>& on_band = nullptr)
         {
             static_assert((std::is_arithmetic<T>::value), "temporal filter assumes numeric types");
 
-            const bool fp = (std::is_floating_point<T>::value);
+            // Pixels are independent of each other, so the frame is split into bands.
+            // Bands are multiples of 64 pixels, so that no two threads write to the same cache line of the history
+            auto smooth = [&](size_t begin, size_t end)
+            {
+                temp_jw_smooth<T>(frame_data, _last_frame_data, history, begin, end);
+                if (on_band)
+                    on_band(begin, end);
+            };
+
+            if (_workers)
+                _workers->run_bands(_current_frm_size_pixels, 64, smooth);
+            else
+                smooth(0, _current_frm_size_pixels);
+
+            _cur_frame_index = (_cur_frame_index + 1) % 8;  // at end of cycle
+        }
 
+        // Filter the pixels in [begin, end)
+        template<typename T>
+        void temp_jw_smooth(void* frame_data, void * _last_frame_data, uint8_t *history, size_t begin, size_t end)
+        {
             T delta_z = static_cast<T>(_delta_param);
 
             auto frame          = reinterpret_cast<T*>(frame_data);
@@ -34,7 +62,7 @@ namespace librealsense
             unsigned char mask = 1 << _cur_frame_index;
 
             // pass one -- go through image and update all
-            for (size_t i = 0; i < _current_frm_size_pixels; i++)
+            for (size_t i = begin + temp_jw_smooth_simd(frame + begin, _last_frame + begin, history + begin, end - begin); i < end; i++)
             {
                 T cur_val = frame[i];
                 T prev_val = _last_frame[i];
@@ -79,11 +107,18 @@ namespace librealsense
                     history[i] &= ~mask;
                 }
             }
-
-            _cur_frame_index = (_cur_frame_index + 1) % 8;  // at end of cycle
         }
 
+        // Vectorized temp_jw_smooth, returning the number of pixels processed. The remainder is left to the scalar code
+        size_t temp_jw_smooth_simd(uint16_t * frame, uint16_t * last_frame, uint8_t * history, size_t count) const;
+        size_t temp_jw_smooth_simd(float * frame, float * last_frame, uint8_t * history, size_t count) const;
+
+        // The bits of the persistence map for the current phase, as a 16x16 table split by the high bit of the high nibble
+        void credible_tables(uint8_t low_table[16], uint8_t high_table[16]) const;
+
     private:
+        friend class depth_post_processing;
+
         void on_set_persistence_control(uint8_t val);
         void on_set_alpha(float val);
         void on_set_delta(float val);
@@ -97,13 +132,26 @@ namespace librealsense
         size_t                  _width, _height, _stride;
         size_t                  _bpp;
         rs2_extension           _extension_type;            // Strictly Depth/Disparity
+        bool                    _fuse_to_depth;             // Output disparity input as depth, in place of a following disparity to depth transform
+        bool                    _fuse_requested;            // _fuse_to_depth for the current configuration, as applied to a disparity input
+        float                   _fused_factor;              // Conversion factor of the fused output, 0 when the output is not fused
+        bool                    _distance_output;           // The fused output is in float meters rather than Z16
+        bool                    _fused_distance;            // _distance_output for the current configuration
+        std::vector<uint8_t>    _fused_disparity;           // The filtered disparity, converted to the fused output band by band
         size_t                  _current_frm_size_pixels;
         rs2::stream_profile     _source_stream_profile;
         rs2::stream_profile     _target_stream_profile;
         std::vector<uint8_t>    _last_frame;                // Hold the last frame received for the current profile
         std::vector<uint8_t>    _history;                   // represents the history over the last 8 frames, 1 bit per frame
         uint8_t                 _cur_frame_index;
+        bool                    _history_reset;             // Whether the history was cleared since the last frame
         // encodes whether a particular 8 bit history is good enough for all 8 phases of storage
         std::array<uint8_t, PRESISTENCY_LUT_SIZE> _persistence_map;
+        int                     _threads;
+        std::shared_ptr<parallel_workers> _workers;
+
+#ifdef RS2_USE_CUDA_DEPTH_FILTERS
+        std::shared_ptr<rscuda::depth_filters_cuda> _cuda;
+#endif
     };
 }
@@ -0,0 +1,560 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include "../include/librealsense2/rs.hpp"
+#include "../include/librealsense2/rsutil.h"
+
+#include "proc/synthetic-stream.h"
+#include "proc/tsdf-fusion.h"
+#include "option.h"
+#include "environment.h"
+#include "context.h"
+#include "parallel.h"
+
+#include <cmath>
+#include <limits>
+
+namespace librealsense
+{
+    namespace
+    {
+        // Block coordinates are packed 21 bits each into the keys of the hash
+        const int coordinate_bits = 21;
+
+        uint64_t block_key(int x, int y, int z)
+        {
+            const uint64_t mask = (1ull << coordinate_bits) - 1;
+            return ((uint64_t(x) & mask) << (2 * coordinate_bits)) | ((uint64_t(y) & mask) << coordinate_bits) | (uint64_t(z) & mask);
+        }
+
+        int floor_div(int a, int b)
+        {
+            return a >= 0 ? a / b : -((-a + b - 1) / b);
+        }
+
+        int floor_int(float value)
+        {
+            return static_cast<int>(std::floor(value));
+        }
+
+        float length(const float3& v)
+        {
+            return std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+        }
+
+        float dot(const float3& a, const float3& b)
+        {
+            return a.x * b.x + a.y * b.y + a.z * b.z;
+        }
+
+        bool is_depth(const rs2::frame& f)
+        {
+            return f.is<rs2::depth_frame>() && f.get_profile().format() == RS2_FORMAT_Z16;
+        }
+
+        // The pose of a pose frame, from the sensor to the world of its tracking
+        rs2_extrinsics to_extrinsics(const rs2_pose& p)
+        {
+            auto x = p.rotation.x, y = p.rotation.y, z = p.rotation.z, w = p.rotation.w;
+            pose r{ { { 1 - 2 * (y * y + z * z), 2 * (x * y + z * w), 2 * (x * z - y * w) },
+                      { 2 * (x * y - z * w), 1 - 2 * (x * x + z * z), 2 * (y * z + x * w) },
+                      { 2 * (x * z + y * w), 2 * (y * z - x * w), 1 - 2 * (x * x + y * y) } },
+                    { p.translation.x, p.translation.y, p.translation.z } };
+            return from_pose(r);
+        }
+    }
+
+    void tsdf_volume::reset(float voxel_size)
+    {
+        _voxel_size = voxel_size;
+        _blocks.clear();
+        _coordinates.clear();
+        _voxels.clear();
+        _stamps.clear();
+        _visible.clear();
+        _frame = 0;
+    }
+
+    int tsdf_volume::find_block(int x, int y, int z) const
+    {
+        auto it = _blocks.find(block_key(x, y, z));
+        return it == _blocks.end() ? -1 : static_cast<int>(it->second);
+    }
+
+    uint32_t tsdf_volume::allocate_block(int x, int y, int z)
+    {
+        auto index = static_cast<uint32_t>(_coordinates.size());
+        auto it = _blocks.emplace(block_key(x, y, z), index);
+        if (!it.second)
+            return it.first->second;
+
+        if (_coordinates.empty())
+        {
+            _min_block = _max_block = { x, y, z };
+        }
+        else
+        {
+            _min_block = { std::min(_min_block.x, x), std::min(_min_block.y, y), std::min(_min_block.z, z) };
+            _max_block = { std::max(_max_block.x, x), std::max(_max_block.y, y), std::max(_max_block.z, z) };
+        }
+        _coordinates.push_back({ x, y, z });
+        _voxels.resize(_voxels.size() + block_voxels, voxel{ 0.f, 0.f });
+        _stamps.push_back(0);
+        return index;
+    }
+
+    const tsdf_volume::voxel* tsdf_volume::find_voxel(int x, int y, int z) const
+    {
+        auto bx = floor_div(x, block_side), by = floor_div(y, block_side), bz = floor_div(z, block_side);
+        auto index = find_block(bx, by, bz);
+        if (index < 0)
+            return nullptr;
+
+        auto&& v = _voxels[size_t(index) * block_voxels +
+            ((z - bz * block_side) * block_side + (y - by * block_side)) * block_side + (x - bx * block_side)];
+        return v.weight > 0 ? &v : nullptr;
+    }
+
+    bool tsdf_volume::sample(const float3& p, float& tsdf) const
+    {
+        // Of the voxels whose centers surround the point
+        float u[] = { p.x / _voxel_size - 0.5f, p.y / _voxel_size - 0.5f, p.z / _voxel_size - 0.5f };
+        int base[] = { floor_int(u[0]), floor_int(u[1]), floor_int(u[2]) };
+        float f[] = { u[0] - base[0], u[1] - base[1], u[2] - base[2] };
+
+        tsdf = 0.f;
+        for (int corner = 0; corner < 8; ++corner)
+        {
+            int dx = corner & 1, dy = (corner >> 1) & 1, dz = corner >> 2;
+            auto v = find_voxel(base[0] + dx, base[1] + dy, base[2] + dz);
+            if (!v)
+                return false;
+            tsdf += v->tsdf * (dx ? f[0] : 1 - f[0]) * (dy ? f[1] : 1 - f[1]) * (dz ? f[2] : 1 - f[2]);
+        }
+        return true;
+    }
+
+    float3 tsdf_volume::get_normal(const float3& p) const
+    {
+        // The gradient of the distance, which points away from the surface into the space in front of it. The differences
+        // are one-sided at the edges of the observed voxels
+        float3 gradient;
+        float center;
+        bool has_center = sample(p, center);
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            float3 a = p, b = p;
+            a[axis] -= _voxel_size;
+            b[axis] += _voxel_size;
+            float fa, fb;
+            bool has_a = sample(a, fa), has_b = sample(b, fb);
+            if (has_a && has_b)
+                gradient[axis] = fb - fa;
+            else if (has_center && has_b)
+                gradient[axis] = 2 * (fb - center);
+            else if (has_center && has_a)
+                gradient[axis] = 2 * (center - fa);
+            else
+                return{ 0.f, 0.f, 0.f };
+        }
+        auto l = length(gradient);
+        return l > 0 ? gradient * (1.f / l) : float3{ 0.f, 0.f, 0.f };
+    }
+
+    void tsdf_volume::integrate(const uint16_t* depth, const rs2_intrinsics& intrinsics, float depth_units,
+        const rs2_extrinsics& camera_to_world, float truncation, float max_weight)
+    {
+        auto to_world = to_pose(camera_to_world);
+        auto to_camera = inverse(to_world);
+        const float block_size = _voxel_size * block_side;
+        const int width = intrinsics.width, height = intrinsics.height;
+
+        // The blocks within the truncation of the depth of every pixel, sampled along its ray at half the size of a block
+        ++_frame;
+        _visible.clear();
+        for (int y = 0; y < height; ++y)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                auto z = depth[y * width + x] * depth_units;
+                if (!z)
+                    continue;
+
+                const float pixel[] = { float(x), float(y) };
+                float3 ray;
+                rs2_deproject_pixel_to_point(&ray.x, &intrinsics, pixel, 1.f);
+
+                auto near_z = std::max(z - truncation, 0.f), far_z = z + truncation;
+                auto steps = std::max(1, static_cast<int>(std::ceil((far_z - near_z) * length(ray) / (block_size * 0.5f))));
+                for (int s = 0; s <= steps; ++s)
+                {
+                    auto p = to_world * (ray * (near_z + (far_z - near_z) * s / steps));
+                    auto index = allocate_block(floor_int(p.x / block_size), floor_int(p.y / block_size), floor_int(p.z / block_size));
+                    if (_stamps[index] != _frame)
+                    {
+                        _stamps[index] = _frame;
+                        _visible.push_back(index);
+                    }
+                }
+            }
+        }
+
+        parallel_for(0, int(_visible.size()), 8, [&](int first, int last)
+        {
+            for (int b = first; b < last; ++b)
+            {
+                auto index = _visible[b];
+                auto&& c = _coordinates[index];
+                auto v = _voxels.data() + size_t(index) * block_voxels;
+                for (int k = 0; k < block_side; ++k)
+                {
+                    for (int j = 0; j < block_side; ++j)
+                    {
+                        for (int i = 0; i < block_side; ++i, ++v)
+                        {
+                            float3 center{ (c.x * block_side + i + 0.5f) * _voxel_size, (c.y * block_side + j + 0.5f) * _voxel_size,
+                                (c.z * block_side + k + 0.5f) * _voxel_size };
+                            auto point = to_camera * center;
+                            if (point.z <= 0)
+                                continue;
+
+                            float pixel[2];
+                            rs2_project_point_to_pixel(pixel, &intrinsics, &point.x);
+                            auto px = floor_int(pixel[0] + 0.5f), py = floor_int(pixel[1] + 0.5f);
+                            if (px < 0 || py < 0 || px >= width || py >= height)
+                                continue;
+
+                            auto z = depth[py * width + px] * depth_units;
+                            auto sdf = z - point.z;
+                            if (!z || sdf < -truncation)
+                                continue;
+
+                            auto tsdf = std::min(1.f, sdf / truncation);
+                            v->tsdf = (v->tsdf * v->weight + tsdf) / (v->weight + 1);
+                            v->weight = std::min(v->weight + 1, max_weight);
+                        }
+                    }
+                }
+            }
+        });
+    }
+
+    void tsdf_volume::raycast(const rs2_intrinsics& intrinsics, const rs2_extrinsics& camera_to_world, float truncation,
+        float3* vertices, float3* normals) const
+    {
+        const int width = intrinsics.width, height = intrinsics.height;
+        memset(vertices, 0, sizeof(float3) * width * height);
+        memset(normals, 0, sizeof(float3) * width * height);
+        if (_coordinates.empty())
+            return;
+
+        auto to_world = to_pose(camera_to_world);
+        auto to_camera = transpose(to_world.orientation);
+        const float block_size = _voxel_size * block_side;
+        float3 low{ _min_block.x * block_size, _min_block.y * block_size, _min_block.z * block_size };
+        float3 high{ (_max_block.x + 1) * block_size, (_max_block.y + 1) * block_size, (_max_block.z + 1) * block_size };
+        auto origin = to_world.position;
+
+        parallel_for(0, height, 4, [&](int first, int last)
+        {
+            for (int y = first; y < last; ++y)
+            {
+                for (int x = 0; x < width; ++x)
+                {
+                    const float pixel[] = { float(x), float(y) };
+                    float3 ray;
+                    rs2_deproject_pixel_to_point(&ray.x, &intrinsics, pixel, 1.f);
+                    ray = ray * (1.f / length(ray));
+                    auto direction = to_world.orientation * ray;
+
+                    // Marched within the bounds of the blocks
+                    float t0 = 0.f, t1 = std::numeric_limits<float>::max();
+                    bool inside = true;
+                    for (int axis = 0; axis < 3 && inside; ++axis)
+                    {
+                        if (std::fabs(direction[axis]) < 1e-9f)
+                        {
+                            inside = origin[axis] >= low[axis] && origin[axis] <= high[axis];
+                            continue;
+                        }
+                        auto ta = (low[axis] - origin[axis]) / direction[axis], tb = (high[axis] - origin[axis]) / direction[axis];
+                        t0 = std::max(t0, std::min(ta, tb));
+                        t1 = std::min(t1, std::max(ta, tb));
+                        inside = t0 <= t1;
+                    }
+                    if (!inside)
+                        continue;
+
+                    bool previous = false;
+                    float previous_tsdf = 0.f, previous_t = 0.f;
+                    for (auto t = t0; t <= t1;)
+                    {
+                        auto p = origin + direction * t;
+                        auto vx = floor_int(p.x / _voxel_size), vy = floor_int(p.y / _voxel_size), vz = floor_int(p.z / _voxel_size);
+                        if (find_block(floor_div(vx, block_side), floor_div(vy, block_side), floor_div(vz, block_side)) < 0)
+                        {
+                            previous = false;
+                            t += block_size * 0.5f;
+                            continue;
+                        }
+                        auto v = find_voxel(vx, vy, vz);
+                        if (!v)
+                        {
+                            previous = false;
+                            t += _voxel_size;
+                            continue;
+                        }
+
+                        // A surface seen from its front, at the zero of the distances interpolated on either side
+                        if (previous && previous_tsdf > 0 && v->tsdf <= 0)
+                        {
+                            float fa = previous_tsdf, fb = v->tsdf;
+                            float sa, sb;
+                            if (sample(origin + direction * previous_t, sa) && sample(p, sb) && sa > sb)
+                            {
+                                fa = sa;
+                                fb = sb;
+                            }
+                            auto hit_t = previous_t + (t - previous_t) * fa / (fa - fb);
+                            auto vertex = ray * hit_t;
+                            auto normal = to_camera * get_normal(origin + direction * hit_t);
+                            if (dot(normal, vertex) > 0)
+                                normal = normal * -1.f;
+                            vertices[y * width + x] = vertex;
+                            normals[y * width + x] = normal;
+                            break;
+                        }
+
+                        previous = true;
+                        previous_tsdf = v->tsdf;
+                        previous_t = t;
+                        t += std::max(_voxel_size, v->tsdf * truncation * 0.8f);
+                    }
+                }
+            }
+        });
+    }
+
+    void tsdf_volume::extract_points(std::vector<float3>& vertices, std::vector<float3>& normals) const
+    {
+        // The points of every block, gathered in its order
+        std::vector<std::vector<float3>> block_vertices(_coordinates.size());
+        parallel_for(0, int(_coordinates.size()), 8, [&](int first, int last)
+        {
+            for (int b = first; b < last; ++b)
+            {
+                auto&& c = _coordinates[b];
+                auto block = _voxels.data() + size_t(b) * block_voxels;
+                for (int k = 0; k < block_side; ++k)
+                {
+                    for (int j = 0; j < block_side; ++j)
+                    {
+                        for (int i = 0; i < block_side; ++i)
+                        {
+                            auto&& v = block[(k * block_side + j) * block_side + i];
+                            if (!v.weight)
+                                continue;
+
+                            int g[] = { c.x * block_side + i, c.y * block_side + j, c.z * block_side + k };
+                            int local[] = { i, j, k };
+                            const int steps[] = { 1, block_side, block_side * block_side };
+                            for (int axis = 0; axis < 3; ++axis)
+                            {
+                                // Within the block, the neighbour is found without the hash
+                                auto n = local[axis] + 1 < block_side ? &v + steps[axis] : nullptr;
+                                if (n && !n->weight)
+                                    continue;
+                                if (!n)
+                                    n = find_voxel(g[0] + (axis == 0), g[1] + (axis == 1), g[2] + (axis == 2));
+
+                                // Of the distances across the surface, rather than the truncated ones on either side of it
+                                if (!n || (v.tsdf > 0) == (n->tsdf > 0) || std::fabs(v.tsdf - n->tsdf) >= 1.f)
+                                    continue;
+
+                                float3 p{ (g[0] + 0.5f) * _voxel_size, (g[1] + 0.5f) * _voxel_size, (g[2] + 0.5f) * _voxel_size };
+                                p[axis] += _voxel_size * v.tsdf / (v.tsdf - n->tsdf);
+                                block_vertices[b].push_back(p);
+                            }
+                        }
+                    }
+                }
+            }
+        });
+
+        vertices.clear();
+        for (auto&& points : block_vertices)
+            vertices.insert(vertices.end(), points.begin(), points.end());
+
+        normals.resize(vertices.size());
+        parallel_for(0, int(vertices.size()), 1024, [&](int first, int last)
+        {
+            for (int i = first; i < last; ++i)
+                normals[i] = get_normal(vertices[i]);
+        });
+    }
+
+    tsdf_fusion::tsdf_fusion()
+        : _voxel_size(0.01f), _truncation(0.04f), _max_weight(64.f), _volume_voxel_size(0.f), _camera_pose(identity_matrix()), _set_frames(0)
+    {
+        auto voxel_size = std::make_shared<ptr_option<float>>(0.001f, 0.1f, 0.001f, 0.01f, &_voxel_size,
+            "Edge length, in meters, of the voxels of the volume. Changing it clears the volume");
+        register_option(RS2_OPTION_VOXEL_SIZE, voxel_size);
+
+        auto truncation = std::make_shared<ptr_option<float>>(0.001f, 0.5f, 0.001f, 0.04f, &_truncation,
+            "Distance, in meters, from the surfaces beyond which the distances of the volume are truncated");
+        register_option(RS2_OPTION_TSDF_TRUNCATION, truncation);
+
+        auto max_weight = std::make_shared<ptr_option<float>>(1.f, 1000.f, 1.f, 64.f, &_max_weight,
+            "Number of frames the distances of the volume are averaged over at most");
+        register_option(RS2_OPTION_TSDF_MAX_WEIGHT, max_weight);
+    }
+
+    void tsdf_fusion::set_camera_pose(const rs2_extrinsics& camera_to_world)
+    {
+        std::lock_guard<std::mutex> lock(_volume_mutex);
+        _camera_pose = camera_to_world;
+    }
+
+    void tsdf_fusion::reset()
+    {
+        std::lock_guard<std::mutex> lock(_volume_mutex);
+        reset_volume();
+    }
+
+    void tsdf_fusion::reset_volume()
+    {
+        _volume_voxel_size = _voxel_size;
+#ifdef RS2_USE_CUDA
+        if (!_volume_cuda)
+            _volume_cuda = std::make_shared<rscuda::tsdf_volume_cuda>();
+        _volume_cuda->reset(_volume_voxel_size);
+#else
+        _volume.reset(_volume_voxel_size);
+#endif
+    }
+
+    bool tsdf_fusion::should_process(const rs2::frame& frame)
+    {
+        if (!frame)
+            return false;
+
+        // The frames of a frameset follow it, and are integrated with it
+        if (auto set = frame.as<rs2::frameset>())
+        {
+            _set_frames = set.size();
+            for (auto&& f : set)
+                if (is_depth(f))
+                    return true;
+            return false;
+        }
+        if (_set_frames)
+        {
+            --_set_frames;
+            return false;
+        }
+        return is_depth(frame);
+    }
+
+    rs2::frame tsdf_fusion::process_frame(const rs2::frame_source& source, const rs2::frame& f)
+    {
+        rs2::frame depth;
+        rs2::frame pose;
+        if (auto set = f.as<rs2::frameset>())
+        {
+            for (auto&& frame : set)
+            {
+                if (!depth && is_depth(frame))
+                    depth = frame;
+                else if (!pose && frame.is<rs2::pose_frame>())
+                    pose = frame;
+            }
+        }
+        else
+        {
+            depth = f;
+        }
+
+        if (depth.get_profile().get() != _source_stream_profile.get())
+        {
+            _source_stream_profile = depth.get_profile();
+            _target_stream_profile = _source_stream_profile.clone(_source_stream_profile.stream_type(), _source_stream_profile.stream_index(), RS2_FORMAT_XYZ32F);
+        }
+
+        auto intrinsics = _source_stream_profile.as<rs2::video_stream_profile>().get_intrinsics();
+        auto sensor = ((frame_interface*)depth.get())->get_sensor().get();
+        auto depth_units = sensor->get_option(RS2_OPTION_DEPTH_UNITS).query();
+
+        std::lock_guard<std::mutex> lock(_volume_mutex);
+        auto camera_to_world = _camera_pose;
+        if (pose)
+        {
+            rs2_extrinsics depth_to_pose;
+            if (!environment::get_instance().get_extrinsics_graph().try_fetch_extrinsics(
+                *(stream_interface*)(_source_stream_profile.get()->profile), *(stream_interface*)(pose.get_profile().get()->profile), &depth_to_pose))
+                depth_to_pose = identity_matrix();
+            camera_to_world = from_pose(to_pose(to_extrinsics(pose.as<rs2::pose_frame>().get_pose_data())) * to_pose(depth_to_pose));
+        }
+
+        if (_volume_voxel_size != _voxel_size)
+            reset_volume();
+
+#ifdef RS2_USE_CUDA
+        // GPU-resident depth is integrated where it is
+        auto d_depth = static_cast<const uint16_t*>(get_device_data((frame_interface*)depth.get()));
+        _volume_cuda->integrate(d_depth ? nullptr : static_cast<const uint16_t*>(depth.get_data()), d_depth,
+            intrinsics, depth_units, camera_to_world, _truncation, _max_weight);
+#else
+        _volume.integrate(static_cast<const uint16_t*>(depth.get_data()), intrinsics, depth_units, camera_to_world, _truncation, _max_weight);
+#endif
+        _last_depth = depth;
+        return f;
+    }
+
+    frame_interface* tsdf_fusion::allocate_points(size_t count)
+    {
+        if (!_last_depth)
+            throw wrong_api_call_sequence_exception("No depth frame was integrated into the volume");
+
+        auto profile = std::dynamic_pointer_cast<stream_profile_interface>(_target_stream_profile.get()->profile->shared_from_this());
+        auto res = _source_wrapper.allocate_points(profile, (frame_interface*)_last_depth.get(), count, false, true, false, true);
+        if (!res)
+            throw std::runtime_error("Failed to allocate the points of the volume");
+        memset(((librealsense::points*)res)->get_texture_coordinates(), 0, count * sizeof(float2));
+        return res;
+    }
+
+    frame_interface* tsdf_fusion::raycast(const rs2_intrinsics& intrinsics, const rs2_extrinsics& camera_to_world)
+    {
+        std::lock_guard<std::mutex> lock(_volume_mutex);
+        auto res = allocate_points(size_t(intrinsics.width) * intrinsics.height);
+        auto pframe = (librealsense::points*)res;
+#ifdef RS2_USE_CUDA
+        _volume_cuda->raycast(intrinsics, camera_to_world, _truncation, &pframe->get_vertices()->x, &pframe->get_normals()->x);
+#else
+        _volume.raycast(intrinsics, camera_to_world, _truncation, pframe->get_vertices(), pframe->get_normals());
+#endif
+        return res;
+    }
+
+    frame_interface* tsdf_fusion::extract_points()
+    {
+        std::lock_guard<std::mutex> lock(_volume_mutex);
+#ifdef RS2_USE_CUDA
+        std::vector<float> vertices, normals;
+        _volume_cuda->extract_points(vertices, normals);
+        auto count = vertices.size() / 3;
+#else
+        std::vector<float3> vertices, normals;
+        _volume.extract_points(vertices, normals);
+        auto count = vertices.size();
+#endif
+        auto res = allocate_points(count);
+        auto pframe = (librealsense::points*)res;
+        if (count)
+        {
+            memcpy(pframe->get_vertices(), vertices.data(), count * sizeof(float3));
+            memcpy(pframe->get_normals(), normals.data(), count * sizeof(float3));
+        }
+        return res;
+    }
+}
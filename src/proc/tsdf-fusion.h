@@ -0,0 +1,119 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "synthetic-stream.h"
+
+#include <unordered_map>
+
+#ifdef RS2_USE_CUDA
+#include "../cuda/cuda-tsdf.cuh"
+#endif
+
+namespace librealsense
+{
+    // Truncated signed distance function of the surfaces seen by depth frames, in blocks of 8x8x8 voxels allocated around the
+    // surfaces alone and found through a hash of their coordinates. Distances are in units of the truncation, positive in front
+    // of the surfaces, and averaged over the frames with weights capped for the volume to follow changes of the scene
+    class tsdf_volume
+    {
+    public:
+        static const int block_side = 8;
+        static const int block_voxels = block_side * block_side * block_side;
+
+        tsdf_volume() : _voxel_size(0.f), _frame(0) {}
+
+        // Clears the volume, for voxels of voxel_size meters
+        void reset(float voxel_size);
+        size_t get_block_count() const { return _coordinates.size(); }
+
+        // The voxels of the blocks within truncation meters of the depth are updated, the blocks being allocated first
+        void integrate(const uint16_t* depth, const rs2_intrinsics& intrinsics, float depth_units,
+            const rs2_extrinsics& camera_to_world, float truncation, float max_weight);
+
+        // The surface seen by every pixel of a camera, in the coordinates of the camera, and its normal facing the camera.
+        // Both are zero for the pixels seeing no surface
+        void raycast(const rs2_intrinsics& intrinsics, const rs2_extrinsics& camera_to_world, float truncation,
+            float3* vertices, float3* normals) const;
+
+        // The points where the distance crosses zero between neighbouring voxels, in the coordinates of the world
+        void extract_points(std::vector<float3>& vertices, std::vector<float3>& normals) const;
+
+    private:
+        struct voxel
+        {
+            float               tsdf;
+            float               weight;
+        };
+
+        struct block_coordinates
+        {
+            int                 x, y, z;
+        };
+
+        // Index of the block, -1 when it is not allocated
+        int find_block(int x, int y, int z) const;
+        uint32_t allocate_block(int x, int y, int z);
+
+        // The voxel of the global voxel coordinates, nullptr when unallocated or never observed
+        const voxel* find_voxel(int x, int y, int z) const;
+
+        // Trilinear interpolation of the distance at a point of the world, false when a voxel around it is unobserved
+        bool sample(const float3& p, float& tsdf) const;
+        float3 get_normal(const float3& p) const;
+
+        float                               _voxel_size;
+        std::unordered_map<uint64_t, uint32_t> _blocks;
+        std::vector<block_coordinates>      _coordinates;
+        std::vector<voxel>                  _voxels;        // block_voxels of every block, x first
+        block_coordinates                   _min_block, _max_block;
+
+        std::vector<uint32_t>               _stamps;        // Frame every block was last seen by
+        std::vector<uint32_t>               _visible;
+        uint32_t                            _frame;
+    };
+
+    // Integrates depth frames into a volume for reconstruction. The input frames pass through the block, and the volume
+    // is raycast and extracted on demand. The pose of the camera is that of the pose frame of the frameset, composed with the
+    // extrinsics of the depth to the pose stream, or else the one set_camera_pose sets. With RS2_USE_CUDA the volume and
+    // every step run on the GPU, and the depth frames already in device memory are read where they are
+    class tsdf_fusion : public generic_processing_block
+    {
+    public:
+        tsdf_fusion();
+
+        void set_camera_pose(const rs2_extrinsics& camera_to_world);
+        void reset();
+
+        // Points of a camera viewing the volume, of a frame of width * height points with normals, in the camera coordinates
+        frame_interface* raycast(const rs2_intrinsics& intrinsics, const rs2_extrinsics& camera_to_world);
+        // Points of the surfaces of the volume with normals, in the world coordinates
+        frame_interface* extract_points();
+
+    protected:
+        bool should_process(const rs2::frame& frame) override;
+        rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
+
+    private:
+        void reset_volume();
+        frame_interface* allocate_points(size_t count);
+
+        float                   _voxel_size;
+        float                   _truncation;
+        float                   _max_weight;
+        float                   _volume_voxel_size;     // Of the voxels of the volume, reset when the option changes
+        rs2_extrinsics          _camera_pose;
+        size_t                  _set_frames;            // Frames of the last frameset still to be offered to should_process
+
+        std::mutex              _volume_mutex;
+#ifdef RS2_USE_CUDA
+        std::shared_ptr<rscuda::tsdf_volume_cuda> _volume_cuda;
+#else
+        tsdf_volume             _volume;
+#endif
+        rs2::frame              _last_depth;            // The original of the points output on demand
+        rs2::stream_profile     _source_stream_profile;
+        rs2::stream_profile     _target_stream_profile;
+    };
+}
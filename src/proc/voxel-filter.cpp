@@ -0,0 +1,252 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include "../include/librealsense2/rs.hpp"
+#include "../include/librealsense2/rsutil.h"
+
+#include "proc/synthetic-stream.h"
+#include "proc/voxel-filter.h"
+#include "option.h"
+#include "environment.h"
+#include "context.h"
+
+#include <cmath>
+
+#ifdef __SSSE3__
+#include <tmmintrin.h> // For SSSE3 intrinsics
+#endif
+
+namespace librealsense
+{
+    namespace
+    {
+        // Points are binned in chunks for their coordinates to stay in the cache
+        const size_t chunk = 256;
+
+        // Voxel coordinates are packed 21 bits each into the keys of the hash table
+        const int coordinate_bits = 21;
+        const float max_coordinate = float((1 << (coordinate_bits - 1)) - 1);
+        const float min_coordinate = -float(1 << (coordinate_bits - 1));
+
+        uint64_t voxel_key(const int32_t* coordinates)
+        {
+            const uint64_t mask = (1ull << coordinate_bits) - 1;
+            return ((uint64_t(coordinates[0]) & mask) << (2 * coordinate_bits)) |
+                ((uint64_t(coordinates[1]) & mask) << coordinate_bits) |
+                (uint64_t(coordinates[2]) & mask);
+        }
+
+        // Voxel of each of the count floats, as floor(value * scale)
+        void get_coordinates(const float* values, size_t count, float scale, int32_t* coordinates)
+        {
+            size_t i = 0;
+#ifdef __SSSE3__
+            auto s = _mm_set1_ps(scale);
+            auto lo = _mm_set1_ps(min_coordinate);
+            auto hi = _mm_set1_ps(max_coordinate);
+            for (; i + 4 <= count; i += 4)
+            {
+                auto v = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(values + i), s), lo), hi);
+                // Truncation rounds the negative values up, which the all-ones mask of the comparison takes back down
+                auto t = _mm_cvttps_epi32(v);
+                t = _mm_add_epi32(t, _mm_castps_si128(_mm_cmplt_ps(v, _mm_cvtepi32_ps(t))));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(coordinates + i), t);
+            }
+#endif
+            for (; i < count; ++i)
+                coordinates[i] = static_cast<int32_t>(std::floor(std::min(std::max(values[i] * scale, min_coordinate), max_coordinate)));
+        }
+    }
+
+    void voxel_grid::reset(float voxel_size, bool centroid, size_t count)
+    {
+        _inverse_size = 1.f / voxel_size;
+        _centroid = centroid;
+        _voxels.clear();
+
+        // At most half full, for the probes to stay short
+        size_t capacity = 1024;
+        while (capacity < count * 2)
+            capacity *= 2;
+        if (_slots.size() < capacity)
+        {
+            _slots.assign(capacity, slot{ 0, 0, 0 });
+            _generation = 0;
+        }
+
+        // Slots of the previous generations are empty, with no need to clear them on every frame
+        if (++_generation == 0)
+        {
+            for (auto&& s : _slots)
+                s.generation = 0;
+            _generation = 1;
+        }
+    }
+
+    uint32_t voxel_grid::find(uint64_t key)
+    {
+        const size_t mask = _slots.size() - 1;
+        auto i = static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+        while (true)
+        {
+            auto&& s = _slots[i];
+            if (s.generation != _generation)
+            {
+                s.key = key;
+                s.generation = _generation;
+                s.voxel = static_cast<uint32_t>(_voxels.size());
+                _voxels.push_back(voxel{ { 0.f, 0.f, 0.f }, { 0.f, 0.f }, 0 });
+                return s.voxel;
+            }
+            if (s.key == key)
+                return s.voxel;
+            i = (i + 1) & mask;
+        }
+    }
+
+    void voxel_grid::add(const float3* vertices, const float2* texture_coordinates, size_t count)
+    {
+        _coordinates.resize(chunk * 3);
+        for (size_t begin = 0; begin < count; begin += chunk)
+        {
+            auto n = std::min(chunk, count - begin);
+            auto points = vertices + begin;
+            get_coordinates(&points->x, n * 3, _inverse_size, _coordinates.data());
+
+            for (size_t i = 0; i < n; ++i)
+            {
+                if (!points[i].z)
+                    continue;
+
+                auto&& v = _voxels[find(voxel_key(_coordinates.data() + i * 3))];
+                if (v.count && !_centroid)
+                    continue;
+
+                auto tex = texture_coordinates ? texture_coordinates[begin + i] : float2{ 0.f, 0.f };
+                v.sum = v.sum + points[i];
+                v.texture_sum = { v.texture_sum.x + tex.x, v.texture_sum.y + tex.y };
+                v.count++;
+            }
+        }
+    }
+
+    void voxel_grid::get_points(float3* vertices, float2* texture_coordinates) const
+    {
+        for (auto&& v : _voxels)
+        {
+            auto scale = v.count > 1 ? 1.f / v.count : 1.f;
+            *vertices++ = { v.sum.x * scale, v.sum.y * scale, v.sum.z * scale };
+            *texture_coordinates++ = { v.texture_sum.x * scale, v.texture_sum.y * scale };
+        }
+    }
+
+    voxel_filter::voxel_filter()
+        : _voxel_size(0.01f), _voxel_point(voxel_centroid), _depth_units(0.f)
+    {
+        auto voxel_size = std::make_shared<ptr_option<float>>(0.001f, 1.f, 0.001f, 0.01f, &_voxel_size,
+            "Edge length, in meters, of the cubes of the grid");
+        register_option(RS2_OPTION_VOXEL_SIZE, voxel_size);
+
+        auto voxel_point = std::make_shared<ptr_option<uint8_t>>(
+            voxel_centroid,
+            voxel_point_max - 1, 1,
+            voxel_centroid,
+            &_voxel_point,
+            "Point output for every occupied voxel");
+        voxel_point->set_description(0.f, "Centroid");
+        voxel_point->set_description(1.f, "First hit");
+        register_option(RS2_OPTION_VOXEL_POINT, voxel_point);
+    }
+
+    bool voxel_filter::should_process(const rs2::frame& frame)
+    {
+        if (!frame || frame.is<rs2::frameset>())
+            return false;
+
+        auto format = frame.get_profile().format();
+        if (frame.is<rs2::points>())
+            return format == RS2_FORMAT_XYZ32F;
+        return frame.is<rs2::depth_frame>() && format == RS2_FORMAT_Z16;
+    }
+
+    void voxel_filter::bin_points(const rs2::points& points)
+    {
+        auto count = points.size();
+        _grid.reset(_voxel_size, _voxel_point == voxel_centroid, count);
+        _grid.add(reinterpret_cast<const float3*>(points.get_vertices()),
+            reinterpret_cast<const float2*>(points.get_texture_coordinates()), count);
+    }
+
+    void voxel_filter::bin_depth(const rs2::depth_frame& depth)
+    {
+        if (_pixel_rays.empty())
+        {
+            _depth_intrinsics = depth.get_profile().as<rs2::video_stream_profile>().get_intrinsics();
+            _pixel_rays.resize(_depth_intrinsics.width * _depth_intrinsics.height);
+            auto ray = _pixel_rays.data();
+            for (int y = 0; y < _depth_intrinsics.height; ++y)
+            {
+                for (int x = 0; x < _depth_intrinsics.width; ++x, ++ray)
+                {
+                    // The deprojection of every distortion model scales with the depth
+                    const float pixel[] = { float(x), float(y) };
+                    float point[3];
+                    rs2_deproject_pixel_to_point(point, &_depth_intrinsics, pixel, 1.f);
+                    *ray = { point[0], point[1] };
+                }
+            }
+
+            auto sensor = ((frame_interface*)depth.get())->get_sensor().get();
+            _depth_units = sensor->get_option(RS2_OPTION_DEPTH_UNITS).query();
+        }
+
+        const int width = _depth_intrinsics.width;
+        const int height = _depth_intrinsics.height;
+        _grid.reset(_voxel_size, _voxel_point == voxel_centroid, size_t(width) * height);
+
+        // The points of a chunk of a row at a time, binned while they are in the cache
+        alignas(16) float3 vertices[chunk];
+        auto data = static_cast<const uint8_t*>(depth.get_data());
+        auto stride = depth.get_stride_in_bytes();
+        for (int y = 0; y < height; ++y)
+        {
+            auto row = reinterpret_cast<const uint16_t*>(data + y * stride);
+            auto rays = _pixel_rays.data() + y * width;
+            for (int begin = 0; begin < width; begin += int(chunk))
+            {
+                auto n = std::min(int(chunk), width - begin);
+                for (int i = 0; i < n; ++i)
+                {
+                    auto z = _depth_units * row[begin + i];
+                    vertices[i] = { rays[begin + i].x * z, rays[begin + i].y * z, z };
+                }
+                _grid.add(vertices, nullptr, n);
+            }
+        }
+    }
+
+    rs2::frame voxel_filter::process_frame(const rs2::frame_source& source, const rs2::frame& f)
+    {
+        if (f.get_profile().get() != _source_stream_profile.get())
+        {
+            _source_stream_profile = f.get_profile();
+            _target_stream_profile = _source_stream_profile.clone(_source_stream_profile.stream_type(), _source_stream_profile.stream_index(), RS2_FORMAT_XYZ32F);
+            environment::get_instance().get_extrinsics_graph().register_same_extrinsics(
+                *(stream_interface*)(_source_stream_profile.get()->profile), *(stream_interface*)(_target_stream_profile.get()->profile));
+            _pixel_rays.clear();
+        }
+
+        if (auto points = f.as<rs2::points>())
+            bin_points(points);
+        else
+            bin_depth(f.as<rs2::depth_frame>());
+
+        auto res = source.allocate_points(_target_stream_profile, f, static_cast<int>(_grid.size()), false);
+        if (!res)
+            return res;
+
+        auto pframe = (librealsense::points*)(res.get());
+        _grid.get_points(pframe->get_vertices(), pframe->get_texture_coordinates());
+        return res;
+    }
+}
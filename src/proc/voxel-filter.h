@@ -0,0 +1,83 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "synthetic-stream.h"
+
+namespace librealsense
+{
+    enum voxel_point_type : uint8_t {
+        voxel_centroid,
+        voxel_first_hit,
+        voxel_point_max };
+
+    // Occupied voxels of a grid of cubes, in a hash table that is reused from frame to frame. Points are binned in
+    // chunks, their voxel coordinates being computed 4 floats at a time with SSE
+    class voxel_grid
+    {
+    public:
+        voxel_grid() : _inverse_size(1.f), _centroid(true), _generation(0) {}
+
+        // Empties the grid, for at most count points to be added
+        void reset(float voxel_size, bool centroid, size_t count);
+        // Points with no depth are left out. Texture coordinates may be null
+        void add(const float3* vertices, const float2* texture_coordinates, size_t count);
+
+        size_t size() const { return _voxels.size(); }
+        // The point of every voxel, in the order of their first point
+        void get_points(float3* vertices, float2* texture_coordinates) const;
+
+    private:
+        struct slot
+        {
+            uint64_t key;
+            uint32_t generation;
+            uint32_t voxel;
+        };
+
+        struct voxel
+        {
+            float3 sum;             // The first point alone when outputting first hits
+            float2 texture_sum;
+            uint32_t count;
+        };
+
+        uint32_t find(uint64_t key);
+
+        float               _inverse_size;
+        bool                _centroid;
+        std::vector<slot>   _slots;
+        uint32_t            _generation;    // Of the slots in use, the others being empty
+        std::vector<voxel>  _voxels;
+        std::vector<int32_t> _coordinates;  // Of the chunk being binned
+    };
+
+    // Downsamples point clouds to a single point per occupied voxel, the centroid of the points in it or the first of
+    // them. Depth frames are binned as they are deprojected, without computing the points of the whole frame first
+    class voxel_filter : public generic_processing_block
+    {
+    public:
+        voxel_filter();
+
+    protected:
+        bool should_process(const rs2::frame& frame) override;
+        rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
+
+    private:
+        void bin_points(const rs2::points& points);
+        void bin_depth(const rs2::depth_frame& depth);
+
+        float                   _voxel_size;
+        uint8_t                 _voxel_point;
+        voxel_grid              _grid;
+
+        rs2::stream_profile     _source_stream_profile;
+        rs2::stream_profile     _target_stream_profile;
+
+        // Deprojection of every depth pixel at a depth of 1, which the points scale with
+        rs2_intrinsics          _depth_intrinsics;
+        std::vector<float2>     _pixel_rays;
+        float                   _depth_units;
+    };
+}
@@ -0,0 +1,263 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include "../include/librealsense2/rsutil.h"
+
+#include "projection.h"
+#include "image.h"
+
+#include <algorithm>
+
+#ifdef __SSSE3__
+#include <tmmintrin.h> // For SSSE3 intrinsics
+#endif
+
+namespace librealsense
+{
+    namespace
+    {
+        // Pixels or points the array of structures layout is transposed by, on the stack
+        const size_t aos_block = 256;
+
+        // The distortion models, applying to the normalized coordinates the operations of rsutil.h in the same order, on a
+        // coordinate and on 4 lanes of them, for the vectorized pixels to be of the same results as the remaining ones
+        struct no_distortion
+        {
+            explicit no_distortion(const rs2_intrinsics&) {}
+
+            void apply(float&, float&) const {}
+#ifdef __SSSE3__
+            void apply(__m128&, __m128&) const {}
+#endif
+        };
+
+        struct inverse_brown_conrady
+        {
+            explicit inverse_brown_conrady(const rs2_intrinsics& intrin) : c(intrin.coeffs) {}
+
+            void apply(float& x, float& y) const
+            {
+                float r2 = x*x + y*y;
+                float f = 1 + c[0]*r2 + c[1]*r2*r2 + c[4]*r2*r2*r2;
+                float ux = x*f + 2*c[2]*x*y + c[3]*(r2 + 2*x*x);
+                float uy = y*f + 2*c[3]*x*y + c[2]*(r2 + 2*y*y);
+                x = ux;
+                y = uy;
+            }
+#ifdef __SSSE3__
+            void apply(__m128& x, __m128& y) const
+            {
+                const __m128 one = _mm_set1_ps(1.f), two = _mm_set1_ps(2.f);
+                const __m128 c0 = _mm_set1_ps(c[0]), c1 = _mm_set1_ps(c[1]), c2 = _mm_set1_ps(c[2]), c3 = _mm_set1_ps(c[3]), c4 = _mm_set1_ps(c[4]);
+                const __m128 two_c2 = _mm_set1_ps(2*c[2]), two_c3 = _mm_set1_ps(2*c[3]);
+
+                __m128 r2 = _mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y));
+                __m128 f = _mm_add_ps(_mm_add_ps(_mm_add_ps(one, _mm_mul_ps(c0, r2)), _mm_mul_ps(_mm_mul_ps(c1, r2), r2)),
+                    _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(c4, r2), r2), r2));
+                __m128 ux = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, f), _mm_mul_ps(_mm_mul_ps(two_c2, x), y)),
+                    _mm_mul_ps(c3, _mm_add_ps(r2, _mm_mul_ps(_mm_mul_ps(two, x), x))));
+                __m128 uy = _mm_add_ps(_mm_add_ps(_mm_mul_ps(y, f), _mm_mul_ps(_mm_mul_ps(two_c3, x), y)),
+                    _mm_mul_ps(c2, _mm_add_ps(r2, _mm_mul_ps(_mm_mul_ps(two, y), y))));
+                x = ux;
+                y = uy;
+            }
+#endif
+            const float* c;
+        };
+
+        struct modified_brown_conrady
+        {
+            explicit modified_brown_conrady(const rs2_intrinsics& intrin) : c(intrin.coeffs) {}
+
+            void apply(float& x, float& y) const
+            {
+                float r2 = x*x + y*y;
+                float f = 1 + c[0]*r2 + c[1]*r2*r2 + c[4]*r2*r2*r2;
+                x *= f;
+                y *= f;
+                float dx = x + 2*c[2]*x*y + c[3]*(r2 + 2*x*x);
+                float dy = y + 2*c[3]*x*y + c[2]*(r2 + 2*y*y);
+                x = dx;
+                y = dy;
+            }
+#ifdef __SSSE3__
+            void apply(__m128& x, __m128& y) const
+            {
+                const __m128 one = _mm_set1_ps(1.f), two = _mm_set1_ps(2.f);
+                const __m128 c0 = _mm_set1_ps(c[0]), c1 = _mm_set1_ps(c[1]), c2 = _mm_set1_ps(c[2]), c3 = _mm_set1_ps(c[3]), c4 = _mm_set1_ps(c[4]);
+                const __m128 two_c2 = _mm_set1_ps(2*c[2]), two_c3 = _mm_set1_ps(2*c[3]);
+
+                __m128 r2 = _mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y));
+                __m128 f = _mm_add_ps(_mm_add_ps(_mm_add_ps(one, _mm_mul_ps(c0, r2)), _mm_mul_ps(_mm_mul_ps(c1, r2), r2)),
+                    _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(c4, r2), r2), r2));
+                x = _mm_mul_ps(x, f);
+                y = _mm_mul_ps(y, f);
+                __m128 dx = _mm_add_ps(_mm_add_ps(x, _mm_mul_ps(_mm_mul_ps(two_c2, x), y)),
+                    _mm_mul_ps(c3, _mm_add_ps(r2, _mm_mul_ps(_mm_mul_ps(two, x), x))));
+                __m128 dy = _mm_add_ps(_mm_add_ps(y, _mm_mul_ps(_mm_mul_ps(two_c3, x), y)),
+                    _mm_mul_ps(c2, _mm_add_ps(r2, _mm_mul_ps(_mm_mul_ps(two, y), y))));
+                x = dx;
+                y = dy;
+            }
+#endif
+            const float* c;
+        };
+
+        template<class MODEL>
+        void deproject(const rs2_intrinsics& intrin, const float* pixel_x, const float* pixel_y, const float* depth,
+            float* point_x, float* point_y, float* point_z, size_t count)
+        {
+            const MODEL model(intrin);
+            size_t i = 0;
+#ifdef __SSSE3__
+            if (get_simd_level() >= simd_level::ssse3)
+            {
+                const __m128 ppx = _mm_set1_ps(intrin.ppx), ppy = _mm_set1_ps(intrin.ppy);
+                const __m128 fx = _mm_set1_ps(intrin.fx), fy = _mm_set1_ps(intrin.fy);
+                for (; i + 4 <= count; i += 4)
+                {
+                    __m128 x = _mm_div_ps(_mm_sub_ps(_mm_loadu_ps(pixel_x + i), ppx), fx);
+                    __m128 y = _mm_div_ps(_mm_sub_ps(_mm_loadu_ps(pixel_y + i), ppy), fy);
+                    __m128 z = _mm_loadu_ps(depth + i);
+                    model.apply(x, y);
+                    _mm_storeu_ps(point_x + i, _mm_mul_ps(z, x));
+                    _mm_storeu_ps(point_y + i, _mm_mul_ps(z, y));
+                    _mm_storeu_ps(point_z + i, z);
+                }
+            }
+#endif
+            for (; i < count; ++i)
+            {
+                float x = (pixel_x[i] - intrin.ppx) / intrin.fx;
+                float y = (pixel_y[i] - intrin.ppy) / intrin.fy;
+                float z = depth[i];
+                model.apply(x, y);
+                point_x[i] = z * x;
+                point_y[i] = z * y;
+                point_z[i] = z;
+            }
+        }
+
+        template<class MODEL>
+        void project(const rs2_intrinsics& intrin, const float* point_x, const float* point_y, const float* point_z,
+            float* pixel_x, float* pixel_y, size_t count)
+        {
+            const MODEL model(intrin);
+            size_t i = 0;
+#ifdef __SSSE3__
+            if (get_simd_level() >= simd_level::ssse3)
+            {
+                const __m128 ppx = _mm_set1_ps(intrin.ppx), ppy = _mm_set1_ps(intrin.ppy);
+                const __m128 fx = _mm_set1_ps(intrin.fx), fy = _mm_set1_ps(intrin.fy);
+                for (; i + 4 <= count; i += 4)
+                {
+                    __m128 z = _mm_loadu_ps(point_z + i);
+                    __m128 x = _mm_div_ps(_mm_loadu_ps(point_x + i), z);
+                    __m128 y = _mm_div_ps(_mm_loadu_ps(point_y + i), z);
+                    model.apply(x, y);
+                    _mm_storeu_ps(pixel_x + i, _mm_add_ps(_mm_mul_ps(x, fx), ppx));
+                    _mm_storeu_ps(pixel_y + i, _mm_add_ps(_mm_mul_ps(y, fy), ppy));
+                }
+            }
+#endif
+            for (; i < count; ++i)
+            {
+                float x = point_x[i] / point_z[i], y = point_y[i] / point_z[i];
+                model.apply(x, y);
+                pixel_x[i] = x * intrin.fx + intrin.ppx;
+                pixel_y[i] = y * intrin.fy + intrin.ppy;
+            }
+        }
+
+        // Of the trigonometry of the C library, left to rsutil.h for the same results
+        void project_ftheta(const rs2_intrinsics& intrin, const float* point_x, const float* point_y, const float* point_z,
+            float* pixel_x, float* pixel_y, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                const float point[] = { point_x[i], point_y[i], point_z[i] };
+                float pixel[2];
+                rs2_project_point_to_pixel(pixel, &intrin, point);
+                pixel_x[i] = pixel[0];
+                pixel_y[i] = pixel[1];
+            }
+        }
+    }
+
+    void deproject_pixels(const rs2_intrinsics& intrin, const float* pixel_x, const float* pixel_y, const float* depth,
+        float* point_x, float* point_y, float* point_z, size_t count)
+    {
+        if (intrin.model == RS2_DISTORTION_INVERSE_BROWN_CONRADY)
+            deproject<inverse_brown_conrady>(intrin, pixel_x, pixel_y, depth, point_x, point_y, point_z, count);
+        else
+            deproject<no_distortion>(intrin, pixel_x, pixel_y, depth, point_x, point_y, point_z, count);
+    }
+
+    void project_points(const rs2_intrinsics& intrin, const float* point_x, const float* point_y, const float* point_z,
+        float* pixel_x, float* pixel_y, size_t count)
+    {
+        switch (intrin.model)
+        {
+        case RS2_DISTORTION_MODIFIED_BROWN_CONRADY:
+            project<modified_brown_conrady>(intrin, point_x, point_y, point_z, pixel_x, pixel_y, count);
+            break;
+        case RS2_DISTORTION_FTHETA:
+            project_ftheta(intrin, point_x, point_y, point_z, pixel_x, pixel_y, count);
+            break;
+        default:
+            project<no_distortion>(intrin, point_x, point_y, point_z, pixel_x, pixel_y, count);
+            break;
+        }
+    }
+
+    void deprojection_maps(const rs2_intrinsics& intrin, std::vector<float>& map_x, std::vector<float>& map_y)
+    {
+        const size_t width = intrin.width;
+        map_x.resize(width * intrin.height);
+        map_y.resize(width * intrin.height);
+
+        std::vector<float> x(width), y(width), ones(width, 1.f), z(width);
+        for (size_t i = 0; i < width; ++i)
+            x[i] = float(i);
+        for (int row = 0; row < intrin.height; ++row)
+        {
+            std::fill(y.begin(), y.end(), float(row));
+            deproject_pixels(intrin, x.data(), y.data(), ones.data(), map_x.data() + row * width, map_y.data() + row * width, z.data(), width);
+        }
+    }
+
+    void deproject_pixels(const rs2_intrinsics& intrin, const float2* pixels, const float* depth, float3* points, size_t count)
+    {
+        float x[aos_block], y[aos_block], z[aos_block];
+        for (size_t begin = 0; begin < count; begin += aos_block)
+        {
+            auto n = std::min(aos_block, count - begin);
+            for (size_t i = 0; i < n; ++i)
+            {
+                x[i] = pixels[begin + i].x;
+                y[i] = pixels[begin + i].y;
+            }
+            deproject_pixels(intrin, x, y, depth + begin, x, y, z, n);
+            for (size_t i = 0; i < n; ++i)
+                points[begin + i] = { x[i], y[i], z[i] };
+        }
+    }
+
+    void project_points(const rs2_intrinsics& intrin, const float3* points, float2* pixels, size_t count)
+    {
+        float x[aos_block], y[aos_block], z[aos_block];
+        for (size_t begin = 0; begin < count; begin += aos_block)
+        {
+            auto n = std::min(aos_block, count - begin);
+            for (size_t i = 0; i < n; ++i)
+            {
+                x[i] = points[begin + i].x;
+                y[i] = points[begin + i].y;
+                z[i] = points[begin + i].z;
+            }
+            project_points(intrin, x, y, z, x, y, n);
+            for (size_t i = 0; i < n; ++i)
+                pixels[begin + i] = { x[i], y[i] };
+        }
+    }
+}
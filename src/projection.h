@@ -0,0 +1,27 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "types.h"
+
+namespace librealsense
+{
+    // Batches of rs2_deproject_pixel_to_point and rs2_project_point_to_pixel, of bit-exact results with them. The distortion
+    // model is resolved once per call, to a loop specialised for it and vectorized with SSE, but for the ftheta projection.
+    // As the single point functions, the deprojection only undistorts the inverse Brown-Conrady model, and the projection
+    // only distorts the modified Brown-Conrady and ftheta ones
+
+    // Structure of arrays layout, each coordinate in its own array. The arrays may be the same for in place computation
+    void deproject_pixels(const rs2_intrinsics& intrin, const float* pixel_x, const float* pixel_y, const float* depth,
+        float* point_x, float* point_y, float* point_z, size_t count);
+    void project_points(const rs2_intrinsics& intrin, const float* point_x, const float* point_y, const float* point_z,
+        float* pixel_x, float* pixel_y, size_t count);
+
+    // Array of structures layout, of pixels of two floats and points of three
+    void deproject_pixels(const rs2_intrinsics& intrin, const float2* pixels, const float* depth, float3* points, size_t count);
+    void project_points(const rs2_intrinsics& intrin, const float3* points, float2* pixels, size_t count);
+
+    // The deprojection of every pixel of the image at a depth of one, which the depth of the pixel scales into its point
+    void deprojection_maps(const rs2_intrinsics& intrin, std::vector<float>& map_x, std::vector<float>& map_y);
+}
@@ -7,10 +7,13 @@
 #include "context.h"
 #include "device.h"
 #include "algo.h"
+#include "image.h"
+#include "projection.h"
 #include "core/debug.h"
 #include "core/motion.h"
 #include "core/extension.h"
 #include "media/record/record_device.h"
+#include "media/record/segmenting_writer.h"
 #include <media/ros/ros_writer.h>
 #include <media/ros/ros_reader.h>
 #include "core/advanced_mode.h"
@@ -22,9 +25,19 @@
 #include "proc/pointcloud.h"
 #include "proc/disparity-transform.h"
 #include "proc/syncer-processing-block.h"
+#include "proc/multi-device-syncer.h"
 #include "proc/decimation-filter.h"
+#include "proc/depth-codec.h"
+#include "proc/voxel-filter.h"
+#include "proc/normals-filter.h"
+#include "proc/colored-pointcloud.h"
+#include "proc/pointcloud-merger.h"
+#include "proc/tsdf-fusion.h"
+#include "proc/depth-stats.h"
 #include "proc/spatial-filter.h"
 #include "proc/hole-filling-filter.h"
+#include "proc/depth-post-processing.h"
+#include "proc/processing-graph.h"
 #include "media/playback/playback_device.h"
 #include "stream.h"
 #include "../include/librealsense2/h/rs_types.h"
@@ -32,6 +45,11 @@
 #include "environment.h"
 #include "proc/temporal-filter.h"
 #include "software-device.h"
+#include "net/net-server.h"
+#include "shm/shm-publisher.h"
+#include "trace.h"
+#include "pose-prediction.h"
+#include "frame-spill.h"
 
 ////////////////////////
 // API implementation //
@@ -77,6 +95,16 @@ struct rs2_context
     std::shared_ptr<librealsense::context> ctx;
 };
 
+struct rs2_net_server
+{
+    std::shared_ptr<librealsense::net_server> server;
+};
+
+struct rs2_shm_publisher
+{
+    std::shared_ptr<librealsense::shm_publisher> publisher;
+};
+
 struct rs2_device_hub
 {
     std::shared_ptr<librealsense::device_hub> hub;
@@ -99,12 +127,96 @@ struct rs2_pipeline_profile
 
 struct rs2_frame_queue
 {
-    explicit rs2_frame_queue(int cap)
-        : queue(cap)
+    explicit rs2_frame_queue(int cap, rs2_frame_queue_policy policy = RS2_FRAME_QUEUE_POLICY_DROP_OLDEST, unsigned int timeout_ms = 0)
+        : queue(policy == RS2_FRAME_QUEUE_POLICY_KEEP_LATEST ? 1 : cap), policy(policy), timeout(timeout_ms), dropped(0)
+    {
+    }
+
+    rs2_frame_queue(int cap, const std::string& spill_file, unsigned long long max_spill_bytes)
+        : rs2_frame_queue(cap)
+    {
+        spill = std::make_shared<librealsense::frame_spill>(spill_file, max_spill_bytes);
+    }
+
+    void enqueue(librealsense::frame_holder&& frame)
+    {
+        if (spill)
+        {
+            // Behind the spilled frames, the new frame waits on disk too, for the frames to be delivered in order
+            std::lock_guard<std::mutex> lock(spill_mutex);
+            if (spill->empty() && queue.try_enqueue(std::move(frame)))
+                return;
+            if (!spill->push(std::move(frame))) dropped++;
+            return;
+        }
+
+        // Blocking frames, as those of non real-time playback, always wait for room
+        if (frame.is_blocking())
+        {
+            dropped += queue.enqueue(std::move(frame));
+            return;
+        }
+
+        switch (policy)
+        {
+        case RS2_FRAME_QUEUE_POLICY_DROP_NEWEST:
+            if (!queue.try_enqueue(std::move(frame))) dropped++;
+            break;
+        case RS2_FRAME_QUEUE_POLICY_BLOCK:
+            if (!queue.blocking_enqueue(std::move(frame), timeout)) dropped++;
+            break;
+        default:
+            dropped += queue.enqueue(std::move(frame));
+            break;
+        }
+    }
+
+    bool dequeue(librealsense::frame_holder* frame, unsigned int timeout_ms)
+    {
+        if (!queue.dequeue(frame, timeout_ms)) return false;
+        refill();
+        return true;
+    }
+
+    bool try_dequeue(librealsense::frame_holder* frame)
+    {
+        if (!queue.try_dequeue(frame)) return false;
+        refill();
+        return true;
+    }
+
+    void clear()
     {
+        std::lock_guard<std::mutex> lock(spill_mutex);
+        if (spill) spill->clear();
+        queue.clear();
     }
 
     single_consumer_frame_queue<librealsense::frame_holder> queue;
+    const rs2_frame_queue_policy policy;
+    const std::chrono::milliseconds timeout;
+    std::atomic<unsigned long long> dropped;
+
+    // The frames the queue has no room for, of the queues created with a spill file
+    std::shared_ptr<librealsense::frame_spill> spill;
+    std::mutex spill_mutex;
+
+private:
+    // The room a dequeue makes goes to the oldest spilled frame, the queue staying ahead of the spill and holding a frame for
+    // as long as the spill does
+    void refill()
+    {
+        if (!spill) return;
+        std::lock_guard<std::mutex> lock(spill_mutex);
+        while (!spill->empty())
+        {
+            auto frame = spill->pop();
+            if (!frame) { dropped++; continue; }
+            // The room is there, whatever the priority of the frame
+            if (!queue.blocking_enqueue(std::move(frame), std::chrono::milliseconds(0))) dropped++;
+            break;
+        }
+    }
 };
 
 struct rs2_processing_block : public rs2_options
@@ -245,11 +357,16 @@ rs2_device_list* rs2_query_devices_ex(const rs2_context* context, int product_ma
     VALIDATE_NOT_NULL(context);
 
     std::vector<rs2_device_info> results;
-    for (auto&& dev_info : context->ctx->query_devices(product_mask))
+    auto infos = context->ctx->query_devices(product_mask);
+    std::vector<std::shared_ptr<librealsense::device_interface>> devices(infos.size());
+    if (product_mask & RS2_PRODUCT_LINE_CREATE_DEVICES)
+        devices = context->ctx->create_devices_concurrently(infos);
+
+    for (size_t i = 0; i < infos.size(); i++)
     {
         try
         {
-            rs2_device_info d{ context->ctx, dev_info };
+            rs2_device_info d{ context->ctx, infos[i], devices[i] };
             results.push_back(d);
         }
         catch (...)
@@ -319,9 +436,13 @@ rs2_device* rs2_create_device(const rs2_device_list* info_list, int index, rs2_e
     VALIDATE_NOT_NULL(info_list);
     VALIDATE_RANGE(index, 0, (int)info_list->list.size() - 1);
 
+    auto dev = std::atomic_exchange(&info_list->list[index].device, std::shared_ptr<device_interface>());
+    if (!dev)
+        dev = info_list->list[index].info->create_device();
+
     return new rs2_device{ info_list->ctx,
                           info_list->list[index].info,
-                          info_list->list[index].info->create_device()
+                          dev
     };
 }
 HANDLE_EXCEPTIONS_AND_RETURN(nullptr, info_list, index)
@@ -486,6 +607,45 @@ const rs2_raw_data_buffer* rs2_send_and_receive_raw_data(rs2_device* device, voi
 }
 HANDLE_EXCEPTIONS_AND_RETURN(nullptr, device)
 
+int rs2_send_and_receive_raw_data_batch(rs2_device* device, const void** raw_data_to_send, const unsigned* sizes_of_raw_data_to_send, int count,
+    const rs2_raw_data_buffer** responses, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    VALIDATE_RANGE(count, 0, std::numeric_limits<int>::max());
+    if (count == 0) return 0;
+    VALIDATE_NOT_NULL(raw_data_to_send);
+    VALIDATE_NOT_NULL(sizes_of_raw_data_to_send);
+    VALIDATE_NOT_NULL(responses);
+
+    auto debug_interface = VALIDATE_INTERFACE(device->device, librealsense::debug_interface);
+
+    std::vector<std::vector<uint8_t>> buffers_to_send;
+    for (int i = 0; i < count; i++)
+    {
+        VALIDATE_NOT_NULL(raw_data_to_send[i]);
+        auto raw_data_buffer = static_cast<const uint8_t*>(raw_data_to_send[i]);
+        buffers_to_send.emplace_back(raw_data_buffer, raw_data_buffer + sizes_of_raw_data_to_send[i]);
+    }
+
+    auto results = debug_interface->send_receive_raw_data_async(buffers_to_send);
+    int responded = 0;
+    for (int i = 0; i < count; i++)
+    {
+        responses[i] = nullptr;
+        try
+        {
+            responses[i] = new rs2_raw_data_buffer{ results[i].get() };
+            responded++;
+        }
+        catch (const std::exception& ex)
+        {
+            LOG_WARNING("Raw command " << i << " of the batch failed: " << ex.what());
+        }
+    }
+    return responded;
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, device, raw_data_to_send, sizes_of_raw_data_to_send, count, responses)
+
 const unsigned char* rs2_get_raw_data(const rs2_raw_data_buffer* buffer, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(buffer);
@@ -564,6 +724,28 @@ void rs2_set_option(const rs2_options* options, rs2_option option, float value,
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, options, option, value)
 
+int rs2_set_options(const rs2_options* options, const rs2_option* option_ids, const float* values, int count, int* statuses, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(options);
+    VALIDATE_RANGE(count, 0, std::numeric_limits<int>::max());
+    if (count == 0) return 0;
+    VALIDATE_NOT_NULL(option_ids);
+    VALIDATE_NOT_NULL(values);
+    return options->options->set_options(option_ids, values, count, statuses);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, options, option_ids, values, count, statuses)
+
+int rs2_get_options(const rs2_options* options, const rs2_option* option_ids, float* values, int count, int* statuses, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(options);
+    VALIDATE_RANGE(count, 0, std::numeric_limits<int>::max());
+    if (count == 0) return 0;
+    VALIDATE_NOT_NULL(option_ids);
+    VALIDATE_NOT_NULL(values);
+    return options->options->get_options(option_ids, values, count, statuses);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, options, option_ids, values, count, statuses)
+
 
 int rs2_supports_option(const rs2_options* options, rs2_option option, rs2_error** error) BEGIN_API_CALL
 {
@@ -719,6 +901,16 @@ rs2_metadata_type rs2_get_frame_metadata(const rs2_frame* frame, rs2_frame_metad
 }
 HANDLE_EXCEPTIONS_AND_RETURN(0, frame, frame_metadata)
 
+int rs2_get_frame_metadata_all(const rs2_frame* frame, rs2_metadata_type* values, int* supported, int count, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(frame);
+    VALIDATE_NOT_NULL(values);
+    VALIDATE_NOT_NULL(supported);
+    VALIDATE_RANGE(count, 0, static_cast<int>(rs2_frame_metadata_value::RS2_FRAME_METADATA_COUNT));
+    return ((frame_interface*)frame)->get_all_frame_metadata(values, supported, count);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, frame, values, supported, count)
+
 const char* rs2_get_notification_description(rs2_notification* notification, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(notification);
@@ -794,6 +986,40 @@ const void* rs2_get_frame_data(const rs2_frame* frame_ref, rs2_error** error) BE
 }
 HANDLE_EXCEPTIONS_AND_RETURN(nullptr, frame_ref)
 
+const void* rs2_get_frame_device_pointer(const rs2_frame* frame_ref, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(frame_ref);
+    auto device_data = get_device_data((frame_interface*)frame_ref);
+    if (!device_data)
+        throw invalid_value_exception("Frame data is not resident on the GPU");
+    return device_data;
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, frame_ref)
+
+int rs2_get_frame_dmabuf(const rs2_frame* frame_ref, int* offset, int* stride, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(frame_ref);
+    auto vf = VALIDATE_INTERFACE(((frame_interface*)frame_ref), librealsense::video_frame);
+    if (vf->get_dmabuf_fd() < 0)
+        throw invalid_value_exception("Frame data is not backed by an exported DMABUF");
+    if (offset) *offset = vf->get_dmabuf_offset();
+    if (stride) *stride = vf->get_stride();
+    return vf->get_dmabuf_fd();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(-1, frame_ref, offset, stride)
+
+const rs2_motion_sample* rs2_get_motion_samples(const rs2_frame* frame_ref, int* count, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(frame_ref);
+    VALIDATE_NOT_NULL(count);
+    auto mf = VALIDATE_INTERFACE(((frame_interface*)frame_ref), librealsense::motion_frame);
+    if (!mf->is_batched())
+        throw invalid_value_exception("Frame does not hold a batch of motion samples");
+    *count = static_cast<int>(mf->data.size() / sizeof(rs2_motion_sample));
+    return reinterpret_cast<const rs2_motion_sample*>(mf->get_frame_data());
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, frame_ref, count)
+
 int rs2_get_frame_width(const rs2_frame* frame_ref, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(frame_ref);
@@ -833,6 +1059,47 @@ int rs2_get_frame_bits_per_pixel(const rs2_frame* frame_ref, rs2_error** error)
 }
 HANDLE_EXCEPTIONS_AND_RETURN(0, frame_ref)
 
+void rs2_get_frame_info(const rs2_frame* frame_ref, rs2_frame_info* info, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(frame_ref);
+    VALIDATE_NOT_NULL(info);
+    auto f = (frame_interface*)frame_ref;
+    info->data = f->get_frame_data();
+    info->timestamp = f->get_frame_timestamp();
+    info->timestamp_domain = f->get_frame_timestamp_domain();
+    info->frame_number = f->get_frame_number();
+    info->profile = f->get_stream()->get_c_wrapper();
+
+    // A single cast, and no error for frames that are not video frames
+    auto vf = VALIDATE_INTERFACE_NO_THROW(f, librealsense::video_frame);
+    info->is_video = vf ? 1 : 0;
+    info->width = vf ? vf->get_width() : 0;
+    info->height = vf ? vf->get_height() : 0;
+    info->stride_in_bytes = vf ? vf->get_stride() : 0;
+    info->bits_per_pixel = vf ? vf->get_bpp() : 0;
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, frame_ref, info)
+
+void rs2_frame_copy_to(const rs2_frame* frame_ref, void* dest, int dest_stride, rs2_format format, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(frame_ref);
+    VALIDATE_NOT_NULL(dest);
+    VALIDATE_ENUM(format);
+    if (format == RS2_FORMAT_ANY)
+        throw invalid_value_exception("The format to copy a frame as must be explicit");
+    auto vf = VALIDATE_INTERFACE(((frame_interface*)frame_ref), librealsense::video_frame);
+    auto source_format = vf->get_stream()->get_format();
+    auto row = vf->get_width() * get_image_bpp(format) / 8;
+    if (dest_stride == 0) dest_stride = row;
+    VALIDATE_RANGE(dest_stride, row, std::numeric_limits<int>::max());
+
+    if (!copy_image(static_cast<byte*>(dest), dest_stride, format, vf->get_frame_data(), vf->get_stride(), source_format,
+                    vf->get_width(), vf->get_height()))
+        throw invalid_value_exception(to_string() << "Frames of format " << get_string(source_format)
+                                                  << " can not be copied as " << get_string(format));
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, frame_ref, dest, dest_stride, format)
+
 unsigned long long rs2_get_frame_number(const rs2_frame* frame, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(frame);
@@ -883,6 +1150,37 @@ rs2_frame_queue* rs2_create_frame_queue(int capacity, rs2_error** error) BEGIN_A
 }
 HANDLE_EXCEPTIONS_AND_RETURN(nullptr, capacity)
 
+rs2_frame_queue* rs2_create_frame_queue_with_policy(int capacity, rs2_frame_queue_policy policy, unsigned int timeout_ms, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_ENUM(policy);
+    return new rs2_frame_queue(capacity, policy, timeout_ms);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, capacity, policy, timeout_ms)
+
+rs2_frame_queue* rs2_create_frame_queue_with_spill(int capacity, const char* spill_file, unsigned long long max_spill_bytes, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(spill_file);
+    return new rs2_frame_queue(capacity, spill_file, max_spill_bytes);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, capacity, spill_file, max_spill_bytes)
+
+unsigned long long rs2_get_frame_queue_dropped_frames(const rs2_frame_queue* queue, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(queue);
+    return queue->dropped;
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, queue)
+
+int rs2_get_frame_queue_spilled_frames(const rs2_frame_queue* queue, unsigned long long* spilled_bytes, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(queue);
+    auto q = const_cast<rs2_frame_queue*>(queue);
+    std::lock_guard<std::mutex> lock(q->spill_mutex);
+    if (spilled_bytes) *spilled_bytes = q->spill ? q->spill->get_spilled_bytes() : 0;
+    return q->spill ? static_cast<int>(q->spill->size()) : 0;
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, queue, spilled_bytes)
+
 void rs2_delete_frame_queue(rs2_frame_queue* queue) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(queue);
@@ -894,7 +1192,7 @@ rs2_frame* rs2_wait_for_frame(rs2_frame_queue* queue, unsigned int timeout_ms, r
 {
     VALIDATE_NOT_NULL(queue);
     librealsense::frame_holder fh;
-    if (!queue->queue.dequeue(&fh, timeout_ms))
+    if (!queue->dequeue(&fh, timeout_ms))
     {
         throw std::runtime_error("Frame did not arrive in time!");
     }
@@ -910,7 +1208,7 @@ int rs2_poll_for_frame(rs2_frame_queue* queue, rs2_frame** output_frame, rs2_err
     VALIDATE_NOT_NULL(queue);
     VALIDATE_NOT_NULL(output_frame);
     librealsense::frame_holder fh;
-    if (queue->queue.try_dequeue(&fh))
+    if (queue->try_dequeue(&fh))
     {
         frame_interface* result = nullptr;
         std::swap(result, fh.frame);
@@ -927,7 +1225,7 @@ int rs2_try_wait_for_frame(rs2_frame_queue* queue, unsigned int timeout_ms, rs2_
     VALIDATE_NOT_NULL(queue);
     VALIDATE_NOT_NULL(output_frame);
     librealsense::frame_holder fh;
-    if (!queue->queue.dequeue(&fh, timeout_ms))
+    if (!queue->dequeue(&fh, timeout_ms))
     {
         return false;
     }
@@ -946,14 +1244,14 @@ void rs2_enqueue_frame(rs2_frame* frame, void* queue) BEGIN_API_CALL
     auto q = reinterpret_cast<rs2_frame_queue*>(queue);
     librealsense::frame_holder fh;
     fh.frame = (frame_interface*)frame;
-    q->queue.enqueue(std::move(fh));
+    q->enqueue(std::move(fh));
 }
 NOEXCEPT_RETURN(, frame, queue)
 
 void rs2_flush_queue(rs2_frame_queue* queue, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(queue);
-    queue->queue.clear();
+    queue->clear();
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, queue)
 
@@ -1031,6 +1329,17 @@ rs2_context* rs2_create_mock_context(int api_version, const char* filename, cons
 }
 HANDLE_EXCEPTIONS_AND_RETURN(nullptr, api_version, filename, section)
 
+int rs2_get_motion_history(const rs2_sensor* sensor, rs2_stream stream, int index, double begin, double end, double* timestamps, rs2_vector* motion, int capacity, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(sensor);
+    VALIDATE_ENUM(stream);
+    VALIDATE_LE(0, capacity);
+
+    auto history = VALIDATE_INTERFACE(sensor->sensor, librealsense::motion_history_interface);
+    return history->get_motion_history(stream, index, begin, end, timestamps, motion, capacity);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, sensor, stream, index, begin, end, timestamps, motion, capacity)
+
 void rs2_set_region_of_interest(const rs2_sensor* sensor, int min_x, int min_y, int max_x, int max_y, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(sensor);
@@ -1063,6 +1372,72 @@ void rs2_get_region_of_interest(const rs2_sensor* sensor, int* min_x, int* min_y
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, sensor, min_x, min_y, max_x, max_y)
 
+void rs2_get_frame_memory_stats(const rs2_sensor* sensor, rs2_frame_memory_stats* stats, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(sensor);
+    VALIDATE_NOT_NULL(stats);
+
+    auto s = dynamic_cast<librealsense::sensor_base*>(sensor->sensor);
+    if (!s)
+        throw librealsense::not_implemented_exception("This sensor does not report frame memory statistics");
+
+    *stats = s->get_frame_memory_stats();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, sensor, stats)
+
+void rs2_set_stream_priority(const rs2_sensor* sensor, rs2_stream stream, int index, int priority, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(sensor);
+    VALIDATE_ENUM(stream);
+
+    auto s = dynamic_cast<librealsense::sensor_base*>(sensor->sensor);
+    if (!s)
+        throw librealsense::not_implemented_exception("This sensor does not support stream priorities");
+
+    s->set_stream_priority(stream, index, priority);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, sensor, stream, index, priority)
+
+int rs2_get_stream_priority(const rs2_sensor* sensor, rs2_stream stream, int index, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(sensor);
+    VALIDATE_ENUM(stream);
+
+    auto s = dynamic_cast<librealsense::sensor_base*>(sensor->sensor);
+    if (!s)
+        throw librealsense::not_implemented_exception("This sensor does not support stream priorities");
+
+    return s->get_stream_priority(stream, index);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, sensor, stream, index)
+
+rs2_stream_profile* rs2_sensor_add_cropped_profile(rs2_sensor* sensor, const rs2_stream_profile* base, int x, int y, int width, int height, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(sensor);
+    VALIDATE_NOT_NULL(base);
+
+    auto uvc = dynamic_cast<librealsense::uvc_sensor*>(sensor->sensor);
+    if (!uvc)
+        throw librealsense::not_implemented_exception("This sensor does not support cropped profiles");
+
+    auto sp = uvc->add_cropped_profile(base->profile, x, y, width, height);
+    return new rs2_stream_profile{ sp.get(), sp };
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, sensor, base, x, y, width, height)
+
+void rs2_get_sensor_health(const rs2_sensor* sensor, rs2_sensor_health* health, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(sensor);
+    VALIDATE_NOT_NULL(health);
+
+    auto s = dynamic_cast<librealsense::sensor_base*>(sensor->sensor);
+    if (!s)
+        throw librealsense::not_implemented_exception("This sensor does not report its health");
+
+    *health = s->get_health();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, sensor, health)
+
 void rs2_free_error(rs2_error* error) { if (error) delete error; }
 const char* rs2_get_failed_function(const rs2_error* error) { return error ? error->function : nullptr; }
 const char* rs2_get_failed_args(const rs2_error* error) { return error ? error->args.c_str() : nullptr; }
@@ -1075,11 +1450,19 @@ const char* rs2_distortion_to_string(rs2_distortion distortion)
 const char* rs2_option_to_string(rs2_option option)                                       { return librealsense::get_string(option);       }
 const char* rs2_camera_info_to_string(rs2_camera_info info)                               { return librealsense::get_string(info);         }
 const char* rs2_timestamp_domain_to_string(rs2_timestamp_domain info)                     { return librealsense::get_string(info);         }
+const char* rs2_depth_sample_mode_to_string(rs2_depth_sample_mode mode)                   { return librealsense::get_string(mode);         }
 const char* rs2_notification_category_to_string(rs2_notification_category category)       { return librealsense::get_string(category);     }
 const char* rs2_sr300_visual_preset_to_string(rs2_sr300_visual_preset preset)             { return librealsense::get_string(preset);       }
 const char* rs2_log_severity_to_string(rs2_log_severity severity)                         { return librealsense::get_string(severity);     }
 const char* rs2_exception_type_to_string(rs2_exception_type type)                         { return librealsense::get_string(type);         }
 const char* rs2_playback_status_to_string(rs2_playback_status status)                     { return librealsense::get_string(status);       }
+const char* rs2_compute_backend_to_string(rs2_compute_backend backend)                     { return librealsense::get_string(backend);      }
+const char* rs2_thread_role_to_string(rs2_thread_role role)                                { return librealsense::get_string(role);         }
+const char* rs2_thread_priority_to_string(rs2_thread_priority priority)                    { return librealsense::get_string(priority);     }
+const char* rs2_frame_queue_policy_to_string(rs2_frame_queue_policy policy)                { return librealsense::get_string(policy);       }
+const char* rs2_record_queue_policy_to_string(rs2_record_queue_policy policy)              { return librealsense::get_string(policy);       }
+const char* rs2_record_compression_to_string(rs2_record_compression compression)           { return librealsense::get_string(compression);  }
+const char* rs2_load_action_to_string(rs2_load_action action)                              { return librealsense::get_string(action);       }
 const char* rs2_extension_type_to_string(rs2_extension type)                              { return librealsense::get_string(type);         }
 const char* rs2_frame_metadata_to_string(rs2_frame_metadata_value metadata)               { return librealsense::get_string(metadata);     }
 const char* rs2_extension_to_string(rs2_extension type)                                   { return rs2_extension_type_to_string(type);     }
@@ -1112,6 +1495,8 @@ int rs2_is_sensor_extendable_to(const rs2_sensor* sensor, rs2_extension extensio
     case RS2_EXTENSION_DEPTH_SENSOR        : return VALIDATE_INTERFACE_NO_THROW(sensor->sensor, librealsense::depth_sensor)           != nullptr;
     case RS2_EXTENSION_DEPTH_STEREO_SENSOR : return VALIDATE_INTERFACE_NO_THROW(sensor->sensor, librealsense::depth_stereo_sensor)    != nullptr;
     case RS2_EXTENSION_SOFTWARE_SENSOR:  return VALIDATE_INTERFACE_NO_THROW(sensor->sensor, librealsense::software_sensor) != nullptr;
+    case RS2_EXTENSION_MOTION_HISTORY  : return VALIDATE_INTERFACE_NO_THROW(sensor->sensor, librealsense::motion_history_interface) != nullptr;
+    case RS2_EXTENSION_POSE_PREDICTION : return VALIDATE_INTERFACE_NO_THROW(sensor->sensor, librealsense::pose_prediction_interface) != nullptr;
     default:
         return false;
     }
@@ -1155,6 +1540,17 @@ int rs2_is_frame_extendable_to(const rs2_frame* f, rs2_extension extension_type,
     case RS2_EXTENSION_DISPARITY_FRAME : return VALIDATE_INTERFACE_NO_THROW((frame_interface*)f, librealsense::disparity_frame) != nullptr;
     case RS2_EXTENSION_MOTION_FRAME    : return VALIDATE_INTERFACE_NO_THROW((frame_interface*)f, librealsense::motion_frame)    != nullptr;
     case RS2_EXTENSION_POSE_FRAME      : return VALIDATE_INTERFACE_NO_THROW((frame_interface*)f, librealsense::pose_frame)      != nullptr;
+    case RS2_EXTENSION_GPU_FRAME       : return get_device_data((frame_interface*)f) != nullptr;
+    case RS2_EXTENSION_DMABUF_FRAME    :
+    {
+        auto vf = VALIDATE_INTERFACE_NO_THROW((frame_interface*)f, librealsense::video_frame);
+        return vf && vf->get_dmabuf_fd() >= 0;
+    }
+    case RS2_EXTENSION_MOTION_BATCH_FRAME:
+    {
+        auto mf = VALIDATE_INTERFACE_NO_THROW((frame_interface*)f, librealsense::motion_frame);
+        return mf && mf->is_batched();
+    }
 
     default:
         return false;
@@ -1186,6 +1582,22 @@ rs2_device* rs2_context_add_device(rs2_context* ctx, const char* file, rs2_error
 }
 HANDLE_EXCEPTIONS_AND_RETURN(nullptr, ctx, file)
 
+rs2_device* rs2_context_add_merged_device(rs2_context* ctx, const char** files, int count, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(ctx);
+    VALIDATE_NOT_NULL(files);
+    VALIDATE_RANGE(count, 1, std::numeric_limits<int>::max());
+
+    std::vector<std::string> names;
+    for (int i = 0; i < count; i++)
+    {
+        VALIDATE_NOT_NULL(files[i]);
+        names.push_back(files[i]);
+    }
+    return new rs2_device{ ctx->ctx, nullptr, ctx->ctx->add_merged_device(names) };
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, ctx, files, count)
+
 void rs2_context_remove_device(rs2_context* ctx, const char* file, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(ctx);
@@ -1194,6 +1606,143 @@ void rs2_context_remove_device(rs2_context* ctx, const char* file, rs2_error** e
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, ctx, file)
 
+rs2_device* rs2_context_add_network_device(rs2_context* ctx, const char* address, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(ctx);
+    VALIDATE_NOT_NULL(address);
+
+    return new rs2_device{ ctx->ctx, nullptr, ctx->ctx->add_network_device(address) };
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, ctx, address)
+
+rs2_net_server* rs2_create_net_server(const rs2_device* device, int port, int allow_remote, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    VALIDATE_RANGE(port, 0, 65535);
+
+    return new rs2_net_server{ std::make_shared<librealsense::net_server>(device->device, static_cast<uint16_t>(port), allow_remote != 0) };
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, device, port, allow_remote)
+
+void rs2_delete_net_server(rs2_net_server* server) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(server);
+    delete server;
+}
+NOEXCEPT_RETURN(, server)
+
+rs2_device* rs2_context_add_shm_device(rs2_context* ctx, const char* name, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(ctx);
+    VALIDATE_NOT_NULL(name);
+
+    return new rs2_device{ ctx->ctx, nullptr, ctx->ctx->add_shm_device(name) };
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, ctx, name)
+
+rs2_shm_publisher* rs2_create_shm_publisher(const rs2_device* device, const char* name, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    VALIDATE_NOT_NULL(name);
+
+    return new rs2_shm_publisher{ std::make_shared<librealsense::shm_publisher>(device->device, name) };
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, device, name)
+
+void rs2_delete_shm_publisher(rs2_shm_publisher* publisher) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(publisher);
+    delete publisher;
+}
+NOEXCEPT_RETURN(, publisher)
+
+int rs2_is_compute_backend_available(rs2_compute_backend backend, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_ENUM(backend);
+    return librealsense::is_compute_backend_available(backend) ? 1 : 0;
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, backend)
+
+void rs2_context_set_compute_backend(rs2_context* context, rs2_compute_backend backend, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(context);
+    VALIDATE_ENUM(backend);
+    auto& env = librealsense::environment::get_instance();
+    auto current = env.get_compute_backend();
+    if ((current ? current->get_type() : RS2_COMPUTE_BACKEND_CPU) != backend)
+        env.set_compute_backend(librealsense::make_compute_backend(backend));
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, context, backend)
+
+void rs2_context_set_worker_threads(rs2_context* context, int threads, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(context);
+    VALIDATE_RANGE(threads, -1, 1024);
+    context->ctx->set_executor(threads ? std::make_shared<executor>(threads < 0 ? 0 : threads) : nullptr);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, context, threads)
+
+void rs2_context_set_streaming_preallocation(rs2_context* context, int enabled, int fatal, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(context);
+    VALIDATE_RANGE(enabled, 0, 1);
+    VALIDATE_RANGE(fatal, 0, 1);
+    context->ctx->set_preallocation(!enabled ? preallocation_mode::off : fatal ? preallocation_mode::fatal : preallocation_mode::counted);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, context, enabled, fatal)
+
+void rs2_context_set_parallel_threads(rs2_context* context, int threads, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(context);
+    VALIDATE_RANGE(threads, -1, 1024);
+    environment::get_instance().set_parallel_runtime(make_parallel_threads(threads));
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, context, threads)
+
+void rs2_context_set_parallel_executor(rs2_context* context, rs2_parallel_executor_ptr executor, void* user, int concurrency, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(context);
+    VALIDATE_RANGE(concurrency, 1, 1024);
+    environment::get_instance().set_parallel_runtime(make_parallel_executor(executor, user, concurrency));
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, context, executor, user, concurrency)
+
+void rs2_context_set_thread_policy(rs2_context* context, rs2_thread_role role, const int* cpus, int cpu_count,
+    rs2_thread_priority priority, const char* name, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(context);
+    VALIDATE_ENUM(role);
+    VALIDATE_ENUM(priority);
+    VALIDATE_RANGE(cpu_count, 0, 4096);
+    if (cpu_count) VALIDATE_NOT_NULL(cpus);
+
+    librealsense::thread_policy policy;
+    for (int i = 0; i < cpu_count; i++)
+    {
+        VALIDATE_RANGE(cpus[i], 0, 4095);
+        policy.cpus.push_back(cpus[i]);
+    }
+    policy.priority = priority;
+    if (name) policy.name = name;
+    librealsense::set_thread_policy(role, std::move(policy));
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, context, role, cpu_count, priority)
+
+void rs2_context_start_trace(rs2_context* context, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(context);
+    librealsense::tracer::instance().start();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, context)
+
+void rs2_context_stop_trace(rs2_context* context, const char* file, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(context);
+    VALIDATE_NOT_NULL(file);
+    librealsense::tracer::instance().stop(file);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, context, file)
+
 const char* rs2_playback_device_get_file_path(const rs2_device* device, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(device);
@@ -1259,6 +1808,45 @@ int rs2_playback_device_is_real_time(const rs2_device* device, rs2_error** error
 }
 HANDLE_EXCEPTIONS_AND_RETURN(0, device)
 
+void rs2_playback_device_set_read_ahead(const rs2_device* device, int count, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    VALIDATE_RANGE(count, 0, static_cast<int>(librealsense::prefetching_reader::max_read_ahead));
+    auto playback = VALIDATE_INTERFACE(device->device, librealsense::playback_device);
+    playback->set_read_ahead(count);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, count)
+
+int rs2_playback_device_set_mapped_read(const rs2_device* device, int mapped, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    auto playback = VALIDATE_INTERFACE(device->device, librealsense::playback_device);
+    return playback->set_mapped_read(mapped != 0) ? 1 : 0;
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, device, mapped)
+
+void rs2_playback_device_get_jitter(const rs2_device* device, rs2_stream stream, int index, rs2_playback_jitter* jitter, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    VALIDATE_NOT_NULL(jitter);
+    if (stream != RS2_STREAM_ANY)
+    {
+        VALIDATE_ENUM(stream);
+    }
+    VALIDATE_RANGE(index, -1, std::numeric_limits<int>::max());
+    auto playback = VALIDATE_INTERFACE(device->device, librealsense::playback_device);
+    *jitter = playback->get_jitter(stream, index);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, stream, index, jitter)
+
+void rs2_playback_device_set_parallel_decode(const rs2_device* device, int parallel, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    auto playback = VALIDATE_INTERFACE(device->device, librealsense::playback_device);
+    playback->set_parallel_decode(parallel != 0);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, parallel)
+
 void rs2_playback_device_set_status_changed_callback(const rs2_device* device, rs2_playback_status_changed_callback* callback, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(device);
@@ -1269,6 +1857,15 @@ void rs2_playback_device_set_status_changed_callback(const rs2_device* device, r
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, device, callback)
 
+void rs2_playback_device_register_codec(const rs2_device* device, rs2_frame_codec* codec, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    VALIDATE_NOT_NULL(codec);
+    auto playback = VALIDATE_INTERFACE(device->device, librealsense::playback_device);
+    playback->register_codec({ codec, [](rs2_frame_codec* p) { p->release(); } });
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, codec)
+
 
 rs2_playback_status rs2_playback_device_get_current_status(const rs2_device* device, rs2_error** error) BEGIN_API_CALL
 {
@@ -1302,20 +1899,37 @@ rs2_device* rs2_create_record_device(const rs2_device* device, const char* file,
     return new rs2_device({
         device->ctx,
         device->info,
-        std::make_shared<record_device>(device->device, std::make_shared<ros_writer>(file))
+        std::make_shared<record_device>(device->device, record_device::create_file_writer(file))
     });
 }
 HANDLE_EXCEPTIONS_AND_RETURN(nullptr, device, file)
 
-void rs2_record_device_pause(const rs2_device* device, rs2_error** error) BEGIN_API_CALL
+rs2_device* rs2_create_segmented_record_device(const rs2_device* device, const char* file, unsigned long long max_duration,
+                                               unsigned long long max_bytes, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(device);
-    auto record_device = VALIDATE_INTERFACE(device->device, librealsense::record_device);
-    record_device->pause_recording();
-}
-HANDLE_EXCEPTIONS_AND_RETURN(, device)
+    VALIDATE_NOT_NULL(file);
 
-void rs2_record_device_resume(const rs2_device* device, rs2_error** error) BEGIN_API_CALL
+    auto writer = std::make_shared<segmenting_writer>(file,
+        [](const std::string& segment_file) { return record_device::create_file_writer(segment_file); },
+        std::chrono::milliseconds(max_duration), max_bytes);
+    return new rs2_device({
+        device->ctx,
+        device->info,
+        std::make_shared<record_device>(device->device, writer)
+    });
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, device, file, max_duration, max_bytes)
+
+void rs2_record_device_pause(const rs2_device* device, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    auto record_device = VALIDATE_INTERFACE(device->device, librealsense::record_device);
+    record_device->pause_recording();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device)
+
+void rs2_record_device_resume(const rs2_device* device, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(device);
     auto record_device = VALIDATE_INTERFACE(device->device, librealsense::record_device);
@@ -1331,6 +1945,101 @@ const char* rs2_record_device_filename(const rs2_device* device, rs2_error** err
 }
 HANDLE_EXCEPTIONS_AND_RETURN(nullptr, device)
 
+void rs2_record_device_set_queue_limit(const rs2_device* device, unsigned long long max_frames, unsigned long long max_bytes,
+                                       rs2_record_queue_policy policy, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    VALIDATE_ENUM(policy);
+    auto record_device = VALIDATE_INTERFACE(device->device, librealsense::record_device);
+    record_device->set_queue_limit(max_frames, max_bytes, policy);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, max_frames, max_bytes, policy)
+
+void rs2_record_device_set_stream_priority(const rs2_device* device, rs2_stream stream, int priority, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    VALIDATE_ENUM(stream);
+    auto record_device = VALIDATE_INTERFACE(device->device, librealsense::record_device);
+    record_device->set_stream_priority(stream, priority);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, stream, priority)
+
+void rs2_record_device_get_queue_stats(const rs2_device* device, rs2_record_queue_stats* stats, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    VALIDATE_NOT_NULL(stats);
+    auto record_device = VALIDATE_INTERFACE(device->device, librealsense::record_device);
+    *stats = record_device->get_queue_stats();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, stats)
+
+void rs2_record_device_set_stream_compression(const rs2_device* device, rs2_stream stream, rs2_record_compression compression, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    VALIDATE_ENUM(stream);
+    VALIDATE_ENUM(compression);
+    auto record_device = VALIDATE_INTERFACE(device->device, librealsense::record_device);
+    record_device->set_stream_compression(stream, compression);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, stream, compression)
+
+void rs2_record_device_set_segment_closed_callback(const rs2_device* device, rs2_segment_closed_callback* callback, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    VALIDATE_NOT_NULL(callback);
+    auto record_device = VALIDATE_INTERFACE(device->device, librealsense::record_device);
+    librealsense::segment_closed_callback_ptr cb(callback, [](rs2_segment_closed_callback* p) { if (p) p->release(); });
+    record_device->set_segment_closed_callback(cb);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, callback)
+
+void rs2_record_device_set_disk_budget(const rs2_device* device, unsigned long long max_bytes, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    auto record_device = VALIDATE_INTERFACE(device->device, librealsense::record_device);
+    record_device->set_disk_budget(max_bytes);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, max_bytes)
+
+void rs2_record_device_set_stream_codec(const rs2_device* device, rs2_stream stream, rs2_frame_codec* codec, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    VALIDATE_ENUM(stream);
+    auto record_device = VALIDATE_INTERFACE(device->device, librealsense::record_device);
+    librealsense::frame_codec_ptr codec_ptr;
+    if (codec)
+        codec_ptr.reset(codec, [](rs2_frame_codec* p) { p->release(); });
+    record_device->set_stream_codec(stream, codec_ptr);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, stream, codec)
+
+void rs2_record_device_set_pre_roll(const rs2_device* device, long long int pre_roll, long long int post_roll, unsigned long long max_bytes, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    VALIDATE_RANGE(pre_roll, 0, std::numeric_limits<long long int>::max());
+    VALIDATE_RANGE(post_roll, 0, std::numeric_limits<long long int>::max());
+    auto record_device = VALIDATE_INTERFACE(device->device, librealsense::record_device);
+    record_device->set_pre_roll(std::chrono::nanoseconds(pre_roll), std::chrono::nanoseconds(post_roll), max_bytes);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, pre_roll, post_roll, max_bytes)
+
+void rs2_record_device_trigger(const rs2_device* device, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    auto record_device = VALIDATE_INTERFACE(device->device, librealsense::record_device);
+    record_device->trigger();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device)
+
+void rs2_record_device_set_stream_processing(const rs2_device* device, rs2_stream stream, rs2_processing_block* block, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    VALIDATE_ENUM(stream);
+    auto record_device = VALIDATE_INTERFACE(device->device, librealsense::record_device);
+    record_device->set_stream_processing(stream, block ? block->block : nullptr);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, stream, block)
+
 
 rs2_frame* rs2_allocate_synthetic_video_frame(rs2_source* source, const rs2_stream_profile* new_stream, rs2_frame* original,
     int new_bpp, int new_width, int new_height, int new_stride, rs2_extension frame_type, rs2_error** error) BEGIN_API_CALL
@@ -1359,6 +2068,34 @@ rs2_frame* rs2_allocate_points(rs2_source* source, const rs2_stream_profile* new
 }
 HANDLE_EXCEPTIONS_AND_RETURN(nullptr, source, new_stream, original)
 
+rs2_frame* rs2_allocate_compact_points(rs2_source* source, const rs2_stream_profile* new_stream, rs2_frame* original, int count, int pixel_indices, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(source);
+    VALIDATE_NOT_NULL(original);
+    VALIDATE_NOT_NULL(new_stream);
+    VALIDATE_RANGE(count, 0, std::numeric_limits<int>::max());
+
+    auto recovered_profile = std::dynamic_pointer_cast<stream_profile_interface>(new_stream->profile->shared_from_this());
+
+    return (rs2_frame*)source->source->allocate_points(recovered_profile,
+        (frame_interface*)original, static_cast<size_t>(count), pixel_indices != 0, false, false, true);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, source, new_stream, original, count, pixel_indices)
+
+rs2_frame* rs2_allocate_points_with_normals(rs2_source* source, const rs2_stream_profile* new_stream, rs2_frame* original, int count, int pixel_indices, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(source);
+    VALIDATE_NOT_NULL(original);
+    VALIDATE_NOT_NULL(new_stream);
+    VALIDATE_RANGE(count, 0, std::numeric_limits<int>::max());
+
+    auto recovered_profile = std::dynamic_pointer_cast<stream_profile_interface>(new_stream->profile->shared_from_this());
+
+    return (rs2_frame*)source->source->allocate_points(recovered_profile,
+        (frame_interface*)original, static_cast<size_t>(count), pixel_indices != 0, true, false, true);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, source, new_stream, original, count, pixel_indices)
+
 void rs2_synthetic_frame_ready(rs2_source* source, rs2_frame* frame, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(frame);
@@ -1433,6 +2170,31 @@ int rs2_pipeline_try_wait_for_frames(rs2_pipeline* pipe, rs2_frame** output_fram
 }
 HANDLE_EXCEPTIONS_AND_RETURN(0, pipe, output_frame)
 
+int rs2_wait_for_any(rs2_frame_queue** queues, int queue_count, rs2_pipeline** pipes, int pipe_count, unsigned int timeout_ms, rs2_error ** error) BEGIN_API_CALL
+{
+    VALIDATE_RANGE(queue_count, 0, std::numeric_limits<int>::max());
+    VALIDATE_RANGE(pipe_count, 0, std::numeric_limits<int>::max());
+    if (queue_count) VALIDATE_NOT_NULL(queues);
+    if (pipe_count) VALIDATE_NOT_NULL(pipes);
+
+    std::vector<single_consumer_frame_queue<librealsense::frame_holder>*> waited;
+    for (int i = 0; i < queue_count; i++)
+    {
+        VALIDATE_NOT_NULL(queues[i]);
+        waited.push_back(&queues[i]->queue);
+    }
+    // Held for the wait, in case a pipeline is stopped meanwhile
+    std::vector<std::shared_ptr<single_consumer_frame_queue<librealsense::frame_holder>>> frames_queues;
+    for (int i = 0; i < pipe_count; i++)
+    {
+        VALIDATE_NOT_NULL(pipes[i]);
+        frames_queues.push_back(pipes[i]->pipe->get_frames_queue());
+        waited.push_back(frames_queues.back().get());
+    }
+    return wait_for_any(waited, timeout_ms);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(-1, queues, queue_count, pipes, pipe_count, timeout_ms)
+
 void rs2_delete_pipeline(rs2_pipeline* pipe) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(pipe);
@@ -1464,6 +2226,15 @@ rs2_pipeline_profile* rs2_pipeline_get_active_profile(rs2_pipeline* pipe, rs2_er
 }
 HANDLE_EXCEPTIONS_AND_RETURN(nullptr, pipe)
 
+void rs2_pipeline_get_health(rs2_pipeline* pipe, rs2_pipeline_health* health, rs2_error ** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(pipe);
+    VALIDATE_NOT_NULL(health);
+
+    *health = pipe->pipe->get_health();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, pipe, health)
+
 rs2_device* rs2_pipeline_profile_get_device(rs2_pipeline_profile* profile, rs2_error ** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(profile);
@@ -1535,6 +2306,15 @@ void rs2_config_enable_device(rs2_config* config, const char* serial, rs2_error
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, config, serial)
 
+void rs2_config_add_device(rs2_config* config, const char* serial, rs2_error ** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(config);
+    VALIDATE_NOT_NULL(serial);
+
+    config->config->add_device(serial);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, config, serial)
+
 void rs2_config_enable_device_from_file_repeat_option(rs2_config* config, const char* file, int repeat_playback, rs2_error ** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(config);
@@ -1562,6 +2342,55 @@ void rs2_config_enable_record_to_file(rs2_config* config, const char* file, rs2_
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, config, file)
 
+void rs2_config_enable_record_compression(rs2_config* config, rs2_stream stream, rs2_record_compression compression, rs2_error ** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(config);
+    VALIDATE_ENUM(stream);
+    VALIDATE_ENUM(compression);
+
+    config->config->enable_record_compression(stream, compression);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, config, stream, compression)
+
+void rs2_config_enable_usb_bandwidth_check(rs2_config* config, int enable, rs2_error ** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(config);
+
+    config->config->enable_usb_bandwidth_check(enable != 0);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, config, enable)
+
+void rs2_config_add_processing_block(rs2_config* config, rs2_processing_block* block, rs2_error ** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(config);
+    VALIDATE_NOT_NULL(block);
+
+    config->config->add_processing_block(block->block);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, config, block)
+
+void rs2_config_enable_load_governor(rs2_config* config, float max_latency_ms, const rs2_load_action* actions, int count, rs2_error ** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(config);
+    VALIDATE_RANGE(count, 0, 1024);
+    if (count)
+    {
+        VALIDATE_NOT_NULL(actions);
+    }
+
+    config->config->enable_load_governor(max_latency_ms, std::vector<rs2_load_action>(actions, actions + count));
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, config, max_latency_ms, actions, count)
+
+void rs2_config_set_low_priority_stream(rs2_config* config, rs2_stream stream, int index, rs2_error ** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(config);
+    VALIDATE_ENUM(stream);
+
+    config->config->set_low_priority_stream(stream, index);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, config, stream, index)
+
 void rs2_config_disable_stream(rs2_config* config, rs2_stream stream, rs2_error ** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(config);
@@ -1630,6 +2459,14 @@ rs2_processing_block* rs2_create_sync_processing_block(rs2_error** error) BEGIN_
 }
 NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
 
+rs2_processing_block* rs2_create_multi_device_sync_processing_block(rs2_error** error) BEGIN_API_CALL
+{
+    auto block = std::make_shared<librealsense::multi_device_syncer>();
+
+    return new rs2_processing_block{ block };
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
+
 void rs2_start_processing(rs2_processing_block* block, rs2_frame_callback* on_frame, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(block);
@@ -1674,6 +2511,53 @@ void rs2_delete_processing_block(rs2_processing_block* block) BEGIN_API_CALL
 }
 NOEXCEPT_RETURN(, block)
 
+void rs2_get_processing_block_stats(const rs2_processing_block* block, rs2_processing_block_stats* stats, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(block);
+    VALIDATE_NOT_NULL(stats);
+
+    auto pb = std::dynamic_pointer_cast<librealsense::processing_block>(block->block);
+    if (!pb)
+        throw librealsense::not_implemented_exception("This processing block does not record statistics");
+    *stats = pb->get_stats();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, block, stats)
+
+void rs2_set_processing_block_roi(rs2_processing_block* block, int min_x, int min_y, int max_x, int max_y, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(block);
+
+    VALIDATE_LE(min_x, max_x);
+    VALIDATE_LE(min_y, max_y);
+    VALIDATE_LE(0, min_x);
+    VALIDATE_LE(0, min_y);
+
+    auto roi = std::dynamic_pointer_cast<librealsense::processing_roi>(block->block);
+    if (!roi)
+        throw librealsense::not_implemented_exception("This processing block does not support a region of interest");
+    roi->set_roi({ min_x, min_y, max_x, max_y });
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, block, min_x, min_y, max_x, max_y)
+
+void rs2_get_processing_block_roi(const rs2_processing_block* block, int* min_x, int* min_y, int* max_x, int* max_y, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(block);
+    VALIDATE_NOT_NULL(min_x);
+    VALIDATE_NOT_NULL(min_y);
+    VALIDATE_NOT_NULL(max_x);
+    VALIDATE_NOT_NULL(max_y);
+
+    auto roi = std::dynamic_pointer_cast<librealsense::processing_roi>(block->block);
+    if (!roi)
+        throw librealsense::not_implemented_exception("This processing block does not support a region of interest");
+    auto rect = roi->get_roi();
+    *min_x = rect.min_x;
+    *min_y = rect.min_y;
+    *max_x = rect.max_x;
+    *max_y = rect.max_y;
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, block, min_x, min_y, max_x, max_y)
+
 rs2_frame* rs2_extract_frame(rs2_frame* composite, int index, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(composite);
@@ -1722,6 +2606,15 @@ rs2_vertex* rs2_get_frame_vertices(const rs2_frame* frame, rs2_error** error) BE
 }
 HANDLE_EXCEPTIONS_AND_RETURN(nullptr, frame)
 
+const float* rs2_get_frame_vertex_plane(const rs2_frame* frame, int axis, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(frame);
+    VALIDATE_RANGE(axis, 0, 2);
+    auto points = VALIDATE_INTERFACE((frame_interface*)frame, librealsense::points);
+    return points->get_vertex_plane(axis);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, frame, axis)
+
 void rs2_export_to_ply(const rs2_frame* frame, const char* fname, rs2_frame* texture, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(frame);
@@ -1731,6 +2624,15 @@ void rs2_export_to_ply(const rs2_frame* frame, const char* fname, rs2_frame* tex
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, frame, fname)
 
+void rs2_export_mesh_to_ply(const rs2_frame* frame, const char* fname, rs2_frame* texture, int normals, int faces, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(frame);
+    VALIDATE_NOT_NULL(fname);
+    auto points = VALIDATE_INTERFACE((frame_interface*)frame, librealsense::points);
+    points->export_to_ply(fname, (frame_interface*)texture, normals != 0, faces != 0);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, frame, fname, normals, faces)
+
 rs2_pixel* rs2_get_frame_texture_coordinates(const rs2_frame* frame, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(frame);
@@ -1747,6 +2649,30 @@ int rs2_get_frame_points_count(const rs2_frame* frame, rs2_error** error) BEGIN_
 }
 HANDLE_EXCEPTIONS_AND_RETURN(0, frame)
 
+const int* rs2_get_frame_pixel_indices(const rs2_frame* frame, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(frame);
+    auto points = VALIDATE_INTERFACE((frame_interface*)frame, librealsense::points);
+    return points->get_pixel_indices();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, frame)
+
+const rs2_vertex* rs2_get_frame_normals(const rs2_frame* frame, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(frame);
+    auto points = VALIDATE_INTERFACE((frame_interface*)frame, librealsense::points);
+    return (const rs2_vertex*)points->get_normals();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, frame)
+
+const unsigned char* rs2_get_frame_colors(const rs2_frame* frame, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(frame);
+    auto points = VALIDATE_INTERFACE((frame_interface*)frame, librealsense::points);
+    return points->get_colors();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, frame)
+
 rs2_processing_block* rs2_create_pointcloud(rs2_error** error) BEGIN_API_CALL
 {
     auto block = std::make_shared<librealsense::pointcloud>();
@@ -1785,6 +2711,14 @@ rs2_processing_block* rs2_create_decimation_filter_block(rs2_error** error) BEGI
 }
 NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
 
+rs2_processing_block* rs2_create_depth_statistics_block(rs2_error** error) BEGIN_API_CALL
+{
+    auto block = std::make_shared<librealsense::depth_statistics_filter>();
+
+    return new rs2_processing_block{ block };
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
+
 rs2_processing_block* rs2_create_temporal_filter_block(rs2_error** error) BEGIN_API_CALL
 {
     auto block = std::make_shared<librealsense::temporal_filter>();
@@ -1817,6 +2751,218 @@ rs2_processing_block* rs2_create_hole_filling_filter_block(rs2_error** error) BE
 }
 NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
 
+rs2_processing_block* rs2_create_depth_compressor_block(rs2_error** error) BEGIN_API_CALL
+{
+    auto block = std::make_shared<librealsense::depth_compressor>();
+
+    return new rs2_processing_block{ block };
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
+
+rs2_processing_block* rs2_create_depth_decompressor_block(rs2_error** error) BEGIN_API_CALL
+{
+    auto block = std::make_shared<librealsense::depth_decompressor>();
+
+    return new rs2_processing_block{ block };
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
+
+rs2_processing_block* rs2_create_voxel_filter_block(rs2_error** error) BEGIN_API_CALL
+{
+    auto block = std::make_shared<librealsense::voxel_filter>();
+
+    return new rs2_processing_block{ block };
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
+
+rs2_processing_block* rs2_create_normals_filter_block(rs2_error** error) BEGIN_API_CALL
+{
+    auto block = std::make_shared<librealsense::normals_filter>();
+
+    return new rs2_processing_block{ block };
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
+
+rs2_processing_block* rs2_create_colored_pointcloud_block(rs2_error** error) BEGIN_API_CALL
+{
+    auto block = std::make_shared<librealsense::colored_pointcloud>();
+
+    return new rs2_processing_block{ block };
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
+
+rs2_processing_block* rs2_create_pointcloud_merger_block(rs2_error** error) BEGIN_API_CALL
+{
+    auto block = std::make_shared<librealsense::pointcloud_merger>();
+
+    return new rs2_processing_block{ block };
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
+
+rs2_processing_block* rs2_create_tsdf_fusion_block(rs2_error** error) BEGIN_API_CALL
+{
+    auto block = std::make_shared<librealsense::tsdf_fusion>();
+
+    return new rs2_processing_block{ block };
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
+
+// The implementation of the given block, or null for a null block
+template<class T>
+static std::shared_ptr<T> get_block_as(rs2_processing_block* block, const char* name)
+{
+    if (!block)
+        return nullptr;
+
+    auto filter = std::dynamic_pointer_cast<T>(block->block);
+    if (!filter)
+        throw librealsense::invalid_value_exception(librealsense::to_string() << "Processing block is not a " << name << " block");
+    return filter;
+}
+
+rs2_processing_block* rs2_create_depth_post_processing_block(rs2_processing_block* decimation, rs2_processing_block* spatial,
+    rs2_processing_block* temporal, rs2_processing_block* hole_filling, rs2_error** error) BEGIN_API_CALL
+{
+    auto block = std::make_shared<librealsense::depth_post_processing>(
+        get_block_as<librealsense::decimation_filter>(decimation, "decimation filter"),
+        get_block_as<librealsense::spatial_filter>(spatial, "spatial filter"),
+        get_block_as<librealsense::temporal_filter>(temporal, "temporal filter"),
+        get_block_as<librealsense::hole_filling_filter>(hole_filling, "hole filling filter"));
+
+    return new rs2_processing_block{ block };
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, decimation, spatial, temporal, hole_filling)
+
+rs2_processing_block* rs2_create_processing_graph(int threads, int max_in_flight, rs2_error** error) BEGIN_API_CALL
+{
+    auto block = std::make_shared<librealsense::processing_graph>(threads, max_in_flight);
+
+    return new rs2_processing_block{ block };
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, threads, max_in_flight)
+
+int rs2_processing_graph_add(rs2_processing_block* graph, rs2_processing_block* block, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(graph);
+    VALIDATE_NOT_NULL(block);
+
+    return get_block_as<librealsense::processing_graph>(graph, "processing graph")->add(block->block);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, graph, block)
+
+void rs2_processing_graph_connect(rs2_processing_block* graph, int from, int to, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(graph);
+
+    get_block_as<librealsense::processing_graph>(graph, "processing graph")->connect(from, to);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, graph, from, to)
+
+void rs2_processing_graph_flush(rs2_processing_block* graph, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(graph);
+
+    get_block_as<librealsense::processing_graph>(graph, "processing graph")->flush();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, graph)
+
+unsigned long long rs2_get_sync_incomplete_framesets(rs2_processing_block* syncer, int stream_unique_id, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(syncer);
+
+    return get_block_as<librealsense::syncer_process_unit>(syncer, "sync")->get_incomplete_framesets(stream_unique_id);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, syncer, stream_unique_id)
+
+void rs2_pointcloud_merger_set_world_extrinsics(rs2_processing_block* merger, const rs2_stream_profile* profile, const rs2_extrinsics* to_world, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(merger);
+    VALIDATE_NOT_NULL(profile);
+    VALIDATE_NOT_NULL(to_world);
+
+    get_block_as<librealsense::pointcloud_merger>(merger, "pointcloud merger")->set_world_extrinsics(*profile->profile, *to_world);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, merger, profile, to_world)
+
+void rs2_tsdf_fusion_set_camera_pose(rs2_processing_block* fusion, const rs2_extrinsics* camera_to_world, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(fusion);
+    VALIDATE_NOT_NULL(camera_to_world);
+
+    get_block_as<librealsense::tsdf_fusion>(fusion, "TSDF fusion")->set_camera_pose(*camera_to_world);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, fusion, camera_to_world)
+
+void rs2_tsdf_fusion_reset(rs2_processing_block* fusion, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(fusion);
+
+    get_block_as<librealsense::tsdf_fusion>(fusion, "TSDF fusion")->reset();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, fusion)
+
+rs2_frame* rs2_tsdf_fusion_raycast(rs2_processing_block* fusion, const rs2_intrinsics* intrinsics, const rs2_extrinsics* camera_to_world, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(fusion);
+    VALIDATE_NOT_NULL(intrinsics);
+    VALIDATE_NOT_NULL(camera_to_world);
+    VALIDATE_RANGE(intrinsics->width, 1, 16384);
+    VALIDATE_RANGE(intrinsics->height, 1, 16384);
+
+    return (rs2_frame*)get_block_as<librealsense::tsdf_fusion>(fusion, "TSDF fusion")->raycast(*intrinsics, *camera_to_world);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, fusion, intrinsics, camera_to_world)
+
+rs2_frame* rs2_tsdf_fusion_extract_points(rs2_processing_block* fusion, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(fusion);
+
+    return (rs2_frame*)get_block_as<librealsense::tsdf_fusion>(fusion, "TSDF fusion")->extract_points();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, fusion)
+
+void rs2_get_sync_stream_stats(rs2_processing_block* syncer, int stream_unique_id, rs2_sync_stream_stats* stats, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(syncer);
+    VALIDATE_NOT_NULL(stats);
+
+    *stats = get_block_as<librealsense::syncer_process_unit>(syncer, "sync")->get_stream_stats(stream_unique_id);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, syncer, stream_unique_id, stats)
+
+void rs2_get_sync_latency_histogram(rs2_processing_block* syncer, unsigned long long* buckets, int count, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(syncer);
+    VALIDATE_NOT_NULL(buckets);
+    VALIDATE_RANGE(count, 0, RS2_SYNC_LATENCY_BUCKETS);
+
+    auto histogram = get_block_as<librealsense::syncer_process_unit>(syncer, "sync")->get_latency_histogram();
+    std::copy(histogram.begin(), histogram.begin() + count, buckets);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, syncer, buckets, count)
+
+void rs2_processing_graph_process_batch(rs2_processing_block* graph, rs2_frame** frames, rs2_frame** results, int count, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(graph);
+    VALIDATE_NOT_NULL(frames);
+    VALIDATE_NOT_NULL(results);
+    VALIDATE_LE(0, count);
+
+    std::vector<frame_holder> batch;
+    for (int i = 0; i < count; i++)
+        batch.push_back(frame_holder((frame_interface*)frames[i]));
+    for (int i = 0; i < count; i++)
+        VALIDATE_NOT_NULL(frames[i]);
+
+    auto out = get_block_as<librealsense::processing_graph>(graph, "processing graph")->process_batch(std::move(batch));
+    for (int i = 0; i < count; i++)
+    {
+        results[i] = (rs2_frame*)out[i].frame;
+        out[i].frame = nullptr;
+    }
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, graph, frames, results, count)
+
 float rs2_get_depth_scale(rs2_sensor* sensor, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(sensor);
@@ -1848,6 +2994,32 @@ float rs2_depth_frame_get_distance(const rs2_frame* frame_ref, int x, int y, rs2
 }
 HANDLE_EXCEPTIONS_AND_RETURN(0, frame_ref, x, y)
 
+void rs2_depth_frame_sample(const rs2_frame* frame_ref, const float* pixels, int count, float* output, rs2_depth_sample_mode mode, int window, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(frame_ref);
+    VALIDATE_NOT_NULL(pixels);
+    VALIDATE_NOT_NULL(output);
+    VALIDATE_RANGE(count, 0, std::numeric_limits<int>::max());
+    VALIDATE_ENUM(mode);
+    VALIDATE_RANGE(window, 1, 15);
+    if (window % 2 == 0)
+        throw invalid_value_exception(to_string() << "The window of the median is of an odd size, not " << window);
+    auto df = VALIDATE_INTERFACE(((frame_interface*)frame_ref), librealsense::depth_frame);
+    df->sample(reinterpret_cast<const float2*>(pixels), count, output, mode, window);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, frame_ref, pixels, count, output, mode, window)
+
+const unsigned long long* rs2_depth_frame_get_validity_mask(const rs2_frame* frame_ref, int* words, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(frame_ref);
+    auto df = VALIDATE_INTERFACE(((frame_interface*)frame_ref), librealsense::depth_frame);
+    auto& mask = df->get_validity_mask();
+    if (words) *words = static_cast<int>(mask.size());
+    static_assert(sizeof(unsigned long long) == sizeof(uint64_t), "The words of the mask are of 64 bits");
+    return reinterpret_cast<const unsigned long long*>(mask.data());
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, frame_ref, words)
+
 float rs2_depth_stereo_frame_get_baseline(const rs2_frame* frame_ref, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(frame_ref);
@@ -1886,12 +3058,91 @@ void rs2_pose_frame_get_pose_data(const rs2_frame* frame, rs2_pose* pose, rs2_er
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, frame, pose)
 
+int rs2_get_latest_pose(const rs2_sensor* sensor, int index, rs2_pose* pose, double* timestamp, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(sensor);
+    VALIDATE_NOT_NULL(pose);
+
+    auto poses = VALIDATE_INTERFACE(sensor->sensor, librealsense::pose_prediction_interface);
+    double ts;
+    if (!poses->get_latest_pose(index, ts, *pose))
+        return 0;
+    if (timestamp) *timestamp = ts;
+    return 1;
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, sensor, index, pose, timestamp)
+
+int rs2_predict_pose(const rs2_sensor* sensor, int index, double timestamp, rs2_pose* pose, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(sensor);
+    VALIDATE_NOT_NULL(pose);
+
+    auto poses = VALIDATE_INTERFACE(sensor->sensor, librealsense::pose_prediction_interface);
+    double ts;
+    rs2_pose latest;
+    if (!poses->get_latest_pose(index, ts, latest))
+        return 0;
+    *pose = predict_pose(latest, timestamp - ts);
+    return 1;
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, sensor, index, timestamp, pose)
+
 rs2_time_t rs2_get_time(rs2_error** error) BEGIN_API_CALL
 {
     return environment::get_instance().get_time_service()->get_time();
 }
 NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(0)
 
+void rs2_deproject_pixels(const rs2_intrinsics* intrin, const float* pixels, const float* depth, float* points, int count, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(intrin);
+    VALIDATE_NOT_NULL(pixels);
+    VALIDATE_NOT_NULL(depth);
+    VALIDATE_NOT_NULL(points);
+    VALIDATE_RANGE(count, 0, std::numeric_limits<int>::max());
+    deproject_pixels(*intrin, reinterpret_cast<const float2*>(pixels), depth, reinterpret_cast<float3*>(points), count);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, intrin, pixels, depth, points, count)
+
+void rs2_deproject_pixels_soa(const rs2_intrinsics* intrin, const float* pixel_x, const float* pixel_y, const float* depth,
+    float* point_x, float* point_y, float* point_z, int count, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(intrin);
+    VALIDATE_NOT_NULL(pixel_x);
+    VALIDATE_NOT_NULL(pixel_y);
+    VALIDATE_NOT_NULL(depth);
+    VALIDATE_NOT_NULL(point_x);
+    VALIDATE_NOT_NULL(point_y);
+    VALIDATE_NOT_NULL(point_z);
+    VALIDATE_RANGE(count, 0, std::numeric_limits<int>::max());
+    deproject_pixels(*intrin, pixel_x, pixel_y, depth, point_x, point_y, point_z, count);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, intrin, pixel_x, pixel_y, depth, point_x, point_y, point_z, count)
+
+void rs2_project_points(const rs2_intrinsics* intrin, const float* points, float* pixels, int count, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(intrin);
+    VALIDATE_NOT_NULL(points);
+    VALIDATE_NOT_NULL(pixels);
+    VALIDATE_RANGE(count, 0, std::numeric_limits<int>::max());
+    project_points(*intrin, reinterpret_cast<const float3*>(points), reinterpret_cast<float2*>(pixels), count);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, intrin, points, pixels, count)
+
+void rs2_project_points_soa(const rs2_intrinsics* intrin, const float* point_x, const float* point_y, const float* point_z,
+    float* pixel_x, float* pixel_y, int count, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(intrin);
+    VALIDATE_NOT_NULL(point_x);
+    VALIDATE_NOT_NULL(point_y);
+    VALIDATE_NOT_NULL(point_z);
+    VALIDATE_NOT_NULL(pixel_x);
+    VALIDATE_NOT_NULL(pixel_y);
+    VALIDATE_RANGE(count, 0, std::numeric_limits<int>::max());
+    project_points(*intrin, point_x, point_y, point_z, pixel_x, pixel_y, count);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, intrin, point_x, point_y, point_z, pixel_x, pixel_y, count)
+
 rs2_device* rs2_create_software_device(rs2_error** error) BEGIN_API_CALL
 {
     auto dev = std::make_shared<software_device>();
@@ -1927,6 +3178,16 @@ void rs2_software_sensor_on_video_frame(rs2_sensor* sensor, rs2_software_video_f
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, sensor, frame.pixels)
 
+void rs2_software_sensor_on_video_frames(rs2_sensor* sensor, const rs2_software_video_frame* frames, int count, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(sensor);
+    VALIDATE_NOT_NULL(frames);
+    VALIDATE_LE(0, count);
+    auto bs = VALIDATE_INTERFACE(sensor->sensor, librealsense::software_sensor);
+    return bs->on_video_frames(frames, count);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, sensor, frames, count)
+
 void rs2_software_sensor_set_metadata(rs2_sensor* sensor, rs2_frame_metadata_value key, rs2_metadata_type value, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(sensor);
@@ -1956,6 +3217,56 @@ void rs2_software_sensor_update_read_only_option(rs2_sensor* sensor, rs2_option
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, sensor, option, val)
 
+static std::shared_ptr<const librealsense::frame_allocator> make_frame_allocator(rs2_frame_allocator_alloc_ptr alloc, rs2_frame_allocator_free_ptr free, size_t alignment, void* user)
+{
+    if (!alloc) return nullptr;
+
+    VALIDATE_NOT_NULL(free);
+    if (alignment == 0 || (alignment & (alignment - 1)))
+        throw librealsense::invalid_value_exception(librealsense::to_string() << "alignment " << alignment << " is not a power of two");
+
+    return std::make_shared<librealsense::frame_allocator>(librealsense::frame_allocator{ alloc, free, alignment, user });
+}
+
+void rs2_set_frame_allocator(rs2_sensor* sensor, rs2_frame_allocator_alloc_ptr alloc, rs2_frame_allocator_free_ptr free, size_t alignment, void* user, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(sensor);
+    auto s = dynamic_cast<librealsense::sensor_base*>(sensor->sensor);
+    if (!s)
+        throw librealsense::not_implemented_exception("This sensor does not support custom frame allocators");
+
+    s->set_frame_allocator(make_frame_allocator(alloc, free, alignment, user));
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, sensor, alignment, user)
+
+void rs2_set_user_buffers(rs2_sensor* sensor, rs2_stream stream, int index, void** buffers, int count, size_t size, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(sensor);
+    VALIDATE_ENUM(stream);
+    VALIDATE_RANGE(count, 0, MAX_V4L2_FRAME_BUFFERS);
+
+    auto s = dynamic_cast<librealsense::uvc_sensor*>(sensor->sensor);
+    if (!s)
+        throw librealsense::not_implemented_exception("This sensor does not capture into user buffers");
+
+    std::vector<platform::user_buffer> user_buffers;
+    if (count) VALIDATE_NOT_NULL(buffers);
+    for (int i = 0; i < count; ++i)
+    {
+        VALIDATE_NOT_NULL(buffers[i]);
+        user_buffers.push_back({ buffers[i], size });
+    }
+    s->set_user_buffers(stream, index, std::move(user_buffers));
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, sensor, stream, index, buffers, count, size)
+
+void rs2_context_set_frame_allocator(rs2_context* context, rs2_frame_allocator_alloc_ptr alloc, rs2_frame_allocator_free_ptr free, size_t alignment, void* user, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(context);
+    context->ctx->set_frame_allocator(make_frame_allocator(alloc, free, alignment, user));
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, context, alignment, user)
+
 void rs2_log(rs2_log_severity severity, const char * message, rs2_error ** error) BEGIN_API_CALL
 {
     VALIDATE_ENUM(severity);
@@ -11,6 +11,9 @@
 #include "device.h"
 #include "stream.h"
 #include "sensor.h"
+#include "usb-bandwidth.h"
+#include "global-timestamp-reader.h"
+#include "trace.h"
 
 namespace librealsense
 {
@@ -29,8 +32,24 @@ namespace librealsense
           })
     {
         register_option(RS2_OPTION_FRAMES_QUEUE_SIZE, _source.get_published_size_option());
+        register_option(RS2_OPTION_FRAMES_MEMORY_BUDGET, _source.get_published_memory_option());
+        register_option(RS2_OPTION_CALLBACK_THREADS, _source.get_callback_threads_option());
+        register_option(RS2_OPTION_ORDERED_CALLBACKS, _source.get_ordered_callbacks_option());
+#ifdef __linux__
+        register_option(RS2_OPTION_FRAMES_HUGE_PAGES, std::make_shared<ptr_option<bool>>(false, true, true, false, &_huge_pages,
+            "Back frame buffers of 2MB and above with huge pages. Applies the next time the sensor is opened"));
+#endif
 
         register_metadata(RS2_FRAME_METADATA_TIME_OF_ARRIVAL, std::make_shared<librealsense::md_time_of_arrival_parser>());
+        register_metadata(RS2_FRAME_METADATA_DEQUEUE_TIME, std::make_shared<librealsense::md_stage_time_parser>(frame_stage::dequeue));
+        register_metadata(RS2_FRAME_METADATA_UNPACK_TIME, std::make_shared<librealsense::md_stage_time_parser>(frame_stage::unpack));
+        register_metadata(RS2_FRAME_METADATA_SYNC_TIME, std::make_shared<librealsense::md_stage_time_parser>(frame_stage::sync));
+        register_metadata(RS2_FRAME_METADATA_CALLBACK_TIME, std::make_shared<librealsense::md_stage_time_parser>(frame_stage::callback));
+        register_metadata(RS2_FRAME_METADATA_DEPTH_MIN, std::make_shared<librealsense::md_depth_statistics_parser>(RS2_FRAME_METADATA_DEPTH_MIN));
+        register_metadata(RS2_FRAME_METADATA_DEPTH_MAX, std::make_shared<librealsense::md_depth_statistics_parser>(RS2_FRAME_METADATA_DEPTH_MAX));
+        register_metadata(RS2_FRAME_METADATA_DEPTH_MEAN, std::make_shared<librealsense::md_depth_statistics_parser>(RS2_FRAME_METADATA_DEPTH_MEAN));
+        register_metadata(RS2_FRAME_METADATA_DEPTH_FILL_RATE, std::make_shared<librealsense::md_depth_statistics_parser>(RS2_FRAME_METADATA_DEPTH_FILL_RATE));
+        register_metadata(RS2_FRAME_METADATA_DEPTH_HISTOGRAM, std::make_shared<librealsense::md_depth_statistics_parser>(RS2_FRAME_METADATA_DEPTH_HISTOGRAM));
 
         register_info(RS2_CAMERA_INFO_NAME, name);
     }
@@ -46,6 +65,29 @@ namespace librealsense
         return info_container::supports_info(info) || _owner->supports_info(info);
     }
 
+    void sensor_base::set_frame_allocator(std::shared_ptr<const frame_allocator> allocator)
+    {
+        std::atomic_store(&_frame_allocator, std::move(allocator));
+    }
+
+    std::shared_ptr<const frame_allocator> sensor_base::get_frame_allocator() const
+    {
+        if (auto allocator = std::atomic_load(&_frame_allocator))
+            return allocator;
+
+        auto ctx = _owner->get_context();
+        if (auto allocator = ctx ? ctx->get_frame_allocator() : nullptr)
+            return allocator;
+
+        return _huge_pages ? get_huge_page_allocator() : nullptr;
+    }
+
+    preallocation_mode sensor_base::get_preallocation() const
+    {
+        auto ctx = _owner->get_context();
+        return ctx ? ctx->get_preallocation() : preallocation_mode::off;
+    }
+
     stream_profiles sensor_base::get_active_streams() const
     {
         return _active_profiles;
@@ -129,20 +171,13 @@ namespace librealsense
     {
         // per requested profile, find all 4ccs that support that request.
         std::map<int, std::set<uint32_t>> legal_fourccs;
-        auto profiles = get_stream_profiles();
+        auto index = get_profile_index();
         for (auto&& r : requests)
         {
             auto sp = to_profile(r.get());
-            for (auto&& mode : profiles)
-            {
-                if (auto backend_profile = dynamic_cast<backend_stream_profile*>(mode.get()))
-                {
-                    auto m = to_profile(mode.get());
-
-                    if (m.fps == sp.fps && m.height == sp.height && m.width == sp.width)
-                        legal_fourccs[sp.index].insert(backend_profile->get_backend_profile().format); // TODO: Stread ID???
-                }
-            }
+            auto it = index->fourccs.find(profile_index::mode_key(sp.width, sp.height, sp.fps));
+            if (it != index->fourccs.end())
+                legal_fourccs[sp.index].insert(it->second.begin(), it->second.end()); // TODO: Stread ID???
         }
 
         //if you want more efficient data structure use std::unordered_set
@@ -229,17 +264,35 @@ namespace librealsense
 
     std::shared_ptr<stream_profile_interface> sensor_base::map_requests(std::shared_ptr<stream_profile_interface> request)
     {
-        stream_profiles results;
-        auto profiles = get_stream_profiles();
+        auto index = get_profile_index();
+        auto sp = to_profile(request.get());
 
-        auto it = std::find_if(profiles.begin(), profiles.end(), [&](std::shared_ptr<stream_profile_interface> p) {
-            return to_profile(p.get()) == to_profile(request.get());
-        });
-
-        if (it == profiles.end())
+        auto it = index->profiles.find(profile_index::profile_key(sp.width, sp.height, sp.fps, sp.format, sp.index));
+        if (it == index->profiles.end())
             throw invalid_value_exception("Subdevice could not map requests!");
 
-        return *it;
+        return it->second;
+    }
+
+    std::shared_ptr<const sensor_base::profile_index> sensor_base::get_profile_index()
+    {
+        auto profiles = get_stream_profiles();
+
+        std::lock_guard<std::mutex> lock(_profile_index_mutex);
+        if (_profile_index && _profile_index->size == profiles.size())
+            return _profile_index;
+
+        auto index = std::make_shared<profile_index>();
+        index->size = profiles.size();
+        for (auto&& p : profiles)
+        {
+            auto sp = to_profile(p.get());
+            index->profiles.emplace(profile_index::profile_key(sp.width, sp.height, sp.fps, sp.format, sp.index), p);
+            if (auto backend_profile = dynamic_cast<backend_stream_profile*>(p.get()))
+                index->fourccs[profile_index::mode_key(sp.width, sp.height, sp.fps)].insert(backend_profile->get_backend_profile().format);
+        }
+        _profile_index = index;
+        return _profile_index;
     }
 
     uvc_sensor::~uvc_sensor()
@@ -251,6 +304,9 @@ namespace librealsense
 
             if (_is_opened)
                 uvc_sensor::close();
+
+            std::lock_guard<std::mutex> lock(_configure_lock);
+            release_warm_streams();
         }
         catch(...)
         {
@@ -285,6 +341,19 @@ namespace librealsense
         if (_uvc_profiles.empty()){}
             _uvc_profiles = _device->get_profiles();
 
+        // Outputs scaling down a native profile are only listed for resolutions no native profile provides,
+        // since resolve_requests prefers the native unpacker for them anyway
+        typedef std::tuple<rs2_stream, int, rs2_format, uint32_t, uint32_t, uint32_t> profile_key;
+        std::set<profile_key> native_profiles;
+        for (auto&& p : _uvc_profiles)
+        {
+            native_pixel_format pf{};
+            if (try_get_pf(p, pf))
+                for (auto&& unpacker : pf.unpackers)
+                    for (auto&& output : unpacker.outputs)
+                        native_profiles.insert(profile_key(output.stream_desc.type, output.stream_desc.index, output.format, p.width, p.height, p.fps));
+        }
+
         for (auto&& p : _uvc_profiles)
         {
             supported_formats.insert(p.format);
@@ -295,8 +364,12 @@ namespace librealsense
                 {
                     for (auto&& output : unpacker.outputs)
                     {
-                        auto profile = std::make_shared<video_stream_profile>(p);
                         auto res = output.stream_resolution({ p.width, p.height });
+                        if (res.width < p.width && res.height < p.height &&
+                            native_profiles.count(profile_key(output.stream_desc.type, output.stream_desc.index, output.format, res.width, res.height, p.fps)))
+                            continue;
+
+                        auto profile = std::make_shared<video_stream_profile>(p);
                         profile->set_dims(res.width, res.height);
                         profile->set_stream_type(output.stream_desc.type);
                         profile->set_stream_index(output.stream_desc.index);
@@ -347,9 +420,9 @@ namespace librealsense
             auto b = to_profile(bp.get());
 
             // stream == RS2_STREAM_COLOR && format == RS2_FORMAT_RGB8 element works around the fact that Y16 gets priority over RGB8 when both
-            // are available for pipeline stream resolution
-            auto at = std::make_tuple(a.stream, a.width, a.height, a.fps, a.stream == RS2_STREAM_COLOR && a.format == RS2_FORMAT_RGB8, a.format);
-            auto bt = std::make_tuple(b.stream, b.width, b.height, b.fps, b.stream == RS2_STREAM_COLOR && b.format == RS2_FORMAT_RGB8, b.format);
+            // are available for pipeline stream resolution, and format != RS2_FORMAT_DISTANCE keeps Z16 ahead of the metric depth
+            auto at = std::make_tuple(a.stream, a.width, a.height, a.fps, a.stream == RS2_STREAM_COLOR && a.format == RS2_FORMAT_RGB8, a.format != RS2_FORMAT_DISTANCE, a.format);
+            auto bt = std::make_tuple(b.stream, b.width, b.height, b.fps, b.stream == RS2_STREAM_COLOR && b.format == RS2_FORMAT_RGB8, b.format != RS2_FORMAT_DISTANCE, b.format);
 
             return at > bt;
         });
@@ -357,6 +430,11 @@ namespace librealsense
         return res;
     }
 
+    bool uvc_sensor::requires_processing(const request_mapping& mode) const
+    {
+        return mode.requires_processing() && !(_zero_copy && is_pass_through(*mode.unpacker));
+    }
+
     rs2_extension uvc_sensor::stream_to_frame_types(rs2_stream stream) const
     {
         // TODO: explicitly return video_frame for relevant streams and default to an error?
@@ -390,6 +468,80 @@ namespace librealsense
             _pixel_formats.erase(it);
     }
 
+    // Enough kernel buffers for the driver to keep capturing through a stall of the callbacks of the given length, on top of
+    // the buffer being filled and the one being delivered. The default tolerance gives the former 4 buffers at 30 fps
+    static int backend_buffers_for(uint32_t fps, float latency_tolerance_ms)
+    {
+        auto stalled = static_cast<int>(std::ceil(fps * latency_tolerance_ms / 1000.f));
+        return std::max(2, std::min<int>(stalled + 2, MAX_V4L2_FRAME_BUFFERS));
+    }
+
+    // Split the frame into bands of whole rows, unpacked concurrently by the workers and the calling thread
+    static void unpack_rows(parallel_workers& workers, const request_mapping& mode, const std::vector<byte *>& dest, const byte * source)
+    {
+        auto&& unpacker = *mode.unpacker;
+        auto width = mode.profile.width;
+        auto height = static_cast<int>(mode.profile.height);
+
+        // Vectorized unpackers consume 16 pixels at a time, keeping bands at multiples of 16 rows preserves that granularity
+        auto rows = (height + static_cast<int>(workers.size())) / (static_cast<int>(workers.size()) + 1);
+        rows = (rows + 15) / 16 * 16;
+        auto bands = (height + rows - 1) / rows;
+
+        std::array<size_t, 2> strides{};
+        for (size_t i = 0; i < dest.size(); i++)
+            strides[i] = width * get_image_bpp(unpacker.outputs[i].format) / 8;
+        auto source_stride = width * mode.pf->bytes_per_pixel;
+
+        workers.run(bands, [&](int band)
+        {
+            auto first = band * rows;
+            std::array<byte *, 2> band_dest{};
+            for (size_t i = 0; i < dest.size(); i++)
+                band_dest[i] = dest[i] + first * strides[i];
+            unpacker.unpack(band_dest.data(), source + first * source_stride, width, std::min(rows, height - first));
+        });
+    }
+
+    // Unpack a region of the frame alone, into outputs of the size of the region, in bands of rows like unpack_rows
+    static void unpack_region(parallel_workers* workers, const request_mapping& mode, uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                              const std::vector<byte *>& dest, const byte * source)
+    {
+        auto&& unpacker = *mode.unpacker;
+        auto bytes_per_pixel = mode.pf->bytes_per_pixel;
+        auto source_stride = mode.profile.width * bytes_per_pixel;
+        source += y * source_stride + x * bytes_per_pixel;
+
+        std::array<size_t, 2> strides{};
+        for (size_t i = 0; i < dest.size(); i++)
+            strides[i] = width * get_image_bpp(unpacker.outputs[i].format) / 8;
+
+        auto unpack_band = [&](uint32_t first, uint32_t rows)
+        {
+            std::array<byte *, 2> band_dest{};
+            for (size_t i = 0; i < dest.size(); i++)
+                band_dest[i] = dest[i] + first * strides[i];
+            unpack_cropped_rows(unpacker, band_dest.data(), source + first * source_stride, static_cast<int>(source_stride),
+                                static_cast<int>(bytes_per_pixel), static_cast<int>(width), static_cast<int>(rows));
+        };
+
+        if (!workers)
+        {
+            unpack_band(0, height);
+            return;
+        }
+
+        auto threads = static_cast<uint32_t>(workers->size()) + 1;
+        auto rows = (height + threads - 1) / threads;
+        rows = (rows + 15) / 16 * 16;
+        auto bands = static_cast<int>((height + rows - 1) / rows);
+        workers->run(bands, [&](int band)
+        {
+            auto first = band * rows;
+            unpack_band(first, std::min(rows, height - first));
+        });
+    }
+
     void uvc_sensor::open(const stream_profiles& requests)
     {
         std::lock_guard<std::mutex> lock(_configure_lock);
@@ -398,26 +550,147 @@ namespace librealsense
         else if (_is_opened)
             throw wrong_api_call_sequence_exception("open(...) failed. UVC device is already opened!");
 
+        // The streams a warm close left running are resumed as they are when the same profiles are requested again
+        if (!_warm_requests.empty())
+        {
+            auto profiles = to_profiles(requests);
+            if (profiles.size() == _warm_requests.size() &&
+                std::is_permutation(profiles.begin(), profiles.end(), _warm_requests.begin(),
+                    [](const stream_profile& a, const stream_profile& b) { return a.stream == b.stream && a == b; }))
+            {
+                _warm_requests.clear();
+                _is_opened = true;
+                set_active_streams(requests);
+                return;
+            }
+            release_warm_streams();
+        }
+
         auto on = std::unique_ptr<power>(new power(std::dynamic_pointer_cast<uvc_sensor>(shared_from_this())));
 
-        _source.init(_metadata_parsers);
+        _source.init(_metadata_parsers, get_frame_allocator(), get_preallocation());
         _source.set_sensor(this->shared_from_this());
-        auto mapping = resolve_requests(requests);
+
+        // Cropped profiles stream the profile they are cropped from, and are delivered in place of it
+        stream_profiles native_requests;
+        for (auto&& r : requests)
+        {
+            auto crop = find_crop(r.get());
+            native_requests.push_back(crop ? crop->source : r);
+        }
+        auto mapping = resolve_requests(native_requests);
+
+        std::vector<std::shared_ptr<const stream_crop>> mode_crops;
+        for (auto&& mode : mapping)
+        {
+            std::shared_ptr<const stream_crop> mode_crop;
+            for (auto&& request : mode.original_requests)
+            {
+                auto it = std::find_if(requests.begin(), requests.end(), [&request](const std::shared_ptr<stream_profile_interface>& r) {
+                    return r->get_stream_type() == request->get_stream_type() && r->get_stream_index() == request->get_stream_index() &&
+                           r->get_format() == request->get_format(); });
+                auto crop = it != requests.end() ? find_crop(it->get()) : nullptr;
+                if (!crop) continue;
+
+                if (mode_crop && (mode_crop->x != crop->x || mode_crop->y != crop->y ||
+                                  mode_crop->width != crop->width || mode_crop->height != crop->height))
+                    throw invalid_value_exception(to_string() << "Streams of the same mode of " << get_info(RS2_CAMERA_INFO_NAME)
+                        << " must be cropped to the same region");
+                mode_crop = crop;
+                request = crop->profile;
+            }
+
+            auto&& outputs = mode.unpacker->outputs;
+            if (mode_crop && (!is_row_separable(*mode.unpacker) || outputs.size() > 2 ||
+                std::any_of(outputs.begin(), outputs.end(), [&mode](const stream_output& output) {
+                    auto res = output.stream_resolution({ mode.profile.width, mode.profile.height });
+                    return res.width != mode.profile.width || res.height != mode.profile.height; })))
+                throw invalid_value_exception(to_string() << get_string(mode_crop->profile->get_stream_type())
+                    << " of " << get_info(RS2_CAMERA_INFO_NAME) << " cannot be cropped in this format");
+            mode_crops.push_back(mode_crop);
+        }
+
+        // Warm up the frame pools, so that the first frames of every stream are served without allocations. Preallocating,
+        // they are sized for the frames queue to fill up, with one more frame on its way
+        auto queue_size = static_cast<uint32_t>(get_option(RS2_OPTION_FRAMES_QUEUE_SIZE).query());
+        auto pool_size = get_preallocation() != preallocation_mode::off && queue_size ? queue_size + 1 : RS2_FRAME_POOL_PREWARM;
+        for (size_t i = 0; i < mapping.size(); i++)
+        {
+            auto&& mode = mapping[i];
+            auto&& crop = mode_crops[i];
+            if (!crop && !requires_processing(mode)) continue;
+
+            for (auto&& output : mode.unpacker->outputs)
+            {
+                auto res = crop ? resolution{ crop->width, crop->height } : output.stream_resolution({ mode.profile.width, mode.profile.height });
+                _source.reserve_frames(stream_to_frame_types(output.stream_desc.type),
+                                       res.width * res.height * get_image_bpp(output.format) / 8,
+                                       pool_size);
+            }
+        }
 
         auto timestamp_reader = _timestamp_reader.get();
 
         std::vector<platform::stream_profile> commited;
 
-        for (auto&& mode : mapping)
+        for (size_t i = 0; i < mapping.size(); i++)
         {
+            auto&& mode = mapping[i];
             try
             {
                 unsigned long long last_frame_number = 0;
                 rs2_time_t last_timestamp = 0;
+                // Cropped frames are always converted into frames of their own
+                auto crop = mode_crops[i];
+                auto requires_processing = crop || this->requires_processing(mode);
+                auto&& outputs = mode.unpacker->outputs;
+
+                // Unpackers running on the GPU produce GPU-resident frames, which are only downloaded when their data is read on the host
+                auto on_device = !crop && requires_processing && unpacks_on_device(*mode.unpacker);
+
+                // Metric depth is converted with the depth units of the sensor, which the unpackers do not know
+                auto distance_sensor = std::any_of(outputs.begin(), outputs.end(), [](const stream_output& output) {
+                    return output.format == RS2_FORMAT_DISTANCE; }) ? dynamic_cast<depth_sensor*>(this) : nullptr;
+
+                // Deferred frames keep the backend buffer, and convert it into their own storage when the data is first read
+                auto deferred = !crop && !distance_sensor && !on_device && _deferred_unpack && requires_processing && outputs.size() == 1;
+
+                // Every stream is captured on its own thread, so each gets a private set of workers.
+                // Bands are only valid when every output row maps to a single source row
+                std::shared_ptr<parallel_workers> unpack_workers;
+                if (_unpack_threads > 1 && requires_processing && !deferred && !on_device && is_row_separable(*mode.unpacker) && outputs.size() <= 2 &&
+                    std::none_of(outputs.begin(), outputs.end(), [&mode](const stream_output& output) {
+                        auto res = output.stream_resolution({ mode.profile.width, mode.profile.height });
+                        return res.width != mode.profile.width || res.height != mode.profile.height; }))
+                    unpack_workers = std::make_shared<parallel_workers>(_unpack_threads - 1);
+
+                // Frames that wrap the backend buffers keep them away from the driver while the user holds them,
+                // so allocate enough buffers to cover the frames queue on top of the others
+                int buffers = _backend_buffers ? _backend_buffers : backend_buffers_for(mode.profile.fps, _buffers_latency_tolerance);
+                if (!requires_processing || deferred)
+                {
+                    auto queue_size = static_cast<int>(get_option(RS2_OPTION_FRAMES_QUEUE_SIZE).query());
+                    buffers = std::min<int>(buffers + queue_size, MAX_V4L2_FRAME_BUFFERS);
+                }
+
+                // Streams captured into the memory of the application run on exactly the buffers it registered
+                auto user_buffers = std::find_if(_user_buffers.begin(), _user_buffers.end(),
+                    [&outputs](const decltype(_user_buffers)::value_type& registered) {
+                        return std::any_of(outputs.begin(), outputs.end(), [&registered](const stream_output& output) {
+                            return output.stream_desc.type == registered.first.first && output.stream_desc.index == registered.first.second; }); });
+                if (user_buffers != _user_buffers.end())
+                {
+                    if (!_device->set_user_buffers(mode.profile, user_buffers->second))
+                        throw not_implemented_exception(to_string() << "The backend of " << get_info(RS2_CAMERA_INFO_NAME)
+                            << " cannot capture " << get_string(user_buffers->first.first) << " into user buffers");
+                    buffers = static_cast<int>(user_buffers->second.size());
+                }
+
                 _device->probe_and_commit(mode.profile,
-                [this, mode, timestamp_reader, requests, last_frame_number, last_timestamp](platform::stream_profile p, platform::frame_object f, std::function<void()> continuation) mutable
+                [this, mode, crop, distance_sensor, timestamp_reader, requests, last_frame_number, last_timestamp, requires_processing, on_device, deferred, unpack_workers](platform::stream_profile p, platform::frame_object f, std::function<void()> continuation) mutable
                 {
                     auto system_time = environment::get_instance().get_time_service()->get_time();
+                    auto dequeue_time = f.dequeue_time ? f.dequeue_time : platform::monotonic_time();
                     if (!this->is_streaming())
                     {
                         LOG_WARNING("Frame received with streaming inactive,"
@@ -431,11 +704,15 @@ namespace librealsense
 
                     // Ignore any frames which appear corrupted or invalid
                     // Determine the timestamp for this frame
-                    auto timestamp = timestamp_reader->get_frame_timestamp(mode, f);
-                    auto timestamp_domain = timestamp_reader->get_frame_timestamp_domain(mode, f);
-                    auto frame_counter = timestamp_reader->get_frame_counter(mode, f);
+                    auto timestamps = timestamp_reader->get_frame_timestamps(mode, f);
+                    auto timestamp = timestamps.timestamp;
+                    auto timestamp_domain = timestamps.domain;
+                    auto frame_counter = timestamps.frame_counter;
 
-                    auto requires_processing = mode.requires_processing();
+                    // The backend stamps the dequeue, the waiting of the frame until this callback is traced from it
+                    auto& trace = tracer::instance();
+                    if (trace.is_enabled() && f.dequeue_time)
+                        trace.record("dequeue", "frame", f.dequeue_time, std::max(platform::monotonic_time() - f.dequeue_time, 1e-6), frame_counter, true);
 
                     std::vector<byte *> dest;
                     std::vector<frame_holder> refs;
@@ -470,11 +747,12 @@ namespace librealsense
                             last_timestamp,
                             last_frame_number,
                             false);
+                        additional_data.priority = _source.get_stream_priority(output.stream_desc.type, output.stream_desc.index);
 
                         last_frame_number = frame_counter;
                         last_timestamp = timestamp;
 
-                        auto res = output.stream_resolution({ mode.profile.width, mode.profile.height });
+                        auto res = crop ? resolution{ crop->width, crop->height } : output.stream_resolution({ mode.profile.width, mode.profile.height });
                         auto width = res.width;
                         auto height = res.height;
 
@@ -486,6 +764,7 @@ namespace librealsense
                             video->set_timestamp_domain(timestamp_domain);
                             dest.push_back(const_cast<byte*>(video->get_frame_data()));
                             frame->set_stream(request);
+                            frame->set_stage_time(frame_stage::dequeue, dequeue_time);
                             refs.push_back(std::move(frame));
                         }
                         else
@@ -499,9 +778,57 @@ namespace librealsense
                     }
 
                     // Unpack the frame
-                    if (requires_processing && (dest.size() > 0))
+                    auto unpack_start = platform::monotonic_time();
+                    void* device_dest = nullptr;
+#ifdef RS2_USE_CUDA
+                    // A frame the device has no memory left for is unpacked on the host
+                    if (on_device)
                     {
-                        unpacker.unpack(dest.data(), reinterpret_cast<const byte *>(f.pixels), mode.profile.width, mode.profile.height);
+                        auto video = (video_frame*)refs.front().frame;
+                        device_dest = video->alloc_device_data(size_t(video->get_stride()) * video->get_height());
+                    }
+#endif
+                    if (device_dest)
+                    {
+#ifdef RS2_USE_CUDA
+                        unpack_to_device(unpacker, static_cast<byte*>(device_dest), reinterpret_cast<const byte *>(f.pixels),
+                            mode.profile.width, mode.profile.height);
+#endif
+                    }
+                    else if (deferred)
+                    {
+                        auto unpack = unpacker.unpack;
+                        auto width = mode.profile.width;
+                        auto height = mode.profile.height;
+                        auto video = (video_frame*)refs.front().frame;
+                        video->defer_unpack([unpack, width, height](byte* dest, const byte* source)
+                        {
+                            byte* const outputs[] = { dest };
+                            unpack(outputs, source, width, height);
+                        });
+                        video->attach_continuation(std::move(release_and_enqueue));
+                    }
+                    else if (requires_processing && (dest.size() > 0))
+                    {
+                        if (crop)
+                            unpack_region(unpack_workers.get(), mode, crop->x, crop->y, crop->width, crop->height,
+                                          dest, reinterpret_cast<const byte *>(f.pixels));
+                        else if (distance_sensor)
+                            depth_to_distance(reinterpret_cast<const uint16_t *>(f.pixels), reinterpret_cast<float *>(dest.front()),
+                                              size_t(mode.profile.width) * mode.profile.height, distance_sensor->get_depth_scale());
+                        else if (unpack_workers)
+                            unpack_rows(*unpack_workers, mode, dest, reinterpret_cast<const byte *>(f.pixels));
+                        else
+                            unpacker.unpack(dest.data(), reinterpret_cast<const byte *>(f.pixels), mode.profile.width, mode.profile.height);
+                    }
+
+                    if (requires_processing && !deferred)
+                    {
+                        auto unpack_time = platform::monotonic_time();
+                        for (auto&& pref : refs)
+                            pref->set_stage_time(frame_stage::unpack, unpack_time);
+                        if (trace.is_enabled())
+                            trace.record("unpack", "frame", unpack_start, std::max(unpack_time - unpack_start, 1e-6), frame_counter, true);
                     }
 
                     // If any frame callbacks were specified, dispatch them now
@@ -509,6 +836,8 @@ namespace librealsense
                     {
                         if (!requires_processing)
                         {
+                            if (f.dmabuf)
+                                ((video_frame*)pref.frame)->set_dmabuf(f.dmabuf->fd, static_cast<int>(f.dmabuf->offset));
                             pref->attach_continuation(std::move(release_and_enqueue));
                         }
 
@@ -522,7 +851,7 @@ namespace librealsense
                         if (pref->get_stream().get())
                             _source.invoke_callback(std::move(pref));
                     }
-                });
+                }, buffers);
             }
             catch(...)
             {
@@ -563,6 +892,8 @@ namespace librealsense
             _is_opened = false;
             throw;
         }
+        usb_bandwidth_planner::set_active(this, &get_device(), get_device_path(), get_usb_specification(),
+                                          usb_bandwidth_planner::get_bandwidth(native_requests));
         set_active_streams(requests);
     }
 
@@ -574,14 +905,135 @@ namespace librealsense
         else if (!_is_opened)
             throw wrong_api_call_sequence_exception("close() failed. UVC device was not opened!");
 
+        // A warm close keeps the device streaming into its buffers with the callbacks stopped, and the sensor powered
+        if (_warm_restart)
+            _warm_requests = to_profiles(get_active_streams());
+        else
+            close_streams();
+        _is_opened = false;
+        set_active_streams({});
+    }
+
+    void uvc_sensor::close_streams()
+    {
         for (auto& profile : _internal_config)
         {
             _device->close(profile);
         }
         reset_streaming();
         _power.reset();
-        _is_opened = false;
-        set_active_streams({});
+        usb_bandwidth_planner::clear_active(this);
+    }
+
+    void uvc_sensor::release_warm_streams()
+    {
+        if (_warm_requests.empty())
+            return;
+
+        _warm_requests.clear();
+        close_streams();
+    }
+
+    rs2_sensor_health sensor_base::get_health() const
+    {
+        auto memory = get_frame_memory_stats();
+        rs2_sensor_health health{};
+        health.frames_received = _source.get_frames_received();
+        health.frames_delivered = _source.get_frames_delivered();
+        health.transport_drops = memory.transport_drops;
+        health.allocation_drops = memory.allocation_failures;
+        health.queue_drops = memory.queue_drops;
+        health.frames_in_flight = memory.live_frames;
+        health.bytes_in_flight = memory.bytes_held - memory.pooled_bytes;
+        return health;
+    }
+
+    rs2_frame_memory_stats uvc_sensor::get_frame_memory_stats() const
+    {
+        auto stats = sensor_base::get_frame_memory_stats();
+        auto transport = _device->get_transport_stats();
+        stats.transport_errors = transport.transfer_errors;
+        stats.transport_drops = transport.dropped_frames;
+        return stats;
+    }
+
+    void uvc_sensor::set_user_buffers(rs2_stream stream, int index, std::vector<platform::user_buffer> buffers)
+    {
+        std::lock_guard<std::mutex> lock(_configure_lock);
+        if (_is_opened)
+            throw wrong_api_call_sequence_exception("set_user_buffers(...) failed. UVC device is already opened!");
+        release_warm_streams();
+
+        if (buffers.empty())
+            _user_buffers.erase({ stream, index });
+        else
+            _user_buffers[{ stream, index }] = std::move(buffers);
+    }
+
+    std::shared_ptr<const uvc_sensor::stream_crop> uvc_sensor::find_crop(const stream_profile_interface* profile) const
+    {
+        auto key = to_profile(profile);
+        for (auto&& crop : _crops)
+        {
+            if (crop->profile.get() == profile)
+                return crop;
+            auto p = to_profile(crop->profile.get());
+            if (p.stream == key.stream && p == key)
+                return crop;
+        }
+        return nullptr;
+    }
+
+    std::shared_ptr<stream_profile_interface> uvc_sensor::add_cropped_profile(const stream_profile_interface* base,
+                                                                              int x, int y, int width, int height)
+    {
+        std::lock_guard<std::mutex> lock(_configure_lock);
+        if (_is_opened)
+            throw wrong_api_call_sequence_exception("add_cropped_profile(...) failed. UVC device is already opened!");
+
+        auto profiles = get_stream_profiles();
+        auto it = std::find_if(profiles.begin(), profiles.end(), [base](const std::shared_ptr<stream_profile_interface>& p) { return p.get() == base; });
+        auto source = it != profiles.end() ? std::dynamic_pointer_cast<video_stream_profile>(*it) : nullptr;
+        if (!source || find_crop(base))
+            throw invalid_value_exception("add_cropped_profile(...) failed. The profile is not a video profile of the sensor!");
+
+        auto intrinsics_width = static_cast<int>(source->get_width());
+        auto intrinsics_height = static_cast<int>(source->get_height());
+        if (x < 0 || y < 0 || width <= 0 || height <= 0 || x + width > intrinsics_width || y + height > intrinsics_height)
+            throw invalid_value_exception(to_string() << "add_cropped_profile(...) failed. The region " << width << "x" << height
+                << " at (" << x << ", " << y << ") is not within the frames of " << intrinsics_width << "x" << intrinsics_height);
+        if (x % 16 || (width % 16 && x + width != intrinsics_width))
+            throw invalid_value_exception(to_string() << "add_cropped_profile(...) failed. The region must start at a column multiple of 16"
+                << " and be of a width multiple of 16, unless it ends with the frames");
+
+        auto profile = std::make_shared<video_stream_profile>(source->get_backend_profile());
+        profile->set_dims(width, height);
+        profile->set_stream_type(source->get_stream_type());
+        profile->set_stream_index(source->get_stream_index());
+        profile->set_format(source->get_format());
+        profile->set_framerate(source->get_framerate());
+        if (find_crop(profile.get()) || std::any_of(profiles.begin(), profiles.end(), [&profile](const std::shared_ptr<stream_profile_interface>& p) {
+                auto a = to_profile(p.get());
+                auto b = to_profile(profile.get());
+                return a.stream == b.stream && a == b; }))
+            throw invalid_value_exception("add_cropped_profile(...) failed. The sensor already has a profile of these dimensions!");
+
+        // The principal point moves with the origin of the region, the focal lengths and distortion are those of the full frames
+        profile->set_intrinsics([source, x, y, width, height]()
+        {
+            auto intrinsics = source->get_intrinsics();
+            intrinsics.width = width;
+            intrinsics.height = height;
+            intrinsics.ppx -= x;
+            intrinsics.ppy -= y;
+            return intrinsics;
+        });
+        assign_stream(source, profile);
+
+        _crops.push_back(std::make_shared<stream_crop>(stream_crop{ profile, source,
+            uint32_t(x), uint32_t(y), uint32_t(width), uint32_t(height) }));
+        add_stream_profile(profile);
+        return profile;
     }
 
     void uvc_sensor::register_xu(platform::extension_unit xu)
@@ -611,6 +1063,7 @@ namespace librealsense
 
         _is_streaming = false;
         _device->stop_callbacks();
+        _source.stop_callbacks();
         raise_on_before_streaming_changes(false);
     }
 
@@ -723,13 +1176,56 @@ namespace librealsense
         }
     }
 
+    int uvc_sensor::set_options(const rs2_option* ids, const float* values, int count, int* applied)
+    {
+        auto cached = std::all_of(ids, ids + count, [&](const rs2_option& id) {
+            float value;
+            return supports_option(id) && get_option(id).try_get_cached(value) && value == values[&id - ids];
+        });
+        if (cached)
+            return sensor_base::set_options(ids, values, count, applied);
+
+        power on(std::dynamic_pointer_cast<uvc_sensor>(shared_from_this()));
+        return sensor_base::set_options(ids, values, count, applied);
+    }
+
+    int uvc_sensor::get_options(const rs2_option* ids, float* values, int count, int* applied) const
+    {
+        auto cached = std::all_of(ids, ids + count, [&](const rs2_option& id) {
+            float value;
+            return supports_option(id) && get_option(id).try_get_cached(value);
+        });
+        if (cached)
+            return sensor_base::get_options(ids, values, count, applied);
+
+        auto self = std::const_pointer_cast<uvc_sensor>(std::dynamic_pointer_cast<const uvc_sensor>(shared_from_this()));
+        power on(self);
+        return sensor_base::get_options(ids, values, count, applied);
+    }
+
     void sensor_base::register_metadata(rs2_frame_metadata_value metadata, std::shared_ptr<md_attribute_parser_base> metadata_parser) const
     {
-        if (_metadata_parsers.get()->end() != _metadata_parsers.get()->find(metadata))
+        if (_metadata_parsers->get(metadata))
             throw invalid_value_exception( to_string() << "Metadata attribute parser for " << rs2_frame_metadata_to_string(metadata)
                                            <<  " is already defined");
 
-        _metadata_parsers.get()->insert(std::pair<rs2_frame_metadata_value, std::shared_ptr<md_attribute_parser_base>>(metadata, metadata_parser));
+        _metadata_parsers->set(metadata, metadata_parser);
+    }
+
+    size_t get_motion_batch_size(int batch_size, int batch_latency, uint32_t fps)
+    {
+        auto size = static_cast<size_t>(std::max(batch_size, 1));
+        if (batch_latency > 0)
+            size = std::min(size, std::max<size_t>(static_cast<size_t>(batch_latency) * fps / 1000, 1));
+        return size;
+    }
+
+    void register_motion_batch_options(sensor_base& sensor, int* batch_size, int* batch_latency)
+    {
+        sensor.register_option(RS2_OPTION_MOTION_BATCH_SIZE, std::make_shared<ptr_option<int>>(1, 512, 1, 1, batch_size,
+            "Number of samples of the motion streams delivered together in a single frame. Applies the next time the sensor is opened"));
+        sensor.register_option(RS2_OPTION_MOTION_BATCH_LATENCY, std::make_shared<ptr_option<int>>(0, 1000, 1, 0, batch_latency,
+            "Longest time, in milliseconds, a motion sample waits for its batch to be delivered, 0 for no bound. Applies the next time the sensor is opened"));
     }
 
     hid_sensor::hid_sensor(std::shared_ptr<platform::hid_device> hid_device, std::unique_ptr<frame_timestamp_reader> hid_iio_timestamp_reader,
@@ -741,9 +1237,20 @@ namespace librealsense
       _fps_and_sampling_frequency_per_rs2_stream(fps_and_sampling_frequency_per_rs2_stream),
       _hid_device(hid_device),
       _is_configured_stream(RS2_STREAM_COUNT),
-      _hid_iio_timestamp_reader(move(hid_iio_timestamp_reader)),
-      _custom_hid_timestamp_reader(move(custom_hid_timestamp_reader))
+      _hid_iio_timestamp_reader(new global_timestamp_reader(move(hid_iio_timestamp_reader))),
+      _custom_hid_timestamp_reader(new global_timestamp_reader(move(custom_hid_timestamp_reader)))
     {
+        register_motion_batch_options(*this, &_batch_size, &_batch_latency);
+
+        auto global_time = std::make_shared<ptr_option<bool>>(false, true, true, false, &_global_time,
+            "Map the hardware timestamps of the frames onto the monotonic clock of the host, in the global time domain");
+        global_time->on_set([this](float value)
+        {
+            static_cast<global_timestamp_reader*>(_hid_iio_timestamp_reader.get())->enable(value != 0);
+            static_cast<global_timestamp_reader*>(_custom_hid_timestamp_reader.get())->enable(value != 0);
+        });
+        register_option(RS2_OPTION_GLOBAL_TIME_ENABLED, global_time);
+
         std::map<std::string, uint32_t> frequency_per_sensor;
         for (auto& elem : sensor_name_and_hid_profiles)
             frequency_per_sensor.insert(make_pair(elem.first, elem.second.fps));
@@ -835,9 +1342,27 @@ namespace librealsense
         std::vector<platform::hid_profile> configured_hid_profiles;
         for (auto& elem : _configured_profiles)
         {
-            configured_hid_profiles.push_back(platform::hid_profile{elem.first, elem.second.fps});
+            // Only the samples unpacked into 3D vectors are batched, the backend then waits for a whole batch before reading it
+            uint32_t batch = 0;
+            auto batch_size = get_motion_batch_size(_batch_size, _batch_latency, elem.second.fps);
+            if (batch_size > 1 && elem.second.format == RS2_FORMAT_MOTION_XYZ32F)
+            {
+                batch = static_cast<uint32_t>(batch_size);
+                _batches[elem.first].size = batch;
+                _batches[elem.first].samples.reserve(batch);
+            }
+            configured_hid_profiles.push_back(platform::hid_profile{elem.first, elem.second.fps, batch});
+        }
+
+        try
+        {
+            _hid_device->open(configured_hid_profiles);
+        }
+        catch (...)
+        {
+            _batches.clear();
+            throw;
         }
-        _hid_device->open(configured_hid_profiles);
         _is_opened = true;
         set_active_streams(requests);
     }
@@ -855,6 +1380,7 @@ namespace librealsense
         _is_configured_stream.clear();
         _is_configured_stream.resize(RS2_STREAM_COUNT);
         _hid_mapping.clear();
+        _batches.clear();
         _is_opened = false;
         set_active_streams({});
     }
@@ -881,12 +1407,13 @@ namespace librealsense
 
         _source.set_callback(callback);
 
-        _source.init(_metadata_parsers);
+        _source.init(_metadata_parsers, get_frame_allocator(), get_preallocation());
         _source.set_sensor(this->shared_from_this());
         raise_on_before_streaming_changes(true); //Required to be just before actual start allow recording to work
         _hid_device->start_capture([this](const platform::sensor_data& sensor_data)
         {
             auto system_time = environment::get_instance().get_time_service()->get_time();
+            auto dequeue_time = sensor_data.fo.dequeue_time ? sensor_data.fo.dequeue_time : platform::monotonic_time();
             auto timestamp_reader = _hid_iio_timestamp_reader.get();
 
             // TODO:
@@ -926,30 +1453,78 @@ namespace librealsense
             mode.profile.height = 1;
 
             // Determine the timestamp for this HID frame
-            auto timestamp = timestamp_reader->get_frame_timestamp(mode, sensor_data.fo);
-            auto frame_counter = timestamp_reader->get_frame_counter(mode, sensor_data.fo);
+            auto timestamps = timestamp_reader->get_frame_timestamps(mode, sensor_data.fo);
+            auto timestamp = timestamps.timestamp;
+            auto frame_counter = timestamps.frame_counter;
+
+            // The 3D vectors are unpacked as they arrive, into the history of the stream, and the batch of batched streams
+            // until it is full for its samples to be delivered together
+            auto is_vector = request->get_format() == RS2_FORMAT_MOTION_XYZ32F;
+            rs2_motion_sample sample{};
+            if (is_vector)
+            {
+                std::vector<byte*> sample_dest{reinterpret_cast<byte*>(&sample.motion)};
+                mode.unpacker->unpack(sample_dest.data(), (const byte*)sensor_data.fo.pixels, mode.profile.width, mode.profile.height);
+                sample.timestamp = timestamp;
+                _motion_history.record(request->get_stream_type(), request->get_stream_index(), timestamp, sample.motion);
+            }
+
+            auto batch = _batches.find(sensor_name);
+            auto frame_size = data_size;
+            if (batch != _batches.end())
+            {
+                if (batch->second.samples.empty())
+                    batch->second.first_frame_number = frame_counter;
+                batch->second.samples.push_back(sample);
+                if (batch->second.samples.size() < batch->second.size)
+                    return;
+
+                // The data of the frame starts with the motion of the first sample, which is what it reads as a motion frame
+                frame_size = batch->second.samples.size() * sizeof(rs2_motion_sample);
+                timestamp = batch->second.samples.front().timestamp;
+                frame_counter = batch->second.first_frame_number;
+            }
 
             frame_additional_data additional_data{};
 
             additional_data.timestamp = timestamp;
             additional_data.frame_number = frame_counter;
-            additional_data.timestamp_domain = timestamp_reader->get_frame_timestamp_domain(mode, sensor_data.fo);
+            additional_data.timestamp_domain = timestamps.domain;
             additional_data.system_time = system_time;
+            additional_data.priority = _source.get_stream_priority(request->get_stream_type(), request->get_stream_index());
             LOG_DEBUG("FrameAccepted," << get_string(request->get_stream_type()) << "," << std::dec << frame_counter
                       << ",Arrived," << std::fixed << system_time
                       << ",TS," << std::fixed << timestamp
                       << ",TS_Domain," << rs2_timestamp_domain_to_string(additional_data.timestamp_domain));
 
-            auto frame = _source.alloc_frame(RS2_EXTENSION_MOTION_FRAME, data_size, additional_data, true);
+            auto frame = _source.alloc_frame(RS2_EXTENSION_MOTION_FRAME, frame_size, additional_data, true);
             if (!frame)
             {
                 LOG_INFO("Dropped frame. alloc_frame(...) returned nullptr");
+                if (batch != _batches.end())
+                    batch->second.samples.clear();
                 return;
             }
             frame->set_stream(request);
+            frame->set_stage_time(frame_stage::dequeue, dequeue_time);
 
-            std::vector<byte*> dest{const_cast<byte*>(frame->get_frame_data())};
-            mode.unpacker->unpack(dest.data(),(const byte*)sensor_data.fo.pixels, mode.profile.width, mode.profile.height);
+            if (batch != _batches.end())
+            {
+                auto& samples = batch->second.samples;
+                librealsense::copy(const_cast<byte*>(frame->get_frame_data()), samples.data(), frame_size);
+                ((motion_frame*)frame)->set_batched(true);
+                samples.clear();
+            }
+            else if (is_vector)
+            {
+                librealsense::copy(const_cast<byte*>(frame->get_frame_data()), &sample.motion, sizeof(sample.motion));
+            }
+            else
+            {
+                std::vector<byte*> dest{const_cast<byte*>(frame->get_frame_data())};
+                mode.unpacker->unpack(dest.data(),(const byte*)sensor_data.fo.pixels, mode.profile.width, mode.profile.height);
+            }
+            frame->set_stage_time(frame_stage::unpack, platform::monotonic_time());
 
             if (_on_before_frame_callback)
             {
@@ -973,6 +1548,8 @@ namespace librealsense
 
         _hid_device->stop_capture();
         _is_streaming = false;
+        for (auto& batch : _batches)
+            batch.second.samples.clear();
         _source.flush();
         _source.reset();
         _hid_iio_timestamp_reader->reset();
@@ -1040,8 +1617,55 @@ namespace librealsense
         : sensor_base(name, dev),
           _device(move(uvc_device)),
           _user_count(0),
-          _timestamp_reader(std::move(timestamp_reader))
+          _timestamp_reader(new global_timestamp_reader(std::move(timestamp_reader))),
+          _controls_generation(0)
     {
+#ifdef ZERO_COPY
+        _zero_copy = true;
+#endif
+        auto zero_copy = std::make_shared<ptr_option<bool>>(false, true, true, _zero_copy, &_zero_copy,
+            "Deliver pass-through formats in the backend buffers without copying. Applies the next time the sensor is opened");
+        register_option(RS2_OPTION_ZERO_COPY_ENABLED, zero_copy);
+
+        auto max_threads = std::max<int>(std::thread::hardware_concurrency(), 1);
+        auto unpack_threads = std::make_shared<ptr_option<int>>(1, max_threads, 1, 1, &_unpack_threads,
+            "Number of threads, including the capture thread, that unpack each frame in bands of rows. Applies the next time the sensor is opened");
+        register_option(RS2_OPTION_UNPACK_THREADS, unpack_threads);
+
+        auto deferred_unpack = std::make_shared<ptr_option<bool>>(false, true, true, false, &_deferred_unpack,
+            "Convert single-stream formats on the first access to the frame data, instead of on arrival. Applies the next time the sensor is opened");
+        register_option(RS2_OPTION_DEFERRED_UNPACK, deferred_unpack);
+
+        auto backend_buffers = std::make_shared<ptr_option<int>>(0, MAX_V4L2_FRAME_BUFFERS, 1, 0, &_backend_buffers,
+            "Number of kernel buffers, or of in-flight USB transfers with libuvc, per stream, 0 to derive it from the frame rate and the latency tolerance. Applies the next time the sensor is opened");
+        register_option(RS2_OPTION_BACKEND_BUFFERS, backend_buffers);
+
+        auto latency_tolerance = std::make_shared<ptr_option<float>>(0.f, 1000.f, 1.f, 66.f, &_buffers_latency_tolerance,
+            "Stall of the frame callbacks, in milliseconds, the automatic number of kernel buffers absorbs. Applies the next time the sensor is opened");
+        register_option(RS2_OPTION_BUFFERS_LATENCY_TOLERANCE, latency_tolerance);
+
+        auto controls_cache_ttl = std::make_shared<ptr_option<float>>(0.f, 10000.f, 1.f, 0.f, &_controls_cache_ttl,
+            "Time, in milliseconds, the values of the controls the camera changes by itself are reused instead of queried again, 0 to query them every time");
+        register_option(RS2_OPTION_CONTROLS_CACHE_TTL, controls_cache_ttl);
+
+        auto warm_restart = std::make_shared<ptr_option<bool>>(false, true, true, false, &_warm_restart,
+            "Keep the device streaming when the sensor is closed, for opening it again with the same profiles to resume at once. "
+            "The options that apply when the sensor is opened take effect once the streams are turned off");
+        warm_restart->on_set([this](float value)
+        {
+            std::lock_guard<std::mutex> lock(_configure_lock);
+            if (!value) release_warm_streams();
+        });
+        register_option(RS2_OPTION_WARM_RESTART, warm_restart);
+
+        auto global_time = std::make_shared<ptr_option<bool>>(false, true, true, false, &_global_time,
+            "Map the hardware timestamps of the frames onto the monotonic clock of the host, in the global time domain");
+        global_time->on_set([this](float value)
+        {
+            static_cast<global_timestamp_reader*>(_timestamp_reader.get())->enable(value != 0);
+        });
+        register_option(RS2_OPTION_GLOBAL_TIME_ENABLED, global_time);
+
         register_metadata(RS2_FRAME_METADATA_BACKEND_TIMESTAMP,     make_additional_data_parser(&frame_additional_data::backend_timestamp));
     }
 }
@@ -9,11 +9,14 @@
 #include "core/streaming.h"
 #include "core/roi.h"
 #include "core/options.h"
+#include "core/motion.h"
 #include "source.h"
+#include "motion-history.h"
 
 #include <chrono>
 #include <memory>
 #include <vector>
+#include <map>
 #include <unordered_set>
 #include <limits.h>
 #include <atomic>
@@ -76,10 +79,28 @@ namespace librealsense
         const std::string& get_info(rs2_camera_info info) const override;
         bool supports_info(rs2_camera_info info) const override;
 
+        // Frame data storage, taking effect on the next open. Falls back to the allocator of the owning context,
+        // then to huge pages when RS2_OPTION_FRAMES_HUGE_PAGES is set
+        void set_frame_allocator(std::shared_ptr<const frame_allocator> allocator);
+        std::shared_ptr<const frame_allocator> get_frame_allocator() const;
+
+        // Of the owning context, taking effect on the next open as well
+        preallocation_mode get_preallocation() const;
+
+        virtual rs2_frame_memory_stats get_frame_memory_stats() const { return _source.get_memory_stats(); }
+
+        // Frames of the streams below the highest priority of the sensor are dropped first, wherever frames compete for room
+        void set_stream_priority(rs2_stream stream, int index, int priority) { _source.set_stream_priority(stream, index, priority); }
+        int get_stream_priority(rs2_stream stream, int index) const { return _source.get_stream_priority(stream, index); }
+
+        // Counters of the frames at every stage from the backend to the callback, kept since the sensor was last opened
+        rs2_sensor_health get_health() const;
+
     protected:
         void raise_on_before_streaming_changes(bool streaming);
         void set_active_streams(const stream_profiles& requests);
         bool try_get_pf(const platform::stream_profile& p, native_pixel_format& result) const;
+        void add_stream_profile(std::shared_ptr<stream_profile_interface> profile) { (*_profiles).push_back(profile); }
 
         void assign_stream(const std::shared_ptr<stream_interface>& stream,
                            std::shared_ptr<stream_profile_interface> target) const;
@@ -101,12 +122,37 @@ namespace librealsense
         std::vector<platform::stream_profile> _uvc_profiles;
 
     private:
+        // The profiles of the sensor by their description, and the fourccs of its backend profiles by resolution and rate,
+        // for the requests to be resolved without a scan of every profile per request. Rebuilt once profiles are added
+        struct profile_index
+        {
+            typedef std::tuple<uint32_t, uint32_t, uint32_t, rs2_format, int> profile_key;  // As stream_profile compares
+            typedef std::tuple<uint32_t, uint32_t, uint32_t> mode_key;
+
+            size_t size = 0;
+            std::map<profile_key, std::shared_ptr<stream_profile_interface>> profiles;   // The first profile of a description
+            std::map<mode_key, std::set<uint32_t>> fourccs;
+        };
+        std::shared_ptr<const profile_index> get_profile_index();
+
         lazy<stream_profiles> _profiles;
+        std::mutex _profile_index_mutex;
+        std::shared_ptr<const profile_index> _profile_index;
+        std::shared_ptr<const frame_allocator> _frame_allocator;
+        bool _huge_pages = false;
         stream_profiles _active_profiles;
         std::vector<native_pixel_format> _pixel_formats;
         signal<sensor_base, bool> on_before_streaming_changes;
     };
 
+    // What a timestamp reader reads of a frame
+    struct frame_timestamps
+    {
+        double                  timestamp;
+        unsigned long long      frame_counter;
+        rs2_timestamp_domain    domain;
+    };
+
     struct frame_timestamp_reader
     {
         virtual ~frame_timestamp_reader() {}
@@ -115,9 +161,35 @@ namespace librealsense
         virtual unsigned long long get_frame_counter(const request_mapping& mode, const platform::frame_object& fo) const = 0;
         virtual rs2_timestamp_domain get_frame_timestamp_domain(const request_mapping & mode, const platform::frame_object& fo) const = 0;
         virtual void reset() = 0;
+
+        // The timestamp, counter and domain of a frame at once, which the readers override to check its metadata a single time.
+        // The counter is advanced once per call, as by get_frame_counter
+        virtual frame_timestamps get_frame_timestamps(const request_mapping& mode, const platform::frame_object& fo)
+        {
+            frame_timestamps res;
+            res.timestamp = get_frame_timestamp(mode, fo);
+            res.domain = get_frame_timestamp_domain(mode, fo);
+            res.frame_counter = get_frame_counter(mode, fo);
+            return res;
+        }
     };
 
-    class hid_sensor : public sensor_base
+    // Samples of a batched motion stream, accumulated until there are enough of them for a frame
+    struct motion_batch
+    {
+        size_t size;
+        std::vector<rs2_motion_sample> samples;
+        unsigned long long first_frame_number;  // Of the first sample, which the frame is stamped with
+    };
+
+    // Samples of the batches of a motion stream: RS2_OPTION_MOTION_BATCH_SIZE, capped by RS2_OPTION_MOTION_BATCH_LATENCY
+    // at the samples the stream captures meanwhile. 1 when the stream is not batched
+    size_t get_motion_batch_size(int batch_size, int batch_latency, uint32_t fps);
+
+    // Registers RS2_OPTION_MOTION_BATCH_SIZE and RS2_OPTION_MOTION_BATCH_LATENCY, over the members of the sensor
+    void register_motion_batch_options(sensor_base& sensor, int* batch_size, int* batch_latency);
+
+    class hid_sensor : public sensor_base, public motion_history_interface
     {
     public:
         explicit hid_sensor(std::shared_ptr<platform::hid_device> hid_device,
@@ -141,6 +213,11 @@ namespace librealsense
                                                     const std::string& report_name,
                                                     platform::custom_sensor_report_field report_field) const;
 
+        int get_motion_history(rs2_stream stream, int index, double begin, double end, double* timestamps, rs2_vector* motion, int count) const override
+        {
+            return _motion_history.query(stream, index, begin, end, timestamps, motion, count);
+        }
+
     protected:
         stream_profiles init_stream_profiles() override;
 
@@ -159,6 +236,11 @@ namespace librealsense
         std::map<std::string, request_mapping> _hid_mapping;
         std::unique_ptr<frame_timestamp_reader> _hid_iio_timestamp_reader;
         std::unique_ptr<frame_timestamp_reader> _custom_hid_timestamp_reader;
+        int _batch_size = 1;
+        int _batch_latency = 0;
+        bool _global_time = false;
+        std::map<std::string, motion_batch> _batches;   // By sensor name, fixed while the sensor is opened
+        motion_histories _motion_history;
 
         stream_profiles get_sensor_profiles(std::string sensor_name) const;
 
@@ -193,21 +275,44 @@ namespace librealsense
             return action(*_device);
         }
 
+        // The options cache the values of the controls until the generation changes, on writes, commands and resets
+        void invalidate_controls() { ++_controls_generation; }
+        uint64_t get_controls_generation() const { return _controls_generation; }
+        float get_controls_cache_ttl() const { return _controls_cache_ttl; }
+
         void register_pu(rs2_option id);
         void try_register_pu(rs2_option id);
 
+        // The controls of a batch are written or read within a single power up of the device, instead of one per control,
+        // and without any when all the values are cached
+        int set_options(const rs2_option* ids, const float* values, int count, int* applied) override;
+        int get_options(const rs2_option* ids, float* values, int count, int* applied) const override;
+
         void start(frame_callback_ptr callback) override;
 
         void stop() override;
 
+        rs2_frame_memory_stats get_frame_memory_stats() const override;
+
         platform::usb_spec get_usb_specification() const { return _device->get_usb_specification(); }
         std::string get_device_path() const { return _device->get_device_location(); }
 
+        // Capture the native frames of a stream into memory of the application the next times the sensor is opened,
+        // in as many buffers as are passed. No buffers go back to the buffers of the backend
+        void set_user_buffers(rs2_stream stream, int index, std::vector<platform::user_buffer> buffers);
+
+        // Lists a profile of a region of the frames of a video profile of the sensor, the unpacking converting only that region.
+        // Columns go by 16 pixels, the granularity of the vectorized unpackers. Only while the sensor is closed
+        std::shared_ptr<stream_profile_interface> add_cropped_profile(const stream_profile_interface* base,
+                                                                      int x, int y, int width, int height);
+
     protected:
         stream_profiles init_stream_profiles() override;
 
         rs2_extension stream_to_frame_types(rs2_stream stream) const;
 
+        bool requires_processing(const request_mapping& mode) const;
+
     private:
         void acquire_power();
 
@@ -215,6 +320,10 @@ namespace librealsense
 
         void reset_streaming();
 
+        // Turns the streams off, or those left running by a warm close
+        void close_streams();
+        void release_warm_streams();
+
         struct power
         {
             explicit power(std::weak_ptr<uvc_sensor> owner)
@@ -248,6 +357,28 @@ namespace librealsense
         std::mutex _configure_lock;
         std::vector<platform::extension_unit> _xus;
         std::unique_ptr<power> _power;
-        std::unique_ptr<frame_timestamp_reader> _timestamp_reader;
+        std::unique_ptr<frame_timestamp_reader> _timestamp_reader; // A global_timestamp_reader around the reader of the device
+        bool _zero_copy = false;
+        int _unpack_threads = 1;
+        bool _deferred_unpack = false;
+        int _backend_buffers = 0;
+        float _buffers_latency_tolerance = 66.f;
+        std::atomic<uint64_t> _controls_generation;
+        float _controls_cache_ttl = 0.f;
+        bool _warm_restart = false;
+        bool _global_time = false;
+        std::vector<stream_profile> _warm_requests; // Requests of the streams a warm close left running, if any
+        std::map<std::pair<rs2_stream, int>, std::vector<platform::user_buffer>> _user_buffers;
+
+        // A region of the frames of a profile, delivered as a profile of its own
+        struct stream_crop
+        {
+            std::shared_ptr<stream_profile_interface> profile;
+            std::shared_ptr<stream_profile_interface> source;
+            uint32_t x, y, width, height;
+        };
+        std::vector<std::shared_ptr<const stream_crop>> _crops;
+
+        std::shared_ptr<const stream_crop> find_crop(const stream_profile_interface* profile) const;
     };
 }
@@ -0,0 +1,279 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include "shm-device.h"
+#include "../net/net-description.h"
+#include "stream.h"
+#include "environment.h"
+#include "metadata-parser.h"
+
+#include <algorithm>
+
+namespace librealsense
+{
+    const std::chrono::milliseconds shm_poll_interval(1);
+
+    shm_attachment::shm_attachment(std::shared_ptr<shm::region> region)
+        : _region(std::move(region))
+    {
+        auto&& header = _region->header();
+        auto process = shm::get_process_id();
+        for (int attempt = 0; attempt < 2 && !_entry; ++attempt)
+        {
+            if (attempt)
+                shm::reclaim_consumers(header);
+            for (auto&& c : header.consumers)
+            {
+                uint32_t free = 0;
+                if (c.process.compare_exchange_strong(free, process))
+                {
+                    _entry = &c;
+                    break;
+                }
+            }
+        }
+        if (!_entry)
+            throw io_exception(to_string() << shm::max_consumers << " processes are attached already");
+    }
+
+    shm_attachment::~shm_attachment()
+    {
+        for (auto&& h : _entry->holds)
+            h.store(0);
+        _entry->process.store(0);
+    }
+
+    bool shm_attachment::hold(uint32_t slot, uint64_t sequence)
+    {
+        auto&& s = _region->header().slots[slot];
+        _entry->holds[slot].fetch_add(1);
+        if (s.writing.load() || s.sequence.load() != sequence)
+        {
+            _entry->holds[slot].fetch_sub(1);
+            return false;
+        }
+        return true;
+    }
+
+    void shm_attachment::release(uint32_t slot)
+    {
+        _entry->holds[slot].fetch_sub(1);
+    }
+
+    shm_device::shm_device(std::shared_ptr<context> ctx, const std::string& name)
+        : device(ctx, platform::backend_device_group({ platform::playback_device_info{ name } })),
+          _name(name),
+          _stopping(false)
+    {
+        auto region = shm::region::open(name);
+        net::reader r(region->get_description(), region->header().description_size);
+        add_sensors(net::read_description(r));
+
+        _attachment = std::make_shared<shm_attachment>(region);
+        _last_sequence = region->header().sequence.load();
+        _poll_thread = std::thread([this]() { poll_loop(); });
+    }
+
+    shm_device::~shm_device()
+    {
+        _stopping = true;
+        if (_poll_thread.joinable())
+            _poll_thread.join();
+    }
+
+    void shm_device::add_sensors(const net::device_description& description)
+    {
+        for (auto&& info : description.infos)
+            register_info(info.first, info.second);
+
+        std::vector<std::shared_ptr<stream_profile_interface>> profiles;
+        for (auto&& d : description.sensors)
+        {
+            std::shared_ptr<shm_sensor> sensor = d.is_depth ?
+                std::make_shared<shm_depth_sensor>(d.name, this, d.depth_units) :
+                std::make_shared<shm_sensor>(d.name, this);
+            for (auto&& info : d.infos)
+                if (info.first != RS2_CAMERA_INFO_NAME)
+                    sensor->register_info(info.first, info.second);
+
+            for (auto&& p : d.profiles)
+            {
+                auto profile = net::create_profile(p);
+                sensor->_profiles.push_back(profile);
+                _profiles[p.uid] = profile;
+                profiles.push_back(profile);
+            }
+
+            add_sensor(sensor);
+            _shm_sensors.push_back(sensor);
+        }
+
+        // Relative to the first profile the publisher described
+        for (auto&& e : description.extrinsics)
+        {
+            auto it = _profiles.find(e.first);
+            if (!profiles.empty() && it != _profiles.end())
+                environment::get_instance().get_extrinsics_graph().register_extrinsics(*profiles.front(), *it->second, e.second);
+        }
+    }
+
+    std::shared_ptr<matcher> shm_device::create_matcher(const frame_holder& frame) const
+    {
+        std::vector<stream_interface*> profiles;
+
+        for (auto&& s : _shm_sensors)
+            for (auto&& p : s->get_stream_profiles())
+                profiles.push_back(p.get());
+
+        return matcher_factory::create(RS2_MATCHER_DEFAULT, profiles);
+    }
+
+    void shm_device::poll_loop()
+    {
+        auto&& header = _attachment->get_region().header();
+        auto stopped = false;
+        while (!_stopping)
+        {
+            auto current = header.sequence.load();
+            if (current == _last_sequence)
+            {
+                if (!stopped && !header.publisher.load())
+                {
+                    LOG_WARNING("The publisher of \"" << _name << "\" stopped");
+                    stopped = true;
+                }
+                std::this_thread::sleep_for(shm_poll_interval);
+                continue;
+            }
+
+            // The slots committed since the last poll, oldest first. Those already reused are skipped
+            std::vector<std::pair<uint64_t, uint32_t>> ready;
+            for (uint32_t i = 0; i < shm::max_slots; ++i)
+            {
+                auto sequence = header.slots[i].sequence.load();
+                if (sequence > _last_sequence && sequence <= current)
+                    ready.emplace_back(sequence, i);
+            }
+            std::sort(ready.begin(), ready.end());
+            _last_sequence = current;
+
+            for (auto&& r : ready)
+            {
+                if (!_attachment->hold(r.second, r.first))
+                    continue;
+
+                auto&& frame = header.slots[r.second].frame;
+                auto it = _profiles.find(frame.profile);
+                if (frame.sensor >= _shm_sensors.size() || it == _profiles.end())
+                {
+                    _attachment->release(r.second);
+                    continue;
+                }
+                _shm_sensors[frame.sensor]->on_frame(_attachment, r.second, it->second);
+            }
+        }
+    }
+
+    shm_sensor::shm_sensor(std::string name, shm_device* owner)
+        : sensor_base(name, owner)
+    {
+        _metadata_parsers = md_constant_parser::create_metadata_parser_map();
+    }
+
+    stream_profiles shm_sensor::init_stream_profiles()
+    {
+        return _profiles;
+    }
+
+    void shm_sensor::open(const stream_profiles& requests)
+    {
+        if (_is_streaming)
+            throw wrong_api_call_sequence_exception("open(...) failed. Shared memory device is streaming!");
+        else if (_is_opened)
+            throw wrong_api_call_sequence_exception("open(...) failed. Shared memory device is already opened!");
+
+        for (auto&& r : requests)
+            if (std::none_of(_profiles.begin(), _profiles.end(),
+                [&r](const std::shared_ptr<stream_profile_interface>& p) { return p->get_unique_id() == r->get_unique_id(); }))
+                throw invalid_value_exception("open(...) failed. The stream profile is not of this shared memory sensor!");
+
+        _is_opened = true;
+        set_active_streams(requests);
+    }
+
+    void shm_sensor::close()
+    {
+        if (_is_streaming)
+            throw wrong_api_call_sequence_exception("close() failed. Shared memory device is streaming!");
+        else if (!_is_opened)
+            throw wrong_api_call_sequence_exception("close() failed. Shared memory device was not opened!");
+        _is_opened = false;
+        set_active_streams({});
+    }
+
+    void shm_sensor::start(frame_callback_ptr callback)
+    {
+        if (_is_streaming)
+            throw wrong_api_call_sequence_exception("start_streaming(...) failed. Shared memory device is already streaming!");
+        else if (!_is_opened)
+            throw wrong_api_call_sequence_exception("start_streaming(...) failed. Shared memory device was not opened!");
+
+        _source.init(_metadata_parsers, get_frame_allocator(), get_preallocation());
+        _source.set_sensor(this->shared_from_this());
+        _source.set_callback(callback);
+        _is_streaming = true;
+        raise_on_before_streaming_changes(true);
+    }
+
+    void shm_sensor::stop()
+    {
+        if (!_is_streaming)
+            throw wrong_api_call_sequence_exception("stop_streaming() failed. Shared memory device is not streaming!");
+
+        _is_streaming = false;
+        raise_on_before_streaming_changes(false);
+        _source.flush();
+        _source.reset();
+    }
+
+    void shm_sensor::on_frame(std::shared_ptr<shm_attachment> attachment, uint32_t slot, std::shared_ptr<stream_profile_interface> profile)
+    {
+        auto active = get_active_streams();
+        if (!_is_streaming || std::none_of(active.begin(), active.end(),
+            [&profile](const std::shared_ptr<stream_profile_interface>& p) { return p->get_unique_id() == profile->get_unique_id(); }))
+        {
+            attachment->release(slot);
+            return;
+        }
+
+        // Read once, for the checks to hold for what the frame is made of
+        auto&& s = attachment->get_region().header().slots[slot];
+        auto header = s.frame;
+        if (!shm::is_valid_frame(attachment->get_region().header(), header))
+        {
+            LOG_WARNING("Dropped frame " << header.frame_number << ", its size does not fit its shared memory slot");
+            attachment->release(slot);
+            return;
+        }
+
+        auto data = net::get_additional_data(header, s.metadata, std::min(header.metadata_count, shm::max_metadata));
+        auto extension = profile->get_stream_type() == RS2_STREAM_DEPTH ? RS2_EXTENSION_DEPTH_FRAME : RS2_EXTENSION_VIDEO_FRAME;
+        auto frame = _source.alloc_frame(extension, 0, data, false);
+        if (!frame)
+        {
+            LOG_INFO("Dropped frame. alloc_frame(...) returned nullptr");
+            attachment->release(slot);
+            return;
+        }
+
+        // The frame is the slot data itself, which stays held until the frame is released
+        auto pixels = attachment->get_region().get_slot_data(slot);
+        auto vid_frame = dynamic_cast<video_frame*>(frame);
+        vid_frame->assign(header.width, header.height, header.stride, header.bpp);
+        frame->set_stream(profile);
+        frame->attach_continuation(frame_continuation{ [attachment, slot]() {
+            attachment->release(slot);
+        }, pixels });
+        _source.invoke_callback(frame);
+    }
+}
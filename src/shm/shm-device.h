@@ -0,0 +1,136 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "shm-region.h"
+#include "core/streaming.h"
+#include "core/video.h"
+#include "device.h"
+#include "context.h"
+
+#include <atomic>
+#include <map>
+#include <thread>
+
+namespace librealsense
+{
+    class shm_sensor;
+    namespace net { struct device_description; }
+
+    // Entry of this process in a region, freed along with the slots it holds once the frames that hold them are all released
+    class shm_attachment
+    {
+    public:
+        explicit shm_attachment(std::shared_ptr<shm::region> region);
+        ~shm_attachment();
+
+        shm::region& get_region() const { return *_region; }
+
+        // False when the slot no longer holds the frame of the sequence
+        bool hold(uint32_t slot, uint64_t sequence);
+        void release(uint32_t slot);
+
+    private:
+        std::shared_ptr<shm::region> _region;
+        shm::consumer* _entry = nullptr;
+    };
+
+    // Device receiving the frames another process of the host publishes with shm_publisher. Its sensors and profiles are those
+    // the publisher described, and they open and start locally, for the frames of the streams the publisher runs. The publisher
+    // alone controls the device and its options
+    class shm_device : public device
+    {
+    public:
+        shm_device(std::shared_ptr<context> ctx, const std::string& name);
+        ~shm_device();
+
+        const std::string& get_name() const { return _name; }
+
+        std::shared_ptr<matcher> create_matcher(const frame_holder& frame) const override;
+
+        std::vector<tagged_profile> get_profiles_tags() const override
+        {
+            std::vector<tagged_profile> markers;
+            return markers;
+        };
+
+    private:
+        void add_sensors(const net::device_description& description);
+        void poll_loop();
+
+        std::string _name;
+        std::shared_ptr<shm_attachment> _attachment;
+        std::vector<std::shared_ptr<shm_sensor>> _shm_sensors;
+        std::map<uint32_t, std::shared_ptr<stream_profile_interface>> _profiles;  // By the unique id in the publisher
+
+        std::atomic<bool> _stopping;
+        uint64_t _last_sequence = 0;
+        std::thread _poll_thread;
+    };
+
+    class shm_sensor : public sensor_base
+    {
+    public:
+        shm_sensor(std::string name, shm_device* owner);
+
+        stream_profiles init_stream_profiles() override;
+
+        void open(const stream_profiles& requests) override;
+        void close() override;
+
+        void start(frame_callback_ptr callback) override;
+        void stop() override;
+
+        // Hands out the slot, which the attachment holds, as a frame of the profile. Releases it when the sensor does not stream it
+        void on_frame(std::shared_ptr<shm_attachment> attachment, uint32_t slot, std::shared_ptr<stream_profile_interface> profile);
+
+    private:
+        friend class shm_device;
+        stream_profiles _profiles;
+    };
+
+    class shm_depth_sensor : public shm_sensor, public virtual depth_sensor
+    {
+    public:
+        shm_depth_sensor(std::string name, shm_device* owner, float depth_units)
+            : shm_sensor(name, owner), _depth_units(depth_units) {}
+
+        float get_depth_scale() const override { return _depth_units; }
+
+        void create_snapshot(std::shared_ptr<depth_sensor>& snapshot) const override
+        {
+            snapshot = std::make_shared<depth_sensor_snapshot>(get_depth_scale());
+        }
+
+        void enable_recording(std::function<void(const depth_sensor&)> recording_function) override {}
+
+    private:
+        float _depth_units;
+    };
+
+    class shm_device_info : public device_info
+    {
+    public:
+        explicit shm_device_info(std::shared_ptr<shm_device> dev)
+            : device_info(dev->get_context()), _dev(dev) {}
+
+        std::shared_ptr<device_interface> create_device(bool) const override
+        {
+            return _dev;
+        }
+
+        platform::backend_device_group get_device_data() const override
+        {
+            return platform::backend_device_group({ platform::playback_device_info{ _dev->get_name() } });
+        }
+
+        std::shared_ptr<device_interface> create(std::shared_ptr<context>, bool) const override
+        {
+            return _dev;
+        }
+
+    private:
+        std::shared_ptr<shm_device> _dev;
+    };
+}
@@ -0,0 +1,168 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include "shm-publisher.h"
+#include "../net/net-description.h"
+#include "image.h"
+
+namespace librealsense
+{
+    bool shm_writer::acquire_slot(uint32_t& index)
+    {
+        auto&& header = _region->header();
+        for (uint32_t i = 0; i < shm::max_slots; ++i)
+        {
+            index = _next_slot.fetch_add(1) % shm::max_slots;
+            auto&& s = header.slots[index];
+
+            uint32_t free = 0;
+            if (!s.writing.compare_exchange_strong(free, 1))
+                continue;
+
+            // A process taking a hold after this check sees the slot written, and lets it go
+            auto held = false;
+            for (auto&& c : header.consumers)
+                held = held || c.holds[index].load() != 0;
+            if (held)
+            {
+                s.writing.store(0);
+                continue;
+            }
+
+            s.sequence.store(0);
+            return true;
+        }
+        return false;
+    }
+
+    void shm_writer::publish(uint32_t sensor, frame_interface& f)
+    {
+        net::frame_header frame;
+        std::vector<net::metadata_pair> metadata;
+        if (!net::describe_frame(f, sensor, frame, metadata))
+            return;
+
+        auto&& header = _region->header();
+        if (frame.data_size > header.slot_size)
+            return;
+
+        uint32_t index;
+        if (!acquire_slot(index))
+        {
+            shm::reclaim_consumers(header);
+            if (!acquire_slot(index))
+            {
+                LOG_DEBUG("Frame " << frame.frame_number << " left out of the shared memory, all slots are held");
+                return;
+            }
+        }
+
+        auto&& s = header.slots[index];
+        frame.metadata_count = std::min<uint32_t>(frame.metadata_count, shm::max_metadata);
+        s.frame = frame;
+        std::copy(metadata.begin(), metadata.begin() + frame.metadata_count, s.metadata);
+        memcpy(_region->get_slot_data(index), f.get_frame_data(), frame.data_size);
+
+        {
+            std::lock_guard<std::mutex> lock(_commit_mutex);
+            auto sequence = header.sequence.load() + 1;
+            s.sequence.store(sequence);
+            header.sequence.store(sequence);
+        }
+        s.writing.store(0);
+    }
+
+    shm_publisher::shm_publisher(std::shared_ptr<device_interface> dev, const std::string& name)
+        : _dev(std::move(dev))
+    {
+        auto description = net::describe(*_dev);
+        net::writer w;
+        net::write_description(w, description);
+
+        uint64_t slot_size = 0;
+        for (auto&& s : description.sensors)
+            for (auto&& p : s.profiles)
+                slot_size = std::max<uint64_t>(slot_size, static_cast<uint64_t>(p.width) * p.height * get_image_bpp(p.format) / 8);
+        slot_size = (slot_size + 4095) / 4096 * 4096;
+
+        auto data_offset = (sizeof(shm::region_header) + w.data().size() + 4095) / 4096 * 4096;
+        auto region = shm::region::create(name, data_offset + shm::max_slots * slot_size);
+
+        auto&& header = region->header();
+        header.version = shm::region_version;
+        header.slot_size = slot_size;
+        header.data_offset = data_offset;
+        header.description_size = static_cast<uint32_t>(w.data().size());
+        memcpy(const_cast<uint8_t*>(region->get_description()), w.data().data(), w.data().size());
+        header.publisher.store(shm::get_process_id());
+        // Attaching processes check the magic last
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        header.magic = shm::region_magic;
+
+        _writer = std::make_shared<shm_writer>(region);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _hooks.resize(_dev->get_sensors_count());
+        for (uint32_t i = 0; i < _hooks.size(); ++i)
+        {
+            auto&& sensor = _dev->get_sensor(i);
+            _hooks[i].token = sensor.register_before_streaming_changes_callback([this, i](bool streaming)
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (streaming)
+                    hook(i);
+                else
+                    unhook(i);
+            });
+
+            // Already streaming, so the callback above comes too late
+            if (sensor.is_streaming())
+                hook(i);
+        }
+    }
+
+    shm_publisher::~shm_publisher()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            for (uint32_t i = 0; i < _hooks.size(); ++i)
+            {
+                _dev->get_sensor(i).unregister_before_start_callback(_hooks[i].token);
+                unhook(i);
+            }
+        }
+        _writer->get_region().header().publisher.store(0);
+    }
+
+    void shm_publisher::hook(uint32_t index)
+    {
+        auto&& sensor = _dev->get_sensor(index);
+        auto original = sensor.get_frames_callback();
+        if (!original || original == _hooks[index].wrapper)
+            return;
+
+        auto writer = _writer;
+        auto on_frame = [writer, index, original](frame_holder f)
+        {
+            writer->publish(index, *f.frame);
+
+            frame_interface* ref = nullptr;
+            std::swap(f.frame, ref);
+            original->on_frame((rs2_frame*)ref);
+        };
+
+        _hooks[index].original = original;
+        _hooks[index].wrapper = { new internal_frame_callback<decltype(on_frame)>(on_frame),
+                                  [](rs2_frame_callback* p) { p->release(); } };
+        sensor.set_frames_callback(_hooks[index].wrapper);
+    }
+
+    void shm_publisher::unhook(uint32_t index)
+    {
+        auto&& hook = _hooks[index];
+        if (hook.wrapper && _dev->get_sensor(index).get_frames_callback() == hook.wrapper)
+            _dev->get_sensor(index).set_frames_callback(hook.original);
+        hook.original.reset();
+        hook.wrapper.reset();
+    }
+}
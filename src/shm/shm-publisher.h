@@ -0,0 +1,55 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "shm-region.h"
+#include "core/streaming.h"
+
+#include <mutex>
+
+namespace librealsense
+{
+    // Copies frames into the slots of a region. Shared by the frame callbacks it wraps, which may still run once the publisher is gone
+    class shm_writer
+    {
+    public:
+        explicit shm_writer(std::shared_ptr<shm::region> region) : _region(std::move(region)), _next_slot(0) {}
+
+        shm::region& get_region() const { return *_region; }
+        void publish(uint32_t sensor, frame_interface& f);
+
+    private:
+        bool acquire_slot(uint32_t& index);
+
+        std::shared_ptr<shm::region> _region;
+        std::mutex _commit_mutex;       // Frames are committed in the order of their sequence
+        std::atomic<uint32_t> _next_slot;
+    };
+
+    // Publishes the video frames the sensors of a device stream, whoever started them, into a shared memory region the other
+    // processes of the host attach to with shm_device. A frame that finds no free slot, as the attached processes hold them
+    // all, is left out of the region
+    class shm_publisher
+    {
+    public:
+        shm_publisher(std::shared_ptr<device_interface> dev, const std::string& name);
+        ~shm_publisher();
+
+    private:
+        struct sensor_hook
+        {
+            int token = -1;
+            frame_callback_ptr original;
+            frame_callback_ptr wrapper;
+        };
+
+        void hook(uint32_t index);
+        void unhook(uint32_t index);
+
+        std::shared_ptr<device_interface> _dev;
+        std::shared_ptr<shm_writer> _writer;
+        std::mutex _mutex;
+        std::vector<sensor_hook> _hooks;
+    };
+}
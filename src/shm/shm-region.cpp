@@ -0,0 +1,203 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include "shm-region.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+namespace librealsense
+{
+    namespace shm
+    {
+#ifdef _WIN32
+        static std::string get_system_name(const std::string& name) { return "Local\\librealsense-" + name; }
+#else
+        static std::string get_system_name(const std::string& name) { return "/librealsense-" + name; }
+#endif
+
+        static void validate_name(const std::string& name)
+        {
+            if (name.empty() || name.find_first_of("/\\") != std::string::npos)
+                throw invalid_value_exception(to_string() << "Invalid shared memory name \"" << name << "\"");
+        }
+
+        std::shared_ptr<region> region::open(const std::string& name)
+        {
+            validate_name(name);
+            std::shared_ptr<region> r(new region());
+            r->_name = get_system_name(name);
+
+#ifdef _WIN32
+            r->_mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, r->_name.c_str());
+            if (!r->_mapping)
+                throw io_exception(to_string() << "No device is published as \"" << name << "\"");
+            r->_data = MapViewOfFile(r->_mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+            if (!r->_data)
+                throw io_exception(to_string() << "Cannot map the shared memory \"" << name << "\", error " << GetLastError());
+            MEMORY_BASIC_INFORMATION info;
+            VirtualQuery(r->_data, &info, sizeof(info));
+            r->_size = info.RegionSize;
+#elif defined(__ANDROID__)
+            throw not_implemented_exception("Shared memory frame distribution is not supported on Android");
+#else
+            auto fd = shm_open(r->_name.c_str(), O_RDWR, 0);
+            if (fd < 0)
+                throw io_exception(to_string() << "No device is published as \"" << name << "\"");
+            struct stat st;
+            if (fstat(fd, &st) != 0)
+            {
+                ::close(fd);
+                throw io_exception(to_string() << "Cannot query the shared memory \"" << name << "\", " << strerror(errno));
+            }
+            r->_size = static_cast<size_t>(st.st_size);
+            auto data = mmap(nullptr, r->_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            ::close(fd);
+            if (data == MAP_FAILED)
+                throw io_exception(to_string() << "Cannot map the shared memory \"" << name << "\", " << strerror(errno));
+            r->_data = data;
+#endif
+
+            if (r->_size < sizeof(region_header) || r->header().magic != region_magic)
+                throw io_exception(to_string() << "The shared memory \"" << name << "\" is not a published device");
+            if (r->header().version != region_version)
+                throw io_exception(to_string() << "The shared memory \"" << name << "\" is of version " << r->header().version
+                                               << ", version " << region_version << " is supported");
+            if (r->header().data_offset + max_slots * r->header().slot_size > r->_size)
+                throw io_exception(to_string() << "The shared memory \"" << name << "\" is truncated");
+            return r;
+        }
+
+        std::shared_ptr<region> region::create(const std::string& name, size_t size)
+        {
+            validate_name(name);
+            try
+            {
+                auto existing = open(name);
+                auto publisher = existing->header().publisher.load();
+                if (publisher && is_process_alive(publisher))
+                    throw invalid_value_exception(to_string() << "A device is already published as \"" << name << "\"");
+            }
+            catch (const io_exception&)
+            {
+                // None, or one we replace
+            }
+
+            std::shared_ptr<region> r(new region());
+            r->_name = get_system_name(name);
+            r->_size = size;
+            r->_owner = true;
+
+#ifdef _WIN32
+            r->_mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                             static_cast<DWORD>(static_cast<uint64_t>(size) >> 32), static_cast<DWORD>(size & 0xFFFFFFFF),
+                                             r->_name.c_str());
+            if (!r->_mapping)
+                throw io_exception(to_string() << "Cannot create the shared memory \"" << name << "\", error " << GetLastError());
+            r->_data = MapViewOfFile(r->_mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+            if (!r->_data)
+                throw io_exception(to_string() << "Cannot map the shared memory \"" << name << "\", error " << GetLastError());
+            memset(r->_data, 0, sizeof(region_header));
+#elif defined(__ANDROID__)
+            throw not_implemented_exception("Shared memory frame distribution is not supported on Android");
+#else
+            // The attached processes of a previous publisher keep their mapping of the unlinked region. Only the processes of the
+            // user publishing the device may attach to it, as any of them can write the region
+            shm_unlink(r->_name.c_str());
+            auto fd = shm_open(r->_name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+            if (fd < 0)
+                throw io_exception(to_string() << "Cannot create the shared memory \"" << name << "\", " << strerror(errno));
+            if (ftruncate(fd, static_cast<off_t>(size)) != 0)
+            {
+                auto error = strerror(errno);
+                ::close(fd);
+                shm_unlink(r->_name.c_str());
+                throw io_exception(to_string() << "Cannot size the shared memory \"" << name << "\", " << error);
+            }
+            auto data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            ::close(fd);
+            if (data == MAP_FAILED)
+            {
+                shm_unlink(r->_name.c_str());
+                throw io_exception(to_string() << "Cannot map the shared memory \"" << name << "\", " << strerror(errno));
+            }
+            r->_data = data;
+#endif
+            return r;
+        }
+
+        region::~region()
+        {
+#ifdef _WIN32
+            if (_data)
+                UnmapViewOfFile(_data);
+            if (_mapping)
+                CloseHandle(_mapping);
+#elif !defined(__ANDROID__)
+            if (_data)
+                munmap(_data, _size);
+            if (_owner)
+                shm_unlink(_name.c_str());
+#endif
+        }
+
+        uint8_t* region::get_slot_data(uint32_t index) const
+        {
+            return static_cast<uint8_t*>(_data) + header().data_offset + index * header().slot_size;
+        }
+
+        bool is_valid_frame(const region_header& header, const net::frame_header& frame)
+        {
+            auto row = (static_cast<uint64_t>(frame.width) * frame.bpp + 7) / 8;
+            auto size = static_cast<uint64_t>(frame.stride) * frame.height;
+            return frame.bpp && frame.stride >= row && size <= header.slot_size && frame.data_size <= size;
+        }
+
+        uint32_t get_process_id()
+        {
+#ifdef _WIN32
+            return static_cast<uint32_t>(GetCurrentProcessId());
+#else
+            return static_cast<uint32_t>(getpid());
+#endif
+        }
+
+        bool is_process_alive(uint32_t process)
+        {
+#ifdef _WIN32
+            auto h = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, process);
+            if (!h)
+                return GetLastError() == ERROR_ACCESS_DENIED;
+            DWORD code = 0;
+            auto alive = GetExitCodeProcess(h, &code) && code == STILL_ACTIVE;
+            CloseHandle(h);
+            return alive;
+#else
+            return kill(static_cast<pid_t>(process), 0) == 0 || errno == EPERM;
+#endif
+        }
+
+        void reclaim_consumers(region_header& header)
+        {
+            for (auto&& c : header.consumers)
+            {
+                auto process = c.process.load();
+                if (!process || is_process_alive(process))
+                    continue;
+
+                LOG_WARNING("Reclaiming the frames of the exited process " << process);
+                for (auto&& h : c.holds)
+                    h.store(0);
+                c.process.compare_exchange_strong(process, 0);
+            }
+        }
+    }
+}
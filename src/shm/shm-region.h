@@ -0,0 +1,93 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "../net/net-protocol.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+namespace librealsense
+{
+    // Distribution of the frames of a device to the other processes of the host. The process streaming the device copies
+    // every frame into a free slot of a named shared memory region, and the attached processes hand out the slot data itself
+    // as their frames. Each attached process counts the frames it holds per slot in its own entry of the region, and the
+    // publisher only reuses a slot none of them holds, after reclaiming the entries of the processes that exited.
+    // The region is readable and writable by the processes of the user who published it only
+    namespace shm
+    {
+        const uint32_t region_magic = 0x4D485352;  // "RSHM"
+        const uint32_t region_version = 1;
+        const uint32_t max_slots = 16;
+        const uint32_t max_consumers = 8;
+        const uint32_t max_metadata = 32;
+
+        static_assert(ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2,
+                      "Shared memory counters require address-free atomics");
+
+        struct slot
+        {
+            std::atomic<uint64_t> sequence;     // Of the frame the slot holds, 0 while it is written
+            std::atomic<uint32_t> writing;
+            net::frame_header frame;
+            net::metadata_pair metadata[max_metadata];
+        };
+
+        struct consumer
+        {
+            std::atomic<uint32_t> process;      // Id of the attached process, 0 for a free entry
+            std::atomic<uint32_t> holds[max_slots];
+        };
+
+        struct region_header
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint64_t slot_size;                 // Capacity of the data of a slot
+            uint64_t data_offset;               // Of the data of the first slot
+            uint32_t description_size;          // Device description, right after the header
+            std::atomic<uint32_t> publisher;    // Id of the publishing process, 0 once it stopped
+            std::atomic<uint64_t> sequence;     // Of the last published frame
+            consumer consumers[max_consumers];
+            slot slots[max_slots];
+        };
+
+        // Named shared memory mapped into the process, unmapped on destruction
+        class region
+        {
+        public:
+            // Replaces a region of the same name left by a publisher that exited
+            static std::shared_ptr<region> create(const std::string& name, size_t size);
+            static std::shared_ptr<region> open(const std::string& name);
+            ~region();
+
+            region_header& header() const { return *static_cast<region_header*>(_data); }
+            uint8_t* get_slot_data(uint32_t index) const;
+            const uint8_t* get_description() const { return static_cast<uint8_t*>(_data) + sizeof(region_header); }
+
+        private:
+            region() = default;
+            region(const region&) = delete;
+            region& operator=(const region&) = delete;
+
+            std::string _name;
+            void* _data = nullptr;
+            size_t _size = 0;
+            bool _owner = false;
+#ifdef _WIN32
+            void* _mapping = nullptr;
+#endif
+        };
+
+        // Whether the frame of a slot, as any process of the user may have written it, lies within the data of the slot
+        bool is_valid_frame(const region_header& header, const net::frame_header& frame);
+
+        uint32_t get_process_id();
+        bool is_process_alive(uint32_t process);
+
+        // Frees the entries of the attached processes that exited, along with the slots they held
+        void reclaim_consumers(region_header& header);
+    }
+}
@@ -38,7 +38,19 @@ namespace librealsense
     software_sensor::software_sensor(std::string name, software_device* owner)
         : sensor_base(name, owner)
     {
+        // The frames wrap the memory of the application, so their number is not limited unless the application limits it
+        _source.get_published_size_option()->set(0);
         _metadata_parsers = md_constant_parser::create_metadata_parser_map();
+        // The delivery stages are stamped by the library, whatever the metadata of the frames
+        _metadata_parsers->set(RS2_FRAME_METADATA_DEQUEUE_TIME, std::make_shared<md_stage_time_parser>(frame_stage::dequeue));
+        _metadata_parsers->set(RS2_FRAME_METADATA_UNPACK_TIME, std::make_shared<md_stage_time_parser>(frame_stage::unpack));
+        _metadata_parsers->set(RS2_FRAME_METADATA_SYNC_TIME, std::make_shared<md_stage_time_parser>(frame_stage::sync));
+        _metadata_parsers->set(RS2_FRAME_METADATA_CALLBACK_TIME, std::make_shared<md_stage_time_parser>(frame_stage::callback));
+        _metadata_parsers->set(RS2_FRAME_METADATA_DEPTH_MIN, std::make_shared<md_depth_statistics_parser>(RS2_FRAME_METADATA_DEPTH_MIN));
+        _metadata_parsers->set(RS2_FRAME_METADATA_DEPTH_MAX, std::make_shared<md_depth_statistics_parser>(RS2_FRAME_METADATA_DEPTH_MAX));
+        _metadata_parsers->set(RS2_FRAME_METADATA_DEPTH_MEAN, std::make_shared<md_depth_statistics_parser>(RS2_FRAME_METADATA_DEPTH_MEAN));
+        _metadata_parsers->set(RS2_FRAME_METADATA_DEPTH_FILL_RATE, std::make_shared<md_depth_statistics_parser>(RS2_FRAME_METADATA_DEPTH_FILL_RATE));
+        _metadata_parsers->set(RS2_FRAME_METADATA_DEPTH_HISTOGRAM, std::make_shared<md_depth_statistics_parser>(RS2_FRAME_METADATA_DEPTH_HISTOGRAM));
     }
 
     std::shared_ptr<matcher> software_device::create_matcher(const frame_holder& frame) const
@@ -114,9 +126,12 @@ namespace librealsense
             throw wrong_api_call_sequence_exception("start_streaming(...) failed. Software device is already streaming!");
         else if (!_is_opened)
             throw wrong_api_call_sequence_exception("start_streaming(...) failed. Software device was not opened!");
-        _source.get_published_size_option()->set(0);
-        _source.init(_metadata_parsers);
+        _source.init(_metadata_parsers, get_frame_allocator(), get_preallocation());
         _source.set_sensor(this->shared_from_this());
+        // The frames wrap the memory of the application, only their objects are preallocated
+        for (auto&& profile : get_active_streams())
+            _source.reserve_frames(profile->get_stream_type() == RS2_STREAM_DEPTH ? RS2_EXTENSION_DEPTH_FRAME : RS2_EXTENSION_VIDEO_FRAME,
+                0, RS2_FRAME_POOL_PREWARM);
         _source.set_callback(callback);
         _is_streaming = true;
         raise_on_before_streaming_changes(true);
@@ -137,29 +152,30 @@ namespace librealsense
     void software_sensor::set_metadata(rs2_frame_metadata_value key, rs2_metadata_type value)
     {
         _metadata_map[key] = value;
-    }
-
-    void software_sensor::on_video_frame(rs2_software_video_frame software_frame)
-    {
-        frame_additional_data data;
-        data.timestamp = software_frame.timestamp;
-        data.timestamp_domain = software_frame.domain;
-        data.frame_number = software_frame.frame_number;
 
-        data.metadata_size = 0;
+        _metadata.metadata_blob.clear();
         for (auto i : _metadata_map)
         {
             auto size_of_enum = sizeof(rs2_frame_metadata_value);
             auto size_of_data = sizeof(rs2_metadata_type);
-            if (data.metadata_size + size_of_enum + size_of_data > 255)
+            if (_metadata.metadata_blob.size() + size_of_enum + size_of_data > 255)
             {
                 continue; //stop adding metadata to frame
             }
-            memcpy(data.metadata_blob.data() + data.metadata_size, &i.first, size_of_enum);
-            data.metadata_size += static_cast<uint32_t>(size_of_enum);
-            memcpy(data.metadata_blob.data() + data.metadata_size, &i.second, size_of_data);
-            data.metadata_size += static_cast<uint32_t>(size_of_data);
+            _metadata.metadata_blob.append(&i.first, size_of_enum);
+            _metadata.metadata_blob.append(&i.second, size_of_data);
         }
+    }
+
+    void software_sensor::on_video_frame(rs2_software_video_frame software_frame)
+    {
+        // The metadata blob is laid out once per change of the metadata, not per frame
+        frame_additional_data data = _metadata;
+        data.timestamp = software_frame.timestamp;
+        data.timestamp_domain = software_frame.domain;
+        data.frame_number = software_frame.frame_number;
+        data.priority = _source.get_stream_priority(software_frame.profile->profile->get_stream_type(),
+            software_frame.profile->profile->get_stream_index());
 
         rs2_extension extension = software_frame.profile->profile->get_stream_type() == RS2_STREAM_DEPTH ?
             RS2_EXTENSION_DEPTH_FRAME : RS2_EXTENSION_VIDEO_FRAME;
@@ -167,6 +183,8 @@ namespace librealsense
         auto frame = _source.alloc_frame(extension, 0, data, false);
         if (!frame)
         {
+            // The pixels are let go all the same, the caller handed them over
+            software_frame.deleter(software_frame.pixels);
             return;
         }
         auto vid_profile = dynamic_cast<video_stream_profile_interface*>(software_frame.profile->profile);
@@ -180,6 +198,12 @@ namespace librealsense
         _source.invoke_callback(frame);
     }
 
+    void software_sensor::on_video_frames(const rs2_software_video_frame* frames, int count)
+    {
+        for (int i = 0; i < count; i++)
+            on_video_frame(frames[i]);
+    }
+
     void software_sensor::add_read_only_option(rs2_option option, float val)
     {
         register_option(option, std::make_shared<const_value_option>("bypass sensor read only option",
@@ -52,6 +52,7 @@ namespace librealsense
         void stop() override;
 
         void on_video_frame(rs2_software_video_frame frame);
+        void on_video_frames(const rs2_software_video_frame* frames, int count);
         void add_read_only_option(rs2_option option, float val);
         void update_read_only_option(rs2_option option, float val);
         void set_metadata(rs2_frame_metadata_value key, rs2_metadata_type value);
@@ -59,6 +60,7 @@ namespace librealsense
         friend class software_device;
         stream_profiles _profiles;
         std::map<rs2_frame_metadata_value, rs2_metadata_type> _metadata_map;
+        frame_additional_data _metadata;    // The blob of _metadata_map, copied into every frame
 
     };
     MAP_EXTENSION(RS2_EXTENSION_SOFTWARE_SENSOR, software_sensor);
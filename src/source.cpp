@@ -4,9 +4,181 @@
 #include "source.h"
 #include "option.h"
 #include "environment.h"
+#include "trace.h"
+
+#include <algorithm>
+#include <deque>
+#include <set>
 
 namespace librealsense
 {
+    // Threads delivering the frames of a source to its callback at once. Ordered, the frames of a stream are delivered
+    // one at a time in the order they came, while those of the other streams go on meanwhile
+    class frame_source::callback_workers
+    {
+    public:
+        callback_workers(uint32_t threads, std::function<void(frame_holder)> deliver)
+            : _state(std::make_shared<state>())
+        {
+            _state->deliver = std::move(deliver);
+            for (uint32_t i = 0; i < threads; i++)
+            {
+                // The threads share the state, for one of them to outlive the workers when they are destroyed from its callback
+                auto shared = _state;
+                _threads.emplace_back([shared]()
+                {
+                    librealsense::apply_thread_policy(RS2_THREAD_ROLE_DISPATCH);
+                    work(*shared);
+                });
+            }
+        }
+
+        // The frames already queued are delivered before the threads are joined. Destroyed from a callback, the queued frames
+        // are dropped instead, the other threads joined and the calling one detached, for it to return from the callback
+        ~callback_workers()
+        {
+            std::deque<item> dropped;
+            auto self = is_worker();
+            {
+                std::lock_guard<std::mutex> lock(_state->mutex);
+                _state->alive = false;
+                if (self)
+                    dropped.swap(_state->queue);
+            }
+            _state->ready.notify_all();
+            auto id = std::this_thread::get_id();
+            for (auto&& t : _threads)
+            {
+                if (t.get_id() == id)
+                    t.detach();
+                else
+                    t.join();
+            }
+        }
+
+        uint32_t size() const { return static_cast<uint32_t>(_threads.size()); }
+
+        void push(frame_holder frame, bool ordered)
+        {
+            auto&& stream = frame->get_stream();
+            auto key = stream ? std::make_pair(stream->get_stream_type(), stream->get_stream_index()) : std::make_pair(RS2_STREAM_ANY, -1);
+            {
+                std::lock_guard<std::mutex> lock(_state->mutex);
+                _state->queue.push_back({ key, ordered, std::move(frame) });
+            }
+            _state->ready.notify_one();
+        }
+
+        void drop_and_wait()
+        {
+            std::deque<item> dropped;
+            std::unique_lock<std::mutex> lock(_state->mutex);
+            dropped.swap(_state->queue);
+            // A callback stopping its own sensor does not wait for itself
+            auto self = is_worker() ? 1 : 0;
+            _state->idle.wait(lock, [&]() { return _state->running <= self; });
+            lock.unlock();
+            // The frames are released with the mutex let go, for their archives to take it back as they please
+        }
+
+    private:
+        struct item
+        {
+            std::pair<rs2_stream, int> key;
+            bool ordered;
+            frame_holder frame;
+        };
+
+        struct state
+        {
+            std::function<void(frame_holder)> deliver;
+            std::mutex mutex;
+            std::condition_variable ready;
+            std::condition_variable idle;
+            std::deque<item> queue;
+            std::set<std::pair<rs2_stream, int>> busy;
+            int running = 0;
+            bool alive = true;
+        };
+
+        bool is_worker() const
+        {
+            auto id = std::this_thread::get_id();
+            return std::any_of(_threads.begin(), _threads.end(), [&](const std::thread& t) { return t.get_id() == id; });
+        }
+
+        // The oldest frame whose stream is not being delivered, of the ordered ones
+        static bool take(state& s, item& next)
+        {
+            for (auto it = s.queue.begin(); it != s.queue.end(); ++it)
+            {
+                if (it->ordered && s.busy.count(it->key))
+                    continue;
+                next = std::move(*it);
+                s.queue.erase(it);
+                return true;
+            }
+            return false;
+        }
+
+        static void work(state& s)
+        {
+            std::unique_lock<std::mutex> lock(s.mutex);
+            while (true)
+            {
+                item next;
+                s.ready.wait(lock, [&]() { return take(s, next) || (!s.alive && s.queue.empty()); });
+                if (!next.frame)
+                    return;
+
+                if (next.ordered)
+                    s.busy.insert(next.key);
+                s.running++;
+                lock.unlock();
+                s.deliver(std::move(next.frame));
+                lock.lock();
+                if (next.ordered)
+                    s.busy.erase(next.key);
+                s.running--;
+
+                // Another frame of the stream may be waiting for this one
+                s.ready.notify_all();
+                s.idle.notify_all();
+            }
+        }
+
+        std::shared_ptr<state> _state;
+        std::vector<std::thread> _threads;
+    };
+
+    class callback_option : public option_base
+    {
+    public:
+        callback_option(std::atomic<uint32_t>* ptr, const option_range& opt_range, const char* description)
+            : option_base(opt_range),
+              _ptr(ptr), _description(description)
+        {}
+
+        void set(float value) override
+        {
+            if (!is_valid(value))
+                throw invalid_value_exception(to_string() << "set(" << _description << ") failed! Given value " << value << " is out of range.");
+
+            *_ptr = static_cast<uint32_t>(value);
+            _recording_function(*this);
+        }
+
+        float query() const override { return static_cast<float>(_ptr->load()); }
+
+        bool is_enabled() const override { return true; }
+
+        const char* get_description() const override { return _description; }
+
+    private:
+        std::atomic<uint32_t>* _ptr;
+        const char* _description;
+    };
+
     class frame_queue_size : public option_base
     {
     public:
@@ -36,18 +208,79 @@ namespace librealsense
         std::atomic<uint32_t>* _ptr;
     };
 
+    class frame_memory_budget : public option_base
+    {
+    public:
+        frame_memory_budget(std::atomic<uint32_t>* ptr, const option_range& opt_range)
+            : option_base(opt_range),
+              _ptr(ptr)
+        {}
+
+        void set(float value) override
+        {
+            if (!is_valid(value))
+                throw invalid_value_exception(to_string() << "set(frame_memory_budget) failed! Given value " << value << " is out of range.");
+
+            *_ptr = static_cast<uint32_t>(value);
+            _recording_function(*this);
+        }
+
+        float query() const override { return static_cast<float>(_ptr->load()); }
+
+        bool is_enabled() const override { return true; }
+
+        const char* get_description() const override
+        {
+            return "Max memory (in MB) the frames you hold at a given time may occupy, 0 for unlimited. Frames exceeding the budget are dropped";
+        }
+    private:
+        std::atomic<uint32_t>* _ptr;
+    };
+
     std::shared_ptr<option> frame_source::get_published_size_option()
     {
-        return std::make_shared<frame_queue_size>(&_max_publish_list_size, option_range{ 0, 32, 1, 16 });
+        return std::make_shared<frame_queue_size>(&_max_publish_list_size, option_range{ 0, RS2_USER_QUEUE_SIZE, 1, 16 });
+    }
+
+    std::shared_ptr<option> frame_source::get_published_memory_option()
+    {
+        return std::make_shared<frame_memory_budget>(&_max_publish_memory, option_range{ 0, 4096, 1, 0 });
+    }
+
+    std::shared_ptr<option> frame_source::get_callback_threads_option()
+    {
+        return std::make_shared<callback_option>(&_callback_threads, option_range{ 1, RS2_MAX_CALLBACK_THREADS, 1, 1 },
+            "Number of threads the frame callback may be invoked on at once. Above one, the callback must be thread-safe");
+    }
+
+    std::shared_ptr<option> frame_source::get_ordered_callbacks_option()
+    {
+        return std::make_shared<callback_option>(&_ordered_callbacks, option_range{ 0, 1, 1, 1 },
+            "With more callback threads than one, deliver the frames of a stream one at a time and in order");
     }
 
     frame_source::frame_source(uint32_t max_publish_list_size)
             : _callback(nullptr, [](rs2_frame_callback*) {}),
               _max_publish_list_size(max_publish_list_size),
-              _ts(environment::get_instance().get_time_service())
+              _max_publish_memory(0),
+              _highest_priority(std::numeric_limits<int>::min()),
+              _has_priorities(false),
+              _frames_received(0),
+              _frames_delivered(0),
+              _ts(environment::get_instance().get_time_service()),
+              _callback_threads(1),
+              _ordered_callbacks(1)
     {}
 
-    void frame_source::init(std::shared_ptr<metadata_parser_map> metadata_parsers)
+    frame_source::~frame_source()
+    {
+        flush();
+        std::lock_guard<std::mutex> lock(_workers_mutex);
+        _workers.reset();
+    }
+
+    void frame_source::init(std::shared_ptr<metadata_parser_map> metadata_parsers, std::shared_ptr<const frame_allocator> allocator,
+        preallocation_mode preallocation)
     {
         std::lock_guard<std::mutex> lock(_callback_mutex);
 
@@ -61,8 +294,11 @@ namespace librealsense
 
         for (auto type : supported)
         {
-            _archive[type] = make_archive(type, &_max_publish_list_size, _ts, metadata_parsers);
+            _archive[type] = make_archive(type, &_max_publish_list_size, &_max_publish_memory, &_highest_priority, _ts, metadata_parsers, allocator, preallocation);
         }
+        _highest_priority = std::numeric_limits<int>::min();
+        _frames_received = 0;
+        _frames_delivered = 0;
     }
 
     callback_invocation_holder frame_source::begin_callback()
@@ -73,6 +309,7 @@ namespace librealsense
 
     void frame_source::reset()
     {
+        stop_callbacks();
         std::lock_guard<std::mutex> lock(_callback_mutex);
         _callback.reset();
         for (auto&& kvp : _archive)
@@ -83,11 +320,33 @@ namespace librealsense
 
     frame_interface* frame_source::alloc_frame(rs2_extension type, size_t size, frame_additional_data additional_data, bool requires_memory) const
     {
+        trace_scope scope("publish", "frame", additional_data.frame_number);
         auto it = _archive.find(type);
         if (it == _archive.end()) throw wrong_api_call_sequence_exception("Requested frame type is not supported!");
+        _frames_received.fetch_add(1, std::memory_order_relaxed);
+        raise_to(_highest_priority, additional_data.priority);
         return it->second->alloc_and_track(size, additional_data, requires_memory);
     }
 
+    void frame_source::reserve_frames(rs2_extension type, size_t size, uint32_t count) const
+    {
+        auto it = _archive.find(type);
+        if (it == _archive.end()) throw wrong_api_call_sequence_exception("Requested frame type is not supported!");
+        it->second->reserve_frames(size, count);
+    }
+
+    rs2_frame_memory_stats frame_source::get_memory_stats() const
+    {
+        std::lock_guard<std::mutex> lock(_callback_mutex);
+
+        rs2_frame_memory_stats stats{};
+        for (auto&& kvp : _archive)
+        {
+            if (kvp.second) kvp.second->get_memory_stats(stats);
+        }
+        return stats;
+    }
+
     void frame_source::set_sensor(std::shared_ptr<sensor_interface> s)
     {
         for (auto&& a : _archive)
@@ -109,14 +368,54 @@ namespace librealsense
     }
     void frame_source::invoke_callback(frame_holder frame) const
     {
-        if (frame)
+        if (!frame)
+            return;
+
+        auto threads = _callback_threads.load();
+        if (threads > 1)
+        {
+            std::shared_ptr<callback_workers> workers;
+            {
+                std::lock_guard<std::mutex> lock(_workers_mutex);
+                if (!_workers || _workers->size() != threads)
+                    _workers = std::make_shared<callback_workers>(threads, [this](frame_holder f) { deliver(std::move(f)); });
+                workers = _workers;
+            }
+            workers->push(std::move(frame), _ordered_callbacks != 0);
+            return;
+        }
+        deliver(std::move(frame));
+    }
+
+    void frame_source::stop_callbacks() const
+    {
+        std::shared_ptr<callback_workers> workers;
+        {
+            std::lock_guard<std::mutex> lock(_workers_mutex);
+            workers = _workers;
+        }
+        if (workers)
+            workers->drop_and_wait();
+    }
+
+    void frame_source::deliver(frame_holder frame) const
+    {
         {
             auto callback = frame.frame->get_owner()->begin_callback();
+            trace_scope scope("callback", "frame", frame->get_frame_number());
             try
             {
                 frame->log_callback_start(_ts ? _ts->get_time() : 0);
+                frame->set_stage_time(frame_stage::callback, platform::monotonic_time());
+                // For the sensors that do not stamp the priority as they allocate their frames
+                if (_has_priorities && frame->get_stream())
+                {
+                    auto&& stream = frame->get_stream();
+                    frame->set_priority(get_stream_priority(stream->get_stream_type(), stream->get_stream_index()));
+                }
                 if (_callback)
                 {
+                    _frames_delivered.fetch_add(1, std::memory_order_relaxed);
                     frame_interface* ref = nullptr;
                     std::swap(frame.frame, ref);
                     _callback->on_frame((rs2_frame*)ref);
@@ -129,8 +428,28 @@ namespace librealsense
         }
     }
 
+    void frame_source::set_stream_priority(rs2_stream stream, int index, int priority)
+    {
+        std::lock_guard<std::mutex> lock(_priorities_mutex);
+        _priorities[{ stream, index }] = priority;
+        _has_priorities = true;
+    }
+
+    int frame_source::get_stream_priority(rs2_stream stream, int index) const
+    {
+        if (!_has_priorities)
+            return 0;
+
+        std::lock_guard<std::mutex> lock(_priorities_mutex);
+        auto it = _priorities.find({ stream, index });
+        if (it == _priorities.end())
+            it = _priorities.find({ stream, -1 });
+        return it != _priorities.end() ? it->second : 0;
+    }
+
     void frame_source::flush() const
     {
+        stop_callbacks();
         for (auto&& kvp : _archive)
         {
             if (kvp.second)
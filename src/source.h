@@ -17,38 +17,74 @@ namespace librealsense
     public:
         frame_source(uint32_t max_publish_list_size = 16);
 
-        void init(std::shared_ptr<metadata_parser_map> metadata_parsers);
+        void init(std::shared_ptr<metadata_parser_map> metadata_parsers, std::shared_ptr<const frame_allocator> allocator = nullptr,
+            preallocation_mode preallocation = preallocation_mode::off);
 
         callback_invocation_holder begin_callback();
 
         void reset();
 
         std::shared_ptr<option> get_published_size_option();
+        std::shared_ptr<option> get_published_memory_option();
+        std::shared_ptr<option> get_callback_threads_option();
+        std::shared_ptr<option> get_ordered_callbacks_option();
 
         frame_interface* alloc_frame(rs2_extension type, size_t size, frame_additional_data additional_data, bool requires_memory) const;
 
+        void reserve_frames(rs2_extension type, size_t size, uint32_t count) const;
+
+        rs2_frame_memory_stats get_memory_stats() const;
+
+        // Counted since the source was last initialized
+        unsigned long long get_frames_received() const { return _frames_received.load(std::memory_order_relaxed); }
+        unsigned long long get_frames_delivered() const { return _frames_delivered.load(std::memory_order_relaxed); }
+
         void set_callback(frame_callback_ptr callback);
         frame_callback_ptr get_callback() const;
 
+        // On the calling thread, or on the callback threads of the source when there are more than one
         void invoke_callback(frame_holder frame) const;
 
+        // Drops the frames waiting for a callback thread and waits for the callbacks running, for no callback to follow the
+        // stop of the sensor. Called once the sensor stopped invoking callbacks
+        void stop_callbacks() const;
+
         void flush() const;
 
-        virtual ~frame_source() { flush(); }
+        virtual ~frame_source();
 
         double get_time() const { return _ts ? _ts->get_time() : 0; }
 
         void set_sensor(std::shared_ptr<sensor_interface> s);
 
+        // Of the frames of a stream, index -1 for every stream of the type. Streams are of priority 0 unless set otherwise
+        void set_stream_priority(rs2_stream stream, int index, int priority);
+        int get_stream_priority(rs2_stream stream, int index) const;
+
     private:
         friend class syncer_process_unit;
+        class callback_workers;
+
+        void deliver(frame_holder frame) const;
 
         mutable std::mutex _callback_mutex;
 
         std::map<rs2_extension, std::shared_ptr<archive_interface>> _archive;
 
         std::atomic<uint32_t> _max_publish_list_size;
+        std::atomic<uint32_t> _max_publish_memory;
+        mutable std::atomic<int> _highest_priority;     // Of the frames allocated, the archives giving those below it half their budgets
+        mutable std::mutex _priorities_mutex;
+        std::map<std::pair<rs2_stream, int>, int> _priorities;
+        std::atomic<bool> _has_priorities;
+        mutable std::atomic<unsigned long long> _frames_received;
+        mutable std::atomic<unsigned long long> _frames_delivered;
         frame_callback_ptr _callback;
         std::shared_ptr<platform::time_service> _ts;
+
+        std::atomic<uint32_t> _callback_threads;
+        std::atomic<uint32_t> _ordered_callbacks;
+        mutable std::mutex _workers_mutex;
+        mutable std::shared_ptr<callback_workers> _workers;  // Started by the first frame once there are more threads than one
     };
 }
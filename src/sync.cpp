@@ -3,7 +3,7 @@
 
 #include "proc/synthetic-stream.h"
 #include "sync.h"
-#include "environment.h"
+#include "backend.h"
 
 namespace librealsense
 {
@@ -28,6 +28,15 @@ namespace librealsense
         return s.str();
     }
 
+    template<class T>
+    std::string list_to_string(const std::vector<T>& items)
+    {
+        std::stringstream s;
+        for (auto&& item : items)
+            s << item << " ";
+        return s.str();
+    }
+
     matcher::matcher(std::vector<stream_id> streams_id)
         : _streams_id(streams_id){}
 
@@ -114,10 +123,46 @@ namespace librealsense
         return s.str();
     }
 
+    bool frame_ring::push(frame_holder&& f, double arrival, size_t limit)
+    {
+        limit = std::min(std::max<size_t>(limit, 1), _frames.size());
+        auto room = _size < limit;
+        while (_size >= limit)
+        {
+            _frames[_head] = frame_holder();
+            _head = (_head + 1) % _frames.size();
+            --_size;
+        }
+        auto tail = (_head + _size) % _frames.size();
+        _frames[tail] = std::move(f);
+        _arrivals[tail] = arrival;
+        ++_size;
+        return room;
+    }
+
+    bool frame_ring::pop(frame_holder* f)
+    {
+        if (!_size)
+            return false;
+        *f = std::move(_frames[_head]);
+        _head = (_head + 1) % _frames.size();
+        --_size;
+        return true;
+    }
+
+    void frame_ring::clear()
+    {
+        frame_holder f;
+        while (pop(&f))
+            f = frame_holder();
+        _head = 0;
+    }
+
     composite_matcher::composite_matcher(std::vector<std::shared_ptr<matcher>> matchers, std::string name)
     {
         for (auto&& matcher : matchers)
         {
+            add_slot(matcher.get());
             for (auto&& stream : matcher->get_streams())
             {
                 matcher->set_callback([&](frame_holder f, syncronization_environment env)
@@ -136,11 +181,108 @@ namespace librealsense
         _name = create_composite_name(matchers, name);
     }
 
+    void composite_matcher::add_slot(matcher* m)
+    {
+        m->set_slot(int(_slots.size()));
+        _slots.push_back({ m, false, frame_ring(), 0., false, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 0., 0, {} });
+    }
+
+    void composite_matcher::set_latency_budget(double ms)
+    {
+        _latency_budget = ms;
+        for (auto&& slot : _slots)
+        {
+            auto composite = dynamic_cast<composite_matcher*>(slot.owner);
+            if (composite)
+                composite->set_latency_budget(ms);
+        }
+    }
+
+    unsigned long long composite_matcher::get_incomplete_framesets(stream_id stream) const
+    {
+        auto it = _incomplete_framesets.find(stream);
+        auto count = it != _incomplete_framesets.end() ? it->second : 0;
+        for (auto&& slot : _slots)
+        {
+            auto composite = dynamic_cast<const composite_matcher*>(slot.owner);
+            if (composite)
+                count += composite->get_incomplete_framesets(stream);
+        }
+        return count;
+    }
+
+    void composite_matcher::get_totals(rs2_sync_stream_stats* totals, unsigned long long* queued) const
+    {
+        for (auto&& slot : _slots)
+        {
+            // The framesets of nested matchers are dropped here too, while their frames are counted by the nested matchers
+            *queued += slot.frames.size();
+            totals->overflowed += slot.stats.overflowed;
+            totals->dropped += slot.stats.dropped;
+            if (auto composite = dynamic_cast<const composite_matcher*>(slot.owner))
+            {
+                composite->get_totals(totals, queued);
+            }
+            else
+            {
+                totals->enqueued += slot.stats.enqueued;
+                totals->matched += slot.stats.matched;
+                totals->skipped += slot.stats.skipped;
+            }
+        }
+    }
+
+    bool composite_matcher::get_stream_stats(stream_id stream, rs2_sync_stream_stats* stats) const
+    {
+        for (auto&& slot : _slots)
+        {
+            auto composite = dynamic_cast<const composite_matcher*>(slot.owner);
+            if (composite)
+            {
+                if (composite->get_stream_stats(stream, stats))
+                    return true;
+            }
+            else
+            {
+                auto&& streams = slot.owner->get_streams();
+                if (std::find(streams.begin(), streams.end(), stream) != streams.end())
+                {
+                    *stats = slot.stats;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    bool composite_matcher::out_of_budget(const std::vector<librealsense::matcher*>& synced, double now) const
+    {
+        if (_latency_budget <= 0)
+            return false;
+
+        // The frameset is as old as the first of its frames to arrive
+        auto first = now;
+        for (auto m : synced)
+            first = std::min(first, _slots[m->get_slot()].frames.front_arrival());
+        return now - first >= _latency_budget;
+    }
+
+    void composite_matcher::queue_frames(matcher* m)
+    {
+        slot_of(m).queued = true;
+    }
+
+    void composite_matcher::drop_frames(matcher* m, bool queued)
+    {
+        auto& slot = slot_of(m);
+        slot.stats.dropped += slot.frames.size();
+        slot.frames.clear();
+        slot.queued = queued;
+    }
+
     void composite_matcher::dispatch(frame_holder f, syncronization_environment env)
     {
-        std::stringstream s;
-        s <<"DISPATCH "<<_name<<"--> "<< frame_to_string(f) <<"\n";
-        LOG_DEBUG(s.str());
+        LOG_DEBUG("DISPATCH " << _name << "--> " << frame_to_string(f) << "\n");
 
         clean_inactive_streams(f);
         auto matcher = find_matcher(f);
@@ -154,6 +296,10 @@ namespace librealsense
         auto stream_id = frame.frame->get_stream()->get_unique_id();
         auto stream_type = frame.frame->get_stream()->get_stream_type();
 
+        auto it = _matchers.find(stream_id);
+        if (it != _matchers.end())
+            matcher = it->second;
+
         auto sensor = frame.frame->get_sensor().get(); //TODO: Potential deadlock if get_sensor() gets a hold of the last reference of that sensor
 
         auto dev_exist = false;
@@ -173,11 +319,13 @@ namespace librealsense
             if (dev)
             {
                 dev_exist = true;
-                matcher = _matchers[stream_id];
                 if (!matcher)
                 {
                     matcher = dev->create_matcher(frame);
-
+                    add_slot(matcher.get());
+                    auto composite = dynamic_cast<composite_matcher*>(matcher.get());
+                    if (composite)
+                        composite->set_latency_budget(_latency_budget);
 
                     matcher->set_callback([&](frame_holder f, syncronization_environment env)
                     {
@@ -186,11 +334,12 @@ namespace librealsense
 
                     for (auto stream : matcher->get_streams())
                     {
-                        if (_matchers[stream])
+                        auto& current = _matchers[stream];
+                        if (current)
                         {
-                            _frames_queue.erase(_matchers[stream].get());
+                            drop_frames(current.get(), false);
                         }
-                        _matchers[stream] = matcher;
+                        current = matcher;
                         _streams_id.push_back(stream);
 
                     }
@@ -209,25 +358,21 @@ namespace librealsense
                 {
 
                      matcher->set_active(true);
-                     _frames_queue[matcher.get()].start();
+                     queue_frames(matcher.get());
                 }
             }
         }
 
         if(!dev_exist)
         {
-            matcher = _matchers[stream_id];
             // We don't know what device this frame came from, so just store it under device NULL with ID matcher
             if (!matcher)
             {
-                if (_matchers[stream_id])
-                {
-                    _frames_queue.erase(_matchers[stream_id].get());
-                }
-                 _matchers[stream_id] = std::make_shared<identity_matcher>(stream_id, stream_type);
+                matcher = std::make_shared<identity_matcher>(stream_id, stream_type);
+                add_slot(matcher.get());
+                _matchers[stream_id] = matcher;
                 _streams_id.push_back(stream_id);
                 _streams_type.push_back(stream_type);
-                matcher = _matchers[stream_id];
 
                 matcher->set_callback([&](frame_holder f, syncronization_environment env)
                 {
@@ -239,13 +384,13 @@ namespace librealsense
     }
 
 
-    std::string composite_matcher::frames_to_string(std::vector<librealsense::matcher*> matchers)
+    std::string composite_matcher::frames_to_string(const std::vector<librealsense::matcher*>& matchers)
     {
         std::string str;
         for (auto m : matchers)
         {
-            frame_holder* f;
-            if(_frames_queue[m].peek(&f))
+            auto f = slot_of(m).frames.front();
+            if (f)
                 str += frame_to_string(*f);
         }
         return str;
@@ -253,41 +398,54 @@ namespace librealsense
 
     void composite_matcher::sync(frame_holder f, syncronization_environment env)
     {
-        std::stringstream s;
-        s <<"SYNC "<<_name<<"--> "<< frame_to_string(f)<<"\n";
-        LOG_DEBUG(s.str());
+        LOG_DEBUG("SYNC " << _name << "--> " << frame_to_string(f) << "\n");
 
         update_next_expected(f);
         auto matcher = find_matcher(f);
-        _frames_queue[matcher.get()].enqueue(std::move(f));
-
-        std::vector<frame_holder*> frames_arrived;
-        std::vector<librealsense::matcher*> frames_arrived_matchers;
-        std::vector<librealsense::matcher*> synced_frames;
-        std::vector<librealsense::matcher*> missing_streams;
+        auto now = _latency_budget > 0 ? platform::monotonic_time() : env.arrival;
+        auto& slot = slot_of(matcher.get());
+        slot.queued = true;
+        slot.stats.enqueued++;
+
+        // The streams below the highest priority hold half as many frames waiting for their matches, the frames they hold
+        // being taken from the budgets of their sensors
+        auto priority = f->get_priority();
+        _highest_priority = std::max(_highest_priority, priority);
+        auto limit = priority < _highest_priority ? (QUEUE_MAX_SIZE + 1) / 2 : QUEUE_MAX_SIZE;
+        if (!slot.frames.push(std::move(f), env.arrival, limit))
+            slot.stats.overflowed++;
+
+        auto& frames_arrived = _frames_arrived;
+        auto& frames_arrived_matchers = _frames_arrived_matchers;
+        auto& synced_frames = _synced_frames;
+        auto& missing_streams = _missing_streams;
+        auto& skipped_streams = _skipped_streams;
 
         do
         {
-            std::stringstream s;
             auto old_frames = false;
 
             synced_frames.clear();
             missing_streams.clear();
+            skipped_streams.clear();
             frames_arrived_matchers.clear();
             frames_arrived.clear();
 
 
-            for (auto s = _frames_queue.begin(); s != _frames_queue.end(); s++)
+            for (auto&& s : _slots)
             {
-                frame_holder* f;
-                if (s->second.peek(&f))
+                if (!s.queued)
+                    continue;
+
+                auto f = s.frames.front();
+                if (f)
                 {
                     frames_arrived.push_back(f);
-                    frames_arrived_matchers.push_back(s->first);
+                    frames_arrived_matchers.push_back(s.owner);
                 }
                 else
                 {
-                    missing_streams.push_back(s->first);
+                    missing_streams.push_back(s.owner);
                 }
             }
 
@@ -322,54 +480,63 @@ namespace librealsense
 
             if (!old_frames)
             {
+                auto expired = out_of_budget(synced_frames, now);
                 for (auto i : missing_streams)
                 {
-                    if (!skip_missing_stream(synced_frames, i))
+                    auto skip = skip_missing_stream(synced_frames, i);
+                    if (!skip && expired)
                     {
-                        s <<  _name<<" "<<frames_to_string(synced_frames )<<" Wait for missing stream: ";
-
-                        for (auto&& stream : i->get_streams())
-                            s << stream<<" next expected "<<std::fixed<< _next_expected[i];
+                        // Waited for the stream for as long as the budget allows
+                        skipped_streams.push_back({ i, true });
+                        LOG_DEBUG(_name << " " << frames_to_string(synced_frames) << " Latency budget ran out waiting for stream: "
+                            << list_to_string(i->get_streams()));
+                    }
+                    else if (!skip)
+                    {
+                        LOG_DEBUG(_name << " " << frames_to_string(synced_frames) << " Wait for missing stream: "
+                            << list_to_string(i->get_streams()) << "next expected " << std::fixed << slot_of(i).next_expected);
                         synced_frames.clear();
-                        LOG_DEBUG(s.str());
                         break;
                     }
                     else
                     {
-                        std::stringstream s;
-                        s << _name << " " << frames_to_string(synced_frames) << " Skipped missing stream: ";
-                        for (auto&& stream : i->get_streams())
-                            s << stream << " next expected " << std::fixed << _next_expected[i]<<" ";
-                        LOG_DEBUG(s.str());
+                        skipped_streams.push_back({ i, false });
+                        LOG_DEBUG(_name << " " << frames_to_string(synced_frames) << " Skipped missing stream: "
+                            << list_to_string(i->get_streams()) << "next expected " << std::fixed << slot_of(i).next_expected << " ");
                     }
 
                 }
             }
-            else
-            {
-                s << _name << " old frames: ";
-            }
             if (synced_frames.size())
             {
                 std::vector<frame_holder> match;
                 match.reserve(synced_frames.size());
 
+                for (auto&& skipped : skipped_streams)
+                {
+                    slot_of(skipped.first).stats.skipped++;
+                    if (skipped.second)
+                        for (auto&& stream : skipped.first->get_streams())
+                            _incomplete_framesets[stream]++;
+                }
+
+                // The frameset is as old as the first of its frames to arrive
+                auto arrival = now;
                 for (auto index : synced_frames)
                 {
+                    auto& synced = slot_of(index);
+                    arrival = std::min(arrival, synced.frames.front_arrival());
+                    synced.stats.matched++;
+
                     frame_holder frame;
-                    _frames_queue[index].dequeue(&frame);
+                    synced.frames.pop(&frame);
                     if (old_frames)
                     {
-                        s  << "--> " << frame_to_string(frame) << "\n";
+                        LOG_DEBUG(_name << " old frames: --> " << frame_to_string(frame));
                     }
                     match.push_back(std::move(frame));
                 }
 
-                if (old_frames)
-                {
-                    LOG_DEBUG(s.str());
-                }
-
                 std::sort(match.begin(), match.end(), [](const frame_holder& f1, const frame_holder& f2)
                 {
                     return ((frame_interface*)f1)->get_stream()->get_unique_id() > ((frame_interface*)f2)->get_stream()->get_unique_id();
@@ -379,10 +546,10 @@ namespace librealsense
                 frame_holder composite = env.source->allocate_composite_frame(std::move(match));
                 if (composite.frame)
                 {
-                    s <<"SYNCED "<<_name<<"--> "<< frame_to_string(composite)<<"\n";
-
                     auto cb = begin_callback();
-                    _callback(std::move(composite), env);
+                    auto composite_env = env;
+                    composite_env.arrival = arrival;
+                    _callback(std::move(composite), composite_env);
                 }
             }
         } while (synced_frames.size() > 0);
@@ -395,7 +562,7 @@ namespace librealsense
 
     void frame_number_composite_matcher::update_last_arrived(frame_holder& f, matcher* m)
     {
-        _last_arrived[m] =f->get_frame_number();
+        slot_of(m).last_arrived = double(f->get_frame_number());
     }
 
     bool frame_number_composite_matcher::are_equivalent(frame_holder& a, frame_holder& b)
@@ -408,40 +575,27 @@ namespace librealsense
     }
     void frame_number_composite_matcher::clean_inactive_streams(frame_holder& f)
     {
-        std::vector<stream_id> inactive_matchers;
-        for(auto m: _matchers)
+        for(auto&& m: _matchers)
         {
-            if (_last_arrived[m.second.get()] && (fabs((long long)f->get_frame_number() - (long long)_last_arrived[m.second.get()])) > 5)
+            auto last_arrived = (long long)slot_of(m.second.get()).last_arrived;
+            if (last_arrived && (fabs((long long)f->get_frame_number() - last_arrived)) > 5)
             {
-                std::stringstream s;
-                s << "clean inactive stream in "<<_name;
-                for (auto stream : m.second->get_streams_types())
-                {
-                    s << stream << " ";
-                }
-                LOG_DEBUG(s.str());
+                LOG_DEBUG("clean inactive stream in " << _name << list_to_string(m.second->get_streams_types()));
 
-                inactive_matchers.push_back(m.first);
                 m.second->set_active(false);
+                drop_frames(m.second.get(), true);
             }
         }
-
-        for(auto id: inactive_matchers)
-        {
-            _frames_queue[_matchers[id].get()].clear();
-        }
     }
 
-    bool frame_number_composite_matcher::skip_missing_stream(std::vector<matcher*> synced, matcher* missing)
+    bool frame_number_composite_matcher::skip_missing_stream(const std::vector<matcher*>& synced, matcher* missing)
     {
-        frame_holder* synced_frame;
-
          if(!missing->get_active())
              return true;
 
-        _frames_queue[synced[0]].peek(&synced_frame);
+        auto synced_frame = slot_of(synced[0]).frames.front();
 
-        auto next_expected = _next_expected[missing];
+        auto next_expected = slot_of(missing).next_expected;
 
         if((*synced_frame)->get_frame_number() - next_expected > 4 || (*synced_frame)->get_frame_number() < next_expected)
         {
@@ -453,7 +607,7 @@ namespace librealsense
     void frame_number_composite_matcher::update_next_expected(const frame_holder& f)
     {
         auto matcher = find_matcher(f);
-        _next_expected[matcher.get()] = f.frame->get_frame_number()+1.;
+        slot_of(matcher.get()).next_expected = f.frame->get_frame_number()+1.;
     }
 
     std::pair<double, double> extract_timestamps(frame_holder & a, frame_holder & b)
@@ -497,13 +651,14 @@ namespace librealsense
 
     void timestamp_composite_matcher::update_last_arrived(frame_holder& f, matcher* m)
     {
+        auto& slot = slot_of(m);
         if(f->supports_frame_metadata(RS2_FRAME_METADATA_ACTUAL_FPS))
-            _fps[m] = (uint32_t)f->get_frame_metadata(RS2_FRAME_METADATA_ACTUAL_FPS);
+            slot.fps = (uint32_t)f->get_frame_metadata(RS2_FRAME_METADATA_ACTUAL_FPS);
 
         else
-            _fps[m] = f->get_stream()->get_framerate();
+            slot.fps = f->get_stream()->get_framerate();
 
-        _last_arrived[m] = environment::get_instance().get_time_service()->get_time();
+        slot.last_arrived = platform::monotonic_time();
     }
 
     unsigned int timestamp_composite_matcher::get_fps(const frame_holder & f)
@@ -523,10 +678,12 @@ namespace librealsense
         auto gap = 1000.f / (float)fps;
 
         auto matcher = find_matcher(f);
+        auto& slot = slot_of(matcher.get());
 
-        _next_expected[matcher.get()] = f.frame->get_frame_timestamp() + gap;
-        _next_expected_domain[matcher.get()] = f.frame->get_frame_timestamp_domain();
-        LOG_DEBUG(_name << frame_to_string(const_cast<frame_holder&>(f))<<"fps " <<fps<<" gap " <<gap<<" next_expected: "<< _next_expected[matcher.get()]);
+        slot.next_expected = f.frame->get_frame_timestamp() + gap;
+        slot.next_expected_domain = f.frame->get_frame_timestamp_domain();
+        slot.has_next_expected_domain = true;
+        LOG_DEBUG(_name << frame_to_string(const_cast<frame_holder&>(f))<<"fps " <<fps<<" gap " <<gap<<" next_expected: "<< slot.next_expected);
 
     }
 
@@ -534,49 +691,35 @@ namespace librealsense
     {
         if (f.is_blocking())
             return;
-        std::vector<stream_id> dead_matchers;
-        auto now = environment::get_instance().get_time_service()->get_time();
-        for(auto m: _matchers)
+        auto now = platform::monotonic_time();
+        for(auto&& m: _matchers)
         {
-            auto threshold = _fps[m.second.get()] ? (1000 / _fps[m.second.get()]) * 5 : 500; //if frame of a specific stream didn't arrive for time equivalence to 5 frames duration
-                                                                                             //this stream will be marked as "not active" in order to not stack the other streams
-            if(_last_arrived[m.second.get()] && (now - _last_arrived[m.second.get()]) > threshold)
+            auto& slot = slot_of(m.second.get());
+            auto threshold = slot.fps ? (1000 / slot.fps) * 5 : 500; //if frame of a specific stream didn't arrive for time equivalence to 5 frames duration
+                                                                     //this stream will be marked as "not active" in order to not stack the other streams
+            if(slot.last_arrived && (now - slot.last_arrived) > threshold)
             {
-                std::stringstream s;
-                s << "clean inactive stream in "<<_name;
-                for (auto stream : m.second->get_streams_types())
-                {
-                    s << stream << " ";
-                }
-                LOG_DEBUG(s.str());
+                LOG_DEBUG("clean inactive stream in " << _name << list_to_string(m.second->get_streams_types()));
 
-                dead_matchers.push_back(m.first);
                 m.second->set_active(false);
+                drop_frames(m.second.get(), false);
             }
         }
-
-        for(auto id: dead_matchers)
-        {
-            _frames_queue[_matchers[id].get()].clear();
-            _frames_queue.erase(_matchers[id].get());
-        }
     }
 
-    bool timestamp_composite_matcher::skip_missing_stream(std::vector<matcher*> synced, matcher* missing)
+    bool timestamp_composite_matcher::skip_missing_stream(const std::vector<matcher*>& synced, matcher* missing)
     {
         if(!missing->get_active())
             return true;
 
-        frame_holder* synced_frame;
-
-        _frames_queue[synced[0]].peek(&synced_frame);
+        auto synced_frame = slot_of(synced[0]).frames.front();
 
-        auto next_expected = _next_expected[missing];
+        auto& missing_slot = slot_of(missing);
+        auto next_expected = missing_slot.next_expected;
 
-        auto it = _next_expected_domain.find(missing);
-        if (it != _next_expected_domain.end())
+        if (missing_slot.has_next_expected_domain)
         {
-            if (it->second != (*synced_frame)->get_frame_timestamp_domain())
+            if (missing_slot.next_expected_domain != (*synced_frame)->get_frame_timestamp_domain())
             {
                 return false;
             }
@@ -5,11 +5,13 @@
 
 #include "types.h"
 #include "archive.h"
+#include "../include/librealsense2/h/rs_processing.h"
 
 #include <stdint.h>
 #include <vector>
 #include <mutex>
 #include <memory>
+#include <array>
 
 namespace librealsense
 {
@@ -59,11 +61,34 @@ namespace librealsense
         synthetic_source_interface* source;
         //sync_lock& lock_ref;
         single_consumer_frame_queue<frame_holder>& matches;
+        double arrival;     // monotonic_time() the oldest of the frames being synced reached the syncer, in milliseconds
     };
 
     typedef int stream_id;
     typedef std::function<void(frame_holder, syncronization_environment)> sync_callback;
 
+    // Frames of a stream waiting to be synced, kept in place. When full, or holding as many frames as the limit of a push, the
+    // oldest frames are dropped to make room for a new one
+    class frame_ring
+    {
+    public:
+        frame_ring() : _head(0), _size(0) {}
+
+        // Arrival is the time the frame reached the syncer, in milliseconds. Returns false when the oldest frame was dropped to make room
+        bool push(frame_holder&& f, double arrival, size_t limit = QUEUE_MAX_SIZE);
+        bool pop(frame_holder* f);
+        frame_holder* front() { return _size ? &_frames[_head] : nullptr; }
+        double front_arrival() const { return _arrivals[_head]; }
+        size_t size() const { return _size; }
+        void clear();
+
+    private:
+        std::array<frame_holder, QUEUE_MAX_SIZE> _frames;
+        std::array<double, QUEUE_MAX_SIZE> _arrivals;
+        size_t _head;
+        size_t _size;
+    };
+
     class matcher_interface
     {
     public:
@@ -91,6 +116,10 @@ namespace librealsense
         bool get_active() const;
         void set_active(const bool active);
 
+        // Index of the matcher among the matchers of the composite matcher it belongs to
+        int get_slot() const { return _slot; }
+        void set_slot(int slot) { _slot = slot; }
+
     protected:
        std::vector<stream_id> _streams_id;
        std::vector<rs2_stream> _streams_type;
@@ -98,6 +127,7 @@ namespace librealsense
        callbacks_heap _callback_inflight;
        std::string _name;
        bool _active = true;
+       int _slot = -1;
     };
 
     class identity_matcher : public matcher
@@ -117,22 +147,65 @@ namespace librealsense
 
         virtual bool are_equivalent(frame_holder& a, frame_holder& b) = 0;
         virtual bool is_smaller_than(frame_holder& a, frame_holder& b) = 0;
-        virtual bool skip_missing_stream(std::vector<matcher*> synced, matcher* missing)  = 0;
+        virtual bool skip_missing_stream(const std::vector<matcher*>& synced, matcher* missing)  = 0;
         virtual void clean_inactive_streams(frame_holder& f) = 0;
         virtual void update_last_arrived(frame_holder& f, matcher* m) = 0;
 
         void dispatch(frame_holder f, syncronization_environment env) override;
-        std::string frames_to_string(std::vector<librealsense::matcher*> matchers);
+        std::string frames_to_string(const std::vector<librealsense::matcher*>& matchers);
         void sync(frame_holder f, syncronization_environment env) override;
         std::shared_ptr<matcher> find_matcher(const frame_holder& f);
 
+        // Longest time a frameset is held back waiting for its missing frames, 0 for no limit. Applies to the nested composite matchers too
+        void set_latency_budget(double ms);
+
+        // Number of framesets emitted without a frame of the stream because the latency budget ran out
+        unsigned long long get_incomplete_framesets(stream_id stream) const;
+
+        // Counters of the stream, kept by the matcher its frames reach first. False when no matcher has seen the stream
+        bool get_stream_stats(stream_id stream, rs2_sync_stream_stats* stats) const;
+
+        // Adds the counters of every stream, and the frames waiting for their matches
+        void get_totals(rs2_sync_stream_stats* totals, unsigned long long* queued) const;
+
     protected:
         virtual void update_next_expected(const frame_holder& f) = 0;
 
-        std::map<matcher*, single_consumer_frame_queue<frame_holder>> _frames_queue;
+        // State of one of the matchers, at the slot of the matcher, so that every frame is synced without lookups or allocations
+        struct matcher_slot
+        {
+            matcher* owner;
+            bool queued;                    // Whether the frames of the matcher are waited for
+            frame_ring frames;
+            double next_expected;
+            bool has_next_expected_domain;
+            rs2_timestamp_domain next_expected_domain;
+            double last_arrived;
+            unsigned int fps;
+            rs2_sync_stream_stats stats;
+        };
+
+        void add_slot(matcher* m);
+        matcher_slot& slot_of(matcher* m) { return _slots[m->get_slot()]; }
+        void queue_frames(matcher* m);
+        void drop_frames(matcher* m, bool queued);
+
         std::map<stream_id, std::shared_ptr<matcher>> _matchers;
-        std::map<matcher*, double> _next_expected;
-        std::map<matcher*, rs2_timestamp_domain> _next_expected_domain;
+        std::vector<matcher_slot> _slots;
+
+    private:
+        bool out_of_budget(const std::vector<librealsense::matcher*>& synced, double now) const;
+
+        double _latency_budget = 0;
+        int _highest_priority = std::numeric_limits<int>::min();   // Of the frames synced, those below it are held half as many
+        std::map<stream_id, unsigned long long> _incomplete_framesets;
+
+        // Kept between the frames, with their capacity
+        std::vector<frame_holder*> _frames_arrived;
+        std::vector<librealsense::matcher*> _frames_arrived_matchers;
+        std::vector<librealsense::matcher*> _synced_frames;
+        std::vector<librealsense::matcher*> _missing_streams;
+        std::vector<std::pair<librealsense::matcher*, bool>> _skipped_streams;   // And whether the latency budget ran out waiting for them
     };
 
     class frame_number_composite_matcher : public composite_matcher
@@ -142,12 +215,9 @@ namespace librealsense
         virtual void update_last_arrived(frame_holder& f, matcher* m) override;
         bool are_equivalent(frame_holder& a, frame_holder& b) override;
         bool is_smaller_than(frame_holder& a, frame_holder& b) override;
-        bool skip_missing_stream(std::vector<matcher*> synced, matcher* missing) override;
+        bool skip_missing_stream(const std::vector<matcher*>& synced, matcher* missing) override;
         void clean_inactive_streams(frame_holder& f) override;
         void update_next_expected(const frame_holder& f) override;
-
-    private:
-         std::map<matcher*,unsigned long long> _last_arrived;
     };
 
     class timestamp_composite_matcher : public composite_matcher
@@ -158,14 +228,11 @@ namespace librealsense
         bool is_smaller_than(frame_holder& a, frame_holder& b) override;
         virtual void update_last_arrived(frame_holder& f, matcher* m) override;
         void clean_inactive_streams(frame_holder& f) override;
-        bool skip_missing_stream(std::vector<matcher*> synced, matcher* missing) override;
+        bool skip_missing_stream(const std::vector<matcher*>& synced, matcher* missing) override;
         void update_next_expected(const frame_holder & f) override;
 
     private:
         unsigned int get_fps(const frame_holder & f);
         bool are_equivalent(double a, double b, int fps);
-        std::map<matcher*, double> _last_arrived;
-        std::map<matcher*, unsigned int> _fps;
-
     };
 }
@@ -0,0 +1,155 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include "thread-policy.h"
+#include "types.h"
+
+#include <array>
+#include <mutex>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#ifdef __linux__
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#endif
+
+namespace librealsense
+{
+    namespace
+    {
+        std::mutex policies_mutex;
+        std::array<thread_policy, RS2_THREAD_ROLE_COUNT> policies;
+        thread_local std::string thread_name;
+
+        // Thread names are limited to 15 characters on Linux
+        const size_t max_name_length = 15;
+
+        std::string default_name(rs2_thread_role role)
+        {
+            switch (role)
+            {
+            case RS2_THREAD_ROLE_CAPTURE: return "rs-capture";
+            case RS2_THREAD_ROLE_HID: return "rs-hid";
+            case RS2_THREAD_ROLE_DISPATCH: return "rs-dispatch";
+            case RS2_THREAD_ROLE_DEVICE_WATCHER: return "rs-watcher";
+            case RS2_THREAD_ROLE_PROCESSING: return "rs-processing";
+            case RS2_THREAD_ROLE_PARALLEL: return "rs-parallel";
+            default: return "rs";
+            }
+        }
+
+#ifdef _WIN32
+        void set_name(const std::string& name)
+        {
+            // SetThreadDescription only exists from Windows 10 1607
+            typedef HRESULT(WINAPI *set_thread_description)(HANDLE, PCWSTR);
+            auto set = reinterpret_cast<set_thread_description>(GetProcAddress(GetModuleHandleW(L"kernel32.dll"), "SetThreadDescription"));
+            if (set)
+                set(GetCurrentThread(), std::wstring(name.begin(), name.end()).c_str());
+        }
+
+        bool set_cpus(const std::vector<int>& cpus)
+        {
+            DWORD_PTR mask = 0;
+            for (auto cpu : cpus)
+                if (cpu >= 0 && cpu < int(sizeof(mask) * 8)) mask |= DWORD_PTR(1) << cpu;
+            return mask && SetThreadAffinityMask(GetCurrentThread(), mask);
+        }
+
+        bool set_priority(rs2_thread_priority priority)
+        {
+            int value = THREAD_PRIORITY_NORMAL;
+            switch (priority)
+            {
+            case RS2_THREAD_PRIORITY_LOW: value = THREAD_PRIORITY_BELOW_NORMAL; break;
+            case RS2_THREAD_PRIORITY_HIGH: value = THREAD_PRIORITY_HIGHEST; break;
+            case RS2_THREAD_PRIORITY_REALTIME: value = THREAD_PRIORITY_TIME_CRITICAL; break;
+            default: break;
+            }
+            return SetThreadPriority(GetCurrentThread(), value) != 0;
+        }
+#else
+        void set_name(const std::string& name)
+        {
+#ifdef __APPLE__
+            pthread_setname_np(name.c_str());
+#else
+            pthread_setname_np(pthread_self(), name.c_str());
+#endif
+        }
+
+        bool set_cpus(const std::vector<int>& cpus)
+        {
+#ifdef __linux__
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            for (auto cpu : cpus)
+                if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+            return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+            return false; // macOS only takes affinity hints
+#endif
+        }
+
+        bool set_priority(rs2_thread_priority priority)
+        {
+            if (priority == RS2_THREAD_PRIORITY_REALTIME)
+            {
+                sched_param param{};
+                param.sched_priority = (sched_get_priority_min(SCHED_FIFO) + sched_get_priority_max(SCHED_FIFO)) / 2;
+                return pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+            }
+#ifdef __linux__
+            // The nice value of a Linux thread is its own, as that of a process
+            auto nice = priority == RS2_THREAD_PRIORITY_LOW ? 10 : -10;
+            return setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), nice) == 0;
+#else
+            sched_param param{};
+            int policy;
+            if (pthread_getschedparam(pthread_self(), &policy, &param)) return false;
+            auto min = sched_get_priority_min(policy), max = sched_get_priority_max(policy);
+            param.sched_priority = priority == RS2_THREAD_PRIORITY_LOW ? min : max;
+            return pthread_setschedparam(pthread_self(), policy, &param) == 0;
+#endif
+        }
+#endif
+    }
+
+    void set_thread_policy(rs2_thread_role role, thread_policy policy)
+    {
+        if (policy.name.size() > max_name_length)
+            policy.name.resize(max_name_length);
+
+        std::lock_guard<std::mutex> lock(policies_mutex);
+        policies[role] = std::move(policy);
+    }
+
+    void apply_thread_policy(rs2_thread_role role)
+    {
+        thread_policy policy;
+        {
+            std::lock_guard<std::mutex> lock(policies_mutex);
+            policy = policies[role];
+        }
+
+        thread_name = policy.name.empty() ? default_name(role) : policy.name;
+        set_name(thread_name);
+
+        if (!policy.cpus.empty() && !set_cpus(policy.cpus))
+            LOG_WARNING("Could not set the CPUs of a " << get_string(role) << " thread");
+
+        if (policy.priority != RS2_THREAD_PRIORITY_DEFAULT && !set_priority(policy.priority))
+            LOG_WARNING("Could not set the " << get_string(policy.priority) << " priority of a " << get_string(role) << " thread");
+    }
+
+    const std::string& get_thread_name()
+    {
+        return thread_name;
+    }
+}
@@ -0,0 +1,30 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "../include/librealsense2/h/rs_context.h"
+
+#include <string>
+#include <vector>
+
+namespace librealsense
+{
+    // Where and how the threads of a role run. An empty CPU set lets them run anywhere, and an empty name uses that of the role
+    struct thread_policy
+    {
+        std::vector<int> cpus;
+        rs2_thread_priority priority = RS2_THREAD_PRIORITY_DEFAULT;
+        std::string name;
+    };
+
+    // Applies to the threads of the role started afterwards, in the whole process
+    void set_thread_policy(rs2_thread_role role, thread_policy policy);
+
+    // Called first thing by every thread librealsense starts: names the calling thread and applies the policy of its role.
+    // A policy the operating system refuses is logged and otherwise ignored
+    void apply_thread_policy(rs2_thread_role role);
+
+    // Given by apply_thread_policy, empty for the threads of the application
+    const std::string& get_thread_name();
+}
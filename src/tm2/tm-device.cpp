@@ -108,7 +108,8 @@ namespace librealsense
         register_metadata(RS2_FRAME_METADATA_ACTUAL_EXPOSURE, std::make_shared<md_tm2_parser>(RS2_FRAME_METADATA_ACTUAL_EXPOSURE));
         register_metadata(RS2_FRAME_METADATA_TEMPERATURE    , std::make_shared<md_tm2_parser>(RS2_FRAME_METADATA_TEMPERATURE));
         //Replacing md parser for RS2_FRAME_METADATA_TIME_OF_ARRIVAL
-        _metadata_parsers->operator[](RS2_FRAME_METADATA_TIME_OF_ARRIVAL) = std::make_shared<md_tm2_parser>(RS2_FRAME_METADATA_TIME_OF_ARRIVAL);
+        _metadata_parsers->set(RS2_FRAME_METADATA_TIME_OF_ARRIVAL, std::make_shared<md_tm2_parser>(RS2_FRAME_METADATA_TIME_OF_ARRIVAL));
+        register_motion_batch_options(*this, &_batch_size, &_batch_latency);
     }
 
     tm2_sensor::~tm2_sensor()
@@ -258,7 +259,7 @@ namespace librealsense
         else if (_is_opened)
             throw wrong_api_call_sequence_exception("open(...) failed. TM2 device is already opened!");
 
-        _source.init(_metadata_parsers);
+        _source.init(_metadata_parsers, get_frame_allocator(), get_preallocation());
         _source.set_sensor(this->shared_from_this());
 
         //TODO - TM2_API currently supports a single profile is supported per stream. 
@@ -382,6 +383,20 @@ namespace librealsense
                 throw invalid_value_exception("Invalid stream type");
             }
         }
+
+        // The IMU samples are batched like those of the motion module of the D400
+        _batches.clear();
+        for (auto&& r : requests)
+        {
+            auto sp = to_profile(r.get());
+            auto batch_size = get_motion_batch_size(_batch_size, _batch_latency, sp.fps);
+            if ((sp.stream == RS2_STREAM_GYRO || sp.stream == RS2_STREAM_ACCEL) && sp.format == RS2_FORMAT_MOTION_XYZ32F && batch_size > 1)
+            {
+                auto&& batch = _batches[{ sp.stream, sp.index }];
+                batch.size = batch_size;
+                batch.samples.reserve(batch_size);
+            }
+        }
         _is_opened = true;
         set_active_streams(requests);
     }
@@ -401,6 +416,7 @@ namespace librealsense
         }
         //reset active profiles
         _tm_active_profiles.reset();
+        _batches.clear();
 
         _is_opened = false;
         set_active_streams({});
@@ -549,8 +565,11 @@ namespace librealsense
         {
             throw io_exception("Failed to stop TM2 camera");
         }
+        _source.stop_callbacks();
         raise_on_before_streaming_changes(false);
         _is_streaming = false;
+        for (auto&& batch : _batches)
+            batch.second.samples.clear();
     }
 
     rs2_intrinsics tm2_sensor::get_intrinsics(const stream_profile& profile) const
@@ -735,6 +754,18 @@ namespace librealsense
             return;
         }
 
+        // Kept ahead of the frame, for the readers of the latest pose not to wait on the delivery of the frames
+        rs2_pose pose;
+        pose.translation = { tm_frame.translation.x, tm_frame.translation.y, tm_frame.translation.z };
+        pose.velocity = { tm_frame.velocity.x, tm_frame.velocity.y, tm_frame.velocity.z };
+        pose.acceleration = { tm_frame.acceleration.x, tm_frame.acceleration.y, tm_frame.acceleration.z };
+        pose.rotation = { tm_frame.rotation.i, tm_frame.rotation.j, tm_frame.rotation.k, tm_frame.rotation.r };
+        pose.angular_velocity = { tm_frame.angularVelocity.x, tm_frame.angularVelocity.y, tm_frame.angularVelocity.z };
+        pose.angular_acceleration = { tm_frame.angularAcceleration.x, tm_frame.angularAcceleration.y, tm_frame.angularAcceleration.z };
+        pose.tracker_confidence = tm_frame.trackerConfidence;
+        pose.mapper_confidence = tm_frame.mapperConfidence;
+        _latest_poses.record(profile->get_stream_index(), ts_ms.count(), pose);
+
         //TODO - maybe pass a raw data and parse up? do I have to pass any data on the buffer?
         frame_holder frame = _source.alloc_frame(RS2_EXTENSION_POSE_FRAME, sizeof(librealsense::pose_frame::pose_info), additional_data, true);
         if (frame.frame)
@@ -843,21 +874,46 @@ namespace librealsense
             return;
         }
 
-        frame_holder frame = _source.alloc_frame(RS2_EXTENSION_MOTION_FRAME, 3 * sizeof(float), additional_data, true);
+        _motion_history.record(stream_type, index, ts_ms.count(), { imu_data[0], imu_data[1], imu_data[2] });
+
+        // Samples of batched streams are delivered together once the batch is full, in a frame of the last of them
+        auto batch = _batches.find({ stream_type, index });
+        size_t frame_size = 3 * sizeof(float);
+        if (batch != _batches.end())
+        {
+            auto& samples = batch->second.samples;
+            samples.push_back({ { imu_data[0], imu_data[1], imu_data[2] }, ts_ms.count() });
+            if (samples.size() < batch->second.size)
+                return;
+            frame_size = samples.size() * sizeof(rs2_motion_sample);
+        }
+
+        frame_holder frame = _source.alloc_frame(RS2_EXTENSION_MOTION_FRAME, frame_size, additional_data, true);
         if (frame.frame)
         {
             auto motion_frame = static_cast<librealsense::motion_frame*>(frame.frame);
             frame->set_timestamp(ts_ms.count());
             frame->set_timestamp_domain(RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK);
             frame->set_stream(profile);
-            auto data = reinterpret_cast<float*>(motion_frame->data.data());
-            data[0] = imu_data[0];
-            data[1] = imu_data[1];
-            data[2] = imu_data[2];
+            if (batch != _batches.end())
+            {
+                librealsense::copy(motion_frame->data.data(), batch->second.samples.data(), frame_size);
+                motion_frame->set_batched(true);
+                batch->second.samples.clear();
+            }
+            else
+            {
+                auto data = reinterpret_cast<float*>(motion_frame->data.data());
+                data[0] = imu_data[0];
+                data[1] = imu_data[1];
+                data[2] = imu_data[2];
+            }
         }
         else
         {
             LOG_WARNING("Dropped frame. alloc_frame(...) returned nullptr");
+            if (batch != _batches.end())
+                batch->second.samples.clear();
             return;
         }
         _source.invoke_callback(std::move(frame));
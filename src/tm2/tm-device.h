@@ -7,6 +7,7 @@
 
 #include "../device.h"
 #include "../core/motion.h"
+#include "../pose-prediction.h"
 #include "TrackingManager.h"
 #include "../media/playback/playback_device.h"
 
@@ -38,7 +39,7 @@ namespace librealsense
         std::shared_ptr<tm2_sensor> _sensor;
     };
 
-    class tm2_sensor : public sensor_base, public video_sensor_interface, public perc::TrackingDevice::Listener
+    class tm2_sensor : public sensor_base, public video_sensor_interface, public motion_history_interface, public pose_prediction_interface, public perc::TrackingDevice::Listener
     {
     public:
         tm2_sensor(tm2_device* owner, perc::TrackingDevice* dev);
@@ -52,6 +53,14 @@ namespace librealsense
         void stop() override;
         rs2_intrinsics get_intrinsics(const stream_profile& profile) const override;
         rs2_motion_device_intrinsic get_motion_intrinsics(const motion_stream_profile_interface& profile) const;
+        int get_motion_history(rs2_stream stream, int index, double begin, double end, double* timestamps, rs2_vector* motion, int count) const override
+        {
+            return _motion_history.query(stream, index, begin, end, timestamps, motion, count);
+        }
+        bool get_latest_pose(int index, double& timestamp, rs2_pose& pose) const override
+        {
+            return _latest_poses.get(index, timestamp, pose);
+        }
 
         // Tracking listener
         ////////////////////
@@ -82,5 +91,10 @@ namespace librealsense
         std::shared_ptr<playback_device> _loopback;
         perc::TrackingData::Profile _tm_supported_profiles;
         perc::TrackingData::Profile _tm_active_profiles;
+        int _batch_size = 1;
+        int _batch_latency = 0;
+        std::map<std::pair<rs2_stream, int>, motion_batch> _batches;  // By stream and index, fixed while the sensor is opened
+        motion_histories _motion_history;
+        latest_poses _latest_poses;
     };
 }
@@ -0,0 +1,190 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include "trace.h"
+#include "thread-policy.h"
+#include "types.h"
+
+#include <fstream>
+#include <iomanip>
+#ifdef __GNUG__
+#include <cxxabi.h>
+#endif
+
+namespace librealsense
+{
+    struct tracer::thread_buffer
+    {
+        explicit thread_buffer(unsigned id) : events(max_thread_events), size(0), dropped(0), session(0), thread(id), name(get_thread_name()) {}
+
+        std::vector<trace_event> events;
+        std::atomic<size_t> size;       // Published by the thread after writing the event, read by the one stopping the trace
+        std::atomic<size_t> dropped;
+        std::atomic<unsigned> session;  // Of the events held, a thread seeing a new session starts over
+        const unsigned thread;
+        const std::string name;
+    };
+
+    const size_t tracer::max_thread_events;
+
+    tracer& tracer::instance()
+    {
+        static tracer t;
+        return t;
+    }
+
+    void tracer::start()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _session.fetch_add(1);
+        _enabled = true;
+    }
+
+    tracer::thread_buffer& tracer::current_buffer()
+    {
+        // Held by the tracer too, for the events of the threads that exited to be written
+        static thread_local std::shared_ptr<thread_buffer> buffer;
+        if (!buffer)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            buffer = std::make_shared<thread_buffer>(static_cast<unsigned>(_buffers.size() + 1));
+            _buffers.push_back(buffer);
+        }
+        return *buffer;
+    }
+
+    void tracer::record(const char* name, const char* category, double start, double duration, unsigned long long frame_number, bool has_frame)
+    {
+        auto& buffer = current_buffer();
+        auto session = _session.load(std::memory_order_relaxed);
+        if (buffer.session.load(std::memory_order_relaxed) != session)
+        {
+            buffer.size = 0;
+            buffer.dropped = 0;
+            buffer.session.store(session, std::memory_order_release);
+        }
+
+        auto size = buffer.size.load(std::memory_order_relaxed);
+        if (size == buffer.events.size())
+        {
+            buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        buffer.events[size] = { name, category, start, duration, frame_number, has_frame };
+        buffer.size.store(size + 1, std::memory_order_release);
+    }
+
+    const char* tracer::intern(const std::string& name)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _names.insert(name).first->c_str();
+    }
+
+    static void write_string(std::ostream& out, const char* str)
+    {
+        out << '"';
+        for (; *str; ++str)
+        {
+            if (*str == '"' || *str == '\\') out << '\\' << *str;
+            else if (static_cast<unsigned char>(*str) < 0x20) out << ' ';
+            else out << *str;
+        }
+        out << '"';
+    }
+
+    void tracer::stop(const std::string& file)
+    {
+        std::vector<std::shared_ptr<thread_buffer>> buffers;
+        unsigned session;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (!_enabled)
+                throw wrong_api_call_sequence_exception("Tracing was not started");
+            _enabled = false;
+            session = _session.load();
+            buffers = _buffers;
+        }
+
+        std::ofstream out(file);
+        if (!out)
+            throw io_exception(to_string() << "Could not create the trace file " << file);
+
+        // Microseconds, the unit of the format
+        out << std::fixed << std::setprecision(3) << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        bool first = true;
+        auto separate = [&]() { if (!first) out << ",\n"; first = false; };
+        for (auto&& buffer : buffers)
+        {
+            if (buffer->session.load(std::memory_order_acquire) != session)
+                continue;
+
+            auto size = buffer->size.load(std::memory_order_acquire);
+            std::string name = buffer->name.empty() ? to_string() << "thread " << buffer->thread : buffer->name;
+            separate();
+            out << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << buffer->thread << ",\"args\":{\"name\":";
+            write_string(out, name.c_str());
+            out << "}}";
+
+            for (size_t i = 0; i < size; ++i)
+            {
+                auto&& e = buffer->events[i];
+                separate();
+                out << "{\"ph\":\"" << (e.duration > 0 ? "X" : "i") << "\",\"name\":";
+                write_string(out, e.name);
+                out << ",\"cat\":";
+                write_string(out, e.category);
+                out << ",\"pid\":1,\"tid\":" << buffer->thread << ",\"ts\":" << e.start * 1000;
+                if (e.duration > 0) out << ",\"dur\":" << e.duration * 1000;
+                else out << ",\"s\":\"t\"";
+                if (e.has_frame) out << ",\"args\":{\"frame\":" << e.frame_number << "}";
+                out << "}";
+            }
+
+            if (auto dropped = buffer->dropped.load())
+                LOG_WARNING("Tracing dropped " << dropped << " events of thread " << buffer->thread << ", past the " << max_thread_events << " a thread records");
+        }
+        out << "]}\n";
+        if (!out)
+            throw io_exception(to_string() << "Could not write the trace file " << file);
+    }
+
+    std::string get_type_name(const std::type_info& type)
+    {
+        std::string name = type.name();
+#ifdef __GNUG__
+        int status = 0;
+        if (auto demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status))
+        {
+            name = demangled;
+            free(demangled);
+        }
+#endif
+        for (auto prefix : { "class ", "struct ", "librealsense::" })
+        {
+            std::string p = prefix;
+            if (name.compare(0, p.size(), p) == 0)
+                name = name.substr(p.size());
+        }
+        return name;
+    }
+
+    trace_scope::trace_scope(const char* name, const char* category)
+        : _name(name && tracer::instance().is_enabled() ? name : nullptr), _category(category),
+          _start(_name ? platform::monotonic_time() : 0), _frame_number(0), _has_frame(false)
+    {}
+
+    trace_scope::trace_scope(const char* name, const char* category, unsigned long long frame_number)
+        : _name(name && tracer::instance().is_enabled() ? name : nullptr), _category(category),
+          _start(_name ? platform::monotonic_time() : 0), _frame_number(frame_number), _has_frame(true)
+    {}
+
+    trace_scope::~trace_scope()
+    {
+        if (_name && tracer::instance().is_enabled())
+        {
+            auto end = platform::monotonic_time();
+            // An event of zero duration would be written as an instant
+            tracer::instance().record(_name, _category, _start, std::max(end - _start, 1e-6), _frame_number, _has_frame);
+        }
+    }
+}
@@ -0,0 +1,85 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+namespace librealsense
+{
+    // A span of time a thread spent on a frame, times in milliseconds of platform::monotonic_time()
+    struct trace_event
+    {
+        const char* name;               // Of static storage, or interned by the tracer
+        const char* category;
+        double start;
+        double duration;                // Zero for instants
+        unsigned long long frame_number;
+        bool has_frame;
+    };
+
+    // Records the lifecycle events of the frames, in a buffer per thread the thread alone appends to, while tracing.
+    // A disabled tracer costs every event a single load
+    class tracer
+    {
+    public:
+        static tracer& instance();
+
+        bool is_enabled() const { return _enabled.load(std::memory_order_relaxed); }
+
+        // Drops the events of any previous trace
+        void start();
+        // Writes the events recorded since start in the Chrome trace event format, which Perfetto and chrome://tracing load.
+        // Threads record at most max_thread_events events each, the others are counted as dropped
+        void stop(const std::string& file);
+
+        void record(const char* name, const char* category, double start, double duration, unsigned long long frame_number, bool has_frame);
+
+        // Stable for the lifetime of the process, for names that are not of static storage
+        const char* intern(const std::string& name);
+
+        static const size_t max_thread_events = 1 << 16;
+
+    private:
+        struct thread_buffer;
+
+        tracer() : _enabled(false), _session(0) {}
+        thread_buffer& current_buffer();
+
+        std::atomic<bool> _enabled;
+        std::atomic<unsigned> _session;
+        std::mutex _mutex;
+        std::vector<std::shared_ptr<thread_buffer>> _buffers;
+        std::set<std::string> _names;
+    };
+
+    // Of a class, demangled and without the librealsense namespace, for the events of its instances
+    std::string get_type_name(const std::type_info& type);
+
+    // Records the time from its construction to its destruction, as an event of the calling thread. Null names record nothing
+    class trace_scope
+    {
+    public:
+        trace_scope(const char* name, const char* category);
+        trace_scope(const char* name, const char* category, unsigned long long frame_number);
+        ~trace_scope();
+
+        void set_frame_number(unsigned long long frame_number) { _frame_number = frame_number; _has_frame = true; }
+
+    private:
+        trace_scope(const trace_scope&) = delete;
+        trace_scope& operator=(const trace_scope&) = delete;
+
+        const char* _name;              // Null while not tracing
+        const char* _category;
+        double _start;
+        unsigned long long _frame_number;
+        bool _has_frame;
+    };
+}
@@ -178,6 +178,11 @@ namespace librealsense
             CASE(TM2)
             CASE(SOFTWARE_DEVICE)
             CASE(SOFTWARE_SENSOR)
+            CASE(GPU_FRAME)
+            CASE(DMABUF_FRAME)
+            CASE(MOTION_BATCH_FRAME)
+            CASE(MOTION_HISTORY)
+            CASE(POSE_PREDICTION)
         default: assert(!is_valid(value)); return UNKNOWN_VALUE;
         }
 #undef CASE
@@ -264,6 +269,42 @@ namespace librealsense
             CASE(STREAM_FILTER)
             CASE(STREAM_FORMAT_FILTER)
             CASE(STREAM_INDEX_FILTER)
+            CASE(FRAMES_MEMORY_BUDGET)
+            CASE(ZERO_COPY_ENABLED)
+            CASE(FRAMES_HUGE_PAGES)
+            CASE(UNPACK_THREADS)
+            CASE(DEFERRED_UNPACK)
+            CASE(PROCESSING_THREADS)
+            CASE(COMPACT_POINTS)
+            CASE(POINTS_FORMAT)
+            CASE(HISTOGRAM_SAMPLING)
+            CASE(FUSED_DISPARITY_TO_DEPTH)
+            CASE(PROCESSING_STATISTICS)
+            CASE(PROCESSED_FRAMES)
+            CASE(DROPPED_FRAMES)
+            CASE(PROCESSING_TIME_P50)
+            CASE(PROCESSING_TIME_P99)
+            CASE(CROP_TO_ROI)
+            CASE(SYNC_LATENCY_BUDGET)
+            CASE(BACKEND_BUFFERS)
+            CASE(BUFFERS_LATENCY_TOLERANCE)
+            CASE(MOTION_BATCH_SIZE)
+            CASE(CONTROLS_CACHE_TTL)
+            CASE(WARM_RESTART)
+            CASE(GLOBAL_TIME_ENABLED)
+            CASE(MOTION_BATCH_LATENCY)
+            CASE(VOXEL_SIZE)
+            CASE(VOXEL_POINT)
+            CASE(NORMALS_WINDOW)
+            CASE(TSDF_TRUNCATION)
+            CASE(TSDF_MAX_WEIGHT)
+            CASE(DEPTH_STATISTICS)
+            CASE(DEPTH_HISTOGRAM_RANGE)
+            CASE(DISTANCE_OUTPUT)
+            CASE(TARGET_SCALE)
+            CASE(CALLBACK_THREADS)
+            CASE(ORDERED_CALLBACKS)
+            CASE(POINTS_LAYOUT)
         default: assert(!is_valid(value)); return UNKNOWN_VALUE;
         }
 #undef CASE
@@ -294,6 +335,12 @@ namespace librealsense
             CASE(MOTION_XYZ32F)
             CASE(GPIO_RAW)
             CASE(6DOF)
+            CASE(NV12)
+            CASE(I420)
+            CASE(XYZ16)
+            CASE(XYZ16F)
+            CASE(Z16_RVL)
+            CASE(DISTANCE)
         default: assert(!is_valid(value)); return UNKNOWN_VALUE;
         }
 #undef CASE
@@ -368,6 +415,15 @@ namespace librealsense
             CASE(MANUAL_WHITE_BALANCE)
             CASE(POWER_LINE_FREQUENCY)
             CASE(LOW_LIGHT_COMPENSATION)
+            CASE(DEQUEUE_TIME)
+            CASE(UNPACK_TIME)
+            CASE(SYNC_TIME)
+            CASE(CALLBACK_TIME)
+            CASE(DEPTH_MIN)
+            CASE(DEPTH_MAX)
+            CASE(DEPTH_MEAN)
+            CASE(DEPTH_FILL_RATE)
+            CASE(DEPTH_HISTOGRAM)
 
         default: assert(!is_valid(value)); return UNKNOWN_VALUE;
         }
@@ -381,6 +437,19 @@ namespace librealsense
         {
             CASE(HARDWARE_CLOCK)
             CASE(SYSTEM_TIME)
+            CASE(GLOBAL_TIME)
+        default: assert(!is_valid(value)); return UNKNOWN_VALUE;
+        }
+#undef CASE
+    }
+
+    const char* get_string(rs2_depth_sample_mode value)
+    {
+#define CASE(X) STRCASE(DEPTH_SAMPLE, X)
+        switch (value)
+        {
+            CASE(DISTANCE)
+            CASE(POINT)
         default: assert(!is_valid(value)); return UNKNOWN_VALUE;
         }
 #undef CASE
@@ -414,6 +483,103 @@ namespace librealsense
         default: assert(!is_valid(value)); return UNKNOWN_VALUE;
         }
 
+#undef CASE
+    }
+
+    const char* get_string(rs2_compute_backend value)
+    {
+#define CASE(X) STRCASE(COMPUTE_BACKEND, X)
+        switch (value)
+        {
+            CASE(CPU)
+            CASE(OPENCL)
+        default: assert(!is_valid(value)); return UNKNOWN_VALUE;
+        }
+#undef CASE
+    }
+
+    const char* get_string(rs2_thread_role value)
+    {
+#define CASE(X) STRCASE(THREAD_ROLE, X)
+        switch (value)
+        {
+            CASE(CAPTURE)
+            CASE(HID)
+            CASE(DISPATCH)
+            CASE(DEVICE_WATCHER)
+            CASE(PROCESSING)
+            CASE(PARALLEL)
+        default: assert(!is_valid(value)); return UNKNOWN_VALUE;
+        }
+#undef CASE
+    }
+
+    const char* get_string(rs2_thread_priority value)
+    {
+#define CASE(X) STRCASE(THREAD_PRIORITY, X)
+        switch (value)
+        {
+            CASE(DEFAULT)
+            CASE(LOW)
+            CASE(HIGH)
+            CASE(REALTIME)
+        default: assert(!is_valid(value)); return UNKNOWN_VALUE;
+        }
+#undef CASE
+    }
+
+    const char* get_string(rs2_frame_queue_policy value)
+    {
+#define CASE(X) STRCASE(FRAME_QUEUE_POLICY, X)
+        switch (value)
+        {
+            CASE(DROP_OLDEST)
+            CASE(DROP_NEWEST)
+            CASE(BLOCK)
+            CASE(KEEP_LATEST)
+        default: assert(!is_valid(value)); return UNKNOWN_VALUE;
+        }
+#undef CASE
+    }
+
+    const char* get_string(rs2_record_queue_policy value)
+    {
+#define CASE(X) STRCASE(RECORD_QUEUE_POLICY, X)
+        switch (value)
+        {
+            CASE(DROP_NEWEST)
+            CASE(BLOCK)
+            CASE(DROP_LOW_PRIORITY)
+        default: assert(!is_valid(value)); return UNKNOWN_VALUE;
+        }
+#undef CASE
+    }
+
+    const char* get_string(rs2_record_compression value)
+    {
+#define CASE(X) STRCASE(RECORD_COMPRESSION, X)
+        switch (value)
+        {
+            CASE(NONE)
+            CASE(LZ4)
+            CASE(LZ4HC)
+            CASE(RVL)
+        default: assert(!is_valid(value)); return UNKNOWN_VALUE;
+        }
+#undef CASE
+    }
+
+    const char* get_string(rs2_load_action value)
+    {
+#define CASE(X) STRCASE(LOAD_ACTION, X)
+        switch (value)
+        {
+            CASE(RAISE_DECIMATION)
+            CASE(SKIP_TEMPORAL)
+            CASE(DROP_STREAMS)
+            CASE(HALVE_RATE)
+        default: assert(!is_valid(value)); return UNKNOWN_VALUE;
+        }
 #undef CASE
     }
     std::string firmware_version::to_string() const
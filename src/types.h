@@ -24,6 +24,8 @@
 #include <condition_variable>
 #include <functional>
 #include <utility>                          // For std::forward
+#include <type_traits>
+#include <atomic>
 #include "backend.h"
 #include "concurrency.h"
 #if BUILD_EASYLOGGINGPP
@@ -32,7 +34,13 @@
 
 typedef unsigned char byte;
 
-const int RS2_USER_QUEUE_SIZE = 128;
+const int RS2_USER_QUEUE_SIZE = 128;                    // Upper bound of the frames queue size option
+const int RS2_MAX_CALLBACK_THREADS = 16;                // Upper bound of the callback threads option, and of the callbacks an archive tracks
+const size_t RS2_FRAME_POOL_BUDGET = 256 * 1024 * 1024; // Max bytes of recycled frame buffers held by a single frame archive
+const uint32_t RS2_FRAME_POOL_PREWARM = 4;              // Number of buffers allocated per stream profile before streaming starts
+
+// Of the frame allocations that the pools a sensor sized when it started did not cover, see rs2_context_set_streaming_preallocation
+enum class preallocation_mode { off, counted, fatal };
 
 #ifndef DBL_EPSILON
 const double DBL_EPSILON = 2.2204460492503131e-016;  // smallest such that 1.0+DBL_EPSILON != 1.0
@@ -95,23 +103,105 @@ namespace librealsense
     void log_to_console(rs2_log_severity min_severity);
     void log_to_file(rs2_log_severity min_severity, const char * file_path);
 
+// Messages of a severity below RS2_LOG_MIN_SEVERITY are compiled out, see the LOG_MIN_SEVERITY CMake option
+#ifndef RS2_LOG_MIN_SEVERITY
+#define RS2_LOG_MIN_SEVERITY 0 // RS2_LOG_SEVERITY_DEBUG
+#endif
+
 #if BUILD_EASYLOGGINGPP
 
-#define LOG_DEBUG(...)   do { CLOG(DEBUG   ,"librealsense") << __VA_ARGS__; } while(false)
-#define LOG_INFO(...)    do { CLOG(INFO    ,"librealsense") << __VA_ARGS__; } while(false)
-#define LOG_WARNING(...) do { CLOG(WARNING ,"librealsense") << __VA_ARGS__; } while(false)
-#define LOG_ERROR(...)   do { CLOG(ERROR   ,"librealsense") << __VA_ARGS__; } while(false)
-#define LOG_FATAL(...)   do { CLOG(FATAL   ,"librealsense") << __VA_ARGS__; } while(false)
+    // Lowest severity of the messages written anywhere, the others are not even formatted
+    extern std::atomic<int> minimum_logged_severity;
+    inline bool is_logged(rs2_log_severity severity) { return severity >= minimum_logged_severity.load(std::memory_order_relaxed); }
+
+    // Writes the messages logged so far, on the calling thread, before returning
+    void flush_log();
+
+    // A message of the asynchronous log, queued when destroyed in the ring of the logging thread, and written by the
+    // thread flushing the rings. Numbers, strings and stream manipulators are captured in binary, and formatted by
+    // the flushing thread. Values of other types, and all the values after them, are formatted on the spot
+    class log_message
+    {
+    public:
+        log_message(rs2_log_severity severity, const char* file, int line);
+        ~log_message();
+
+        template<class T>
+        typename std::enable_if<std::is_arithmetic<T>::value, log_message&>::type operator<<(T value)
+        {
+            if (_formatted) *_stream << value;
+            else capture_value(&print<T>, &value, sizeof(T));
+            return *this;
+        }
+        log_message& operator<<(const char* value);
+        log_message& operator<<(const std::string& value);
+        log_message& operator<<(std::ios_base& (*manipulator)(std::ios_base&));
+        log_message& operator<<(std::ostream& (*manipulator)(std::ostream&));
+        // Defined below the stream operators of the enumerations, for them to be found
+        template<class T>
+        typename std::enable_if<!std::is_arithmetic<T>::value && !std::is_enum<T>::value, log_message&>::type operator<<(const T& value);
+        // Enumerations by the name get_string gives them, or as numbers when they have none. Not deduced through the stream
+        // operators, of which both librealsense and rs.hpp define one for the enumerations of the API
+        template<class T>
+        typename std::enable_if<std::is_enum<T>::value, log_message&>::type operator<<(T value);
+
+        typedef void(*print_function)(std::ostream& out, const void* value);
+
+    private:
+        log_message(const log_message&) = delete;
+        log_message& operator=(const log_message&) = delete;
+
+        template<class T>
+        static void print(std::ostream& out, const void* value)
+        {
+            T v;
+            memcpy(&v, value, sizeof(T));
+            out << v;
+        }
+
+        void capture_value(print_function print, const void* value, size_t size);
+        std::ostream& begin_formatting();
+
+        struct scratch;
+        scratch* _scratch;
+        std::ostream* _stream;
+        bool _formatted;
+    };
+
+#define RS2_LOG(severity, ...) do { if (librealsense::is_logged(severity)) { librealsense::log_message(severity, __FILE__, __LINE__) << __VA_ARGS__; } } while(false)
 
 #else // BUILD_EASYLOGGINGPP
 
+#define RS2_LOG(severity, ...) do { ; } while(false)
+
+#endif // BUILD_EASYLOGGINGPP
+
+#if RS2_LOG_MIN_SEVERITY <= 0
+#define LOG_DEBUG(...)   RS2_LOG(RS2_LOG_SEVERITY_DEBUG, __VA_ARGS__)
+#else
 #define LOG_DEBUG(...)   do { ; } while(false)
+#endif
+#if RS2_LOG_MIN_SEVERITY <= 1
+#define LOG_INFO(...)    RS2_LOG(RS2_LOG_SEVERITY_INFO, __VA_ARGS__)
+#else
 #define LOG_INFO(...)    do { ; } while(false)
+#endif
+#if RS2_LOG_MIN_SEVERITY <= 2
+#define LOG_WARNING(...) RS2_LOG(RS2_LOG_SEVERITY_WARN, __VA_ARGS__)
+#else
 #define LOG_WARNING(...) do { ; } while(false)
+#endif
+#if RS2_LOG_MIN_SEVERITY <= 3
+#define LOG_ERROR(...)   RS2_LOG(RS2_LOG_SEVERITY_ERROR, __VA_ARGS__)
+#else
 #define LOG_ERROR(...)   do { ; } while(false)
+#endif
+#if RS2_LOG_MIN_SEVERITY <= 4 && BUILD_EASYLOGGINGPP
+// Flushed before returning, a fatal message is the last one before the application aborts
+#define LOG_FATAL(...)   do { RS2_LOG(RS2_LOG_SEVERITY_FATAL, __VA_ARGS__); librealsense::flush_log(); } while(false)
+#else
 #define LOG_FATAL(...)   do { ; } while(false)
-
-#endif // BUILD_EASYLOGGINGPP
+#endif
 
     // Enhancement for debug mode that incurs performance penalty with STL
     // std::clamp to be introduced with c++17
@@ -399,6 +489,7 @@ namespace librealsense
     RS2_ENUM_HELPERS(rs2_camera_info, CAMERA_INFO)
     RS2_ENUM_HELPERS(rs2_frame_metadata_value, FRAME_METADATA)
     RS2_ENUM_HELPERS(rs2_timestamp_domain, TIMESTAMP_DOMAIN)
+    RS2_ENUM_HELPERS(rs2_depth_sample_mode, DEPTH_SAMPLE_MODE)
     RS2_ENUM_HELPERS(rs2_sr300_visual_preset, SR300_VISUAL_PRESET)
     RS2_ENUM_HELPERS(rs2_extension, EXTENSION)
     RS2_ENUM_HELPERS(rs2_exception_type, EXCEPTION_TYPE)
@@ -406,6 +497,38 @@ namespace librealsense
     RS2_ENUM_HELPERS(rs2_notification_category, NOTIFICATION_CATEGORY)
     RS2_ENUM_HELPERS(rs2_playback_status, PLAYBACK_STATUS)
     RS2_ENUM_HELPERS(rs2_matchers, MATCHER)
+    RS2_ENUM_HELPERS(rs2_compute_backend, COMPUTE_BACKEND)
+    RS2_ENUM_HELPERS(rs2_thread_role, THREAD_ROLE)
+    RS2_ENUM_HELPERS(rs2_thread_priority, THREAD_PRIORITY)
+    RS2_ENUM_HELPERS(rs2_frame_queue_policy, FRAME_QUEUE_POLICY)
+    RS2_ENUM_HELPERS(rs2_record_queue_policy, RECORD_QUEUE_POLICY)
+    RS2_ENUM_HELPERS(rs2_record_compression, RECORD_COMPRESSION)
+    RS2_ENUM_HELPERS(rs2_load_action, LOAD_ACTION)
+
+#if BUILD_EASYLOGGINGPP
+    template<class T>
+    typename std::enable_if<!std::is_arithmetic<T>::value && !std::is_enum<T>::value, log_message&>::type log_message::operator<<(const T& value)
+    {
+        (_formatted ? *_stream : begin_formatting()) << value;
+        return *this;
+    }
+
+    namespace log_detail
+    {
+        template<class T>
+        auto enum_name(T value, int) -> decltype(get_string(value)) { return get_string(value); }
+        template<class T>
+        int enum_name(T value, long) { return static_cast<int>(value); }
+    }
+
+    template<class T>
+    typename std::enable_if<std::is_enum<T>::value, log_message&>::type log_message::operator<<(T value)
+    {
+        (_formatted ? *_stream : begin_formatting()) << log_detail::enum_name(value, 0);
+        return *this;
+    }
+#endif // BUILD_EASYLOGGINGPP
+
     ////////////////////////////////////////////
     // World's tiniest linear algebra library //
     ////////////////////////////////////////////
@@ -745,6 +868,30 @@ namespace librealsense
         S accumulated;
     };
 
+    // The arithmetic_wraparound of 32-bit inputs into 64 bits, for threads to share with no lock: the last input being the low
+    // bits of the accumulated value, a compare and swap advances both at once
+    class atomic_wraparound
+    {
+    public:
+        atomic_wraparound() : _accumulated(0) {}
+
+        uint64_t calc(const uint32_t input)
+        {
+            auto accumulated = _accumulated.load(std::memory_order_relaxed);
+            uint64_t next;
+            do
+            {
+                next = accumulated + static_cast<uint32_t>(input - static_cast<uint32_t>(accumulated));
+            } while (!_accumulated.compare_exchange_weak(accumulated, next, std::memory_order_relaxed));
+            return next;
+        }
+
+        void reset() { _accumulated = 0; }
+
+    private:
+        std::atomic<uint64_t> _accumulated;
+    };
+
     typedef void(*frame_callback_function_ptr)(rs2_frame * frame, void * user);
 
     class frame_callback : public rs2_frame_callback
@@ -860,6 +1007,8 @@ namespace librealsense
     typedef std::shared_ptr<rs2_frame_processor_callback> frame_processor_callback_ptr;
     typedef std::shared_ptr<rs2_notifications_callback> notifications_callback_ptr;
     typedef std::shared_ptr<rs2_devices_changed_callback> devices_changed_callback_ptr;
+    typedef std::shared_ptr<rs2_frame_codec> frame_codec_ptr;
+    typedef std::shared_ptr<rs2_segment_closed_callback> segment_closed_callback_ptr;
 
     using internal_callback = std::function<void(rs2_device_list* removed, rs2_device_list* added)>;
     class devices_changed_callback_internal : public rs2_devices_changed_callback
@@ -944,11 +1093,13 @@ namespace librealsense
         return (c0 << 24) | (c1 << 16) | (c2 << 8) | c3;
     }
 
+    // Fixed-capacity object heap. C is the default capacity, while the actual
+    // capacity can be chosen at run-time when the heap is constructed
     template<class T, int C>
     class small_heap
     {
-        T buffer[C];
-        bool is_free[C];
+        std::vector<T> buffer;
+        std::vector<bool> is_free;
         std::mutex mutex;
         bool keep_allocating = true;
         std::condition_variable cv;
@@ -957,21 +1108,19 @@ namespace librealsense
     public:
         static const int CAPACITY = C;
 
-        small_heap()
+        explicit small_heap(int capacity = C)
+            : buffer(std::max(capacity, 1)), is_free(buffer.size(), true)
         {
-            for (auto i = 0; i < C; i++)
-            {
-                is_free[i] = true;
-                buffer[i] = std::move(T());
-            }
         }
 
+        int get_capacity() const { return static_cast<int>(buffer.size()); }
+
         T * allocate()
         {
             std::unique_lock<std::mutex> lock(mutex);
             if (!keep_allocating) return nullptr;
 
-            for (auto i = 0; i < C; i++)
+            for (size_t i = 0; i < buffer.size(); i++)
             {
                 if (is_free[i])
                 {
@@ -983,13 +1132,18 @@ namespace librealsense
             return nullptr;
         }
 
+        bool owns(const T * item) const
+        {
+            return item >= buffer.data() && item < buffer.data() + buffer.size();
+        }
+
         void deallocate(T * item)
         {
-             if (item < buffer || item >= buffer + C)
+            if (!owns(item))
             {
                 throw invalid_value_exception("Trying to return item to a heap that didn't allocate it!");
             }
-            auto i = item - buffer;
+            auto i = item - buffer.data();
             auto old_value = std::move(buffer[i]);
             buffer[i] = std::move(T());
 
@@ -1317,7 +1471,7 @@ namespace librealsense
             _backend(backend_ref),_active_object([this](dispatcher::cancellable_timer cancellable_timer)
         {
             polling(cancellable_timer);
-        }), _devices_data()
+        }, RS2_THREAD_ROLE_DEVICE_WATCHER), _devices_data()
         {
         }
 
@@ -0,0 +1,262 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include "usb-bandwidth.h"
+#include "sensor.h"
+#include "stream.h"
+#include "image.h"
+
+#include <algorithm>
+#include <cctype>
+#include <set>
+#include <tuple>
+
+namespace librealsense
+{
+    double usb_bandwidth_planner::get_bandwidth(const stream_profile_interface& profile)
+    {
+        auto p = to_profile(&profile);
+        if (!p.width || !p.height)
+            return 32. * p.fps; // Motion and pose samples
+
+        auto bpp = std::min(get_image_bpp(p.format), 16);
+        return static_cast<double>(p.width) * p.height * p.fps * bpp / 8;
+    }
+
+    double usb_bandwidth_planner::get_bandwidth(const stream_profiles& profiles)
+    {
+        double bandwidth = 0;
+        for (auto&& p : profiles)
+            bandwidth += get_bandwidth(*p);
+        return bandwidth;
+    }
+
+    double usb_bandwidth_planner::get_capacity(platform::usb_spec spec)
+    {
+        switch (spec)
+        {
+        case platform::usb3_type:
+        case platform::usb3_1_type:
+        case platform::usb3_2_type:
+            return 400e6;
+        case platform::usb2_type:
+        case platform::usb2_1_type:
+            return 40e6;
+        case platform::usb1_type:
+        case platform::usb1_1_type:
+            return 1e6;
+        default:
+            return 0; // Unknown, not planned for
+        }
+    }
+
+    std::string usb_bandwidth_planner::get_bus(const std::string& location)
+    {
+        // /sys/devices/pci0000:00/0000:00:14.0/usb2/2-3/2-3:1.0/video4linux/video0 is on /sys/devices/pci0000:00/0000:00:14.0/usb2
+        for (auto pos = location.find("/usb"); pos != std::string::npos; pos = location.find("/usb", pos + 1))
+        {
+            auto end = pos + 4;
+            while (end < location.size() && isdigit(static_cast<unsigned char>(location[end]))) ++end;
+            if (end > pos + 4 && (end == location.size() || location[end] == '/'))
+                return location.substr(0, end);
+        }
+        return location;
+    }
+
+    std::mutex& usb_bandwidth_planner::get_active_mutex()
+    {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    std::map<const sensor_interface*, usb_bandwidth_planner::active_stream>& usb_bandwidth_planner::get_active_streams()
+    {
+        static std::map<const sensor_interface*, active_stream> streams;
+        return streams;
+    }
+
+    void usb_bandwidth_planner::set_active(const sensor_interface* sensor, const device_interface* dev,
+                                           const std::string& location, platform::usb_spec spec, double bandwidth)
+    {
+        std::lock_guard<std::mutex> lock(get_active_mutex());
+        get_active_streams()[sensor] = { dev, get_bus(location), get_capacity(spec), bandwidth };
+    }
+
+    void usb_bandwidth_planner::clear_active(const sensor_interface* sensor)
+    {
+        std::lock_guard<std::mutex> lock(get_active_mutex());
+        get_active_streams().erase(sensor);
+    }
+
+    void usb_bandwidth_planner::add(device_interface& dev, const std::map<int, stream_profiles>& profiles)
+    {
+        for (size_t i = 0; i < dev.get_sensors_count(); ++i)
+        {
+            if (auto uvc = dynamic_cast<uvc_sensor*>(&dev.get_sensor(i)))
+            {
+                auto capacity = get_capacity(uvc->get_usb_specification());
+                if (capacity > 0)
+                    _requests.push_back({ &dev, get_bus(uvc->get_device_path()), capacity, profiles });
+                return;
+            }
+        }
+    }
+
+    std::map<std::string, usb_bus_load> usb_bandwidth_planner::get_loads(const std::vector<request>& requests) const
+    {
+        std::map<std::string, usb_bus_load> loads;
+        for (auto&& r : requests)
+        {
+            auto& load = loads[r.bus];
+            load.bus = r.bus;
+            load.capacity = r.capacity;
+            for (auto&& kvp : r.profiles)
+                load.demand += get_bandwidth(kvp.second);
+        }
+
+        // The streams the planned devices already run are replaced by the requested ones
+        std::lock_guard<std::mutex> lock(get_active_mutex());
+        for (auto&& kvp : get_active_streams())
+        {
+            auto&& active = kvp.second;
+            auto it = loads.find(active.bus);
+            if (it == loads.end())
+                continue;
+            if (std::any_of(requests.begin(), requests.end(), [&active](const request& r) { return r.dev == active.dev; }))
+                continue;
+            it->second.demand += active.bandwidth;
+        }
+        return loads;
+    }
+
+    std::vector<usb_bus_load> usb_bandwidth_planner::get_loads() const
+    {
+        std::vector<usb_bus_load> result;
+        for (auto&& kvp : get_loads(_requests))
+            result.push_back(kvp.second);
+        return result;
+    }
+
+    bool usb_bandwidth_planner::fits() const
+    {
+        for (auto&& kvp : get_loads(_requests))
+            if (kvp.second.demand > kvp.second.capacity)
+                return false;
+        return true;
+    }
+
+    // The video streams of a sensor run at a single resolution and frame rate. Returns those of the sensor switched to another
+    // of its modes, or nothing when one of them has no such profile
+    static bool switch_mode(sensor_interface& sensor, const stream_profiles& current, uint32_t width, uint32_t height, uint32_t fps,
+                            stream_profiles& result)
+    {
+        auto available = sensor.get_stream_profiles();
+        result.clear();
+        for (auto&& p : current)
+        {
+            auto from = to_profile(p.get());
+            if (!from.width || !from.height)
+            {
+                result.push_back(p);
+                continue;
+            }
+
+            auto it = std::find_if(available.begin(), available.end(), [&](const std::shared_ptr<stream_profile_interface>& a)
+            {
+                auto to = to_profile(a.get());
+                return to.stream == from.stream && to.index == from.index && to.format == from.format &&
+                       to.width == width && to.height == height && to.fps == fps;
+            });
+            if (it == available.end())
+                return false;
+            result.push_back(*it);
+        }
+        return true;
+    }
+
+    // The next mode down from the current one of the sensor: the highest lower frame rate at the same resolution, or
+    // otherwise the largest lower resolution at a frame rate no higher
+    static bool lower_mode(sensor_interface& sensor, const stream_profiles& current, stream_profiles& result)
+    {
+        const stream_profile_interface* heaviest = nullptr;
+        for (auto&& p : current)
+            if (!heaviest || usb_bandwidth_planner::get_bandwidth(*p) > usb_bandwidth_planner::get_bandwidth(*heaviest))
+                heaviest = p.get();
+        if (!heaviest)
+            return false;
+
+        auto mode = to_profile(heaviest);
+        if (!mode.width || !mode.height)
+            return false;
+
+        std::set<std::tuple<uint32_t, uint32_t, uint32_t>> lower_fps, lower_res;
+        for (auto&& a : sensor.get_stream_profiles())
+        {
+            auto p = to_profile(a.get());
+            if (p.stream != mode.stream || p.index != mode.index || p.format != mode.format)
+                continue;
+            if (p.width == mode.width && p.height == mode.height && p.fps < mode.fps)
+                lower_fps.insert(std::make_tuple(p.fps, p.width, p.height));
+            else if (p.width * p.height < mode.width * mode.height && p.fps <= mode.fps)
+                lower_res.insert(std::make_tuple(p.width * p.height, p.fps, p.width));
+        }
+
+        for (auto it = lower_fps.rbegin(); it != lower_fps.rend(); ++it)
+            if (switch_mode(sensor, current, std::get<1>(*it), std::get<2>(*it), std::get<0>(*it), result))
+                return true;
+
+        for (auto it = lower_res.rbegin(); it != lower_res.rend(); ++it)
+        {
+            auto width = std::get<2>(*it);
+            if (switch_mode(sensor, current, width, std::get<0>(*it) / width, std::get<1>(*it), result))
+                return true;
+        }
+        return false;
+    }
+
+    std::vector<std::map<int, stream_profiles>> usb_bandwidth_planner::suggest() const
+    {
+        auto requests = _requests;
+        while (true)
+        {
+            std::string overloaded;
+            for (auto&& kvp : get_loads(requests))
+                if (kvp.second.demand > kvp.second.capacity)
+                    overloaded = kvp.first;
+
+            if (overloaded.empty())
+            {
+                std::vector<std::map<int, stream_profiles>> result;
+                for (auto&& r : requests)
+                    result.push_back(r.profiles);
+                return result;
+            }
+
+            // Lower the heaviest sensor of the bus that still has a lower mode
+            std::vector<std::pair<double, std::pair<request*, int>>> candidates;
+            for (auto&& r : requests)
+                if (r.bus == overloaded)
+                    for (auto&& kvp : r.profiles)
+                        candidates.push_back({ get_bandwidth(kvp.second), { &r, kvp.first } });
+            std::sort(candidates.begin(), candidates.end(),
+                [](const decltype(candidates)::value_type& a, const decltype(candidates)::value_type& b) { return a.first > b.first; });
+
+            auto lowered = false;
+            for (auto&& c : candidates)
+            {
+                auto r = c.second.first;
+                auto& profiles = r->profiles[c.second.second];
+                stream_profiles lower;
+                if (lower_mode(r->dev->get_sensor(c.second.second), profiles, lower))
+                {
+                    profiles = lower;
+                    lowered = true;
+                    break;
+                }
+            }
+
+            if (!lowered)
+                throw std::runtime_error(to_string() << "The requested streams do not fit the USB bus " << overloaded << " at any frame rate and resolution");
+        }
+    }
+}
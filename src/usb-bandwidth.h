@@ -0,0 +1,83 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "backend.h"
+#include "core/streaming.h"
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace librealsense
+{
+    class device_interface;
+    class sensor_interface;
+
+    // Estimated traffic of a USB bus, that of a root hub of a host controller, in bytes per second
+    struct usb_bus_load
+    {
+        std::string bus;
+        double capacity;
+        double demand;
+    };
+
+    // Estimates whether streams fit the USB buses of their devices, together with the streams the UVC sensors of this
+    // process already run. Devices on the same root hub share its bandwidth; when the bus cannot be told from the location
+    // of a device, as on Windows, every device is assumed to have a bus of its own
+    class usb_bandwidth_planner
+    {
+    public:
+        // Bytes per second a profile is transported at. Formats the host converts from YUY2 are counted at 16 bits per pixel
+        static double get_bandwidth(const stream_profile_interface& profile);
+        static double get_bandwidth(const stream_profiles& profiles);
+
+        // Payload a bus of the speed carries in practice, short of its signaling rate
+        static double get_capacity(platform::usb_spec spec);
+
+        // Path of the root hub of a sysfs location, or the location itself
+        static std::string get_bus(const std::string& location);
+
+        // Bandwidth the sensor streams meanwhile, registered by the UVC sensors when opened
+        static void set_active(const sensor_interface* sensor, const device_interface* dev,
+                               const std::string& location, platform::usb_spec spec, double bandwidth);
+        static void clear_active(const sensor_interface* sensor);
+
+        // Streams requested of the sensors of a device, keyed by sensor index. Devices not on USB are left out
+        void add(device_interface& dev, const std::map<int, stream_profiles>& profiles);
+
+        std::vector<usb_bus_load> get_loads() const;
+        bool fits() const;
+
+        // The closest streams that fit, in the order of the devices, lowering the frame rate, and then the resolution, of the
+        // heaviest streams of the buses over capacity. Throws when they do not fit even at their lowest settings
+        std::vector<std::map<int, stream_profiles>> suggest() const;
+
+    private:
+        struct request
+        {
+            device_interface* dev;
+            std::string bus;
+            double capacity;
+            std::map<int, stream_profiles> profiles;
+        };
+
+        struct active_stream
+        {
+            const device_interface* dev;
+            std::string bus;
+            double capacity;
+            double bandwidth;
+        };
+
+        static std::mutex& get_active_mutex();
+        static std::map<const sensor_interface*, active_stream>& get_active_streams();
+
+        // Load of every bus, with the requests of the planner given
+        std::map<std::string, usb_bus_load> get_loads(const std::vector<request>& requests) const;
+
+        std::vector<request> _requests;
+    };
+}
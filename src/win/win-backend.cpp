@@ -148,7 +148,22 @@ namespace librealsense
                 if (!_data._stopped) throw wrong_api_call_sequence_exception("Cannot start a running device_watcher");
                 _data._stopped = false;
                 _data._callback = std::move(callback);
-                _thread = std::thread([this]() { run(); });
+                _thread = std::thread([this]()
+                {
+                    apply_thread_policy(RS2_THREAD_ROLE_DEVICE_WATCHER);
+                    run();
+                });
+            }
+
+            bool start_from(const backend_device_group& devices, device_changed_callback callback) override
+            {
+                stop();
+                {
+                    std::lock_guard<std::mutex> lock(_m);
+                    _data._last = devices;
+                }
+                start(std::move(callback));
+                return true;
             }
 
             void stop() override
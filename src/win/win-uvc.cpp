@@ -34,6 +34,7 @@ The library will be compiled without the metadata support!\n")
 #include <vidcap.h>
 #include <ksmedia.h>    // Metadata Extension
 #include <Mferror.h>
+#include <mftransform.h>
 
 #pragma comment(lib, "Shlwapi.lib")
 #pragma comment(lib, "mf.lib")
@@ -210,7 +211,10 @@ namespace librealsense
                                 auto profile = stream.profile;
                                 frame_object f{ current_length, metadata_size, byte_buffer, metadata, monotonic_to_realtime(llTimestamp/10000.f) };
 
-                                auto continuation = [buffer, this]()
+                                // The sample goes back to the pool of the source once released, for its buffer to be filled again.
+                                // Zero-copy frames hold both until they are released, so that the pixels stay untouched meanwhile
+                                CComPtr<IMFSample> held_sample = sample;
+                                auto continuation = [buffer, held_sample]()
                                 {
                                     buffer->Unlock();
                                 };
@@ -1005,16 +1009,38 @@ namespace librealsense
             }
         }
 
-        void wmf_uvc_device::probe_and_commit(stream_profile profile, frame_callback callback, int /*buffers*/)
+        void wmf_uvc_device::probe_and_commit(stream_profile profile, frame_callback callback, int buffers)
         {
             if (_streaming)
                 throw std::runtime_error("Device is already streaming!");
 
             _profiles.push_back(profile);
             _frame_callbacks.push_back(callback);
+            _frame_buffers.push_back(buffers);
         }
 
-        void wmf_uvc_device::play_profile(stream_profile profile, frame_callback callback)
+        void wmf_uvc_device::set_sample_pool_size(DWORD sIndex, int buffers)
+        {
+            // The transforms the reader inserts allocate their output samples from pools that default to a few samples,
+            // short of the ones that zero-copy frames hold
+            CComPtr<IMFSourceReaderEx> reader_ex = nullptr;
+            if (FAILED(_reader->QueryInterface(IID_PPV_ARGS(&reader_ex))))
+                return;
+
+            for (DWORD t = 0;; ++t)
+            {
+                GUID category;
+                CComPtr<IMFTransform> transform = nullptr;
+                if (FAILED(reader_ex->GetTransformForStream(sIndex, t, &category, &transform)))
+                    break;
+
+                CComPtr<IMFAttributes> attributes = nullptr;
+                if (SUCCEEDED(transform->GetOutputStreamAttributes(0, &attributes)) && attributes)
+                    LOG_HR(attributes->SetUINT32(MF_SA_MINIMUM_OUTPUT_SAMPLE_COUNT, buffers));
+            }
+        }
+
+        void wmf_uvc_device::play_profile(stream_profile profile, frame_callback callback, int buffers)
         {
             CComPtr<IMFMediaType> pMediaType = nullptr;
             for (unsigned int sIndex = 0; sIndex < _streams.size(); ++sIndex)
@@ -1072,6 +1098,8 @@ namespace librealsense
 
                                 if (SUCCEEDED(hr) && pMediaType)
                                 {
+                                    set_sample_pool_size(sIndex, buffers);
+
                                     for (unsigned int i = 0; i < _streams.size(); ++i)
                                     {
                                         if (sIndex == i || (_streams[i].callback))
@@ -1133,7 +1161,7 @@ namespace librealsense
             {
                 for (uint32_t i = 0; i < _profiles.size(); ++i)
                 {
-                    play_profile(_profiles[i], _frame_callbacks[i]);
+                    play_profile(_profiles[i], _frame_callbacks[i], _frame_buffers[i]);
                 }
 
                 _streaming = true;
@@ -1146,6 +1174,7 @@ namespace librealsense
 
                 _profiles.clear();
                 _frame_callbacks.clear();
+                _frame_buffers.clear();
 
                 throw;
             }
@@ -1177,6 +1206,7 @@ namespace librealsense
             {
                 _profiles.erase(_profiles.begin() + pos);
                 _frame_callbacks.erase(_frame_callbacks.begin() + pos);
+                _frame_buffers.erase(_frame_buffers.begin() + pos);
             }
 
             if (_profiles.empty())
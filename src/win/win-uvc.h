@@ -97,7 +97,8 @@ namespace librealsense
         private:
             friend class source_reader_callback;
 
-            void play_profile(stream_profile profile, frame_callback callback);
+            void play_profile(stream_profile profile, frame_callback callback, int buffers);
+            void set_sample_pool_size(DWORD sIndex, int buffers);
             void stop_stream_cleanup(const stream_profile& profile, std::vector<profile_and_callback>::iterator& elem);
             void flush(int sIndex);
             void check_connection() const;
@@ -134,6 +135,7 @@ namespace librealsense
             usb_spec                                _device_usb_spec;
             std::vector<stream_profile>             _profiles;
             std::vector<frame_callback>             _frame_callbacks;
+            std::vector<int>                        _frame_buffers;     // Samples each stream may hold at once
             bool                                    _streaming = false;
             std::atomic<bool>                       _is_started = false;
         };
@@ -130,7 +130,11 @@ namespace librealsense
                 if (!_data._stopped) throw wrong_api_call_sequence_exception("Cannot start a running device_watcher");
                 _data._stopped = false;
                 _data._callback = std::move(callback);
-                _thread = std::thread([this]() { run(); });
+                _thread = std::thread([this]()
+                {
+                    apply_thread_policy(RS2_THREAD_ROLE_DEVICE_WATCHER);
+                    run();
+                });
             }
 
             void stop() override
@@ -537,13 +537,14 @@ namespace librealsense
         }
 
         // profile config- set control
-        void win7_uvc_device::probe_and_commit(stream_profile profile, frame_callback callback, int /*buffers*/)
+        void win7_uvc_device::probe_and_commit(stream_profile profile, frame_callback callback, int buffers)
         {
             if (_streaming)
                 throw std::runtime_error("Device is already streaming!");
 
             _profiles.push_back(profile);
             _frame_callbacks.push_back(callback);
+            _buffers.push_back(buffers);
         }
 
         /* callback context send for each frame for its specific profile */
@@ -561,7 +562,7 @@ namespace librealsense
             context->_callback(context->_profile, *frame, []() mutable {});
         }
 
-        void win7_uvc_device::play_profile(stream_profile profile, frame_callback callback)
+        void win7_uvc_device::play_profile(stream_profile profile, frame_callback callback, int buffers)
         {
             bool foundFormat = false;
 
@@ -612,7 +613,8 @@ namespace librealsense
             context->_this = this;
             context->_profile = profile;
 
-            winusb_start_streaming(_device.get(), &ctrl, internal_winusb_uvc_callback, context, 0);
+            // The buffers of the profile are the reads kept in flight on its endpoint
+            winusb_start_streaming(_device.get(), &ctrl, internal_winusb_uvc_callback, context, 0, buffers);
         }
 
         void win7_uvc_device::stream_on(std::function<void(const notification& n)> error_handler)
@@ -629,7 +631,7 @@ namespace librealsense
             {
                 for (uint32_t i = 0; i < _profiles.size(); ++i)
                 {
-                    play_profile(_profiles[i], _frame_callbacks[i]);
+                    play_profile(_profiles[i], _frame_callbacks[i], _buffers[i]);
                 }
 
                 _streaming = true;
@@ -642,6 +644,7 @@ namespace librealsense
 
                 _profiles.clear();
                 _frame_callbacks.clear();
+                _buffers.clear();
 
                 throw;
             }
@@ -673,6 +676,7 @@ namespace librealsense
             {
                 _profiles.erase(_profiles.begin() + pos);
                 _frame_callbacks.erase(_frame_callbacks.begin() + pos);
+                _buffers.erase(_buffers.begin() + pos);
             }
 
             if (_profiles.empty())
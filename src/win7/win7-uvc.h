@@ -82,7 +82,7 @@ namespace librealsense
             friend class source_reader_callback;
 
             int32_t rs2_value_translate(uvc_req_code action, rs2_option option, int32_t value) const;
-            void play_profile(stream_profile profile, frame_callback callback);
+            void play_profile(stream_profile profile, frame_callback callback, int buffers);
             void stop_stream_cleanup(const stream_profile& profile, std::vector<profile_and_callback>::iterator& elem);
             void flush(int sIndex);
             void check_connection() const;
@@ -104,6 +104,7 @@ namespace librealsense
             usb_spec                                _device_usb_spec;
             std::vector<stream_profile>             _profiles;
             std::vector<frame_callback>             _frame_callbacks;
+            std::vector<int>                        _buffers;
             bool                                    _streaming = false;
             std::atomic<bool>                       _is_started = false;
 
@@ -13,6 +13,7 @@
 #include <vector>
 #include <thread>
 #include <atomic>
+#include <deque>
 
 // Data structures for Backend-Frontend queue:
 struct frame;
@@ -911,13 +912,38 @@ void winusb_uvc_process_payload(winusb_uvc_stream_handle_t *strmh,
     }
 }
 
+// A read of the streaming endpoint, and the payload it received once it completed
+struct winusb_uvc_transfer
+{
+    std::vector<uint8_t> buffer;
+    OVERLAPPED overlapped;
+    DWORD transferred;
+};
+
+// Posts the overlapped read of a transfer. False when the read could not be queued
+static bool submit_transfer(winusb_uvc_stream_context *strctx, winusb_uvc_transfer* t)
+{
+    auto event = t->overlapped.hEvent;
+    t->overlapped = {};
+    t->overlapped.hEvent = event;
+    t->transferred = 0;
+    if (WinUsb_ReadPipe(strctx->stream->stream_if->associateHandle, strctx->endpoint,
+        t->buffer.data(), static_cast<ULONG>(t->buffer.size()), nullptr, &t->overlapped))
+        return true;
+    return GetLastError() == ERROR_IO_PENDING;
+}
+
+// Keeps numTransfers overlapped reads in flight on the endpoint, for it never to sit idle while a payload is processed.
+// The reads complete in the order they were posted, and hand their payloads over to a thread assembling the frames, the
+// buffers of twice as many transfers as are in flight giving the assembly room to fall behind without stalling the reads
 void stream_thread(winusb_uvc_stream_context *strctx)
 {
-    PUCHAR buffer = (PUCHAR)malloc(strctx->maxPayloadTransferSize);
-    memset(buffer, 0, sizeof(strctx->maxPayloadTransferSize));
+    auto handle = strctx->stream->stream_if->associateHandle;
+    const size_t buffer_count = strctx->numTransfers * 2;
 
     frames_archive archive;
     std::atomic_bool keep_sending_callbacks = true;
+    std::atomic_bool keep_assembling = true;
     frames_queue queue;
 
     // Get all pointers from archive and initialize their content
@@ -934,6 +960,20 @@ void stream_thread(winusb_uvc_stream_context *strctx)
         archive.deallocate(ptr);
     }
 
+    std::vector<std::unique_ptr<winusb_uvc_transfer>> transfers;
+    single_consumer_queue<winusb_uvc_transfer*> free_transfers(static_cast<unsigned int>(buffer_count));
+    single_consumer_queue<winusb_uvc_transfer*> completed_transfers(static_cast<unsigned int>(buffer_count));
+    for (size_t i = 0; i < buffer_count; i++)
+    {
+        std::unique_ptr<winusb_uvc_transfer> t(new winusb_uvc_transfer());
+        t->buffer.resize(strctx->maxPayloadTransferSize, 0);
+        t->overlapped = {};
+        t->overlapped.hEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+        t->transferred = 0;
+        free_transfers.enqueue(t.get());
+        transfers.push_back(std::move(t));
+    }
+
     std::thread t([&]() {
         while (keep_sending_callbacks)
         {
@@ -945,27 +985,83 @@ void stream_thread(winusb_uvc_stream_context *strctx)
         }
     });
 
-    do {
-        DWORD transferred;
-        if (!WinUsb_ReadPipe(strctx->stream->stream_if->associateHandle,
-            strctx->endpoint,
-            buffer,
-            strctx->maxPayloadTransferSize,
-            &transferred,
-            NULL)) 
+    std::thread assembly([&]() {
+        librealsense::apply_thread_policy(RS2_THREAD_ROLE_CAPTURE);
+        while (keep_assembling)
+        {
+            winusb_uvc_transfer* completed = nullptr;
+            if (completed_transfers.dequeue(&completed, 50))
             {
-                printf("WinUsb_ReadPipe Error: %d\n" + GetLastError());
-                break;
+                LOG_DEBUG("Packet received with size " << completed->transferred);
+                winusb_uvc_process_payload(strctx->stream, completed->buffer.data(), completed->transferred, &archive, &queue);
+                free_transfers.enqueue(std::move(completed));
             }
+        }
+    });
 
-        LOG_DEBUG("Packet received with size " << transferred);
-        winusb_uvc_process_payload(strctx->stream, buffer, transferred, &archive, &queue);
-    } while (strctx->stream->running);
+    std::deque<winusb_uvc_transfer*> in_flight;
+    auto failed = false;
+    auto submit_free_transfer = [&](unsigned int timeout_ms)
+    {
+        winusb_uvc_transfer* next = nullptr;
+        if (!free_transfers.dequeue(&next, timeout_ms))
+            return;
+        if (!submit_transfer(strctx, next))
+        {
+            LOG_ERROR("WinUsb_ReadPipe Error: " << GetLastError());
+            free_transfers.enqueue(std::move(next));
+            failed = true;
+            return;
+        }
+        in_flight.push_back(next);
+    };
+
+    for (int i = 0; i < strctx->numTransfers && !failed; i++)
+        submit_free_transfer(0);
+
+    while (strctx->stream->running && !failed)
+    {
+        // Short of free buffers, the assembly fell behind by as many payloads as there are buffers and the reads left in
+        // flight keep the endpoint busy, the read being posted again once the assembly lets go of a buffer
+        if (in_flight.size() < static_cast<size_t>(strctx->numTransfers))
+            submit_free_transfer(in_flight.empty() ? 10 : 0);
+        if (in_flight.empty())
+            continue;
+
+        auto oldest = in_flight.front();
+        if (WaitForSingleObject(oldest->overlapped.hEvent, 100) == WAIT_TIMEOUT)
+            continue;
+
+        if (!WinUsb_GetOverlappedResult(handle, &oldest->overlapped, &oldest->transferred, FALSE))
+        {
+            LOG_ERROR("WinUsb_GetOverlappedResult Error: " << GetLastError());
+            failed = true;
+            break;
+        }
+        in_flight.pop_front();
+        completed_transfers.enqueue(std::move(oldest));
+    }
+
+    // Cancel the reads still in flight, and wait for them to let go of their buffers
+    WinUsb_AbortPipe(handle, strctx->endpoint);
+    for (auto pending : in_flight)
+    {
+        DWORD transferred;
+        WinUsb_GetOverlappedResult(handle, &pending->overlapped, &transferred, TRUE);
+    }
+    in_flight.clear();
 
     // reseting pipe after use
-    auto ret = WinUsb_ResetPipe(strctx->stream->stream_if->associateHandle, strctx->endpoint);
+    auto ret = WinUsb_ResetPipe(handle, strctx->endpoint);
+
+    keep_assembling = false;
+    assembly.join();
+    completed_transfers.clear();
+    free_transfers.clear();
+    for (auto&& tr : transfers)
+        CloseHandle(tr->overlapped.hEvent);
+    transfers.clear();
 
-    free(buffer);
     free(strctx);
 
     queue.clear();
@@ -979,7 +1075,8 @@ uvc_error_t winusb_uvc_stream_start(
     winusb_uvc_stream_handle_t *strmh,
     winusb_uvc_frame_callback_t *cb,
     void *user_ptr,
-    uint8_t flags
+    uint8_t flags,
+    int num_transfers
 ) {
     /* USB interface we'll be using */
     winusb_uvc_interface *iface;
@@ -1021,8 +1118,15 @@ uvc_error_t winusb_uvc_stream_start(
     streamctx->endpoint = format_desc->parent->bEndpointAddress;
     streamctx->iface = iface;
     streamctx->maxPayloadTransferSize = strmh->cur_ctrl.dwMaxPayloadTransferSize;
+    if (num_transfers <= 0)
+        num_transfers = WINUSB_UVC_DEFAULT_TRANSFER_BUFS;
+    streamctx->numTransfers = num_transfers < WINUSB_UVC_NUM_TRANSFER_BUFS ? num_transfers : WINUSB_UVC_NUM_TRANSFER_BUFS;
     strmh->user_ptr = user_ptr;
-    strmh->cb_thread = std::thread(stream_thread, streamctx);
+    strmh->cb_thread = std::thread([streamctx]()
+    {
+        librealsense::apply_thread_policy(RS2_THREAD_ROLE_CAPTURE);
+        stream_thread(streamctx);
+    });
     strmh->user_cb = cb;
 
 
@@ -1061,7 +1165,8 @@ void winusb_uvc_stream_close(winusb_uvc_stream_handle_t *strmh)
 
 uvc_error_t winusb_uvc_stream_open_ctrl(winusb_uvc_device *devh, winusb_uvc_stream_handle_t **strmhp, uvc_stream_ctrl_t *ctrl);
 
-uvc_error_t winusb_start_streaming(winusb_uvc_device *devh, uvc_stream_ctrl_t *ctrl, winusb_uvc_frame_callback_t *cb, void *user_ptr, uint8_t flags)
+uvc_error_t winusb_start_streaming(winusb_uvc_device *devh, uvc_stream_ctrl_t *ctrl, winusb_uvc_frame_callback_t *cb, void *user_ptr, uint8_t flags,
+    int num_transfers)
 {
     uvc_error_t ret;
     winusb_uvc_stream_handle_t *strmh;
@@ -1072,7 +1177,7 @@ uvc_error_t winusb_start_streaming(winusb_uvc_device *devh, uvc_stream_ctrl_t *c
         return ret;
     }
 
-    ret = winusb_uvc_stream_start(strmh, cb, user_ptr, flags);
+    ret = winusb_uvc_stream_start(strmh, cb, user_ptr, flags, num_transfers);
     if (ret != UVC_SUCCESS)
     {
         winusb_uvc_stream_close(strmh);
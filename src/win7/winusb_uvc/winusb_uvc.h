@@ -21,6 +21,9 @@ enum uvc_req_code {
 };
 
 #define LIBUVC_XFER_BUF_SIZE	( 16 * 1024 * 1024 )
+// Overlapped reads of the streaming endpoint kept in flight
+#define WINUSB_UVC_NUM_TRANSFER_BUFS 32
+#define WINUSB_UVC_DEFAULT_TRANSFER_BUFS 4
 #define MAX_USB_INTERFACES 20
 
 struct winusb_uvc_interface {
@@ -413,6 +416,7 @@ typedef struct winusb_uvc_stream_context {
     winusb_uvc_stream_handle_t *stream;
     int endpoint;
     int maxPayloadTransferSize;
+    int numTransfers;
     winusb_uvc_interface *iface;
 }winusb_uvc_stream_context_t;
 
@@ -651,8 +655,9 @@ uvc_error_t winusb_get_stream_ctrl_format_size(winusb_uvc_device *devh, uvc_stre
 // Get a negotiated streaming control block for some common parameters for all interfaces
 uvc_error_t winusb_get_stream_ctrl_format_size_all(winusb_uvc_device *devh, uvc_stream_ctrl_t *ctrl, uint32_t fourcc, int width, int height, int fps);
 
-// Start video streaming
-uvc_error_t winusb_start_streaming(winusb_uvc_device *devh, uvc_stream_ctrl_t *ctrl, winusb_uvc_frame_callback_t *cb, void *user_ptr, uint8_t flags);
+// Start video streaming, with num_transfers reads kept in flight, up to WINUSB_UVC_NUM_TRANSFER_BUFS. Zero for the default
+uvc_error_t winusb_start_streaming(winusb_uvc_device *devh, uvc_stream_ctrl_t *ctrl, winusb_uvc_frame_callback_t *cb, void *user_ptr, uint8_t flags,
+    int num_transfers = 0);
 
 uvc_error_t update_stream_if_handle(winusb_uvc_device *devh, int interface_idx);
 
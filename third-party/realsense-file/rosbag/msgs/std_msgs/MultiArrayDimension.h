@@ -6,6 +6,7 @@
 #define STD_MSGS_MESSAGE_MULTIARRAYDIMENSION_H
 
 
+#include <memory>
 #include <string>
 #include <vector>
 #include <map>
@@ -49,15 +50,15 @@ struct MultiArrayDimension_
 
 
 
-  typedef boost::shared_ptr< ::std_msgs::MultiArrayDimension_<ContainerAllocator> > Ptr;
-  typedef boost::shared_ptr< ::std_msgs::MultiArrayDimension_<ContainerAllocator> const> ConstPtr;
+  typedef std::shared_ptr< ::std_msgs::MultiArrayDimension_<ContainerAllocator> > Ptr;
+  typedef std::shared_ptr< ::std_msgs::MultiArrayDimension_<ContainerAllocator> const> ConstPtr;
 
 }; // struct MultiArrayDimension_
 
 typedef ::std_msgs::MultiArrayDimension_<std::allocator<void> > MultiArrayDimension;
 
-typedef boost::shared_ptr< ::std_msgs::MultiArrayDimension > MultiArrayDimensionPtr;
-typedef boost::shared_ptr< ::std_msgs::MultiArrayDimension const> MultiArrayDimensionConstPtr;
+typedef std::shared_ptr< ::std_msgs::MultiArrayDimension > MultiArrayDimensionPtr;
+typedef std::shared_ptr< ::std_msgs::MultiArrayDimension const> MultiArrayDimensionConstPtr;
 
 // constants requiring out of line definition
 
@@ -123,6 +123,16 @@ public:
     std::tuple<std::string, uint64_t, uint64_t> getCompressionInfo() const;
     void            setChunkThreshold(uint32_t chunk_threshold);  //!< Set the threshold for creating new chunks
     uint32_t        getChunkThreshold() const;                    //!< Get the threshold for creating new chunks
+    bool            setMappedRead(bool mapped);                   //!< Read the bag open for reading through a memory mapping of its file, false if it cannot be mapped
+    bool            isMappedRead() const;                         //!< Get whether the bag is read through a memory mapping
+    void            setIndexFile(std::string const& filename);    //!< Set a sidecar file of the message indexes, written on closing the bag after writing, and read on opening it instead of the indexes after every chunk
+    bool            isIndexFileRead() const;                      //!< Get whether the message indexes of the open bag were read from its index file
+
+    //! Find the time of the last message of a topic at or before the given time, through the message indexes
+    /*!
+     * \return false if the topic has no message at or before the time
+     */
+    bool findLastMessageTime(std::string const& topic, ros::Time const& end_time, ros::Time& time) const;
 
     //! Write a message into the bag file
     /*!
@@ -192,6 +202,8 @@ private:
 
     void startReadingVersion102();
     void startReadingVersion200();
+    bool readIndexFile();
+    void writeIndexFile() const;
 
     // Writing
 
@@ -285,6 +297,9 @@ private:
     uint32_t connection_count_;
     uint32_t chunk_count_;
 
+    std::string index_file_;
+    bool        index_file_read_;
+
     // Current chunk
     bool      chunk_open_;
     ChunkInfo curr_chunk_info_;
@@ -585,16 +600,8 @@ void Bag::writeMessageDataRecord(uint32_t conn_id, ros::Time const& time, T cons
     header[CONNECTION_FIELD_NAME] = toHeaderString(&conn_id);
     header[TIME_FIELD_NAME]       = toHeaderString(&time);
 
-    // Assemble message in memory first, because we need to write its length
     uint32_t msg_ser_len = ros::serialization::serializationLength(msg);
 
-    record_buffer_.setSize(msg_ser_len);
-
-    ros::serialization::OStream s(record_buffer_.getData(), msg_ser_len);
-
-    // todo: serialize into the outgoing_chunk_buffer & remove record_buffer_
-    ros::serialization::serialize(s, msg);
-
     // We do an extra seek here since writing our data record may
     // have indirectly moved our file-pointer if it was a
     // MessageInstance for our own bag
@@ -604,17 +611,19 @@ void Bag::writeMessageDataRecord(uint32_t conn_id, ros::Time const& time, T cons
     CONSOLE_BRIDGE_logDebug("Writing MSG_DATA [%llu:%d]: conn=%d sec=%d nsec=%d data_len=%d",
               (unsigned long long) file_.getOffset(), getChunkOffset(), conn_id, time.sec, time.nsec, msg_ser_len);
 
-    writeHeader(header);
-    writeDataLength(msg_ser_len);
-    write((char*) record_buffer_.getData(), msg_ser_len);
-
     // todo: use better abstraction than appendHeaderToBuffer
     appendHeaderToBuffer(outgoing_chunk_buffer_, header);
     appendDataLengthToBuffer(outgoing_chunk_buffer_, msg_ser_len);
 
+    // Serialized straight into the outgoing chunk, and written to the file from there
     uint32_t offset = outgoing_chunk_buffer_.getSize();
     outgoing_chunk_buffer_.setSize(outgoing_chunk_buffer_.getSize() + msg_ser_len);
-    memcpy(outgoing_chunk_buffer_.getData() + offset, record_buffer_.getData(), msg_ser_len);
+    ros::serialization::OStream s(outgoing_chunk_buffer_.getData() + offset, msg_ser_len);
+    ros::serialization::serialize(s, msg);
+
+    writeHeader(header);
+    writeDataLength(msg_ser_len);
+    write((char*) outgoing_chunk_buffer_.getData() + offset, msg_ser_len);
 
     // Update the current chunk time range
     if (time > curr_chunk_info_.end_time)
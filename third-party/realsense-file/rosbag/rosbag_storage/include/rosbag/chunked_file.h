@@ -69,6 +69,10 @@ public:
     void        setReadMode(CompressionType type);
     void        setWriteMode(CompressionType type);
 
+    bool        map();                                          //!< map the file open for reading to memory, for reads without system calls. false if it cannot be mapped
+    void        unmap();                                        //!< read the file through its file pointer again
+    bool        isMapped()             const;                   //!< return true if the file is read through a memory mapping
+
     // File I/O
     void        write(std::string const& s);
     void        write(void* ptr, size_t size);                          //!< write size bytes from ptr to the file
@@ -90,6 +94,10 @@ private:
     char*       unused_;         //!< extra data read by compressed stream
     int         nUnused_;        //!< number of bytes of extra data read by compressed stream
 
+    const char* mapped_;         //!< memory mapping of the file, null when it is not mapped
+    uint64_t    mapped_size_;    //!< size of the memory mapping
+    void*       mapping_;        //!< handle of the memory mapping on Windows
+
 	std::shared_ptr<StreamFactory> stream_factory_;
 
 	std::shared_ptr<Stream> read_stream_;
@@ -90,6 +90,9 @@ protected:
     void     setUnused(char* unused);
     void     setUnusedLength(int nUnused);
     void     clearUnused();
+    uint64_t getOffset();
+    const char* getMapped();
+    uint64_t getMappedSize();
 
 protected:
     ChunkedFile* file_;
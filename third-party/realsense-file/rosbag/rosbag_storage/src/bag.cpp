@@ -38,6 +38,8 @@
 #include <signal.h>
 #include <assert.h>
 #include <iomanip>
+#include <cstdio>
+#include <fstream>
 #include <map>
 #include <tuple>
 #include <boost/foreach.hpp>
@@ -70,6 +72,7 @@ Bag::Bag() :
     index_data_pos_(0),
     connection_count_(0),
     chunk_count_(0),
+    index_file_read_(false),
     chunk_open_(false),
     curr_chunk_data_pos_(0),
     current_buffer_(0),
@@ -86,6 +89,7 @@ Bag::Bag(string const& filename, uint32_t mode) :
     index_data_pos_(0),
     connection_count_(0),
     chunk_count_(0),
+    index_file_read_(false),
     chunk_open_(false),
     curr_chunk_data_pos_(0),
     current_buffer_(0),
@@ -133,6 +137,10 @@ void Bag::openRead(string const& filename) {
 void Bag::openWrite(string const& filename) {
     file_.openWrite(filename);
 
+    // An index file left from a former bag of the same name is of no use
+    if (!index_file_.empty())
+        std::remove(index_file_.c_str());
+
     startWriting();
 }
 
@@ -175,15 +183,25 @@ void Bag::close() {
     chunks_.clear();
     connection_indexes_.clear();
     curr_chunk_connection_indexes_.clear();
+    index_file_read_ = false;
 }
 
 void Bag::closeWrite() {
     stopWriting();
+
+    if (!index_file_.empty())
+        writeIndexFile();
 }
 
 string   Bag::getFileName() const { return file_.getFileName(); }
 BagMode  Bag::getMode()     const { return mode_;               }
-uint64_t Bag::getSize()     const { return file_size_;          }
+uint64_t Bag::getSize()     const
+{
+    // Chunks in the writing are in the file once they are done
+    if (mode_ & (bagmode::Write | bagmode::Append))
+        return file_.getOffset();
+    return file_size_;
+}
 
 uint32_t Bag::getChunkThreshold() const { return chunk_threshold_; }
 
@@ -238,6 +256,165 @@ std::tuple<std::string, uint64_t, uint64_t> Bag::getCompressionInfo() const
     //auto main_compression_count = compression_counts.begin()->second;
     return std::make_tuple(main_compression, compressed, uncompressed);
 }
+// Index file
+
+namespace {
+    const char     INDEX_FILE_MAGIC[8] = { 'R', 'S', 'B', 'A', 'G', 'I', 'D', 'X' };
+    const uint32_t INDEX_FILE_VERSION  = 1;
+
+    // Identifies the bag the index file was written for
+    struct IndexFileHeader
+    {
+        char     magic[8];
+        uint32_t version;
+        uint32_t connection_count;
+        uint64_t file_size;
+        uint64_t index_data_pos;
+        uint32_t chunk_count;
+        uint32_t index_count;
+    };
+
+    struct IndexFileEntry
+    {
+        uint64_t chunk_pos;
+        uint32_t sec;
+        uint32_t nsec;
+        uint32_t offset;
+        uint32_t reserved;
+    };
+}
+
+void Bag::setIndexFile(string const& filename) { index_file_ = filename; }
+bool Bag::isIndexFileRead() const { return index_file_read_; }
+
+void Bag::writeIndexFile() const {
+    seek(0, std::ios::end);
+
+    IndexFileHeader header;
+    memcpy(header.magic, INDEX_FILE_MAGIC, sizeof(header.magic));
+    header.version          = INDEX_FILE_VERSION;
+    header.connection_count = connection_count_;
+    header.file_size        = file_.getOffset();
+    header.index_data_pos   = index_data_pos_;
+    header.chunk_count      = chunk_count_;
+    header.index_count      = static_cast<uint32_t>(connection_indexes_.size());
+
+    std::ofstream out(index_file_.c_str(), std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    vector<IndexFileEntry> entries;
+    for (map<uint32_t, multiset<IndexEntry> >::const_iterator i = connection_indexes_.begin(); i != connection_indexes_.end(); i++) {
+        uint32_t connection_id = i->first;
+        uint32_t count         = static_cast<uint32_t>(i->second.size());
+        out.write(reinterpret_cast<const char*>(&connection_id), sizeof(connection_id));
+        out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+
+        entries.clear();
+        entries.reserve(count);
+        foreach(IndexEntry const& e, i->second) {
+            IndexFileEntry entry = { e.chunk_pos, e.time.sec, e.time.nsec, e.offset, 0 };
+            entries.push_back(entry);
+        }
+        if (!entries.empty())
+            out.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(IndexFileEntry));
+    }
+
+    if (!out) {
+        CONSOLE_BRIDGE_logWarn("Error writing index file %s", index_file_.c_str());
+        out.close();
+        std::remove(index_file_.c_str());
+    }
+}
+
+bool Bag::readIndexFile() {
+    if (index_file_.empty())
+        return false;
+
+    std::ifstream in(index_file_.c_str(), std::ios::binary);
+    if (!in)
+        return false;
+
+    uint64_t offset = file_.getOffset();
+    seek(0, std::ios::end);
+    uint64_t file_size = file_.getOffset();
+    seek(offset);
+
+    IndexFileHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        memcmp(header.magic, INDEX_FILE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version          != INDEX_FILE_VERSION ||
+        header.connection_count != connection_count_ ||
+        header.file_size        != file_size ||
+        header.index_data_pos   != index_data_pos_ ||
+        header.chunk_count      != chunk_count_) {
+        CONSOLE_BRIDGE_logDebug("Index file %s is not of %s", index_file_.c_str(), file_.getFileName().c_str());
+        return false;
+    }
+
+    map<uint32_t, multiset<IndexEntry> > connection_indexes;
+    vector<IndexFileEntry> entries;
+    for (uint32_t i = 0; i < header.index_count; i++) {
+        uint32_t connection_id;
+        uint32_t count;
+        if (!in.read(reinterpret_cast<char*>(&connection_id), sizeof(connection_id)) ||
+            !in.read(reinterpret_cast<char*>(&count), sizeof(count)) ||
+            connections_.find(connection_id) == connections_.end())
+            return false;
+
+        entries.resize(count);
+        if (count > 0 && !in.read(reinterpret_cast<char*>(entries.data()), count * sizeof(IndexFileEntry)))
+            return false;
+
+        // The entries are in the order of the index they were written from
+        multiset<IndexEntry>& connection_index = connection_indexes[connection_id];
+        foreach(IndexFileEntry const& entry, entries) {
+            IndexEntry index_entry;
+            index_entry.time      = Time(entry.sec, entry.nsec);
+            index_entry.chunk_pos = entry.chunk_pos;
+            index_entry.offset    = entry.offset;
+            connection_index.insert(connection_index.end(), index_entry);
+        }
+    }
+
+    connection_indexes_.swap(connection_indexes);
+    index_file_read_ = true;
+    return true;
+}
+
+bool Bag::setMappedRead(bool mapped) {
+    if (!mapped) {
+        file_.unmap();
+        return true;
+    }
+    if (!(mode_ & bagmode::Read) || (mode_ & (bagmode::Write | bagmode::Append)))
+        return false;
+    return file_.map();
+}
+
+bool Bag::isMappedRead() const { return file_.isMapped(); }
+
+bool Bag::findLastMessageTime(string const& topic, Time const& end_time, Time& time) const {
+    bool found = false;
+    for (map<uint32_t, ConnectionInfo*>::const_iterator i = connections_.begin(); i != connections_.end(); i++) {
+        if (i->second->topic != topic)
+            continue;
+
+        map<uint32_t, multiset<IndexEntry> >::const_iterator index = connection_indexes_.find(i->first);
+        if (index == connection_indexes_.end())
+            continue;
+
+        IndexEntry end_entry;
+        end_entry.time = end_time;
+        multiset<IndexEntry>::const_iterator next = index->second.upper_bound(end_entry);
+        if (next == index->second.begin())
+            continue;
+        --next;
+        if (!found || time < next->time)
+            time = next->time;
+        found = true;
+    }
+    return found;
+}
+
 void Bag::setCompression(CompressionType compression) {
     if (file_.isOpen() && chunk_open_)
         stopWritingChunk();
@@ -323,7 +500,11 @@ void Bag::startReadingVersion200() {
     for (uint32_t i = 0; i < chunk_count_; i++)
         readChunkInfoRecord();
 
-    // Read the connection indexes for each chunk
+    // Read the connection indexes from the index file, in a single read rather than a seek per chunk
+    if (readIndexFile())
+        return;
+
+    // Or from after each chunk
     foreach(ChunkInfo const& chunk_info, chunks_) {
         curr_chunk_info_ = chunk_info;
 
@@ -38,6 +38,16 @@
 
 #include "boost/format.hpp"
 
+#ifdef _WIN32
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    include <io.h>
+#    include <windows.h>
+#else
+#    include <sys/mman.h>
+#endif
+
 //#include <ros/ros.h>
 #ifdef _WIN32
 #    ifdef __MINGW32__
@@ -65,7 +75,10 @@ ChunkedFile::ChunkedFile() :
     offset_(0),
     compressed_in_(0),
     unused_(NULL),
-    nUnused_(0)
+    nUnused_(0),
+    mapped_(NULL),
+    mapped_size_(0),
+    mapping_(NULL)
 {
     stream_factory_ = std::make_shared<StreamFactory>(this);
 }
@@ -138,6 +151,8 @@ void ChunkedFile::close() {
     // Close any compressed stream by changing to uncompressed mode
     setWriteMode(compression::Uncompressed);
 
+    unmap();
+
     // Close the file
     int success = fclose(file_);
     if (success != 0)
@@ -188,6 +203,67 @@ void ChunkedFile::seek(uint64_t offset, int origin) {
     offset_ = ftello(file_);
 }
 
+bool ChunkedFile::map() {
+    if (!file_)
+        throw BagIOException("Can't map - file not open");
+    if (mapped_)
+        return true;
+
+    // The size of the file, keeping the offset of the file pointer
+    uint64_t offset = offset_;
+    if (fseeko(file_, 0, SEEK_END) != 0)
+        return false;
+    uint64_t size = ftello(file_);
+    if (fseeko(file_, offset, SEEK_SET) != 0)
+        throw BagIOException("Error seeking");
+    if (size == 0 || size > static_cast<uint64_t>(static_cast<size_t>(-1)))
+        return false;
+
+#ifdef _WIN32
+    HANDLE file = reinterpret_cast<HANDLE>(_get_osfhandle(fileno(file_)));
+    HANDLE mapping = CreateFileMapping(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping == NULL)
+        return false;
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (data == NULL) {
+        CloseHandle(mapping);
+        return false;
+    }
+    mapping_ = mapping;
+#else
+    void* data = mmap(NULL, static_cast<size_t>(size), PROT_READ, MAP_SHARED, fileno(file_), 0);
+    if (data == MAP_FAILED)
+        return false;
+    // Messages are mostly read in order, for the kernel to read ahead of them
+    madvise(data, static_cast<size_t>(size), MADV_SEQUENTIAL);
+#endif
+
+    mapped_ = static_cast<const char*>(data);
+    mapped_size_ = size;
+    return true;
+}
+
+void ChunkedFile::unmap() {
+    if (!mapped_)
+        return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(mapped_);
+    CloseHandle(static_cast<HANDLE>(mapping_));
+    mapping_ = NULL;
+#else
+    munmap(const_cast<char*>(mapped_), static_cast<size_t>(mapped_size_));
+#endif
+    mapped_ = NULL;
+    mapped_size_ = 0;
+
+    // Reads through the file pointer resume where the mapped reads left off
+    if (file_ && fseeko(file_, offset_, SEEK_SET) != 0)
+        throw BagIOException("Error seeking");
+}
+
+bool ChunkedFile::isMapped() const { return mapped_ != NULL; }
+
 uint64_t ChunkedFile::getOffset()            const { return offset_;        }
 uint32_t ChunkedFile::getCompressedBytesIn() const { return static_cast<uint32_t>(compressed_in_); }
 
@@ -203,6 +279,9 @@ bool ChunkedFile::truncate(uint64_t length) {
 //! \todo add error handling
 string ChunkedFile::getline() {
     char buffer[1024];
+    // Mapped reads leave the file pointer behind
+    if (mapped_ && fseeko(file_, offset_, SEEK_SET) != 0)
+        return string("");
     if(fgets(buffer, 1024, file_))
     {
       string s(buffer);
@@ -77,5 +77,8 @@ int      Stream::getUnusedLength()                { return file_->nUnused_;
 void     Stream::setUnused(char* unused)          { file_->unused_ = unused;        }
 void     Stream::setUnusedLength(int nUnused)     { file_->nUnused_ = nUnused;      }
 void     Stream::clearUnused()                    { file_->clearUnused();           }
+uint64_t Stream::getOffset()                      { return file_->offset_;          }
+const char* Stream::getMapped()                  { return file_->mapped_;          }
+uint64_t Stream::getMappedSize()                 { return file_->mapped_size_;     }
 
 } // namespace rosbag
@@ -96,7 +96,18 @@ void UncompressedStream::read(void* ptr, size_t size) {
         }
     }
     
-    // No unused data - read from stream
+    // No unused data - read from the memory mapping, if any
+    if (getMapped()) {
+        uint64_t offset = getOffset();
+        if (offset > getMappedSize() || size > getMappedSize() - offset)
+            throw BagIOException((format("Error reading from file: wanted %1% bytes, read %2% bytes") % size % (offset < getMappedSize() ? getMappedSize() - offset : 0)).str());
+
+        memcpy(ptr, getMapped() + offset, size);
+        advanceOffset(size);
+        return;
+    }
+
+    // Or from stream
     int result = static_cast<int>(fread( ptr, 1, static_cast<int>(size), getFilePointer()));
     if ((size_t) result != size)
         throw BagIOException((format("Error reading from file: wanted %1% bytes, read %2% bytes") % size % result).str());
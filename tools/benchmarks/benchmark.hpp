@@ -0,0 +1,320 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#ifndef __RS_BENCHMARKS_BENCHMARK_H
+#define __RS_BENCHMARKS_BENCHMARK_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// A harness after Google Benchmark, with its command line flags and its JSON output, for its tools to compare the results
+namespace rs2 {
+    namespace tools {
+        namespace benchmark {
+
+            class state
+            {
+            public:
+                explicit state(uint64_t iterations) : _iterations(iterations), _remaining(iterations) {}
+
+                // Counts the iterations down, timing them from the first call
+                bool keep_running()
+                {
+                    if (_remaining == _iterations && !_started)
+                    {
+                        _started = true;
+                        resume_timing();
+                    }
+                    if (_remaining == 0 || !_error.empty())
+                    {
+                        if (_running) pause_timing();
+                        return false;
+                    }
+                    --_remaining;
+                    return true;
+                }
+
+                // Leaves the setup of an iteration out of the times
+                void pause_timing()
+                {
+                    _real += std::chrono::duration<double>(std::chrono::steady_clock::now() - _real_start).count();
+                    _cpu += double(std::clock() - _cpu_start) / CLOCKS_PER_SEC;
+                    _running = false;
+                }
+
+                void resume_timing()
+                {
+                    _real_start = std::chrono::steady_clock::now();
+                    _cpu_start = std::clock();
+                    _running = true;
+                }
+
+                void set_bytes_processed(uint64_t bytes) { _bytes = bytes; }
+                void set_items_processed(uint64_t items) { _items = items; }
+                void set_label(const std::string& label) { _label = label; }
+                void skip_with_error(const std::string& message) { _error = message; }
+
+                uint64_t iterations() const { return _iterations; }
+                double real_time() const { return _real; }
+                double cpu_time() const { return _cpu; }
+                uint64_t bytes_processed() const { return _bytes; }
+                uint64_t items_processed() const { return _items; }
+                const std::string& label() const { return _label; }
+                const std::string& error() const { return _error; }
+
+            private:
+                const uint64_t _iterations;
+                uint64_t _remaining;
+                bool _started = false;
+                bool _running = false;
+                std::chrono::steady_clock::time_point _real_start;
+                std::clock_t _cpu_start = 0;
+                double _real = 0;       // Seconds
+                double _cpu = 0;
+                uint64_t _bytes = 0;
+                uint64_t _items = 0;
+                std::string _label;
+                std::string _error;
+            };
+
+            typedef std::function<void(state&)> function;
+
+            struct result
+            {
+                std::string name;
+                uint64_t iterations;
+                double real_time;       // Nanoseconds per iteration
+                double cpu_time;
+                double bytes_per_second;
+                double items_per_second;
+                std::string label;
+                std::string error;
+            };
+
+            class registry
+            {
+            public:
+                static registry& instance()
+                {
+                    static registry r;
+                    return r;
+                }
+
+                void add(const std::string& name, function f) { _benchmarks.emplace_back(name, f); }
+
+                // Parses the flags of Google Benchmark it knows, leaving the others to the caller. 0 once every benchmark ran
+                int run(int argc, char** argv, const std::map<std::string, std::string>& context)
+                {
+                    std::string filter = ".";
+                    std::string format = "console";
+                    std::string out_file;
+                    std::string out_format = "json";
+                    double min_time = 0.5;
+                    bool list = false;
+                    for (int i = 1; i < argc; ++i)
+                    {
+                        std::string arg = argv[i];
+                        auto value = [&arg](const std::string& flag, std::string& out) {
+                            if (arg.compare(0, flag.size() + 1, flag + "=") != 0) return false;
+                            out = arg.substr(flag.size() + 1);
+                            return true; };
+                        std::string v;
+                        if (value("--benchmark_filter", v)) filter = v;
+                        else if (value("--benchmark_format", v)) format = v;
+                        else if (value("--benchmark_out", v)) out_file = v;
+                        else if (value("--benchmark_out_format", v)) out_format = v;
+                        else if (value("--benchmark_min_time", v)) min_time = std::max(std::atof(v.c_str()), 0.001);
+                        else if (arg == "--benchmark_list_tests" || arg == "--benchmark_list_tests=true") list = true;
+                    }
+
+                    std::regex pattern;
+                    try
+                    {
+                        pattern = std::regex(filter);
+                    }
+                    catch (const std::regex_error&)
+                    {
+                        std::cerr << "Invalid --benchmark_filter " << filter << std::endl;
+                        return EXIT_FAILURE;
+                    }
+
+                    std::vector<result> results;
+                    if (format == "console" && !list)
+                        print_console_header(std::cout, context);
+                    for (auto&& b : _benchmarks)
+                    {
+                        if (!std::regex_search(b.first, pattern))
+                            continue;
+                        if (list)
+                        {
+                            std::cout << b.first << std::endl;
+                            continue;
+                        }
+
+                        results.push_back(measure(b.first, b.second, min_time));
+                        if (format == "console")
+                            print_console(std::cout, results.back());
+                    }
+                    if (list)
+                        return EXIT_SUCCESS;
+
+                    if (format == "json")
+                        print_json(std::cout, context, results);
+                    if (!out_file.empty())
+                    {
+                        std::ofstream out(out_file);
+                        if (out_format == "json")
+                            print_json(out, context, results);
+                        else
+                        {
+                            print_console_header(out, context);
+                            for (auto&& r : results)
+                                print_console(out, r);
+                        }
+                        if (!out)
+                        {
+                            std::cerr << "Could not write " << out_file << std::endl;
+                            return EXIT_FAILURE;
+                        }
+                    }
+
+                    return std::any_of(results.begin(), results.end(), [](const result& r) { return !r.error.empty(); })
+                        ? EXIT_FAILURE : EXIT_SUCCESS;
+                }
+
+            private:
+                // Grows the iterations until they run for the minimal time, predicting the count from the last run as Google Benchmark does
+                static result measure(const std::string& name, const function& f, double min_time)
+                {
+                    uint64_t iterations = 1;
+                    while (true)
+                    {
+                        state s(iterations);
+                        try
+                        {
+                            f(s);
+                        }
+                        catch (const std::exception& e)
+                        {
+                            s.skip_with_error(e.what());
+                        }
+
+                        if (!s.error().empty() || s.real_time() >= min_time || iterations >= 1000000000)
+                        {
+                            result r{ name, iterations, s.real_time() * 1e9 / iterations, s.cpu_time() * 1e9 / iterations, 0, 0, s.label(), s.error() };
+                            if (s.real_time() > 0)
+                            {
+                                r.bytes_per_second = s.bytes_processed() / s.real_time();
+                                r.items_per_second = s.items_processed() / s.real_time();
+                            }
+                            return r;
+                        }
+
+                        auto multiplier = s.real_time() > 0 ? min_time * 1.4 / s.real_time() : 10.0;
+                        multiplier = std::min(std::max(multiplier, 1.0), 10.0);
+                        iterations = std::max<uint64_t>(iterations + 1, static_cast<uint64_t>(iterations * multiplier));
+                    }
+                }
+
+                static void print_console_header(std::ostream& out, const std::map<std::string, std::string>& context)
+                {
+                    for (auto&& kvp : context)
+                        out << kvp.first << ": " << kvp.second << "\n";
+                    out << std::string(100, '-') << "\n"
+                        << std::left << std::setw(50) << "Benchmark" << std::right << std::setw(14) << "Time" << std::setw(14) << "CPU"
+                        << std::setw(12) << "Iterations" << "  UserCounters\n"
+                        << std::string(100, '-') << std::endl;
+                }
+
+                static void print_console(std::ostream& out, const result& r)
+                {
+                    out << std::left << std::setw(50) << r.name << std::right;
+                    if (!r.error.empty())
+                    {
+                        out << " ERROR: " << r.error << std::endl;
+                        return;
+                    }
+                    out << std::fixed << std::setprecision(0) << std::setw(11) << r.real_time << " ns" << std::setw(11) << r.cpu_time << " ns"
+                        << std::setw(12) << r.iterations;
+                    if (r.bytes_per_second > 0)
+                        out << "  " << std::setprecision(1) << r.bytes_per_second / (1 << 20) << " MB/s";
+                    if (r.items_per_second > 0)
+                        out << "  " << std::setprecision(1) << r.items_per_second << " items/s";
+                    if (!r.label.empty())
+                        out << "  " << r.label;
+                    out << std::endl;
+                }
+
+                static std::string quote(const std::string& s)
+                {
+                    std::string q = "\"";
+                    for (auto c : s)
+                    {
+                        if (c == '"' || c == '\\') q += '\\';
+                        q += c;
+                    }
+                    return q + "\"";
+                }
+
+                static void print_json(std::ostream& out, const std::map<std::string, std::string>& context, const std::vector<result>& results)
+                {
+                    out << "{\n  \"context\": {\n";
+                    auto now = std::time(nullptr);
+                    char date[64];
+                    std::strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S", std::localtime(&now));
+                    out << "    \"date\": " << quote(date) << ",\n"
+                        << "    \"num_cpus\": " << std::thread::hardware_concurrency();
+                    for (auto&& kvp : context)
+                        out << ",\n    " << quote(kvp.first) << ": " << quote(kvp.second);
+                    out << "\n  },\n  \"benchmarks\": [";
+
+                    for (size_t i = 0; i < results.size(); ++i)
+                    {
+                        auto&& r = results[i];
+                        out << (i ? ",\n" : "\n") << "    {\n      \"name\": " << quote(r.name) << ",\n";
+                        if (!r.error.empty())
+                        {
+                            out << "      \"error_occurred\": true,\n      \"error_message\": " << quote(r.error) << "\n    }";
+                            continue;
+                        }
+                        out << std::fixed << std::setprecision(3)
+                            << "      \"iterations\": " << r.iterations << ",\n"
+                            << "      \"real_time\": " << r.real_time << ",\n"
+                            << "      \"cpu_time\": " << r.cpu_time << ",\n"
+                            << "      \"time_unit\": \"ns\"";
+                        if (r.bytes_per_second > 0)
+                            out << ",\n      \"bytes_per_second\": " << r.bytes_per_second;
+                        if (r.items_per_second > 0)
+                            out << ",\n      \"items_per_second\": " << r.items_per_second;
+                        if (!r.label.empty())
+                            out << ",\n      \"label\": " << quote(r.label);
+                        out << "\n    }";
+                    }
+                    out << "\n  ]\n}" << std::endl;
+                }
+
+                std::vector<std::pair<std::string, function>> _benchmarks;
+            };
+
+            inline void register_benchmark(const std::string& name, function f)
+            {
+                registry::instance().add(name, f);
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,298 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+// The payloads of the UVC interfaces as the backend delivers them, with no unpacking, no frame archive and no sensor of the
+// library involved, for the throughput of the transport to tell apart from the overhead of the library
+
+#include "backend.h"
+#include "types.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tclap/CmdLine.h"
+
+using namespace librealsense;
+using namespace TCLAP;
+
+static std::string fourcc_to_string(uint32_t fourcc)
+{
+    std::string s;
+    for (int i = 3; i >= 0; i--)
+    {
+        auto c = static_cast<char>((fourcc >> (8 * i)) & 0xff);
+        s += (c >= 32 && c < 127) ? c : '?';
+    }
+    return s;
+}
+
+static uint32_t string_to_fourcc(std::string s)
+{
+    s.resize(4, ' ');
+    uint32_t fourcc = 0;
+    for (auto c : s)
+        fourcc = (fourcc << 8) | static_cast<uint8_t>(c);
+    return fourcc;
+}
+
+static std::string profile_string(const platform::stream_profile& p)
+{
+    std::stringstream ss;
+    ss << p.width << "x" << p.height << "@" << p.fps << " " << fourcc_to_string(p.format);
+    return ss.str();
+}
+
+// Nearest rank, of sorted samples
+static double percentile(const std::vector<double>& sorted, double p)
+{
+    if (sorted.empty()) return 0;
+    auto rank = static_cast<size_t>(p / 100 * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+// The payloads of one interface, counted from its callback
+class payload_counter
+{
+public:
+    void add(const platform::frame_object& f)
+    {
+        auto now = platform::monotonic_time();
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_payloads && now > _last)
+            _intervals.push_back(now - _last);
+        _last = now;
+        ++_payloads;
+        _bytes += f.frame_size;
+        if (!_payloads_min || f.frame_size < _payloads_min) _payloads_min = f.frame_size;
+        _payloads_max = std::max(_payloads_max, f.frame_size);
+        if (!f.frame_size) ++_empty;
+    }
+
+    struct report
+    {
+        unsigned long long payloads, bytes, empty;
+        size_t min_size, max_size;
+        double payloads_per_second, megabytes_per_second;
+        double mean_interval, jitter_stddev, jitter_p50, jitter_p99, jitter_max;
+    };
+
+    report get(double seconds, uint32_t fps) const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        report r{};
+        r.payloads = _payloads;
+        r.bytes = _bytes;
+        r.empty = _empty;
+        r.min_size = _payloads_min;
+        r.max_size = _payloads_max;
+        r.payloads_per_second = seconds > 0 ? _payloads / seconds : 0;
+        r.megabytes_per_second = seconds > 0 ? _bytes / seconds / (1024 * 1024) : 0;
+
+        // The jitter is the distance of every interval between two payloads from the nominal one of the frame rate
+        auto nominal = fps ? 1000. / fps : 0;
+        std::vector<double> jitter;
+        double sum = 0, squares = 0;
+        for (auto interval : _intervals)
+        {
+            sum += interval;
+            auto d = std::abs(interval - nominal);
+            squares += (interval - nominal) * (interval - nominal);
+            jitter.push_back(d);
+        }
+        std::sort(jitter.begin(), jitter.end());
+        r.mean_interval = _intervals.empty() ? 0 : sum / _intervals.size();
+        r.jitter_stddev = _intervals.empty() ? 0 : std::sqrt(squares / _intervals.size());
+        r.jitter_p50 = percentile(jitter, 50);
+        r.jitter_p99 = percentile(jitter, 99);
+        r.jitter_max = percentile(jitter, 100);
+        return r;
+    }
+
+private:
+    mutable std::mutex _mutex;
+    unsigned long long _payloads = 0, _bytes = 0, _empty = 0;
+    size_t _payloads_min = 0, _payloads_max = 0;
+    double _last = 0;
+    std::vector<double> _intervals;
+};
+
+struct streaming_interface
+{
+    platform::uvc_device_info info;
+    std::shared_ptr<platform::uvc_device> device;
+    platform::stream_profile profile;
+    payload_counter counter;
+};
+
+int main(int argc, char** argv) try
+{
+    CmdLine cmd("librealsense rs-backend-benchmark tool", ' ');
+    SwitchArg list("l", "list", "List the UVC interfaces and their profiles, and exit");
+    MultiArg<int> interfaces("d", "device", "Index of a UVC interface of the list to stream, all of them by default", false, "index");
+    ValueArg<int> width("W", "width", "Width of the profile, any by default", false, 0, "pixels");
+    ValueArg<int> height("H", "height", "Height of the profile, any by default", false, 0, "pixels");
+    ValueArg<int> fps("r", "rate", "Frame rate of the profile, any by default", false, 0, "fps");
+    ValueArg<std::string> format("f", "format", "FOURCC of the profile, for example Z16 or YUYV, any by default", false, "", "fourcc");
+    ValueArg<int> buffers("b", "buffers", "Buffers the backend captures into", false, DEFAULT_V4L2_FRAME_BUFFERS, "count");
+    ValueArg<double> duration("t", "time", "Seconds every interface streams for", false, 10, "seconds");
+    ValueArg<std::string> output("o", "output", "Also write the report, as JSON, to the file", false, "", "file");
+    cmd.add(list);
+    cmd.add(interfaces);
+    cmd.add(width);
+    cmd.add(height);
+    cmd.add(fps);
+    cmd.add(format);
+    cmd.add(buffers);
+    cmd.add(duration);
+    cmd.add(output);
+    cmd.parse(argc, argv);
+
+    auto backend = platform::create_backend();
+    auto infos = backend->query_uvc_devices();
+    if (infos.empty())
+    {
+        std::cerr << "No UVC interface found" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (list.getValue())
+    {
+        for (size_t i = 0; i < infos.size(); i++)
+        {
+            std::cout << i << ": " << std::string(infos[i]) << std::endl;
+            auto device = backend->create_uvc_device(infos[i]);
+            for (auto&& p : device->get_profiles())
+                std::cout << "    " << profile_string(p) << std::endl;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    std::vector<int> indices = interfaces.getValue();
+    if (indices.empty())
+        for (size_t i = 0; i < infos.size(); i++)
+            indices.push_back(static_cast<int>(i));
+
+    // Of every interface, the first profile of the filters
+    std::vector<std::unique_ptr<streaming_interface>> streams;
+    auto fourcc = format.isSet() ? string_to_fourcc(format.getValue()) : 0;
+    for (auto index : indices)
+    {
+        if (index < 0 || index >= static_cast<int>(infos.size()))
+        {
+            std::cerr << "No UVC interface " << index << ", see the list of -l" << std::endl;
+            return EXIT_FAILURE;
+        }
+        std::unique_ptr<streaming_interface> s(new streaming_interface());
+        s->info = infos[index];
+        s->device = backend->create_uvc_device(s->info);
+        auto profiles = s->device->get_profiles();
+        auto it = std::find_if(profiles.begin(), profiles.end(), [&](const platform::stream_profile& p)
+        {
+            return (!width.getValue() || p.width == static_cast<uint32_t>(width.getValue())) &&
+                (!height.getValue() || p.height == static_cast<uint32_t>(height.getValue())) &&
+                (!fps.getValue() || p.fps == static_cast<uint32_t>(fps.getValue())) &&
+                (!fourcc || p.format == fourcc);
+        });
+        if (it == profiles.end())
+        {
+            std::cerr << "Interface " << index << " has no profile of the filters, see the list of -l" << std::endl;
+            continue;
+        }
+        s->profile = *it;
+        streams.push_back(std::move(s));
+    }
+    if (streams.empty())
+        return EXIT_FAILURE;
+
+    // The payloads are counted and handed right back to the backend
+    for (auto&& s : streams)
+    {
+        auto counter = &s->counter;
+        s->device->set_power_state(platform::D0);
+        s->device->probe_and_commit(s->profile, [counter](platform::stream_profile p, platform::frame_object f, std::function<void()> continuation)
+        {
+            counter->add(f);
+            continuation();
+        }, buffers.getValue());
+    }
+    for (auto&& s : streams)
+    {
+        s->device->stream_on([](const notification& n)
+        {
+            std::cerr << "Backend error: " << n.description << std::endl;
+        });
+    }
+    auto begin = std::chrono::steady_clock::now();
+    for (auto&& s : streams)
+        s->device->start_callbacks();
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(duration.getValue()));
+    auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    for (auto&& s : streams)
+        s->device->stop_callbacks();
+    std::vector<platform::transport_stats> transport;
+    for (auto&& s : streams)
+    {
+        transport.push_back(s->device->get_transport_stats());
+        s->device->close(s->profile);
+        s->device->set_power_state(platform::D3);
+    }
+
+    std::cout << std::fixed << std::setprecision(2) << std::right
+        << std::setw(28) << "interface" << std::setw(10) << "payloads" << std::setw(10) << "per sec" << std::setw(10) << "MB/s"
+        << std::setw(8) << "empty" << std::setw(11) << "interval" << std::setw(9) << "stddev" << std::setw(8) << "p50"
+        << std::setw(8) << "p99" << std::setw(8) << "max" << std::setw(10) << "errors" << std::setw(9) << "dropped" << std::endl;
+
+    std::stringstream json;
+    json << std::fixed << std::setprecision(3) << "{\n  \"seconds\": " << seconds << ",\n  \"interfaces\": [";
+    for (size_t i = 0; i < streams.size(); i++)
+    {
+        auto& s = *streams[i];
+        auto r = s.counter.get(seconds, s.profile.fps);
+        std::stringstream name;
+        name << std::hex << std::setfill('0') << std::setw(4) << s.info.pid << ":" << std::dec << s.info.mi << " " << profile_string(s.profile);
+        std::cout << std::setw(28) << name.str() << std::setw(10) << r.payloads << std::setw(10) << r.payloads_per_second
+            << std::setw(10) << r.megabytes_per_second << std::setw(8) << r.empty << std::setw(11) << r.mean_interval
+            << std::setw(9) << r.jitter_stddev << std::setw(8) << r.jitter_p50 << std::setw(8) << r.jitter_p99 << std::setw(8) << r.jitter_max
+            << std::setw(10) << transport[i].transfer_errors << std::setw(9) << transport[i].dropped_frames << std::endl;
+
+        json << (i ? ",\n" : "\n") << "    { \"pid\": " << s.info.pid << ", \"mi\": " << s.info.mi << ", \"path\": \"" << s.info.device_path << "\""
+            << ", \"width\": " << s.profile.width << ", \"height\": " << s.profile.height << ", \"fps\": " << s.profile.fps
+            << ", \"format\": \"" << fourcc_to_string(s.profile.format) << "\""
+            << ", \"payloads\": " << r.payloads << ", \"bytes\": " << r.bytes << ", \"empty_payloads\": " << r.empty
+            << ", \"min_payload\": " << r.min_size << ", \"max_payload\": " << r.max_size
+            << ", \"payloads_per_second\": " << r.payloads_per_second << ", \"megabytes_per_second\": " << r.megabytes_per_second
+            << ", \"interval_ms\": " << r.mean_interval
+            << ", \"jitter_ms\": { \"stddev\": " << r.jitter_stddev << ", \"p50\": " << r.jitter_p50 << ", \"p99\": " << r.jitter_p99 << ", \"max\": " << r.jitter_max << " }"
+            << ", \"transfer_errors\": " << transport[i].transfer_errors << ", \"backend_drops\": " << transport[i].dropped_frames << " }";
+    }
+    json << "\n  ]\n}" << std::endl;
+
+    if (output.isSet())
+    {
+        std::ofstream out(output.getValue());
+        out << json.str();
+        if (!out)
+        {
+            std::cerr << "Could not write " << output.getValue() << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
+catch (const std::exception& e)
+{
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,268 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include <librealsense2/rs.hpp>
+#include <librealsense2/hpp/rs_internal.hpp>
+
+#include "benchmark.hpp"
+
+#ifdef RS2_BENCHMARK_UNPACKERS
+#include "image.h"
+#endif
+
+using namespace rs2;
+using namespace rs2::tools::benchmark;
+
+struct resolution_t { int width, height; };
+
+static std::string res_name(const resolution_t& res)
+{
+    return std::to_string(res.width) + "x" + std::to_string(res.height);
+}
+
+// Depth with a few holes, deterministic for the runs to compare
+static std::vector<uint16_t> make_depth(int width, int height)
+{
+    std::vector<uint16_t> pixels(width * height);
+    uint32_t seed = 1;
+    for (int y = 0; y < height; y++)
+        for (int x = 0; x < width; x++)
+        {
+            seed = seed * 1664525 + 1013904223;
+            auto hole = (seed >> 24) < 12;
+            pixels[y * width + x] = hole ? 0 : static_cast<uint16_t>(1000 + (x * 7 + y * 13) % 200 + (seed >> 28));
+        }
+    return pixels;
+}
+
+#ifdef RS2_BENCHMARK_UNPACKERS
+// Every image unpacker of every native format, the motion and GPIO reports excepted
+static void register_unpackers(const std::vector<resolution_t>& resolutions)
+{
+    using namespace librealsense;
+    const std::vector<std::pair<std::string, const native_pixel_format*>> formats = {
+        { "z16", &pf_z16 },{ "invz", &pf_invz },{ "y8", &pf_y8 },{ "y8i", &pf_y8i },{ "y16", &pf_y16 },{ "y12i", &pf_y12i },
+        { "yuy2", &pf_yuy2 },{ "yuyv", &pf_yuyv },{ "uyvyl", &pf_uyvyl },{ "rgb888", &pf_rgb888 },{ "raw8", &pf_raw8 },
+        { "rw10", &pf_rw10 },{ "w10", &pf_w10 },{ "rw16", &pf_rw16 },{ "bayer16", &pf_bayer16 },{ "f200_invi", &pf_f200_invi },
+        { "f200_inzi", &pf_f200_inzi },{ "sr300_invi", &pf_sr300_invi },{ "sr300_inzi", &pf_sr300_inzi },
+        { "confidence_l500", &pf_confidence_l500 },{ "z16_l500", &pf_z16_l500 },{ "y8_l500", &pf_y8_l500 } };
+
+    for (auto&& format : formats)
+        for (auto&& u : format.second->unpackers)
+        {
+            std::string outputs;
+            for (auto&& o : u.outputs)
+                outputs += (outputs.empty() ? "" : "+") + std::string(rs2_format_to_string(o.format));
+
+            for (auto&& res : resolutions)
+            {
+                auto pf = format.second;
+                auto unpacker = &u;
+                register_benchmark("unpack/" + format.first + "/" + outputs + "/" + res_name(res), [pf, unpacker, res](state& s)
+                {
+                    // Packed formats take less than their bytes per pixel, so the source has room to spare
+                    auto source_size = pf->get_image_size(res.width, res.height);
+                    std::vector<byte> source(source_size * 2);
+                    for (size_t i = 0; i < source.size(); i++)
+                        source[i] = static_cast<byte>(i * 31 + (i >> 8));
+
+                    std::vector<std::vector<byte>> buffers;
+                    std::vector<byte*> dest;
+                    for (auto&& o : unpacker->outputs)
+                    {
+                        auto out = o.stream_resolution({ static_cast<uint32_t>(res.width), static_cast<uint32_t>(res.height) });
+                        buffers.emplace_back(get_image_size(out.width, out.height, o.format) + 64);
+                    }
+                    for (auto&& b : buffers)
+                        dest.push_back(b.data());
+
+                    while (s.keep_running())
+                        unpacker->unpack(dest.data(), source.data(), res.width, res.height);
+                    s.set_bytes_processed(s.iterations() * source_size);
+                    s.set_items_processed(s.iterations());
+                });
+            }
+        }
+}
+#endif
+
+// Depth and color of a software device, synced into a frameset that the blocks process over and over
+class synthetic_frames
+{
+public:
+    explicit synthetic_frames(const resolution_t& res)
+        : _depth(make_depth(res.width, res.height)), _color(res.width * res.height * 3)
+    {
+        for (size_t i = 0; i < _color.size(); i++)
+            _color[i] = static_cast<uint8_t>(i * 7);
+
+        auto s = _dev.add_sensor("software_sensor");
+        s.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+        rs2_intrinsics intrinsics{ res.width, res.height, res.width / 2.f, res.height / 2.f, res.width * 0.9f, res.width * 0.9f,
+            RS2_DISTORTION_NONE,{ 0,0,0,0,0 } };
+        auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, res.width, res.height, 30, 2, RS2_FORMAT_Z16, intrinsics });
+        auto color = s.add_video_stream({ RS2_STREAM_COLOR, 0, 1, res.width, res.height, 30, 3, RS2_FORMAT_RGB8, intrinsics });
+        depth.register_extrinsics_to(color, { { 1,0,0,0,1,0,0,0,1 },{ 0.015f,0,0 } });
+
+        syncer sync;
+        s.open({ depth, color });
+        s.start(sync);
+        s.on_video_frame({ _depth.data(), [](void*) {}, res.width * 2, 2, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 0, depth });
+        s.on_video_frame({ _color.data(), [](void*) {}, res.width * 3, 3, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 0, color });
+        frames = sync.wait_for_frames();
+        s.stop();
+        s.close();
+    }
+
+    frameset frames;
+
+private:
+    software_device _dev;
+    std::vector<uint16_t> _depth;
+    std::vector<uint8_t> _color;
+};
+
+static void register_block(const std::string& name, const std::vector<resolution_t>& resolutions,
+    std::function<std::function<frame(const frameset&)>()> make)
+{
+    for (auto&& res : resolutions)
+    {
+        register_benchmark("block/" + name + "/" + res_name(res), [res, make](state& s)
+        {
+            synthetic_frames input(res);
+            auto process = make();
+            while (s.keep_running())
+                process(input.frames);
+            s.set_bytes_processed(s.iterations() * res.width * res.height * 2);
+            s.set_items_processed(s.iterations());
+        });
+    }
+}
+
+static void register_blocks(const std::vector<resolution_t>& resolutions)
+{
+    register_block("decimation", resolutions, [] {
+        auto block = std::make_shared<decimation_filter>();
+        return [block](const frameset& fs) { return block->process(fs.get_depth_frame()); }; });
+    register_block("spatial", resolutions, [] {
+        auto block = std::make_shared<spatial_filter>();
+        return [block](const frameset& fs) { return block->process(fs.get_depth_frame()); }; });
+    register_block("temporal", resolutions, [] {
+        auto block = std::make_shared<temporal_filter>();
+        return [block](const frameset& fs) { return block->process(fs.get_depth_frame()); }; });
+    register_block("hole_filling", resolutions, [] {
+        auto block = std::make_shared<hole_filling_filter>();
+        return [block](const frameset& fs) { return block->process(fs.get_depth_frame()); }; });
+    register_block("disparity", resolutions, [] {
+        auto block = std::make_shared<disparity_transform>(true);
+        return [block](const frameset& fs) { return block->process(fs.get_depth_frame()); }; });
+    register_block("colorizer", resolutions, [] {
+        auto block = std::make_shared<colorizer>();
+        return [block](const frameset& fs) { return block->process(fs.get_depth_frame()); }; });
+    register_block("align_to_color", resolutions, [] {
+        auto block = std::make_shared<align>(RS2_STREAM_COLOR);
+        return [block](const frameset& fs) { return block->process(fs); }; });
+    register_block("align_to_depth", resolutions, [] {
+        auto block = std::make_shared<align>(RS2_STREAM_DEPTH);
+        return [block](const frameset& fs) { return block->process(fs); }; });
+    register_block("pointcloud", resolutions, [] {
+        auto block = std::make_shared<pointcloud>();
+        return [block](const frameset& fs) { return block->calculate(fs.get_depth_frame()); }; });
+}
+
+// Frames of three streams through a syncer, from a software device, every iteration a frameset
+static void register_syncer(const std::vector<resolution_t>& resolutions)
+{
+    for (auto&& res : resolutions)
+    {
+        register_benchmark("syncer/depth+color+infrared/" + res_name(res), [res](state& s)
+        {
+            auto depth_pixels = make_depth(res.width, res.height);
+            std::vector<uint8_t> color_pixels(res.width * res.height * 3, 128);
+            std::vector<uint8_t> ir_pixels(res.width * res.height, 64);
+
+            software_device dev;
+            auto sensor = dev.add_sensor("software_sensor");
+            rs2_intrinsics intrinsics{ res.width, res.height, res.width / 2.f, res.height / 2.f, res.width * 0.9f, res.width * 0.9f,
+                RS2_DISTORTION_NONE,{ 0,0,0,0,0 } };
+            auto depth = sensor.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, res.width, res.height, 30, 2, RS2_FORMAT_Z16, intrinsics });
+            auto color = sensor.add_video_stream({ RS2_STREAM_COLOR, 0, 1, res.width, res.height, 30, 3, RS2_FORMAT_RGB8, intrinsics });
+            auto ir = sensor.add_video_stream({ RS2_STREAM_INFRARED, 1, 2, res.width, res.height, 30, 1, RS2_FORMAT_Y8, intrinsics });
+
+            syncer sync;
+            sensor.open({ depth, color, ir });
+            sensor.start(sync);
+            double timestamp = 0;
+            int number = 0;
+            while (s.keep_running())
+            {
+                sensor.on_video_frame({ depth_pixels.data(), [](void*) {}, res.width * 2, 2, timestamp, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, number, depth });
+                sensor.on_video_frame({ color_pixels.data(), [](void*) {}, res.width * 3, 3, timestamp, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, number, color });
+                sensor.on_video_frame({ ir_pixels.data(), [](void*) {}, res.width, 1, timestamp, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, number, ir });
+                frameset fs;
+                if (!sync.try_wait_for_frames(&fs, 1000))
+                {
+                    s.skip_with_error("The syncer did not match the frames");
+                    break;
+                }
+                timestamp += 1000. / 30;
+                number++;
+            }
+            sensor.stop();
+            sensor.close();
+            s.set_items_processed(s.iterations());
+        });
+    }
+}
+
+int main(int argc, char** argv) try
+{
+    // The unpackers and blocks fix their instruction set once, on first use
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        std::string flag = "--benchmark_simd=";
+        if (arg.compare(0, flag.size(), flag) == 0)
+        {
+#ifdef _WIN32
+            _putenv_s("LRS_SIMD_LEVEL", arg.substr(flag.size()).c_str());
+#else
+            setenv("LRS_SIMD_LEVEL", arg.substr(flag.size()).c_str(), 1);
+#endif
+        }
+    }
+
+    std::map<std::string, std::string> context;
+    context["library_version"] = RS2_API_VERSION_STR;
+#ifdef NDEBUG
+    context["library_build_type"] = "release";
+#else
+    context["library_build_type"] = "debug";
+#endif
+#ifdef RS2_BENCHMARK_UNPACKERS
+    context["simd_level"] = librealsense::get_string(librealsense::get_simd_level());
+#else
+    auto level = getenv("LRS_SIMD_LEVEL");
+    context["simd_level"] = level ? level : "detected";
+#endif
+
+    std::vector<resolution_t> resolutions = { { 640, 480 },{ 1280, 720 },{ 1920, 1080 } };
+    std::vector<resolution_t> depth_resolutions = { { 640, 480 },{ 848, 480 },{ 1280, 720 } };
+#ifdef RS2_BENCHMARK_UNPACKERS
+    register_unpackers(resolutions);
+#endif
+    register_blocks(depth_resolutions);
+    register_syncer(depth_resolutions);
+
+    return registry::instance().run(argc, argv, context);
+}
+catch (const error & e)
+{
+    std::cerr << "RealSense error calling " << e.get_failed_function() << "(" << e.get_failed_args() << "):\n    " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
+catch (const std::exception& e)
+{
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,307 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include <librealsense2/rs.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "tclap/CmdLine.h"
+
+using namespace rs2;
+using namespace TCLAP;
+
+// The options the library was configured with, passed on by CMake to the tool
+#ifndef RS2_WITH_OPENMP
+#define RS2_WITH_OPENMP "unknown"
+#endif
+#ifndef RS2_WITH_CUDA
+#define RS2_WITH_CUDA "unknown"
+#endif
+#ifndef RS2_ZERO_COPY
+#define RS2_ZERO_COPY "unknown"
+#endif
+
+// CPU time of the process, every thread of it, in seconds
+static double process_cpu_time()
+{
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+        return 0;
+    auto to_seconds = [](const FILETIME& t) { return ((uint64_t(t.dwHighDateTime) << 32) | t.dwLowDateTime) * 1e-7; };
+    return to_seconds(kernel) + to_seconds(user);
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage))
+        return 0;
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6;
+#endif
+}
+
+// Peak resident memory of the process, in kilobytes
+static uint64_t peak_memory_kb()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return 0;
+    return counters.PeakWorkingSetSize / 1024;
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage))
+        return 0;
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;  // Bytes on macOS
+#else
+    return usage.ru_maxrss;
+#endif
+#endif
+}
+
+static std::shared_ptr<processing_block> make_filter(const std::string& name)
+{
+    if (name == "decimation") return std::make_shared<decimation_filter>();
+    if (name == "spatial") return std::make_shared<spatial_filter>();
+    if (name == "temporal") return std::make_shared<temporal_filter>();
+    if (name == "hole_filling") return std::make_shared<hole_filling_filter>();
+    if (name == "disparity") return std::make_shared<disparity_transform>(true);
+    if (name == "depth") return std::make_shared<disparity_transform>(false);
+    if (name == "colorizer") return std::make_shared<colorizer>();
+    if (name == "align_to_color") return std::make_shared<align>(RS2_STREAM_COLOR);
+    if (name == "align_to_depth") return std::make_shared<align>(RS2_STREAM_DEPTH);
+    if (name == "pointcloud") return std::make_shared<pointcloud>();
+    throw std::runtime_error("Unknown filter " + name);
+}
+
+// Latencies of a stage of the delivery, in milliseconds
+class latencies
+{
+public:
+    void add(double ms) { _samples.push_back(ms); }
+    bool empty() const { return _samples.empty(); }
+
+    // Nearest rank, of the samples sorted once they are all in
+    double percentile(double p)
+    {
+        if (_samples.empty()) return 0;
+        if (!_sorted)
+        {
+            std::sort(_samples.begin(), _samples.end());
+            _sorted = true;
+        }
+        auto rank = static_cast<size_t>(p / 100 * (_samples.size() - 1) + 0.5);
+        return _samples[std::min(rank, _samples.size() - 1)];
+    }
+
+private:
+    std::vector<double> _samples;
+    bool _sorted = false;
+};
+
+static const std::vector<double> percentiles = { 50, 90, 99, 100 };
+
+static std::string quote(const std::string& s)
+{
+    std::string q = "\"";
+    for (auto c : s)
+    {
+        if (c == '"' || c == '\\') q += '\\';
+        q += c;
+    }
+    return q + "\"";
+}
+
+int main(int argc, char** argv) try
+{
+    rs2::log_to_console(RS2_LOG_SEVERITY_ERROR);
+
+    CmdLine cmd("librealsense rs-playback-benchmark tool", ' ');
+    ValueArg<std::string> input("i", "input", "Recorded file to play back", true, "", "file");
+    ValueArg<std::string> filters("f", "filters", "Comma separated chain of filters applied to every frameset, in order: "
+        "decimation, spatial, temporal, hole_filling, disparity, depth, colorizer, align_to_color, align_to_depth, pointcloud", false, "", "filters");
+    ValueArg<int> repeat("r", "repeat", "Times the file is played back", false, 1, "count");
+    ValueArg<std::string> output("o", "output", "Also write the report, as JSON, to the file", false, "", "file");
+    SwitchArg real_time("t", "real-time", "Play back at the speed of the recording, rather than as fast as the frames are consumed", false);
+    cmd.add(input);
+    cmd.add(filters);
+    cmd.add(repeat);
+    cmd.add(output);
+    cmd.add(real_time);
+    cmd.parse(argc, argv);
+
+    std::vector<std::shared_ptr<processing_block>> chain;
+    std::stringstream names(filters.getValue());
+    std::string name;
+    while (std::getline(names, name, ','))
+    {
+        if (name.empty()) continue;
+        chain.push_back(make_filter(name));
+    }
+
+    // The stages are timed from when the frame was read from the file
+    const std::vector<std::pair<std::string, rs2_frame_metadata_value>> stages = {
+        { "unpack", RS2_FRAME_METADATA_UNPACK_TIME },
+        { "callback", RS2_FRAME_METADATA_CALLBACK_TIME },
+        { "sync", RS2_FRAME_METADATA_SYNC_TIME } };
+    std::map<std::string, latencies> stage_latencies;
+    latencies filter_latencies;
+
+    uint64_t framesets = 0, frames = 0;
+    auto cpu_start = process_cpu_time();
+    auto start = std::chrono::steady_clock::now();
+    auto end = start;   // Of the last frameset, for the wait on the end of the file to be left out
+
+    for (int i = 0; i < std::max(repeat.getValue(), 1); i++)
+    {
+        pipeline pipe;
+        config cfg;
+        cfg.enable_device_from_file(input.getValue(), false);
+        auto profile = pipe.start(cfg);
+        auto dev = profile.get_device().as<playback>();
+        dev.set_real_time(real_time.getValue());
+
+        while (true)
+        {
+            frameset fs;
+            if (!pipe.try_wait_for_frames(&fs, 1000))
+            {
+                if (dev.current_status() == RS2_PLAYBACK_STATUS_STOPPED)
+                    break;
+                continue;
+            }
+
+            framesets++;
+            end = std::chrono::steady_clock::now();
+            for (auto&& f : fs)
+            {
+                frames++;
+                if (!f.supports_frame_metadata(RS2_FRAME_METADATA_DEQUEUE_TIME))
+                    continue;
+                auto dequeue = f.get_frame_metadata(RS2_FRAME_METADATA_DEQUEUE_TIME);
+                for (auto&& stage : stages)
+                    if (f.supports_frame_metadata(stage.second))
+                        stage_latencies[stage.first].add((f.get_frame_metadata(stage.second) - dequeue) / 1000.);
+            }
+
+            auto filter_start = std::chrono::steady_clock::now();
+            frame processed = fs;
+            for (auto&& block : chain)
+                processed = block->process(processed);
+            if (!chain.empty())
+                filter_latencies.add(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - filter_start).count());
+        }
+        pipe.stop();
+    }
+
+    auto seconds = std::chrono::duration<double>(end - start).count();
+    auto cpu_percent = seconds > 0 ? (process_cpu_time() - cpu_start) * 100 / seconds : 0;
+    auto peak_kb = peak_memory_kb();
+
+    std::map<std::string, std::string> context = {
+        { "library_version", RS2_API_VERSION_STR },
+#ifdef NDEBUG
+        { "library_build_type", "release" },
+#else
+        { "library_build_type", "debug" },
+#endif
+        { "BUILD_WITH_OPENMP", RS2_WITH_OPENMP },
+        { "BUILD_WITH_CUDA", RS2_WITH_CUDA },
+        { "ENABLE_ZERO_COPY", RS2_ZERO_COPY },
+        { "file", input.getValue() },
+        { "filters", filters.getValue() },
+        { "real_time", real_time.getValue() ? "true" : "false" } };
+
+    // The stages the frames went through, with the filter chain last
+    std::vector<std::pair<std::string, latencies*>> report;
+    for (auto&& stage : stages)
+        if (!stage_latencies[stage.first].empty())
+            report.emplace_back(stage.first, &stage_latencies[stage.first]);
+    if (!filter_latencies.empty())
+        report.emplace_back("filters", &filter_latencies);
+
+    for (auto&& kvp : context)
+        std::cout << kvp.first << ": " << kvp.second << "\n";
+    std::cout << std::string(60, '-') << "\n" << std::fixed << std::setprecision(1)
+        << "framesets: " << framesets << ", frames: " << frames << ", in " << seconds << " s\n"
+        << "framesets/sec: " << (seconds > 0 ? framesets / seconds : 0) << "\n"
+        << "CPU: " << cpu_percent << "%\n"
+        << "peak memory: " << peak_kb / 1024. << " MB\n"
+        << std::string(60, '-') << "\n"
+        << std::left << std::setw(14) << "Latency (ms)" << std::right;
+    for (auto p : percentiles)
+        std::cout << std::setw(10) << (p == 100 ? std::string("max") : "p" + std::to_string(int(p)));
+    std::cout << "\n" << std::setprecision(3);
+    for (auto&& stage : report)
+    {
+        std::cout << std::left << std::setw(14) << stage.first << std::right;
+        for (auto p : percentiles)
+            std::cout << std::setw(10) << stage.second->percentile(p);
+        std::cout << "\n";
+    }
+    std::cout << std::flush;
+
+    if (output.isSet())
+    {
+        std::ofstream out(output.getValue());
+        out << "{\n  \"context\": {";
+        bool first = true;
+        for (auto&& kvp : context)
+        {
+            out << (first ? "\n" : ",\n") << "    " << quote(kvp.first) << ": " << quote(kvp.second);
+            first = false;
+        }
+        out << "\n  },\n" << std::fixed << std::setprecision(3)
+            << "  \"framesets\": " << framesets << ",\n"
+            << "  \"frames\": " << frames << ",\n"
+            << "  \"seconds\": " << seconds << ",\n"
+            << "  \"framesets_per_second\": " << (seconds > 0 ? framesets / seconds : 0) << ",\n"
+            << "  \"cpu_percent\": " << cpu_percent << ",\n"
+            << "  \"peak_memory_kb\": " << peak_kb << ",\n"
+            << "  \"latency_ms\": {";
+        first = true;
+        for (auto&& stage : report)
+        {
+            out << (first ? "\n" : ",\n") << "    " << quote(stage.first) << ": { ";
+            for (size_t i = 0; i < percentiles.size(); i++)
+                out << (i ? ", " : "") << quote(percentiles[i] == 100 ? std::string("max") : "p" + std::to_string(int(percentiles[i])))
+                    << ": " << stage.second->percentile(percentiles[i]);
+            out << " }";
+            first = false;
+        }
+        out << "\n  }\n}" << std::endl;
+        if (!out)
+        {
+            std::cerr << "Could not write " << output.getValue() << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+catch (const rs2::error& e)
+{
+    std::cerr << "RealSense error calling " << e.get_failed_function() << "(" << e.get_failed_args() << "):\n    " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
+catch (const std::exception& e)
+{
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,437 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include <librealsense2/rs.hpp>
+#include <librealsense2/hpp/rs_internal.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#include "tclap/CmdLine.h"
+
+using namespace rs2;
+using namespace TCLAP;
+
+// Resident memory of the process now, in kilobytes. macOS has its peak alone
+static uint64_t memory_kb()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return 0;
+    return counters.WorkingSetSize / 1024;
+#elif defined(__APPLE__)
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage))
+        return 0;
+    return usage.ru_maxrss / 1024;
+#else
+    std::ifstream statm("/proc/self/statm");
+    uint64_t size = 0, resident = 0;
+    if (!(statm >> size >> resident))
+        return 0;
+    return resident * sysconf(_SC_PAGESIZE) / 1024;
+#endif
+}
+
+static double now_ms()
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Latencies of the frames of a window, in milliseconds
+class latencies
+{
+public:
+    void add(double ms)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _samples.push_back(ms);
+    }
+
+    // The samples of the window, the next one starting empty
+    std::vector<double> take()
+    {
+        std::vector<double> samples;
+        std::lock_guard<std::mutex> lock(_mutex);
+        samples.swap(_samples);
+        std::sort(samples.begin(), samples.end());
+        return samples;
+    }
+
+    // Nearest rank, of sorted samples
+    static double percentile(const std::vector<double>& sorted, double p)
+    {
+        if (sorted.empty()) return 0;
+        auto rank = static_cast<size_t>(p / 100 * (sorted.size() - 1) + 0.5);
+        return sorted[std::min(rank, sorted.size() - 1)];
+    }
+
+private:
+    std::mutex _mutex;
+    std::vector<double> _samples;
+};
+
+// Last time a thread was seen outside of a call that may block, for the watchdog to tell the threads stuck in the library
+struct heartbeat
+{
+    std::string name;
+    std::atomic<double> last{ now_ms() };
+
+    void beat() { last = now_ms(); }
+};
+
+// A report line, of the counters since the previous one
+struct sample
+{
+    double seconds;
+    uint64_t memory_kb;
+    uint64_t pushed, delivered, consumed, framesets, cycles, option_changes;
+    double source_drop_percent, queue_drop_percent;
+    double p50, p90, p99, max;
+};
+
+int main(int argc, char** argv) try
+{
+    rs2::log_to_console(RS2_LOG_SEVERITY_ERROR);
+
+    CmdLine cmd("librealsense rs-soak-test tool", ' ');
+    ValueArg<double> duration("t", "time", "Seconds the test runs for", false, 3600, "seconds");
+    ValueArg<int> fps("r", "rate", "Frames per second of each of the depth and color streams", false, 60, "fps");
+    ValueArg<int> consumers("c", "consumers", "Threads consuming every frame, each from its own frame queue", false, 4, "count");
+    ValueArg<int> max_delay("d", "delay", "Longest random delay of a consumer after each frame, in milliseconds", false, 20, "ms");
+    ValueArg<double> cycle_period("s", "start-stop", "Longest random period between two stop and start cycles of the sensor, 0 for none", false, 10, "seconds");
+    ValueArg<int> option_period("p", "options", "Period of the random option changes, in milliseconds, 0 for none", false, 50, "ms");
+    ValueArg<double> interval("i", "interval", "Seconds between two report lines", false, 60, "seconds");
+    ValueArg<double> watchdog("w", "watchdog", "Seconds a thread may be stuck in a call before the test fails as deadlocked", false, 30, "seconds");
+    ValueArg<double> max_growth("", "max-growth", "Largest growth of the memory since the end of the first interval, in megabytes", false, 64, "MB");
+    ValueArg<double> max_p99("", "max-p99", "Largest 99th percentile of the latency of an interval, in milliseconds, 0 for no limit", false, 0, "ms");
+    ValueArg<double> max_drops("", "max-drops", "Largest percentage of the frames the library drops in an interval, 0 for no limit", false, 0, "percent");
+    ValueArg<unsigned> seed("", "seed", "Seed of the random start, stop, option changes and delays", false, 1, "seed");
+    ValueArg<std::string> output("o", "output", "Also write the report lines, as JSON, to the file", false, "", "file");
+    cmd.add(duration);
+    cmd.add(fps);
+    cmd.add(consumers);
+    cmd.add(max_delay);
+    cmd.add(cycle_period);
+    cmd.add(option_period);
+    cmd.add(interval);
+    cmd.add(watchdog);
+    cmd.add(max_growth);
+    cmd.add(max_p99);
+    cmd.add(max_drops);
+    cmd.add(seed);
+    cmd.add(output);
+    cmd.parse(argc, argv);
+
+    const int W = 640, H = 480;
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+    s.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+    rs2_intrinsics intrinsics{ W, H, W / 2.f, H / 2.f, W * 0.9f, W * 0.9f, RS2_DISTORTION_NONE,{ 0,0,0,0,0 } };
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, fps.getValue(), 2, RS2_FORMAT_Z16, intrinsics });
+    auto color = s.add_video_stream({ RS2_STREAM_COLOR, 0, 1, W, H, fps.getValue(), 3, RS2_FORMAT_RGB8, intrinsics });
+    depth.register_extrinsics_to(color, { { 1,0,0,0,1,0,0,0,1 },{ 0.015f,0,0 } });
+
+    std::atomic<bool> done{ false };
+    std::atomic<uint64_t> pushed{ 0 }, delivered{ 0 }, consumed{ 0 }, framesets{ 0 }, cycles{ 0 }, option_changes{ 0 };
+    latencies latency;
+
+    // Every frame goes to the queue of every consumer and to a syncer
+    std::vector<std::unique_ptr<frame_queue>> queues;
+    for (int i = 0; i < std::max(consumers.getValue(), 1); i++)
+        queues.emplace_back(new frame_queue(2));
+    syncer sync;
+    std::vector<std::shared_ptr<decimation_filter>> filters;
+    for (size_t i = 0; i < queues.size(); i++)
+        filters.push_back(std::make_shared<decimation_filter>());
+
+    std::mutex streaming_mutex;
+    bool streaming = false;
+    auto start = [&]()
+    {
+        s.open({ depth, color });
+        s.start([&](frame f)
+        {
+            delivered++;
+            for (auto&& q : queues)
+                q->enqueue(f);
+            sync(f);
+        });
+        streaming = true;
+    };
+    auto stop = [&]()
+    {
+        streaming = false;
+        s.stop();
+        s.close();
+    };
+
+    std::vector<std::unique_ptr<heartbeat>> heartbeats;
+    auto add_heartbeat = [&](const std::string& name)
+    {
+        heartbeats.emplace_back(new heartbeat());
+        heartbeats.back()->name = name;
+        return heartbeats.back().get();
+    };
+    std::vector<std::thread> threads;
+
+    // The frames, new pixels every time for the leaks of the frames to show, stamped with the time they are pushed at
+    auto producer_beat = add_heartbeat("producer");
+    threads.emplace_back([&]()
+    {
+        auto period = std::chrono::microseconds(1000000 / std::max(fps.getValue(), 1));
+        auto next = std::chrono::steady_clock::now();
+        int number = 0;
+        while (!done)
+        {
+            producer_beat->beat();
+            next += period;
+            std::this_thread::sleep_until(next);
+            std::lock_guard<std::mutex> lock(streaming_mutex);
+            if (!streaming)
+                continue;
+            auto timestamp = rs2_get_time(nullptr);
+            auto depth_pixels = new uint16_t[W * H]();
+            auto color_pixels = new uint8_t[W * H * 3]();
+            s.on_video_frame({ depth_pixels, [](void* p) { delete[] static_cast<uint16_t*>(p); }, W * 2, 2, timestamp, RS2_TIMESTAMP_DOMAIN_SYSTEM_TIME, number, depth });
+            s.on_video_frame({ color_pixels, [](void* p) { delete[] static_cast<uint8_t*>(p); }, W * 3, 3, timestamp, RS2_TIMESTAMP_DOMAIN_SYSTEM_TIME, number, color });
+            pushed += 2;
+            number++;
+        }
+    });
+
+    for (size_t i = 0; i < queues.size(); i++)
+    {
+        auto beat = add_heartbeat("consumer " + std::to_string(i));
+        threads.emplace_back([&, i, beat]()
+        {
+            std::mt19937 random(seed.getValue() + static_cast<unsigned>(i) + 1);
+            std::uniform_int_distribution<int> delay(0, std::max(max_delay.getValue(), 0));
+            while (!done)
+            {
+                beat->beat();
+                frame f;
+                if (!queues[i]->try_wait_for_frame(&f, 100))
+                    continue;
+                consumed++;
+                latency.add(rs2_get_time(nullptr) - f.get_timestamp());
+                if (f.get_profile().stream_type() == RS2_STREAM_DEPTH)
+                    filters[i]->process(f);
+                std::this_thread::sleep_for(std::chrono::milliseconds(delay(random)));
+            }
+        });
+    }
+
+    auto sync_beat = add_heartbeat("syncer");
+    threads.emplace_back([&]()
+    {
+        while (!done)
+        {
+            sync_beat->beat();
+            frameset fs;
+            if (sync.try_wait_for_frames(&fs, 100))
+                framesets++;
+        }
+    });
+
+    // Options of the sensor and of the filters the consumers run, changed while they are in use
+    if (option_period.getValue() > 0)
+    {
+        auto beat = add_heartbeat("options");
+        threads.emplace_back([&]()
+        {
+            std::mt19937 random(seed.getValue() + 1000);
+            std::uniform_int_distribution<int> magnitude(2, 8);
+            std::uniform_int_distribution<size_t> which(0, filters.size() - 1);
+            while (!done)
+            {
+                beat->beat();
+                std::this_thread::sleep_for(std::chrono::milliseconds(option_period.getValue()));
+                filters[which(random)]->set_option(RS2_OPTION_FILTER_MAGNITUDE, static_cast<float>(magnitude(random)));
+                s.set_read_only_option(RS2_OPTION_DEPTH_UNITS, magnitude(random) * 0.0005f);
+                option_changes++;
+            }
+        });
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(streaming_mutex);
+        start();
+    }
+
+    // Stop and start cycles of the sensor, at random times, while the consumers wait on their queues
+    if (cycle_period.getValue() > 0)
+    {
+        auto beat = add_heartbeat("start/stop");
+        threads.emplace_back([&]()
+        {
+            std::mt19937 random(seed.getValue() + 2000);
+            std::uniform_real_distribution<double> period(0, cycle_period.getValue() * 1000);
+            while (!done)
+            {
+                auto until = now_ms() + period(random);
+                while (!done && now_ms() < until)
+                {
+                    beat->beat();
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                }
+                if (done)
+                    break;
+                std::lock_guard<std::mutex> lock(streaming_mutex);
+                stop();
+                std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<int>(period(random) / 100)));
+                start();
+                cycles++;
+            }
+        });
+    }
+
+    std::vector<sample> samples;
+    std::vector<std::string> failures;
+    auto begin = now_ms();
+    auto next_report = begin + interval.getValue() * 1000;
+    uint64_t last_pushed = 0, last_delivered = 0, last_consumed = 0, last_framesets = 0, last_cycles = 0, last_options = 0;
+
+    std::cout << std::fixed << std::setprecision(1) << std::right
+        << std::setw(8) << "seconds" << std::setw(11) << "memory MB" << std::setw(10) << "frames"
+        << std::setw(11) << "framesets" << std::setw(8) << "cycles" << std::setw(9) << "options"
+        << std::setw(11) << "src drop%" << std::setw(11) << "queue drop%"
+        << std::setw(8) << "p50" << std::setw(8) << "p90" << std::setw(8) << "p99" << std::setw(8) << "max" << std::endl;
+
+    auto report = [&]()
+    {
+        sample sm;
+        sm.seconds = (now_ms() - begin) / 1000;
+        sm.memory_kb = memory_kb();
+        uint64_t p = pushed, d = delivered, c = consumed, f = framesets, cy = cycles, o = option_changes;
+        sm.pushed = p - last_pushed;
+        sm.delivered = d - last_delivered;
+        sm.consumed = c - last_consumed;
+        sm.framesets = f - last_framesets;
+        sm.cycles = cy - last_cycles;
+        sm.option_changes = o - last_options;
+        last_pushed = p; last_delivered = d; last_consumed = c; last_framesets = f; last_cycles = cy; last_options = o;
+
+        // The frames the library let go before the callback, and those the queues dropped for the delays of the consumers
+        sm.source_drop_percent = sm.pushed ? std::max(0., (double(sm.pushed) - sm.delivered) * 100 / sm.pushed) : 0;
+        auto expected = double(sm.delivered) * queues.size();
+        sm.queue_drop_percent = expected > 0 ? std::max(0., (expected - sm.consumed) * 100 / expected) : 0;
+
+        auto window = latency.take();
+        sm.p50 = latencies::percentile(window, 50);
+        sm.p90 = latencies::percentile(window, 90);
+        sm.p99 = latencies::percentile(window, 99);
+        sm.max = latencies::percentile(window, 100);
+        samples.push_back(sm);
+
+        std::cout << std::setw(8) << sm.seconds << std::setw(11) << sm.memory_kb / 1024. << std::setw(10) << sm.consumed
+            << std::setw(11) << sm.framesets << std::setw(8) << sm.cycles << std::setw(9) << sm.option_changes
+            << std::setw(11) << sm.source_drop_percent << std::setw(11) << sm.queue_drop_percent
+            << std::setw(8) << sm.p50 << std::setw(8) << sm.p90 << std::setw(8) << sm.p99 << std::setw(8) << sm.max << std::endl;
+
+        if (max_p99.getValue() > 0 && sm.p99 > max_p99.getValue())
+            failures.push_back("p99 latency of " + std::to_string(sm.p99) + " ms at " + std::to_string(int(sm.seconds)) + " s");
+        if (max_drops.getValue() > 0 && sm.source_drop_percent > max_drops.getValue())
+            failures.push_back("library dropped " + std::to_string(sm.source_drop_percent) + "% of the frames at " + std::to_string(int(sm.seconds)) + " s");
+    };
+
+    auto write_output = [&]()
+    {
+        if (!output.isSet())
+            return true;
+        std::ofstream out(output.getValue());
+        out << "{\n  \"seed\": " << seed.getValue() << ",\n  \"failures\": [";
+        for (size_t i = 0; i < failures.size(); i++)
+            out << (i ? ", " : "") << "\"" << failures[i] << "\"";
+        out << "],\n  \"samples\": [" << std::fixed << std::setprecision(3);
+        for (size_t i = 0; i < samples.size(); i++)
+        {
+            auto& sm = samples[i];
+            out << (i ? ",\n" : "\n") << "    { \"seconds\": " << sm.seconds << ", \"memory_kb\": " << sm.memory_kb
+                << ", \"pushed\": " << sm.pushed << ", \"delivered\": " << sm.delivered << ", \"consumed\": " << sm.consumed
+                << ", \"framesets\": " << sm.framesets << ", \"cycles\": " << sm.cycles << ", \"option_changes\": " << sm.option_changes
+                << ", \"source_drop_percent\": " << sm.source_drop_percent << ", \"queue_drop_percent\": " << sm.queue_drop_percent
+                << ", \"latency_ms\": { \"p50\": " << sm.p50 << ", \"p90\": " << sm.p90 << ", \"p99\": " << sm.p99 << ", \"max\": " << sm.max << " } }";
+        }
+        out << "\n  ]\n}" << std::endl;
+        if (!out)
+            std::cerr << "Could not write " << output.getValue() << std::endl;
+        return bool(out);
+    };
+
+    while (now_ms() - begin < duration.getValue() * 1000)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        for (auto&& beat : heartbeats)
+        {
+            if (now_ms() - beat->last > watchdog.getValue() * 1000)
+            {
+                // The stuck threads cannot be joined, the process ends without them
+                failures.push_back("deadlock, the " + beat->name + " thread is stuck");
+                report();
+                write_output();
+                std::cerr << "FAILED: " << failures.back() << std::endl;
+                std::_Exit(EXIT_FAILURE);
+            }
+        }
+        if (now_ms() >= next_report)
+        {
+            report();
+            next_report += interval.getValue() * 1000;
+        }
+    }
+
+    done = true;
+    for (auto&& t : threads)
+        t.join();
+    {
+        std::lock_guard<std::mutex> lock(streaming_mutex);
+        stop();
+    }
+    report();
+
+    // The memory is compared from the end of the first interval, once the pools and caches are filled
+    if (samples.size() > 1)
+    {
+        auto growth_mb = (double(samples.back().memory_kb) - samples.front().memory_kb) / 1024;
+        std::cout << "memory growth: " << growth_mb << " MB" << std::endl;
+        if (growth_mb > max_growth.getValue())
+            failures.push_back("memory grew by " + std::to_string(growth_mb) + " MB");
+    }
+
+    auto written = write_output();
+    for (auto&& failure : failures)
+        std::cerr << "FAILED: " << failure << std::endl;
+    return failures.empty() && written ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+catch (const rs2::error& e)
+{
+    std::cerr << "RealSense error calling " << e.get_failed_function() << "(" << e.get_failed_args() << "):\n    " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
+catch (const std::exception& e)
+{
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
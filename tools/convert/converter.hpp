@@ -6,7 +6,15 @@
 
 #include <unordered_map>
 #include <unordered_set>
+#include <map>
+#include <deque>
 #include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <algorithm>
+#include <memory>
 #include <string>
 #include <sstream>
 
@@ -19,13 +27,155 @@ namespace rs2 {
 
             typedef unsigned long long frame_number_t;
 
+            // Threads shared by the converters, for the frames of a frameset and of the framesets after it to be
+            // encoded and written at once. The tasks not done yet are bounded, holding frames the playback cannot
+            // reuse: enqueue blocks the reader on them, below the frames a stream can publish
+            class worker_pool {
+                static const size_t max_threads = 8;
+                static const size_t max_pending = 12;
+
+                std::vector<std::thread> _threads;
+                std::deque<std::function<void()>> _tasks;
+                size_t _pending;
+                bool _stopping;
+                std::mutex _mutex;
+                std::condition_variable _taskAdded;
+                std::condition_variable _taskDone;
+
+                worker_pool()
+                    : _pending(0)
+                    , _stopping(false)
+                {
+                    auto count = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1U), max_threads);
+
+                    for (size_t i = 0; i < count; i++) {
+                        _threads.emplace_back([this] { run(); });
+                    }
+                }
+
+                void run()
+                {
+                    std::unique_lock<std::mutex> lock(_mutex);
+
+                    while (true) {
+                        _taskAdded.wait(lock, [this] { return _stopping || !_tasks.empty(); });
+
+                        if (_tasks.empty()) {
+                            return;
+                        }
+
+                        auto task = std::move(_tasks.front());
+                        _tasks.pop_front();
+
+                        lock.unlock();
+                        task();
+                        lock.lock();
+
+                        _pending--;
+                        _taskDone.notify_all();
+                    }
+                }
+
+            public:
+                static worker_pool& instance()
+                {
+                    static worker_pool pool;
+                    return pool;
+                }
+
+                ~worker_pool()
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(_mutex);
+                        _stopping = true;
+                    }
+
+                    _taskAdded.notify_all();
+
+                    for_each(_threads.begin(), _threads.end(),
+                        [] (std::thread& t) {
+                            t.join();
+                        });
+                }
+
+                void enqueue(std::function<void()> task)
+                {
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    _taskDone.wait(lock, [this] { return _pending < max_pending; });
+
+                    _pending++;
+                    _tasks.push_back(std::move(task));
+                    _taskAdded.notify_one();
+                }
+            };
+
             class converter_base {
             protected:
-                std::thread _worker;
-                std::vector<std::thread> _subWorkers;
                 std::unordered_map<int, std::unordered_set<frame_number_t>> _framesMap;
 
+            private:
+                // Of the tasks of the converter, for wait to return once they are done
+                size_t _subWorkers = 0;
+                std::exception_ptr _error;
+                std::mutex _mutex;
+                std::condition_variable _subWorkerDone;
+
+                // Outputs of the ordered tasks done out of their turn, by the ticket they were added with
+                std::map<size_t, std::function<void()>> _outputs;
+                size_t _nextTicket = 0;
+                size_t _nextOutput = 0;
+                bool _writing = false;
+
+                void sub_worker_done(std::exception_ptr error)
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+
+                    if (error && !_error) {
+                        _error = error;
+                    }
+
+                    _subWorkers--;
+                    _subWorkerDone.notify_all();
+                }
+
+                // Writes the outputs in the order of their tickets, on the thread of whichever task completes the next one
+                void output(size_t ticket, std::function<void()> write)
+                {
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    _outputs.emplace(ticket, std::move(write));
+
+                    if (_writing) {
+                        return;
+                    }
+
+                    _writing = true;
+
+                    while (!_outputs.empty() && _outputs.begin()->first == _nextOutput) {
+                        auto next = std::move(_outputs.begin()->second);
+                        _outputs.erase(_outputs.begin());
+
+                        lock.unlock();
+                        std::exception_ptr error;
+                        try {
+                            next();
+                        }
+                        catch (...) {
+                            error = std::current_exception();
+                        }
+                        lock.lock();
+
+                        if (error && !_error) {
+                            _error = error;
+                        }
+
+                        _nextOutput++;
+                    }
+
+                    _writing = false;
+                }
+
             protected:
+                // Not thread safe, called by convert only
                 bool frames_map_get_and_set(rs2_stream streamType, frame_number_t frameNumber)
                 {
                     if (_framesMap.find(streamType) == _framesMap.end()) {
@@ -42,27 +192,67 @@ namespace rs2 {
                     return result;
                 }
 
-                template <typename F> void start_worker(const F& f)
+                // Runs f on the shared workers, waiting for one of them when too many tasks are pending
+                template <typename F> void add_sub_worker(const F& f)
                 {
-                    _worker = std::thread(f);
+                    {
+                        std::lock_guard<std::mutex> lock(_mutex);
+                        _subWorkers++;
+                    }
+
+                    worker_pool::instance().enqueue(
+                        [this, f] {
+                            std::exception_ptr error;
+                            try {
+                                f();
+                            }
+                            catch (...) {
+                                error = std::current_exception();
+                            }
+
+                            sub_worker_done(error);
+                        });
                 }
 
-                template <typename F> void add_sub_worker(const F& f)
+                // Runs f on the shared workers as add_sub_worker does, and write with its result after the writes of
+                // the tasks added before it, for the output to follow the order of the frames
+                template <typename F, typename W> void add_ordered_sub_worker(const F& f, const W& write)
                 {
-                    _subWorkers.emplace_back(f);
+                    size_t ticket;
+                    {
+                        std::lock_guard<std::mutex> lock(_mutex);
+                        ticket = _nextTicket++;
+                    }
+
+                    add_sub_worker(
+                        [this, f, write, ticket] {
+                            std::shared_ptr<decltype(f())> result;
+                            try {
+                                result = std::make_shared<decltype(f())>(f());
+                            }
+                            catch (...) {
+                                // The ticket is still used, for the tasks after it not to wait on it
+                                output(ticket, [] {});
+                                throw;
+                            }
+
+                            output(ticket, [write, result] { write(*result); });
+                        });
                 }
 
                 void wait_sub_workers()
                 {
-                    for_each(_subWorkers.begin(), _subWorkers.end(),
-                        [] (std::thread& t) {
-                            t.join();
-                        });
-
-                    _subWorkers.clear();
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    _subWorkerDone.wait(lock, [this] { return _subWorkers == 0; });
                 }
 
             public:
+                virtual ~converter_base()
+                {
+                    wait_sub_workers();
+                }
+
+                // Scans the frameset on the calling thread and leaves the encoding and the writing to the workers
                 virtual void convert(rs2::frameset& frameset) = 0;
                 virtual std::string name() const = 0;
 
@@ -82,9 +272,17 @@ namespace rs2 {
                     return (result.str());
                 }
 
+                // Waits for the frames converted so far to be written, throwing the first error of their tasks
                 void wait()
                 {
-                    _worker.join();
+                    wait_sub_workers();
+
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    if (_error) {
+                        auto error = _error;
+                        _error = nullptr;
+                        std::rethrow_exception(error);
+                    }
                 }
             };
 
@@ -73,47 +73,42 @@ namespace rs2 {
 
                 void convert(rs2::frameset& frameset) override
                 {
-                    start_worker(
-                        [this, &frameset] {
-                            for (size_t i = 0; i < frameset.size(); i++) {
-                                rs2::depth_frame frame = frameset[i].as<rs2::depth_frame>();
-
-                                if (frame && (_streamType == rs2_stream::RS2_STREAM_ANY || frame.get_profile().stream_type() == _streamType)) {
-                                    if (frames_map_get_and_set(frame.get_profile().stream_type(), frame.get_frame_number())) {
-                                        continue;
-                                    }
+                    for (size_t i = 0; i < frameset.size(); i++) {
+                        rs2::depth_frame frame = frameset[i].as<rs2::depth_frame>();
 
-                                    std::stringstream filename;
-                                    filename << _filePath
-                                        << "_" << frame.get_profile().stream_name()
-                                        << "_" << frame.get_frame_number()
-                                        << ".bin";
+                        if (frame && (_streamType == rs2_stream::RS2_STREAM_ANY || frame.get_profile().stream_type() == _streamType)) {
+                            if (frames_map_get_and_set(frame.get_profile().stream_type(), frame.get_frame_number())) {
+                                continue;
+                            }
 
-                                    std::string filenameS = filename.str();
+                            std::stringstream filename;
+                            filename << _filePath
+                                << "_" << frame.get_profile().stream_name()
+                                << "_" << frame.get_frame_number()
+                                << ".bin";
 
-                                    add_sub_worker(
-                                        [filenameS, frame] {
-                                            std::ofstream fs(filenameS, std::ios::binary | std::ios::trunc);
+                            std::string filenameS = filename.str();
 
-                                            if (fs) {
-                                                uint8_t buffer[4];
+                            add_sub_worker(
+                                [filenameS, frame] {
+                                    std::ofstream fs(filenameS, std::ios::binary | std::ios::trunc);
 
-                                                for (int y = 0; y < frame.get_height(); y++) {
-                                                    for (int x = 0; x < frame.get_width(); x++) {
-                                                        fs.write(
-                                                            static_cast<const char *>(to_ieee754_32(frame.get_distance(x, y), buffer))
-                                                            , sizeof buffer);
-                                                    }
-                                                }
+                                    if (fs) {
+                                        uint8_t buffer[4];
 
-                                                fs.flush();
+                                        for (int y = 0; y < frame.get_height(); y++) {
+                                            for (int x = 0; x < frame.get_width(); x++) {
+                                                fs.write(
+                                                    static_cast<const char *>(to_ieee754_32(frame.get_distance(x, y), buffer))
+                                                    , sizeof buffer);
                                             }
-                                        });
-                                }
-                            }
+                                        }
 
-                            wait_sub_workers();
-                        });
+                                        fs.flush();
+                                    }
+                                });
+                        }
+                    }
                 }
             };
 
@@ -15,10 +15,14 @@ namespace rs2 {
             class converter_ply : public converter_base {
             protected:
                 std::string _filePath;
+                bool _normals;
+                bool _faces;
 
             public:
-                converter_ply(const std::string& filePath)
+                converter_ply(const std::string& filePath, bool normals = false, bool faces = false)
                     : _filePath(filePath)
+                    , _normals(normals)
+                    , _faces(faces)
                 {
                 }
 
@@ -29,29 +33,31 @@ namespace rs2 {
 
                 void convert(rs2::frameset& frameset) override
                 {
-                    start_worker(
-                        [this, &frameset] {
-                            auto frameDepth = frameset.get_depth_frame();
-                            auto frameColor = frameset.get_color_frame();
+                    auto frameDepth = frameset.get_depth_frame();
+                    auto frameColor = frameset.get_color_frame();
 
-                            if (frameDepth && frameColor) {
-                                if (frames_map_get_and_set(rs2_stream::RS2_STREAM_ANY, frameDepth.get_frame_number())) {
-                                    return;
-                                }
+                    if (frameDepth && frameColor) {
+                        if (frames_map_get_and_set(rs2_stream::RS2_STREAM_ANY, frameDepth.get_frame_number())) {
+                            return;
+                        }
 
+                        std::stringstream filename;
+                        filename << _filePath
+                            << "_" << frameDepth.get_frame_number()
+                            << ".ply";
+
+                        std::string filenameS = filename.str();
+
+                        // A pointcloud of its own for every task, for them to calculate at once
+                        add_sub_worker(
+                            [this, filenameS, frameDepth, frameColor] {
                                 rs2::pointcloud pc;
                                 pc.map_to(frameColor);
 
                                 auto points = pc.calculate(frameDepth);
-
-                                std::stringstream filename;
-                                filename << _filePath
-                                    << "_" << frameDepth.get_frame_number()
-                                    << ".ply";
-
-                                points.export_to_ply(filename.str(), frameColor);
-                            }
-                        });
+                                points.export_to_ply(filenameS, frameColor, _normals, _faces);
+                            });
+                    }
                 }
             };
 
@@ -32,41 +32,36 @@ namespace rs2 {
 
                 void convert(rs2::frameset& frameset) override
                 {
-                    start_worker(
-                        [this, &frameset] {
-                            for (size_t i = 0; i < frameset.size(); i++) {
-                                rs2::video_frame frame = frameset[i].as<rs2::video_frame>();
-
-                                if (frame && (_streamType == rs2_stream::RS2_STREAM_ANY || frame.get_profile().stream_type() == _streamType)) {
-                                    if (frames_map_get_and_set(frame.get_profile().stream_type(), frame.get_frame_number())) {
-                                        continue;
-                                    }
+                    for (size_t i = 0; i < frameset.size(); i++) {
+                        rs2::video_frame frame = frameset[i].as<rs2::video_frame>();
 
-                                    std::stringstream filename;
-                                    filename << _filePath
-                                        << "_" << frame.get_profile().stream_name()
-                                        << "_" << frame.get_frame_number()
-                                        << ".raw";
+                        if (frame && (_streamType == rs2_stream::RS2_STREAM_ANY || frame.get_profile().stream_type() == _streamType)) {
+                            if (frames_map_get_and_set(frame.get_profile().stream_type(), frame.get_frame_number())) {
+                                continue;
+                            }
 
-                                    std::string filenameS = filename.str();
+                            std::stringstream filename;
+                            filename << _filePath
+                                << "_" << frame.get_profile().stream_name()
+                                << "_" << frame.get_frame_number()
+                                << ".raw";
 
-                                    add_sub_worker(
-                                        [filenameS, frame] {
-                                            std::ofstream fs(filenameS, std::ios::binary | std::ios::trunc);
+                            std::string filenameS = filename.str();
 
-                                            if (fs) {
-                                                fs.write(
-                                                    static_cast<const char *>(frame.get_data())
-                                                    , frame.get_stride_in_bytes() * frame.get_height());
+                            add_sub_worker(
+                                [filenameS, frame] {
+                                    std::ofstream fs(filenameS, std::ios::binary | std::ios::trunc);
 
-                                                fs.flush();
-                                            }
-                                        });
-                                }
-                            }
+                                    if (fs) {
+                                        fs.write(
+                                            static_cast<const char *>(frame.get_data())
+                                            , frame.get_stride_in_bytes() * frame.get_height());
 
-                            wait_sub_workers();
-                        });
+                                        fs.flush();
+                                    }
+                                });
+                        }
+                    }
                 }
             };
 
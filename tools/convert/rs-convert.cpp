@@ -30,6 +30,8 @@ int main(int argc, char** argv) try
     ValueArg<string> outputFilenameRaw("r", "output-raw", "output RAW file(s) path", false, "", "raw-path");
     ValueArg<string> outputFilenamePly("l", "output-ply", "output PLY file(s) path", false, "", "ply-path");
     ValueArg<string> outputFilenameBin("b", "output-bin", "output BIN (depth matrix) file(s) path", false, "", "bin-path");
+    SwitchArg switchPlyNormals("", "ply-normals", "export the normals of the PLY vertices", false);
+    SwitchArg switchPlyFaces("", "ply-faces", "export the PLY vertices as a mesh of triangles", false);
     SwitchArg switchDepth("d", "depth", "convert depth frames (default - all supported)", false);
     SwitchArg switchColor("c", "color", "convert color frames (default - all supported)", false);
 
@@ -39,6 +41,8 @@ int main(int argc, char** argv) try
     cmd.add(outputFilenameRaw);
     cmd.add(outputFilenamePly);
     cmd.add(outputFilenameBin);
+    cmd.add(switchPlyNormals);
+    cmd.add(switchPlyFaces);
     cmd.add(switchDepth);
     cmd.add(switchColor);
     cmd.parse(argc, argv);
@@ -73,7 +77,9 @@ int main(int argc, char** argv) try
     if (outputFilenamePly.isSet()) {
         converters.push_back(
             make_shared<rs2::tools::converter::converter_ply>(
-                outputFilenamePly.getValue()));
+                outputFilenamePly.getValue()
+                , switchPlyNormals.isSet()
+                , switchPlyFaces.isSet()));
     }
 
     if (outputFilenameBin.isSet()) {
@@ -119,13 +125,14 @@ int main(int argc, char** argv) try
             [&frameset] (shared_ptr<rs2::tools::converter::converter_base>& converter) {
                 converter->convert(frameset);
             });
-
-        for_each(converters.begin(), converters.end(),
-            [] (shared_ptr<rs2::tools::converter::converter_base>& converter) {
-                converter->wait();
-            });
     }
 
+    // The frames are written while the next framesets are read, waiting for the writes only at the end
+    for_each(converters.begin(), converters.end(),
+        [] (shared_ptr<rs2::tools::converter::converter_base>& converter) {
+            converter->wait();
+        });
+
     cout << endl;
 
     for_each(converters.begin(), converters.end(),
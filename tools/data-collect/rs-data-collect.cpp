@@ -14,22 +14,68 @@
 #include <thread>
 #include <array>
 #include <atomic>
+#include <algorithm>
+#include <iomanip>
+#include <vector>
 
 using namespace std;
 using namespace TCLAP;
 
 int MAX_FRAMES_NUMBER = 10; //number of frames to capture from each stream
 const unsigned int NUM_OF_STREAMS = static_cast<int>(RS2_STREAM_COUNT);
+const size_t RING_CAPACITY = 1 << 14; // records of a stream not written yet, 40 seconds of 400 Hz IMU
 
 struct frame_data
 {
     unsigned long long frame_number;
     double ts;
-    long long arrival_time;
+    double arrival_time; // milliseconds from the start of the capture
     rs2_timestamp_domain domain;
     rs2_stream stream_type;
 };
 
+// Records of a stream, pushed by the callback of its sensor and popped by the writer thread without locks.
+// A single producer and a single consumer, the indices only ever grow
+class frame_ring
+{
+public:
+    frame_ring() : _records(RING_CAPACITY), _head(0), _tail(0) {}
+
+    bool push(const frame_data& data)
+    {
+        auto head = _head.load(memory_order_relaxed);
+        if (head - _tail.load(memory_order_acquire) == _records.size())
+            return false;
+        _records[head % _records.size()] = data;
+        _head.store(head + 1, memory_order_release);
+        return true;
+    }
+
+    bool pop(frame_data& data)
+    {
+        auto tail = _tail.load(memory_order_relaxed);
+        if (tail == _head.load(memory_order_acquire))
+            return false;
+        data = _records[tail % _records.size()];
+        _tail.store(tail + 1, memory_order_release);
+        return true;
+    }
+
+private:
+    vector<frame_data> _records;
+    atomic<size_t> _head;
+    atomic<size_t> _tail;
+};
+
+struct stream_records
+{
+    frame_ring ring;
+    atomic<unsigned long long> received{ 0 };   // recorded, up to the maximal number of frames
+    atomic<unsigned long long> overflows{ 0 };  // lost as the writer fell behind
+    atomic<unsigned long long> missed{ 0 };     // skipped frame numbers, dropped before the callback
+    unsigned long long last_frame_number = 0;   // of the callback thread alone
+};
+
 enum Config_Params { STREAM_TYPE = 0, RES_WIDTH, RES_HEIGHT, FPS, FORMAT };
 
 int parse_number(char const *s, int base = 0)
@@ -123,28 +169,85 @@ void configure_stream(rs2::config& cfg, std::string filename)
     }
 }
 
-void save_data_to_file(std::array<list<frame_data>, NUM_OF_STREAMS> buffer, const string& filename)
+// Streams the records to the file while the capture runs, as CSV or as packed binary records
+class data_writer
 {
-    // Save to file
-    ofstream csv;
-    csv.open(filename);
-    csv << "Stream Type,F#,Timestamp,Arrival Time\n";
+public:
+    data_writer(std::array<stream_records, NUM_OF_STREAMS>& streams, const string& filename, bool binary)
+        : _streams(streams), _binary(binary), _running(true)
+    {
+        _out.open(filename, binary ? ios::binary | ios::trunc : ios::trunc);
+        if (!_out)
+            throw runtime_error("Could not open " + filename);
+        if (!_binary)
+            _out << "Stream Type,F#,Timestamp,Arrival Time\n";
+        _thread = std::thread([this]() { run(); });
+    }
 
-    for (int stream_index = 0; stream_index < NUM_OF_STREAMS; stream_index++)
+    // Writes the records left, and returns once they are in the file
+    void stop()
     {
-        auto buffer_size = buffer[stream_index].size();
-        for (auto i = 0; i < buffer_size; i++)
+        _running = false;
+        if (_thread.joinable())
+            _thread.join();
+        _out.flush();
+    }
+
+    ~data_writer() { stop(); }
+
+private:
+    void run()
+    {
+        while (true)
         {
-            ostringstream line;
-            auto data = buffer[stream_index].front();
-            line << rs2_stream_to_string(data.stream_type) << "," << data.frame_number << "," << std::fixed << std::setprecision(3) << data.ts << "," << data.arrival_time << "\n";
-            buffer[stream_index].pop_front();
-            csv << line.str();
+            auto last = !_running;
+            if (!write_available() && !last)
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            if (last)
+                break;
         }
     }
 
-    csv.close();
-}
+    bool write_available()
+    {
+        bool written = false;
+        frame_data data;
+        for (auto&& stream : _streams)
+        {
+            while (stream.ring.pop(data))
+            {
+                write(data);
+                written = true;
+            }
+        }
+        return written;
+    }
+
+    void write(const frame_data& data)
+    {
+        if (_binary)
+        {
+            // 32 bytes a record, little endian: stream type, timestamp domain, frame number, timestamp and arrival time
+            int32_t type = data.stream_type, domain = data.domain;
+            uint64_t frame_number = data.frame_number;
+            _out.write(reinterpret_cast<const char*>(&type), sizeof(type));
+            _out.write(reinterpret_cast<const char*>(&domain), sizeof(domain));
+            _out.write(reinterpret_cast<const char*>(&frame_number), sizeof(frame_number));
+            _out.write(reinterpret_cast<const char*>(&data.ts), sizeof(data.ts));
+            _out.write(reinterpret_cast<const char*>(&data.arrival_time), sizeof(data.arrival_time));
+        }
+        else
+        {
+            _out << rs2_stream_to_string(data.stream_type) << "," << data.frame_number << "," << std::fixed << std::setprecision(3) << data.ts << "," << data.arrival_time << "\n";
+        }
+    }
+
+    std::array<stream_records, NUM_OF_STREAMS>& _streams;
+    bool _binary;
+    ofstream _out;
+    std::atomic_bool _running;
+    std::thread _thread;
+};
 
 int main(int argc, char** argv) try
 {
@@ -156,20 +259,25 @@ int main(int argc, char** argv) try
     ValueArg<int>    max_frames("m", "MaxFrames_Number", "Maximun number of frames data to receive", false, 100, "");
     ValueArg<string> filename("f", "FullFilePath", "the file which the data will be saved to", false, "", "");
     ValueArg<string> config_file("c", "ConfigurationFile", "Specify file path with the requested configuration", false, "", "");
+    SwitchArg        binary("b", "Binary", "Save the data as packed binary records rather than as CSV", false);
 
     cmd.add(timeout);
     cmd.add(max_frames);
     cmd.add(filename);
     cmd.add(config_file);
+    cmd.add(binary);
     cmd.parse(argc, argv);
 
-    std::string output_file = filename.isSet() ? filename.getValue() : "frames_data.csv";
+    std::string output_file = filename.isSet() ? filename.getValue() : (binary.isSet() ? "frames_data.bin" : "frames_data.csv");
 
     auto max_frames_number = MAX_FRAMES_NUMBER;
 
     if (max_frames.isSet())
         max_frames_number = max_frames.getValue();
 
+    // Given a timeout alone, every frame until it is recorded
+    auto limit_frames = !timeout.isSet() || max_frames.isSet();
+
     bool succeed = false;
 
     while (!succeed)
@@ -181,10 +289,17 @@ int main(int argc, char** argv) try
             configure_stream(config, config_file.getValue());
         }
 
-        rs2::pipeline_profile profile = pipe.start(config);
+        // The sensors of the resolved streams deliver to the records from their own threads, with no frame queue in between
+        rs2::pipeline_profile profile = config.resolve(pipe);
         auto dev = profile.get_device();
+        auto active_streams = profile.get_streams();
+
+        std::array<stream_records, NUM_OF_STREAMS> streams;
+        data_writer writer(streams, output_file, binary.isSet());
+        auto start_time = chrono::high_resolution_clock::now();
 
         std::atomic_bool need_to_reset(false);
+        std::vector<rs2::sensor> started;
         for (auto sub : dev.query_sensors())
         {
             sub.set_notifications_callback([&](const rs2::notification& n)
@@ -194,10 +309,42 @@ int main(int argc, char** argv) try
                     need_to_reset = true;
                 }
             });
+
+            std::vector<rs2::stream_profile> profiles;
+            for (auto&& p : sub.get_stream_profiles())
+                for (auto&& active : active_streams)
+                    if (p.unique_id() == active.unique_id())
+                        profiles.push_back(p);
+            if (profiles.empty())
+                continue;
+
+            sub.open(profiles);
+            sub.start([&](rs2::frame f)
+            {
+                auto arrival_time = chrono::duration<double, std::milli>(chrono::high_resolution_clock::now() - start_time);
+                auto& stream = streams[(int)f.get_profile().stream_type()];
+
+                auto frame_number = f.get_frame_number();
+                if (stream.last_frame_number && frame_number > stream.last_frame_number + 1)
+                    stream.missed += frame_number - stream.last_frame_number - 1;
+                stream.last_frame_number = std::max(stream.last_frame_number, frame_number);
+
+                if (limit_frames && stream.received >= static_cast<unsigned long long>(max_frames_number))
+                    return;
+
+                frame_data data{ frame_number,
+                                 f.get_timestamp(),
+                                 arrival_time.count(),
+                                 f.get_frame_timestamp_domain(),
+                                 f.get_profile().stream_type() };
+                if (stream.ring.push(data))
+                    stream.received++;
+                else
+                    stream.overflows++;
+            });
+            started.push_back(sub);
         }
 
-        std::array<std::list<frame_data>, NUM_OF_STREAMS> buffer;
-        auto start_time = chrono::high_resolution_clock::now();
         const auto ready = [&]()
         {
             //If not switch is set, we're ready after max_frames_number frames.
@@ -212,9 +359,9 @@ int main(int argc, char** argv) try
             }
 
             bool collected_enough_frames = true;
-            for (auto&& profile : pipe.get_active_profile().get_streams())
+            for (auto&& profile : active_streams)
             {
-                if (buffer[(int)profile.stream_type()].size() < max_frames_number)
+                if (streams[(int)profile.stream_type()].received < static_cast<unsigned long long>(max_frames_number))
                 {
                     collected_enough_frames = false;
                 }
@@ -226,39 +373,33 @@ int main(int argc, char** argv) try
             return timed_out || collected_enough_frames;
         };
 
-        while (!ready())
-        {
-            auto frameset = pipe.wait_for_frames();
-            auto arrival_time = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - start_time);
+        while (!ready() && !need_to_reset)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
 
-            for (auto it = frameset.begin(); it != frameset.end(); ++it)
-            {
-                auto f = (*it);
-                frame_data data{f.get_frame_number(),
-                                f.get_timestamp(),
-                                arrival_time.count(),
-                                f.get_frame_timestamp_domain(),
-                                f.get_profile().stream_type()};
-                if (buffer[(int)data.stream_type].size() < max_frames_number)
-                {
-                    buffer[(int)data.stream_type].push_back(data);
-                }
-            }
+        for (auto&& sub : started)
+        {
+            sub.stop();
+            sub.close();
+        }
+        writer.stop();
 
-            if (need_to_reset)
-            {
-                dev.hardware_reset();
-                need_to_reset = false;
-                break;
-            }
+        if (need_to_reset)
+        {
+            dev.hardware_reset();
+            continue;
         }
 
-        if(ready())
+        std::set<rs2_stream> types;
+        for (auto&& profile : active_streams)
+            types.insert(profile.stream_type());
+        for (auto type : types)
         {
-            save_data_to_file(buffer, output_file);
-            pipe.stop();
-            succeed = true;
+            auto& stream = streams[(int)type];
+            cout << rs2_stream_to_string(type) << ": " << stream.received << " frames recorded, "
+                 << stream.missed << " frame numbers skipped, "
+                 << stream.overflows << " records lost as the writer fell behind" << endl;
         }
+        succeed = true;
     }
     return EXIT_SUCCESS;
 }
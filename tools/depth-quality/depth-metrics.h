@@ -7,6 +7,9 @@
 #include <vector>
 #include <mutex>
 #include <array>
+#include <thread>
+#include <cstring>
+#include <algorithm>
 #include <imgui.h>
 #include <librealsense2/rsutil.h>
 #include <librealsense2/rs.hpp>
@@ -59,26 +62,42 @@ namespace rs2
             return{ normal.x, normal.y, normal.z, -(normal.x*point.x + normal.y*point.y + normal.z*point.z) };
         }
 
-        //Based on: http://www.ilikebigbits.com/blog/2015/3/2/plane-from-points
-        inline plane plane_from_points(const std::vector<rs2::float3> points)
+        // Sums of the coordinates of the points and of their products, accumulated in a single pass and merged across threads
+        struct plane_moments
         {
-            if (points.size() < 3) throw std::runtime_error("Not enough points to calculate plane");
-
-            rs2::float3 sum = { 0,0,0 };
-            for (auto point : points) sum = sum + point;
-
-            rs2::float3 centroid = sum / float(points.size());
-
-            double xx = 0, xy = 0, xz = 0, yy = 0, yz = 0, zz = 0;
-            for (auto point : points) {
-                rs2::float3 temp = point - centroid;
-                xx += temp.x * temp.x;
-                xy += temp.x * temp.y;
-                xz += temp.x * temp.z;
-                yy += temp.y * temp.y;
-                yz += temp.y * temp.z;
-                zz += temp.z * temp.z;
+            double n = 0, x = 0, y = 0, z = 0, xx = 0, xy = 0, xz = 0, yy = 0, yz = 0, zz = 0;
+
+            void add(const rs2::float3& p)
+            {
+                n++;
+                x += p.x; y += p.y; z += p.z;
+                xx += p.x * p.x; xy += p.x * p.y; xz += p.x * p.z;
+                yy += p.y * p.y; yz += p.y * p.z; zz += p.z * p.z;
+            }
+
+            void add(const plane_moments& m)
+            {
+                n += m.n;
+                x += m.x; y += m.y; z += m.z;
+                xx += m.xx; xy += m.xy; xz += m.xz;
+                yy += m.yy; yz += m.yz; zz += m.zz;
             }
+        };
+
+        //Based on: http://www.ilikebigbits.com/blog/2015/3/2/plane-from-points
+        inline plane plane_from_moments(const plane_moments& m)
+        {
+            if (m.n < 3) throw std::runtime_error("Not enough points to calculate plane");
+
+            rs2::float3 centroid{ float(m.x / m.n), float(m.y / m.n), float(m.z / m.n) };
+
+            // The sums of the products of the points relative to their centroid
+            double xx = m.xx - m.x * m.x / m.n;
+            double xy = m.xy - m.x * m.y / m.n;
+            double xz = m.xz - m.x * m.z / m.n;
+            double yy = m.yy - m.y * m.y / m.n;
+            double yz = m.yz - m.y * m.z / m.n;
+            double zz = m.zz - m.z * m.z / m.n;
 
             double det_x = yy*zz - yz*yz;
             double det_y = xx*zz - xz*xz;
@@ -110,6 +129,42 @@ namespace rs2
             return plane_from_point_and_normal(centroid, dir.normalize());
         }
 
+        inline plane plane_from_points(const std::vector<rs2::float3>& points)
+        {
+            plane_moments m;
+            for (auto&& point : points) m.add(point);
+            return plane_from_moments(m);
+        }
+
+        // Rays of the pixels of the ROI at unit depth, to deproject by a multiplication. Deprojection is linear in depth for
+        // every distortion model, so the rays are calculated once for the intrinsics and the ROI they last changed to
+        class roi_rays
+        {
+        public:
+            const std::vector<rs2::float3>& get(const rs2_intrinsics& intrin, const rs2::region_of_interest& roi)
+            {
+                if (memcmp(&intrin, &_intrin, sizeof(intrin)) || memcmp(&roi, &_roi, sizeof(roi)) || _rays.empty())
+                {
+                    _intrin = intrin;
+                    _roi = roi;
+                    _rays.resize(std::max(0, (roi.max_x - roi.min_x) * (roi.max_y - roi.min_y)));
+                    auto ray = _rays.begin();
+                    for (int y = roi.min_y; y < roi.max_y; ++y)
+                        for (int x = roi.min_x; x < roi.max_x; ++x, ++ray)
+                        {
+                            float pixel[2] = { float(x), float(y) };
+                            rs2_deproject_pixel_to_point(&ray->x, &intrin, pixel, 1.f);
+                        }
+                }
+                return _rays;
+            }
+
+        private:
+            rs2_intrinsics _intrin{};
+            rs2::region_of_interest _roi{};
+            std::vector<rs2::float3> _rays;
+        };
+
         inline double evaluate_pixel(const plane& p, const rs2_intrinsics* intrin, float x, float y, float distance, float3& output)
         {
             float pixel[2] = { x, y };
@@ -153,35 +208,74 @@ namespace rs2
 
             snapshot_metrics result{ w, h, roi, {} };
 
-            std::mutex m;
-
-            std::vector<rs2::float3> roi_pixels;
+            if (roi.max_x <= roi.min_x || roi.max_y <= roi.min_y)
+                return result;
 
-//#pragma omp parallel for - TODO optimization envisaged
-            for (int y = roi.min_y; y < roi.max_y; ++y)
-                for (int x = roi.min_x; x < roi.max_x; ++x)
+            // Of the thread the frames are analyzed on
+            static thread_local roi_rays rays_cache;
+            auto& rays = rays_cache.get(*intrin, roi);
+            const int roi_width = roi.max_x - roi.min_x;
+            const int roi_height = roi.max_y - roi.min_y;
+
+            // Rows of the ROI in bands of a thread each, for large ROIs. Every band deprojects its pixels in order and
+            // sums their moments, and the bands are joined in order, for the points to be the same on any thread count
+            const int min_band_pixels = 1 << 16;
+            auto bands = std::max(1, std::min<int>(std::thread::hardware_concurrency(), roi_width * roi_height / min_band_pixels));
+            bands = std::min(bands, roi_height);
+            std::vector<std::vector<rs2::float3>> band_points(bands);
+            std::vector<plane_moments> band_moments(bands);
+
+            auto deproject_rows = [&](int band)
+            {
+                auto first = roi_height * band / bands, last = roi_height * (band + 1) / bands;
+                auto& points = band_points[band];
+                auto& moments = band_moments[band];
+                points.reserve((last - first) * roi_width);
+                for (int y = first; y < last; ++y)
                 {
-                    auto depth_raw = pixels[y*w + x];
-
-                    if (depth_raw)
+                    auto row = pixels + (roi.min_y + y) * w + roi.min_x;
+                    auto ray = rays.data() + y * roi_width;
+                    for (int x = 0; x < roi_width; ++x)
                     {
-                        // units is float
-                        float pixel[2] = { float(x), float(y) };
-                        float point[3];
-                        auto distance = depth_raw * units;
-
-                        rs2_deproject_pixel_to_point(point, intrin, pixel, distance);
-
-                        std::lock_guard<std::mutex> lock(m);
-                        roi_pixels.push_back({ point[0], point[1], point[2] });
+                        if (!row[x]) continue;
+                        auto distance = row[x] * units;
+                        rs2::float3 point{ ray[x].x * distance, ray[x].y * distance, ray[x].z * distance };
+                        points.push_back(point);
+                        moments.add(point);
                     }
                 }
+            };
+
+            std::vector<std::thread> threads;
+            for (int band = 1; band < bands; ++band)
+                threads.emplace_back(deproject_rows, band);
+            deproject_rows(0);
+            for (auto&& t : threads)
+                t.join();
+
+            plane_moments moments;
+            size_t count = 0;
+            for (int band = 0; band < bands; ++band)
+            {
+                moments.add(band_moments[band]);
+                count += band_points[band].size();
+            }
+
+            std::vector<rs2::float3> roi_pixels;
+            if (bands == 1)
+                roi_pixels.swap(band_points[0]);
+            else
+            {
+                roi_pixels.reserve(count);
+                for (auto&& points : band_points)
+                    roi_pixels.insert(roi_pixels.end(), points.begin(), points.end());
+            }
 
             if (roi_pixels.size() < 3) { // Not enough pixels in RoI to fit a plane
                 return result;
             }
 
-            plane p = plane_from_points(roi_pixels);
+            plane p = plane_from_moments(moments);
 
             if (p == plane{ 0, 0, 0, 0 }) { // The points in RoI don't span a valid plane
                 return result;
@@ -2,6 +2,7 @@
 // Copyright(c) 2015 Intel Corporation. All Rights Reserved.
 
 #include <numeric>
+#include <algorithm>
 #include <librealsense2/rs.hpp>
 #include "depth-quality-model.h"
 
@@ -92,24 +93,27 @@ int main(int argc, const char * argv[]) try
         const float bf_factor = baseline_mm * focal_length_pixels * TO_METERS; // also convert point units from mm to meter
 
         std::vector<rs2::float3> points_set = points;
-        std::vector<float> distances;
-        std::vector<float> disparities;
         std::vector<float> gt_errors;
 
         // Reserve memory for the data
-        distances.reserve(points.size());
-        disparities.reserve(points.size());
         if (ground_truth_mm) gt_errors.reserve(points.size());
 
-        // Remove outliers [below 0.5% and above 99.5%)
-        std::sort(points_set.begin(), points_set.end(), [](const rs2::float3& a, const rs2::float3& b) { return a.z < b.z; });
+        // Remove outliers [below 0.5% and above 99.5%), partitioning the points around the two rather than sorting them
+        auto by_z = [](const rs2::float3& a, const rs2::float3& b) { return a.z < b.z; };
         size_t outliers = points_set.size() / 200;
+        if (outliers)
+        {
+            std::nth_element(points_set.begin(), points_set.begin() + outliers, points_set.end(), by_z);
+            std::nth_element(points_set.begin() + outliers, points_set.end() - outliers, points_set.end(), by_z);
+        }
         points_set.erase(points_set.begin(), points_set.begin() + outliers); // crop min 0.5% of the dataset
         points_set.resize(points_set.size() - outliers); // crop max 0.5% of the dataset
 
         // Convert Z values into Depth values by aligning the Fitted plane with the Ground Truth (GT) plane
         // Calculate distance and disparity of Z values to the fitted plane.
         // Use the rotated plane fit to calculate GT errors
+        double plane_fit_err_sqr_sum = 0;
+        double total_sq_disparity_diff = 0;
         for (auto point : points_set)
         {
             // Find distance from point to the reconstructed plane
@@ -119,9 +123,11 @@ int main(int argc, const char * argv[]) try
                                             float(point.y - dist2plane*p.b),
                                             float(point.z - dist2plane*p.c) };
 
-            // Store distance, disparity and gt- error
-            distances.push_back(dist2plane * TO_MM);
-            disparities.push_back(bf_factor / point.length() - bf_factor / plane_intersect.length());
+            // Accumulate the squares of distance and disparity, and store the gt- error
+            auto distance = dist2plane * TO_MM;
+            auto disparity = bf_factor / point.length() - bf_factor / plane_intersect.length();
+            plane_fit_err_sqr_sum += distance * distance;
+            total_sq_disparity_diff += disparity * disparity;
             // The negative dist2plane represents a point closer to the camera than the fitted plane
             if (ground_truth_mm) gt_errors.push_back(plane_fit_to_ground_truth_mm + (dist2plane * TO_MM));
         }
@@ -130,7 +136,7 @@ int main(int argc, const char * argv[]) try
         z_accuracy->enable(ground_truth_mm > 0);
         if (ground_truth_mm)
         {
-            std::sort(begin(gt_errors), end(gt_errors));
+            std::nth_element(begin(gt_errors), begin(gt_errors) + gt_errors.size() / 2, end(gt_errors));
             auto gt_median = gt_errors[gt_errors.size() / 2];
             auto accuracy = TO_PERCENT * (gt_median / ground_truth_mm);
             z_accuracy->add_value(accuracy);
@@ -138,18 +144,12 @@ int main(int argc, const char * argv[]) try
         }
 
         // Calculate Sub-pixel RMS for Stereo-based Depth sensors
-        double total_sq_disparity_diff = 0;
-        for (auto disparity : disparities)
-        {
-            total_sq_disparity_diff += disparity*disparity;
-        }
-        auto rms_subpixel_val = static_cast<float>(std::sqrt(total_sq_disparity_diff / disparities.size()));
+        auto rms_subpixel_val = static_cast<float>(std::sqrt(total_sq_disparity_diff / points_set.size()));
         sub_pixel_rms_error->add_value(rms_subpixel_val);
         if (record) samples.push_back({ sub_pixel_rms_error->get_name(),  rms_subpixel_val });
 
         // Calculate Plane Fit RMS  (Spatial Noise) mm
-        double plane_fit_err_sqr_sum = std::inner_product(distances.begin(), distances.end(), distances.begin(), 0.);
-        auto rms_error_val = static_cast<float>(std::sqrt(plane_fit_err_sqr_sum / distances.size()));
+        auto rms_error_val = static_cast<float>(std::sqrt(plane_fit_err_sqr_sum / points_set.size()));
         auto rms_error_val_per = TO_PERCENT * (rms_error_val / distance_mm);
         plane_fit_rms_error->add_value(rms_error_val_per);
         if (record) samples.push_back({ plane_fit_rms_error->get_name(),  rms_error_val });
@@ -7,6 +7,9 @@
 #include <map>
 #include <set>
 #include <cstring>
+#include <future>
+#include <sstream>
+#include <vector>
 
 #include "tclap/CmdLine.h"
 
@@ -14,7 +17,7 @@ using namespace std;
 using namespace TCLAP;
 using namespace rs2;
 
-void print(const rs2_extrinsics& extrinsics)
+void print(ostream& out, const rs2_extrinsics& extrinsics)
 {
     stringstream ss;
      ss << "Rotation Matrix:\n";
@@ -32,10 +35,10 @@ void print(const rs2_extrinsics& extrinsics)
     for (auto i = 0 ; i < sizeof(extrinsics.translation)/sizeof(extrinsics.translation[0]) ; ++i)
         ss << setprecision(15) << extrinsics.translation[i] << "  ";
 
-    cout << ss.str() << endl << endl;
+    out << ss.str() << endl << endl;
 }
 
-void print(const rs2_motion_device_intrinsic& intrinsics)
+void print(ostream& out, const rs2_motion_device_intrinsic& intrinsics)
 {
     stringstream ss;
      ss << "Bias Variances: ";
@@ -56,10 +59,10 @@ void print(const rs2_motion_device_intrinsic& intrinsics)
     }
 
 
-    cout << ss.str() << endl << endl;
+    out << ss.str() << endl << endl;
 }
 
-void print(const rs2_intrinsics& intrinsics)
+void print(ostream& out, const rs2_intrinsics& intrinsics)
 {
     stringstream ss;
      ss << left << setw(14) << "Width: "      << "\t" << intrinsics.width  << endl <<
@@ -74,7 +77,7 @@ void print(const rs2_intrinsics& intrinsics)
     for (auto i = 0 ; i < sizeof(intrinsics.coeffs)/sizeof(intrinsics.coeffs[0]) ; ++i)
         ss << "\t" << setprecision(15) << intrinsics.coeffs[i] << "  ";
 
-    cout << ss.str() << endl << endl;
+    out << ss.str() << endl << endl;
 }
 
 bool safe_get_intrinsics(const video_stream_profile& profile, rs2_intrinsics& intrinsics)
@@ -156,174 +159,149 @@ string get_str_formats(const set<rs2_format>& formats)
     return ss.str();
 }
 
-int main(int argc, char** argv) try
+void print_device(ostream& out, device dev, bool show_options, bool show_modes, bool show_calibration_data)
 {
-    CmdLine cmd("librealsense rs-enumerate-devices example tool", ' ', RS2_API_VERSION_STR);
-
-    SwitchArg compact_view_arg("s", "short", "Provide short summary of the devices");
-    SwitchArg show_options("o", "option", "Show all supported options per subdevice");
-    SwitchArg show_modes("m", "modes", "Show all supported stream modes per subdevice");
-    SwitchArg show_calibration_data("c", "calib_data", "Show extrinsic and intrinsic of all subdevices");
-    cmd.add(compact_view_arg);
-    cmd.add(show_options);
-    cmd.add(show_modes);
-    cmd.add(show_calibration_data);
-
-    cmd.parse(argc, argv);
-
-    log_to_console(RS2_LOG_SEVERITY_ERROR);
-
-    // Obtain a list of devices currently present on the system
-    context ctx;
-    auto devices = ctx.query_devices();
-    size_t device_count = devices.size();
-    if (!device_count)
+    // Show which options are supported by this device
+    out << " Device info: \n";
+    for (auto j = 0; j < RS2_CAMERA_INFO_COUNT; ++j)
     {
-        cout <<"No device detected. Is it plugged in?\n";
-        return EXIT_SUCCESS;
+        auto param = static_cast<rs2_camera_info>(j);
+        if (dev.supports(param))
+            out << "    " << left << setw(30) << rs2_camera_info_to_string(rs2_camera_info(param))
+            << ": \t" << dev.get_info(param) << endl;
     }
 
-    if (compact_view_arg.getValue())
-    {
-        cout << left << setw(30) << "Device Name"
-            << setw(20) << "Serial Number"
-            << setw(20) << "Firmware Version"
-            << endl;
-
-        for (auto i = 0; i < device_count; ++i)
-        {
-            auto dev = devices[i];
-
-            cout << left << setw(30) << dev.get_info(RS2_CAMERA_INFO_NAME)
-                << setw(20) << dev.get_info(RS2_CAMERA_INFO_SERIAL_NUMBER)
-                << setw(20) << dev.get_info(RS2_CAMERA_INFO_FIRMWARE_VERSION)
-                << endl;
-        }
-
-        if (show_options.getValue() || show_modes.getValue())
-            cout << "\n\nNote:  \"-s\" option is not compatible with the other flags specified,"
-                 << " all the additional options are skipped" << endl;
-
-        return EXIT_SUCCESS;
-    }
+    out << endl;
 
-    for (auto i = 0; i < device_count; ++i)
+    if (show_options)
     {
-        auto dev = devices[i];
-
-        // Show which options are supported by this device
-        cout << " Device info: \n";
-        for (auto j = 0; j < RS2_CAMERA_INFO_COUNT; ++j)
+        for (auto&& sensor : dev.query_sensors())
         {
-            auto param = static_cast<rs2_camera_info>(j);
-            if (dev.supports(param))
-                cout << "    " << left << setw(30) << rs2_camera_info_to_string(rs2_camera_info(param))
-                << ": \t" << dev.get_info(param) << endl;
-        }
+            out << "Options for " << sensor.get_info(RS2_CAMERA_INFO_NAME) << endl;
 
-        cout << endl;
-
-        if (show_options.getValue())
-        {
-            for (auto&& sensor : dev.query_sensors())
+            out << setw(55) << " Supported options:" << setw(10) << "min" << setw(10)
+                << " max" << setw(6) << " step" << setw(10) << " default" << endl;
+            for (auto j = 0; j < RS2_OPTION_COUNT; ++j)
             {
-                cout << "Options for " << sensor.get_info(RS2_CAMERA_INFO_NAME) << endl;
-
-                cout << setw(55) << " Supported options:" << setw(10) << "min" << setw(10)
-                     << " max" << setw(6) << " step" << setw(10) << " default" << endl;
-                for (auto j = 0; j < RS2_OPTION_COUNT; ++j)
+                auto opt = static_cast<rs2_option>(j);
+                if (sensor.supports(opt))
                 {
-                    auto opt = static_cast<rs2_option>(j);
-                    if (sensor.supports(opt))
-                    {
-                        auto range = sensor.get_option_range(opt);
-                        cout << "    " << left << setw(50) << opt << " : "
-                             << setw(5) << range.min << "... " << setw(12) << range.max
-                             << setw(6) << range.step << setw(10) << range.def << "\n";
-                    }
+                    auto range = sensor.get_option_range(opt);
+                    out << "    " << left << setw(50) << opt << " : "
+                        << setw(5) << range.min << "... " << setw(12) << range.max
+                        << setw(6) << range.step << setw(10) << range.def << "\n";
                 }
-
-                cout << endl;
             }
-        }
-
-        if (show_modes.getValue())
-        {
-            for (auto&& sensor : dev.query_sensors())
-            {
-                cout << "Stream Profiles supported by " << sensor.get_info(RS2_CAMERA_INFO_NAME) << endl;
-
-                cout << setw(55) << " Supported modes:" << setw(10) << "stream" << setw(10)
-                     << " resolution" << setw(6) << " fps" << setw(10) << " format" << endl;
-                // Show which streams are supported by this device
-                for (auto&& profile : sensor.get_stream_profiles())
-                {
-                    if (auto video = profile.as<video_stream_profile>())
-                    {
-                        cout << "    " << profile.stream_name() << "\t  " << video.width() << "x"
-                            << video.height() << "\t@ " << profile.fps() << "Hz\t" << profile.format() << endl;
-                    }
-                    else
-                    {
-                        cout << "    " << profile.stream_name() << "\t@ " << profile.fps() << "Hz\t" << profile.format() << endl;
-                    }
-                }
 
-                cout << endl;
-            }
+            out << endl;
         }
+    }
 
+    if (show_modes)
+    {
         for (auto&& sensor : dev.query_sensors())
         {
-            cout << "Stream Profiles supported by " << sensor.get_info(RS2_CAMERA_INFO_NAME) << endl;
+            out << "Stream Profiles supported by " << sensor.get_info(RS2_CAMERA_INFO_NAME) << endl;
 
-            cout << setw(55) << " Supported modes:" << setw(10) << "stream" << setw(10)
-                 << " resolution" << setw(6) << " fps" << setw(10) << " format" << endl;
+            out << setw(55) << " Supported modes:" << setw(10) << "stream" << setw(10)
+                << " resolution" << setw(6) << " fps" << setw(10) << " format" << endl;
             // Show which streams are supported by this device
             for (auto&& profile : sensor.get_stream_profiles())
             {
                 if (auto video = profile.as<video_stream_profile>())
                 {
-                    cout << "    " << profile.stream_name() << "\t  " << video.width() << "x"
+                    out << "    " << profile.stream_name() << "\t  " << video.width() << "x"
                         << video.height() << "\t@ " << profile.fps() << "Hz\t" << profile.format() << endl;
                 }
                 else
                 {
-                    cout << "    " << profile.stream_name() << "\t@ " << profile.fps() << "Hz\t" << profile.format() << endl;
+                    out << "    " << profile.stream_name() << "\t@ " << profile.fps() << "Hz\t" << profile.format() << endl;
                 }
             }
 
-            cout << endl;
+            out << endl;
         }
+    }
+
+    for (auto&& sensor : dev.query_sensors())
+    {
+        out << "Stream Profiles supported by " << sensor.get_info(RS2_CAMERA_INFO_NAME) << endl;
 
-        // Print Intrinsics
-        if (show_calibration_data.getValue())
+        out << setw(55) << " Supported modes:" << setw(10) << "stream" << setw(10)
+            << " resolution" << setw(6) << " fps" << setw(10) << " format" << endl;
+        // Show which streams are supported by this device
+        for (auto&& profile : sensor.get_stream_profiles())
         {
-            std::map<stream_and_index, stream_profile> streams;
-            std::map<stream_and_resolution, std::vector<std::pair<std::set<rs2_format>, rs2_intrinsics>>> intrinsics_map;
-            std::map<stream_and_resolution, std::vector<std::pair<std::set<rs2_format>, rs2_motion_device_intrinsic>>> motion_intrinsics_map;
-            for (auto&& sensor : dev.query_sensors())
+            if (auto video = profile.as<video_stream_profile>())
             {
-                // Intrinsics
-                for (auto&& profile : sensor.get_stream_profiles())
+                out << "    " << profile.stream_name() << "\t  " << video.width() << "x"
+                    << video.height() << "\t@ " << profile.fps() << "Hz\t" << profile.format() << endl;
+            }
+            else
+            {
+                out << "    " << profile.stream_name() << "\t@ " << profile.fps() << "Hz\t" << profile.format() << endl;
+            }
+        }
+
+        out << endl;
+    }
+
+    // Print Intrinsics
+    if (show_calibration_data)
+    {
+        std::map<stream_and_index, stream_profile> streams;
+        std::map<stream_and_resolution, std::vector<std::pair<std::set<rs2_format>, rs2_intrinsics>>> intrinsics_map;
+        std::map<stream_and_resolution, std::vector<std::pair<std::set<rs2_format>, rs2_motion_device_intrinsic>>> motion_intrinsics_map;
+        for (auto&& sensor : dev.query_sensors())
+        {
+            // Intrinsics
+            for (auto&& profile : sensor.get_stream_profiles())
+            {
+                if (auto video = profile.as<video_stream_profile>())
                 {
-                    if (auto video = profile.as<video_stream_profile>())
+                    if (streams.find(stream_and_index{profile.stream_type(), profile.stream_index()}) == streams.end())
+                    {
+                        streams[stream_and_index{profile.stream_type(), profile.stream_index()}] = profile;
+                    }
+
+                    rs2_intrinsics intrinsics{};
+                    stream_and_resolution stream_res{profile.stream_type(), profile.stream_index(), video.width(), video.height(), profile.stream_name()};
+                    if (safe_get_intrinsics(video, intrinsics))
+                    {
+                        auto it = std::find_if((intrinsics_map[stream_res]).begin(), (intrinsics_map[stream_res]).end(), [&](const std::pair<std::set<rs2_format>, rs2_intrinsics>& kvp) {
+                            return intrinsics == kvp.second;
+                        });
+                        if (it == (intrinsics_map[stream_res]).end())
+                        {
+                            (intrinsics_map[stream_res]).push_back({ {profile.format()}, intrinsics });
+                        }
+                        else
+                        {
+                            it->first.insert(profile.format()); // If the intrinsics are equals, add the profile format to format set
+                        }
+                    }
+                }
+                else
+                {
+                    if (motion_stream_profile motion = profile.as<motion_stream_profile>())
                     {
                         if (streams.find(stream_and_index{profile.stream_type(), profile.stream_index()}) == streams.end())
                         {
                             streams[stream_and_index{profile.stream_type(), profile.stream_index()}] = profile;
                         }
 
-                        rs2_intrinsics intrinsics{};
-                        stream_and_resolution stream_res{profile.stream_type(), profile.stream_index(), video.width(), video.height(), profile.stream_name()};
-                        if (safe_get_intrinsics(video, intrinsics))
+                        rs2_motion_device_intrinsic motion_intrinsics{};
+                        stream_and_resolution stream_res{profile.stream_type(), profile.stream_index(), motion.stream_type(), motion.stream_index(), profile.stream_name()};
+                        if (safe_get_motion_intrinsics(motion, motion_intrinsics))
                         {
-                            auto it = std::find_if((intrinsics_map[stream_res]).begin(), (intrinsics_map[stream_res]).end(), [&](const std::pair<std::set<rs2_format>, rs2_intrinsics>& kvp) {
-                                return intrinsics == kvp.second;
+                            auto it = std::find_if((motion_intrinsics_map[stream_res]).begin(), (motion_intrinsics_map[stream_res]).end(),
+                                [&](const std::pair<std::set<rs2_format>, rs2_motion_device_intrinsic>& kvp)
+                            {
+                                return motion_intrinsics == kvp.second;
                             });
-                            if (it == (intrinsics_map[stream_res]).end())
+                            if (it == (motion_intrinsics_map[stream_res]).end())
                             {
-                                (intrinsics_map[stream_res]).push_back({ {profile.format()}, intrinsics });
+                                (motion_intrinsics_map[stream_res]).push_back({ {profile.format()}, motion_intrinsics });
                             }
                             else
                             {
@@ -331,99 +309,232 @@ int main(int argc, char** argv) try
                             }
                         }
                     }
-                    else
-                    {
-                        if (motion_stream_profile motion = profile.as<motion_stream_profile>())
-                        {
-                            if (streams.find(stream_and_index{profile.stream_type(), profile.stream_index()}) == streams.end())
-                            {
-                                streams[stream_and_index{profile.stream_type(), profile.stream_index()}] = profile;
-                            }
+                }
+            }
+        }
 
-                            rs2_motion_device_intrinsic motion_intrinsics{};
-                            stream_and_resolution stream_res{profile.stream_type(), profile.stream_index(), motion.stream_type(), motion.stream_index(), profile.stream_name()};
-                            if (safe_get_motion_intrinsics(motion, motion_intrinsics))
-                            {
-                                auto it = std::find_if((motion_intrinsics_map[stream_res]).begin(), (motion_intrinsics_map[stream_res]).end(),
-                                    [&](const std::pair<std::set<rs2_format>, rs2_motion_device_intrinsic>& kvp)
-                                {
-                                    return motion_intrinsics == kvp.second;
-                                });
-                                if (it == (motion_intrinsics_map[stream_res]).end())
-                                {
-                                    (motion_intrinsics_map[stream_res]).push_back({ {profile.format()}, motion_intrinsics });
-                                }
-                                else
-                                {
-                                    it->first.insert(profile.format()); // If the intrinsics are equals, add the profile format to format set
-                                }
-                            }
-                        }
-                    }
+        out << "Provided Intrinsic:" << endl;
+        for (auto& kvp : intrinsics_map)
+        {
+            auto stream_res = kvp.first;
+            for (auto& intrinsics : kvp.second)
+            {
+                auto formats = get_str_formats(intrinsics.first);
+                out << "Intrinsic of \"" << stream_res.stream_name << "\"\t  " << stream_res.width << "x"
+                    << stream_res.height << "\t  " << formats << endl;
+                if (intrinsics.second == rs2_intrinsics{})
+                {
+                    out << "Intrinsic NOT available!\n\n";
+                }
+                else
+                {
+                    print(out, intrinsics.second);
                 }
             }
+        }
 
-            cout << "Provided Intrinsic:" << endl;
-            for (auto& kvp : intrinsics_map)
+        out << "Provided Motion Intrinsic:" << endl;
+        for (auto& kvp : motion_intrinsics_map)
+        {
+            auto stream_res = kvp.first;
+            for (auto& intrinsics : kvp.second)
             {
-                auto stream_res = kvp.first;
-                for (auto& intrinsics : kvp.second)
+                auto formats = get_str_formats(intrinsics.first);
+                out << "Motion Intrinsic of \"" << stream_res.stream_name << "\"\t  " << formats << endl;
+                if (intrinsics.second == rs2_motion_device_intrinsic{})
                 {
-                    auto formats = get_str_formats(intrinsics.first);
-                    cout << "Intrinsic of \"" << stream_res.stream_name << "\"\t  " << stream_res.width << "x"
-                        << stream_res.height << "\t  " << formats << endl;
-                    if (intrinsics.second == rs2_intrinsics{})
-                    {
-                        cout << "Intrinsic NOT available!\n\n";
-                    }
-                    else
-                    {
-                        print(intrinsics.second);
-                    }
+                    out << "Intrinsic NOT available!\n\n";
+                }
+                else
+                {
+                    print(out, intrinsics.second);
                 }
             }
+        }
 
-            cout << "Provided Motion Intrinsic:" << endl;
-            for (auto& kvp : motion_intrinsics_map)
+        // Print Extrinsics
+        out << "\nProvided Extrinsic:" << endl;
+        rs2_extrinsics extrinsics{};
+        for (auto kvp1 = streams.begin(); kvp1 != streams.end(); ++kvp1)
+        {
+            for (auto kvp2 = streams.begin(); kvp2 != streams.end(); ++kvp2)
             {
-                auto stream_res = kvp.first;
-                for (auto& intrinsics : kvp.second)
+                out << "Extrinsic from \"" << kvp1->second.stream_name() << "\"\t  " <<
+                        "To" << "\t  \"" << kvp2->second.stream_name() << "\" :\n";
+                try
                 {
-                    auto formats = get_str_formats(intrinsics.first);
-                    cout << "Motion Intrinsic of \"" << stream_res.stream_name << "\"\t  " << formats << endl;
-                    if (intrinsics.second == rs2_motion_device_intrinsic{})
-                    {
-                        cout << "Intrinsic NOT available!\n\n";
-                    }
-                    else
-                    {
-                        print(intrinsics.second);
-                    }
+                    extrinsics = kvp1->second.get_extrinsics_to(kvp2->second);
+                    print(out, extrinsics);
                 }
+                catch (...)
+                {
+                    out << "N/A\n";
+                }
+            }
+        }
+    }
+}
+
+string quote(const string& s)
+{
+    string q = "\"";
+    for (auto c : s)
+    {
+        if (c == '"' || c == '\\') q += '\\';
+        q += c;
+    }
+    return q + "\"";
+}
+
+// One device as a JSON object, on a single line for the inventories to be parsed line by line
+void print_device_json(ostream& out, device dev, bool show_options, bool show_calibration_data)
+{
+    out << setprecision(15) << "{\"info\":{";
+    bool first = true;
+    for (auto j = 0; j < RS2_CAMERA_INFO_COUNT; ++j)
+    {
+        auto param = static_cast<rs2_camera_info>(j);
+        if (!dev.supports(param))
+            continue;
+        out << (first ? "" : ",") << quote(rs2_camera_info_to_string(param)) << ":" << quote(dev.get_info(param));
+        first = false;
+    }
+    out << "},\"sensors\":[";
+
+    first = true;
+    for (auto&& sensor : dev.query_sensors())
+    {
+        out << (first ? "" : ",") << "{\"name\":" << quote(sensor.get_info(RS2_CAMERA_INFO_NAME));
+        first = false;
+
+        if (show_options)
+        {
+            out << ",\"options\":{";
+            bool first_option = true;
+            for (auto j = 0; j < RS2_OPTION_COUNT; ++j)
+            {
+                auto opt = static_cast<rs2_option>(j);
+                if (!sensor.supports(opt))
+                    continue;
+                auto range = sensor.get_option_range(opt);
+                out << (first_option ? "" : ",") << quote(rs2_option_to_string(opt)) << ":{\"min\":" << range.min << ",\"max\":" << range.max
+                    << ",\"step\":" << range.step << ",\"default\":" << range.def << "}";
+                first_option = false;
             }
+            out << "}";
+        }
 
-            // Print Extrinsics
-            cout << "\nProvided Extrinsic:" << endl;
-            rs2_extrinsics extrinsics{};
-            for (auto kvp1 = streams.begin(); kvp1 != streams.end(); ++kvp1)
+        out << ",\"profiles\":[";
+        bool first_profile = true;
+        for (auto&& profile : sensor.get_stream_profiles())
+        {
+            out << (first_profile ? "" : ",") << "{\"stream\":" << quote(profile.stream_name())
+                << ",\"format\":" << quote(rs2_format_to_string(profile.format())) << ",\"fps\":" << profile.fps();
+            first_profile = false;
+            if (auto video = profile.as<video_stream_profile>())
             {
-                for (auto kvp2 = streams.begin(); kvp2 != streams.end(); ++kvp2)
+                out << ",\"width\":" << video.width() << ",\"height\":" << video.height();
+                rs2_intrinsics intrinsics{};
+                if (show_calibration_data && safe_get_intrinsics(video, intrinsics))
                 {
-                    cout << "Extrinsic from \"" << kvp1->second.stream_name() << "\"\t  " <<
-                            "To" << "\t  \"" << kvp2->second.stream_name() << "\" :\n";
-                    try
-                    {
-                        extrinsics = kvp1->second.get_extrinsics_to(kvp2->second);
-                        print(extrinsics);
-                    }
-                    catch (...)
-                    {
-                        cout << "N/A\n";
-                    }
+                    out << ",\"intrinsics\":{\"ppx\":" << intrinsics.ppx << ",\"ppy\":" << intrinsics.ppy << ",\"fx\":" << intrinsics.fx
+                        << ",\"fy\":" << intrinsics.fy << ",\"model\":" << quote(rs2_distortion_to_string(intrinsics.model)) << ",\"coeffs\":[";
+                    for (auto i = 0; i < 5; ++i)
+                        out << (i ? "," : "") << intrinsics.coeffs[i];
+                    out << "]}";
                 }
             }
+            out << "}";
         }
+        out << "]}";
     }
+    out << "]}";
+}
+
+int main(int argc, char** argv) try
+{
+    CmdLine cmd("librealsense rs-enumerate-devices example tool", ' ', RS2_API_VERSION_STR);
+
+    SwitchArg compact_view_arg("s", "short", "Provide short summary of the devices");
+    SwitchArg show_options("o", "option", "Show all supported options per subdevice");
+    SwitchArg show_modes("m", "modes", "Show all supported stream modes per subdevice");
+    SwitchArg show_calibration_data("c", "calib_data", "Show extrinsic and intrinsic of all subdevices");
+    SwitchArg json_arg("j", "json", "Print the devices as JSON, one object per device: their info, sensors, profiles, and the options and intrinsics with -o and -c");
+    cmd.add(json_arg);
+    cmd.add(compact_view_arg);
+    cmd.add(show_options);
+    cmd.add(show_modes);
+    cmd.add(show_calibration_data);
+
+    cmd.parse(argc, argv);
+
+    log_to_console(RS2_LOG_SEVERITY_ERROR);
+
+    // Obtain a list of devices currently present on the system
+    context ctx;
+    auto devices = ctx.query_devices();
+    size_t device_count = devices.size();
+    if (!device_count)
+    {
+        if (json_arg.getValue())
+        {
+            cout << "[]" << endl;
+            return EXIT_SUCCESS;
+        }
+        cout <<"No device detected. Is it plugged in?\n";
+        return EXIT_SUCCESS;
+    }
+
+    if (compact_view_arg.getValue())
+    {
+        cout << left << setw(30) << "Device Name"
+            << setw(20) << "Serial Number"
+            << setw(20) << "Firmware Version"
+            << endl;
+
+        for (auto i = 0; i < device_count; ++i)
+        {
+            auto dev = devices[i];
+
+            cout << left << setw(30) << dev.get_info(RS2_CAMERA_INFO_NAME)
+                << setw(20) << dev.get_info(RS2_CAMERA_INFO_SERIAL_NUMBER)
+                << setw(20) << dev.get_info(RS2_CAMERA_INFO_FIRMWARE_VERSION)
+                << endl;
+        }
+
+        if (show_options.getValue() || show_modes.getValue())
+            cout << "\n\nNote:  \"-s\" option is not compatible with the other flags specified,"
+                 << " all the additional options are skipped" << endl;
+
+        return EXIT_SUCCESS;
+    }
+
+    // The devices are walked concurrently, each into its own text, printed in the order of the devices
+    std::vector<std::future<string>> outputs;
+    for (auto i = 0; i < device_count; ++i)
+    {
+        auto dev = devices[i];
+        outputs.push_back(std::async(std::launch::async, [&, dev]() {
+            stringstream ss;
+            if (json_arg.getValue())
+                print_device_json(ss, dev, show_options.getValue(), show_calibration_data.getValue());
+            else
+                print_device(ss, dev, show_options.getValue(), show_modes.getValue(), show_calibration_data.getValue());
+            return ss.str();
+        }));
+    }
+
+    if (json_arg.getValue())
+    {
+        cout << "[";
+        for (size_t i = 0; i < outputs.size(); ++i)
+            cout << (i ? ",\n" : "\n") << outputs[i].get();
+        cout << "\n]" << endl;
+        return EXIT_SUCCESS;
+    }
+
+    for (auto&& output : outputs)
+        cout << output.get();
 
     cout << endl;
 
@@ -4,6 +4,10 @@
 #include <librealsense2/rs.hpp>
 #include <fstream>
 #include <thread>
+#include <atomic>
+#include <mutex>
+#include <deque>
+#include <condition_variable>
 #include "tclap/CmdLine.h"
 #include "fw-logs-parser.h"
 
@@ -44,6 +48,45 @@ string datetime_string()
     return string(buffer);
 }
 
+// The logs the device returned on a fetch, parsed apart from the fetch loop for the device to be read again without delay
+struct fw_logs_batch
+{
+    string time;
+    vector<uint8_t> data;
+};
+
+class fw_logs_queue
+{
+public:
+    void push(fw_logs_batch batch)
+    {
+        {
+            lock_guard<mutex> lock(_mutex);
+            _batches.push_back(move(batch));
+        }
+        _cv.notify_one();
+    }
+
+    bool pop(fw_logs_batch& batch, chrono::milliseconds timeout)
+    {
+        unique_lock<mutex> lock(_mutex);
+        if (!_cv.wait_for(lock, timeout, [this]() { return !_batches.empty(); }))
+            return false;
+        batch = move(_batches.front());
+        _batches.pop_front();
+        return true;
+    }
+
+private:
+    mutex _mutex;
+    condition_variable _cv;
+    deque<fw_logs_batch> _batches;
+};
+
+// The device is read again right away while it has logs, and less often as it has none, down to the rate of the old fixed period
+const chrono::milliseconds min_fetch_interval(1);
+const chrono::milliseconds max_fetch_interval(100);
+
 int main(int argc, char* argv[])
 {
     CmdLine cmd("librealsense rs-fw-logger example tool", ' ', RS2_API_VERSION_STR);
@@ -90,36 +133,75 @@ int main(int argc, char* argv[])
 
             setvbuf(stdout, NULL, _IONBF, 0); // unbuffering stdout
 
-            while (hub.is_connected(dev))
+            fw_logs_queue queue;
+            atomic<bool> fetching(true);
+            thread fetcher([&]()
             {
-                this_thread::sleep_for(chrono::milliseconds(100));
-
-                auto raw_data = dev.as<debug_protocol>().send_and_receive_raw_data(input);
-                vector<string> fw_log_lines = {""};
-                if (raw_data.size() <= 4)
-                    continue;
-
-                if (use_xml_file)
+                auto interval = max_fetch_interval;
+                try
                 {
-                    fw_logs_binary_data fw_logs_binary_data = {raw_data};
-                    fw_logs_binary_data.logs_buffer.erase(fw_logs_binary_data.logs_buffer.begin(),fw_logs_binary_data.logs_buffer.begin()+4);
-                    fw_log_lines = fw_log_parser->get_fw_log_lines(fw_logs_binary_data);
-                    for (auto& elem : fw_log_lines)
-                        elem = datetime_string() + "  " + elem;
+                    while (fetching)
+                    {
+                        auto raw_data = dev.as<debug_protocol>().send_and_receive_raw_data(input);
+                        if (raw_data.size() > 4)
+                        {
+                            queue.push({ datetime_string(), move(raw_data) });
+                            interval = min_fetch_interval;
+                        }
+                        else
+                            interval = min(interval * 2, max_fetch_interval);
+
+                        this_thread::sleep_for(interval);
+                    }
                 }
-                else
+                catch (const error & e)
                 {
-                    stringstream sstr;
-                    sstr << datetime_string() << "  FW_Log_Data:";
-                    for (size_t i = 0; i < raw_data.size(); ++i)
-                        sstr << hexify(raw_data[i]) << " ";
-
-                    fw_log_lines.push_back(sstr.str());
+                    cerr << "RealSense error calling " << e.get_failed_function() << "(" << e.get_failed_args() << "):\n    " << e.what() << endl;
                 }
+                fetching = false;
+            });
 
-                for (auto& line : fw_log_lines)
-                    cout << line << endl;
+            try
+            {
+                fw_logs_batch batch;
+                while (hub.is_connected(dev) && (queue.pop(batch, max_fetch_interval) || fetching))
+                {
+                    if (batch.data.empty())
+                        continue;
+
+                    vector<string> fw_log_lines = {""};
+                    if (use_xml_file)
+                    {
+                        fw_logs_binary_data fw_logs_binary_data = {batch.data};
+                        fw_logs_binary_data.logs_buffer.erase(fw_logs_binary_data.logs_buffer.begin(),fw_logs_binary_data.logs_buffer.begin()+4);
+                        fw_log_lines = fw_log_parser->get_fw_log_lines(fw_logs_binary_data);
+                        for (auto& elem : fw_log_lines)
+                            elem = batch.time + "  " + elem;
+                    }
+                    else
+                    {
+                        stringstream sstr;
+                        sstr << batch.time << "  FW_Log_Data:";
+                        for (size_t i = 0; i < batch.data.size(); ++i)
+                            sstr << hexify(batch.data[i]) << " ";
+
+                        fw_log_lines.push_back(sstr.str());
+                    }
+
+                    for (auto& line : fw_log_lines)
+                        cout << line << endl;
+                    batch.data.clear();
+                }
             }
+            catch (...)
+            {
+                fetching = false;
+                fetcher.join();
+                throw;
+            }
+
+            fetching = false;
+            fetcher.join();
         }
         catch (const error & e)
         {
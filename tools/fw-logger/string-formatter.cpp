@@ -1,5 +1,6 @@
 #include "string-formatter.h"
-#include <regex>
+#include <cctype>
+#include <algorithm>
 #include <sstream>
 #include <iomanip>
 
@@ -18,51 +19,44 @@ namespace fw_logger
 
     bool string_formatter::generate_message(const string& source, int num_of_params, const uint32_t* params, string* dest)
     {
-        map<string, string> exp_replace_map;
-
         if (params == nullptr && num_of_params > 0) return false;
 
-        for (int i = 0; i < num_of_params; i++)
+        // A single scan of the format for its {i} and {i:x} parameters, instead of a regular expression per parameter
+        string message;
+        message.reserve(source.size());
+        size_t pos = 0;
+        while (pos < source.size())
         {
-            string regular_exp[2];
-            string replacement[2];
-            stringstream st_regular_exp[2];
-            stringstream st_replacement[2];
-
-            st_regular_exp[0] << "\\{\\b(" << i << ")\\}";
-            regular_exp[0] = st_regular_exp[0].str();
-
-            st_replacement[0] << params[i];
-            replacement[0] = st_replacement[0].str();
-
-            exp_replace_map[regular_exp[0]] = replacement[0];
-
-
-            st_regular_exp[1] << "\\{\\b(" << i << "):x\\}";
-            regular_exp[1] = st_regular_exp[1].str();
-
-            st_replacement[1] << hex << setw(2) << setfill('0') << params[i];
-            replacement[1] = st_replacement[1].str();
-
-            exp_replace_map[regular_exp[1]] = replacement[1];
+            auto open = source.find('{', pos);
+            if (open == string::npos)
+                break;
+            message.append(source, pos, open - pos);
+
+            size_t end = open + 1;
+            int index = 0;
+            while (end < source.size() && isdigit(static_cast<unsigned char>(source[end])))
+                index = index * 10 + (source[end++] - '0');
+            auto digits = end > open + 1 && end - open <= 10 && (end == open + 2 || source[open + 1] != '0');
+            auto hex_param = source.compare(end, 3, ":x}") == 0;
+
+            if (digits && index < num_of_params && (hex_param || source.compare(end, 1, "}") == 0))
+            {
+                stringstream st_replacement;
+                if (hex_param)
+                    st_replacement << hex << setw(2) << setfill('0');
+                st_replacement << params[index];
+                message += st_replacement.str();
+                pos = end + (hex_param ? 3 : 1);
+            }
+            else
+            {
+                message += '{';
+                pos = open + 1;
+            }
         }
+        message.append(source, min(pos, source.size()), string::npos);
 
-        return replace_params(source, exp_replace_map, dest);
-    }
-
-    bool string_formatter::replace_params(const string& source, const map<string, string>& exp_replace_map, string* dest) const
-    {
-        string source_temp(source);
-
-        for (auto exp_replace_it = exp_replace_map.begin(); exp_replace_it != exp_replace_map.end(); exp_replace_it++)
-        {
-            string destTemp;
-            regex e(exp_replace_it->first);
-            regex_replace(back_inserter(destTemp), source_temp.begin(), source_temp.end(), e, exp_replace_it->second);
-            source_temp = destTemp;
-
-        }
-        *dest = source_temp;
+        *dest = message;
         return true;
     }
 }
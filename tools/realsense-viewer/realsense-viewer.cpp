@@ -318,7 +318,8 @@ int main(int argv, const char** argc) try
 
 
         ImGui::PushFont(window.get_font());
-        ImGui::SetNextWindowSize({ viewer_model.panel_width, 20.f * new_devices_count + 8 });
+        // One more row for capturing a trace
+        ImGui::SetNextWindowSize({ viewer_model.panel_width, 20.f * (new_devices_count + 1) + 8 });
         if (ImGui::BeginPopup("select"))
         {
             ImGui::PushStyleColor(ImGuiCol_Text, dark_grey);
@@ -377,6 +378,36 @@ int main(int argv, const char** argc) try
             ImGui::Text("%s", "");
             ImGui::NextColumn();
 
+            static bool tracing = false;
+            if (ImGui::Selectable(tracing ? "Save Trace..." : "Capture Trace", false, ImGuiSelectableFlags_SpanAllColumns))
+            {
+                try
+                {
+                    if (!tracing)
+                    {
+                        ctx.start_trace();
+                        tracing = true;
+                    }
+                    else if (auto ret = file_dialog_open(save_file, "Trace\0*.json\0", NULL, "trace.json"))
+                    {
+                        tracing = false;
+                        ctx.stop_trace(ret);
+                        viewer_model.not_model.add_log(to_string() << "Trace saved to " << ret << ", open it in chrome://tracing or Perfetto");
+                    }
+                }
+                catch (const error& e)
+                {
+                    error_message = error_to_string(e);
+                }
+                catch (const std::exception& e)
+                {
+                    error_message = e.what();
+                }
+            }
+            ImGui::NextColumn();
+            ImGui::Text("%s", tracing ? "Tracing" : "");
+            ImGui::NextColumn();
+
             ImGui::PopStyleColor();
             ImGui::EndPopup();
         }
@@ -4,6 +4,9 @@
 #pragma once
 
 #include <string>
+#include <atomic>
+#include <mutex>
+#include <thread>
 
 #include "../../third-party/realsense-file/rosbag/rosbag_storage/include/rosbag/bag.h"
 #include "../../third-party/realsense-file/rosbag/rosbag_storage/include/rosbag/view.h"
@@ -26,100 +29,170 @@ namespace rosbag_inspector
         uint64_t uncompressed;
     };
 
+    struct topic_info
+    {
+        std::vector<std::string> message_types;  // Of the connections of the topic
+        int64_t messages = -1;                   // Not counted yet while negative
+    };
+
+    // What is known of the file so far, gathered in the background
+    struct bag_summary
+    {
+        bool indexed = false;       // Once the index of the file is read
+        bool complete = false;      // Once every topic is counted
+        std::string error;
+        std::string version;
+        std::chrono::nanoseconds file_duration = std::chrono::nanoseconds::zero();
+        double size = 0;
+        rosbag_inspector::compression_info compression_info;
+        std::map<std::string, topic_info> topics;
+    };
+
+    // The messages of a topic shown at once, formatted. Only this page of a topic is held in memory
+    struct message_page
+    {
+        uint64_t offset = 0;
+        std::vector<std::pair<std::chrono::nanoseconds, std::string>> messages;
+        bool loaded = false;
+    };
+
+    // A bag opened for inspection. The index of the file is read and its topics are counted by a thread of the
+    // content, for the file to show as soon as it is added, and the messages are read from the index a page at a time
     struct rosbag_content
     {
-        rosbag_content(const std::string& file)
+        static constexpr uint64_t page_size = 10;
+
+        rosbag_content(const std::string& file) : path(file)
+        {
+            auto it = std::find_if(path.rbegin(), path.rend(), [](char c) { return c == '\\' || c == '/'; });
+            file_name = std::string(it.base(), path.end());
+
+            worker = std::thread([this]() { gather_summary(); });
+        }
+
+        ~rosbag_content()
         {
-            bag.open(file);
+            stopping = true;
+            worker.join();
+        }
 
-            rosbag::View entire_bag_view(bag);
+        rosbag_content(const rosbag_content&) = delete;
+        rosbag_content& operator=(const rosbag_content&) = delete;
 
-            for (auto&& m : entire_bag_view)
+        bag_summary get_summary() const
+        {
+            std::lock_guard<std::mutex> lock(summary_mutex);
+            return summary;
+        }
+
+        // The page of the topic at the offset, read from the file unless it is the page held. Empty while
+        // the thread of the content holds the file, for the caller to ask again on its next frame
+        const message_page& get_page(const std::string& topic, uint64_t offset)
+        {
+            auto&& page = pages[topic];
+            if (page.loaded && page.offset == offset)
+                return page;
+
+            std::unique_lock<std::mutex> lock(bag_mutex, std::try_to_lock);
+            if (!lock.owns_lock() || !opened)
             {
-                topics_to_message_types[m.getTopic()].push_back(m.getDataType());
+                page.loaded = false;
+                return page;
             }
 
-            path = bag.getFileName();
-            for (auto rit = path.rbegin(); rit != path.rend(); ++rit)
+            page.offset = offset;
+            page.messages.clear();
+            rosbag::View messages(bag, rosbag::TopicQuery(topic));
+            auto m = messages.begin();
+            for (uint64_t i = 0; i < offset && m != messages.end(); ++i)
+                ++m;
+            for (; m != messages.end() && page.messages.size() < page_size; ++m)
             {
-                if (*rit == '\\' || *rit == '/')
-                    break;
-                file_name += *rit;
+                std::ostringstream oss;
+                oss << *m;
+                page.messages.emplace_back(std::chrono::nanoseconds(m->getTime().toNSec()), oss.str());
             }
-            std::reverse(file_name.begin(), file_name.end());
-
-            version = tmpstringstream() << bag.getMajorVersion() << "." << bag.getMinorVersion();
-            file_duration = get_duration(bag);
-            size = 1.0 * bag.getSize() / (1024LL * 1024LL);
-            compression_info = bag.getCompressionInfo();
+            page.loaded = true;
+            return page;
         }
 
-        rosbag_content(const rosbag_content& other)
+        // Releases the page of a topic no longer shown
+        void close_page(const std::string& topic)
         {
-            bag.open(other.path);
-            cache = other.cache;
-            file_duration = other.file_duration;
-            file_name = other.file_name;
-            path = other.path;
-            version = other.version;
-            size = other.size;
-            compression_info = other.compression_info;
-            topics_to_message_types = other.topics_to_message_types;
+            pages.erase(topic);
         }
-        rosbag_content(rosbag_content&& other)
-        {
-            other.bag.close();
-            bag.open(other.path);
-            cache = other.cache;
-            file_duration = other.file_duration;
-            file_name = other.file_name;
-            path = other.path;
-            version = other.version;
-            size = other.size;
-            compression_info = other.compression_info;
-            topics_to_message_types = other.topics_to_message_types;
-
-            other.cache.clear();
-            other.file_duration = std::chrono::nanoseconds::zero();
-            other.file_name.clear();
-            other.path.clear();
-            other.version.clear();
-            other.size = 0;
-            other.compression_info.compressed = 0;
-            other.compression_info.uncompressed = 0;
-            other.compression_info.compression_type = "";
-            other.topics_to_message_types.clear();
-        }
-        std::string instanciate_and_cache(const rosbag::MessageInstance& m, uint64_t count)
+
+        std::string file_name;
+        std::string path;
+
+    private:
+        void gather_summary()
         {
-            auto key = std::make_tuple(m.getCallerId(), m.getDataType(), m.getMD5Sum(), m.getTopic(), m.getTime(), count);
-            if (cache.find(key) != cache.end())
+            try
+            {
+                std::vector<std::string> topics;
+                {
+                    std::lock_guard<std::mutex> lock(bag_mutex);
+                    bag.open(path);
+                    opened = true;
+
+                    bag_summary s;
+                    s.version = tmpstringstream() << bag.getMajorVersion() << "." << bag.getMinorVersion();
+                    s.size = 1.0 * bag.getSize() / (1024LL * 1024LL);
+                    s.compression_info = bag.getCompressionInfo();
+                    rosbag::View entire_bag_view(bag);
+                    for (auto&& c : entire_bag_view.getConnections())
+                        s.topics[c->topic].message_types.push_back(c->datatype);
+                    s.indexed = true;
+
+                    for (auto&& t : s.topics)
+                        topics.push_back(t.first);
+                    std::lock_guard<std::mutex> summary_lock(summary_mutex);
+                    summary = s;
+                }
+
+                // The file is let go between the topics, for the pages to be read meanwhile
+                for (auto&& topic : topics)
+                {
+                    if (stopping) return;
+                    std::lock_guard<std::mutex> lock(bag_mutex);
+                    auto count = rosbag::View(bag, rosbag::TopicQuery(topic)).size();
+                    std::lock_guard<std::mutex> summary_lock(summary_mutex);
+                    summary.topics[topic].messages = count;
+                }
+
+                if (stopping) return;
+                std::lock_guard<std::mutex> lock(bag_mutex);
+                auto duration = get_duration(bag);
+                std::lock_guard<std::mutex> summary_lock(summary_mutex);
+                summary.file_duration = duration;
+                summary.complete = true;
+            }
+            catch (const std::exception& e)
             {
-                return cache[key];
+                std::lock_guard<std::mutex> summary_lock(summary_mutex);
+                summary.error = e.what();
             }
-            std::ostringstream oss;
-            oss << m;
-            cache[key] = oss.str();
-            return oss.str();
         }
 
         std::chrono::nanoseconds get_duration(const rosbag::Bag& bag)
         {
-            rosbag::View only_frames(bag, [](rosbag::ConnectionInfo const* info) {
-                std::regex exp(R"RRR(/device_\d+/sensor_\d+/.*_\d+/(image|imu))RRR");
+            std::regex exp(R"RRR(/device_\d+/sensor_\d+/.*_\d+/(image|imu))RRR");
+            rosbag::View only_frames(bag, [&exp](rosbag::ConnectionInfo const* info) {
                 return std::regex_search(info->topic, exp);
             });
             return std::chrono::nanoseconds((only_frames.getEndTime() - only_frames.getBeginTime()).toNSec());
         }
 
-        std::map<std::tuple<std::string, std::string, std::string, std::string, ros::Time, uint64_t>, std::string> cache;
-        std::chrono::nanoseconds file_duration;
-        std::string file_name;
-        std::string path;
-        std::string version;
-        double size;
-        rosbag_inspector::compression_info compression_info;
-        std::map<std::string, std::vector<std::string>> topics_to_message_types;
+        mutable std::mutex summary_mutex;
+        bag_summary summary;
+
+        std::map<std::string, message_page> pages;
+
+        std::mutex bag_mutex;       // The bag is read by the thread of the content and by the pages
         rosbag::Bag bag;
+        bool opened = false;
+        std::atomic<bool> stopping{ false };
+        std::thread worker;
     };
 }
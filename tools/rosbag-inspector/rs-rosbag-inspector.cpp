@@ -34,7 +34,7 @@
 using namespace rosbag_inspector;
 
 files_container files; // Container of loaded files
-std::map<std::string, uint64_t> num_topics_to_show;
+std::map<std::string, uint64_t> topic_offsets; // First message shown of each topic
 
 class gui_window
 {
@@ -172,7 +172,7 @@ int draw_files_left_panel(int flags)
         if (ImGui::Selectable(files[i].file_name.c_str(), selected == i, 0, ImVec2(100, 0)))
         {
             selected = i;
-            num_topics_to_show.clear();
+            topic_offsets.clear();
         }
         ImGui::PopStyleColor(4);
         if (ImGui::IsItemHovered())
@@ -229,70 +229,86 @@ void draw_bag_content(rosbag_content& bag, int flags)
 {
     ImGui::BeginChild("Bag Content", ImVec2(0, 0), false, flags);
     ImGui::PushStyleColor(ImGuiCol_Text, white);
-    std::ostringstream oss;
+    auto summary = bag.get_summary();
     ImGui::Text("\t%s", std::string(tmpstringstream() << std::left << std::setw(20) << "Path: " << bag.path).c_str());
-    ImGui::Text("\t%s", std::string(tmpstringstream() << std::left << std::setw(20) << "Bag Version: " << bag.version).c_str());
-    ImGui::Text("\t%s", std::string(tmpstringstream() << std::left << std::setw(20) << "Duration: " << pretty_time(bag.file_duration)).c_str());
-    ImGui::Text("\t%s", std::string(tmpstringstream() << std::left << std::setw(20) << "Size: " << bag.size << " MB").c_str());
-    ImGui::Text("\t%s", std::string(tmpstringstream() << std::left << std::setw(20) << "Compression: " << bag.compression_info.compression_type).c_str());
-    ImGui::Text("\t%s", std::string(tmpstringstream() << std::left << std::setw(20) << "uncompressed: " << bag.compression_info.compressed).c_str());
-    ImGui::Text("\t%s", std::string(tmpstringstream() << std::left << std::setw(20) << "compressed: " << bag.compression_info.uncompressed).c_str());
-    if (ImGui::CollapsingHeader("Topics"))
+    if (!summary.error.empty())
     {
-        for (auto&& topic_to_message_type : bag.topics_to_message_types)
+        ImGui::Text("\t%s", std::string(tmpstringstream() << std::left << std::setw(20) << "Error: " << summary.error).c_str());
+    }
+    else if (!summary.indexed)
+    {
+        ImGui::Text("\tReading the index of the file...");
+    }
+    else
+    {
+        ImGui::Text("\t%s", std::string(tmpstringstream() << std::left << std::setw(20) << "Bag Version: " << summary.version).c_str());
+        ImGui::Text("\t%s", std::string(tmpstringstream() << std::left << std::setw(20) << "Duration: " << (summary.complete ? pretty_time(summary.file_duration) : std::string("..."))).c_str());
+        ImGui::Text("\t%s", std::string(tmpstringstream() << std::left << std::setw(20) << "Size: " << summary.size << " MB").c_str());
+        ImGui::Text("\t%s", std::string(tmpstringstream() << std::left << std::setw(20) << "Compression: " << summary.compression_info.compression_type).c_str());
+        ImGui::Text("\t%s", std::string(tmpstringstream() << std::left << std::setw(20) << "uncompressed: " << summary.compression_info.compressed).c_str());
+        ImGui::Text("\t%s", std::string(tmpstringstream() << std::left << std::setw(20) << "compressed: " << summary.compression_info.uncompressed).c_str());
+    }
+    if (summary.indexed && ImGui::CollapsingHeader("Topics"))
+    {
+        for (auto&& topic_to_info : summary.topics)
         {
-            std::string topic = topic_to_message_type.first;
-            std::vector<std::string> messages_types = topic_to_message_type.second;
+            std::string topic = topic_to_info.first;
+            auto&& info = topic_to_info.second;
+            std::string count = info.messages < 0 ? std::string("...") : std::to_string(info.messages);
             std::ostringstream oss;
             int max_topic_len = 100;
             oss << std::left << std::setw(max_topic_len) << topic
-                << " " << std::left << std::setw(10) << messages_types.size() << std::setw(6) << std::string(" msg") + (messages_types.size() > 1 ? "s" : "")
-                << ": " << std::left << std::setw(40) << messages_types.front() << std::endl;
+                << " " << std::left << std::setw(10) << count << std::setw(6) << std::string(" msg") + (info.messages == 1 ? "" : "s")
+                << ": " << std::left << std::setw(40) << info.message_types.front() << std::endl;
             std::string line = oss.str();
             auto pos = ImGui::GetCursorPos();
             ImGui::SetCursorPos({ pos.x + 20, pos.y });
             if (ImGui::CollapsingHeader(line.c_str()))
             {
-                rosbag::View messages(bag.bag, rosbag::TopicQuery(topic));
-                uint64_t count = 0;
-                constexpr uint64_t num_next_items_to_show = 10;
-                num_topics_to_show[topic] = std::max(num_topics_to_show[topic], num_next_items_to_show);
-                uint64_t max = num_topics_to_show[topic];
+                auto offset = topic_offsets[topic];
+                auto&& page = bag.get_page(topic, offset);
                 auto win_pos = ImGui::GetWindowPos();
                 ImGui::SetWindowPos({ win_pos.x + 20, win_pos.y });
-                for (auto&& m : messages)
+                if (!page.loaded)
+                {
+                    ImGui::Text("Loading messages...");
+                }
+                for (auto&& m : page.messages)
                 {
-                    count++;
                     ImGui::Columns(2, "Message", true);
                     ImGui::Separator();
                     ImGui::Text("Timestamp"); ImGui::NextColumn();
                     ImGui::Text("Content"); ImGui::NextColumn();
                     ImGui::Separator();
-                    ImGui::Text("%s", pretty_time(std::chrono::nanoseconds(m.getTime().toNSec())).c_str()); ImGui::NextColumn();
-                    ImGui::Text("%s", bag.instanciate_and_cache(m, count).c_str());
+                    ImGui::Text("%s", pretty_time(m.first).c_str()); ImGui::NextColumn();
+                    ImGui::Text("%s", m.second.c_str());
                     ImGui::Columns(1);
                     ImGui::Separator();
-                    if (count >= max)
+                }
+                if (page.loaded)
+                {
+                    uint64_t page_size = rosbag_content::page_size;
+                    uint64_t last = offset + page.messages.size();
+                    ImGui::Text("Messages %llu - %llu of %s", (unsigned long long)(page.messages.empty() ? offset : offset + 1), (unsigned long long)last, count.c_str());
+                    ImGui::SameLine();
+                    std::string label = tmpstringstream() << "Previous ##" << topic;
+                    if (offset > 0 && ImGui::Button(label.c_str()))
                     {
-                        int left = messages.size() - max;
-                        if (left > 0)
-                        {
-                            ImGui::Text("... %d more messages", left);
-                            ImGui::SameLine();
-                            std::string label = tmpstringstream() << "Show More ##" << topic;
-                            if (ImGui::Button(label.c_str()))
-                            {
-                                num_topics_to_show[topic] += 10;
-                            }
-                            else
-                            {
-                                break;
-                            }
-                        }
+                        topic_offsets[topic] = offset > page_size ? offset - page_size : 0;
+                    }
+                    ImGui::SameLine();
+                    label = tmpstringstream() << "Next ##" << topic;
+                    if (page.messages.size() == page_size && (info.messages < 0 || last < uint64_t(info.messages)) && ImGui::Button(label.c_str()))
+                    {
+                        topic_offsets[topic] = last;
                     }
                 }
                 ImGui::SetWindowPos(win_pos);
             }
+            else
+            {
+                bag.close_page(topic);
+            }
 
             if (ImGui::IsItemHovered())
             {
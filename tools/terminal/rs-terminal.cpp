@@ -10,6 +10,8 @@
 #include "auto-complete.h"
 
 #include <string>
+#include <thread>
+#include <future>
 
 
 using namespace std;
@@ -37,7 +39,7 @@ vector<uint8_t> build_raw_command_data(const command& command, const vector<stri
     return raw_data;
 }
 
-void xml_mode(const string& line, const commands_xml& cmd_xml, rs2::device& dev, map<string, xml_parser_function>& format_type_to_lambda)
+vector<uint8_t> parse_xml_command(const string& line, const commands_xml& cmd_xml, command& cmd)
 {
     vector<string> tokens;
     stringstream ss(line);
@@ -57,21 +59,16 @@ void xml_mode(const string& line, const commands_xml& cmd_xml, rs2::device& dev,
     if (it == cmd_xml.commands.end())
         throw runtime_error("Command not found!");
 
-    auto command = it->second;
+    cmd = it->second;
     vector<string> params;
     for (auto i = 1; i < tokens.size(); ++i)
         params.push_back(tokens[i]);
 
-    auto raw_data = build_raw_command_data(command, params);
-
-    for (auto b : raw_data)
-    {
-        cout << hex << fixed << setfill('0') << setw(2) << (int)b << " ";
-    }
-    cout << endl;
-
-    auto result = dev.as<rs2::debug_protocol>().send_and_receive_raw_data(raw_data);
+    return build_raw_command_data(cmd, params);
+}
 
+string decode_xml_response(const command& command, const vector<uint8_t>& result, const commands_xml& cmd_xml, map<string, xml_parser_function>& format_type_to_lambda)
+{
     unsigned returned_opcode = *result.data();
     // check returned opcode
     if (command.op_code != returned_opcode)
@@ -85,15 +82,27 @@ void xml_mode(const string& line, const commands_xml& cmd_xml, rs2::device& dev,
     {
         string data;
         decode_string_from_raw_data(command, cmd_xml.custom_formatters, result.data(), result.size(), data, format_type_to_lambda);
-        cout << endl << data << endl;
+        return data;
     }
-    else
+    return "Done!";
+}
+
+void xml_mode(const string& line, const commands_xml& cmd_xml, rs2::device& dev, map<string, xml_parser_function>& format_type_to_lambda)
+{
+    command command;
+    auto raw_data = parse_xml_command(line, cmd_xml, command);
+
+    for (auto b : raw_data)
     {
-        cout << endl << "Done!" << endl;
+        cout << hex << fixed << setfill('0') << setw(2) << (int)b << " ";
     }
+    cout << endl;
+
+    auto result = dev.as<rs2::debug_protocol>().send_and_receive_raw_data(raw_data);
+    cout << endl << decode_xml_response(command, result, cmd_xml, format_type_to_lambda) << endl;
 }
 
-void hex_mode(const string& line, rs2::device& dev)
+vector<uint8_t> parse_hex_command(const string& line)
 {
     vector<uint8_t> raw_data;
     stringstream ss(line);
@@ -108,12 +117,86 @@ void hex_mode(const string& line, rs2::device& dev)
     }
     if (raw_data.empty())
         throw runtime_error("Wrong input!");
+    return raw_data;
+}
 
+string format_hex_response(const vector<uint8_t>& result)
+{
+    stringstream ss;
+    for (auto& elem : result)
+        ss << setfill('0') << setw(2) << hex << static_cast<int>(elem) << " ";
+    return ss.str();
+}
+
+void hex_mode(const string& line, rs2::device& dev)
+{
+    auto raw_data = parse_hex_command(line);
     auto result = dev.as<rs2::debug_protocol>().send_and_receive_raw_data(raw_data);
 
-    cout << endl;
-    for (auto& elem : result)
-        cout << setfill('0') << setw(2) << hex << static_cast<int>(elem) << " ";
+    cout << endl << format_hex_response(result);
+}
+
+// A line of a script, parsed before anything is sent for a mistake in the script not to stop it halfway
+struct script_command
+{
+    string line;
+    vector<uint8_t> raw_data;
+    command cmd;            // Of the commands of the XML, unused in hex mode
+};
+
+vector<script_command> parse_script(const vector<string>& lines, bool hex_mode, const commands_xml& cmd_xml)
+{
+    vector<script_command> commands;
+    for (size_t i = 0; i < lines.size(); ++i)
+    {
+        if (lines[i].find_first_not_of(" \t\r") == string::npos)
+            continue;
+
+        script_command sc;
+        sc.line = lines[i];
+        try
+        {
+            sc.raw_data = hex_mode ? parse_hex_command(lines[i]) : parse_xml_command(lines[i], cmd_xml, sc.cmd);
+        }
+        catch (const exception& ex)
+        {
+            stringstream msg;
+            msg << "Script line " << dec << (i + 1) << ": " << ex.what();
+            throw runtime_error(msg.str());
+        }
+        commands.push_back(sc);
+    }
+    return commands;
+}
+
+// Sends the commands back-to-back through the queue of the hardware monitor and formats their responses in order
+string run_script(rs2::device dev, const vector<script_command>& commands, bool hex_mode, const commands_xml& cmd_xml,
+    map<string, xml_parser_function> format_type_to_lambda)
+{
+    vector<vector<uint8_t>> inputs;
+    for (auto& sc : commands)
+        inputs.push_back(sc.raw_data);
+
+    vector<bool> succeeded;
+    auto results = dev.as<rs2::debug_protocol>().send_and_receive_raw_data_batch(inputs, &succeeded);
+
+    stringstream out;
+    out << "\nDevice with Serial Number:  " << dev.get_info(RS2_CAMERA_INFO_SERIAL_NUMBER) << "\n";
+    for (size_t i = 0; i < commands.size(); ++i)
+    {
+        out << "\n#>" << commands[i].line << "\n";
+        try
+        {
+            if (!succeeded[i])
+                throw runtime_error("No response from the device!");
+            out << (hex_mode ? format_hex_response(results[i]) : decode_xml_response(commands[i].cmd, results[i], cmd_xml, format_type_to_lambda)) << "\n";
+        }
+        catch (const exception& ex)
+        {
+            out << ex.what() << "\n";
+        }
+    }
+    return out.str();
 }
 
 auto_complete get_auto_complete_obj(bool is_application_in_hex_mode, const map<string, command>& commands_map)
@@ -165,6 +248,7 @@ int main(int argc, char** argv)
     ValueArg<string> hex_cmd_arg("s", "send", "Hexadecimal raw data", false, "", "Send hexadecimal raw data to device");
     ValueArg<string> hex_script_arg("r", "raw", "Full file path of hexadecimal raw data script", false, "", "Send raw data line by line from script file");
     ValueArg<string> commands_script_arg("c", "cmd", "Full file path of commands script", false, "", "Send commands line by line from script file");
+    SwitchArg parallel_arg("p", "parallel", "Run the script on the selected devices at once", false);
     cmd.add(xml_arg);
     cmd.add(device_id_arg);
     cmd.add(specific_SN_arg);
@@ -172,6 +256,7 @@ int main(int argc, char** argv)
     cmd.add(hex_cmd_arg);
     cmd.add(hex_script_arg);
     cmd.add(commands_script_arg);
+    cmd.add(parallel_arg);
     cmd.parse(argc, argv);
 
     // parse command.xml
@@ -322,40 +407,44 @@ int main(int argc, char** argv)
         if (!script_file.empty())
             read_script_file(script_file, script_lines);
 
-        if (hex_script_arg.isSet())
+        if (hex_script_arg.isSet() || commands_script_arg.isSet())
         {
-            for (auto dev : selected_rs_devices) {
-                try
-                {
-                    for (auto& elem : script_lines)
-                        hex_mode(elem, dev);
-                }
-                catch (const exception& ex)
-                {
-                    cout << endl << ex.what() << endl;
-                    continue;
-                }
+            auto is_hex_script = hex_script_arg.isSet();
+            if (!is_hex_script && is_application_in_hex_mode)
+            {
+                cout << "\nCommands script requires the commands XML file" << endl;
+                return EXIT_FAILURE;
             }
-            return EXIT_SUCCESS;
-        }
-
-
 
+            vector<script_command> commands;
+            try
+            {
+                commands = parse_script(script_lines, is_hex_script, cmd_xml);
+            }
+            catch (const exception& ex)
+            {
+                cout << endl << ex.what() << endl;
+                return EXIT_FAILURE;
+            }
 
-        if (commands_script_arg.isSet())
-        {
-            for (auto dev : selected_rs_devices) {
+            // Every device runs the whole script, at once with the others in parallel mode
+            auto run = [&](rs2::device dev)
+            {
                 try
                 {
-                    for (auto& elem : script_lines)
-                        xml_mode(elem, cmd_xml, dev, format_type_to_lambda);
+                    return run_script(dev, commands, is_hex_script, cmd_xml, format_type_to_lambda);
                 }
                 catch (const exception& ex)
                 {
-                    cout << endl << ex.what() << endl;
-                    continue;
+                    return string("\n") + ex.what() + "\n";
                 }
-            }
+            };
+            vector<future<string>> outputs;
+            for (auto dev : selected_rs_devices)
+                outputs.push_back(async(parallel_arg.isSet() ? launch::async : launch::deferred, run, dev));
+            for (auto& output : outputs)
+                cout << output.get();
+            cout << endl;
             return EXIT_SUCCESS;
         }
 
@@ -4402,9 +4402,93 @@ TEST_CASE("Syncer clean_inactive_streams by frame number with software-device de
     }
 }
 
+TEST_CASE("Batched injection with software-device device", "[live][software-device]") {
+    rs2::context ctx;
+    if (make_context(SECTION_FROM_TEST_NAME, &ctx))
+    {
+        const int W = 64;
+        const int H = 48;
+        const int BPP = 2;
+        const int frames_count = 200;
+        software_device dev;
+        auto s = dev.add_sensor("software_sensor");
+
+        rs2_intrinsics intrinsics{ W, H, 0, 0, 0, 0, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+        s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+        s.add_video_stream({ RS2_STREAM_INFRARED, 1, 1, W, H, 60, BPP, RS2_FORMAT_Y8, intrinsics });
+        s.set_metadata(RS2_FRAME_METADATA_ACTUAL_EXPOSURE, 33);
+
+        auto profiles = s.get_stream_profiles();
+        frame_queue q(2 * frames_count);
+        s.open(profiles);
+        s.start(q);
+
+        // Frames of both streams in a single call, each with pixels of its own
+        static std::atomic<int> released{ 0 };
+        released = 0;
+        std::vector<std::vector<uint8_t>> pixels;
+        std::vector<rs2_software_video_frame> batch;
+        for (int i = 0; i < frames_count; i++)
+            pixels.emplace_back(W * H * BPP, uint8_t(i));
+        for (int i = 0; i < frames_count; i++)
+            batch.push_back({ pixels[i].data(), [](void*) { released++; }, W * BPP, BPP, double(i), RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, i, profiles[i % 2] });
+        REQUIRE_NOTHROW(s.on_video_frames(batch));
+
+        for (int i = 0; i < frames_count; i++)
+        {
+            rs2::frame f;
+            REQUIRE(q.poll_for_frame(&f));
+            REQUIRE(f.get_frame_number() == i);
+            REQUIRE(f.get_profile().stream_type() == (i % 2 ? RS2_STREAM_INFRARED : RS2_STREAM_DEPTH));
+            REQUIRE(f.get_frame_metadata(RS2_FRAME_METADATA_ACTUAL_EXPOSURE) == 33);
+            REQUIRE(static_cast<const uint8_t*>(f.get_data())[0] == uint8_t(i));
+        }
+        s.stop();
+        s.close();
+        REQUIRE(released == frames_count);
+    }
+}
+
 void dev_changed(rs2_device_list* removed_devs, rs2_device_list* added_devs, void* ptr) {}
 TEST_CASE("C API Compilation", "[live]") {
     rs2_error* e;
     REQUIRE_NOTHROW(rs2_set_devices_changed_callback(NULL, dev_changed, NULL, &e));
     REQUIRE(e != nullptr);
 }
+
+TEST_CASE("Frame metadata blobs hold their own copy of the payloads of the backend", "[offline][metadata]") {
+    using librealsense::frame_metadata_blob;
+    std::vector<uint8_t> backend(200);
+    for (size_t i = 0; i < backend.size(); i++) backend[i] = uint8_t(i);
+
+    // Blobs made over the buffer of the backend refer to it, and their copies do not
+    frame_metadata_blob view(backend.data(), backend.size());
+    REQUIRE(view.data() == backend.data());
+    frame_metadata_blob copy(view);
+    REQUIRE(copy.data() != backend.data());
+    REQUIRE(copy.size() == backend.size());
+    REQUIRE(std::equal(backend.begin(), backend.end(), copy.data()));
+
+    // Moving a view copies the payload, moving a blob of its own hands its buffer over
+    frame_metadata_blob moved(std::move(view));
+    REQUIRE(moved.data() != backend.data());
+    auto buffer = copy.data();
+    frame_metadata_blob taken(std::move(copy));
+    REQUIRE(taken.data() == buffer);
+    REQUIRE(copy.size() == 0);
+
+    // The buffer of a frame is reused by the payloads that fit in it
+    frame_metadata_blob small(backend.data(), 16);
+    taken = small;
+    REQUIRE(taken.data() == buffer);
+    REQUIRE(taken.size() == 16);
+
+    frame_metadata_blob pairs;
+    int64_t value = 7;
+    for (int i = 0; i < 21; i++)
+        REQUIRE(pairs.append(&value, sizeof(value)));
+    REQUIRE(pairs.size() == 168);
+    REQUIRE(!pairs.append(backend.data(), 100));
+    REQUIRE(pairs.size() == 168);
+    REQUIRE(*reinterpret_cast<const int64_t*>(pairs.data() + 160) == 7);
+}
@@ -13,6 +13,7 @@
 #include <chrono>
 #include <ctime>
 #include <algorithm>
+#include <numeric>
 #include <librealsense2/rsutil.h>
 
 using namespace rs2;
@@ -2154,6 +2155,68 @@ void trigger_error(const rs2::device& dev, int num)
 
 
 
+TEST_CASE("Raw commands of a batch are answered in order", "[live]") {
+    rs2::context ctx;
+    if (make_context(SECTION_FROM_TEST_NAME, &ctx))
+    {
+        // GVD of the RS4xx, whose response is the same every time it is sent
+        std::vector<uint8_t> gvd(24, 0);
+        gvd[0] = 0x14;
+        gvd[2] = 0xab;
+        gvd[3] = 0xcd;
+        gvd[4] = 0x10;
+
+        for (auto&& dev : ctx.query_devices())
+        {
+            auto debug = dev.as<debug_protocol>();
+            if (!debug)
+                continue;
+
+            auto single = debug.send_and_receive_raw_data(gvd);
+            std::vector<bool> succeeded;
+            auto responses = debug.send_and_receive_raw_data_batch(std::vector<std::vector<uint8_t>>(10, gvd), &succeeded);
+            REQUIRE(responses.size() == 10);
+            REQUIRE(succeeded.size() == 10);
+            for (size_t i = 0; i < responses.size(); i++)
+            {
+                REQUIRE(succeeded[i]);
+                REQUIRE(responses[i] == single);
+            }
+            REQUIRE(debug.send_and_receive_raw_data_batch({}).empty());
+        }
+    }
+}
+
+TEST_CASE("Preallocated sensors do not allocate while streaming", "[live]") {
+    rs2::context ctx;
+    if (make_context(SECTION_FROM_TEST_NAME, &ctx))
+    {
+        ctx.set_streaming_preallocation(true, true);
+        for (auto&& s : ctx.query_all_sensors())
+        {
+            // A profile unpacked into frames of their own, whose storage comes from the pools
+            auto profiles = s.get_stream_profiles();
+            auto it = std::find_if(profiles.begin(), profiles.end(), [](const stream_profile& p) {
+                return p.format() == RS2_FORMAT_RGB8 && p.is<video_stream_profile>(); });
+            if (it == profiles.end())
+                continue;
+
+            std::atomic<int> frames(0);
+            s.open(*it);
+            s.start([&](frame f) { frames++; });
+            for (int i = 0; i < 100 && frames < 30; i++)
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            s.stop();
+
+            auto stats = s.get_frame_memory_stats();
+            s.close();
+            REQUIRE(frames >= 30);
+            REQUIRE(stats.streaming_allocations == 0);
+            REQUIRE(stats.allocation_failures == 0);
+        }
+    }
+}
+
 TEST_CASE("Error handling sanity", "[live][!mayfail]") {
 
     //Require at least one device to be plugged in
@@ -3569,6 +3632,88 @@ TEST_CASE("Pipeline with specific device", "[live][pipeline][using_pipeline]")
     }
 }
 
+TEST_CASE("Pipeline with several devices", "[live][pipeline][using_pipeline]")
+{
+    rs2::context ctx;
+
+    if (make_context(SECTION_FROM_TEST_NAME, &ctx, "2.16.0"))
+    {
+        auto list = ctx.query_devices();
+        if (list.size() < 2)
+            return;
+
+        rs2::config cfg;
+        for (auto&& dev : list)
+        {
+            disable_sensitive_options_for(dev);
+            REQUIRE_NOTHROW(cfg.add_device(dev.get_info(RS2_CAMERA_INFO_SERIAL_NUMBER)));
+        }
+        REQUIRE_THROWS(cfg.enable_record_to_file("several_devices.bag"));
+
+        rs2::pipeline pipe(ctx);
+        rs2::pipeline_profile profile;
+        REQUIRE_NOTHROW(profile = pipe.start(cfg));
+        REQUIRE(profile.get_device().get_info(RS2_CAMERA_INFO_SERIAL_NUMBER) == std::string(list[0].get_info(RS2_CAMERA_INFO_SERIAL_NUMBER)));
+
+        // Once the other devices stream, the framesets hold their frames besides those of the streams of the profile
+        auto spans = false;
+        for (int i = 0; i < 100 && !spans; i++)
+        {
+            rs2::frameset fs;
+            REQUIRE_NOTHROW(fs = pipe.wait_for_frames());
+            spans = fs.size() > profile.get_streams().size();
+        }
+        REQUIRE(spans);
+        REQUIRE_NOTHROW(pipe.stop());
+    }
+}
+
+TEST_CASE("Hardware timestamps are mapped onto the host clock", "[live]")
+{
+    rs2::context ctx;
+
+    if (make_context(SECTION_FROM_TEST_NAME, &ctx, "2.16.0"))
+    {
+        auto list = ctx.query_devices();
+        REQUIRE(list.size());
+        auto dev = list[0];
+        disable_sensitive_options_for(dev);
+
+        rs2::pipeline pipe(ctx);
+        rs2::config cfg;
+        cfg.enable_device(dev.get_info(RS2_CAMERA_INFO_SERIAL_NUMBER));
+        for (auto&& s : dev.query_sensors())
+            if (s.supports(RS2_OPTION_GLOBAL_TIME_ENABLED))
+                REQUIRE_NOTHROW(s.set_option(RS2_OPTION_GLOBAL_TIME_ENABLED, 1));
+        REQUIRE_NOTHROW(pipe.start(cfg));
+
+        // Frames without hardware timestamps keep their domain
+        std::map<int, double> last;
+        for (int i = 0; i < 100; i++)
+        {
+            rs2::frameset fs;
+            REQUIRE_NOTHROW(fs = pipe.wait_for_frames());
+            auto now = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+            for (auto&& f : fs)
+            {
+                if (f.get_frame_timestamp_domain() != RS2_TIMESTAMP_DOMAIN_GLOBAL_TIME)
+                    continue;
+                auto uid = f.get_profile().unique_id();
+                REQUIRE(f.get_timestamp() <= now + 1);
+                REQUIRE(f.get_timestamp() > now - 1000);
+                if (last.count(uid))
+                    REQUIRE(f.get_timestamp() >= last[uid]);
+                last[uid] = f.get_timestamp();
+            }
+        }
+        REQUIRE_NOTHROW(pipe.stop());
+
+        for (auto&& s : dev.query_sensors())
+            if (s.supports(RS2_OPTION_GLOBAL_TIME_ENABLED))
+                REQUIRE_NOTHROW(s.set_option(RS2_OPTION_GLOBAL_TIME_ENABLED, 0));
+    }
+}
+
 bool operator==(std::vector<profile> streams1, std::vector<profile> streams2)
 {
     if (streams1.size() != streams2.size())
@@ -4731,6 +4876,142 @@ TEST_CASE("C API Compilation", "[live]") {
 
 
 
+TEST_CASE("Syncer emits incomplete framesets when the latency budget runs out", "[software-device]") {
+    const int W = 64;
+    const int H = 48;
+    const int BPP = 2;
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+
+    rs2_intrinsics intrinsics{ W, H, 0, 0, 0, 0, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 30, BPP, RS2_FORMAT_Z16, intrinsics });
+    auto ir = s.add_video_stream({ RS2_STREAM_INFRARED, 1, 1, W, H, 30, BPP, RS2_FORMAT_Y16, intrinsics });
+
+    const float budget = 20.f;
+    syncer sync(10);
+    sync.set_latency_budget(budget);
+    s.open({ depth, ir });
+    s.start(sync);
+
+    std::vector<uint8_t> pixels(W * H * BPP, 0);
+    s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 0, depth });
+    s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 0, ir });
+    REQUIRE(sync.wait_for_frames().size() == 2);
+
+    // The infrared stream stalls, so the depth frame waits for it until the next frame finds the budget has run out
+    s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 1000. / 30, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 1, depth });
+    frameset fs;
+    const unsigned int held_back = unsigned(budget) * 3;
+    REQUIRE_FALSE(sync.try_wait_for_frames(&fs, held_back));
+    s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 2000. / 30, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 2, depth });
+
+    fs = sync.wait_for_frames();
+    REQUIRE(fs.size() == 1);
+    REQUIRE(fs.get_depth_frame().get_frame_number() == 1);
+    REQUIRE(sync.get_incomplete_framesets(ir) == 1);
+    REQUIRE(sync.get_incomplete_framesets(depth) == 0);
+
+    auto depth_stats = sync.get_stream_stats(depth);
+    REQUIRE(depth_stats.enqueued == 3);
+    REQUIRE(depth_stats.matched == 2);
+    REQUIRE(depth_stats.skipped == 0);
+    REQUIRE(depth_stats.overflowed == 0);
+    auto ir_stats = sync.get_stream_stats(ir);
+    REQUIRE(ir_stats.enqueued == 1);
+    REQUIRE(ir_stats.matched == 1);
+    REQUIRE(ir_stats.skipped == 1);
+
+    // The incomplete frameset was held back for as long as the queue was waited on, in the bucket of that wait or a later one
+    auto histogram = sync.get_latency_histogram();
+    REQUIRE(histogram.size() == RS2_SYNC_LATENCY_BUCKETS);
+    size_t bucket = 0;
+    while (bucket + 1 < histogram.size() && held_back >= (1ull << bucket))
+        bucket++;
+    REQUIRE(std::accumulate(histogram.begin(), histogram.end(), 0ull) == 2);
+    REQUIRE(std::accumulate(histogram.begin() + bucket, histogram.end(), 0ull) == 1);
+
+    s.stop();
+    s.close();
+}
+
+#ifdef RS2_TEST_KERNELS
+#include "../src/environment.h"
+
+// A host clock the test moves on by hand
+class manual_time_service : public librealsense::platform::time_service
+{
+public:
+    rs2_time_t get_time() const override { return _time; }
+    void advance(double ms) { _time = _time + ms; }
+
+private:
+    std::atomic<double> _time{ 1000. };
+};
+
+TEST_CASE("Multi-device syncer matches the frames of devices with different clocks", "[software-device]") {
+    const int W = 64;
+    const int H = 48;
+    const int BPP = 2;
+    rs2_intrinsics intrinsics{ W, H, 0, 0, 0, 0, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+
+    software_device dev_a, dev_b;
+    auto sensor_a = dev_a.add_sensor("software_sensor");
+    auto sensor_b = dev_b.add_sensor("software_sensor");
+    auto depth_a = sensor_a.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 30, BPP, RS2_FORMAT_Z16, intrinsics });
+    auto depth_b = sensor_b.add_video_stream({ RS2_STREAM_DEPTH, 0, 1, W, H, 30, BPP, RS2_FORMAT_Z16, intrinsics });
+
+    const int frames = 10;
+    multi_device_syncer sync(frames);
+    sensor_a.open(depth_a);
+    sensor_b.open(depth_b);
+    sensor_a.start(sync);
+    sensor_b.start(sync);
+
+    // The frames arrive a frame period apart on the host clock, which the devices' contexts set and the test replaces
+    auto& env = librealsense::environment::get_instance();
+    struct restore_time_service
+    {
+        std::shared_ptr<librealsense::platform::time_service> ts;
+        ~restore_time_service() { librealsense::environment::get_instance().set_time_service(ts); }
+    } restore{ env.get_time_service() };
+    auto clock = std::make_shared<manual_time_service>();
+    env.set_time_service(clock);
+
+    // Both devices take their frames together, and count the time from when they were turned on
+    std::vector<uint8_t> pixels(W * H * BPP, 0);
+    const double period = 1000. / 30;
+    for (int i = 0; i < frames; i++)
+    {
+        CAPTURE(i);
+        sensor_a.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 1000 + i * period, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, i, depth_a });
+        sensor_b.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 5000 + i * period, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, i, depth_b });
+
+        // Until it has seen both devices, the syncer does not wait for the other one
+        if (i == 0)
+        {
+            REQUIRE(sync.wait_for_frames(1000).size() == 1);
+            REQUIRE(sync.wait_for_frames(1000).size() == 1);
+        }
+        else
+        {
+            auto fs = sync.wait_for_frames(1000);
+            REQUIRE(fs.size() == 2);
+            REQUIRE(fs[0].get_frame_number() == i);
+            REQUIRE(fs[1].get_frame_number() == i);
+        }
+        clock->advance(period);
+    }
+    frameset fs;
+    REQUIRE_FALSE(sync.poll_for_frames(&fs));
+
+    sensor_a.stop();
+    sensor_b.stop();
+    sensor_a.close();
+    sensor_b.close();
+}
+
+#endif
+
 TEST_CASE("Syncer try wait for frames", "[live][software-device]") {
     rs2::context ctx;
     if (make_context(SECTION_FROM_TEST_NAME, &ctx))
@@ -4813,93 +5094,5206 @@ TEST_CASE("Syncer try wait for frames", "[live][software-device]") {
     }
 }
 
-TEST_CASE("Projection from recording", "[software-device][using_pipeline][projection]") {
+TEST_CASE("Frames queue size and memory budget options", "[software-device]") {
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+
+    REQUIRE(s.supports(RS2_OPTION_FRAMES_QUEUE_SIZE));
+    REQUIRE(s.supports(RS2_OPTION_FRAMES_MEMORY_BUDGET));
+
+    auto queue_range = s.get_option_range(RS2_OPTION_FRAMES_QUEUE_SIZE);
+    REQUIRE(queue_range.max >= 32);
+    REQUIRE_NOTHROW(s.set_option(RS2_OPTION_FRAMES_QUEUE_SIZE, queue_range.max));
+    REQUIRE(s.get_option(RS2_OPTION_FRAMES_QUEUE_SIZE) == queue_range.max);
+
+    auto budget_range = s.get_option_range(RS2_OPTION_FRAMES_MEMORY_BUDGET);
+    REQUIRE(budget_range.def == 0);
+    REQUIRE(s.get_option(RS2_OPTION_FRAMES_MEMORY_BUDGET) == 0);
+    REQUIRE_NOTHROW(s.set_option(RS2_OPTION_FRAMES_MEMORY_BUDGET, 64));
+    REQUIRE(s.get_option(RS2_OPTION_FRAMES_MEMORY_BUDGET) == 64);
+    REQUIRE_THROWS(s.set_option(RS2_OPTION_FRAMES_MEMORY_BUDGET, budget_range.max + 1));
+}
+
+TEST_CASE("Frame memory statistics", "[software-device]") {
+    const int W = 640;
+    const int H = 480;
+    const int BPP = 2;
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+
+    rs2_intrinsics intrinsics{ W, H, 0, 0, 0, 0, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+    s.set_option(RS2_OPTION_FRAMES_QUEUE_SIZE, 1);
+
+    std::vector<frame> held;
+    s.open(depth);
+    s.start([&](frame f) { held.push_back(f); });
+
+    std::vector<uint8_t> pixels(W * H * BPP, 0);
+    for (int i = 0; i < 3; i++)
+        s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, i, depth });
+
+    auto stats = s.get_frame_memory_stats();
+    REQUIRE(held.size() == 1);
+    REQUIRE(stats.live_frames == 1);
+    REQUIRE(stats.queue_drops == 2);
+    REQUIRE(stats.allocation_failures == 0);
+    REQUIRE(stats.streaming_allocations == 0);
+
+    held.clear();
+    stats = s.get_frame_memory_stats();
+    REQUIRE(stats.live_frames == 0);
+
+    s.stop();
+    s.close();
+}
+
+TEST_CASE("Sensor health counts the frames at every stage", "[software-device]") {
+    const int W = 64;
+    const int H = 48;
+    const int BPP = 2;
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+
+    rs2_intrinsics intrinsics{ W, H, 0, 0, 0, 0, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+
+    // Software sensors lift the limit when they start
+    std::vector<frame> held;
+    s.open(depth);
+    s.start([&](frame f) { held.push_back(f); });
+    s.set_option(RS2_OPTION_FRAMES_QUEUE_SIZE, 2);
+
+    std::vector<uint8_t> pixels(W * H * BPP, 0);
+    for (int i = 0; i < 5; i++)
+        s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, i, depth });
+
+    auto health = s.get_health();
+    REQUIRE(held.size() == 2);
+    REQUIRE(health.frames_received == 5);
+    REQUIRE(health.frames_delivered == 2);
+    REQUIRE(health.queue_drops == 3);
+    REQUIRE(health.allocation_drops == 0);
+    REQUIRE(health.transport_drops == 0);
+    REQUIRE(health.frames_in_flight == 2);
+
+    held.clear();
+    health = s.get_health();
+    REQUIRE(health.frames_in_flight == 0);
+    REQUIRE(health.bytes_in_flight == 0);
+    REQUIRE(health.frames_received == 5);
+
+    s.stop();
+
+    // Counted anew once the storage of the frames is set up again
+    s.start([](frame f) {});
+    REQUIRE(s.get_health().frames_received == 0);
+    s.stop();
+    s.close();
+}
+
+TEST_CASE("Frame queue policies drop and count the frames that do not fit", "[software-device]") {
+    const int W = 16;
+    const int H = 16;
+    const int BPP = 2;
+    rs2_intrinsics intrinsics{ W, H, 0, 0, 0, 0, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    std::vector<uint8_t> pixels(W * H * BPP, 0);
+
+    auto queued_frames = [&](frame_queue& queue, int count)
+    {
+        software_device dev;
+        auto s = dev.add_sensor("software_sensor");
+        auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+        s.set_option(RS2_OPTION_FRAMES_QUEUE_SIZE, 16);
+        s.open(depth);
+        s.start(queue);
+
+        for (int i = 0; i < count; i++)
+            s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, i, depth });
+
+        std::vector<unsigned long long> numbers;
+        frame f;
+        while (queue.poll_for_frame(&f))
+            numbers.push_back(f.get_frame_number());
+
+        s.stop();
+        s.close();
+        return numbers;
+    };
+
+    frame_queue oldest(3, RS2_FRAME_QUEUE_POLICY_DROP_OLDEST);
+    REQUIRE(queued_frames(oldest, 5) == std::vector<unsigned long long>({ 2, 3, 4 }));
+    REQUIRE(oldest.dropped_frames() == 2);
+
+    frame_queue newest(3, RS2_FRAME_QUEUE_POLICY_DROP_NEWEST);
+    REQUIRE(queued_frames(newest, 5) == std::vector<unsigned long long>({ 0, 1, 2 }));
+    REQUIRE(newest.dropped_frames() == 2);
+
+    frame_queue blocking(3, RS2_FRAME_QUEUE_POLICY_BLOCK, 1);
+    REQUIRE(queued_frames(blocking, 5) == std::vector<unsigned long long>({ 0, 1, 2 }));
+    REQUIRE(blocking.dropped_frames() == 2);
+
+    frame_queue latest(3, RS2_FRAME_QUEUE_POLICY_KEEP_LATEST);
+    REQUIRE(latest.capacity() == 1);
+    REQUIRE(queued_frames(latest, 5) == std::vector<unsigned long long>({ 4 }));
+    REQUIRE(latest.dropped_frames() == 4);
+}
+
+TEST_CASE("Frame queues spill the frames that do not fit to a file", "[software-device]") {
+    const int W = 16;
+    const int H = 16;
+    const int BPP = 2;
+    rs2_intrinsics intrinsics{ W, H, 0, 0, 0, 0, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    std::vector<std::vector<uint16_t>> pixels(16, std::vector<uint16_t>(W * H));
+    for (size_t i = 0; i < pixels.size(); i++)
+        std::fill(pixels[i].begin(), pixels[i].end(), static_cast<uint16_t>(i + 1));
+
+    std::string folder_name = get_folder_path(special_folder::temp_folder);
+    const std::string filename = folder_name + "frame_queue.spill";
+    REQUIRE_THROWS(frame_queue(2, folder_name + "no_such_folder/frame_queue.spill", 1024));
+
+    // Room in memory for two frames, and in the file for four more
+    frame_queue queue(2, filename, 4 * W * H * BPP);
+
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+    s.set_option(RS2_OPTION_FRAMES_QUEUE_SIZE, 16);
+    s.open(depth);
+    s.start(queue);
+
+    auto queued_frames = [&](int first, int count)
+    {
+        for (int i = first; i < first + count; i++)
+            s.on_video_frame({ pixels[i].data(), [](void*) {}, W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, i, depth });
+
+        std::vector<unsigned long long> numbers;
+        depth_frame f = frame();
+        while (queue.poll_for_frame(&f))
+        {
+            numbers.push_back(f.get_frame_number());
+            REQUIRE(f.get_width() == W);
+            REQUIRE(f.get_height() == H);
+            REQUIRE(f.get_profile().format() == RS2_FORMAT_Z16);
+            auto data = reinterpret_cast<const uint16_t*>(f.get_data());
+            REQUIRE(std::all_of(data, data + W * H, [&](uint16_t d) { return d == f.get_frame_number() + 1; }));
+        }
+        return numbers;
+    };
+
+    for (int i = 0; i < 8; i++)
+        s.on_video_frame({ pixels[i].data(), [](void*) {}, W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, i, depth });
+    unsigned long long spilled_bytes = 0;
+    REQUIRE(queue.spilled_frames(&spilled_bytes) == 4);
+    REQUIRE(spilled_bytes == 4 * W * H * BPP);
+    REQUIRE(queue.dropped_frames() == 2);
+    REQUIRE(queued_frames(8, 0) == std::vector<unsigned long long>({ 0, 1, 2, 3, 4, 5 }));
+    REQUIRE(queue.spilled_frames() == 0);
+
+    // Once drained, the file takes the frames of the next stall
+    REQUIRE(queued_frames(8, 5) == std::vector<unsigned long long>({ 8, 9, 10, 11, 12 }));
+    REQUIRE(queue.dropped_frames() == 2);
+
+    s.stop();
+    s.close();
+}
+
+TEST_CASE("Recorder bounds its write queue", "[software-device]") {
+    const int W = 16;
+    const int H = 16;
+    const int BPP = 2;
+    rs2_intrinsics intrinsics{ W, H, 0, 0, 0, 0, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    std::vector<uint8_t> pixels(W * H * BPP, 0);
+
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+
+    std::string folder_name = get_folder_path(special_folder::temp_folder);
+    const std::string filename = folder_name + "recorder_queue.bag";
+    {
+        recorder rec(filename, dev);
+        REQUIRE_THROWS(rec.set_queue_limit(2, 0, RS2_RECORD_QUEUE_POLICY_COUNT));
+
+        auto stats = rec.get_queue_stats();
+        REQUIRE(stats.queued_frames == 0);
+        REQUIRE(stats.written_frames == 0);
+        REQUIRE(stats.dropped_frames == 0);
+
+        auto recorded = rec.query_sensors().front();
+        recorded.open(recorded.get_stream_profiles().front());
+        recorded.start([](frame) {});
+
+        auto inject = [&](int first, int count)
+        {
+            for (int i = first; i < first + count; i++)
+                s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, i, depth });
+
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+            while (rec.get_queue_stats().queued_frames && std::chrono::steady_clock::now() < deadline)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            return rec.get_queue_stats();
+        };
+
+        // Every frame is either written or counted as dropped, and the queue never holds more than its bound
+        rec.set_queue_limit(2, 0, RS2_RECORD_QUEUE_POLICY_DROP_NEWEST);
+        stats = inject(0, 20);
+        REQUIRE(stats.queued_frames == 0);
+        REQUIRE(stats.queued_bytes == 0);
+        REQUIRE(stats.written_frames + stats.dropped_frames == 20);
+        REQUIRE(stats.written_frames > 0);
+        REQUIRE(stats.peak_bytes <= 2 * W * H * BPP);
+        REQUIRE(stats.max_latency_us >= stats.average_latency_us);
+
+        // Blocking waits for room instead of dropping
+        rec.set_queue_limit(1, 0, RS2_RECORD_QUEUE_POLICY_BLOCK);
+        auto blocked = inject(20, 20);
+        REQUIRE(blocked.dropped_frames == stats.dropped_frames);
+        REQUIRE(blocked.written_frames == stats.written_frames + 20);
+
+        recorded.stop();
+        recorded.close();
+    }
+}
+
+TEST_CASE("Flight recorder writes the pre-roll of a trigger", "[software-device]") {
+    const int W = 16;
+    const int H = 16;
+    const int BPP = 2;
+    rs2_intrinsics intrinsics{ W, H, 0, 0, 0, 0, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    std::vector<uint8_t> pixels(W * H * BPP, 0);
+
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+
+    std::string folder_name = get_folder_path(special_folder::temp_folder);
+    const std::string filename = folder_name + "recorder_pre_roll.bag";
+    {
+        recorder rec(filename, dev);
+        REQUIRE_THROWS(rec.trigger());
+        REQUIRE_THROWS(rec.set_pre_roll(std::chrono::seconds(-1), std::chrono::seconds(0)));
+        // The pre-roll holds the three frames its bytes bound it to, and the post-roll ends with the trigger
+        rec.set_pre_roll(std::chrono::seconds(60), std::chrono::seconds(0), 3 * W * H * BPP);
+
+        auto recorded = rec.query_sensors().front();
+        recorded.open(recorded.get_stream_profiles().front());
+        recorded.start([](frame) {});
+
+        auto inject = [&](int first, int count)
+        {
+            for (int i = first; i < first + count; i++)
+                s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, static_cast<double>(i), RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, i, depth });
+
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+            while (rec.get_queue_stats().queued_frames && std::chrono::steady_clock::now() < deadline)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            return rec.get_queue_stats();
+        };
+
+        auto stats = inject(0, 10);
+        REQUIRE(stats.pre_roll_frames == 3);
+        REQUIRE(stats.pre_roll_bytes == 3 * W * H * BPP);
+        REQUIRE(stats.written_frames == 0);
+
+        rec.trigger();
+        stats = inject(10, 5);
+        REQUIRE(stats.pre_roll_frames == 3);
+
+        recorded.stop();
+        recorded.close();
+    }
+
+    // The file holds the pre-roll of the trigger alone
     rs2::context ctx;
-    if (!make_context(SECTION_FROM_TEST_NAME, &ctx, "2.13.0"))
-        return;
+    auto dev_played = ctx.load_device(filename);
+    dev_played.set_real_time(false);
+    auto played = dev_played.query_sensors().front();
+    frame_queue queue(20);
+    played.open(played.get_stream_profiles().front());
+    played.start(queue);
+
+    std::vector<unsigned long long> numbers;
+    frame f;
+    while (queue.try_wait_for_frame(&f, 1000))
+        numbers.push_back(f.get_frame_number());
+    REQUIRE(numbers == std::vector<unsigned long long>({ 7, 8, 9 }));
+
+    played.stop();
+    played.close();
+}
+
+TEST_CASE("Recorder compresses the frames of a stream", "[software-device]") {
+    const int W = 64;
+    const int H = 48;
+    const int BPP = 2;
+    rs2_intrinsics intrinsics{ W, H, 0, 0, 0, 0, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    std::vector<uint16_t> pixels(W * H);
+    for (int i = 0; i < W * H; i++)
+        pixels[i] = static_cast<uint16_t>(i / 7);
+
     std::string folder_name = get_folder_path(special_folder::temp_folder);
-    const std::string filename = folder_name + "single_depth_color_640x480.bag";
-    REQUIRE(file_exists(filename));
-    auto dev = ctx.load_device(filename);
+    for (auto compression : { RS2_RECORD_COMPRESSION_NONE, RS2_RECORD_COMPRESSION_LZ4, RS2_RECORD_COMPRESSION_LZ4HC, RS2_RECORD_COMPRESSION_RVL })
+    {
+        CAPTURE(compression);
+        const std::string filename = folder_name + "recorder_compression.bag";
+        {
+            software_device dev;
+            auto s = dev.add_sensor("software_sensor");
+            auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+
+            recorder rec(filename, dev);
+            REQUIRE_THROWS(rec.set_stream_compression(RS2_STREAM_DEPTH, RS2_RECORD_COMPRESSION_COUNT));
+            rec.set_stream_compression(RS2_STREAM_DEPTH, compression);
+
+            auto recorded = rec.query_sensors().front();
+            recorded.open(recorded.get_stream_profiles().front());
+            recorded.start([](frame) {});
+            for (int i = 0; i < 3; i++)
+                s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, static_cast<double>(i), RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, i, depth });
+            recorded.stop();
+            recorded.close();
+        }
 
-    syncer sync;
-    std::vector<sensor> sensors = dev.query_sensors();
-    REQUIRE(sensors.size() == 2);
-    for (auto s : sensors)
+        // The frames play back as they were, whatever their compression
+        rs2::context ctx;
+        auto dev = ctx.load_device(filename);
+        dev.set_real_time(false);
+        auto played = dev.query_sensors().front();
+        frame_queue queue(10);
+        played.open(played.get_stream_profiles().front());
+        played.start(queue);
+
+        frame f;
+        REQUIRE(queue.try_wait_for_frame(&f, 5000));
+        auto vf = f.as<video_frame>();
+        REQUIRE(vf.get_stride_in_bytes() * vf.get_height() == W * H * BPP);
+        REQUIRE(memcmp(f.get_data(), pixels.data(), W * H * BPP) == 0);
+
+        played.stop();
+        played.close();
+    }
+}
+
+TEST_CASE("Recorder records the output of a processing block", "[software-device]") {
+    const int W = 64;
+    const int H = 48;
+    const int BPP = 2;
+    rs2_intrinsics intrinsics{ W, H, W / 2.f, H / 2.f, 50, 50, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    std::vector<uint16_t> pixels(W * H, 1000);
+
+    std::string folder_name = get_folder_path(special_folder::temp_folder);
+    const std::string filename = folder_name + "recorder_processing.bag";
     {
-        REQUIRE_NOTHROW(s.open(s.get_stream_profiles().front()));
-        REQUIRE_NOTHROW(s.start(sync));
+        software_device dev;
+        auto s = dev.add_sensor("software_sensor");
+        auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+
+        recorder rec(filename, dev);
+        decimation_filter decimation;
+        decimation.set_option(RS2_OPTION_FILTER_MAGNITUDE, 2);
+        REQUIRE_THROWS(rec.set_stream_processing(RS2_STREAM_COLOR, decimation));
+        rec.set_stream_processing(RS2_STREAM_DEPTH, decimation);
+
+        auto recorded = rec.query_sensors().front();
+        recorded.open(recorded.get_stream_profiles().front());
+        recorded.start([](frame) {});
+        // The processing of a stream that started recording would leave two profiles of it in the recording
+        REQUIRE_THROWS(rec.reset_stream_processing(RS2_STREAM_DEPTH));
+        for (int i = 0; i < 3; i++)
+            s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, static_cast<double>(i), RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, i, depth });
+        recorded.stop();
+        recorded.close();
     }
 
-    rs2::frame depth;
-    rs2::stream_profile depth_profile;
-    rs2::stream_profile color_profile;
+    // The recording holds the decimated frames, under the profile and intrinsics of the decimation
+    rs2::context ctx;
+    auto dev = ctx.load_device(filename);
+    dev.set_real_time(false);
+    auto played = dev.query_sensors().front();
+    auto profile = played.get_stream_profiles().front().as<video_stream_profile>();
+    REQUIRE(profile.width() == W / 2);
+    REQUIRE(profile.height() == H / 2);
+    auto intr = profile.get_intrinsics();
+    REQUIRE(intr.width == W / 2);
+    REQUIRE(intr.fx == Approx(intrinsics.fx / 2));
+
+    frame_queue queue(10);
+    played.open(profile);
+    played.start(queue);
+
+    frame f;
+    REQUIRE(queue.try_wait_for_frame(&f, 5000));
+    auto vf = f.as<video_frame>();
+    REQUIRE(vf.get_width() == W / 2);
+    REQUIRE(vf.get_height() == H / 2);
+    REQUIRE(reinterpret_cast<const uint16_t*>(vf.get_data())[0] == 1000);
+
+    played.stop();
+    played.close();
+}
 
-    while (!depth_profile || !color_profile)
+// Run-length coding of bytes, standing for the codecs of applications
+class run_length_codec : public rs2::frame_codec
+{
+public:
+    std::atomic<int> encoded{ 0 };
+    std::atomic<int> decoded{ 0 };
+
+    std::string name() const override { return "test-rle"; }
+
+    size_t encode(const video_frame& frame, uint8_t* out, size_t capacity) override
     {
-        frameset frames = sync.wait_for_frames(200);
-        REQUIRE(frames.size() > 0);
-        if (frames.size() == 1)
+        auto in = static_cast<const uint8_t*>(frame.get_data());
+        auto size = static_cast<size_t>(frame.get_stride_in_bytes()) * frame.get_height();
+        size_t written = 0;
+        for (size_t i = 0; i < size;)
         {
-            if (frames.get_profile().stream_type() == RS2_STREAM_DEPTH)
-            {
-                depth = frames.get_depth_frame();
-                depth_profile = depth.get_profile();
-            }
-            else
-            {
-                color_profile = frames.get_color_frame().get_profile();
-            }
+            size_t run = 1;
+            while (i + run < size && run < 255 && in[i + run] == in[i]) run++;
+            if (written + 2 > capacity) return 0;
+            out[written++] = static_cast<uint8_t>(run);
+            out[written++] = in[i];
+            i += run;
         }
-        else
+        encoded++;
+        return written;
+    }
+
+    bool decode(const uint8_t* in, size_t size, int width, int height, int stride, rs2_format format, uint8_t* pixels) override
+    {
+        decoded++;
+        size_t written = 0, total = static_cast<size_t>(stride) * height;
+        for (size_t i = 0; i + 1 < size; i += 2)
         {
-            depth = frames.get_depth_frame();
-            depth_profile = depth.get_profile();
-            color_profile = frames.get_color_frame().get_profile();
+            if (written + in[i] > total) return false;
+            memset(pixels + written, in[i + 1], in[i]);
+            written += in[i];
         }
+        return written == total;
     }
+};
 
-    auto depth_intrin = depth_profile.as<rs2::video_stream_profile>().get_intrinsics();
-    auto color_intrin = color_profile.as<rs2::video_stream_profile>().get_intrinsics();
-    auto depth_extrin_to_color = depth_profile.as<rs2::video_stream_profile>().get_extrinsics_to(color_profile);
-    auto color_extrin_to_depth = color_profile.as<rs2::video_stream_profile>().get_extrinsics_to(depth_profile);
+TEST_CASE("Recorder encodes frames with a codec of the application", "[software-device]") {
+    const int W = 64;
+    const int H = 48;
+    const int BPP = 3;
+    rs2_intrinsics intrinsics{ W, H, 0, 0, 0, 0, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    std::vector<uint8_t> pixels(W * H * BPP);
+    for (int i = 0; i < W * H * BPP; i++)
+        pixels[i] = static_cast<uint8_t>(i / (W * BPP));
 
-    float depth_scale = 0;
-    for (auto s : sensors)
+    std::string folder_name = get_folder_path(special_folder::temp_folder);
+    const std::string filename = folder_name + "recorder_codec.bag";
+    auto codec = std::make_shared<run_length_codec>();
     {
-        auto depth_sensor = s.is<rs2::depth_sensor>();
-        if (s.is<rs2::depth_sensor>())
+        software_device dev;
+        auto s = dev.add_sensor("software_sensor");
+        auto color = s.add_video_stream({ RS2_STREAM_COLOR, 0, 0, W, H, 60, BPP, RS2_FORMAT_RGB8, intrinsics });
+
+        recorder rec(filename, dev);
+        rec.set_stream_codec(RS2_STREAM_COLOR, codec);
+
+        auto recorded = rec.query_sensors().front();
+        recorded.open(recorded.get_stream_profiles().front());
+        recorded.start([](frame) {});
+        for (int i = 0; i < 3; i++)
+            s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, static_cast<double>(i), RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, i, color });
+        recorded.stop();
+        recorded.close();
+    }
+    REQUIRE(codec->encoded > 0);
+
+    // Without the codec the frames are not played
+    {
+        rs2::context ctx;
+        auto dev = ctx.load_device(filename);
+        dev.set_real_time(false);
+        auto played = dev.query_sensors().front();
+        frame_queue queue(10);
+        played.open(played.get_stream_profiles().front());
+        played.start(queue);
+        frame f;
+        REQUIRE_FALSE(queue.try_wait_for_frame(&f, 1000));
+        played.stop();
+        played.close();
+    }
+
+    // With it, the frames decode when their data is first accessed
+    rs2::context ctx;
+    auto dev = ctx.load_device(filename);
+    dev.set_real_time(false);
+    dev.register_codec(codec);
+    auto played = dev.query_sensors().front();
+    frame_queue queue(10);
+    played.open(played.get_stream_profiles().front());
+    played.start(queue);
+
+    frame f;
+    REQUIRE(queue.try_wait_for_frame(&f, 5000));
+    REQUIRE(codec->decoded == 0);
+    auto vf = f.as<video_frame>();
+    REQUIRE(vf.get_stride_in_bytes() * vf.get_height() == W * H * BPP);
+    REQUIRE(memcmp(f.get_data(), pixels.data(), W * H * BPP) == 0);
+    REQUIRE(codec->decoded == 1);
+
+    played.stop();
+    played.close();
+}
+
+TEST_CASE("Playback reads ahead through a mapping of the file", "[software-device]") {
+    const int W = 64;
+    const int H = 48;
+    const int BPP = 2;
+    const int frames = 20;
+    rs2_intrinsics intrinsics{ W, H, 0, 0, 0, 0, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    std::vector<uint16_t> pixels(W * H);
+
+    std::string folder_name = get_folder_path(special_folder::temp_folder);
+    const std::string filename = folder_name + "playback_read_ahead.bag";
+    {
+        software_device dev;
+        auto s = dev.add_sensor("software_sensor");
+        auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+
+        recorder rec(filename, dev);
+        auto recorded = rec.query_sensors().front();
+        recorded.open(recorded.get_stream_profiles().front());
+        recorded.start([](frame) {});
+        for (int i = 0; i < frames; i++)
         {
-            REQUIRE_NOTHROW(depth_scale = s.as<rs2::depth_sensor>().get_depth_scale());
+            std::fill(pixels.begin(), pixels.end(), static_cast<uint16_t>(i + 1));
+            s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, static_cast<double>(i), RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, i, depth });
         }
+        recorded.stop();
+        recorded.close();
     }
 
-    int count = 0;
-    for (float i = 0; i < depth_intrin.width; i++)
+    rs2::context ctx;
+    auto dev = ctx.load_device(filename);
+    dev.set_real_time(false);
+    REQUIRE_THROWS(dev.set_read_ahead(-1));
+    REQUIRE_THROWS(dev.set_read_ahead(17));
+    dev.set_read_ahead(8);
+    REQUIRE(dev.set_mapped_read(true));
+
+    // Every frame plays, in order and as it was, whether read ahead or on demand
+    for (auto read_ahead : { 8, 0 })
     {
-        for (float j = 0; j < depth_intrin.height; j++)
+        CAPTURE(read_ahead);
+        dev.set_read_ahead(read_ahead);
+        auto played = dev.query_sensors().front();
+        frame_queue queue(frames);
+        played.open(played.get_stream_profiles().front());
+        played.start(queue);
+
+        for (int i = 0; i < frames; i++)
         {
-            float depth_pixel[2] = { i, j };
-            auto udist = depth.as<rs2::depth_frame>().get_distance(depth_pixel[0], depth_pixel[1]);
-            if (udist == 0) continue;
+            frame f;
+            REQUIRE(queue.try_wait_for_frame(&f, 5000));
+            REQUIRE(f.get_frame_number() == i);
+            REQUIRE(reinterpret_cast<const uint16_t*>(f.get_data())[W * H - 1] == i + 1);
+        }
 
-            float from_pixel[2] = { 0 }, to_pixel[2] = { 0 }, point[3] = { 0 }, other_point[3] = { 0 };
-            rs2_deproject_pixel_to_point(point, &depth_intrin, depth_pixel, udist);
-            rs2_transform_point_to_point(other_point, &depth_extrin_to_color, point);
-            rs2_project_point_to_pixel(from_pixel, &color_intrin, other_point);
+        played.stop();
+        played.close();
+    }
+    REQUIRE(dev.set_mapped_read(false));
+}
 
-            rs2_project_color_pixel_to_depth_pixel(to_pixel, reinterpret_cast<const uint16_t*>(depth.get_data()), depth_scale, 0.1, 10,
-                &depth_intrin, &color_intrin,
-                &color_extrin_to_depth, &depth_extrin_to_color, from_pixel);
+TEST_CASE("Real time playback counts the lateness of its frames", "[software-device]") {
+    const int W = 64;
+    const int H = 48;
+    const int BPP = 2;
+    const int frames = 10;
+    rs2_intrinsics intrinsics{ W, H, 0, 0, 0, 0, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    std::vector<uint16_t> pixels(W * H);
 
-            float dist = sqrt(pow((depth_pixel[1] - to_pixel[1]), 2) + pow((depth_pixel[0] - to_pixel[0]), 2));
-            if (dist > 1)
-                count++;
-            if (dist > 2)
-                printf("%f\n", dist);
+    std::string folder_name = get_folder_path(special_folder::temp_folder);
+    const std::string filename = folder_name + "playback_jitter.bag";
+    {
+        software_device dev;
+        auto s = dev.add_sensor("software_sensor");
+        auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+
+        recorder rec(filename, dev);
+        auto recorded = rec.query_sensors().front();
+        recorded.open(recorded.get_stream_profiles().front());
+        recorded.start([](frame) {});
+        for (int i = 0; i < frames; i++)
+        {
+            s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, static_cast<double>(i * 10), RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, i, depth });
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
         }
+        recorded.stop();
+        recorded.close();
     }
-    const double MAX_ERROR_PERCENTAGE = 0.1;
-    REQUIRE(count * 100 / (depth_intrin.width * depth_intrin.height) < MAX_ERROR_PERCENTAGE);
-    CAPTURE(count);
-}
\ No newline at end of file
+
+    rs2::context ctx;
+    auto dev = ctx.load_device(filename);
+    dev.set_real_time(true);
+    auto played = dev.query_sensors().front();
+    frame_queue queue(frames);
+    played.open(played.get_stream_profiles().front());
+    played.start(queue);
+    for (int i = 0; i < frames; i++)
+    {
+        frame f;
+        REQUIRE(queue.try_wait_for_frame(&f, 5000));
+    }
+    played.stop();
+    played.close();
+
+    // Of every frame, none of them published before it was due
+    auto jitter = dev.get_jitter();
+    REQUIRE(jitter.frames == frames);
+    REQUIRE(jitter.mean_lateness_us >= 0);
+    REQUIRE(jitter.max_lateness_us >= jitter.mean_lateness_us);
+    REQUIRE(jitter.stddev_lateness_us >= 0);
+    REQUIRE(dev.get_jitter(RS2_STREAM_DEPTH, 0).frames == frames);
+    REQUIRE(dev.get_jitter(RS2_STREAM_COLOR).frames == 0);
+    REQUIRE(dev.get_jitter(RS2_STREAM_DEPTH, 1).frames == 0);
+}
+
+TEST_CASE("Merged playback plays the sensors of every file", "[software-device]") {
+    const int W = 64;
+    const int H = 48;
+    const int BPP = 2;
+    const int frames = 10;
+    rs2_intrinsics intrinsics{ W, H, 0, 0, 0, 0, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    std::vector<uint16_t> pixels(W * H);
+
+    std::string folder_name = get_folder_path(special_folder::temp_folder);
+    const std::vector<std::string> filenames = { folder_name + "merged_playback_0.bag", folder_name + "merged_playback_1.bag" };
+    for (size_t n = 0; n < filenames.size(); n++)
+    {
+        software_device dev;
+        auto s = dev.add_sensor("software_sensor");
+        auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+
+        recorder rec(filenames[n], dev);
+        auto recorded = rec.query_sensors().front();
+        recorded.open(recorded.get_stream_profiles().front());
+        recorded.start([](frame) {});
+        for (int i = 0; i < frames; i++)
+        {
+            std::fill(pixels.begin(), pixels.end(), static_cast<uint16_t>(n + 1));
+            s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, static_cast<double>(i * 10), RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, i, depth });
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        recorded.stop();
+        recorded.close();
+    }
+
+    rs2::context ctx;
+    auto dev = ctx.load_merged_device(filenames);
+    dev.set_real_time(false);
+    REQUIRE(dev.file_name() == filenames[0] + "|" + filenames[1]);
+    REQUIRE_THROWS(ctx.load_merged_device(filenames));
+
+    // Of the sensors of both files in order, each of the frames of its own file
+    auto sensors = dev.query_sensors();
+    REQUIRE(sensors.size() == filenames.size());
+    std::vector<std::vector<unsigned long long>> numbers(sensors.size());
+    std::mutex m;
+    for (size_t n = 0; n < sensors.size(); n++)
+    {
+        sensors[n].open(sensors[n].get_stream_profiles().front());
+        sensors[n].start([&, n](frame f)
+        {
+            auto data = static_cast<const uint16_t*>(f.get_data());
+            std::lock_guard<std::mutex> lock(m);
+            if (data[0] == n + 1)
+                numbers[n].push_back(f.get_frame_number());
+        });
+    }
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            if (numbers[0].size() == frames && numbers[1].size() == frames)
+                break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    for (auto&& s : sensors)
+    {
+        s.stop();
+        s.close();
+    }
+
+    for (auto&& n : numbers)
+    {
+        REQUIRE(n.size() == frames);
+        REQUIRE(std::is_sorted(n.begin(), n.end()));
+    }
+    ctx.unload_device(filenames[0] + "|" + filenames[1]);
+}
+
+TEST_CASE("Playback seeks through the index file of the recording", "[software-device]") {
+    const int W = 64;
+    const int H = 48;
+    const int BPP = 2;
+    const int frames = 30;
+    rs2_intrinsics intrinsics{ W, H, 0, 0, 0, 0, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    std::vector<uint16_t> pixels(W * H);
+
+    std::string folder_name = get_folder_path(special_folder::temp_folder);
+    const std::string filename = folder_name + "playback_index_file.bag";
+    {
+        software_device dev;
+        auto s = dev.add_sensor("software_sensor");
+        auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+
+        recorder rec(filename, dev);
+        auto recorded = rec.query_sensors().front();
+        recorded.open(recorded.get_stream_profiles().front());
+        recorded.start([](frame) {});
+        for (int i = 0; i < frames; i++)
+        {
+            std::fill(pixels.begin(), pixels.end(), static_cast<uint16_t>(i + 1));
+            s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, static_cast<double>(i), RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, i, depth });
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        recorded.stop();
+        recorded.close();
+    }
+    REQUIRE(std::ifstream(filename + ".idx").good());
+
+    rs2::context ctx;
+    auto dev = ctx.load_device(filename);
+    dev.set_real_time(false);
+    auto played = dev.query_sensors().front();
+    frame_queue queue(frames);
+    played.open(played.get_stream_profiles().front());
+    played.start(queue);
+    dev.pause();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    frame f;
+    while (queue.poll_for_frame(&f));
+
+    // Seeking while paused raises the last frame recorded before the seek time
+    dev.seek(dev.get_duration() / 2);
+    REQUIRE(queue.try_wait_for_frame(&f, 5000));
+    REQUIRE(f.get_frame_number() > 0);
+    REQUIRE(f.get_frame_number() < frames - 1);
+    REQUIRE(reinterpret_cast<const uint16_t*>(f.get_data())[W * H - 1] == f.get_frame_number() + 1);
+
+    played.stop();
+    played.close();
+}
+
+TEST_CASE("Recorded frame metadata plays back as it was", "[software-device]") {
+    const int W = 64;
+    const int H = 48;
+    const int BPP = 2;
+    const int frames = 10;
+    rs2_intrinsics intrinsics{ W, H, 0, 0, 0, 0, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    std::vector<uint16_t> pixels(W * H);
+
+    std::string folder_name = get_folder_path(special_folder::temp_folder);
+    const std::string filename = folder_name + "recorded_metadata.bag";
+    {
+        software_device dev;
+        auto s = dev.add_sensor("software_sensor");
+        auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+
+        recorder rec(filename, dev);
+        auto recorded = rec.query_sensors().front();
+        recorded.open(recorded.get_stream_profiles().front());
+        recorded.start([](frame) {});
+        for (int i = 0; i < frames; i++)
+        {
+            s.set_metadata(RS2_FRAME_METADATA_ACTUAL_EXPOSURE, 1000 + i);
+            s.set_metadata(RS2_FRAME_METADATA_GAIN_LEVEL, -i);
+            s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, static_cast<double>(i), RS2_TIMESTAMP_DOMAIN_SYSTEM_TIME, i, depth });
+        }
+        recorded.stop();
+        recorded.close();
+    }
+
+    rs2::context ctx;
+    auto dev = ctx.load_device(filename);
+    dev.set_real_time(false);
+    auto played = dev.query_sensors().front();
+    frame_queue queue(frames);
+    played.open(played.get_stream_profiles().front());
+    played.start(queue);
+
+    for (int i = 0; i < frames; i++)
+    {
+        frame f;
+        REQUIRE(queue.try_wait_for_frame(&f, 5000));
+        REQUIRE(f.get_frame_timestamp_domain() == RS2_TIMESTAMP_DOMAIN_SYSTEM_TIME);
+        REQUIRE(f.supports_frame_metadata(RS2_FRAME_METADATA_ACTUAL_EXPOSURE));
+        REQUIRE(f.get_frame_metadata(RS2_FRAME_METADATA_ACTUAL_EXPOSURE) == 1000 + f.get_frame_number());
+        REQUIRE(f.supports_frame_metadata(RS2_FRAME_METADATA_GAIN_LEVEL));
+        REQUIRE(f.get_frame_metadata(RS2_FRAME_METADATA_GAIN_LEVEL) == -static_cast<rs2_metadata_type>(f.get_frame_number()));
+        REQUIRE_FALSE(f.supports_frame_metadata(RS2_FRAME_METADATA_WHITE_BALANCE));
+    }
+
+    played.stop();
+    played.close();
+}
+
+TEST_CASE("All frame metadata is retrieved at once", "[software-device]") {
+    const int W = 64;
+    const int H = 48;
+    const int BPP = 2;
+    rs2_intrinsics intrinsics{ W, H, 0, 0, 0, 0, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    std::vector<uint16_t> pixels(W * H);
+
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+    frame_queue queue(10);
+    s.open(depth);
+    s.start(queue);
+    s.set_metadata(RS2_FRAME_METADATA_ACTUAL_EXPOSURE, 1000);
+    s.set_metadata(RS2_FRAME_METADATA_GAIN_LEVEL, -7);
+    s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 3, depth });
+
+    frame f;
+    REQUIRE(queue.try_wait_for_frame(&f, 1000));
+
+    rs2_metadata_type values[RS2_FRAME_METADATA_COUNT] = {};
+    int supported[RS2_FRAME_METADATA_COUNT] = {};
+    auto count = f.get_frame_metadata_all(values, supported);
+    REQUIRE(count >= 2);
+    REQUIRE(supported[RS2_FRAME_METADATA_ACTUAL_EXPOSURE]);
+    REQUIRE(values[RS2_FRAME_METADATA_ACTUAL_EXPOSURE] == 1000);
+    REQUIRE(supported[RS2_FRAME_METADATA_GAIN_LEVEL]);
+    REQUIRE(values[RS2_FRAME_METADATA_GAIN_LEVEL] == -7);
+
+    // The same as queried one at a time
+    auto found = 0;
+    for (int i = 0; i < RS2_FRAME_METADATA_COUNT; i++)
+    {
+        auto md = static_cast<rs2_frame_metadata_value>(i);
+        REQUIRE(f.supports_frame_metadata(md) == (supported[i] != 0));
+        if (supported[i])
+        {
+            REQUIRE(f.get_frame_metadata(md) == values[i]);
+            found++;
+        }
+    }
+    REQUIRE(found == count);
+
+    s.stop();
+    s.close();
+}
+
+TEST_CASE("Frame info is retrieved at once", "[software-device]") {
+    const int W = 64;
+    const int H = 48;
+    const int BPP = 2;
+    rs2_intrinsics intrinsics{ W, H, 0, 0, 0, 0, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    std::vector<uint16_t> pixels(W * H);
+
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+    frame_queue queue(10);
+    s.open(depth);
+    s.start(queue);
+    s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 25, RS2_TIMESTAMP_DOMAIN_SYSTEM_TIME, 3, depth });
+
+    frame f;
+    REQUIRE(queue.try_wait_for_frame(&f, 1000));
+    auto vf = f.as<video_frame>();
+    REQUIRE(vf);
+
+    // The same as queried one at a time
+    auto info = f.get_info();
+    REQUIRE(info.data == vf.get_data());
+    REQUIRE(info.timestamp == vf.get_timestamp());
+    REQUIRE(info.timestamp_domain == vf.get_frame_timestamp_domain());
+    REQUIRE(info.frame_number == vf.get_frame_number());
+    REQUIRE(stream_profile(info.profile) == vf.get_profile());
+    REQUIRE(info.is_video);
+    REQUIRE(info.width == vf.get_width());
+    REQUIRE(info.height == vf.get_height());
+    REQUIRE(info.stride_in_bytes == vf.get_stride_in_bytes());
+    REQUIRE(info.bits_per_pixel == vf.get_bits_per_pixel());
+
+    s.stop();
+    s.close();
+}
+
+TEST_CASE("Frames are copied into buffers of the application", "[software-device]") {
+    const int W = 64;
+    const int H = 48;
+    const int PADDING = 10;
+    rs2_intrinsics intrinsics{ W, H, 0, 0, 0, 0, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    std::vector<uint8_t> pixels(W * H);
+    for (size_t i = 0; i < pixels.size(); i++)
+        pixels[i] = static_cast<uint8_t>(i * 13);
+
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+    auto ir = s.add_video_stream({ RS2_STREAM_INFRARED, 1, 0, W, H, 60, 1, RS2_FORMAT_Y8, intrinsics });
+    frame_queue queue(10);
+    s.open(ir);
+    s.start(queue);
+    s.on_video_frame({ pixels.data(), [](void*) {}, W, 1, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 0, ir });
+
+    frame f;
+    REQUIRE(queue.try_wait_for_frame(&f, 1000));
+    auto vf = f.as<video_frame>();
+    REQUIRE(vf);
+
+    // Converted into rows padded past the image, leaving the padding alone
+    const int stride = W * 2 + PADDING;
+    std::vector<uint8_t> converted(stride * H, 0xAB);
+    REQUIRE_NOTHROW(vf.copy_to(converted.data(), RS2_FORMAT_Y16, stride));
+    for (int y = 0; y < H; y++)
+    {
+        auto row = reinterpret_cast<const uint16_t*>(converted.data() + y * stride);
+        for (int x = 0; x < W; x++)
+        {
+            auto pixel = pixels[y * W + x];
+            REQUIRE(row[x] == (pixel | pixel << 8));
+        }
+        for (int x = W * 2; x < stride; x++)
+            REQUIRE(converted[y * stride + x] == 0xAB);
+    }
+
+    // Copied as is, in rows right one after the other
+    std::vector<uint8_t> copied(W * H);
+    REQUIRE_NOTHROW(vf.copy_to(copied.data(), RS2_FORMAT_Y8));
+    REQUIRE(copied == pixels);
+
+    // No conversion, or rows too short for the image
+    REQUIRE_THROWS(vf.copy_to(converted.data(), RS2_FORMAT_RGB8));
+    REQUIRE_THROWS(vf.copy_to(converted.data(), RS2_FORMAT_Y16, W));
+
+    s.stop();
+    s.close();
+}
+
+TEST_CASE("Frames are stamped at the stages of their delivery", "[software-device]") {
+    const int W = 64;
+    const int H = 48;
+    const int BPP = 2;
+    rs2_intrinsics intrinsics{ W, H, 0, 0, 0, 0, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    std::vector<uint16_t> pixels(W * H);
+
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+    syncer sync;
+    s.open(depth);
+    s.start(sync);
+    s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 25, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 1, depth });
+
+    frameset fs;
+    REQUIRE(sync.try_wait_for_frames(&fs, 5000));
+    auto f = fs.get_depth_frame();
+    REQUIRE(f);
+
+    // Software frames are neither dequeued from a driver nor unpacked
+    REQUIRE_FALSE(f.supports_frame_metadata(RS2_FRAME_METADATA_DEQUEUE_TIME));
+    REQUIRE_FALSE(f.supports_frame_metadata(RS2_FRAME_METADATA_UNPACK_TIME));
+    REQUIRE(f.supports_frame_metadata(RS2_FRAME_METADATA_SYNC_TIME));
+    REQUIRE(f.supports_frame_metadata(RS2_FRAME_METADATA_CALLBACK_TIME));
+
+    // The last callback is the frameset's, once matched
+    auto synced = f.get_frame_metadata(RS2_FRAME_METADATA_SYNC_TIME);
+    auto callback = f.get_frame_metadata(RS2_FRAME_METADATA_CALLBACK_TIME);
+    REQUIRE(synced > 0);
+    REQUIRE(callback >= synced);
+    REQUIRE(fs.get_frame_metadata(RS2_FRAME_METADATA_CALLBACK_TIME) == callback);
+
+    s.stop();
+    s.close();
+}
+
+TEST_CASE("Traces record the delivery of frames", "[software-device]") {
+    const int W = 64;
+    const int H = 48;
+    const int BPP = 2;
+    rs2_intrinsics intrinsics{ W, H, 0, 0, 0, 0, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    std::vector<uint16_t> pixels(W * H);
+
+    std::string folder_name = get_folder_path(special_folder::temp_folder);
+    const std::string filename = folder_name + "delivery_trace.json";
+
+    context ctx;
+    REQUIRE_THROWS(ctx.stop_trace(filename));
+    ctx.start_trace();
+    {
+        software_device dev;
+        auto s = dev.add_sensor("software_sensor");
+        auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+        syncer sync;
+        s.open(depth);
+        s.start(sync);
+        s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 25, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 7, depth });
+
+        frameset fs;
+        REQUIRE(sync.try_wait_for_frames(&fs, 5000));
+        s.stop();
+        s.close();
+    }
+    ctx.stop_trace(filename);
+
+    std::ifstream file(filename);
+    std::string trace((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    REQUIRE(trace.find("\"traceEvents\"") != std::string::npos);
+    for (auto stage : { "\"publish\"", "\"sync\"", "\"callback\"", "\"release\"" })
+        REQUIRE(trace.find(stage) != std::string::npos);
+    REQUIRE(trace.find("\"frame\":7") != std::string::npos);
+}
+
+TEST_CASE("Extrinsics looked up again follow their registration", "[software-device]") {
+    rs2_intrinsics intrinsics{ 64, 48, 0, 0, 0, 0, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, 64, 48, 60, 2, RS2_FORMAT_Z16, intrinsics });
+    auto ir = s.add_video_stream({ RS2_STREAM_INFRARED, 1, 1, 64, 48, 60, 1, RS2_FORMAT_Y8, intrinsics });
+
+    rs2_extrinsics first{ { 1, 0, 0, 0, 1, 0, 0, 0, 1 },{ 0.1f, 0, 0 } };
+    depth.register_extrinsics_to(ir, first);
+    for (int i = 0; i < 2; i++)
+    {
+        auto extrinsics = depth.get_extrinsics_to(ir);
+        REQUIRE(extrinsics.translation[0] == Approx(0.1f));
+        REQUIRE(ir.get_extrinsics_to(depth).translation[0] == Approx(-0.1f));
+    }
+
+    // Replaces what was looked up before
+    rs2_extrinsics second{ { 1, 0, 0, 0, 1, 0, 0, 0, 1 },{ 0.2f, 0, 0 } };
+    depth.register_extrinsics_to(ir, second);
+    REQUIRE(depth.get_extrinsics_to(ir).translation[0] == Approx(0.2f));
+    REQUIRE(ir.get_extrinsics_to(depth).translation[0] == Approx(-0.2f));
+}
+
+#ifdef RS2_TEST_KERNELS
+#include "../src/environment.h"
+#include "../src/stream.h"
+
+TEST_CASE("Extrinsics looked up again are dropped with the edges of their path", "[software-device]") {
+    librealsense::extrinsics_graph graph;
+    auto depth = std::make_shared<librealsense::stream>(RS2_STREAM_DEPTH);
+    auto ir = std::make_shared<librealsense::stream>(RS2_STREAM_INFRARED);
+    auto color = std::make_shared<librealsense::stream>(RS2_STREAM_COLOR);
+
+    // The edges of a device are owned by it, and go with it
+    auto depth_to_ir = std::make_shared<librealsense::lazy<rs2_extrinsics>>([]() { return rs2_extrinsics{ { 1,0,0,0,1,0,0,0,1 },{ 0.1f,0,0 } }; });
+    auto ir_to_color = std::make_shared<librealsense::lazy<rs2_extrinsics>>([]() { return rs2_extrinsics{ { 1,0,0,0,1,0,0,0,1 },{ 0,0.2f,0 } }; });
+    graph.register_extrinsics(*depth, *ir, depth_to_ir);
+    graph.register_extrinsics(*ir, *color, ir_to_color);
+
+    rs2_extrinsics extrinsics;
+    for (int i = 0; i < 2; i++)
+    {
+        REQUIRE(graph.try_fetch_extrinsics(*depth, *color, &extrinsics));
+        REQUIRE(extrinsics.translation[0] == Approx(0.1f));
+        REQUIRE(extrinsics.translation[1] == Approx(0.2f));
+    }
+
+    ir_to_color.reset();
+    REQUIRE_FALSE(graph.try_fetch_extrinsics(*depth, *color, &extrinsics));
+    REQUIRE(graph.try_fetch_extrinsics(*depth, *ir, &extrinsics));
+    REQUIRE(extrinsics.translation[0] == Approx(0.1f));
+
+    // A stream going away is cleaned up from the graph by the next lock, and nothing resolved through it stands
+    ir.reset();
+    graph.lock();
+    REQUIRE_FALSE(graph.try_fetch_extrinsics(*depth, *color, &extrinsics));
+}
+#endif
+
+TEST_CASE("Segmented recording loses no frame between its files", "[software-device]") {
+    const int W = 64;
+    const int H = 48;
+    const int BPP = 2;
+    const int frames = 30;
+    rs2_intrinsics intrinsics{ W, H, 0, 0, 0, 0, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    std::vector<uint16_t> pixels(W * H);
+
+    std::string folder_name = get_folder_path(special_folder::temp_folder);
+    const std::string filename = folder_name + "segmented_recording.bag";
+
+    // Records 30 frames over ~600 ms, in segments of 100 ms
+    auto record = [&](unsigned long long disk_budget)
+    {
+        std::vector<std::string> closed;
+        {
+            software_device dev;
+            auto s = dev.add_sensor("software_sensor");
+            auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+
+            recorder rec(filename, dev, std::chrono::milliseconds(100), 0);
+            rec.set_segment_closed_callback([&](const std::string& file) { closed.push_back(file); });
+            if (disk_budget)
+                rec.set_disk_budget(disk_budget);
+            auto recorded = rec.query_sensors().front();
+            recorded.open(recorded.get_stream_profiles().front());
+            recorded.start([](frame) {});
+            for (int i = 0; i < frames; i++)
+            {
+                std::fill(pixels.begin(), pixels.end(), static_cast<uint16_t>(i + 1));
+                s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, static_cast<double>(i), RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, i, depth });
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            }
+            recorded.stop();
+            recorded.close();
+        }
+        return closed;
+    };
+
+    auto segments = record(0);
+    REQUIRE(segments.size() > 2);
+
+    // Each segment plays on its own, and together they hold every frame once, in order
+    int next_frame = 0;
+    for (auto&& segment : segments)
+    {
+        CAPTURE(segment);
+        rs2::context ctx;
+        auto dev = ctx.load_device(segment);
+        dev.set_real_time(false);
+        auto played = dev.query_sensors().front();
+        REQUIRE(played.get_stream_profiles().size() == 1);
+        frame_queue queue(frames);
+        played.open(played.get_stream_profiles().front());
+        played.start(queue);
+
+        frame f;
+        while (queue.try_wait_for_frame(&f, 500))
+        {
+            REQUIRE(f.get_frame_number() == next_frame);
+            REQUIRE(reinterpret_cast<const uint16_t*>(f.get_data())[W * H - 1] == next_frame + 1);
+            next_frame++;
+        }
+        played.stop();
+        played.close();
+    }
+    REQUIRE(next_frame == frames);
+
+    // Without room for any segment, each is deleted once it is closed
+    segments = record(1);
+    REQUIRE(segments.size() > 2);
+    for (auto&& segment : segments)
+        REQUIRE_FALSE(file_exists(segment));
+}
+
+TEST_CASE("Capture files play back frames from the mapped file", "[software-device]") {
+    const int W = 64;
+    const int H = 48;
+    const int BPP = 2;
+    const int frames = 40;
+    rs2_intrinsics intrinsics{ W, H, 32, 24, 50, 50, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    // The software frames hold their pixels until they are written
+    std::vector<std::vector<uint16_t>> pixels(frames, std::vector<uint16_t>(W * H));
+
+    std::string folder_name = get_folder_path(special_folder::temp_folder);
+    const std::string filename = folder_name + "capture.rscap";
+    {
+        software_device dev;
+        auto s = dev.add_sensor("software_sensor");
+        auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+
+        recorder rec(filename, dev);
+        auto recorded = rec.query_sensors().front();
+        recorded.open(recorded.get_stream_profiles().front());
+        recorded.start([](frame) {});
+        for (int i = 0; i < frames; i++)
+        {
+            std::fill(pixels[i].begin(), pixels[i].end(), static_cast<uint16_t>(i + 1));
+            s.set_metadata(RS2_FRAME_METADATA_ACTUAL_EXPOSURE, 1000 + i);
+            s.on_video_frame({ pixels[i].data(), [](void*) {}, W * BPP, BPP, static_cast<double>(i), RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, i, depth });
+        }
+        recorded.stop();
+        recorded.close();
+    }
+
+    rs2::context ctx;
+    auto dev = ctx.load_device(filename);
+    dev.set_real_time(false);
+    auto played = dev.query_sensors().front();
+    REQUIRE(played.get_stream_profiles().size() == 1);
+    auto profile = played.get_stream_profiles().front().as<video_stream_profile>();
+    REQUIRE(profile.width() == W);
+    REQUIRE(profile.height() == H);
+    REQUIRE(profile.get_intrinsics().fx == intrinsics.fx);
+
+    // More frames than a chunk holds, each played in place from its chunk
+    frame_queue queue(frames);
+    played.open(played.get_stream_profiles().front());
+    played.start(queue);
+    for (int i = 0; i < frames; i++)
+    {
+        frame f;
+        REQUIRE(queue.try_wait_for_frame(&f, 5000));
+        REQUIRE(f.get_frame_number() == i);
+        REQUIRE(f.get_timestamp() == static_cast<double>(i));
+        REQUIRE(reinterpret_cast<uintptr_t>(f.get_data()) % 64 == 0);
+        REQUIRE(reinterpret_cast<const uint16_t*>(f.get_data())[W * H - 1] == i + 1);
+        REQUIRE(f.get_frame_metadata(RS2_FRAME_METADATA_ACTUAL_EXPOSURE) == 1000 + i);
+    }
+    played.stop();
+    played.close();
+}
+
+TEST_CASE("Pipeline runs the processing blocks of its configuration", "[software-device][using_pipeline]") {
+    const int W = 64;
+    const int H = 48;
+    const int BPP = 2;
+    const int frames = 10;
+    rs2_intrinsics intrinsics{ W, H, 32, 24, 50, 50, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    std::vector<std::vector<uint16_t>> pixels(frames, std::vector<uint16_t>(W * H));
+
+    std::string folder_name = get_folder_path(special_folder::temp_folder);
+    const std::string filename = folder_name + "pipeline_processing.rscap";
+    {
+        software_device dev;
+        auto s = dev.add_sensor("software_sensor");
+        auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+
+        recorder rec(filename, dev);
+        auto recorded = rec.query_sensors().front();
+        recorded.open(recorded.get_stream_profiles().front());
+        recorded.start([](frame) {});
+        for (int i = 0; i < frames; i++)
+        {
+            std::fill(pixels[i].begin(), pixels[i].end(), static_cast<uint16_t>(i + 1));
+            s.on_video_frame({ pixels[i].data(), [](void*) {}, W * BPP, BPP, static_cast<double>(i), RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, i, depth });
+        }
+        recorded.stop();
+        recorded.close();
+    }
+
+    std::mutex m;
+    std::vector<std::thread::id> first_threads;
+    std::vector<long long> order;
+    rs2::processing_block first([&](rs2::frame f, rs2::frame_source& src)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            first_threads.push_back(std::this_thread::get_id());
+        }
+        src.frame_ready(f);
+    });
+    rs2::processing_block second([&](rs2::frame f, rs2::frame_source& src)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            order.push_back(f.as<frameset>().get_depth_frame().get_frame_number());
+        }
+        src.frame_ready(f);
+    });
+
+    rs2::context ctx;
+    rs2::pipeline pipe(ctx);
+    rs2::config cfg;
+    cfg.enable_device_from_file(filename, false);
+    cfg.add_processing_block(first);
+    cfg.add_processing_block(second);
+    pipe.start(cfg);
+
+    frameset fs;
+    REQUIRE(pipe.try_wait_for_frames(&fs, 5000));
+    REQUIRE(fs.get_depth_frame());
+    pipe.stop();
+
+    std::lock_guard<std::mutex> lock(m);
+    REQUIRE(!first_threads.empty());
+    REQUIRE(!order.empty());
+    // Both blocks ran, on worker threads of the pipeline, before the frameset was returned
+    for (auto&& id : first_threads)
+        REQUIRE(id != std::this_thread::get_id());
+    REQUIRE(std::is_sorted(order.begin(), order.end()));
+    REQUIRE(std::find(order.begin(), order.end(), fs.get_depth_frame().get_frame_number()) != order.end());
+}
+
+TEST_CASE("Depth compression is lossless", "[software-device]") {
+    const int W = 848;
+    const int H = 480;
+    const int BPP = 2;
+    rs2_intrinsics intrinsics{ W, H, 0, 0, 0, 0, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+
+    // Smooth depth with holes, and the extremes of the 16-bit range
+    std::vector<uint16_t> pixels(W * H);
+    for (int y = 0; y < H; y++)
+        for (int x = 0; x < W; x++)
+            pixels[y * W + x] = ((x / 40 + y / 30) % 7 == 0) ? 0 : static_cast<uint16_t>(1000 + x / 3 + y / 2 + (x * y) % 3);
+    pixels[1] = 65535;
+    pixels[2] = 1;
+    pixels[W * H - 1] = 65535;
+
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 30, BPP, RS2_FORMAT_Z16, intrinsics });
+    frame_queue queue(10);
+    s.open(depth);
+    s.start(queue);
+    s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 7, depth });
+
+    frame f;
+    REQUIRE(queue.try_wait_for_frame(&f, 1000));
+
+    rs2::depth_compressor compressor;
+    rs2::depth_decompressor decompressor;
+    auto compressed = compressor.process(f).as<video_frame>();
+    REQUIRE(compressed);
+    REQUIRE(compressed.get_profile().format() == RS2_FORMAT_Z16_RVL);
+    REQUIRE(compressed.get_profile().stream_type() == RS2_STREAM_DEPTH);
+    REQUIRE(compressed.get_width() == W);
+    REQUIRE(compressed.get_height() == H);
+    REQUIRE(compressed.get_frame_number() == 7);
+    REQUIRE(compressed.get_stride_in_bytes() * H < W * H * BPP / 2);
+
+    auto decompressed = decompressor.process(compressed).as<depth_frame>();
+    REQUIRE(decompressed);
+    REQUIRE(decompressed.get_profile().format() == RS2_FORMAT_Z16);
+    REQUIRE(decompressed.get_stride_in_bytes() == W * BPP);
+    REQUIRE(memcmp(decompressed.get_data(), pixels.data(), W * H * BPP) == 0);
+
+    // Frames of other formats are left as they are
+    REQUIRE(decompressor.process(f).get_profile().format() == RS2_FORMAT_Z16);
+
+    s.stop();
+    s.close();
+}
+
+TEST_CASE("Pointcloud compacts the valid points", "[software-device][pointcloud]") {
+    const int W = 64;
+    const int H = 48;
+    const int BPP = 2;
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+    s.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+
+    rs2_intrinsics intrinsics{ W, H, W / 2.f, H / 2.f, 50, 50, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+
+    // Every third pixel has depth
+    std::vector<uint16_t> pixels(W * H, 0);
+    std::vector<int> valid;
+    for (int i = 0; i < W * H; i += 3)
+    {
+        pixels[i] = static_cast<uint16_t>(500 + i);
+        valid.push_back(i);
+    }
+
+    rs2::pointcloud pc;
+    REQUIRE(pc.supports(RS2_OPTION_COMPACT_POINTS));
+    REQUIRE(pc.get_option(RS2_OPTION_COMPACT_POINTS) == 0);
+
+    frame_queue q;
+    s.open(depth);
+    s.start(q);
+
+    std::vector<rs2::points> clouds;
+    for (int mode = 0; mode < 3; mode++)
+    {
+        pc.set_option(RS2_OPTION_COMPACT_POINTS, static_cast<float>(mode));
+        s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, mode, depth });
+        clouds.push_back(pc.calculate(q.wait_for_frame()));
+    }
+    s.stop();
+    s.close();
+
+    auto& full = clouds[0];
+    REQUIRE(full.size() == W * H);
+    REQUIRE(full.get_pixel_indices() == nullptr);
+
+    REQUIRE(clouds[1].size() == valid.size());
+    REQUIRE(clouds[1].get_pixel_indices() == nullptr);
+
+    auto& indexed = clouds[2];
+    REQUIRE(indexed.size() == valid.size());
+    REQUIRE(indexed.get_pixel_indices() != nullptr);
+    for (size_t i = 0; i < valid.size(); i++)
+    {
+        REQUIRE(indexed.get_pixel_indices()[i] == valid[i]);
+        REQUIRE(clouds[1].get_vertices()[i].z == full.get_vertices()[valid[i]].z);
+        REQUIRE(indexed.get_vertices()[i].x == full.get_vertices()[valid[i]].x);
+        REQUIRE(indexed.get_vertices()[i].y == full.get_vertices()[valid[i]].y);
+        REQUIRE(indexed.get_vertices()[i].z == full.get_vertices()[valid[i]].z);
+    }
+}
+
+TEST_CASE("Pointcloud 16-bit vertex formats", "[software-device][pointcloud]") {
+    const int W = 64;
+    const int H = 48;
+    const int BPP = 2;
+    const float units = 0.001f;
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+    s.add_read_only_option(RS2_OPTION_DEPTH_UNITS, units);
+
+    rs2_intrinsics intrinsics{ W, H, W / 2.f, H / 2.f, 50, 50, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+
+    std::vector<uint16_t> pixels(W * H, 0);
+    for (int i = 0; i < W * H; i++)
+        pixels[i] = i % 5 ? static_cast<uint16_t>(300 + i * 7) : 0;
+
+    auto half_to_float = [](uint16_t h) {
+        int exponent = (h >> 10) & 0x1f, mantissa = h & 0x3ff;
+        float value = exponent ? std::ldexp(1.f + mantissa / 1024.f, exponent - 15) : std::ldexp(mantissa / 1024.f, -14);
+        return h & 0x8000 ? -value : value;
+    };
+
+    rs2::pointcloud pc;
+    REQUIRE(pc.supports(RS2_OPTION_POINTS_FORMAT));
+
+    frame_queue q;
+    s.open(depth);
+    s.start(q);
+
+    std::vector<rs2::points> clouds;
+    for (int format = 0; format < 3; format++)
+    {
+        pc.set_option(RS2_OPTION_POINTS_FORMAT, static_cast<float>(format));
+        s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, format, depth });
+        clouds.push_back(pc.calculate(q.wait_for_frame()));
+    }
+    s.stop();
+    s.close();
+
+    REQUIRE(clouds[0].get_profile().format() == RS2_FORMAT_XYZ32F);
+    REQUIRE(clouds[1].get_profile().format() == RS2_FORMAT_XYZ16);
+    REQUIRE(clouds[2].get_profile().format() == RS2_FORMAT_XYZ16F);
+
+    auto full = clouds[0].get_vertices();
+    auto xyz16 = reinterpret_cast<const uint16_t*>(clouds[1].get_vertices());
+    auto xyz16f = reinterpret_cast<const uint16_t*>(clouds[2].get_vertices());
+    REQUIRE(clouds[1].size() == W * H);
+    REQUIRE(clouds[2].size() == W * H);
+    for (int i = 0; i < W * H; i++)
+    {
+        // XYZ16 holds the depth value itself as Z, and X and Y rounded to depth units
+        REQUIRE(xyz16[i * 3 + 2] == pixels[i]);
+        REQUIRE(std::abs(static_cast<int16_t>(xyz16[i * 3]) * units - full[i].x) <= units / 2 + 1e-6f);
+        REQUIRE(std::abs(static_cast<int16_t>(xyz16[i * 3 + 1]) * units - full[i].y) <= units / 2 + 1e-6f);
+
+        // Half precision keeps 11 significant bits
+        REQUIRE(std::abs(half_to_float(xyz16f[i * 3]) - full[i].x) <= std::abs(full[i].x) / 2048);
+        REQUIRE(std::abs(half_to_float(xyz16f[i * 3 + 1]) - full[i].y) <= std::abs(full[i].y) / 2048);
+        REQUIRE(std::abs(half_to_float(xyz16f[i * 3 + 2]) - full[i].z) <= std::abs(full[i].z) / 2048);
+    }
+}
+
+#ifdef RS2_TEST_KERNELS
+#include "../src/proc/synthetic-stream.h"
+#include "../src/proc/pointcloud.h"
+#ifdef __F16C__
+#include <immintrin.h>
+#endif
+
+TEST_CASE("Half precision vertices round as F16C does", "[software-device][post-processing]") {
+    auto half = [](uint32_t bits) {
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        return librealsense::float_to_half(value);
+    };
+    REQUIRE(half(0x3f800000) == 0x3c00);    // 1
+    REQUIRE(half(0x477fe000) == 0x7bff);    // 65504, the largest half
+    REQUIRE(half(0x477ff000) == 0x7c00);    // 65520 rounds to infinity
+    REQUIRE(half(0x33800000) == 0x0001);    // 2^-24, the smallest subnormal
+    REQUIRE(half(0x33000000) == 0x0000);    // 2^-25 ties to even
+    REQUIRE(half(0x33c00000) == 0x0002);    // 3 * 2^-25 ties to even
+    REQUIRE(half(0x80000000) == 0x8000);    // -0
+    REQUIRE(half(0xff800000) == 0xfc00);    // -infinity
+
+    // NaNs keep their sign and the upper bits of their payload, and are quieted
+    REQUIRE(half(0x7fc00000) == 0x7e00);
+    REQUIRE(half(0x7f800001) == 0x7e00);
+    REQUIRE(half(0x7fa00000) == 0x7f00);
+    REQUIRE(half(0xffbfe000) == 0xffff);
+
+#ifdef __F16C__
+    for (uint64_t bits = 0; bits < (1ull << 32); bits += 4099)
+    {
+        float value;
+        auto b = static_cast<uint32_t>(bits);
+        memcpy(&value, &b, sizeof(value));
+        CAPTURE(b);
+        REQUIRE(librealsense::float_to_half(value) == _cvtss_sh(value, 0));
+    }
+#endif
+}
+#endif
+
+TEST_CASE("Pointcloud exports to PLY with normals and faces", "[software-device][pointcloud]") {
+    const int W = 64;
+    const int H = 48;
+    const int BPP = 2;
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+    s.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+
+    rs2_intrinsics intrinsics{ W, H, W / 2.f, H / 2.f, 50, 50, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+
+    // A plane a meter away, with a hole of 4x4 pixels
+    std::vector<uint16_t> pixels(W * H, 1000);
+    for (int y = 10; y < 14; y++)
+        for (int x = 20; x < 24; x++)
+            pixels[y * W + x] = 0;
+    const size_t valid = W * H - 16;
+
+    rs2::pointcloud pc;
+    frame_queue q;
+    s.open(depth);
+    s.start(q);
+
+    std::vector<rs2::points> clouds;
+    for (int mode = 0; mode < 3; mode++)
+    {
+        pc.set_option(RS2_OPTION_COMPACT_POINTS, static_cast<float>(mode));
+        s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, mode, depth });
+        clouds.push_back(pc.calculate(q.wait_for_frame()));
+    }
+    s.stop();
+    s.close();
+
+    auto read = [](const std::string& name) {
+        std::ifstream in(name, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    };
+    auto element = [](const std::string& ply, const std::string& name) {
+        auto pos = ply.find("element " + name + " ");
+        return pos == std::string::npos ? -1 : std::atoi(ply.c_str() + pos + name.size() + 9);
+    };
+
+    // Two triangles for each 2x2 pixels, but for those of the hole. Two corners of it keep the triangle not missing a pixel
+    const int faces = 2 * ((W - 1) * (H - 1) - 5 * 5) + 2;
+
+    clouds[0].export_to_ply("full.ply", video_frame(frame()), true, true);
+    auto full = read("full.ply");
+    REQUIRE(element(full, "vertex") == valid);
+    REQUIRE(element(full, "face") == faces);
+    auto body = full.find("end_header\n") + 11;
+    REQUIRE(full.size() - body == valid * 6 * sizeof(float) + faces * (1 + 3 * sizeof(int32_t)));
+
+    // The plane faces the camera
+    float normal[3];
+    memcpy(normal, full.data() + body + 3 * sizeof(float), sizeof(normal));
+    REQUIRE(std::abs(normal[0]) < 1e-5f);
+    REQUIRE(std::abs(normal[1]) < 1e-5f);
+    REQUIRE(normal[2] == Approx(-1));
+
+    // Pixel indices stand for the invalid points left out
+    clouds[2].export_to_ply("indexed.ply", video_frame(frame()), true, true);
+    REQUIRE(read("indexed.ply") == full);
+    REQUIRE_THROWS(clouds[1].export_to_ply("compact.ply", video_frame(frame()), true, false));
+
+    // Without them the file is the same as before
+    clouds[0].export_to_ply("points.ply", video_frame(frame()));
+    auto points = read("points.ply");
+    REQUIRE(element(points, "vertex") == valid);
+    REQUIRE(element(points, "face") == -1);
+    REQUIRE(points.size() - (points.find("end_header\n") + 11) == valid * 3 * sizeof(float));
+}
+
+TEST_CASE("Voxel filter downsamples points and depth", "[software-device][pointcloud]") {
+    const int W = 64;
+    const int H = 48;
+    const int BPP = 2;
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+    s.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+
+    rs2_intrinsics intrinsics{ W, H, W / 2.f, H / 2.f, 50, 50, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+
+    // A plane a meter away, every other pixel of it with depth
+    std::vector<uint16_t> pixels(W * H, 0);
+    for (int i = 0; i < W * H; i += 2)
+        pixels[i] = 1000;
+
+    rs2::pointcloud pc;
+    pc.set_option(RS2_OPTION_COMPACT_POINTS, 1);
+    rs2::voxel_filter voxels(0.1f);
+    REQUIRE(voxels.get_option(RS2_OPTION_VOXEL_SIZE) == Approx(0.1f));
+    REQUIRE(voxels.get_option(RS2_OPTION_VOXEL_POINT) == 0);
+
+    frame_queue q;
+    s.open(depth);
+    s.start(q);
+    s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 0, depth });
+    auto f = q.wait_for_frame();
+    s.stop();
+    s.close();
+
+    auto cloud = pc.calculate(f);
+    REQUIRE(cloud.size() == W * H / 2);
+
+    // The plane spans 14x10 voxels of 10cm
+    auto from_points = voxels.calculate(cloud);
+    auto from_depth = voxels.calculate(f);
+    REQUIRE(from_points.get_profile().format() == RS2_FORMAT_XYZ32F);
+    REQUIRE(from_points.size() == 14 * 10);
+    REQUIRE(from_depth.size() == from_points.size());
+    for (size_t i = 0; i < from_points.size(); i++)
+    {
+        REQUIRE(from_depth.get_vertices()[i].x == Approx(from_points.get_vertices()[i].x));
+        REQUIRE(from_depth.get_vertices()[i].y == Approx(from_points.get_vertices()[i].y));
+        REQUIRE(from_points.get_vertices()[i].z == Approx(1));
+    }
+
+    // The first point of the first voxel is the first of the cloud
+    voxels.set_option(RS2_OPTION_VOXEL_POINT, 1);
+    auto first_hits = voxels.calculate(cloud);
+    REQUIRE(first_hits.size() == 14 * 10);
+    REQUIRE(first_hits.get_vertices()[0].x == cloud.get_vertices()[0].x);
+    REQUIRE(first_hits.get_vertices()[0].y == cloud.get_vertices()[0].y);
+    REQUIRE(voxels.calculate(f).get_vertices()[0].x == Approx(cloud.get_vertices()[0].x));
+}
+
+TEST_CASE("Normals of the points face the camera", "[software-device][pointcloud]") {
+    const int W = 64;
+    const int H = 48;
+    const int BPP = 2;
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+    s.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+
+    rs2_intrinsics intrinsics{ W, H, W / 2.f, H / 2.f, 50, 50, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+
+    // A plane a meter away, with a hole of 4x4 pixels
+    std::vector<uint16_t> pixels(W * H, 1000);
+    for (int y = 10; y < 14; y++)
+        for (int x = 20; x < 24; x++)
+            pixels[y * W + x] = 0;
+
+    frame_queue q;
+    s.open(depth);
+    s.start(q);
+    s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 0, depth });
+    auto f = q.wait_for_frame();
+    s.stop();
+    s.close();
+
+    rs2::pointcloud pc;
+    REQUIRE(pc.get_option(RS2_OPTION_NORMALS_WINDOW) == 0);
+    auto cloud = pc.calculate(f);
+    REQUIRE(cloud.get_normals() == nullptr);
+
+    rs2::normals_filter normals(2);
+    auto map = normals.calculate(cloud);
+    REQUIRE(map);
+    REQUIRE(map.get_profile().format() == RS2_FORMAT_XYZ32F);
+    REQUIRE(map.get_width() == W);
+    REQUIRE(map.get_height() == H);
+    auto map_normals = reinterpret_cast<const rs2::vertex*>(map.get_data());
+    for (int i = 0; i < W * H; i++)
+    {
+        if (!pixels[i])
+        {
+            REQUIRE(map_normals[i].z == 0);
+            continue;
+        }
+        REQUIRE(std::abs(map_normals[i].x) < 1e-5f);
+        REQUIRE(std::abs(map_normals[i].y) < 1e-5f);
+        REQUIRE(map_normals[i].z == Approx(-1));
+    }
+
+    // The point cloud computes the same normals, of the valid points alone when compacted
+    pc.set_option(RS2_OPTION_NORMALS_WINDOW, 2);
+    pc.set_option(RS2_OPTION_COMPACT_POINTS, 2);
+    auto compact = pc.calculate(f);
+    REQUIRE(compact.size() == W * H - 16);
+    REQUIRE(compact.get_normals() != nullptr);
+    REQUIRE(compact.get_pixel_indices() != nullptr);
+    for (size_t i = 0; i < compact.size(); i++)
+    {
+        auto pixel = compact.get_pixel_indices()[i];
+        REQUIRE(compact.get_vertices()[i].z == cloud.get_vertices()[pixel].z);
+        REQUIRE(compact.get_normals()[i].x == map_normals[pixel].x);
+        REQUIRE(compact.get_normals()[i].y == map_normals[pixel].y);
+        REQUIRE(compact.get_normals()[i].z == map_normals[pixel].z);
+    }
+}
+
+TEST_CASE("Pointcloud merger transforms the cameras to the world", "[software-device][pointcloud]") {
+    const int W = 64;
+    const int H = 48;
+    const int BPP = 2;
+    rs2_intrinsics intrinsics{ W, H, W / 2.f, H / 2.f, 50, 50, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+
+    // Two cameras of a plane a meter away, the second with half its pixels without depth
+    std::vector<uint16_t> pixels(W * H, 1000);
+    std::vector<uint16_t> half(W * H, 0);
+    for (int i = 0; i < W * H; i += 2)
+        half[i] = 1000;
+
+    software_device dev0, dev1;
+    auto s0 = dev0.add_sensor("software_sensor");
+    auto s1 = dev1.add_sensor("software_sensor");
+    s0.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+    s1.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+    auto depth0 = s0.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+    auto depth1 = s1.add_video_stream({ RS2_STREAM_DEPTH, 0, 1, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+
+    frame_queue q0, q1;
+    s0.open(depth0);
+    s1.open(depth1);
+    s0.start(q0);
+    s1.start(q1);
+    s0.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 0, depth0 });
+    s1.on_video_frame({ half.data(), [](void*) {}, W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 0, depth1 });
+    auto f0 = q0.wait_for_frame();
+    auto f1 = q1.wait_for_frame();
+    s0.stop();
+    s1.stop();
+    s0.close();
+    s1.close();
+
+    rs2::frame_queue sets;
+    rs2::processing_block bundle([&](rs2::frame, rs2::frame_source& source)
+    {
+        source.frame_ready(source.allocate_composite_frame({ f0, f1 }));
+    });
+    bundle.start(sets);
+    bundle.invoke(f0);
+    auto set = sets.wait_for_frame();
+    REQUIRE(set.as<rs2::frameset>().size() == 2);
+
+    rs2::pointcloud_merger merger;
+    REQUIRE(merger.get_option(RS2_OPTION_COMPACT_POINTS) == 1);
+    REQUIRE(merger.get_option(RS2_OPTION_VOXEL_SIZE) == 0);
+    REQUIRE_THROWS(merger.calculate(set));
+
+    // The first camera at the origin of the world, the second a meter to its right
+    rs2_extrinsics identity{ { 1,0,0, 0,1,0, 0,0,1 },{ 0,0,0 } };
+    rs2_extrinsics right{ { 1,0,0, 0,1,0, 0,0,1 },{ 1,0,0 } };
+    merger.set_world_extrinsics(depth0, identity);
+    merger.set_world_extrinsics(depth1, right);
+
+    rs2::pointcloud pc;
+    auto cloud = pc.calculate(f0);
+    auto merged = merger.calculate(set);
+    REQUIRE(merged.get_profile().format() == RS2_FORMAT_XYZ32F);
+    REQUIRE(merged.size() == W * H + W * H / 2);
+    for (int i = 0; i < W * H; i++)
+    {
+        REQUIRE(merged.get_vertices()[i].x == Approx(cloud.get_vertices()[i].x));
+        REQUIRE(merged.get_vertices()[i].y == Approx(cloud.get_vertices()[i].y));
+        REQUIRE(merged.get_vertices()[i].z == Approx(1));
+    }
+    for (int i = 0; i < W * H / 2; i++)
+    {
+        REQUIRE(merged.get_vertices()[W * H + i].x == Approx(cloud.get_vertices()[2 * i].x + 1));
+        REQUIRE(merged.get_vertices()[W * H + i].z == Approx(1));
+    }
+
+    // Not compacted, the pixels without depth are at the origin
+    merger.set_option(RS2_OPTION_COMPACT_POINTS, 0);
+    auto full = merger.calculate(set);
+    REQUIRE(full.size() == 2 * W * H);
+    REQUIRE(full.get_vertices()[W * H + 1].x == 0);
+    REQUIRE(full.get_vertices()[W * H + 1].z == 0);
+
+    // Moved onto the first, the second camera adds no voxel of its own
+    merger.set_world_extrinsics(depth1, identity);
+    merger.set_option(RS2_OPTION_COMPACT_POINTS, 1);
+    merger.set_option(RS2_OPTION_VOXEL_SIZE, 0.1f);
+    rs2::voxel_filter voxels(0.1f);
+    REQUIRE(merger.calculate(set).size() == voxels.calculate(f0).size());
+}
+
+TEST_CASE("Colored point cloud is computed in the color frame from the raw depth", "[software-device][pointcloud]") {
+    const int W = 64;
+    const int H = 48;
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+    s.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+
+    rs2_intrinsics depth_intrinsics{ W, H, W / 2.f, H / 2.f, 50, 50, RS2_DISTORTION_NONE,{ 0,0,0,0,0 } };
+    rs2_intrinsics color_intrinsics{ W, H, W / 2.f + 1.5f, H / 2.f - 0.5f, 55, 55, RS2_DISTORTION_MODIFIED_BROWN_CONRADY,{ 0.1f, -0.05f, 0.001f, 0.001f, 0 } };
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 30, 2, RS2_FORMAT_Z16, depth_intrinsics });
+    auto color = s.add_video_stream({ RS2_STREAM_COLOR, 0, 1, W, H, 30, 3, RS2_FORMAT_RGB8, color_intrinsics });
+    rs2_extrinsics depth_to_color{ { 1,0,0,0,1,0,0,0,1 },{ 0.015f,0.001f,0 } };
+    depth.register_extrinsics_to(color, depth_to_color);
+
+    // A slope with holes, and a color of every pixel of its own
+    std::vector<uint16_t> depth_pixels(W * H);
+    std::vector<uint8_t> color_pixels(W * H * 3);
+    for (int i = 0; i < W * H; i++)
+    {
+        depth_pixels[i] = i % 7 == 3 ? 0 : static_cast<uint16_t>(300 + (i % W) * 10);
+        color_pixels[i * 3] = static_cast<uint8_t>(i);
+        color_pixels[i * 3 + 1] = static_cast<uint8_t>(i >> 8);
+        color_pixels[i * 3 + 2] = static_cast<uint8_t>(i * 3);
+    }
+
+    syncer sync;
+    s.open({ depth, color });
+    s.start(sync);
+    s.on_video_frame({ depth_pixels.data(), [](void*) {}, W * 2, 2, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 0, depth });
+    s.on_video_frame({ color_pixels.data(), [](void*) {}, W * 3, 3, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 0, color });
+    auto frames = sync.wait_for_frames();
+    s.stop();
+    s.close();
+    REQUIRE(frames.size() == 2);
+
+    for (auto threads : { 1, 4 })
+    {
+        CAPTURE(threads);
+        rs2::colored_pointcloud pc;
+        pc.set_option(RS2_OPTION_PROCESSING_THREADS, std::min<float>(float(threads), pc.get_option_range(RS2_OPTION_PROCESSING_THREADS).max));
+        auto cloud = pc.calculate(frames);
+        REQUIRE(cloud);
+        REQUIRE(cloud.get_profile().format() == RS2_FORMAT_XYZ32F);
+        REQUIRE(cloud.size() == W * H);
+        REQUIRE(cloud.get_colors() != nullptr);
+
+        // The same as deprojecting the depth, transforming it to the color camera and projecting it onto the color image
+        int colored = 0;
+        for (int i = 0; i < W * H; i++)
+        {
+            auto vertex = cloud.get_vertices()[i];
+            auto rgb = cloud.get_colors() + i * 3;
+            if (!depth_pixels[i])
+            {
+                REQUIRE(vertex.z == 0);
+                REQUIRE((rgb[0] | rgb[1] | rgb[2]) == 0);
+                continue;
+            }
+            const float pixel[] = { float(i % W), float(i / W) };
+            float point[3], color_point[3], color_pixel[2];
+            rs2_deproject_pixel_to_point(point, &depth_intrinsics, pixel, depth_pixels[i] * 0.001f);
+            rs2_transform_point_to_point(color_point, &depth_to_color, point);
+            rs2_project_point_to_pixel(color_pixel, &color_intrinsics, color_point);
+            REQUIRE(vertex.x == color_point[0]);
+            REQUIRE(vertex.y == color_point[1]);
+            REQUIRE(vertex.z == color_point[2]);
+            REQUIRE(cloud.get_texture_coordinates()[i].u == color_pixel[0] / W);
+            REQUIRE(cloud.get_texture_coordinates()[i].v == color_pixel[1] / H);
+
+            auto x = int(color_pixel[0] + 0.5f), y = int(color_pixel[1] + 0.5f);
+            if (color_pixel[0] + 0.5f < 0 || color_pixel[1] + 0.5f < 0 || x >= W || y >= H)
+            {
+                REQUIRE((rgb[0] | rgb[1] | rgb[2]) == 0);
+                continue;
+            }
+            auto texel = color_pixels.data() + (y * W + x) * 3;
+            REQUIRE(rgb[0] == texel[0]);
+            REQUIRE(rgb[1] == texel[1]);
+            REQUIRE(rgb[2] == texel[2]);
+            ++colored;
+        }
+        REQUIRE(colored > W * H / 2);
+    }
+
+    // A frame alone is left as it is
+    rs2::colored_pointcloud pc;
+    auto single = pc.process(frames.get_depth_frame());
+    REQUIRE(single.get_profile().format() == RS2_FORMAT_Z16);
+}
+
+TEST_CASE("Untextured point clouds hold their vertices alone", "[software-device][pointcloud]") {
+    const int W = 64;
+    const int H = 48;
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+    s.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+
+    rs2_intrinsics depth_intrinsics{ W, H, W / 2.f, H / 2.f, 50, 50, RS2_DISTORTION_NONE,{ 0,0,0,0,0 } };
+    rs2_intrinsics color_intrinsics{ W, H, W / 2.f + 1.5f, H / 2.f - 0.5f, 55, 55, RS2_DISTORTION_MODIFIED_BROWN_CONRADY,{ 0.1f, -0.05f, 0.001f, 0.001f, 0 } };
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 30, 2, RS2_FORMAT_Z16, depth_intrinsics });
+    auto color = s.add_video_stream({ RS2_STREAM_COLOR, 0, 1, W, H, 30, 3, RS2_FORMAT_RGB8, color_intrinsics });
+    rs2_extrinsics depth_to_color{ { 1,0,0,0,1,0,0,0,1 },{ 0.015f,0.001f,0 } };
+    depth.register_extrinsics_to(color, depth_to_color);
+
+    std::vector<uint16_t> depth_pixels(W * H);
+    std::vector<uint8_t> color_pixels(W * H * 3, 0);
+    for (int i = 0; i < W * H; i++)
+        depth_pixels[i] = i % 7 == 3 ? 0 : static_cast<uint16_t>(300 + (i % W) * 10);
+
+    syncer sync;
+    s.open({ depth, color });
+    s.start(sync);
+    s.on_video_frame({ depth_pixels.data(), [](void*) {}, W * 2, 2, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 0, depth });
+    s.on_video_frame({ color_pixels.data(), [](void*) {}, W * 3, 3, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 0, color });
+    auto frames = sync.wait_for_frames();
+    s.stop();
+    s.close();
+    REQUIRE(frames.size() == 2);
+    // Texture coordinates laid out in the frame follow its vertices
+    auto laid_out = [](const rs2::points& p) { return (const void*)(p.get_vertices() + p.size()) == (const void*)p.get_texture_coordinates(); };
+
+    // Without a texture, the vertices alone, and texture coordinates of zero when they are read anyway
+    rs2::pointcloud pc;
+    auto cloud = pc.calculate(frames.get_depth_frame());
+    REQUIRE(cloud.size() == W * H);
+    REQUIRE_FALSE(laid_out(cloud));
+    for (int i = 0; i < W * H; i++)
+    {
+        REQUIRE(cloud.get_texture_coordinates()[i].u == 0);
+        REQUIRE(cloud.get_texture_coordinates()[i].v == 0);
+    }
+
+    // Compacted, the same
+    pc.set_option(RS2_OPTION_COMPACT_POINTS, 1);
+    auto compact = pc.calculate(frames.get_depth_frame());
+    REQUIRE_FALSE(laid_out(compact));
+    pc.set_option(RS2_OPTION_COMPACT_POINTS, 0);
+
+    // Mapped to the color, the texture coordinates are computed as they are read
+    pc.map_to(frames.get_color_frame());
+    auto textured = pc.calculate(frames.get_depth_frame());
+    REQUIRE(textured.size() == W * H);
+    REQUIRE(laid_out(textured));
+    auto vertices = textured.get_vertices();
+    auto tex = textured.get_texture_coordinates();
+    for (int i = 0; i < W * H; i++)
+    {
+        if (!depth_pixels[i])
+        {
+            REQUIRE(tex[i].u == 0);
+            REQUIRE(tex[i].v == 0);
+            continue;
+        }
+        float color_point[3], color_pixel[2];
+        rs2_transform_point_to_point(color_point, &depth_to_color, &vertices[i].x);
+        rs2_project_point_to_pixel(color_pixel, &color_intrinsics, color_point);
+        REQUIRE(tex[i].u == color_pixel[0] / W);
+        REQUIRE(tex[i].v == color_pixel[1] / H);
+    }
+}
+
+TEST_CASE("Planar point clouds hold the same vertices in planes", "[software-device][pointcloud]") {
+    const int W = 64;
+    const int H = 48;
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+    s.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+
+    rs2_intrinsics depth_intrinsics{ W, H, W / 2.f, H / 2.f, 50, 50, RS2_DISTORTION_NONE,{ 0,0,0,0,0 } };
+    rs2_intrinsics color_intrinsics{ W, H, W / 2.f + 1.5f, H / 2.f - 0.5f, 55, 55, RS2_DISTORTION_MODIFIED_BROWN_CONRADY,{ 0.1f, -0.05f, 0.001f, 0.001f, 0 } };
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 30, 2, RS2_FORMAT_Z16, depth_intrinsics });
+    auto color = s.add_video_stream({ RS2_STREAM_COLOR, 0, 1, W, H, 30, 3, RS2_FORMAT_RGB8, color_intrinsics });
+    rs2_extrinsics depth_to_color{ { 1,0,0,0,1,0,0,0,1 },{ 0.015f,0.001f,0 } };
+    depth.register_extrinsics_to(color, depth_to_color);
+
+    std::vector<uint16_t> depth_pixels(W * H);
+    std::vector<uint8_t> color_pixels(W * H * 3, 0);
+    for (int i = 0; i < W * H; i++)
+        depth_pixels[i] = i % 7 == 3 ? 0 : static_cast<uint16_t>(300 + (i % W) * 10);
+
+    syncer sync;
+    s.open({ depth, color });
+    s.start(sync);
+    s.on_video_frame({ depth_pixels.data(), [](void*) {}, W * 2, 2, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 0, depth });
+    s.on_video_frame({ color_pixels.data(), [](void*) {}, W * 3, 3, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 0, color });
+    auto frames = sync.wait_for_frames();
+    s.stop();
+    s.close();
+    REQUIRE(frames.size() == 2);
+
+    for (auto compact : { 0, 1 })
+    {
+        CAPTURE(compact);
+        rs2::pointcloud interleaved, planar;
+        interleaved.set_option(RS2_OPTION_COMPACT_POINTS, float(compact));
+        planar.set_option(RS2_OPTION_COMPACT_POINTS, float(compact));
+        planar.set_option(RS2_OPTION_POINTS_LAYOUT, 1);
+        interleaved.map_to(frames.get_color_frame());
+        planar.map_to(frames.get_color_frame());
+
+        auto expected = interleaved.calculate(frames.get_depth_frame());
+        auto cloud = planar.calculate(frames.get_depth_frame());
+        REQUIRE_FALSE(expected.is_planar());
+        REQUIRE(cloud.is_planar());
+        REQUIRE(cloud.size() == expected.size());
+        REQUIRE_THROWS(cloud.get_vertices());
+
+        auto x = cloud.get_vertex_plane(0), y = cloud.get_vertex_plane(1), z = cloud.get_vertex_plane(2);
+        auto vertices = expected.get_vertices();
+        for (size_t i = 0; i < cloud.size(); i++)
+        {
+            REQUIRE(x[i] == vertices[i].x);
+            REQUIRE(y[i] == vertices[i].y);
+            REQUIRE(z[i] == vertices[i].z);
+            REQUIRE(cloud.get_texture_coordinates()[i].u == Approx(expected.get_texture_coordinates()[i].u));
+            REQUIRE(cloud.get_texture_coordinates()[i].v == Approx(expected.get_texture_coordinates()[i].v));
+        }
+    }
+
+    // The 16-bit formats stay interleaved
+    rs2::pointcloud pc;
+    pc.set_option(RS2_OPTION_POINTS_LAYOUT, 1);
+    pc.set_option(RS2_OPTION_POINTS_FORMAT, 1);
+    REQUIRE_FALSE(pc.calculate(frames.get_depth_frame()).is_planar());
+}
+
+TEST_CASE("Options are set and queried in a batch, every item on its own", "[options]") {
+    rs2::decimation_filter dec;
+
+    // Out of its range, and of an option the block does not have
+    auto statuses = dec.set_options({ { RS2_OPTION_FILTER_MAGNITUDE, 4.f },
+                                      { RS2_OPTION_DEPTH_STATISTICS, 1.f },
+                                      { RS2_OPTION_PROCESSING_THREADS, 1000.f },
+                                      { RS2_OPTION_HOLES_FILL, 1.f } });
+    REQUIRE(statuses == std::vector<bool>({ true, true, false, false }));
+
+    std::vector<bool> read;
+    auto values = dec.get_options({ RS2_OPTION_FILTER_MAGNITUDE, RS2_OPTION_HOLES_FILL, RS2_OPTION_DEPTH_STATISTICS }, &read);
+    REQUIRE(read == std::vector<bool>({ true, false, true }));
+    REQUIRE(values == std::vector<float>({ 4.f, 0.f, 1.f }));
+    REQUIRE(dec.get_option(RS2_OPTION_PROCESSING_THREADS) == 1.f);
+
+    // Through the C API, without statuses
+    rs2_option ids[] = { RS2_OPTION_FILTER_MAGNITUDE, RS2_OPTION_HOLES_FILL };
+    float vals[] = { 2.f, 1.f };
+    rs2_error* e = nullptr;
+    REQUIRE(rs2_set_options((rs2_options*)dec.get(), ids, vals, 2, nullptr, &e) == 1);
+    REQUIRE(e == nullptr);
+    REQUIRE(dec.get_option(RS2_OPTION_FILTER_MAGNITUDE) == 2.f);
+    REQUIRE(rs2_set_options((rs2_options*)dec.get(), ids, vals, 0, nullptr, &e) == 0);
+    REQUIRE(e == nullptr);
+    REQUIRE(rs2_set_options((rs2_options*)dec.get(), nullptr, vals, 2, nullptr, &e) == 0);
+    REQUIRE(e != nullptr);
+    rs2_free_error(e);
+}
+
+TEST_CASE("Depth is aligned to a reduced resolution of the other stream", "[software-device][align]") {
+    const int W = 64;
+    const int H = 48;
+    const int CW = 96;
+    const int CH = 72;
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+    s.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+
+    // A plane a meter away, seen by a narrower color camera at the same place
+    rs2_intrinsics depth_intrinsics{ W, H, W / 2.f, H / 2.f, 50, 50, RS2_DISTORTION_NONE,{ 0,0,0,0,0 } };
+    rs2_intrinsics color_intrinsics{ CW, CH, CW / 2.f - 0.5f, CH / 2.f + 0.5f, 100, 100, RS2_DISTORTION_NONE,{ 0,0,0,0,0 } };
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 30, 2, RS2_FORMAT_Z16, depth_intrinsics });
+    auto color = s.add_video_stream({ RS2_STREAM_COLOR, 0, 1, CW, CH, 30, 3, RS2_FORMAT_RGB8, color_intrinsics });
+    depth.register_extrinsics_to(color, { { 1,0,0,0,1,0,0,0,1 },{ 0,0,0 } });
+
+    std::vector<uint16_t> depth_pixels(W * H, 1000);
+    std::vector<uint8_t> color_pixels(CW * CH * 3, 0x80);
+
+    syncer sync;
+    s.open({ depth, color });
+    s.start(sync);
+    s.on_video_frame({ depth_pixels.data(), [](void*) {}, W * 2, 2, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 0, depth });
+    s.on_video_frame({ color_pixels.data(), [](void*) {}, CW * 3, 3, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 0, color });
+    auto frames = sync.wait_for_frames();
+    s.stop();
+    s.close();
+    REQUIRE(frames.size() == 2);
+
+    rs2::align align(RS2_STREAM_COLOR, 1.f / 3);
+    auto aligned = align.process(frames);
+    auto aligned_depth = aligned.get_depth_frame();
+    REQUIRE(aligned_depth.get_width() == CW / 3);
+    REQUIRE(aligned_depth.get_height() == CH / 3);
+
+    // Of the same field of view as the color image
+    auto intrinsics = aligned_depth.get_profile().as<rs2::video_stream_profile>().get_intrinsics();
+    REQUIRE(intrinsics.width == CW / 3);
+    REQUIRE(intrinsics.height == CH / 3);
+    REQUIRE(intrinsics.fx == Approx(color_intrinsics.fx / 3));
+    REQUIRE(intrinsics.ppx == Approx((color_intrinsics.ppx + 0.5f) / 3 - 0.5f));
+    REQUIRE(intrinsics.ppy == Approx((color_intrinsics.ppy + 0.5f) / 3 - 0.5f));
+
+    // The color frame itself is left at its resolution
+    REQUIRE(aligned.get_color_frame().get_width() == CW);
+
+    // Covered by the plane, the depth pixels being finer than the aligned ones
+    auto data = reinterpret_cast<const uint16_t*>(aligned_depth.get_data());
+    for (int y = 1; y < aligned_depth.get_height() - 1; y++)
+        for (int x = 1; x < aligned_depth.get_width() - 1; x++)
+            REQUIRE(data[y * aligned_depth.get_width() + x] == 1000);
+
+    // Aligning to the depth has no target scale
+    rs2::align to_depth(RS2_STREAM_DEPTH);
+    REQUIRE_FALSE(to_depth.supports(RS2_OPTION_TARGET_SCALE));
+}
+
+TEST_CASE("TSDF fusion reconstructs the surface of the depth", "[software-device][pointcloud]") {
+    const int W = 64;
+    const int H = 48;
+    const int BPP = 2;
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+    s.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+
+    rs2_intrinsics intrinsics{ W, H, W / 2.f, H / 2.f, 50, 50, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+
+    // A plane a meter away
+    std::vector<uint16_t> pixels(W * H, 1000);
+
+    frame_queue q;
+    s.open(depth);
+    s.start(q);
+    s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 0, depth });
+    auto f = q.wait_for_frame();
+    s.stop();
+    s.close();
+
+    rs2::tsdf_fusion fusion;
+    REQUIRE(fusion.get_option(RS2_OPTION_VOXEL_SIZE) == Approx(0.01f));
+    REQUIRE(fusion.get_option(RS2_OPTION_TSDF_TRUNCATION) == Approx(0.04f));
+    REQUIRE(fusion.get_option(RS2_OPTION_TSDF_MAX_WEIGHT) == 64);
+    REQUIRE_THROWS(fusion.extract_points());
+
+    // The frames pass through
+    rs2_extrinsics identity{ { 1,0,0, 0,1,0, 0,0,1 },{ 0,0,0 } };
+    for (int i = 0; i < 3; i++)
+        REQUIRE(fusion.process(f).get() == f.get());
+
+    auto view = fusion.raycast(intrinsics, identity);
+    REQUIRE(view.size() == W * H);
+    REQUIRE(view.get_normals() != nullptr);
+    for (int i = 0; i < W * H; i++)
+    {
+        REQUIRE(view.get_vertices()[i].z == Approx(1).epsilon(0.01));
+        REQUIRE(view.get_normals()[i].z == Approx(-1).epsilon(0.01));
+    }
+
+    // A voxel of 1cm every 1cm of the plane
+    auto surface = fusion.extract_points();
+    REQUIRE(surface.size() == 128 * 96);
+    for (size_t i = 0; i < surface.size(); i++)
+        REQUIRE(surface.get_vertices()[i].z == Approx(1));
+
+    // Seen from 10cm to the right, the plane is seen where the camera saw it
+    auto right = identity;
+    right.translation[0] = 0.1f;
+    auto moved = fusion.raycast(intrinsics, right);
+    REQUIRE(moved.get_vertices()[H / 2 * W + W / 2].z == Approx(1).epsilon(0.01));
+    REQUIRE(moved.get_vertices()[H / 2 * W + W - 1].z == 0);
+
+    // Integrated from there, the plane grows to its right
+    fusion.set_camera_pose(right);
+    fusion.process(f);
+    REQUIRE(fusion.extract_points().size() == 138 * 96);
+
+    fusion.reset();
+    REQUIRE(fusion.extract_points().size() == 0);
+}
+
+TEST_CASE("Depth statistics are attached to the frames as metadata", "[software-device][post-processing-filters]") {
+    const int W = 64;
+    const int H = 48;
+    const int BPP = 2;
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+    s.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+
+    rs2_intrinsics intrinsics{ W, H, W / 2.f, H / 2.f, 50, 50, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+
+    // A quarter of the rows without depth, a quarter at 1.2m and the rest at 3.2m
+    std::vector<uint16_t> pixels(W * H);
+    for (int y = 0; y < H; y++)
+        for (int x = 0; x < W; x++)
+            pixels[y * W + x] = y < H / 4 ? 0 : y < H / 2 ? 1200 : 3200;
+
+    frame_queue q;
+    s.open(depth);
+    s.start(q);
+    s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 0, depth });
+    auto f = q.wait_for_frame();
+    s.stop();
+    s.close();
+    REQUIRE_FALSE(f.supports_frame_metadata(RS2_FRAME_METADATA_DEPTH_MIN));
+
+    // Bins of 50cm, the depth at 1.2m in the third and the one at 3.2m in the seventh
+    auto require_statistics = [](const rs2::frame& frame)
+    {
+        REQUIRE(frame.supports_frame_metadata(RS2_FRAME_METADATA_DEPTH_MIN));
+        REQUIRE(frame.get_frame_metadata(RS2_FRAME_METADATA_DEPTH_MIN) == 1200);
+        REQUIRE(frame.get_frame_metadata(RS2_FRAME_METADATA_DEPTH_MAX) == 3200);
+        REQUIRE(frame.get_frame_metadata(RS2_FRAME_METADATA_DEPTH_MEAN) == 2533);
+        REQUIRE(frame.get_frame_metadata(RS2_FRAME_METADATA_DEPTH_FILL_RATE) == 7500);
+        auto histogram = uint64_t(frame.get_frame_metadata(RS2_FRAME_METADATA_DEPTH_HISTOGRAM));
+        REQUIRE(histogram == ((uint64_t(85) << 16) | (uint64_t(170) << 48)));
+    };
+
+    rs2::depth_statistics stats(4.f);
+    auto with_stats = stats.process(f);
+    require_statistics(with_stats);
+    REQUIRE(memcmp(with_stats.get_data(), pixels.data(), W * H * BPP) == 0);
+
+    // Decimated, the statistics are of the decimated depth, when asked for
+    rs2::decimation_filter decimation(2);
+    REQUIRE_FALSE(decimation.process(f).supports_frame_metadata(RS2_FRAME_METADATA_DEPTH_MIN));
+    decimation.set_option(RS2_OPTION_DEPTH_STATISTICS, 1);
+    decimation.set_option(RS2_OPTION_DEPTH_HISTOGRAM_RANGE, 4.f);
+    for (int threads : { 1, 2 })
+    {
+        decimation.set_option(RS2_OPTION_PROCESSING_THREADS, float(std::min<int>(threads, decimation.get_option_range(RS2_OPTION_PROCESSING_THREADS).max)));
+        auto decimated = decimation.process(f);
+        REQUIRE(decimated.as<video_frame>().get_width() == W / 2);
+        require_statistics(decimated);
+    }
+
+    // Filtered further, the depth is no longer that of the statistics
+    rs2::hole_filling_filter holes;
+    REQUIRE_FALSE(holes.process(with_stats).supports_frame_metadata(RS2_FRAME_METADATA_DEPTH_MIN));
+}
+
+TEST_CASE("Frames of low priority streams are dropped first", "[software-device]") {
+    const int W = 64;
+    const int H = 48;
+    const int BPP = 2;
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+
+    rs2_intrinsics intrinsics{ W, H, 0, 0, 0, 0, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 30, BPP, RS2_FORMAT_Z16, intrinsics });
+    auto ir = s.add_video_stream({ RS2_STREAM_INFRARED, 1, 1, W, H, 30, BPP, RS2_FORMAT_Y16, intrinsics });
+
+    REQUIRE(s.get_stream_priority(RS2_STREAM_DEPTH, 0) == 0);
+    s.set_stream_priority(RS2_STREAM_DEPTH, -1, 1);
+    REQUIRE(s.get_stream_priority(RS2_STREAM_DEPTH, 0) == 1);
+    REQUIRE(s.get_stream_priority(RS2_STREAM_INFRARED, 1) == 0);
+
+    frame_queue q(4);
+    s.open({ depth, ir });
+    s.start(q);
+
+    // Once the queue is half full, the infrared frames are dropped while the depth frames make room by dropping the oldest
+    std::vector<uint8_t> pixels(W * H * BPP, 0);
+    int number = 0;
+    s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, number++, depth });
+    for (int i = 0; i < 3; i++)
+        s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, number++, ir });
+    for (int i = 0; i < 3; i++)
+        s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, number++, depth });
+
+    std::vector<std::pair<rs2_stream, unsigned long long>> received;
+    frame f;
+    while (q.poll_for_frame(&f))
+        received.push_back({ f.get_profile().stream_type(), f.get_frame_number() });
+    s.stop();
+    s.close();
+
+    std::vector<std::pair<rs2_stream, unsigned long long>> expected{
+        { RS2_STREAM_INFRARED, 1 }, { RS2_STREAM_DEPTH, 4 }, { RS2_STREAM_DEPTH, 5 }, { RS2_STREAM_DEPTH, 6 } };
+    REQUIRE(received == expected);
+}
+
+TEST_CASE("Colorizer histogram sampling follows the depth", "[software-device][colorizer]") {
+    const int W = 64;
+    const int H = 48;
+    const int BPP = 2;
+    const int sampling = 3;
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+    s.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+
+    rs2_intrinsics intrinsics{ W, H, W / 2.f, H / 2.f, 50, 50, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+
+    std::vector<uint16_t> first(W * H), second(W * H);
+    for (int i = 0; i < W * H; i++)
+    {
+        first[i] = i % 7 ? static_cast<uint16_t>(400 + i) : 0;
+        second[i] = i % 5 ? static_cast<uint16_t>(3000 - i / 2) : 0;
+    }
+
+    rs2::colorizer full, sampled;
+    REQUIRE(sampled.supports(RS2_OPTION_HISTOGRAM_SAMPLING));
+    REQUIRE(sampled.get_option(RS2_OPTION_HISTOGRAM_SAMPLING) == 1);
+    sampled.set_option(RS2_OPTION_HISTOGRAM_SAMPLING, static_cast<float>(sampling));
+
+    frame_queue q;
+    s.open(depth);
+    s.start(q);
+
+    // Once every row was recounted, the sampled histogram holds the new depth alone
+    std::vector<rs2::video_frame> colored;
+    for (int i = 0; i <= sampling; i++)
+    {
+        auto& pixels = i ? second : first;
+        s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, i, depth });
+        auto f = q.wait_for_frame();
+        colored.push_back(sampled.colorize(f));
+        if (i == sampling)
+            colored.push_back(full.colorize(f));
+    }
+    s.stop();
+    s.close();
+
+    auto& reference = colored.back();
+    auto& result = colored[sampling];
+    REQUIRE(reference.get_profile().format() == RS2_FORMAT_RGB8);
+    REQUIRE(result.get_width() == W);
+    REQUIRE(result.get_height() == H);
+    REQUIRE(memcmp(result.get_data(), reference.get_data(), W * H * 3) == 0);
+
+    // Before that, part of the rows still count the first frame
+    REQUIRE(memcmp(colored[1].get_data(), reference.get_data(), W * H * 3) != 0);
+
+    // Pixels without depth are black
+    auto rgb = reinterpret_cast<const uint8_t*>(result.get_data());
+    REQUIRE(rgb[0] == 0);
+    REQUIRE(rgb[1] == 0);
+    REQUIRE(rgb[2] == 0);
+}
+
+TEST_CASE("Temporal filter fuses the disparity to depth transform", "[software-device][post-processing]") {
+    const int W = 64;
+    const int H = 48;
+    const int BPP = 2;
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+    s.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+    s.add_read_only_option(RS2_OPTION_STEREO_BASELINE, 0.05f);
+
+    rs2_intrinsics intrinsics{ W, H, W / 2.f, H / 2.f, 50, 50, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+
+    rs2::disparity_transform to_disparity(true), from_disparity(false);
+    rs2::temporal_filter temporal, fused;
+    REQUIRE(fused.supports(RS2_OPTION_FUSED_DISPARITY_TO_DEPTH));
+    REQUIRE(fused.get_option(RS2_OPTION_FUSED_DISPARITY_TO_DEPTH) == 0);
+    fused.set_option(RS2_OPTION_FUSED_DISPARITY_TO_DEPTH, 1);
+
+    frame_queue q;
+    s.open(depth);
+    s.start(q);
+
+    std::vector<uint16_t> pixels(W * H);
+    for (int frame = 0; frame < 4; frame++)
+    {
+        for (int i = 0; i < W * H; i++)
+            pixels[i] = (i + frame) % 9 ? static_cast<uint16_t>(500 + (i * 13 + frame * 7) % 3000) : 0;
+        s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, frame, depth });
+        auto disparity = to_disparity.process(q.wait_for_frame());
+        REQUIRE(disparity.is<rs2::disparity_frame>());
+
+        auto reference = from_disparity.process(temporal.process(disparity));
+        auto result = fused.process(disparity);
+
+        REQUIRE(result.is<rs2::depth_frame>());
+        REQUIRE_FALSE(result.is<rs2::disparity_frame>());
+        REQUIRE(result.get_profile().format() == RS2_FORMAT_Z16);
+        REQUIRE(memcmp(result.get_data(), reference.get_data(), W * H * BPP) == 0);
+    }
+    s.stop();
+    s.close();
+}
+
+TEST_CASE("Disparity and temporal filters output depth in meters", "[software-device][post-processing]") {
+    const int W = 64;
+    const int H = 48;
+    const int BPP = 2;
+    const float units = 0.001f;
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+    s.add_read_only_option(RS2_OPTION_DEPTH_UNITS, units);
+    s.add_read_only_option(RS2_OPTION_STEREO_BASELINE, 0.05f);
+
+    rs2_intrinsics intrinsics{ W, H, W / 2.f, H / 2.f, 50, 50, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+
+    rs2::disparity_transform to_disparity(true), from_disparity(false), to_distance(false);
+    rs2::temporal_filter fused, fused_distance;
+    REQUIRE(to_distance.supports(RS2_OPTION_DISTANCE_OUTPUT));
+    REQUIRE(to_distance.get_option(RS2_OPTION_DISTANCE_OUTPUT) == 0);
+    to_distance.set_option(RS2_OPTION_DISTANCE_OUTPUT, 1);
+    fused.set_option(RS2_OPTION_FUSED_DISPARITY_TO_DEPTH, 1);
+    fused_distance.set_option(RS2_OPTION_FUSED_DISPARITY_TO_DEPTH, 1);
+    fused_distance.set_option(RS2_OPTION_DISTANCE_OUTPUT, 1);
+
+    frame_queue q;
+    s.open(depth);
+    s.start(q);
+
+    // The meters of the disparity round to the depth it converts back to
+    auto require_meters_of = [&](const rs2::frame& result, const rs2::frame& reference)
+    {
+        REQUIRE(result.is<rs2::depth_frame>());
+        REQUIRE(result.get_profile().format() == RS2_FORMAT_DISTANCE);
+        auto meters = reinterpret_cast<const float*>(result.get_data());
+        auto z = reinterpret_cast<const uint16_t*>(reference.get_data());
+        for (int i = 0; i < W * H; i++)
+        {
+            if (!z[i])
+                REQUIRE(meters[i] == 0.f);
+            else
+                REQUIRE(std::abs(meters[i] - z[i] * units) <= units * 0.51f);
+        }
+        REQUIRE(result.as<rs2::depth_frame>().get_distance(W / 3, H / 3) == meters[(H / 3) * W + W / 3]);
+    };
+
+    std::vector<uint16_t> pixels(W * H);
+    for (int frame = 0; frame < 4; frame++)
+    {
+        for (int i = 0; i < W * H; i++)
+            pixels[i] = (i + frame) % 9 ? static_cast<uint16_t>(500 + (i * 13 + frame * 7) % 3000) : 0;
+        s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, frame, depth });
+        auto z16 = q.wait_for_frame();
+
+        // Depth is converted with its units alone
+        auto direct = to_distance.process(z16);
+        REQUIRE(direct.get_profile().format() == RS2_FORMAT_DISTANCE);
+        auto meters = reinterpret_cast<const float*>(direct.get_data());
+        for (int i = 0; i < W * H; i++)
+            REQUIRE(meters[i] == pixels[i] * units);
+
+        auto disparity = to_disparity.process(z16);
+        require_meters_of(to_distance.process(disparity), from_disparity.process(disparity));
+        require_meters_of(fused_distance.process(disparity), fused.process(disparity));
+    }
+    s.stop();
+    s.close();
+}
+
+TEST_CASE("Hole filling fills the rows in parallel like a single scan", "[software-device][post-processing]") {
+    const int W = 301;
+    const int H = 61;
+    const int BPP = 2;
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+    s.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+
+    rs2_intrinsics intrinsics{ W, H, W / 2.f, H / 2.f, 200, 200, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+
+    frame_queue q;
+    s.open(depth);
+    s.start(q);
+
+    // Large holes, and depth near the top of the range where the selection of the nearest wraps around
+    std::vector<uint16_t> pixels(W * H);
+    for (int i = 0; i < W * H; i++)
+        pixels[i] = (i * 7) % 5 < 2 || (i / W) % 9 == 4 ? 0 : static_cast<uint16_t>(i % 11 ? 300 + (i * 37) % 4000 : 65535 - i % 3);
+    s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 0, depth });
+    auto f = q.wait_for_frame();
+
+    for (int mode : { 0, 1, 2 })
+    {
+        CAPTURE(mode);
+
+        // The scan of the frame from its top left, pixel by pixel. Filling from the left fills the first and last rows too
+        auto expected = pixels;
+        for (int y = mode ? 1 : 0; y < (mode ? H - 1 : H); y++)
+        {
+            for (int x = 1; x < W; x++)
+            {
+                auto p = &expected[y * W + x];
+                if (*p)
+                    continue;
+                if (!mode)
+                {
+                    *p = *(p - 1);
+                    continue;
+                }
+                auto tmp = *(p - W);
+                for (auto n : { p - W - 1, p - 1, p + W - 1, p + W })
+                {
+                    if (mode == 1 ? *n > tmp : (*n && *n < tmp))
+                        tmp = *n;
+                }
+                *p = tmp;
+            }
+        }
+
+        rs2::hole_filling_filter hole_filling;
+        for (float threads : { 1.f, hole_filling.get_option_range(RS2_OPTION_PROCESSING_THREADS).max })
+        {
+            CAPTURE(threads);
+            hole_filling.set_option(RS2_OPTION_HOLES_FILL, float(mode));
+            hole_filling.set_option(RS2_OPTION_PROCESSING_THREADS, threads);
+            auto result = hole_filling.process(f);
+            REQUIRE(memcmp(result.get_data(), expected.data(), W * H * BPP) == 0);
+        }
+    }
+    s.stop();
+    s.close();
+}
+
+TEST_CASE("Depth post-processing runs the filter chain in strips", "[software-device][post-processing]") {
+    const int W = 640;
+    const int H = 480;
+    const int BPP = 2;
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+    s.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+    s.add_read_only_option(RS2_OPTION_STEREO_BASELINE, 0.05f);
+
+    rs2_intrinsics intrinsics{ W, H, W / 2.f, H / 2.f, 380, 380, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+
+    // The separate blocks, and the filters of the chain, configured alike
+    rs2::decimation_filter decimation, chain_decimation;
+    rs2::disparity_transform to_disparity(true), from_disparity(false);
+    rs2::spatial_filter spatial, chain_spatial;
+    rs2::temporal_filter temporal, chain_temporal;
+    rs2::hole_filling_filter hole_filling, chain_hole_filling;
+    for (auto filter : { &decimation, &chain_decimation })
+        filter->set_option(RS2_OPTION_FILTER_MAGNITUDE, 2);
+    for (auto filter : { &spatial, &chain_spatial })
+        filter->set_option(RS2_OPTION_HOLES_FILL, 2);
+    for (auto filter : { &hole_filling, &chain_hole_filling })
+        filter->set_option(RS2_OPTION_HOLES_FILL, 1);
+
+    rs2::depth_post_processing chain(&chain_decimation, &chain_spatial, &chain_temporal, &chain_hole_filling);
+    chain.set_option(RS2_OPTION_PROCESSING_THREADS, 2);
+
+    frame_queue q;
+    s.open(depth);
+    s.start(q);
+
+    std::vector<uint16_t> pixels(W * H);
+    for (int frame = 0; frame < 4; frame++)
+    {
+        for (int i = 0; i < W * H; i++)
+            pixels[i] = (i + frame) % 7 ? static_cast<uint16_t>(500 + (i * 13 + frame * 7) % 3000) : 0;
+        s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, frame, depth });
+        auto f = q.wait_for_frame();
+
+        auto reference = decimation.process(f);
+        reference = to_disparity.process(reference);
+        reference = spatial.process(reference);
+        reference = temporal.process(reference);
+        reference = from_disparity.process(reference);
+        reference = hole_filling.process(reference);
+        auto result = chain.process(f);
+
+        REQUIRE(result.is<rs2::depth_frame>());
+        REQUIRE(result.get_profile().format() == RS2_FORMAT_Z16);
+        auto vf = result.as<rs2::video_frame>();
+        auto reference_vf = reference.as<rs2::video_frame>();
+        REQUIRE(vf.get_width() == reference_vf.get_width());
+        REQUIRE(vf.get_height() == reference_vf.get_height());
+        REQUIRE(memcmp(result.get_data(), reference.get_data(), vf.get_width() * vf.get_height() * BPP) == 0);
+    }
+    s.stop();
+    s.close();
+}
+
+TEST_CASE("Processing graph pipelines frames through its blocks in order", "[software-device][post-processing]") {
+    const int W = 64;
+    const int H = 48;
+    const int BPP = 2;
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+    s.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+
+    rs2_intrinsics intrinsics{ W, H, W / 2.f, H / 2.f, 50, 50, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+
+    rs2::decimation_filter decimation, graph_decimation;
+    rs2::spatial_filter spatial, graph_spatial;
+    rs2::temporal_filter temporal, graph_temporal;
+
+    rs2::processing_graph graph(3, 2);
+    auto d = graph.add(graph_decimation);
+    auto sp = graph.add(graph_spatial);
+    auto t = graph.add(graph_temporal);
+    graph.connect(d, sp);
+    graph.connect(sp, t);
+    REQUIRE_THROWS(graph.connect(t, d));
+    REQUIRE_THROWS(graph.connect(d, sp));
+    REQUIRE_THROWS(graph.add(graph_spatial));
+
+    const int frames = 8;
+    frame_queue results(frames);
+    graph.start(results);
+
+    frame_queue q;
+    s.open(depth);
+    s.start(q);
+
+    // The temporal filter depends on the order of the frames
+    std::vector<rs2::frame> references;
+    std::vector<uint16_t> pixels(W * H);
+    for (int frame = 0; frame < frames; frame++)
+    {
+        for (int i = 0; i < W * H; i++)
+            pixels[i] = (i + frame) % 5 ? static_cast<uint16_t>(500 + (i * 13 + frame * 7) % 3000) : 0;
+        s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, frame, depth });
+        auto f = q.wait_for_frame();
+        references.push_back(temporal.process(spatial.process(decimation.process(f))));
+        graph.invoke(f);
+    }
+    graph.flush();
+
+    for (auto&& reference : references)
+    {
+        rs2::frame result;
+        REQUIRE(results.poll_for_frame(&result));
+        REQUIRE(result.get_frame_number() == reference.get_frame_number());
+        auto vf = result.as<rs2::video_frame>();
+        REQUIRE(vf.get_width() == reference.as<rs2::video_frame>().get_width());
+        REQUIRE(memcmp(result.get_data(), reference.get_data(), vf.get_height() * vf.get_stride_in_bytes()) == 0);
+    }
+    s.stop();
+    s.close();
+}
+
+TEST_CASE("Processing graph processes batches of frames in order", "[software-device][post-processing]") {
+    const int W = 64;
+    const int H = 48;
+    const int BPP = 2;
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+    s.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+
+    rs2_intrinsics intrinsics{ W, H, W / 2.f, H / 2.f, 50, 50, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+
+    rs2::decimation_filter decimation, graph_decimation;
+    rs2::temporal_filter temporal, graph_temporal;
+    rs2::colorizer graph_colorizer;
+
+    rs2::processing_graph graph(3, 2);
+    auto d = graph.add(graph_decimation);
+    auto t = graph.add(graph_temporal);
+    graph.connect(d, t);
+
+    // The batch does not go through the output of the graph
+    frame_queue outputs;
+    graph.start(outputs);
+
+    frame_queue q;
+    s.open(depth);
+    s.start(q);
+
+    const int frames = 8;
+    std::vector<rs2::frame> inputs, references;
+    std::vector<uint16_t> pixels(W * H);
+    for (int frame = 0; frame < frames; frame++)
+    {
+        for (int i = 0; i < W * H; i++)
+            pixels[i] = (i + frame) % 5 ? static_cast<uint16_t>(500 + (i * 13 + frame * 7) % 3000) : 0;
+        s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, frame, depth });
+        inputs.push_back(q.wait_for_frame());
+        references.push_back(temporal.process(decimation.process(inputs.back())));
+    }
+
+    auto results = graph.process(inputs);
+    REQUIRE(results.size() == references.size());
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        REQUIRE(results[i].get_frame_number() == references[i].get_frame_number());
+        auto vf = results[i].as<rs2::video_frame>();
+        REQUIRE(vf.get_width() == references[i].as<rs2::video_frame>().get_width());
+        REQUIRE(memcmp(vf.get_data(), references[i].get_data(), vf.get_height() * vf.get_stride_in_bytes()) == 0);
+    }
+    rs2::frame unexpected;
+    REQUIRE_FALSE(outputs.poll_for_frame(&unexpected));
+
+    // Every frame leaving a graph with two outputs is part of the result of its input
+    graph.add(graph_colorizer);
+    results = graph.process({ inputs.front() });
+    REQUIRE(results.size() == 1);
+    auto set = results.front().as<rs2::frameset>();
+    REQUIRE(set);
+    REQUIRE(set.size() == 2);
+
+    s.stop();
+    s.close();
+}
+
+TEST_CASE("Filters process frames nothing else references in place", "[software-device][post-processing]") {
+    const int W = 64;
+    const int H = 48;
+    const int BPP = 2;
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+    s.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+
+    rs2_intrinsics intrinsics{ W, H, W / 2.f, H / 2.f, 50, 50, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+
+    rs2::decimation_filter decimation;
+    rs2::hole_filling_filter hole_filling, reference_filling;
+
+    frame_queue q;
+    s.open(depth);
+    s.start(q);
+
+    std::vector<uint16_t> pixels(W * H);
+    for (int i = 0; i < W * H; i++)
+        pixels[i] = i % 3 ? static_cast<uint16_t>(500 + (i * 13) % 3000) : 0;
+    auto original = pixels;
+    s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 0, depth });
+    auto f = q.wait_for_frame();
+
+    // A frame referenced by the caller is copied
+    auto shared = reference_filling.process(f);
+    REQUIRE(shared.get_data() != f.get_data());
+    std::vector<uint16_t> expected(W * H);
+    memcpy(expected.data(), shared.get_data(), W * H * BPP);
+    shared = rs2::frame();
+
+    // Frames holding the memory of the software device are never modified
+    auto result = hole_filling.process(std::move(f));
+    REQUIRE(memcmp(pixels.data(), original.data(), W * H * BPP) == 0);
+    REQUIRE(memcmp(result.get_data(), expected.data(), W * H * BPP) == 0);
+
+    // A frame of a previous block, that nothing else references, is filtered in place
+    auto decimated = decimation.process(result);
+    auto data = decimated.get_data();
+    auto width = decimated.as<rs2::video_frame>().get_width();
+    auto height = decimated.as<rs2::video_frame>().get_height();
+    std::vector<uint16_t> decimated_expected(width * height);
+    {
+        auto reference = reference_filling.process(decimated);
+        memcpy(decimated_expected.data(), reference.get_data(), width * height * BPP);
+    }
+    auto filled = hole_filling.process(std::move(decimated));
+    REQUIRE(filled.get_data() == data);
+    REQUIRE(filled.is<rs2::depth_frame>());
+    REQUIRE(memcmp(filled.get_data(), decimated_expected.data(), width * height * BPP) == 0);
+
+    s.stop();
+    s.close();
+}
+
+TEST_CASE("Frames held in host memory are not GPU-resident", "[software-device]") {
+    const int W = 64;
+    const int H = 48;
+    const int BPP = 2;
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+    s.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+
+    rs2_intrinsics intrinsics{ W, H, W / 2.f, H / 2.f, 50, 50, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+
+    frame_queue q;
+    s.open(depth);
+    s.start(q);
+
+    std::vector<uint16_t> pixels(W * H, 1000);
+    s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 0, depth });
+    auto f = q.wait_for_frame();
+
+    // Frames of the software device, and the ones filtered from them on the CPU, stay in host memory
+    REQUIRE_FALSE(f.is<rs2::gpu_frame>());
+    rs2_error* e = nullptr;
+    REQUIRE(rs2_get_frame_device_pointer(f.get(), &e) == nullptr);
+    REQUIRE(e != nullptr);
+    rs2_free_error(e);
+
+    rs2::decimation_filter decimation;
+    auto decimated = decimation.process(f);
+    REQUIRE_FALSE(decimated.is<rs2::gpu_frame>());
+    REQUIRE_THROWS(rs2::gpu_frame(f).get_device_pointer());
+
+    s.stop();
+    s.close();
+}
+
+TEST_CASE("Processing blocks produce the same frames on every compute backend", "[software-device]") {
+    const int W = 64;
+    const int H = 48;
+    const int BPP = 2;
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+    s.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+
+    rs2_intrinsics intrinsics{ W, H, W / 2.f, H / 2.f, 50, 50, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+
+    frame_queue q;
+    s.open(depth);
+    s.start(q);
+
+    std::vector<uint16_t> pixels(W * H);
+    for (int i = 0; i < W * H; i++)
+        pixels[i] = i % 7 ? uint16_t(500 + (i * 37) % 3000) : 0;
+    s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 0, depth });
+    auto f = q.wait_for_frame();
+
+    rs2::context ctx;
+    REQUIRE(ctx.is_compute_backend_available(RS2_COMPUTE_BACKEND_CPU));
+    REQUIRE(std::string(rs2_compute_backend_to_string(RS2_COMPUTE_BACKEND_OPENCL)) == "Opencl");
+
+    auto process = [&](rs2_compute_backend backend)
+    {
+        ctx.set_compute_backend(backend);
+        rs2::colorizer colorizer;
+        rs2::decimation_filter decimation;
+        rs2::pointcloud pc;
+        auto colorized = colorizer.process(f);
+        auto decimated = decimation.process(f);
+        auto points = pc.calculate(f);
+        auto bytes = [](const void* data, size_t size) { return std::vector<uint8_t>((const uint8_t*)data, (const uint8_t*)data + size); };
+        return std::make_tuple(bytes(colorized.get_data(), W * H * 3),
+            bytes(decimated.get_data(), decimated.as<rs2::video_frame>().get_height() * decimated.as<rs2::video_frame>().get_stride_in_bytes()),
+            bytes(points.get_vertices(), points.size() * sizeof(rs2::vertex)));
+    };
+
+    auto expected = process(RS2_COMPUTE_BACKEND_CPU);
+    for (int i = 0; i < RS2_COMPUTE_BACKEND_COUNT; i++)
+    {
+        auto backend = rs2_compute_backend(i);
+        if (!ctx.is_compute_backend_available(backend))
+        {
+            REQUIRE_THROWS(ctx.set_compute_backend(backend));
+            continue;
+        }
+        CAPTURE(rs2_compute_backend_to_string(backend));
+        auto actual = process(backend);
+        REQUIRE(std::get<0>(actual) == std::get<0>(expected));
+        REQUIRE(std::get<1>(actual) == std::get<1>(expected));
+        // Points are computed with float math that may round differently on other devices
+        auto& expected_points = std::get<2>(expected);
+        auto& actual_points = std::get<2>(actual);
+        REQUIRE(actual_points.size() == expected_points.size());
+        for (size_t j = 0; j < actual_points.size() / sizeof(float); j++)
+            REQUIRE(((float*)actual_points.data())[j] == Approx(((float*)expected_points.data())[j]).epsilon(1e-4));
+    }
+    ctx.set_compute_backend(RS2_COMPUTE_BACKEND_CPU);
+
+    s.stop();
+    s.close();
+}
+
+TEST_CASE("Processing blocks record their invocation statistics", "[software-device]") {
+    const int W = 64;
+    const int H = 48;
+    const int BPP = 2;
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+    s.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+
+    rs2_intrinsics intrinsics{ W, H, W / 2.f, H / 2.f, 50, 50, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+
+    frame_queue q;
+    s.open(depth);
+    s.start(q);
+
+    std::vector<uint16_t> pixels(W * H, 1000);
+    s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 0, depth });
+    auto f = q.wait_for_frame();
+
+    rs2::decimation_filter decimation;
+    REQUIRE(decimation.get_option(RS2_OPTION_PROCESSING_STATISTICS) == 0.f);
+    REQUIRE(decimation.is_option_read_only(RS2_OPTION_PROCESSED_FRAMES));
+    REQUIRE(decimation.is_option_read_only(RS2_OPTION_PROCESSING_TIME_P99));
+
+    // Nothing is recorded until the statistics are enabled
+    decimation.process(f);
+    REQUIRE(decimation.get_stats().invocations == 0);
+
+    const int frames = 10;
+    decimation.set_option(RS2_OPTION_PROCESSING_STATISTICS, 1);
+    for (int i = 0; i < frames; i++)
+        decimation.process(f);
+
+    auto stats = decimation.get_stats();
+    REQUIRE(stats.invocations == frames);
+    REQUIRE(stats.dropped_frames == 0);
+    REQUIRE(stats.p50_time >= 0);
+    REQUIRE(stats.p99_time >= stats.p50_time);
+    REQUIRE(stats.total_time >= stats.p99_time);
+    REQUIRE(decimation.get_option(RS2_OPTION_PROCESSED_FRAMES) == float(frames));
+    REQUIRE(decimation.get_option(RS2_OPTION_DROPPED_FRAMES) == 0.f);
+    REQUIRE(decimation.get_option(RS2_OPTION_PROCESSING_TIME_P99) == Approx(stats.p99_time));
+
+    // Disabling keeps the statistics, and enabling again clears them
+    decimation.set_option(RS2_OPTION_PROCESSING_STATISTICS, 0);
+    decimation.process(f);
+    REQUIRE(decimation.get_stats().invocations == frames);
+    decimation.set_option(RS2_OPTION_PROCESSING_STATISTICS, 1);
+    REQUIRE(decimation.get_stats().invocations == 0);
+
+    // The consumers of the outputs are not counted in the processing time of the block
+    rs2::processing_block forward([](rs2::frame f, rs2::frame_source& source) { source.frame_ready(f); });
+    forward.start([](rs2::frame) { std::this_thread::sleep_for(std::chrono::milliseconds(200)); });
+    forward.set_option(RS2_OPTION_PROCESSING_STATISTICS, 1);
+    forward.invoke(f);
+    REQUIRE(forward.get_stats().invocations == 1);
+    REQUIRE(forward.get_stats().total_time < 100);
+
+    s.stop();
+    s.close();
+}
+
+TEST_CASE("Depth filters and the pointcloud process only their region of interest", "[software-device][post-processing]") {
+    const int W = 64;
+    const int H = 48;
+    const int BPP = 2;
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+    s.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+
+    rs2_intrinsics intrinsics{ W, H, W / 2.f, H / 2.f, 50, 50, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+
+    frame_queue q;
+    s.open(depth);
+    s.start(q);
+
+    // Every other column is a hole
+    std::vector<uint16_t> pixels(W * H);
+    for (int i = 0; i < W * H; i++)
+        pixels[i] = i % 2 ? 0 : 1000;
+    s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 0, depth });
+    auto f = q.wait_for_frame();
+
+    const region_of_interest roi{ 8, 4, 40, 20 };
+    auto inside = [&](int x, int y) { return x >= roi.min_x && x < roi.max_x && y >= roi.min_y && y < roi.max_y; };
+
+    rs2::hole_filling_filter hole_filling;
+    hole_filling.set_region_of_interest(roi);
+    auto set_roi = hole_filling.get_region_of_interest();
+    REQUIRE(set_roi.min_x == roi.min_x);
+    REQUIRE(set_roi.max_y == roi.max_y);
+
+    // The holes are filled inside the rectangle only
+    auto filled = hole_filling.process(f).as<video_frame>();
+    REQUIRE(filled.get_width() == W);
+    REQUIRE(filled.get_height() == H);
+    auto data = (const uint16_t*)filled.get_data();
+    for (int y = 0; y < H; y++)
+        for (int x = 1; x < W; x += 2)
+            REQUIRE((data[y * W + x] != 0) == inside(x, y));
+
+    // Cropping outputs the rectangle, with the intrinsics of its pixels
+    hole_filling.set_option(RS2_OPTION_CROP_TO_ROI, 1);
+    auto cropped = hole_filling.process(f).as<video_frame>();
+    REQUIRE(cropped.get_width() == roi.max_x - roi.min_x);
+    REQUIRE(cropped.get_height() == roi.max_y - roi.min_y);
+    auto cropped_intrinsics = cropped.get_profile().as<video_stream_profile>().get_intrinsics();
+    REQUIRE(cropped_intrinsics.ppx == Approx(intrinsics.ppx - roi.min_x));
+    REQUIRE(cropped_intrinsics.ppy == Approx(intrinsics.ppy - roi.min_y));
+
+    // An empty rectangle processes the whole frame again
+    hole_filling.set_region_of_interest({ 0, 0, 0, 0 });
+    REQUIRE(hole_filling.process(f).as<video_frame>().get_width() == W);
+
+    rs2::pointcloud pc;
+    pc.set_region_of_interest(roi);
+    auto points = pc.calculate(f);
+    REQUIRE(points.size() == size_t(W * H));
+    auto vertices = points.get_vertices();
+    for (int y = 0; y < H; y++)
+        for (int x = 0; x < W; x += 2)
+            REQUIRE((vertices[y * W + x].z != 0) == inside(x, y));
+
+    pc.set_option(RS2_OPTION_CROP_TO_ROI, 1);
+    REQUIRE(pc.calculate(f).size() == size_t((roi.max_x - roi.min_x) * (roi.max_y - roi.min_y)));
+
+    // Blocks without a region of interest refuse one
+    rs2::decimation_filter decimation;
+    REQUIRE_THROWS(decimation.set_region_of_interest(roi));
+
+    s.stop();
+    s.close();
+}
+
+TEST_CASE("Concurrent frame callbacks keep the order of every stream", "[software-device]") {
+    const int W = 16;
+    const int H = 16;
+    const int BPP = 2;
+    const int FRAMES = 10;
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+
+    rs2_intrinsics intrinsics{ W, H, 0, 0, 0, 0, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+    auto ir = s.add_video_stream({ RS2_STREAM_INFRARED, 1, 1, W, H, 60, BPP, RS2_FORMAT_Y16, intrinsics });
+
+    REQUIRE(s.get_option(RS2_OPTION_CALLBACK_THREADS) == 1);
+    REQUIRE(s.get_option(RS2_OPTION_ORDERED_CALLBACKS) == 1);
+    REQUIRE_THROWS(s.set_option(RS2_OPTION_CALLBACK_THREADS, 0));
+    s.set_option(RS2_OPTION_CALLBACK_THREADS, 4);
+    s.set_option(RS2_OPTION_FRAMES_QUEUE_SIZE, 2 * FRAMES);
+
+    std::mutex m;
+    int running = 0, most_running = 0, delivered = 0;
+    std::map<rs2_stream, unsigned long long> last;
+    bool in_order = true;
+    std::atomic<bool> stopped(false);
+    std::atomic<int> after_stop(0);
+    s.open({ depth, ir });
+    s.start([&](rs2::frame f)
+    {
+        if (stopped)
+            after_stop++;
+        auto stream = f.get_profile().stream_type();
+        {
+            std::lock_guard<std::mutex> lock(m);
+            most_running = std::max(most_running, ++running);
+            if (last.count(stream) && last[stream] >= f.get_frame_number())
+                in_order = false;
+            last[stream] = f.get_frame_number();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        std::lock_guard<std::mutex> lock(m);
+        running--;
+        delivered++;
+    });
+
+    std::vector<uint16_t> pixels(W * H);
+    for (int i = 1; i <= FRAMES; i++)
+    {
+        s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, double(i), RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, i, depth });
+        s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, double(i), RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, i, ir });
+    }
+    for (int i = 0; i < 100; i++)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            if (delivered == 2 * FRAMES)
+                break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m);
+        REQUIRE(delivered == 2 * FRAMES);
+        // The streams are delivered side by side, each one frame at a time
+        REQUIRE(most_running == 2);
+        REQUIRE(in_order);
+    }
+
+    // Once stopped, the frames still waiting for a thread are dropped and no callback follows
+    for (int i = FRAMES + 1; i <= 2 * FRAMES; i++)
+        s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, double(i), RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, i, depth });
+    s.stop();
+    stopped = true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    REQUIRE(after_stop == 0);
+    s.close();
+}
+
+TEST_CASE("Batch projection matches the projection of single points", "[projection]") {
+    // Counts off the vector width, for the remainders to be checked with the vectorized points
+    const int count = 1031;
+    std::vector<float> pixels(count * 2), depth(count), points(count * 3);
+    for (int i = 0; i < count; ++i)
+    {
+        pixels[i * 2] = float(i % 640) + 0.25f;
+        pixels[i * 2 + 1] = float(i * 7 % 480) - 0.5f;
+        depth[i] = 0.1f + (i % 97) * 0.05f;
+        points[i * 3] = (i % 53 - 26) * 0.03f;
+        points[i * 3 + 1] = (i % 41 - 20) * 0.04f;
+        points[i * 3 + 2] = 0.2f + (i % 89) * 0.06f;
+    }
+
+    for (auto model : { RS2_DISTORTION_NONE, RS2_DISTORTION_MODIFIED_BROWN_CONRADY, RS2_DISTORTION_INVERSE_BROWN_CONRADY,
+        RS2_DISTORTION_BROWN_CONRADY, RS2_DISTORTION_FTHETA })
+    {
+        CAPTURE(model);
+        rs2_intrinsics intrin = { 640, 480, 321.3f, 239.7f, 615.f, 616.f, model, { 0.1f, -0.05f, 0.002f, -0.001f, 0.01f } };
+        if (model == RS2_DISTORTION_FTHETA)
+            intrin.coeffs[0] = 0.9f;
+
+        std::vector<float> projected(count * 2);
+        rs2_project_points(&intrin, points.data(), projected.data(), count, nullptr);
+
+        std::vector<float> x(count), y(count), z(count), u(count), v(count);
+        for (int i = 0; i < count; ++i)
+        {
+            x[i] = points[i * 3];
+            y[i] = points[i * 3 + 1];
+            z[i] = points[i * 3 + 2];
+        }
+        rs2_project_points_soa(&intrin, x.data(), y.data(), z.data(), u.data(), v.data(), count, nullptr);
+
+        for (int i = 0; i < count; ++i)
+        {
+            float pixel[2];
+            rs2_project_point_to_pixel(pixel, &intrin, &points[i * 3]);
+            REQUIRE(projected[i * 2] == pixel[0]);
+            REQUIRE(projected[i * 2 + 1] == pixel[1]);
+            REQUIRE(u[i] == pixel[0]);
+            REQUIRE(v[i] == pixel[1]);
+        }
+
+        // Deprojection from the forward-distorted images is left out, as of rs2_deproject_pixel_to_point
+        if (model == RS2_DISTORTION_MODIFIED_BROWN_CONRADY || model == RS2_DISTORTION_FTHETA)
+            continue;
+
+        std::vector<float> deprojected(count * 3);
+        rs2_deproject_pixels(&intrin, pixels.data(), depth.data(), deprojected.data(), count, nullptr);
+
+        // In place, from the arrays of the pixels into those of the points
+        for (int i = 0; i < count; ++i)
+        {
+            x[i] = pixels[i * 2];
+            y[i] = pixels[i * 2 + 1];
+        }
+        rs2_deproject_pixels_soa(&intrin, x.data(), y.data(), depth.data(), x.data(), y.data(), z.data(), count, nullptr);
+
+        for (int i = 0; i < count; ++i)
+        {
+            float point[3];
+            rs2_deproject_pixel_to_point(point, &intrin, &pixels[i * 2], depth[i]);
+            for (int j = 0; j < 3; ++j)
+                REQUIRE(deprojected[i * 3 + j] == point[j]);
+            REQUIRE(x[i] == point[0]);
+            REQUIRE(y[i] == point[1]);
+            REQUIRE(z[i] == point[2]);
+        }
+    }
+
+    rs2_error* e = nullptr;
+    rs2_project_points(nullptr, points.data(), pixels.data(), count, &e);
+    REQUIRE(e);
+    rs2_free_error(e);
+}
+
+TEST_CASE("Wait for any of several frame queues", "[software-device]") {
+    const int W = 16;
+    const int H = 8;
+    const int BPP = 2;
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+    rs2_intrinsics intrinsics{ W, H, W / 2.f, H / 2.f, 10, 10, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+    std::vector<uint16_t> pixels(W * H, 0);
+
+    frame_queue q0, q1, q2;
+    REQUIRE(wait_for_any({ q0, q1, q2 }, {}, 0) == -1);
+    REQUIRE(wait_for_any({ q0, q1, q2 }, {}, 20) == -1);
+
+    s.open(depth);
+    s.start(q1);
+
+    // Woken by the frame of the second queue, with no polling
+    std::thread producer([&]()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 0, depth });
+    });
+    auto index = wait_for_any({ q0, q1, q2 }, {}, 5000);
+    producer.join();
+    REQUIRE(index == 1);
+
+    // The frame is left in its queue, for the consumer to fetch
+    REQUIRE(wait_for_any({ q0, q1, q2 }, {}, 0) == 1);
+    frame f;
+    REQUIRE(q1.poll_for_frame(&f));
+    REQUIRE(wait_for_any({ q0, q1, q2 }, {}, 0) == -1);
+
+    s.stop();
+    s.close();
+}
+
+TEST_CASE("Depth frames sample the depth of many pixels at once", "[software-device]") {
+    const int W = 64;
+    const int H = 48;
+    const int BPP = 2;
+    const float units = 0.001f;
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+    s.add_read_only_option(RS2_OPTION_DEPTH_UNITS, units);
+
+    rs2_intrinsics intrinsics{ W, H, W / 2.f, H / 2.f, 50, 50, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+
+    std::vector<uint16_t> data(W * H, 0);
+    for (int i = 0; i < W * H; i++)
+        data[i] = i % 3 ? static_cast<uint16_t>(500 + (i * 37) % 1000) : 0;
+
+    frame_queue q;
+    s.open(depth);
+    s.start(q);
+    s.on_video_frame({ data.data(), [](void*) {}, W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 0, depth });
+    rs2::depth_frame frame = q.wait_for_frame();
+    s.stop();
+    s.close();
+
+    // Fractional pixels, the edges of the frame and pixels out of it
+    std::vector<float> pixels;
+    for (int i = 0; i < 200; i++)
+    {
+        pixels.push_back(-2.f + (i * 7.3f) - std::floor(i * 7.3f / (W + 4)) * (W + 4));
+        pixels.push_back(-2.f + (i * 3.1f) - std::floor(i * 3.1f / (H + 4)) * (H + 4));
+    }
+    auto count = static_cast<int>(pixels.size() / 2);
+    auto nearest = [&](int i, int& x, int& y)
+    {
+        x = static_cast<int>(std::floor(pixels[i * 2] + 0.5f));
+        y = static_cast<int>(std::floor(pixels[i * 2 + 1] + 0.5f));
+        return x >= 0 && y >= 0 && x < W && y < H;
+    };
+
+    std::vector<float> distances(count), points(count * 3), medians(count);
+    frame.sample(pixels.data(), count, distances.data());
+    frame.sample(pixels.data(), count, points.data(), RS2_DEPTH_SAMPLE_POINT);
+    frame.sample(pixels.data(), count, medians.data(), RS2_DEPTH_SAMPLE_DISTANCE, 3);
+
+    for (int i = 0; i < count; i++)
+    {
+        int x, y;
+        float distance = nearest(i, x, y) ? frame.get_distance(x, y) : 0.f;
+        REQUIRE(distances[i] == distance);
+
+        float point[3];
+        rs2_deproject_pixel_to_point(point, &intrinsics, &pixels[i * 2], distance);
+        for (int j = 0; j < 3; j++)
+            REQUIRE(points[i * 3 + j] == point[j]);
+
+        // The lower median of the pixels of depth in the window
+        std::vector<uint16_t> window;
+        if (nearest(i, x, y))
+            for (int v = std::max(y - 1, 0); v <= std::min(y + 1, H - 1); v++)
+                for (int u = std::max(x - 1, 0); u <= std::min(x + 1, W - 1); u++)
+                    if (data[v * W + u]) window.push_back(data[v * W + u]);
+        std::sort(window.begin(), window.end());
+        REQUIRE(medians[i] == (window.empty() ? 0.f : window[(window.size() - 1) / 2] * units));
+    }
+
+    // Pixels that are not finite or too far out to be converted to int have no depth
+    const float nan = std::numeric_limits<float>::quiet_NaN(), inf = std::numeric_limits<float>::infinity();
+    std::vector<float> invalid = { nan, 1.f, 1.f, nan, inf, 1.f, -inf, 1.f, 1e20f, 1.f, 1.f, -1e20f };
+    auto invalid_count = static_cast<int>(invalid.size() / 2);
+    std::vector<float> invalid_distances(invalid_count, -1.f), invalid_medians(invalid_count, -1.f);
+    frame.sample(invalid.data(), invalid_count, invalid_distances.data());
+    frame.sample(invalid.data(), invalid_count, invalid_medians.data(), RS2_DEPTH_SAMPLE_DISTANCE, 3);
+    for (int i = 0; i < invalid_count; i++)
+    {
+        REQUIRE(invalid_distances[i] == 0.f);
+        REQUIRE(invalid_medians[i] == 0.f);
+    }
+
+    REQUIRE_THROWS(frame.sample(pixels.data(), count, medians.data(), RS2_DEPTH_SAMPLE_DISTANCE, 2));
+    REQUIRE_THROWS(frame.sample(pixels.data(), count, medians.data(), RS2_DEPTH_SAMPLE_MODE_COUNT));
+}
+
+TEST_CASE("Depth frames share a validity mask of a bit per pixel", "[software-device]") {
+    // Rows that are not of a whole number of words, and runs without depth of more than a word
+    const int W = 70;
+    const int H = 20;
+    const int BPP = 2;
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+    s.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+
+    rs2_intrinsics intrinsics{ W, H, W / 2.f, H / 2.f, 50, 50, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+
+    std::vector<uint16_t> data(W * H, 0);
+    std::vector<int> valid;
+    for (int i = 0; i < W * H; i++)
+    {
+        auto y = i / W;
+        if ((y < 5 || y > 12) && i % 5 != 2)
+        {
+            data[i] = static_cast<uint16_t>(300 + i);
+            valid.push_back(i);
+        }
+    }
+
+    frame_queue q;
+    s.open(depth);
+    s.start(q);
+    s.on_video_frame({ data.data(), [](void*) {}, W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 0, depth });
+    rs2::depth_frame frame = q.wait_for_frame();
+    s.stop();
+    s.close();
+
+    int words = 0;
+    auto mask = frame.get_validity_mask(&words);
+    REQUIRE(words == (W * H + 63) / 64);
+    for (int i = 0; i < words * 64; i++)
+        REQUIRE(((mask[i / 64] >> (i % 64)) & 1) == (i < W * H && data[i] ? 1u : 0u));
+
+    // Computed once for every reader of the frame
+    REQUIRE(frame.get_validity_mask() == mask);
+
+    rs2::pointcloud pc;
+    pc.set_option(RS2_OPTION_COMPACT_POINTS, 2);
+    rs2::points points = pc.calculate(frame);
+    REQUIRE(points.size() == valid.size());
+    for (size_t i = 0; i < valid.size(); i++)
+        REQUIRE(points.get_pixel_indices()[i] == valid[i]);
+}
+
+TEST_CASE("Playback throughput with parallel decode", "[software-device][.][benchmark]") {
+    std::string folder_name = get_folder_path(special_folder::temp_folder);
+    const std::string filename = folder_name + "single_depth_color_640x480.bag";
+    REQUIRE(file_exists(filename));
+
+    // Plays the whole file as fast as it can, touching the data of every frame
+    auto play = [&](bool fast) -> std::pair<int, double>
+    {
+        rs2::context ctx;
+        auto dev = ctx.load_device(filename);
+        dev.set_real_time(false);
+        if (fast)
+        {
+            dev.set_read_ahead(16);
+            dev.set_parallel_decode(true);
+        }
+
+        std::mutex m;
+        std::condition_variable cv;
+        bool stopped = false;
+        std::atomic<int> frames(0);
+        dev.set_status_changed_callback([&](rs2_playback_status status)
+        {
+            if (status != RS2_PLAYBACK_STATUS_STOPPED)
+                return;
+            std::lock_guard<std::mutex> lock(m);
+            stopped = true;
+            cv.notify_all();
+        });
+
+        auto sensors = dev.query_sensors();
+        auto started = std::chrono::high_resolution_clock::now();
+        for (auto&& s : sensors)
+        {
+            s.open(s.get_stream_profiles());
+            s.start([&](frame f)
+            {
+                volatile auto first = *reinterpret_cast<const uint8_t*>(f.get_data());
+                (void)first;
+                frames++;
+            });
+        }
+        {
+            std::unique_lock<std::mutex> lock(m);
+            REQUIRE(cv.wait_for(lock, std::chrono::seconds(60), [&]() { return stopped; }));
+        }
+        std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - started;
+        for (auto&& s : sensors)
+            s.close();
+        return{ frames.load(), elapsed.count() };
+    };
+
+    auto on_demand = play(false);
+    auto fast = play(true);
+    WARN("On demand: " << on_demand.first << " frames in " << on_demand.second << " s, " << on_demand.first / on_demand.second << " fps");
+    WARN("Read ahead and parallel decode: " << fast.first << " frames in " << fast.second << " s, " << fast.first / fast.second << " fps");
+
+    // Not a frame is dropped in either mode
+    REQUIRE(on_demand.first > 0);
+    REQUIRE(fast.first == on_demand.first);
+}
+
+TEST_CASE("Projection from recording", "[software-device][using_pipeline][projection]") {
+    rs2::context ctx;
+    if (!make_context(SECTION_FROM_TEST_NAME, &ctx, "2.13.0"))
+        return;
+    std::string folder_name = get_folder_path(special_folder::temp_folder);
+    const std::string filename = folder_name + "single_depth_color_640x480.bag";
+    REQUIRE(file_exists(filename));
+    auto dev = ctx.load_device(filename);
+
+    syncer sync;
+    std::vector<sensor> sensors = dev.query_sensors();
+    REQUIRE(sensors.size() == 2);
+    for (auto s : sensors)
+    {
+        REQUIRE_NOTHROW(s.open(s.get_stream_profiles().front()));
+        REQUIRE_NOTHROW(s.start(sync));
+    }
+
+    rs2::frame depth;
+    rs2::stream_profile depth_profile;
+    rs2::stream_profile color_profile;
+
+    while (!depth_profile || !color_profile)
+    {
+        frameset frames = sync.wait_for_frames(200);
+        REQUIRE(frames.size() > 0);
+        if (frames.size() == 1)
+        {
+            if (frames.get_profile().stream_type() == RS2_STREAM_DEPTH)
+            {
+                depth = frames.get_depth_frame();
+                depth_profile = depth.get_profile();
+            }
+            else
+            {
+                color_profile = frames.get_color_frame().get_profile();
+            }
+        }
+        else
+        {
+            depth = frames.get_depth_frame();
+            depth_profile = depth.get_profile();
+            color_profile = frames.get_color_frame().get_profile();
+        }
+    }
+
+    auto depth_intrin = depth_profile.as<rs2::video_stream_profile>().get_intrinsics();
+    auto color_intrin = color_profile.as<rs2::video_stream_profile>().get_intrinsics();
+    auto depth_extrin_to_color = depth_profile.as<rs2::video_stream_profile>().get_extrinsics_to(color_profile);
+    auto color_extrin_to_depth = color_profile.as<rs2::video_stream_profile>().get_extrinsics_to(depth_profile);
+
+    float depth_scale = 0;
+    for (auto s : sensors)
+    {
+        auto depth_sensor = s.is<rs2::depth_sensor>();
+        if (s.is<rs2::depth_sensor>())
+        {
+            REQUIRE_NOTHROW(depth_scale = s.as<rs2::depth_sensor>().get_depth_scale());
+        }
+    }
+
+    int count = 0;
+    for (float i = 0; i < depth_intrin.width; i++)
+    {
+        for (float j = 0; j < depth_intrin.height; j++)
+        {
+            float depth_pixel[2] = { i, j };
+            auto udist = depth.as<rs2::depth_frame>().get_distance(depth_pixel[0], depth_pixel[1]);
+            if (udist == 0) continue;
+
+            float from_pixel[2] = { 0 }, to_pixel[2] = { 0 }, point[3] = { 0 }, other_point[3] = { 0 };
+            rs2_deproject_pixel_to_point(point, &depth_intrin, depth_pixel, udist);
+            rs2_transform_point_to_point(other_point, &depth_extrin_to_color, point);
+            rs2_project_point_to_pixel(from_pixel, &color_intrin, other_point);
+
+            rs2_project_color_pixel_to_depth_pixel(to_pixel, reinterpret_cast<const uint16_t*>(depth.get_data()), depth_scale, 0.1, 10,
+                &depth_intrin, &color_intrin,
+                &color_extrin_to_depth, &depth_extrin_to_color, from_pixel);
+
+            float dist = sqrt(pow((depth_pixel[1] - to_pixel[1]), 2) + pow((depth_pixel[0] - to_pixel[0]), 2));
+            if (dist > 1)
+                count++;
+            if (dist > 2)
+                printf("%f\n", dist);
+        }
+    }
+    const double MAX_ERROR_PERCENTAGE = 0.1;
+    REQUIRE(count * 100 / (depth_intrin.width * depth_intrin.height) < MAX_ERROR_PERCENTAGE);
+    CAPTURE(count);
+}
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include "../src/image_neon.h"
+
+static uint8_t clamp_byte(int32_t x) { return static_cast<uint8_t>(x > 255 ? 255 : x < 0 ? 0 : x); }
+
+TEST_CASE("NEON YUY2 unpacking matches the generic code", "[neon]") {
+    const int N = 64;
+    std::vector<uint8_t> yuy2(N * 2);
+    for (size_t i = 0; i < yuy2.size(); i++) yuy2[i] = static_cast<uint8_t>(i * 37 + 11);
+
+    std::vector<uint8_t> rgb(N * 3), bgra(N * 4), y8(N), y16(N * 2);
+    uint8_t* rgb_dest[] = { rgb.data() };
+    uint8_t* bgra_dest[] = { bgra.data() };
+    uint8_t* y8_dest[] = { y8.data() };
+    uint8_t* y16_dest[] = { y16.data() };
+    librealsense::unpack_yuy2_neon_rgb8(rgb_dest, yuy2.data(), N);
+    librealsense::unpack_yuy2_neon_bgra8(bgra_dest, yuy2.data(), N);
+    librealsense::unpack_yuy2_neon_y8(y8_dest, yuy2.data(), N);
+    librealsense::unpack_yuy2_neon_y16(y16_dest, yuy2.data(), N);
+
+    for (int i = 0; i < N; i++)
+    {
+        int32_t c = yuy2[i * 2] - 16;
+        int32_t d = yuy2[(i / 2) * 4 + 1] - 128;
+        int32_t e = yuy2[(i / 2) * 4 + 3] - 128;
+        uint8_t r = clamp_byte((298 * c + 409 * e + 128) >> 8);
+        uint8_t g = clamp_byte((298 * c - 100 * d - 208 * e + 128) >> 8);
+        uint8_t b = clamp_byte((298 * c + 516 * d + 128) >> 8);
+
+        CAPTURE(i);
+        REQUIRE(rgb[i * 3] == r);
+        REQUIRE(rgb[i * 3 + 1] == g);
+        REQUIRE(rgb[i * 3 + 2] == b);
+        REQUIRE(bgra[i * 4] == b);
+        REQUIRE(bgra[i * 4 + 1] == g);
+        REQUIRE(bgra[i * 4 + 2] == r);
+        REQUIRE(bgra[i * 4 + 3] == 255);
+        REQUIRE(y8[i] == yuy2[i * 2]);
+        REQUIRE(y16[i * 2] == 0);
+        REQUIRE(y16[i * 2 + 1] == yuy2[i * 2]);
+    }
+}
+
+TEST_CASE("NEON stereo and BGR unpacking matches the generic code", "[neon]") {
+    const int N = 50; // Not a multiple of the vector width, the remainder is left to the generic code
+    std::vector<uint8_t> src(N * 3);
+    for (size_t i = 0; i < src.size(); i++) src[i] = static_cast<uint8_t>(i * 53 + 7);
+
+    std::vector<uint8_t> left8(N), right8(N), rgb(N * 3);
+    std::vector<uint16_t> left16(N), right16(N);
+    uint8_t* y8i_dest[] = { left8.data(), right8.data() };
+    uint8_t* y12i_dest[] = { reinterpret_cast<uint8_t*>(left16.data()), reinterpret_cast<uint8_t*>(right16.data()) };
+    uint8_t* rgb_dest[] = { rgb.data() };
+
+    auto y8i_done = librealsense::unpack_y8_y8_from_y8i_neon(y8i_dest, src.data(), N);
+    auto y12i_done = librealsense::unpack_y16_y16_from_y12i_10_neon(y12i_dest, src.data(), N);
+    auto rgb_done = librealsense::unpack_rgb_from_bgr_neon(rgb_dest, src.data(), N);
+    REQUIRE(y8i_done == N / 16 * 16);
+    REQUIRE(y12i_done == N / 8 * 8);
+    REQUIRE(rgb_done == N / 16 * 16);
+
+    for (int i = 0; i < y8i_done; i++)
+    {
+        REQUIRE(left8[i] == src[i * 2]);
+        REQUIRE(right8[i] == src[i * 2 + 1]);
+    }
+    for (int i = 0; i < y12i_done; i++)
+    {
+        int l = src[i * 3 + 2] << 4 | src[i * 3 + 1] >> 4;
+        int r = (src[i * 3 + 1] & 0x0f) << 8 | src[i * 3];
+        REQUIRE(left16[i] == static_cast<uint16_t>(l << 6 | l >> 4));
+        REQUIRE(right16[i] == static_cast<uint16_t>(r << 6 | r >> 4));
+    }
+    for (int i = 0; i < rgb_done; i++)
+    {
+        REQUIRE(rgb[i * 3] == src[i * 3 + 2]);
+        REQUIRE(rgb[i * 3 + 1] == src[i * 3 + 1]);
+        REQUIRE(rgb[i * 3 + 2] == src[i * 3]);
+    }
+}
+
+TEST_CASE("NEON RAW10 unpacking matches the generic code", "[neon]") {
+    const int N = 100; // Not a multiple of the vector width, the remainder is left to the generic code
+    std::vector<uint8_t> src(N * 2);
+    for (size_t i = 0; i < src.size(); i++) src[i] = static_cast<uint8_t>(i * 53 + 7);
+
+    std::vector<uint8_t> rw8(N), y8(N);
+    uint8_t* rw8_dest[] = { rw8.data() };
+    uint8_t* y8_dest[] = { y8.data() };
+
+    auto rw8_done = librealsense::unpack_rw10_from_rw8_neon(rw8_dest, src.data(), N);
+    auto y8_done = librealsense::unpack_y8_from_rw10_neon(y8_dest, src.data(), N);
+    REQUIRE(rw8_done == N / 16 * 16);
+    REQUIRE(y8_done % 4 == 0);
+    REQUIRE(y8_done > 0);
+
+    for (int i = 0; i < rw8_done; i++)
+    {
+        int pixel = (src[i * 2 + 1] << 8 | src[i * 2]) >> 2;
+        REQUIRE(rw8[i] == static_cast<uint8_t>(pixel > 255 ? 255 : pixel));
+    }
+    for (int i = 0; i < y8_done; i++)
+        REQUIRE(y8[i] == src[i / 4 * 5 + i % 4]);
+}
+#endif
+#if defined(__SSSE3__) && !defined(ANDROID) && (defined(__AVX2__) || defined(RS2_USE_AVX2_UNPACKERS))
+#include "../src/image_avx.h"
+
+TEST_CASE("AVX2 Y12I unpacking matches the generic code", "[avx2]") {
+    if (!__builtin_cpu_supports("avx2")) return;
+
+    const int N = 50; // Not a multiple of the vector width, the remainder is left to the generic code
+    std::vector<uint8_t> src(N * 3);
+    for (size_t i = 0; i < src.size(); i++) src[i] = static_cast<uint8_t>(i * 53 + 7);
+
+    std::vector<uint16_t> left16(N), right16(N);
+    uint8_t* y12i_dest[] = { reinterpret_cast<uint8_t*>(left16.data()), reinterpret_cast<uint8_t*>(right16.data()) };
+
+    auto y12i_done = librealsense::unpack_y16_y16_from_y12i_10_avx(y12i_dest, src.data(), N);
+    REQUIRE(y12i_done == N / 16 * 16);
+
+    for (int i = 0; i < y12i_done; i++)
+    {
+        int l = src[i * 3 + 2] << 4 | src[i * 3 + 1] >> 4;
+        int r = (src[i * 3 + 1] & 0x0f) << 8 | src[i * 3];
+        REQUIRE(left16[i] == static_cast<uint16_t>(l << 6 | l >> 4));
+        REQUIRE(right16[i] == static_cast<uint16_t>(r << 6 | r >> 4));
+    }
+}
+#endif
+#ifdef RS2_TEST_KERNELS
+#include "../src/image.h"
+
+// How closely a variant of a kernel is declared to follow the generic code
+struct kernel_tolerance
+{
+    double max_difference;      // Of an element from that of the generic code
+    double mismatch_fraction;   // Of the elements allowed beyond it, for kernels whose rounding may move a pixel to its neighbour
+};
+
+// Every SIMD level the CPU and the build support, the generic code first
+static std::vector<librealsense::simd_level> supported_simd_levels()
+{
+    using librealsense::simd_level;
+    auto best = librealsense::get_simd_level();
+    if (best == simd_level::neon)
+        return { simd_level::generic, simd_level::neon };
+    std::vector<simd_level> levels;
+    for (int level = 0; level <= static_cast<int>(best); level++)
+        levels.push_back(static_cast<simd_level>(level));
+    return levels;
+}
+
+// Runs the kernel at every level, and requires what it produced to match what the generic code did within the tolerance
+template<class T>
+void require_simd_equivalence(const std::function<std::vector<T>()>& kernel, const kernel_tolerance& tolerance)
+{
+    struct restore_simd_level { ~restore_simd_level() { librealsense::set_simd_level(librealsense::simd_level::count); } } restore;
+
+    auto levels = supported_simd_levels();
+    librealsense::set_simd_level(librealsense::simd_level::generic);
+    auto reference = kernel();
+    for (size_t i = 1; i < levels.size(); i++)
+    {
+        librealsense::set_simd_level(levels[i]);
+        auto result = kernel();
+
+        CAPTURE(librealsense::get_string(levels[i]));
+        REQUIRE(result.size() == reference.size());
+        size_t mismatches = 0, first_mismatch = 0;
+        for (size_t j = 0; j < result.size(); j++)
+            if (std::abs(static_cast<double>(result[j]) - static_cast<double>(reference[j])) > tolerance.max_difference && !mismatches++)
+                first_mismatch = j;
+        CAPTURE(mismatches);
+        CAPTURE(first_mismatch);
+        REQUIRE(mismatches <= tolerance.mismatch_fraction * result.size());
+    }
+}
+
+static const kernel_tolerance exact = { 0, 0 };
+static const kernel_tolerance yuv_to_color_tolerance = { 2, 0 };
+
+static bool is_color_format(rs2_format format)
+{
+    return format == RS2_FORMAT_RGB8 || format == RS2_FORMAT_RGBA8 || format == RS2_FORMAT_BGR8 || format == RS2_FORMAT_BGRA8;
+}
+
+// Bytes of the inputs: random, and the extremes kernels tend to get wrong
+enum class kernel_input { random, zeros, saturated };
+
+static std::vector<uint8_t> make_kernel_input(kernel_input input, size_t size, uint32_t seed)
+{
+    std::vector<uint8_t> bytes(size, input == kernel_input::saturated ? 0xff : 0);
+    if (input == kernel_input::random)
+        for (auto&& b : bytes)
+        {
+            seed = seed * 1664525 + 1013904223;
+            b = static_cast<uint8_t>(seed >> 24);
+        }
+    return bytes;
+}
+
+TEST_CASE("SIMD unpackers match the generic code", "[simd]") {
+    using namespace librealsense;
+    const std::vector<std::pair<std::string, const native_pixel_format*>> formats = {
+        { "z16", &pf_z16 },{ "invz", &pf_invz },{ "y8", &pf_y8 },{ "y8i", &pf_y8i },{ "y16", &pf_y16 },{ "y12i", &pf_y12i },
+        { "yuy2", &pf_yuy2 },{ "yuyv", &pf_yuyv },{ "yuy2_downscaled", &pf_yuy2_downscaled },{ "yuyv_downscaled", &pf_yuyv_downscaled },
+        { "uyvyl", &pf_uyvyl },{ "rgb888", &pf_rgb888 },{ "raw8", &pf_raw8 },
+        { "rw10", &pf_rw10 },{ "w10", &pf_w10 },{ "rw16", &pf_rw16 },{ "bayer16", &pf_bayer16 },{ "f200_invi", &pf_f200_invi },
+        { "f200_inzi", &pf_f200_inzi },{ "sr300_invi", &pf_sr300_invi },{ "sr300_inzi", &pf_sr300_inzi },
+        { "confidence_l500", &pf_confidence_l500 },{ "z16_l500", &pf_z16_l500 },{ "y8_l500", &pf_y8_l500 } };
+    // Widths off the vector widths, which leave remainders to the generic code
+    const std::vector<int> widths = { 1, 3, 6, 17, 34, 66, 641 };
+    const size_t guard = 64;
+    const uint8_t guard_value = 0xa5;
+
+    for (auto&& format : formats)
+    {
+        // The 10-bit formats pack four pixels together, and the chroma subsampled ones two, and convert sixteen pixels at a time
+        auto packed = format.first == "rw10" || format.first == "w10";
+        auto subsampled = format.first.find("yuy") == 0 || format.first == "uyvyl";
+        auto granularity = packed ? 4 : subsampled ? 2 : 1;
+        std::vector<int> heights = { 16 };
+        if (granularity == 1)
+            heights.insert(heights.end(), { 1, 3 });
+        // The L500 frames are rotated 8x8 pixels at a time, which leaves edges off the tiles on both sides
+        if (format.first.find("_l500") != std::string::npos)
+            heights.push_back(19);
+
+        for (auto&& unpacker : format.second->unpackers)
+        {
+            // The vector code converts the chroma into color in fixed point, off the generic code by up to two levels
+            auto tolerance = subsampled && is_color_format(unpacker.outputs.front().format) ? yuv_to_color_tolerance : exact;
+            for (auto w : widths)
+                for (auto height : heights)
+                    for (auto input : { kernel_input::random, kernel_input::zeros, kernel_input::saturated })
+                        for (int offset : { 0, 2 })  // Off the alignment of the vector loads and stores
+                        {
+                            auto width = (w + granularity - 1) / granularity * granularity;
+                            CAPTURE(format.first);
+                            CAPTURE(rs2_format_to_string(unpacker.outputs.front().format));
+                            CAPTURE(width);
+                            CAPTURE(height);
+                            CAPTURE(static_cast<int>(input));
+                            CAPTURE(offset);
+
+                            // The native size is that of the bytes per pixel, beyond which the 10-bit formats read
+                            auto source = make_kernel_input(input, format.second->get_image_size(width, height) * 2 + offset, width * 31 + height);
+                            require_simd_equivalence<uint8_t>([&]() {
+                                std::vector<std::vector<uint8_t>> outputs;
+                                for (auto&& o : unpacker.outputs)
+                                {
+                                    auto res = o.stream_resolution({ static_cast<uint32_t>(width), static_cast<uint32_t>(height) });
+                                    outputs.emplace_back(offset + get_image_size(res.width, res.height, o.format) + guard, guard_value);
+                                }
+                                std::vector<byte*> dest;
+                                for (auto&& o : outputs)
+                                    dest.push_back(o.data() + offset);
+                                unpacker.unpack(dest.data(), source.data() + offset, width, height);
+
+                                // The guards after the images catch the variants writing past them
+                                std::vector<uint8_t> result;
+                                for (auto&& o : outputs)
+                                    result.insert(result.end(), o.begin(), o.end());
+                                return result;
+                            }, tolerance);
+                        }
+        }
+    }
+}
+
+TEST_CASE("Y12I unpacking at every SIMD level matches the bit layout", "[simd]") {
+    using namespace librealsense;
+    struct restore_simd_level { ~restore_simd_level() { set_simd_level(simd_level::count); } } restore;
+
+    // A calibration IR row and an odd size, which leaves remainders to the generic code after the vector loops
+    for (auto&& size : { std::make_pair(1280, 4), std::make_pair(1283, 3) })
+    {
+        auto count = size.first * size.second;
+        auto src = make_kernel_input(kernel_input::random, count * 3, count);
+
+        for (auto level : supported_simd_levels())
+        {
+            CAPTURE(size.first);
+            CAPTURE(get_string(level));
+            set_simd_level(level);
+
+            std::vector<uint16_t> left16(count), right16(count);
+            uint8_t* dest[] = { reinterpret_cast<uint8_t*>(left16.data()), reinterpret_cast<uint8_t*>(right16.data()) };
+            pf_y12i.unpackers.front().unpack(dest, src.data(), size.first, size.second);
+
+            size_t mismatches = 0;
+            for (int i = 0; i < count; i++)
+            {
+                int l = src[i * 3 + 2] << 4 | src[i * 3 + 1] >> 4;
+                int r = (src[i * 3 + 1] & 0x0f) << 8 | src[i * 3];
+                if (left16[i] != static_cast<uint16_t>(l << 6 | l >> 4) || right16[i] != static_cast<uint16_t>(r << 6 | r >> 4))
+                    mismatches++;
+            }
+            REQUIRE(mismatches == 0);
+        }
+    }
+}
+
+TEST_CASE("Only the downscaled YUY2 tables offer resolutions the sensor does not stream", "[simd]") {
+    using namespace librealsense;
+    const resolution native = { 640, 480 };
+    const std::vector<std::pair<const native_pixel_format*, const native_pixel_format*>> tables = {
+        { &pf_yuy2, &pf_yuy2_downscaled },{ &pf_yuyv, &pf_yuyv_downscaled } };
+
+    for (auto&& t : tables)
+    {
+        for (auto&& unpacker : t.first->unpackers)
+            for (auto&& o : unpacker.outputs)
+            {
+                auto res = o.stream_resolution(native);
+                REQUIRE(res.width == native.width);
+                REQUIRE(res.height == native.height);
+            }
+
+        // Every output of the plain table, followed by the color formats at a half and at a quarter of the resolution
+        REQUIRE(t.second->fourcc == t.first->fourcc);
+        REQUIRE(t.second->unpackers.size() == t.first->unpackers.size() + 8);
+        for (size_t i = 0; i < t.first->unpackers.size(); i++)
+        {
+            REQUIRE(t.second->unpackers[i].unpack == t.first->unpackers[i].unpack);
+            REQUIRE(t.second->unpackers[i].outputs.front().format == t.first->unpackers[i].outputs.front().format);
+        }
+        for (uint32_t scale : { 2u, 4u })
+            for (auto format : { RS2_FORMAT_RGB8, RS2_FORMAT_RGBA8, RS2_FORMAT_BGR8, RS2_FORMAT_BGRA8 })
+            {
+                CAPTURE(scale);
+                CAPTURE(rs2_format_to_string(format));
+                auto found = std::count_if(t.second->unpackers.begin(), t.second->unpackers.end(), [&](const pixel_format_unpacker& u)
+                {
+                    auto res = u.outputs.front().stream_resolution(native);
+                    return u.outputs.front().format == format && res.width == native.width / scale && res.height == native.height / scale;
+                });
+                REQUIRE(found == 1);
+            }
+    }
+}
+
+TEST_CASE("YUY2 and UYVY unpack into the planes of NV12 and I420", "[simd]") {
+    using namespace librealsense;
+    const std::vector<std::pair<int, int>> sizes = { { 2, 2 },{ 18, 4 },{ 34, 6 },{ 642, 2 } };
+    for (auto uyvy : { false, true })
+        for (auto format : { RS2_FORMAT_NV12, RS2_FORMAT_I420 })
+        {
+            auto&& table = uyvy ? pf_uyvyl : pf_yuy2;
+            auto unpacker = std::find_if(table.unpackers.begin(), table.unpackers.end(),
+                [&](const pixel_format_unpacker& u) { return u.outputs.front().format == format; });
+            REQUIRE(unpacker != table.unpackers.end());
+            REQUIRE(unpacker->outputs.size() == 1);
+
+            for (auto&& size : sizes)
+            {
+                auto width = size.first, height = size.second;
+                CAPTURE(uyvy);
+                CAPTURE(rs2_format_to_string(format));
+                CAPTURE(width);
+                CAPTURE(height);
+
+                // The luma plane, then the chroma averaged over every two rows, interleaved for NV12 and planar for I420
+                auto source = make_kernel_input(kernel_input::random, width * height * 2, width * 3 + height);
+                std::vector<uint8_t> expected(width * height * 3 / 2);
+                auto chroma = expected.data() + width * height;
+                for (int y = 0; y < height; y++)
+                    for (int x = 0; x < width; x++)
+                        expected[y * width + x] = source[(y * width + x) * 2 + (uyvy ? 1 : 0)];
+                for (int y = 0; y < height / 2; y++)
+                    for (int x = 0; x < width / 2; x++)
+                    {
+                        auto top = source.data() + (y * 2 * width + x * 2) * 2;
+                        auto bottom = top + width * 2;
+                        auto u = (top[uyvy ? 0 : 1] + bottom[uyvy ? 0 : 1] + 1) / 2;
+                        auto v = (top[uyvy ? 2 : 3] + bottom[uyvy ? 2 : 3] + 1) / 2;
+                        if (format == RS2_FORMAT_NV12)
+                        {
+                            chroma[y * width + x * 2] = static_cast<uint8_t>(u);
+                            chroma[y * width + x * 2 + 1] = static_cast<uint8_t>(v);
+                        }
+                        else
+                        {
+                            chroma[y * width / 2 + x] = static_cast<uint8_t>(u);
+                            chroma[width * height / 4 + y * width / 2 + x] = static_cast<uint8_t>(v);
+                        }
+                    }
+
+                REQUIRE(get_image_size(width, height, format) == expected.size());
+                for (auto level : supported_simd_levels())
+                {
+                    CAPTURE(get_string(level));
+                    set_simd_level(level);
+                    std::vector<uint8_t> actual(expected.size() + 16, 0xa5);
+                    uint8_t* const dest[] = { actual.data() };
+                    unpacker->unpack(dest, source.data(), width, height);
+                    REQUIRE(std::vector<uint8_t>(actual.begin(), actual.begin() + expected.size()) == expected);
+                    REQUIRE(std::count(actual.begin() + expected.size(), actual.end(), 0xa5) == 16);
+                }
+                set_simd_level(simd_level::count);
+            }
+        }
+}
+
+TEST_CASE("SIMD image copies match the generic code at any stride", "[simd]") {
+    using namespace librealsense;
+    const std::vector<std::pair<rs2_format, rs2_format>> conversions = {
+        { RS2_FORMAT_YUYV, RS2_FORMAT_Y8 },{ RS2_FORMAT_YUYV, RS2_FORMAT_Y16 },{ RS2_FORMAT_YUYV, RS2_FORMAT_RGB8 },
+        { RS2_FORMAT_YUYV, RS2_FORMAT_RGBA8 },{ RS2_FORMAT_YUYV, RS2_FORMAT_BGR8 },{ RS2_FORMAT_YUYV, RS2_FORMAT_BGRA8 },
+        { RS2_FORMAT_UYVY, RS2_FORMAT_RGB8 },{ RS2_FORMAT_UYVY, RS2_FORMAT_RGBA8 },{ RS2_FORMAT_UYVY, RS2_FORMAT_BGR8 },
+        { RS2_FORMAT_UYVY, RS2_FORMAT_BGRA8 },{ RS2_FORMAT_Y8, RS2_FORMAT_Y16 },{ RS2_FORMAT_BGR8, RS2_FORMAT_RGB8 },
+        { RS2_FORMAT_RGB8, RS2_FORMAT_BGR8 },{ RS2_FORMAT_Z16, RS2_FORMAT_Z16 } };
+    const std::vector<std::pair<int, int>> sizes = { { 2, 1 },{ 6, 3 },{ 18, 5 },{ 34, 4 },{ 642, 3 } };
+
+    for (auto&& c : conversions)
+        for (auto&& size : sizes)
+            for (int padding : { 0, 1, 7 })    // Bytes past the end of each row, leaving the rows off any alignment
+            {
+                auto width = size.first, height = size.second;
+                auto subsampled = c.first == RS2_FORMAT_YUYV || c.first == RS2_FORMAT_UYVY;
+                auto source_stride = width * get_image_bpp(c.first) / 8 + padding;
+                auto dest_stride = width * get_image_bpp(c.second) / 8 + padding * 2;
+                CAPTURE(rs2_format_to_string(c.first));
+                CAPTURE(rs2_format_to_string(c.second));
+                CAPTURE(width);
+                CAPTURE(height);
+                CAPTURE(padding);
+
+                auto source = make_kernel_input(kernel_input::random, source_stride * height, width + padding);
+                require_simd_equivalence<uint8_t>([&]() {
+                    std::vector<uint8_t> dest(dest_stride * height + 64, 0xa5);
+                    REQUIRE(copy_image(dest.data(), dest_stride, c.second, source.data(), source_stride, c.first, width, height));
+                    return dest;
+                }, subsampled && is_color_format(c.second) ? yuv_to_color_tolerance : exact);
+            }
+}
+
+TEST_CASE("Cropped regions ending at the frame edge unpack as the full frames", "[simd]") {
+    using namespace librealsense;
+    // A 424-wide YUY2 frame, cropped past its first 16 columns to a width of 408, and in full rows over an odd row count.
+    // Neither region is a whole number of the 16-pixel steps of the kernels
+    const int frame_width = 424, frame_height = 4;
+    const std::vector<std::pair<int, int>> regions = { { 16, 408 },{ 0, 424 } };
+    for (auto format : { RS2_FORMAT_RGB8, RS2_FORMAT_Y16 })
+    {
+        auto unpacker = std::find_if(pf_yuy2.unpackers.begin(), pf_yuy2.unpackers.end(),
+            [&](const pixel_format_unpacker& u) { return u.outputs.front().format == format; });
+        REQUIRE(unpacker != pf_yuy2.unpackers.end());
+        auto bpp = get_image_bpp(format) / 8;
+
+        auto source = make_kernel_input(kernel_input::random, frame_width * frame_height * 2, frame_width + frame_height);
+        for (auto&& region : regions)
+            for (auto level : supported_simd_levels())
+            {
+                auto x = region.first, width = region.second, y = 1, rows = 3;
+                CAPTURE(rs2_format_to_string(format));
+                CAPTURE(x);
+                CAPTURE(width);
+                CAPTURE(get_string(level));
+                set_simd_level(level);
+
+                std::vector<uint8_t> frame(frame_width * frame_height * bpp);
+                uint8_t* const frame_dest[] = { frame.data() };
+                unpacker->unpack(frame_dest, source.data(), frame_width, frame_height);
+                std::vector<uint8_t> expected;
+                for (int row = y; row < y + rows; row++)
+                {
+                    auto begin = frame.begin() + (row * frame_width + x) * bpp;
+                    expected.insert(expected.end(), begin, begin + width * bpp);
+                }
+                std::vector<uint8_t> actual(expected.size() + 64, 0xa5);
+                uint8_t* const dest[] = { actual.data() };
+                unpack_cropped_rows(*unpacker, dest, source.data() + (y * frame_width + x) * 2, frame_width * 2, 2, width, rows);
+                REQUIRE(std::vector<uint8_t>(actual.begin(), actual.begin() + expected.size()) == expected);
+                REQUIRE(std::count(actual.begin() + expected.size(), actual.end(), 0xa5) == 64);
+            }
+        set_simd_level(simd_level::count);
+    }
+}
+
+// Depth of a few meters, with holes and runs of zeros, and the color of the same software device
+class simd_test_frames
+{
+public:
+    simd_test_frames(int width, int height)
+    {
+        auto random = make_kernel_input(kernel_input::random, width * height, width * 7 + height);
+        _depth.resize(width * height);
+        for (int i = 0; i < width * height; i++)
+        {
+            auto zero_run = (i / width) % 5 == 2 && (i % width) < width / 3;
+            _depth[i] = zero_run || random[i] < 20 ? 0 : static_cast<uint16_t>(400 + (i % width) * 3 + random[i] * 8);
+        }
+        _color = make_kernel_input(kernel_input::random, width * height * 3, width + height);
+
+        auto s = _dev.add_sensor("software_sensor");
+        s.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+        rs2_intrinsics depth_intrinsics{ width, height, width / 2.f, height / 2.f, width * 0.9f, width * 0.9f, RS2_DISTORTION_NONE,{ 0,0,0,0,0 } };
+        rs2_intrinsics color_intrinsics{ width, height, width / 2.f + 1.5f, height / 2.f - 0.5f, width * 0.95f, width * 0.95f,
+            RS2_DISTORTION_MODIFIED_BROWN_CONRADY,{ 0.1f, -0.05f, 0.001f, 0.001f, 0 } };
+        auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, width, height, 30, 2, RS2_FORMAT_Z16, depth_intrinsics });
+        auto color = s.add_video_stream({ RS2_STREAM_COLOR, 0, 1, width, height, 30, 3, RS2_FORMAT_RGB8, color_intrinsics });
+        depth.register_extrinsics_to(color, { { 1,0,0,0,1,0,0,0,1 },{ 0.015f,0.001f,0 } });
+
+        syncer sync;
+        s.open({ depth, color });
+        s.start(sync);
+        s.on_video_frame({ _depth.data(), [](void*) {}, width * 2, 2, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 0, depth });
+        s.on_video_frame({ _color.data(), [](void*) {}, width * 3, 3, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 0, color });
+        frames = sync.wait_for_frames();
+        s.stop();
+        s.close();
+    }
+
+    frameset frames;
+
+private:
+    software_device _dev;
+    std::vector<uint16_t> _depth;
+    std::vector<uint8_t> _color;
+};
+
+template<class T>
+static std::vector<T> frame_elements(const video_frame& f)
+{
+    auto data = reinterpret_cast<const T*>(f.get_data());
+    return std::vector<T>(data, data + f.get_height() * f.get_stride_in_bytes() / sizeof(T));
+}
+
+TEST_CASE("SIMD processing blocks match the generic code", "[simd][software-device]") {
+    // Widths of the remainders of the vector loops, and of a whole number of them
+    for (auto&& size : { std::make_pair(61, 37), std::make_pair(640, 480) })
+    {
+        CAPTURE(size.first);
+        CAPTURE(size.second);
+        simd_test_frames input(size.first, size.second);
+
+        SECTION("Colorizer")
+        {
+            require_simd_equivalence<uint8_t>([&]() {
+                rs2::colorizer block;
+                return frame_elements<uint8_t>(block.process(input.frames.get_depth_frame()));
+            }, exact);
+        }
+        SECTION("Pointcloud")
+        {
+            // The vertices within ten micrometers, the vector code multiplying in another order
+            require_simd_equivalence<float>([&]() {
+                rs2::pointcloud block;
+                auto points = block.calculate(input.frames.get_depth_frame());
+                auto vertices = reinterpret_cast<const float*>(points.get_vertices());
+                return std::vector<float>(vertices, vertices + points.size() * 3);
+            }, { 1e-5, 0 });
+        }
+        SECTION("Pointcloud texture coordinates")
+        {
+            require_simd_equivalence<float>([&]() {
+                rs2::pointcloud block;
+                block.map_to(input.frames.get_color_frame());
+                auto points = block.calculate(input.frames.get_depth_frame());
+                auto coordinates = reinterpret_cast<const float*>(points.get_texture_coordinates());
+                return std::vector<float>(coordinates, coordinates + points.size() * 2);
+            }, { 1e-5, 0 });
+        }
+        SECTION("Pointcloud occlusion removal")
+        {
+            // The texels of the exhaustive filter are indexed in SIMD lanes, and both filters run in bands on the workers
+            for (auto filter : { 1.f, 2.f })
+                for (auto parallel : { false, true })
+                {
+                    CAPTURE(filter);
+                    CAPTURE(parallel);
+                    require_simd_equivalence<float>([&]() {
+                        rs2::pointcloud block;
+                        block.set_option(RS2_OPTION_FILTER_MAGNITUDE, filter);
+                        if (parallel)
+                            block.set_option(RS2_OPTION_PROCESSING_THREADS, block.get_option_range(RS2_OPTION_PROCESSING_THREADS).max);
+                        block.map_to(input.frames.get_color_frame());
+                        auto points = block.calculate(input.frames.get_depth_frame());
+                        auto coordinates = reinterpret_cast<const float*>(points.get_texture_coordinates());
+                        return std::vector<float>(coordinates, coordinates + points.size() * 2);
+                    }, { 1e-5, 0 });
+                }
+        }
+        SECTION("Align to color")
+        {
+            // Rounding may project a pixel onto its neighbour
+            require_simd_equivalence<uint16_t>([&]() {
+                rs2::align block(RS2_STREAM_COLOR);
+                return frame_elements<uint16_t>(block.process(input.frames).get_depth_frame());
+            }, { 0, 0.001 });
+        }
+        SECTION("Align to depth")
+        {
+            require_simd_equivalence<uint8_t>([&]() {
+                rs2::align block(RS2_STREAM_DEPTH);
+                return frame_elements<uint8_t>(block.process(input.frames).get_color_frame());
+            }, { 0, 0.001 });
+        }
+    }
+}
+#endif
+#ifdef RS2_TEST_KERNELS
+#include "../src/motion-history.h"
+
+TEST_CASE("Motion history queries time ranges of the latest samples", "[motion-history]") {
+    using librealsense::motion_history;
+    motion_history history;
+    std::vector<double> timestamps(motion_history::capacity);
+    std::vector<rs2_vector> motion(motion_history::capacity);
+
+    REQUIRE(history.query(0, 1e9, timestamps.data(), motion.data(), static_cast<int>(timestamps.size())) == 0);
+
+    // A sample every 5 ms, for twice what the history holds
+    const int samples = 2 * motion_history::capacity;
+    for (int i = 0; i < samples; i++)
+        history.record(i * 5., { float(i), float(-i), float(i * 2) });
+
+    SECTION("Ranges within the history")
+    {
+        auto n = history.query(samples * 5. - 100, samples * 5. - 50, timestamps.data(), motion.data(), static_cast<int>(timestamps.size()));
+        REQUIRE(n == 11);
+        for (int k = 0; k < n; k++)
+        {
+            auto i = samples - 20 + k;
+            REQUIRE(timestamps[k] == i * 5.);
+            REQUIRE(motion[k].x == float(i));
+            REQUIRE(motion[k].y == float(-i));
+            REQUIRE(motion[k].z == float(i * 2));
+        }
+    }
+    SECTION("Ranges past the oldest sample kept")
+    {
+        auto n = history.query(0, 1e9, nullptr, nullptr, samples);
+        REQUIRE(n == static_cast<int>(motion_history::capacity));
+        REQUIRE(history.query(0, 1e9, timestamps.data(), nullptr, 1) == 1);
+        REQUIRE(timestamps[0] == (samples - motion_history::capacity) * 5.);
+        REQUIRE(history.query(0, 100, timestamps.data(), nullptr, 1) == 0);
+    }
+    SECTION("Ranges with no sample")
+    {
+        REQUIRE(history.query(samples * 5., 1e9, nullptr, nullptr, 1) == 0);
+        REQUIRE(history.query(samples * 5. - 4, samples * 5. - 6, nullptr, nullptr, 1) == 0);
+    }
+}
+#endif
+#ifdef RS2_TEST_KERNELS
+#include "../src/pose-prediction.h"
+
+TEST_CASE("Pose prediction extrapolates the latest pose", "[pose-prediction]") {
+    librealsense::latest_pose latest;
+    double timestamp;
+    rs2_pose pose = {};
+    REQUIRE(!latest.get(timestamp, pose));
+
+    pose.translation = { 1, 0, 0 };
+    pose.velocity = { 0, 2, 0 };
+    pose.acceleration = { 0, 0, 4 };
+    pose.rotation = { 0, 0, 0, 1 };
+    pose.angular_velocity = { 0, 0, 1 };
+    pose.tracker_confidence = 3;
+    for (int i = 0; i < 10; i++)
+        latest.record(1000. + i, pose);
+
+    rs2_pose got;
+    REQUIRE(latest.get(timestamp, got));
+    REQUIRE(timestamp == 1009.);
+    REQUIRE(got.tracker_confidence == 3);
+
+    // A second ahead: a turn of a radian around Z
+    auto predicted = librealsense::predict_pose(got, 1000);
+    REQUIRE(predicted.translation.x == Approx(1));
+    REQUIRE(predicted.translation.y == Approx(2));
+    REQUIRE(predicted.translation.z == Approx(2));
+    REQUIRE(predicted.velocity.z == Approx(4));
+    REQUIRE(predicted.rotation.z == Approx(std::sin(.5)));
+    REQUIRE(predicted.rotation.w == Approx(std::cos(.5)));
+    REQUIRE(predicted.tracker_confidence == 3);
+}
+#endif
+#ifdef RS2_TEST_KERNELS
+#include "../src/load-governor.h"
+
+TEST_CASE("Load governor degrades under load and settles as it subsides", "[load-governor]") {
+    using librealsense::load_governor;
+    load_governor governor(50.f, 3);
+
+    // A frameset every 10 ms, delivered with the latency, and the times the level changed
+    double now = 0;
+    auto run = [&](double latency_ms, double duration_ms)
+    {
+        std::vector<double> changes;
+        for (auto end = now + duration_ms; now < end; now += 10)
+        {
+            auto changed = governor.on_queued(now, false);
+            changed |= governor.on_delivered(now, latency_ms);
+            if (changed)
+                changes.push_back(now);
+        }
+        return changes;
+    };
+
+    // A level every other window, the windows after a change being left out, up to the last level
+    REQUIRE(run(100, 2000) == std::vector<double>({ 250, 750, 1250 }));
+    REQUIRE(governor.get_level() == 3);
+
+    // Restored after a second of low load, a level at a time
+    REQUIRE(run(10, 3000) == std::vector<double>({ 3000, 4250 }));
+    REQUIRE(governor.get_level() == 1);
+
+    // The load returning right after the restore, the next restore waits twice as long
+    REQUIRE(run(100, 500) == std::vector<double>({ 5250 }));
+    REQUIRE(run(10, 3000) == std::vector<double>({ 7500 }));
+    REQUIRE(governor.get_level() == 1);
+
+    // Framesets the queue drops count as load, latency or not
+    for (int i = 0; i < 50; i++, now += 10)
+        governor.on_queued(now, i % 2 == 0);
+    REQUIRE(governor.get_level() == 2);
+
+    // Between the bounds, the level stays
+    REQUIRE(run(40, 3000).empty());
+
+    auto level = librealsense::load_level::of({ RS2_LOAD_ACTION_RAISE_DECIMATION, RS2_LOAD_ACTION_HALVE_RATE,
+        RS2_LOAD_ACTION_SKIP_TEMPORAL, RS2_LOAD_ACTION_HALVE_RATE }, 2);
+    REQUIRE(level.decimation_raise == 1);
+    REQUIRE(level.rate_divider == 2);
+    REQUIRE_FALSE(level.skip_temporal);
+    REQUIRE_FALSE(level.drop_streams);
+}
+#endif
+
+#ifdef RS2_TEST_KERNELS
+#include "../src/types.h"
+
+TEST_CASE("Atomic wraparound accumulates as the arithmetic one", "[timestamps]") {
+    // Rolling 32-bit timestamps that wrap around more than four times
+    std::vector<uint32_t> inputs;
+    uint32_t t = 0xfffff000u;
+    for (int i = 0; i < 4000; i++, t += 0x400000u + i)
+        inputs.push_back(t);
+
+    librealsense::arithmetic_wraparound<uint32_t, uint64_t> reference;
+    librealsense::atomic_wraparound wrap;
+    for (auto input : inputs)
+        REQUIRE(wrap.calc(input) == reference.calc(input));
+    REQUIRE(wrap.calc(inputs.back()) > 4 * uint64_t(std::numeric_limits<uint32_t>::max()));
+
+    wrap.reset();
+    reference.reset();
+    REQUIRE(wrap.calc(12345) == reference.calc(12345));
+}
+#endif
+
+// The CUDA depth filters are only run by the filters once BUILD_WITH_CUDA_DEPTH_FILTERS is set, so it is the CPU filters that the
+// kernels are compared against, on the GPU they are about to be enabled for
+#if defined(RS2_TEST_KERNELS) && defined(RS2_USE_CUDA) && !defined(RS2_USE_CUDA_DEPTH_FILTERS)
+#include "../src/cuda/cuda-depth-filters.cuh"
+
+TEST_CASE("CUDA depth filters match the CPU filters", "[software-device][post-processing][cuda]") {
+    const int W = 640;
+    const int H = 480;
+    const int BPP = 2;
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+    s.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+    s.add_read_only_option(RS2_OPTION_STEREO_BASELINE, 0.05f);
+
+    rs2_intrinsics intrinsics{ W, H, W / 2.f, H / 2.f, 380, 380, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+
+    // Defaults but for the hole filling of the spatial filter, with a radius of 4, and a temporal persistence of all 1's
+    rs2::disparity_transform to_disparity(true);
+    rs2::spatial_filter spatial, spatial_disparity;
+    rs2::temporal_filter temporal;
+    rs2::hole_filling_filter hole_filling[3];
+    for (auto filter : { &spatial, &spatial_disparity })
+        filter->set_option(RS2_OPTION_HOLES_FILL, 2);
+    temporal.set_option(RS2_OPTION_HOLES_FILL, 8);
+    for (int mode = 0; mode < 3; mode++)
+        hole_filling[mode].set_option(RS2_OPTION_HOLES_FILL, float(mode));
+    uint8_t persistence_map[256];
+    std::fill(std::begin(persistence_map), std::end(persistence_map), uint8_t(0xff));
+
+    rscuda::depth_filters_cuda cuda, cuda_temporal;
+    auto require_equal = [&](const rs2::frame& reference, const std::vector<uint8_t>& result)
+    {
+        auto vf = reference.as<rs2::video_frame>();
+        REQUIRE(result.size() == size_t(vf.get_stride_in_bytes() * vf.get_height()));
+        REQUIRE(memcmp(result.data(), reference.get_data(), result.size()) == 0);
+    };
+
+    frame_queue q;
+    s.open(depth);
+    s.start(q);
+
+    std::vector<uint16_t> pixels(W * H);
+    for (int frame = 0; frame < 4; frame++)
+    {
+        // Holes, and values at the top of the range for the blends to saturate at
+        for (int i = 0; i < W * H; i++)
+            pixels[i] = (i + frame) % 7 ? static_cast<uint16_t>(i % 11 ? 500 + (i * 13 + frame * 7) % 3000 : 65500 + (i + frame) % 36) : 0;
+        s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, frame, depth });
+        auto f = q.wait_for_frame();
+        std::vector<uint8_t> result(W * H * BPP);
+
+        CAPTURE(frame);
+        cuda.upload(f.get_data(), W, H, false);
+        cuda.spatial(0.5f, 20.f, 2, 4, true);
+        cuda.download(result.data());
+        require_equal(spatial.process(f), result);
+
+        auto disparity = to_disparity.process(f);
+        std::vector<uint8_t> disparity_result(W * H * sizeof(float));
+        cuda.upload(disparity.get_data(), W, H, true);
+        cuda.spatial(0.5f, 20.f, 2, 4, true);
+        cuda.download(disparity_result.data());
+        require_equal(spatial_disparity.process(disparity), disparity_result);
+
+        cuda_temporal.upload(f.get_data(), W, H, false);
+        cuda_temporal.temporal(0.4f, 1.f - 0.4f, 20, persistence_map, uint8_t(frame % 8), frame == 0);
+        cuda_temporal.download(result.data());
+        require_equal(temporal.process(f), result);
+
+        for (int mode = 0; mode < 3; mode++)
+        {
+            CAPTURE(mode);
+            cuda.upload(f.get_data(), W, H, false);
+            cuda.hole_filling(mode);
+            cuda.download(result.data());
+            require_equal(hole_filling[mode].process(f), result);
+        }
+    }
+    s.stop();
+    s.close();
+}
+#endif
+
+#if defined(RS2_TEST_KERNELS) && defined(RS2_USE_CUDA)
+#include "../src/archive.h"
+
+TEST_CASE("Frames stay in host memory when the device has none left", "[software-device][cuda]") {
+    const int W = 64;
+    const int H = 48;
+    const int BPP = 2;
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+
+    rs2_intrinsics intrinsics{ W, H, 0, 0, 0, 0, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, intrinsics });
+
+    frame_queue q;
+    s.open(depth);
+    s.start(q);
+
+    std::vector<uint16_t> pixels(W * H);
+    for (int i = 0; i < W * H; i++)
+        pixels[i] = static_cast<uint16_t>(i);
+    s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 0, depth });
+    auto f = q.wait_for_frame();
+
+    // No device has the memory for this, so the frame is not made GPU-resident and keeps its host data
+    auto frame = dynamic_cast<librealsense::frame*>((librealsense::frame_interface*)f.get());
+    REQUIRE(frame);
+    REQUIRE(frame->alloc_device_data(size_t(1) << 50) == nullptr);
+    REQUIRE(frame->get_device_data() == nullptr);
+    REQUIRE_FALSE(rs2::gpu_frame(f));
+    REQUIRE(memcmp(f.get_data(), pixels.data(), W * H * BPP) == 0);
+
+    s.stop();
+    s.close();
+}
+#endif
+
+// YUY2 goes to the CUDA unpacking whenever CUDA is built in, ahead of any compute backend
+#if defined(RS2_TEST_KERNELS) && !defined(RS2_USE_CUDA)
+TEST_CASE("Compute backends unpack YUY2 and align as the CPU does", "[software-device][align]") {
+    const int W = 64;
+    const int H = 48;
+    const int CW = 96;
+    const int CH = 72;
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+    s.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+
+    rs2_intrinsics depth_intrinsics{ W, H, W / 2.f, H / 2.f, 50, 50, RS2_DISTORTION_NONE,{ 0,0,0,0,0 } };
+    rs2_intrinsics color_intrinsics{ CW, CH, CW / 2.f - 0.5f, CH / 2.f + 0.5f, 80, 80, RS2_DISTORTION_NONE,{ 0,0,0,0,0 } };
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 30, 2, RS2_FORMAT_Z16, depth_intrinsics });
+    auto color = s.add_video_stream({ RS2_STREAM_COLOR, 0, 1, CW, CH, 30, 3, RS2_FORMAT_RGB8, color_intrinsics });
+    depth.register_extrinsics_to(color, { { 1,0,0,0,1,0,0,0,1 },{ 0.015f,0.001f,0 } });
+
+    // A slanted surface with holes, and a color gradient
+    std::vector<uint16_t> depth_pixels(W * H);
+    for (int i = 0; i < W * H; i++)
+        depth_pixels[i] = i % 13 ? static_cast<uint16_t>(800 + (i % W) * 5 + (i / W) * 3) : 0;
+    std::vector<uint8_t> color_pixels(CW * CH * 3);
+    for (size_t i = 0; i < color_pixels.size(); i++)
+        color_pixels[i] = static_cast<uint8_t>(i * 7);
+    std::vector<uint8_t> yuy2(W * H * 2);
+    for (size_t i = 0; i < yuy2.size(); i++)
+        yuy2[i] = static_cast<uint8_t>(i * 29 + i / 7);
+
+    syncer sync;
+    s.open({ depth, color });
+    s.start(sync);
+    s.on_video_frame({ depth_pixels.data(), [](void*) {}, W * 2, 2, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 0, depth });
+    s.on_video_frame({ color_pixels.data(), [](void*) {}, CW * 3, 3, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 0, color });
+    auto frames = sync.wait_for_frames();
+    s.stop();
+    s.close();
+    REQUIRE(frames.size() == 2);
+
+    rs2::context ctx;
+    auto process = [&](rs2_compute_backend backend)
+    {
+        ctx.set_compute_backend(backend);
+        std::vector<std::vector<uint8_t>> results;
+        for (auto&& unpacker : librealsense::pf_yuy2.unpackers)
+        {
+            auto format = unpacker.outputs.front().format;
+            auto res = unpacker.outputs.front().stream_resolution({ W, H });
+            if (!unpacker.requires_processing || res.width != W || res.height != H || format == RS2_FORMAT_NV12 || format == RS2_FORMAT_I420)
+                continue;
+            results.emplace_back(W * H * librealsense::get_image_bpp(format) / 8);
+            uint8_t* const dest[] = { results.back().data() };
+            unpacker.unpack(dest, yuy2.data(), W, H);
+        }
+        for (auto to : { RS2_STREAM_COLOR, RS2_STREAM_DEPTH })
+        {
+            rs2::align align(to);
+            auto aligned = align.process(frames);
+            auto f = to == RS2_STREAM_COLOR ? rs2::video_frame(aligned.get_depth_frame()) : aligned.get_color_frame();
+            auto data = static_cast<const uint8_t*>(f.get_data());
+            results.emplace_back(data, data + f.get_height() * f.get_stride_in_bytes());
+        }
+        return results;
+    };
+
+    auto expected = process(RS2_COMPUTE_BACKEND_CPU);
+    for (int i = 0; i < RS2_COMPUTE_BACKEND_COUNT; i++)
+    {
+        auto backend = rs2_compute_backend(i);
+        if (!ctx.is_compute_backend_available(backend))
+            continue;
+        CAPTURE(rs2_compute_backend_to_string(backend));
+        auto actual = process(backend);
+        REQUIRE(actual.size() == expected.size());
+
+        // The unpacking is integer math, and align is required to agree with the CPU but for the pixels at the edges of
+        // the projected ones, which float math on another device may move to their neighbour
+        size_t unpacked = actual.size() - 2;
+        for (size_t j = 0; j < unpacked; j++)
+            REQUIRE(actual[j] == expected[j]);
+        for (size_t j = unpacked; j < actual.size(); j++)
+        {
+            REQUIRE(actual[j].size() == expected[j].size());
+            size_t mismatches = 0;
+            for (size_t k = 0; k < actual[j].size(); k++)
+                mismatches += actual[j][k] != expected[j][k];
+            REQUIRE(mismatches <= actual[j].size() / 100);
+        }
+    }
+    ctx.set_compute_backend(RS2_COMPUTE_BACKEND_CPU);
+}
+#endif
+
+// As the depth filters, align only runs on CUDA once BUILD_WITH_CUDA_ALIGN is set, and the kernels are compared against the CPU align
+#if defined(RS2_TEST_KERNELS) && defined(RS2_USE_CUDA) && !defined(RS2_USE_CUDA_ALIGN)
+#include "../src/cuda/cuda-align.cuh"
+
+TEST_CASE("CUDA align matches the CPU align", "[software-device][align][cuda]") {
+    const int W = 64;
+    const int H = 48;
+    const int CW = 96;
+    const int CH = 72;
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+    s.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+
+    rs2_intrinsics depth_intrinsics{ W, H, W / 2.f, H / 2.f, 50, 50, RS2_DISTORTION_NONE,{ 0,0,0,0,0 } };
+    rs2_intrinsics color_intrinsics{ CW, CH, CW / 2.f - 0.5f, CH / 2.f + 0.5f, 80, 80, RS2_DISTORTION_NONE,{ 0,0,0,0,0 } };
+    rs2_extrinsics depth_to_color{ { 1,0,0,0,1,0,0,0,1 },{ 0.015f,0.001f,0 } };
+    auto depth = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 30, 2, RS2_FORMAT_Z16, depth_intrinsics });
+    auto color = s.add_video_stream({ RS2_STREAM_COLOR, 0, 1, CW, CH, 30, 3, RS2_FORMAT_RGB8, color_intrinsics });
+    depth.register_extrinsics_to(color, depth_to_color);
+
+    // A slanted surface with holes, and a color gradient
+    std::vector<uint16_t> depth_pixels(W * H);
+    for (int i = 0; i < W * H; i++)
+        depth_pixels[i] = i % 13 ? static_cast<uint16_t>(800 + (i % W) * 5 + (i / W) * 3) : 0;
+    std::vector<uint8_t> color_pixels(CW * CH * 3);
+    for (size_t i = 0; i < color_pixels.size(); i++)
+        color_pixels[i] = static_cast<uint8_t>(i * 7);
+
+    syncer sync;
+    s.open({ depth, color });
+    s.start(sync);
+    s.on_video_frame({ depth_pixels.data(), [](void*) {}, W * 2, 2, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 0, depth });
+    s.on_video_frame({ color_pixels.data(), [](void*) {}, CW * 3, 3, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 0, color });
+    auto frames = sync.wait_for_frames();
+    s.stop();
+    s.close();
+    REQUIRE(frames.size() == 2);
+
+    // Equal but for the pixels at the edges of the projected ones, which the float math of the GPU may move to their neighbour
+    auto require_close = [](const rs2::video_frame& reference, const std::vector<uint8_t>& result)
+    {
+        REQUIRE(result.size() == size_t(reference.get_height() * reference.get_stride_in_bytes()));
+        auto data = static_cast<const uint8_t*>(reference.get_data());
+        size_t mismatches = 0;
+        for (size_t i = 0; i < result.size(); i++)
+            mismatches += result[i] != data[i];
+        REQUIRE(mismatches <= result.size() / 100);
+    };
+
+    rscuda::align_cuda cuda;
+    rs2::align to_color(RS2_STREAM_COLOR), to_depth(RS2_STREAM_DEPTH);
+
+    std::vector<uint8_t> depth_aligned(CW * CH * 2);
+    cuda.align_depth_to_other(reinterpret_cast<uint16_t*>(depth_aligned.data()), depth_pixels.data(), 0.001f,
+        depth_intrinsics, depth_to_color, color_intrinsics);
+    require_close(to_color.process(frames).get_depth_frame(), depth_aligned);
+
+    std::vector<uint8_t> color_aligned(W * H * 3);
+    cuda.align_other_to_depth(color_aligned.data(), depth_pixels.data(), 0.001f,
+        depth_intrinsics, depth_to_color, color_intrinsics, color_pixels.data(), 3);
+    require_close(to_depth.process(frames).get_color_frame(), color_aligned);
+}
+#endif
+
+#ifdef RS2_TEST_KERNELS
+#include "../src/concurrency.h"
+
+TEST_CASE("A strand runs its items one at a time and in order", "[executor]") {
+    auto exec = std::make_shared<executor>(4);
+    dispatcher strand(16, exec);
+    strand.start();
+
+    // Several strands share the workers, for the items of every one of them to be spread over the workers by the stealing
+    dispatcher other(16, exec);
+    other.start();
+
+    std::vector<int> order;
+    std::atomic<int> running(0);
+    std::atomic<bool> overlapped(false);
+    for (int i = 0; i < 1000; i++)
+    {
+        strand.invoke([&, i](dispatcher::cancellable_timer)
+        {
+            if (running++ != 0) overlapped = true;
+            order.push_back(i);
+            running--;
+        }, true);
+        other.invoke([](dispatcher::cancellable_timer) {}, true);
+    }
+
+    // Unlike flush(), which drops the oldest item of a full queue, a last blocking item tells the others ran
+    std::mutex m;
+    std::condition_variable cv;
+    int done = 0;
+    for (auto d : { &strand, &other })
+        d->invoke([&](dispatcher::cancellable_timer)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m);
+                done++;
+            }
+            cv.notify_one();
+        }, true);
+    {
+        std::unique_lock<std::mutex> lock(m);
+        REQUIRE(cv.wait_for(lock, std::chrono::seconds(10), [&]() { return done == 2; }));
+    }
+
+    REQUIRE_FALSE(overlapped);
+    std::vector<int> expected(1000);
+    std::iota(expected.begin(), expected.end(), 0);
+    REQUIRE(order == expected);
+}
+
+TEST_CASE("Stopping a busy dispatcher waits for its item and runs nothing after", "[executor]") {
+    auto exec = std::make_shared<executor>(2);
+    for (auto strand : { false, true })
+    {
+        CAPTURE(strand);
+        dispatcher d(16, strand ? exec : nullptr);
+        d.start();
+
+        std::mutex m;
+        std::condition_variable cv;
+        bool started = false;
+        std::atomic<bool> woken(false), returned(false);
+        std::atomic<int> after(0);
+        d.invoke([&](dispatcher::cancellable_timer t)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m);
+                started = true;
+            }
+            cv.notify_one();
+            // Interrupted by the stop long before it would time out
+            woken = !t.try_sleep(60000);
+            returned = true;
+        }, true);
+        for (int i = 0; i < 5; i++)
+            d.invoke([&](dispatcher::cancellable_timer) { after++; }, true);
+
+        {
+            std::unique_lock<std::mutex> lock(m);
+            REQUIRE(cv.wait_for(lock, std::chrono::seconds(10), [&]() { return started; }));
+        }
+        auto begin = std::chrono::steady_clock::now();
+        d.stop();
+        REQUIRE(std::chrono::steady_clock::now() - begin < std::chrono::seconds(10));
+        REQUIRE(woken);
+        REQUIRE(returned);
+
+        // The items the stop found queued are dropped, though some may have run as it was stopping
+        auto ran = after.load();
+        d.start();
+        REQUIRE(d.flush());
+        REQUIRE(after == ran);
+
+        // Stopped from one of its own items, the dispatcher does not wait for that item
+        bool stopped = false;
+        d.invoke([&](dispatcher::cancellable_timer)
+        {
+            d.stop();
+            {
+                std::lock_guard<std::mutex> lock(m);
+                stopped = true;
+            }
+            cv.notify_one();
+        }, true);
+        std::unique_lock<std::mutex> lock(m);
+        REQUIRE(cv.wait_for(lock, std::chrono::seconds(10), [&]() { return stopped; }));
+    }
+}
+
+TEST_CASE("A ring queue keeps its order as its positions wrap around the ring", "[ring-queue]") {
+    ring_queue<int> q(4);
+    REQUIRE(q.capacity() == 4);
+
+    // Three items at a time, for the positions to come back to every cell at another offset each round
+    int next_in = 0, next_out = 0;
+    for (int round = 0; round < 20; round++)
+    {
+        for (int i = 0; i < 3; i++)
+            REQUIRE(q.enqueue(next_in++) == 0);
+        REQUIRE(q.size() == 3);
+        int item;
+        for (int i = 0; i < 3; i++)
+        {
+            REQUIRE(q.try_dequeue(&item));
+            REQUIRE(item == next_out++);
+        }
+        REQUIRE(q.size() == 0);
+    }
+
+    // Past the capacity, every item drops the oldest, whatever cell the ring starts at
+    for (int i = 0; i < 10; i++)
+        REQUIRE(q.enqueue(next_in++) == (i < 4 ? 0u : 1u));
+    REQUIRE(q.size() == 4);
+    int item;
+    for (int i = next_in - 4; i < next_in; i++)
+    {
+        REQUIRE(q.try_dequeue(&item));
+        REQUIRE(item == i);
+    }
+    REQUIRE_FALSE(q.try_dequeue(&item));
+}
+
+TEST_CASE("A ring queue rejects what it has no room for and waits for what it lacks", "[ring-queue]") {
+    ring_queue<int> q(2);
+    int item;
+    REQUIRE_FALSE(q.ready());
+    REQUIRE_FALSE(q.try_dequeue(&item));
+
+    // Empty, the timeout of the consumer runs out
+    auto begin = std::chrono::steady_clock::now();
+    REQUIRE_FALSE(q.dequeue(&item, 20));
+    REQUIRE(std::chrono::steady_clock::now() - begin >= std::chrono::milliseconds(20));
+
+    // Full, the queued items are kept rather than the new ones, and a blocking producer gives up after its timeout
+    REQUIRE(q.try_enqueue(1));
+    REQUIRE(q.try_enqueue(2));
+    REQUIRE(q.ready());
+    REQUIRE_FALSE(q.try_enqueue(3));
+    REQUIRE_FALSE(q.blocking_enqueue(3, std::chrono::milliseconds(20)));
+    REQUIRE(q.size() == 2);
+
+    // A blocking producer is let in by the consumer making room
+    std::atomic<bool> let_in(false);
+    std::thread producer([&]() { let_in = q.blocking_enqueue(3, std::chrono::seconds(10)); });
+    REQUIRE(q.dequeue(&item));
+    REQUIRE(item == 1);
+    producer.join();
+    REQUIRE(let_in);
+    REQUIRE(q.dequeue(&item));
+    REQUIRE(item == 2);
+    REQUIRE(q.dequeue(&item));
+    REQUIRE(item == 3);
+
+    // A waiting consumer is woken by the producer
+    std::thread late_producer([&]() { q.enqueue(4); });
+    REQUIRE(q.dequeue(&item, 10000));
+    REQUIRE(item == 4);
+    late_producer.join();
+
+    // Cleared, the queue holds nothing and takes nothing until it is started again
+    REQUIRE(q.try_enqueue(5));
+    q.clear();
+    REQUIRE_FALSE(q.ready());
+    REQUIRE(q.enqueue(6) == 1);
+    REQUIRE_FALSE(q.try_enqueue(6));
+    REQUIRE_FALSE(q.blocking_enqueue(6, std::chrono::milliseconds(20)));
+    q.start();
+    REQUIRE(q.try_enqueue(7));
+    REQUIRE(q.try_dequeue(&item));
+    REQUIRE(item == 7);
+}
+
+TEST_CASE("A ring queue hands the items of several producers to its consumer once each and in their order", "[ring-queue]") {
+    const int producers = 4;
+    const int items = 20000;
+    ring_queue<int> q(16);
+
+    // Blocking producers, which lose nothing to a consumer falling behind
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++)
+        threads.emplace_back([&q, p]()
+        {
+            for (int i = 0; i < items; i++)
+                q.blocking_enqueue(p * items + i);
+        });
+
+    std::vector<int> next(producers, 0);
+    bool in_order = true;
+    for (int received = 0; received < producers * items; received++)
+    {
+        int item;
+        REQUIRE(q.dequeue(&item, 10000));
+        auto& expected = next[item / items];
+        if (item % items != expected) in_order = false;
+        expected = item % items + 1;
+    }
+    for (auto&& t : threads)
+        t.join();
+
+    REQUIRE(in_order);
+    for (auto n : next)
+        REQUIRE(n == items);
+    int item;
+    REQUIRE_FALSE(q.try_dequeue(&item));
+}
+#endif
+
+#ifdef RS2_TEST_KERNELS
+#include "../src/hw-monitor.h"
+
+// Answers every command with its opcode and first parameter, and records the opcodes sent while each batch held the monitor
+class mock_locked_transfer : public librealsense::locked_transfer
+{
+public:
+    std::vector<std::vector<uint32_t>> get_batches()
+    {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+        return _batches;
+    }
+
+    // Commands with the opcode fail, the monitor answering with an error
+    void fail(uint32_t opcode) { _failing = opcode; }
+
+    // The transfer of the opcode waits for release(), with the monitor held
+    void stall(uint32_t opcode) { _stalled = opcode; }
+
+    void wait_for_stall()
+    {
+        std::unique_lock<std::mutex> lock(_stall_mutex);
+        REQUIRE(_stall_cv.wait_for(lock, std::chrono::seconds(10), [&]() { return _stalling; }));
+    }
+
+    void release()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_stall_mutex);
+            _stalled = 0;
+        }
+        _stall_cv.notify_all();
+    }
+
+protected:
+    void hold(const std::function<void()>& f) override
+    {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+        // The transfers nested in a batch join it
+        if (_depth++ == 0)
+            _batches.emplace_back();
+        try
+        {
+            f();
+        }
+        catch (...)
+        {
+            _depth--;
+            throw;
+        }
+        _depth--;
+    }
+
+    std::vector<uint8_t> transfer(const std::vector<uint8_t>& data, int, bool) override
+    {
+        // Past the size and the magic number of the header
+        uint32_t opcode, param1;
+        memcpy(&opcode, data.data() + 4, sizeof(opcode));
+        memcpy(&param1, data.data() + 8, sizeof(param1));
+        _batches.back().push_back(opcode);
+
+        {
+            std::unique_lock<std::mutex> lock(_stall_mutex);
+            if (opcode == _stalled)
+            {
+                _stalling = true;
+                _stall_cv.notify_all();
+                _stall_cv.wait(lock, [&]() { return _stalled == 0; });
+            }
+        }
+
+        if (opcode == _failing)
+            throw librealsense::io_exception("The command failed");
+        std::vector<uint8_t> response(8);
+        memcpy(response.data(), &opcode, sizeof(opcode));
+        memcpy(response.data() + 4, &param1, sizeof(param1));
+        return response;
+    }
+
+private:
+    std::recursive_mutex _mutex;
+    int _depth = 0;
+    std::vector<std::vector<uint32_t>> _batches;
+    std::atomic<uint32_t> _failing{ 0 };
+
+    std::mutex _stall_mutex;
+    std::condition_variable _stall_cv;
+    uint32_t _stalled = 0;
+    bool _stalling = false;
+};
+
+static int response_param(const std::vector<uint8_t>& response)
+{
+    REQUIRE(response.size() == 4);
+    int param;
+    memcpy(&param, response.data(), sizeof(param));
+    return param;
+}
+
+TEST_CASE("Hardware monitor batches send their commands back-to-back under one hold", "[hw-monitor]") {
+    auto transfer = std::make_shared<mock_locked_transfer>();
+    librealsense::hw_monitor monitor(transfer);
+
+    auto results = monitor.send({ librealsense::command(0x10, 1), librealsense::command(0x11, 2), librealsense::command(0x12, 3) });
+    REQUIRE(results.size() == 3);
+    for (int i = 0; i < 3; i++)
+        REQUIRE(response_param(results[i]) == i + 1);
+
+    // Single commands are held each on their own
+    REQUIRE(response_param(monitor.send(librealsense::command(0x13, 4))) == 4);
+    std::vector<std::vector<uint32_t>> batches = { { 0x10, 0x11, 0x12 },{ 0x13 } };
+    REQUIRE(transfer->get_batches() == batches);
+
+    // The batch stops at the first command that fails
+    transfer->fail(0x21);
+    REQUIRE_THROWS(monitor.send({ librealsense::command(0x20), librealsense::command(0x21), librealsense::command(0x22) }));
+    std::vector<uint32_t> failed = { 0x20, 0x21 };
+    REQUIRE(transfer->get_batches().back() == failed);
+}
+
+TEST_CASE("Hardware monitor sends the commands queued during a batch in the next one", "[hw-monitor]") {
+    auto transfer = std::make_shared<mock_locked_transfer>();
+    librealsense::hw_monitor monitor(transfer);
+
+    // The monitor thread is held in the first command while the others are queued
+    transfer->stall(0x30);
+    auto first = monitor.send_async(librealsense::command(0x30, 1));
+    transfer->wait_for_stall();
+
+    transfer->fail(0x32);
+    std::vector<std::future<std::vector<uint8_t>>> queued;
+    for (int i = 1; i < 4; i++)
+        queued.push_back(monitor.send_async(librealsense::command(0x30 + i, i + 1)));
+    transfer->release();
+
+    REQUIRE(response_param(first.get()) == 1);
+    REQUIRE(response_param(queued[0].get()) == 2);
+    // A failed command fails its own future alone
+    REQUIRE_THROWS(queued[1].get());
+    REQUIRE(response_param(queued[2].get()) == 4);
+
+    std::vector<std::vector<uint32_t>> batches = { { 0x30 },{ 0x31, 0x32, 0x33 } };
+    REQUIRE(transfer->get_batches() == batches);
+}
+
+// The hardware monitor interface of a device, shared by the handles of two processes. A claim holds it for a whole command
+struct mock_usb_interface
+{
+    static const int busy = -6;
+
+    std::atomic<bool> claimed{ false };
+    std::atomic<int> transfers{ 0 };
+    std::atomic<bool> overlapped{ false };
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    int busy_claims = 0;
+};
+
+class mock_bulk_transfer : public librealsense::platform::command_transfer
+{
+public:
+    explicit mock_bulk_transfer(mock_usb_interface& usb) : _usb(usb) {}
+
+    std::vector<uint8_t> send_receive(const std::vector<uint8_t>& data, int timeout_ms, bool) override
+    {
+        auto status = librealsense::platform::claim_when_free([&]()
+        {
+            bool free = false;
+            if (_usb.claimed.compare_exchange_strong(free, true))
+                return 0;
+            {
+                std::lock_guard<std::mutex> lock(_usb.mutex);
+                _usb.busy_claims++;
+            }
+            _usb.cv.notify_all();
+            return mock_usb_interface::busy;
+        }, mock_usb_interface::busy, timeout_ms);
+        if (status < 0)
+            throw librealsense::io_exception("The interface is busy");
+
+        if (_usb.transfers++ != 0)
+            _usb.overlapped = true;
+        // The command is on the wire until the other process has found the interface busy
+        {
+            std::unique_lock<std::mutex> lock(_usb.mutex);
+            _usb.cv.wait_for(lock, std::chrono::seconds(10), [&]() { return _usb.busy_claims > 0; });
+        }
+        _usb.transfers--;
+        _usb.claimed = false;
+        return data;
+    }
+
+private:
+    mock_usb_interface& _usb;
+};
+
+TEST_CASE("Hardware monitor transfers wait for the interface another process holds", "[hw-monitor]") {
+    mock_usb_interface usb;
+    mock_bulk_transfer first(usb), second(usb);
+
+    std::vector<uint8_t> first_response, second_response;
+    std::thread other([&]() { second_response = second.send_receive({ 2 }, 10000, true); });
+    first_response = first.send_receive({ 1 }, 10000, true);
+    other.join();
+
+    // Both commands went through, one after the other
+    REQUIRE(first_response == std::vector<uint8_t>{ 1 });
+    REQUIRE(second_response == std::vector<uint8_t>{ 2 });
+    REQUIRE(usb.busy_claims > 0);
+    REQUIRE_FALSE(usb.overlapped);
+
+    // Held for longer than the timeout, the interface fails the transfer
+    usb.claimed = true;
+    REQUIRE_THROWS(first.send_receive({ 3 }, 20, true));
+}
+#endif
+
+#ifndef __ANDROID__
+TEST_CASE("Shared memory slots hand out the frames of a publisher until all of them are held", "[shm][software-device]") {
+    const int W = 64;
+    const int H = 48;
+    const int BPP = 2;
+    software_device dev;
+    auto s = dev.add_sensor("Depth");
+    rs2_intrinsics intrinsics{ W, H, 0, 0, 0, 0, RS2_DISTORTION_NONE,{ 0,0,0,0,0 } };
+    s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 30, BPP, RS2_FORMAT_Z16, intrinsics });
+    auto profile = s.get_stream_profiles()[0];
+
+    auto name = "unit-test-" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+    rs2::shm_publisher publisher(dev, name);
+
+    // Attached in this process, the device maps the region as another process would
+    rs2::context ctx;
+    auto attached = ctx.attach_device(name).query_sensors()[0];
+    frame_queue received(64);
+    attached.open(attached.get_stream_profiles()[0]);
+    attached.start(received);
+
+    frame_queue sink(64);
+    s.open(profile);
+    s.start(sink);
+
+    std::vector<std::vector<uint16_t>> images;
+    auto send = [&](int number)
+    {
+        images.emplace_back(W * H);
+        std::iota(images.back().begin(), images.back().end(), static_cast<uint16_t>(number * 100));
+        s.on_video_frame({ images.back().data(), [](void*) {}, W * BPP, BPP, double(number), RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, number, profile });
+        sink.wait_for_frame();
+    };
+
+    // Every slot a frame the attached device holds, in order and with the data of the publisher
+    std::vector<frame> held;
+    for (int i = 0; i < 16; i++)
+    {
+        send(i);
+        frame f;
+        REQUIRE(received.try_wait_for_frame(&f));
+        REQUIRE(f.get_frame_number() == i);
+        REQUIRE(memcmp(f.get_data(), images[i].data(), W * H * BPP) == 0);
+        held.push_back(f);
+    }
+
+    // With no slot left, the frame is left out of the region
+    send(16);
+    frame f;
+    REQUIRE_FALSE(received.try_wait_for_frame(&f, 200));
+
+    // A released slot takes the next frame, and the frames still held keep their data
+    held.erase(held.begin());
+    send(17);
+    REQUIRE(received.try_wait_for_frame(&f));
+    REQUIRE(f.get_frame_number() == 17);
+    for (size_t i = 0; i < held.size(); i++)
+        REQUIRE(memcmp(held[i].get_data(), images[i + 1].data(), W * H * BPP) == 0);
+
+    held.clear();
+    f = frame();
+    s.stop();
+    attached.stop();
+}
+#endif
+
+#if defined(RS2_TEST_KERNELS) && !defined(__ANDROID__)
+#include "../src/shm/shm-region.h"
+
+TEST_CASE("Shared memory frames must lie within their slot", "[shm]") {
+    librealsense::shm::region_header header{};
+    header.slot_size = 64 * 48 * 2;
+
+    librealsense::net::frame_header frame{};
+    frame.width = 64;
+    frame.height = 48;
+    frame.stride = 128;
+    frame.bpp = 16;
+    frame.data_size = 128 * 48;
+    REQUIRE(librealsense::shm::is_valid_frame(header, frame));
+
+    auto invalid = frame;
+    invalid.height = 49;
+    REQUIRE_FALSE(librealsense::shm::is_valid_frame(header, invalid));
+    invalid = frame;
+    invalid.stride = 127;
+    REQUIRE_FALSE(librealsense::shm::is_valid_frame(header, invalid));
+    invalid = frame;
+    invalid.data_size = 128 * 48 + 1;
+    REQUIRE_FALSE(librealsense::shm::is_valid_frame(header, invalid));
+    invalid = frame;
+    invalid.bpp = 0;
+    REQUIRE_FALSE(librealsense::shm::is_valid_frame(header, invalid));
+
+    // Sizes that would wrap around in 32 bits
+    invalid = frame;
+    invalid.stride = 0x10000;
+    invalid.height = 0x10000;
+    REQUIRE_FALSE(librealsense::shm::is_valid_frame(header, invalid));
+}
+#endif
+
+#ifdef RS2_TEST_KERNELS
+#include "../src/net/net-protocol.h"
+
+TEST_CASE("Network frame codecs round-trip and reject truncated data", "[net]") {
+    using namespace librealsense::net;
+    const int W = 64, H = 48;
+
+    // Smooth depth with holes, which every codec shrinks
+    std::vector<uint16_t> depth(W * H);
+    for (int y = 0; y < H; y++)
+        for (int x = 0; x < W; x++)
+            depth[y * W + x] = (x % 16 == 0) ? 0 : static_cast<uint16_t>(1000 + x + y);
+    auto src = reinterpret_cast<const uint8_t*>(depth.data());
+    auto size = depth.size() * sizeof(uint16_t);
+
+    for (auto format : { RS2_FORMAT_Z16, RS2_FORMAT_DISPARITY16, RS2_FORMAT_Y16 })
+    {
+        CAPTURE(format);
+        std::vector<uint8_t> encoded;
+        auto c = encode(format, src, size, encoded);
+        REQUIRE(c != codec::raw);
+        REQUIRE(encoded.size() < size);
+
+        std::vector<uint8_t> decoded(size);
+        REQUIRE(decode(c, encoded.data(), encoded.size(), decoded.data(), decoded.size()));
+        REQUIRE(memcmp(decoded.data(), src, size) == 0);
+
+        // Cut anywhere, or decoded into the wrong size, the data does not decode
+        for (auto cut : { size_t(0), size_t(1), encoded.size() / 2, encoded.size() - 1 })
+            REQUIRE_FALSE(decode(c, encoded.data(), cut, decoded.data(), decoded.size()));
+        REQUIRE_FALSE(decode(c, encoded.data(), encoded.size(), decoded.data(), decoded.size() - 2));
+    }
+
+    // Data that does not compress goes raw, which must match the size exactly
+    std::vector<uint8_t> noise(size);
+    uint32_t seed = 12345;
+    for (auto&& b : noise)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        b = static_cast<uint8_t>(seed >> 24);
+    }
+    std::vector<uint8_t> encoded;
+    REQUIRE(encode(RS2_FORMAT_RGB8, noise.data(), noise.size(), encoded) == codec::raw);
+    REQUIRE(encoded.empty());
+    std::vector<uint8_t> decoded(size);
+    REQUIRE(decode(codec::raw, noise.data(), noise.size(), decoded.data(), decoded.size()));
+    REQUIRE(decoded == noise);
+    REQUIRE_FALSE(decode(codec::raw, noise.data(), noise.size() - 1, decoded.data(), decoded.size()));
+    REQUIRE_FALSE(decode(static_cast<codec>(99), noise.data(), noise.size(), decoded.data(), decoded.size()));
+}
+
+TEST_CASE("Network messages read back what was written and reject truncated payloads", "[net]") {
+    using namespace librealsense::net;
+
+    writer w;
+    w << uint32_t(7) << std::string("depth") << 1.5f << std::string();
+    auto&& data = w.data();
+
+    reader r(data);
+    REQUIRE(r.read<uint32_t>() == 7);
+    REQUIRE(r.read<std::string>() == "depth");
+    REQUIRE(r.read<float>() == 1.5f);
+    REQUIRE(r.read<std::string>().empty());
+    REQUIRE_THROWS(r.read<uint8_t>());
+
+    // Every prefix of the payload ends early
+    for (size_t cut = 0; cut < data.size(); cut++)
+    {
+        CAPTURE(cut);
+        reader t(data.data(), cut);
+        REQUIRE_THROWS([&]()
+        {
+            t.read<uint32_t>();
+            t.read<std::string>();
+            t.read<float>();
+            t.read<std::string>();
+        }());
+    }
+
+    // A string claiming more bytes than are left
+    writer bad;
+    bad << uint32_t(1000) << uint8_t('x');
+    reader b(bad.data());
+    REQUIRE_THROWS(b.read<std::string>());
+
+    // Headers of another protocol, or of a payload no frame needs, are refused before it is allocated
+    validate_header({ protocol_magic, static_cast<uint32_t>(message_type::frame), max_payload_size });
+    REQUIRE_THROWS(validate_header({ protocol_magic + 1, static_cast<uint32_t>(message_type::frame), 16 }));
+    REQUIRE_THROWS(validate_header({ protocol_magic, static_cast<uint32_t>(message_type::frame), max_payload_size + 1 }));
+}
+#endif
+
+#ifdef RS2_TEST_KERNELS
+#include "../src/proc/synthetic-stream.h"
+#include "../src/proc/syncer-processing-block.h"
+#include "../src/pipeline.h"
+
+TEST_CASE("Pipeline profile cache stores and loads the selection of its requests", "[pipeline][cache]") {
+    using namespace librealsense;
+
+    pipeline_config config, same, other;
+    for (auto c : { &config, &same })
+    {
+        c->enable_stream(RS2_STREAM_DEPTH, 0, 640, 480, RS2_FORMAT_Z16, 30);
+        c->enable_stream(RS2_STREAM_COLOR, 0, 1280, 720, RS2_FORMAT_RGB8, 30);
+    }
+    other.enable_stream(RS2_STREAM_DEPTH, 0, 640, 480, RS2_FORMAT_Z16, 60);
+    auto key = config.get_requests_key();
+    REQUIRE(key == same.get_requests_key());
+    REQUIRE(key != other.get_requests_key());
+    REQUIRE(key.find('\n') == std::string::npos);
+    REQUIRE(pipeline_config().get_requests_key() == "default");
+
+    // Without its variable set, the cache is the current directory
+    std::vector<std::pair<int, librealsense::stream_profile>> selection = {
+        { 0, { RS2_STREAM_DEPTH, 0, 640, 480, 30, RS2_FORMAT_Z16 } },
+        { 1, { RS2_STREAM_COLOR, 0, 1280, 720, 30, RS2_FORMAT_RGB8 } },
+    };
+    pipeline_profile_cache cache("unit-test-serial", "1.2.3.4", key);
+    std::remove(cache.get_path().c_str());
+
+    std::vector<std::pair<int, librealsense::stream_profile>> loaded;
+    REQUIRE_FALSE(cache.load(loaded));
+    cache.store(selection);
+    REQUIRE(cache.load(loaded));
+    REQUIRE(loaded.size() == selection.size());
+    for (size_t i = 0; i < loaded.size(); i++)
+    {
+        REQUIRE(loaded[i].first == selection[i].first);
+        REQUIRE(loaded[i].second.stream == selection[i].second.stream);
+        REQUIRE(loaded[i].second == selection[i].second);
+    }
+
+    // Stored again, the file is replaced whole
+    selection.pop_back();
+    cache.store(selection);
+    REQUIRE(cache.load(loaded));
+    REQUIRE(loaded.size() == 1);
+
+    // A cache of other requests does not load the file, nor does a truncated file load
+    pipeline_profile_cache colliding("unit-test-serial", "1.2.3.4", other.get_requests_key());
+    std::remove(colliding.get_path().c_str());
+    {
+        std::ofstream file(colliding.get_path(), std::ios::trunc);
+        file << key << "\n0 1 0 640";
+    }
+    REQUIRE_FALSE(colliding.load(loaded));
+    {
+        std::ofstream file(colliding.get_path(), std::ios::trunc);
+        file << other.get_requests_key() << "\n0 1 0 640";
+    }
+    REQUIRE_FALSE(colliding.load(loaded));
+
+    std::remove(cache.get_path().c_str());
+    std::remove(colliding.get_path().c_str());
+}
+#endif
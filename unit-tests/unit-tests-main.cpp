@@ -18,10 +18,22 @@ int main(int argc, char* const argv[])
     }
     std::cout << std::endl;
 
+    // Of the test cases selected, those of index modulo the count of shards, for processes to run them in parallel
+    int shard = 0, shards = 1;
+
     for (auto i = 0; i < argc; i++)
     {
         std::string param(argv[i]);
-        if (param != "into" && param != "from")
+        if (param == "shard")
+        {
+            if (i + 2 >= argc || (shard = atoi(argv[i + 1])) < 0 || (shards = atoi(argv[i + 2])) <= shard)
+            {
+                std::cout << "Expected shard <index> <count>, of an index below the count!" << std::endl;
+                return EXIT_FAILURE;
+            }
+            i += 2;
+        }
+        else if (param != "into" && param != "from")
         {
             new_argvs.push_back(argv[i]);
         }
@@ -41,7 +53,32 @@ int main(int argc, char* const argv[])
         }
     }
 
-    auto result = Catch::Session().run(static_cast<int>(new_argvs.size()), new_argvs.data());
+    Catch::Session session;
+    auto result = session.applyCommandLine(static_cast<int>(new_argvs.size()), new_argvs.data());
+    if (result)
+        return result;
+
+    if (shards > 1)
+    {
+        auto spec = session.config().testSpec();
+        if (!spec.hasFilters())
+            spec = Catch::TestSpecParser(Catch::ITagAliasRegistry::get()).parse("~[.]").testSpec();
+        std::vector<Catch::TestCase> tests;
+        Catch::getRegistryHub().getTestCaseRegistry().getFilteredTests(spec, session.config(), tests);
+
+        auto data = session.configData();
+        data.testsOrTags.clear();
+        for (size_t i = shard; i < tests.size(); i += shards)
+            data.testsOrTags.push_back("\"" + tests[i].name + "\",");
+        if (data.testsOrTags.empty())
+        {
+            std::cout << "No tests in shard " << shard << " of " << shards << std::endl;
+            return EXIT_SUCCESS;
+        }
+        session.useConfigData(data);
+    }
+
+    result = session.run();
 
     if(!command_line_params::instance()._found_any_section)
     {
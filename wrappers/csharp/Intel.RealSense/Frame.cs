@@ -1,4 +1,5 @@
 ﻿using System;
+using System.Collections.Generic;
 using System.Runtime.InteropServices;
 
 namespace Intel.RealSense
@@ -43,12 +44,36 @@ namespace Intel.RealSense
         public void Dispose()
         {
             // Do not change this code. Put cleanup code in Dispose(bool disposing) above.
+            var disposed = disposedValue;
             Dispose(true);
             // TODO: uncomment the following line if the finalizer is overridden above.
             GC.SuppressFinalize(this);
+            // The object is reused for a next frame, do not use it once disposed
+            if (!disposed)
+                ReturnToPool();
         }
         #endregion
 
+        /// <summary>
+        /// Wraps another native frame in a disposed object taken from a pool
+        /// </summary>
+        internal void Reset(IntPtr ptr)
+        {
+            m_instance = new HandleRef(this, ptr);
+            NativeMethods.rs2_keep_frame(m_instance.Handle);
+            disposedValue = false;
+            GC.ReRegisterForFinalize(this);
+        }
+
+        /// <summary>
+        /// Returns a disposed object to the pool of its type, unless it is of a type derived by the application
+        /// </summary>
+        internal virtual void ReturnToPool()
+        {
+            if (GetType() == typeof(Frame))
+                FramePool<Frame>.Return(this);
+        }
+
         public void Release()
         {
             if (m_instance.Handle != IntPtr.Zero)
@@ -63,6 +88,17 @@ namespace Intel.RealSense
             return new Frame(m_instance.Handle);
         }
 
+        /// <summary>
+        /// The native rs2_frame, for native plugins to take their own reference to
+        /// </summary>
+        public IntPtr NativePtr
+        {
+            get
+            {
+                return m_instance.Handle;
+            }
+        }
+
         public IntPtr Data
         {
             get
@@ -72,6 +108,19 @@ namespace Intel.RealSense
             }
         }
 
+        /// <summary>
+        /// Size of the frame data in bytes. Data and DataSize can be handed to APIs taking native memory,
+        /// such as Texture2D.LoadRawTextureData in Unity, with no copy, until the frame is disposed
+        /// </summary>
+        public int DataSize
+        {
+            get
+            {
+                object error;
+                return NativeMethods.rs2_get_frame_data_size(m_instance.Handle, out error);
+            }
+        }
+
         public StreamProfile Profile
         {
             get
@@ -111,6 +160,20 @@ namespace Intel.RealSense
                 return timestampDomain;
             }
         }
+
+        /// <summary>
+        /// Data, timestamp, number, profile and video dimensions of the frame, in a single native call
+        /// </summary>
+        public FrameInfo Info
+        {
+            get
+            {
+                object error;
+                FrameInfo info;
+                NativeMethods.rs2_get_frame_info(m_instance.Handle, out info, out error);
+                return info;
+            }
+        }
     }
 
     public class VideoFrame : Frame
@@ -119,6 +182,12 @@ namespace Intel.RealSense
         {
         }
 
+        internal override void ReturnToPool()
+        {
+            if (GetType() == typeof(VideoFrame))
+                FramePool<VideoFrame>.Return(this);
+        }
+
         public int Width
         {
             get
@@ -188,6 +257,12 @@ namespace Intel.RealSense
         {
         }
 
+        internal override void ReturnToPool()
+        {
+            if (GetType() == typeof(DepthFrame))
+                FramePool<DepthFrame>.Return(this);
+        }
+
         public float GetDistance(int x, int y)
         {
             object error;
@@ -214,6 +289,12 @@ namespace Intel.RealSense
         {
         }
 
+        internal override void ReturnToPool()
+        {
+            if (GetType() == typeof(Points))
+                FramePool<Points>.Return(this);
+        }
+
         public int Count
         {
             get
@@ -284,6 +365,39 @@ namespace Intel.RealSense
 
 
 
+    /// <summary>
+    /// Disposed frame objects of a type, reused for the next frames of the type. The frames delivered
+    /// every cycle are then neither collected nor finalized by the garbage collector
+    /// </summary>
+    internal static class FramePool<T> where T : Frame
+    {
+        private const int Capacity = 16;
+        private static readonly Stack<T> m_pool = new Stack<T>(Capacity);
+
+        public static T Get(IntPtr ptr, Func<IntPtr, T> create)
+        {
+            T frame = null;
+            lock (m_pool)
+            {
+                if (m_pool.Count > 0)
+                    frame = m_pool.Pop();
+            }
+            if (frame == null)
+                return create(ptr);
+            frame.Reset(ptr);
+            return frame;
+        }
+
+        public static void Return(T frame)
+        {
+            lock (m_pool)
+            {
+                if (m_pool.Count < Capacity)
+                    m_pool.Push(frame);
+            }
+        }
+    }
+
     class FrameMarshaler : ICustomMarshaler
     {
         private static FrameMarshaler Instance;
@@ -318,7 +432,9 @@ namespace Intel.RealSense
 
         public object MarshalNativeToManaged(IntPtr pNativeData)
         {
-            return new Frame(pNativeData);
+            if (pNativeData == IntPtr.Zero)
+                return null;
+            return FrameSet.CreateFrame(pNativeData);
         }
     }
 }
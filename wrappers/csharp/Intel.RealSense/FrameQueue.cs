@@ -22,7 +22,8 @@ namespace Intel.RealSense
             object error;
             if (NativeMethods.rs2_poll_for_frame(m_instance.Handle, out frame, out error) > 0)
             {
-                frame = FramesReleaser.ScopedReturn(releaser, FrameSet.CreateFrame(frame.m_instance.Handle));
+                // The marshaled frame is already of the type of the native frame
+                frame = FramesReleaser.ScopedReturn(releaser, frame);
                 return true;
             }
             return false;
@@ -33,13 +33,13 @@ namespace Intel.RealSense
         {
             object error;
             if (NativeMethods.rs2_is_frame_extendable_to(ptr, Extension.Points, out error) > 0)
-                return new Points(ptr);
+                return FramePool<Points>.Get(ptr, p => new Points(p));
             else if (NativeMethods.rs2_is_frame_extendable_to(ptr, Extension.DepthFrame, out error) > 0)
-                return new DepthFrame(ptr);
+                return FramePool<DepthFrame>.Get(ptr, p => new DepthFrame(p));
             else if (NativeMethods.rs2_is_frame_extendable_to(ptr, Extension.VideoFrame, out error) > 0)
-                return new VideoFrame(ptr);
+                return FramePool<VideoFrame>.Get(ptr, p => new VideoFrame(p));
             else
-                return new Frame(ptr);
+                return FramePool<Frame>.Get(ptr, p => new Frame(p));
         }
 
         public T FirstOrDefault<T>(Stream stream, Format format = Format.Any) where T : Frame
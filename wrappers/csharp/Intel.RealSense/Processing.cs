@@ -285,7 +285,7 @@ namespace Intel.RealSense
         {
             object error;
             var fref = NativeMethods.rs2_allocate_synthetic_video_frame(m_instance.Handle, profile.m_instance.Handle, original.m_instance.Handle, bpp, width, height, stride, extension, out error);
-            return new VideoFrame(fref);
+            return FramePool<VideoFrame>.Get(fref, p => new VideoFrame(p));
         }
 
         public FrameSet AllocateCompositeFrame(FramesReleaser releaser, params Frame[] frames)
@@ -325,7 +325,7 @@ namespace Intel.RealSense
             object error;
             frame_processor_callback cb2 = (IntPtr f, IntPtr src, IntPtr u) =>
             {
-                using (var frame = new Frame(f))
+                using (var frame = FramePool<Frame>.Get(f, p => new Frame(p)))
                     cb(frame, new FrameSource(new HandleRef(this, src)));
             };
             m_proc_callback = cb2;
@@ -362,7 +362,7 @@ namespace Intel.RealSense
             object error;
             frame_callback cb2 = (IntPtr f, IntPtr u) =>
             {
-                using (var frame = new Frame(f))
+                using (var frame = FramePool<Frame>.Get(f, p => new Frame(p)))
                     cb(frame);
             };
             NativeMethods.rs2_start_processing_fptr(m_instance.Handle, cb2, IntPtr.Zero, out error);
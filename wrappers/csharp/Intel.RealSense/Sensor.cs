@@ -360,7 +360,7 @@ namespace Intel.RealSense
             object error;
             frame_callback cb2 = (IntPtr f, IntPtr u) =>
             {
-                using (var frame = new Frame(f))
+                using (var frame = FramePool<Frame>.Get(f, p => new Frame(p)))
                     cb(frame);
             };
             m_callback = cb2;
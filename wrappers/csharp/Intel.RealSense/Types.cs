@@ -130,6 +130,7 @@ namespace Intel.RealSense
     {
         HardwareClock = 0,
         SystemTime = 1,
+        GlobalTime = 2,
     }
 
     public enum FrameMetadataValue
@@ -163,6 +164,10 @@ namespace Intel.RealSense
         ManualWhiteBalance = 26,
         PowerLineFrequency = 27,
         LowLightCompensation = 28,
+        DequeueTime = 29,
+        UnpackTime = 30,
+        SyncTime = 31,
+        CallbackTime = 32,
     }
 
     public enum Option
@@ -333,6 +338,21 @@ namespace Intel.RealSense
     }
 
 
+    [StructLayout(LayoutKind.Sequential)]
+    public struct FrameInfo
+    {
+        public IntPtr data;
+        public double timestamp;
+        public TimestampDomain timestampDomain;
+        public ulong number;
+        public IntPtr profile;
+        public int isVideo;     // the fields below are 0 for frames that are not video frames
+        public int width;
+        public int height;
+        public int stride;
+        public int bpp;
+    }
+
     [System.Serializable]
     [StructLayout(LayoutKind.Sequential)]
     public struct SoftwareVideoStream
@@ -1879,6 +1879,8 @@ class Frame {
     this.cxxFrame._internalResetBuffer = function() {
       jsWrapper.typedArray = undefined;
       jsWrapper.arrayBuffer = undefined;
+      jsWrapper.verticesArray = undefined;
+      jsWrapper.verticesCoordArray = undefined;
     };
   }
 
@@ -1999,7 +2001,10 @@ class Frame {
   }
 
   /**
-   * Retrieve the frame data
+   * Retrieve the frame data, with no copy. The array is over the memory of the
+   * frame, and holds the frame until the array is garbage collected: drop the
+   * references to the arrays no longer used, for the frames to return to the
+   * frame pool of the sensor
    * @return {Float32Array|Uint16Array|Uint8Array|undefined}
    * if the frame is from the depth stream, the return value is Uint16Array;
    * if the frame is from the XYZ32F or MOTION_XYZ32F stream, the return value is Float32Array;
@@ -2177,15 +2182,11 @@ class Points extends Frame {
   get vertices() {
     if (this.verticesArray) return this.verticesArray;
 
+    // The array is over the memory of the frame, which it holds until it is
+    // garbage collected, see Frame.data
     if (this.cxxFrame.canGetPoints()) {
-      const newLength = this.cxxFrame.getVerticesBufferLen();
-      if (!this.verticesData || newLength !== this.verticesData.byteLength) {
-        this.verticesData = new ArrayBuffer(newLength);
-      }
-      if (this.cxxFrame.writeVertices(this.verticesData)) {
-        this.verticesArray = new Float32Array(this.verticesData);
-        return this.verticesArray;
-      }
+      this.verticesArray = this.cxxFrame.getVertices();
+      return this.verticesArray;
     }
     return undefined;
   }
@@ -2198,8 +2199,6 @@ class Points extends Frame {
 
   destroy() {
     this.release();
-    this.verticesData = undefined;
-    this.textureCoordData = undefined;
     this.cxxFrame = undefined;
   }
 
@@ -2229,14 +2228,8 @@ class Points extends Frame {
     if (this.verticesCoordArray) return this.verticesCoordArray;
 
     if (this.cxxFrame.canGetPoints()) {
-      const newLength = this.cxxFrame.getTexCoordBufferLen();
-      if (!this.textureCoordData || newLength !== this.textureCoordData.byteLength) {
-        this.textureCoordData = new ArrayBuffer(newLength);
-      }
-      if (this.cxxFrame.writeTextureCoordinates(this.textureCoordData)) {
-        this.verticesCoordArray = new Int32Array(this.textureCoordData);
-        return this.verticesCoordArray;
-      }
+      this.verticesCoordArray = this.cxxFrame.getTextureCoordinates();
+      return this.verticesCoordArray;
     }
     return undefined;
   }
@@ -8,6 +8,7 @@
 #include <librealsense2/hpp/rs_types.hpp>
 #include <nan.h>
 
+#include <algorithm>
 #include <iostream>
 #include <list>
 #include <memory>
@@ -213,6 +214,9 @@ class MainThreadCallbackInfo {
   }
   virtual void Run() {}
   virtual void Release() {}
+  // The object the info is delivered to, for which only the latest info waits
+  // for the main thread. Infos without a target all wait in turn
+  virtual const void* Target() const { return nullptr; }
   void SetConsumed() { consumed_ = true; }
   static bool InfoExist(MainThreadCallbackInfo* info) {
     auto result = std::find(pending_infos_.begin(), pending_infos_.end(), info);
@@ -261,13 +265,25 @@ class MainThreadCallback {
   static void NotifyMainThread(MainThreadCallbackInfo* info) {
     if (singleton_) {
       LockGuard guard;
-      if (singleton_->async_->data) {
-        MainThreadCallbackInfo* info =
-          reinterpret_cast<MainThreadCallbackInfo*>(singleton_->async_->data);
-        info->Release();
-        delete info;
+      // An info not yet run for the same target, as a frame of the same
+      // sensor, is replaced. The infos of the other targets are kept, for the
+      // frames of every stream to reach js
+      auto& queue = singleton_->queue_;
+      auto target = info->Target();
+      auto pending = queue.end();
+      if (target) {
+        pending = std::find_if(queue.begin(), queue.end(),
+            [target](MainThreadCallbackInfo* i) {
+              return i->Target() == target;
+            });
+      }
+      if (pending != queue.end()) {
+        (*pending)->Release();
+        delete *pending;
+        *pending = info;
+      } else {
+        queue.push_back(info);
       }
-      singleton_->async_->data = static_cast<void*>(info);
       uv_async_send(singleton_->async_);
     }
   }
@@ -286,24 +302,26 @@ class MainThreadCallback {
     if (singleton_) uv_mutex_unlock(&(singleton_->mutex_));
   }
   static void AsyncProc(uv_async_t* async) {
-    MainThreadCallbackInfo* info = nullptr;
+    // The sends coalesce, every info queued so far is run
+    std::list<MainThreadCallbackInfo*> infos;
     {
       LockGuard guard;
-      if (!(async->data))
-        return;
-
-      info = reinterpret_cast<MainThreadCallbackInfo*>(async->data);
-      async->data = nullptr;
+      if (!singleton_) return;
+      infos.swap(singleton_->queue_);
+    }
+    for (auto info : infos) {
+      // As info->Run() enters js world and during that, any code such as
+      // cleanup() could be called to release everything. So the infos may
+      // have been released, we need to check before running or releasing them.
+      if (!MainThreadCallbackInfo::InfoExist(info)) continue;
+      info->Run();
+      if (MainThreadCallbackInfo::InfoExist(info)) delete info;
     }
-    info->Run();
-    // As the above info->Run() enters js world and during that, any code
-    // such as cleanup() could be called to release everything. So this info
-    // may has been released, we need to check before releasing it.
-    if (MainThreadCallbackInfo::InfoExist(info)) delete info;
   }
   static MainThreadCallback* singleton_;
   uv_async_t* async_;
   uv_mutex_t mutex_;
+  std::list<MainThreadCallbackInfo*> queue_;
 };
 
 MainThreadCallback* MainThreadCallback::singleton_ = nullptr;
@@ -643,6 +661,46 @@ Nan::Persistent<v8::Function> RSStreamProfile::constructor_;
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
+// An external ArrayBuffer over the memory of a frame, which holds a reference
+// to the frame until the buffer is garbage collected. The data is read from
+// js with no copy, and stays valid once the js frame is released or replaced.
+class FrameArrayBuffer {
+ public:
+  static v8::Local<v8::ArrayBuffer> New(rs2_frame* frame, const void* data,
+      size_t length, rs2_error** error) {
+    Nan::EscapableHandleScope scope;
+    CallNativeFunc(rs2_frame_add_ref, error, frame, error);
+    if (*error) return v8::Local<v8::ArrayBuffer>();
+
+    auto buffer = v8::ArrayBuffer::New(v8::Isolate::GetCurrent(),
+        const_cast<void*>(data), length,
+        v8::ArrayBufferCreationMode::kExternalized);
+    auto me = new FrameArrayBuffer(frame, length);
+    me->buffer_.Reset(buffer);
+    me->buffer_.SetWeak(me, WeakCallback, Nan::WeakCallbackType::kParameter);
+    // For the collector to account for the frames held by the buffers
+    Nan::AdjustExternalMemory(static_cast<int>(length));
+    return scope.Escape(buffer);
+  }
+
+ private:
+  FrameArrayBuffer(rs2_frame* frame, size_t length) :
+      frame_(frame), length_(length) {}
+  ~FrameArrayBuffer() {
+    buffer_.Reset();
+    rs2_release_frame(frame_);
+    Nan::AdjustExternalMemory(-static_cast<int>(length_));
+  }
+
+  static void WeakCallback(const Nan::WeakCallbackInfo<FrameArrayBuffer>& info) {
+    delete info.GetParameter();
+  }
+
+  Nan::Persistent<v8::ArrayBuffer> buffer_;
+  rs2_frame* frame_;
+  size_t length_;
+};
+
 class RSFrame : public Nan::ObjectWrap {
  public:
   static void Init(v8::Local<v8::Object> exports) {
@@ -836,10 +894,10 @@ class RSFrame : public Nan::ObjectWrap {
     const auto height = GetNativeResult<int>(rs2_get_frame_height, &me->error_,
         me->frame_, &me->error_);
     const auto length = stride * height;
-    auto array_buffer = v8::ArrayBuffer::New(
-        v8::Isolate::GetCurrent(),
-        static_cast<uint8_t*>(const_cast<void*>(buffer)), length,
-        v8::ArrayBufferCreationMode::kExternalized);
+    auto array_buffer = FrameArrayBuffer::New(me->frame_, buffer, length,
+        &me->error_);
+    if (array_buffer.IsEmpty()) return;
+
     info.GetReturnValue().Set(array_buffer);
   }
 
@@ -1056,16 +1114,10 @@ class RSFrame : public Nan::ObjectWrap {
         &me->error_, me->frame_, &me->error_);
     if (!vertices || !count) return;
 
-    uint32_t step = 3 * sizeof(float);
-    uint32_t len = count * step;
-    auto vertex_buf = static_cast<uint8_t*>(malloc(len));
-
-    for (size_t i = 0; i < count; i++) {
-      memcpy(vertex_buf+i*step, vertices[i].xyz, step);
-    }
-    auto array_buffer = v8::ArrayBuffer::New(
-        v8::Isolate::GetCurrent(), vertex_buf, len,
-        v8::ArrayBufferCreationMode::kInternalized);
+    // The vertices are packed, for js to read them in place
+    auto array_buffer = FrameArrayBuffer::New(me->frame_, vertices,
+        count * sizeof(rs2_vertex), &me->error_);
+    if (array_buffer.IsEmpty()) return;
 
     info.GetReturnValue().Set(v8::Float32Array::New(array_buffer, 0, 3*count));
   }
@@ -1130,16 +1182,9 @@ class RSFrame : public Nan::ObjectWrap {
         &me->error_, me->frame_, &me->error_);
     if (!coords || !count) return;
 
-    uint32_t step = 2 * sizeof(int);
-    uint32_t len = count * step;
-    auto texcoord_buf = static_cast<uint8_t*>(malloc(len));
-
-    for (size_t i = 0; i < count; ++i) {
-      memcpy(texcoord_buf + i * step, coords[i].ij, step);
-    }
-    auto array_buffer = v8::ArrayBuffer::New(
-        v8::Isolate::GetCurrent(), texcoord_buf, len,
-        v8::ArrayBufferCreationMode::kInternalized);
+    auto array_buffer = FrameArrayBuffer::New(me->frame_, coords,
+        count * sizeof(rs2_pixel), &me->error_);
+    if (array_buffer.IsEmpty()) return;
 
     info.GetReturnValue().Set(v8::Int32Array::New(array_buffer, 0, 2*count));
   }
@@ -1416,6 +1461,7 @@ class FrameCallbackInfo : public MainThreadCallbackInfo {
       frame_(frame), sensor_(static_cast<RSSensor*>(data)) {}
   virtual ~FrameCallbackInfo() { if (!consumed_) Release(); }
   virtual void Run();
+  virtual const void* Target() const { return sensor_; }
   virtual void Release() {
     if (frame_) {
       rs2_release_frame(frame_);
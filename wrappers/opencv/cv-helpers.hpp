@@ -4,8 +4,67 @@
 #pragma once
 
 #include <librealsense2/rs.hpp> // Include RealSense Cross Platform API
+#include <librealsense2/h/rs_internal.h>
 #include <opencv2/opencv.hpp>   // Include OpenCV API
+#include <opencv2/core/cuda.hpp>
 #include <exception>
+#include <map>
+#include <mutex>
+
+// Lends the data of RealSense frames to OpenCV matrices, the matrices holding on to their frame for as long as
+// any of them, or of their regions, is alive. The frames are taken from the frame pool of their sensor, and are
+// only returned to it once their matrices are released: matrices kept for long should be cloned instead
+class frame_mat_allocator : public cv::MatAllocator
+{
+public:
+    static frame_mat_allocator& instance()
+    {
+        static frame_mat_allocator a;
+        return a;
+    }
+
+    cv::Mat wrap(const rs2::frame& f, cv::Size size, int type) const
+    {
+        auto vf = f.as<rs2::video_frame>();
+        size_t step = vf ? vf.get_stride_in_bytes() : cv::Mat::AUTO_STEP;
+        cv::Mat m(size, type, (void*)f.get_data(), step);
+
+        auto u = new cv::UMatData(this);
+        u->data = u->origdata = m.data;
+        u->size = m.step[0] * m.rows;
+        u->flags |= cv::UMatData::USER_ALLOCATED;
+        u->handle = new rs2::frame(f);
+        u->refcount = 1;
+        m.u = u;
+        m.allocator = const_cast<frame_mat_allocator*>(this);
+        return m;
+    }
+
+    // Matrices made anew from a wrapped one, as when their type changes, get memory of their own
+    cv::UMatData* allocate(int dims, const int* sizes, int type, void* data, size_t* step, int flags, cv::UMatUsageFlags usage) const override
+    {
+        return cv::Mat::getStdAllocator()->allocate(dims, sizes, type, data, step, flags, usage);
+    }
+
+    bool allocate(cv::UMatData* u, int access, cv::UMatUsageFlags usage) const override
+    {
+        return cv::Mat::getStdAllocator()->allocate(u, access, usage);
+    }
+
+    void deallocate(cv::UMatData* u) const override
+    {
+        if (!u) return;
+        CV_Assert(u->urefcount >= 0 && u->refcount >= 0);
+        if (u->refcount == 0)
+        {
+            delete static_cast<rs2::frame*>(u->handle);
+            delete u;
+        }
+    }
+
+private:
+    frame_mat_allocator() {}
+};
 
 // Convert rs2::frame to cv::Mat
 cv::Mat frame_to_mat(const rs2::frame& f)
@@ -16,24 +75,26 @@ cv::Mat frame_to_mat(const rs2::frame& f)
     auto vf = f.as<video_frame>();
     const int w = vf.get_width();
     const int h = vf.get_height();
+    auto&& allocator = frame_mat_allocator::instance();
 
+    // The matrices hold the frame, and need no clone when it is let go
     if (f.get_profile().format() == RS2_FORMAT_BGR8)
     {
-        return Mat(Size(w, h), CV_8UC3, (void*)f.get_data(), Mat::AUTO_STEP);
+        return allocator.wrap(f, Size(w, h), CV_8UC3);
     }
     else if (f.get_profile().format() == RS2_FORMAT_RGB8)
     {
-        auto r = Mat(Size(w, h), CV_8UC3, (void*)f.get_data(), Mat::AUTO_STEP);
+        auto r = allocator.wrap(f, Size(w, h), CV_8UC3);
         cvtColor(r, r, CV_RGB2BGR);
         return r;
     }
     else if (f.get_profile().format() == RS2_FORMAT_Z16)
     {
-        return Mat(Size(w, h), CV_16UC1, (void*)f.get_data(), Mat::AUTO_STEP);
+        return allocator.wrap(f, Size(w, h), CV_16UC1);
     }
     else if (f.get_profile().format() == RS2_FORMAT_Y8)
     {
-        return Mat(Size(w, h), CV_8UC1, (void*)f.get_data(), Mat::AUTO_STEP);
+        return allocator.wrap(f, Size(w, h), CV_8UC1);
     }
 
     throw std::runtime_error("Frame format is not supported yet!");
@@ -55,3 +116,59 @@ cv::Mat depth_frame_to_meters(const rs2::pipeline& pipe, const rs2::depth_frame&
     return dm;
 }
 
+
+// Page-locked storage for the frames of a sensor, for them to be uploaded to the GPU without the driver of CUDA
+// staging them first, and asynchronously to the host. Must outlive the sensor it is set to, and its frames
+class pinned_frame_allocator
+{
+public:
+    // Takes effect the next time the sensor is opened
+    void attach(const rs2::sensor& sensor, size_t alignment = 64)
+    {
+        rs2_error* e = nullptr;
+        rs2_set_frame_allocator(sensor.get().get(), alloc, release, alignment, this, &e);
+        rs2::error::handle(e);
+    }
+
+private:
+    static void* alloc(size_t size, size_t alignment, void* user)
+    {
+        auto self = static_cast<pinned_frame_allocator*>(user);
+        try
+        {
+            cv::cuda::HostMem mem(1, static_cast<int>(size + alignment), CV_8UC1, cv::cuda::HostMem::PAGE_LOCKED);
+            auto ptr = cv::alignPtr(mem.data, static_cast<int>(alignment));
+            std::lock_guard<std::mutex> lock(self->_mutex);
+            self->_buffers[ptr] = mem;
+            return ptr;
+        }
+        catch (const cv::Exception&)
+        {
+            return nullptr;
+        }
+    }
+
+    static void release(void* ptr, size_t, void* user)
+    {
+        auto self = static_cast<pinned_frame_allocator*>(user);
+        std::lock_guard<std::mutex> lock(self->_mutex);
+        self->_buffers.erase(static_cast<uchar*>(ptr));
+    }
+
+    std::mutex _mutex;
+    std::map<uchar*, cv::cuda::HostMem> _buffers;
+};
+
+// Uploads a frame to the GPU, the frame being converted as frame_to_mat does. With the frames of a sensor in
+// page-locked memory, see pinned_frame_allocator, the copy runs on the stream without blocking the host, the
+// frame being held until the stream is done with it
+inline void frame_to_gpu_mat(const rs2::frame& f, cv::cuda::GpuMat& dst, cv::cuda::Stream& stream = cv::cuda::Stream::Null())
+{
+    auto m = frame_to_mat(f);
+    dst.upload(m, stream);
+    if (stream)
+    {
+        auto held = new cv::Mat(m);
+        stream.enqueueHostCallback([](int, void* user) { delete static_cast<cv::Mat*>(user); }, held);
+    }
+}
@@ -0,0 +1,187 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <librealsense2/rs.hpp> // Include RealSense Cross Platform API
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Latencies of a stream, in milliseconds, since the last report and since the start
+class stream_latencies
+{
+public:
+    void add(double capture_to_callback, double dequeue_to_callback)
+    {
+        _interval.push_back(capture_to_callback);
+        _all.push_back(capture_to_callback);
+        if (dequeue_to_callback >= 0) _host.push_back(dequeue_to_callback);
+    }
+    void miss() { _unmeasured++; }
+
+    std::vector<double>& interval() { return _interval; }
+    std::vector<double>& all() { return _all; }
+    std::vector<double>& host() { return _host; }
+    uint64_t unmeasured() const { return _unmeasured; }
+
+private:
+    std::vector<double> _interval;
+    std::vector<double> _all;
+    std::vector<double> _host;      // Of the library alone, from when the frame was taken from the driver
+    uint64_t _unmeasured = 0;       // Frames with no timestamp on a host clock
+};
+
+// Measures, with no window and no setup, the latency from the capture of the frames, as timestamped by the
+// device mapped onto the host clock, to their callback, for every stream of every connected device
+class latency_monitor
+{
+public:
+    latency_monitor(double interval_s, double duration_s, double max_p99_ms)
+        : _interval(interval_s), _duration(duration_s), _max_p99(max_p99_ms) {}
+
+    int run()
+    {
+        rs2::context ctx;
+        auto devices = ctx.query_devices();
+        if (devices.size() == 0)
+            throw std::runtime_error("No device connected");
+
+        std::vector<rs2::sensor> started;
+        for (auto&& dev : devices)
+        {
+            std::string serial = dev.supports(RS2_CAMERA_INFO_SERIAL_NUMBER) ? dev.get_info(RS2_CAMERA_INFO_SERIAL_NUMBER) : "unknown";
+            for (auto&& sensor : dev.query_sensors())
+            {
+                // For the timestamps to be comparable to the clock of the host
+                if (sensor.supports(RS2_OPTION_GLOBAL_TIME_ENABLED))
+                    sensor.set_option(RS2_OPTION_GLOBAL_TIME_ENABLED, 1.f);
+
+                std::vector<rs2::stream_profile> profiles;
+                for (auto&& p : sensor.get_stream_profiles())
+                    if (p.is_default()) profiles.push_back(p);
+                if (profiles.empty())
+                    continue;
+
+                sensor.open(profiles);
+                sensor.start([this, serial](rs2::frame f) { on_frame(serial, f); });
+                started.push_back(sensor);
+            }
+        }
+
+        std::cout << std::left << std::setw(10) << "time (s)" << std::setw(14) << "device" << std::setw(16) << "stream"
+                  << std::right << std::setw(8) << "frames" << std::setw(10) << "p50" << std::setw(10) << "p90"
+                  << std::setw(10) << "p99" << std::setw(10) << "max" << std::setw(12) << "host p50" << std::endl;
+
+        auto start = std::chrono::steady_clock::now();
+        auto next = start;
+        double elapsed = 0;
+        while (_duration <= 0 || elapsed < _duration)
+        {
+            next += std::chrono::milliseconds(static_cast<int64_t>(_interval * 1000));
+            std::this_thread::sleep_until(next);
+            elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            report(elapsed);
+        }
+
+        for (auto&& sensor : started)
+        {
+            sensor.stop();
+            sensor.close();
+        }
+
+        return summarize();
+    }
+
+private:
+    static double percentile(std::vector<double>& samples, double p)
+    {
+        if (samples.empty()) return 0;
+        auto rank = std::min(static_cast<size_t>(p / 100 * (samples.size() - 1) + 0.5), samples.size() - 1);
+        std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+        return samples[rank];
+    }
+
+    static std::string stream_name(const rs2::stream_profile& p)
+    {
+        std::string name = rs2_stream_to_string(p.stream_type());
+        if (p.stream_index()) name += " " + std::to_string(p.stream_index());
+        return name;
+    }
+
+    void on_frame(const std::string& serial, rs2::frame f)
+    {
+        // The clocks are read first, for the bookkeeping to be left out of the measure
+        auto steady = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        auto system = std::chrono::duration<double, std::milli>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+        double host = -1;
+        if (f.supports_frame_metadata(RS2_FRAME_METADATA_DEQUEUE_TIME) && f.supports_frame_metadata(RS2_FRAME_METADATA_CALLBACK_TIME))
+            host = (f.get_frame_metadata(RS2_FRAME_METADATA_CALLBACK_TIME) - f.get_frame_metadata(RS2_FRAME_METADATA_DEQUEUE_TIME)) / 1000.;
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto&& stream = _streams[{ serial, stream_name(f.get_profile()) }];
+        switch (f.get_frame_timestamp_domain())
+        {
+        case RS2_TIMESTAMP_DOMAIN_GLOBAL_TIME: stream.add(steady - f.get_timestamp(), host); break;
+        case RS2_TIMESTAMP_DOMAIN_SYSTEM_TIME: stream.add(system - f.get_timestamp(), host); break;
+        default: stream.miss(); break;
+        }
+    }
+
+    void report(double elapsed)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (auto&& kvp : _streams)
+        {
+            auto&& samples = kvp.second.interval();
+            auto&& host = kvp.second.host();
+            std::cout << std::left << std::fixed << std::setprecision(1) << std::setw(10) << elapsed
+                      << std::setw(14) << kvp.first.first << std::setw(16) << kvp.first.second << std::right
+                      << std::setw(8) << samples.size() << std::setprecision(2)
+                      << std::setw(10) << percentile(samples, 50) << std::setw(10) << percentile(samples, 90)
+                      << std::setw(10) << percentile(samples, 99) << std::setw(10) << percentile(samples, 100)
+                      << std::setw(12) << percentile(host, 50) << std::endl;
+            samples.clear();
+            host.clear();
+        }
+    }
+
+    // The latencies over the whole run, failing when a stream went over the bound, or went unmeasured
+    int summarize()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::cout << std::string(100, '-') << "\n" << std::left << std::setw(14) << "device" << std::setw(16) << "stream"
+                  << std::right << std::setw(8) << "frames" << std::setw(10) << "p50" << std::setw(10) << "p90"
+                  << std::setw(10) << "p99" << std::setw(10) << "max" << std::setw(12) << "unmeasured" << std::endl;
+
+        bool passed = !_streams.empty();
+        for (auto&& kvp : _streams)
+        {
+            auto&& samples = kvp.second.all();
+            auto p99 = percentile(samples, 99);
+            std::cout << std::left << std::setw(14) << kvp.first.first << std::setw(16) << kvp.first.second << std::right
+                      << std::setw(8) << samples.size() << std::fixed << std::setprecision(2)
+                      << std::setw(10) << percentile(samples, 50) << std::setw(10) << percentile(samples, 90)
+                      << std::setw(10) << p99 << std::setw(10) << percentile(samples, 100)
+                      << std::setw(12) << kvp.second.unmeasured() << std::endl;
+            if (samples.empty() || (_max_p99 > 0 && p99 > _max_p99))
+                passed = false;
+        }
+        return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    const double _interval;
+    const double _duration;
+    const double _max_p99;
+
+    std::mutex _mutex;
+    std::map<std::pair<std::string, std::string>, stream_latencies> _streams;    // By serial number and stream
+};
@@ -2,6 +2,7 @@
 // Copyright(c) 2017 Intel Corporation. All Rights Reserved.
 
 #include "latency-detector.h"
+#include "latency-monitor.h"
 
 // This demo is presenting one way to estimate latency without access to special equipment
 // See ReadMe.md for more information
@@ -10,6 +11,25 @@ int main(int argc, char * argv[]) try
     using namespace cv;
     using namespace rs2;
 
+    // With --headless, the latency of every stream of every device is measured from the timestamps of the frames instead
+    // --interval <seconds> between the reports, --duration <seconds> of the run (0 until stopped), --max-p99 <ms> to fail above
+    bool headless = false;
+    double interval = 5, duration = 60, max_p99 = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        auto value = [&]() {
+            if (i + 1 >= argc) throw std::runtime_error("Missing value of " + arg);
+            return std::atof(argv[++i]); };
+        if (arg == "--headless") headless = true;
+        else if (arg == "--interval") interval = std::max(value(), 0.1);
+        else if (arg == "--duration") duration = value();
+        else if (arg == "--max-p99") max_p99 = value();
+        else throw std::runtime_error("Unknown argument " + arg);
+    }
+    if (headless)
+        return latency_monitor(interval, duration, max_p99).run();
+
     // Start RealSense camera
     // Uncomment the configuration you wish to test
     pipeline pipe;
@@ -0,0 +1,135 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <librealsense2/rs.hpp> // Include RealSense Cross Platform API
+#include <pcl/point_cloud.h>    // Include PCL API
+#include <pcl/point_types.h>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define RS2_PCL_SSE
+#endif
+
+namespace rs2_pcl_detail
+{
+#ifdef RS2_PCL_SSE
+    // Spreads 4 packed vertices, 48 bytes, over the 4 vectors of the head of PCL points: x, y, z, and the 1 PCL keeps as padding
+    inline void spread(const float* v, __m128 p[4])
+    {
+        auto one = _mm_set1_ps(1.f);
+        auto v0 = _mm_loadu_ps(v);      // x0 y0 z0 x1
+        auto v1 = _mm_loadu_ps(v + 4);  // y1 z1 x2 y2
+        auto v2 = _mm_loadu_ps(v + 8);  // z2 x3 y3 z3
+        p[0] = _mm_shuffle_ps(v0, _mm_shuffle_ps(v0, one, _MM_SHUFFLE(0, 0, 2, 2)), _MM_SHUFFLE(2, 0, 1, 0));
+        p[1] = _mm_shuffle_ps(_mm_shuffle_ps(v0, v1, _MM_SHUFFLE(0, 0, 3, 3)), _mm_shuffle_ps(v1, one, _MM_SHUFFLE(0, 0, 1, 1)), _MM_SHUFFLE(2, 0, 2, 0));
+        p[2] = _mm_shuffle_ps(_mm_shuffle_ps(v1, v1, _MM_SHUFFLE(3, 3, 3, 2)), _mm_shuffle_ps(v2, one, _MM_SHUFFLE(0, 0, 0, 0)), _MM_SHUFFLE(2, 0, 1, 0));
+        p[3] = _mm_shuffle_ps(v2, _mm_shuffle_ps(v2, one, _MM_SHUFFLE(0, 0, 3, 3)), _MM_SHUFFLE(2, 0, 2, 1));
+    }
+#endif
+
+    // Writes the vertices into the head of the points, the color of each being set by paint(point, index of the vertex).
+    // Organized clouds keep every vertex, those with no depth as NaN, the others only keep the vertices with depth
+    template<class PointT, class Paint>
+    void convert(const rs2::points& points, pcl::PointCloud<PointT>& cloud, bool organized, Paint paint)
+    {
+        const size_t count = points.size();
+        auto v = reinterpret_cast<const float*>(points.get_vertices());
+        const auto nan = std::numeric_limits<float>::quiet_NaN();
+
+        // The storage of the cloud is reused, for no allocation once it holds as many points
+        cloud.points.resize(count);
+        size_t n = 0;
+        size_t i = 0;
+
+#ifdef RS2_PCL_SSE
+        auto invalid = _mm_setr_ps(nan, nan, nan, 1.f);
+        auto zero = _mm_setzero_ps();
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 p[4];
+            spread(v + i * 3, p);
+            for (int k = 0; k < 4; k++)
+            {
+                auto valid = v[(i + k) * 3 + 2] != 0;
+                if (organized)
+                {
+                    auto mask = _mm_cmpeq_ps(_mm_shuffle_ps(p[k], p[k], _MM_SHUFFLE(2, 2, 2, 2)), zero);
+                    p[k] = _mm_or_ps(_mm_and_ps(mask, invalid), _mm_andnot_ps(mask, p[k]));
+                }
+                // Points with no depth are written over by the next one, for no branch on the depth
+                _mm_storeu_ps(cloud.points[n].data, p[k]);
+                paint(cloud.points[n], i + k);
+                n += organized || valid;
+            }
+        }
+#endif
+
+        for (; i < count; i++)
+        {
+            auto valid = v[i * 3 + 2] != 0;
+            auto&& p = cloud.points[n];
+            p.x = organized && !valid ? nan : v[i * 3];
+            p.y = organized && !valid ? nan : v[i * 3 + 1];
+            p.z = organized && !valid ? nan : v[i * 3 + 2];
+            p.data[3] = 1.f;
+            paint(p, i);
+            n += organized || valid;
+        }
+
+        cloud.points.resize(n);
+        if (organized)
+        {
+            auto sp = points.get_profile().as<rs2::video_stream_profile>();
+            cloud.width = sp.width();
+            cloud.height = sp.height();
+            cloud.is_dense = false;
+        }
+        else
+        {
+            cloud.width = static_cast<uint32_t>(n);
+            cloud.height = 1;
+            cloud.is_dense = true;
+        }
+    }
+}
+
+// Converts rs2::points to a PCL cloud, reusing the storage of the cloud. Unless organized, the cloud only holds the points
+// with depth. Organized clouds keep the layout of the depth frame, with the points with no depth set to NaN
+inline void points_to_pcl(const rs2::points& points, pcl::PointCloud<pcl::PointXYZ>& cloud, bool organized = false)
+{
+    rs2_pcl_detail::convert(points, cloud, organized, [](pcl::PointXYZ&, size_t) {});
+}
+
+// Converts rs2::points to a colored PCL cloud, the points taking the color of the frame they were mapped to, see rs2::pointcloud::map_to
+inline void points_to_pcl(const rs2::points& points, const rs2::video_frame& color, pcl::PointCloud<pcl::PointXYZRGB>& cloud, bool organized = false)
+{
+    int r, g, b;
+    switch (color.get_profile().format())
+    {
+    case RS2_FORMAT_RGB8: case RS2_FORMAT_RGBA8: r = 0; g = 1; b = 2; break;
+    case RS2_FORMAT_BGR8: case RS2_FORMAT_BGRA8: r = 2; g = 1; b = 0; break;
+    default: throw std::runtime_error("Color format is not supported!");
+    }
+
+    auto tex = points.get_texture_coordinates();
+    auto data = reinterpret_cast<const uint8_t*>(color.get_data());
+    const int w = color.get_width(), h = color.get_height();
+    const int bpp = color.get_bytes_per_pixel(), stride = color.get_stride_in_bytes();
+
+    rs2_pcl_detail::convert(points, cloud, organized, [&](pcl::PointXYZRGB& p, size_t i) {
+        // Texture coordinates out of the frame are clamped to its edges
+        auto x = std::min(std::max(int(tex[i].u * w + .5f), 0), w - 1);
+        auto y = std::min(std::max(int(tex[i].v * h + .5f), 0), h - 1);
+        auto texel = data + y * stride + x * bpp;
+        p.r = texel[r];
+        p.g = texel[g];
+        p.b = texel[b];
+        p.a = 255;
+    });
+}
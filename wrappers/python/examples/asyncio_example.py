@@ -0,0 +1,60 @@
+## License: Apache 2.0. See LICENSE file in root directory.
+## Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+###############################################################
+##      Streaming every connected camera with asyncio        ##
+###############################################################
+
+# Python 3.6 or later, for the asynchronous generators
+import asyncio
+import pyrealsense2 as rs
+
+
+async def frames(queue):
+    # Yields the frames of a notifying queue, awaiting the readiness of its descriptor rather than blocking a thread
+    loop = asyncio.get_event_loop()
+    ready = asyncio.Event()
+    loop.add_reader(queue.fileno(), ready.set)
+    try:
+        while True:
+            await ready.wait()
+            ready.clear()
+            for f in queue.drain():
+                yield f
+    finally:
+        loop.remove_reader(queue.fileno())
+
+
+async def stream(device, count):
+    # The frames of the depth and color sensors of the device are matched into framesets
+    queue = rs.notifying_frame_queue(capacity=8, synchronize=True)
+    sensors = []
+    for sensor in device.query_sensors():
+        profiles = [p for p in sensor.get_stream_profiles() if p.is_default()]
+        if not profiles:
+            continue
+        sensor.open(profiles)
+        sensor.start(queue)
+        sensors.append(sensor)
+
+    serial = device.get_info(rs.camera_info.serial_number)
+    received = 0
+    async for f in frames(queue):
+        if f.is_frameset():
+            fs = f.as_frameset()
+            print(serial, [s.get_profile().stream_type() for s in fs], fs.get_frame_number())
+        received += 1
+        if received >= count:
+            break
+
+    for sensor in sensors:
+        sensor.stop()
+        sensor.close()
+
+
+async def main():
+    devices = rs.context().query_devices()
+    await asyncio.gather(*[stream(devices[i], 100) for i in range(len(devices))])
+
+
+asyncio.get_event_loop().run_until_complete(main())
@@ -1,6 +1,17 @@
 /* License: Apache 2.0. See LICENSE file in root directory.
 Copyright(c) 2017 Intel Corporation. All Rights Reserved. */
 
+#ifdef _WIN32
+// Before Python.h may include windows.h, which brings the older winsock.h
+#include <winsock2.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "Ws2_32.lib")
+#endif
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 #include <pybind11/pybind11.h>
 
 // convenience functions
@@ -22,6 +33,7 @@ Copyright(c) 2017 Intel Corporation. All Rights Reserved. */
 #include "../include/librealsense2/rs.hpp"
 #include "../include/librealsense2/rs_advanced_mode.hpp"
 #include "../include/librealsense2/rsutil.h"
+#include <atomic>
 #define NAME pyrealsense2
 #define SNAME "pyrealsense2"
 // hacky little bit of half-functions to make .def(BIND_DOWNCAST) look nice for binding as/is functions
@@ -100,6 +112,170 @@ std::string array_to_string(const T(&arr)[N])
 namespace py = pybind11;
 using namespace pybind11::literals;
 
+// Calls the library that may block, waiting on the camera or on its threads, are made with the GIL released, for the
+// other Python threads, and the callbacks of the library, to run meanwhile
+using release_gil = py::call_guard<py::gil_scoped_release>;
+
+// A Python callable handed to the library, which calls, copies and destroys its callbacks on its own threads. The GIL
+// is taken for each call, and for the last reference to the callable to be dropped
+template<class... Args>
+std::function<void(Args...)> python_callback(py::function f)
+{
+    std::shared_ptr<py::function> held(new py::function(std::move(f)), [](py::function* p)
+    {
+        py::gil_scoped_acquire acquire;
+        delete p;
+    });
+    return [held](Args... args)
+    {
+        py::gil_scoped_acquire acquire;
+        (*held)(args...);
+    };
+}
+
+// A pipe whose read end becomes readable once signaled, for an event loop to watch. A loopback socket pair on Windows,
+// the only descriptors its select() and the selector event loop of asyncio watch
+class self_pipe
+{
+public:
+    self_pipe()
+    {
+#ifdef _WIN32
+        WSADATA wsa;
+        if (WSAStartup(MAKEWORD(2, 2), &wsa))
+            throw std::runtime_error("WSAStartup failed");
+        auto listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        int len = sizeof(addr);
+        bool connected = listener != INVALID_SOCKET &&
+            !bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) && !listen(listener, 1) &&
+            !getsockname(listener, reinterpret_cast<sockaddr*>(&addr), &len) &&
+            (_write = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP)) != INVALID_SOCKET &&
+            !connect(_write, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) &&
+            (_read = accept(listener, nullptr, nullptr)) != INVALID_SOCKET;
+        if (listener != INVALID_SOCKET) closesocket(listener);
+        u_long non_blocking = 1;
+        if (!connected || ioctlsocket(_read, FIONBIO, &non_blocking) || ioctlsocket(_write, FIONBIO, &non_blocking))
+        {
+            close();
+            throw std::runtime_error("Could not create the loopback sockets of a notifying queue");
+        }
+#else
+        int fds[2];
+        if (pipe(fds))
+            throw std::runtime_error("Could not create the pipe of a notifying queue");
+        _read = fds[0];
+        _write = fds[1];
+        for (auto fd : fds)
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+#endif
+    }
+
+    ~self_pipe() { close(); }
+    self_pipe(const self_pipe&) = delete;
+    self_pipe& operator=(const self_pipe&) = delete;
+
+    int64_t fileno() const { return static_cast<int64_t>(_read); }
+
+    // A full pipe is left as it is, already readable
+    void signal()
+    {
+        char c = 0;
+#ifdef _WIN32
+        send(_write, &c, 1, 0);
+#else
+        auto written = write(_write, &c, 1);
+        (void)written;
+#endif
+    }
+
+    void drain()
+    {
+        char buffer[256];
+#ifdef _WIN32
+        while (recv(_read, buffer, sizeof(buffer), 0) > 0) {}
+#else
+        while (read(_read, buffer, sizeof(buffer)) > 0) {}
+#endif
+    }
+
+private:
+    void close()
+    {
+#ifdef _WIN32
+        if (_read != INVALID_SOCKET) closesocket(_read);
+        if (_write != INVALID_SOCKET) closesocket(_write);
+        _read = _write = INVALID_SOCKET;
+        WSACleanup();
+#else
+        if (_read >= 0) ::close(_read);
+        if (_write >= 0) ::close(_write);
+        _read = _write = -1;
+#endif
+    }
+
+#ifdef _WIN32
+    SOCKET _read = INVALID_SOCKET, _write = INVALID_SOCKET;
+#else
+    int _read = -1, _write = -1;
+#endif
+};
+
+// A frame queue the sensors deliver into with no Python in between, signaling its frames on a pipe for an event loop
+// to watch, so no thread blocks on the queue. With synchronize, the frames of several streams are matched into framesets
+class notifying_frame_queue
+{
+public:
+    notifying_frame_queue(unsigned int capacity, bool synchronize) : _queue(std::make_shared<queue>(capacity))
+    {
+        if (synchronize)
+        {
+            _sync = std::make_shared<rs2::asynchronous_syncer>();
+            auto q = _queue;
+            _sync->start([q](rs2::frame f) { q->push(f); });
+        }
+    }
+
+    void operator()(rs2::frame f) const
+    {
+        if (_sync) _sync->invoke(f);
+        else _queue->push(f);
+    }
+
+    // Every frame queued, in order. The pipe is drained first, for a frame queued meanwhile to signal it again
+    std::vector<rs2::frame> drain() const
+    {
+        _queue->pipe.drain();
+        std::vector<rs2::frame> frames;
+        rs2::frame f;
+        while (_queue->frames.poll_for_frame(&f))
+            frames.push_back(f);
+        return frames;
+    }
+
+    int64_t fileno() const { return _queue->pipe.fileno(); }
+    unsigned int capacity() const { return _queue->frames.capacity(); }
+
+private:
+    // Shared with the callback of the syncer, which may outlive the queue on the threads of the library
+    struct queue
+    {
+        explicit queue(unsigned int capacity) : frames(capacity) {}
+        void push(rs2::frame f)
+        {
+            frames.enqueue(std::move(f));
+            pipe.signal();
+        }
+        rs2::frame_queue frames;
+        self_pipe pipe;
+    };
+
+    std::shared_ptr<queue> _queue;
+    std::shared_ptr<rs2::asynchronous_syncer> _sync;
+};
+
 PYBIND11_MODULE(NAME, m) {
     m.doc() = "Library for accessing Intel RealSenseTM cameras";
 
@@ -223,9 +399,9 @@ PYBIND11_MODULE(NAME, m) {
         .def_property_readonly("sensors", &rs2::context::query_all_sensors, "Generate a flat list of "
             "all available sensors from all RealSense devices.")
         .def("get_sensor_parent", &rs2::context::get_sensor_parent, "s"_a)
-        .def("set_devices_changed_callback", [](rs2::context& self, std::function<void(rs2::event_information)> &callback)
+        .def("set_devices_changed_callback", [](rs2::context& self, py::function callback)
     {
-        self.set_devices_changed_callback(callback);
+        self.set_devices_changed_callback(python_callback<rs2::event_information>(callback));
     }, "Register devices changed callback.", "callback"_a)
         // not binding create_processing_block, not inpr Python API.
         .def("load_device", &rs2::context::load_device, "Creates a devices from a RealSense file.\n"
@@ -244,7 +420,7 @@ PYBIND11_MODULE(NAME, m) {
         .def("supports", &rs2::device::supports, "Check if specific camera info is supported.", "info"_a)
         .def("get_info", &rs2::device::get_info, "Retrieve camera specific information, "
             "like versions of various internal components", "info"_a)
-        .def("hardware_reset", &rs2::device::hardware_reset, "Send hardware reset request to the device")
+        .def("hardware_reset", &rs2::device::hardware_reset, "Send hardware reset request to the device", release_gil())
         .def(py::init<>())
         .def("__nonzero__", &rs2::device::operator bool)
         .def(BIND_DOWNCAST(device, debug_protocol))
@@ -339,8 +515,14 @@ PYBIND11_MODULE(NAME, m) {
         else
             return BufData(const_cast<void*>(self.get_data()), 1, std::string("@B"), 0); };
 
-    py::class_<rs2::frame> frame(m, "frame");
-    frame.def(py::init<>())
+    // The frames are buffers of their data, for numpy.asarray(frame) to view it in place, holding the frame while the array lives
+    py::class_<rs2::frame> frame(m, "frame", py::buffer_protocol());
+    frame.def_buffer([get_frame_data](rs2::frame& self)
+    {
+        auto data = get_frame_data(self);
+        return py::buffer_info(data._ptr, data._itemsize, data._format, data._ndim, data._shape, data._strides);
+    })
+        .def(py::init<>())
         //         .def(py::self = py::self) // can't overload assignment in python
         .def(py::init<rs2::frame>())
         .def("swap", &rs2::frame::swap, "other"_a)
@@ -401,8 +583,14 @@ PYBIND11_MODULE(NAME, m) {
         return oss.str();
     });
 
-    py::class_<rs2::points, rs2::frame> points(m, "points");
-    points.def(py::init<>())
+    // The points are the buffer of their vertices, as an N x 3 array of floats
+    py::class_<rs2::points, rs2::frame> points(m, "points", py::buffer_protocol());
+    points.def_buffer([](rs2::points& self)
+    {
+        auto verts = const_cast<rs2::vertex*>(self.get_vertices());
+        return py::buffer_info(verts, sizeof(float), "@f", 2, { self.size(), size_t(3) }, { sizeof(rs2::vertex), sizeof(float) });
+    })
+        .def(py::init<>())
         .def(py::init<rs2::frame>())
         .def("get_vertices", [](rs2::points& self, int dims) -> BufData
         {
@@ -424,7 +612,7 @@ PYBIND11_MODULE(NAME, m) {
                 return BufData(tex, sizeof(float), "@f", 2, self.size());
             }
         }, py::keep_alive<0, 1>(), "dims"_a=1)
-        .def("export_to_ply", &rs2::points::export_to_ply)
+        .def("export_to_ply", &rs2::points::export_to_ply, "fname"_a, "texture"_a, "normals"_a = false, "faces"_a = false)
         .def("size", &rs2::points::size);
 
     py::class_<rs2::frameset, rs2::frame> frameset(m, "composite_frame");
@@ -463,7 +651,7 @@ PYBIND11_MODULE(NAME, m) {
 
     /* rs2_processing.hpp */
     py::class_<rs2::process_interface> process_interface(m, "process_interface");
-    process_interface.def("process", &rs2::process_interface::process, "frame"_a);
+    process_interface.def("process", &rs2::process_interface::process, "frame"_a, release_gil());
 
     // Base class for options interface. Should be used via sensor
     py::class_<rs2::options> options(m, "options");
@@ -481,11 +669,11 @@ PYBIND11_MODULE(NAME, m) {
 
     // Not binding frame_processor_callback, templated
     py::class_<rs2::processing_block, rs2::process_interface, rs2::options> processing_block(m, "processing_block");
-    processing_block.def("start", [](rs2::processing_block& self, std::function<void(rs2::frame)> f)
+    processing_block.def("start", [](rs2::processing_block& self, py::function f)
     {
-        self.start(f);
+        self.start(python_callback<rs2::frame>(f));
     }, "callback"_a)
-        .def("invoke", &rs2::processing_block::invoke, "f"_a)
+        .def("invoke", &rs2::processing_block::invoke, "f"_a, release_gil())
         /*.def("__call__", &rs2::processing_block::operator(), "f"_a)*/;
 
     // Not binding syncer_processing_block, not in Python API
@@ -495,8 +683,8 @@ PYBIND11_MODULE(NAME, m) {
         "cross-platform synchronization primitive provided by librealsense to help "
         "developers who are not using async APIs.")
         .def(py::init<>())
-        .def("wait_for_frame", [](const rs2::frame_queue& self, unsigned int timeout_ms) { py::gil_scoped_release(); self.wait_for_frame(timeout_ms); }, "Wait until a new frame "
-            "becomes available in the queue and dequeue it.", "timeout_ms"_a = 5000)
+        .def("wait_for_frame", &rs2::frame_queue::wait_for_frame, "Wait until a new frame "
+            "becomes available in the queue and dequeue it.", "timeout_ms"_a = 5000, release_gil())
         .def("poll_for_frame", [](const rs2::frame_queue &self)
     {
         rs2::frame frame;
@@ -505,15 +693,24 @@ PYBIND11_MODULE(NAME, m) {
     }, "Poll if a new frame is available and dequeue it if it is")
         .def("__call__", &rs2::frame_queue::operator());
 
+    py::class_<notifying_frame_queue> notifying_frame_queue_py(m, "notifying_frame_queue");
+    notifying_frame_queue_py.def(py::init<unsigned int, bool>(), "Create a frame queue signaling its frames on a "
+        "file descriptor, for an event loop such as asyncio to watch with add_reader instead of a thread blocking "
+        "on wait_for_frame. With synchronize, the frames are matched into framesets.", "capacity"_a = 1, "synchronize"_a = false)
+        .def("fileno", &notifying_frame_queue::fileno, "The descriptor that becomes readable once frames are queued")
+        .def("drain", &notifying_frame_queue::drain, "Dequeue every frame queued, in order, acknowledging the signal of the descriptor")
+        .def("capacity", &notifying_frame_queue::capacity)
+        .def("__call__", &notifying_frame_queue::operator(), "frame"_a, release_gil());
+
     py::class_<rs2::pointcloud, rs2::processing_block> pointcloud(m, "pointcloud");
     pointcloud.def(py::init<>())
-        .def("calculate", &rs2::pointcloud::calculate, "depth"_a)
+        .def("calculate", &rs2::pointcloud::calculate, "depth"_a, release_gil())
         .def("map_to", &rs2::pointcloud::map_to, "mapped"_a);
 
     py::class_<rs2::syncer> syncer(m, "syncer");
     syncer.def(py::init<>())
         .def("wait_for_frames", &rs2::syncer::wait_for_frames, "Wait until a coherent set "
-            "of frames becomes available", "timeout_ms"_a = 5000)
+            "of frames becomes available", "timeout_ms"_a = 5000, release_gil())
         .def("poll_for_frames", [](const rs2::syncer &self)
     {
         rs2::frameset frames;
@@ -524,12 +721,12 @@ PYBIND11_MODULE(NAME, m) {
 
     py::class_<rs2::colorizer, rs2::processing_block> colorizer(m, "colorizer");
     colorizer.def(py::init<>())
-        .def("colorize", &rs2::colorizer::colorize, "depth"_a)
+        .def("colorize", &rs2::colorizer::colorize, "depth"_a, release_gil())
         /*.def("__call__", &rs2::colorizer::operator())*/;
 
     py::class_<rs2::align, rs2::processing_block> align(m, "align");
     align.def(py::init<rs2_stream>(), "align_to"_a)
-        .def("process", &rs2::align::process, "frames"_a);
+        .def("process", &rs2::align::process, "frames"_a, release_gil());
 
     py::class_<rs2::decimation_filter, rs2::processing_block> decimation_filter(m, "decimation_filter");
     decimation_filter.def(py::init<>());
@@ -549,16 +746,16 @@ PYBIND11_MODULE(NAME, m) {
     /* rs2_record_playback.hpp */
     py::class_<rs2::playback, rs2::device> playback(m, "playback");
     playback.def(py::init<rs2::device>(), "device"_a)
-        .def("pause", &rs2::playback::pause)
-        .def("resume", &rs2::playback::resume)
+        .def("pause", &rs2::playback::pause, release_gil())
+        .def("resume", &rs2::playback::resume, release_gil())
         .def("file_name", &rs2::playback::file_name)
         .def("get_position", &rs2::playback::get_position)
         .def("get_duration", &rs2::playback::get_duration)
-        .def("seek", &rs2::playback::seek, "time"_a)
+        .def("seek", &rs2::playback::seek, "time"_a, release_gil())
         .def("is_real_time", &rs2::playback::is_real_time)
         .def("set_real_time", &rs2::playback::set_real_time, "real_time"_a)
-        .def("set_status_changed_callback", [](rs2::playback& self, std::function<void(rs2_playback_status)> callback)
-    { self.set_status_changed_callback(callback); }, "callback"_a)
+        .def("set_status_changed_callback", [](rs2::playback& self, py::function callback)
+    { self.set_status_changed_callback(python_callback<rs2_playback_status>(callback)); }, "callback"_a)
         .def("current_status", &rs2::playback::current_status);
 
     py::class_<rs2::recorder, rs2::device> recorder(m, "recorder");
@@ -649,23 +846,26 @@ PYBIND11_MODULE(NAME, m) {
     // not binding notifications_callback, templated
     py::class_<rs2::sensor, rs2::options> sensor(m, "sensor");
     sensor.def("open", (void (rs2::sensor::*)(const rs2::stream_profile&) const) &rs2::sensor::open,
-        "Open sensor for exclusive access, by commiting to a configuration", "profile"_a)
+        "Open sensor for exclusive access, by commiting to a configuration", "profile"_a, release_gil())
         .def("supports", (bool (rs2::sensor::*)(rs2_camera_info) const) &rs2::sensor::supports,
             "Check if specific camera info is supported.", "info")
         .def("supports", (bool (rs2::sensor::*)(rs2_option) const) &rs2::options::supports,
             "Check if specific camera info is supported.", "info")
         .def("get_info", &rs2::sensor::get_info, "Retrieve camera specific information, "
             "like versions of various internal components.", "info"_a)
-        .def("set_notifications_callback", [](const rs2::sensor& self, std::function<void(rs2::notification)> callback)
-    { self.set_notifications_callback(callback); }, "Register Notifications callback", "callback"_a)
+        .def("set_notifications_callback", [](const rs2::sensor& self, py::function callback)
+    { self.set_notifications_callback(python_callback<rs2::notification>(callback)); }, "Register Notifications callback", "callback"_a)
         .def("open", (void (rs2::sensor::*)(const std::vector<rs2::stream_profile>&) const) &rs2::sensor::open,
             "Open sensor for exclusive access, by committing to a composite configuration, specifying one or "
-            "more stream profiles.", "profiles"_a)
-        .def("close", [](const rs2::sensor& self) { py::gil_scoped_release lock; self.close(); }, "Close sensor for exclusive access.")
-        .def("start", [](const rs2::sensor& self, std::function<void(rs2::frame)> callback)
-    { self.start(callback); }, "Start passing frames into user provided callback.", "callback"_a)
-        .def("start", [](const rs2::sensor& self, rs2::frame_queue& queue) { self.start(queue); })
-        .def("stop", [](const rs2::sensor& self) { py::gil_scoped_release lock; self.stop(); }, "Stop streaming.")
+            "more stream profiles.", "profiles"_a, release_gil())
+        .def("close", [](const rs2::sensor& self) { self.close(); }, "Close sensor for exclusive access.", release_gil())
+        // The queues before the callables, which they are too, for the frames to reach them with no Python in between
+        .def("start", [](const rs2::sensor& self, rs2::frame_queue& queue) { self.start(queue); }, release_gil())
+        .def("start", [](const rs2::sensor& self, const notifying_frame_queue& queue) { self.start(queue); },
+            "Start passing frames into a notifying queue.", "queue"_a, release_gil())
+        .def("start", [](const rs2::sensor& self, py::function callback)
+    { self.start(python_callback<rs2::frame>(callback)); }, "Start passing frames into user provided callback.", "callback"_a)
+        .def("stop", [](const rs2::sensor& self) { self.stop(); }, "Stop streaming.", release_gil())
         .def("get_stream_profiles", &rs2::sensor::get_stream_profiles, "Check if physical sensor is supported.")
         .def_property_readonly("profiles", &rs2::sensor::get_stream_profiles, "Check if physical sensor is supported.")
         .def(py::init<>())
@@ -691,10 +891,10 @@ PYBIND11_MODULE(NAME, m) {
     py::class_<rs2::pipeline> pipeline(m, "pipeline");
     pipeline.def(py::init([](rs2::context ctx) { return rs2::pipeline(ctx); }))
         .def(py::init([]() { return rs2::pipeline(rs2::context()); }))
-        .def("start", (rs2::pipeline_profile(rs2::pipeline::*)(const rs2::config&)) &rs2::pipeline::start, "config")
-        .def("start", (rs2::pipeline_profile(rs2::pipeline::*)()) &rs2::pipeline::start)
-        .def("stop", &rs2::pipeline::stop)
-        .def("wait_for_frames", &rs2::pipeline::wait_for_frames, "timeout_ms"_a = 5000)
+        .def("start", (rs2::pipeline_profile(rs2::pipeline::*)(const rs2::config&)) &rs2::pipeline::start, "config", release_gil())
+        .def("start", (rs2::pipeline_profile(rs2::pipeline::*)()) &rs2::pipeline::start, release_gil())
+        .def("stop", &rs2::pipeline::stop, release_gil())
+        .def("wait_for_frames", &rs2::pipeline::wait_for_frames, "timeout_ms"_a = 5000, release_gil())
         .def("poll_for_frames", &rs2::pipeline::poll_for_frames, "frameset*"_a)
         .def("get_active_profile", &rs2::pipeline::get_active_profile);
 
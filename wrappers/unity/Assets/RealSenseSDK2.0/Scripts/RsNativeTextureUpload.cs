@@ -0,0 +1,83 @@
+﻿using Intel.RealSense;
+using System;
+using System.Runtime.InteropServices;
+using UnityEngine;
+
+/// <summary>
+/// Writes frames into textures on the render thread, with the realsense2-unity native plugin, so that the frames are
+/// neither copied to managed memory nor uploaded with Texture2D.Apply. Supports D3D11 and OpenGL core
+/// </summary>
+public static class RsNativeTextureUpload
+{
+    const string dllName = "realsense2-unity";
+
+    [DllImport(dllName)]
+    static extern int rs_unity_is_supported();
+
+    [DllImport(dllName)]
+    static extern int rs_unity_create_sink(IntPtr texture, int width, int height);
+
+    [DllImport(dllName)]
+    static extern void rs_unity_destroy_sink(int sink);
+
+    [DllImport(dllName)]
+    static extern void rs_unity_enqueue_frame(int sink, IntPtr frame);
+
+    [DllImport(dllName)]
+    static extern IntPtr rs_unity_get_render_event_func();
+
+    static IntPtr renderEventFunc;
+
+    /// <summary>
+    /// Whether the plugin is deployed, and supports the graphics API in use
+    /// </summary>
+    public static bool Supported
+    {
+        get
+        {
+            try
+            {
+                return rs_unity_is_supported() != 0;
+            }
+            catch (DllNotFoundException)
+            {
+                return false;
+            }
+            catch (EntryPointNotFoundException)
+            {
+                return false;
+            }
+        }
+    }
+
+    /// <summary>
+    /// Registers a texture of the size and format of the frames written into it, returns the sink to pass them to
+    /// </summary>
+    public static int CreateSink(Texture2D texture)
+    {
+        return rs_unity_create_sink(texture.GetNativeTexturePtr(), texture.width, texture.height);
+    }
+
+    public static void DestroySink(int sink)
+    {
+        rs_unity_destroy_sink(sink);
+    }
+
+    /// <summary>
+    /// Queues a frame for the next upload of the sink, from any thread. The plugin takes its own reference to the frame
+    /// </summary>
+    public static void Enqueue(int sink, Frame frame)
+    {
+        rs_unity_enqueue_frame(sink, frame.NativePtr);
+    }
+
+    /// <summary>
+    /// Writes the latest frame queued into the texture of the sink, on the render thread
+    /// </summary>
+    public static void Upload(int sink)
+    {
+        if (renderEventFunc == IntPtr.Zero)
+            renderEventFunc = rs_unity_get_render_event_func();
+        GL.IssuePluginEvent(renderEventFunc, sink);
+    }
+}
@@ -44,6 +44,10 @@ public class RsStreamTextureRenderer : MonoBehaviour
 
     public FilterMode filterMode = FilterMode.Point;
 
+    [Tooltip("Write the frames into the texture on the render thread with the native plugin, when it supports the graphics API")]
+    public bool nativeUpload = true;
+    private int nativeSink;
+
     private RsVideoStreamRequest _videoStreamFilter;
     private RsVideoStreamRequest _currVideoStreamFilter;
 
@@ -74,6 +78,11 @@ public class RsStreamTextureRenderer : MonoBehaviour
 
     void OnDestroy()
     {
+        if (nativeSink != 0)
+        {
+            RsNativeTextureUpload.DestroySink(nativeSink);
+            nativeSink = 0;
+        }
         if (texture != null) {
             Destroy(texture);
             texture = null;
@@ -139,9 +148,17 @@ public class RsStreamTextureRenderer : MonoBehaviour
         _currVideoStreamFilter = vsr.Clone();
 
         texture.Apply();
+        ResetNativeSink();
         textureBinding.Invoke(texture);
     }
 
+    private void ResetNativeSink()
+    {
+        if (nativeSink != 0)
+            RsNativeTextureUpload.DestroySink(nativeSink);
+        nativeSink = nativeUpload && RsNativeTextureUpload.Supported ? RsNativeTextureUpload.CreateSink(texture) : 0;
+    }
+
     private bool HasTextureConflict(Frame frame)
     {
         var vidFrame = frame as VideoFrame;
@@ -170,7 +187,10 @@ public class RsStreamTextureRenderer : MonoBehaviour
             return;
         if (HasTextureConflict(frame))
             return;
-        UpdateData(frame);
+        if (nativeSink != 0)
+            RsNativeTextureUpload.Enqueue(nativeSink, frame);
+        else
+            UpdateData(frame);
         f.Set();
     }
 
@@ -185,7 +205,10 @@ public class RsStreamTextureRenderer : MonoBehaviour
 
         UnityEngine.Assertions.Assert.AreEqual(threadId, Thread.CurrentThread.ManagedThreadId);
 
-        texture.LoadRawTextureData(vidFrame.Data, vidFrame.Stride * vidFrame.Height);
+        if (nativeSink != 0)
+            RsNativeTextureUpload.Enqueue(nativeSink, vidFrame);
+        else
+            texture.LoadRawTextureData(vidFrame.Data, vidFrame.Stride * vidFrame.Height);
 
         if ((vidFrame as Frame) != frame)
             vidFrame.Dispose();
@@ -202,18 +225,25 @@ public class RsStreamTextureRenderer : MonoBehaviour
 
         if (f.WaitOne(0))
         {
-            try
+            if (nativeSink != 0)
             {
-                if (data != null)
-                    texture.LoadRawTextureData(data);
+                RsNativeTextureUpload.Upload(nativeSink);
             }
-            catch
+            else
             {
-                OnStopStreaming();
-                Debug.LogError("Error loading texture data, check texture and stream formats");
-                throw;
+                try
+                {
+                    if (data != null)
+                        texture.LoadRawTextureData(data);
+                }
+                catch
+                {
+                    OnStopStreaming();
+                    Debug.LogError("Error loading texture data, check texture and stream formats");
+                    throw;
+                }
+                texture.Apply();
             }
-            texture.Apply();
 
             if (!bound)
             {
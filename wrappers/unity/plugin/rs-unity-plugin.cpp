@@ -0,0 +1,241 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+// A native rendering plugin for Unity, writing the frames of librealsense into Unity textures on the render
+// thread. The frames do not go through managed memory, nor through Texture2D.LoadRawTextureData and Apply
+
+#include <librealsense2/rs.h>
+
+#include "IUnityInterface.h"
+#include "IUnityGraphics.h"
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <d3d11.h>
+#include "IUnityGraphicsD3D11.h"
+#endif
+
+#ifdef __APPLE__
+#include <OpenGL/gl.h>
+#else
+#include <GL/gl.h>
+#endif
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#ifndef GL_BGRA
+#define GL_BGRA 0x80E1
+#endif
+
+namespace
+{
+    // A Unity texture, and the queue of the frames written into it at the next render event for it
+    struct texture_sink
+    {
+        void* texture;              // ID3D11Texture2D* or the GL texture name, from Texture.GetNativeTexturePtr
+        int width;
+        int height;
+        rs2_frame_queue* queue;     // Of the latest frame only
+    };
+
+    IUnityInterfaces* unity_interfaces = nullptr;
+    IUnityGraphics* unity_graphics = nullptr;
+    UnityGfxRenderer renderer = kUnityGfxRendererNull;
+#ifdef _WIN32
+    ID3D11Device* d3d11_device = nullptr;
+#endif
+
+    std::mutex sinks_mutex;     // The sinks are added by the scripts, and written on the render thread
+    std::map<int, texture_sink> sinks;
+    int next_sink = 1;
+    std::vector<uint8_t> expanded;  // RGB frames, as RGBA for D3D11 which has no 24-bit formats
+
+    void UNITY_INTERFACE_API on_graphics_device_event(UnityGfxDeviceEventType type)
+    {
+        if (type == kUnityGfxDeviceEventInitialize)
+        {
+            renderer = unity_graphics->GetRenderer();
+#ifdef _WIN32
+            if (renderer == kUnityGfxRendererD3D11)
+                d3d11_device = unity_interfaces->Get<IUnityGraphicsD3D11>()->GetDevice();
+#endif
+        }
+        else if (type == kUnityGfxDeviceEventShutdown)
+        {
+            renderer = kUnityGfxRendererNull;
+#ifdef _WIN32
+            d3d11_device = nullptr;
+#endif
+        }
+    }
+
+    const uint8_t* as_rgba(const uint8_t* rgb, int width, int height, int stride)
+    {
+        expanded.resize(width * height * 4);
+        auto out = expanded.data();
+        for (int y = 0; y < height; ++y)
+        {
+            auto in = rgb + y * stride;
+            for (int x = 0; x < width; ++x, in += 3, out += 4)
+            {
+                out[0] = in[0];
+                out[1] = in[1];
+                out[2] = in[2];
+                out[3] = 255;
+            }
+        }
+        return expanded.data();
+    }
+
+    void upload(texture_sink& sink, rs2_frame* frame)
+    {
+        rs2_error* e = nullptr;
+        auto data = static_cast<const uint8_t*>(rs2_get_frame_data(frame, &e));
+        auto width = rs2_get_frame_width(frame, &e);
+        auto height = rs2_get_frame_height(frame, &e);
+        auto stride = rs2_get_frame_stride_in_bytes(frame, &e);
+        auto bpp = rs2_get_frame_bits_per_pixel(frame, &e) / 8;
+        rs2_stream stream; rs2_format format; int index, unique_id, fps;
+        rs2_get_stream_profile_data(rs2_get_frame_stream_profile(frame, &e), &stream, &format, &index, &unique_id, &fps, &e);
+        if (e)
+        {
+            rs2_free_error(e);
+            return;
+        }
+        // The texture is resized by the scripts before the frames of the new size are written
+        if (!data || width != sink.width || height != sink.height)
+            return;
+
+#ifdef _WIN32
+        if (renderer == kUnityGfxRendererD3D11 && d3d11_device)
+        {
+            if (bpp == 3)
+            {
+                data = as_rgba(data, width, height, stride);
+                stride = width * 4;
+            }
+            ID3D11DeviceContext* context = nullptr;
+            d3d11_device->GetImmediateContext(&context);
+            context->UpdateSubresource(static_cast<ID3D11Texture2D*>(sink.texture), 0, nullptr, data, stride, 0);
+            context->Release();
+            return;
+        }
+#endif
+        if (renderer == kUnityGfxRendererOpenGLCore)
+        {
+            GLenum gl_format = GL_RED, type = GL_UNSIGNED_BYTE;
+            switch (bpp)
+            {
+            case 1: break;
+            case 2: type = GL_UNSIGNED_SHORT; break;
+            case 3: gl_format = GL_RGB; break;
+            case 4: gl_format = format == RS2_FORMAT_BGRA8 ? GL_BGRA : GL_RGBA; break;
+            default: return;
+            }
+            glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(reinterpret_cast<size_t>(sink.texture)));
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, stride / bpp);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, gl_format, type, data);
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        }
+    }
+
+    // Issued by the scripts with GL.IssuePluginEvent, on the render thread
+    void UNITY_INTERFACE_API on_render_event(int sink_id)
+    {
+        std::lock_guard<std::mutex> lock(sinks_mutex);
+        auto it = sinks.find(sink_id);
+        if (it == sinks.end())
+            return;
+
+        rs2_frame* frame = nullptr;
+        rs2_error* e = nullptr;
+        if (rs2_poll_for_frame(it->second.queue, &frame, &e) && frame)
+        {
+            upload(it->second, frame);
+            rs2_release_frame(frame);
+        }
+        if (e) rs2_free_error(e);
+    }
+}
+
+extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API UnityPluginLoad(IUnityInterfaces* interfaces)
+{
+    unity_interfaces = interfaces;
+    unity_graphics = interfaces->Get<IUnityGraphics>();
+    unity_graphics->RegisterDeviceEventCallback(on_graphics_device_event);
+    // The device may be initialized before the plugin is loaded
+    on_graphics_device_event(kUnityGfxDeviceEventInitialize);
+}
+
+extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API UnityPluginUnload()
+{
+    unity_graphics->UnregisterDeviceEventCallback(on_graphics_device_event);
+}
+
+// Whether the frames can be written by the plugin with the current graphics API, D3D11 or OpenGL core
+extern "C" int UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API rs_unity_is_supported()
+{
+#ifdef _WIN32
+    if (renderer == kUnityGfxRendererD3D11 && d3d11_device)
+        return 1;
+#endif
+    return renderer == kUnityGfxRendererOpenGLCore ? 1 : 0;
+}
+
+// Registers a texture the frames are written into, of their size and of the Unity format matching theirs.
+// Returns the id of the sink, for the render events, or 0 on failure
+extern "C" int UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API rs_unity_create_sink(void* native_texture, int width, int height)
+{
+    rs2_error* e = nullptr;
+    auto queue = rs2_create_frame_queue(1, &e);
+    if (e)
+    {
+        rs2_free_error(e);
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(sinks_mutex);
+    auto id = next_sink++;
+    sinks[id] = { native_texture, width, height, queue };
+    return id;
+}
+
+extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API rs_unity_destroy_sink(int sink_id)
+{
+    std::lock_guard<std::mutex> lock(sinks_mutex);
+    auto it = sinks.find(sink_id);
+    if (it == sinks.end())
+        return;
+    rs2_delete_frame_queue(it->second.queue);
+    sinks.erase(it);
+}
+
+// Queues a frame for the next render event of the sink, which replaces a frame not written yet. The frame stays
+// owned by the caller, the queue holding its own reference
+extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API rs_unity_enqueue_frame(int sink_id, rs2_frame* frame)
+{
+    std::lock_guard<std::mutex> lock(sinks_mutex);
+    auto it = sinks.find(sink_id);
+    if (it == sinks.end() || !frame)
+        return;
+
+    rs2_error* e = nullptr;
+    rs2_frame_add_ref(frame, &e);
+    if (e)
+    {
+        rs2_free_error(e);
+        return;
+    }
+    rs2_enqueue_frame(frame, it->second.queue);
+}
+
+extern "C" UnityRenderingEvent UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API rs_unity_get_render_event_func()
+{
+    return on_render_event;
+}